@@ -718,6 +718,12 @@ class _Uri {
     }
     return result.toString();
   }
+
+  @patch
+  static String _uriDecode(
+      String text, int start, int end, Encoding encoding, bool plusToSpace) {
+    return _uriDecodeGeneric(text, start, end, encoding, plusToSpace);
+  }
 }
 
 @patch
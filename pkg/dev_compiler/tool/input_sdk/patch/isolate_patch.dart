@@ -6,6 +6,7 @@
 
 import 'dart:_js_helper' show patch, NoReifyGeneric;
 import 'dart:async';
+import 'dart:typed_data' show TypedData;
 
 @patch
 class Isolate {
@@ -113,6 +114,13 @@ class Capability {
   factory Capability() => _unsupported();
 }
 
+@patch
+class TransferableTypedData {
+  @patch
+  factory TransferableTypedData.fromList(List<TypedData> list) =>
+      _unsupported();
+}
+
 @NoReifyGeneric()
 T _unsupported<T>() {
   throw UnsupportedError('dart:isolate is not supported on dart4web');
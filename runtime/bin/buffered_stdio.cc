@@ -0,0 +1,159 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "bin/buffered_stdio.h"
+
+#include <stdlib.h>  // NOLINT
+#include <string.h>  // NOLINT
+
+#include "bin/file.h"
+#include "bin/lockers.h"
+#include "platform/assert.h"
+
+namespace dart {
+namespace bin {
+
+// Consecutive writes to the same stream are appended to one segment.
+struct BufferedStdio::Segment {
+  static const intptr_t kMinCapacity = 16 * KB;
+
+  intptr_t fd;
+  intptr_t length;
+  intptr_t capacity;
+  Segment* next;
+
+  uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+
+  static Segment* New(intptr_t fd, intptr_t length) {
+    intptr_t capacity = (length < kMinCapacity) ? kMinCapacity : length;
+    Segment* segment =
+        reinterpret_cast<Segment*>(malloc(sizeof(Segment) + capacity));
+    if (segment == NULL) {
+      FATAL("Out of memory buffering stdio output.");
+    }
+    segment->fd = fd;
+    segment->length = 0;
+    segment->capacity = capacity;
+    segment->next = NULL;
+    return segment;
+  }
+};
+
+bool BufferedStdio::enabled_ = false;
+Monitor* BufferedStdio::monitor_ = new Monitor();
+bool BufferedStdio::writer_started_ = false;
+bool BufferedStdio::writing_ = false;
+BufferedStdio::Segment* BufferedStdio::head_ = NULL;
+BufferedStdio::Segment* BufferedStdio::tail_ = NULL;
+intptr_t BufferedStdio::pending_bytes_ = 0;
+File* BufferedStdio::stdout_ = NULL;
+File* BufferedStdio::stderr_ = NULL;
+
+static void FlushAtExit() {
+  BufferedStdio::Flush();
+}
+
+void BufferedStdio::StartWriterLocked() {
+  if (writer_started_) {
+    return;
+  }
+  writer_started_ = true;
+  stdout_ = File::OpenStdio(kStdoutFd);
+  stderr_ = File::OpenStdio(kStderrFd);
+  atexit(FlushAtExit);
+  int result = Thread::Start(&WriterThread, 0);
+  if (result != 0) {
+    FATAL1("Failed to start the stdio writer thread: %d", result);
+  }
+}
+
+void BufferedStdio::WaitForSpace() {
+  MonitorLocker ml(monitor_);
+  while (pending_bytes_ >= kMaxPendingBytes) {
+    ml.Wait();
+  }
+}
+
+void BufferedStdio::Write(intptr_t fd, const uint8_t* data, intptr_t length) {
+  ASSERT(IsBuffered(fd));
+  if (length == 0) {
+    return;
+  }
+  MonitorLocker ml(monitor_);
+  StartWriterLocked();
+  if ((tail_ == NULL) || (tail_->fd != fd) ||
+      (tail_->capacity - tail_->length < length)) {
+    Segment* segment = Segment::New(fd, length);
+    if (tail_ == NULL) {
+      head_ = segment;
+    } else {
+      tail_->next = segment;
+    }
+    tail_ = segment;
+  }
+  memmove(tail_->data() + tail_->length, data, length);
+  tail_->length += length;
+  const intptr_t previous_bytes = pending_bytes_;
+  pending_bytes_ += length;
+  // Wake the writer when its first wait should start, and when it should
+  // stop waiting for more output.
+  if ((previous_bytes == 0) || ((previous_bytes < kFlushThreshold) &&
+                                (pending_bytes_ >= kFlushThreshold))) {
+    ml.NotifyAll();
+  }
+}
+
+void BufferedStdio::WriteSegments(Segment* segments) {
+  while (segments != NULL) {
+    Segment* next = segments->next;
+    File* file = (segments->fd == kStdoutFd) ? stdout_ : stderr_;
+    // Like print(), errors writing to stdio are ignored here.
+    file->WriteFully(segments->data(), segments->length);
+    free(segments);
+    segments = next;
+  }
+}
+
+void BufferedStdio::Flush() {
+  Segment* segments = NULL;
+  {
+    MonitorLocker ml(monitor_);
+    // Output taken by another thread must be written first.
+    while (writing_) {
+      ml.Wait();
+    }
+    if (head_ == NULL) {
+      return;
+    }
+    segments = head_;
+    head_ = NULL;
+    tail_ = NULL;
+    pending_bytes_ = 0;
+    writing_ = true;
+  }
+  WriteSegments(segments);
+  {
+    MonitorLocker ml(monitor_);
+    writing_ = false;
+    ml.NotifyAll();
+  }
+}
+
+void BufferedStdio::WriterThread(uword unused) {
+  while (true) {
+    {
+      MonitorLocker ml(monitor_);
+      while (head_ == NULL) {
+        ml.Wait();
+      }
+      if (pending_bytes_ < kFlushThreshold) {
+        ml.Wait(kFlushIntervalMillis);
+      }
+    }
+    Flush();
+  }
+}
+
+}  // namespace bin
+}  // namespace dart
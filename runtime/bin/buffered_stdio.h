@@ -0,0 +1,75 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_BUFFERED_STDIO_H_
+#define RUNTIME_BIN_BUFFERED_STDIO_H_
+
+#include "bin/thread.h"
+#include "platform/globals.h"
+
+namespace dart {
+namespace bin {
+
+class File;
+
+// Collects output to stdout and stderr in memory when enabled with
+// --buffered-stdio. A background thread writes it out once kFlushThreshold
+// bytes are pending or kFlushIntervalMillis after the first pending write,
+// so that writers neither make a system call per write nor block on a slow
+// pipe. Writes to both streams are kept in one queue to preserve their
+// relative order.
+class BufferedStdio {
+ public:
+  static const intptr_t kFlushThreshold = 64 * KB;
+  static const int64_t kFlushIntervalMillis = 50;
+  // Writers wait for the background thread beyond this many pending bytes.
+  static const intptr_t kMaxPendingBytes = 4 * MB;
+
+  static bool enabled() { return enabled_; }
+  static void set_enabled(bool enabled) { enabled_ = enabled; }
+
+  // Whether writes to [fd] should go through Write.
+  static bool IsBuffered(intptr_t fd) {
+    return enabled_ && ((fd == kStdoutFd) || (fd == kStderrFd));
+  }
+
+  // Blocks while more than kMaxPendingBytes are waiting to be written.
+  static void WaitForSpace();
+
+  // Queues a copy of [data] to be written to [fd]. Never blocks on I/O.
+  static void Write(intptr_t fd, const uint8_t* data, intptr_t length);
+
+  // Writes all output queued so far before returning. Called on exit.
+  static void Flush();
+
+ private:
+  struct Segment;
+
+  static const intptr_t kStdoutFd = 1;
+  static const intptr_t kStderrFd = 2;
+
+  // Requires monitor_.
+  static void StartWriterLocked();
+  static void WriterThread(uword unused);
+  static void WriteSegments(Segment* segments);
+
+  static bool enabled_;
+  static Monitor* monitor_;
+  static bool writer_started_;
+  // Set while some thread writes a batch of segments outside the monitor.
+  static bool writing_;
+  static Segment* head_;
+  static Segment* tail_;
+  static intptr_t pending_bytes_;
+  static File* stdout_;
+  static File* stderr_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(BufferedStdio);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // RUNTIME_BIN_BUFFERED_STDIO_H_
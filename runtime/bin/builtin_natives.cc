@@ -11,6 +11,7 @@
 
 #include "platform/assert.h"
 
+#include "bin/buffered_stdio.h"
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
 #include "bin/embedded_dart_io.h"
@@ -89,6 +90,19 @@ void FUNCTION_NAME(Builtin_PrintString)(Dart_NativeArguments args) {
     Dart_PropagateError(result);
   }
 
+  if (BufferedStdio::IsBuffered(STDOUT_FILENO)) {
+    // Keep the order of print() and stdout writes. The writer thread reports
+    // the output to the service if it is captured.
+    uint8_t newline[] = {'\n'};
+    {
+      ScopedBlockingCall blocker;
+      BufferedStdio::WaitForSpace();
+    }
+    BufferedStdio::Write(STDOUT_FILENO, chars, length);
+    BufferedStdio::Write(STDOUT_FILENO, newline, sizeof(newline));
+    return;
+  }
+
   // Uses fwrite to support printing NUL bytes.
   intptr_t res = fwrite(chars, 1, length, stdout);
   ASSERT(res == length);
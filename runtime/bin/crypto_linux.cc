@@ -5,8 +5,10 @@
 #include "platform/globals.h"
 #if defined(HOST_OS_LINUX)
 
-#include <errno.h>  // NOLINT
-#include <fcntl.h>  // NOLINT
+#include <errno.h>        // NOLINT
+#include <fcntl.h>        // NOLINT
+#include <sys/syscall.h>  // NOLINT
+#include <unistd.h>       // NOLINT
 
 #include "bin/crypto.h"
 #include "bin/fdutils.h"
@@ -15,8 +17,31 @@
 namespace dart {
 namespace bin {
 
+// Reads from the urandom source without opening a file descriptor. Returns
+// false if the kernel does not support getrandom(2).
+static bool GetRandomBytesFromSyscall(intptr_t count, uint8_t* buffer) {
+#if defined(SYS_getrandom)
+  intptr_t bytes_read = 0;
+  while (bytes_read < count) {
+    const intptr_t res = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
+        syscall(SYS_getrandom, buffer + bytes_read, count - bytes_read, 0));
+    if (res < 0) {
+      // E.g. ENOSYS before Linux 3.17. The caller falls back to the device.
+      return false;
+    }
+    bytes_read += res;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 bool Crypto::GetRandomBytes(intptr_t count, uint8_t* buffer) {
   ThreadSignalBlocker signal_blocker(SIGPROF);
+  if (GetRandomBytesFromSyscall(count, buffer)) {
+    return true;
+  }
   intptr_t fd =
       TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(open("/dev/urandom", O_RDONLY));
   if (fd < 0) {
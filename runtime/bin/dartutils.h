@@ -301,10 +301,14 @@ class CObject {
   bool IsDouble() { return type() == Dart_CObject_kDouble; }
   bool IsString() { return type() == Dart_CObject_kString; }
   bool IsArray() { return type() == Dart_CObject_kArray; }
-  bool IsTypedData() { return type() == Dart_CObject_kTypedData; }
+  // Large typed data posted from Dart arrives as external typed data, which
+  // shares the type, length and data layout of typed data.
+  bool IsTypedData() {
+    return type() == Dart_CObject_kTypedData ||
+           type() == Dart_CObject_kExternalTypedData;
+  }
   bool IsUint8Array() {
-    return type() == Dart_CObject_kTypedData &&
-           byte_array_type() == Dart_TypedData_kUint8;
+    return IsTypedData() && byte_array_type() == Dart_TypedData_kUint8;
   }
   bool IsSendPort() { return type() == Dart_CObject_kSendPort; }
 
@@ -382,13 +386,13 @@ class CObject {
 
 #define DECLARE_COBJECT_TYPED_DATA_CONSTRUCTORS(t)                             \
   explicit CObject##t##Array(Dart_CObject* cobject) : CObject(cobject) {       \
-    ASSERT(type() == Dart_CObject_kTypedData);                                 \
+    ASSERT(IsTypedData());                                                     \
     ASSERT(byte_array_type() == Dart_TypedData_k##t);                          \
     cobject_ = cobject;                                                        \
   }                                                                            \
   explicit CObject##t##Array(CObject* cobject) : CObject() {                   \
     ASSERT(cobject != NULL);                                                   \
-    ASSERT(cobject->type() == Dart_CObject_kTypedData);                        \
+    ASSERT(cobject->IsTypedData());                                            \
     ASSERT(cobject->byte_array_type() == Dart_TypedData_k##t);                 \
     cobject_ = cobject->AsApiCObject();                                        \
   }
@@ -516,12 +520,12 @@ class CObjectSendPort : public CObject {
 class CObjectTypedData : public CObject {
  public:
   explicit CObjectTypedData(Dart_CObject* cobject) : CObject(cobject) {
-    ASSERT(type() == Dart_CObject_kTypedData);
+    ASSERT(IsTypedData());
     cobject_ = cobject;
   }
   explicit CObjectTypedData(CObject* cobject) : CObject() {
     ASSERT(cobject != NULL);
-    ASSERT(cobject->type() == Dart_CObject_kTypedData);
+    ASSERT(cobject->IsTypedData());
     cobject_ = cobject->AsApiCObject();
   }
 
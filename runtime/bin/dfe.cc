@@ -8,9 +8,13 @@
 #include "bin/directory.h"
 #include "bin/error_exit.h"
 #include "bin/file.h"
+#include "bin/lockers.h"
+#include "bin/log.h"
 #include "bin/platform.h"
+#include "bin/process.h"
 #include "bin/utils.h"
 #include "include/dart_tools_api.h"
+#include "platform/text_buffer.h"
 #include "platform/utils.h"
 #include "vm/os.h"
 
@@ -83,8 +87,13 @@ DFE::DFE()
     : use_dfe_(false),
       use_incremental_compiler_(false),
       frontend_filename_(NULL),
+      kernel_cache_directory_(NULL),
       application_kernel_buffer_(NULL),
-      application_kernel_buffer_size_(0) {}
+      application_kernel_buffer_size_(0),
+      shared_kernels_lock_(new Mutex()),
+      shared_kernels_(NULL),
+      shared_kernels_count_(0),
+      shared_kernels_bytes_(0) {}
 
 DFE::~DFE() {
   if (frontend_filename_ != NULL) {
@@ -92,9 +101,23 @@ DFE::~DFE() {
   }
   frontend_filename_ = NULL;
 
+  free(kernel_cache_directory_);
+  kernel_cache_directory_ = NULL;
+
   free(application_kernel_buffer_);
   application_kernel_buffer_ = NULL;
   application_kernel_buffer_size_ = 0;
+
+  while (shared_kernels_ != NULL) {
+    SharedKernel* next = shared_kernels_->next;
+    free(shared_kernels_->script_uri);
+    free(shared_kernels_->package_config);
+    free(shared_kernels_->buffer);
+    delete shared_kernels_;
+    shared_kernels_ = next;
+  }
+  delete shared_kernels_lock_;
+  shared_kernels_lock_ = NULL;
 }
 
 void DFE::Init() {
@@ -260,6 +283,378 @@ void DFE::ReadScript(const char* script_uri,
                      Dart_Timeline_Event_Duration, 0, NULL, NULL);
 }
 
+// Compares two strings, either of which may be NULL.
+static bool SameString(const char* a, const char* b) {
+  if ((a == NULL) || (b == NULL)) {
+    return a == b;
+  }
+  return strcmp(a, b) == 0;
+}
+
+DFE::SharedKernel* DFE::FindSharedKernel(const char* script_uri,
+                                         bool strong,
+                                         const char* package_config) {
+  for (SharedKernel* kernel = shared_kernels_; kernel != NULL;
+       kernel = kernel->next) {
+    if ((kernel->strong == strong) &&
+        (strcmp(kernel->script_uri, script_uri) == 0) &&
+        SameString(kernel->package_config, package_config)) {
+      return kernel;
+    }
+  }
+  return NULL;
+}
+
+bool DFE::LookupSharedKernel(const char* script_uri,
+                             bool strong,
+                             const char* package_config,
+                             const uint8_t** kernel_buffer,
+                             intptr_t* kernel_buffer_size) {
+  MutexLocker ml(shared_kernels_lock_);
+  SharedKernel* kernel = FindSharedKernel(script_uri, strong, package_config);
+  if (kernel == NULL) {
+    return false;
+  }
+  *kernel_buffer = kernel->buffer;
+  *kernel_buffer_size = kernel->size;
+  return true;
+}
+
+bool DFE::ShareKernel(const char* script_uri,
+                      bool strong,
+                      const char* package_config,
+                      uint8_t** kernel_buffer,
+                      intptr_t* kernel_buffer_size) {
+  ASSERT(*kernel_buffer != NULL);
+  MutexLocker ml(shared_kernels_lock_);
+  SharedKernel* kernel = FindSharedKernel(script_uri, strong, package_config);
+  if (kernel != NULL) {
+    // Lost a race with another isolate starting the same script.
+    free(*kernel_buffer);
+    *kernel_buffer = kernel->buffer;
+    *kernel_buffer_size = kernel->size;
+    return true;
+  }
+  // Isolates keep using the shared buffers they were given, so none can be
+  // evicted. Once the limits are reached, new programs are not shared.
+  if ((shared_kernels_count_ >= kMaxSharedKernels) ||
+      (*kernel_buffer_size > kMaxSharedKernelBytes - shared_kernels_bytes_)) {
+    return false;
+  }
+  kernel = new SharedKernel();
+  kernel->script_uri = strdup(script_uri);
+  kernel->strong = strong;
+  kernel->package_config =
+      (package_config == NULL) ? NULL : strdup(package_config);
+  kernel->buffer = *kernel_buffer;
+  kernel->size = *kernel_buffer_size;
+  kernel->next = shared_kernels_;
+  shared_kernels_ = kernel;
+  shared_kernels_count_++;
+  shared_kernels_bytes_ += kernel->size;
+  return true;
+}
+
+static uint64_t KernelCacheHash(uint64_t hash,
+                                const void* data,
+                                intptr_t size) {
+  // FNV-1a.
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  for (intptr_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+static const uint64_t kKernelCacheHashSeed = 14695981039346656037ULL;
+
+// Hashes the contents of the file at 'path'. Returns false if it cannot be
+// read, e.g. because it was deleted.
+static bool HashFileContents(const char* path, uint64_t* hash) {
+  File* file = File::Open(NULL, path, File::kRead);
+  if (file == NULL) {
+    return false;
+  }
+  RefCntReleaseScope<File> rs(file);
+  int64_t remaining = file->Length();
+  if (remaining < 0) {
+    return false;
+  }
+  const intptr_t kChunkSize = 64 * KB;
+  uint8_t* chunk = reinterpret_cast<uint8_t*>(malloc(kChunkSize));
+  uint64_t result = kKernelCacheHashSeed;
+  bool success = true;
+  while (success && (remaining > 0)) {
+    const intptr_t size =
+        remaining < kChunkSize ? static_cast<intptr_t>(remaining) : kChunkSize;
+    success = file->ReadFully(chunk, size);
+    result = KernelCacheHash(result, chunk, size);
+    remaining -= size;
+  }
+  free(chunk);
+  *hash = result;
+  return success;
+}
+
+// Returns the canonical path of the package config the frontend compiles
+// the script at 'script_path' with, or NULL if there is none: the given
+// 'package_config' URI, or else the nearest '.packages' file in the script's
+// directory or one of its parents.
+static char* ResolvePackageConfig(const char* script_path,
+                                  const char* package_config) {
+  if (package_config != NULL) {
+    const char* path = (strncmp(package_config, "file:///", 8) == 0)
+                           ? package_config + 7
+                           : package_config;
+    const char* canonical = File::GetCanonicalPath(NULL, path);
+    return (canonical != NULL) ? strdup(canonical) : NULL;
+  }
+  const char separator = File::PathSeparator()[0];
+  char* directory = DartUtils::DirName(script_path);
+  char* result = NULL;
+  while (result == NULL) {
+    char* candidate = OS::SCreate(NULL, "%s.packages", directory);
+    if (File::Exists(NULL, candidate)) {
+      result = candidate;
+      break;
+    }
+    free(candidate);
+    // 'directory' ends with a separator; cut it back to the previous one.
+    intptr_t length = strlen(directory) - 1;
+    while ((length > 0) && (directory[length - 1] != separator)) {
+      length--;
+    }
+    if (length <= 0) {
+      break;
+    }
+    directory[length] = '\0';
+  }
+  free(directory);
+  return result;
+}
+
+// Returns the name of the kernel cache entry for the script, without an
+// extension, or NULL if the script is not a local file. The entry holds
+// '<name>.dill', the program, and '<name>.deps', the hash and path of every
+// file it was compiled from, including the package config. Sets
+// '*package_config_path' to the package config the script resolves to.
+static char* KernelCacheEntryName(const char* directory,
+                                  const char* script_uri,
+                                  bool strong,
+                                  const char* package_config,
+                                  char** package_config_path) {
+  // Relative script paths name different scripts in different directories.
+  const char* script_path = File::GetCanonicalPath(NULL, script_uri);
+  if (script_path == NULL) {
+    return NULL;
+  }
+  *package_config_path = ResolvePackageConfig(script_path, package_config);
+  uint64_t hash = kKernelCacheHashSeed;
+  // Include the terminators so that adjacent strings cannot run together.
+  hash = KernelCacheHash(hash, script_path, strlen(script_path) + 1);
+  const char* version = Dart_VersionString();
+  hash = KernelCacheHash(hash, version, strlen(version) + 1);
+  hash = KernelCacheHash(hash, &strong, sizeof(strong));
+  if (*package_config_path != NULL) {
+    hash = KernelCacheHash(hash, *package_config_path,
+                           strlen(*package_config_path) + 1);
+  }
+  return OS::SCreate(NULL, "%s%s%016" Px64, directory,
+                     File::PathSeparator(), hash);
+}
+
+// Appends the '<hash> <path>' line for 'path' to 'deps'. Returns false if the
+// file cannot be read, or if it was modified at or after 'compile_start'
+// (in seconds), in which case the compiled program may not match the hash.
+static bool AddKernelCacheDependency(TextBuffer* deps,
+                                     const char* path,
+                                     int64_t compile_start) {
+  uint64_t hash = 0;
+  if ((strchr(path, '\n') != NULL) || !HashFileContents(path, &hash)) {
+    return false;
+  }
+  const int64_t modified = File::LastModified(NULL, path);
+  if ((modified < 0) || (modified >= compile_start)) {
+    return false;
+  }
+  deps->Printf("%016" Px64 " %s\n", hash, path);
+  return true;
+}
+
+static bool ReadWholeFile(const char* path, uint8_t** buffer, intptr_t* size) {
+  File* file = File::Open(NULL, path, File::kRead);
+  if (file == NULL) {
+    return false;
+  }
+  RefCntReleaseScope<File> rs(file);
+  const int64_t length = file->Length();
+  if (length <= 0) {
+    return false;
+  }
+  *buffer = reinterpret_cast<uint8_t*>(malloc(length + 1));
+  if (!file->ReadFully(*buffer, length)) {
+    free(*buffer);
+    *buffer = NULL;
+    return false;
+  }
+  (*buffer)[length] = '\0';
+  *size = length;
+  return true;
+}
+
+// Writes 'data' to 'path' through a temporary file, so that concurrent runs
+// never read a partially written entry.
+static bool WriteWholeFile(const char* path,
+                           const void* data,
+                           intptr_t size) {
+  char* temp_path = OS::SCreate(NULL, "%s.%" Pd ".tmp", path,
+                                Process::CurrentProcessId());
+  File* file = File::Open(NULL, temp_path, File::kWriteTruncate);
+  bool success = false;
+  if (file != NULL) {
+    success = file->WriteFully(data, size);
+    file->Release();
+    success = success && File::Rename(NULL, temp_path, path);
+    if (!success) {
+      File::Delete(NULL, temp_path);
+    }
+  }
+  free(temp_path);
+  return success;
+}
+
+bool DFE::LookupCachedKernel(const char* script_uri,
+                             bool strong,
+                             const char* package_config,
+                             uint8_t** kernel_buffer,
+                             intptr_t* kernel_buffer_size) {
+  if (kernel_cache_directory_ == NULL) {
+    return false;
+  }
+  char* package_config_path = NULL;
+  char* entry = KernelCacheEntryName(kernel_cache_directory_, script_uri,
+                                     strong, package_config,
+                                     &package_config_path);
+  free(package_config_path);
+  if (entry == NULL) {
+    return false;
+  }
+  char* deps_path = OS::SCreate(NULL, "%s.deps", entry);
+  char* dill_path = OS::SCreate(NULL, "%s.dill", entry);
+  free(entry);
+
+  uint8_t* deps = NULL;
+  intptr_t deps_size = 0;
+  bool valid = ReadWholeFile(deps_path, &deps, &deps_size);
+  // Each line is '<hash> <path>'.
+  char* line = reinterpret_cast<char*>(deps);
+  while (valid && (*line != '\0')) {
+    char* end = strchr(line, '\n');
+    if (end == NULL) {
+      valid = false;
+      break;
+    }
+    *end = '\0';
+    char* path = NULL;
+    const uint64_t expected = strtoull(line, &path, 16);
+    uint64_t actual = 0;
+    valid = (*path == ' ') && HashFileContents(path + 1, &actual) &&
+            (actual == expected);
+    line = end + 1;
+  }
+  free(deps);
+  free(deps_path);
+
+  if (valid) {
+    valid = TryReadKernelFile(dill_path, kernel_buffer, kernel_buffer_size);
+  }
+  free(dill_path);
+  return valid;
+}
+
+int64_t DFE::KernelCacheClock() {
+  return OS::GetCurrentTimeMillis();
+}
+
+void DFE::CacheKernel(const char* script_uri,
+                      bool strong,
+                      const char* package_config,
+                      const uint8_t* kernel_buffer,
+                      intptr_t kernel_buffer_size,
+                      int64_t compile_start_millis) {
+  if (kernel_cache_directory_ == NULL) {
+    return;
+  }
+  if (Directory::Exists(NULL, kernel_cache_directory_) != Directory::EXISTS) {
+    Log::PrintErr("Kernel cache directory does not exist: %s\n",
+                  kernel_cache_directory_);
+    return;
+  }
+  char* package_config_path = NULL;
+  char* entry = KernelCacheEntryName(kernel_cache_directory_, script_uri,
+                                     strong, package_config,
+                                     &package_config_path);
+  if (entry == NULL) {
+    return;
+  }
+  Dart_KernelCompilationResult result = Dart_KernelListDependencies();
+  if (result.status != Dart_KernelCompilationStatus_Ok) {
+    free(result.error);
+    free(package_config_path);
+    free(entry);
+    return;
+  }
+
+  // The files are hashed after the compilation, so a file modified while it
+  // ran may have been compiled with other contents than the ones hashed.
+  // Such programs are not cached. File times have a resolution of seconds.
+  const int64_t compile_start = compile_start_millis / kMillisecondsPerSecond;
+  TextBuffer deps(1024);
+  // The package config decides which files the package imports resolve to.
+  bool success =
+      (package_config_path == NULL) ||
+      AddKernelCacheDependency(&deps, package_config_path, compile_start);
+  free(package_config_path);
+
+  // The dependencies are a space separated list of paths in which spaces
+  // and backslashes are escaped with a backslash, as in depfiles.
+  char* path = reinterpret_cast<char*>(malloc(result.kernel_size + 1));
+  intptr_t i = 0;
+  while (success && (i < result.kernel_size)) {
+    intptr_t length = 0;
+    while ((i < result.kernel_size) && (result.kernel[i] != ' ')) {
+      if ((result.kernel[i] == '\\') && (i + 1 < result.kernel_size)) {
+        i++;
+      }
+      path[length++] = result.kernel[i++];
+    }
+    i++;  // Skip the separator.
+    path[length] = '\0';
+    if (length == 0) {
+      continue;
+    }
+    success = AddKernelCacheDependency(&deps, path, compile_start);
+  }
+  free(path);
+  free(result.kernel);
+  if (!success) {
+    free(entry);
+    return;
+  }
+
+  char* deps_path = OS::SCreate(NULL, "%s.deps", entry);
+  char* dill_path = OS::SCreate(NULL, "%s.dill", entry);
+  free(entry);
+  // The program is written first: a lookup only reads it once the
+  // dependencies matched.
+  if (WriteWholeFile(dill_path, kernel_buffer, kernel_buffer_size)) {
+    WriteWholeFile(deps_path, deps.buf(), deps.length());
+  }
+  free(deps_path);
+  free(dill_path);
+}
+
 bool DFE::TryReadKernelFile(const char* script_uri,
                             uint8_t** kernel_ir,
                             intptr_t* kernel_ir_size) {
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_BIN_DFE_H_
 #define RUNTIME_BIN_DFE_H_
 
+#include "bin/thread.h"
 #include "include/dart_api.h"
 #include "include/dart_native_api.h"
 #include "platform/assert.h"
@@ -39,6 +40,13 @@ class DFE {
   }
   bool use_incremental_compiler() const { return use_incremental_compiler_; }
 
+  // With a kernel cache directory, programs compiled from source are kept
+  // there and reused by later runs whose source files are unchanged.
+  void set_kernel_cache_directory(const char* directory) {
+    free(kernel_cache_directory_);
+    kernel_cache_directory_ = strdup(directory);
+  }
+
   // Returns the platform binary file name if the path to
   // kernel binaries was set using SetKernelBinaries.
   const char* GetPlatformBinaryFilename();
@@ -80,6 +88,58 @@ class DFE {
                   uint8_t** kernel_buffer,
                   intptr_t* kernel_buffer_size) const;
 
+  // Kernel programs are shared by all isolates running the same script with
+  // the same compilation inputs, e.g. the workers started with Isolate.spawn,
+  // so that a spawn does not read or compile the program again. A program is
+  // keyed on 'script_uri', 'strong' and 'package_config', which is NULL for
+  // programs read from kernel files. Shared buffers live until the DFE is
+  // destroyed, so at most kMaxSharedKernels programs totalling
+  // kMaxSharedKernelBytes are shared.
+  //
+  // Looks up the program previously shared for these inputs.
+  bool LookupSharedKernel(const char* script_uri,
+                          bool strong,
+                          const char* package_config,
+                          const uint8_t** kernel_buffer,
+                          intptr_t* kernel_buffer_size);
+
+  // Shares 'kernel_buffer' for these inputs and returns true if the DFE now
+  // owns it. If another isolate shared a program for the same inputs first,
+  // the given buffer is freed and replaced by the shared one. Returns false,
+  // leaving the buffer to the caller, if the program does not fit.
+  bool ShareKernel(const char* script_uri,
+                   bool strong,
+                   const char* package_config,
+                   uint8_t** kernel_buffer,
+                   intptr_t* kernel_buffer_size);
+
+  // Reads the program cached for 'script_uri' by a previous run, if the VM
+  // version, the package config and all source files it was compiled from
+  // are unchanged. The caller is responsible for free()ing 'kernel_buffer'
+  // if `true` was returned.
+  bool LookupCachedKernel(const char* script_uri,
+                          bool strong,
+                          const char* package_config,
+                          uint8_t** kernel_buffer,
+                          intptr_t* kernel_buffer_size);
+
+  // Writes the program just compiled for 'script_uri' by the current
+  // isolate to the kernel cache, together with the source files it was
+  // compiled from. 'compile_start_millis' is the KernelCacheClock() time
+  // the compilation started at: files modified since then are not trusted to
+  // match the program, which is then not cached. Failures are ignored: the
+  // next run compiles again.
+  void CacheKernel(const char* script_uri,
+                   bool strong,
+                   const char* package_config,
+                   const uint8_t* kernel_buffer,
+                   intptr_t kernel_buffer_size,
+                   int64_t compile_start_millis);
+
+  // The current wall clock time in milliseconds, comparable to file
+  // modification times.
+  static int64_t KernelCacheClock();
+
   static bool KernelServiceDillAvailable();
 
   // Tries to read [script_uri] as a Kernel IR file.
@@ -107,11 +167,32 @@ class DFE {
   bool use_dfe_;
   bool use_incremental_compiler_;
   char* frontend_filename_;
+  char* kernel_cache_directory_;
 
   // Kernel binary specified on the cmd line.
   uint8_t* application_kernel_buffer_;
   intptr_t application_kernel_buffer_size_;
 
+  static const intptr_t kMaxSharedKernels = 16;
+  static const intptr_t kMaxSharedKernelBytes = 256 * MB;
+
+  struct SharedKernel {
+    char* script_uri;
+    bool strong;
+    char* package_config;
+    uint8_t* buffer;
+    intptr_t size;
+    SharedKernel* next;
+  };
+  SharedKernel* FindSharedKernel(const char* script_uri,
+                                 bool strong,
+                                 const char* package_config);
+
+  Mutex* shared_kernels_lock_;
+  SharedKernel* shared_kernels_;
+  intptr_t shared_kernels_count_;
+  intptr_t shared_kernels_bytes_;
+
   DISALLOW_COPY_AND_ASSIGN(DFE);
 };
 
@@ -87,9 +87,20 @@ ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
 
   if (fd_ == -1) {
     ASSERT(lister_ == 0);
-    NamespaceScope ns(listing->namespc(), listing->path_buffer().AsString());
-    const int listingfd =
-        TEMP_FAILURE_RETRY(openat64(ns.fd(), ns.path(), O_DIRECTORY));
+    int listingfd;
+    if (parent_ != NULL) {
+      // Open subdirectories relative to the parent's descriptor, so the
+      // kernel does not resolve the whole path again for every directory.
+      const char* name =
+          listing->path_buffer().AsString() + parent_->path_length_;
+      listingfd = TEMP_FAILURE_RETRY(
+          openat64(parent_->fd_, name, O_DIRECTORY));
+    } else {
+      NamespaceScope ns(listing->namespc(),
+                        listing->path_buffer().AsString());
+      listingfd = TEMP_FAILURE_RETRY(
+          openat64(ns.fd(), ns.path(), O_DIRECTORY));
+    }
     if (listingfd < 0) {
       done_ = true;
       return kListError;
@@ -148,13 +159,12 @@ ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
         // On some file systems the entry type is not determined by
         // readdir. For those and for links we use stat to determine
         // the actual entry type. Notice that stat returns the type of
-        // the file pointed to.
-        NamespaceScope ns(listing->namespc(),
-                          listing->path_buffer().AsString());
+        // the file pointed to. The entry is looked up relative to the
+        // open directory rather than by its full path.
         struct stat64 entry_info;
         int stat_success;
-        stat_success = TEMP_FAILURE_RETRY(
-            fstatat64(ns.fd(), ns.path(), &entry_info, AT_SYMLINK_NOFOLLOW));
+        stat_success = TEMP_FAILURE_RETRY(fstatat64(
+            fd_, entry->d_name, &entry_info, AT_SYMLINK_NOFOLLOW));
         if (stat_success == -1) {
           return kListError;
         }
@@ -171,7 +181,7 @@ ListType DirectoryListingEntry::Next(DirectoryListing* listing) {
             previous = previous->next;
           }
           stat_success =
-              TEMP_FAILURE_RETRY(fstatat64(ns.fd(), ns.path(), &entry_info, 0));
+              TEMP_FAILURE_RETRY(fstatat64(fd_, entry->d_name, &entry_info, 0));
           if (stat_success == -1) {
             // Report a broken link as a link, even if follow_links is true.
             return kListLink;
@@ -55,17 +55,41 @@ void TimeoutQueue::UpdateTimeout(Dart_Port port, int64_t timeout) {
   }
 }
 
-static EventHandler* event_handler = NULL;
+// On Windows all overlapped I/O is bound to the single completion port of the
+// first event handler, and Fuchsia has not been taught to share its ports.
+#if defined(HOST_OS_WINDOWS) || defined(HOST_OS_FUCHSIA)
+static const intptr_t kMaxEventHandlerThreads = 1;
+#else
+static const intptr_t kMaxEventHandlerThreads = 64;
+#endif
+
+intptr_t EventHandler::thread_count_ = 1;
+static EventHandler** event_handlers = NULL;
 static Monitor* shutdown_monitor = NULL;
 
+void EventHandler::set_thread_count(intptr_t count) {
+  ASSERT(event_handlers == NULL);
+  if (count < 1) {
+    count = 1;
+  } else if (count > kMaxEventHandlerThreads) {
+    count = kMaxEventHandlerThreads;
+  }
+  thread_count_ = count;
+}
+
 void EventHandler::Start() {
   // Initialize global socket registry.
   ListeningSocketRegistry::Initialize();
 
-  ASSERT(event_handler == NULL);
+  ASSERT(event_handlers == NULL);
   shutdown_monitor = new Monitor();
-  event_handler = new EventHandler();
-  event_handler->delegate_.Start(event_handler);
+  event_handlers = new EventHandler*[thread_count_];
+  for (intptr_t i = 0; i < thread_count_; i++) {
+    event_handlers[i] = new EventHandler();
+  }
+  for (intptr_t i = 0; i < thread_count_; i++) {
+    event_handlers[i]->delegate_.Start(event_handlers[i]);
+  }
 }
 
 void EventHandler::NotifyShutdownDone() {
@@ -74,22 +98,25 @@ void EventHandler::NotifyShutdownDone() {
 }
 
 void EventHandler::Stop() {
-  if (event_handler == NULL) {
+  if (event_handlers == NULL) {
     return;
   }
 
-  // Wait until it has stopped.
-  {
+  // Stop the threads one at a time, waiting until each has stopped.
+  for (intptr_t i = 0; i < thread_count_; i++) {
     MonitorLocker ml(shutdown_monitor);
 
     // Signal to event handler that we want it to stop.
-    event_handler->delegate_.Shutdown();
+    event_handlers[i]->delegate_.Shutdown();
     ml.Wait(Monitor::kNoTimeout);
   }
 
   // Cleanup
-  delete event_handler;
-  event_handler = NULL;
+  for (intptr_t i = 0; i < thread_count_; i++) {
+    delete event_handlers[i];
+  }
+  delete[] event_handlers;
+  event_handlers = NULL;
   delete shutdown_monitor;
   shutdown_monitor = NULL;
 
@@ -98,14 +125,27 @@ void EventHandler::Stop() {
 }
 
 EventHandlerImplementation* EventHandler::delegate() {
-  if (event_handler == NULL) {
+  if (event_handlers == NULL) {
     return NULL;
   }
-  return &event_handler->delegate_;
+  return &event_handlers[0]->delegate_;
+}
+
+EventHandler* EventHandler::ForId(intptr_t id) {
+  if ((thread_count_ == 1) || (id == kTimerId)) {
+    return event_handlers[0];
+  }
+  // Route by descriptor rather than by Socket so that all Sockets sharing a
+  // descriptor, and the messages closing and reopening it, are handled by
+  // the same thread.
+  Socket* socket = reinterpret_cast<Socket*>(id);
+  uintptr_t hash = static_cast<uintptr_t>(socket->fd());
+  hash ^= hash >> 7;
+  return event_handlers[hash % thread_count_];
 }
 
 void EventHandler::SendFromNative(intptr_t id, Dart_Port port, int64_t data) {
-  event_handler->SendData(id, port, data);
+  ForId(id)->SendData(id, port, data);
 }
 
 /*
@@ -134,7 +174,7 @@ void FUNCTION_NAME(EventHandler_SendData)(Dart_NativeArguments args) {
     id = reinterpret_cast<intptr_t>(socket);
   }
   int64_t data = DartUtils::GetIntegerValue(Dart_GetNativeArgument(args, 2));
-  event_handler->SendData(id, dart_port, data);
+  EventHandler::SendFromNative(id, dart_port, data);
 }
 
 void FUNCTION_NAME(EventHandler_TimerMillisecondClock)(
@@ -639,12 +639,27 @@ class EventHandler {
    */
   static void Stop();
 
+  // The delegate of the first event handler thread. On Windows, where there
+  // is only one, this owns the completion port.
   static EventHandlerImplementation* delegate();
 
   static void SendFromNative(intptr_t id, Dart_Port port, int64_t data);
 
+  // Sets the number of event handler threads started by Start(). Sockets are
+  // spread over the threads by file descriptor, so every socket sharing a
+  // descriptor, e.g. a listening socket shared through the
+  // ListeningSocketRegistry, is served by the same thread. Timers are always
+  // served by the first thread.
+  static void set_thread_count(intptr_t count);
+  static intptr_t thread_count() { return thread_count_; }
+
  private:
   friend class EventHandlerImplementation;
+
+  static EventHandler* ForId(intptr_t id);
+
+  static intptr_t thread_count_;
+
   EventHandlerImplementation delegate_;
 
   DISALLOW_COPY_AND_ASSIGN(EventHandler);
@@ -133,17 +133,42 @@ EventHandlerImplementation::~EventHandlerImplementation() {
   VOID_TEMP_FAILURE_RETRY(close(interrupt_fds_[1]));
 }
 
+// Re-arms an edge-triggered descriptor with its current mask. Modifying the
+// registration makes epoll report readiness that is already pending, so
+// edges seen while the mask was 0 are not lost.
+static void RearmInEpollInstance(intptr_t epoll_fd_, DescriptorInfo* di) {
+  ASSERT(!di->IsListeningSocket());
+  struct epoll_event event;
+  event.events = EPOLLRDHUP | EPOLLET | di->GetPollEvents();
+  event.data.ptr = di;
+  int status =
+      NO_RETRY_EXPECTED(epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, di->fd(), &event));
+  if (status == -1) {
+    // Not registered yet, or not a descriptor epoll accepts. Adding it
+    // handles both cases.
+    AddToEpollInstance(epoll_fd_, di);
+  }
+}
+
 void EventHandlerImplementation::UpdateEpollInstance(intptr_t old_mask,
                                                      DescriptorInfo* di) {
   intptr_t new_mask = di->Mask();
-  if ((old_mask != 0) && (new_mask == 0)) {
-    RemoveFromEpollInstance(epoll_fd_, di);
-  } else if ((old_mask == 0) && (new_mask != 0)) {
-    AddToEpollInstance(epoll_fd_, di);
-  } else if ((old_mask != 0) && (new_mask != 0) && (old_mask != new_mask)) {
-    ASSERT(!di->IsListeningSocket());
-    RemoveFromEpollInstance(epoll_fd_, di);
-    AddToEpollInstance(epoll_fd_, di);
+  if (di->IsListeningSocket()) {
+    // Listening sockets are level-triggered and must not stay registered
+    // without a listener.
+    if ((old_mask != 0) && (new_mask == 0)) {
+      RemoveFromEpollInstance(epoll_fd_, di);
+    } else if ((old_mask == 0) && (new_mask != 0)) {
+      AddToEpollInstance(epoll_fd_, di);
+    }
+    return;
+  }
+  // Other descriptors are edge-triggered. They stay registered while their
+  // mask is 0 and the events reported meanwhile are ignored, which saves
+  // removing and re-adding them every time Dart runs out of tokens or
+  // toggles interest.
+  if ((new_mask != 0) && (new_mask != old_mask)) {
+    RearmInEpollInstance(epoll_fd_, di);
   }
 }
 
@@ -191,10 +216,16 @@ void EventHandlerImplementation::WakeupHandler(intptr_t id,
 }
 
 void EventHandlerImplementation::HandleInterruptFd() {
-  const intptr_t MAX_MESSAGES = kInterruptMessageSize;
+  const intptr_t MAX_MESSAGES = 64;
   InterruptMessage msg[MAX_MESSAGES];
   ssize_t bytes = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
       read(interrupt_fds_[0], msg, MAX_MESSAGES * kInterruptMessageSize));
+  // Mask changes are applied to the epoll instance once per descriptor,
+  // after all messages read here are handled, starting from the mask the
+  // descriptor had before the first of them.
+  DescriptorInfo* updated[MAX_MESSAGES];
+  intptr_t updated_old_masks[MAX_MESSAGES];
+  intptr_t updated_count = 0;
   for (ssize_t i = 0; i < bytes / kInterruptMessageSize; i++) {
     if (msg[i].id == kTimerId) {
       timeout_queue_.UpdateTimeout(msg[i].dart_port, msg[i].data);
@@ -222,12 +253,22 @@ void EventHandlerImplementation::HandleInterruptFd() {
         // Close the socket and free system resources and move on to next
         // message.
         intptr_t old_mask = di->Mask();
+        for (intptr_t j = 0; j < updated_count; j++) {
+          if (updated[j] == di) {
+            old_mask = updated_old_masks[j];
+            updated[j] = NULL;
+          }
+        }
         Dart_Port port = msg[i].dart_port;
         if (port != ILLEGAL_PORT) {
           di->RemovePort(port);
         }
         intptr_t new_mask = di->Mask();
         UpdateEpollInstance(old_mask, di);
+        if (!di->IsListeningSocket()) {
+          // Edge-triggered descriptors may still be registered.
+          RemoveFromEpollInstance(epoll_fd_, di);
+        }
 
         intptr_t fd = di->fd();
         ASSERT(fd == socket->fd());
@@ -256,24 +297,39 @@ void EventHandlerImplementation::HandleInterruptFd() {
           socket->SetClosedFd();
         }
         DartUtils::PostInt32(port, 1 << kDestroyedEvent);
-      } else if (IS_COMMAND(msg[i].data, kReturnTokenCommand)) {
-        int count = TOKEN_COUNT(msg[i].data);
-        intptr_t old_mask = di->Mask();
-        di->ReturnTokens(msg[i].dart_port, count);
-        UpdateEpollInstance(old_mask, di);
-      } else if (IS_COMMAND(msg[i].data, kSetEventMaskCommand)) {
-        // `events` can only have kInEvent/kOutEvent flags set.
-        intptr_t events = msg[i].data & EVENT_MASK;
-        ASSERT(0 == (events & ~(1 << kInEvent | 1 << kOutEvent)));
-
-        intptr_t old_mask = di->Mask();
-        di->SetPortAndMask(msg[i].dart_port, msg[i].data & EVENT_MASK);
-        UpdateEpollInstance(old_mask, di);
       } else {
-        UNREACHABLE();
+        intptr_t old_mask = di->Mask();
+        if (IS_COMMAND(msg[i].data, kReturnTokenCommand)) {
+          int count = TOKEN_COUNT(msg[i].data);
+          di->ReturnTokens(msg[i].dart_port, count);
+        } else if (IS_COMMAND(msg[i].data, kSetEventMaskCommand)) {
+          // `events` can only have kInEvent/kOutEvent flags set.
+          intptr_t events = msg[i].data & EVENT_MASK;
+          ASSERT(0 == (events & ~(1 << kInEvent | 1 << kOutEvent)));
+          di->SetPortAndMask(msg[i].dart_port, msg[i].data & EVENT_MASK);
+        } else {
+          UNREACHABLE();
+        }
+        bool seen = false;
+        for (intptr_t j = 0; j < updated_count; j++) {
+          if (updated[j] == di) {
+            seen = true;
+            break;
+          }
+        }
+        if (!seen) {
+          updated[updated_count] = di;
+          updated_old_masks[updated_count] = old_mask;
+          updated_count++;
+        }
       }
     }
   }
+  for (intptr_t i = 0; i < updated_count; i++) {
+    if (updated[i] != NULL) {
+      UpdateEpollInstance(updated_old_masks[i], updated[i]);
+    }
+  }
 }
 
 void EventHandlerImplementation::UpdateTimerFd() {
@@ -361,6 +417,11 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
       DescriptorInfo* di =
           reinterpret_cast<DescriptorInfo*>(events[i].data.ptr);
       const intptr_t old_mask = di->Mask();
+      if (old_mask == 0) {
+        // An edge-triggered descriptor that is not armed. It is re-armed
+        // once its mask becomes non-zero.
+        continue;
+      }
       const intptr_t event_mask = GetPollEvents(events[i].events, di);
       if ((event_mask & (1 << kErrorEvent)) != 0) {
         di->NotifyAllDartPorts(event_mask);
@@ -382,7 +443,11 @@ void EventHandlerImplementation::HandleEvents(struct epoll_event* events,
 
 void EventHandlerImplementation::Poll(uword args) {
   ThreadSignalBlocker signal_blocker(SIGPROF);
-  static const intptr_t kMaxEvents = 16;
+  // The batch starts small and doubles whenever epoll_wait fills it, so busy
+  // servers drain many ready descriptors per call.
+  static const intptr_t kMinEvents = 16;
+  static const intptr_t kMaxEvents = 1024;
+  intptr_t max_events = kMinEvents;
   struct epoll_event events[kMaxEvents];
   EventHandler* handler = reinterpret_cast<EventHandler*>(args);
   EventHandlerImplementation* handler_impl = &handler->delegate_;
@@ -390,7 +455,7 @@ void EventHandlerImplementation::Poll(uword args) {
 
   while (!handler_impl->shutdown_) {
     intptr_t result = TEMP_FAILURE_RETRY_NO_SIGNAL_BLOCKER(
-        epoll_wait(handler_impl->epoll_fd_, events, kMaxEvents, -1));
+        epoll_wait(handler_impl->epoll_fd_, events, max_events, -1));
     ASSERT(EAGAIN == EWOULDBLOCK);
     if (result <= 0) {
       if (errno != EWOULDBLOCK) {
@@ -398,6 +463,9 @@ void EventHandlerImplementation::Poll(uword args) {
       }
     } else {
       handler_impl->HandleEvents(events, result);
+      if ((result == max_events) && (max_events < kMaxEvents)) {
+        max_events *= 2;
+      }
     }
   }
   DEBUG_ASSERT(ReferenceCounted<Socket>::instances() == 0);
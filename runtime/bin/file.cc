@@ -225,6 +225,57 @@ void FUNCTION_NAME(File_Read)(Dart_NativeArguments args) {
   }
 }
 
+static void UnmapFinalizer(void* isolate_data,
+                           Dart_WeakPersistentHandle handle,
+                           void* peer) {
+  delete reinterpret_cast<MappedMemory*>(peer);
+}
+
+void FUNCTION_NAME(File_Map)(Dart_NativeArguments args) {
+  // Mappings start at a multiple of the largest page size or allocation
+  // granularity of the supported platforms.
+  const int64_t kMapAlignment = 64 * KB;
+  File* file = GetFile(args);
+  ASSERT(file != NULL);
+  int64_t position = 0;
+  int64_t length = 0;
+  if (!DartUtils::GetInt64Value(Dart_GetNativeArgument(args, 1), &position) ||
+      !DartUtils::GetInt64Value(Dart_GetNativeArgument(args, 2), &length) ||
+      (position < 0) || (length <= 0) || (length > kIntptrMax)) {
+    OSError os_error(-1, "Invalid argument", OSError::kUnknown);
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+    return;
+  }
+#if defined(HOST_OS_FUCHSIA)
+  OSError os_error(-1, "Not supported", OSError::kUnknown);
+  Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+#else
+  const int64_t offset = position % kMapAlignment;
+  if (length > kIntptrMax - offset) {
+    OSError os_error(-1, "Invalid argument", OSError::kUnknown);
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+    return;
+  }
+  MappedMemory* mapping =
+      file->Map(File::kReadWrite, position - offset, offset + length);
+  if (mapping == NULL) {
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+    return;
+  }
+  // The mapped pages are backed by the file, so they are not reported to the
+  // GC as external allocation.
+  Dart_Handle result = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kUint8,
+      reinterpret_cast<uint8_t*>(mapping->address()) + offset, length, mapping,
+      0, UnmapFinalizer);
+  if (Dart_IsError(result)) {
+    delete mapping;
+    Dart_PropagateError(result);
+  }
+  Dart_SetReturnValue(args, result);
+#endif  // defined(HOST_OS_FUCHSIA)
+}
+
 void FUNCTION_NAME(File_ReadInto)(Dart_NativeArguments args) {
   File* file = GetFile(args);
   ASSERT(file != NULL);
@@ -100,6 +100,9 @@ class File : public ReferenceCounted<File> {
   enum MapType {
     kReadOnly = 0,
     kReadExecute = 1,
+    // A private copy-on-write mapping. Writes are not carried through to
+    // the file.
+    kReadWrite = 2,
   };
   MappedMemory* Map(MapType type, int64_t position, int64_t length);
 
@@ -86,6 +86,9 @@ MappedMemory* File::Map(MapType type, int64_t position, int64_t length) {
     case kReadExecute:
       prot = PROT_READ | PROT_EXEC;
       break;
+    case kReadWrite:
+      prot = PROT_READ | PROT_WRITE;
+      break;
     default:
       return NULL;
   }
@@ -74,6 +74,7 @@ class _RandomAccessFileOpsImpl extends NativeFieldWrapperClass1
   readByte() native "File_ReadByte";
   read(int bytes) native "File_Read";
   readInto(List<int> buffer, int start, int end) native "File_ReadInto";
+  map(int position, int length) native "File_Map";
   writeByte(int value) native "File_WriteByte";
   writeFrom(List<int> buffer, int start, int end) native "File_WriteFrom";
   position() native "File_Position";
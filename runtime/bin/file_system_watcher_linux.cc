@@ -13,6 +13,7 @@
 #include "bin/fdutils.h"
 #include "bin/file.h"
 #include "bin/socket.h"
+#include "platform/hashmap.h"
 #include "platform/signal_blocker.h"
 
 namespace dart {
@@ -100,11 +101,29 @@ static int InotifyEventToMask(struct inotify_event* e) {
   return mask;
 }
 
+static const char* InotifyEventName(struct inotify_event* e) {
+  return e->len > 0 ? e->name : "";
+}
+
+static bool SameInotifyEventPath(void* key1, void* key2) {
+  struct inotify_event* e1 = reinterpret_cast<struct inotify_event*>(key1);
+  struct inotify_event* e2 = reinterpret_cast<struct inotify_event*>(key2);
+  return (e1->wd == e2->wd) &&
+         (strcmp(InotifyEventName(e1), InotifyEventName(e2)) == 0);
+}
+
+static uint32_t InotifyEventPathHash(struct inotify_event* e) {
+  char* name = const_cast<char*>(InotifyEventName(e));
+  return HashMap::StringHash(name) ^ static_cast<uint32_t>(e->wd);
+}
+
 Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
   USE(path_id);
   const intptr_t kEventSize = sizeof(struct inotify_event);
-  const intptr_t kBufferSize = kEventSize + NAME_MAX + 1;
-  uint8_t buffer[kBufferSize];
+  // Read as many events as are queued, up to 64KB, so that a burst of
+  // changes is delivered in a few large lists rather than one at a time.
+  const intptr_t kBufferSize = 64 * KB;
+  uint8_t* buffer = Dart_ScopeAllocate(kBufferSize);
   intptr_t bytes =
       SocketBase::Read(id, buffer, kBufferSize, SocketBase::kAsync);
   if (bytes < 0) {
@@ -112,30 +131,46 @@ Dart_Handle FileSystemWatcher::ReadEvents(intptr_t id, intptr_t path_id) {
   }
   const intptr_t kMaxCount = bytes / kEventSize;
   Dart_Handle events = Dart_NewList(kMaxCount);
+  // Modification events already reported in this batch, by path. Repeated
+  // writes to the same file only need to be reported once, as long as
+  // nothing else happened to the path in between.
+  const int kModifyMask = IN_CLOSE_WRITE | IN_ATTRIB;
+  HashMap modified(&SameInotifyEventPath, 16);
   intptr_t offset = 0;
   intptr_t i = 0;
   while (offset < bytes) {
     struct inotify_event* e =
         reinterpret_cast<struct inotify_event*>(buffer + offset);
-    if ((e->mask & IN_IGNORED) == 0) {
-      Dart_Handle event = Dart_NewList(5);
-      int mask = InotifyEventToMask(e);
-      Dart_ListSetAt(event, 0, Dart_NewInteger(mask));
-      Dart_ListSetAt(event, 1, Dart_NewInteger(e->cookie));
-      if (e->len > 0) {
-        Dart_ListSetAt(
-            event, 2,
-            Dart_NewStringFromUTF8(reinterpret_cast<uint8_t*>(e->name),
-                                   strlen(e->name)));
-      } else {
-        Dart_ListSetAt(event, 2, Dart_Null());
+    offset += kEventSize + e->len;
+    if ((e->mask & IN_IGNORED) != 0) {
+      continue;
+    }
+    const uint32_t hash = InotifyEventPathHash(e);
+    if ((e->mask & ~(kModifyMask | IN_ISDIR)) == 0) {
+      HashMap::Entry* entry = modified.Lookup(e, hash, true);
+      const intptr_t seen = reinterpret_cast<intptr_t>(entry->value);
+      if ((e->mask & ~seen) == 0) {
+        continue;
       }
-      Dart_ListSetAt(event, 3, Dart_NewBoolean(e->mask & IN_MOVED_TO));
-      Dart_ListSetAt(event, 4, Dart_NewInteger(e->wd));
-      Dart_ListSetAt(events, i, event);
-      i++;
+      entry->value = reinterpret_cast<void*>(seen | e->mask);
+    } else {
+      modified.Remove(e, hash);
     }
-    offset += kEventSize + e->len;
+    Dart_Handle event = Dart_NewList(5);
+    int mask = InotifyEventToMask(e);
+    Dart_ListSetAt(event, 0, Dart_NewInteger(mask));
+    Dart_ListSetAt(event, 1, Dart_NewInteger(e->cookie));
+    if (e->len > 0) {
+      Dart_ListSetAt(event, 2,
+                     Dart_NewStringFromUTF8(reinterpret_cast<uint8_t*>(e->name),
+                                            strlen(e->name)));
+    } else {
+      Dart_ListSetAt(event, 2, Dart_Null());
+    }
+    Dart_ListSetAt(event, 3, Dart_NewBoolean(e->mask & IN_MOVED_TO));
+    Dart_ListSetAt(event, 4, Dart_NewInteger(e->wd));
+    Dart_ListSetAt(events, i, event);
+    i++;
   }
   ASSERT(offset == bytes);
   return events;
@@ -85,6 +85,10 @@ MappedMemory* File::Map(File::MapType type, int64_t position, int64_t length) {
       prot_alloc = PAGE_EXECUTE_READWRITE;
       prot_final = PAGE_EXECUTE_READ;
       break;
+    case File::kReadWrite:
+      prot_alloc = PAGE_READWRITE;
+      prot_final = PAGE_READWRITE;
+      break;
     default:
       return NULL;
   }
@@ -6,6 +6,7 @@
 
 #include "bin/dartutils.h"
 #include "bin/io_buffer.h"
+#include "bin/lockers.h"
 
 #include "include/dart_api.h"
 
@@ -283,39 +284,114 @@ Dart_Handle Filter::GetFilterNativeField(Dart_Handle filter,
       reinterpret_cast<intptr_t*>(filter_pointer));
 }
 
+// A pool of deflate streams that have been reset, so that they can be reused
+// by new filters with the same parameters without allocating zlib's internal
+// state again.
+class DeflateStreamPool {
+ public:
+  static z_stream* Acquire(int level,
+                           int window_bits,
+                           int mem_level,
+                           int strategy) {
+    MutexLocker locker(mutex_);
+    for (intptr_t i = 0; i < count_; i++) {
+      Entry* entry = &entries_[i];
+      if ((entry->level == level) && (entry->window_bits == window_bits) &&
+          (entry->mem_level == mem_level) && (entry->strategy == strategy)) {
+        z_stream* stream = entry->stream;
+        entries_[i] = entries_[--count_];
+        return stream;
+      }
+    }
+    return NULL;
+  }
+
+  // Takes ownership of a stream that has been reset.
+  static void Release(z_stream* stream,
+                      int level,
+                      int window_bits,
+                      int mem_level,
+                      int strategy) {
+    {
+      MutexLocker locker(mutex_);
+      if (count_ < kMaxStreams) {
+        Entry entry = {stream, level, window_bits, mem_level, strategy};
+        entries_[count_++] = entry;
+        return;
+      }
+    }
+    deflateEnd(stream);
+    delete stream;
+  }
+
+ private:
+  static const intptr_t kMaxStreams = 8;
+
+  struct Entry {
+    z_stream* stream;
+    int level;
+    int window_bits;
+    int mem_level;
+    int strategy;
+  };
+
+  static Mutex* mutex_;
+  static Entry entries_[kMaxStreams];
+  static intptr_t count_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(DeflateStreamPool);
+};
+
+Mutex* DeflateStreamPool::mutex_ = new Mutex();
+DeflateStreamPool::Entry DeflateStreamPool::entries_[kMaxStreams];
+intptr_t DeflateStreamPool::count_ = 0;
+
 ZLibDeflateFilter::~ZLibDeflateFilter() {
   delete[] dictionary_;
   delete[] current_buffer_;
-  if (initialized()) {
-    deflateEnd(&stream_);
+  if (stream_ != NULL) {
+    if (initialized()) {
+      deflateEnd(stream_);
+    }
+    delete stream_;
   }
 }
 
-bool ZLibDeflateFilter::Init() {
-  int window_bits = window_bits_;
+int ZLibDeflateFilter::WindowBits() const {
   if (raw_) {
-    window_bits = -window_bits;
+    return -window_bits_;
   } else if (gzip_) {
-    window_bits += kZLibFlagUseGZipHeader;
+    return window_bits_ + kZLibFlagUseGZipHeader;
   }
-  stream_.next_in = Z_NULL;
-  stream_.zalloc = Z_NULL;
-  stream_.zfree = Z_NULL;
-  stream_.opaque = Z_NULL;
-  int result = deflateInit2(&stream_, level_, Z_DEFLATED, window_bits,
-                            mem_level_, strategy_);
-  if (result != Z_OK) {
-    return false;
+  return window_bits_;
+}
+
+bool ZLibDeflateFilter::Init() {
+  const int window_bits = WindowBits();
+  stream_ =
+      DeflateStreamPool::Acquire(level_, window_bits, mem_level_, strategy_);
+  if (stream_ == NULL) {
+    stream_ = new z_stream();
+    stream_->next_in = Z_NULL;
+    stream_->zalloc = Z_NULL;
+    stream_->zfree = Z_NULL;
+    stream_->opaque = Z_NULL;
+    int result = deflateInit2(stream_, level_, Z_DEFLATED, window_bits,
+                              mem_level_, strategy_);
+    if (result != Z_OK) {
+      return false;
+    }
   }
+  set_initialized(true);
   if ((dictionary_ != NULL) && !gzip_ && !raw_) {
-    result = deflateSetDictionary(&stream_, dictionary_, dictionary_length_);
+    int result = deflateSetDictionary(stream_, dictionary_, dictionary_length_);
     delete[] dictionary_;
     dictionary_ = NULL;
     if (result != Z_OK) {
       return false;
     }
   }
-  set_initialized(true);
   return true;
 }
 
@@ -323,8 +399,13 @@ bool ZLibDeflateFilter::Process(uint8_t* data, intptr_t length) {
   if (current_buffer_ != NULL) {
     return false;
   }
-  stream_.avail_in = length;
-  stream_.next_in = current_buffer_ = data;
+  if (stream_ == NULL) {
+    // The stream has ended. Processed reports the error.
+    current_buffer_ = data;
+    return true;
+  }
+  stream_->avail_in = length;
+  stream_->next_in = current_buffer_ = data;
   return true;
 }
 
@@ -332,24 +413,38 @@ intptr_t ZLibDeflateFilter::Processed(uint8_t* buffer,
                                       intptr_t length,
                                       bool flush,
                                       bool end) {
-  stream_.avail_out = length;
-  stream_.next_out = buffer;
   bool error = false;
-  switch (
-      deflate(&stream_, end ? Z_FINISH : flush ? Z_SYNC_FLUSH : Z_NO_FLUSH)) {
-    case Z_STREAM_END:
-    case Z_BUF_ERROR:
-    case Z_OK: {
-      intptr_t processed = length - stream_.avail_out;
-      if (processed == 0) {
-        break;
+  if (stream_ == NULL) {
+    // Like zlib, only accept further calls to finish an ended stream.
+    error = !end;
+  } else {
+    stream_->avail_out = length;
+    stream_->next_out = buffer;
+    int result =
+        deflate(stream_, end ? Z_FINISH : flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+    switch (result) {
+      case Z_STREAM_END:
+      case Z_BUF_ERROR:
+      case Z_OK: {
+        intptr_t processed = length - stream_->avail_out;
+        if (result == Z_STREAM_END) {
+          // All output has been produced, so the stream can be reused.
+          if (deflateReset(stream_) == Z_OK) {
+            DeflateStreamPool::Release(stream_, level_, WindowBits(),
+                                       mem_level_, strategy_);
+            stream_ = NULL;
+          }
+        }
+        if (processed == 0) {
+          break;
+        }
+        return processed;
       }
-      return processed;
-    }
 
-    default:
-    case Z_STREAM_ERROR:
-      error = true;
+      default:
+      case Z_STREAM_ERROR:
+        error = true;
+    }
   }
 
   delete[] current_buffer_;
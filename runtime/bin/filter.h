@@ -70,7 +70,8 @@ class ZLibDeflateFilter : public Filter {
         dictionary_(dictionary),
         dictionary_length_(dictionary_length),
         raw_(raw),
-        current_buffer_(NULL) {}
+        current_buffer_(NULL),
+        stream_(NULL) {}
   virtual ~ZLibDeflateFilter();
 
   virtual bool Init();
@@ -90,7 +91,12 @@ class ZLibDeflateFilter : public Filter {
   const intptr_t dictionary_length_;
   const bool raw_;
   uint8_t* current_buffer_;
-  z_stream stream_;
+  // Taken from and returned to a pool of streams shared by all filters, as
+  // allocating zlib's window and hash tables for every filter is expensive.
+  // NULL once the stream has ended.
+  z_stream* stream_;
+
+  int WindowBits() const;
 
   DISALLOW_COPY_AND_ASSIGN(ZLibDeflateFilter);
 };
@@ -82,5 +82,37 @@ void Decompress(const uint8_t* input,
   *output_length = output_cursor;
 }
 
+void Compress(const uint8_t* input,
+              intptr_t input_len,
+              uint8_t** output,
+              intptr_t* output_length) {
+  ASSERT(input != NULL);
+  ASSERT(input_len > 0);
+  ASSERT(output != NULL);
+  ASSERT(output_length != NULL);
+
+  z_stream strm;
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+  // Window bits over 15 write a gzip header and trailer.
+  int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                         16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  ASSERT(ret == Z_OK);
+
+  // The bound holds the whole stream, so a single call finishes it.
+  intptr_t output_capacity = deflateBound(&strm, input_len);
+  *output = reinterpret_cast<uint8_t*>(malloc(output_capacity));
+  strm.avail_in = input_len;
+  strm.next_in = const_cast<uint8_t*>(input);
+  strm.avail_out = output_capacity;
+  strm.next_out = *output;
+  ret = deflate(&strm, Z_FINISH);
+  ASSERT(ret == Z_STREAM_END);
+
+  *output_length = output_capacity - strm.avail_out;
+  deflateEnd(&strm);
+}
+
 }  // namespace bin
 }  // namespace dart
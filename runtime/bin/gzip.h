@@ -18,6 +18,14 @@ void Decompress(const uint8_t* input,
                 uint8_t** output,
                 intptr_t* output_length);
 
+// Compresses |input| into a gzipped stream that Decompress can read.
+// This function allocates the output buffer in the C heap and the caller
+// is responsible for freeing it.
+void Compress(const uint8_t* input,
+              intptr_t input_len,
+              uint8_t** output,
+              intptr_t* output_length);
+
 }  // namespace bin
 }  // namespace dart
 
@@ -0,0 +1,252 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "bin/host_lookup_cache.h"
+
+#include "bin/lockers.h"
+#include "bin/thread.h"
+#include "bin/utils.h"
+#include "platform/hashmap.h"
+
+namespace dart {
+namespace bin {
+
+struct HostLookupKey {
+  const char* host;
+  int type;
+
+  uint32_t Hash() const {
+    return HashMap::StringHash(const_cast<char*>(host)) + type;
+  }
+
+  static bool Matches(void* key1, void* key2) {
+    HostLookupKey* a = reinterpret_cast<HostLookupKey*>(key1);
+    HostLookupKey* b = reinterpret_cast<HostLookupKey*>(key2);
+    return (a->type == b->type) && (strcmp(a->host, b->host) == 0);
+  }
+};
+
+// The result of looking up one (host, type) pair. While pending, the lookup
+// is being performed by some thread and must not be removed.
+class CachedHostLookup {
+ public:
+  CachedHostLookup(const char* host, int type)
+      : pending_(true),
+        expires_(0),
+        addresses_(NULL),
+        count_(0),
+        error_code_(0),
+        error_message_(NULL),
+        next_(NULL),
+        previous_(NULL) {
+    key_.host = strdup(host);
+    key_.type = type;
+  }
+
+  ~CachedHostLookup() {
+    free(const_cast<char*>(key_.host));
+    delete[] addresses_;
+    free(error_message_);
+  }
+
+  HostLookupKey* key() { return &key_; }
+  bool pending() const { return pending_; }
+  int64_t expires() const { return expires_; }
+
+  void SetAddresses(AddressList<SocketAddress>* addresses, int64_t expires) {
+    ASSERT(pending_);
+    count_ = addresses->count();
+    addresses_ = new RawAddr[count_];
+    for (intptr_t i = 0; i < count_; i++) {
+      addresses_[i] = addresses->GetAt(i)->addr();
+    }
+    expires_ = expires;
+    pending_ = false;
+  }
+
+  void SetError(OSError* error, int64_t expires) {
+    ASSERT(pending_);
+    error_code_ = error->code();
+    error_message_ =
+        (error->message() == NULL) ? NULL : strdup(error->message());
+    expires_ = expires;
+    pending_ = false;
+  }
+
+  // Returns a copy of the result in the form SocketBase::LookupAddress
+  // returns it.
+  AddressList<SocketAddress>* Result(OSError** os_error) const {
+    ASSERT(!pending_);
+    if (addresses_ == NULL) {
+      ASSERT(*os_error == NULL);
+      *os_error = new OSError(error_code_, error_message_,
+                              OSError::kGetAddressInfo);
+      return NULL;
+    }
+    AddressList<SocketAddress>* addresses =
+        new AddressList<SocketAddress>(count_);
+    for (intptr_t i = 0; i < count_; i++) {
+      RawAddr addr = addresses_[i];
+      addresses->SetAt(i, new SocketAddress(&addr.addr));
+    }
+    return addresses;
+  }
+
+  CachedHostLookup* next() const { return next_; }
+  void set_next(CachedHostLookup* next) { next_ = next; }
+  CachedHostLookup* previous() const { return previous_; }
+  void set_previous(CachedHostLookup* previous) { previous_ = previous; }
+
+ private:
+  HostLookupKey key_;
+  bool pending_;
+  int64_t expires_;
+
+  // Set if the lookup succeeded.
+  RawAddr* addresses_;
+  intptr_t count_;
+
+  // Set if the lookup failed.
+  int error_code_;
+  char* error_message_;
+
+  // All entries are linked so they can be evicted without iterating the map.
+  CachedHostLookup* next_;
+  CachedHostLookup* previous_;
+
+  DISALLOW_COPY_AND_ASSIGN(CachedHostLookup);
+};
+
+int HostLookupCache::ttl_seconds_ = 0;
+Monitor* HostLookupCache::monitor_ = new Monitor();
+HashMap* HostLookupCache::entries_ = NULL;
+CachedHostLookup* HostLookupCache::head_ = NULL;
+
+// Only a lookup failing because the name does not exist is an answer worth
+// remembering. Anything else, e.g. EAI_AGAIN, may go away on the next try.
+static bool IsNegativeAnswer(OSError* error) {
+  return (error->sub_system() == OSError::kGetAddressInfo) &&
+         (error->code() == EAI_NONAME);
+}
+
+CachedHostLookup* HostLookupCache::Find(const char* host, int type) {
+  if (entries_ == NULL) {
+    return NULL;
+  }
+  HostLookupKey key = {host, type};
+  HashMap::Entry* entry = entries_->Lookup(&key, key.Hash(), false);
+  return (entry == NULL) ? NULL
+                         : reinterpret_cast<CachedHostLookup*>(entry->value);
+}
+
+void HostLookupCache::Remove(CachedHostLookup* lookup) {
+  ASSERT(!lookup->pending());
+  entries_->Remove(lookup->key(), lookup->key()->Hash());
+  if (lookup->previous() == NULL) {
+    head_ = lookup->next();
+  } else {
+    lookup->previous()->set_next(lookup->next());
+  }
+  if (lookup->next() != NULL) {
+    lookup->next()->set_previous(lookup->previous());
+  }
+  delete lookup;
+}
+
+void HostLookupCache::Evict(int64_t now) {
+  CachedHostLookup* lookup = head_;
+  while (lookup != NULL) {
+    CachedHostLookup* next = lookup->next();
+    if (!lookup->pending() && (lookup->expires() <= now)) {
+      Remove(lookup);
+    }
+    lookup = next;
+  }
+  if (entries_->size() < kMaxEntries) {
+    return;
+  }
+  lookup = head_;
+  while (lookup != NULL) {
+    CachedHostLookup* next = lookup->next();
+    if (!lookup->pending()) {
+      Remove(lookup);
+    }
+    lookup = next;
+  }
+}
+
+AddressList<SocketAddress>* HostLookupCache::Lookup(const char* host,
+                                                    int type,
+                                                    OSError** os_error) {
+  if (ttl_seconds_ <= 0) {
+    return SocketBase::LookupAddress(host, type, os_error);
+  }
+  {
+    MonitorLocker ml(monitor_);
+    while (true) {
+      CachedHostLookup* lookup = Find(host, type);
+      if (lookup == NULL) {
+        break;
+      }
+      if (lookup->pending()) {
+        // Another thread is looking up the same host. Use its answer.
+        ml.Wait();
+        continue;
+      }
+      if (lookup->expires() > TimerUtils::GetCurrentMonotonicMillis()) {
+        return lookup->Result(os_error);
+      }
+      Remove(lookup);
+      break;
+    }
+    if (entries_ == NULL) {
+      entries_ = new HashMap(&HostLookupKey::Matches, 64);
+    } else if (entries_->size() >= kMaxEntries) {
+      Evict(TimerUtils::GetCurrentMonotonicMillis());
+    }
+    CachedHostLookup* lookup = new CachedHostLookup(host, type);
+    HashMap::Entry* entry =
+        entries_->Lookup(lookup->key(), lookup->key()->Hash(), true);
+    ASSERT(entry->value == NULL);
+    entry->value = lookup;
+    lookup->set_next(head_);
+    if (head_ != NULL) {
+      head_->set_previous(lookup);
+    }
+    head_ = lookup;
+  }
+
+  OSError* error = NULL;
+  AddressList<SocketAddress>* addresses =
+      SocketBase::LookupAddress(host, type, &error);
+
+  {
+    MonitorLocker ml(monitor_);
+    // Pending entries are never removed by other threads.
+    CachedHostLookup* lookup = Find(host, type);
+    ASSERT((lookup != NULL) && lookup->pending());
+    const int64_t now = TimerUtils::GetCurrentMonotonicMillis();
+    if (addresses != NULL) {
+      const int64_t ttl =
+          static_cast<int64_t>(ttl_seconds_) * kMillisecondsPerSecond;
+      lookup->SetAddresses(addresses, now + ttl);
+    } else if (IsNegativeAnswer(error)) {
+      const int ttl = (ttl_seconds_ < kMaxNegativeTtlSeconds)
+                          ? ttl_seconds_
+                          : kMaxNegativeTtlSeconds;
+      lookup->SetError(error, now + ttl * kMillisecondsPerSecond);
+    } else {
+      lookup->SetError(error, now);
+      Remove(lookup);
+    }
+    ml.NotifyAll();
+  }
+
+  ASSERT(*os_error == NULL);
+  *os_error = error;
+  return addresses;
+}
+
+}  // namespace bin
+}  // namespace dart
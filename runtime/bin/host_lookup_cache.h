@@ -0,0 +1,57 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_BIN_HOST_LOOKUP_CACHE_H_
+#define RUNTIME_BIN_HOST_LOOKUP_CACHE_H_
+
+#include "bin/socket_base.h"
+#include "platform/globals.h"
+
+namespace dart {
+namespace bin {
+
+class CachedHostLookup;
+
+// A process-wide cache in front of SocketBase::LookupAddress.
+//
+// Successful lookups are kept for ttl_seconds(). Lookups failing because the
+// host does not exist are kept for at most kMaxNegativeTtlSeconds. Other
+// failures are not cached. Concurrent lookups of a host that is not cached
+// wait for a single call to SocketBase::LookupAddress instead of each
+// occupying an IO thread. The cache is disabled while ttl_seconds() is 0.
+class HostLookupCache {
+ public:
+  static const int kMaxNegativeTtlSeconds = 5;
+  static const intptr_t kMaxEntries = 1024;
+
+  // Same contract as SocketBase::LookupAddress.
+  static AddressList<SocketAddress>* Lookup(const char* host,
+                                            int type,
+                                            OSError** os_error);
+
+  static int ttl_seconds() { return ttl_seconds_; }
+  static void set_ttl_seconds(int ttl_seconds) { ttl_seconds_ = ttl_seconds; }
+
+ private:
+  // Returns the entry for (host, type), or NULL. Requires monitor_.
+  static CachedHostLookup* Find(const char* host, int type);
+  // Removes [lookup] from the cache and deletes it. Requires monitor_.
+  static void Remove(CachedHostLookup* lookup);
+  // Drops expired entries, or all finished entries if there are still too
+  // many. Requires monitor_.
+  static void Evict(int64_t now);
+
+  static int ttl_seconds_;
+  static Monitor* monitor_;
+  static HashMap* entries_;
+  static CachedHostLookup* head_;
+
+  DISALLOW_ALLOCATION();
+  DISALLOW_IMPLICIT_CONSTRUCTORS(HostLookupCache);
+};
+
+}  // namespace bin
+}  // namespace dart
+
+#endif  // RUNTIME_BIN_HOST_LOOKUP_CACHE_H_
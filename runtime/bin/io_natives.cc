@@ -52,6 +52,7 @@ namespace bin {
   V(File_LengthFromPath, 2)                                                    \
   V(File_LinkTarget, 2)                                                        \
   V(File_Lock, 4)                                                              \
+  V(File_Map, 3)                                                               \
   V(File_Open, 3)                                                              \
   V(File_OpenStdio, 1)                                                         \
   V(File_Position, 1)                                                          \
@@ -119,6 +120,7 @@ namespace bin {
   V(SecureSocket_RegisterBadCertificateCallback, 2)                            \
   V(SecureSocket_RegisterHandshakeCompleteCallback, 2)                         \
   V(SecureSocket_Renegotiate, 4)                                               \
+  V(SecureSocket_SetPrivateKeyOperationPort, 2)                                \
   V(SecurityContext_Allocate, 1)                                               \
   V(SecurityContext_UsePrivateKeyBytes, 3)                                     \
   V(SecurityContext_SetAlpnProtocols, 3)                                       \
@@ -143,11 +145,14 @@ namespace bin {
   V(Socket_JoinMulticast, 4)                                                   \
   V(Socket_LeaveMulticast, 4)                                                  \
   V(Socket_Read, 2)                                                            \
-  V(Socket_RecvFrom, 1)                                                        \
+  V(Socket_RecvFromMany, 1)                                                    \
+  V(Socket_SendFile, 4)                                                        \
+  V(Socket_SendFileSupported, 0)                                               \
   V(Socket_SendTo, 6)                                                          \
   V(Socket_SetOption, 4)                                                       \
   V(Socket_SetSocketId, 3)                                                     \
   V(Socket_WriteList, 4)                                                       \
+  V(Socket_WriteVector, 3)                                                     \
   V(Stdin_ReadByte, 1)                                                         \
   V(Stdin_GetEchoMode, 1)                                                      \
   V(Stdin_SetEchoMode, 2)                                                      \
@@ -156,6 +161,9 @@ namespace bin {
   V(Stdin_AnsiSupported, 1)                                                    \
   V(Stdout_GetTerminalSize, 1)                                                 \
   V(Stdout_AnsiSupported, 1)                                                   \
+  V(Stdout_BufferedWrite, 2)                                                   \
+  V(Stdout_Flush, 0)                                                           \
+  V(Stdout_IsBuffered, 1)                                                      \
   V(StringToSystemEncoding, 1)                                                 \
   V(SynchronousSocket_Available, 1)                                            \
   V(SynchronousSocket_CloseSync, 1)                                            \
@@ -9,34 +9,35 @@ class _IOServicePorts {
   // spawn too many threads all at once, which can crash the VM on Windows.
   static const int maxPorts = 32;
   List<SendPort> _ports = <SendPort>[];
-  List<SendPort> _freePorts = <SendPort>[];
-  Map<int, SendPort> _usedPorts = new HashMap<int, SendPort>();
+  // The number of pending requests using each of [_ports], and the indices of
+  // the ports that have none.
+  List<int> _useCounts = <int>[];
+  List<int> _freePorts = <int>[];
+  Map<int, int> _usedPorts = new HashMap<int, int>();
 
   _IOServicePorts();
 
   SendPort _getPort(int forRequestId) {
-    if (_freePorts.isEmpty && _usedPorts.length < maxPorts) {
-      final SendPort port = _newServicePort();
-      _ports.add(port);
-      _freePorts.add(port);
+    if (_freePorts.isEmpty && _ports.length < maxPorts) {
+      _ports.add(_newServicePort());
+      _useCounts.add(0);
+      _freePorts.add(_ports.length - 1);
     }
-    if (!_freePorts.isEmpty) {
-      final SendPort port = _freePorts.removeLast();
-      assert(!_usedPorts.containsKey(forRequestId));
-      _usedPorts[forRequestId] = port;
-      return port;
-    }
-    // We have already allocated the max number of ports. Re-use an
+    // If we have already allocated the max number of ports, re-use an
     // existing one.
-    final SendPort port = _ports[forRequestId % maxPorts];
-    _usedPorts[forRequestId] = port;
-    return port;
+    final int index = _freePorts.isEmpty
+        ? forRequestId % maxPorts
+        : _freePorts.removeLast();
+    assert(!_usedPorts.containsKey(forRequestId));
+    _usedPorts[forRequestId] = index;
+    _useCounts[index]++;
+    return _ports[index];
   }
 
   void _returnPort(int forRequestId) {
-    final SendPort port = _usedPorts.remove(forRequestId);
-    if (!_usedPorts.values.contains(port)) {
-      _freePorts.add(port);
+    final int index = _usedPorts.remove(forRequestId);
+    if (--_useCounts[index] == 0) {
+      _freePorts.add(index);
     }
   }
 
@@ -112,7 +112,8 @@ void Loader::IOResult::Setup(Dart_CObject* message) {
         reinterpret_cast<uint8_t*>(strdup(payload_message->value.as_string));
   } else {
     // Payload is the contents of a file.
-    ASSERT(payload_message->type == Dart_CObject_kTypedData);
+    ASSERT((payload_message->type == Dart_CObject_kTypedData) ||
+           (payload_message->type == Dart_CObject_kExternalTypedData));
     ASSERT(payload_message->value.as_typed_data.type == Dart_TypedData_kUint8);
     payload_length = payload_message->value.as_typed_data.length;
     payload = reinterpret_cast<uint8_t*>(malloc(payload_length));
@@ -128,6 +129,12 @@ void Loader::IOResult::Cleanup() {
   free(payload);
 }
 
+static void MallocFinalizer(void* isolate_callback_data,
+                            Dart_WeakPersistentHandle handle,
+                            void* peer) {
+  free(peer);
+}
+
 // Send the Loader Initialization message to the service isolate. This
 // message is sent the first time a loader is constructed for an isolate and
 // seeds the service isolate with some initial state about this isolate.
@@ -142,7 +149,7 @@ void Loader::Init(const char* package_root,
   // Keep in sync with loader.dart.
   const intptr_t _Dart_kInitLoader = 4;
 
-  Dart_Handle request = Dart_NewList(9);
+  Dart_Handle request = Dart_NewList(10);
   Dart_ListSetAt(request, 0, trace_loader ? Dart_True() : Dart_False());
   Dart_ListSetAt(request, 1, Dart_NewInteger(Dart_GetMainPortId()));
   Dart_ListSetAt(request, 2, Dart_NewInteger(_Dart_kInitLoader));
@@ -161,6 +168,7 @@ void Loader::Init(const char* package_root,
                      ? Dart_Null()
                      : Dart_NewStringFromCString(root_script_uri));
   Dart_ListSetAt(request, 8, Dart_NewBoolean(Dart_IsReloading()));
+  Dart_ListSetAt(request, 9, FileReaderPorts());
 
   bool success = Dart_Post(loader_port, request);
   ASSERT(success);
@@ -640,12 +648,6 @@ Dart_Handle Loader::DartColonLibraryTagHandler(Dart_LibraryTag tag,
   return Dart_Null();
 }
 #else
-static void MallocFinalizer(void* isolate_callback_data,
-                            Dart_WeakPersistentHandle handle,
-                            void* peer) {
-  free(peer);
-}
-
 Dart_Handle Loader::LibraryTagHandler(Dart_LibraryTag tag,
                                       Dart_Handle library,
                                       Dart_Handle url) {
@@ -880,6 +882,140 @@ void Loader::InitOnce() {
   loader_infos_lock_ = new Mutex();
 }
 
+Dart_Port Loader::file_reader_ports_[Loader::kFileReaderCount];
+
+Dart_Handle Loader::FileReaderPorts() {
+  {
+    MutexLocker ml(loader_infos_lock_);
+    if (file_reader_ports_[0] == ILLEGAL_PORT) {
+      for (intptr_t i = 0; i < kFileReaderCount; i++) {
+        file_reader_ports_[i] = Dart_NewNativePort(
+            "LoaderFileReader", Loader::FileReaderMessageHandler, false);
+      }
+    }
+  }
+  Dart_Handle ports = Dart_NewList(kFileReaderCount);
+  for (intptr_t i = 0; i < kFileReaderCount; i++) {
+    Dart_ListSetAt(ports, i, Dart_NewSendPort(file_reader_ports_[i]));
+  }
+  return ports;
+}
+
+// Reads all of |file|. Files reporting a zero length may be character
+// devices and are read in chunks until the end of the stream.
+static bool ReadFileContents(File* file, uint8_t** data, intptr_t* length) {
+  int64_t file_length = file->Length();
+  if ((file_length < 0) || (file_length > kIntptrMax)) {
+    return false;
+  }
+  if (file_length > 0) {
+    *length = static_cast<intptr_t>(file_length);
+    *data = reinterpret_cast<uint8_t*>(malloc(*length));
+    if (*data == NULL) {
+      OUT_OF_MEMORY();
+    }
+    if (!file->ReadFully(*data, *length)) {
+      free(*data);
+      *data = NULL;
+      return false;
+    }
+    return true;
+  }
+  const intptr_t kChunkSize = 64 * KB;
+  intptr_t capacity = 0;
+  *data = NULL;
+  *length = 0;
+  while (true) {
+    if (*length == capacity) {
+      capacity += kChunkSize;
+      *data = reinterpret_cast<uint8_t*>(realloc(*data, capacity));
+      if (*data == NULL) {
+        OUT_OF_MEMORY();
+      }
+    }
+    int64_t bytes_read = file->Read(*data + *length, capacity - *length);
+    if (bytes_read < 0) {
+      free(*data);
+      *data = NULL;
+      return false;
+    }
+    if (bytes_read == 0) {
+      return true;
+    }
+    *length += static_cast<intptr_t>(bytes_read);
+  }
+}
+
+static const char* ScopedFormat(const char* format, ...)
+    PRINTF_ATTRIBUTE(1, 2);
+
+static const char* ScopedFormat(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  va_list measure_args;
+  va_copy(measure_args, args);
+  intptr_t length = vsnprintf(NULL, 0, format, measure_args);
+  va_end(measure_args);
+  char* buffer = DartUtils::ScopedCString(length + 1);
+  vsnprintf(buffer, length + 1, format, args);
+  va_end(args);
+  return buffer;
+}
+
+// The request is [reply port, tag, uri, resolved uri, library uri, path]. The
+// reply has the same layout as the results sent by the service isolate.
+void Loader::FileReaderMessageHandler(Dart_Port dest_port_id,
+                                      Dart_CObject* message) {
+  CObjectArray request(message);
+  ASSERT((message->type == Dart_CObject_kArray) && (request.Length() == 6));
+  CObjectSendPort reply_port(request[0]);
+  CObjectInt32 tag(request[1]);
+  CObjectString uri(request[2]);
+  CObject* library_uri = request[4];
+  CObjectString path(request[5]);
+
+  uint8_t* data = NULL;
+  intptr_t length = 0;
+  OSError os_error;
+  File* file = File::Open(NULL, path.CString(), File::kRead);
+  bool success = false;
+  if (file == NULL) {
+    os_error.Reload();
+  } else {
+    success = ReadFileContents(file, &data, &length);
+    if (!success) {
+      os_error.Reload();
+    }
+    file->Release();
+  }
+
+  CObjectArray result(CObject::NewArray(5));
+  result.SetAt(1, request[2]);
+  result.SetAt(2, request[3]);
+  result.SetAt(3, library_uri);
+  if (success) {
+    result.SetAt(0, new CObjectInt32(CObject::NewInt32(tag.Value())));
+    result.SetAt(4, new CObjectExternalUint8Array(CObject::NewExternalUint8Array(
+                        length, data, data, MallocFinalizer)));
+  } else {
+    // Errors are reported with a negative tag and a message, as the service
+    // isolate does.
+    result.SetAt(0, new CObjectInt32(CObject::NewInt32(-tag.Value())));
+    const char* error;
+    if (library_uri->IsNull()) {
+      error = ScopedFormat("Could not load \"%s\"", uri.CString());
+    } else {
+      error = ScopedFormat("Could not import \"%s\" from \"%s\"",
+                           uri.CString(), CObjectString(library_uri).CString());
+    }
+    error = ScopedFormat(
+        "%s: Cannot open file, path = '%s' (OS Error: %s, errno = %d)", error,
+        path.CString(), os_error.message(), os_error.code());
+    result.SetAt(4, new CObjectString(CObject::NewString(error)));
+  }
+  Dart_PostCObject(reply_port.Value(), result.AsApiCObject());
+}
+
 Mutex* Loader::loader_infos_lock_;
 Loader::LoaderInfo* Loader::loader_infos_ = NULL;
 intptr_t Loader::loader_infos_length_ = 0;
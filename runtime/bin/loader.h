@@ -142,6 +142,21 @@ class Loader {
   static intptr_t loader_infos_length_;
   static intptr_t loader_infos_capacity_;
 
+  // Native ports that read files on behalf of the service isolate and post
+  // the contents straight back to the requesting loader. Each port handles
+  // its messages serially, so the service isolate spreads reads across them
+  // to overlap file I/O. Keep in sync with loader.dart.
+  static const intptr_t kFileReaderCount = 8;
+  static Dart_Port file_reader_ports_[kFileReaderCount];
+
+  // Returns a list of send ports for the file readers, creating them the
+  // first time.
+  static Dart_Handle FileReaderPorts();
+
+  // Reads the file in |message| and replies with a loader result.
+  static void FileReaderMessageHandler(Dart_Port dest_port_id,
+                                       Dart_CObject* message);
+
   static void AddLoader(Dart_Port port, IsolateData* data);
   static void RemoveLoader(Dart_Port port);
   static intptr_t LoaderIndexFor(Dart_Port port);
@@ -214,6 +214,22 @@ static void WriteDepsFile(Dart_Isolate isolate) {
   delete dependencies;
 }
 
+// The entry of the --jit-cache directory that belongs to the script being
+// run, or NULL if the JIT cache is not populated by this run.
+static char* jit_cache_filename = NULL;
+
+static void GenerateAppJITSnapshot() {
+  Snapshot::GenerateAppJIT(Options::snapshot_filename(),
+                           Options::compress_snapshot_data());
+  if (jit_cache_filename != NULL) {
+    // The snapshot is written under a temporary name and then moved into
+    // place, so concurrent runs never load a partially written cache entry.
+    if (!File::Rename(NULL, Options::snapshot_filename(), jit_cache_filename)) {
+      File::Delete(NULL, Options::snapshot_filename());
+    }
+  }
+}
+
 static void SnapshotOnExitHook(int64_t exit_code) {
   if (Dart_CurrentIsolate() != main_isolate) {
     Log::PrintErr(
@@ -223,7 +239,7 @@ static void SnapshotOnExitHook(int64_t exit_code) {
     Platform::Exit(kErrorExitCode);
   }
   if (exit_code == 0) {
-    Snapshot::GenerateAppJIT(Options::snapshot_filename());
+    GenerateAppJITSnapshot();
     WriteDepsFile(main_isolate);
   }
 }
@@ -343,21 +359,49 @@ static Dart_Isolate IsolateSetupHelper(Dart_Isolate isolate,
       Dart_ShutdownIsolate();
       return NULL;
     }
-    uint8_t* application_kernel_buffer = NULL;
-    intptr_t application_kernel_buffer_size = 0;
-    dfe.CompileAndReadScript(script_uri, &application_kernel_buffer,
-                             &application_kernel_buffer_size, error, exit_code,
-                             flags->strong, resolved_packages_config);
-    if (application_kernel_buffer == NULL) {
-      Dart_ExitScope();
-      Dart_ShutdownIsolate();
-      return NULL;
+    // The incremental compiler may recompile the script on reload, so only
+    // share programs produced by the one-shot compiler.
+    const bool share_kernel = !dfe.use_incremental_compiler();
+    bool shared = share_kernel &&
+                  dfe.LookupSharedKernel(script_uri, flags->strong,
+                                         resolved_packages_config,
+                                         &kernel_buffer, &kernel_buffer_size);
+    if (!shared) {
+      uint8_t* application_kernel_buffer = NULL;
+      intptr_t application_kernel_buffer_size = 0;
+      if (!share_kernel ||
+          !dfe.LookupCachedKernel(script_uri, flags->strong,
+                                  resolved_packages_config,
+                                  &application_kernel_buffer,
+                                  &application_kernel_buffer_size)) {
+        const int64_t compile_start = DFE::KernelCacheClock();
+        dfe.CompileAndReadScript(script_uri, &application_kernel_buffer,
+                                 &application_kernel_buffer_size, error,
+                                 exit_code, flags->strong,
+                                 resolved_packages_config);
+        if (application_kernel_buffer == NULL) {
+          Dart_ExitScope();
+          Dart_ShutdownIsolate();
+          return NULL;
+        }
+        if (share_kernel) {
+          dfe.CacheKernel(script_uri, flags->strong, resolved_packages_config,
+                          application_kernel_buffer,
+                          application_kernel_buffer_size, compile_start);
+        }
+      }
+      if (share_kernel) {
+        shared = dfe.ShareKernel(script_uri, flags->strong,
+                                 resolved_packages_config,
+                                 &application_kernel_buffer,
+                                 &application_kernel_buffer_size);
+      }
+      kernel_buffer = application_kernel_buffer;
+      kernel_buffer_size = application_kernel_buffer_size;
     }
-    isolate_data->set_kernel_buffer(application_kernel_buffer,
-                                    application_kernel_buffer_size,
-                                    true /*take ownership*/);
-    kernel_buffer = application_kernel_buffer;
-    kernel_buffer_size = application_kernel_buffer_size;
+    isolate_data->set_kernel_buffer(const_cast<uint8_t*>(kernel_buffer),
+                                    kernel_buffer_size,
+                                    !shared /*take ownership*/);
   }
   if (kernel_buffer != NULL) {
     Dart_Handle uri = Dart_NewStringFromCString(script_uri);
@@ -628,8 +672,9 @@ static Dart_Isolate CreateIsolateAndSetupHelper(bool is_main_isolate,
                                                 int* exit_code) {
   int64_t start = Dart_TimelineGetMicros();
   ASSERT(script_uri != NULL);
-  uint8_t* kernel_buffer = NULL;
+  const uint8_t* kernel_buffer = NULL;
   intptr_t kernel_buffer_size = 0;
+  bool owns_kernel_buffer = false;
   AppSnapshot* app_snapshot = NULL;
 
 #if defined(DART_PRECOMPILED_RUNTIME)
@@ -662,16 +707,32 @@ static Dart_Isolate CreateIsolateAndSetupHelper(bool is_main_isolate,
           &isolate_snapshot_data, &isolate_snapshot_instructions);
     }
   }
-  if (!isolate_run_app_snapshot) {
-    dfe.ReadScript(script_uri, &kernel_buffer, &kernel_buffer_size);
+  // Isolates spawned from the same script share one copy of its kernel
+  // program instead of reading it again. A kernel file does not depend on
+  // the package config.
+  if (!isolate_run_app_snapshot &&
+      !dfe.LookupSharedKernel(script_uri, flags->strong, NULL, &kernel_buffer,
+                              &kernel_buffer_size)) {
+    uint8_t* script_kernel_buffer = NULL;
+    intptr_t script_kernel_buffer_size = 0;
+    dfe.ReadScript(script_uri, &script_kernel_buffer,
+                   &script_kernel_buffer_size);
+    if (script_kernel_buffer != NULL) {
+      owns_kernel_buffer =
+          !dfe.ShareKernel(script_uri, flags->strong, NULL,
+                           &script_kernel_buffer, &script_kernel_buffer_size);
+      kernel_buffer = script_kernel_buffer;
+      kernel_buffer_size = script_kernel_buffer_size;
+    }
   }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
   IsolateData* isolate_data =
       new IsolateData(script_uri, package_root, packages_config, app_snapshot);
   if (kernel_buffer != NULL) {
-    isolate_data->set_kernel_buffer(kernel_buffer, kernel_buffer_size,
-                                    true /*take ownership*/);
+    // Unless the program could not be shared, it is owned by the DFE.
+    isolate_data->set_kernel_buffer(const_cast<uint8_t*>(kernel_buffer),
+                                    kernel_buffer_size, owns_kernel_buffer);
   }
   if (is_main_isolate && (Options::snapshot_deps_filename() != NULL)) {
     isolate_data->set_dependencies(new MallocGrowableArray<char*>());
@@ -849,7 +910,8 @@ static void GenerateAppAOTSnapshot() {
   if (Options::use_blobs()) {
     Snapshot::GenerateAppAOTAsBlobs(Options::snapshot_filename(),
                                     app_isolate_shared_data,
-                                    app_isolate_shared_instructions);
+                                    app_isolate_shared_instructions,
+                                    Options::compress_snapshot_data());
   } else {
     Snapshot::GenerateAppAOTAsAssembly(Options::snapshot_filename());
   }
@@ -1080,6 +1142,13 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
         result = Dart_LoadCompilationTrace(buffer, size);
         CHECK_RESULT(result);
       }
+      if (Options::load_type_feedback_filename() != NULL) {
+        uint8_t* buffer = NULL;
+        intptr_t size = 0;
+        ReadFile(Options::load_type_feedback_filename(), &buffer, &size);
+        result = Dart_LoadTypeFeedback(buffer, size);
+        CHECK_RESULT(result);
+      }
 
       // Create a closure for the main entry point which is in the exported
       // namespace of the root library or invoke a getter of the same name
@@ -1111,7 +1180,7 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
       // Generate an app snapshot after execution if specified.
       if (Options::gen_snapshot_kind() == kAppJIT) {
         if (!Dart_IsCompilationError(result)) {
-          Snapshot::GenerateAppJIT(Options::snapshot_filename());
+          GenerateAppJITSnapshot();
         }
       }
       CHECK_RESULT(result);
@@ -1123,6 +1192,13 @@ bool RunMainIsolate(const char* script_name, CommandLineOptions* dart_options) {
         CHECK_RESULT(result);
         WriteFile(Options::save_compilation_trace_filename(), buffer, size);
       }
+      if (Options::save_type_feedback_filename() != NULL) {
+        uint8_t* buffer = NULL;
+        intptr_t size = 0;
+        result = Dart_SaveTypeFeedback(&buffer, &size);
+        CHECK_RESULT(result);
+        WriteFile(Options::save_type_feedback_filename(), buffer, size);
+      }
     }
   }
 
@@ -1160,6 +1236,52 @@ Dart_Handle GetVMServiceAssetsArchiveCallback() {
 static Dart_GetVMServiceAssetsArchive GetVMServiceAssetsArchiveCallback = NULL;
 #endif  // !defined(DART_PRECOMPILER)
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+static uint64_t JitCacheHash(uint64_t hash, const void* data, intptr_t size) {
+  // FNV-1a.
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  for (intptr_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+// Returns the name of the --jit-cache entry for [script_name], or NULL if the
+// script cannot be cached. Only kernel files are cached: they contain the
+// whole program, so together with the VM version and the VM flags their
+// contents determine the code the JIT produces. An edited program gets a new
+// key, which invalidates all of its previously cached code.
+static char* ComputeJitCacheFilename(const char* script_name,
+                                     CommandLineOptions* vm_options) {
+  const char* directory = Options::jit_cache_directory();
+  if (Directory::Exists(NULL, directory) != Directory::EXISTS) {
+    Log::PrintErr("JIT cache directory does not exist: %s\n", directory);
+    return NULL;
+  }
+  uint8_t* kernel_buffer = NULL;
+  intptr_t kernel_buffer_size = 0;
+  if (!DFE::TryReadKernelFile(script_name, &kernel_buffer,
+                              &kernel_buffer_size)) {
+    return NULL;
+  }
+  uint64_t hash = 14695981039346656037ULL;
+  hash = JitCacheHash(hash, kernel_buffer, kernel_buffer_size);
+  free(kernel_buffer);
+  const char* version = Dart_VersionString();
+  hash = JitCacheHash(hash, version, strlen(version));
+  for (intptr_t i = 0; i < vm_options->count(); i++) {
+    const char* argument = vm_options->GetArgument(i);
+    // Include the terminator so that "--a" "b" and "--ab" differ.
+    hash = JitCacheHash(hash, argument, strlen(argument) + 1);
+  }
+  TextBuffer filename(256);
+  filename.Printf("%s%s%016" Px64 ".jit", directory, File::PathSeparator(),
+                  hash);
+  return filename.Steal();
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 void main(int argc, char** argv) {
   char* script_name;
   const int EXTRA_VM_ARGUMENTS = 10;
@@ -1259,6 +1381,29 @@ void main(int argc, char** argv) {
                              &app_isolate_snapshot_data,
                              &app_isolate_snapshot_instructions);
   }
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  if ((app_snapshot == NULL) && (Options::jit_cache_directory() != NULL) &&
+      (Options::gen_snapshot_kind() == kNone)) {
+    char* cache_filename = ComputeJitCacheFilename(script_name, &vm_options);
+    if (cache_filename != NULL) {
+      app_snapshot = Snapshot::TryReadAppSnapshot(cache_filename);
+      if (app_snapshot != NULL) {
+        vm_run_app_snapshot = true;
+        app_snapshot->SetBuffers(&vm_snapshot_data, &vm_snapshot_instructions,
+                                 &app_isolate_snapshot_data,
+                                 &app_isolate_snapshot_instructions);
+        free(cache_filename);
+      } else {
+        // Populate the cache when this run exits successfully.
+        jit_cache_filename = cache_filename;
+        TextBuffer temp_filename(256);
+        temp_filename.Printf("%s.%" Pd ".tmp", cache_filename,
+                             Process::CurrentProcessId());
+        Options::set_app_jit_snapshot_filename(temp_filename.Steal());
+      }
+    }
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
 #endif
 
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
@@ -1369,6 +1514,7 @@ void main(int argc, char** argv) {
   delete shared_blobs;
 #endif
   free(app_script_uri);
+  free(jit_cache_filename);
 
   // Free copied argument strings if converted.
   if (argv_converted) {
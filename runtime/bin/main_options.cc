@@ -8,10 +8,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "bin/buffered_stdio.h"
+#include "bin/eventhandler.h"
+#include "bin/host_lookup_cache.h"
 #include "bin/log.h"
 #include "bin/options.h"
 #include "bin/platform.h"
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
+#include "bin/secure_socket_filter.h"
 #include "bin/security_context.h"
 #endif  // !defined(DART_IO_SECURE_SOCKET_DISABLED)
 #include "bin/socket.h"
@@ -81,6 +85,9 @@ DFE* Options::dfe_ = NULL;
 // TODO(sivachandra): Make it an error to specify --dfe without
 // specifying --preview_dart_2.
 DEFINE_STRING_OPTION_CB(dfe, { Options::dfe()->set_frontend_filename(value); });
+DEFINE_STRING_OPTION_CB(kernel_cache, {
+  Options::dfe()->set_kernel_cache_directory(value);
+});
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
 DEFINE_BOOL_OPTION_CB(hot_reload_test_mode, {
@@ -154,6 +161,19 @@ void Options::PrintUsage() {
 "    <snapshot-kind> controls the kind of snapshot, it could be\n"
 "                    script(default), app-aot or app-jit\n"
 "    <file_name> specifies the file into which the snapshot is written\n"
+"--compress-snapshot-data\n"
+"  Gzip the data sections of app-jit and app-aot snapshots, which are\n"
+"  inflated into memory when the snapshot is loaded. Instructions stay\n"
+"  uncompressed.\n"
+"--jit-cache=<directory>\n"
+"  Reuse the JIT code of a previous run of the same kernel file. An app-jit\n"
+"  snapshot is written to <directory> on the first successful run and\n"
+"  loaded instead of the kernel file on later runs with the same VM and\n"
+"  flags.\n"
+"--kernel-cache=<directory>\n"
+"  Reuse the kernel compiled from a Dart source script by a previous run.\n"
+"  The kernel is kept in <directory> and recompiled when the VM version\n"
+"  or any of the script's source files or package config changed.\n"
 "--version\n"
 "  Print the VM version.\n");
   } else {
@@ -188,6 +208,19 @@ void Options::PrintUsage() {
 "    <snapshot-kind> controls the kind of snapshot, it could be\n"
 "                    script(default), app-aot or app-jit\n"
 "    <file_name> specifies the file into which the snapshot is written\n"
+"--compress-snapshot-data\n"
+"  Gzip the data sections of app-jit and app-aot snapshots, which are\n"
+"  inflated into memory when the snapshot is loaded. Instructions stay\n"
+"  uncompressed.\n"
+"--jit-cache=<directory>\n"
+"  Reuse the JIT code of a previous run of the same kernel file. An app-jit\n"
+"  snapshot is written to <directory> on the first successful run and\n"
+"  loaded instead of the kernel file on later runs with the same VM and\n"
+"  flags.\n"
+"--kernel-cache=<directory>\n"
+"  Reuse the kernel compiled from a Dart source script by a previous run.\n"
+"  The kernel is kept in <directory> and recompiled when the VM version\n"
+"  or any of the script's source files or package config changed.\n"
 "--version\n"
 "  Print the VM version.\n"
 "\n"
@@ -198,6 +231,31 @@ void Options::PrintUsage() {
 "  enables the VM service and listens on specified port for connections\n"
 "  (default port number is 8181, default bind address is localhost).\n"
 "\n"
+"--event-handler-threads=<count>\n"
+"  The number of threads dispatching socket events (default 1). Sockets\n"
+"  are spread over the threads by file descriptor. Only supported on\n"
+"  Linux, Android and macOS.\n"
+"\n"
+"--buffered-stdio\n"
+"  Collect output to stdout and stderr, including print(), in memory and\n"
+"  write it out from a background thread, at the latest 50ms after it is\n"
+"  written. Output is written out on flush() and when the process exits.\n"
+"\n"
+"--dns-cache-ttl=<seconds>\n"
+"  Keep the addresses found by host name lookups for the given number of\n"
+"  seconds, and share lookups of a host that are in progress (default 0,\n"
+"  no caching). Lookups of unknown hosts are kept for at most 5 seconds.\n"
+"\n"
+"--shared-sockets-reuse-port\n"
+"  Give every bind() of a shared server socket its own listening socket\n"
+"  with SO_REUSEPORT, so that the kernel balances incoming connections\n"
+"  over them. Only supported on Linux and Android.\n"
+"\n"
+"--tls-async-private-key\n"
+"  Run the private key operations of TLS server handshakes on a pool of\n"
+"  threads, so that a burst of new connections does not block the isolate\n"
+"  accepting them.\n"
+"\n"
 "--root-certs-file=<path>\n"
 "  The path to a file containing the trusted root certificates to use for\n"
 "  secure socket connections.\n"
@@ -276,6 +334,45 @@ bool Options::ExtractPortAndAddress(const char* option_value,
   return true;
 }
 
+int Options::event_handler_threads_ = 1;
+bool Options::ProcessEventHandlerThreadsOption(const char* arg,
+                                               CommandLineOptions* vm_options) {
+  const char* value =
+      OptionProcessor::ProcessOption(arg, "--event-handler-threads=");
+  if (value == NULL) {
+    return false;
+  }
+  char* end = NULL;
+  long threads = strtol(value, &end, 10);  // NOLINT
+  if ((end == value) || (*end != '\0') || (threads < 1)) {
+    Log::PrintErr(
+        "unrecognized --event-handler-threads option syntax. "
+        "Use --event-handler-threads=<count>\n");
+    return false;
+  }
+  event_handler_threads_ = static_cast<int>(threads);
+  return true;
+}
+
+int Options::dns_cache_ttl_ = 0;
+bool Options::ProcessDnsCacheTtlOption(const char* arg,
+                                       CommandLineOptions* vm_options) {
+  const char* value = OptionProcessor::ProcessOption(arg, "--dns-cache-ttl=");
+  if (value == NULL) {
+    return false;
+  }
+  char* end = NULL;
+  long ttl = strtol(value, &end, 10);  // NOLINT
+  if ((end == value) || (*end != '\0') || (ttl < 0) || (ttl > kMaxInt32)) {
+    Log::PrintErr(
+        "unrecognized --dns-cache-ttl option syntax. "
+        "Use --dns-cache-ttl=<seconds>\n");
+    return false;
+  }
+  dns_cache_ttl_ = static_cast<int>(ttl);
+  return true;
+}
+
 static const char* DEFAULT_VM_SERVICE_SERVER_IP = "localhost";
 static const int DEFAULT_VM_SERVICE_SERVER_PORT = 8181;
 
@@ -401,9 +498,14 @@ int Options::ParseArguments(int argc,
 
   Socket::set_short_socket_read(Options::short_socket_read());
   Socket::set_short_socket_write(Options::short_socket_write());
+  Socket::set_shared_sockets_reuse_port(Options::shared_sockets_reuse_port());
+  EventHandler::set_thread_count(Options::event_handler_threads());
+  HostLookupCache::set_ttl_seconds(Options::dns_cache_ttl());
+  BufferedStdio::set_enabled(Options::buffered_stdio());
 #if !defined(DART_IO_SECURE_SOCKET_DISABLED)
   SSLCertContext::set_root_certs_file(Options::root_certs_file());
   SSLCertContext::set_root_certs_cache(Options::root_certs_cache());
+  SSLFilter::set_async_private_key_operations(Options::tls_async_private_key());
 #endif  // !defined(DART_IO_SECURE_SOCKET_DISABLED)
 
   // The arguments to the VM are at positions 1 through i-1 in argv.
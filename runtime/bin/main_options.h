@@ -21,10 +21,13 @@ namespace bin {
   V(package_root, package_root)                                                \
   V(snapshot, snapshot_filename)                                               \
   V(snapshot_depfile, snapshot_deps_filename)                                  \
+  V(jit_cache, jit_cache_directory)                                            \
   V(shared_blobs, shared_blobs_filename)                                       \
   V(save_obfuscation_map, obfuscation_map_filename)                            \
   V(save_compilation_trace, save_compilation_trace_filename)                   \
   V(load_compilation_trace, load_compilation_trace_filename)                   \
+  V(save_type_feedback, save_type_feedback_filename)                           \
+  V(load_type_feedback, load_type_feedback_filename)                           \
   V(root_certs_file, root_certs_file)                                          \
   V(root_certs_cache, root_certs_cache)                                        \
   V(namespace, namespc)
@@ -38,10 +41,14 @@ namespace bin {
   V(disable_service_origin_check, vm_service_dev_mode)                         \
   V(deterministic, deterministic)                                              \
   V(use_blobs, use_blobs)                                                      \
+  V(compress_snapshot_data, compress_snapshot_data)                            \
   V(obfuscate, obfuscate)                                                      \
   V(trace_loading, trace_loading)                                              \
   V(short_socket_read, short_socket_read)                                      \
   V(short_socket_write, short_socket_write)                                    \
+  V(shared_sockets_reuse_port, shared_sockets_reuse_port)                      \
+  V(tls_async_private_key, tls_async_private_key)                              \
+  V(buffered_stdio, buffered_stdio)                                            \
   V(disable_exit, exit_disabled)                                               \
   V(no_preview_dart_2, no_preview_dart_2)                                      \
   V(preview_dart_2, nop_option)
@@ -62,7 +69,9 @@ namespace bin {
 #define CB_OPTIONS_LIST(V)                                                     \
   V(ProcessEnvironmentOption)                                                  \
   V(ProcessEnableVmServiceOption)                                              \
-  V(ProcessObserveOption)
+  V(ProcessObserveOption)                                                      \
+  V(ProcessEventHandlerThreadsOption)                                          \
+  V(ProcessDnsCacheTtlOption)
 
 // This enum must match the strings in kSnapshotKindNames in main_options.cc.
 enum SnapshotKind {
@@ -115,6 +124,9 @@ class Options {
 
   static dart::HashMap* environment() { return environment_; }
 
+  static int event_handler_threads() { return event_handler_threads_; }
+  static int dns_cache_ttl() { return dns_cache_ttl_; }
+
   static const char* vm_service_server_ip() { return vm_service_server_ip_; }
   static int vm_service_server_port() { return vm_service_server_port_; }
 
@@ -123,6 +135,13 @@ class Options {
   static void set_dfe(DFE* dfe) { dfe_ = dfe; }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+  // Requests an app-jit snapshot of the main isolate to be written to
+  // [filename] on exit, as if --snapshot-kind=app-jit was given.
+  static void set_app_jit_snapshot_filename(const char* filename) {
+    gen_snapshot_kind_ = kAppJIT;
+    snapshot_filename_ = filename;
+  }
+
   static void PrintUsage();
   static void PrintVersion();
 
@@ -154,6 +173,8 @@ class Options {
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
   // VM Service argument processing.
+  static int event_handler_threads_;
+  static int dns_cache_ttl_;
   static const char* vm_service_server_ip_;
   static int vm_service_server_port_;
   static bool ExtractPortAndAddress(const char* option_value,
@@ -209,37 +209,17 @@ class SignalInfo {
 
 // Utility class for collecting the output when running a process
 // synchronously by using Process::Wait. This class is sub-classed in
-// the platform specific files to implement reading into the buffers
+// the platform specific files to implement reading into the buffer
 // allocated.
+//
+// The output is collected in a single buffer which grows geometrically, and
+// which is handed to Dart as external typed data without copying it.
 class BufferListBase {
  protected:
   static const intptr_t kBufferSize = 16 * 1024;
 
-  class BufferListNode {
-   public:
-    explicit BufferListNode(intptr_t size) {
-      data_ = new uint8_t[size];
-      // We check for a failed allocation below in Allocate()
-      next_ = NULL;
-    }
-
-    ~BufferListNode() { delete[] data_; }
-
-    bool Valid() const { return data_ != NULL; }
-
-    uint8_t* data() const { return data_; }
-    BufferListNode* next() const { return next_; }
-    void set_next(BufferListNode* n) { next_ = n; }
-
-   private:
-    uint8_t* data_;
-    BufferListNode* next_;
-
-    DISALLOW_IMPLICIT_CONSTRUCTORS(BufferListNode);
-  };
-
  public:
-  BufferListBase() : head_(NULL), tail_(NULL), data_size_(0), free_size_(0) {}
+  BufferListBase() : data_(NULL), data_size_(0), free_size_(0) {}
   ~BufferListBase() {
     Free();
     DEBUG_ASSERT(IsEmpty());
@@ -248,70 +228,80 @@ class BufferListBase {
   // Returns the collected data as a Uint8List. If an error occours an
   // error handle is returned.
   Dart_Handle GetData() {
-    uint8_t* buffer;
-    intptr_t buffer_position = 0;
-    Dart_Handle result = IOBuffer::Allocate(data_size_, &buffer);
-    if (Dart_IsNull(result)) {
-      return DartUtils::NewDartOSError();
+    if (data_ == NULL) {
+      Dart_Handle result = IOBuffer::Allocate(0, NULL);
+      if (Dart_IsNull(result)) {
+        return DartUtils::NewDartOSError();
+      }
+      return result;
+    }
+    if (free_size_ > data_size_) {
+      // Give back the unused part of a buffer that is less than half full.
+      // Shrinking a block usually does not move it.
+      uint8_t* data = reinterpret_cast<uint8_t*>(
+          realloc(data_, (data_size_ > 0) ? data_size_ : 1));
+      if (data != NULL) {
+        data_ = data;
+        free_size_ = 0;
+      }
     }
+    Dart_Handle result = Dart_NewExternalTypedDataWithFinalizer(
+        Dart_TypedData_kUint8, data_, data_size_, data_, data_size_,
+        IOBuffer::Finalizer);
     if (Dart_IsError(result)) {
       Free();
       return result;
     }
-    for (BufferListNode* current = head_; current != NULL;
-         current = current->next()) {
-      intptr_t to_copy = dart::Utils::Minimum(data_size_, kBufferSize);
-      memmove(buffer + buffer_position, current->data(), to_copy);
-      buffer_position += to_copy;
-      data_size_ -= to_copy;
-    }
-    ASSERT(data_size_ == 0);
-    Free();
+    // The buffer is now owned by the typed data.
+    data_ = NULL;
+    data_size_ = 0;
+    free_size_ = 0;
     return result;
   }
 
 #if defined(DEBUG)
-  bool IsEmpty() const { return (head_ == NULL) && (tail_ == NULL); }
+  bool IsEmpty() const { return data_ == NULL; }
 #endif
 
  protected:
-  bool Allocate() {
-    ASSERT(free_size_ == 0);
-    BufferListNode* node = new BufferListNode(kBufferSize);
-    if ((node == NULL) || !node->Valid()) {
-      // Failed to allocate a buffer for the node.
-      delete node;
-      return false;
+  // Makes room for at least [size] more bytes, and at least kBufferSize.
+  bool Allocate(intptr_t size = kBufferSize) {
+    intptr_t capacity = data_size_ + free_size_;
+    const intptr_t required =
+        data_size_ + dart::Utils::Maximum(size, kBufferSize);
+    if (capacity >= required) {
+      return true;
+    }
+    if (capacity == 0) {
+      capacity = kBufferSize;
     }
-    if (head_ == NULL) {
-      head_ = node;
-      tail_ = node;
-    } else {
-      ASSERT(tail_->next() == NULL);
-      tail_->set_next(node);
-      tail_ = node;
+    while (capacity < required) {
+      capacity *= 2;
     }
-    free_size_ = kBufferSize;
+    // The buffer is released with IOBuffer::Free, so it must come from
+    // malloc.
+    uint8_t* data = reinterpret_cast<uint8_t*>(realloc(data_, capacity));
+    if (data == NULL) {
+      return false;
+    }
+    data_ = data;
+    free_size_ = capacity - data_size_;
     return true;
   }
 
   void Free() {
-    BufferListNode* current = head_;
-    while (current != NULL) {
-      BufferListNode* tmp = current;
-      current = current->next();
-      delete tmp;
+    if (data_ != NULL) {
+      IOBuffer::Free(data_);
     }
-    head_ = NULL;
-    tail_ = NULL;
+    data_ = NULL;
     data_size_ = 0;
     free_size_ = 0;
   }
 
   // Returns the address of the first byte in the free space.
-  uint8_t* FreeSpaceAddress() {
-    return tail_->data() + (kBufferSize - free_size_);
-  }
+  uint8_t* FreeSpaceAddress() { return data_ + data_size_; }
+
+  uint8_t* data() const { return data_; }
 
   intptr_t data_size() const { return data_size_; }
   void set_data_size(intptr_t size) { data_size_ = size; }
@@ -319,18 +309,14 @@ class BufferListBase {
   intptr_t free_size() const { return free_size_; }
   void set_free_size(intptr_t size) { free_size_ = size; }
 
-  BufferListNode* head() const { return head_; }
-  BufferListNode* tail() const { return tail_; }
-
  private:
-  // Linked list for data collected.
-  BufferListNode* head_;
-  BufferListNode* tail_;
+  // Buffer for the data collected.
+  uint8_t* data_;
 
-  // Number of bytes of data collected in the linked list.
+  // Number of bytes of data collected in the buffer.
   intptr_t data_size_;
 
-  // Number of free bytes in the last node in the list.
+  // Number of free bytes after the data in the buffer.
   intptr_t free_size_;
 
   DISALLOW_COPY_AND_ASSIGN(BufferListBase);
@@ -343,17 +329,16 @@ class BufferList : public BufferListBase {
   BufferList() {}
 
   bool Read(int fd, intptr_t available) {
-    // Read all available bytes.
+    // Read all available bytes, usually with a single read.
     while (available > 0) {
-      if (free_size() == 0) {
-        if (!Allocate()) {
+      if (free_size() < available) {
+        if (!Allocate(available)) {
           errno = ENOMEM;
           return false;
         }
       }
-      ASSERT(free_size() > 0);
-      ASSERT(free_size() <= kBufferSize);
-      intptr_t block_size = dart::Utils::Minimum(free_size(), available);
+      ASSERT(free_size() >= available);
+      intptr_t block_size = available;
 #if defined(HOST_OS_FUCHSIA)
       intptr_t bytes = NO_RETRY_EXPECTED(
           read(fd, reinterpret_cast<void*>(FreeSpaceAddress()), block_size));
@@ -720,7 +720,6 @@ class BufferList : public BufferListBase {
       }
     }
     ASSERT(free_size() > 0);
-    ASSERT(free_size() <= kBufferSize);
     *buffer = FreeSpaceAddress();
     *size = free_size();
     read_pending_ = true;
@@ -730,10 +729,8 @@ class BufferList : public BufferListBase {
   intptr_t GetDataSize() { return data_size(); }
 
   uint8_t* GetFirstDataBuffer() {
-    ASSERT(head() != NULL);
-    ASSERT(head() == tail());
-    ASSERT(data_size() <= kBufferSize);
-    return head()->data();
+    ASSERT(data() != NULL);
+    return data();
   }
 
   void FreeDataBuffer() { Free(); }
@@ -76,7 +76,7 @@ void TestCaseBase::RunTest() {
 void Benchmark::RunBenchmark() {
   if ((run_filter == kAllBenchmarks) ||
       (strcmp(run_filter, this->name()) == 0)) {
-    this->Run();
+    this->RunRepetitions();
     bin::Log::Print("%s(%s): %" Pd64 "\n", this->name(), this->score_kind(),
                     this->score());
     run_matches++;
@@ -90,7 +90,8 @@ static void PrintUsage() {
   bin::Log::PrintErr(
       "Usage: one of the following\n"
       "  run_vm_tests --list\n"
-      "  run_vm_tests [--dfe=<snapshot file name>] --benchmarks\n"
+      "  run_vm_tests [--dfe=<snapshot file name>] [vm-flags ...] "
+      "--benchmarks\n"
       "  run_vm_tests [--dfe=<snapshot file name>] [vm-flags ...] <test name>\n"
       "  run_vm_tests [--dfe=<snapshot file name>] [vm-flags ...] <benchmark "
       "name>\n");
@@ -250,17 +251,17 @@ static int Main(int argc, const char** argv) {
     ++arg_pos;
   }
 
-  if (arg_pos == argc - 1 && strcmp(argv[arg_pos], "--benchmarks") == 0) {
+  if (strcmp(argv[argc - 1], "--benchmarks") == 0) {
     // "--benchmarks" is the last argument.
     run_filter = kAllBenchmarks;
   } else {
-    // Last argument is the test name, the rest are vm flags.
+    // Last argument is the test name.
     run_filter = argv[argc - 1];
-    // Remove the first value (executable) from the arguments and
-    // exclude the last argument which is the test name.
-    dart_argc = argc - 2;
-    dart_argv = &argv[1];
   }
+  // The rest are vm flags, e.g. --benchmark_repetitions. Remove the first
+  // value (executable) from the arguments and exclude the last argument.
+  dart_argc = argc - 2;
+  dart_argv = &argv[1];
 
   bin::Thread::InitOnce();
   bin::TimerUtils::InitOnce();
@@ -7,6 +7,9 @@
 #include "bin/secure_socket_filter.h"
 
 #include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
 #include <openssl/ssl.h>
 #include <openssl/x509.h>
 
@@ -32,6 +35,8 @@ bool SSLFilter::library_initialized_ = false;
 // To protect library initialization.
 Mutex* SSLFilter::mutex_ = new Mutex();
 int SSLFilter::filter_ssl_index;
+bool SSLFilter::async_private_key_operations_ = false;
+Dart_Port SSLFilter::private_key_port_ = ILLEGAL_PORT;
 
 const intptr_t SSLFilter::kInternalBIOSize = 10 * KB;
 const intptr_t SSLFilter::kApproximateSize =
@@ -130,7 +135,14 @@ void FUNCTION_NAME(SecureSocket_Destroy)(Dart_NativeArguments args) {
 }
 
 void FUNCTION_NAME(SecureSocket_Handshake)(Dart_NativeArguments args) {
-  GetFilter(args)->Handshake();
+  Dart_SetBooleanReturnValue(args, GetFilter(args)->Handshake());
+}
+
+void FUNCTION_NAME(SecureSocket_SetPrivateKeyOperationPort)(
+    Dart_NativeArguments args) {
+  Dart_Port port = ILLEGAL_PORT;
+  ThrowIfError(Dart_SendPortGetId(Dart_GetNativeArgument(args, 1), &port));
+  GetFilter(args)->SetPrivateKeyOperationPort(port);
 }
 
 void FUNCTION_NAME(SecureSocket_GetSelectedProtocol)(
@@ -426,16 +438,243 @@ Dart_Handle SSLFilter::PeerCertificate() {
   return X509Helper::WrappedX509Certificate(ca);
 }
 
+// A private key operation of a server handshake. It runs on the threads of
+// SSLFilter::private_key_port_, so that a burst of handshakes does not block
+// the isolates accepting the connections, and uses all cores.
+class PrivateKeyOperation {
+ public:
+  PrivateKeyOperation(SSLFilter* filter,
+                      EVP_PKEY* key,
+                      bool decrypt,
+                      uint16_t signature_algorithm,
+                      const uint8_t* in,
+                      size_t in_len)
+      : filter_(filter),
+        key_(key),
+        decrypt_(decrypt),
+        signature_algorithm_(signature_algorithm),
+        input_(reinterpret_cast<uint8_t*>(malloc(in_len))),
+        input_length_(in_len),
+        output_(NULL),
+        output_length_(0),
+        success_(false),
+        done_(false),
+        port_(ILLEGAL_PORT) {
+    memmove(input_, in, in_len);
+  }
+
+  ~PrivateKeyOperation() {
+    EVP_PKEY_free(key_);
+    free(input_);
+    free(output_);
+  }
+
+  SSLFilter* filter() const { return filter_; }
+  const uint8_t* output() const { return output_; }
+  size_t output_length() const { return output_length_; }
+  bool success() const { return success_; }
+
+  bool IsDone() {
+    MutexLocker locker(mutex_);
+    return done_;
+  }
+
+  // Called on the isolate's thread.
+  void SetPort(Dart_Port port) {
+    {
+      MutexLocker locker(mutex_);
+      if (!done_) {
+        port_ = port;
+        return;
+      }
+    }
+    Dart_PostInteger(port, 0);
+  }
+
+  // Called on a thread of the private key port. The operation may be deleted
+  // by the isolate as soon as it is marked as done.
+  void Run() {
+    const size_t max_output = EVP_PKEY_size(key_);
+    output_ = reinterpret_cast<uint8_t*>(malloc(max_output));
+    if (output_ != NULL) {
+      if (decrypt_) {
+        RSA* rsa = EVP_PKEY_get0_RSA(key_);
+        success_ = (rsa != NULL) &&
+                   (RSA_decrypt(rsa, &output_length_, output_, max_output,
+                                input_, input_length_, RSA_NO_PADDING) == 1);
+      } else {
+        EVP_MD_CTX context;
+        EVP_MD_CTX_init(&context);
+        EVP_PKEY_CTX* key_context = NULL;
+        const EVP_MD* digest =
+            SSL_get_signature_algorithm_digest(signature_algorithm_);
+        output_length_ = max_output;
+        success_ =
+            (EVP_DigestSignInit(&context, &key_context, digest, NULL, key_) ==
+             1) &&
+            (!SSL_is_signature_algorithm_rsa_pss(signature_algorithm_) ||
+             ((EVP_PKEY_CTX_set_rsa_padding(key_context,
+                                            RSA_PKCS1_PSS_PADDING) == 1) &&
+              (EVP_PKEY_CTX_set_rsa_pss_saltlen(key_context, -1) == 1))) &&
+            (EVP_DigestSign(&context, output_, &output_length_, input_,
+                            input_length_) == 1);
+        EVP_MD_CTX_cleanup(&context);
+      }
+    }
+    // Don't leave errors behind on this thread.
+    ERR_clear_error();
+
+    Dart_Port port;
+    {
+      MutexLocker locker(mutex_);
+      done_ = true;
+      port = port_;
+    }
+    if (port != ILLEGAL_PORT) {
+      Dart_PostInteger(port, 0);
+    }
+  }
+
+ private:
+  static Mutex* mutex_;
+
+  SSLFilter* filter_;
+  EVP_PKEY* key_;
+  bool decrypt_;
+  uint16_t signature_algorithm_;
+  uint8_t* input_;
+  size_t input_length_;
+  uint8_t* output_;
+  size_t output_length_;
+  bool success_;
+  bool done_;
+  Dart_Port port_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrivateKeyOperation);
+};
+
+Mutex* PrivateKeyOperation::mutex_ = new Mutex();
+
+static void PrivateKeyOperationHandler(Dart_Port dest_port_id,
+                                       Dart_CObject* message) {
+  ASSERT(message->type == Dart_CObject_kInt64);
+  PrivateKeyOperation* operation =
+      reinterpret_cast<PrivateKeyOperation*>(message->value.as_int64);
+  // The operation belongs to the filter, which was retained for it.
+  SSLFilter* filter = operation->filter();
+  operation->Run();
+  filter->Release();
+}
+
+static SSLFilter* GetFilter(SSL* ssl) {
+  return static_cast<SSLFilter*>(
+      SSL_get_ex_data(ssl, SSLFilter::filter_ssl_index));
+}
+
+static enum ssl_private_key_result_t PrivateKeySign(
+    SSL* ssl,
+    uint8_t* out,
+    size_t* out_len,
+    size_t max_out,
+    uint16_t signature_algorithm,
+    const uint8_t* in,
+    size_t in_len) {
+  return GetFilter(ssl)->StartPrivateKeyOperation(false, signature_algorithm,
+                                                  in, in_len);
+}
+
+static enum ssl_private_key_result_t PrivateKeyDecrypt(SSL* ssl,
+                                                       uint8_t* out,
+                                                       size_t* out_len,
+                                                       size_t max_out,
+                                                       const uint8_t* in,
+                                                       size_t in_len) {
+  return GetFilter(ssl)->StartPrivateKeyOperation(true, 0, in, in_len);
+}
+
+static enum ssl_private_key_result_t PrivateKeyComplete(SSL* ssl,
+                                                        uint8_t* out,
+                                                        size_t* out_len,
+                                                        size_t max_out) {
+  return GetFilter(ssl)->CompletePrivateKeyOperation(out, out_len, max_out);
+}
+
+static SSL_PRIVATE_KEY_METHOD private_key_method;
+
 void SSLFilter::InitializeLibrary() {
   MutexLocker locker(mutex_);
   if (!library_initialized_) {
     SSL_library_init();
     filter_ssl_index = SSL_get_ex_new_index(0, NULL, NULL, NULL, NULL);
     ASSERT(filter_ssl_index >= 0);
+    if (async_private_key_operations_) {
+      private_key_method.sign = PrivateKeySign;
+      private_key_method.decrypt = PrivateKeyDecrypt;
+      private_key_method.complete = PrivateKeyComplete;
+      private_key_port_ = Dart_NewNativePort(
+          "SSLPrivateKeyOperations", PrivateKeyOperationHandler, true);
+    }
     library_initialized_ = true;
   }
 }
 
+enum ssl_private_key_result_t SSLFilter::StartPrivateKeyOperation(
+    bool decrypt,
+    uint16_t signature_algorithm,
+    const uint8_t* in,
+    size_t in_len) {
+  ASSERT(private_key_operation_ == NULL);
+  EVP_PKEY* key = SSL_CTX_get0_privatekey(SSL_get_SSL_CTX(ssl_));
+  if (key == NULL) {
+    return ssl_private_key_failure;
+  }
+  EVP_PKEY_up_ref(key);
+  PrivateKeyOperation* operation = new PrivateKeyOperation(
+      this, key, decrypt, signature_algorithm, in, in_len);
+  // Released when the operation has run.
+  Retain();
+  Dart_CObject message;
+  message.type = Dart_CObject_kInt64;
+  message.value.as_int64 = reinterpret_cast<intptr_t>(operation);
+  if (!Dart_PostCObject(private_key_port_, &message)) {
+    delete operation;
+    Release();
+    return ssl_private_key_failure;
+  }
+  private_key_operation_ = operation;
+  return ssl_private_key_retry;
+}
+
+enum ssl_private_key_result_t SSLFilter::CompletePrivateKeyOperation(
+    uint8_t* out,
+    size_t* out_len,
+    size_t max_out) {
+  PrivateKeyOperation* operation = private_key_operation_;
+  if (operation == NULL) {
+    return ssl_private_key_failure;
+  }
+  if (!operation->IsDone()) {
+    return ssl_private_key_retry;
+  }
+  private_key_operation_ = NULL;
+  enum ssl_private_key_result_t result = ssl_private_key_failure;
+  if (operation->success() && (operation->output_length() <= max_out)) {
+    memmove(out, operation->output(), operation->output_length());
+    *out_len = operation->output_length();
+    result = ssl_private_key_success;
+  }
+  delete operation;
+  return result;
+}
+
+void SSLFilter::SetPrivateKeyOperationPort(Dart_Port port) {
+  if (private_key_operation_ != NULL) {
+    private_key_operation_->SetPort(port);
+  } else {
+    Dart_PostInteger(port, 0);
+  }
+}
+
 void SSLFilter::Connect(const char* hostname,
                         SSLCertContext* context,
                         bool is_server,
@@ -463,6 +702,11 @@ void SSLFilter::Connect(const char* hostname,
   SSL_set_ex_data(ssl_, filter_ssl_index, this);
   context->RegisterCallbacks(ssl_);
 
+  if (is_server_ && (private_key_port_ != ILLEGAL_PORT) &&
+      (SSL_CTX_get0_privatekey(context->context()) != NULL)) {
+    SSL_set_private_key_method(ssl_, &private_key_method);
+  }
+
   if (is_server_) {
     int certificate_mode =
         request_client_certificate ? SSL_VERIFY_PEER : SSL_VERIFY_NONE;
@@ -517,7 +761,7 @@ void SSLFilter::Connect(const char* hostname,
   Handshake();
 }
 
-void SSLFilter::Handshake() {
+bool SSLFilter::Handshake() {
   // Try and push handshake along.
   int status;
   status = SSL_do_handshake(ssl_);
@@ -528,9 +772,13 @@ void SSLFilter::Handshake() {
     // logic and we propagate the error"
     Dart_PropagateError(callback_error);
   }
+  if (SSL_want_private_key_operation(ssl_)) {
+    in_handshake_ = true;
+    return true;
+  }
   if (SSL_want_write(ssl_) || SSL_want_read(ssl_)) {
     in_handshake_ = true;
-    return;
+    return false;
   }
   SecureSocketUtils::CheckStatusSSL(
       status, "HandshakeException",
@@ -557,6 +805,7 @@ void SSLFilter::Handshake() {
         Dart_HandleFromPersistent(handshake_complete_), 0, NULL));
     in_handshake_ = false;
   }
+  return false;
 }
 
 void SSLFilter::GetSelectedProtocol(Dart_NativeArguments args) {
@@ -604,6 +853,8 @@ void SSLFilter::FreeResources() {
 
 SSLFilter::~SSLFilter() {
   FreeResources();
+  // Operations still hold a reference to the filter while they run.
+  delete private_key_operation_;
 }
 
 void SSLFilter::Destroy() {
@@ -21,6 +21,8 @@ namespace bin {
 extern const unsigned char* root_certificates_pem;
 extern unsigned int root_certificates_pem_length;
 
+class PrivateKeyOperation;
+
 class SSLFilter : public ReferenceCounted<SSLFilter> {
  public:
   // These enums must agree with those in sdk/lib/io/secure_socket.dart.
@@ -45,7 +47,8 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
         handshake_complete_(NULL),
         bad_certificate_callback_(NULL),
         in_handshake_(false),
-        hostname_(NULL) {}
+        hostname_(NULL),
+        private_key_operation_(NULL) {}
 
   ~SSLFilter();
 
@@ -62,7 +65,9 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
                Dart_Handle protocols_handle);
   void Destroy();
   void FreeResources();
-  void Handshake();
+  // Returns true if the handshake is waiting for a private key operation
+  // running on another thread.
+  bool Handshake();
   void GetSelectedProtocol(Dart_NativeArguments args);
   void Renegotiate(bool use_session_cache,
                    bool request_client_certificate,
@@ -81,6 +86,24 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
                          bool in_handshake);
   Dart_Handle PeerCertificate();
   static void InitializeLibrary();
+
+  // Sets the port that is notified when the pending private key operation
+  // completes.
+  void SetPrivateKeyOperationPort(Dart_Port port);
+  enum ssl_private_key_result_t StartPrivateKeyOperation(
+      bool decrypt,
+      uint16_t signature_algorithm,
+      const uint8_t* in,
+      size_t in_len);
+  enum ssl_private_key_result_t CompletePrivateKeyOperation(uint8_t* out,
+                                                            size_t* out_len,
+                                                            size_t max_out);
+
+  // Whether the private key operations of server handshakes run on a pool
+  // of threads rather than on the isolate's thread.
+  static void set_async_private_key_operations(bool value) {
+    async_private_key_operations_ = value;
+  }
   Dart_Handle callback_error;
 
   static CObject* ProcessFilterRequest(const CObjectArray& request);
@@ -92,6 +115,9 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   static const intptr_t kInternalBIOSize;
   static bool library_initialized_;
   static Mutex* mutex_;  // To protect library initialization.
+  static bool async_private_key_operations_;
+  // Native port running private key operations concurrently.
+  static Dart_Port private_key_port_;
 
   SSL* ssl_;
   BIO* socket_side_;
@@ -107,6 +133,7 @@ class SSLFilter : public ReferenceCounted<SSLFilter> {
   bool in_handshake_;
   bool is_server_;
   char* hostname_;
+  PrivateKeyOperation* private_key_operation_;
 
   static bool IsBufferEncrypted(int i) {
     return static_cast<BufferIndex>(i) >= kFirstEncrypted;
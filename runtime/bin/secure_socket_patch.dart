@@ -88,12 +88,37 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
 
   void destroy() {
     buffers = null;
+    _closePrivateKeyOperationPort();
     _destroy();
   }
 
   void _destroy() native "SecureSocket_Destroy";
 
-  void handshake() native "SecureSocket_Handshake";
+  void handshake() {
+    // Wait for a pending private key operation before continuing.
+    if (_privateKeyOperationPort != null) return;
+    if (_handshake()) {
+      // The handshake is waiting for a private key operation running on
+      // another thread, which will send a message when it is done.
+      _privateKeyOperationPort = new RawReceivePort((_) {
+        _closePrivateKeyOperationPort();
+        _privateKeyOperationCallback();
+      });
+      _setPrivateKeyOperationPort(_privateKeyOperationPort.sendPort);
+    }
+  }
+
+  bool _handshake() native "SecureSocket_Handshake";
+
+  void _setPrivateKeyOperationPort(SendPort port)
+      native "SecureSocket_SetPrivateKeyOperationPort";
+
+  void _closePrivateKeyOperationPort() {
+    if (_privateKeyOperationPort != null) {
+      _privateKeyOperationPort.close();
+      _privateKeyOperationPort = null;
+    }
+  }
 
   void rehandshake() => throw new UnimplementedError();
 
@@ -114,10 +139,16 @@ class _SecureFilterImpl extends NativeFieldWrapperClass1
   void registerHandshakeCompleteCallback(Function handshakeCompleteHandler)
       native "SecureSocket_RegisterHandshakeCompleteCallback";
 
+  void registerPrivateKeyOperationCallback(Function callback) {
+    _privateKeyOperationCallback = callback;
+  }
+
   // This is a security issue, as it exposes a raw pointer to Dart code.
   int _pointer() native "SecureSocket_FilterPointer";
 
   List<_ExternalBuffer> buffers;
+  RawReceivePort _privateKeyOperationPort;
+  Function _privateKeyOperationCallback;
 }
 
 @patch
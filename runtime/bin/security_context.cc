@@ -9,6 +9,7 @@
 #include <openssl/bio.h>
 #include <openssl/err.h>
 #include <openssl/pkcs12.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #include <openssl/x509.h>
 
@@ -34,6 +35,9 @@ namespace bin {
 
 const char* SSLCertContext::root_certs_file_ = NULL;
 const char* SSLCertContext::root_certs_cache_ = NULL;
+Mutex* SSLCertContext::session_ticket_keys_mutex_ = new Mutex();
+bool SSLCertContext::session_ticket_keys_initialized_ = false;
+uint8_t SSLCertContext::session_ticket_keys_[kSessionTicketKeysLength];
 
 int SSLCertContext::CertificateCallback(int preverify_ok,
                                         X509_STORE_CTX* store_ctx) {
@@ -634,7 +638,33 @@ static int UseChainBytes(SSL_CTX* context, BIO* bio, const char* password) {
 int SSLCertContext::UseCertificateChainBytes(Dart_Handle cert_chain_bytes,
                                              const char* password) {
   ScopedMemBIO bio(cert_chain_bytes);
-  return UseChainBytes(context(), bio.bio(), password);
+  int status = UseChainBytes(context(), bio.bio(), password);
+  if (status != 0) {
+    // Session tickets can be decrypted by every context in the process, so
+    // only resume sessions in contexts serving the same certificate.
+    uint8_t digest[SSL_MAX_SID_CTX_LENGTH];
+    unsigned int digest_length = 0;
+    X509* certificate = SSL_CTX_get0_certificate(context());
+    if ((certificate != NULL) &&
+        (X509_digest(certificate, EVP_sha256(), digest, &digest_length) == 1)) {
+      ASSERT(digest_length <= SSL_MAX_SID_CTX_LENGTH);
+      status = SSL_CTX_set_session_id_context(context(), digest, digest_length);
+    }
+  }
+  return status;
+}
+
+void SSLCertContext::UseSharedSessionTicketKeys(SSL_CTX* context) {
+  MutexLocker locker(session_ticket_keys_mutex_);
+  if (!session_ticket_keys_initialized_) {
+    if (RAND_bytes(session_ticket_keys_, kSessionTicketKeysLength) != 1) {
+      // Keep the context's own keys.
+      return;
+    }
+    session_ticket_keys_initialized_ = true;
+  }
+  SSL_CTX_set_tlsext_ticket_keys(context, session_ticket_keys_,
+                                 kSessionTicketKeysLength);
 }
 
 static X509* GetX509Certificate(Dart_NativeArguments args) {
@@ -824,6 +854,7 @@ void FUNCTION_NAME(SecurityContext_Allocate)(Dart_NativeArguments args) {
   SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER, SSLCertContext::CertificateCallback);
   SSL_CTX_set_min_proto_version(ctx, TLS1_VERSION);
   SSL_CTX_set_cipher_list(ctx, "HIGH:MEDIUM");
+  SSLCertContext::UseSharedSessionTicketKeys(ctx);
   SSLCertContext* context = new SSLCertContext(ctx);
   Dart_Handle err = SetSecurityContext(args, context);
   if (Dart_IsError(err)) {
@@ -84,6 +84,11 @@ class SSLCertContext : public ReferenceCounted<SSLCertContext> {
 
   void RegisterCallbacks(SSL* ssl);
 
+  // Makes [context] encrypt session tickets with keys shared by all security
+  // contexts in the process, so that a session can be resumed in any
+  // isolate.
+  static void UseSharedSessionTicketKeys(SSL_CTX* context);
+
  private:
   void AddCompiledInCerts();
   void LoadRootCertFile(const char* file);
@@ -92,6 +97,11 @@ class SSLCertContext : public ReferenceCounted<SSLCertContext> {
   static const char* root_certs_file_;
   static const char* root_certs_cache_;
 
+  static const intptr_t kSessionTicketKeysLength = 48;
+  static Mutex* session_ticket_keys_mutex_;
+  static bool session_ticket_keys_initialized_;
+  static uint8_t session_ticket_keys_[kSessionTicketKeysLength];
+
   SSL_CTX* context_;
   uint8_t* alpn_protocol_string_;
 
@@ -9,6 +9,7 @@
 #include "bin/error_exit.h"
 #include "bin/extensions.h"
 #include "bin/file.h"
+#include "bin/gzip.h"
 #include "bin/platform.h"
 #include "include/dart_api.h"
 #include "platform/utils.h"
@@ -31,24 +32,32 @@ class MappedAppSnapshot : public AppSnapshot {
   MappedAppSnapshot(MappedMemory* vm_snapshot_data,
                     MappedMemory* vm_snapshot_instructions,
                     MappedMemory* isolate_snapshot_data,
-                    MappedMemory* isolate_snapshot_instructions)
+                    MappedMemory* isolate_snapshot_instructions,
+                    uint8_t* vm_inflated_data,
+                    uint8_t* isolate_inflated_data)
       : vm_data_mapping_(vm_snapshot_data),
         vm_instructions_mapping_(vm_snapshot_instructions),
         isolate_data_mapping_(isolate_snapshot_data),
-        isolate_instructions_mapping_(isolate_snapshot_instructions) {}
+        isolate_instructions_mapping_(isolate_snapshot_instructions),
+        vm_inflated_data_(vm_inflated_data),
+        isolate_inflated_data_(isolate_inflated_data) {}
 
   ~MappedAppSnapshot() {
     delete vm_data_mapping_;
     delete vm_instructions_mapping_;
     delete isolate_data_mapping_;
     delete isolate_instructions_mapping_;
+    free(vm_inflated_data_);
+    free(isolate_inflated_data_);
   }
 
   void SetBuffers(const uint8_t** vm_data_buffer,
                   const uint8_t** vm_instructions_buffer,
                   const uint8_t** isolate_data_buffer,
                   const uint8_t** isolate_instructions_buffer) {
-    if (vm_data_mapping_ != NULL) {
+    if (vm_inflated_data_ != NULL) {
+      *vm_data_buffer = vm_inflated_data_;
+    } else if (vm_data_mapping_ != NULL) {
       *vm_data_buffer =
           reinterpret_cast<const uint8_t*>(vm_data_mapping_->address());
     }
@@ -56,7 +65,9 @@ class MappedAppSnapshot : public AppSnapshot {
       *vm_instructions_buffer =
           reinterpret_cast<const uint8_t*>(vm_instructions_mapping_->address());
     }
-    if (isolate_data_mapping_ != NULL) {
+    if (isolate_inflated_data_ != NULL) {
+      *isolate_data_buffer = isolate_inflated_data_;
+    } else if (isolate_data_mapping_ != NULL) {
       *isolate_data_buffer =
           reinterpret_cast<const uint8_t*>(isolate_data_mapping_->address());
     }
@@ -71,8 +82,35 @@ class MappedAppSnapshot : public AppSnapshot {
   MappedMemory* vm_instructions_mapping_;
   MappedMemory* isolate_data_mapping_;
   MappedMemory* isolate_instructions_mapping_;
+  uint8_t* vm_inflated_data_;
+  uint8_t* isolate_inflated_data_;
 };
 
+// Data sections written with --compress-snapshot-data are gzip streams.
+// Uncompressed sections start with the snapshot magic value instead.
+static bool IsCompressedSection(MappedMemory* mapping, int64_t size) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(mapping->address());
+  return (size > 2) && (bytes[0] == 0x1f) && (bytes[1] == 0x8b);
+}
+
+// Returns the inflated contents of a compressed data section, which replace
+// the mapping, or NULL if the section is used in place.
+static uint8_t* TryInflateSection(MappedMemory** mapping, int64_t size) {
+  if ((*mapping == NULL) || !IsCompressedSection(*mapping, size)) {
+    return NULL;
+  }
+  uint8_t* inflated = NULL;
+  intptr_t inflated_size = 0;
+  Decompress(reinterpret_cast<const uint8_t*>((*mapping)->address()), size,
+             &inflated, &inflated_size);
+  // Objects in the data section are used in place, so the buffer needs the
+  // alignment of heap objects, which malloc provides.
+  ASSERT(Utils::IsAligned(reinterpret_cast<uword>(inflated), 2 * kWordSize));
+  delete *mapping;
+  *mapping = NULL;
+  return inflated;
+}
+
 static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name) {
   File* file = File::Open(NULL, script_name, File::kRead);
   if (file == NULL) {
@@ -150,8 +188,13 @@ static AppSnapshot* TryReadAppSnapshotBlobs(const char* script_name) {
     }
   }
 
+  uint8_t* vm_inflated_data = TryInflateSection(&vm_data_mapping, vm_data_size);
+  uint8_t* isolate_inflated_data =
+      TryInflateSection(&isolate_data_mapping, isolate_data_size);
+
   return new MappedAppSnapshot(vm_data_mapping, vm_instr_mapping,
-                               isolate_data_mapping, isolate_instr_mapping);
+                               isolate_data_mapping, isolate_instr_mapping,
+                               vm_inflated_data, isolate_inflated_data);
 }
 
 #if defined(DART_PRECOMPILED_RUNTIME)
@@ -268,6 +311,27 @@ static bool WriteInt64(File* file, int64_t size) {
   return file->WriteFully(&size, sizeof(size));
 }
 
+// Replaces the data section in |buffer| with a gzip compressed copy, which
+// the caller must free. Instructions are never compressed so they can still
+// be mapped executable.
+static void CompressDataSection(const char* name,
+                                uint8_t** buffer,
+                                intptr_t* size) {
+  if (*size == 0) {
+    *buffer = NULL;
+    return;
+  }
+  uint8_t* compressed = NULL;
+  intptr_t compressed_size = 0;
+  Compress(*buffer, *size, &compressed, &compressed_size);
+  if (Dart_IsVMFlagSet("print_snapshot_sizes")) {
+    Log::Print("%s(DataSize): %" Pd "\n", name, *size);
+    Log::Print("%s(CompressedDataSize): %" Pd "\n", name, compressed_size);
+  }
+  *buffer = compressed;
+  *size = compressed_size;
+}
+
 static void WriteAppSnapshot(const char* filename,
                              uint8_t* vm_data_buffer,
                              intptr_t vm_data_size,
@@ -276,7 +340,13 @@ static void WriteAppSnapshot(const char* filename,
                              uint8_t* isolate_data_buffer,
                              intptr_t isolate_data_size,
                              uint8_t* isolate_instructions_buffer,
-                             intptr_t isolate_instructions_size) {
+                             intptr_t isolate_instructions_size,
+                             bool compress_data) {
+  if (compress_data) {
+    CompressDataSection("VMIsolate", &vm_data_buffer, &vm_data_size);
+    CompressDataSection("Isolate", &isolate_data_buffer, &isolate_data_size);
+  }
+
   File* file = File::Open(NULL, filename, File::kWriteTruncate);
   if (file == NULL) {
     ErrorExit(kErrorExitCode, "Unable to write snapshot file '%s'\n", filename);
@@ -330,6 +400,11 @@ static void WriteAppSnapshot(const char* filename,
 
   file->Flush();
   file->Release();
+
+  if (compress_data) {
+    free(vm_data_buffer);
+    free(isolate_data_buffer);
+  }
 }
 
 void Snapshot::GenerateKernel(const char* snapshot_filename,
@@ -360,7 +435,8 @@ void Snapshot::GenerateScript(const char* snapshot_filename) {
   WriteSnapshotFile(snapshot_filename, buffer, size);
 }
 
-void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
+void Snapshot::GenerateAppJIT(const char* snapshot_filename,
+                              bool compress_data) {
 #if defined(TARGET_ARCH_IA32)
   // Snapshots with code are not supported on IA32 or DBC.
   uint8_t* isolate_buffer = NULL;
@@ -373,7 +449,7 @@ void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
   }
 
   WriteAppSnapshot(snapshot_filename, NULL, 0, NULL, 0, isolate_buffer,
-                   isolate_size, NULL, 0);
+                   isolate_size, NULL, 0, compress_data);
 #else
   uint8_t* isolate_data_buffer = NULL;
   intptr_t isolate_data_size = 0;
@@ -387,13 +463,14 @@ void Snapshot::GenerateAppJIT(const char* snapshot_filename) {
   }
   WriteAppSnapshot(snapshot_filename, NULL, 0, NULL, 0, isolate_data_buffer,
                    isolate_data_size, isolate_instructions_buffer,
-                   isolate_instructions_size);
+                   isolate_instructions_size, compress_data);
 #endif
 }
 
 void Snapshot::GenerateAppAOTAsBlobs(const char* snapshot_filename,
                                      const uint8_t* shared_data,
-                                     const uint8_t* shared_instructions) {
+                                     const uint8_t* shared_instructions,
+                                     bool compress_data) {
   uint8_t* vm_data_buffer = NULL;
   intptr_t vm_data_size = 0;
   uint8_t* vm_instructions_buffer = NULL;
@@ -413,7 +490,8 @@ void Snapshot::GenerateAppAOTAsBlobs(const char* snapshot_filename,
   WriteAppSnapshot(snapshot_filename, vm_data_buffer, vm_data_size,
                    vm_instructions_buffer, vm_instructions_size,
                    isolate_data_buffer, isolate_data_size,
-                   isolate_instructions_buffer, isolate_instructions_size);
+                   isolate_instructions_buffer, isolate_instructions_size,
+                   compress_data);
 }
 
 static void StreamingWriteCallback(void* callback_data,
@@ -33,10 +33,14 @@ class Snapshot {
                              bool strong,
                              const char* package_config);
   static void GenerateScript(const char* snapshot_filename);
-  static void GenerateAppJIT(const char* snapshot_filename);
+  // With |compress_data| the data sections of the snapshot are gzip
+  // compressed and inflated into the C heap when the snapshot is read.
+  static void GenerateAppJIT(const char* snapshot_filename,
+                             bool compress_data);
   static void GenerateAppAOTAsBlobs(const char* snapshot_filename,
                                     const uint8_t* shared_data,
-                                    const uint8_t* shared_instructions);
+                                    const uint8_t* shared_instructions,
+                                    bool compress_data);
   static void GenerateAppAOTAsAssembly(const char* snapshot_filename);
 
   static AppSnapshot* TryReadAppSnapshot(const char* script_name);
@@ -6,6 +6,8 @@
 
 #include "bin/dartutils.h"
 #include "bin/eventhandler.h"
+#include "bin/file.h"
+#include "bin/host_lookup_cache.h"
 #include "bin/io_buffer.h"
 #include "bin/isolate_data.h"
 #include "bin/lockers.h"
@@ -23,10 +25,16 @@ namespace bin {
 
 static const int kSocketIdNativeField = 0;
 
+// Reads of at most this many bytes go through a buffer in the native scope
+// and are returned as a Dart heap allocated Uint8List of the exact size read,
+// instead of as an external IOBuffer.
+static const intptr_t kMaxScopeReadSize = 16 * KB;
+
 ListeningSocketRegistry* globalTcpListeningSocketRegistry = NULL;
 
 bool Socket::short_socket_read_ = false;
 bool Socket::short_socket_write_ = false;
+bool Socket::shared_sockets_reuse_port_ = false;
 
 void ListeningSocketRegistry::Initialize() {
   ASSERT(globalTcpListeningSocketRegistry == NULL);
@@ -96,6 +104,8 @@ Dart_Handle ListeningSocketRegistry::CreateBindListen(Dart_Handle socket_object,
                                                       bool shared) {
   MutexLocker ml(mutex_);
 
+  const bool reuse_port = shared && Socket::shared_sockets_reuse_port() &&
+                          ServerSocket::SupportsReusePort();
   OSSocket* first_os_socket = NULL;
   intptr_t port = SocketAddress::GetAddrPort(addr);
   if (port > 0) {
@@ -125,25 +135,32 @@ Dart_Handle ListeningSocketRegistry::CreateBindListen(Dart_Handle socket_object,
           return DartUtils::NewDartOSError(&os_error);
         }
 
-        // This socket creation is the exact same as the one which originally
-        // created the socket. We therefore increment the refcount and reuse
-        // the file descriptor.
-        os_socket->ref_count++;
-
-        // The same Socket is used by a second Dart _NativeSocket object.
-        // It Retains a reference.
-        os_socket->socketfd->Retain();
-        // We set as a side-effect the file descriptor on the dart
-        // socket_object.
-        Socket::ReuseSocketIdNativeField(socket_object, os_socket->socketfd,
-                                         Socket::kFinalizerListening);
-        return Dart_True();
+        if (!reuse_port) {
+          // This socket creation is the exact same as the one which
+          // originally created the socket. We therefore increment the
+          // refcount and reuse the file descriptor.
+          os_socket->ref_count++;
+
+          // The same Socket is used by a second Dart _NativeSocket object.
+          // It Retains a reference.
+          os_socket->socketfd->Retain();
+          // We set as a side-effect the file descriptor on the dart
+          // socket_object.
+          Socket::ReuseSocketIdNativeField(socket_object, os_socket->socketfd,
+                                           Socket::kFinalizerListening);
+          return Dart_True();
+        }
+        // Otherwise bind another socket with SO_REUSEPORT below, so that the
+        // kernel spreads the incoming connections over the accept queues of
+        // all of them, and link it in front of the existing ones.
       }
     }
   }
 
-  // There is no socket listening on that (address, port), so we create new one.
-  intptr_t fd = ServerSocket::CreateBindListen(addr, backlog, v6_only);
+  // There is no socket listening on that (address, port), or it is shared
+  // with SO_REUSEPORT, so we create new one.
+  intptr_t fd =
+      ServerSocket::CreateBindListen(addr, backlog, v6_only, reuse_port);
   if (fd == -5) {
     OSError os_error(-1, "Invalid host", OSError::kUnknown);
     return DartUtils::NewDartOSError(&os_error);
@@ -329,6 +346,31 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
     if (Socket::short_socket_read()) {
       length = (length + 1) / 2;
     }
+    if (length <= kMaxScopeReadSize) {
+      // Small reads need neither a malloc'ed buffer with a finalizer nor a
+      // second buffer when fewer bytes than requested are read.
+      uint8_t* buffer = Dart_ScopeAllocate(length > 0 ? length : 1);
+      intptr_t bytes_read =
+          SocketBase::Read(socket->fd(), buffer, length, SocketBase::kAsync);
+      if (bytes_read > 0) {
+        Dart_Handle result =
+            Dart_NewTypedData(Dart_TypedData_kUint8, bytes_read);
+        if (Dart_IsError(result)) {
+          Dart_PropagateError(result);
+        }
+        Dart_Handle err = Dart_ListSetAsBytes(result, 0, buffer, bytes_read);
+        if (Dart_IsError(err)) {
+          Dart_PropagateError(err);
+        }
+        Dart_SetReturnValue(args, result);
+      } else if (bytes_read == 0) {
+        Dart_SetReturnValue(args, Dart_Null());
+      } else {
+        ASSERT(bytes_read == -1);
+        Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+      }
+      return;
+    }
     uint8_t* buffer = NULL;
     Dart_Handle result = IOBuffer::Allocate(length, &buffer);
     if (Dart_IsNull(result)) {
@@ -370,81 +412,108 @@ void FUNCTION_NAME(Socket_Read)(Dart_NativeArguments args) {
   }
 }
 
-void FUNCTION_NAME(Socket_RecvFrom)(Dart_NativeArguments args) {
+void FUNCTION_NAME(Socket_RecvFromMany)(Dart_NativeArguments args) {
   // TODO(sgjesse): Use a MTU value here. Only the loopback adapter can
   // handle 64k datagrams.
   const int kReceiveBufferLen = 65536;
+  const intptr_t kMaxDatagrams = SocketBase::kMaxRecvFromMany;
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
 
-  // Ensure that a receive buffer for the UDP socket exists.
+  // Ensure that a receive buffer for the UDP socket exists. It has room for
+  // kMaxDatagrams datagrams of the maximum size, but only the pages the
+  // received datagrams are written to are ever touched.
   ASSERT(socket != NULL);
   uint8_t* recv_buffer = socket->udp_receive_buffer();
   if (recv_buffer == NULL) {
-    recv_buffer = reinterpret_cast<uint8_t*>(malloc(kReceiveBufferLen));
+    recv_buffer = reinterpret_cast<uint8_t*>(
+        malloc(kReceiveBufferLen * kMaxDatagrams));
     socket->set_udp_receive_buffer(recv_buffer);
   }
 
-  // Read data into the buffer.
-  RawAddr addr;
-  const intptr_t bytes_read = SocketBase::RecvFrom(
-      socket->fd(), recv_buffer, kReceiveBufferLen, &addr, SocketBase::kAsync);
-  if (bytes_read == 0) {
+  // Read the pending datagrams into the buffer.
+  RawAddr addrs[kMaxDatagrams];
+  intptr_t lengths[kMaxDatagrams];
+  const intptr_t count = SocketBase::RecvFromMany(
+      socket->fd(), recv_buffer, kReceiveBufferLen, kMaxDatagrams, lengths,
+      addrs, SocketBase::kAsync);
+  if (count == 0) {
     Dart_SetReturnValue(args, Dart_Null());
     return;
   }
-  if (bytes_read < 0) {
-    ASSERT(bytes_read == -1);
+  if (count < 0) {
+    ASSERT(count == -1);
     Dart_SetReturnValue(args, DartUtils::NewDartOSError());
     return;
   }
 
-  // Datagram data read. Copy into buffer of the exact size,
-  ASSERT(bytes_read > 0);
-  uint8_t* data_buffer = NULL;
-  Dart_Handle data = IOBuffer::Allocate(bytes_read, &data_buffer);
-  if (Dart_IsNull(data)) {
-    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
-    return;
-  }
-  if (Dart_IsError(data)) {
-    Dart_PropagateError(data);
+  Dart_Handle io_lib = Dart_LookupLibrary(DartUtils::NewString("dart:io"));
+  if (Dart_IsError(io_lib)) {
+    Dart_PropagateError(io_lib);
   }
-  ASSERT(data_buffer != NULL);
-  memmove(data_buffer, recv_buffer, bytes_read);
-
-  // Get the port and clear it in the sockaddr structure.
-  int port = SocketAddress::GetAddrPort(addr);
-  if (addr.addr.sa_family == AF_INET) {
-    addr.in.sin_port = 0;
-  } else {
-    ASSERT(addr.addr.sa_family == AF_INET6);
-    addr.in6.sin6_port = 0;
+  Dart_Handle make_datagram = DartUtils::NewString("_makeDatagram");
+  Dart_Handle result = Dart_NewList(count);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
   }
-  // Format the address to a string using the numeric format.
-  char numeric_address[INET6_ADDRSTRLEN];
-  SocketBase::FormatNumericAddress(addr, numeric_address, INET6_ADDRSTRLEN);
 
-  // Create a Datagram object with the data and sender address and port.
+  // Create a Datagram object with the data and sender address and port for
+  // each datagram. Consecutive datagrams from the same sender share the
+  // formatted address.
   const int kNumArgs = 4;
   Dart_Handle dart_args[kNumArgs];
-  dart_args[0] = data;
-  dart_args[1] = Dart_NewStringFromCString(numeric_address);
-  if (Dart_IsError(dart_args[1])) {
-    Dart_PropagateError(dart_args[1]);
-  }
-  dart_args[2] = SocketAddress::ToTypedData(addr);
-  dart_args[3] = Dart_NewInteger(port);
-  if (Dart_IsError(dart_args[3])) {
-    Dart_PropagateError(dart_args[3]);
-  }
-  // TODO(sgjesse): Cache the _makeDatagram function somewhere.
-  Dart_Handle io_lib = Dart_LookupLibrary(DartUtils::NewString("dart:io"));
-  if (Dart_IsError(io_lib)) {
-    Dart_PropagateError(io_lib);
+  RawAddr* last_addr = NULL;
+  for (intptr_t i = 0; i < count; i++) {
+    // Copy the datagram data into a buffer of the exact size.
+    Dart_Handle data = Dart_NewTypedData(Dart_TypedData_kUint8, lengths[i]);
+    if (Dart_IsError(data)) {
+      Dart_PropagateError(data);
+    }
+    if (lengths[i] > 0) {
+      Dart_Handle err = Dart_ListSetAsBytes(
+          data, 0, recv_buffer + i * kReceiveBufferLen, lengths[i]);
+      if (Dart_IsError(err)) {
+        Dart_PropagateError(err);
+      }
+    }
+    dart_args[0] = data;
+
+    // Get the port and clear it in the sockaddr structure.
+    RawAddr* addr = &addrs[i];
+    int port = SocketAddress::GetAddrPort(*addr);
+    if (addr->addr.sa_family == AF_INET) {
+      addr->in.sin_port = 0;
+    } else {
+      ASSERT(addr->addr.sa_family == AF_INET6);
+      addr->in6.sin6_port = 0;
+    }
+    if ((last_addr == NULL) ||
+        !SocketAddress::AreAddressesEqual(*last_addr, *addr)) {
+      // Format the address to a string using the numeric format.
+      char numeric_address[INET6_ADDRSTRLEN];
+      SocketBase::FormatNumericAddress(*addr, numeric_address,
+                                       INET6_ADDRSTRLEN);
+      dart_args[1] = Dart_NewStringFromCString(numeric_address);
+      if (Dart_IsError(dart_args[1])) {
+        Dart_PropagateError(dart_args[1]);
+      }
+      dart_args[2] = SocketAddress::ToTypedData(*addr);
+      last_addr = addr;
+    }
+    dart_args[3] = Dart_NewInteger(port);
+    if (Dart_IsError(dart_args[3])) {
+      Dart_PropagateError(dart_args[3]);
+    }
+    Dart_Handle datagram =
+        Dart_Invoke(io_lib, make_datagram, kNumArgs, dart_args);
+    if (Dart_IsError(datagram)) {
+      Dart_PropagateError(datagram);
+    }
+    Dart_Handle err = Dart_ListSetAt(result, i, datagram);
+    if (Dart_IsError(err)) {
+      Dart_PropagateError(err);
+    }
   }
-  Dart_Handle result = Dart_Invoke(
-      io_lib, DartUtils::NewString("_makeDatagram"), kNumArgs, dart_args);
   Dart_SetReturnValue(args, result);
 }
 
@@ -491,6 +560,109 @@ void FUNCTION_NAME(Socket_WriteList)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Socket_WriteVector)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  Dart_Handle buffers_obj = Dart_GetNativeArgument(args, 1);
+  ASSERT(Dart_IsList(buffers_obj));
+  // The offset into the first buffer.
+  intptr_t offset = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 2));
+  intptr_t count = 0;
+  Dart_Handle result = Dart_ListLength(buffers_obj, &count);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+  }
+  ASSERT((count > 0) && (count <= SocketBase::kMaxWriteVBuffers));
+  bool short_write = false;
+  if (Socket::short_socket_write()) {
+    // Forced short writes only ever cover part of the first buffer.
+    short_write = true;
+    count = 1;
+  }
+  Dart_Handle handles[SocketBase::kMaxWriteVBuffers];
+  const void* buffers[SocketBase::kMaxWriteVBuffers];
+  intptr_t lengths[SocketBase::kMaxWriteVBuffers];
+  for (intptr_t i = 0; i < count; i++) {
+    handles[i] = Dart_ListGetAt(buffers_obj, i);
+    if (Dart_IsError(handles[i])) {
+      Dart_PropagateError(handles[i]);
+    }
+  }
+  intptr_t acquired = 0;
+  for (; acquired < count; acquired++) {
+    Dart_TypedData_Type type;
+    uint8_t* buffer = NULL;
+    intptr_t len = 0;
+    result = Dart_TypedDataAcquireData(
+        handles[acquired], &type, reinterpret_cast<void**>(&buffer), &len);
+    if (Dart_IsError(result)) {
+      break;
+    }
+    buffers[acquired] = buffer;
+    lengths[acquired] = len;
+  }
+  if (acquired < count) {
+    for (intptr_t i = 0; i < acquired; i++) {
+      Dart_TypedDataReleaseData(handles[i]);
+    }
+    Dart_PropagateError(result);
+  }
+  ASSERT(offset <= lengths[0]);
+  buffers[0] = reinterpret_cast<const uint8_t*>(buffers[0]) + offset;
+  lengths[0] -= offset;
+  if (short_write) {
+    short_write = lengths[0] > 1;
+    lengths[0] = (lengths[0] + 1) / 2;
+  }
+  intptr_t bytes_written = SocketBase::WriteV(socket->fd(), buffers, lengths,
+                                              count, SocketBase::kAsync);
+  if (bytes_written < 0) {
+    // Extract OSError before we release data, as it may override the error.
+    OSError os_error;
+    for (intptr_t i = 0; i < count; i++) {
+      Dart_TypedDataReleaseData(handles[i]);
+    }
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+    return;
+  }
+  for (intptr_t i = 0; i < count; i++) {
+    Dart_TypedDataReleaseData(handles[i]);
+  }
+  // As in Socket_WriteList, a forced short write is reported as the negative
+  // number of bytes written.
+  Dart_SetReturnValue(
+      args, Dart_NewInteger(short_write ? -bytes_written : bytes_written));
+}
+
+void FUNCTION_NAME(Socket_SendFileSupported)(Dart_NativeArguments args) {
+  Dart_SetBooleanReturnValue(args, SocketBase::SupportsSendFile());
+}
+
+void FUNCTION_NAME(Socket_SendFile)(Dart_NativeArguments args) {
+  Socket* socket =
+      Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
+  File* file = reinterpret_cast<File*>(
+      DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 1)));
+  int64_t position = DartUtils::GetInt64ValueCheckRange(
+      Dart_GetNativeArgument(args, 2), 0, kMaxInt64);
+  intptr_t length = DartUtils::GetIntptrValue(Dart_GetNativeArgument(args, 3));
+  ASSERT(SocketBase::SupportsSendFile());
+  if ((file == NULL) || file->IsClosed()) {
+    OSError os_error(-1, "File closed", OSError::kUnknown);
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError(&os_error));
+    return;
+  }
+  intptr_t bytes_written = SocketBase::SendFile(
+      socket->fd(), file->GetFD(), position, length, SocketBase::kAsync);
+  if (bytes_written >= 0) {
+    Dart_SetIntegerReturnValue(args, bytes_written);
+  } else if (bytes_written == SocketBase::kSendFileEndOfFile) {
+    Dart_SetReturnValue(args, Dart_Null());
+  } else {
+    Dart_SetReturnValue(args, DartUtils::NewDartOSError());
+  }
+}
+
 void FUNCTION_NAME(Socket_SendTo)(Dart_NativeArguments args) {
   Socket* socket =
       Socket::GetSocketIdNativeField(Dart_GetNativeArgument(args, 0));
@@ -654,7 +826,7 @@ CObject* Socket::LookupRequest(const CObjectArray& request) {
     CObject* result = NULL;
     OSError* os_error = NULL;
     AddressList<SocketAddress>* addresses =
-        SocketBase::LookupAddress(host.CString(), type.Value(), &os_error);
+        HostLookupCache::Lookup(host.CString(), type.Value(), &os_error);
     if (addresses != NULL) {
       CObjectArray* array =
           new CObjectArray(CObject::NewArray(addresses->count() + 1));
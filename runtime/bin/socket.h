@@ -94,6 +94,13 @@ class Socket : public ReferenceCounted<Socket> {
   static void set_short_socket_write(bool short_socket_write) {
     short_socket_write_ = short_socket_write;
   }
+  // When set, binding a shared server socket again on the same (address,
+  // port) creates another listening socket with SO_REUSEPORT instead of
+  // reusing the first one's file descriptor, where this is supported.
+  static bool shared_sockets_reuse_port() { return shared_sockets_reuse_port_; }
+  static void set_shared_sockets_reuse_port(bool reuse_port) {
+    shared_sockets_reuse_port_ = reuse_port;
+  }
 
   static bool IsSignalSocketFlag(intptr_t flag) {
     return ((flag & (0x1 << kInternalSignalSocket)) != 0);
@@ -110,6 +117,7 @@ class Socket : public ReferenceCounted<Socket> {
 
   static bool short_socket_read_;
   static bool short_socket_write_;
+  static bool shared_sockets_reuse_port_;
 
   intptr_t fd_;
   Dart_Port isolate_port_;
@@ -134,9 +142,17 @@ class ServerSocket {
   //
   //   -1: system error (errno set)
   //   -5: invalid bindAddress
+  //
+  // If [reuse_port] is true the socket is created with SO_REUSEPORT, which
+  // requires SupportsReusePort().
   static intptr_t CreateBindListen(const RawAddr& addr,
                                    intptr_t backlog,
-                                   bool v6_only = false);
+                                   bool v6_only = false,
+                                   bool reuse_port = false);
+
+  // Whether the kernel can bind several listening sockets to the same
+  // (address, port) and spread incoming connections over them.
+  static bool SupportsReusePort();
 
   // Start accepting on a newly created listening socket. If it was unable to
   // start accepting incoming sockets, the fd is invalidated.
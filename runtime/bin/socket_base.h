@@ -152,6 +152,28 @@ class SocketBase : public AllStatic {
                         const void* buffer,
                         intptr_t num_bytes,
                         SocketOpKind sync);
+  // Writes the 'count' buffers, in order, with a single system call where
+  // the platform supports it. Returns the total number of bytes written,
+  // which may end inside any of the buffers, or -1 on error. 'count' must not
+  // exceed kMaxWriteVBuffers.
+  static const intptr_t kMaxWriteVBuffers = 16;
+  static intptr_t WriteV(intptr_t fd,
+                         const void* const* buffers,
+                         const intptr_t* lengths,
+                         intptr_t count,
+                         SocketOpKind sync);
+  // Sends up to 'count' bytes of the file 'file_fd', starting at 'offset',
+  // without copying them through user space. Returns the number of bytes
+  // sent, 0 if the socket would block, kSendFileEndOfFile if 'offset' is at
+  // or past the end of the file, or -1 on error. Only supported where
+  // SupportsSendFile() is true.
+  static const intptr_t kSendFileEndOfFile = -2;
+  static bool SupportsSendFile();
+  static intptr_t SendFile(intptr_t fd,
+                           intptr_t file_fd,
+                           int64_t offset,
+                           intptr_t count,
+                           SocketOpKind sync);
   // Send data on a socket. The port to send to is specified in the port
   // component of the passed RawAddr structure. The RawAddr structure is only
   // used for datagram sockets.
@@ -165,6 +187,19 @@ class SocketBase : public AllStatic {
                            intptr_t num_bytes,
                            RawAddr* addr,
                            SocketOpKind sync);
+  // Receives up to 'count' datagrams, with a single system call where the
+  // platform supports it. Datagram i is stored at buffer + i * buffer_size,
+  // its length in lengths[i] and its sender in addrs[i]. Returns the number
+  // of datagrams received, 0 if none is pending, or -1 on error. 'count' must
+  // not exceed kMaxRecvFromMany.
+  static const intptr_t kMaxRecvFromMany = 8;
+  static intptr_t RecvFromMany(intptr_t fd,
+                               uint8_t* buffer,
+                               intptr_t buffer_size,
+                               intptr_t count,
+                               intptr_t* lengths,
+                               RawAddr* addrs,
+                               SocketOpKind sync);
   // Returns true if the given error-number is because the system was not able
   // to bind the socket to a specific IP.
   static bool IsBindError(intptr_t error_number);
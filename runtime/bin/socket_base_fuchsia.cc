@@ -126,6 +126,30 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return -1;
 }
 
+intptr_t SocketBase::RecvFromMany(intptr_t fd,
+                                  uint8_t* buffer,
+                                  intptr_t buffer_size,
+                                  intptr_t count,
+                                  intptr_t* lengths,
+                                  RawAddr* addrs,
+                                  SocketOpKind sync) {
+  ASSERT((count > 0) && (count <= kMaxRecvFromMany));
+  intptr_t received = 0;
+  while (received < count) {
+    intptr_t bytes_read = RecvFrom(fd, buffer + received * buffer_size,
+                                   buffer_size, &addrs[received], sync);
+    if (bytes_read < 0) {
+      // Report the error on the next call if some datagrams were received.
+      return (received > 0) ? received : -1;
+    }
+    if (bytes_read == 0) {
+      break;
+    }
+    lengths[received++] = bytes_read;
+  }
+  return received;
+}
+
 intptr_t SocketBase::Write(intptr_t fd,
                            const void* buffer,
                            intptr_t num_bytes,
@@ -150,6 +174,40 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteV(intptr_t fd,
+                            const void* const* buffers,
+                            const intptr_t* lengths,
+                            intptr_t count,
+                            SocketOpKind sync) {
+  // There is no vectored write here, so write the buffers one by one until
+  // one of them is not written completely.
+  intptr_t total = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    intptr_t written = Write(fd, buffers[i], lengths[i], sync);
+    if (written < 0) {
+      return (total > 0) ? total : written;
+    }
+    total += written;
+    if (written < lengths[i]) {
+      break;
+    }
+  }
+  return total;
+}
+
+bool SocketBase::SupportsSendFile() {
+  return false;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              intptr_t count,
+                              SocketOpKind sync) {
+  errno = ENOSYS;
+  return -1;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
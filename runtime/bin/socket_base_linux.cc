@@ -14,7 +14,9 @@
 #include <stdio.h>        // NOLINT
 #include <stdlib.h>       // NOLINT
 #include <string.h>       // NOLINT
+#include <sys/sendfile.h>  // NOLINT
 #include <sys/stat.h>     // NOLINT
+#include <sys/uio.h>      // NOLINT
 #include <unistd.h>       // NOLINT
 
 #include "bin/fdutils.h"
@@ -90,6 +92,39 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return read_bytes;
 }
 
+intptr_t SocketBase::RecvFromMany(intptr_t fd,
+                                  uint8_t* buffer,
+                                  intptr_t buffer_size,
+                                  intptr_t count,
+                                  intptr_t* lengths,
+                                  RawAddr* addrs,
+                                  SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT((count > 0) && (count <= kMaxRecvFromMany));
+  struct mmsghdr messages[kMaxRecvFromMany];
+  struct iovec iov[kMaxRecvFromMany];
+  memset(messages, 0, sizeof(messages));
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = buffer + i * buffer_size;
+    iov[i].iov_len = buffer_size;
+    messages[i].msg_hdr.msg_name = &addrs[i].addr;
+    messages[i].msg_hdr.msg_namelen = sizeof(addrs[i].ss);
+    messages[i].msg_hdr.msg_iov = &iov[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+  int received =
+      TEMP_FAILURE_RETRY(recvmmsg(fd, messages, count, MSG_DONTWAIT, NULL));
+  if ((sync == kAsync) && (received == -1) && (errno == EWOULDBLOCK)) {
+    // If the read would block we need to retry and therefore return 0
+    // as the number of datagrams read.
+    received = 0;
+  }
+  for (intptr_t i = 0; i < received; i++) {
+    lengths[i] = messages[i].msg_len;
+  }
+  return received;
+}
+
 intptr_t SocketBase::Write(intptr_t fd,
                            const void* buffer,
                            intptr_t num_bytes,
@@ -105,6 +140,53 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteV(intptr_t fd,
+                            const void* const* buffers,
+                            const intptr_t* lengths,
+                            intptr_t count,
+                            SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT((count > 0) && (count <= kMaxWriteVBuffers));
+  struct iovec iov[kMaxWriteVBuffers];
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = const_cast<void*>(buffers[i]);
+    iov[i].iov_len = lengths[i];
+  }
+  ssize_t written_bytes = TEMP_FAILURE_RETRY(writev(fd, iov, count));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    written_bytes = 0;
+  }
+  return written_bytes;
+}
+
+bool SocketBase::SupportsSendFile() {
+  return true;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              intptr_t count,
+                              SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  off64_t file_offset = offset;
+  ssize_t written_bytes =
+      TEMP_FAILURE_RETRY(sendfile64(fd, file_fd, &file_offset, count));
+  if ((written_bytes == 0) && (count > 0)) {
+    return kSendFileEndOfFile;
+  }
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    written_bytes = 0;
+  }
+  return written_bytes;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
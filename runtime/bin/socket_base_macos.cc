@@ -14,7 +14,10 @@
 #include <stdio.h>        // NOLINT
 #include <stdlib.h>       // NOLINT
 #include <string.h>       // NOLINT
+#include <sys/socket.h>   // NOLINT
 #include <sys/stat.h>     // NOLINT
+#include <sys/types.h>    // NOLINT
+#include <sys/uio.h>      // NOLINT
 #include <unistd.h>       // NOLINT
 
 #include "bin/fdutils.h"
@@ -89,6 +92,30 @@ intptr_t SocketBase::RecvFrom(intptr_t fd,
   return read_bytes;
 }
 
+intptr_t SocketBase::RecvFromMany(intptr_t fd,
+                                  uint8_t* buffer,
+                                  intptr_t buffer_size,
+                                  intptr_t count,
+                                  intptr_t* lengths,
+                                  RawAddr* addrs,
+                                  SocketOpKind sync) {
+  ASSERT((count > 0) && (count <= kMaxRecvFromMany));
+  intptr_t received = 0;
+  while (received < count) {
+    intptr_t bytes_read = RecvFrom(fd, buffer + received * buffer_size,
+                                   buffer_size, &addrs[received], sync);
+    if (bytes_read < 0) {
+      // Report the error on the next call if some datagrams were received.
+      return (received > 0) ? received : -1;
+    }
+    if (bytes_read == 0) {
+      break;
+    }
+    lengths[received++] = bytes_read;
+  }
+  return received;
+}
+
 intptr_t SocketBase::Write(intptr_t fd,
                            const void* buffer,
                            intptr_t num_bytes,
@@ -104,6 +131,58 @@ intptr_t SocketBase::Write(intptr_t fd,
   return written_bytes;
 }
 
+intptr_t SocketBase::WriteV(intptr_t fd,
+                            const void* const* buffers,
+                            const intptr_t* lengths,
+                            intptr_t count,
+                            SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  ASSERT((count > 0) && (count <= kMaxWriteVBuffers));
+  struct iovec iov[kMaxWriteVBuffers];
+  for (intptr_t i = 0; i < count; i++) {
+    iov[i].iov_base = const_cast<void*>(buffers[i]);
+    iov[i].iov_len = lengths[i];
+  }
+  ssize_t written_bytes = TEMP_FAILURE_RETRY(writev(fd, iov, count));
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((sync == kAsync) && (written_bytes == -1) && (errno == EWOULDBLOCK)) {
+    // If the would block we need to retry and therefore return 0 as
+    // the number of bytes written.
+    written_bytes = 0;
+  }
+  return written_bytes;
+}
+
+bool SocketBase::SupportsSendFile() {
+  return true;
+}
+
+intptr_t SocketBase::SendFile(intptr_t fd,
+                              intptr_t file_fd,
+                              int64_t offset,
+                              intptr_t count,
+                              SocketOpKind sync) {
+  ASSERT(fd >= 0);
+  // On input 'length' is the number of bytes to send, and on output the
+  // number of bytes sent, also when sendfile fails part way.
+  off_t length = count;
+  int result;
+  do {
+    length = count;
+    result = sendfile(file_fd, fd, offset, &length, NULL, 0);
+  } while ((result == -1) && (errno == EINTR) && (length == 0));
+  if (result == 0) {
+    return ((length == 0) && (count > 0)) ? kSendFileEndOfFile : length;
+  }
+  ASSERT(EAGAIN == EWOULDBLOCK);
+  if ((length > 0) || ((sync == kAsync) && (errno == EWOULDBLOCK))) {
+    // If the would block we need to retry and therefore return the number
+    // of bytes written so far.
+    return length;
+  }
+  return -1;
+}
+
 intptr_t SocketBase::SendTo(intptr_t fd,
                             const void* buffer,
                             intptr_t num_bytes,
@@ -298,6 +298,10 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
       typeInternalSocket |
       typeInternalSignalSocket;
 
+  // Maximum number of buffers passed to a single vectored write.
+  // Keep in sync with SocketBase::kMaxWriteVBuffers in socket_base.h.
+  static const int maxWriteVectorBuffers = 16;
+
   // Native port messages.
   static const hostNameLookupMessage = 0;
   static const listInterfacesMessage = 1;
@@ -338,6 +342,11 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   int available = 0;
 
+  // Datagrams received by a single native call but not yet returned by
+  // receive().
+  List<Datagram> receivedDatagrams;
+  int receivedDatagramsIndex = 0;
+
   int tokens = 0;
 
   bool sendReadEvents = false;
@@ -658,17 +667,34 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
 
   Datagram receive() {
     if (isClosing || isClosed) return null;
-    var result = nativeRecvFrom();
-    if (result is OSError) {
-      reportError(result, "Receive failed");
-      return null;
+    Datagram result;
+    if (receivedDatagrams != null) {
+      result = receivedDatagrams[receivedDatagramsIndex++];
+      if (receivedDatagramsIndex == receivedDatagrams.length) {
+        receivedDatagrams = null;
+      }
+    } else {
+      // Receive all pending datagrams, up to a limit, with one native call
+      // and hand them out one at a time.
+      var received = nativeRecvFromMany();
+      if (received is OSError) {
+        reportError(received, "Receive failed");
+        return null;
+      }
+      if (received != null) {
+        result = received[0];
+        if (received.length > 1) {
+          receivedDatagrams = received;
+          receivedDatagramsIndex = 1;
+        }
+      }
     }
     if (result != null) {
       // Read the next available. Available is only for the next datagram, not
       // the sum of all datagrams pending, so we need to call after each
       // receive. If available becomes > 0, the _NativeSocket will continue to
-      // emit read events.
-      available = nativeAvailable();
+      // emit read events, which datagrams already received also ensure.
+      available = receivedDatagrams != null ? 1 : nativeAvailable();
       // TODO(ricow): Remove when we track internal and pipe uses.
       assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
       if (resourceInfo != null) {
@@ -727,6 +753,69 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
     return result;
   }
 
+  // Writes as much as possible of [buffers], starting at [offset] in the
+  // first one, with a single vectored write. Only the first
+  // [maxWriteVectorBuffers] buffers are considered. Returns the number of
+  // bytes written.
+  int writeVector(List<List<int>> buffers, int offset) {
+    if (isClosing || isClosed) return 0;
+    final count = min(buffers.length, maxWriteVectorBuffers);
+    final fastBuffers = new List<List<int>>(count);
+    int bytes = -offset;
+    for (int i = 0; i < count; i++) {
+      final buffer = buffers[i];
+      fastBuffers[i] =
+          _ensureFastAndSerializableByteData(buffer, 0, buffer.length).buffer;
+      bytes += buffer.length;
+    }
+    if (bytes == 0) return 0;
+    var result = nativeWriteVector(fastBuffers, offset);
+    if (result is OSError) {
+      OSError osError = result;
+      scheduleMicrotask(() => reportError(osError, "Write failed"));
+      result = 0;
+    }
+    // See write for the handling of negative results.
+    if (result >= 0 && result < bytes) {
+      writeAvailable = false;
+    }
+    if (result < 0) result = -result;
+    // TODO(ricow): Remove when we track internal and pipe uses.
+    assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+    if (resourceInfo != null) {
+      resourceInfo.addWrite(result);
+    }
+    return result;
+  }
+
+  static bool _sendFileSupported;
+  static bool get sendFileSupported =>
+      _sendFileSupported ??= nativeSendFileSupported();
+
+  // Sends up to [length] bytes of the file with the native pointer
+  // [filePointer], starting at [position], without reading them into Dart.
+  // Returns -1 if [position] is at the end of the file.
+  int sendFile(int filePointer, int position, int length) {
+    if (isClosing || isClosed) return 0;
+    if (length == 0) return 0;
+    var result = nativeSendFile(filePointer, position, length);
+    if (result == null) return -1;
+    if (result is OSError) {
+      OSError osError = result;
+      scheduleMicrotask(() => reportError(osError, "Write failed"));
+      result = 0;
+    }
+    if (result < length) {
+      writeAvailable = false;
+    }
+    // TODO(ricow): Remove when we track internal and pipe uses.
+    assert(resourceInfo != null || isPipe || isInternal || isInternalSignal);
+    if (resourceInfo != null) {
+      resourceInfo.addWrite(result);
+    }
+    return result;
+  }
+
   int send(List<int> buffer, int offset, int bytes, InternetAddress address,
       int port) {
     _throwOnBadPort(port);
@@ -871,6 +960,7 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
             available++;
           } else {
             available = nativeAvailable();
+            if (available == 0 && receivedDatagrams != null) available = 1;
             issueReadEvent();
             continue;
           }
@@ -1119,9 +1209,14 @@ class _NativeSocket extends _NativeSocketNativeWrapper with _ServiceObject {
   void nativeSetSocketId(int id, int typeFlags) native "Socket_SetSocketId";
   nativeAvailable() native "Socket_Available";
   nativeRead(int len) native "Socket_Read";
-  nativeRecvFrom() native "Socket_RecvFrom";
+  nativeRecvFromMany() native "Socket_RecvFromMany";
   nativeWrite(List<int> buffer, int offset, int bytes)
       native "Socket_WriteList";
+  nativeWriteVector(List<List<int>> buffers, int offset)
+      native "Socket_WriteVector";
+  nativeSendFile(int filePointer, int position, int length)
+      native "Socket_SendFile";
+  static bool nativeSendFileSupported() native "Socket_SendFileSupported";
   nativeSendTo(List<int> buffer, int offset, int bytes, List<int> address,
       int port) native "Socket_SendTo";
   nativeCreateConnect(List<int> addr, int port) native "Socket_CreateConnect";
@@ -1338,6 +1433,12 @@ class _RawSocket extends Stream<RawSocketEvent> implements RawSocket {
   int write(List<int> buffer, [int offset, int count]) =>
       _socket.write(buffer, offset, count);
 
+  int _writeVector(List<List<int>> buffers, int offset) =>
+      _socket.writeVector(buffers, offset);
+
+  int _sendFile(int filePointer, int position, int length) =>
+      _socket.sendFile(filePointer, position, length);
+
   Future<RawSocket> close() => _socket.close().then<RawSocket>((_) => this);
 
   void shutdown(SocketDirection direction) => _socket.shutdown(direction);
@@ -1463,39 +1564,141 @@ class Socket {
 }
 
 class _SocketStreamConsumer extends StreamConsumer<List<int>> {
+  // Data is still accepted while waiting for the socket to become writable,
+  // until this many bytes are pending. The pending buffers are then written
+  // together with a vectored write.
+  static const int _maxPendingBytes = 64 * 1024;
+
   StreamSubscription subscription;
   final _Socket socket;
-  int offset;
-  List<int> buffer;
+  // The offset of the unwritten data in the first of [buffers].
+  int offset = 0;
+  final List<List<int>> buffers = <List<int>>[];
+  int pendingBytes = 0;
   bool paused = false;
+  // Set when the stream is done while buffers are still pending.
+  bool streamDone = false;
   Completer streamCompleter;
 
+  // Set while the range [filePosition, fileEnd) of a file is sent directly
+  // from the file, see sendFile. [file] is null until it has been opened.
+  bool sendingFile = false;
+  RandomAccessFile file;
+  int filePosition;
+  int fileEnd;
+
   _SocketStreamConsumer(this.socket);
 
   Future<Socket> addStream(Stream<List<int>> stream) {
     socket._ensureRawSocketSubscription();
     streamCompleter = new Completer<Socket>();
     if (socket._raw != null) {
-      subscription = stream.listen((data) {
-        assert(!paused);
-        assert(buffer == null);
-        buffer = data;
-        offset = 0;
-        try {
+      if (stream is _FileStream &&
+          stream._path != null &&
+          socket._canSendFile) {
+        sendFile(stream);
+      } else {
+        listen(stream);
+      }
+    }
+    return streamCompleter.future;
+  }
+
+  void listen(Stream<List<int>> stream) {
+    subscription = stream.listen((data) {
+      assert(!paused);
+      if (data.isEmpty) return;
+      buffers.add(data);
+      pendingBytes += data.length;
+      try {
+        if (buffers.length == 1) {
           write();
-        } catch (e) {
-          socket.destroy();
-          stop();
-          done(e);
+        } else if (pendingBytes >= _maxPendingBytes) {
+          // Wait for the write event to write the pending buffers.
+          paused = true;
+          subscription.pause();
         }
-      }, onError: (error, [stackTrace]) {
+      } catch (e) {
         socket.destroy();
-        done(error, stackTrace);
-      }, onDone: () {
+        stop();
+        done(e);
+      }
+    }, onError: (error, [stackTrace]) {
+      socket.destroy();
+      done(error, stackTrace);
+    }, onDone: () {
+      if (buffers.isEmpty) {
         done();
-      }, cancelOnError: true);
+      } else {
+        // Complete once the pending buffers have been written.
+        streamDone = true;
+      }
+    }, cancelOnError: true);
+  }
+
+  // Sends the file read by [stream] without reading it into Dart, which
+  // lets the kernel copy it to the socket directly.
+  void sendFile(_FileStream stream) {
+    sendingFile = true;
+    final path = stream._path;
+    final start = stream._position;
+    final end = stream._end;
+    FileStat.stat(path).then((stat) {
+      if (!sendingFile) return null;
+      if (stat.type != FileSystemEntityType.file) {
+        // Pipes and devices, and missing files, are handled by the stream.
+        sendingFile = false;
+        listen(stream);
+        return null;
+      }
+      if (end != null && end < start) {
+        throw new RangeError("Bad end position: $end");
+      }
+      return new File(path).open().then((opened) {
+        if (!sendingFile) {
+          opened.close().catchError((_) {});
+          return;
+        }
+        file = opened;
+        filePosition = start;
+        fileEnd = end == null ? stat.size : min(end, stat.size);
+        write();
+      });
+    }).catchError((error, stackTrace) {
+      if (!sendingFile) return;
+      socket.destroy();
+      done(error, stackTrace);
+    });
+  }
+
+  void writeFile() {
+    try {
+      while (filePosition < fileEnd) {
+        int written =
+            socket._sendFile(file, filePosition, fileEnd - filePosition);
+        // The file may have been truncated since it was opened.
+        if (written < 0) break;
+        if (written == 0) {
+          socket._enableWriteEvent();
+          return;
+        }
+        filePosition += written;
+      }
+    } catch (e) {
+      socket.destroy();
+      done(e);
+      return;
+    }
+    done();
+  }
+
+  void closeFile() {
+    if (!sendingFile) return;
+    sendingFile = false;
+    if (file != null) {
+      file.close().catchError((_) {});
+      file = null;
     }
-    return streamCompleter.future;
   }
 
   Future<Socket> close() {
@@ -1504,26 +1707,55 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   }
 
   void write() {
+    if (sendingFile) {
+      if (file != null) writeFile();
+      return;
+    }
     if (subscription == null) return;
-    assert(buffer != null);
     // Write as much as possible.
-    offset += socket._write(buffer, offset, buffer.length - offset);
-    if (offset < buffer.length) {
-      if (!paused) {
+    while (buffers.isNotEmpty) {
+      int requested;
+      int written;
+      if (buffers.length == 1) {
+        var buffer = buffers[0];
+        requested = buffer.length - offset;
+        written = socket._write(buffer, offset, requested);
+      } else {
+        requested = -offset;
+        int count = min(buffers.length, _NativeSocket.maxWriteVectorBuffers);
+        for (int i = 0; i < count; i++) {
+          requested += buffers[i].length;
+        }
+        written = socket._writeVector(buffers, offset);
+      }
+      pendingBytes -= written;
+      offset += written;
+      int completed = 0;
+      while (completed < buffers.length &&
+          offset >= buffers[completed].length) {
+        offset -= buffers[completed].length;
+        completed++;
+      }
+      buffers.removeRange(0, completed);
+      if (written < requested) break;
+    }
+    if (buffers.isNotEmpty) {
+      if (!paused && pendingBytes >= _maxPendingBytes) {
         paused = true;
         subscription.pause();
       }
       socket._enableWriteEvent();
-    } else {
-      buffer = null;
-      if (paused) {
-        paused = false;
-        subscription.resume();
-      }
+    } else if (streamDone) {
+      streamDone = false;
+      done();
+    } else if (paused) {
+      paused = false;
+      subscription.resume();
     }
   }
 
   void done([error, stackTrace]) {
+    closeFile();
     if (streamCompleter != null) {
       if (error != null) {
         streamCompleter.completeError(error, stackTrace);
@@ -1535,9 +1767,13 @@ class _SocketStreamConsumer extends StreamConsumer<List<int>> {
   }
 
   void stop() {
+    closeFile();
     if (subscription == null) return;
     subscription.cancel();
     subscription = null;
+    buffers.clear();
+    offset = pendingBytes = 0;
+    streamDone = false;
     paused = false;
     socket._disableWriteEvent();
   }
@@ -1662,7 +1898,7 @@ class _Socket extends Stream<List<int>> implements Socket {
     _detachReady = new Completer();
     _sink.close();
     return _detachReady.future.then((_) {
-      assert(_consumer.buffer == null);
+      assert(_consumer.buffers.isEmpty);
       var raw = _raw;
       _raw = null;
       return [raw, _subscription];
@@ -1743,6 +1979,29 @@ class _Socket extends Stream<List<int>> implements Socket {
   int _write(List<int> data, int offset, int length) =>
       _raw.write(data, offset, length);
 
+  int _writeVector(List<List<int>> buffers, int offset) {
+    var raw = _raw;
+    if (raw is _RawSocket) return raw._writeVector(buffers, offset);
+    // Other raw sockets, such as secure sockets, write buffer by buffer.
+    int written = 0;
+    for (var buffer in buffers) {
+      int bytes = raw.write(buffer, offset, buffer.length - offset);
+      written += bytes;
+      if (offset + bytes < buffer.length) break;
+      offset = 0;
+    }
+    return written;
+  }
+
+  bool get _canSendFile =>
+      _raw is _RawSocket && _NativeSocket.sendFileSupported;
+
+  int _sendFile(RandomAccessFile file, int position, int length) {
+    _RawSocket raw = _raw;
+    _RandomAccessFile opened = file;
+    return raw._sendFile(opened._ops.getPointer(), position, length);
+  }
+
   void _enableWriteEvent() {
     _raw.writeEventsEnabled = true;
   }
@@ -179,9 +179,15 @@ intptr_t Socket::CreateBindDatagram(const RawAddr& addr, bool reuseAddress) {
   return reinterpret_cast<intptr_t>(datagram_socket);
 }
 
+bool ServerSocket::SupportsReusePort() {
+  return false;
+}
+
 intptr_t ServerSocket::CreateBindListen(const RawAddr& addr,
                                         intptr_t backlog,
-                                        bool v6_only) {
+                                        bool v6_only,
+                                        bool reuse_port) {
+  ASSERT(!reuse_port);
   SOCKET s = socket(addr.ss.ss_family, SOCK_STREAM, IPPROTO_TCP);
   if (s == INVALID_SOCKET) {
     return -1;
@@ -220,7 +226,7 @@ intptr_t ServerSocket::CreateBindListen(const RawAddr& addr,
        65535)) {
     // Don't close fd until we have created new. By doing that we ensure another
     // port.
-    intptr_t new_s = CreateBindListen(addr, backlog, v6_only);
+    intptr_t new_s = CreateBindListen(addr, backlog, v6_only, reuse_port);
     DWORD rc = WSAGetLastError();
     closesocket(s);
     listen_socket->Release();
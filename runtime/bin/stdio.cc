@@ -4,6 +4,7 @@
 
 #include "bin/stdio.h"
 
+#include "bin/buffered_stdio.h"
 #include "bin/builtin.h"
 #include "bin/dartutils.h"
 #include "bin/utils.h"
@@ -147,6 +148,36 @@ void FUNCTION_NAME(Stdout_GetTerminalSize)(Dart_NativeArguments args) {
   }
 }
 
+void FUNCTION_NAME(Stdout_IsBuffered)(Dart_NativeArguments args) {
+  intptr_t fd;
+  if (!GetIntptrArgument(args, 0, &fd)) {
+    return;
+  }
+  Dart_SetBooleanReturnValue(args, BufferedStdio::IsBuffered(fd));
+}
+
+void FUNCTION_NAME(Stdout_BufferedWrite)(Dart_NativeArguments args) {
+  intptr_t fd;
+  if (!GetIntptrArgument(args, 0, &fd)) {
+    return;
+  }
+  if (!BufferedStdio::IsBuffered(fd)) {
+    Dart_ThrowException(DartUtils::NewDartArgumentError("Not buffered"));
+  }
+  {
+    // Wait before acquiring the data, which must not be held for long.
+    ScopedBlockingCall blocker;
+    BufferedStdio::WaitForSpace();
+  }
+  ScopedMemBuffer buffer(Dart_GetNativeArgument(args, 1));
+  BufferedStdio::Write(fd, buffer.get(), buffer.length());
+}
+
+void FUNCTION_NAME(Stdout_Flush)(Dart_NativeArguments args) {
+  ScopedBlockingCall blocker;
+  BufferedStdio::Flush();
+}
+
 void FUNCTION_NAME(Stdout_AnsiSupported)(Dart_NativeArguments args) {
   intptr_t fd;
   if (!GetIntptrArgument(args, 0, &fd)) {
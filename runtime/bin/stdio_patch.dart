@@ -28,6 +28,9 @@ class _StdIOUtils {
       case _stdioHandleTypePipe:
       case _stdioHandleTypeSocket:
       case _stdioHandleTypeFile:
+        if (Stdout._isBuffered(fd)) {
+          return new Stdout._(new IOSink(new _BufferedStdConsumer(fd)), fd);
+        }
         return new Stdout._(new IOSink(new _StdConsumer(fd)), fd);
       default:
         throw new FileSystemException(
@@ -160,6 +163,39 @@ class Stdout {
   }
 
   static _getAnsiSupported(int fd) native "Stdout_AnsiSupported";
+
+  static bool _isBuffered(int fd) native "Stdout_IsBuffered";
+}
+
+// Consumer for stdout and stderr with --buffered-stdio. Data is handed to the
+// native buffer, which is written out on flush() and close() or by a
+// background thread.
+class _BufferedStdConsumer implements StreamConsumer<List<int>> {
+  final int _fd;
+
+  _BufferedStdConsumer(this._fd);
+
+  Future addStream(Stream<List<int>> stream) {
+    var completer = new Completer();
+    stream.listen((data) {
+      if (data is! Uint8List) {
+        data = new Uint8List.fromList(data);
+      }
+      _write(_fd, data);
+    }, onError: completer.completeError, onDone: () {
+      _flush();
+      completer.complete();
+    }, cancelOnError: true);
+    return completer.future;
+  }
+
+  Future close() {
+    _flush();
+    return new Future.value();
+  }
+
+  static _write(int fd, List<int> data) native "Stdout_BufferedWrite";
+  static _flush() native "Stdout_Flush";
 }
 
 _getStdioHandle(_NativeSocket socket, int num) native "Socket_GetStdioHandle";
@@ -73,6 +73,22 @@ class IsolateLoaderState extends IsolateEmbedderData {
   bool _dead = false;
   SendPort sp;
 
+  // Native ports of the embedder that read files and reply directly to the
+  // requesting isolate's loader. Null if the embedder does not provide them,
+  // in which case files are read with dart:io.
+  List<SendPort> fileReaders;
+  int _nextFileReader = 0;
+
+  SendPort nextFileReader() {
+    if (_deterministic) {
+      // A single reader replies in request order.
+      return fileReaders[0];
+    }
+    var reader = fileReaders[_nextFileReader];
+    _nextFileReader = (_nextFileReader + 1) % fileReaders.length;
+    return reader;
+  }
+
   void init(String packageRootFlag, String packagesConfigFlag,
       String workingDirectory, String rootScript) {
     if (_dead) {
@@ -509,7 +525,19 @@ _loadPackage(IsolateLoaderState loaderState, SendPort sp, bool traceLoading,
 _handleResourceRequest(IsolateLoaderState loaderState, SendPort sp,
     bool traceLoading, int tag, Uri uri, Uri resolvedUri, String libraryUrl) {
   if (resolvedUri.scheme == '' || resolvedUri.scheme == 'file') {
-    if (loaderState.shouldIssueFileRequest) {
+    if (loaderState.fileReaders != null) {
+      // The embedder reads the file and replies to the loader without a round
+      // trip through this isolate. Reads are spread over the readers so they
+      // overlap.
+      var request = new List(6);
+      request[0] = sp;
+      request[1] = tag;
+      request[2] = uri.toString();
+      request[3] = resolvedUri.toString();
+      request[4] = libraryUrl;
+      request[5] = resolvedUri.toFilePath();
+      loaderState.nextFileReader().send(request);
+    } else if (loaderState.shouldIssueFileRequest) {
       _loadFile(loaderState, sp, tag, uri, resolvedUri, libraryUrl);
       loaderState.currentFileRequests++;
     } else {
@@ -1017,6 +1045,7 @@ _processLoadRequest(request) {
         String workingDirectory = request[6];
         String rootScript = request[7];
         bool isReloading = request[8];
+        List fileReaders = (request.length > 9) ? request[9] : null;
         if (loaderState == null) {
           loaderState = new IsolateLoaderState(isolateId);
           isolateEmbedderData[isolateId] = loaderState;
@@ -1026,6 +1055,9 @@ _processLoadRequest(request) {
           loaderState.updatePackageMap(packagesFile);
         }
         loaderState.sp = sp;
+        loaderState.fileReaders = (fileReaders == null)
+            ? null
+            : new List<SendPort>.from(fileReaders, growable: false);
         assert(isolateEmbedderData[isolateId] == loaderState);
       }
       break;
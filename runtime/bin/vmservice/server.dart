@@ -80,6 +80,10 @@ class WebSocketClient extends Client {
         case ResponsePayloadKind.Utf8String:
           socket.addUtf8Text(result.payload);
           break;
+        case ResponsePayloadKind.Utf8Chunks:
+          // A WebSocket message cannot be sent in parts.
+          socket.addUtf8Text(Response.joinChunks(result.payload));
+          break;
       }
     } catch (e, st) {
       serverPrint("Ignoring error posting over WebSocket.");
@@ -125,6 +129,9 @@ class HttpRequestClient extends Client {
       case ResponsePayloadKind.Utf8String:
         response.add(result.payload);
         break;
+      case ResponsePayloadKind.Utf8Chunks:
+        result.payload.forEach(response.add);
+        break;
       case ResponsePayloadKind.Binary:
         throw 'Can not handle binary responses';
     }
@@ -957,7 +957,9 @@ DART_EXPORT void Dart_EnterIsolate(Dart_Isolate isolate);
 /**
  * Notifies the VM that the embedder expects to be idle until |deadline|. The VM
  * may use this time to perform garbage collection or other tasks to avoid
- * delays during execution of Dart code in the future.
+ * delays during execution of Dart code in the future. When the time left is
+ * too short for a whole collection, the VM works on part of one instead, so
+ * frequent short idle periods also reduce future pauses.
  *
  * |deadline| is measured in microseconds against the system's monotonic time.
  * This clock can be accessed via Dart_TimelineGetMicros().
@@ -2137,6 +2139,31 @@ DART_EXPORT Dart_Handle Dart_MapContainsKey(Dart_Handle map, Dart_Handle key);
  */
 DART_EXPORT Dart_Handle Dart_MapKeys(Dart_Handle map);
 
+/**
+ * Gets the keys and values of a Map, in iteration order.
+ *
+ * Fills keys and values with the first min(capacity, length) entries and
+ * sets length to the number of entries of the map, so that passing a
+ * capacity of 0 just queries the length. Maps created by the VM are read
+ * directly, without calls into Dart.
+ *
+ * May generate an unhandled exception error.
+ *
+ * \param map A Map.
+ * \param keys An array of at least capacity handles to fill with the keys.
+ * \param values An array of at least capacity handles to fill with the
+ *   values.
+ * \param capacity The number of entries keys and values can hold.
+ * \param length Set to the number of entries of the map.
+ *
+ * \return Success if no error occurs during the operation.
+ */
+DART_EXPORT Dart_Handle Dart_MapGetEntries(Dart_Handle map,
+                                           Dart_Handle* keys,
+                                           Dart_Handle* values,
+                                           intptr_t capacity,
+                                           intptr_t* length);
+
 /*
  * ==========
  * Typed Data
@@ -2212,7 +2239,10 @@ DART_EXPORT Dart_Handle Dart_NewExternalTypedData(Dart_TypedData_Type type,
  * \param peer A pointer to a native object or NULL.  This value is
  *   provided to callback when it is invoked.
  * \param external_allocation_size The number of externally allocated
- *   bytes for peer. Used to inform the garbage collector.
+ *   bytes for peer. Used to inform the garbage collector. Once the external
+ *   bytes held by the isolate's objects exceed the VM's soft limit, this call
+ *   first collects garbage, so that finalizers of unreachable objects release
+ *   their memory before more is allocated.
  * \param callback A function pointer that will be invoked sometime
  *   after the object is garbage collected, unless the handle has been deleted.
  *   A valid callback needs to be specified it cannot be NULL.
@@ -3375,6 +3405,32 @@ Dart_SaveCompilationTrace(uint8_t** buffer, intptr_t* buffer_length);
 DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
 Dart_LoadCompilationTrace(uint8_t* buffer, intptr_t buffer_length);
 
+/**
+ * Record the type feedback collected by the current isolate: receiver classes
+ * and counts of call sites, usage counters, field guard states and which
+ * functions were optimized.
+ *
+ * \param buffer Returns a pointer to a buffer containing the feedback.
+ *   This buffer is scope allocated and is only valid  until the next call to
+ *   Dart_ExitScope.
+ * \param size Returns the size of the buffer.
+ * \return Returns an valid handle upon success.
+ */
+DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
+Dart_SaveTypeFeedback(uint8_t** buffer, intptr_t* buffer_length);
+
+/**
+ * Seed the current isolate with type feedback from Dart_SaveTypeFeedback and
+ * optimize the functions which were optimized when it was saved. Like
+ * compilation traces, the feedback is fuzzy: entries which do not match the
+ * loaded program are ignored.
+ *
+ * \return Returns an error handle if a compilation error was encountered or
+ *   the feedback has an incompatible format.
+ */
+DART_EXPORT DART_WARN_UNUSED_RESULT Dart_Handle
+Dart_LoadTypeFeedback(uint8_t* buffer, intptr_t buffer_length);
+
 /*
  * ==============
  * Precompilation
@@ -33,6 +33,14 @@
  * message send and returned when the VM invokes the
  * Dart_WeakPersistentHandleFinalizer callback; a non-NULL callback must be
  * provided.
+ *
+ * On message receipt by a native port, typed data is not copied out of the
+ * message. Large typed data sent from Dart, and external typed data posted
+ * with Dart_PostCObject, is received as kExternalTyped with the length in
+ * bytes. The VM invokes its callback when the message handler returns; the
+ * handler can instead take ownership of the data by saving 'peer' and
+ * 'callback' and setting 'callback' to NULL, and must then invoke the
+ * callback itself once done with the data.
  */
 typedef enum {
   Dart_CObject_kNull = 0,
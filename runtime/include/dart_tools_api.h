@@ -226,6 +226,88 @@ DART_EXPORT Dart_Handle Dart_ServiceSendDataEvent(const char* stream_id,
                                                   const uint8_t* bytes,
                                                   intptr_t bytes_length);
 
+/*
+ * ========
+ * Profiler
+ * ========
+ */
+
+typedef enum {
+  /** Samples of the CPU time spent by the isolate. */
+  Dart_PprofProfile_CPU = 0,
+  /** Samples of allocations traced with _setTraceClassAllocation. */
+  Dart_PprofProfile_Allocation,
+  /**
+   * Samples of all allocations in the Dart heap, taken about once per
+   * --heap_sample_interval KB allocated and scaled to estimate the number
+   * and size of all allocations.
+   */
+  Dart_PprofProfile_Heap,
+} Dart_PprofProfileKind;
+
+/**
+ * Writes the profiler samples of the current isolate as a gzipped pprof
+ * profile (see https://github.com/google/pprof). Dart functions, inlined
+ * frames and native symbols are resolved by the VM.
+ *
+ * The profile is passed to 'callback' in chunks as it is written, so the
+ * full profile is never held in memory.
+ *
+ * Requires there to be a current isolate.
+ *
+ * \param kind The kind of samples to write.
+ * \param callback Called with each chunk of the profile.
+ * \param callback_data Passed to 'callback'.
+ *
+ * \return Success if the profile was written. Otherwise, returns an error
+ *   handle, e.g. if the profiler is disabled.
+ */
+DART_EXPORT Dart_Handle
+Dart_WritePprofProfile(Dart_PprofProfileKind kind,
+                       Dart_StreamingWriteCallback callback,
+                       void* callback_data);
+
+/**
+ * Records a native allocation of 'size' bytes at 'ptr' for the native
+ * memory profile of --profiler_native_memory, e.g. from an embedder's
+ * allocator. With --native_memory_sample_interval, only about one
+ * allocation per interval is recorded, with its stack trace.
+ *
+ * The VM records allocations of malloc itself only when it uses TCMalloc.
+ * Allocations it records must not be reported again.
+ *
+ * Can be called from any thread. Does nothing without
+ * --profiler_native_memory and in PRODUCT mode.
+ */
+DART_EXPORT void Dart_RecordNativeAllocation(void* ptr, intptr_t size);
+
+/**
+ * Records that the allocation at 'ptr' reported with
+ * Dart_RecordNativeAllocation was freed.
+ */
+DART_EXPORT void Dart_RecordNativeFree(void* ptr);
+
+/*
+ * ========
+ * Metrics
+ * ========
+ */
+
+/**
+ * Renders the current values of all VM metrics and of the metrics of every
+ * running isolate in the OpenMetrics text format (see
+ * https://openmetrics.io), e.g. to be served to a Prometheus scraper.
+ * Isolate metrics are labeled with the name and main port of their isolate.
+ *
+ * Can be called from any thread, with or without a current isolate. The
+ * values are read without pausing the isolates, so metrics of a running
+ * isolate may be slightly out of date.
+ *
+ * \return A malloc'ed string the caller is responsible for freeing, or NULL
+ *   in PRODUCT mode.
+ */
+DART_EXPORT char* Dart_GetOpenMetrics();
+
 /*
  * ========
  * Reload support
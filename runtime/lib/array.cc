@@ -68,6 +68,53 @@ DEFINE_NATIVE_ENTRY(List_slice, 4) {
   return src.Slice(istart, icount, needs_type_arg.value());
 }
 
+// Returns the array holding the elements of a fixed-length or growable list
+// and sets 'length' to the number of elements in use.
+static RawArray* GetBackingArray(const Instance& list, intptr_t* length) {
+  if (list.IsGrowableObjectArray()) {
+    const GrowableObjectArray& growable = GrowableObjectArray::Cast(list);
+    *length = growable.Length();
+    return growable.data();
+  }
+  const Array& array = Array::Cast(list);
+  *length = array.Length();
+  return array.raw();
+}
+
+// List dst, int dst_start, List src, int src_start, int count.
+// Both lists are fixed-length or growable VM lists; the ranges may overlap.
+DEFINE_NATIVE_ENTRY(List_copyFrom, 5) {
+  const Instance& dst_list = Instance::CheckedHandle(arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, dst_start, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, src_list, arguments->NativeArgAt(2));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, src_start, arguments->NativeArgAt(3));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, count, arguments->NativeArgAt(4));
+  ASSERT(dst_list.IsArray() || dst_list.IsGrowableObjectArray());
+  if (!src_list.IsArray() && !src_list.IsGrowableObjectArray()) {
+    Exceptions::ThrowArgumentError(src_list);
+  }
+  intptr_t dst_length = 0;
+  intptr_t src_length = 0;
+  const Array& dst =
+      Array::Handle(zone, GetBackingArray(dst_list, &dst_length));
+  const Array& src =
+      Array::Handle(zone, GetBackingArray(src_list, &src_length));
+  const intptr_t icount = count.Value();
+  if ((icount < 0) || (icount > dst_length) || (icount > src_length)) {
+    Exceptions::ThrowRangeError("count", count, 0,
+                                Utils::Minimum(dst_length, src_length));
+  }
+  if ((dst_start.Value() < 0) || (dst_start.Value() > dst_length - icount)) {
+    Exceptions::ThrowRangeError("start", dst_start, 0, dst_length - icount);
+  }
+  if ((src_start.Value() < 0) || (src_start.Value() > src_length - icount)) {
+    Exceptions::ThrowRangeError("skipCount", src_start, 0,
+                                src_length - icount);
+  }
+  dst.CopyFrom(dst_start.Value(), src, src_start.Value(), icount);
+  return Object::null();
+}
+
 // Private factory, expects correct arguments.
 DEFINE_NATIVE_ENTRY(ImmutableList_from, 4) {
   // Ignore first argument of a thsi factory (type argument).
@@ -17,6 +17,11 @@ class _List<E> extends FixedLengthListBase<E> {
 
   int get length native "List_getLength";
 
+  // Copies [count] elements of the VM list [src] starting at [srcStart] to
+  // this list starting at [start]. The ranges may overlap.
+  void _copyFrom(int start, List src, int srcStart, int count)
+      native "List_copyFrom";
+
   List _slice(int start, int count, bool needsTypeArgument) {
     if (count <= 64) {
       final result = needsTypeArgument ? new _List<E>(count) : new _List(count);
@@ -42,11 +47,11 @@ class _List<E> extends FixedLengthListBase<E> {
     }
     int length = end - start;
     if (length == 0) return;
-    if (identical(this, iterable)) {
-      Lists.copy(this, skipCount, this, start, length);
-    } else if (ClassID.getID(iterable) == ClassID.cidArray) {
-      final _List<E> iterableAsList = iterable;
-      Lists.copy(iterableAsList, skipCount, this, start, length);
+    final cid = ClassID.getID(iterable);
+    if ((cid == ClassID.cidArray) ||
+        (cid == ClassID.cidGrowableObjectArray) ||
+        (cid == ClassID.cidImmutableArray)) {
+      _copyFrom(start, iterable, skipCount, length);
     } else if (iterable is List<E>) {
       Lists.copy(iterable, skipCount, this, start, length);
     } else {
@@ -88,18 +88,34 @@ Function _asyncErrorWrapperHelper(continuation) {
 
 /// Registers the [thenCallback] and [errorCallback] on the given [object].
 ///
-/// If [object] is not a future, then it is wrapped into one.
+/// If [object] is not a future, or is an internal future that has already
+/// completed with a value, the continuation is resumed from a microtask without
+/// registering a listener.
 ///
-/// Returns the result of registering with `.then`.
+/// Returns the result of registering with `.then`, or null if no listener was
+/// registered.
 Future _awaitHelper(
     var object, Function thenCallback, Function errorCallback, var awaiter) {
   if (object is! Future) {
-    object = new _Future().._setValue(object);
+    // Awaiting a value that is not a future: resume the continuation from a
+    // microtask directly instead of wrapping the value into a completed
+    // `_Future` and listening on it, which would also allocate a listener and
+    // the result future of `.then`.
+    _resumeLater(Zone.current, thenCallback, object);
+    return null;
   } else if (object is! _Future) {
     return object.then(thenCallback, onError: errorCallback);
   }
   // `object` is a `_Future`.
   //
+  // If it has already completed with a value, resume the continuation the same
+  // way its listeners would be notified, but without creating a listener and a
+  // result future.
+  _Future future = object;
+  if (future._isComplete && !future._hasError) {
+    _resumeLater(future._zone, thenCallback, future._resultOrListeners);
+    return null;
+  }
   // Since the callbacks have been registered in the current zone (see
   // [_asyncThenWrapperHelper] and [_asyncErrorWrapperHelper]), we can avoid
   // another registration and directly invoke the no-zone-registration `.then`.
@@ -110,6 +126,19 @@ Future _awaitHelper(
   return object._thenNoZoneRegistration(thenCallback, errorCallback);
 }
 
+/// Schedules [thenCallback] to be run with [value] in the current zone from a
+/// microtask scheduled in [zone].
+///
+/// This mirrors how a completed `_Future` notifies a listener added with
+/// `_thenNoZoneRegistration`: the callback has already been registered in the
+/// current zone (see [_asyncThenWrapperHelper]).
+void _resumeLater(Zone zone, Function thenCallback, var value) {
+  final Zone current = Zone.current;
+  zone.scheduleMicrotask(() {
+    current.runUnary(thenCallback, value);
+  });
+}
+
 // Called as part of the 'await for (...)' construct. Registers the
 // awaiter on the stream.
 void _asyncStarListenHelper(var object, var awaiter) {
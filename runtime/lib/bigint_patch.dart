@@ -1182,6 +1182,10 @@ class _BigIntImpl implements BigInt {
     return 1;
   }
 
+  /// Operands with at least this many digits are multiplied with the
+  /// Karatsuba algorithm rather than digit by digit.
+  static const int _karatsubaThreshold = 64;
+
   /// Multiplication operator.
   _BigIntImpl operator *(BigInt bigInt) {
     _BigIntImpl other = bigInt;
@@ -1190,6 +1194,10 @@ class _BigIntImpl implements BigInt {
     if (used == 0 || otherUsed == 0) {
       return zero;
     }
+    if (used >= _karatsubaThreshold && otherUsed >= _karatsubaThreshold) {
+      var result = _karatsubaMul(abs(), other.abs());
+      return (_isNegative != other._isNegative) ? -result : result;
+    }
     var resultUsed = used + otherUsed;
     var digits = _digits;
     var otherDigits = other._digits;
@@ -1202,6 +1210,43 @@ class _BigIntImpl implements BigInt {
         _isNegative != other._isNegative, resultUsed, resultDigits);
   }
 
+  /// Returns `x * y` for non-negative [x] and [y].
+  ///
+  /// Splits the operands at `half` digits into `x1*B + x0` and `y1*B + y0`,
+  /// and computes the product from the three products `x0*y0`, `x1*y1` and
+  /// `(x0 + x1)*(y0 + y1)`, recursively, instead of the four products of the
+  /// schoolbook method.
+  static _BigIntImpl _karatsubaMul(_BigIntImpl x, _BigIntImpl y) {
+    assert(!x._isNegative && !y._isNegative);
+    if (x._used < y._used) {
+      var t = x;
+      x = y;
+      y = t;
+    }
+    if (y._used < _karatsubaThreshold) {
+      return x * y;
+    }
+    final half = (x._used + 1) >> 1;
+    final x0 = x._lowDigits(half);
+    final x1 = x._drShift(half);
+    if (y._used <= half) {
+      // Unbalanced operands: multiply y by each half of x.
+      return _karatsubaMul(x0, y) + _karatsubaMul(x1, y)._dlShift(half);
+    }
+    final y0 = y._lowDigits(half);
+    final y1 = y._drShift(half);
+    final z0 = _karatsubaMul(x0, y0);
+    final z2 = _karatsubaMul(x1, y1);
+    final z1 = _karatsubaMul(x0 + x1, y0 + y1) - z0 - z2;
+    return z0 + z1._dlShift(half) + z2._dlShift(2 * half);
+  }
+
+  /// Returns `abs(this) % (1 << n*_digitBits)`.
+  _BigIntImpl _lowDigits(int n) {
+    final used = _min(n, _used);
+    return new _BigIntImpl._(false, used, _cloneDigits(_digits, 0, used, used));
+  }
+
   // resultDigits[0..resultUsed-1] =
   //     xDigits[0..xUsed-1]*otherDigits[0..otherUsed-1].
   // Returns resultUsed = xUsed + otherUsed.
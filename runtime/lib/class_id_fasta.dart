@@ -13,4 +13,7 @@ class ClassID {
   static final int cidImmutableArray = 0;
   static final int cidOneByteString = 0;
   static final int cidTwoByteString = 0;
+  static final int cidUint8Array = 0;
+  static final int cidExternalUint8Array = 0;
+  static final int cidUint8ArrayView = 0;
 }
@@ -871,6 +871,7 @@ class LinkedHashMap<K, V> {
     if (isValidKey == null) {
       if (hashCode == null) {
         if (equals == null) {
+          if (K == int) return new _CompactLinkedIntegerHashMap<K, V>();
           return new _InternalLinkedHashMap<K, V>();
         }
         hashCode = _defaultHashCode;
@@ -908,6 +909,7 @@ class LinkedHashSet<E> {
     if (isValidKey == null) {
       if (hashCode == null) {
         if (equals == null) {
+          if (E == int) return new _CompactLinkedIntegerHashSet<E>();
           return new _CompactLinkedHashSet<E>();
         }
         hashCode = _defaultHashCode;
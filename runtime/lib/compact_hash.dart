@@ -103,6 +103,26 @@ abstract class _HashBase implements _HashVMBase {
 
   static int _nextProbe(int i, int sizeMask) => (i + 1) & sizeMask;
 
+  // Recovers the masked hash of each of the first [entries] entries from the
+  // hash patterns in [index]. Entries whose masked hash is 0 or 1 share a
+  // pattern and are left as 0.
+  static Uint32List _hashesFromIndex(Uint32List index, int entries) {
+    final int size = index.length;
+    final int entryBits = (size >> 1).bitLength - 1;
+    final int entryMask = (size >> 1) - 1;
+    final Uint32List hashes = new Uint32List(entries);
+    for (int i = 0; i < size; i++) {
+      final int pair = index[i];
+      if (pair > _DELETED_PAIR) {
+        final int maskedHash = pair >> entryBits;
+        if (maskedHash > 1) {
+          hashes[pair & entryMask] = maskedHash;
+        }
+      }
+    }
+    return hashes;
+  }
+
   // A self-loop is used to mark a deleted key or value.
   static bool _isDeleted(List data, Object keyOrValue) =>
       identical(keyOrValue, data);
@@ -129,6 +149,14 @@ class _IdenticalAndIdentityHashCode {
   bool _equals(e1, e2) => identical(e1, e2);
 }
 
+// Equality for collections whose stored keys are all ints. Ints with the
+// same value are identical, so only a non-int lookup key (e.g., 1.0 or an
+// object with a custom operator==) needs a dynamic call to operator==.
+class _IntegerEqualsAndHashCode {
+  int _hashCode(e) => e.hashCode;
+  bool _equals(e1, e2) => identical(e1, e2) || (e1 is! int && e1 == e2);
+}
+
 // VM-internalized implementation of a default-constructed LinkedHashMap.
 class _InternalLinkedHashMap<K, V> extends _HashVMBase
     with
@@ -177,22 +205,50 @@ abstract class _LinkedHashMapMixin<K, V> implements _HashBase {
   void _init(int size, int hashMask, List oldData, int oldUsed) {
     assert(size & (size - 1) == 0);
     assert(_HashBase._UNUSED_PAIR == 0);
+    final Uint32List oldIndex = _index;
+    final int oldHashMask = _hashMask;
     _index = new Uint32List(size);
     _hashMask = hashMask;
     _data = new List(size);
     _usedData = 0;
     _deletedKeys = 0;
     if (oldData != null) {
+      // While the old hash patterns still cover all hash bits used by the
+      // new index, reinsert keys without calling hashCode.
+      Uint32List hashes;
+      if (oldHashMask != 0 &&
+          ((size - 1) & ~oldHashMask) == 0 &&
+          (hashMask & ~oldHashMask) == 0) {
+        hashes = _HashBase._hashesFromIndex(oldIndex, oldUsed >> 1);
+      }
       for (int i = 0; i < oldUsed; i += 2) {
         var key = oldData[i];
         if (!_HashBase._isDeleted(oldData, key)) {
-          // TODO(koda): While there are enough hash bits, avoid hashCode calls.
-          this[key] = oldData[i + 1];
+          int fullHash = (hashes != null) ? hashes[i >> 1] : 0;
+          if (fullHash == 0) fullHash = _hashCode(key);
+          _insertUnique(key, oldData[i + 1], fullHash);
         }
       }
     }
   }
 
+  // Inserts a key that is known to be absent into a freshly allocated index,
+  // which has no deleted entries, so no keys need to be compared.
+  void _insertUnique(K key, V value, int fullHash) {
+    final int size = _index.length;
+    final int sizeMask = size - 1;
+    final int hashPattern = _HashBase._hashPattern(fullHash, _hashMask, size);
+    int i = _HashBase._firstProbe(fullHash, sizeMask);
+    while (_index[i] != _HashBase._UNUSED_PAIR) {
+      i = _HashBase._nextProbe(i, sizeMask);
+    }
+    final int index = _usedData >> 1;
+    assert((index & hashPattern) == 0);
+    _index[i] = hashPattern | index;
+    _data[_usedData++] = key;
+    _data[_usedData++] = value;
+  }
+
   // This method is called by [_rehashObjects] (see above).
   void _regenerateIndex() {
     _index = new Uint32List(_data.length);
@@ -380,6 +436,17 @@ class _CompactLinkedIdentityHashMap<K, V> extends _HashFieldBase
   _CompactLinkedIdentityHashMap() : super(_HashBase._INITIAL_INDEX_SIZE);
 }
 
+// Default-constructed LinkedHashMap<int, V>.
+class _CompactLinkedIntegerHashMap<K, V> extends _HashFieldBase
+    with
+        MapMixin<K, V>,
+        _LinkedHashMapMixin<K, V>,
+        _HashBase,
+        _IntegerEqualsAndHashCode
+    implements LinkedHashMap<K, V> {
+  _CompactLinkedIntegerHashMap() : super(_HashBase._INITIAL_INDEX_SIZE);
+}
+
 class _CompactLinkedCustomHashMap<K, V> extends _HashFieldBase
     with MapMixin<K, V>, _LinkedHashMapMixin<K, V>, _HashBase
     implements LinkedHashMap<K, V> {
@@ -620,6 +687,12 @@ class _CompactLinkedIdentityHashSet<E> extends _CompactLinkedHashSet<E>
   Set<R> cast<R>() => Set.castFrom<E, R>(this, newSet: _newEmpty);
 }
 
+// Default-constructed LinkedHashSet<int>.
+class _CompactLinkedIntegerHashSet<E> extends _CompactLinkedHashSet<E>
+    with _IntegerEqualsAndHashCode {
+  Set<E> toSet() => new _CompactLinkedIntegerHashSet<E>()..addAll(this);
+}
+
 class _CompactLinkedCustomHashSet<E> extends _CompactLinkedHashSet<E> {
   final _equality;
   final _hasher;
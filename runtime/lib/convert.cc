@@ -0,0 +1,82 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/bootstrap_natives.h"
+
+#include "vm/native_entry.h"
+#include "vm/object.h"
+#include "vm/symbols.h"
+
+namespace dart {
+
+// Returns the number of leading ASCII bytes in [data, data + length).
+// Checks four words at a time for the bulk of the input, which compilers
+// lower to vector loads where available.
+static intptr_t ScanOneByteCharacters(const uint8_t* data, intptr_t length) {
+  const uword kHighBits = static_cast<uword>(0x8080808080808080ULL);
+  intptr_t i = 0;
+  while ((i < length) &&
+         !Utils::IsAligned(reinterpret_cast<uword>(data + i), kWordSize)) {
+    if ((data[i] & 0x80) != 0) return i;
+    i++;
+  }
+  const intptr_t kBlockSize = 4 * kWordSize;
+  for (; i + kBlockSize <= length; i += kBlockSize) {
+    const uword* words = reinterpret_cast<const uword*>(data + i);
+    if (((words[0] | words[1] | words[2] | words[3]) & kHighBits) != 0) {
+      break;
+    }
+  }
+  for (; i + kWordSize <= length; i += kWordSize) {
+    if ((*reinterpret_cast<const uword*>(data + i) & kHighBits) != 0) {
+      break;
+    }
+  }
+  for (; i < length; i++) {
+    if ((data[i] & 0x80) != 0) return i;
+  }
+  return length;
+}
+
+// Decodes the leading ASCII bytes of bytes[start:end] into a one-byte string
+// with a single copy. The range has been checked by the caller. Typed data
+// views are not scanned and yield the empty string, leaving all of the input
+// to the Dart decoder.
+DEFINE_NATIVE_ENTRY(Utf8Decoder_decodeOneBytePrefix, 3) {
+  const Instance& bytes =
+      Instance::CheckedHandle(zone, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_obj, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, end_obj, arguments->NativeArgAt(2));
+  const intptr_t start = start_obj.Value();
+  const intptr_t end = end_obj.Value();
+  ASSERT((0 <= start) && (start <= end));
+
+  if (bytes.IsTypedData()) {
+    const TypedData& array = TypedData::Cast(bytes);
+    ASSERT(array.ElementSizeInBytes() == 1);
+    ASSERT(end <= array.LengthInBytes());
+    intptr_t length;
+    {
+      NoSafepointScope no_safepoint;
+      length = ScanOneByteCharacters(
+          reinterpret_cast<const uint8_t*>(array.DataAddr(start)),
+          end - start);
+    }
+    if (length > 0) {
+      return OneByteString::New(array, start, length, Heap::kNew);
+    }
+  } else if (bytes.IsExternalTypedData()) {
+    const ExternalTypedData& array = ExternalTypedData::Cast(bytes);
+    ASSERT(array.ElementSizeInBytes() == 1);
+    ASSERT(end <= array.LengthInBytes());
+    const intptr_t length = ScanOneByteCharacters(
+        reinterpret_cast<const uint8_t*>(array.DataAddr(start)), end - start);
+    if (length > 0) {
+      return OneByteString::New(array, start, length, Heap::kNew);
+    }
+  }
+  return Symbols::Empty().raw();
+}
+
+}  // namespace dart
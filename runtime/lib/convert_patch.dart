@@ -48,8 +48,26 @@ class Utf8Decoder {
   @patch
   static String _convertIntercepted(
       bool allowMalformed, List<int> codeUnits, int start, int end) {
-    return null; // This call was not intercepted.
+    if (codeUnits is! Uint8List) {
+      return null; // This call was not intercepted.
+    }
+    end = RangeError.checkValidRange(start, end, codeUnits.length);
+    // ASCII decodes to itself, so leading ASCII bytes are copied in bulk and
+    // the Dart decoder only starts at the first multi-byte sequence.
+    String prefix = _decodeOneBytePrefix(codeUnits, start, end);
+    int position = start + prefix.length;
+    if (position == end) return prefix;
+    StringBuffer buffer = new StringBuffer(prefix);
+    _Utf8Decoder decoder = new _Utf8Decoder(buffer, allowMalformed);
+    // A BOM following the prefix is not at the start of the input.
+    decoder._isFirstCharacter = prefix.isEmpty;
+    decoder.convert(codeUnits, position, end);
+    decoder.flush(codeUnits, end);
+    return buffer.toString();
   }
+
+  static String _decodeOneBytePrefix(Uint8List codeUnits, int start, int end)
+      native "Utf8Decoder_decodeOneBytePrefix";
 }
 
 class _JsonUtf8Decoder extends Converter<List<int>, Object> {
@@ -405,6 +423,10 @@ abstract class _ChunkedJsonParser<T> {
   // Mask used to mask off two lower bits.
   static const int TWO_BIT_MASK = 3;
 
+  // Property name cache size (a power of two) and longest cached name.
+  static const int KEY_CACHE_SIZE = 64;
+  static const int KEY_CACHE_MAX_LENGTH = 32;
+
   final _JsonListener listener;
 
   // The current parsing state.
@@ -457,6 +479,15 @@ abstract class _ChunkedJsonParser<T> {
    */
   var buffer = null;
 
+  /**
+   * Recently seen ASCII property names, indexed by [keyCacheIndex].
+   *
+   * Objects in the same JSON text usually repeat the same property names.
+   * Reusing the string saves allocating it, and its hash code is already
+   * computed when it is used as a map key again.
+   */
+  final List<String> keyCache = new List<String>(KEY_CACHE_SIZE);
+
   _ChunkedJsonParser(this.listener);
 
   /**
@@ -598,6 +629,33 @@ abstract class _ChunkedJsonParser<T> {
    */
   String getString(int start, int end, int bits);
 
+  /**
+   * Like [getString], but for a property name, which is likely to be repeated.
+   *
+   * Returns the cached string if its characters match the slice, otherwise
+   * creates the string and caches it.
+   */
+  String getKeyString(int start, int end, int bits) {
+    const int maxAsciiChar = 0x7f;
+    int length = end - start;
+    if (bits > maxAsciiChar ||
+        length == 0 ||
+        length > KEY_CACHE_MAX_LENGTH) {
+      return getString(start, end, bits);
+    }
+    int index = keyCacheIndex(length, getChar(start), getChar(end - 1));
+    String cached = keyCache[index];
+    if (cached != null && cached.length == length) {
+      int i = 0;
+      while (i < length && cached.codeUnitAt(i) == getChar(start + i)) i++;
+      if (i == length) return cached;
+    }
+    return keyCache[index] = getString(start, end, bits);
+  }
+
+  static int keyCacheIndex(int length, int first, int last) =>
+      (length * 31 + first * 7 + last) & (KEY_CACHE_SIZE - 1);
+
   /**
    * Parse a slice of the current chunk as an integer.
    *
@@ -856,8 +914,10 @@ abstract class _ChunkedJsonParser<T> {
           break;
         case QUOTE:
           if ((state & ALLOW_STRING_MASK) != 0) return fail(position);
+          // Only property names are allowed where other values are not.
+          bool isKey = (state & ALLOW_VALUE_MASK) != 0;
           state |= VALUE_READ_BITS;
-          position = parseString(position + 1);
+          position = parseString(position + 1, isKey);
           break;
         case LBRACKET:
           if ((state & ALLOW_VALUE_MASK) != 0) return fail(position);
@@ -1019,8 +1079,10 @@ abstract class _ChunkedJsonParser<T> {
    *
    * Initial [position] is right after the initial quote.
    * Returned position right after the final quote.
+   * If [isKey] the string is a property name and may be shared with
+   * earlier occurrences of the same name.
    */
-  int parseString(int position) {
+  int parseString(int position, bool isKey) {
     // Format: '"'([^\x00-\x1f\\\"]|'\\'[bfnrt/\\"])*'"'
     // Initial position is right after first '"'.
     int start = position;
@@ -1040,7 +1102,9 @@ abstract class _ChunkedJsonParser<T> {
         return parseStringToBuffer(sliceEnd);
       }
       if (char == QUOTE) {
-        listener.handleString(getString(start, position - 1, bits));
+        listener.handleString(isKey
+            ? getKeyString(start, position - 1, bits)
+            : getString(start, position - 1, bits));
         return position;
       }
       if (char < SPACE) {
@@ -1783,6 +1847,12 @@ class _JsonUtf8Parser extends _ChunkedJsonParser<List<int>> {
   }
 
   double parseDouble(int start, int end) {
+    List<int> chunk = this.chunk;
+    if (chunk is Uint8List) {
+      // Typed data views are not handled by the native parser.
+      double result = _parseDoubleBytes(chunk, start, end);
+      if (result != null) return result;
+    }
     String string = getString(start, end, 0x7f);
     return _parseDouble(string, 0, string.length);
   }
@@ -1790,6 +1860,9 @@ class _JsonUtf8Parser extends _ChunkedJsonParser<List<int>> {
 
 double _parseDouble(String source, int start, int end) native "Double_parse";
 
+double _parseDoubleBytes(Uint8List source, int start, int end)
+    native "Double_parse";
+
 /**
  * Implements the chunked conversion from a UTF-8 encoding of JSON
  * to its corresponding object.
@@ -140,7 +140,7 @@ DEFINE_NATIVE_ENTRY(Developer_getServerInfo, 1) {
   SendNull(port);
   return Object::null();
 #else
-  if (!ServiceIsolate::IsRunning()) {
+  if (!ServiceIsolate::EnsureRunning()) {
     SendNull(port);
   } else {
     ServiceIsolate::RequestServerInfo(port);
@@ -156,7 +156,7 @@ DEFINE_NATIVE_ENTRY(Developer_webServerControl, 2) {
   return Object::null();
 #else
   GET_NON_NULL_NATIVE_ARGUMENT(Bool, enabled, arguments->NativeArgAt(1));
-  if (!ServiceIsolate::IsRunning()) {
+  if (!ServiceIsolate::EnsureRunning()) {
     SendNull(port);
   } else {
     ServiceIsolate::ControlWebServer(port, enabled.value());
@@ -191,19 +191,44 @@ DEFINE_NATIVE_ENTRY(Double_toInt, 1) {
   return DoubleToInteger(arg.value(), "Infinity or NaN toInt");
 }
 
+// The source is either a String or, for the JSON UTF-8 parser, a byte
+// array, which is parsed in place instead of through a substring.
 DEFINE_NATIVE_ENTRY(Double_parse, 3) {
-  GET_NON_NULL_NATIVE_ARGUMENT(String, value, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Instance, value, arguments->NativeArgAt(0));
   GET_NON_NULL_NATIVE_ARGUMENT(Integer, startValue, arguments->NativeArgAt(1));
   GET_NON_NULL_NATIVE_ARGUMENT(Integer, endValue, arguments->NativeArgAt(2));
 
   const intptr_t start = startValue.AsTruncatedUint32Value();
   const intptr_t end = endValue.AsTruncatedUint32Value();
-  const intptr_t len = value.Length();
-
-  // Indices should be inside the string, and 0 <= start < end <= len.
-  if (0 <= start && start < end && end <= len) {
-    double double_value;
-    if (String::ParseDouble(value, start, end, &double_value)) {
+  double double_value;
+  if (value.IsString()) {
+    const String& string = String::Cast(value);
+    // Indices should be inside the string, and 0 <= start < end <= len.
+    if (0 <= start && start < end && end <= string.Length() &&
+        String::ParseDouble(string, start, end, &double_value)) {
+      return Double::New(double_value);
+    }
+  } else if (value.IsTypedData()) {
+    const TypedData& bytes = TypedData::Cast(value);
+    if (bytes.ElementSizeInBytes() == 1 && 0 <= start && start < end &&
+        end <= bytes.LengthInBytes()) {
+      bool ok;
+      {
+        NoSafepointScope no_safepoint;
+        ok = CStringToDouble(
+            reinterpret_cast<const char*>(bytes.DataAddr(start)), end - start,
+            &double_value);
+      }
+      if (ok) {
+        return Double::New(double_value);
+      }
+    }
+  } else if (value.IsExternalTypedData()) {
+    const ExternalTypedData& bytes = ExternalTypedData::Cast(value);
+    if (bytes.ElementSizeInBytes() == 1 && 0 <= start && start < end &&
+        end <= bytes.LengthInBytes() &&
+        CStringToDouble(reinterpret_cast<const char*>(bytes.DataAddr(start)),
+                        end - start, &double_value)) {
       return Double::New(double_value);
     }
   }
@@ -19,7 +19,7 @@ class _GrowableList<T> extends ListBase<T> {
     // (with a length that has been increased, but without a new element).
     if (index is! int) throw new ArgumentError(index);
     this.length++;
-    Lists.copy(this, index, this, index + 1, oldLength - index);
+    _copyFrom(index + 1, this, index, oldLength - index);
     this[index] = element;
   }
 
@@ -27,7 +27,7 @@ class _GrowableList<T> extends ListBase<T> {
     var result = this[index];
     int newLength = this.length - 1;
     if (index < newLength) {
-      Lists.copy(this, index + 1, this, index, newLength - index);
+      _copyFrom(index, this, index + 1, newLength - index);
     }
     this.length = newLength;
     return result;
@@ -52,14 +52,34 @@ class _GrowableList<T> extends ListBase<T> {
       iterable = iterable.toList();
     }
     int insertionLength = iterable.length;
+    int oldLength = this.length;
     // There might be errors after the length change, in which case the list
     // will end up being modified but the operation not complete. Unless we
     // always go through a "toList" we can't really avoid that.
     this.length += insertionLength;
-    setRange(index + insertionLength, this.length, this, index);
+    _copyFrom(index + insertionLength, this, index, oldLength - index);
     setAll(index, iterable);
   }
 
+  void setRange(int start, int end, Iterable<T> iterable, [int skipCount = 0]) {
+    final cid = ClassID.getID(iterable);
+    if ((cid == ClassID.cidArray) ||
+        (cid == ClassID.cidGrowableObjectArray) ||
+        (cid == ClassID.cidImmutableArray)) {
+      RangeError.checkValidRange(start, end, this.length);
+      RangeError.checkNotNegative(skipCount, "skipCount");
+      final int length = end - start;
+      if (length == 0) return;
+      final List<T> list = iterable;
+      if (skipCount + length > list.length) {
+        throw IterableElementError.tooFew();
+      }
+      _copyFrom(start, list, skipCount, length);
+      return;
+    }
+    super.setRange(start, end, iterable, skipCount);
+  }
+
   void setAll(int index, Iterable<T> iterable) {
     if (iterable is List) {
       setRange(index, index + iterable.length, iterable);
@@ -72,7 +92,7 @@ class _GrowableList<T> extends ListBase<T> {
 
   void removeRange(int start, int end) {
     RangeError.checkValidRange(start, end, this.length);
-    Lists.copy(this, end, this, start, this.length - end);
+    _copyFrom(start, this, end, this.length - end);
     this.length = this.length - (end - start);
   }
 
@@ -80,10 +100,8 @@ class _GrowableList<T> extends ListBase<T> {
     end = RangeError.checkValidRange(start, end, this.length);
     int length = end - start;
     if (length == 0) return <T>[];
-    List list = new _List(length);
-    for (int i = 0; i < length; i++) {
-      list[i] = this[start + i];
-    }
+    _List list = new _List(length);
+    list._copyFrom(0, this, start, length);
     var result = new _GrowableList<T>.withData(list);
     result._setLength(length);
     return result;
@@ -146,6 +164,12 @@ class _GrowableList<T> extends ListBase<T> {
 
   void _setIndexed(int index, T value) native "GrowableList_setIndexed";
 
+  // Copies [count] elements of the VM list [src] starting at [srcStart] to
+  // this list starting at [start], with a single memmove of the backing
+  // arrays where the write barrier allows. The ranges may overlap.
+  void _copyFrom(int start, List src, int srcStart, int count)
+      native "List_copyFrom";
+
   void add(T value) {
     var len = length;
     if (len == _capacity) {
@@ -177,10 +201,7 @@ class _GrowableList<T> extends ListBase<T> {
           throw new ConcurrentModificationError(this);
         }
         this._setLength(newLen);
-        final ListBase<T> iterableAsList = iterable;
-        for (int i = 0; i < iterLen; i++) {
-          this[len++] = iterableAsList[i];
-        }
+        _copyFrom(len, iterable, 0, iterLen);
         return;
       }
     }
@@ -240,28 +261,17 @@ class _GrowableList<T> extends ListBase<T> {
   int _nextCapacity(int old_capacity) => (old_capacity * 2) | 3;
 
   void _grow(int new_capacity) {
-    var newData = _allocateData(new_capacity);
-    // This is a work-around for dartbug.com/30090: array-bound-check
-    // generalization causes excessive deoptimizations because it
-    // hoists CheckArrayBound(i, ...) out of the loop below and turns it
-    // into CheckArrayBound(length - 1, ...). Which deoptimizes
-    // if length == 0. However the loop itself does not execute
-    // if length == 0.
+    _List newData = _allocateData(new_capacity);
     if (length > 0) {
-      for (int i = 0; i < length; i++) {
-        newData[i] = this[i];
-      }
+      newData._copyFrom(0, this, 0, length);
     }
     _setData(newData);
   }
 
   void _shrink(int new_capacity, int new_length) {
-    var newData = _allocateData(new_capacity);
-    // This is a work-around for dartbug.com/30090. See the comment in _grow.
+    _List newData = _allocateData(new_capacity);
     if (new_length > 0) {
-      for (int i = 0; i < new_length; i++) {
-        newData[i] = this[i];
-      }
+      newData._copyFrom(0, this, 0, new_length);
     }
     _setData(newData);
   }
@@ -102,9 +102,5 @@ _prependTypeArguments(functionTypeArguments, parentTypeArguments, parentLen,
 
 // Called by IRRegExpMacroAssembler::GrowStack.
 Int32List _growRegExpStack(Int32List stack) {
-  final newStack = new Int32List(stack.length * 2);
-  for (int i = 0; i < stack.length; i++) {
-    newStack[i] = stack[i];
-  }
-  return newStack;
+  return new Int32List(stack.length * 2)..setRange(0, stack.length, stack);
 }
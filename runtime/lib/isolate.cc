@@ -46,6 +46,102 @@ DEFINE_NATIVE_ENTRY(CapabilityImpl_get_hashcode, 1) {
   return Smi::New(hash);
 }
 
+// Finds the bytes backing a TypedData, ExternalTypedData or typed data view.
+// Returns false if [obj] is none of these.
+static bool GetTypedDataBytes(const Instance& obj,
+                              Instance* data,
+                              intptr_t* offset_in_bytes,
+                              intptr_t* length_in_bytes) {
+  const intptr_t cid = obj.GetClassId();
+  if (RawObject::IsTypedDataClassId(cid)) {
+    *data = obj.raw();
+    *offset_in_bytes = 0;
+    *length_in_bytes = TypedData::Cast(obj).LengthInBytes();
+    return true;
+  }
+  if (RawObject::IsExternalTypedDataClassId(cid)) {
+    *data = obj.raw();
+    *offset_in_bytes = 0;
+    *length_in_bytes = ExternalTypedData::Cast(obj).LengthInBytes();
+    return true;
+  }
+  if (RawObject::IsTypedDataViewClassId(cid)) {
+    *data = TypedDataView::Data(obj);
+    *offset_in_bytes = Smi::Value(TypedDataView::OffsetInBytes(obj));
+    *length_in_bytes = Smi::Value(TypedDataView::Length(obj)) *
+                       TypedDataView::ElementSizeInBytes(obj);
+    return true;
+  }
+  return false;
+}
+
+static uint8_t* TypedDataBytes(const Instance& data, intptr_t offset) {
+  if (data.IsTypedData()) {
+    return reinterpret_cast<uint8_t*>(TypedData::Cast(data).DataAddr(offset));
+  }
+  return reinterpret_cast<uint8_t*>(
+      ExternalTypedData::Cast(data).DataAddr(offset));
+}
+
+DEFINE_NATIVE_ENTRY(TransferableTypedData_factory, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Array, list, arguments->NativeArgAt(0));
+
+  Instance& element = Instance::Handle(zone);
+  Instance& data = Instance::Handle(zone);
+  intptr_t offset = 0;
+  intptr_t length = 0;
+  int64_t total_length = 0;
+  for (intptr_t i = 0; i < list.Length(); i++) {
+    element ^= list.At(i);
+    if (!GetTypedDataBytes(element, &data, &offset, &length)) {
+      Exceptions::ThrowArgumentError(element);
+    }
+    total_length += length;
+    if (total_length > kMaxInt32) {
+      Exceptions::ThrowArgumentError(element);
+    }
+  }
+
+  uint8_t* buffer =
+      reinterpret_cast<uint8_t*>(malloc(total_length > 0 ? total_length : 1));
+  if (buffer == NULL) {
+    Exceptions::ThrowOOM();
+  }
+  intptr_t position = 0;
+  for (intptr_t i = 0; i < list.Length(); i++) {
+    element ^= list.At(i);
+    GetTypedDataBytes(element, &data, &offset, &length);
+    NoSafepointScope no_safepoint;
+    memmove(buffer + position, TypedDataBytes(data, offset), length);
+    position += length;
+  }
+  return TransferableTypedData::New(buffer, total_length);
+}
+
+// This function's name can appear in Observatory.
+static void MaterializedTypedDataFinalizer(void* isolate_callback_data,
+                                           Dart_WeakPersistentHandle handle,
+                                           void* buffer) {
+  free(buffer);
+}
+
+DEFINE_NATIVE_ENTRY(TransferableTypedData_materialize, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(TransferableTypedData, transferable,
+                               arguments->NativeArgAt(0));
+  if (transferable.IsDetached()) {
+    Exceptions::ThrowArgumentError(String::Handle(
+        zone, String::New("Attempt to materialize object that was "
+                          "transferred already.")));
+  }
+  intptr_t length = 0;
+  uint8_t* data = transferable.Detach(&length);
+  const ExternalTypedData& result = ExternalTypedData::Handle(
+      zone,
+      ExternalTypedData::New(kExternalTypedDataUint8ArrayCid, data, length));
+  result.AddFinalizer(data, MaterializedTypedDataFinalizer, length);
+  return result.raw();
+}
+
 DEFINE_NATIVE_ENTRY(RawReceivePortImpl_factory, 1) {
   ASSERT(TypeArguments::CheckedHandle(arguments->NativeArgAt(0)).IsNull());
   Dart_Port port_id = PortMap::CreatePort(isolate->message_handler());
@@ -62,6 +158,31 @@ DEFINE_NATIVE_ENTRY(RawReceivePortImpl_get_sendport, 1) {
   return port.send_port();
 }
 
+// Returns [port id, message] for the next queued message that may be
+// delivered in the current batch, or null if the batch has to end.
+DEFINE_NATIVE_ENTRY(RawReceivePortImpl_dequeueBatchedMessage, 0) {
+  Message* message = isolate->message_handler()->DequeueBatchableMessage();
+  if (message == NULL) {
+    return Object::null();
+  }
+  Object& msg_obj = Object::Handle(zone);
+  if (message->IsRaw()) {
+    msg_obj = message->raw_obj();
+  } else {
+    MessageSnapshotReader reader(message, thread);
+    msg_obj = reader.ReadObject();
+  }
+  const Dart_Port port_id = message->dest_port();
+  delete message;
+  if (msg_obj.IsError()) {
+    Exceptions::PropagateError(Error::Cast(msg_obj));
+  }
+  const Array& result = Array::Handle(zone, Array::New(2));
+  result.SetAt(0, Integer::Handle(zone, Integer::New(port_id)));
+  result.SetAt(1, msg_obj);
+  return result.raw();
+}
+
 DEFINE_NATIVE_ENTRY(RawReceivePortImpl_closeInternal, 1) {
   GET_NON_NULL_NATIVE_ARGUMENT(ReceivePort, port, arguments->NativeArgAt(0));
   Dart_Port id = port.Id();
@@ -14,6 +14,8 @@ import "dart:async"
 
 import "dart:collection" show HashMap;
 
+import "dart:typed_data" show ByteBuffer, TypedData, Uint8List;
+
 /// These are the additional parts of this patch library:
 // part "timer_impl.dart";
 
@@ -49,6 +51,29 @@ class _CapabilityImpl implements Capability {
   _get_hashcode() native "CapabilityImpl_get_hashcode";
 }
 
+@patch
+class TransferableTypedData {
+  @patch
+  factory TransferableTypedData.fromList(List<TypedData> list) =>
+      new _TransferableTypedDataImpl(list);
+}
+
+class _TransferableTypedDataImpl implements TransferableTypedData {
+  factory _TransferableTypedDataImpl(List<TypedData> list) {
+    return _create(new List<TypedData>.from(list, growable: false));
+  }
+
+  static _TransferableTypedDataImpl _create(List<TypedData> list)
+      native "TransferableTypedData_factory";
+
+  ByteBuffer materialize() {
+    return _materializeIntoUint8List().buffer;
+  }
+
+  Uint8List _materializeIntoUint8List()
+      native "TransferableTypedData_materialize";
+}
+
 @patch
 class RawReceivePort {
   /**
@@ -166,6 +191,30 @@ class _RawReceivePortImpl implements RawReceivePort {
     _runPendingImmediateCallback();
   }
 
+  // Called from the VM to dispatch the message for port [id] and then up to
+  // [maxCount] - 1 further queued messages in the same entry. The next
+  // message is only taken off the queue once the previous one and its
+  // microtasks are done, so the batch ends as soon as the isolate is paused
+  // or has OOB messages to handle. Messages for ports that have been closed
+  // in the meantime are dropped.
+  static void _handleMessages(int id, var message, int maxCount) {
+    for (int count = 1;; count++) {
+      final handler = _handlerMap[id];
+      if (handler != null) {
+        handler(message);
+        _runPendingImmediateCallback();
+      }
+      if (count >= maxCount) return;
+      final List next = _dequeueBatchedMessage();
+      if (next == null) return;
+      id = next[0];
+      message = next[1];
+    }
+  }
+
+  static List _dequeueBatchedMessage()
+      native "RawReceivePortImpl_dequeueBatchedMessage";
+
   // Call into the VM to close the VM maintained mappings.
   _closeInternal() native "RawReceivePortImpl_closeInternal";
 
@@ -608,6 +608,113 @@ static RawInstance* InvokeDynamicFunction(const Instance& receiver,
   return ReturnResult(result);
 }
 
+// Reflective calls resolve their target by name in the receiver's class and
+// its superclasses on every call. The targets found are cached in an open
+// addressing table of (class id, selector, target) entries after a count of
+// the used entries. The table is dropped on reload.
+enum {
+  kLookupCacheClassIdIndex,
+  kLookupCacheSelectorIndex,
+  kLookupCacheTargetIndex,
+  kLookupCacheEntryLength,
+};
+static const intptr_t kLookupCacheInitialCapacity = 64;
+
+static intptr_t LookupCacheCapacity(const Array& table) {
+  return (table.Length() - 1) / kLookupCacheEntryLength;
+}
+
+static intptr_t LookupCacheProbe(const Array& table,
+                                 intptr_t cid,
+                                 const String& selector) {
+  const intptr_t mask = LookupCacheCapacity(table) - 1;
+  const uintptr_t hash = static_cast<uintptr_t>(selector.Hash()) + cid * 7;
+  String& key = String::Handle();
+  intptr_t i = hash & mask;
+  while (true) {
+    const intptr_t base = 1 + i * kLookupCacheEntryLength;
+    if (table.At(base + kLookupCacheSelectorIndex) == Object::null()) {
+      return i;
+    }
+    key ^= table.At(base + kLookupCacheSelectorIndex);
+    if ((Smi::Value(Smi::RawCast(table.At(base + kLookupCacheClassIdIndex))) ==
+         cid) &&
+        key.Equals(selector)) {
+      return i;
+    }
+    i = (i + 1) & mask;
+  }
+}
+
+static void LookupCacheInsert(const Array& table,
+                              const Smi& cid,
+                              const String& selector,
+                              const Function& target) {
+  const intptr_t base =
+      1 + LookupCacheProbe(table, cid.Value(), selector) *
+              kLookupCacheEntryLength;
+  ASSERT(table.At(base + kLookupCacheSelectorIndex) == Object::null());
+  table.SetAt(base + kLookupCacheClassIdIndex, cid);
+  table.SetAt(base + kLookupCacheSelectorIndex, selector);
+  table.SetAt(base + kLookupCacheTargetIndex, target);
+}
+
+// Like Resolver::ResolveDynamicAnyArgs, but remembers the functions found.
+static RawFunction* ResolveDynamicCached(Zone* zone,
+                                         const Class& klass,
+                                         const String& selector) {
+  ObjectStore* object_store = Isolate::Current()->object_store();
+  Array& table = Array::Handle(zone, object_store->reflective_lookup_cache());
+  const intptr_t cid = klass.id();
+  if (!table.IsNull()) {
+    const intptr_t base = 1 + LookupCacheProbe(table, cid, selector) *
+                                  kLookupCacheEntryLength;
+    if (table.At(base + kLookupCacheSelectorIndex) != Object::null()) {
+      return Function::RawCast(table.At(base + kLookupCacheTargetIndex));
+    }
+  }
+
+  const Function& function = Function::Handle(
+      zone, Resolver::ResolveDynamicAnyArgs(zone, klass, selector));
+  if (function.IsNull()) {
+    // Misses are not cached; they go on to noSuchMethod or a getter.
+    return function.raw();
+  }
+
+  intptr_t used = 0;
+  if (table.IsNull()) {
+    table = Array::New(
+        1 + kLookupCacheInitialCapacity * kLookupCacheEntryLength, Heap::kOld);
+    object_store->set_reflective_lookup_cache(table);
+  } else {
+    used = Smi::Value(Smi::RawCast(table.At(0)));
+    // Keep the table at most half full.
+    if (2 * (used + 1) > LookupCacheCapacity(table)) {
+      const Array& old_table = Array::Handle(zone, table.raw());
+      const intptr_t capacity = 2 * LookupCacheCapacity(old_table);
+      table = Array::New(1 + capacity * kLookupCacheEntryLength, Heap::kOld);
+      Smi& old_cid = Smi::Handle(zone);
+      String& old_selector = String::Handle(zone);
+      Function& old_target = Function::Handle(zone);
+      for (intptr_t i = 0; i < LookupCacheCapacity(old_table); i++) {
+        const intptr_t base = 1 + i * kLookupCacheEntryLength;
+        if (old_table.At(base + kLookupCacheSelectorIndex) == Object::null()) {
+          continue;
+        }
+        old_cid ^= old_table.At(base + kLookupCacheClassIdIndex);
+        old_selector ^= old_table.At(base + kLookupCacheSelectorIndex);
+        old_target ^= old_table.At(base + kLookupCacheTargetIndex);
+        LookupCacheInsert(table, old_cid, old_selector, old_target);
+      }
+      object_store->set_reflective_lookup_cache(table);
+    }
+  }
+  LookupCacheInsert(table, Smi::Handle(zone, Smi::New(cid)), selector,
+                    function);
+  table.SetAt(0, Smi::Handle(zone, Smi::New(used + 1)));
+  return function.raw();
+}
+
 static RawInstance* InvokeLibraryGetter(const Library& library,
                                         const String& getter_name,
                                         const bool throw_nsm_if_absent) {
@@ -1344,7 +1451,7 @@ DEFINE_NATIVE_ENTRY(InstanceMirror_invoke, 5) {
 
   Class& klass = Class::Handle(reflectee.clazz());
   Function& function = Function::Handle(
-      zone, Resolver::ResolveDynamicAnyArgs(zone, klass, function_name));
+      zone, ResolveDynamicCached(zone, klass, function_name));
 
   // TODO(regis): Support invocation of generic functions with type arguments.
   const int kTypeArgsLen = 0;
@@ -1355,7 +1462,7 @@ DEFINE_NATIVE_ENTRY(InstanceMirror_invoke, 5) {
     // Didn't find a method: try to find a getter and invoke call on its result.
     const String& getter_name =
         String::Handle(zone, Field::GetterName(function_name));
-    function = Resolver::ResolveDynamicAnyArgs(zone, klass, getter_name);
+    function = ResolveDynamicCached(zone, klass, getter_name);
     if (!function.IsNull()) {
       ASSERT(function.kind() != RawFunction::kMethodExtractor);
       // Invoke the getter.
@@ -1396,11 +1503,11 @@ DEFINE_NATIVE_ENTRY(InstanceMirror_invokeGetter, 3) {
   const String& internal_getter_name =
       String::Handle(Field::GetterName(getter_name));
   Function& function = Function::Handle(
-      zone, Resolver::ResolveDynamicAnyArgs(zone, klass, internal_getter_name));
+      zone, ResolveDynamicCached(zone, klass, internal_getter_name));
 
   // Check for method extraction when method extractors are not created.
   if (function.IsNull() && !FLAG_lazy_dispatchers) {
-    function = Resolver::ResolveDynamicAnyArgs(zone, klass, getter_name);
+    function = ResolveDynamicCached(zone, klass, getter_name);
     if (!function.IsNull()) {
       const Function& closure_function =
           Function::Handle(zone, function.ImplicitClosureFunction());
@@ -1432,7 +1539,7 @@ DEFINE_NATIVE_ENTRY(InstanceMirror_invokeSetter, 4) {
   const String& internal_setter_name =
       String::Handle(zone, Field::SetterName(setter_name));
   const Function& setter = Function::Handle(
-      zone, Resolver::ResolveDynamicAnyArgs(zone, klass, internal_setter_name));
+      zone, ResolveDynamicCached(zone, klass, internal_setter_name));
 
   const int kTypeArgsLen = 0;
   const int kNumArgs = 2;
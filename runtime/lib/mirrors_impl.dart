@@ -212,6 +212,13 @@ abstract class _LocalObjectMirror extends _LocalMirror implements ObjectMirror {
 
   InstanceMirror invoke(Symbol memberName, List positionalArguments,
       [Map<Symbol, dynamic> namedArguments]) {
+    return reflect(
+        _invokeReflectee(memberName, positionalArguments, namedArguments));
+  }
+
+  // Returns the result of the invocation without wrapping it in a mirror.
+  _invokeReflectee(Symbol memberName, List positionalArguments,
+      Map<Symbol, dynamic> namedArguments) {
     int numPositionalArguments = positionalArguments.length;
     int numNamedArguments = namedArguments != null ? namedArguments.length : 0;
     int numArguments = numPositionalArguments + numNamedArguments;
@@ -227,7 +234,7 @@ abstract class _LocalObjectMirror extends _LocalMirror implements ObjectMirror {
       });
     }
 
-    return reflect(this._invoke(_reflectee, _n(memberName), arguments, names));
+    return this._invoke(_reflectee, _n(memberName), arguments, names);
   }
 
   InstanceMirror getField(Symbol memberName) {
@@ -239,21 +246,21 @@ abstract class _LocalObjectMirror extends _LocalMirror implements ObjectMirror {
     return reflect(value);
   }
 
+  // Calls the natives directly, as wrapping results in mirrors only to
+  // unwrap them again would allocate a mirror per call.
   delegate(Invocation invocation) {
     if (invocation.isMethod) {
-      return this
-          .invoke(invocation.memberName, invocation.positionalArguments,
-              invocation.namedArguments)
-          .reflectee;
+      return _invokeReflectee(invocation.memberName,
+          invocation.positionalArguments, invocation.namedArguments);
     }
     if (invocation.isGetter) {
-      return this.getField(invocation.memberName).reflectee;
+      return this._invokeGetter(_reflectee, _n(invocation.memberName));
     }
     if (invocation.isSetter) {
       var unwrapped = _n(invocation.memberName);
-      var withoutEqual = _s(unwrapped.substring(0, unwrapped.length - 1));
+      var withoutEqual = unwrapped.substring(0, unwrapped.length - 1);
       var arg = invocation.positionalArguments[0];
-      this.setField(withoutEqual, arg).reflectee;
+      this._invokeSetter(_reflectee, withoutEqual, arg);
       return arg;
     }
     throw "UNREACHABLE";
@@ -302,8 +309,8 @@ class _LocalInstanceMirror extends _LocalObjectMirror
   }
 
   // Override to include the receiver in the arguments.
-  InstanceMirror invoke(Symbol memberName, List positionalArguments,
-      [Map<Symbol, dynamic> namedArguments]) {
+  _invokeReflectee(Symbol memberName, List positionalArguments,
+      Map<Symbol, dynamic> namedArguments) {
     int numPositionalArguments = positionalArguments.length + 1; // Receiver.
     int numNamedArguments = namedArguments != null ? namedArguments.length : 0;
     int numArguments = numPositionalArguments + numNamedArguments;
@@ -320,7 +327,7 @@ class _LocalInstanceMirror extends _LocalObjectMirror
       });
     }
 
-    return reflect(this._invoke(_reflectee, _n(memberName), arguments, names));
+    return this._invoke(_reflectee, _n(memberName), arguments, names);
   }
 
   _invoke(reflectee, functionName, arguments, argumentNames)
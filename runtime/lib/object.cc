@@ -39,9 +39,14 @@ DEFINE_NATIVE_ENTRY(Object_getHash, 1) {
 #if defined(HASH_IN_OBJECT_HEADER)
   return Smi::New(Object::GetCachedHash(arguments->NativeArgAt(0)));
 #else
+  RawObject* obj = arguments->NativeArgAt(0);
+  ASSERT(obj->IsDartInstance());
+  RawObject** slot = Object::IdentityHashSlot(obj);
+  if ((slot != NULL) && (*slot)->IsSmi()) {
+    return *slot;
+  }
   Heap* heap = isolate->heap();
-  ASSERT(arguments->NativeArgAt(0)->IsDartInstance());
-  return Smi::New(heap->GetHash(arguments->NativeArgAt(0)));
+  return Smi::New(heap->GetHash(obj));
 #endif
 }
 
@@ -51,6 +56,12 @@ DEFINE_NATIVE_ENTRY(Object_setHash, 2) {
   Object::SetCachedHash(arguments->NativeArgAt(0), hash.Value());
 #else
   const Instance& instance = Instance::CheckedHandle(arguments->NativeArgAt(0));
+  RawObject** slot = Object::IdentityHashSlot(instance.raw());
+  if (slot != NULL) {
+    // A Smi needs no write barrier.
+    *slot = hash.raw();
+    return Object::null();
+  }
   Heap* heap = isolate->heap();
   heap->SetHash(instance.raw(), hash.Value());
 #endif
@@ -102,6 +102,49 @@ RawStackTrace* GetStackTraceForException() {
   return CurrentStackTrace(thread, false, 0);
 }
 
+RawStackTrace* GetPartialStackTraceForException(int frame_count) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  const Array& code_array = Array::Handle(zone, Array::New(frame_count));
+  const Array& pc_offset_array = Array::Handle(zone, Array::New(frame_count));
+  const intptr_t collected_frames_count = StackTraceUtils::CollectFrames(
+      thread, code_array, pc_offset_array, 0, frame_count, 0);
+  ASSERT(collected_frames_count == frame_count);
+  const StackTrace& result = StackTrace::Handle(
+      zone, StackTrace::New(code_array, pc_offset_array));
+  result.set_is_partial(true);
+  return result.raw();
+}
+
+RawStackTrace* CompleteStackTraceForException(const StackTrace& partial) {
+  ASSERT(partial.is_partial());
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  // Skip the handler frame, it is the last frame of the partial trace.
+  const StackTrace& outer =
+      StackTrace::Handle(zone, CurrentStackTrace(thread, false, 1));
+  const intptr_t partial_length = partial.Length();
+  const intptr_t length = partial_length + outer.Length();
+  const Array& code_array = Array::Handle(zone, Array::New(length));
+  const Array& pc_offset_array = Array::Handle(zone, Array::New(length));
+  Code& code = Code::Handle(zone);
+  Smi& offset = Smi::Handle(zone);
+  for (intptr_t i = 0; i < length; i++) {
+    if (i < partial_length) {
+      code = partial.CodeAtFrame(i);
+      offset = partial.PcOffsetAtFrame(i);
+    } else {
+      code = outer.CodeAtFrame(i - partial_length);
+      offset = outer.PcOffsetAtFrame(i - partial_length);
+    }
+    code_array.SetAt(i, code);
+    pc_offset_array.SetAt(i, offset);
+  }
+  const StackTrace& async_link =
+      StackTrace::Handle(zone, outer.async_link());
+  return StackTrace::New(code_array, pc_offset_array, async_link);
+}
+
 DEFINE_NATIVE_ENTRY(StackTrace_current, 0) {
   return CurrentStackTrace(thread, false);
 }
@@ -20,6 +20,14 @@ const StackTrace& GetCurrentStackTrace(int skip_frames);
 // Creates a StackTrace object to be attached to an exception.
 RawStackTrace* GetStackTraceForException();
 
+// Creates a partial StackTrace of the top frame_count Dart frames, for an
+// exception whose handler does not use the stack trace.
+RawStackTrace* GetPartialStackTraceForException(int frame_count);
+
+// Completes a partial StackTrace being rethrown from the handler frame it
+// ends with by appending the frames above that handler.
+RawStackTrace* CompleteStackTraceForException(const StackTrace& partial);
+
 }  // namespace dart
 
 #endif  // RUNTIME_LIB_STACKTRACE_H_
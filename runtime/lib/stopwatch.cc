@@ -6,6 +6,7 @@
 
 #include "vm/object.h"
 #include "vm/os.h"
+#include "vm/runtime_entry.h"
 
 namespace dart {
 
@@ -17,4 +18,16 @@ DEFINE_NATIVE_ENTRY(Stopwatch_frequency, 0) {
   return Integer::New(OS::GetCurrentMonotonicFrequency());
 }
 
+// Leaf versions called directly from optimized code, see
+// BOOTSTRAP_LEAF_NATIVE_LIST.
+DEFINE_LEAF_RUNTIME_ENTRY(int64_t, StopwatchNow, 0, void) {
+  return OS::GetCurrentMonotonicTicks();
+}
+END_LEAF_RUNTIME_ENTRY
+
+DEFINE_LEAF_RUNTIME_ENTRY(int64_t, StopwatchFrequency, 0, void) {
+  return OS::GetCurrentMonotonicFrequency();
+}
+END_LEAF_RUNTIME_ENTRY
+
 }  // namespace dart
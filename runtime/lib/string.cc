@@ -265,12 +265,19 @@ DEFINE_NATIVE_ENTRY(OneByteString_splitWithCharCode, 2) {
   GET_NON_NULL_NATIVE_ARGUMENT(Smi, smi_split_code, arguments->NativeArgAt(1));
   const intptr_t len = receiver.Length();
   const intptr_t split_code = smi_split_code.Value();
+  // Count the parts first, so that the result is allocated once.
+  intptr_t count = 1;
+  for (intptr_t i = 0; i < len; i++) {
+    if (split_code == OneByteString::CharAt(receiver, i)) {
+      count++;
+    }
+  }
   const GrowableObjectArray& result = GrowableObjectArray::Handle(
-      zone, GrowableObjectArray::New(16, Heap::kNew));
+      zone, GrowableObjectArray::New(count, Heap::kNew));
   String& str = String::Handle(zone);
   intptr_t start = 0;
   intptr_t i = 0;
-  for (; i < len; i++) {
+  for (; (i < len) && (result.Length() < count - 1); i++) {
     if (split_code == OneByteString::CharAt(receiver, i)) {
       str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
                                               Heap::kNew);
@@ -278,7 +285,7 @@ DEFINE_NATIVE_ENTRY(OneByteString_splitWithCharCode, 2) {
       start = i + 1;
     }
   }
-  str = OneByteString::SubStringUnchecked(receiver, start, (i - start),
+  str = OneByteString::SubStringUnchecked(receiver, start, (len - start),
                                           Heap::kNew);
   result.Add(str);
   result.SetTypeArguments(TypeArguments::Handle(
@@ -339,10 +346,27 @@ DEFINE_NATIVE_ENTRY(OneByteString_allocateFromOneByteList, 3) {
     intptr_t data_offset = Smi::Value(TypedDataView::OffsetInBytes(view));
     if (data_obj.IsTypedData()) {
       const TypedData& array = TypedData::Cast(data_obj);
-      return OneByteString::New(array, data_offset + start, length, space);
+      if (array.ElementSizeInBytes() == 1) {
+        return OneByteString::New(array, data_offset + start, length, space);
+      }
+      // A byte view on a buffer with wider elements.
+      String& string = String::Handle(OneByteString::New(length, space));
+      for (intptr_t i = 0; i < length; i++) {
+        OneByteString::SetCharAt(string, i,
+                                 array.GetUint8(data_offset + start + i));
+      }
+      return string.raw();
     } else if (data_obj.IsExternalTypedData()) {
       const ExternalTypedData& array = ExternalTypedData::Cast(data_obj);
-      return OneByteString::New(array, data_offset + start, length, space);
+      if (array.ElementSizeInBytes() == 1) {
+        return OneByteString::New(array, data_offset + start, length, space);
+      }
+      String& string = String::Handle(OneByteString::New(length, space));
+      for (intptr_t i = 0; i < length; i++) {
+        OneByteString::SetCharAt(string, i,
+                                 array.GetUint8(data_offset + start + i));
+      }
+      return string.raw();
     }
   } else if (list.IsArray()) {
     const Array& array = Array::Cast(list);
@@ -7,6 +7,7 @@
 @patch
 class StringBuffer {
   static const int _BUFFER_SIZE = 64;
+  static const int _MAX_BUFFER_SIZE = 4096;
   static const int _PARTS_TO_COMPACT = 128;
   static const int _PARTS_TO_COMPACT_SIZE_LIMIT = _PARTS_TO_COMPACT * 8;
 
@@ -35,8 +36,15 @@ class StringBuffer {
   /**
    * The buffer is used to build up a string from code units. It is
    * used when writing short strings or individual char codes to the
-   * buffer. The buffer is allocated on demand.
+   * buffer. The buffers are allocated on demand and grow geometrically
+   * up to [_MAX_BUFFER_SIZE] code units before their content becomes a
+   * part.
+   *
+   * While the code units are all Latin-1 they are kept in
+   * [_oneByteBuffer], which is copied directly into a one-byte string.
+   * The first wider code unit moves the content to [_buffer].
    */
+  Uint8List _oneByteBuffer;
   Uint16List _buffer;
   int _bufferPosition = 0;
 
@@ -46,7 +54,8 @@ class StringBuffer {
    *
    * The value of each added code unit is or'ed with this variable, so the
    * most significant bit set in any code unit is also set in this value.
-   * If below 256, the string in the buffer is a Latin-1 string.
+   * If below 256, the string in the buffer is a Latin-1 string and is
+   * kept in [_oneByteBuffer].
    */
   int _bufferCodeUnitMagnitude = 0;
 
@@ -69,7 +78,13 @@ class StringBuffer {
 
   @patch
   void writeCharCode(int charCode) {
-    if (charCode <= 0xFFFF) {
+    if (charCode <= 0xFF && _bufferCodeUnitMagnitude <= 0xFF) {
+      if (charCode < 0) {
+        throw new RangeError.range(charCode, 0, 0x10FFFF);
+      }
+      _ensureOneByteCapacity(1);
+      _oneByteBuffer[_bufferPosition++] = charCode;
+    } else if (charCode <= 0xFFFF) {
       if (charCode < 0) {
         throw new RangeError.range(charCode, 0, 0x10FFFF);
       }
@@ -127,12 +142,45 @@ class StringBuffer {
         : _StringBase._concatRange(_parts, 0, _parts.length);
   }
 
-  /** Ensures that the buffer has enough capacity to add n code units. */
+  /**
+   * Ensures that the one-byte buffer has enough capacity to add n Latin-1
+   * code units. Only used while the buffer content is Latin-1.
+   */
+  void _ensureOneByteCapacity(int n) {
+    if (_oneByteBuffer == null) {
+      _oneByteBuffer = new Uint8List(_BUFFER_SIZE);
+    } else if (_bufferPosition + n > _oneByteBuffer.length) {
+      if (_oneByteBuffer.length < _MAX_BUFFER_SIZE) {
+        _oneByteBuffer = new Uint8List(_oneByteBuffer.length * 2)
+          ..setRange(0, _bufferPosition, _oneByteBuffer);
+      } else {
+        _consumeBuffer();
+      }
+    }
+  }
+
+  /**
+   * Ensures that the two-byte buffer holds the buffer content and has
+   * enough capacity to add n code units.
+   */
   void _ensureCapacity(int n) {
+    if (_bufferCodeUnitMagnitude <= 0xFF && _bufferPosition > 0) {
+      if (_buffer == null || _buffer.length < _oneByteBuffer.length) {
+        _buffer = new Uint16List(_oneByteBuffer.length);
+      }
+      for (int i = 0; i < _bufferPosition; i++) {
+        _buffer[i] = _oneByteBuffer[i];
+      }
+    }
     if (_buffer == null) {
       _buffer = new Uint16List(_BUFFER_SIZE);
     } else if (_bufferPosition + n > _buffer.length) {
-      _consumeBuffer();
+      if (_buffer.length < _MAX_BUFFER_SIZE) {
+        _buffer = new Uint16List(_buffer.length * 2)
+          ..setRange(0, _bufferPosition, _buffer);
+      } else {
+        _consumeBuffer();
+      }
     }
   }
 
@@ -143,8 +191,10 @@ class StringBuffer {
    */
   void _consumeBuffer() {
     if (_bufferPosition == 0) return;
-    bool isLatin1 = _bufferCodeUnitMagnitude <= 0xFF;
-    String str = _create(_buffer, _bufferPosition, isLatin1);
+    String str = (_bufferCodeUnitMagnitude <= 0xFF)
+        ? _OneByteString._allocateFromOneByteList(
+            _oneByteBuffer, 0, _bufferPosition)
+        : _create(_buffer, _bufferPosition, false);
     _bufferPosition = _bufferCodeUnitMagnitude = 0;
     _addPart(str);
   }
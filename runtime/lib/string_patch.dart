@@ -91,6 +91,11 @@ abstract class _StringBase implements String {
   // TODO(lrn): See if this limit can be tweaked.
   static const int _maxJoinReplaceOneByteStringLength = 500;
 
+  // For longer ranges of a [Uint8List], copying the bytes in C++ with a
+  // single memmove is faster than the element-wise loop in
+  // [_createOneByteString].
+  static const int _maxOneByteCopyInDartLength = 64;
+
   factory _StringBase._uninstantiable() {
     throw new UnsupportedError("_StringBase can't be instaniated");
   }
@@ -126,6 +131,14 @@ abstract class _StringBase implements String {
         (ccid != ClassID.cidImmutableArray)) {
       if (charCodes is Uint8List) {
         end = RangeError.checkValidRange(start, end, charCodes.length);
+        // The native code only reads the VM's own Uint8List implementations,
+        // not e.g. an UnmodifiableUint8ListView.
+        if ((end - start > _maxOneByteCopyInDartLength) &&
+            ((ccid == ClassID.cidUint8Array) ||
+                (ccid == ClassID.cidExternalUint8Array) ||
+                (ccid == ClassID.cidUint8ArrayView))) {
+          return _OneByteString._allocateFromOneByteList(charCodes, start, end);
+        }
         return _createOneByteString(charCodes, start, end - start);
       } else if (charCodes is! Uint16List) {
         return _createStringFromIterable(charCodes, start, end);
@@ -803,6 +816,41 @@ abstract class _StringBase implements String {
     return s;
   }
 
+  // Interpolations of two to four parts are compiled into calls to these
+  // instead of [_interpolate], so no list of parts is allocated.
+  static String _interpolate2(Object a, Object b) {
+    return _interpolateSingle(a) + _interpolateSingle(b);
+  }
+
+  static String _interpolate3(Object a, Object b, Object c) {
+    return _concat4(_interpolateSingle(a), _interpolateSingle(b),
+        _interpolateSingle(c), "");
+  }
+
+  static String _interpolate4(Object a, Object b, Object c, Object d) {
+    return _concat4(_interpolateSingle(a), _interpolateSingle(b),
+        _interpolateSingle(c), _interpolateSingle(d));
+  }
+
+  static String _concat4(String s0, String s1, String s2, String s3) {
+    final totalLength = s0.length + s1.length + s2.length + s3.length;
+    // Like [_OneByteString._concatAll], copy short one-byte strings in
+    // Dart code and leave everything else to the runtime.
+    if ((totalLength <= 128) &&
+        (ClassID.getID(s0) == ClassID.cidOneByteString) &&
+        (ClassID.getID(s1) == ClassID.cidOneByteString) &&
+        (ClassID.getID(s2) == ClassID.cidOneByteString) &&
+        (ClassID.getID(s3) == ClassID.cidOneByteString)) {
+      final result = _OneByteString._allocate(totalLength);
+      int index = result._setRange(0, s0, 0, s0.length);
+      index = result._setRange(index, s1, 0, s1.length);
+      index = result._setRange(index, s2, 0, s2.length);
+      result._setRange(index, s3, 0, s3.length);
+      return result;
+    }
+    return _concatRangeNative(<String>[s0, s1, s2, s3], 0, 4);
+  }
+
   /**
    * Convert all objects in [values] to strings and concat them
    * into a result string.
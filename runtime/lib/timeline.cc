@@ -9,6 +9,7 @@
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/os.h"
+#include "vm/runtime_entry.h"
 #include "vm/timeline.h"
 
 namespace dart {
@@ -46,6 +47,18 @@ DEFINE_NATIVE_ENTRY(Timeline_getThreadCpuClock, 0) {
   return Integer::New(OS::GetCurrentThreadCPUMicros(), Heap::kNew);
 }
 
+// Leaf versions called directly from optimized code, see
+// BOOTSTRAP_LEAF_NATIVE_LIST.
+DEFINE_LEAF_RUNTIME_ENTRY(int64_t, TimelineGetTraceClock, 0, void) {
+  return OS::GetCurrentMonotonicMicros();
+}
+END_LEAF_RUNTIME_ENTRY
+
+DEFINE_LEAF_RUNTIME_ENTRY(int64_t, TimelineGetThreadCpuClock, 0, void) {
+  return OS::GetCurrentThreadCPUMicros();
+}
+END_LEAF_RUNTIME_ENTRY
+
 DEFINE_NATIVE_ENTRY(Timeline_reportTaskEvent, 6) {
 #ifndef PRODUCT
   if (!FLAG_support_timeline) {
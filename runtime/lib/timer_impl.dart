@@ -114,6 +114,106 @@ class _TimerHeap {
   static int _rightChildIndex(int index) => 2 * index + 2;
 }
 
+// Timer wheel for timers that expire well in the future.
+//
+// Time is divided into slots of 2^_SLOT_SHIFT milliseconds. A timer expiring
+// within the _SLOT_COUNT slots after the current slot is kept in a doubly
+// linked list for its slot, which makes `add` and `remove` O(1). Other timers
+// are kept in the _TimerHeap. When time reaches the start of a slot, its
+// timers are moved to the heap, which orders them precisely.
+//
+// Long timeouts are usually canceled before their slot is reached, so they
+// never touch the heap.
+class _TimerWheel {
+  static const _SLOT_SHIFT = 7;
+  static const _SLOT_COUNT = 1024;
+
+  final List<_Timer> _slots = new List<_Timer>(_SLOT_COUNT);
+  int _currentSlot = _slotOf(VMLibraryHooks.timerMillisecondClock());
+  // Not after the earliest occupied slot, if any.
+  int _earliestSlot = 0;
+  int _length = 0;
+
+  bool get isEmpty => _length == 0;
+
+  // The start of the earliest occupied slot. The wheel must not be empty.
+  int get nextWakeupTime {
+    assert(!isEmpty);
+    while (_slots[_indexOf(_earliestSlot)] == null) {
+      _earliestSlot++;
+    }
+    return _earliestSlot << _SLOT_SHIFT;
+  }
+
+  bool contains(_Timer timer) =>
+      (timer._previous != null) ||
+      identical(_slots[_indexOf(_slotOf(timer._wakeupTime))], timer);
+
+  // Adds [timer] unless it belongs in the heap. Returns whether it was added.
+  bool add(_Timer timer) {
+    int slot = _slotOf(timer._wakeupTime);
+    if ((slot <= _currentSlot) || (slot >= _currentSlot + _SLOT_COUNT)) {
+      return false;
+    }
+    int index = _indexOf(slot);
+    _Timer head = _slots[index];
+    timer._indexOrNext = head;
+    timer._previous = null;
+    if (head != null) {
+      head._previous = timer;
+    }
+    _slots[index] = timer;
+    if (isEmpty || (slot < _earliestSlot)) {
+      _earliestSlot = slot;
+    }
+    _length++;
+    return true;
+  }
+
+  void remove(_Timer timer) {
+    _Timer next = timer._indexOrNext;
+    _Timer previous = timer._previous;
+    if (previous == null) {
+      _slots[_indexOf(_slotOf(timer._wakeupTime))] = next;
+    } else {
+      previous._indexOrNext = next;
+    }
+    if (next != null) {
+      next._previous = previous;
+    }
+    timer._indexOrNext = null;
+    timer._previous = null;
+    _length--;
+  }
+
+  // Moves the timers of all slots that started at or before [now] to [heap].
+  void advance(int now, _TimerHeap heap) {
+    int slot = _slotOf(now);
+    if (slot <= _currentSlot) return;
+    int last = _currentSlot + _SLOT_COUNT - 1;
+    if (slot < last) last = slot;
+    for (int s = _earliestSlot; !isEmpty && (s <= last); s++) {
+      int index = _indexOf(s);
+      _Timer timer = _slots[index];
+      _slots[index] = null;
+      while (timer != null) {
+        _Timer next = timer._indexOrNext;
+        timer._previous = null;
+        heap.add(timer);
+        _length--;
+        timer = next;
+      }
+    }
+    _currentSlot = slot;
+    if (_earliestSlot <= slot) {
+      _earliestSlot = slot + 1;
+    }
+  }
+
+  static int _slotOf(int time) => time >> _SLOT_SHIFT;
+  static int _indexOf(int slot) => slot & (_SLOT_COUNT - 1);
+}
+
 class _Timer implements Timer {
   // Cancels the timer in the event handler.
   static const _NO_TIMER = -1;
@@ -123,8 +223,10 @@ class _Timer implements Timer {
   static const _TIMEOUT_EVENT = null;
 
   // Timers are ordered by wakeup time. Timers with a timeout value of > 0 do
-  // end up on the TimerHeap. Timers with a timeout of 0 are queued in a list.
+  // end up on the TimerHeap, or on the TimerWheel until they are close to
+  // expiring. Timers with a timeout of 0 are queued in a list.
   static _TimerHeap _heap = new _TimerHeap();
+  static _TimerWheel _wheel = new _TimerWheel();
   static _Timer _firstZeroTimer;
   static _Timer _lastZeroTimer;
 
@@ -144,6 +246,7 @@ class _Timer implements Timer {
   final int _milliSeconds; // Duration specified at creation.
   final bool _repeating; // Indicates periodic timers.
   var _indexOrNext; // Index if part of the TimerHeap, link otherwise.
+  _Timer _previous; // Previous timer in the same TimerWheel slot.
   int _id; // Incrementing id to enable sorting of timers with same expiry.
 
   int _tick = 0; // Backing for [tick],
@@ -201,18 +304,27 @@ class _Timer implements Timer {
 
   int get tick => _tick;
 
-  // Cancels a set timer. The timer is removed from the timer heap if it is a
-  // non-zero timer. Zero timers are kept in the list as they need to consume
-  // the corresponding pending message.
+  // Cancels a set timer. The timer is removed from the timer heap or wheel if
+  // it is a non-zero timer. Zero timers are kept in the list as they need to
+  // consume the corresponding pending message.
   void cancel() {
     _callback = null;
-    // Only heap timers are really removed. Zero timers need to consume their
-    // corresponding wakeup message so they are left in the queue.
-    if (!_isInHeap) return;
-    bool update = _heap.isFirst(this);
-    _heap.remove(this);
-    if (update) {
-      _notifyEventHandler();
+    // Only heap and wheel timers are really removed. Zero timers need to
+    // consume their corresponding wakeup message so they are left in the
+    // queue.
+    if (_isInHeap) {
+      bool update = _heap.isFirst(this);
+      _heap.remove(this);
+      if (update) {
+        _notifyEventHandler();
+      }
+    } else if ((_milliSeconds > 0) && _wheel.contains(this)) {
+      _wheel.remove(this);
+      // A wakeup scheduled for the slot of this timer is harmless, but the
+      // event handler must learn about the last timer going away.
+      if (_wheel.isEmpty) {
+        _notifyEventHandler();
+      }
     }
   }
 
@@ -227,8 +339,8 @@ class _Timer implements Timer {
     }
   }
 
-  // Adds a timer to the heap or timer list. Timers with the same wakeup time
-  // are enqueued in order and notified in FIFO order.
+  // Adds a timer to the heap, wheel or timer list. Timers with the same wakeup
+  // time are enqueued in order and notified in FIFO order.
   void _enqueue() {
     if (_milliSeconds == 0) {
       if (_firstZeroTimer == null) {
@@ -240,6 +352,11 @@ class _Timer implements Timer {
       }
       // Every zero timer gets its own event.
       _notifyZeroHandler();
+    } else if (_wheel.add(this)) {
+      if ((_scheduledWakeupTime == null) ||
+          (_wheel.nextWakeupTime < _scheduledWakeupTime)) {
+        _notifyEventHandler();
+      }
     } else {
       _heap.add(this);
       if (_heap.isFirst(this)) {
@@ -263,7 +380,9 @@ class _Timer implements Timer {
     var pendingTimers = new List();
     assert(_firstZeroTimer != null);
     // Collect pending timers from the timer heap that have an expiration prior
-    // to the currently notified zero timer.
+    // to the currently notified zero timer. Timers left in the wheel expire
+    // after the current time.
+    _wheel.advance(VMLibraryHooks.timerMillisecondClock(), _heap);
     var timer;
     while (!_heap.isEmpty && (_heap.first._compareTo(_firstZeroTimer) < 0)) {
       timer = _heap.removeFirst();
@@ -286,7 +405,7 @@ class _Timer implements Timer {
     }
 
     // If there are no pending timers. Close down the receive port.
-    if ((_firstZeroTimer == null) && _heap.isEmpty) {
+    if ((_firstZeroTimer == null) && _heap.isEmpty && _wheel.isEmpty) {
       // No pending timers: Close the receive port and let the event handler
       // know.
       if (_sendPort != null) {
@@ -294,15 +413,26 @@ class _Timer implements Timer {
         _shutdownTimerHandler();
       }
       return;
-    } else if (_heap.isEmpty) {
+    } else if (_heap.isEmpty && _wheel.isEmpty) {
       // Only zero timers are left. Cancel any scheduled wakeups.
       _cancelWakeup();
       return;
     }
 
+    // Wake up for the first timer in the heap, or at the start of the first
+    // occupied wheel slot to move its timers to the heap.
+    var wakeupTime;
+    if (_heap.isEmpty) {
+      wakeupTime = _wheel.nextWakeupTime;
+    } else {
+      wakeupTime = _heap.first._wakeupTime;
+      if (!_wheel.isEmpty && (_wheel.nextWakeupTime < wakeupTime)) {
+        wakeupTime = _wheel.nextWakeupTime;
+      }
+    }
+
     // Only send a message if the requested wakeup time differs from the
     // already scheduled wakeup time.
-    var wakeupTime = _heap.first._wakeupTime;
     if ((_scheduledWakeupTime == null) ||
         (wakeupTime != _scheduledWakeupTime)) {
       _scheduleWakeup(wakeupTime);
@@ -311,6 +441,8 @@ class _Timer implements Timer {
 
   static List _queueFromTimeoutEvent() {
     var pendingTimers = new List();
+    var currentTime = VMLibraryHooks.timerMillisecondClock();
+    _wheel.advance(currentTime, _heap);
     if (_firstZeroTimer != null) {
       // Collect pending timers from the timer heap that have an expiration
       // prior to the next zero timer.
@@ -326,7 +458,6 @@ class _Timer implements Timer {
     } else {
       // Collect pending timers from the timer heap which have expired at this
       // time.
-      var currentTime = VMLibraryHooks.timerMillisecondClock();
       var timer;
       while (!_heap.isEmpty && (_heap.first._wakeupTime <= currentTime)) {
         timer = _heap.removeFirst();
@@ -339,7 +470,7 @@ class _Timer implements Timer {
   static void _runTimers(List pendingTimers) {
     // If there are no pending timers currently reset the id space before we
     // have a chance to enqueue new timers.
-    if (_heap.isEmpty && (_firstZeroTimer == null)) {
+    if (_heap.isEmpty && _wheel.isEmpty && (_firstZeroTimer == null)) {
       _idCount = 0;
     }
 
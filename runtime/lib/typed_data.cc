@@ -144,6 +144,83 @@ DEFINE_NATIVE_ENTRY(TypedData_setRange, 7) {
   return Bool::False().raw();
 }
 
+// Returns the address of a byte range of a TypedData or ExternalTypedData
+// object after checking that the range is in bounds. The range must not be
+// empty. The address is only valid until the next safepoint.
+static uint8_t* ByteRangeAddr(const Instance& instance,
+                              intptr_t offset_in_bytes,
+                              intptr_t length_in_bytes) {
+  ASSERT(length_in_bytes > 0);
+  if (instance.IsTypedData()) {
+    const TypedData& array = TypedData::Cast(instance);
+    RangeCheck(offset_in_bytes, length_in_bytes, array.LengthInBytes(), 1);
+    return reinterpret_cast<uint8_t*>(array.DataAddr(offset_in_bytes));
+  }
+  if (instance.IsExternalTypedData()) {
+    const ExternalTypedData& array = ExternalTypedData::Cast(instance);
+    RangeCheck(offset_in_bytes, length_in_bytes, array.LengthInBytes(), 1);
+    return reinterpret_cast<uint8_t*>(array.DataAddr(offset_in_bytes));
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+// The following natives back fillRange, indexOf and lastIndexOf of lists with
+// one byte elements, which call them for ranges long enough for memset and
+// memchr to beat a Dart loop. The value is the byte representation of the
+// element, computed by the caller.
+DEFINE_NATIVE_ENTRY(TypedData_fillBytes, 4) {
+  const Instance& array = Instance::CheckedHandle(arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, length, arguments->NativeArgAt(2));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, value, arguments->NativeArgAt(3));
+  ASSERT(Utils::IsUint(8, value.Value()));
+  if (length.Value() > 0) {
+    uint8_t* data = ByteRangeAddr(array, start.Value(), length.Value());
+    NoSafepointScope no_safepoint;
+    memset(data, value.Value(), length.Value());
+  }
+  return Object::null();
+}
+
+DEFINE_NATIVE_ENTRY(TypedData_indexOfByte, 4) {
+  const Instance& array = Instance::CheckedHandle(arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, length, arguments->NativeArgAt(2));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, value, arguments->NativeArgAt(3));
+  ASSERT(Utils::IsUint(8, value.Value()));
+  if (length.Value() <= 0) {
+    return Smi::New(-1);
+  }
+  const uint8_t* data = ByteRangeAddr(array, start.Value(), length.Value());
+  NoSafepointScope no_safepoint;
+  const void* found = memchr(data, value.Value(), length.Value());
+  if (found == NULL) {
+    return Smi::New(-1);
+  }
+  return Smi::New(reinterpret_cast<const uint8_t*>(found) - data);
+}
+
+DEFINE_NATIVE_ENTRY(TypedData_lastIndexOfByte, 4) {
+  const Instance& array = Instance::CheckedHandle(arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, length, arguments->NativeArgAt(2));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, value, arguments->NativeArgAt(3));
+  ASSERT(Utils::IsUint(8, value.Value()));
+  if (length.Value() <= 0) {
+    return Smi::New(-1);
+  }
+  const uint8_t* data = ByteRangeAddr(array, start.Value(), length.Value());
+  const uint8_t byte = value.Value();
+  NoSafepointScope no_safepoint;
+  for (intptr_t i = length.Value() - 1; i >= 0; i--) {
+    if (data[i] == byte) {
+      return Smi::New(i);
+    }
+  }
+  return Smi::New(-1);
+}
+
 // We check the length parameter against a possible maximum length for the
 // array based on available physical addressable memory on the system. The
 // maximum possible length is a scaled value of kSmiMax which is set up based
@@ -105,8 +105,22 @@ abstract class _TypedListBase {
   // Element size of toCid and fromCid must match (test at caller).
   bool _setRange(int startInBytes, int lengthInBytes, _TypedListBase from,
       int startFromInBytes, int toCid, int fromCid) native "TypedData_setRange";
+
+  // Byte range operations used by lists with one byte elements. 'value' is
+  // the byte stored for an element, and the search operations return an
+  // offset relative to 'startInBytes', or -1.
+  void _fillBytes(int startInBytes, int lengthInBytes, int value)
+      native "TypedData_fillBytes";
+  int _indexOfByte(int startInBytes, int lengthInBytes, int value)
+      native "TypedData_indexOfByte";
+  int _lastIndexOfByte(int startInBytes, int lengthInBytes, int value)
+      native "TypedData_lastIndexOfByte";
 }
 
+// Ranges of one byte elements at least this long are filled or searched by
+// natives using memset and memchr rather than by a loop in Dart.
+const int _minNativeByteRangeLength = 64;
+
 abstract class _IntListMixin implements List<int> {
   int get elementSizeInBytes;
   int get offsetInBytes;
@@ -389,6 +403,14 @@ abstract class _IntListMixin implements List<int> {
     } else if (start < 0) {
       start = 0;
     }
+    if (elementSizeInBytes == 1 &&
+        this.length - start >= _minNativeByteRangeLength) {
+      final byte = _byteOf(element);
+      if (byte < 0) return -1;
+      final found = buffer._data
+          ._indexOfByte(start + offsetInBytes, this.length - start, byte);
+      return (found < 0) ? -1 : start + found;
+    }
     for (int i = start; i < this.length; i++) {
       if (this[i] == element) return i;
     }
@@ -401,12 +423,27 @@ abstract class _IntListMixin implements List<int> {
     } else if (start < 0) {
       return -1;
     }
+    if (elementSizeInBytes == 1 && start + 1 >= _minNativeByteRangeLength) {
+      final byte = _byteOf(element);
+      if (byte < 0) return -1;
+      return buffer._data._lastIndexOfByte(offsetInBytes, start + 1, byte);
+    }
     for (int i = start; i >= 0; i--) {
       if (this[i] == element) return i;
     }
     return -1;
   }
 
+  // Returns the byte that represents 'element' in a list with one byte
+  // elements, or -1 if such a list cannot contain it.
+  int _byteOf(int element) {
+    if (element == null) return -1;
+    if (this is Int8List) {
+      return (element >= -128 && element <= 127) ? (element & 0xFF) : -1;
+    }
+    return (element >= 0 && element <= 255) ? element : -1;
+  }
+
   int removeLast() {
     throw new UnsupportedError("Cannot remove from a fixed-length list");
   }
@@ -454,6 +491,18 @@ abstract class _IntListMixin implements List<int> {
 
   void fillRange(int start, int end, [int fillValue]) {
     RangeError.checkValidRange(start, end, this.length);
+    if (elementSizeInBytes == 1 &&
+        fillValue != null &&
+        end - start >= _minNativeByteRangeLength) {
+      int byte;
+      if (this is Uint8ClampedList) {
+        byte = (fillValue < 0) ? 0 : (fillValue > 255 ? 255 : fillValue);
+      } else {
+        byte = fillValue & 0xFF;
+      }
+      buffer._data._fillBytes(start + offsetInBytes, end - start, byte);
+      return;
+    }
     for (var i = start; i < end; ++i) {
       this[i] = fillValue;
     }
@@ -16,4 +16,79 @@ DEFINE_NATIVE_ENTRY(Uri_isWindowsPlatform, 0) {
 #endif
 }
 
+// Returns the value of the hex digit c, or -1 if c is not a hex digit.
+static intptr_t HexDigitValue(uint16_t c) {
+  if ((c >= '0') && (c <= '9')) {
+    return c - '0';
+  }
+  c |= 0x20;
+  if ((c >= 'a') && (c <= 'f')) {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+// Decodes the percent-encoded range [start, end) of a one byte string in two
+// passes: the first validates the range and counts the decoded bytes, the
+// second decodes into a string of exactly that length. Returns null whenever
+// _Uri._uriDecodeGeneric has to decide, e.g. to throw the right error.
+DEFINE_NATIVE_ENTRY(Uri_decodeOneByteString, 5) {
+  GET_NON_NULL_NATIVE_ARGUMENT(String, text, arguments->NativeArgAt(0));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_obj, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, end_obj, arguments->NativeArgAt(2));
+  GET_NON_NULL_NATIVE_ARGUMENT(Bool, plus_to_space, arguments->NativeArgAt(3));
+  GET_NON_NULL_NATIVE_ARGUMENT(Bool, is_latin1, arguments->NativeArgAt(4));
+  ASSERT(text.IsOneByteString());
+  const intptr_t start = start_obj.Value();
+  const intptr_t end = end_obj.Value();
+  ASSERT((0 <= start) && (start <= end) && (end <= text.Length()));
+  const uint16_t plus = plus_to_space.value() ? '+' : '%';
+
+  intptr_t length = 0;
+  bool simple = true;
+  for (intptr_t i = start; i < end; i++, length++) {
+    const uint16_t c = OneByteString::CharAt(text, i);
+    if (c > 127) {
+      return Object::null();
+    }
+    if (c == '%') {
+      if (i + 3 > end) {
+        return Object::null();
+      }
+      const intptr_t hi = HexDigitValue(OneByteString::CharAt(text, i + 1));
+      const intptr_t lo = HexDigitValue(OneByteString::CharAt(text, i + 2));
+      if ((hi < 0) || (lo < 0) || ((hi > 7) && !is_latin1.value())) {
+        return Object::null();
+      }
+      i += 2;
+      simple = false;
+    } else if (c == plus) {
+      simple = false;
+    }
+  }
+  if (simple) {
+    if ((start == 0) && (end == text.Length())) {
+      return text.raw();
+    }
+    return OneByteString::New(text, start, end - start, Heap::kNew);
+  }
+
+  const String& result =
+      String::Handle(zone, OneByteString::New(length, Heap::kNew));
+  intptr_t j = 0;
+  for (intptr_t i = start; i < end; i++, j++) {
+    uint16_t c = OneByteString::CharAt(text, i);
+    if (c == '%') {
+      c = (HexDigitValue(OneByteString::CharAt(text, i + 1)) << 4) |
+          HexDigitValue(OneByteString::CharAt(text, i + 2));
+      i += 2;
+    } else if (c == plus) {
+      c = ' ';
+    }
+    OneByteString::SetCharAt(result, j, c);
+  }
+  ASSERT(j == length);
+  return result.raw();
+}
+
 }  // namespace dart
@@ -76,4 +76,26 @@ class _Uri {
     }
     return result.toString();
   }
+
+  @patch
+  static String _uriDecode(
+      String text, int start, int end, Encoding encoding, bool plusToSpace) {
+    if (text is _OneByteString) {
+      final bool isLatin1 = identical(encoding, latin1);
+      if (isLatin1 ||
+          identical(encoding, utf8) ||
+          identical(encoding, ascii)) {
+        String result =
+            _decodeOneByteString(text, start, end, plusToSpace, isLatin1);
+        if (result != null) return result;
+      }
+    }
+    return _uriDecodeGeneric(text, start, end, encoding, plusToSpace);
+  }
+
+  // Returns null if [text] has to be decoded by [_uriDecodeGeneric]: if it is
+  // not validly percent-encoded, or if a decoded byte is not ASCII and the
+  // encoding is not Latin-1.
+  static String _decodeOneByteString(String text, int start, int end,
+      bool plusToSpace, bool isLatin1) native "Uri_decodeOneByteString";
 }
@@ -0,0 +1,42 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+// VMOptions=--error_on_bad_type --error_on_bad_override
+
+import 'package:observatory/service_io.dart';
+import 'package:unittest/unittest.dart';
+
+import 'test_helper.dart';
+
+var tests = <VMTest>[
+  (VM vm) async {
+    var result = await vm.invokeRpcNoUpgrade('_getCompilerStatistics', {});
+    expect(result['type'], equals('_CompilerStatistics'));
+    // Starting the test isolate compiled code.
+    List passes = result['passes'];
+    List compilations = result['compilations'];
+    expect(compilations, isNotEmpty);
+    for (var pass in passes) {
+      expect(pass['name'], new isInstanceOf<String>());
+      expect(pass['runs'], greaterThan(0));
+      expect(pass['micros'], greaterThanOrEqualTo(0));
+    }
+    // Compilations are listed most expensive first.
+    for (int i = 0; i < compilations.length; i++) {
+      expect(compilations[i]['function'], new isInstanceOf<String>());
+      expect(compilations[i]['optimized'], new isInstanceOf<bool>());
+      if (i > 0) {
+        expect(compilations[i]['micros'],
+            lessThanOrEqualTo(compilations[i - 1]['micros']));
+      }
+    }
+  },
+  (VM vm) async {
+    var result =
+        await vm.invokeRpcNoUpgrade('_getCompilerStatistics', {'limit': '1'});
+    expect(result['type'], equals('_CompilerStatistics'));
+    expect(result['compilations'].length, equals(1));
+  },
+];
+
+main(args) async => runVMTests(args, tests);
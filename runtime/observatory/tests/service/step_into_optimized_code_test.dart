@@ -0,0 +1,90 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+// VMOptions=--no_background_compilation --optimization_counter_threshold=10
+
+import 'dart:developer';
+import 'package:observatory/service_io.dart';
+import 'package:unittest/unittest.dart';
+import 'service_test_common.dart';
+import 'test_helper.dart';
+
+const int LINE_A = 19;
+const int LINE_B = 23;
+const int LINE_C = 28;
+
+class Foo {
+  int value = 0;
+  void add(int x) {
+    value += x; // LINE_A
+  }
+
+  String toString() {
+    return 'Foo($value)'; // LINE_B
+  }
+}
+
+int hot(int x) {
+  return x + 1; // LINE_C
+}
+
+// Once optimized, the callback, toString and hot are reached through
+// optimized code: forEach, string interpolation and inlining.
+String warmup(Foo foo, List<int> list) {
+  list.forEach(foo.add);
+  return '$foo ${hot(1)}';
+}
+
+void testMain() {
+  Foo foo = new Foo();
+  List<int> list = <int>[1, 2, 3];
+  for (int i = 0; i < 100; i++) {
+    warmup(foo, list);
+  }
+  debugger();
+  warmup(foo, list);
+  for (int i = 0; i < 100; i++) {
+    warmup(foo, list);
+  }
+  debugger();
+  warmup(foo, list);
+}
+
+Future<int> topFrameLine(Isolate isolate) async {
+  ServiceMap stack = await isolate.getStack();
+  Frame top = stack['frames'][0];
+  Script script = await top.location.script.load();
+  return script.tokenToLine(top.location.tokenPos);
+}
+
+IsolateTest stepIntoUntilLine(int line) {
+  return (Isolate isolate) async {
+    for (int i = 0; i < 50; i++) {
+      await stepInto(isolate);
+      if (await topFrameLine(isolate) == line) {
+        return;
+      }
+    }
+    fail('Stepping into did not reach line $line');
+  };
+}
+
+var tests = <IsolateTest>[
+  hasStoppedAtBreakpoint,
+  // Step into callbacks invoked by optimized code.
+  stepIntoUntilLine(LINE_A),
+  stepIntoUntilLine(LINE_B),
+  resumeIsolate,
+  hasStoppedAtBreakpoint,
+  // A breakpoint in a function that optimized code inlined.
+  setBreakpointAtLine(LINE_C),
+  resumeIsolate,
+  hasStoppedAtBreakpoint,
+  stoppedAtLine(LINE_C),
+  // Stepping out continues in the deoptimized caller.
+  stepOut,
+  stoppedAtLine(35),
+  resumeIsolate,
+];
+
+main(args) => runIsolateTests(args, tests, testeeConcurrent: testMain);
@@ -41,6 +41,10 @@ class AtomicOperations : public AllStatic {
                                        uint32_t old_value,
                                        uint32_t new_value);
 
+  // Full memory barrier: memory accesses before the fence are ordered before
+  // memory accesses after it.
+  static void ThreadFence();
+
   // Performs a load of a word from 'ptr', but without any guarantees about
   // memory order (i.e., no load barriers/fences).
   template <typename T>
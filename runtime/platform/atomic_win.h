@@ -141,6 +141,10 @@ inline uint32_t AtomicOperations::CompareAndSwapUint32(uint32_t* ptr,
 #endif
 }
 
+inline void AtomicOperations::ThreadFence() {
+  MemoryBarrier();
+}
+
 }  // namespace dart
 
 #endif  // RUNTIME_PLATFORM_ATOMIC_WIN_H_
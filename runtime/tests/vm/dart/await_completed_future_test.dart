@@ -0,0 +1,54 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that awaiting a value or an already completed future still suspends
+// the async function and resumes it from a microtask in the right zone.
+
+import "dart:async";
+
+import "package:expect/expect.dart";
+
+final List<String> events = <String>[];
+
+Future<int> awaitValue() async {
+  events.add("value:before");
+  final result = await 1;
+  events.add("value:after");
+  return result;
+}
+
+Future<int> awaitCompleted(Future<int> future) async {
+  events.add("completed:before");
+  final result = await future;
+  events.add("completed:after");
+  return result;
+}
+
+main() async {
+  final completed = new Future<int>.value(2);
+  await null;
+
+  final f1 = awaitValue();
+  final f2 = awaitCompleted(completed);
+  events.add("sync");
+  Expect.equals(1, await f1);
+  Expect.equals(2, await f2);
+  Expect.listEquals([
+    "value:before",
+    "completed:before",
+    "sync",
+    "value:after",
+    "completed:after",
+  ], events);
+
+  // The continuation must run in the zone of the async function.
+  final zone = Zone.current.fork(zoneValues: {#key: "inner"});
+  final value = await zone.run(() async {
+    await 3;
+    final inner = Zone.current[#key];
+    await completed;
+    return "$inner:${Zone.current[#key]}";
+  });
+  Expect.equals("inner:inner", value);
+}
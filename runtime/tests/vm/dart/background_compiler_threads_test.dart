@@ -0,0 +1,56 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--background-compilation --background-compiler-threads=4 --optimization-counter-threshold=100
+// VMOptions=--background-compilation --background-compiler-threads=4 --optimization-counter-threshold=100 --stress-test-background-compilation
+
+// Test that many functions becoming hot at the same time are compiled
+// correctly by several background compiler threads.
+
+import "package:expect/expect.dart";
+
+int f0(int x) => x + 0;
+int f1(int x) => x * 2 + 1;
+int f2(int x) => x - 2;
+int f3(int x) => (x << 1) - 3;
+int f4(int x) => x ~/ 2 + 4;
+int f5(int x) => x % 7 + 5;
+int f6(int x) => x * x - 6;
+int f7(int x) => -x + 7;
+
+int g0(List<int> l) => l.fold(0, (a, b) => a + f0(b));
+int g1(List<int> l) => l.fold(0, (a, b) => a + f1(b));
+int g2(List<int> l) => l.fold(0, (a, b) => a + f2(b));
+int g3(List<int> l) => l.fold(0, (a, b) => a + f3(b));
+
+int run(List<int> l, int i) {
+  return f0(i) +
+      f1(i) +
+      f2(i) +
+      f3(i) +
+      f4(i) +
+      f5(i) +
+      f6(i) +
+      f7(i) +
+      g0(l) +
+      g1(l) +
+      g2(l) +
+      g3(l);
+}
+
+int expected(List<int> l, int i) {
+  int sum = i + (i * 2 + 1) + (i - 2) + ((i << 1) - 3) + (i ~/ 2 + 4) +
+      (i % 7 + 5) + (i * i - 6) + (-i + 7);
+  for (int x in l) {
+    sum += x + (x * 2 + 1) + (x - 2) + ((x << 1) - 3);
+  }
+  return sum;
+}
+
+void main() {
+  final l = new List<int>.generate(10, (i) => i * 3);
+  for (int i = 0; i < 20000; i++) {
+    Expect.equals(expected(l, i), run(l, i));
+  }
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test multiplication of big integers large enough to use the Karatsuba
+// algorithm, including unbalanced and negative operands.
+
+import "package:expect/expect.dart";
+
+BigInt ones(int bits) => (BigInt.one << bits) - BigInt.one;
+
+BigInt pattern(int bits, int seed) {
+  var result = BigInt.zero;
+  var x = seed;
+  for (int i = 0; i < bits; i += 31) {
+    x = (x * 1103515245 + 12345) & 0x7fffffff;
+    result = (result << 31) | new BigInt.from(x);
+  }
+  return result;
+}
+
+main() {
+  for (final bits in [2048, 4099, 10000]) {
+    final m = ones(bits);
+    Expect.equals(
+        (BigInt.one << (2 * bits)) - (BigInt.one << (bits + 1)) + BigInt.one,
+        m * m);
+  }
+  for (final sizes in [
+    [2100, 2100],
+    [6000, 2100],
+    [20000, 2050],
+    [9000, 7000],
+  ]) {
+    final a = pattern(sizes[0], sizes[0]);
+    final b = pattern(sizes[1], sizes[1] + 1);
+    final p = a * b;
+    Expect.equals(p, b * a);
+    Expect.equals(a, p ~/ b);
+    Expect.equals(b, p ~/ a);
+    Expect.equals(BigInt.zero, p % a);
+    Expect.equals(-p, (-a) * b);
+    Expect.equals(-p, a * (-b));
+    Expect.equals(p, (-a) * (-b));
+    Expect.equals(p + a, a * (b + BigInt.one));
+  }
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+// VMOptions=--no-closed-world-devirtualization
+
+// Test that calls on interface types that are devirtualized using the closed
+// world class hierarchy in AOT mode reach the right implementation.
+
+import "package:expect/expect.dart";
+
+abstract class Shape {
+  int area();
+  String get name;
+}
+
+// Implements Shape without extending it.
+class Square implements Shape {
+  final int side;
+  Square(this.side);
+  int area() => side * side;
+  String get name => "square";
+}
+
+class Rectangle implements Shape {
+  final int width;
+  final int height;
+  Rectangle(this.width, this.height);
+  int area() => width * height;
+  String get name => "rectangle";
+}
+
+// Inherits area() from Rectangle, so there are fewer targets than classes.
+class Banner extends Rectangle {
+  Banner(int width) : super(width, 1);
+  String get name => "banner";
+}
+
+// Only implemented by a single class: calls become static calls.
+abstract class Counter {
+  int next();
+}
+
+class SimpleCounter implements Counter {
+  int value = 0;
+  int next() => ++value;
+}
+
+int totalArea(List<Shape> shapes) {
+  int total = 0;
+  for (int i = 0; i < shapes.length; i++) {
+    total += shapes[i].area();
+  }
+  return total;
+}
+
+String names(List<Shape> shapes) {
+  final buffer = new StringBuffer();
+  for (int i = 0; i < shapes.length; i++) {
+    buffer.write(shapes[i].name[0]);
+  }
+  return buffer.toString();
+}
+
+int count(Counter counter, int n) {
+  int last = 0;
+  for (int i = 0; i < n; i++) {
+    last = counter.next();
+  }
+  return last;
+}
+
+main() {
+  final shapes = <Shape>[
+    new Square(3),
+    new Rectangle(2, 5),
+    new Banner(7),
+  ];
+  for (int i = 0; i < 50; i++) {
+    Expect.equals(9 + 10 + 7, totalArea(shapes));
+    Expect.equals("srb", names(shapes));
+  }
+  Expect.equals(100, count(new SimpleCounter(), 100));
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+// VMOptions=--no-speculative-closure-calls
+
+// Test that closure calls specialized to the closure function seen at the
+// call site deoptimize correctly when a different closure arrives.
+
+import "package:expect/expect.dart";
+
+int apply(int f(int x), int value) => f(value);
+
+int sum(List<int> list, int f(int x)) {
+  int total = 0;
+  for (int i = 0; i < list.length; i++) {
+    total += f(list[i]);
+  }
+  return total;
+}
+
+int negate(int x) => -x;
+
+String named(String f({String prefix}), String prefix) => f(prefix: prefix);
+
+main() {
+  final list = <int>[1, 2, 3, 4];
+  int twice(int x) => 2 * x;
+  for (int i = 0; i < 50; i++) {
+    Expect.equals(2 * i, apply(twice, i));
+    Expect.equals(20, sum(list, twice));
+    Expect.equals("a!", named(({String prefix}) => "$prefix!", "a"));
+  }
+
+  // A different closure with the same class reaches the specialized sites.
+  int offset = 100;
+  Expect.equals(105, apply((int x) => x + offset, 5));
+  Expect.equals(410, sum(list, (int x) => x + offset));
+  Expect.equals("b?", named(({String prefix}) => "$prefix?", "b"));
+
+  // Tear-offs are closures as well.
+  Expect.equals(-3, apply(negate, 3));
+  Expect.equals(-10, sum(list, negate));
+}
@@ -0,0 +1,45 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+// VMOptions=--max-unchecked-loop-trip-count=0
+
+// Test that short counted loops whose back-edge stack checks are removed
+// still compute the right results, including when nested in a checked loop.
+
+import "package:expect/expect.dart";
+
+int sumSmall() {
+  int total = 0;
+  for (int i = 0; i < 8; i++) {
+    total += i;
+  }
+  return total;
+}
+
+int sumStrided() {
+  int total = 0;
+  for (int i = 3; i <= 20; i += 4) {
+    total += i;
+  }
+  return total;
+}
+
+int nested(int n) {
+  int total = 0;
+  for (int j = 0; j < n; j++) {
+    for (int i = 0; i < 4; i++) {
+      total += i * j;
+    }
+  }
+  return total;
+}
+
+main() {
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(28, sumSmall());
+    Expect.equals(3 + 7 + 11 + 15 + 19, sumStrided());
+    Expect.equals(6 * (99 * 100 ~/ 2), nested(100));
+  }
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+
+// Test that casts to generic interface types like List<String>, which type
+// testing stubs check inline for implementations sharing the type arguments
+// layout, accept and reject the right instances.
+
+import "dart:collection";
+import "dart:typed_data";
+import "package:expect/expect.dart";
+
+class StringList extends ListBase<String> {
+  final List<String> _list = <String>[];
+  int get length => _list.length;
+  set length(int value) => _list.length = value;
+  String operator [](int index) => _list[index];
+  void operator []=(int index, String value) => _list[index] = value;
+}
+
+// Passes its type parameter to List at a different position.
+class Swapped<A, B> extends ListBase<B> {
+  int get length => 0;
+  set length(int value) {}
+  B operator [](int index) => null;
+  void operator []=(int index, B value) {}
+}
+
+bool isStringList(Object o) => o is List<String>;
+bool isIntList(Object o) => o is List<int>;
+bool isStringIntMap(Object o) => o is Map<String, int>;
+
+List<String> castStringList(Object o) => o as List<String>;
+Map<String, int> castStringIntMap(Object o) => o as Map<String, int>;
+
+bool isCastError(e) => e is CastError;
+
+main() {
+  for (int i = 0; i < 50; i++) {
+    Expect.isTrue(isStringList(<String>["a"]));
+    Expect.isTrue(isStringList(new List<String>(3)));
+    Expect.isTrue(isStringList(const <String>["a"]));
+    Expect.isTrue(isStringList(new StringList()));
+    Expect.isTrue(isStringList(new Swapped<int, String>()));
+    Expect.isFalse(isStringList(new Swapped<String, int>()));
+    Expect.isFalse(isStringList(<int>[1]));
+    Expect.isFalse(isStringList(<Object>["a"]));
+    Expect.isFalse(isStringList("a"));
+    Expect.isFalse(isStringList(null));
+
+    Expect.isTrue(isIntList(<int>[1]));
+    Expect.isTrue(isIntList(new Uint8List(1)));
+    Expect.isFalse(isIntList(new Float64List(1)));
+    Expect.isFalse(isIntList(<num>[1]));
+
+    Expect.isTrue(isStringIntMap(<String, int>{"a": 1}));
+    Expect.isTrue(isStringIntMap(new HashMap<String, int>()));
+    Expect.isFalse(isStringIntMap(<int, String>{1: "a"}));
+
+    Expect.equals(1, castStringList(<String>["a"]).length);
+    Expect.isNull(castStringList(null));
+    Expect.throws(() => castStringList(<int>[1]), (e) => e is CastError);
+
+    // Instances with an all-dynamic type arguments vector.
+    Expect.isFalse(isStringList(<dynamic>["a"]));
+    Expect.isFalse(isStringList(new List(1)));
+    Expect.isFalse(isStringIntMap(<dynamic, dynamic>{"a": 1}));
+    Expect.isFalse(isStringIntMap(new HashMap()));
+    Expect.throws(() => castStringList(<dynamic>["a"]), isCastError);
+    Expect.throws(() => castStringList(new List(1)), isCastError);
+    Expect.throws(
+        () => castStringIntMap(<dynamic, dynamic>{"a": 1}), isCastError);
+    Expect.throws(() => castStringIntMap(new HashMap()), isCastError);
+    Expect.equals(1, castStringIntMap(<String, int>{"a": 1}).length);
+  }
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+
+// Test that the bulk element copies used by growable and fixed-length lists
+// keep the elements (and the objects they refer to) intact, including lists
+// large enough to live in old space.
+
+import "package:expect/expect.dart";
+
+class Box {
+  final int value;
+  Box(this.value);
+}
+
+List<Box> boxes(int start, int count) =>
+    new List<Box>.generate(count, (i) => new Box(start + i));
+
+void expectValues(List<int> expected, List<Box> actual) {
+  Expect.listEquals(expected, actual.map((b) => b.value).toList());
+}
+
+void churn() {
+  // Allocate enough to trigger scavenges, which must not lose new objects
+  // stored into old lists by the bulk copies.
+  var list = [];
+  for (int i = 0; i < 100000; i++) {
+    list.add(new Box(i));
+    if (list.length > 1000) list = [];
+  }
+}
+
+void test(int size) {
+  final list = <Box>[];
+  list.addAll(boxes(0, size));
+  churn();
+  final expected = new List<int>.generate(size, (i) => i);
+  expectValues(expected, list);
+
+  list.insertAll(size ~/ 2, boxes(-3, 3));
+  expected.insertAll(size ~/ 2, [-3, -2, -1]);
+  churn();
+  expectValues(expected, list);
+
+  list.insert(1, new Box(-10));
+  expected.insert(1, -10);
+  list.removeAt(0);
+  expected.removeAt(0);
+  list.removeRange(2, size ~/ 3);
+  expected.removeRange(2, size ~/ 3);
+  churn();
+  expectValues(expected, list);
+
+  // Overlapping ranges in both directions.
+  list.setRange(1, list.length, list);
+  expected.setRange(1, expected.length, expected);
+  list.setRange(0, list.length - 1, list, 1);
+  expected.setRange(0, expected.length - 1, expected, 1);
+  expectValues(expected, list);
+
+  // Copies from fixed-length and immutable lists.
+  final fixed = new List<Box>.from(boxes(100, 5), growable: false);
+  list.setRange(0, 5, fixed);
+  expected.setRange(0, 5, [100, 101, 102, 103, 104]);
+  list.setRange(5, 7, const <Box>[null, null]);
+  expected.setRange(5, 7, [null, null]);
+  fixed.setRange(0, 3, list, 2);
+  expectValues([102, 103, 104, 103, 104], fixed);
+  churn();
+  Expect.equals(102, fixed[0].value);
+  Expect.isNull(list[5]);
+  Expect.isNull(list[6]);
+  list[5] = new Box(expected[5] = 5);
+  list[6] = new Box(expected[6] = 6);
+  expectValues(expected, list);
+  expectValues(expected.sublist(3, 9), list.sublist(3, 9));
+
+  Expect.throws(() => list.setRange(0, 3, fixed, 3));
+  Expect.throws(() => list.setRange(0, 1, fixed, -1));
+}
+
+main() {
+  for (int i = 0; i < 20; i++) {
+    test(100);
+  }
+  // Backing arrays of this size are allocated in old space.
+  test(300000);
+}
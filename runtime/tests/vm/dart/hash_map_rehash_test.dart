@@ -0,0 +1,61 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that growing and compacting a LinkedHashMap, which reuses the hash
+// bits kept in its index instead of calling hashCode, keeps all keys
+// reachable and in insertion order.
+
+import "package:expect/expect.dart";
+
+int hashCodeCalls = 0;
+
+class Key {
+  final int id;
+  final int hash;
+  Key(this.id, this.hash);
+
+  int get hashCode {
+    hashCodeCalls++;
+    return hash;
+  }
+
+  bool operator ==(other) => other is Key && other.id == id;
+}
+
+void check(Map<Key, int> map, List<Key> keys) {
+  Expect.equals(keys.length, map.length);
+  Expect.listEquals(keys, map.keys.toList());
+  for (final key in keys) {
+    Expect.equals(key.id, map[new Key(key.id, key.hash)]);
+  }
+}
+
+main() {
+  const int count = 5000;
+  final hashes = <int>[0, 1, 2, 3, 0x3fffffff, 0x7fffffff, 0xffffffff];
+  final keys = <Key>[];
+  final map = <Key, int>{};
+  for (int i = 0; i < count; i++) {
+    final hash = i < hashes.length ? hashes[i] : (i * 0x9e3779b1) & 0xffffffff;
+    final key = new Key(i, hash);
+    keys.add(key);
+    map[key] = i;
+  }
+  // Growing to [count] entries reinserts about [count] keys in total, but
+  // their hashes are recovered from the index.
+  Expect.isTrue(hashCodeCalls < 2 * count, "$hashCodeCalls");
+  check(map, keys);
+
+  // Remove enough keys that filling the map compacts it in place.
+  for (int i = 0; i < count; i++) {
+    if (i % 8 != 0) Expect.equals(i, map.remove(keys[i]));
+  }
+  keys.removeWhere((key) => key.id % 8 != 0);
+  for (int i = count; i < 2 * count; i++) {
+    final key = new Key(i, i);
+    keys.add(key);
+    map[key] = i;
+  }
+  check(map, keys);
+}
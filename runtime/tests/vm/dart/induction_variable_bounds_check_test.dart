@@ -0,0 +1,68 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --enable-inlining-annotations --optimization-counter-threshold=10
+
+// Test that bounds checks generalized through induction variables with
+// non-unit steps, offsets and multiple indexed arrays still produce range
+// errors when the iteration space is out of bounds.
+
+import 'dart:typed_data';
+
+import "package:expect/expect.dart";
+
+const NeverInline = 'NeverInline';
+
+@NeverInline
+int sumStrided(List<int> a, int start, int n) {
+  int s = 0;
+  for (int i = start; i < n; i += 2) {
+    s += a[i];
+  }
+  return s;
+}
+
+@NeverInline
+int sumPairs(List<int> a, int n) {
+  int s = 0;
+  for (int i = 0; i < n; i += 2) {
+    s += a[i] * a[i + 1];
+  }
+  return s;
+}
+
+@NeverInline
+void addInto(Int32List dst, Int32List a, Int32List b, int n) {
+  for (int i = 0, j = 1; i < n; i += 3, j += 3) {
+    dst[i] = a[i] + b[j];
+  }
+}
+
+void main() {
+  final list = new List<int>.generate(16, (i) => i);
+  final a = new Int32List.fromList(list);
+  final b = new Int32List.fromList(list);
+  final dst = new Int32List(16);
+
+  for (int k = 0; k < 50; k++) {
+    Expect.equals(56, sumStrided(list, 0, 16));
+    Expect.equals(64, sumStrided(list, 1, 16));
+    Expect.equals(616, sumPairs(list, 16));
+    addInto(dst, a, b, 15);
+    for (int i = 0; i < 15; i += 3) {
+      Expect.equals(2 * i + 1, dst[i]);
+    }
+  }
+
+  Expect.throws(() => sumStrided(list, 0, 17), (e) => e is RangeError);
+  Expect.throws(() => sumStrided(list, -2, 16), (e) => e is RangeError);
+  Expect.throws(() => sumPairs(list, 17), (e) => e is RangeError);
+  Expect.throws(() => addInto(dst, a, b, 16), (e) => e is RangeError);
+
+  // Loops still work after deoptimizing on the generalized checks.
+  for (int k = 0; k < 50; k++) {
+    Expect.equals(56, sumStrided(list, 0, 16));
+    Expect.equals(616, sumPairs(list, 16));
+  }
+}
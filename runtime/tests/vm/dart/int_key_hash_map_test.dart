@@ -0,0 +1,45 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that int-keyed maps and sets, which compare int keys by identity,
+// still find keys through equal doubles and large ints.
+
+import "dart:collection";
+
+import "package:expect/expect.dart";
+
+class IntLike {
+  final int value;
+  IntLike(this.value);
+  int get hashCode => value.hashCode;
+  bool operator ==(other) => other == value;
+}
+
+main() {
+  final map = new Map<int, String>();
+  final set = new LinkedHashSet<int>();
+  final keys = <int>[0, 1, -1, 1 << 40, (1 << 62) + 3, -(1 << 62)];
+  for (int i = 0; i < 1000; i++) keys.add(i * 7919);
+  for (final key in keys) {
+    map[key] = "$key";
+    set.add(key);
+  }
+  for (final key in keys) {
+    // Compute a fresh, possibly boxed, copy of the key.
+    final copy = int.parse("$key");
+    Expect.equals("$key", map[copy]);
+    Expect.isTrue(set.contains(copy));
+  }
+  Expect.equals("1", map[1.0]);
+  Expect.isTrue(set.contains(1.0));
+  Expect.isFalse(set.contains(1.5));
+  Expect.equals("7919", map[new IntLike(7919)]);
+  Expect.isTrue(set.contains(new IntLike(1 << 40)));
+  Expect.listEquals(keys, map.keys.toList());
+  Expect.listEquals(keys, set.toSet().toList());
+  Expect.equals("0", map.remove(0));
+  Expect.isTrue(set.remove(-1));
+  Expect.isFalse(map.containsKey(0));
+  Expect.isFalse(set.contains(-1));
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that --jit-cache writes an app-jit snapshot of a kernel file on the
+// first successful run, reuses it on later runs with the same flags, and
+// keeps separate entries for different flags.
+
+import 'dart:io';
+
+import 'package:expect/expect.dart';
+import 'package:path/path.dart' as p;
+
+int fib(int n) {
+  if (n <= 1) return 1;
+  return fib(n - 1) + fib(n - 2);
+}
+
+String run(String cacheDir, List<String> flags, List<String> args,
+    {int expectedExitCode: 0}) {
+  final arguments = <String>[]
+    ..addAll(Platform.executableArguments)
+    ..addAll(flags)
+    ..add('--jit-cache=$cacheDir')
+    ..add(Platform.script.toFilePath())
+    ..addAll(args);
+  final result = Process.runSync(Platform.executable, arguments);
+  Expect.equals(expectedExitCode, result.exitCode,
+      '${Platform.executable} ${arguments.join(' ')}:\n${result.stderr}');
+  return result.stdout.trim();
+}
+
+List<File> entries(Directory cache) {
+  final files = cache.listSync().map((entity) => entity as File).toList();
+  // No temporary file is left behind.
+  for (final file in files) {
+    Expect.isTrue(file.path.endsWith('.jit'), file.path);
+  }
+  return files;
+}
+
+main(List<String> args) {
+  if (args.contains('--child')) {
+    print(fib(25));
+    if (args.contains('--fail')) exit(1);
+    return;
+  }
+  // Only kernel files are cached.
+  if (!Platform.script.path.endsWith('.dill')) return;
+
+  final temp = Directory.systemTemp.createTempSync('jit-cache');
+  try {
+    final cache = new Directory(p.join(temp.path, 'cache'))..createSync();
+
+    // A failed run leaves no entry.
+    Expect.equals('121393', run(cache.path, [], ['--child', '--fail'],
+        expectedExitCode: 1));
+    Expect.equals(0, entries(cache).length);
+
+    // The first successful run populates the cache.
+    Expect.equals('121393', run(cache.path, [], ['--child']));
+    Expect.equals(1, entries(cache).length);
+    final entry = entries(cache).single;
+
+    // Later runs load the entry instead of writing it again.
+    final old = new DateTime.now().subtract(const Duration(hours: 1));
+    entry.setLastModifiedSync(old);
+    Expect.equals('121393', run(cache.path, [], ['--child']));
+    Expect.equals(1, entries(cache).length);
+    Expect.equals(old.millisecondsSinceEpoch ~/ 1000,
+        entry.lastModifiedSync().millisecondsSinceEpoch ~/ 1000);
+
+    // Different VM flags get their own entry.
+    Expect.equals('121393',
+        run(cache.path, ['--no-background-compilation'], ['--child']));
+    Expect.equals(2, entries(cache).length);
+  } finally {
+    temp.deleteSync(recursive: true);
+  }
+}
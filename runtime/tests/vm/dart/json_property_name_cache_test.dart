@@ -0,0 +1,31 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that the JSON decoders share repeated property names without mixing
+// up names that hash to the same cache entry.
+
+import "dart:convert";
+
+import "package:expect/expect.dart";
+
+const String text = '[{"abc": 1, "aXc": 2, "name": "abc", "\\u0061bc": 3},'
+    ' {"abc": 4, "aXc": 5, "name": "aXc", "\\u00e6": 6, "\\u00e6": 7}]';
+
+void check(List objects) {
+  Map first = objects[0];
+  Map second = objects[1];
+  Expect.listEquals(["abc", "aXc", "name"], first.keys.toList());
+  Expect.equals(3, first["abc"]);
+  Expect.equals(2, first["aXc"]);
+  Expect.equals("abc", first["name"]);
+  Expect.equals(4, second["abc"]);
+  Expect.equals(5, second["aXc"]);
+  Expect.equals(7, second["æ"]);
+  Expect.isTrue(identical(first.keys.elementAt(2), second.keys.elementAt(2)));
+}
+
+main() {
+  check(json.decode(text));
+  check(utf8.decoder.fuse(json.decoder).convert(utf8.encode(text)));
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that the JSON UTF-8 decoder, which parses doubles in place from byte
+// arrays, agrees with double.parse, also for views and for numbers split
+// across chunks.
+
+import 'dart:convert';
+import 'dart:typed_data';
+
+import 'package:expect/expect.dart';
+
+const doubles = const <String>[
+  "0.0",
+  "-0.0",
+  "1.5",
+  "-2.25",
+  "1e10",
+  "1E-10",
+  "-1.7976931348623157e308",
+  "4.9e-324",
+  "2.2250738585072014e-308",
+  "0.1000000000000000055511151231257827",
+  "123456789012345678901234567890.5",
+  "1e400",
+  "-1e400",
+  "1e-400",
+];
+
+final decoder = utf8.decoder.fuse(json.decoder);
+
+void check(String text, Object decoded) {
+  final expected = double.parse(text);
+  Expect.isTrue(decoded is double, text);
+  Expect.equals(expected, decoded, text);
+  Expect.equals(expected.isNegative, (decoded as double).isNegative, text);
+}
+
+Uint8List bytesOf(String text) => new Uint8List.fromList(utf8.encode(text));
+
+void testWhole() {
+  for (final text in doubles) {
+    check(text, decoder.convert(bytesOf(text)));
+    // Inside a larger document, so that the number is a range of the bytes.
+    final list = decoder.convert(bytesOf('[1, $text, "x"]')) as List;
+    check(text, list[1]);
+  }
+}
+
+void testView() {
+  for (final text in doubles) {
+    final bytes = bytesOf('  [$text]  ');
+    final view = new Uint8List.view(bytes.buffer, 2, bytes.length - 4);
+    check(text, (decoder.convert(view) as List).single);
+  }
+}
+
+void testChunks() {
+  for (final text in doubles) {
+    final bytes = bytesOf('[$text]');
+    for (int split = 1; split < bytes.length; split++) {
+      Object result;
+      final sink = decoder.startChunkedConversion(
+          new ChunkedConversionSink.withCallback((values) {
+        result = values.single;
+      }));
+      sink.add(bytes.sublist(0, split));
+      sink.add(bytes.sublist(split));
+      sink.close();
+      check(text, (result as List).single);
+    }
+  }
+}
+
+void main() {
+  testWhole();
+  testView();
+  testChunks();
+}
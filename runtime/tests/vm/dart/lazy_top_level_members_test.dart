@@ -0,0 +1,40 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--lazy-top-level-members
+// VMOptions=--no-lazy-top-level-members
+
+// Test that top level members that are loaded when they are first looked up
+// behave like eagerly loaded ones.
+
+import "package:expect/expect.dart";
+
+int counter = 0;
+final String greeting = "hello";
+const int answer = 42;
+
+int get doubledCounter => counter * 2;
+set doubledCounter(int value) => counter = value ~/ 2;
+
+int increment([int by = 1]) => counter += by;
+
+String describe(int value, {String unit: "items"}) => "$value $unit";
+
+// A constant tear-off refers to the top level function from the constant
+// table.
+const incrementTearOff = increment;
+
+main() {
+  Expect.equals(0, counter);
+  Expect.equals(1, increment());
+  Expect.equals(3, incrementTearOff(2));
+  Expect.equals(6, doubledCounter);
+  doubledCounter = 20;
+  Expect.equals(10, counter);
+  Expect.equals("hello", greeting);
+  Expect.equals(42, answer);
+  Expect.equals("3 items", describe(3));
+  Expect.equals("5 apples", describe(5, unit: "apples"));
+  Expect.identical(increment, incrementTearOff);
+}
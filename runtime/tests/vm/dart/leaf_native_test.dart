@@ -0,0 +1,31 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+
+// Test that clock natives called as leaf runtime entries from optimized code
+// still return monotonic values.
+
+import "package:expect/expect.dart";
+
+int ticks(Stopwatch watch, int n) {
+  int last = 0;
+  for (int i = 0; i < n; i++) {
+    final int now = watch.elapsedTicks;
+    Expect.isTrue(now >= last);
+    last = now;
+  }
+  return last;
+}
+
+main() {
+  final watch = new Stopwatch()..start();
+  int last = 0;
+  for (int i = 0; i < 50; i++) {
+    final int now = ticks(watch, 100);
+    Expect.isTrue(now >= last);
+    last = now;
+  }
+  Expect.isTrue(new Stopwatch().frequency > 0);
+}
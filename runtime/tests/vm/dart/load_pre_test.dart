@@ -0,0 +1,89 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --enable-inlining-annotations --optimization-counter-threshold=10
+// VMOptions=--no-background-compilation --enable-inlining-annotations --optimization-counter-threshold=10 --no-load-pre
+
+// Test that loads made fully redundant by inserting them on paths where they
+// were not available observe the right values.
+
+import "package:expect/expect.dart";
+
+const NeverInline = 'NeverInline';
+
+class Node {
+  var tag;
+  var value;
+  var next;
+  Node(this.tag, this.value, this.next);
+}
+
+@NeverInline
+void clobber(Node n) {
+  n.value = -1;
+}
+
+@NeverInline
+int partiallyRedundant(Node n, bool cond) {
+  var tag = n.tag;
+  var sum = 0;
+  if (cond) {
+    sum += n.value;
+  }
+  // n.value is available only when cond is true.
+  return sum + n.value + tag;
+}
+
+@NeverInline
+int killedOnOnePath(Node n, bool cond, bool kill) {
+  var tag = n.tag;
+  var sum = 0;
+  if (cond) {
+    sum += n.value;
+    if (kill) clobber(n);
+  } else {
+    sum -= tag;
+  }
+  return sum + n.value;
+}
+
+@NeverInline
+int differentObjects(Node a, Node b, bool cond) {
+  var n = cond ? a : b;
+  var sum = a.tag + b.tag;
+  if (cond) {
+    sum += a.value;
+  }
+  return sum + n.value;
+}
+
+@NeverInline
+int nullablePath(Node n, bool cond) {
+  var sum = 0;
+  if (n != null) {
+    sum += n.value;
+  }
+  if (cond) {
+    sum++;
+  }
+  return n == null ? sum : sum + n.value;
+}
+
+void main() {
+  final a = new Node(1, 10, null);
+  final b = new Node(2, 20, a);
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(21, partiallyRedundant(a, true));
+    Expect.equals(11, partiallyRedundant(a, false));
+    Expect.equals(20, killedOnOnePath(a, true, false));
+    Expect.equals(9, killedOnOnePath(a, false, false));
+    Expect.equals(23, differentObjects(a, b, true));
+    Expect.equals(23, differentObjects(a, b, false));
+    Expect.equals(21, nullablePath(a, true));
+    Expect.equals(0, nullablePath(null, false));
+  }
+
+  Expect.equals(9, killedOnOnePath(a, true, true));
+  Expect.equals(-1, a.value);
+}
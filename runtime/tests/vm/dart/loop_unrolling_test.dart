@@ -0,0 +1,59 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --enable-inlining-annotations --loop-unrolling
+// VMOptions=--no-background-compilation --enable-inlining-annotations
+
+// Test that unrolled loops over typed data produce the same results and
+// leave the loop with the right values for both even and odd trip counts.
+
+import 'dart:typed_data';
+
+import "package:expect/expect.dart";
+
+const NeverInline = 'NeverInline';
+
+@NeverInline
+int copy(Uint8List dst, Uint8List src, int n) {
+  int i = 0;
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+  return i;
+}
+
+@NeverInline
+double sum(Float64List a) {
+  double s = 0.0;
+  for (int i = 0; i < a.length; i++) {
+    s += a[i];
+  }
+  return s;
+}
+
+void check(int length) {
+  final src = new Uint8List(length);
+  final dst = new Uint8List(length);
+  final a = new Float64List(length);
+  for (int i = 0; i < length; i++) {
+    src[i] = i & 0xff;
+    a[i] = i.toDouble();
+  }
+  Expect.equals(length, copy(dst, src, length));
+  for (int i = 0; i < length; i++) {
+    Expect.equals(src[i], dst[i]);
+  }
+  Expect.equals(length * (length - 1) / 2, sum(a));
+}
+
+main() {
+  for (int i = 0; i < 2000; i++) {
+    check(i % 7);
+  }
+  for (int length = 0; length < 20; length++) {
+    check(length);
+  }
+  // Out of range copy must still throw after the loop was optimized.
+  Expect.throws(() => copy(new Uint8List(3), new Uint8List(3), 4));
+}
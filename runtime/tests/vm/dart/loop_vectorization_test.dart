@@ -0,0 +1,82 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --enable-inlining-annotations --loop-vectorization
+// VMOptions=--no-background-compilation --enable-inlining-annotations
+
+// Test that vectorized loops over typed data compute the same results as
+// scalar loops, including the scalar epilogue, aliasing arrays, rounding of
+// single precision results and 32-bit wrap-around.
+
+import 'dart:typed_data';
+
+import "package:expect/expect.dart";
+
+const NeverInline = 'NeverInline';
+
+@NeverInline
+void addFloat32(Float32List d, Float32List a, Float32List b) {
+  for (int i = 0; i < d.length; i++) {
+    d[i] = a[i] + b[i];
+  }
+}
+
+@NeverInline
+void mulFloat64(Float64List d, Float64List a, Float64List b) {
+  for (int i = 0; i < d.length; i++) {
+    d[i] = a[i] * b[i];
+  }
+}
+
+@NeverInline
+void mixInt32(Int32List d, Int32List a, Int32List b, int from) {
+  for (int i = from; i < d.length; i++) {
+    d[i] = (a[i] + b[i]) ^ a[i];
+  }
+}
+
+void check(int length) {
+  final fa = new Float32List(length);
+  final fb = new Float32List(length);
+  final fd = new Float32List(length);
+  final da = new Float64List(length);
+  final dd = new Float64List(length);
+  final ia = new Int32List(length);
+  final ib = new Int32List(length);
+  final id = new Int32List(length);
+  for (int i = 0; i < length; i++) {
+    fa[i] = 1.0 / (i + 3);
+    fb[i] = i * 0.1;
+    da[i] = i * 0.3;
+    ia[i] = 0x7ffffff0 + i;
+    ib[i] = i * 0x1000001;
+  }
+
+  addFloat32(fd, fa, fb);
+  mulFloat64(dd, da, da);
+  mixInt32(id, ia, ib, 1);
+  for (int i = 0; i < length; i++) {
+    final sum = new Float32List(1)..[0] = fa[i] + fb[i];
+    Expect.equals(sum[0], fd[i]);
+    Expect.equals(da[i] * da[i], dd[i]);
+    final mixed = new Int32List(1)..[0] = (ia[i] + ib[i]) ^ ia[i];
+    Expect.equals(i == 0 ? 0 : mixed[0], id[i]);
+  }
+
+  // Destination aliasing a source.
+  final before = new Float32List.fromList(fa);
+  addFloat32(fa, fa, fa);
+  for (int i = 0; i < length; i++) {
+    Expect.equals(before[i] * 2, fa[i]);
+  }
+}
+
+main() {
+  for (int i = 0; i < 2000; i++) {
+    check(i % 11);
+  }
+  for (int length = 0; length < 40; length++) {
+    check(length);
+  }
+}
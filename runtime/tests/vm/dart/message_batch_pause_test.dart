@@ -0,0 +1,65 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--message-batch-size=64
+// VMOptions=--message-batch-size=1
+
+// Test that pausing the isolate while it handles a burst of queued messages
+// holds back the rest of the burst until the isolate is resumed, even when
+// those messages would otherwise be delivered in the same batch.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import "package:expect/expect.dart";
+
+const int kCount = 100;
+const int kPauseAt = 10;
+const int kPauseMillis = 200;
+
+// Resumes the paused main isolate some time after receiving
+// [control port, pause capability, resume capability].
+void resumer(SendPort replyPort) {
+  final port = new ReceivePort();
+  replyPort.send(port.sendPort);
+  port.listen((args) {
+    port.close();
+    final isolate = new Isolate(args[0], pauseCapability: args[1]);
+    new Timer(const Duration(milliseconds: kPauseMillis), () {
+      isolate.resume(args[2]);
+    });
+  });
+}
+
+main() async {
+  final handshake = new ReceivePort();
+  await Isolate.spawn(resumer, handshake.sendPort);
+  final SendPort resumerPort = await handshake.first;
+
+  final port = new ReceivePort();
+  final stopwatch = new Stopwatch();
+  int expected = 0;
+  port.listen((message) {
+    Expect.equals(expected, message);
+    if (message == kPauseAt) {
+      final self = Isolate.current;
+      final resumeCapability = self.pause();
+      stopwatch.start();
+      resumerPort
+          .send([self.controlPort, self.pauseCapability, resumeCapability]);
+    } else if (message == kPauseAt + 1) {
+      // Only delivered once the resumer has resumed the isolate.
+      Expect.isTrue(stopwatch.elapsedMilliseconds >= kPauseMillis ~/ 2);
+    }
+    expected++;
+    if (expected == kCount) {
+      port.close();
+    }
+  });
+
+  // All of these are queued before the first one is handled.
+  for (int i = 0; i < kCount; i++) {
+    port.sendPort.send(i);
+  }
+}
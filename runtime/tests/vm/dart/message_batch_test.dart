@@ -0,0 +1,52 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--message-batch-size=64
+// VMOptions=--message-batch-size=1
+
+// Test that messages queued up before the receiving isolate gets to run are
+// delivered in order, with microtasks running between messages, and that
+// messages for a port closed in the middle of a batch are dropped.
+
+import 'dart:async';
+import 'dart:isolate';
+
+import "package:expect/expect.dart";
+
+const int kCount = 1000;
+
+void main() {
+  final port = new ReceivePort();
+  final closed = new ReceivePort();
+  final log = <String>[];
+  int expected = 0;
+
+  port.listen((message) {
+    Expect.equals(expected, message);
+    log.add("message $message");
+    scheduleMicrotask(() => log.add("microtask $message"));
+    if (message == kCount ~/ 2) {
+      closed.close();
+    }
+    expected++;
+    if (expected == kCount) {
+      port.close();
+      scheduleMicrotask(() {
+        for (int i = 0; i < kCount; i++) {
+          Expect.equals("message $i", log[2 * i]);
+          Expect.equals("microtask $i", log[2 * i + 1]);
+        }
+      });
+    }
+  });
+  closed.listen((message) {
+    Expect.isTrue(message < kCount ~/ 2);
+  });
+
+  // All of these are queued before the first one is handled.
+  for (int i = 0; i < kCount; i++) {
+    port.sendPort.send(i);
+    closed.sendPort.send(i);
+  }
+}
@@ -0,0 +1,31 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=100 --no-background-compilation
+// VMOptions=--optimization-counter-threshold=100 --no-cache-osr-code
+// VMOptions=--optimization-counter-threshold=100
+
+// Test that loops entered through OSR again, possibly with inputs that
+// deoptimize earlier OSR code, compute the right results.
+
+import "package:expect/expect.dart";
+
+sumLoop(List values, int repeat) {
+  var sum = 0;
+  for (int r = 0; r < repeat; r++) {
+    for (int i = 0; i < values.length; i++) {
+      sum += values[i];
+    }
+  }
+  return sum;
+}
+
+main() {
+  final ints = new List<int>.generate(100, (i) => i);
+  final doubles = new List<double>.generate(100, (i) => i + 0.5);
+  for (int i = 0; i < 5; i++) {
+    Expect.equals(4950 * 20, sumLoop(ints, 20));
+    Expect.equals(5000.0 * 20, sumLoop(doubles, 20));
+  }
+}
@@ -0,0 +1,84 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --enable-inlining-annotations --optimization-counter-threshold=10
+// VMOptions=--no-background-compilation --enable-inlining-annotations --optimization-counter-threshold=10 --no-partial-escape-analysis
+
+// Test that objects which escape only on rare paths are materialized with
+// the right field values and identity at the point where they escape.
+
+import "package:expect/expect.dart";
+
+const NeverInline = 'NeverInline';
+
+class Point {
+  var x;
+  var y;
+  Point(this.x, this.y);
+}
+
+final escaped = <Point>[];
+
+@NeverInline
+void escape(Point p) {
+  escaped.add(p);
+}
+
+@NeverInline
+int sumOrEscape(int x, int y, bool slow) {
+  final p = new Point(x, y);
+  if (slow) {
+    escape(p);
+    // Mutations after the escape must be visible through the escaped object.
+    p.x = p.x + 100;
+    escape(p);
+  }
+  p.y = p.y + 1;
+  return p.x + p.y;
+}
+
+@NeverInline
+Point returnOnSlowPath(int x, bool slow) {
+  final p = new Point(x, x);
+  p.x = x * 2;
+  if (slow) {
+    return p;
+  }
+  return null;
+}
+
+@NeverInline
+int loopWithEscape(int n, int escapeAt) {
+  int sum = 0;
+  for (int i = 0; i < n; i++) {
+    final p = new Point(i, i + 1);
+    if (i == escapeAt) {
+      escape(p);
+    }
+    sum += p.x * p.y;
+  }
+  return sum;
+}
+
+void main() {
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(2 * i + 2, sumOrEscape(i, i + 1, false));
+    Expect.equals(i * 2, returnOnSlowPath(i, true).x);
+    Expect.isNull(returnOnSlowPath(i, false));
+    Expect.equals(330, loopWithEscape(10, -1));
+  }
+
+  escaped.clear();
+  Expect.equals(110, sumOrEscape(3, 6, true));
+  Expect.equals(2, escaped.length);
+  Expect.identical(escaped[0], escaped[1]);
+  Expect.equals(103, escaped[0].x);
+  Expect.equals(7, escaped[0].y);
+
+  escaped.clear();
+  Expect.equals(330, loopWithEscape(10, 4));
+  Expect.equals(1, escaped.length);
+  Expect.equals(4, escaped[0].x);
+  Expect.equals(5, escaped[0].y);
+}
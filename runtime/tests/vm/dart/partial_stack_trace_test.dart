@@ -0,0 +1,63 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+
+// Test that exceptions thrown to a handler that does not use the stack trace
+// still report the full stack trace when the handler passes them on.
+
+import "package:expect/expect.dart";
+
+const neverInline = "NeverInline";
+
+class Special implements Exception {}
+
+@neverInline
+void thrower(int depth) {
+  if (depth == 0) throw new FormatException("deep");
+  thrower(depth - 1);
+}
+
+@neverInline
+void typedCatch() {
+  try {
+    thrower(3);
+  } on Special {
+    Expect.fail("Unreachable");
+  }
+}
+
+@neverInline
+void explicitRethrow() {
+  try {
+    thrower(3);
+  } catch (e) {
+    rethrow;
+  }
+}
+
+@neverInline
+String catchTrace(void f()) {
+  try {
+    f();
+  } catch (e, st) {
+    Expect.isTrue(e is FormatException);
+    return st.toString();
+  }
+  Expect.fail("Unreachable");
+  return null;
+}
+
+main() {
+  for (int i = 0; i < 20; i++) {
+    for (final f in [typedCatch, explicitRethrow]) {
+      final trace = catchTrace(f);
+      final name = f == typedCatch ? "typedCatch" : "explicitRethrow";
+      Expect.isTrue(trace.contains("thrower"), trace);
+      Expect.isTrue(trace.contains(name), trace);
+      Expect.isTrue(trace.contains("catchTrace"), trace);
+      Expect.isTrue(trace.contains("main"), trace);
+    }
+  }
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10 --no-profile-guided-inlining
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10 --inlining-hot-call-frequency=0 --inlining-hot-budget=1000
+
+// Test that callees inlined into hot call sites by the profile guided
+// inlining heuristics compute the same results as out-of-line calls.
+
+import "package:expect/expect.dart";
+
+class Accumulator {
+  int total = 0;
+
+  // Large enough to be rejected by the static size heuristics.
+  void add(int x) {
+    if (x.isEven) {
+      total += x ~/ 2;
+    } else if (x % 3 == 0) {
+      total += x ~/ 3;
+    } else if (x % 5 == 0) {
+      total -= x ~/ 5;
+    } else if (x % 7 == 0) {
+      total -= x ~/ 7;
+    } else {
+      total += x;
+    }
+    if (total > 1000000) {
+      total = total % 1000;
+    }
+  }
+}
+
+int hotLoop(Accumulator acc, int n, bool rare) {
+  for (int i = 0; i < n; i++) {
+    acc.add(i);
+  }
+  if (rare) {
+    // Cold call site.
+    acc.add(n);
+  }
+  return acc.total;
+}
+
+int expected(int n, bool rare) {
+  int total = 0;
+  void add(int x) {
+    if (x.isEven) {
+      total += x ~/ 2;
+    } else if (x % 3 == 0) {
+      total += x ~/ 3;
+    } else if (x % 5 == 0) {
+      total -= x ~/ 5;
+    } else if (x % 7 == 0) {
+      total -= x ~/ 7;
+    } else {
+      total += x;
+    }
+    if (total > 1000000) {
+      total = total % 1000;
+    }
+  }
+
+  for (int i = 0; i < n; i++) {
+    add(i);
+  }
+  if (rare) add(n);
+  return total;
+}
+
+void main() {
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(expected(50, false), hotLoop(new Accumulator(), 50, false));
+  }
+  Expect.equals(expected(50, true), hotLoop(new Accumulator(), 50, true));
+  Expect.equals(expected(51, true), hotLoop(new Accumulator(), 51, true));
+}
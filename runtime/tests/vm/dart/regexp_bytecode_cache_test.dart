@@ -0,0 +1,46 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--interpret_irregexp
+// VMOptions=--interpret_irregexp --regexp_bytecode_cache_size=0
+
+// Test that isolates sharing compiled regexp bytecode through the
+// process-wide cache get the same results as compiling it themselves.
+
+import "dart:isolate";
+import "package:expect/expect.dart";
+
+List<String> matches() {
+  final results = <String>[];
+  // Same pattern with different flags must not share bytecode.
+  for (final re in [
+    new RegExp(r"(\w+)@(\w+)\.com"),
+    new RegExp(r"(\w+)@(\w+)\.com", caseSensitive: false),
+    new RegExp(r"^(\w+)@(\w+)\.com$", multiLine: true),
+  ]) {
+    for (final subject in ["bob@x.com", "BOB@X.COM\ny", "bš@x.com"]) {
+      final match = re.firstMatch(subject);
+      results.add(match == null ? "-" : "${match[1]}/${match[2]}");
+    }
+  }
+  return results;
+}
+
+void child(SendPort port) {
+  port.send(matches());
+}
+
+main() async {
+  final expected = matches();
+  Expect.listEquals([
+    "bob/x", "-", "-", //
+    "bob/x", "BOB/X", "-", //
+    "bob/x", "-", "-", //
+  ], expected);
+  for (int i = 0; i < 4; i++) {
+    final port = new ReceivePort();
+    await Isolate.spawn(child, port.sendPort);
+    Expect.listEquals(expected, await port.first);
+  }
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--interpret_irregexp
+// VMOptions=--no_interpret_irregexp
+
+// Test that regexps which scan ahead for a required character find matches
+// at the right positions in one- and two-byte subjects.
+
+import "package:expect/expect.dart";
+
+main() {
+  final padding = "abcdefghij" * 100;
+
+  // The 'q' in the middle of the literal is the rarest required character.
+  final literal = new RegExp("seqs");
+  Expect.equals(padding.length, "${padding}seqs".indexOf(literal));
+  Expect.equals(-1, "${padding}seq".indexOf(literal));
+  Expect.equals(-1, "${padding}sqs".indexOf(literal));
+  Expect.isNull(literal.firstMatch(padding));
+
+  // Required character beyond the first position, with a character class
+  // in front of it.
+  final classThenChar = new RegExp("[xy]z");
+  Expect.equals(padding.length + 1, "${padding}zyz".indexOf(classThenChar));
+  Expect.equals(-1, "${padding}z".indexOf(classThenChar));
+
+  // The scanned character must not match characters that are only equal
+  // modulo the lookahead table size (0x161 & 0x7f == 'a').
+  final twoByte = new RegExp("xš");
+  Expect.equals(3, "xašxš".indexOf(twoByte));
+  Expect.equals(-1, "${padding}xa".indexOf(twoByte));
+  Expect.equals(-1, "xaĀ".indexOf(twoByte));
+
+  // Scanning starts from the requested start index.
+  final all = literal.allMatches("seqs--seqs--seqs").map((m) => m.start);
+  Expect.listEquals([0, 6, 12], all.toList());
+
+  // Case-insensitive patterns do not have a single required character.
+  final ignoreCase = new RegExp("seqs", caseSensitive: false);
+  Expect.equals(padding.length, "${padding}SeQs".indexOf(ignoreCase));
+}
@@ -0,0 +1,118 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+
+// Test switches with enough Smi cases to dispatch a Smi value by binary
+// search, in unoptimized and optimized code.
+
+import "package:expect/expect.dart";
+
+const seven = 7;
+
+// Negative, sparse and duplicate cases, with a default.
+String withDefault(x) {
+  switch (x) {
+    case -1000000:
+      return "-1000000";
+    case -3:
+      return "-3";
+    case 0:
+      return "0";
+    case seven:
+      return "seven";
+    case 100:
+      return "100";
+    case 7: // Equal to an earlier case, never matches.
+      return "7";
+    case 1 << 20:
+      return "1 << 20";
+    case 12345678:
+      return "12345678";
+    case 42:
+    case 43:
+      return "42 or 43";
+    default:
+      return "default";
+  }
+}
+
+// No default, and `continue` jumping between cases.
+List<int> withoutDefault(x) {
+  final result = <int>[];
+  switch (x) {
+    case 9:
+      result.add(9);
+      continue six;
+    case 8:
+      result.add(8);
+      break;
+    case -5:
+      result.add(-5);
+      continue one;
+    six:
+    case 6:
+      result.add(6);
+      continue one;
+    case 5:
+      result.add(5);
+      break;
+    case 4:
+      result.add(4);
+      break;
+    case 3:
+      result.add(3);
+      break;
+    one:
+    case 1:
+      result.add(1);
+  }
+  return result;
+}
+
+void test() {
+  Expect.equals("-1000000", withDefault(-1000000));
+  Expect.equals("-3", withDefault(-3));
+  Expect.equals("0", withDefault(0));
+  Expect.equals("seven", withDefault(7));
+  Expect.equals("100", withDefault(100));
+  Expect.equals("1 << 20", withDefault(1 << 20));
+  Expect.equals("12345678", withDefault(12345678));
+  Expect.equals("42 or 43", withDefault(42));
+  Expect.equals("42 or 43", withDefault(43));
+  // A double equal to an int case matches it through `==`.
+  Expect.equals("seven", withDefault(7.0));
+  Expect.equals("-3", withDefault(-3.0));
+  // Misses, between, below and above the cases, and values of other types.
+  Expect.equals("default", withDefault(-1000001));
+  Expect.equals("default", withDefault(-4));
+  Expect.equals("default", withDefault(1));
+  Expect.equals("default", withDefault(41));
+  Expect.equals("default", withDefault(99999999));
+  Expect.equals("default", withDefault(7.5));
+  Expect.equals("default", withDefault("7"));
+  Expect.equals("default", withDefault(null));
+
+  Expect.listEquals([9, 6, 1], withoutDefault(9));
+  Expect.listEquals([8], withoutDefault(8));
+  Expect.listEquals([-5, 1], withoutDefault(-5));
+  Expect.listEquals([6, 1], withoutDefault(6));
+  Expect.listEquals([5], withoutDefault(5));
+  Expect.listEquals([4], withoutDefault(4));
+  Expect.listEquals([3], withoutDefault(3));
+  Expect.listEquals([1], withoutDefault(1));
+  Expect.listEquals([6, 1], withoutDefault(6.0));
+  Expect.listEquals([], withoutDefault(0));
+  Expect.listEquals([], withoutDefault(2));
+  Expect.listEquals([], withoutDefault(10));
+  Expect.listEquals([], withoutDefault(-6));
+  Expect.listEquals([], withoutDefault(2.5));
+  Expect.listEquals([], withoutDefault(null));
+}
+
+void main() {
+  for (int i = 0; i < 50; i++) {
+    test();
+  }
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that StringBuffer keeps char codes in its one-byte buffer until the
+// first wide one, and grows and flushes its buffers without losing any.
+
+import "package:expect/expect.dart";
+
+void check(List<int> codes) {
+  final buffer = new StringBuffer();
+  for (int i = 0; i < codes.length; i++) {
+    buffer.writeCharCode(codes[i]);
+  }
+  final result = new String.fromCharCodes(codes);
+  Expect.equals(result.length, buffer.length);
+  Expect.equals(result, buffer.toString());
+}
+
+main() {
+  for (final length in [0, 1, 63, 64, 65, 4095, 4096, 4097, 20000]) {
+    final latin1 = new List<int>.generate(length, (i) => (i * 7) & 0xff);
+    check(latin1);
+    // A wide char code at the start, middle and end of the buffer.
+    for (final at in [0, length ~/ 2, length]) {
+      check(new List<int>.from(latin1)..insert(at, 0x20AC));
+      check(new List<int>.from(latin1)..insert(at, 0x1F600));
+    }
+  }
+
+  // Latin-1 char codes after the buffer was flushed start a new one-byte
+  // buffer.
+  final buffer = new StringBuffer()
+    ..writeCharCode(0x20AC)
+    ..write("x")
+    ..writeCharCode(0x61)
+    ..writeCharCode(0xE6);
+  Expect.equals("€xaæ", buffer.toString());
+  buffer.clear();
+  buffer.writeCharCode(0x62);
+  Expect.equals("b", buffer.toString());
+
+  Expect.throws(() => new StringBuffer().writeCharCode(-1));
+  Expect.throws(() => (new StringBuffer()..writeCharCode(0x100))
+      .writeCharCode(-1));
+  Expect.throws(() => new StringBuffer().writeCharCode(0x110000));
+}
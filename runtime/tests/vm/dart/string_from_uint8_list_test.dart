@@ -0,0 +1,43 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that String.fromCharCodes of long Uint8List ranges, which are copied
+// by the runtime, matches the element-wise result for lists and views.
+
+import "dart:typed_data";
+
+import "package:expect/expect.dart";
+
+void check(Uint8List bytes, List<int> codes) {
+  for (final start in [0, 1, 7, 33]) {
+    for (final end in [start, start + 1, start + 64, start + 65, codes.length]) {
+      if (end > codes.length) continue;
+      Expect.equals(new String.fromCharCodes(codes, start, end),
+          new String.fromCharCodes(bytes, start, end));
+    }
+  }
+  Expect.equals(
+      new String.fromCharCodes(codes), new String.fromCharCodes(bytes));
+}
+
+main() {
+  final codes = new List<int>.generate(300, (i) => (i * 37) & 0xff);
+  final bytes = new Uint8List.fromList(codes);
+  check(bytes, codes);
+
+  // A view starting in the middle of a byte list.
+  final padded = new Uint8List(codes.length + 5)..setRange(5, 305, codes);
+  check(new Uint8List.view(padded.buffer, 5), codes);
+
+  // A byte view on a buffer with wider elements.
+  final wide = new Uint16List(codes.length ~/ 2);
+  final view = new Uint8List.view(wide.buffer);
+  view.setRange(0, view.length, codes);
+  check(view, codes);
+
+  // A Uint8List that is not implemented by the VM.
+  check(new UnmodifiableUint8ListView(bytes), codes);
+
+  Expect.throws(() => new String.fromCharCodes(bytes, 10, 400));
+}
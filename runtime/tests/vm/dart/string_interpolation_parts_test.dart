@@ -0,0 +1,50 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+
+// Test that interpolations with few parts, which are compiled without an
+// intermediate array of parts, produce the same strings as longer ones.
+
+import "package:expect/expect.dart";
+
+class Part {
+  final String value;
+  final List<String> log;
+  Part(this.value, this.log);
+  String toString() {
+    log.add(value);
+    return value;
+  }
+}
+
+class NotAString {
+  toString() => 42;
+}
+
+String two(a, b) => "$a$b";
+String three(a, b, c) => "$a-$b-$c";
+String four(a, b, c, d) => "$a$b$c$d";
+
+main() {
+  final longPart = "x" * 200;
+  for (int i = 0; i < 30; i++) {
+    Expect.equals("ab", two("a", "b"));
+    Expect.equals("1-2.5-null", three(1, 2.5, null));
+    Expect.equals("abcd", four("a", "b", "c", "d"));
+    Expect.equals("aሴb", two("a", "ሴb"));
+    Expect.equals("ሴ-x-true", three("ሴ", "x", true));
+    Expect.equals("a${longPart}bc", four("a", longPart, "b", "c"));
+    Expect.equals(203, four("a", longPart, "b", "c").length);
+    Expect.equals("", four("", "", "", ""));
+
+    final log = <String>[];
+    Expect.equals("pqrs",
+        four(new Part("p", log), new Part("q", log), new Part("r", log), "s"));
+    Expect.listEquals(["p", "q", "r"], log);
+
+    Expect.throws(() => two("a", new NotAString()));
+    Expect.throws(() => three(new NotAString(), "b", "c"));
+  }
+}
@@ -0,0 +1,60 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that timers far enough in the future to be kept in the timer wheel
+// fire in order, not early, and not at all once canceled.
+
+import 'dart:async';
+
+import 'package:async_helper/async_helper.dart';
+import 'package:expect/expect.dart';
+
+const int timerCount = 2000;
+
+main() {
+  asyncStart();
+  final stopwatch = new Stopwatch()..start();
+  final fired = <int>[];
+  final timers = <Timer>[];
+  final durations = <int>[];
+  for (int i = 0; i < timerCount; i++) {
+    final duration = 300 + (i * 37) % 700;
+    durations.add(duration);
+    timers.add(new Timer(new Duration(milliseconds: duration), () {
+      Expect.isTrue(stopwatch.elapsedMilliseconds >= duration);
+      fired.add(i);
+      if (fired.length == timerCount ~/ 4) {
+        checkOrder(fired, durations);
+        asyncEnd();
+      }
+    }));
+  }
+  // Keep only every fourth timer.
+  for (int i = 0; i < timerCount; i++) {
+    if (i % 4 != 0) timers[i].cancel();
+  }
+
+  // Canceling every timer must not keep the isolate alive.
+  for (int i = 0; i < timerCount; i++) {
+    new Timer(new Duration(seconds: 60), () {
+      Expect.fail('Canceled timer fired');
+    }).cancel();
+  }
+}
+
+void checkOrder(List<int> fired, List<int> durations) {
+  for (final i in fired) {
+    Expect.equals(0, i % 4);
+  }
+  // Timers created in order with the same duration fire in order, and
+  // timers with durations far enough apart fire in order of duration.
+  for (int j = 1; j < fired.length; j++) {
+    final previous = fired[j - 1];
+    final current = fired[j];
+    if (durations[previous] == durations[current]) {
+      Expect.isTrue(previous < current);
+    }
+    Expect.isTrue(durations[previous] < durations[current] + 50);
+  }
+}
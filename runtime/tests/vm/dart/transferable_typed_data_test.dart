@@ -0,0 +1,61 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that TransferableTypedData moves its bytes to the receiving isolate
+// and leaves the sender detached.
+
+import "dart:async";
+import "dart:isolate";
+import "dart:typed_data";
+
+import "package:expect/expect.dart";
+
+const int kLength = 1024 * 1024;
+
+void echo(SendPort sendPort) {
+  final port = new ReceivePort();
+  sendPort.send(port.sendPort);
+  port.listen((message) {
+    final TransferableTypedData transferable = message;
+    final Uint8List bytes = transferable.materialize().asUint8List();
+    var sum = 0;
+    for (var i = 0; i < bytes.length; i++) {
+      sum += bytes[i];
+    }
+    sendPort.send([bytes.length, sum]);
+    port.close();
+  });
+}
+
+main() async {
+  final bytes = new Uint8List(kLength);
+  var expectedSum = 0;
+  for (var i = 0; i < bytes.length; i++) {
+    bytes[i] = i & 0xff;
+    expectedSum += i & 0xff;
+  }
+
+  // Contents are gathered from all kinds of typed data.
+  final halves = new TransferableTypedData.fromList([
+    new Uint8List.view(bytes.buffer, 0, 4),
+    new Uint16List.fromList([0x0504, 0x0706]),
+  ]);
+  Expect.listEquals(
+      [0, 1, 2, 3, 4, 5, 6, 7], halves.materialize().asUint8List());
+  Expect.throws(() => halves.materialize(), (e) => e is ArgumentError);
+
+  final port = new ReceivePort();
+  final messages = new StreamIterator(port);
+  await Isolate.spawn(echo, port.sendPort);
+  Expect.isTrue(await messages.moveNext());
+  final SendPort worker = messages.current;
+
+  final transferable = new TransferableTypedData.fromList([bytes]);
+  worker.send(transferable);
+  Expect.throws(() => transferable.materialize(), (e) => e is ArgumentError);
+
+  Expect.isTrue(await messages.moveNext());
+  Expect.listEquals([kLength, expectedSum], messages.current);
+  port.close();
+}
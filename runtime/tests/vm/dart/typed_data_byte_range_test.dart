@@ -0,0 +1,57 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test fillRange, indexOf and lastIndexOf on long ranges of one byte typed
+// lists and views, which are handled natively.
+
+import "dart:typed_data";
+import "package:expect/expect.dart";
+
+const int n = 300;
+
+testUint8(Uint8List list) {
+  list.fillRange(0, list.length, 7);
+  list.fillRange(10, 200, 300); // Truncated to 44.
+  Expect.equals(7, list[9]);
+  Expect.equals(44, list[10]);
+  Expect.equals(44, list[199]);
+  Expect.equals(7, list[200]);
+  Expect.equals(10, list.indexOf(44));
+  Expect.equals(150, list.indexOf(44, 150));
+  Expect.equals(-1, list.indexOf(44, 200));
+  Expect.equals(-1, list.indexOf(300));
+  Expect.equals(-1, list.indexOf(-1));
+  Expect.equals(-1, list.indexOf(null));
+  Expect.equals(199, list.lastIndexOf(44));
+  Expect.equals(100, list.lastIndexOf(44, 100));
+  Expect.equals(list.length - 1, list.lastIndexOf(7));
+  Expect.equals(9, list.lastIndexOf(7, 150));
+  Expect.equals(-1, list.lastIndexOf(8));
+}
+
+main() {
+  testUint8(new Uint8List(n));
+  final bytes = new Uint8List(n + 20);
+  testUint8(new Uint8List.view(bytes.buffer, 10, n));
+  Expect.equals(0, bytes[9]);
+  Expect.equals(0, bytes[n + 10]);
+
+  final int8 = new Int8List(n);
+  int8.fillRange(0, n, -1);
+  Expect.equals(-1, int8[n - 1]);
+  Expect.equals(0, int8.indexOf(-1));
+  Expect.equals(-1, int8.indexOf(255));
+  Expect.equals(n - 1, int8.lastIndexOf(-1));
+  int8.fillRange(0, n, 128); // Wraps to -128.
+  Expect.equals(-128, int8[100]);
+  Expect.equals(-1, int8.indexOf(128));
+
+  final clamped = new Uint8ClampedList(n);
+  clamped.fillRange(0, n, 1000);
+  Expect.equals(255, clamped[n - 1]);
+  clamped.fillRange(0, n, -5);
+  Expect.equals(0, clamped[0]);
+  Expect.equals(0, clamped.indexOf(0));
+  Expect.equals(-1, clamped.indexOf(-5));
+}
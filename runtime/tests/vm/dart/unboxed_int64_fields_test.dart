@@ -0,0 +1,64 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--no-background-compilation --optimization-counter-threshold=10
+// VMOptions=--no-unbox-mints
+
+// Test that int fields which only ever hold 64-bit integers outside of the
+// Smi range keep their values when stored unboxed.
+
+import "package:expect/expect.dart";
+
+const int kBase = 0x4000000000000000;
+
+class Accumulator {
+  int value = kBase;
+
+  void add(int x) {
+    value += x;
+  }
+}
+
+class Pair {
+  int first;
+  int second;
+  Pair(this.first, this.second);
+}
+
+int sum(Accumulator acc, int n) {
+  for (int i = 0; i < n; i++) {
+    acc.add(i);
+  }
+  return acc.value;
+}
+
+Pair swap(Pair p) {
+  final tmp = p.first;
+  p.first = p.second;
+  p.second = tmp;
+  return p;
+}
+
+main() {
+  final acc = new Accumulator();
+  int expected = kBase;
+  for (int n = 0; n < 50; n++) {
+    expected += n * (n - 1) ~/ 2;
+    Expect.equals(expected, sum(acc, n));
+  }
+
+  // Boxes read out of a field must not alias the field's storage.
+  final p = new Pair(kBase + 1, kBase + 2);
+  final first = p.first;
+  for (int i = 0; i < 51; i++) {
+    swap(p);
+  }
+  Expect.equals(kBase + 1, first);
+  Expect.equals(kBase + 2, p.first);
+  Expect.equals(kBase + 1, p.second);
+
+  // Leaving the Mint range makes the field polymorphic again.
+  p.first = 1;
+  Expect.equals(1, swap(p).second);
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test percent-decoding of one byte strings, which the VM does natively, and
+// the inputs the native decoder leaves to the generic Dart code.
+
+import "dart:convert";
+
+import "package:expect/expect.dart";
+
+void testDecoded() {
+  Expect.equals("", Uri.decodeComponent(""));
+  Expect.equals("abc", Uri.decodeComponent("abc"));
+  Expect.equals("a b", Uri.decodeComponent("a%20b"));
+  Expect.equals("a+b", Uri.decodeComponent("a+b"));
+  Expect.equals("a b", Uri.decodeQueryComponent("a+b"));
+  Expect.equals("a+b", Uri.decodeQueryComponent("a%2Bb"));
+  Expect.equals("/?#[]", Uri.decodeComponent("%2F%3f%23%5B%5d"));
+  Expect.equals("%", Uri.decodeComponent("%25"));
+  Expect.equals("%41", Uri.decodeComponent("%2541"));
+  Expect.equals("\x00\x7f", Uri.decodeComponent("%00%7F"));
+
+  final long = "x%41y+" * 1000;
+  Expect.equals("xAy+" * 1000, Uri.decodeComponent(long));
+  Expect.equals("xAy " * 1000, Uri.decodeQueryComponent(long));
+}
+
+void testComponents() {
+  // The getters decode substrings of the URI text.
+  final uri = Uri.parse("http://host/a%20b/c%2Fd?x=1+2&y=%41%42#frag%21");
+  Expect.listEquals(["a b", "c/d"], uri.pathSegments);
+  Expect.equals("1 2", uri.queryParameters["x"]);
+  Expect.equals("AB", uri.queryParameters["y"]);
+  Expect.equals("frag!", Uri.decodeComponent(uri.fragment));
+  Expect.equals("http://host/a b/c/d?x=1+2&y=AB#frag!",
+      Uri.decodeFull(uri.toString()));
+}
+
+void testNonAscii() {
+  // Non-ASCII bytes are decoded as UTF-8 by the generic code.
+  Expect.equals("é", Uri.decodeComponent("%C3%A9"));
+  Expect.equals("a€b", Uri.decodeComponent("a%E2%82%ACb"));
+  // Latin-1 is decoded natively.
+  Expect.equals("é ÿ", Uri.decodeQueryComponent("%E9+%FF", encoding: latin1));
+  Expect.equals("é", Uri.decodeQueryComponent("%e9", encoding: latin1));
+  Expect.throwsFormatException(
+      () => Uri.decodeQueryComponent("%E9", encoding: ascii));
+}
+
+void testInvalid() {
+  Expect.throwsArgumentError(() => Uri.decodeComponent("%"));
+  Expect.throwsArgumentError(() => Uri.decodeComponent("a%4"));
+  Expect.throwsArgumentError(() => Uri.decodeComponent("%4G"));
+  Expect.throwsArgumentError(() => Uri.decodeComponent("%G4"));
+  // An unencoded non-ASCII character in a one byte string.
+  Expect.throwsArgumentError(() => Uri.decodeComponent("aé%20"));
+  Expect.throwsFormatException(() => Uri.decodeComponent("%FF"));
+  Expect.throwsFormatException(() => Uri.decodeComponent("%C3"));
+}
+
+void testTwoByte() {
+  // Two byte strings are not decoded natively, and give the same results.
+  Expect.equals("Ā b", Uri.decodeComponent("Ā%20b"));
+  Expect.equals("Ā b", Uri.decodeQueryComponent("Ā+b"));
+}
+
+main() {
+  testDecoded();
+  testComponents();
+  testNonAscii();
+  testInvalid();
+  testTwoByte();
+}
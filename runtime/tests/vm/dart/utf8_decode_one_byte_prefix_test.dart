@@ -0,0 +1,54 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that utf8.decode of typed data, which copies leading ASCII bytes in
+// bulk, agrees with decoding the same bytes from a plain list.
+
+import "dart:convert";
+import "dart:typed_data";
+
+import "package:expect/expect.dart";
+
+String decodeList(List<int> bytes, {bool allowMalformed: false}) =>
+    new Utf8Decoder(allowMalformed: allowMalformed)
+        .convert(new List<int>.from(bytes));
+
+void check(List<int> bytes) {
+  final expected = decodeList(bytes);
+  final typed = new Uint8List.fromList(bytes);
+  Expect.equals(expected, utf8.decode(typed));
+  // Unaligned starts and a view.
+  for (int start = 0; start < 9 && start <= bytes.length; start++) {
+    Expect.equals(decodeList(bytes.sublist(start)),
+        utf8.decoder.convert(typed, start));
+  }
+  Expect.equals(expected, utf8.decode(new Uint8List.view(typed.buffer)));
+}
+
+main() {
+  final ascii = new List<int>.generate(100, (i) => 0x20 + i % 90);
+  check(<int>[]);
+  check(ascii);
+  // Multi-byte sequences at various offsets.
+  for (int i = 0; i < 40; i++) {
+    check(new List<int>.from(ascii.take(i))
+      ..addAll(<int>[0xC3, 0xA6, 0xE2, 0x82, 0xAC])
+      ..addAll(ascii));
+  }
+
+  // Only a BOM at the very start is dropped.
+  Expect.equals("a\uFEFF", utf8.decode(new Uint8List.fromList(
+      <int>[0x61, 0xEF, 0xBB, 0xBF])));
+  Expect.equals("a", utf8.decode(new Uint8List.fromList(
+      <int>[0xEF, 0xBB, 0xBF, 0x61])));
+
+  // Malformed input after an ASCII prefix reports the same offset.
+  final malformed = new Uint8List.fromList(<int>[0x61, 0x62, 0xFF, 0x63]);
+  Expect.throws(() => utf8.decode(malformed),
+      (e) => e is FormatException && e.offset == 2);
+  Expect.equals("ab\uFFFDc", utf8.decode(malformed, allowMalformed: true));
+  final unfinished = new Uint8List.fromList(<int>[0x61, 0xC3]);
+  Expect.throws(() => utf8.decode(unfinished),
+      (e) => e is FormatException && e.offset == 2);
+}
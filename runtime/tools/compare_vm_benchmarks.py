@@ -0,0 +1,81 @@
+#!/usr/bin/env python
+#
+# Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+# for details. All rights reserved. Use of this source code is governed by a
+# BSD-style license that can be found in the LICENSE file.
+
+# Compares the results of two runs of the VM benchmarks, written with
+#
+#   run_vm_tests --benchmark_repetitions=10 --benchmark_results=<file> \
+#       --benchmarks
+#
+# and exits with 1 if any benchmark regressed. A benchmark regressed if its
+# median got worse by more than --threshold percent and by more than the
+# noise of either run, i.e. --stddevs standard deviations.
+
+import json
+import optparse
+import sys
+
+
+def BuildOptions():
+  result = optparse.OptionParser(
+      usage='%prog [options] <baseline.json> <results.json>')
+  result.add_option('--threshold',
+      help='Percent a median may get worse before it is a regression.',
+      type='float', default=5.0)
+  result.add_option('--stddevs',
+      help='Standard deviations a median must move to not be noise.',
+      type='float', default=2.0)
+  return result
+
+
+def ReadResults(path):
+  with open(path) as f:
+    results = json.load(f)
+  return dict((b['name'], b) for b in results['benchmarks'])
+
+
+def Compare(baseline, current, options):
+  regressions = []
+  for name in sorted(current):
+    if name not in baseline:
+      print('%-30s new: %d' % (name, current[name]['median']))
+      continue
+    old = baseline[name]
+    new = current[name]
+    # A positive change is a change for the worse.
+    change = new['median'] - old['median']
+    if not new['lowerIsBetter']:
+      change = -change
+    if old['median'] != 0:
+      percent = 100.0 * change / abs(old['median'])
+    else:
+      percent = 0.0
+    noise = options.stddevs * max(old['stddev'], new['stddev'])
+    regressed = percent > options.threshold and change > noise
+    print('%-30s %12d -> %12d %+7.1f%%%s' % (
+        name, old['median'], new['median'], percent,
+        '  REGRESSION' if regressed else ''))
+    if regressed:
+      regressions.append(name)
+  return regressions
+
+
+def Main():
+  parser = BuildOptions()
+  (options, args) = parser.parse_args()
+  if len(args) != 2:
+    parser.print_help()
+    return 2
+  baseline = ReadResults(args[0])
+  current = ReadResults(args[1])
+  regressions = Compare(baseline, current, options)
+  if regressions:
+    print('Regressed: %s' % ', '.join(regressions))
+    return 1
+  return 0
+
+
+if __name__ == '__main__':
+  sys.exit(Main())
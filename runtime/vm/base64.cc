@@ -35,6 +35,61 @@ static const int8_t decode_table[] = {
 
 static const char PAD = '=';
 
+static const char encode_table[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char url_safe_encode_table[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+intptr_t EncodeBase64(const uint8_t* bytes,
+                      intptr_t length,
+                      char* out,
+                      bool url_safe) {
+  const char* table = url_safe ? url_safe_encode_table : encode_table;
+  char* const start = out;
+  intptr_t i = 0;
+  // Encode six bytes into eight characters per iteration. Reading all six
+  // bytes first lets the loads overlap instead of alternating with stores.
+  for (; i + 6 <= length; i += 6) {
+    const uint32_t a = (bytes[i] << 16) | (bytes[i + 1] << 8) | bytes[i + 2];
+    const uint32_t b =
+        (bytes[i + 3] << 16) | (bytes[i + 4] << 8) | bytes[i + 5];
+    out[0] = table[a >> 18];
+    out[1] = table[(a >> 12) & 63];
+    out[2] = table[(a >> 6) & 63];
+    out[3] = table[a & 63];
+    out[4] = table[b >> 18];
+    out[5] = table[(b >> 12) & 63];
+    out[6] = table[(b >> 6) & 63];
+    out[7] = table[b & 63];
+    out += 8;
+  }
+  for (; i + 3 <= length; i += 3) {
+    const uint32_t a = (bytes[i] << 16) | (bytes[i + 1] << 8) | bytes[i + 2];
+    out[0] = table[a >> 18];
+    out[1] = table[(a >> 12) & 63];
+    out[2] = table[(a >> 6) & 63];
+    out[3] = table[a & 63];
+    out += 4;
+  }
+  if (i + 1 == length) {
+    const uint32_t a = bytes[i] << 16;
+    out[0] = table[a >> 18];
+    out[1] = table[(a >> 12) & 63];
+    out[2] = PAD;
+    out[3] = PAD;
+    out += 4;
+  } else if (i + 2 == length) {
+    const uint32_t a = (bytes[i] << 16) | (bytes[i + 1] << 8);
+    out[0] = table[a >> 18];
+    out[1] = table[(a >> 12) & 63];
+    out[2] = table[(a >> 6) & 63];
+    out[3] = PAD;
+    out += 4;
+  }
+  ASSERT(out - start == Base64EncodedLength(length));
+  return out - start;
+}
+
 uint8_t* DecodeBase64(Zone* zone, const char* str, intptr_t* out_decoded_len) {
   intptr_t len = strlen(str);
   if (len == 0 || (len % 4 != 0)) {
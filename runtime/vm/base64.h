@@ -11,6 +11,19 @@ namespace dart {
 
 uint8_t* DecodeBase64(Zone* zone, const char* str, intptr_t* out_decoded_len);
 
+// Number of characters EncodeBase64 writes for length bytes.
+inline intptr_t Base64EncodedLength(intptr_t length) {
+  return ((length + 2) / 3) * 4;
+}
+
+// Writes the padded Base 64 encoding of bytes to out, which must have room
+// for Base64EncodedLength(length) characters, and returns the number of
+// characters written. The URL-safe alphabet uses '-' and '_' for 62 and 63.
+intptr_t EncodeBase64(const uint8_t* bytes,
+                      intptr_t length,
+                      char* out,
+                      bool url_safe = false);
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_BASE64_H_
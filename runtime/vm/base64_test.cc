@@ -25,6 +25,37 @@ TEST_CASE(Base64DecodeMalformed) {
          nullptr);
 }
 
+TEST_CASE(Base64EncodeRoundTrip) {
+  uint8_t bytes[256];
+  for (intptr_t i = 0; i < 256; i++) {
+    bytes[i] = 255 - i;
+  }
+  char encoded[512];
+  // Covers all tail lengths of both the six and three byte loops.
+  for (intptr_t length = 1; length < 20; length++) {
+    intptr_t encoded_len = EncodeBase64(bytes, length, encoded);
+    EXPECT_EQ(Base64EncodedLength(length), encoded_len);
+    encoded[encoded_len] = '\0';
+    intptr_t decoded_len;
+    uint8_t* decoded = DecodeBase64(thread->zone(), encoded, &decoded_len);
+    EXPECT_EQ(length, decoded_len);
+    EXPECT(!memcmp(bytes, decoded, length));
+  }
+
+  const uint8_t hello[] = "Hello, world!\n";
+  intptr_t encoded_len = EncodeBase64(hello, sizeof(hello) - 1, encoded);
+  encoded[encoded_len] = '\0';
+  EXPECT_STREQ("SGVsbG8sIHdvcmxkIQo=", encoded);
+
+  const uint8_t high[] = {0xfb, 0xff};
+  encoded_len = EncodeBase64(high, 2, encoded);
+  encoded[encoded_len] = '\0';
+  EXPECT_STREQ("+/8=", encoded);
+  encoded_len = EncodeBase64(high, 2, encoded, /*url_safe=*/true);
+  encoded[encoded_len] = '\0';
+  EXPECT_STREQ("-_8=", encoded);
+}
+
 TEST_CASE(Base64DecodeEmpty) {
   intptr_t decoded_len;
   EXPECT(DecodeBase64(thread->zone(), "", &decoded_len) == nullptr);
@@ -6,16 +6,27 @@
 
 #include "bin/builtin.h"
 #include "bin/file.h"
+#include "bin/gzip.h"
 #include "bin/isolate_data.h"
 #include "bin/process.h"
 
 #include "platform/assert.h"
 #include "platform/globals.h"
+#include "platform/text_buffer.h"
 
 #include "vm/clustered_snapshot.h"
+#include "vm/compiler/jit/compiler.h"
 #include "vm/compiler_stats.h"
 #include "vm/dart_api_impl.h"
+#include "vm/heap/scavenger.h"
 #include "vm/stack_frame.h"
+#include "vm/version.h"
+
+#if defined(HOST_OS_LINUX)
+#include <linux/perf_event.h>  // NOLINT
+#include <sys/syscall.h>       // NOLINT
+#include <unistd.h>            // NOLINT
+#endif
 
 using dart::bin::File;
 
@@ -23,6 +34,22 @@ namespace dart {
 
 DECLARE_FLAG(bool, use_dart_frontend);
 DECLARE_FLAG(bool, strong);
+DECLARE_FLAG(bool, use_huge_pages);
+#if !defined(DART_PRECOMPILED_RUNTIME)
+DECLARE_FLAG(bool, loop_unrolling);
+DECLARE_FLAG(bool, loop_vectorization);
+#endif
+
+DEFINE_FLAG(int,
+            benchmark_repetitions,
+            1,
+            "Number of times each benchmark is run. The median score is "
+            "reported.");
+DEFINE_FLAG(charp,
+            benchmark_results,
+            NULL,
+            "Write the scores and statistics of the benchmarks run as JSON "
+            "to this file, e.g. for runtime/tools/compare_vm_benchmarks.py.");
 
 Benchmark* Benchmark::first_ = NULL;
 Benchmark* Benchmark::tail_ = NULL;
@@ -91,6 +118,102 @@ void Benchmark::RunAll(const char* executable) {
     benchmark->RunBenchmark();
     benchmark = benchmark->next_;
   }
+  WriteResults();
+}
+
+static int CompareScores(const void* a, const void* b) {
+  const int64_t score_a = *reinterpret_cast<const int64_t*>(a);
+  const int64_t score_b = *reinterpret_cast<const int64_t*>(b);
+  return (score_a < score_b) ? -1 : ((score_a > score_b) ? 1 : 0);
+}
+
+void Benchmark::RunRepetitions() {
+  const intptr_t repetitions =
+      (FLAG_benchmark_repetitions < 1) ? 1 : FLAG_benchmark_repetitions;
+  delete[] scores_;
+  scores_ = new int64_t[repetitions];
+  num_scores_ = repetitions;
+  for (intptr_t i = 0; i < repetitions; i++) {
+    Run();
+    scores_[i] = score_;
+  }
+  qsort(scores_, num_scores_, sizeof(scores_[0]), CompareScores);
+  // The median is the middle score, or the lower of the middle two.
+  score_ = scores_[(num_scores_ - 1) / 2];
+}
+
+static void ComputeStatistics(const int64_t* scores,
+                              intptr_t num_scores,
+                              double* mean,
+                              double* stddev) {
+  double sum = 0.0;
+  for (intptr_t i = 0; i < num_scores; i++) {
+    sum += static_cast<double>(scores[i]);
+  }
+  *mean = sum / num_scores;
+  double squares = 0.0;
+  for (intptr_t i = 0; i < num_scores; i++) {
+    const double delta = static_cast<double>(scores[i]) - *mean;
+    squares += delta * delta;
+  }
+  // The sample standard deviation.
+  *stddev = (num_scores > 1) ? sqrt(squares / (num_scores - 1)) : 0.0;
+}
+
+void Benchmark::PrintResultJSON(JSONWriter* writer) const {
+  double mean;
+  double stddev;
+  ComputeStatistics(scores_, num_scores_, &mean, &stddev);
+  writer->OpenObject();
+  writer->PrintProperty("name", name_);
+  writer->PrintProperty("kind", score_kind_);
+  writer->PrintPropertyBool("lowerIsBetter", lower_is_better_);
+  writer->PrintProperty("repetitions", num_scores_);
+  writer->PrintProperty64("median", score_);
+  writer->PrintProperty64("min", scores_[0]);
+  writer->PrintProperty64("max", scores_[num_scores_ - 1]);
+  writer->PrintProperty("mean", mean);
+  writer->PrintProperty("stddev", stddev);
+  writer->OpenArray("scores");
+  for (intptr_t i = 0; i < num_scores_; i++) {
+    writer->PrintValue64(scores_[i]);
+  }
+  writer->CloseArray();
+  writer->CloseObject();
+}
+
+void Benchmark::WriteResults() {
+  if (FLAG_benchmark_results == NULL) {
+    return;
+  }
+  JSONWriter writer;
+  writer.OpenObject();
+  writer.PrintProperty("version", Version::String());
+  writer.OpenArray("benchmarks");
+  intptr_t num_results = 0;
+  for (Benchmark* benchmark = first_; benchmark != NULL;
+       benchmark = benchmark->next_) {
+    if (benchmark->num_scores_ > 0) {
+      benchmark->PrintResultJSON(&writer);
+      num_results++;
+    }
+  }
+  writer.CloseArray();
+  writer.CloseObject();
+  if (num_results == 0) {
+    return;
+  }
+  File* file = File::Open(NULL, FLAG_benchmark_results, File::kWriteTruncate);
+  if (file == NULL) {
+    OS::PrintErr("Could not open %s to write benchmark results\n",
+                 FLAG_benchmark_results);
+  } else {
+    if (!file->WriteFully(writer.buffer()->buf(), writer.buffer()->length())) {
+      OS::PrintErr("Could not write benchmark results to %s\n",
+                   FLAG_benchmark_results);
+    }
+    file->Release();
+  }
 }
 
 //
@@ -549,6 +672,90 @@ BENCHMARK_SIZE(StandaloneSnapshotSize) {
   free(isolate_snapshot_data_buffer);
 }
 
+//
+// Measure writing a full snapshot of the core libraries. Reading one is
+// measured by CorelibIsolateStartup.
+//
+BENCHMARK(CoreSnapshotWrite) {
+  const char* kScriptChars =
+      "import 'dart:async';\n"
+      "import 'dart:core';\n"
+      "import 'dart:collection';\n"
+      "import 'dart:_internal';\n"
+      "import 'dart:math';\n"
+      "import 'dart:isolate';\n"
+      "import 'dart:typed_data';\n"
+      "\n";
+  TestCase::LoadCoreTestScript(kScriptChars, NULL);
+  Api::CheckAndFinalizePendingClasses(thread);
+
+  TransitionNativeToVM transition(thread);
+  uint8_t* vm_snapshot_data_buffer;
+  uint8_t* isolate_snapshot_data_buffer;
+  Timer timer(true, "Core Snapshot Write");
+  timer.Start();
+  FullSnapshotWriter writer(Snapshot::kFull, &vm_snapshot_data_buffer,
+                            &isolate_snapshot_data_buffer, &malloc_allocator,
+                            NULL, NULL /* image_writer */);
+  writer.WriteFullSnapshot();
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+
+  free(vm_snapshot_data_buffer);
+  free(isolate_snapshot_data_buffer);
+}
+
+//
+// Measure inflating the compressed data of a full snapshot of the core
+// libraries, as the standalone embedder does for snapshots written with
+// --compress-snapshot-data. Startup gains when this takes less time than
+// reading the bytes saved by compression.
+//
+BENCHMARK(CoreSnapshotInflate) {
+  const char* kScriptChars =
+      "import 'dart:async';\n"
+      "import 'dart:core';\n"
+      "import 'dart:collection';\n"
+      "import 'dart:_internal';\n"
+      "import 'dart:math';\n"
+      "import 'dart:isolate';\n"
+      "import 'dart:typed_data';\n"
+      "\n";
+  TestCase::LoadCoreTestScript(kScriptChars, NULL);
+  Api::CheckAndFinalizePendingClasses(thread);
+
+  TransitionNativeToVM transition(thread);
+  uint8_t* vm_snapshot_data_buffer;
+  uint8_t* isolate_snapshot_data_buffer;
+  FullSnapshotWriter writer(Snapshot::kFull, &vm_snapshot_data_buffer,
+                            &isolate_snapshot_data_buffer, &malloc_allocator,
+                            NULL, NULL /* image_writer */);
+  writer.WriteFullSnapshot();
+  const intptr_t size = writer.IsolateSnapshotSize();
+
+  uint8_t* compressed = NULL;
+  intptr_t compressed_size = 0;
+  bin::Compress(isolate_snapshot_data_buffer, size, &compressed,
+                &compressed_size);
+
+  const int kNumIterations = 10;
+  Timer timer(true, "Core Snapshot Inflate");
+  for (int i = 0; i < kNumIterations; i++) {
+    uint8_t* inflated = NULL;
+    intptr_t inflated_size = 0;
+    timer.Start();
+    bin::Decompress(compressed, compressed_size, &inflated, &inflated_size);
+    timer.Stop();
+    EXPECT_EQ(size, inflated_size);
+    free(inflated);
+  }
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+
+  free(compressed);
+  free(vm_snapshot_data_buffer);
+  free(isolate_snapshot_data_buffer);
+}
+
 BENCHMARK(CreateMirrorSystem) {
   const char* kScriptChars =
       "import 'dart:mirrors';\n"
@@ -687,6 +894,543 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+static void BenchmarkMessageRoundTrip(Thread* thread,
+                                      const Instance& message_object,
+                                      intptr_t loop_count,
+                                      const char* name,
+                                      Benchmark* benchmark) {
+  Timer timer(true, name);
+  timer.Start();
+  for (intptr_t i = 0; i < loop_count; i++) {
+    StackZone zone(thread);
+    MessageWriter writer(true);
+    Message* message = writer.WriteMessage(message_object, ILLEGAL_PORT,
+                                           Message::kNormalPriority);
+
+    // Read object back from the snapshot.
+    MessageSnapshotReader reader(message, thread);
+    reader.ReadObject();
+    delete message;
+  }
+  timer.Stop();
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
+// Many small objects: the shape of typical JSON-like worker messages.
+BENCHMARK(ListOfMapsMessage) {
+  const char* kScript =
+      "makeList() {\n"
+      "  var list = [];\n"
+      "  for (int i = 0; i < 1000; ++i) {\n"
+      "    list.add({'id': 'item$i', 'name': 'name of item $i',\n"
+      "              'tags': ['a$i', 'b$i'], 'count': i});\n"
+      "  }\n"
+      "  return list;\n"
+      "}";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(h_lib);
+  Dart_Handle h_result = Dart_Invoke(h_lib, NewString("makeList"), 0, NULL);
+  EXPECT_VALID(h_result);
+  Instance& list = Instance::Handle();
+  list ^= Api::UnwrapHandle(h_result);
+  BenchmarkMessageRoundTrip(thread, list, 100, "List Of Maps Message",
+                            benchmark);
+}
+
+BENCHMARK(StringListMessage) {
+  const char* kScript =
+      "makeList() {\n"
+      "  var list = new List(10000);\n"
+      "  for (int i = 0; i < list.length; ++i) {\n"
+      "    list[i] = 'a moderately long string number $i';\n"
+      "  }\n"
+      "  return list;\n"
+      "}";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(h_lib);
+  Dart_Handle h_result = Dart_Invoke(h_lib, NewString("makeList"), 0, NULL);
+  EXPECT_VALID(h_result);
+  Instance& list = Instance::Handle();
+  list ^= Api::UnwrapHandle(h_result);
+  BenchmarkMessageRoundTrip(thread, list, 100, "String List Message",
+                            benchmark);
+}
+
+// Counts the data TLB misses of the current thread, where the OS allows it.
+class DTLBMissCounter : public ValueObject {
+ public:
+  DTLBMissCounter() : fd_(-1) {
+#if defined(HOST_OS_LINUX)
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd_ = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+
+  ~DTLBMissCounter() {
+#if defined(HOST_OS_LINUX)
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif
+  }
+
+  // Returns -1 if there is no counter.
+  int64_t Read() const {
+#if defined(HOST_OS_LINUX)
+    uint64_t count = 0;
+    if ((fd_ >= 0) && (read(fd_, &count, sizeof(count)) == sizeof(count))) {
+      return static_cast<int64_t>(count);
+    }
+#endif
+    return -1;
+  }
+
+ private:
+  int fd_;
+
+  DISALLOW_COPY_AND_ASSIGN(DTLBMissCounter);
+};
+
+// Allocates 2M small arrays in new space, keeping a scattered sixteenth of
+// them alive for a while for the scavenges to copy.
+static void AllocateShortLivedArrays(Thread* thread) {
+  const intptr_t kNumRetained = 10000;
+  const intptr_t kLoopCount = 2000000;
+  HANDLESCOPE(thread);
+  const Array& retained = Array::Handle(Array::New(kNumRetained, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    element = Array::New(8);
+    if ((i % 16) == 0) {
+      retained.SetAt((i / 16) % kNumRetained, element);
+    }
+  }
+}
+
+static void AllocateWithHugePages(Thread* thread,
+                                  bool use_huge_pages,
+                                  int64_t* scavenge_micros,
+                                  int64_t* dtlb_misses) {
+  FLAG_use_huge_pages = use_huge_pages;
+  Heap* heap = thread->isolate()->heap();
+  // Map both semi-spaces afresh, bypassing the cached one.
+  for (intptr_t i = 0; i < 2; i++) {
+    SemiSpace::Cleanup();
+    heap->CollectGarbage(Heap::kNew);
+  }
+
+  const int64_t gc_time_before = heap->new_space()->gc_time_micros();
+  DTLBMissCounter counter;
+  const int64_t misses_before = counter.Read();
+  AllocateShortLivedArrays(thread);
+  const int64_t misses_after = counter.Read();
+  *scavenge_micros = heap->new_space()->gc_time_micros() - gc_time_before;
+  *dtlb_misses = (misses_before < 0) ? -1 : (misses_after - misses_before);
+}
+
+// Runs the allocation loop without and then with transparent huge pages
+// backing new space, and returns what the huge pages saved.
+static void CompareHugePages(Thread* thread,
+                             int64_t* micros_saved,
+                             int64_t* misses_saved) {
+  const bool saved_use_huge_pages = FLAG_use_huge_pages;
+  int64_t small_micros = 0;
+  int64_t small_misses = 0;
+  int64_t huge_micros = 0;
+  int64_t huge_misses = 0;
+  AllocateWithHugePages(thread, false, &small_micros, &small_misses);
+  AllocateWithHugePages(thread, true, &huge_micros, &huge_misses);
+  FLAG_use_huge_pages = saved_use_huge_pages;
+  SemiSpace::Cleanup();
+  *micros_saved = small_micros - huge_micros;
+  *misses_saved = ((small_misses >= 0) && (huge_misses >= 0))
+                      ? (small_misses - huge_misses)
+                      : 0;
+}
+
+// The score is the scavenge time saved by backing new space with transparent
+// huge pages.
+BENCHMARK(ScavengeHugePages) {
+  TransitionNativeToVM transition(thread);
+  int64_t micros_saved = 0;
+  int64_t misses_saved = 0;
+  CompareHugePages(thread, &micros_saved, &misses_saved);
+  benchmark->set_lower_is_better(false);
+  benchmark->set_score(micros_saved);
+}
+
+// The score is the number of data TLB misses of the whole allocation loop
+// saved by transparent huge pages, or 0 where they cannot be counted.
+BENCHMARK_HELPER(ScavengeHugePagesTLBMisses, "DTLBMisses") {
+  TransitionNativeToVM transition(thread);
+  int64_t micros_saved = 0;
+  int64_t misses_saved = 0;
+  CompareHugePages(thread, &micros_saved, &misses_saved);
+  benchmark->set_lower_is_better(false);
+  benchmark->set_score(misses_saved);
+}
+
+//
+// Measure the time spent in scavenges while allocating short-lived objects.
+//
+BENCHMARK(ScavengeThroughput) {
+  TransitionNativeToVM transition(thread);
+  Heap* heap = thread->isolate()->heap();
+  const int64_t gc_time_before = heap->new_space()->gc_time_micros();
+  AllocateShortLivedArrays(thread);
+  benchmark->set_score(heap->new_space()->gc_time_micros() - gc_time_before);
+}
+
+//
+// Measure full collections of an old space of 200K live objects.
+//
+BENCHMARK(MarkSweepThroughput) {
+  TransitionNativeToVM transition(thread);
+  Heap* heap = thread->isolate()->heap();
+  const intptr_t kNumArrays = 100000;
+  const intptr_t kNumCollections = 10;
+  const Array& root = Array::Handle(Array::New(kNumArrays, Heap::kOld));
+  {
+    HANDLESCOPE(thread);
+    Array& element = Array::Handle();
+    Array& previous = Array::Handle();
+    String& string = String::Handle();
+    for (intptr_t i = 0; i < kNumArrays; i++) {
+      element = Array::New(2, Heap::kOld);
+      string = String::New("a live string", Heap::kOld);
+      element.SetAt(0, string);
+      // Link the arrays so that marking also follows chains of pointers.
+      element.SetAt(1, previous);
+      root.SetAt(i, element);
+      previous = element.raw();
+    }
+  }
+  heap->CollectAllGarbage();
+  Timer timer(true, "Mark Sweep Throughput");
+  timer.Start();
+  for (intptr_t i = 0; i < kNumCollections; i++) {
+    heap->CollectAllGarbage();
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime() / kNumCollections);
+}
+
+//
+// Measure allocation of small objects by optimized Dart code.
+//
+BENCHMARK(AllocationRate) {
+  const char* kScriptChars =
+      "class Point {\n"
+      "  var x, y;\n"
+      "  Point(this.x, this.y);\n"
+      "}\n"
+      "allocate(int n) {\n"
+      "  var ring = new List(1024);\n"
+      "  for (int i = 0; i < n; i++) {\n"
+      "    ring[i & 1023] = new Point(i, i);\n"
+      "  }\n"
+      "  return ring;\n"
+      "}\n";
+  const int kNumWarmupIterations = 100000;
+  const int kNumIterations = 10000000;
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle args[1];
+  args[0] = Dart_NewInteger(kNumWarmupIterations);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("allocate"), 1, args));
+
+  Timer timer(true, "Allocation Rate");
+  args[0] = Dart_NewInteger(kNumIterations);
+  timer.Start();
+  Dart_Handle result = Dart_Invoke(lib, NewString("allocate"), 1, args);
+  timer.Stop();
+  EXPECT_VALID(result);
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+//
+// Measure the cost of calling into Dart through the API, and of creating
+// and reading back a handle.
+//
+BENCHMARK(DartApiInvoke) {
+  const char* kScriptChars = "empty() {}\n";
+  const intptr_t kLoopCount = 1000000;
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  Dart_Handle name = NewString("empty");
+  EXPECT_VALID(Dart_Invoke(lib, name, 0, NULL));
+  Timer timer(true, "Dart API Invoke");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    Dart_EnterScope();
+    Dart_Invoke(lib, name, 0, NULL);
+    Dart_ExitScope();
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+BENCHMARK(DartApiNewInteger) {
+  const intptr_t kLoopCount = 10000000;
+  int64_t sum = 0;
+  Timer timer(true, "Dart API New Integer");
+  timer.Start();
+  for (intptr_t i = 0; i < kLoopCount; i++) {
+    Dart_EnterScope();
+    int64_t value = 0;
+    Dart_IntegerToInt64(Dart_NewInteger(i), &value);
+    sum += value;
+    Dart_ExitScope();
+  }
+  timer.Stop();
+  EXPECT_EQ((kLoopCount - 1) * kLoopCount / 2, sum);
+  benchmark->set_score(timer.TotalElapsedTime());
+}
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+static int64_t TimeTypedDataKernels(Dart_Handle lib,
+                                    const char* name,
+                                    bool* flag,
+                                    bool value) {
+  const int kNumWarmupIterations = 10000;
+  const int kNumIterations = 20000;
+  *flag = value;
+  Dart_Handle args[1];
+  // Warmup first to get the kernels optimized with the given flag.
+  args[0] = Dart_NewInteger(kNumWarmupIterations);
+  Dart_Handle result = Dart_Invoke(lib, NewString(name), 1, args);
+  EXPECT_VALID(result);
+
+  Timer timer(true, name);
+  args[0] = Dart_NewInteger(kNumIterations);
+  timer.Start();
+  result = Dart_Invoke(lib, NewString(name), 1, args);
+  EXPECT_VALID(result);
+  timer.Stop();
+  return timer.TotalElapsedTime();
+}
+
+//
+// Measure copy and reduction loops over typed data. The kernels are
+// duplicated and the copies are optimized with and without loop unrolling,
+// the score is the time saved by unrolling.
+//
+BENCHMARK(TypedDataLoopUnrolling) {
+  const char* kScriptChars =
+      "import 'dart:typed_data';\n"
+      "copyRolled(Uint8List dst, Uint8List src) {\n"
+      "  for (int i = 0; i < src.length; i++) dst[i] = src[i];\n"
+      "}\n"
+      "sumRolled(Float64List a) {\n"
+      "  double s = 0.0;\n"
+      "  for (int i = 0; i < a.length; i++) s += a[i];\n"
+      "  return s;\n"
+      "}\n"
+      "rolled(int count) {\n"
+      "  var src = new Uint8List(1021), dst = new Uint8List(1021);\n"
+      "  var a = new Float64List(1021);\n"
+      "  double s = 0.0;\n"
+      "  for (int n = 0; n < count; n++) {\n"
+      "    copyRolled(dst, src);\n"
+      "    s += sumRolled(a);\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n"
+      "copyUnrolled(Uint8List dst, Uint8List src) {\n"
+      "  for (int i = 0; i < src.length; i++) dst[i] = src[i];\n"
+      "}\n"
+      "sumUnrolled(Float64List a) {\n"
+      "  double s = 0.0;\n"
+      "  for (int i = 0; i < a.length; i++) s += a[i];\n"
+      "  return s;\n"
+      "}\n"
+      "unrolled(int count) {\n"
+      "  var src = new Uint8List(1021), dst = new Uint8List(1021);\n"
+      "  var a = new Float64List(1021);\n"
+      "  double s = 0.0;\n"
+      "  for (int n = 0; n < count; n++) {\n"
+      "    copyUnrolled(dst, src);\n"
+      "    s += sumUnrolled(a);\n"
+      "  }\n"
+      "  return s;\n"
+      "}\n";
+
+  const bool saved_loop_unrolling = FLAG_loop_unrolling;
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  const int64_t rolled_micros =
+      TimeTypedDataKernels(lib, "rolled", &FLAG_loop_unrolling, false);
+  const int64_t unrolled_micros =
+      TimeTypedDataKernels(lib, "unrolled", &FLAG_loop_unrolling, true);
+  FLAG_loop_unrolling = saved_loop_unrolling;
+  benchmark->set_lower_is_better(false);
+  benchmark->set_score(rolled_micros - unrolled_micros);
+}
+
+//
+// Measure element-wise kernels over Float32List and Int32List optimized with
+// and without vectorization. The score is the time saved by vectorization.
+//
+BENCHMARK(TypedDataLoopVectorization) {
+  const char* kScriptChars =
+      "import 'dart:typed_data';\n"
+      "addScalar(Float32List d, Float32List a, Float32List b) {\n"
+      "  for (int i = 0; i < d.length; i++) d[i] = a[i] + b[i];\n"
+      "}\n"
+      "xorScalar(Int32List d, Int32List a, Int32List b) {\n"
+      "  for (int i = 0; i < d.length; i++) d[i] = a[i] ^ b[i];\n"
+      "}\n"
+      "scalar(int count) {\n"
+      "  var fd = new Float32List(1021), fa = new Float32List(1021);\n"
+      "  var id = new Int32List(1021), ia = new Int32List(1021);\n"
+      "  for (int n = 0; n < count; n++) {\n"
+      "    addScalar(fd, fa, fd);\n"
+      "    xorScalar(id, ia, id);\n"
+      "  }\n"
+      "}\n"
+      "addVector(Float32List d, Float32List a, Float32List b) {\n"
+      "  for (int i = 0; i < d.length; i++) d[i] = a[i] + b[i];\n"
+      "}\n"
+      "xorVector(Int32List d, Int32List a, Int32List b) {\n"
+      "  for (int i = 0; i < d.length; i++) d[i] = a[i] ^ b[i];\n"
+      "}\n"
+      "vector(int count) {\n"
+      "  var fd = new Float32List(1021), fa = new Float32List(1021);\n"
+      "  var id = new Int32List(1021), ia = new Int32List(1021);\n"
+      "  for (int n = 0; n < count; n++) {\n"
+      "    addVector(fd, fa, fd);\n"
+      "    xorVector(id, ia, id);\n"
+      "  }\n"
+      "}\n";
+
+  const bool saved_loop_vectorization = FLAG_loop_vectorization;
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  const int64_t scalar_micros =
+      TimeTypedDataKernels(lib, "scalar", &FLAG_loop_vectorization, false);
+  const int64_t vector_micros =
+      TimeTypedDataKernels(lib, "vector", &FLAG_loop_vectorization, true);
+  FLAG_loop_vectorization = saved_loop_vectorization;
+  benchmark->set_lower_is_better(false);
+  benchmark->set_score(scalar_micros - vector_micros);
+}
+
+//
+// Measure the latency of compiling generated functions without optimization,
+// in microseconds per thousand lines of source.
+//
+BENCHMARK(UnoptimizedCompileLatency) {
+  const intptr_t kNumFunctions = 200;
+  const intptr_t kLinesPerFunction = 12;
+  TextBuffer buffer(64 * KB);
+  buffer.AddString(
+      "class Point {\n"
+      "  final int x, y;\n"
+      "  Point(this.x, this.y);\n"
+      "}\n");
+  for (intptr_t i = 0; i < kNumFunctions; i++) {
+    buffer.Printf(
+        "f%" Pd "(List<Point> points, Map<String, int> counts) {\n"
+        "  var sum = 0;\n"
+        "  for (var p in points) {\n"
+        "    sum += p.x * %" Pd " - p.y;\n"
+        "    if (sum > 1000) {\n"
+        "      counts['f%" Pd "'] = (counts['f%" Pd "'] ?? 0) + 1;\n"
+        "      sum = 0;\n"
+        "    }\n"
+        "  }\n"
+        "  var s = 'sum: $sum';\n"
+        "  return s.length + points.length;\n"
+        "}\n",
+        i, i, i, i);
+  }
+  Dart_Handle lib = TestCase::LoadTestScript(buffer.buf(), NULL);
+  EXPECT_VALID(lib);
+
+  TransitionNativeToVM transition(thread);
+  Library& library = Library::Handle();
+  library ^= Api::UnwrapHandle(lib);
+  GrowableArray<const Function*> functions(kNumFunctions);
+  String& name = String::Handle();
+  for (intptr_t i = 0; i < kNumFunctions; i++) {
+    name = Symbols::NewFormatted(thread, "f%" Pd, i);
+    const Function& function =
+        Function::ZoneHandle(library.LookupLocalFunction(name));
+    EXPECT(!function.IsNull());
+    functions.Add(&function);
+  }
+  Object& result = Object::Handle();
+  Timer timer(true, "Unoptimized Compile Latency");
+  timer.Start();
+  for (intptr_t i = 0; i < kNumFunctions; i++) {
+    result = Compiler::CompileFunction(thread, *functions[i]);
+    EXPECT(result.IsCode());
+  }
+  timer.Stop();
+  const intptr_t kNumLines = kNumFunctions * kLinesPerFunction;
+  benchmark->set_score(timer.TotalElapsedTime() * 1000 / kNumLines);
+}
+
+//
+// Measure the latency of optimizing a medium-sized function with type
+// feedback, in microseconds per compilation.
+//
+BENCHMARK(OptimizingCompileLatency) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  var f = 1;\n"
+      "  int get g => f * 2;\n"
+      "}\n"
+      "work(List<A> list, Map<String, int> map) {\n"
+      "  var sum = 0;\n"
+      "  for (var a in list) {\n"
+      "    sum += a.f + a.g;\n"
+      "    if (sum > 1000) sum -= map['key'] ?? 0;\n"
+      "  }\n"
+      "  var s = 'result $sum';\n"
+      "  for (int i = 0; i < s.length; i++) {\n"
+      "    map[s.substring(i)] = i;\n"
+      "  }\n"
+      "  return sum + map.length;\n"
+      "}\n"
+      "warmup() {\n"
+      "  var list = new List<A>.generate(10, (_) => new A());\n"
+      "  var map = <String, int>{'key': 1};\n"
+      "  for (int i = 0; i < 10; i++) work(list, map);\n"
+      "}\n";
+  const intptr_t kNumCompilations = 100;
+  Dart_Handle lib = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib);
+  // Collect type feedback in the unoptimized code.
+  EXPECT_VALID(Dart_Invoke(lib, NewString("warmup"), 0, NULL));
+
+  TransitionNativeToVM transition(thread);
+  Library& library = Library::Handle();
+  library ^= Api::UnwrapHandle(lib);
+  const Function& function = Function::Handle(library.LookupLocalFunction(
+      String::Handle(Symbols::New(thread, "work"))));
+  EXPECT(!function.IsNull());
+  Object& result = Object::Handle();
+  Timer timer(true, "Optimizing Compile Latency");
+  timer.Start();
+  for (intptr_t i = 0; i < kNumCompilations; i++) {
+    result = Compiler::CompileOptimizedFunction(thread, function);
+  }
+  timer.Stop();
+  EXPECT(result.IsCode());
+  benchmark->set_score(timer.TotalElapsedTime() / kNumCompilations);
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
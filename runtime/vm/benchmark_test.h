@@ -10,6 +10,7 @@
 #include "vm/dart.h"
 #include "vm/globals.h"
 #include "vm/isolate.h"
+#include "vm/json_writer.h"
 #include "vm/malloc_hooks.h"
 #include "vm/object.h"
 #include "vm/unit_test.h"
@@ -68,6 +69,9 @@ class Benchmark {
         name_(name),
         score_kind_(score_kind),
         score_(0),
+        lower_is_better_(true),
+        scores_(NULL),
+        num_scores_(0),
         isolate_(NULL),
         next_(NULL) {
     if (first_ == NULL) {
@@ -83,11 +87,19 @@ class Benchmark {
   const char* score_kind() const { return score_kind_; }
   void set_score(int64_t value) { score_ = value; }
   int64_t score() const { return score_; }
+  // Benchmarks scoring an improvement, rather than a cost, must say so for
+  // regression checks on their results.
+  bool lower_is_better() const { return lower_is_better_; }
+  void set_lower_is_better(bool value) { lower_is_better_ = value; }
   Isolate* isolate() const { return reinterpret_cast<Isolate*>(isolate_); }
 
   void Run() { (*run_)(this); }
   void RunBenchmark();
 
+  // Runs the benchmark --benchmark_repetitions times, leaving the median of
+  // the scores in score(). RunAll writes all of them to --benchmark_results.
+  void RunRepetitions();
+
   static void RunAll(const char* executable);
   static void SetExecutable(const char* arg) { executable_ = arg; }
   static const char* Executable() { return executable_; }
@@ -102,10 +114,17 @@ class Benchmark {
   static Benchmark* tail_;
   static const char* executable_;
 
+  void PrintResultJSON(JSONWriter* writer) const;
+  static void WriteResults();
+
   RunEntry* const run_;
   const char* name_;
   const char* score_kind_;
   int64_t score_;
+  bool lower_is_better_;
+  // Sorted scores of the last RunRepetitions.
+  int64_t* scores_;
+  intptr_t num_scores_;
   Dart_Isolate isolate_;
   Benchmark* next_;
 
@@ -10,6 +10,7 @@
 #include "vm/dart_api_impl.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
+#include "vm/runtime_entry.h"
 #include "vm/service_isolate.h"
 
 namespace dart {
@@ -53,6 +54,16 @@ Dart_NativeFunction BootstrapNatives::Lookup(Dart_Handle name,
   return NULL;
 }
 
+const RuntimeEntry* BootstrapNatives::LookupLeaf(const String& name) {
+#define LOOKUP_LEAF_NATIVE(native_name, entry_name)                            \
+  if (name.Equals("" #native_name)) {                                          \
+    return &k##entry_name##RuntimeEntry;                                       \
+  }
+  BOOTSTRAP_LEAF_NATIVE_LIST(LOOKUP_LEAF_NATIVE)
+#undef LOOKUP_LEAF_NATIVE
+  return NULL;
+}
+
 const uint8_t* BootstrapNatives::Symbol(Dart_NativeFunction* nf) {
   int num_entries = sizeof(BootStrapEntries) / sizeof(struct NativeEntries);
   for (int i = 0; i < num_entries; i++) {
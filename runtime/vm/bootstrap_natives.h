@@ -49,9 +49,12 @@ namespace dart {
   V(CapabilityImpl_factory, 1)                                                 \
   V(CapabilityImpl_equals, 2)                                                  \
   V(CapabilityImpl_get_hashcode, 1)                                            \
+  V(TransferableTypedData_factory, 1)                                          \
+  V(TransferableTypedData_materialize, 1)                                      \
   V(RawReceivePortImpl_factory, 1)                                             \
   V(RawReceivePortImpl_get_id, 1)                                              \
   V(RawReceivePortImpl_get_sendport, 1)                                        \
+  V(RawReceivePortImpl_dequeueBatchedMessage, 0)                               \
   V(RawReceivePortImpl_closeInternal, 1)                                       \
   V(SendPortImpl_get_id, 1)                                                    \
   V(SendPortImpl_get_hashcode, 1)                                              \
@@ -112,6 +115,7 @@ namespace dart {
   V(List_setIndexed, 3)                                                        \
   V(List_getLength, 1)                                                         \
   V(List_slice, 4)                                                             \
+  V(List_copyFrom, 5)                                                          \
   V(ImmutableList_from, 4)                                                     \
   V(StringBase_createFromCodePoints, 3)                                        \
   V(StringBase_substringUnchecked, 3)                                          \
@@ -132,6 +136,7 @@ namespace dart {
   V(String_toLowerCase, 1)                                                     \
   V(String_toUpperCase, 1)                                                     \
   V(String_concatRange, 3)                                                     \
+  V(Utf8Decoder_decodeOneBytePrefix, 3)                                        \
   V(Math_sqrt, 1)                                                              \
   V(Math_sin, 1)                                                               \
   V(Math_cos, 1)                                                               \
@@ -186,6 +191,9 @@ namespace dart {
   V(TypedData_Float64x2Array_new, 2)                                           \
   V(TypedData_length, 1)                                                       \
   V(TypedData_setRange, 7)                                                     \
+  V(TypedData_fillBytes, 4)                                                    \
+  V(TypedData_indexOfByte, 4)                                                  \
+  V(TypedData_lastIndexOfByte, 4)                                              \
   V(TypedData_GetInt8, 2)                                                      \
   V(TypedData_SetInt8, 3)                                                      \
   V(TypedData_GetUint8, 2)                                                     \
@@ -329,6 +337,7 @@ namespace dart {
   V(WeakProperty_getValue, 1)                                                  \
   V(WeakProperty_setValue, 2)                                                  \
   V(Uri_isWindowsPlatform, 0)                                                  \
+  V(Uri_decodeOneByteString, 5)                                                \
   V(LibraryPrefix_load, 1)                                                     \
   V(LibraryPrefix_invalidateDependentCode, 1)                                  \
   V(LibraryPrefix_loadError, 1)                                                \
@@ -404,12 +413,31 @@ namespace dart {
   V(TypedefMirror_declaration, 1)                                              \
   V(VariableMirror_type, 2)
 
+// Bootstrap natives that optimized code may call as leaf runtime entries
+// instead of going through the native call stub and NativeArguments. The
+// leaf version takes no arguments and returns an unboxed int64; like any leaf
+// runtime entry it must not allocate, throw, or call back into Dart.
+//
+// (native name, leaf runtime entry)
+#define BOOTSTRAP_LEAF_NATIVE_LIST(V)                                          \
+  V(Stopwatch_now, StopwatchNow)                                               \
+  V(Stopwatch_frequency, StopwatchFrequency)                                   \
+  V(Timeline_getTraceClock, TimelineGetTraceClock)                             \
+  V(Timeline_getThreadCpuClock, TimelineGetThreadCpuClock)
+
+class RuntimeEntry;
+class String;
+
 class BootstrapNatives : public AllStatic {
  public:
   static Dart_NativeFunction Lookup(Dart_Handle name,
                                     int argument_count,
                                     bool* auto_setup_scope);
 
+  // Returns the leaf runtime entry for the bootstrap native 'name', or NULL
+  // if it has none.
+  static const RuntimeEntry* LookupLeaf(const String& name);
+
   static const uint8_t* Symbol(Dart_NativeFunction* nf);
 
 #define DECLARE_BOOTSTRAP_NATIVE(name, ignored)                                \
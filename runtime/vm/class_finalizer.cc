@@ -2615,8 +2615,9 @@ void ClassFinalizer::FinalizeTypesInClass(const Class& cls) {
     ASSERT(!super_class.IsNull());
     super_class.AddDirectSubclass(cls);
   }
-  // A top level class is parsed eagerly so just finalize it.
-  if (cls.IsTopLevel()) {
+  // A top level class is parsed eagerly so just finalize it, unless the
+  // kernel loader deferred loading its members until they are looked up.
+  if (cls.IsTopLevel() && (cls.kernel_offset() <= 0)) {
     FinalizeClass(cls);
   } else {
     // This class should not contain any functions or user-defined fields yet,
@@ -2658,8 +2659,8 @@ void ClassFinalizer::FinalizeClass(const Class& cls) {
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
   // If loading from a kernel, make sure that the class is fully loaded.
-  // Top level classes are always fully loaded.
-  if (!cls.IsTopLevel() && cls.kernel_offset() > 0) {
+  // Top level classes are fully loaded unless their members were deferred.
+  if (cls.kernel_offset() > 0) {
     kernel::KernelLoader::FinishLoading(cls);
   }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
@@ -124,25 +124,7 @@ void ClassTable::Register(const Class& cls) {
     }
   } else {
     if (top_ == capacity_) {
-      // Grow the capacity of the class table.
-      // TODO(koda): Add ClassTable::Grow to share code.
-      intptr_t new_capacity = capacity_ + capacity_increment_;
-      ClassAndSize* new_table = reinterpret_cast<ClassAndSize*>(
-          malloc(new_capacity * sizeof(ClassAndSize)));  // NOLINT
-      memmove(new_table, table_, capacity_ * sizeof(ClassAndSize));
-#ifndef PRODUCT
-      ClassHeapStats* new_stats_table = reinterpret_cast<ClassHeapStats*>(
-          realloc(class_heap_stats_table_,
-                  new_capacity * sizeof(ClassHeapStats)));  // NOLINT
-#endif
-      for (intptr_t i = capacity_; i < new_capacity; i++) {
-        new_table[i] = ClassAndSize(NULL, 0);
-        NOT_IN_PRODUCT(new_stats_table[i].Initialize());
-      }
-      capacity_ = new_capacity;
-      old_tables_->Add(table_);
-      table_ = new_table;  // TODO(koda): This should use atomics.
-      NOT_IN_PRODUCT(class_heap_stats_table_ = new_stats_table);
+      Grow(top_);
     }
     ASSERT(top_ < capacity_);
     if (!Class::is_valid_id(top_)) {
@@ -157,30 +139,11 @@ void ClassTable::Register(const Class& cls) {
 
 void ClassTable::AllocateIndex(intptr_t index) {
   if (index >= capacity_) {
-    // Grow the capacity of the class table.
-    // TODO(koda): Add ClassTable::Grow to share code.
-    intptr_t new_capacity = index + capacity_increment_;
-    if (!Class::is_valid_id(index) || new_capacity < capacity_) {
+    if (!Class::is_valid_id(index)) {
       FATAL1("Fatal error in ClassTable::Register: invalid index %" Pd "\n",
              index);
     }
-    ClassAndSize* new_table = reinterpret_cast<ClassAndSize*>(
-        malloc(new_capacity * sizeof(ClassAndSize)));  // NOLINT
-    memmove(new_table, table_, capacity_ * sizeof(ClassAndSize));
-#ifndef PRODUCT
-    ClassHeapStats* new_stats_table = reinterpret_cast<ClassHeapStats*>(
-        realloc(class_heap_stats_table_,
-                new_capacity * sizeof(ClassHeapStats)));  // NOLINT
-#endif
-    for (intptr_t i = capacity_; i < new_capacity; i++) {
-      new_table[i] = ClassAndSize(NULL);
-      NOT_IN_PRODUCT(new_stats_table[i].Initialize());
-    }
-    capacity_ = new_capacity;
-    old_tables_->Add(table_);
-    table_ = new_table;  // TODO(koda): This should use atomics.
-    NOT_IN_PRODUCT(class_heap_stats_table_ = new_stats_table);
-    ASSERT(capacity_increment_ >= 1);
+    Grow(index);
   }
 
   ASSERT(table_[index].class_ == NULL);
@@ -189,6 +152,37 @@ void ClassTable::AllocateIndex(intptr_t index) {
   }
 }
 
+void ClassTable::Grow(intptr_t index) {
+  ASSERT(index >= capacity_);
+  // Grow geometrically so that registering N classes copies the table
+  // O(log N) times. The old copy may still be read by compiler threads and
+  // by generated code that loaded table_ before the switch, so it is only
+  // freed by the next old-space collection (see FreeOldTables).
+  intptr_t new_capacity =
+      Utils::Maximum<intptr_t>(capacity_ * 2, capacity_increment_);
+  if (new_capacity <= index) {
+    new_capacity = index + capacity_increment_;
+  }
+  ClassAndSize* new_table = reinterpret_cast<ClassAndSize*>(
+      malloc(new_capacity * sizeof(ClassAndSize)));  // NOLINT
+  memmove(new_table, table_, capacity_ * sizeof(ClassAndSize));
+#ifndef PRODUCT
+  // The statistics are only accessed by the mutator and during GC, so they
+  // can be reallocated in place.
+  ClassHeapStats* new_stats_table = reinterpret_cast<ClassHeapStats*>(
+      realloc(class_heap_stats_table_,
+              new_capacity * sizeof(ClassHeapStats)));  // NOLINT
+#endif
+  for (intptr_t i = capacity_; i < new_capacity; i++) {
+    new_table[i] = ClassAndSize(NULL, 0);
+    NOT_IN_PRODUCT(new_stats_table[i].Initialize());
+  }
+  capacity_ = new_capacity;
+  old_tables_->Add(table_);
+  table_ = new_table;  // TODO(koda): This should use atomics.
+  NOT_IN_PRODUCT(class_heap_stats_table_ = new_stats_table);
+}
+
 #if defined(DEBUG)
 void ClassTable::Unregister(intptr_t index) {
   table_[index] = ClassAndSize(NULL);
@@ -368,6 +362,18 @@ void ClassHeapStats::UpdatePromotedAfterNewGC() {
   promoted_size = recent.old_size - old_pre_new_gc_size_;
 }
 
+intptr_t ClassHeapStats::EstimatedLiveCount() const {
+  return post_gc.new_count + recent.new_count + post_gc.old_count +
+         recent.old_count;
+}
+
+intptr_t ClassHeapStats::EstimatedLiveSize() const {
+  return post_gc.new_size + post_gc.new_external_size + recent.new_size +
+         recent.new_external_size + post_gc.old_size +
+         post_gc.old_external_size + recent.old_size +
+         recent.old_external_size;
+}
+
 void ClassHeapStats::PrintToJSONObject(const Class& cls,
                                        JSONObject* obj) const {
   if (!FLAG_support_service) {
@@ -403,8 +409,12 @@ void ClassHeapStats::PrintToJSONObject(const Class& cls,
                          recent.old_size + recent.old_external_size -
                          last_reset.old_size - last_reset.old_external_size);
   }
+  obj->AddProperty("instancesCurrent", EstimatedLiveCount());
+  obj->AddProperty("bytesCurrent", EstimatedLiveSize());
   obj->AddProperty("promotedInstances", promoted_count);
   obj->AddProperty("promotedBytes", promoted_size);
+  Isolate::Current()->heap()->pretenuring_feedback()->PrintToJSONObject(
+      cls.id(), obj);
 }
 
 void ClassTable::UpdateAllocatedNew(intptr_t cid, intptr_t size) {
@@ -151,6 +151,11 @@ class ClassHeapStats {
   void ResetAccumulator();
   void UpdatePromotedAfterNewGC();
   void UpdateSize(intptr_t instance_size);
+  // Instances and bytes live after the last GC of each space plus those
+  // allocated since, without walking the heap. Dead objects are only noticed
+  // by the next GC, so between GCs this is an upper bound.
+  intptr_t EstimatedLiveCount() const;
+  intptr_t EstimatedLiveSize() const;
 #ifndef PRODUCT
   void PrintToJSONObject(const Class& cls, JSONObject* obj) const;
 #endif
@@ -294,6 +299,7 @@ class ClassTable {
  private:
   friend class GCMarker;
   friend class MarkingWeakVisitor;
+  friend class ParallelScavengerVisitor;
   friend class ScavengerVisitor;
   friend class ScavengerWeakVisitor;
   friend class ClassHeapStatsTestHelper;
@@ -302,6 +308,9 @@ class ClassTable {
 
   static bool ShouldUpdateSizeForClassId(intptr_t cid);
 
+  // Grows the table so that it has room for index.
+  void Grow(intptr_t index);
+
   intptr_t top_;
   intptr_t capacity_;
 
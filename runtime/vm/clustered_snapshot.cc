@@ -16,6 +16,7 @@
 #include "vm/program_visitor.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/version.h"
 
@@ -23,10 +24,22 @@
 
 namespace dart {
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+DEFINE_FLAG(bool,
+            snapshot_initialized_statics,
+            false,
+            "Keep the values of initialized static fields in JIT app "
+            "snapshots when they are numbers, strings, booleans or constants, "
+            "so that isolates started from them skip these initializers.");
+#endif
+
 static RawObject* AllocateUninitialized(PageSpace* old_space, intptr_t size) {
   ASSERT(Utils::IsAligned(size, kObjectAlignment));
-  uword address =
-      old_space->TryAllocateDataBumpLocked(size, PageSpace::kForceGrowth);
+  // Deserialization allocates many small objects in a row: take them from a
+  // chunk of old space held by this thread rather than under the data lock,
+  // which would otherwise stall the background compiler for the whole load.
+  uword address = old_space->TryAllocateInThreadBuffer(
+      Thread::Current(), size, PageSpace::kForceGrowth);
   if (address == 0) {
     OUT_OF_MEMORY();
   }
@@ -619,6 +632,8 @@ class FunctionDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     Snapshot::Kind kind = d->kind();
     bool is_vm_object = d->isolate() == Dart::vm_isolate();
@@ -667,6 +682,7 @@ class FunctionDeserializationCluster : public DeserializationCluster {
         func->ptr()->optimized_instruction_count_ = 0;
         func->ptr()->optimized_call_site_count_ = 0;
         func->ptr()->deoptimization_counter_ = 0;
+        func->ptr()->adapted_deoptimization_counter_ = 0;
         func->ptr()->state_bits_ = 0;
         func->ptr()->inlining_depth_ = 0;
 #endif
@@ -973,7 +989,7 @@ class FieldSerializationCluster : public SerializationCluster {
         s->Push(field->ptr()->value_.static_value_);
       } else {
         // Otherwise, for static fields we write out the initial static value.
-        s->Push(field->ptr()->initializer_.saved_value_);
+        s->Push(StaticValueToSnapshot(field, kind));
       }
     } else {
       s->Push(field->ptr()->value_.offset_);
@@ -1023,7 +1039,7 @@ class FieldSerializationCluster : public SerializationCluster {
           s->WriteRef(field->ptr()->value_.static_value_);
         } else {
           // Otherwise, for static fields we write out the initial static value.
-          s->WriteRef(field->ptr()->initializer_.saved_value_);
+          s->WriteRef(StaticValueToSnapshot(field, kind));
         }
       } else {
         s->WriteRef(field->ptr()->value_.offset_);
@@ -1056,6 +1072,33 @@ class FieldSerializationCluster : public SerializationCluster {
   }
 
  private:
+  // Returns the value a non-const static field starts with in a snapshot.
+  // That is its initial value, unless --snapshot_initialized_statics keeps the
+  // current value. Only immutable values are kept, as the heap reachable from
+  // mutable ones may hold objects that cannot be snapshotted.
+  static RawObject* StaticValueToSnapshot(RawField* field,
+                                          Snapshot::Kind kind) {
+    RawObject* saved_value = field->ptr()->initializer_.saved_value_;
+    if (!FLAG_snapshot_initialized_statics || (kind != Snapshot::kFullJIT)) {
+      return saved_value;
+    }
+    RawObject* value = field->ptr()->value_.static_value_;
+    if ((value == Object::sentinel().raw()) ||
+        (value == Object::transition_sentinel().raw())) {
+      // Not initialized yet, or being initialized.
+      return saved_value;
+    }
+    const intptr_t cid = value->GetClassIdMayBeSmi();
+    if ((RawObject::IsStringClassId(cid) &&
+         !RawObject::IsExternalStringClassId(cid)) ||
+        RawObject::IsNumberClassId(cid) || (cid == kBoolCid) ||
+        (cid == kNullCid) ||
+        (value->IsHeapObject() && value->IsCanonical())) {
+      return value;
+    }
+    return saved_value;
+  }
+
   GrowableArray<RawField*> objects_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
@@ -1075,6 +1118,8 @@ class FieldDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     Snapshot::Kind kind = d->kind();
     bool is_vm_object = d->isolate() == Dart::vm_isolate();
@@ -1755,6 +1800,8 @@ class CodeDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     bool is_vm_object = d->isolate() == Dart::vm_isolate();
 
@@ -1932,6 +1979,8 @@ class ObjectPoolDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     bool is_vm_object = d->isolate() == Dart::vm_isolate();
     for (intptr_t id = start_index_; id < stop_index_; id += 1) {
@@ -1976,13 +2025,13 @@ class ObjectPoolDeserializationCluster : public DeserializationCluster {
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 // PcDescriptor, StackMap, OneByteString, TwoByteString
-class RODataSerializationCluster : public SerializationCluster {
+// Objects without pointers that are used in place from the read-only data
+// of the image, and so shared between processes mapping the same snapshot.
+class ReadOnlyObjects : public ValueObject {
  public:
-  RODataSerializationCluster(const char* name, intptr_t cid)
-      : SerializationCluster(name), cid_(cid) {}
-  virtual ~RODataSerializationCluster() {}
+  ReadOnlyObjects() {}
 
-  void Trace(Serializer* s, RawObject* object) {
+  void Add(Serializer* s, RawObject* object) {
     // A string's hash must already be computed when we write it because it
     // will be loaded into read-only memory. Extra bytes due to allocation
     // rounding need to be deterministically set for reliable deduplication in
@@ -2001,8 +2050,8 @@ class RODataSerializationCluster : public SerializationCluster {
     }
   }
 
-  void WriteAlloc(Serializer* s) {
-    s->WriteCid(cid_);
+  // Writes the image offsets of the objects and assigns their refs.
+  void Write(Serializer* s) {
     intptr_t count = shared_objects_.length();
     s->WriteUnsigned(count);
     for (intptr_t i = 0; i < count; i++) {
@@ -2029,36 +2078,59 @@ class RODataSerializationCluster : public SerializationCluster {
     }
   }
 
+ private:
+  GrowableArray<RawObject*> objects_;
+  GrowableArray<RawObject*> shared_objects_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadOnlyObjects);
+};
+
+class RODataSerializationCluster : public SerializationCluster {
+ public:
+  RODataSerializationCluster(const char* name, intptr_t cid)
+      : SerializationCluster(name), cid_(cid) {}
+  virtual ~RODataSerializationCluster() {}
+
+  void Trace(Serializer* s, RawObject* object) { objects_.Add(s, object); }
+
+  void WriteAlloc(Serializer* s) {
+    s->WriteCid(cid_);
+    objects_.Write(s);
+  }
+
   void WriteFill(Serializer* s) {
     // No-op.
   }
 
  private:
   const intptr_t cid_;
-  GrowableArray<RawObject*> objects_;
-  GrowableArray<RawObject*> shared_objects_;
+  ReadOnlyObjects objects_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
+// Reads the image offsets written by ReadOnlyObjects::Write and assigns the
+// refs of the objects in the image.
+static void ReadReadOnlyObjects(Deserializer* d) {
+  intptr_t count = d->ReadUnsigned();
+  for (intptr_t i = 0; i < count; i++) {
+    uint32_t offset = d->ReadUnsigned();
+    d->AssignRef(d->GetSharedObjectAt(offset));
+  }
+
+  count = d->ReadUnsigned();
+  uint32_t running_offset = 0;
+  for (intptr_t i = 0; i < count; i++) {
+    running_offset += d->ReadUnsigned() << kObjectAlignmentLog2;
+    d->AssignRef(d->GetObjectAt(running_offset));
+  }
+}
+
 class RODataDeserializationCluster : public DeserializationCluster {
  public:
   RODataDeserializationCluster() {}
   virtual ~RODataDeserializationCluster() {}
 
-  void ReadAlloc(Deserializer* d) {
-    intptr_t count = d->ReadUnsigned();
-    for (intptr_t i = 0; i < count; i++) {
-      uint32_t offset = d->ReadUnsigned();
-      d->AssignRef(d->GetSharedObjectAt(offset));
-    }
-
-    count = d->ReadUnsigned();
-    uint32_t running_offset = 0;
-    for (intptr_t i = 0; i < count; i++) {
-      running_offset += d->ReadUnsigned() << kObjectAlignmentLog2;
-      d->AssignRef(d->GetObjectAt(running_offset));
-    }
-  }
+  void ReadAlloc(Deserializer* d) { ReadReadOnlyObjects(d); }
 
   void ReadFill(Deserializer* d) {
     // No-op.
@@ -2572,6 +2644,7 @@ class MegamorphicCacheDeserializationCluster : public DeserializationCluster {
         *p = d->ReadRef();
       }
       cache->ptr()->filled_entry_count_ = d->Read<int32_t>();
+      cache->ptr()->miss_count_ = 0;
     }
   }
 };
@@ -2586,7 +2659,12 @@ class SubtypeTestCacheSerializationCluster : public SerializationCluster {
   void Trace(Serializer* s, RawObject* object) {
     RawSubtypeTestCache* cache = SubtypeTestCache::RawCast(object);
     objects_.Add(cache);
-    s->Push(cache->ptr()->cache_);
+
+    RawObject** from = cache->from();
+    RawObject** to = cache->to();
+    for (RawObject** p = from; p <= to; p++) {
+      s->Push(*p);
+    }
   }
 
   void WriteAlloc(Serializer* s) {
@@ -2603,7 +2681,12 @@ class SubtypeTestCacheSerializationCluster : public SerializationCluster {
     intptr_t count = objects_.length();
     for (intptr_t i = 0; i < count; i++) {
       RawSubtypeTestCache* cache = objects_[i];
-      s->WriteRef(cache->ptr()->cache_);
+      RawObject** from = cache->from();
+      RawObject** to = cache->to();
+      for (RawObject** p = from; p <= to; p++) {
+        s->WriteRef(*p);
+      }
+      s->Write<int32_t>(cache->ptr()->filled_entry_count_);
     }
   }
 
@@ -2637,7 +2720,12 @@ class SubtypeTestCacheDeserializationCluster : public DeserializationCluster {
       Deserializer::InitializeHeader(cache, kSubtypeTestCacheCid,
                                      SubtypeTestCache::InstanceSize(),
                                      is_vm_object);
-      cache->ptr()->cache_ = reinterpret_cast<RawArray*>(d->ReadRef());
+      RawObject** from = cache->from();
+      RawObject** to = cache->to();
+      for (RawObject** p = from; p <= to; p++) {
+        *p = d->ReadRef();
+      }
+      cache->ptr()->filled_entry_count_ = d->Read<int32_t>();
     }
   }
 };
@@ -2888,6 +2976,8 @@ class InstanceDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     intptr_t next_field_offset = next_field_offset_in_words_ << kWordSizeLog2;
     intptr_t instance_size =
@@ -3605,6 +3695,9 @@ class MintSerializationCluster : public SerializationCluster {
     if (!object->IsHeapObject()) {
       RawSmi* smi = Smi::RawCast(object);
       smis_.Add(smi);
+    } else if (Snapshot::IncludesCode(s->kind()) && object->IsCanonical()) {
+      // Canonical mints are never mutated and can be used in place.
+      read_only_mints_.Add(s, object);
     } else {
       RawMint* mint = Mint::RawCast(object);
       mints_.Add(mint);
@@ -3627,6 +3720,9 @@ class MintSerializationCluster : public SerializationCluster {
       s->Write<int64_t>(mint->ptr()->value_);
       s->AssignRef(mint);
     }
+    if (Snapshot::IncludesCode(s->kind())) {
+      read_only_mints_.Write(s);
+    }
   }
 
   void WriteFill(Serializer* s) {}
@@ -3634,6 +3730,7 @@ class MintSerializationCluster : public SerializationCluster {
  private:
   GrowableArray<RawSmi*> smis_;
   GrowableArray<RawMint*> mints_;
+  ReadOnlyObjects read_only_mints_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
@@ -3662,6 +3759,9 @@ class MintDeserializationCluster : public DeserializationCluster {
         d->AssignRef(mint);
       }
     }
+    if (Snapshot::IncludesCode(d->kind())) {
+      ReadReadOnlyObjects(d);
+    }
     stop_index_ = d->next_index();
   }
 
@@ -3692,11 +3792,20 @@ class DoubleSerializationCluster : public SerializationCluster {
 
   void Trace(Serializer* s, RawObject* object) {
     RawDouble* dbl = Double::RawCast(object);
-    objects_.Add(dbl);
+    if (Snapshot::IncludesCode(s->kind()) && dbl->IsCanonical()) {
+      // Canonical doubles are never mutated and can be used in place, unlike
+      // the boxes of unboxed fields.
+      read_only_objects_.Add(s, dbl);
+    } else {
+      objects_.Add(dbl);
+    }
   }
 
   void WriteAlloc(Serializer* s) {
     s->WriteCid(kDoubleCid);
+    if (Snapshot::IncludesCode(s->kind())) {
+      read_only_objects_.Write(s);
+    }
     intptr_t count = objects_.length();
     s->WriteUnsigned(count);
     for (intptr_t i = 0; i < count; i++) {
@@ -3716,6 +3825,7 @@ class DoubleSerializationCluster : public SerializationCluster {
 
  private:
   GrowableArray<RawDouble*> objects_;
+  ReadOnlyObjects read_only_objects_;
 };
 #endif  // !DART_PRECOMPILED_RUNTIME
 
@@ -3725,6 +3835,9 @@ class DoubleDeserializationCluster : public DeserializationCluster {
   virtual ~DoubleDeserializationCluster() {}
 
   void ReadAlloc(Deserializer* d) {
+    if (Snapshot::IncludesCode(d->kind())) {
+      ReadReadOnlyObjects(d);
+    }
     start_index_ = d->next_index();
     PageSpace* old_space = d->heap()->old_space();
     intptr_t count = d->ReadUnsigned();
@@ -3890,6 +4003,8 @@ class TypedDataDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     bool is_vm_object = d->isolate() == Dart::vm_isolate();
     intptr_t element_size = TypedData::ElementSizeInBytes(cid_);
@@ -4062,6 +4177,7 @@ class StackTraceDeserializationCluster : public DeserializationCluster {
       for (RawObject** p = from; p <= to; p++) {
         *p = d->ReadRef();
       }
+      trace->ptr()->is_partial_ = false;
     }
   }
 };
@@ -4418,6 +4534,8 @@ class ArrayDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     bool is_vm_object = d->isolate() == Dart::vm_isolate();
 
@@ -4498,6 +4616,8 @@ class OneByteStringDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     bool is_vm_object = d->isolate() == Dart::vm_isolate();
 
@@ -4575,6 +4695,8 @@ class TwoByteStringDeserializationCluster : public DeserializationCluster {
     stop_index_ = d->next_index();
   }
 
+  bool CanFillConcurrently() const { return true; }
+
   void ReadFill(Deserializer* d) {
     bool is_vm_object = d->isolate() == Dart::vm_isolate();
 
@@ -4704,8 +4826,14 @@ SerializationCluster* Serializer::NewClusterForClass(intptr_t cid) {
           RODataSerializationCluster("(RO)CodeSourceMap", kCodeSourceMapCid);
     case kStackMapCid:
       return new (Z) RODataSerializationCluster("(RO)StackMap", kStackMapCid);
-    case kExceptionHandlersCid:
-      return new (Z) ExceptionHandlersSerializationCluster();
+    case kExceptionHandlersCid: {
+      if (kind_ == Snapshot::kFullAOT) {
+        return new (Z) RODataSerializationCluster("(RO)ExceptionHandlers",
+                                                  kExceptionHandlersCid);
+      } else {
+        return new (Z) ExceptionHandlersSerializationCluster();
+      }
+    }
     case kContextCid:
       return new (Z) ContextSerializationCluster();
     case kContextScopeCid:
@@ -4938,6 +5066,15 @@ static int CompareClusters(SerializationCluster* const* a,
 }
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+void Serializer::WriteFillSize(intptr_t size) {
+  // Fixed width, so the table can be patched after the fill sections.
+  if (!Utils::IsUint(32, size)) {
+    FATAL("Fill section overflow");
+  }
+  uint32_t value = static_cast<uint32_t>(size);
+  WriteBytes(reinterpret_cast<const uint8_t*>(&value), sizeof(value));
+}
+
 void Serializer::Serialize() {
   while (stack_.length() > 0) {
     Trace(stack_.RemoveLast());
@@ -4975,16 +5112,32 @@ void Serializer::Serialize() {
   // We should have assigned a ref to every object we pushed.
   ASSERT((next_ref_index_ - 1) == num_objects);
 
+  // Reserve the table of fill section sizes, patched once they are known.
+  const intptr_t fill_sizes_position = stream_.Position();
+  for (intptr_t i = 0; i < num_clusters; i++) {
+    WriteFillSize(0);
+  }
+
+  GrowableArray<intptr_t> fill_sizes(num_clusters);
   for (intptr_t cid = 1; cid < num_cids_; cid++) {
     SerializationCluster* cluster = clusters_by_cid_[cid];
     if (cluster != NULL) {
+      const intptr_t start = stream_.Position();
       cluster->WriteAndMeasureFill(this);
 #if defined(DEBUG)
       Write<int32_t>(kSectionMarker);
 #endif
+      fill_sizes.Add(stream_.Position() - start);
     }
   }
 
+  const intptr_t fill_end_position = stream_.Position();
+  stream_.SetPosition(fill_sizes_position);
+  for (intptr_t i = 0; i < num_clusters; i++) {
+    WriteFillSize(fill_sizes[i]);
+  }
+  stream_.SetPosition(fill_end_position);
+
 #if !defined(DART_PRECOMPILED_RUNTIME)
   if (FLAG_print_snapshot_sizes_verbose) {
     OS::PrintErr("             Cluster   Objs     Size Fraction Cumulative\n");
@@ -5167,6 +5320,22 @@ Deserializer::Deserializer(Thread* thread,
   }
 }
 
+Deserializer::Deserializer(Thread* thread, const Deserializer& parent)
+    : StackResource(thread),
+      heap_(parent.heap_),
+      zone_(thread->zone()),
+      kind_(parent.kind_),
+      // The same buffer as the parent's stream.
+      stream_(parent.CurrentBufferAddress() - parent.Position(),
+              parent.Position() + parent.PendingBytes()),
+      image_reader_(parent.image_reader_),
+      num_base_objects_(parent.num_base_objects_),
+      num_objects_(parent.num_objects_),
+      num_clusters_(parent.num_clusters_),
+      refs_(parent.refs_),
+      next_ref_index_(parent.next_ref_index_),
+      clusters_(NULL) {}
+
 Deserializer::~Deserializer() {
   delete[] clusters_;
 }
@@ -5227,8 +5396,13 @@ DeserializationCluster* Deserializer::ReadCluster() {
     case kCodeSourceMapCid:
     case kStackMapCid:
       return new (Z) RODataDeserializationCluster();
-    case kExceptionHandlersCid:
-      return new (Z) ExceptionHandlersDeserializationCluster();
+    case kExceptionHandlersCid: {
+      if (kind_ == Snapshot::kFullAOT) {
+        return new (Z) RODataDeserializationCluster();
+      } else {
+        return new (Z) ExceptionHandlersDeserializationCluster();
+      }
+    }
     case kContextCid:
       return new (Z) ContextDeserializationCluster();
     case kContextScopeCid:
@@ -5415,31 +5589,178 @@ void Deserializer::Deserialize() {
   // We should have completely filled the ref array.
   ASSERT((next_ref_index_ - 1) == num_objects_);
 
+  intptr_t* fill_sizes = zone_->Alloc<intptr_t>(num_clusters_);
+  for (intptr_t i = 0; i < num_clusters_; i++) {
+    uint32_t size;
+    ReadBytes(reinterpret_cast<uint8_t*>(&size), sizeof(size));
+    fill_sizes[i] = size;
+  }
+
   {
     NOT_IN_PRODUCT(TimelineDurationScope tds(
         thread(), Timeline::GetIsolateStream(), "ReadFill"));
-    for (intptr_t i = 0; i < num_clusters_; i++) {
-      clusters_[i]->ReadFill(this);
+    if (!ReadFillConcurrently(fill_sizes)) {
+      for (intptr_t i = 0; i < num_clusters_; i++) {
+        clusters_[i]->ReadFill(this);
 #if defined(DEBUG)
-      int32_t section_marker = Read<int32_t>();
-      ASSERT(section_marker == kSectionMarker);
+        int32_t section_marker = Read<int32_t>();
+        ASSERT(section_marker == kSectionMarker);
 #endif
+      }
     }
   }
 }
 
-class HeapLocker : public StackResource {
+// Below this many bytes of concurrent fill data, starting the helper tasks
+// costs more than it saves.
+static const intptr_t kMinConcurrentFillSize = 256 * KB;
+
+class DeserializationFillTask : public ThreadPool::Task {
  public:
-  HeapLocker(Thread* thread, PageSpace* page_space)
-      : StackResource(thread), page_space_(page_space) {
-    page_space_->AcquireDataLock();
+  DeserializationFillTask(Isolate* isolate,
+                          const Deserializer* parent,
+                          DeserializationCluster** clusters,
+                          intptr_t* positions,
+                          intptr_t num_clusters,
+                          Monitor* monitor,
+                          intptr_t* num_busy)
+      : isolate_(isolate),
+        parent_(parent),
+        clusters_(clusters),
+        positions_(positions),
+        num_clusters_(num_clusters),
+        monitor_(monitor),
+        num_busy_(num_busy) {}
+
+  virtual void Run() {
+    bool result = Thread::EnterIsolateAsHelper(
+        isolate_, Thread::kDeserializerTask, true);
+    ASSERT(result);
+    {
+      Deserializer d(Thread::Current(), *parent_);
+      for (intptr_t i = 0; i < num_clusters_; i++) {
+        d.SetPosition(positions_[i]);
+        clusters_[i]->ReadFill(&d);
+#if defined(DEBUG)
+        int32_t section_marker = d.Read<int32_t>();
+        ASSERT(section_marker == kSectionMarker);
+#endif
+      }
+    }
+    Thread::ExitIsolateAsHelper(true);
+
+    MonitorLocker ml(monitor_);
+    (*num_busy_)--;
+    ml.Notify();
   }
-  ~HeapLocker() { page_space_->ReleaseDataLock(); }
 
  private:
-  PageSpace* page_space_;
+  Isolate* isolate_;
+  const Deserializer* parent_;
+  DeserializationCluster** clusters_;
+  intptr_t* positions_;
+  intptr_t num_clusters_;
+  Monitor* monitor_;
+  intptr_t* num_busy_;
+
+  DISALLOW_COPY_AND_ASSIGN(DeserializationFillTask);
 };
 
+bool Deserializer::ReadFillConcurrently(const intptr_t* fill_sizes) {
+  // The VM isolate is read while the VM is still being initialized.
+  if ((FLAG_deserialization_tasks <= 0) ||
+      (isolate() == Dart::vm_isolate())) {
+    return false;
+  }
+
+  intptr_t* positions = zone_->Alloc<intptr_t>(num_clusters_);
+  intptr_t concurrent_size = 0;
+  intptr_t num_concurrent = 0;
+  intptr_t position = Position();
+  for (intptr_t i = 0; i < num_clusters_; i++) {
+    positions[i] = position;
+    position += fill_sizes[i];
+    if (clusters_[i]->CanFillConcurrently()) {
+      concurrent_size += fill_sizes[i];
+      num_concurrent++;
+    }
+  }
+  const intptr_t fill_end = position;
+  if (concurrent_size < kMinConcurrentFillSize) {
+    return false;
+  }
+
+  // Deal the concurrent clusters to the tasks, largest first, each to the
+  // task with the least fill data so far.
+  const intptr_t num_tasks = Utils::Minimum<intptr_t>(
+      FLAG_deserialization_tasks, num_concurrent);
+  GrowableArray<intptr_t> order(num_concurrent);
+  for (intptr_t i = 0; i < num_clusters_; i++) {
+    if (clusters_[i]->CanFillConcurrently()) {
+      intptr_t j = order.length();
+      order.Add(i);
+      while ((j > 0) && (fill_sizes[order[j - 1]] < fill_sizes[i])) {
+        order[j] = order[j - 1];
+        j--;
+      }
+      order[j] = i;
+    }
+  }
+  DeserializationCluster*** task_clusters =
+      zone_->Alloc<DeserializationCluster**>(num_tasks);
+  intptr_t** task_positions = zone_->Alloc<intptr_t*>(num_tasks);
+  intptr_t* task_lengths = zone_->Alloc<intptr_t>(num_tasks);
+  intptr_t* task_sizes = zone_->Alloc<intptr_t>(num_tasks);
+  for (intptr_t t = 0; t < num_tasks; t++) {
+    task_clusters[t] = zone_->Alloc<DeserializationCluster*>(num_concurrent);
+    task_positions[t] = zone_->Alloc<intptr_t>(num_concurrent);
+    task_lengths[t] = 0;
+    task_sizes[t] = 0;
+  }
+  for (intptr_t k = 0; k < order.length(); k++) {
+    const intptr_t i = order[k];
+    intptr_t target = 0;
+    for (intptr_t t = 1; t < num_tasks; t++) {
+      if (task_sizes[t] < task_sizes[target]) {
+        target = t;
+      }
+    }
+    task_clusters[target][task_lengths[target]] = clusters_[i];
+    task_positions[target][task_lengths[target]] = positions[i];
+    task_lengths[target]++;
+    task_sizes[target] += fill_sizes[i];
+  }
+
+  Monitor monitor;
+  intptr_t num_busy = num_tasks;
+  for (intptr_t t = 0; t < num_tasks; t++) {
+    Dart::thread_pool()->Run(new DeserializationFillTask(
+        isolate(), this, task_clusters[t], task_positions[t], task_lengths[t],
+        &monitor, &num_busy));
+  }
+
+  // Fill the remaining clusters here in the meantime.
+  for (intptr_t i = 0; i < num_clusters_; i++) {
+    if (!clusters_[i]->CanFillConcurrently()) {
+      SetPosition(positions[i]);
+      clusters_[i]->ReadFill(this);
+#if defined(DEBUG)
+      int32_t section_marker = Read<int32_t>();
+      ASSERT(section_marker == kSectionMarker);
+#endif
+    }
+  }
+
+  {
+    MonitorLocker ml(&monitor);
+    while (num_busy > 0) {
+      ml.Wait();
+    }
+  }
+  SetPosition(fill_end);
+  return true;
+}
+
 void Deserializer::AddVMIsolateBaseObjects() {
   // These objects are always allocated by Object::InitOnce, so they are not
   // written into the snapshot.
@@ -5495,7 +5816,6 @@ void Deserializer::ReadVMSnapshot() {
 
   {
     NoSafepointScope no_safepoint;
-    HeapLocker hl(thread(), heap_->old_space());
 
     AddVMIsolateBaseObjects();
 
@@ -5521,9 +5841,9 @@ void Deserializer::ReadVMSnapshot() {
     refs_ = NULL;
   }
 
-  // Move remaining bump allocation space to the freelist so it used by C++
+  // Move the rest of the allocation chunk to the freelist so it is used by C++
   // allocations (e.g., FinalizeVMIsolate) before allocating new pages.
-  heap_->old_space()->AbandonBumpAllocation();
+  thread()->ReleaseOldAllocationBuffer();
 
   Symbols::InitOnceFromSnapshot(isolate());
 
@@ -5540,7 +5860,6 @@ void Deserializer::ReadIsolateSnapshot(ObjectStore* object_store) {
 
   {
     NoSafepointScope no_safepoint;
-    HeapLocker hl(thread(), heap_->old_space());
 
     // N.B.: Skipping index 0 because ref 0 is illegal.
     const Array& base_objects = Object::vm_isolate_snapshot_object_table();
@@ -5566,6 +5885,8 @@ void Deserializer::ReadIsolateSnapshot(ObjectStore* object_store) {
     refs_ = NULL;
   }
 
+  // Keep the heap walkable for the verification below and for the mutator.
+  thread()->ReleaseOldAllocationBuffer();
   thread()->isolate()->class_table()->CopySizesFromClassObjects();
 
 #if defined(DEBUG)
@@ -5779,6 +6100,12 @@ void FullSnapshotWriter::WriteIsolateSnapshot(intptr_t num_base_objects) {
   NOT_IN_PRODUCT(TimelineDurationScope tds(
       thread(), Timeline::GetIsolateStream(), "WriteIsolateSnapshot"));
 
+#if defined(DART_PRECOMPILER)
+  if (Snapshot::IncludesCode(kind_)) {
+    isolate_image_writer_->PrepareForSerialization();
+  }
+#endif
+
   Serializer serializer(thread(), kind_, isolate_snapshot_data_buffer_, alloc_,
                         kInitialSize, isolate_image_writer_);
   ObjectStore* object_store = isolate()->object_store();
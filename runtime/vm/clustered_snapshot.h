@@ -47,6 +47,10 @@ class ImageReader;
 // Finally, each cluster is given an opportunity to perform some fix-ups that
 // require the graph has been fully loaded, such as rehashing, though most
 // clusters do not require fixups.
+//
+// The fill section starts with the size of each cluster's fill data, so
+// clusters whose fill only writes their own objects can be filled on helper
+// threads once every object has been allocated.
 
 class SerializationCluster : public ZoneAllocated {
  public:
@@ -90,6 +94,11 @@ class DeserializationCluster : public ZoneAllocated {
   // Initialize the cluster's objects. Do not touch the memory of other objects.
   virtual void ReadFill(Deserializer* deserializer) = 0;
 
+  // Whether ReadFill may run on a helper thread concurrently with the fill of
+  // other clusters: it must only read the stream and refs and write the
+  // cluster's own objects, without allocating or using handles.
+  virtual bool CanFillConcurrently() const { return false; }
+
   // Complete any action that requires the full graph to be deserialized, such
   // as rehashing.
   virtual void PostLoad(const Array& refs, Snapshot::Kind kind, Zone* zone) {}
@@ -265,6 +274,8 @@ class Serializer : public StackResource {
   void DumpCombinedCodeStatistics();
 
  private:
+  void WriteFillSize(intptr_t size);
+
   TypeTestingStubFinder type_testing_stubs_;
   Heap* heap_;
   Zone* zone_;
@@ -297,6 +308,9 @@ class Deserializer : public StackResource {
                const uint8_t* instructions_buffer,
                const uint8_t* shared_data_buffer,
                const uint8_t* shared_instructions_buffer);
+  // Creates a deserializer for the fill section of 'parent' that reads from
+  // its own position, for use on a helper thread.
+  Deserializer(Thread* thread, const Deserializer& parent);
   ~Deserializer();
 
   void ReadIsolateSnapshot(ObjectStore* object_store);
@@ -327,6 +341,9 @@ class Deserializer : public StackResource {
 
   intptr_t PendingBytes() const { return stream_.PendingBytes(); }
 
+  intptr_t Position() const { return stream_.Position(); }
+  void SetPosition(intptr_t value) { stream_.SetPosition(value); }
+
   void AddBaseObject(RawObject* base_object) { AssignRef(base_object); }
 
   void AssignRef(RawObject* object) {
@@ -368,6 +385,11 @@ class Deserializer : public StackResource {
   Snapshot::Kind kind() const { return kind_; }
 
  private:
+  // Fills the clusters that allow it on helper threads and the others on this
+  // thread, leaving the stream after the fill section. Returns false if the
+  // fill section should be read sequentially instead.
+  bool ReadFillConcurrently(const intptr_t* fill_sizes);
+
   Heap* heap_;
   Zone* zone_;
   Snapshot::Kind kind_;
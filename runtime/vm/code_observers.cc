@@ -4,6 +4,8 @@
 
 #include "vm/code_observers.h"
 
+#include "platform/atomic.h"
+#include "vm/lockers.h"
 #include "vm/os.h"
 #include "vm/os_thread.h"
 
@@ -14,6 +16,27 @@ namespace dart {
 Mutex* CodeObservers::mutex_ = NULL;
 intptr_t CodeObservers::observers_length_ = 0;
 CodeObserver** CodeObservers::observers_ = NULL;
+CodeObservers::Record* CodeObservers::pending_ = NULL;
+Monitor* CodeObservers::writer_monitor_ = NULL;
+bool CodeObservers::writer_started_ = false;
+bool CodeObservers::writer_shutdown_ = false;
+ThreadJoinId CodeObservers::writer_id_ = OSThread::kInvalidThreadJoinId;
+
+// How long the writer thread collects records before notifying the
+// asynchronous observers of them.
+static const int64_t kWriterIntervalMillis = 100;
+
+// A code object waiting to be passed to the asynchronous observers. The
+// name is copied right after the record.
+struct CodeObservers::Record {
+  Record* next;
+  uword base;
+  uword prologue_offset;
+  uword size;
+  bool optimized;
+
+  const char* name() const { return reinterpret_cast<const char*>(this + 1); }
+};
 
 void CodeObservers::Register(CodeObserver* observer) {
   observers_length_++;
@@ -31,11 +54,109 @@ void CodeObservers::NotifyAll(const char* name,
                               uword size,
                               bool optimized) {
   ASSERT(!AreActive() || (strlen(name) != 0));
+  bool has_asynchronous = false;
   for (intptr_t i = 0; i < observers_length_; i++) {
     if (observers_[i]->IsActive()) {
-      observers_[i]->Notify(name, base, prologue_offset, size, optimized);
+      if (observers_[i]->IsAsynchronous()) {
+        has_asynchronous = true;
+      } else {
+        observers_[i]->Notify(name, base, prologue_offset, size, optimized);
+      }
     }
   }
+  if (has_asynchronous) {
+    Enqueue(name, base, prologue_offset, size, optimized);
+  }
+}
+
+void CodeObservers::Enqueue(const char* name,
+                            uword base,
+                            uword prologue_offset,
+                            uword size,
+                            bool optimized) {
+  const intptr_t name_length = strlen(name);
+  Record* record =
+      reinterpret_cast<Record*>(malloc(sizeof(Record) + name_length + 1));
+  if (record == NULL) {
+    FATAL("failed to allocate code observer record");
+  }
+  record->base = base;
+  record->prologue_offset = prologue_offset;
+  record->size = size;
+  record->optimized = optimized;
+  memmove(record + 1, name, name_length + 1);
+
+  // The threads creating code never wait for each other or the writer.
+  Record* head;
+  do {
+    head = AtomicOperations::LoadRelaxed(&pending_);
+    record->next = head;
+  } while (AtomicOperations::CompareAndSwapPointer(&pending_, head, record) !=
+           head);
+
+  if (!AtomicOperations::LoadRelaxed(&writer_started_)) {
+    StartWriter();
+  }
+}
+
+void CodeObservers::StartWriter() {
+  MonitorLocker ml(writer_monitor_);
+  if (writer_started_ || writer_shutdown_) {
+    return;
+  }
+  writer_started_ = true;
+  int result = OSThread::Start("Dart CodeObservers", WriterMain, 0);
+  if (result != 0) {
+    FATAL1("Failed to start the code observers thread: %d", result);
+  }
+  while (writer_id_ == OSThread::kInvalidThreadJoinId) {
+    ml.Wait();
+  }
+}
+
+void CodeObservers::WriterMain(uword parameter) {
+  MonitorLocker ml(writer_monitor_);
+  writer_id_ = OSThread::GetCurrentThreadJoinId(OSThread::Current());
+  ml.NotifyAll();
+  while (!writer_shutdown_) {
+    ml.Wait(kWriterIntervalMillis);
+    DrainLocked();
+  }
+}
+
+void CodeObservers::DrainLocked() {
+  Record* records;
+  do {
+    records = AtomicOperations::LoadRelaxed(&pending_);
+  } while (AtomicOperations::CompareAndSwapPointer(
+               &pending_, records, static_cast<Record*>(NULL)) != records);
+  if (records == NULL) {
+    return;
+  }
+  // Restore the order in which the code was created.
+  Record* ordered = NULL;
+  while (records != NULL) {
+    Record* next = records->next;
+    records->next = ordered;
+    ordered = records;
+    records = next;
+  }
+  for (intptr_t i = 0; i < observers_length_; i++) {
+    CodeObserver* observer = observers_[i];
+    if (!observer->IsActive() || !observer->IsAsynchronous()) {
+      continue;
+    }
+    for (Record* record = ordered; record != NULL; record = record->next) {
+      observer->Notify(record->name(), record->base, record->prologue_offset,
+                       record->size, record->optimized);
+    }
+    observer->FlushBatch();
+  }
+  while (ordered != NULL) {
+    Record* next = ordered->next;
+    free(ordered);
+    ordered = next;
+  }
 }
 
 bool CodeObservers::AreActive() {
@@ -46,6 +167,21 @@ bool CodeObservers::AreActive() {
 }
 
 void CodeObservers::DeleteAll() {
+  {
+    MonitorLocker ml(writer_monitor_);
+    writer_shutdown_ = true;
+    ml.NotifyAll();
+  }
+  if (writer_id_ != OSThread::kInvalidThreadJoinId) {
+    OSThread::Join(writer_id_);
+    writer_id_ = OSThread::kInvalidThreadJoinId;
+  }
+  {
+    // Flush the records created since the writer's last batch.
+    MonitorLocker ml(writer_monitor_);
+    DrainLocked();
+  }
+
   for (intptr_t i = 0; i < observers_length_; i++) {
     delete observers_[i];
   }
@@ -58,6 +194,7 @@ void CodeObservers::InitOnce() {
   ASSERT(mutex_ == NULL);
   mutex_ = new Mutex();
   ASSERT(mutex_ != NULL);
+  writer_monitor_ = new Monitor();
   OS::RegisterCodeObservers();
 }
 
@@ -7,6 +7,7 @@
 
 #include "vm/allocation.h"
 #include "vm/globals.h"
+#include "vm/os_thread.h"
 
 namespace dart {
 
@@ -34,6 +35,15 @@ class CodeObserver {
                       uword size,
                       bool optimized) = 0;
 
+  // Returns true if this observer is notified in batches by a background
+  // thread, some time after the code was created, instead of by the thread
+  // creating the code. Such an observer must not read the code itself,
+  // which may have been freed by then.
+  virtual bool IsAsynchronous() const { return false; }
+
+  // Called after each batch of notifications of an asynchronous observer.
+  virtual void FlushBatch() {}
+
  private:
   DISALLOW_COPY_AND_ASSIGN(CodeObserver);
 };
@@ -45,6 +55,7 @@ class CodeObservers : public AllStatic {
   static void Register(CodeObserver* observer);
 
   // Notify all active code observers about a newly created code object.
+  // Asynchronous observers are notified later, from the writer thread.
   static void NotifyAll(const char* name,
                         uword base,
                         uword prologue_offset,
@@ -54,14 +65,36 @@ class CodeObservers : public AllStatic {
   // Returns true if there is at least one active code observer.
   static bool AreActive();
 
+  // Notifies the asynchronous observers of all pending code objects, stops
+  // the writer thread and deletes all observers.
   static void DeleteAll();
 
   static Mutex* mutex() { return mutex_; }
 
  private:
+  struct Record;
+
+  static void Enqueue(const char* name,
+                      uword base,
+                      uword prologue_offset,
+                      uword size,
+                      bool optimized);
+  static void StartWriter();
+  static void WriterMain(uword parameter);
+  // Must be called with writer_monitor_ held.
+  static void DrainLocked();
+
   static Mutex* mutex_;
   static intptr_t observers_length_;
   static CodeObserver** observers_;
+
+  // Pending records, pushed without locking and drained by the writer
+  // thread. Newest first.
+  static Record* pending_;
+  static Monitor* writer_monitor_;
+  static bool writer_started_;
+  static bool writer_shutdown_;
+  static ThreadJoinId writer_id_;
 };
 
 #endif  // !PRODUCT
@@ -6,6 +6,7 @@
 
 #include "vm/longjump.h"
 #include "vm/object_store.h"
+#include "vm/os.h"
 #include "vm/resolver.h"
 #include "vm/symbols.h"
 
@@ -253,4 +254,466 @@ RawObject* CompilationTraceLoader::EvaluateInitializer(const Field& field) {
   return Object::null();
 }
 
+// Type feedback is a sequence of comma separated records, one per line:
+//
+//   C,<index>,<library uri>,<class name>
+//       Names a class referred to by index in later records.
+//   F,<class index>,<field name>,<guarded class index>
+//       Guarded class of an instance field.
+//   U,<class index>,<function name>,<usage counter>,<optimized>
+//       A function, followed by the call sites of its unoptimized code.
+//   I,<deopt id>,<selector>,<number of arguments tested>
+//       A call site with checks, followed by its checks.
+//   R,<count>[,<class index>...]
+//       A check of the preceding call site.
+static const char* kTypeFeedbackHeader = "# type feedback v1\n";
+
+// Marks classes which were not referred to by a class record yet.
+static const intptr_t kNoClassIndex = -2;
+
+TypeFeedbackSaver::TypeFeedbackSaver(Zone* zone)
+    : buf_(zone, 4 * KB),
+      class_indices_(),
+      pending_classes_(),
+      num_classes_(0),
+      cls_(Class::Handle(zone)),
+      lib_(Library::Handle(zone)),
+      uri_(String::Handle(zone)),
+      name_(String::Handle(zone)),
+      fields_(Array::Handle(zone)),
+      field_(Field::Handle(zone)),
+      ic_data_array_(Array::Handle(zone)),
+      ic_data_(ICData::Handle(zone)) {
+  buf_.AddString(kTypeFeedbackHeader);
+}
+
+intptr_t TypeFeedbackSaver::ClassIndex(intptr_t cid) {
+  while (class_indices_.length() <= cid) {
+    class_indices_.Add(kNoClassIndex);
+  }
+  if (class_indices_[cid] != kNoClassIndex) {
+    return class_indices_[cid];
+  }
+  class_indices_[cid] = -1;
+  ClassTable* class_table = Isolate::Current()->class_table();
+  if (!class_table->HasValidClassAt(cid)) {
+    return -1;
+  }
+  cls_ = class_table->At(cid);
+  lib_ = cls_.library();
+  if (lib_.IsNull()) {
+    return -1;
+  }
+  const intptr_t index = num_classes_++;
+  class_indices_[cid] = index;
+  uri_ = lib_.url();
+  name_ = cls_.Name();
+  name_ = String::RemovePrivateKey(name_);
+  buf_.Printf("C,%" Pd ",%s,%s\n", index, uri_.ToCString(), name_.ToCString());
+  pending_classes_.Add(cid);
+  return index;
+}
+
+void TypeFeedbackSaver::WritePendingFields() {
+  ClassTable* class_table = Isolate::Current()->class_table();
+  // Writing a field record can name more classes.
+  for (intptr_t i = 0; i < pending_classes_.length(); i++) {
+    const intptr_t cid = pending_classes_[i];
+    const intptr_t cls_index = class_indices_[cid];
+    cls_ = class_table->At(cid);
+    if (!cls_.is_finalized()) {
+      continue;
+    }
+    fields_ = cls_.fields();
+    for (intptr_t j = 0; j < fields_.Length(); j++) {
+      field_ ^= fields_.At(j);
+      const intptr_t guarded_cid = field_.guarded_cid();
+      if (field_.is_static() || (guarded_cid == kIllegalCid) ||
+          (guarded_cid == kDynamicCid) || (guarded_cid == kNullCid)) {
+        continue;
+      }
+      // ClassIndex clobbers name_.
+      const intptr_t guarded_index = ClassIndex(guarded_cid);
+      if (guarded_index >= 0) {
+        name_ = field_.name();
+        name_ = String::RemovePrivateKey(name_);
+        buf_.Printf("F,%" Pd ",%s,%" Pd "\n", cls_index, name_.ToCString(),
+                    guarded_index);
+      }
+    }
+  }
+  pending_classes_.Clear();
+}
+
+void TypeFeedbackSaver::Visit(const Function& function) {
+  if (!function.HasCode()) {
+    return;  // Not compiled.
+  }
+  if (function.parent_function() != Function::null()) {
+    // Lookup works poorly for local functions.
+    return;
+  }
+
+  const intptr_t cls_index = ClassIndex(Class::Handle(function.Owner()).id());
+  if (cls_index < 0) {
+    return;
+  }
+  name_ = function.name();
+  name_ = String::RemovePrivateKey(name_);
+  buf_.Printf("U,%" Pd ",%s,%" Pd ",%d\n", cls_index, name_.ToCString(),
+              static_cast<intptr_t>(function.usage_counter()),
+              function.HasOptimizedCode() ? 1 : 0);
+
+  ic_data_array_ = function.ic_data_array();
+  if (ic_data_array_.IsNull()) {
+    WritePendingFields();
+    return;
+  }
+  const Array& ic_data_array = Array::Handle(ic_data_array_.raw());
+  GrowableArray<intptr_t> class_ids;
+  GrowableArray<intptr_t> class_indices;
+  for (intptr_t i = 1; i < ic_data_array.Length(); i++) {
+    ic_data_ ^= ic_data_array.At(i);
+    const ICData::RebindRule rule = ic_data_.rebind_rule();
+    if (((rule != ICData::kInstance) && (rule != ICData::kStatic)) ||
+        (ic_data_.NumberOfUsedChecks() == 0)) {
+      continue;
+    }
+    const ICData& ic_data = ICData::Handle(ic_data_.raw());
+    name_ = ic_data.target_name();
+    name_ = String::RemovePrivateKey(name_);
+    buf_.Printf("I,%" Pd ",%s,%" Pd "\n", ic_data.deopt_id(),
+                name_.ToCString(), ic_data.NumArgsTested());
+    for (intptr_t j = 0; j < ic_data.NumberOfChecks(); j++) {
+      const intptr_t count = ic_data.GetCountAt(j);
+      if (count <= 0) {
+        continue;
+      }
+      class_indices.Clear();
+      if (ic_data.NumArgsTested() > 0) {
+        ic_data.GetClassIdsAt(j, &class_ids);
+        for (intptr_t k = 0; k < class_ids.length(); k++) {
+          class_indices.Add(ClassIndex(class_ids[k]));
+        }
+      }
+      buf_.Printf("R,%" Pd, count);
+      for (intptr_t k = 0; k < class_indices.length(); k++) {
+        buf_.Printf(",%" Pd, class_indices[k]);
+      }
+      buf_.AddString("\n");
+    }
+  }
+  WritePendingFields();
+}
+
+TypeFeedbackLoader::TypeFeedbackLoader(Thread* thread)
+    : thread_(thread),
+      zone_(thread->zone()),
+      class_ids_(),
+      ic_data_map_(NULL),
+      optimized_functions_(
+          GrowableObjectArray::Handle(zone_, GrowableObjectArray::New())),
+      uri_(String::Handle(zone_)),
+      name_(String::Handle(zone_)),
+      lib_(Library::Handle(zone_)),
+      cls_(Class::Handle(zone_)),
+      function_(Function::Handle(zone_)),
+      target_(Function::Handle(zone_)),
+      field_(Field::Handle(zone_)),
+      ic_data_(ICData::Handle(zone_)),
+      error_(Object::Handle(zone_)) {}
+
+RawObject* TypeFeedbackLoader::LoadFeedback(uint8_t* buffer, intptr_t size) {
+  char* cursor = reinterpret_cast<char*>(buffer);
+  char* limit = cursor + size;
+  const intptr_t header_length = strlen(kTypeFeedbackHeader);
+  if ((size < header_length) ||
+      (strncmp(cursor, kTypeFeedbackHeader, header_length) != 0)) {
+    return ApiError::New(String::Handle(
+        zone_, String::New("Invalid or incompatible type feedback")));
+  }
+  cursor += header_length;
+
+  char* fields[kMaxRecordFields];
+  while (cursor < limit) {
+    char* newline = FindCharacter(cursor, '\n', limit);
+    if (newline == NULL) {
+      break;
+    }
+    *newline = 0;
+    intptr_t num_fields = 0;
+    char* field = cursor;
+    while (num_fields < kMaxRecordFields) {
+      fields[num_fields++] = field;
+      char* comma = FindCharacter(field, ',', newline);
+      if (comma == NULL) {
+        break;
+      }
+      *comma = 0;
+      field = comma + 1;
+    }
+    cursor = newline + 1;
+
+    if (strlen(fields[0]) != 1) {
+      continue;  // Unknown record.
+    }
+    switch (fields[0][0]) {
+      case 'C':
+        error_ = LoadClass(fields, num_fields);
+        break;
+      case 'F':
+        error_ = LoadField(fields, num_fields);
+        break;
+      case 'U':
+        error_ = LoadFunction(fields, num_fields);
+        break;
+      case 'I':
+        LoadCallSite(fields, num_fields);
+        break;
+      case 'R':
+        LoadCheck(fields, num_fields);
+        break;
+      default:
+        // Unknown record.
+        break;
+    }
+    if (error_.IsError()) {
+      return error_.raw();
+    }
+  }
+
+  return OptimizeFunctions();
+}
+
+intptr_t TypeFeedbackLoader::ClassIdAt(const char* index_cstr) {
+  int64_t index;
+  if (!OS::StringToInt64(index_cstr, &index) || (index < 0) ||
+      (index >= class_ids_.length())) {
+    return kIllegalCid;
+  }
+  return class_ids_[index];
+}
+
+RawObject* TypeFeedbackLoader::LoadClass(char** fields, intptr_t num_fields) {
+  if (num_fields != 4) {
+    return Object::null();
+  }
+  int64_t index;
+  if (!OS::StringToInt64(fields[1], &index) || (index < 0)) {
+    return Object::null();
+  }
+  while (class_ids_.length() <= index) {
+    class_ids_.Add(kIllegalCid);
+  }
+
+  uri_ = Symbols::New(thread_, fields[2]);
+  name_ = Symbols::New(thread_, fields[3]);
+  lib_ = Library::LookupLibrary(thread_, uri_);
+  if (lib_.IsNull()) {
+    // Missing library.
+    return Object::null();
+  }
+  if (name_.Equals(Symbols::TopLevel())) {
+    cls_ = lib_.toplevel_class();
+  } else {
+    cls_ = lib_.SlowLookupClassAllowMultiPartPrivate(name_);
+  }
+  if (cls_.IsNull()) {
+    // Missing class.
+    return Object::null();
+  }
+  error_ = cls_.EnsureIsFinalized(thread_);
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+  class_ids_[index] = cls_.id();
+  return Object::null();
+}
+
+RawObject* TypeFeedbackLoader::LoadField(char** fields, intptr_t num_fields) {
+  if ((num_fields != 4) || !thread_->isolate()->use_field_guards()) {
+    return Object::null();
+  }
+  const intptr_t owner_cid = ClassIdAt(fields[1]);
+  const intptr_t guarded_cid = ClassIdAt(fields[3]);
+  if ((owner_cid == kIllegalCid) || (guarded_cid == kIllegalCid)) {
+    return Object::null();
+  }
+  cls_ = thread_->isolate()->class_table()->At(owner_cid);
+  name_ = Symbols::New(thread_, fields[2]);
+  field_ = cls_.LookupInstanceFieldAllowPrivate(name_);
+  if (field_.IsNull() || (field_.guarded_cid() != kIllegalCid)) {
+    // Missing field, or the program already stored into it.
+    return Object::null();
+  }
+  // Only seed fields which were never stored into. The field is kept
+  // nullable because instances which did not initialize it yet contain
+  // null, this also keeps the field boxed.
+  field_.set_guarded_cid(guarded_cid);
+  field_.set_is_nullable(true);
+  if (field_.needs_length_check()) {
+    field_.set_guarded_list_length(Field::kNoFixedLength);
+    field_.set_guarded_list_length_in_object_offset(
+        Field::kUnknownLengthOffset);
+  }
+  return Object::null();
+}
+
+RawObject* TypeFeedbackLoader::LoadFunction(char** fields,
+                                            intptr_t num_fields) {
+  function_ = Function::null();
+  ic_data_ = ICData::null();
+  ic_data_map_ = NULL;
+  if (num_fields != 5) {
+    return Object::null();
+  }
+  const intptr_t owner_cid = ClassIdAt(fields[1]);
+  int64_t usage_counter;
+  if ((owner_cid == kIllegalCid) ||
+      !OS::StringToInt64(fields[3], &usage_counter)) {
+    return Object::null();
+  }
+  cls_ = thread_->isolate()->class_table()->At(owner_cid);
+  name_ = Symbols::New(thread_, fields[2]);
+  function_ = cls_.LookupFunctionAllowPrivate(name_);
+  if (function_.IsNull() || function_.is_abstract()) {
+    function_ = Function::null();
+    return Object::null();
+  }
+
+  error_ = Compiler::EnsureUnoptimizedCode(thread_, function_);
+  if (error_.IsError()) {
+    return error_.raw();
+  }
+  ic_data_map_ = new (zone_) ZoneGrowableArray<const ICData*>();
+  function_.RestoreICDataMap(ic_data_map_, /* clone_ic_data = */ false);
+
+  if (usage_counter > function_.usage_counter()) {
+    function_.SetUsageCounter(
+        Utils::Minimum(usage_counter, static_cast<int64_t>(kMaxInt32)));
+  }
+  if (strcmp(fields[4], "1") == 0) {
+    optimized_functions_.Add(function_);
+  }
+  return Object::null();
+}
+
+void TypeFeedbackLoader::LoadCallSite(char** fields, intptr_t num_fields) {
+  ic_data_ = ICData::null();
+  int64_t deopt_id;
+  int64_t num_args_tested;
+  if ((num_fields != 4) || (ic_data_map_ == NULL) ||
+      !OS::StringToInt64(fields[1], &deopt_id) ||
+      !OS::StringToInt64(fields[3], &num_args_tested) || (deopt_id < 0) ||
+      (deopt_id >= ic_data_map_->length()) ||
+      ((*ic_data_map_)[deopt_id] == NULL)) {
+    return;
+  }
+  const ICData& ic_data = *(*ic_data_map_)[deopt_id];
+  name_ = ic_data.target_name();
+  name_ = String::RemovePrivateKey(name_);
+  if (!name_.Equals(fields[2]) ||
+      (ic_data.NumArgsTested() != num_args_tested)) {
+    // The program changed, the feedback is for a different call.
+    return;
+  }
+  const ICData::RebindRule rule = ic_data.rebind_rule();
+  if ((rule != ICData::kInstance) && (rule != ICData::kStatic)) {
+    return;
+  }
+  ic_data_ = ic_data.raw();
+}
+
+bool TypeFeedbackLoader::HasCheck(const GrowableArray<intptr_t>& class_ids) {
+  GrowableArray<intptr_t> existing;
+  for (intptr_t i = 0; i < ic_data_.NumberOfChecks(); i++) {
+    ic_data_.GetClassIdsAt(i, &existing);
+    bool matches = true;
+    for (intptr_t k = 0; k < class_ids.length(); k++) {
+      if (existing[k] != class_ids[k]) {
+        matches = false;
+        break;
+      }
+    }
+    if (matches) return true;
+  }
+  return false;
+}
+
+void TypeFeedbackLoader::LoadCheck(char** fields, intptr_t num_fields) {
+  int64_t count;
+  if (ic_data_.IsNull() || !OS::StringToInt64(fields[1], &count) ||
+      (count <= 0) || (num_fields != 2 + ic_data_.NumArgsTested())) {
+    return;
+  }
+  const intptr_t saturated_count =
+      Utils::Minimum(count, static_cast<int64_t>(Smi::kMaxValue));
+
+  if (ic_data_.NumArgsTested() == 0) {
+    // Static call without class checks: only the count is interesting.
+    if (ic_data_.NumberOfChecks() > 0) {
+      ic_data_.SetCountAt(0, Utils::Maximum(ic_data_.GetCountAt(0),
+                                            saturated_count));
+    }
+    return;
+  }
+
+  GrowableArray<intptr_t> class_ids(ic_data_.NumArgsTested());
+  for (intptr_t k = 0; k < ic_data_.NumArgsTested(); k++) {
+    const intptr_t cid = ClassIdAt(fields[2 + k]);
+    if (cid == kIllegalCid) {
+      return;
+    }
+    class_ids.Add(cid);
+  }
+  if (HasCheck(class_ids)) {
+    return;
+  }
+
+  if (ic_data_.rebind_rule() == ICData::kStatic) {
+    // Static calls testing arguments keep their target.
+    target_ = ic_data_.GetTargetAt(0);
+  } else {
+    cls_ = thread_->isolate()->class_table()->At(class_ids[0]);
+    name_ = ic_data_.target_name();
+    const ArgumentsDescriptor args_desc(
+        Array::Handle(zone_, ic_data_.arguments_descriptor()));
+    target_ = Resolver::ResolveDynamicForReceiverClass(cls_, name_, args_desc);
+  }
+  if (target_.IsNull()) {
+    return;
+  }
+  if (ic_data_.NumArgsTested() == 1) {
+    ic_data_.AddReceiverCheck(class_ids[0], target_, saturated_count);
+  } else {
+    ic_data_.AddCheck(class_ids, target_, saturated_count);
+  }
+}
+
+RawObject* TypeFeedbackLoader::OptimizeFunctions() {
+  Isolate* isolate = thread_->isolate();
+  for (intptr_t i = 0; i < optimized_functions_.Length(); i++) {
+    function_ ^= optimized_functions_.At(i);
+    if (function_.HasOptimizedCode() ||
+        !Compiler::CanOptimizeFunction(thread_, function_)) {
+      continue;
+    }
+    if (FLAG_background_compilation &&
+        !BackgroundCompiler::IsDisabled(isolate) &&
+        function_.is_background_optimizable()) {
+      // See DRT_OptimizeInvokedFunction.
+      function_.SetUsageCounter(INT_MIN);
+      BackgroundCompiler::Start(isolate);
+      isolate->background_compiler()->CompileOptimized(function_);
+    } else {
+      function_.SetUsageCounter(0);
+      error_ = Compiler::CompileOptimizedFunction(thread_, function_);
+      if (error_.IsError()) {
+        return error_.raw();
+      }
+    }
+  }
+  return Object::null();
+}
+
 }  // namespace dart
@@ -59,6 +59,79 @@ class CompilationTraceLoader : public ValueObject {
   Object& error_;
 };
 
+// Records type feedback collected by unoptimized code: receiver classes and
+// counts of call sites, usage counters, field guard states and the list of
+// optimized functions. Like the compilation trace the feedback refers to
+// classes and functions by name, so it can be loaded into a slightly
+// different program.
+class TypeFeedbackSaver : public FunctionVisitor {
+ public:
+  explicit TypeFeedbackSaver(Zone* zone);
+  void Visit(const Function& function);
+
+  void StealBuffer(uint8_t** buffer, intptr_t* buffer_length) {
+    *buffer = reinterpret_cast<uint8_t*>(buf_.buffer());
+    *buffer_length = buf_.length();
+  }
+
+ private:
+  // Returns the index of the class record for the given class id, writing
+  // the record first if needed. Returns -1 for classes that cannot be named.
+  intptr_t ClassIndex(intptr_t cid);
+  // Write field records of the classes named since the last call.
+  void WritePendingFields();
+
+  ZoneTextBuffer buf_;
+  GrowableArray<intptr_t> class_indices_;
+  GrowableArray<intptr_t> pending_classes_;
+  intptr_t num_classes_;
+  Class& cls_;
+  Library& lib_;
+  String& uri_;
+  String& name_;
+  Array& fields_;
+  Field& field_;
+  Array& ic_data_array_;
+  ICData& ic_data_;
+};
+
+class TypeFeedbackLoader : public ValueObject {
+ public:
+  explicit TypeFeedbackLoader(Thread* thread);
+
+  RawObject* LoadFeedback(uint8_t* buffer, intptr_t buffer_length);
+
+ private:
+  static const intptr_t kMaxRecordFields = 8;
+
+  RawObject* LoadClass(char** fields, intptr_t num_fields);
+  RawObject* LoadField(char** fields, intptr_t num_fields);
+  RawObject* LoadFunction(char** fields, intptr_t num_fields);
+  void LoadCallSite(char** fields, intptr_t num_fields);
+  void LoadCheck(char** fields, intptr_t num_fields);
+  RawObject* OptimizeFunctions();
+
+  // Returns the class id for the given class record index, or kIllegalCid
+  // if the class is missing in this program.
+  intptr_t ClassIdAt(const char* index_cstr);
+  bool HasCheck(const GrowableArray<intptr_t>& class_ids);
+
+  Thread* thread_;
+  Zone* zone_;
+  GrowableArray<intptr_t> class_ids_;
+  ZoneGrowableArray<const ICData*>* ic_data_map_;
+  const GrowableObjectArray& optimized_functions_;
+  String& uri_;
+  String& name_;
+  Library& lib_;
+  Class& cls_;
+  Function& function_;
+  Function& target_;
+  Field& field_;
+  ICData& ic_data_;
+  Object& error_;
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_COMPILATION_TRACE_H_
@@ -36,6 +36,8 @@ DEFINE_FLAG(int,
             "If a call receiver is known to be of at most this many classes, "
             "generate exhaustive class tests instead of a megamorphic call");
 
+DECLARE_FLAG(bool, closed_world_devirtualization);
+
 // Quick access to the current isolate and zone.
 #define I (isolate())
 #define Z (zone())
@@ -876,6 +878,9 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
   Definition* callee_receiver = instr->ArgumentAt(receiver_idx);
   const Function& function = flow_graph()->function();
   Class& receiver_class = Class::Handle(Z);
+  // Whether the receiver is only known to implement receiver_class, so that
+  // its possible classes come from the closed world analysis instead of CHA.
+  bool closed_world = false;
 
   if (function.IsDynamicFunction() &&
       flow_graph()->IsReceiver(callee_receiver)) {
@@ -888,13 +893,21 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
         !type->ToAbstractType()->IsDynamicType() && !type->is_nullable()) {
       receiver_class = type->ToAbstractType()->type_class();
       if (receiver_class.is_implemented()) {
-        receiver_class = Class::null();
+        if ((precompiler_ != NULL) && FLAG_closed_world_devirtualization) {
+          closed_world = true;
+        } else {
+          receiver_class = Class::null();
+        }
       }
     }
   }
   if (!receiver_class.IsNull()) {
     GrowableArray<intptr_t> class_ids(6);
-    if (thread()->cha()->ConcreteSubclasses(receiver_class, &class_ids)) {
+    const bool has_class_ids =
+        closed_world
+            ? precompiler_->ConcreteSubtypes(receiver_class, &class_ids)
+            : thread()->cha()->ConcreteSubclasses(receiver_class, &class_ids);
+    if (has_class_ids) {
       // First check if all subclasses end up calling the same method.
       // If this is the case we will replace instance call with a direct
       // static call.
@@ -980,6 +993,11 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
         // within the whole hierarchy. Replace InstanceCall with StaticCall.
         const Function& target = Function::ZoneHandle(Z, single_target.raw());
         StaticCallInstr* call = StaticCallInstr::FromCall(Z, instr, target);
+        if (precompiler_ != NULL) {
+          precompiler_->RecordDevirtualizedCall(
+              function, instr->function_name(), receiver_class,
+              class_ids.length(), /*num_checks=*/1, closed_world);
+        }
         instr->ReplaceWith(call, current_iterator());
         return;
       } else if ((ic_data.raw() != ICData::null()) &&
@@ -988,14 +1006,20 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
         PolymorphicInstanceCallInstr* call =
             new (Z) PolymorphicInstanceCallInstr(instr, *targets,
                                                  /* complete = */ true);
+        if (precompiler_ != NULL) {
+          precompiler_->RecordDevirtualizedCall(
+              function, instr->function_name(), receiver_class,
+              class_ids.length(), targets->length(), closed_world);
+        }
         instr->ReplaceWith(call, current_iterator());
         return;
       }
     }
 
     // Detect if o.m(...) is a call through a getter and expand it
-    // into o.get:m().call(...).
-    if (TryExpandCallThroughGetter(receiver_class, instr)) {
+    // into o.get:m().call(...). The lookup of the getter is only valid for
+    // subclasses of receiver_class.
+    if (!closed_world && TryExpandCallThroughGetter(receiver_class, instr)) {
       return;
     }
   }
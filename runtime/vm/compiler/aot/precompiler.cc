@@ -27,11 +27,13 @@
 #include "vm/dart_entry.h"
 #include "vm/exceptions.h"
 #include "vm/flags.h"
+#include "vm/hash.h"
 #include "vm/hash_table.h"
 #include "vm/isolate.h"
 #include "vm/json_writer.h"
 #include "vm/log.h"
 #include "vm/longjump.h"
+#include "vm/megamorphic_cache_table.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
 #include "vm/os.h"
@@ -64,6 +66,26 @@ DEFINE_FLAG(
     1,
     "Max number of attempts with speculative inlining (precompilation only)");
 DEFINE_FLAG(int, precompiler_rounds, 1, "Number of precompiler iterations");
+DEFINE_FLAG(bool,
+            closed_world_devirtualization,
+            true,
+            "Devirtualize instance calls on interface types using the "
+            "closed world class hierarchy.");
+DEFINE_FLAG(charp,
+            print_devirtualized_calls_to,
+            NULL,
+            "Print instance calls devirtualized by the precompiler as JSON to "
+            "the given file.");
+DEFINE_FLAG(charp,
+            print_function_fingerprints_to,
+            NULL,
+            "Print the functions compiled by the precompiler with a "
+            "fingerprint of their source and of the source of the functions "
+            "inlined into them as JSON to the given file.");
+DEFINE_FLAG(bool,
+            use_dispatch_table,
+            true,
+            "Build a global dispatch table for megamorphic instance calls.");
 
 DECLARE_FLAG(bool, print_flow_graph);
 DECLARE_FLAG(bool, print_flow_graph_optimized);
@@ -254,7 +276,11 @@ Precompiler::Precompiler(Thread* thread)
       consts_to_retain_(),
       field_type_map_(),
       error_(Error::Handle()),
-      get_runtime_type_is_unique_(false) {}
+      get_runtime_type_is_unique_(false),
+      closed_world_subtypes_(),
+      devirtualized_calls_(),
+      devirtualized_call_count_(0),
+      compiled_functions_() {}
 
 void Precompiler::DoCompileAll(
     Dart_QualifiedFunctionName embedder_entry_points[]) {
@@ -274,6 +300,10 @@ void Precompiler::DoCompileAll(
 
       ClassFinalizer::SortClasses();
 
+      // The class hierarchy is now closed. Compute the concrete subtypes of
+      // every class so calls on interface types can be devirtualized.
+      ComputeClosedWorldSubtypes();
+
       // Collects type usage information which allows us to decide when/how to
       // optimize runtime type tests.
       TypeUsageInfo type_usage_info(T);
@@ -326,6 +356,9 @@ void Precompiler::DoCompileAll(
 
       I->set_compilation_allowed(false);
 
+      PrintDevirtualizedCalls();
+      PrintFunctionFingerprints();
+
       TraceForRetainedFunctions();
       DropFunctions();
       DropFields();
@@ -360,6 +393,7 @@ void Precompiler::DoCompileAll(
 
     BindStaticCalls();
     SwitchICCalls();
+    BuildDispatchTable();
     Obfuscate();
 
     ProgramVisitor::Dedup();
@@ -381,6 +415,8 @@ void Precompiler::DoCompileAll(
     THR_Print("Precompiled %" Pd " functions,", function_count_);
     THR_Print(" %" Pd " dynamic types,", class_count_);
     THR_Print(" %" Pd " dynamic selectors.\n", selector_count_);
+    THR_Print("Devirtualized %" Pd " instance calls.\n",
+              devirtualized_call_count_);
 
     THR_Print("Dropped %" Pd " functions,", dropped_function_count_);
     THR_Print(" %" Pd " fields,", dropped_field_count_);
@@ -977,6 +1013,9 @@ void Precompiler::ProcessFunction(const Function& function) {
     if (!error_.IsNull()) {
       Jump(error_);
     }
+    if (FLAG_print_function_fingerprints_to != NULL) {
+      compiled_functions_.Add(&Function::ZoneHandle(Z, function.raw()));
+    }
     // Used in the JIT to save type-feedback across compilations.
     function.ClearICDataArray();
   } else {
@@ -2538,6 +2577,259 @@ void Precompiler::SwitchICCalls() {
 #endif
 }
 
+// A row of the global dispatch table: a dynamically invoked name together with
+// the number of arguments (including the receiver) of its targets, and the
+// target for each allocated class that has one.
+class DispatchTableSelector : public ZoneAllocated {
+ public:
+  DispatchTableSelector(const String* name, intptr_t num_args)
+      : name_(name), num_args_(num_args), row_(0), cids_(), targets_() {}
+
+  const String* name() const { return name_; }
+  intptr_t num_args() const { return num_args_; }
+  intptr_t row() const { return row_; }
+  void set_row(intptr_t row) { row_ = row; }
+
+  // Class ids are added in increasing order.
+  void Add(intptr_t cid, const Function* target) {
+    cids_.Add(cid);
+    targets_.Add(target);
+  }
+  intptr_t length() const { return cids_.length(); }
+  intptr_t cid(intptr_t i) const { return cids_[i]; }
+  const GrowableArray<intptr_t>& cids() const { return cids_; }
+  const Function* target(intptr_t i) const { return targets_[i]; }
+
+ private:
+  const String* name_;
+  intptr_t num_args_;
+  intptr_t row_;
+  GrowableArray<intptr_t> cids_;
+  GrowableArray<const Function*> targets_;
+};
+
+class DispatchTableSelectorKeyValueTrait {
+ public:
+  // Typedefs needed for the DirectChainedHashMap template.
+  typedef const DispatchTableSelector* Key;
+  typedef DispatchTableSelector* Value;
+  typedef DispatchTableSelector* Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+
+  static Value ValueOf(Pair kv) { return kv; }
+
+  static inline intptr_t Hashcode(Key key) {
+    return CombineHashes(key->name()->Hash(), key->num_args());
+  }
+
+  static inline bool IsKeyEqual(Pair pair, Key key) {
+    return (pair->name()->raw() == key->name()->raw()) &&
+           (pair->num_args() == key->num_args());
+  }
+};
+
+typedef DirectChainedHashMap<DispatchTableSelectorKeyValueTrait>
+    DispatchTableSelectorMap;
+
+static int CompareSelectorsByLength(DispatchTableSelector* const* a,
+                                    DispatchTableSelector* const* b) {
+  // Place the largest rows first, they are the hardest to fit.
+  return (*b)->length() - (*a)->length();
+}
+
+static int CompareSelectorsByHash(DispatchTableSelector* const* a,
+                                  DispatchTableSelector* const* b) {
+  const intptr_t hash_a = (*a)->name()->Hash();
+  const intptr_t hash_b = (*b)->name()->Hash();
+  if (hash_a != hash_b) {
+    return hash_a < hash_b ? -1 : 1;
+  }
+  return (*a)->num_args() - (*b)->num_args();
+}
+
+bool DispatchTableRowAssigner::Fits(const GrowableArray<intptr_t>& cids,
+                                    intptr_t row) const {
+  ASSERT(row + num_cids_ >= 0);
+  if ((row + num_cids_ < used_rows_.length()) && used_rows_[row + num_cids_]) {
+    return false;
+  }
+  for (intptr_t i = 0; i < cids.length(); i++) {
+    const intptr_t index = row + cids[i];
+    if ((index < used_entries_.length()) && used_entries_[index]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+intptr_t DispatchTableRowAssigner::Assign(const GrowableArray<intptr_t>& cids) {
+  ASSERT(!cids.is_empty());
+  ASSERT(cids.Last() < num_cids_);
+  intptr_t row = first_free_ - cids[0];
+  while (!Fits(cids, row)) {
+    row++;
+  }
+  while (used_rows_.length() <= row + num_cids_) {
+    used_rows_.Add(false);
+  }
+  used_rows_[row + num_cids_] = true;
+  for (intptr_t i = 0; i < cids.length(); i++) {
+    const intptr_t index = row + cids[i];
+    while (used_entries_.length() <= index) {
+      used_entries_.Add(false);
+    }
+    used_entries_[index] = true;
+  }
+  while ((first_free_ < used_entries_.length()) &&
+         used_entries_[first_free_]) {
+    first_free_++;
+  }
+  return row;
+}
+
+// Builds a row displacement table that maps (selector row + receiver class
+// id) to the target of the selector for that class. Megamorphic caches of
+// these selectors refer to their row, so the megamorphic call stub finds the
+// target with an indexed load instead of a hash probe. The cache is still
+// probed for receivers without an entry, e.g. noSuchMethod and call-through-
+// getter invocations.
+//
+// The targets for a class are found the way Resolver::ResolveDynamicAnyArgs
+// finds them: the first non-abstract instance function with the selector's
+// name in the superclass chain. A selector only gets an entry for a class if
+// that function takes exactly the selector's number of positional arguments.
+void Precompiler::BuildDispatchTable() {
+  if (!FLAG_use_dispatch_table) {
+    return;
+  }
+
+  ClassTable* class_table = I->class_table();
+  const intptr_t num_cids = class_table->NumCids();
+  Class& cls = Class::Handle(Z);
+  Class& super = Class::Handle(Z);
+  Array& functions = Array::Handle(Z);
+  Function& function = Function::Handle(Z);
+  String& name = String::Handle(Z);
+
+  DispatchTableSelectorMap selector_map;
+  GrowableArray<DispatchTableSelector*> selectors;
+  SymbolSet seen_names;
+  for (intptr_t cid = kInstanceCid; cid < num_cids; cid++) {
+    if (!class_table->HasValidClassAt(cid)) {
+      continue;
+    }
+    cls = class_table->At(cid);
+    if (cls.is_abstract() || !cls.is_finalized() || !cls.is_allocated()) {
+      continue;
+    }
+    seen_names.Clear();
+    for (super = cls.raw(); !super.IsNull(); super = super.SuperClass()) {
+      functions = super.functions();
+      for (intptr_t i = 0; i < functions.Length(); i++) {
+        function ^= functions.At(i);
+        if (!function.IsDynamicFunction(/*allow_abstract=*/false)) {
+          continue;
+        }
+        name = function.name();
+        if (!IsSent(name) || seen_names.HasKey(&name)) {
+          continue;
+        }
+        seen_names.Insert(&String::ZoneHandle(Z, name.raw()));
+        if (function.HasOptionalParameters() || !function.HasCode()) {
+          continue;
+        }
+        switch (function.kind()) {
+          case RawFunction::kRegularFunction:
+          case RawFunction::kGetterFunction:
+          case RawFunction::kSetterFunction:
+          case RawFunction::kImplicitGetter:
+          case RawFunction::kImplicitSetter:
+          case RawFunction::kMethodExtractor:
+            break;
+          default:
+            continue;
+        }
+
+        DispatchTableSelector key(&name, function.num_fixed_parameters());
+        DispatchTableSelector* selector = selector_map.LookupValue(&key);
+        if (selector == NULL) {
+          selector = new (Z) DispatchTableSelector(
+              &String::ZoneHandle(Z, name.raw()),
+              function.num_fixed_parameters());
+          selector_map.Insert(selector);
+          selectors.Add(selector);
+        }
+        selector->Add(cid, &Function::ZoneHandle(Z, function.raw()));
+      }
+    }
+  }
+
+  // Assign rows, largest selectors first.
+  selectors.Sort(CompareSelectorsByLength);
+  DispatchTableRowAssigner assigner(num_cids);
+  for (intptr_t i = 0; i < selectors.length(); i++) {
+    DispatchTableSelector* selector = selectors[i];
+    selector->set_row(assigner.Assign(selector->cids()));
+  }
+
+  const intptr_t kEntryLength =
+      MegamorphicCacheTable::kDispatchTableEntryLength;
+  const Array& table =
+      Array::Handle(Z, Array::New(assigner.length() * kEntryLength,
+                                  Heap::kOld));
+  for (intptr_t i = 0; i < selectors.length(); i++) {
+    DispatchTableSelector* selector = selectors[i];
+    const Smi& row = Smi::Handle(Z, Smi::New(selector->row()));
+    for (intptr_t j = 0; j < selector->length(); j++) {
+      const intptr_t index =
+          (selector->row() + selector->cid(j)) * kEntryLength;
+      table.SetAt(index + MegamorphicCacheTable::kDispatchTableRowIndex, row);
+      table.SetAt(index + MegamorphicCacheTable::kDispatchTableTargetIndex,
+                  *selector->target(j));
+    }
+  }
+
+  selectors.Sort(CompareSelectorsByHash);
+  const intptr_t kSelectorLength =
+      MegamorphicCacheTable::kDispatchSelectorEntryLength;
+  const Array& selector_table = Array::Handle(
+      Z, Array::New(selectors.length() * kSelectorLength, Heap::kOld));
+  Smi& smi = Smi::Handle(Z);
+  for (intptr_t i = 0; i < selectors.length(); i++) {
+    DispatchTableSelector* selector = selectors[i];
+    const intptr_t base = i * kSelectorLength;
+    selector_table.SetAt(
+        base + MegamorphicCacheTable::kDispatchSelectorNameIndex,
+        *selector->name());
+    smi = Smi::New(selector->num_args());
+    selector_table.SetAt(
+        base + MegamorphicCacheTable::kDispatchSelectorNumArgsIndex, smi);
+    smi = Smi::New(selector->row());
+    selector_table.SetAt(
+        base + MegamorphicCacheTable::kDispatchSelectorRowIndex, smi);
+  }
+
+  I->object_store()->set_dispatch_table(table);
+  I->object_store()->set_dispatch_table_selectors(selector_table);
+
+  // Caches created during precompilation predate the table.
+  const GrowableObjectArray& caches = GrowableObjectArray::Handle(
+      Z, I->object_store()->megamorphic_cache_table());
+  if (!caches.IsNull()) {
+    MegamorphicCache& cache = MegamorphicCache::Handle(Z);
+    for (intptr_t i = 0; i < caches.Length(); i++) {
+      cache ^= caches.At(i);
+      MegamorphicCacheTable::AttachDispatchTableRow(I, cache);
+    }
+  }
+
+  if (FLAG_trace_precompiler) {
+    THR_Print("Dispatch table: %" Pd " selectors, %" Pd " entries.\n",
+              selectors.length(), assigner.length());
+  }
+}
+
 void Precompiler::Obfuscate() {
   if (!I->obfuscate()) {
     return;
@@ -2614,6 +2906,228 @@ void Precompiler::Obfuscate() {
   I->object_store()->set_obfuscation_map(Array::Handle(Z));
 }
 
+void Precompiler::ComputeClosedWorldSubtypes() {
+  if (!FLAG_closed_world_devirtualization) {
+    return;
+  }
+
+  ClassTable* class_table = I->class_table();
+  const intptr_t num_cids = class_table->NumCids();
+  closed_world_subtypes_.Clear();
+  for (intptr_t cid = 0; cid < num_cids; cid++) {
+    closed_world_subtypes_.Add(NULL);
+  }
+
+  // Visit the supertypes of every concrete class: its superclasses and,
+  // transitively, their interfaces (which include mixins).
+  GrowableArray<intptr_t> visited_by(num_cids);
+  for (intptr_t cid = 0; cid < num_cids; cid++) {
+    visited_by.Add(kIllegalCid);
+  }
+  GrowableArray<intptr_t> worklist;
+  Class& cls = Class::Handle(Z);
+  Class& super = Class::Handle(Z);
+  Array& interfaces = Array::Handle(Z);
+  AbstractType& type = AbstractType::Handle(Z);
+  for (intptr_t cid = kInstanceCid; cid < num_cids; cid++) {
+    if (!class_table->HasValidClassAt(cid)) {
+      continue;
+    }
+    cls = class_table->At(cid);
+    if (cls.is_abstract() || !cls.is_finalized() || cls.IsTypedefClass()) {
+      continue;
+    }
+    ASSERT(worklist.is_empty());
+    worklist.Add(cid);
+    visited_by[cid] = cid;
+    while (!worklist.is_empty()) {
+      const intptr_t super_cid = worklist.RemoveLast();
+      ZoneGrowableArray<intptr_t>* subtypes = closed_world_subtypes_[super_cid];
+      if (subtypes == NULL) {
+        subtypes = new (Z) ZoneGrowableArray<intptr_t>();
+        closed_world_subtypes_[super_cid] = subtypes;
+      }
+      subtypes->Add(cid);
+
+      super = class_table->At(super_cid);
+      interfaces = super.interfaces();
+      const intptr_t num_interfaces =
+          interfaces.IsNull() ? 0 : interfaces.Length();
+      for (intptr_t i = -1; i < num_interfaces; i++) {
+        if (i < 0) {
+          type = super.super_type();
+        } else {
+          type ^= interfaces.At(i);
+        }
+        if (type.IsNull() || !type.HasResolvedTypeClass()) {
+          continue;
+        }
+        const intptr_t next_cid = type.type_class_id();
+        if ((next_cid < num_cids) && (visited_by[next_cid] != cid)) {
+          visited_by[next_cid] = cid;
+          worklist.Add(next_cid);
+        }
+      }
+    }
+  }
+}
+
+bool Precompiler::ConcreteSubtypes(const Class& cls,
+                                   GrowableArray<intptr_t>* cids) const {
+  if (cls.InVMHeap() || cls.IsObjectClass()) {
+    return false;
+  }
+  const intptr_t cid = cls.id();
+  if (cid >= closed_world_subtypes_.length()) {
+    // Unknown class or the subtypes were not computed.
+    return false;
+  }
+  ZoneGrowableArray<intptr_t>* subtypes = closed_world_subtypes_[cid];
+  if (subtypes != NULL) {
+    // Concrete classes were visited in increasing class id order.
+    for (intptr_t i = 0; i < subtypes->length(); i++) {
+      cids->Add(subtypes->At(i));
+    }
+  }
+  return true;
+}
+
+void Precompiler::RecordDevirtualizedCall(const Function& caller,
+                                          const String& selector,
+                                          const Class& receiver_class,
+                                          intptr_t num_classes,
+                                          intptr_t num_checks,
+                                          bool closed_world) {
+  devirtualized_call_count_++;
+  if (FLAG_print_devirtualized_calls_to == NULL) {
+    return;
+  }
+  DevirtualizedCall call;
+  call.caller = &Function::ZoneHandle(Z, caller.raw());
+  call.selector = &String::ZoneHandle(Z, selector.raw());
+  call.receiver_class = &Class::ZoneHandle(Z, receiver_class.raw());
+  call.num_classes = num_classes;
+  call.num_checks = num_checks;
+  call.closed_world = closed_world;
+  devirtualized_calls_.Add(call);
+}
+
+// Prints the devirtualized calls as a JSON array of objects with the calling
+// function, the selector, the receiver's static type, the number of concrete
+// receiver classes and class id range checks (1 for a static call), and
+// whether the closed world analysis was needed to find them.
+void Precompiler::PrintDevirtualizedCalls() {
+  if (FLAG_print_devirtualized_calls_to == NULL) {
+    return;
+  }
+
+  JSONWriter writer;
+  writer.OpenArray();
+  String& name = String::Handle(Z);
+  for (intptr_t i = 0; i < devirtualized_calls_.length(); i++) {
+    const DevirtualizedCall& call = devirtualized_calls_[i];
+    writer.OpenObject();
+    name = call.caller->QualifiedUserVisibleName();
+    writer.PrintPropertyStr("caller", name);
+    writer.PrintPropertyStr("selector", *call.selector);
+    name = call.receiver_class->ScrubbedName();
+    writer.PrintPropertyStr("receiver", name);
+    writer.PrintProperty64("classes", call.num_classes);
+    writer.PrintProperty64("checks", call.num_checks);
+    writer.PrintPropertyBool("closedWorld", call.closed_world);
+    writer.CloseObject();
+  }
+  writer.CloseArray();
+
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  Dart_FileCloseCallback file_close = Dart::file_close_callback();
+  if ((file_open == NULL) || (file_write == NULL) || (file_close == NULL)) {
+    return;
+  }
+  void* out_stream =
+      file_open(FLAG_print_devirtualized_calls_to, /* write = */ true);
+  if (out_stream == NULL) {
+    OS::PrintErr("Failed to open file %s\n", FLAG_print_devirtualized_calls_to);
+    return;
+  }
+  const char* contents = writer.ToCString();
+  file_write(contents, strlen(contents), out_stream);
+  file_close(out_stream);
+}
+
+static uint32_t SourceFingerprintOf(const Function& function) {
+  // Functions without kernel, such as implicit closures and dispatchers,
+  // are derived from the fingerprinted functions they belong to.
+  if (function.kernel_offset() <= 0) {
+    return 0;
+  }
+  return function.SourceFingerprint();
+}
+
+// Prints the functions compiled by the precompiler as a JSON array of objects
+// with the qualified function name, the size of its code, and a fingerprint
+// combining the source fingerprints of the function and of every function
+// inlined into it. A compiled function whose fingerprint did not change
+// between two builds was compiled from the same source; its code can still
+// differ if the class hierarchy or the type flow facts it relied on changed.
+void Precompiler::PrintFunctionFingerprints() {
+  if (FLAG_print_function_fingerprints_to == NULL) {
+    return;
+  }
+
+  JSONWriter writer;
+  writer.OpenArray();
+  Code& code = Code::Handle(Z);
+  Array& inlined = Array::Handle(Z);
+  Function& inlined_function = Function::Handle(Z);
+  for (intptr_t i = 0; i < compiled_functions_.length(); i++) {
+    const Function& function = *compiled_functions_[i];
+    if (!function.HasCode()) {
+      continue;
+    }
+    code = function.CurrentCode();
+    uint32_t hash = SourceFingerprintOf(function);
+    intptr_t num_inlined = 0;
+    inlined = code.inlined_id_to_function();
+    if (!inlined.IsNull()) {
+      for (intptr_t j = 0; j < inlined.Length(); j++) {
+        inlined_function ^= inlined.At(j);
+        if (inlined_function.raw() == function.raw()) {
+          continue;
+        }
+        hash = CombineHashes(hash, SourceFingerprintOf(inlined_function));
+        num_inlined++;
+      }
+    }
+    writer.OpenObject();
+    writer.PrintProperty("function",
+                         function.ToLibNamePrefixedQualifiedCString());
+    writer.PrintProperty64("fingerprint", FinalizeHash(hash, String::kHashBits));
+    writer.PrintProperty64("inlined", num_inlined);
+    writer.PrintProperty64("size", code.Size());
+    writer.CloseObject();
+  }
+  writer.CloseArray();
+
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  Dart_FileCloseCallback file_close = Dart::file_close_callback();
+  if ((file_open == NULL) || (file_write == NULL) || (file_close == NULL)) {
+    return;
+  }
+  void* out_stream =
+      file_open(FLAG_print_function_fingerprints_to, /* write = */ true);
+  if (out_stream == NULL) {
+    OS::PrintErr("Failed to open file %s\n",
+                 FLAG_print_function_fingerprints_to);
+    return;
+  }
+  const char* contents = writer.ToCString();
+  file_write(contents, strlen(contents), out_stream);
+  file_close(out_stream);
+}
+
 void Precompiler::FinalizeAllClasses() {
   Library& lib = Library::Handle(Z);
   Class& cls = Class::Handle(Z);
@@ -320,6 +320,34 @@ struct FunctionFeedbackPair {
 
 typedef DirectChainedHashMap<FunctionFeedbackPair> FunctionFeedbackMap;
 
+// Places the rows of the global dispatch table built by
+// Precompiler::BuildDispatchTable. The entry of a selector for receivers of
+// class cid is at index row + cid. The megamorphic call stub only checks that
+// the entry it loads has the row of the called selector, so no two selectors
+// may share an entry or a row.
+class DispatchTableRowAssigner : public ValueObject {
+ public:
+  explicit DispatchTableRowAssigner(intptr_t num_cids)
+      : num_cids_(num_cids), used_entries_(), used_rows_(), first_free_(0) {}
+
+  // Returns the row of a selector with entries for the given class ids, which
+  // are increasing and less than num_cids. Rows may be negative as long as
+  // all entries of the selector have a non-negative index.
+  intptr_t Assign(const GrowableArray<intptr_t>& cids);
+
+  // The number of entries of the table.
+  intptr_t length() const { return used_entries_.length(); }
+
+ private:
+  bool Fits(const GrowableArray<intptr_t>& cids, intptr_t row) const;
+
+  const intptr_t num_cids_;
+  GrowableArray<bool> used_entries_;
+  // Indexed by row + num_cids_.
+  GrowableArray<bool> used_rows_;
+  intptr_t first_free_;
+};
+
 class Precompiler : public ValueObject {
  public:
   static RawError* CompileAll(
@@ -344,6 +372,20 @@ class Precompiler : public ValueObject {
 
   FieldTypeMap* field_type_map() { return &field_type_map_; }
 
+  // Adds the ids of all concrete classes that are subtypes of [cls] in the
+  // closed world of the precompiled program, in increasing order. Returns
+  // false if they are not known.
+  bool ConcreteSubtypes(const Class& cls, GrowableArray<intptr_t>* cids) const;
+
+  // Records an instance call that was replaced by a static call or by
+  // [num_checks] class id range tests, for --print-devirtualized-calls-to.
+  void RecordDevirtualizedCall(const Function& caller,
+                               const String& selector,
+                               const Class& receiver_class,
+                               intptr_t num_classes,
+                               intptr_t num_checks,
+                               bool closed_world);
+
   static void PopulateWithICData(const Function& func, FlowGraph* graph);
 
  private:
@@ -390,6 +432,7 @@ class Precompiler : public ValueObject {
 
   void BindStaticCalls();
   void SwitchICCalls();
+  void BuildDispatchTable();
   void ResetPrecompilerState();
 
   void Obfuscate();
@@ -401,6 +444,10 @@ class Precompiler : public ValueObject {
 
   void FinalizeAllClasses();
 
+  void ComputeClosedWorldSubtypes();
+  void PrintDevirtualizedCalls();
+  void PrintFunctionFingerprints();
+
   Thread* thread() const { return thread_; }
   Zone* zone() const { return zone_; }
   Isolate* isolate() const { return isolate_; }
@@ -437,6 +484,23 @@ class Precompiler : public ValueObject {
   Error& error_;
 
   bool get_runtime_type_is_unique_;
+
+  // Concrete subtypes of each class, indexed by class id.
+  GrowableArray<ZoneGrowableArray<intptr_t>*> closed_world_subtypes_;
+
+  struct DevirtualizedCall {
+    const Function* caller;
+    const String* selector;
+    const Class* receiver_class;
+    intptr_t num_classes;
+    intptr_t num_checks;
+    bool closed_world;
+  };
+  GrowableArray<DevirtualizedCall> devirtualized_calls_;
+  intptr_t devirtualized_call_count_;
+
+  // Functions compiled by ProcessFunction, if their fingerprints are printed.
+  GrowableArray<const Function*> compiled_functions_;
 };
 
 class FunctionsTraits {
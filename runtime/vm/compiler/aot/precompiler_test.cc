@@ -0,0 +1,86 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/aot/precompiler.h"
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER)
+
+static void AddCids(GrowableArray<intptr_t>* cids,
+                    intptr_t first,
+                    intptr_t last,
+                    intptr_t step) {
+  for (intptr_t cid = first; cid <= last; cid += step) {
+    cids->Add(cid);
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(DispatchTableRowsOfInterleavedSelectors) {
+  const intptr_t kNumCids = 20;
+  // Selectors with interleaved class ids, e.g. {5, 7} and {6}, placed largest
+  // first like Precompiler::BuildDispatchTable does.
+  GrowableArray<intptr_t> odd;
+  AddCids(&odd, 5, 19, 2);
+  GrowableArray<intptr_t> even;
+  AddCids(&even, 6, 18, 2);
+  GrowableArray<intptr_t> pair;
+  pair.Add(5);
+  pair.Add(7);
+  GrowableArray<intptr_t> single;
+  single.Add(6);
+  GrowableArray<intptr_t> other_single;
+  other_single.Add(8);
+  GrowableArray<intptr_t>* selectors[] = {&odd, &even, &pair, &single,
+                                          &other_single};
+  const intptr_t kNumSelectors = ARRAY_SIZE(selectors);
+
+  DispatchTableRowAssigner assigner(kNumCids);
+  intptr_t rows[kNumSelectors];
+  for (intptr_t i = 0; i < kNumSelectors; i++) {
+    rows[i] = assigner.Assign(*selectors[i]);
+  }
+
+  // Fill the table with the index of the selector owning each entry.
+  GrowableArray<intptr_t> owners(assigner.length());
+  for (intptr_t i = 0; i < assigner.length(); i++) {
+    owners.Add(-1);
+  }
+  for (intptr_t i = 0; i < kNumSelectors; i++) {
+    for (intptr_t j = 0; j < selectors[i]->length(); j++) {
+      const intptr_t index = rows[i] + selectors[i]->At(j);
+      EXPECT(index >= 0);
+      EXPECT(index < assigner.length());
+      EXPECT_EQ(-1, owners[index]);
+      owners[index] = i;
+    }
+  }
+
+  // The stub only compares rows: a selector may only find the row it looks
+  // for in its own entries.
+  for (intptr_t i = 0; i < kNumSelectors; i++) {
+    for (intptr_t k = i + 1; k < kNumSelectors; k++) {
+      EXPECT(rows[i] != rows[k]);
+    }
+    for (intptr_t cid = 0; cid < kNumCids; cid++) {
+      const intptr_t index = rows[i] + cid;
+      if ((index < 0) || (index >= assigner.length()) ||
+          (owners[index] == -1)) {
+        continue;
+      }
+      const bool hit = rows[owners[index]] == rows[i];
+      bool has_entry = false;
+      for (intptr_t j = 0; j < selectors[i]->length(); j++) {
+        has_entry = has_entry || (selectors[i]->At(j) == cid);
+      }
+      EXPECT_EQ(has_entry, hit);
+    }
+  }
+}
+
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
@@ -28,13 +28,24 @@ DEFINE_FLAG(bool,
 DEFINE_FLAG(bool, use_far_branches, false, "Enable far branches for ARM.");
 #endif
 
-static uword NewContents(intptr_t capacity) {
-  Zone* zone = Thread::Current()->zone();
-  uword result = zone->AllocUnsafe(capacity);
+static const intptr_t kInitialBufferCapacity = 4 * KB;
+
+static uword NewContents(intptr_t* capacity) {
+  intptr_t reused_capacity = 0;
+  uword result = Thread::Current()->TakeAssemblerBuffer(&reused_capacity);
+  if (result == 0) {
+    result = reinterpret_cast<uword>(malloc(kInitialBufferCapacity));
+    if (result == 0) {
+      OUT_OF_MEMORY();
+    }
+    *capacity = kInitialBufferCapacity;
+  } else {
+    *capacity = reused_capacity;
+  }
 #if defined(DEBUG)
   // Initialize the buffer with kBreakPointInstruction to force a break
   // point if we ever execute an uninitialized part of the code buffer.
-  Assembler::InitializeMemoryWithBreakpoints(result, capacity);
+  Assembler::InitializeMemoryWithBreakpoints(result, *capacity);
 #endif
   return result;
 }
@@ -67,11 +78,12 @@ AssemblerBuffer::EnsureCapacity::~EnsureCapacity() {
 #endif
 
 AssemblerBuffer::AssemblerBuffer()
-    : pointer_offsets_(new ZoneGrowableArray<intptr_t>(16)) {
-  static const intptr_t kInitialBufferCapacity = 4 * KB;
-  contents_ = NewContents(kInitialBufferCapacity);
+    : pointer_offsets_(new ZoneGrowableArray<intptr_t>(16)),
+      contents_scope_(this) {
+  intptr_t capacity = 0;
+  contents_ = NewContents(&capacity);
   cursor_ = contents_;
-  limit_ = ComputeLimit(contents_, kInitialBufferCapacity);
+  limit_ = ComputeLimit(contents_, capacity);
   fixup_ = NULL;
 #if defined(DEBUG)
   has_ensured_capacity_ = false;
@@ -79,12 +91,19 @@ AssemblerBuffer::AssemblerBuffer()
 #endif
 
   // Verify internal state.
-  ASSERT(Capacity() == kInitialBufferCapacity);
+  ASSERT(Capacity() == capacity);
   ASSERT(Size() == 0);
 }
 
 AssemblerBuffer::~AssemblerBuffer() {}
 
+AssemblerBuffer::ContentsScope::~ContentsScope() {
+  thread()->ReleaseAssemblerBuffer(buffer_->contents_, buffer_->Capacity());
+  buffer_->contents_ = 0;
+  buffer_->cursor_ = 0;
+  buffer_->limit_ = kMinimumGap;
+}
+
 void AssemblerBuffer::ProcessFixups(const MemoryRegion& region) {
   AssemblerFixup* fixup = fixup_;
   while (fixup != NULL) {
@@ -114,10 +133,16 @@ void AssemblerBuffer::ExtendCapacity() {
     FATAL("Unexpected overflow in AssemblerBuffer::ExtendCapacity");
   }
 
-  // Allocate the new data area and copy contents of the old one to it.
-  uword new_contents = NewContents(new_capacity);
-  memmove(reinterpret_cast<void*>(new_contents),
-          reinterpret_cast<void*>(contents_), old_size);
+  // Grow the data area, in place if the allocator can.
+  uword new_contents = reinterpret_cast<uword>(
+      realloc(reinterpret_cast<void*>(contents_), new_capacity));
+  if (new_contents == 0) {
+    OUT_OF_MEMORY();
+  }
+#if defined(DEBUG)
+  Assembler::InitializeMemoryWithBreakpoints(new_contents + old_capacity,
+                                             new_capacity - old_capacity);
+#endif
 
   // Compute the relocation delta and switch to the new contents area.
   intptr_t delta = new_contents - contents_;
@@ -141,6 +141,9 @@ class AssemblerFixup : public ZoneAllocated {
 };
 
 // Assembler buffers are used to emit binary code. They grow on demand.
+// The data area is malloced and handed back to the thread on destruction,
+// so that the next compilation on the thread starts with a buffer that is
+// large enough, instead of growing and copying a fresh one.
 class AssemblerBuffer : public ValueObject {
  public:
   AssemblerBuffer();
@@ -254,6 +257,18 @@ class AssemblerBuffer : public ValueObject {
   // for a single, fast space check per instruction.
   static const intptr_t kMinimumGap = 32;
 
+  // Returns the data area to the thread, also when compilation bails out
+  // with a long jump past the destructor of the buffer.
+  class ContentsScope : public StackResource {
+   public:
+    explicit ContentsScope(AssemblerBuffer* buffer)
+        : StackResource(Thread::Current()), buffer_(buffer) {}
+    ~ContentsScope();
+
+   private:
+    AssemblerBuffer* buffer_;
+  };
+
   uword contents_;
   uword cursor_;
   uword limit_;
@@ -262,6 +277,7 @@ class AssemblerBuffer : public ValueObject {
 #if defined(DEBUG)
   bool fixups_processed_;
 #endif
+  ContentsScope contents_scope_;
 
   uword cursor() const { return cursor_; }
   uword limit() const { return limit_; }
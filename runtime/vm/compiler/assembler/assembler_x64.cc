@@ -9,6 +9,7 @@
 #include "vm/compiler/backend/locations.h"
 #include "vm/cpu.h"
 #include "vm/heap/heap.h"
+#include "vm/heap/pages.h"
 #include "vm/instructions.h"
 #include "vm/memory_region.h"
 #include "vm/runtime_entry.h"
@@ -291,6 +292,32 @@ void Assembler::EmitSimple(int opcode, int opcode2) {
   }
 }
 
+void Assembler::EmitVex(int dst,
+                        int src1,
+                        int src2,
+                        int opcode,
+                        VexPrefix prefix) {
+  ASSERT(TargetCPUFeatures::avx_supported());
+  ASSERT(dst <= XMM15);
+  ASSERT(src1 <= XMM15);
+  ASSERT(src2 <= XMM15);
+  AssemblerBuffer::EnsureCapacity ensured(&buffer_);
+  // R, X, B and vvvv are stored inverted. L is zero for 128-bit operations.
+  const uint8_t r_bit = (dst > 7) ? 0 : 0x80;
+  const uint8_t vvvv_l_pp = ((~src1 & 0xF) << 3) | prefix;
+  if (src2 > 7) {
+    // Only the three-byte form can encode B. X is unused, map is 0F.
+    EmitUint8(0xC4);
+    EmitUint8(r_bit | 0x40 | 0x01);
+    EmitUint8(vvvv_l_pp);
+  } else {
+    EmitUint8(0xC5);
+    EmitUint8(r_bit | vvvv_l_pp);
+  }
+  EmitUint8(opcode);
+  EmitRegisterOperand(dst & 7, src2);
+}
+
 void Assembler::EmitQ(int dst, int src, int opcode, int prefix2, int prefix1) {
   ASSERT(src <= XMM15);
   ASSERT(dst <= XMM15);
@@ -1251,9 +1278,71 @@ void Assembler::StoreIntoObject(Register object,
                                 CanBeSmi can_be_smi) {
   ASSERT(object != value);
   movq(dest, value);
-  Label done;
+  Label done, update;
+  if (FLAG_concurrent_mark) {
+    // While the old generation is marked concurrently, every store of a heap
+    // object into an old object is recorded in the store buffer.
+    Label not_marking;
+    cmpq(Address(THR, Thread::marking_active_offset()), Immediate(0));
+    j(EQUAL, &not_marking, kNearJump);
+    if (can_be_smi == kValueCanBeSmi) {
+      testq(value, Immediate(kSmiTagMask));
+      j(ZERO, &done, kNearJump);
+    }
+    testq(object, Immediate(kNewObjectAlignmentOffset));
+    j(ZERO, &update, kNearJump);
+    jmp(&done, kNearJump);
+    Bind(&not_marking);
+  }
+  StoreIntoObjectFilter(object, value, &done, can_be_smi, kJumpToNoUpdate);
+  // A store buffer update is required.
+  Bind(&update);
+  if (value != RDX) pushq(RDX);
+  if (object != RDX) {
+    movq(RDX, object);
+  }
+  call(Address(THR, Thread::update_store_buffer_entry_point_offset()));
+
+  if (value != RDX) popq(RDX);
+  Bind(&done);
+}
+
+void Assembler::StoreIntoArray(Register object,
+                               Register slot,
+                               Register value,
+                               CanBeSmi can_be_smi) {
+  ASSERT(object != value);
+  ASSERT((slot != object) && (slot != value));
+  movq(Address(slot, 0), value);
+  Label done, update;
+  if (FLAG_concurrent_mark) {
+    // While marking, the whole array is remembered (see StoreIntoObject).
+    Label not_marking;
+    cmpq(Address(THR, Thread::marking_active_offset()), Immediate(0));
+    j(EQUAL, &not_marking, kNearJump);
+    if (can_be_smi == kValueCanBeSmi) {
+      testq(value, Immediate(kSmiTagMask));
+      j(ZERO, &done, kNearJump);
+    }
+    testq(object, Immediate(kNewObjectAlignmentOffset));
+    j(ZERO, &update, kNearJump);
+    jmp(&done, kNearJump);
+    Bind(&not_marking);
+  }
   StoreIntoObjectFilter(object, value, &done, can_be_smi, kJumpToNoUpdate);
+  testb(FieldAddress(object, Object::tags_offset()),
+        Immediate(1 << RawObject::kCardRememberedBit));
+  j(ZERO, &update, kNearJump);
+  // Dirty the card covering the slot: page->card_table_[offset >> shift] = 1.
+  movq(TMP, object);
+  andq(TMP, Immediate(kPageMask));
+  subq(slot, TMP);
+  shrq(slot, Immediate(HeapPage::kBytesPerCardLog2));
+  movq(TMP, Address(TMP, HeapPage::card_table_offset()));
+  movb(Address(TMP, slot, TIMES_1, 0), Immediate(1));
+  jmp(&done, kNearJump);
   // A store buffer update is required.
+  Bind(&update);
   if (value != RDX) pushq(RDX);
   if (object != RDX) {
     movq(RDX, object);
@@ -427,6 +427,29 @@ class Assembler : public ValueObject {
 #undef AX
 #undef XA
 
+// Three-operand AVX forms, dst = src1 op src2. Only available if
+// TargetCPUFeatures::avx_supported().
+#define DECLARE_AVX(name, code)                                                \
+  void v##name##ps(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVexNoPrefix);                       \
+  }                                                                            \
+  void v##name##pd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVex66Prefix);                       \
+  }                                                                            \
+  void v##name##ss(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVexF3Prefix);                       \
+  }                                                                            \
+  void v##name##sd(XmmRegister dst, XmmRegister src1, XmmRegister src2) {      \
+    EmitVex(dst, src1, src2, 0x50 + code, kVexF2Prefix);                       \
+  }
+  DECLARE_AVX(add, 0x8)
+  DECLARE_AVX(mul, 0x9)
+  DECLARE_AVX(sub, 0xC)
+  DECLARE_AVX(min, 0xD)
+  DECLARE_AVX(div, 0xE)
+  DECLARE_AVX(max, 0xF)
+#undef DECLARE_AVX
+
 #define DECLARE_CMPPS(name, code)                                              \
   void cmpps##name(XmmRegister dst, XmmRegister src) {                         \
     EmitL(dst, src, 0xC2, 0x0F);                                               \
@@ -719,6 +742,13 @@ class Assembler : public ValueObject {
                        Register value,       // Value we are storing.
                        CanBeSmi can_be_smi = kValueCanBeSmi);
 
+  // Stores into an element of an Array. Destroys slot, the address of the
+  // element; large arrays remember the written card instead of the object.
+  void StoreIntoArray(Register object,  // Array we are storing into.
+                      Register slot,    // Address of the element.
+                      Register value,   // Value we are storing.
+                      CanBeSmi can_be_smi = kValueCanBeSmi);
+
   void StoreIntoObjectNoBarrier(Register object,
                                 const Address& dest,
                                 Register value);
@@ -1029,6 +1059,17 @@ class Assembler : public ValueObject {
              int prefix1 = -1);
   void CmpPS(XmmRegister dst, XmmRegister src, int condition);
 
+  // The implied legacy prefix, encoded in the pp field of the VEX prefix.
+  enum VexPrefix {
+    kVexNoPrefix = 0,
+    kVex66Prefix = 1,
+    kVexF3Prefix = 2,
+    kVexF2Prefix = 3,
+  };
+  // Emits a 128-bit VEX-encoded instruction from the 0F opcode map with
+  // register operands.
+  void EmitVex(int dst, int src1, int src2, int opcode, VexPrefix prefix);
+
   inline void EmitUint8(uint8_t value);
   inline void EmitInt32(int32_t value);
   inline void EmitUInt32(uint32_t value);
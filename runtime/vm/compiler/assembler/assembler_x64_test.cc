@@ -6,6 +6,7 @@
 #if defined(TARGET_ARCH_X64)
 
 #include "vm/compiler/assembler/assembler.h"
+#include "vm/cpu.h"
 #include "vm/os.h"
 #include "vm/unit_test.h"
 #include "vm/virtual_memory.h"
@@ -3187,6 +3188,69 @@ ASSEMBLER_TEST_RUN(PackedDoubleSub, test) {
       "ret\n");
 }
 
+ASSEMBLER_TEST_GENERATE(PackedDoubleAddAVX, assembler) {
+  static const struct ALIGN16 {
+    double a;
+    double b;
+  } constant0 = {1.0, 2.0};
+  static const struct ALIGN16 {
+    double a;
+    double b;
+  } constant1 = {3.0, 4.0};
+  __ movq(RAX, Immediate(reinterpret_cast<uword>(&constant0)));
+  __ movups(XMM10, Address(RAX, 0));
+  __ movq(RAX, Immediate(reinterpret_cast<uword>(&constant1)));
+  __ movups(XMM11, Address(RAX, 0));
+  if (TargetCPUFeatures::avx_supported()) {
+    __ vaddpd(XMM0, XMM10, XMM11);
+  } else {
+    __ movaps(XMM0, XMM10);
+    __ addpd(XMM0, XMM11);
+  }
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(PackedDoubleAddAVX, test) {
+  typedef double (*PackedDoubleAddAVX)();
+  double res = reinterpret_cast<PackedDoubleAddAVX>(test->entry())();
+  EXPECT_FLOAT_EQ(4.0, res, 0.000001f);
+  if (TargetCPUFeatures::avx_supported()) {
+    EXPECT_DISASSEMBLY_ENDS_WITH(
+        "movups xmm11,[rax]\n"
+        "vaddpd xmm0,xmm10,xmm11\n"
+        "ret\n");
+  }
+}
+
+ASSEMBLER_TEST_GENERATE(DoubleSubAVX, assembler) {
+  __ movq(RAX, Immediate(12));
+  __ cvtsi2sdq(XMM9, RAX);
+  __ movq(RAX, Immediate(2));
+  __ cvtsi2sdq(XMM1, RAX);
+  if (TargetCPUFeatures::avx_supported()) {
+    // The first source is left intact.
+    __ vsubsd(XMM0, XMM9, XMM1);
+    __ vmulsd(XMM0, XMM0, XMM9);
+  } else {
+    __ movaps(XMM0, XMM9);
+    __ subsd(XMM0, XMM1);
+    __ mulsd(XMM0, XMM9);
+  }
+  __ ret();
+}
+
+ASSEMBLER_TEST_RUN(DoubleSubAVX, test) {
+  typedef double (*DoubleSubAVX)();
+  double res = reinterpret_cast<DoubleSubAVX>(test->entry())();
+  EXPECT_FLOAT_EQ(120.0, res, 0.000001f);
+  if (TargetCPUFeatures::avx_supported()) {
+    EXPECT_DISASSEMBLY_ENDS_WITH(
+        "vsubsd xmm0,xmm9,xmm1\n"
+        "vmulsd xmm0,xmm0,xmm9\n"
+        "ret\n");
+  }
+}
+
 static void EnterTestFrame(Assembler* assembler) {
   COMPILE_ASSERT(THR != CallingConventions::kArg1Reg);
   COMPILE_ASSERT(CODE_REG != CallingConventions::kArg2Reg);
@@ -344,6 +344,9 @@ class DisassemblerX64 : public ValueObject {
   const char* TwoByteMnemonic(uint8_t opcode);
   int TwoByteOpcodeInstruction(uint8_t* data);
   int Print660F38Instruction(uint8_t* data);
+#if defined(TARGET_ARCH_X64)
+  int AVXInstruction(uint8_t* data);
+#endif
   void CheckPrintStop(uint8_t* data);
 
   int F6F7Instruction(uint8_t* data);
@@ -1230,6 +1233,62 @@ int DisassemblerX64::Print660F38Instruction(uint8_t* current) {
 }
 
 // Called when disassembling test eax, 0xXXXXX.
+#if defined(TARGET_ARCH_X64)
+// Handles the VEX-encoded three-operand SSE arithmetic instructions.
+int DisassemblerX64::AVXInstruction(uint8_t* data) {
+  uint8_t* current = data;
+  // The VEX prefix stores R, X, B and vvvv inverted. Translate R, X, B and W
+  // into an equivalent REX prefix so that the ModRM helpers can be reused.
+  uint8_t rex = 0x40;
+  uint8_t vvvv_l_pp;
+  if (*current == 0xC5) {
+    if ((current[1] & 0x80) == 0) rex |= 0x04;
+    vvvv_l_pp = current[1];
+    current += 2;
+  } else {
+    ASSERT(*current == 0xC4);
+    if ((current[1] & 0x1F) != 0x01) {
+      // Only the 0F opcode map is supported.
+      UnimplementedInstruction();
+    }
+    if ((current[1] & 0x80) == 0) rex |= 0x04;
+    if ((current[1] & 0x40) == 0) rex |= 0x02;
+    if ((current[1] & 0x20) == 0) rex |= 0x01;
+    if ((current[2] & 0x80) != 0) rex |= 0x08;
+    vvvv_l_pp = current[2];
+    current += 3;
+  }
+  setRex(rex);
+  const int vvvv = (~vvvv_l_pp >> 3) & 0xF;
+  const uint8_t opcode = *current++;
+  if ((opcode < 0x51) || (opcode > 0x5F) || ((vvvv_l_pp & 0x04) != 0)) {
+    UnimplementedInstruction();
+  }
+  const XmmMnemonic& names = xmm_instructions[opcode & 0xF];
+  const char* mnemonic = NULL;
+  switch (vvvv_l_pp & 0x3) {
+    case 0:
+      mnemonic = names.ps_name;
+      break;
+    case 1:
+      mnemonic = names.pd_name;
+      break;
+    case 2:
+      mnemonic = names.ss_name;
+      break;
+    default:
+      mnemonic = names.sd_name;
+      break;
+  }
+  int mod, regop, rm;
+  get_modrm(*current, &mod, &regop, &rm);
+  Print("v%s %s,%s,", mnemonic, NameOfXMMRegister(regop),
+        NameOfXMMRegister(vvvv));
+  current += PrintRightXMMOperand(current);
+  return current - data;
+}
+#endif  // defined(TARGET_ARCH_X64)
+
 void DisassemblerX64::CheckPrintStop(uint8_t* data) {
 #if defined(TARGET_ARCH_IA32)
   // Recognize stop pattern.
@@ -1617,6 +1676,13 @@ int DisassemblerX64::InstructionDecode(uword pc) {
 
   if (!processed) {
     switch (*data) {
+#if defined(TARGET_ARCH_X64)
+      case 0xC4:  // Three-byte VEX prefix.
+      case 0xC5:  // Two-byte VEX prefix.
+        data += AVXInstruction(data);
+        break;
+#endif
+
       case 0xC2:
         Print("ret ");
         PrintImmediateValue(*reinterpret_cast<uint16_t*>(data + 1));
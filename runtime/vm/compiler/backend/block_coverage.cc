@@ -0,0 +1,113 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/block_coverage.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/object_store.h"
+
+namespace dart {
+
+// Returns the token positions of the calls in 'block', which unoptimized code
+// records ICData for, or NULL if there are none.
+static const Array* BlockPositions(Zone* zone, BlockEntryInstr* block) {
+  GrowableArray<intptr_t> positions;
+  for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if ((current->IsInstanceCall() || current->IsStaticCall()) &&
+        current->token_pos().IsReal()) {
+      positions.Add(current->token_pos().value());
+    }
+  }
+  if (positions.is_empty()) {
+    return NULL;
+  }
+  const Array& array =
+      Array::ZoneHandle(zone, Array::New(positions.length(), Heap::kOld));
+  Smi& position = Smi::Handle(zone);
+  for (intptr_t i = 0; i < positions.length(); i++) {
+    position = Smi::New(positions[i]);
+    array.SetAt(i, position);
+  }
+  return &array;
+}
+
+void BlockCoverage::Instrument(FlowGraph* flow_graph) {
+  Zone* zone = flow_graph->zone();
+  GrowableArray<BlockEntryInstr*> blocks;
+  GrowableArray<const Array*> block_positions;
+  for (BlockIterator it = flow_graph->reverse_postorder_iterator(); !it.Done();
+       it.Advance()) {
+    BlockEntryInstr* block = it.Current();
+    // Catch entries and the graph entry start with definitions.
+    if (!block->IsTargetEntry() && !block->IsJoinEntry()) {
+      continue;
+    }
+    const Array* positions = BlockPositions(zone, block);
+    if (positions != NULL) {
+      blocks.Add(block);
+      block_positions.Add(positions);
+    }
+  }
+  if (blocks.is_empty()) {
+    return;
+  }
+
+  const intptr_t num_blocks = blocks.length();
+  const Array& hits =
+      Array::ZoneHandle(zone, Array::New(num_blocks, Heap::kOld));
+  const Array& positions =
+      Array::Handle(zone, Array::New(num_blocks, Heap::kOld));
+  const Smi& zero = Smi::Handle(zone, Smi::New(0));
+  for (intptr_t i = 0; i < num_blocks; i++) {
+    hits.SetAt(i, zero);
+    positions.SetAt(i, *block_positions[i]);
+  }
+  const Array& record =
+      Array::ZoneHandle(zone, Array::New(kRecordSize, Heap::kOld));
+  record.SetAt(kFunctionIndex, flow_graph->function());
+  record.SetAt(kHitsIndex, hits);
+  record.SetAt(kPositionsIndex, positions);
+  flow_graph->AddBlockCoverageRecord(record);
+
+  // A store of a Smi constant needs no barrier: each block costs one store.
+  ConstantInstr* hits_constant = flow_graph->GetConstant(hits);
+  ConstantInstr* one =
+      flow_graph->GetConstant(Smi::ZoneHandle(zone, Smi::New(1)));
+  for (intptr_t i = 0; i < num_blocks; i++) {
+    ConstantInstr* index =
+        flow_graph->GetConstant(Smi::ZoneHandle(zone, Smi::New(i)));
+    StoreIndexedInstr* store = new (zone) StoreIndexedInstr(
+        new (zone) Value(hits_constant), new (zone) Value(index),
+        new (zone) Value(one), kNoStoreBarrier,
+        Instance::ElementSizeFor(kArrayCid), kArrayCid, kAlignedAccess,
+        Thread::kNoDeoptId, TokenPosition::kNoSource);
+    flow_graph->InsertAfter(blocks[i], store, NULL, FlowGraph::kEffect);
+  }
+}
+
+void BlockCoverage::Register(Thread* thread, FlowGraph* flow_graph) {
+  const ZoneGrowableArray<const Array*>* records =
+      flow_graph->block_coverage_records();
+  if (records == NULL) {
+    return;
+  }
+  ObjectStore* object_store = thread->isolate()->object_store();
+  GrowableObjectArray& all_records = GrowableObjectArray::Handle(
+      thread->zone(), object_store->block_coverage_records());
+  if (all_records.IsNull()) {
+    all_records = GrowableObjectArray::New(Heap::kOld);
+    object_store->set_block_coverage_records(all_records);
+  }
+  for (intptr_t i = 0; i < records->length(); i++) {
+    all_records.Add(*records->At(i), Heap::kOld);
+  }
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
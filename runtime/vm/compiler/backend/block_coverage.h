@@ -0,0 +1,39 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_BLOCK_COVERAGE_H_
+#define RUNTIME_VM_COMPILER_BACKEND_BLOCK_COVERAGE_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+class Thread;
+
+// With --optimized_coverage, optimized code marks which of its blocks ran,
+// so that coverage of code running only after optimization, when the ICData
+// counters of the unoptimized code no longer count, can still be reported.
+//
+// Each instrumented graph gets a record, an Array of
+// [function, hits, positions]. The first instruction of a block containing
+// calls stores Smi 1 into its slot of hits. The same slot of positions holds
+// an Array of the token positions of these calls, the positions at which
+// SourceReport reports coverage.
+class BlockCoverage : public AllStatic {
+ public:
+  enum { kFunctionIndex = 0, kHitsIndex, kPositionsIndex, kRecordSize };
+
+  // Instruments the blocks of a freshly built graph and adds its record to
+  // flow_graph->block_coverage_records().
+  static void Instrument(FlowGraph* flow_graph);
+
+  // Makes the records of the compiled flow_graph visible to SourceReport.
+  // Must run on the mutator thread or at a safepoint.
+  static void Register(Thread* thread, FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_BLOCK_COVERAGE_H_
@@ -13,6 +13,12 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            split_cold_blocks,
+            true,
+            "Move blocks that were never executed to the end of optimized "
+            "code.");
+
 static intptr_t GetEdgeCount(const Array& edge_counters, intptr_t edge_id) {
   if (!FLAG_reorder_basic_blocks) {
     // Assume everything was visited once.
@@ -149,12 +155,67 @@ static void Union(GrowableArray<Chain*>* chains,
   }
 }
 
+// A block is cold if the profile shows that the branch leading to it was
+// never taken although its sibling was, or if all of its predecessors are
+// cold. Blocks introduced by optimizations have no profile and both of their
+// branches have weight zero, so they are not considered cold.
+static bool IsColdBranchTarget(BlockEntryInstr* block) {
+  TargetEntryInstr* target = block->AsTargetEntry();
+  if ((target == NULL) || (target->edge_weight() != 0.0) ||
+      (target->PredecessorCount() != 1)) {
+    return false;
+  }
+  BranchInstr* branch =
+      target->PredecessorAt(0)->last_instruction()->AsBranch();
+  if (branch == NULL) {
+    return false;
+  }
+  TargetEntryInstr* sibling = (branch->true_successor() == target)
+                                  ? branch->false_successor()
+                                  : branch->true_successor();
+  return sibling->edge_weight() > 0.0;
+}
+
+static void ComputeColdBlocks(FlowGraph* flow_graph,
+                              GrowableArray<bool>* is_cold) {
+  const intptr_t block_count = flow_graph->postorder().length();
+  for (intptr_t i = 0; i < block_count; ++i) {
+    is_cold->Add(false);
+  }
+  if (!FLAG_split_cold_blocks ||
+      (flow_graph->graph_entry()->entry_count() <= 0)) {
+    return;
+  }
+  for (BlockIterator it = flow_graph->reverse_postorder_iterator();
+       !it.Done(); it.Advance()) {
+    BlockEntryInstr* block = it.Current();
+    bool cold = IsColdBranchTarget(block);
+    // Back edges are visited after their loop header, so loop headers are
+    // never considered cold through their predecessors.
+    if (!cold && (block->PredecessorCount() > 0)) {
+      cold = true;
+      for (intptr_t i = 0; i < block->PredecessorCount(); ++i) {
+        if (!(*is_cold)[block->PredecessorAt(i)->postorder_number()]) {
+          cold = false;
+          break;
+        }
+      }
+    }
+    (*is_cold)[block->postorder_number()] = cold;
+  }
+}
+
 void BlockScheduler::ReorderBlocks() const {
   // Add every block to a chain of length 1 and compute a list of edges
   // sorted by weight.
   intptr_t block_count = flow_graph()->preorder().length();
   GrowableArray<Edge> edges(2 * block_count);
 
+  // Blocks that were never executed are emitted after all other blocks so
+  // that the hot code is packed into fewer cache lines.
+  GrowableArray<bool> is_cold(block_count);
+  ComputeColdBlocks(flow_graph(), &is_cold);
+
   // A map from a block's postorder number to the chain it is in.  Used to
   // implement a simple (ordered) union-find data structure.  Chains are
   // stored by pointer so that they are aliased (mutating one mutates all
@@ -195,16 +256,27 @@ void BlockScheduler::ReorderBlocks() const {
       continue;
     }
 
+    // Do not let a hot chain fall through into a cold block.
+    if (is_cold[edge.target->postorder_number()] &&
+        !is_cold[edge.source->postorder_number()]) {
+      continue;
+    }
+
     Union(&chains, source_chain, target_chain);
   }
 
   // Build a new block order.  Emit each chain when its first block occurs
   // in the original reverse postorder ordering (which gives a topological
-  // sort of the blocks).
-  for (intptr_t i = block_count - 1; i >= 0; --i) {
-    if (chains[i]->first->block == flow_graph()->postorder()[i]) {
-      for (Link* link = chains[i]->first; link != NULL; link = link->next) {
-        flow_graph()->CodegenBlockOrder(true)->Add(link->block);
+  // sort of the blocks). Chains starting with a cold block are emitted
+  // after all hot chains.
+  for (intptr_t pass = 0; pass < 2; ++pass) {
+    const bool emit_cold = (pass == 1);
+    for (intptr_t i = block_count - 1; i >= 0; --i) {
+      if ((chains[i]->first->block == flow_graph()->postorder()[i]) &&
+          (is_cold[i] == emit_cold)) {
+        for (Link* link = chains[i]->first; link != NULL; link = link->next) {
+          flow_graph()->CodegenBlockOrder(true)->Add(link->block);
+        }
       }
     }
   }
@@ -1063,6 +1063,10 @@ void ConstantPropagator::VisitInvokeMathCFunction(
   SetValue(instr, non_constant_);
 }
 
+void ConstantPropagator::VisitCallLeafNative(CallLeafNativeInstr* instr) {
+  SetValue(instr, non_constant_);
+}
+
 void ConstantPropagator::VisitTruncDivMod(TruncDivModInstr* instr) {
   // TODO(srdjan): Handle merged instruction.
   SetValue(instr, non_constant_);
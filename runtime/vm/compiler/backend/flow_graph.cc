@@ -50,6 +50,7 @@ FlowGraph::FlowGraph(const ParsedFunction& parsed_function,
       loop_invariant_loads_(NULL),
       deferred_prefixes_(parsed_function.deferred_prefixes()),
       await_token_positions_(NULL),
+      block_coverage_records_(NULL),
       captured_parameters_(new (zone()) BitVector(zone(), variable_count())),
       inlining_id_(-1),
       should_print_(FlowGraphPrinter::ShouldPrint(parsed_function.function())) {
@@ -498,7 +499,8 @@ FlowGraph::ToCheck FlowGraph::CheckForInstanceCall(
           "are no overrides of method '%s' on '%s'\n",
           method_name.ToCString(), receiver_class.ToCString());
     }
-    thread()->cha()->AddToGuardedClasses(receiver_class, subclass_count);
+    thread()->cha()->AddToGuardedClasses(receiver_class, subclass_count,
+                                         method_name);
     return receiver_maybe_null ? ToCheck::kCheckNull : ToCheck::kNoCheck;
   }
   return ToCheck::kCheckCid;
@@ -342,6 +342,18 @@ class FlowGraph : public ZoneAllocated {
     await_token_positions_ = await_token_positions;
   }
 
+  // The records of BlockCoverage for the code compiled from this graph,
+  // including those of inlined graphs. NULL if there are none.
+  ZoneGrowableArray<const Array*>* block_coverage_records() const {
+    return block_coverage_records_;
+  }
+  void AddBlockCoverageRecord(const Array& record) {
+    if (block_coverage_records_ == NULL) {
+      block_coverage_records_ = new (zone()) ZoneGrowableArray<const Array*>();
+    }
+    block_coverage_records_->Add(&record);
+  }
+
   // Replaces uses that are dominated by dom of 'def' with 'other'.
   // Note: uses that occur at instruction dom itself are not dominated by it.
   static void RenameDominatedUses(Definition* def,
@@ -390,6 +402,8 @@ class FlowGraph : public ZoneAllocated {
   friend class BranchSimplifier;
   friend class ConstantPropagator;
   friend class DeadCodeElimination;
+  friend class LoopUnroller;
+  friend class LoopVectorizer;
 
   // SSA transformation methods and fields.
   void ComputeDominators(GrowableArray<BitVector*>* dominance_frontier);
@@ -480,6 +494,7 @@ class FlowGraph : public ZoneAllocated {
   ZoneGrowableArray<BitVector*>* loop_invariant_loads_;
   ZoneGrowableArray<const LibraryPrefix*>* deferred_prefixes_;
   ZoneGrowableArray<TokenPosition>* await_token_positions_;
+  ZoneGrowableArray<const Array*>* block_coverage_records_;
   DirectChainedHashMap<ConstantPoolTrait> constant_instr_pool_;
   BitVector* captured_parameters_;
 
@@ -179,11 +179,18 @@ bool FlowGraphCompiler::IsUnboxedField(const Field& field) {
   bool valid_class =
       (SupportsUnboxedDoubles() && (field.guarded_cid() == kDoubleCid)) ||
       (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat32x4Cid)) ||
-      (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat64x2Cid));
+      (SupportsUnboxedSimd128() && (field.guarded_cid() == kFloat64x2Cid)) ||
+      (SupportsUnboxedInt64Fields() && (field.guarded_cid() == kMintCid));
   return field.is_unboxing_candidate() && !field.is_final() &&
          !field.is_nullable() && valid_class;
 }
 
+bool FlowGraphCompiler::SupportsUnboxedInt64Fields() {
+  // Int64 fields are kept in a mutable Mint box which is updated in place.
+  // Only 64-bit targets can move the payload with a single register.
+  return (kBitsPerWord == 64) && SupportsUnboxedInt64();
+}
+
 bool FlowGraphCompiler::IsPotentialUnboxedField(const Field& field) {
   return field.is_unboxing_candidate() &&
          (FlowGraphCompiler::IsUnboxedField(field) ||
@@ -2113,7 +2120,7 @@ void FlowGraphCompiler::FrameStateUpdateWith(Instruction* instr) {
 void FlowGraphCompiler::FrameStatePush(Definition* defn) {
   Representation rep = defn->representation();
   if ((rep == kUnboxedDouble) || (rep == kUnboxedFloat64x2) ||
-      (rep == kUnboxedFloat32x4)) {
+      (rep == kUnboxedFloat32x4) || (rep == kUnboxedInt64)) {
     // LoadField instruction lies about its representation in the unoptimized
     // code because Definition::representation() can't depend on the type of
     // compilation but MakeLocationSummary and EmitNativeCode can.
@@ -329,6 +329,7 @@ class FlowGraphCompiler : public ValueObject {
   static bool SupportsUnboxedDoubles();
   static bool SupportsUnboxedInt64();
   static bool SupportsUnboxedSimd128();
+  static bool SupportsUnboxedInt64Fields();
   static bool SupportsHardwareDivision();
   static bool CanConvertInt64ToDouble();
 
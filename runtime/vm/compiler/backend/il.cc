@@ -14,11 +14,13 @@
 #include "vm/compiler/backend/linearscan.h"
 #include "vm/compiler/backend/locations.h"
 #include "vm/compiler/backend/range_analysis.h"
+#include "vm/compiler/cha.h"
 #include "vm/compiler/frontend/flow_graph_builder.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/compiler/method_recognizer.h"
 #include "vm/cpu.h"
 #include "vm/dart_entry.h"
+#include "vm/heap/heap.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
 #include "vm/os.h"
@@ -44,7 +46,7 @@ DEFINE_FLAG(bool,
 DEFINE_FLAG(bool,
             unbox_numeric_fields,
             !USING_DBC,
-            "Support unboxed double and float32x4 fields.");
+            "Support unboxed double, float32x4 and int64 fields.");
 DECLARE_FLAG(bool, eliminate_type_checks);
 
 const CidRangeVector& HierarchyInfo::SubtypeRangesForClass(
@@ -148,6 +150,120 @@ void HierarchyInfo::BuildRangesFor(ClassTable* table,
   }
 }
 
+// Returns the type arguments of [target] as a supertype of the declaration
+// type of [klass], expressed in terms of the type parameters of [klass], or
+// null if [target] is not a supertype of [klass].
+static RawTypeArguments* SupertypeArgumentsOf(Zone* zone,
+                                              const Class& klass,
+                                              const Class& target) {
+  if (klass.raw() == target.raw()) {
+    return AbstractType::Handle(zone, klass.DeclarationType()).arguments();
+  }
+  const Array& interfaces = Array::Handle(zone, klass.interfaces());
+  const intptr_t num_interfaces = interfaces.IsNull() ? 0 : interfaces.Length();
+  AbstractType& supertype = AbstractType::Handle(zone);
+  Class& superclass = Class::Handle(zone);
+  TypeArguments& arguments = TypeArguments::Handle(zone);
+  for (intptr_t i = -1; i < num_interfaces; i++) {
+    supertype ^= (i < 0) ? klass.super_type() : interfaces.At(i);
+    if (supertype.IsNull() || !supertype.IsType()) continue;
+    superclass = supertype.type_class();
+    arguments = SupertypeArgumentsOf(zone, superclass, target);
+    if (arguments.IsNull()) continue;
+    if (!arguments.IsInstantiated()) {
+      // Substitute the type parameters of [superclass] with the type
+      // arguments [klass] passes to it.
+      Error& bound_error = Error::Handle(zone);
+      arguments = arguments.InstantiateFrom(
+          TypeArguments::Handle(zone, supertype.arguments()),
+          Object::null_type_arguments(), kAllFree, &bound_error, NULL, NULL,
+          Heap::kNew);
+      if (!bound_error.IsNull()) return TypeArguments::null();
+    }
+    return arguments.raw();
+  }
+  return TypeArguments::null();
+}
+
+bool HierarchyInfo::SubtypeRangesWithSameTypeArgumentsLayout(
+    const Class& klass,
+    CidRangeVector* ranges,
+    intptr_t* type_arguments_field_offset) {
+  Zone* zone = thread()->zone();
+  ClassTable* table = thread()->isolate()->class_table();
+  const intptr_t num_type_parameters = klass.NumTypeParameters();
+  const intptr_t num_type_arguments = klass.NumTypeArguments();
+  ASSERT(num_type_parameters > 0);
+
+  // Find the concrete subtypes of [klass] which pass its type parameters
+  // through unchanged.
+  GrowableArray<intptr_t> cids;
+  GrowableArray<intptr_t> offsets;
+  Class& cls = Class::Handle(zone);
+  TypeArguments& arguments = TypeArguments::Handle(zone);
+  AbstractType& argument = AbstractType::Handle(zone);
+  const CidRangeVector& subtype_ranges = SubtypeRangesForClass(klass);
+  for (intptr_t i = 0; i < subtype_ranges.length(); i++) {
+    const CidRange& range = subtype_ranges[i];
+    if (range.IsIllegalRange()) continue;
+    for (intptr_t cid = range.cid_start; cid <= range.cid_end; cid++) {
+      if (!table->HasValidClassAt(cid)) continue;
+      cls = table->At(cid);
+      if (cls.is_abstract() || cls.is_patch() || cls.IsTopLevel()) continue;
+      const intptr_t offset = cls.type_arguments_field_offset();
+      if (offset == Class::kNoTypeArguments) continue;
+      arguments = SupertypeArgumentsOf(zone, cls, klass);
+      if (arguments.IsNull() || arguments.Length() != num_type_arguments) {
+        continue;
+      }
+      bool same_layout = true;
+      for (intptr_t j = num_type_arguments - num_type_parameters;
+           j < num_type_arguments; j++) {
+        argument = arguments.TypeAt(j);
+        if (!argument.IsTypeParameter() ||
+            !TypeParameter::Cast(argument).IsClassTypeParameter() ||
+            TypeParameter::Cast(argument).index() != j) {
+          same_layout = false;
+          break;
+        }
+      }
+      if (same_layout) {
+        cids.Add(cid);
+        offsets.Add(offset);
+      }
+    }
+  }
+  if (cids.length() == 0) return false;
+
+  // Use the type arguments field offset shared by most of them.
+  intptr_t best_offset = Class::kNoTypeArguments;
+  intptr_t best_count = 0;
+  for (intptr_t i = 0; i < offsets.length(); i++) {
+    intptr_t count = 0;
+    for (intptr_t j = 0; j < offsets.length(); j++) {
+      if (offsets[j] == offsets[i]) count++;
+    }
+    if (count > best_count) {
+      best_offset = offsets[i];
+      best_count = count;
+    }
+  }
+
+  // [cids] is sorted, so adjacent class ids form ranges.
+  ranges->Clear();
+  for (intptr_t i = 0; i < cids.length(); i++) {
+    if (offsets[i] != best_offset) continue;
+    const intptr_t cid = cids[i];
+    if (ranges->length() > 0 && ranges->Last().cid_end == cid - 1) {
+      (*ranges)[ranges->length() - 1].cid_end = cid;
+    } else {
+      ranges->Add(CidRange(cid, cid));
+    }
+  }
+  *type_arguments_field_offset = best_offset;
+  return true;
+}
+
 bool HierarchyInfo::CanUseSubtypeRangeCheckFor(const AbstractType& type) {
   ASSERT(type.IsFinalized() && !type.IsMalformedOrMalbounded());
 
@@ -225,13 +341,15 @@ bool HierarchyInfo::CanUseGenericSubtypeRangeCheckFor(
 
   // If the type class is implemented the different implementations might have
   // their type argument vector stored at different offsets and we can therefore
-  // not perform our optimized [CidRange]-based implementation.
-  //
-  // TODO(kustermann): If the class is implemented but all implementations
-  // store the instantator type argument vector at the same offset we can
-  // still do it!
+  // only perform our optimized [CidRange]-based implementation for those
+  // implementations that agree on the layout.
   if (type_class.is_implemented()) {
-    return false;
+    CidRangeVector ranges;
+    intptr_t type_arguments_field_offset;
+    if (!SubtypeRangesWithSameTypeArgumentsLayout(
+            type_class, &ranges, &type_arguments_field_offset)) {
+      return false;
+    }
   }
 
   const TypeArguments& ta =
@@ -673,6 +791,8 @@ Representation LoadFieldInstr::representation() const {
         return kUnboxedFloat32x4;
       case kFloat64x2Cid:
         return kUnboxedFloat64x2;
+      case kMintCid:
+        return kUnboxedInt64;
       default:
         UNREACHABLE();
     }
@@ -680,6 +800,23 @@ Representation LoadFieldInstr::representation() const {
   return kTagged;
 }
 
+bool AllocateObjectInstr::ShouldPretenure(FlowGraphCompiler* compiler) const {
+  if (!compiler->is_optimizing() || FLAG_precompiled_mode) {
+    return false;
+  }
+  Thread* thread = compiler->thread();
+  // Dependent code cannot be registered with classes in the VM heap.
+  if (cls().InVMHeap() || (thread->cha() == NULL)) {
+    return false;
+  }
+  if (!thread->isolate()->heap()->pretenuring_feedback()->IsPretenured(
+          cls().id())) {
+    return false;
+  }
+  thread->cha()->AddToPretenuredClasses(cls());
+  return true;
+}
+
 bool StoreInstanceFieldInstr::IsUnboxedStore() const {
   return FLAG_unbox_numeric_fields && !field().IsNull() &&
          FlowGraphCompiler::IsUnboxedField(field());
@@ -702,6 +839,8 @@ Representation StoreInstanceFieldInstr::RequiredInputRepresentation(
         return kUnboxedFloat32x4;
       case kFloat64x2Cid:
         return kUnboxedFloat64x2;
+      case kMintCid:
+        return kUnboxedInt64;
       default:
         UNREACHABLE();
     }
@@ -3128,6 +3267,15 @@ Instruction* CheckEitherNonSmiInstr::Canonicalize(FlowGraph* flow_graph) {
   return this;
 }
 
+Instruction* CheckFunctionInstr::Canonicalize(FlowGraph* flow_graph) {
+  Definition* defn = value()->definition()->OriginalDefinition();
+  if (defn->IsConstant() &&
+      (defn->AsConstant()->value().raw() == function().raw())) {
+    return NULL;  // Remove from the graph.
+  }
+  return this;
+}
+
 Instruction* CheckNullInstr::Canonicalize(FlowGraph* flow_graph) {
   return (!value()->Type()->is_nullable()) ? NULL : this;
 }
@@ -4171,6 +4319,23 @@ class NullErrorSlowPath : public ThrowErrorSlowPathCode {
   }
 };
 
+LocationSummary* CheckFunctionInstr::MakeLocationSummary(Zone* zone,
+                                                         bool opt) const {
+  const intptr_t kNumInputs = 1;
+  const intptr_t kNumTemps = 0;
+  LocationSummary* locs = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
+  locs->set_in(0, Location::RequiresRegister());
+  return locs;
+}
+
+void CheckFunctionInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  Label* deopt =
+      compiler->AddDeoptStub(deopt_id(), ICData::kDeoptCheckClosureFunction);
+  __ CompareObject(locs()->in(0).reg(), function());
+  __ BranchIf(NOT_EQUAL, deopt);
+}
+
 void CheckNullInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   NullErrorSlowPath* slow_path =
       new NullErrorSlowPath(this, compiler->CurrentTryIndex());
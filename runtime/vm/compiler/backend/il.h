@@ -396,6 +396,20 @@ class HierarchyInfo : public StackResource {
   // false.
   bool CanUseGenericSubtypeRangeCheckFor(const AbstractType& type);
 
+  // Collects into [ranges] the class ids of the concrete subtypes of [klass]
+  // which store the type arguments of their [klass] supertype at the same
+  // positions of their type arguments vector as [klass] itself, and whose
+  // type arguments vector lives at a common field offset, returned in
+  // [type_arguments_field_offset].  The type arguments of instances of these
+  // classes can be checked inline even if [klass] is implemented rather than
+  // extended (e.g. List<T> by _GrowableList<T> and _List<T>).
+  //
+  // Returns `false` if there are no such classes.
+  bool SubtypeRangesWithSameTypeArgumentsLayout(
+      const Class& klass,
+      CidRangeVector* ranges,
+      intptr_t* type_arguments_field_offset);
+
  private:
   void BuildRangesFor(ClassTable* table,
                       CidRangeVector* ranges,
@@ -530,6 +544,7 @@ class EmbeddedArray<T, 0> {
   M(FloatToDouble)                                                             \
   M(CheckClass)                                                                \
   M(CheckClassId)                                                              \
+  M(CheckFunction)                                                             \
   M(CheckSmi)                                                                  \
   M(CheckNull)                                                                 \
   M(Constant)                                                                  \
@@ -555,6 +570,7 @@ class EmbeddedArray<T, 0> {
   M(OneByteStringFromCharCode)                                                 \
   M(StringInterpolate)                                                         \
   M(InvokeMathCFunction)                                                       \
+  M(CallLeafNative)                                                            \
   M(TruncDivMod)                                                               \
   M(GuardFieldClass)                                                           \
   M(GuardFieldLength)                                                          \
@@ -4531,6 +4547,8 @@ class StoreIndexedInstr : public TemplateDefinition<3, NoThrow> {
 
   enum { kArrayPos = 0, kIndexPos = 1, kValuePos = 2 };
 
+  virtual TokenPosition token_pos() const { return token_pos_; }
+
   Value* array() const { return inputs_[kArrayPos]; }
   Value* index() const { return inputs_[kIndexPos]; }
   Value* value() const { return inputs_[kValuePos]; }
@@ -4667,6 +4685,11 @@ class AllocateObjectInstr : public TemplateDefinition<0, NoThrow> {
   virtual AliasIdentity Identity() const { return identity_; }
   virtual void SetIdentity(AliasIdentity identity) { identity_ = identity; }
 
+  // Whether optimized code should allocate the object directly in old space,
+  // see PretenuringFeedback. Makes the code being compiled depend on the
+  // class staying pretenured.
+  bool ShouldPretenure(FlowGraphCompiler* compiler) const;
+
   PRINT_OPERANDS_TO_SUPPORT
 
  private:
@@ -6886,6 +6909,36 @@ class InvokeMathCFunctionInstr : public PureDefinition {
   DISALLOW_COPY_AND_ASSIGN(InvokeMathCFunctionInstr);
 };
 
+// Calls the leaf runtime entry of a bootstrap native (see
+// BOOTSTRAP_LEAF_NATIVE_LIST) directly, without building NativeArguments or
+// entering the VM. The result is an unboxed int64. The call is neither pure
+// nor CSE-able: natives like Stopwatch._now return a new value every time.
+class CallLeafNativeInstr : public TemplateDefinition<0, NoThrow> {
+ public:
+  CallLeafNativeInstr(const RuntimeEntry& target, const String& native_name)
+      : target_(target), native_name_(native_name) {}
+
+  const RuntimeEntry& target() const { return target_; }
+  const String& native_name() const { return native_name_; }
+
+  DECLARE_INSTRUCTION(CallLeafNative)
+  virtual CompileType ComputeType() const;
+
+  virtual bool ComputeCanDeoptimize() const { return false; }
+
+  virtual bool HasUnknownSideEffects() const { return false; }
+
+  virtual Representation representation() const { return kUnboxedInt64; }
+
+  PRINT_OPERANDS_TO_SUPPORT
+
+ private:
+  const RuntimeEntry& target_;
+  const String& native_name_;
+
+  DISALLOW_COPY_AND_ASSIGN(CallLeafNativeInstr);
+};
+
 class ExtractNthOutputInstr : public TemplateDefinition<1, NoThrow, Pure> {
  public:
   // Extract the Nth output register from value.
@@ -7141,6 +7194,40 @@ class CheckClassIdInstr : public TemplateInstruction<1, NoThrow> {
   DISALLOW_COPY_AND_ASSIGN(CheckClassIdInstr);
 };
 
+// Deoptimizes unless `value` is the given function. Used to guard
+// speculatively inlined closure calls.
+class CheckFunctionInstr : public TemplateInstruction<1, NoThrow> {
+ public:
+  CheckFunctionInstr(Value* value, const Function& function, intptr_t deopt_id)
+      : TemplateInstruction(deopt_id), function_(function) {
+    ASSERT(function.IsZoneHandle());
+    SetInputAt(0, value);
+  }
+
+  Value* value() const { return inputs_[0]; }
+  const Function& function() const { return function_; }
+
+  DECLARE_INSTRUCTION(CheckFunction)
+
+  virtual bool ComputeCanDeoptimize() const { return true; }
+
+  virtual Instruction* Canonicalize(FlowGraph* flow_graph);
+
+  virtual bool AllowsCSE() const { return true; }
+  virtual bool HasUnknownSideEffects() const { return false; }
+
+  virtual bool AttributesEqual(Instruction* other) const {
+    return other->AsCheckFunction()->function().raw() == function().raw();
+  }
+
+  PRINT_OPERANDS_TO_SUPPORT
+
+ private:
+  const Function& function_;
+
+  DISALLOW_COPY_AND_ASSIGN(CheckFunctionInstr);
+};
+
 class CheckArrayBoundInstr : public TemplateInstruction<2, NoThrow, Pure> {
  public:
   CheckArrayBoundInstr(Value* length, Value* index, intptr_t deopt_id)
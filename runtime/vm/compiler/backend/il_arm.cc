@@ -5519,6 +5519,22 @@ void InvokeMathCFunctionInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   }
 }
 
+LocationSummary* CallLeafNativeInstr::MakeLocationSummary(Zone* zone,
+                                                          bool opt) const {
+  const intptr_t kNumInputs = 0;
+  const intptr_t kNumTemps = 0;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kCall);
+  // The int64 result is returned in R0 (low) and R1 (high).
+  summary->set_out(0, Location::Pair(Location::RegisterLocation(R0),
+                                     Location::RegisterLocation(R1)));
+  return summary;
+}
+
+void CallLeafNativeInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  __ CallRuntime(target(), 0);
+}
+
 LocationSummary* ExtractNthOutputInstr::MakeLocationSummary(Zone* zone,
                                                             bool opt) const {
   // Only use this instruction in optimized code.
@@ -1922,7 +1922,9 @@ LocationSummary* StoreInstanceFieldInstr::MakeLocationSummary(Zone* zone,
 
   summary->set_in(0, Location::RequiresRegister());
   if (IsUnboxedStore() && opt) {
-    summary->set_in(1, Location::RequiresFpuRegister());
+    summary->set_in(1, (field().UnboxedFieldCid() == kMintCid)
+                           ? Location::RequiresRegister()
+                           : Location::RequiresFpuRegister());
     summary->set_temp(0, Location::RequiresRegister());
     summary->set_temp(1, Location::RequiresRegister());
   } else if (IsPotentialUnboxedStore()) {
@@ -1945,7 +1947,6 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   const Register instance_reg = locs()->in(0).reg();
 
   if (IsUnboxedStore() && compiler->is_optimizing()) {
-    const VRegister value = locs()->in(1).fpu_reg();
     const Register temp = locs()->temp(0).reg();
     const Register temp2 = locs()->temp(1).reg();
     const intptr_t cid = field().UnboxedFieldCid();
@@ -1962,6 +1963,9 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
         case kFloat64x2Cid:
           cls = &compiler->float64x2_class();
           break;
+        case kMintCid:
+          cls = &compiler->mint_class();
+          break;
         default:
           UNREACHABLE();
       }
@@ -1975,15 +1979,22 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleStoreInstanceFieldInstr");
-        __ StoreDFieldToOffset(value, temp, Double::value_offset());
+        __ StoreDFieldToOffset(locs()->in(1).fpu_reg(), temp,
+                               Double::value_offset());
         break;
       case kFloat32x4Cid:
         __ Comment("UnboxedFloat32x4StoreInstanceFieldInstr");
-        __ StoreQFieldToOffset(value, temp, Float32x4::value_offset());
+        __ StoreQFieldToOffset(locs()->in(1).fpu_reg(), temp,
+                               Float32x4::value_offset());
         break;
       case kFloat64x2Cid:
         __ Comment("UnboxedFloat64x2StoreInstanceFieldInstr");
-        __ StoreQFieldToOffset(value, temp, Float64x2::value_offset());
+        __ StoreQFieldToOffset(locs()->in(1).fpu_reg(), temp,
+                               Float64x2::value_offset());
+        break;
+      case kMintCid:
+        __ Comment("UnboxedInt64StoreInstanceFieldInstr");
+        __ StoreFieldToOffset(locs()->in(1).reg(), temp, Mint::value_offset());
         break;
       default:
         UNREACHABLE();
@@ -2007,6 +2018,7 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label store_double;
     Label store_float32x4;
     Label store_float64x2;
+    Label store_mint;
 
     __ LoadObject(temp, Field::ZoneHandle(Z, field().Original()));
 
@@ -2035,6 +2047,13 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ CompareImmediate(temp2, kFloat64x2Cid);
     __ b(&store_float64x2, EQ);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ LoadFieldFromOffset(temp2, temp, Field::guarded_cid_offset(),
+                             kUnsignedHalfword);
+      __ CompareImmediate(temp2, kMintCid);
+      __ b(&store_mint, EQ);
+    }
+
     // Fall through.
     __ b(&store_pointer);
 
@@ -2070,6 +2089,15 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ b(&skip_store);
     }
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ Bind(&store_mint);
+      EnsureMutableBox(compiler, this, temp, compiler->mint_class(),
+                       instance_reg, offset_in_bytes_, temp2);
+      __ LoadFieldFromOffset(temp2, value_reg, Mint::value_offset());
+      __ StoreFieldToOffset(temp2, temp, Mint::value_offset());
+      __ b(&skip_store);
+    }
+
     __ Bind(&store_pointer);
   }
 
@@ -2295,20 +2323,27 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   const Register instance_reg = locs()->in(0).reg();
   if (IsUnboxedLoad() && compiler->is_optimizing()) {
-    const VRegister result = locs()->out(0).fpu_reg();
     const Register temp = locs()->temp(0).reg();
     __ LoadFieldFromOffset(temp, instance_reg, offset_in_bytes());
     const intptr_t cid = field()->UnboxedFieldCid();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleLoadFieldInstr");
-        __ LoadDFieldFromOffset(result, temp, Double::value_offset());
+        __ LoadDFieldFromOffset(locs()->out(0).fpu_reg(), temp,
+                                Double::value_offset());
         break;
       case kFloat32x4Cid:
-        __ LoadQFieldFromOffset(result, temp, Float32x4::value_offset());
+        __ LoadQFieldFromOffset(locs()->out(0).fpu_reg(), temp,
+                                Float32x4::value_offset());
         break;
       case kFloat64x2Cid:
-        __ LoadQFieldFromOffset(result, temp, Float64x2::value_offset());
+        __ LoadQFieldFromOffset(locs()->out(0).fpu_reg(), temp,
+                                Float64x2::value_offset());
+        break;
+      case kMintCid:
+        __ Comment("UnboxedInt64LoadFieldInstr");
+        __ LoadFieldFromOffset(locs()->out(0).reg(), temp,
+                               Mint::value_offset());
         break;
       default:
         UNREACHABLE();
@@ -2325,6 +2360,7 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label load_double;
     Label load_float32x4;
     Label load_float64x2;
+    Label load_mint;
 
     __ LoadObject(result_reg, Field::ZoneHandle(field()->Original()));
 
@@ -2349,6 +2385,12 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ CompareImmediate(temp, kFloat64x2Cid);
     __ b(&load_float64x2, EQ);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ ldr(temp, field_cid_operand, kUnsignedHalfword);
+      __ CompareImmediate(temp, kMintCid);
+      __ b(&load_mint, EQ);
+    }
+
     // Fall through.
     __ b(&load_pointer);
 
@@ -2386,6 +2428,16 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ b(&done);
     }
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ Bind(&load_mint);
+      BoxAllocationSlowPath::Allocate(compiler, this, compiler->mint_class(),
+                                      result_reg, temp);
+      __ LoadFieldFromOffset(temp, instance_reg, offset_in_bytes());
+      __ LoadFieldFromOffset(temp, temp, Mint::value_offset());
+      __ StoreFieldToOffset(temp, result_reg, Mint::value_offset());
+      __ b(&done);
+    }
+
     __ Bind(&load_pointer);
   }
   __ LoadFieldFromOffset(result_reg, instance_reg, offset_in_bytes());
@@ -4718,6 +4770,20 @@ void InvokeMathCFunctionInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ CallRuntime(TargetFunction(), InputCount());
 }
 
+LocationSummary* CallLeafNativeInstr::MakeLocationSummary(Zone* zone,
+                                                          bool opt) const {
+  const intptr_t kNumInputs = 0;
+  const intptr_t kNumTemps = 0;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kCall);
+  summary->set_out(0, Location::RegisterLocation(R0));
+  return summary;
+}
+
+void CallLeafNativeInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  __ CallRuntime(target(), 0);
+}
+
 LocationSummary* ExtractNthOutputInstr::MakeLocationSummary(Zone* zone,
                                                             bool opt) const {
   // Only use this instruction in optimized code.
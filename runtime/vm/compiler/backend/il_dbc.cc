@@ -54,8 +54,10 @@ DECLARE_FLAG(int, optimization_counter_threshold);
 // - Precompilation.
 #define FOR_EACH_UNREACHABLE_INSTRUCTION(M)                                    \
   M(CaseInsensitiveCompareUC16)                                                \
+  M(CallLeafNative)                                                            \
   M(GenericCheckBound)                                                         \
   M(CheckNull)                                                                 \
+  M(CheckFunction)                                                             \
   M(IndirectGoto)                                                              \
   M(Int64ToDouble)                                                             \
   M(BinaryInt64Op)                                                             \
@@ -4865,6 +4865,29 @@ void InvokeMathCFunctionInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ movl(ESP, locs()->temp(kSavedSpTempIndex).reg());
 }
 
+LocationSummary* CallLeafNativeInstr::MakeLocationSummary(Zone* zone,
+                                                          bool opt) const {
+  const intptr_t kNumInputs = 0;
+  const intptr_t kNumTemps = 0;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kCall);
+  // The int64 result is returned in EAX (low) and EDX (high).
+  summary->set_out(0, Location::Pair(Location::RegisterLocation(EAX),
+                                     Location::RegisterLocation(EDX)));
+  return summary;
+}
+
+void CallLeafNativeInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  // Save ESP. EDI is chosen because it is callee saved so we do not need to
+  // back it up before calling into the runtime.
+  static const Register kSavedSPReg = EDI;
+  __ movl(kSavedSPReg, ESP);
+  __ ReserveAlignedFrameSpace(0);
+  __ CallRuntime(target(), 0);
+  // Restore ESP.
+  __ movl(ESP, kSavedSPReg);
+}
+
 LocationSummary* ExtractNthOutputInstr::MakeLocationSummary(Zone* zone,
                                                             bool opt) const {
   // Only use this instruction in optimized code.
@@ -795,6 +795,11 @@ void UnaryDoubleOpInstr::PrintOperandsTo(BufferFormatter* f) const {
   value()->PrintTo(f);
 }
 
+void CheckFunctionInstr::PrintOperandsTo(BufferFormatter* f) const {
+  value()->PrintTo(f);
+  f->Print(", %s", function().ToCString());
+}
+
 void CheckClassIdInstr::PrintOperandsTo(BufferFormatter* f) const {
   value()->PrintTo(f);
 
@@ -825,6 +830,10 @@ void InvokeMathCFunctionInstr::PrintOperandsTo(BufferFormatter* f) const {
   Definition::PrintOperandsTo(f);
 }
 
+void CallLeafNativeInstr::PrintOperandsTo(BufferFormatter* f) const {
+  f->Print("%s", native_name().ToCString());
+}
+
 void GraphEntryInstr::PrintTo(BufferFormatter* f) const {
   const GrowableArray<Definition*>& defns = initial_definitions_;
   f->Print("B%" Pd "[graph]:%" Pd, block_id(), GetDeoptId());
@@ -13,6 +13,7 @@
 #include "vm/compiler/backend/locations_helpers.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/cpu.h"
 #include "vm/dart_entry.h"
 #include "vm/instructions.h"
 #include "vm/object_store.h"
@@ -1383,7 +1384,9 @@ Representation StoreIndexedInstr::RequiredInputRepresentation(
 LocationSummary* StoreIndexedInstr::MakeLocationSummary(Zone* zone,
                                                         bool opt) const {
   const intptr_t kNumInputs = 3;
-  const intptr_t kNumTemps = 0;
+  // The barrier of a store into an Array needs the address of the element.
+  const intptr_t kNumTemps =
+      ((class_id() == kArrayCid) && ShouldEmitStoreBarrier()) ? 1 : 0;
   LocationSummary* locs = new (zone)
       LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
   locs->set_in(0, Location::RequiresRegister());
@@ -1405,6 +1408,9 @@ LocationSummary* StoreIndexedInstr::MakeLocationSummary(Zone* zone,
       locs->set_in(2, ShouldEmitStoreBarrier()
                           ? Location::WritableRegister()
                           : Location::RegisterOrConstant(value()));
+      if (ShouldEmitStoreBarrier()) {
+        locs->set_temp(0, Location::RequiresRegister());
+      }
       break;
     case kExternalTypedDataUint8ArrayCid:
     case kExternalTypedDataUint8ClampedArrayCid:
@@ -1464,7 +1470,9 @@ void StoreIndexedInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     case kArrayCid:
       if (ShouldEmitStoreBarrier()) {
         Register value = locs()->in(2).reg();
-        __ StoreIntoObject(array, element_address, value);
+        Register slot = locs()->temp(0).reg();
+        __ leaq(slot, element_address);
+        __ StoreIntoArray(array, slot, value);
       } else if (locs()->in(2).IsConstant()) {
         const Object& constant = locs()->in(2).constant();
         __ StoreIntoObjectNoBarrier(array, element_address, constant);
@@ -1819,7 +1827,9 @@ LocationSummary* StoreInstanceFieldInstr::MakeLocationSummary(Zone* zone,
 
   summary->set_in(0, Location::RequiresRegister());
   if (IsUnboxedStore() && opt) {
-    summary->set_in(1, Location::RequiresFpuRegister());
+    summary->set_in(1, (field().UnboxedFieldCid() == kMintCid)
+                           ? Location::RequiresRegister()
+                           : Location::RequiresFpuRegister());
     summary->set_temp(0, Location::RequiresRegister());
     summary->set_temp(1, Location::RequiresRegister());
   } else if (IsPotentialUnboxedStore()) {
@@ -1862,7 +1872,6 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   Register instance_reg = locs()->in(0).reg();
 
   if (IsUnboxedStore() && compiler->is_optimizing()) {
-    XmmRegister value = locs()->in(1).fpu_reg();
     Register temp = locs()->temp(0).reg();
     Register temp2 = locs()->temp(1).reg();
     const intptr_t cid = field().UnboxedFieldCid();
@@ -1879,6 +1888,9 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
         case kFloat64x2Cid:
           cls = &compiler->float64x2_class();
           break;
+        case kMintCid:
+          cls = &compiler->mint_class();
+          break;
         default:
           UNREACHABLE();
       }
@@ -1893,15 +1905,22 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleStoreInstanceFieldInstr");
-        __ movsd(FieldAddress(temp, Double::value_offset()), value);
+        __ movsd(FieldAddress(temp, Double::value_offset()),
+                 locs()->in(1).fpu_reg());
         break;
       case kFloat32x4Cid:
         __ Comment("UnboxedFloat32x4StoreInstanceFieldInstr");
-        __ movups(FieldAddress(temp, Float32x4::value_offset()), value);
+        __ movups(FieldAddress(temp, Float32x4::value_offset()),
+                  locs()->in(1).fpu_reg());
         break;
       case kFloat64x2Cid:
         __ Comment("UnboxedFloat64x2StoreInstanceFieldInstr");
-        __ movups(FieldAddress(temp, Float64x2::value_offset()), value);
+        __ movups(FieldAddress(temp, Float64x2::value_offset()),
+                  locs()->in(1).fpu_reg());
+        break;
+      case kMintCid:
+        __ Comment("UnboxedInt64StoreInstanceFieldInstr");
+        __ movq(FieldAddress(temp, Mint::value_offset()), locs()->in(1).reg());
         break;
       default:
         UNREACHABLE();
@@ -1925,6 +1944,7 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label store_double;
     Label store_float32x4;
     Label store_float64x2;
+    Label store_mint;
 
     __ LoadObject(temp, Field::ZoneHandle(Z, field().Original()));
 
@@ -1948,6 +1968,12 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
             Immediate(kFloat64x2Cid));
     __ j(EQUAL, &store_float64x2);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ cmpw(FieldAddress(temp, Field::guarded_cid_offset()),
+              Immediate(kMintCid));
+      __ j(EQUAL, &store_mint);
+    }
+
     // Fall through.
     __ jmp(&store_pointer);
 
@@ -1983,6 +2009,15 @@ void StoreInstanceFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ jmp(&skip_store);
     }
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ Bind(&store_mint);
+      EnsureMutableBox(compiler, this, temp, compiler->mint_class(),
+                       instance_reg, offset_in_bytes_, temp2);
+      __ movq(temp2, FieldAddress(value_reg, Mint::value_offset()));
+      __ movq(FieldAddress(temp, Mint::value_offset()), temp2);
+      __ jmp(&skip_store);
+    }
+
     __ Bind(&store_pointer);
   }
 
@@ -2214,22 +2249,28 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   ASSERT(sizeof(classid_t) == kInt16Size);
   Register instance_reg = locs()->in(0).reg();
   if (IsUnboxedLoad() && compiler->is_optimizing()) {
-    XmmRegister result = locs()->out(0).fpu_reg();
     Register temp = locs()->temp(0).reg();
     __ movq(temp, FieldAddress(instance_reg, offset_in_bytes()));
     intptr_t cid = field()->UnboxedFieldCid();
     switch (cid) {
       case kDoubleCid:
         __ Comment("UnboxedDoubleLoadFieldInstr");
-        __ movsd(result, FieldAddress(temp, Double::value_offset()));
+        __ movsd(locs()->out(0).fpu_reg(),
+                 FieldAddress(temp, Double::value_offset()));
         break;
       case kFloat32x4Cid:
         __ Comment("UnboxedFloat32x4LoadFieldInstr");
-        __ movups(result, FieldAddress(temp, Float32x4::value_offset()));
+        __ movups(locs()->out(0).fpu_reg(),
+                  FieldAddress(temp, Float32x4::value_offset()));
         break;
       case kFloat64x2Cid:
         __ Comment("UnboxedFloat64x2LoadFieldInstr");
-        __ movups(result, FieldAddress(temp, Float64x2::value_offset()));
+        __ movups(locs()->out(0).fpu_reg(),
+                  FieldAddress(temp, Float64x2::value_offset()));
+        break;
+      case kMintCid:
+        __ Comment("UnboxedInt64LoadFieldInstr");
+        __ movq(locs()->out(0).reg(), FieldAddress(temp, Mint::value_offset()));
         break;
       default:
         UNREACHABLE();
@@ -2247,6 +2288,7 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     Label load_double;
     Label load_float32x4;
     Label load_float64x2;
+    Label load_mint;
 
     __ LoadObject(result, Field::ZoneHandle(field()->Original()));
 
@@ -2265,6 +2307,11 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
     __ cmpw(field_cid_operand, Immediate(kFloat64x2Cid));
     __ j(EQUAL, &load_float64x2);
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ cmpw(field_cid_operand, Immediate(kMintCid));
+      __ j(EQUAL, &load_mint);
+    }
+
     // Fall through.
     __ jmp(&load_pointer);
 
@@ -2302,6 +2349,16 @@ void LoadFieldInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
       __ jmp(&done);
     }
 
+    if (FlowGraphCompiler::SupportsUnboxedInt64Fields()) {
+      __ Bind(&load_mint);
+      BoxAllocationSlowPath::Allocate(compiler, this, compiler->mint_class(),
+                                      result, temp);
+      __ movq(temp, FieldAddress(instance_reg, offset_in_bytes()));
+      __ movq(temp, FieldAddress(temp, Mint::value_offset()));
+      __ movq(FieldAddress(result, Mint::value_offset()), temp);
+      __ jmp(&done);
+    }
+
     __ Bind(&load_pointer);
   }
   __ movq(result, FieldAddress(instance_reg, offset_in_bytes()));
@@ -3819,7 +3876,11 @@ LocationSummary* BinaryDoubleOpInstr::MakeLocationSummary(Zone* zone,
       LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kNoCall);
   summary->set_in(0, Location::RequiresFpuRegister());
   summary->set_in(1, Location::RequiresFpuRegister());
-  summary->set_out(0, Location::SameAsFirstInput());
+  // The three-operand AVX forms do not clobber the left operand, which saves
+  // the register allocator a move when it is still live.
+  summary->set_out(0, TargetCPUFeatures::avx_supported()
+                          ? Location::RequiresFpuRegister()
+                          : Location::SameAsFirstInput());
   return summary;
 }
 
@@ -3827,6 +3888,27 @@ void BinaryDoubleOpInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   XmmRegister left = locs()->in(0).fpu_reg();
   XmmRegister right = locs()->in(1).fpu_reg();
 
+  if (TargetCPUFeatures::avx_supported()) {
+    XmmRegister result = locs()->out(0).fpu_reg();
+    switch (op_kind()) {
+      case Token::kADD:
+        __ vaddsd(result, left, right);
+        break;
+      case Token::kSUB:
+        __ vsubsd(result, left, right);
+        break;
+      case Token::kMUL:
+        __ vmulsd(result, left, right);
+        break;
+      case Token::kDIV:
+        __ vdivsd(result, left, right);
+        break;
+      default:
+        UNREACHABLE();
+    }
+    return;
+  }
+
   ASSERT(locs()->out(0).fpu_reg() == left);
 
   switch (op_kind()) {
@@ -3915,6 +3997,44 @@ Condition DoubleTestOpInstr::EmitComparisonCode(FlowGraphCompiler* compiler,
   V(Float32x4LessThan, cmppslt)                                                \
   V(Float32x4LessThanOrEqual, cmppsle)
 
+#define SIMD_OP_AVX_BINARY(V)                                                  \
+  SIMD_OP_FLOAT_ARITH(V, Add, vadd)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Sub, vsub)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Mul, vmul)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Div, vdiv)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Min, vmin)                                            \
+  SIMD_OP_FLOAT_ARITH(V, Max, vmax)
+
+// Used instead of SimdBinaryOp for the SIMD_OP_AVX_BINARY kinds when AVX is
+// available.
+DEFINE_EMIT(SimdAVXBinaryOp,
+            (XmmRegister out, XmmRegister left, XmmRegister right)) {
+  switch (instr->kind()) {
+#define EMIT(Name, op)                                                         \
+  case SimdOpInstr::k##Name:                                                   \
+    __ op(out, left, right);                                                   \
+    break;
+    SIMD_OP_AVX_BINARY(EMIT)
+#undef EMIT
+    default:
+      UNREACHABLE();
+  }
+}
+
+static bool UseAVXBinaryOp(SimdOpInstr::Kind kind) {
+  if (!TargetCPUFeatures::avx_supported()) {
+    return false;
+  }
+  switch (kind) {
+#define CASE(Name, op) case SimdOpInstr::k##Name:
+    SIMD_OP_AVX_BINARY(CASE)
+#undef CASE
+    return true;
+    default:
+      return false;
+  }
+}
+
 DEFINE_EMIT(SimdBinaryOp,
             (SameAsFirstInput, XmmRegister left, XmmRegister right)) {
   switch (instr->kind()) {
@@ -4262,6 +4382,9 @@ DEFINE_EMIT(Int32x4Select,
   SIMPLE(Int32x4Select)
 
 LocationSummary* SimdOpInstr::MakeLocationSummary(Zone* zone, bool opt) const {
+  if (UseAVXBinaryOp(kind())) {
+    return MakeLocationSummaryFromEmitter(zone, this, &EmitSimdAVXBinaryOp);
+  }
   switch (kind()) {
 #define CASE(Name, ...) case k##Name:
 #define EMIT(Name)                                                             \
@@ -4279,6 +4402,10 @@ LocationSummary* SimdOpInstr::MakeLocationSummary(Zone* zone, bool opt) const {
 }
 
 void SimdOpInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  if (UseAVXBinaryOp(kind())) {
+    InvokeEmitter(compiler, this, &EmitSimdAVXBinaryOp);
+    return;
+  }
   switch (kind()) {
 #define CASE(Name, ...) case k##Name:
 #define EMIT(Name)                                                             \
@@ -4838,6 +4965,27 @@ void InvokeMathCFunctionInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
   __ movq(RSP, locs()->temp(kSavedSpTempIndex).reg());
 }
 
+LocationSummary* CallLeafNativeInstr::MakeLocationSummary(Zone* zone,
+                                                          bool opt) const {
+  const intptr_t kNumInputs = 0;
+  const intptr_t kNumTemps = 0;
+  LocationSummary* summary = new (zone)
+      LocationSummary(zone, kNumInputs, kNumTemps, LocationSummary::kCall);
+  summary->set_out(0, Location::RegisterLocation(RAX));
+  return summary;
+}
+
+void CallLeafNativeInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
+  // Save RSP. R13 is chosen because it is callee saved so we do not need to
+  // back it up before calling into the runtime.
+  static const Register kSavedSPReg = R13;
+  __ movq(kSavedSPReg, RSP);
+  __ ReserveAlignedFrameSpace(0);
+  __ CallRuntime(target(), 0);
+  // Restore RSP.
+  __ movq(RSP, kSavedSPReg);
+}
+
 LocationSummary* ExtractNthOutputInstr::MakeLocationSummary(Zone* zone,
                                                             bool opt) const {
   // Only use this instruction in optimized code.
@@ -5975,6 +6123,23 @@ void AllocateObjectInstr::EmitNativeCode(FlowGraphCompiler* compiler) {
                                ArgumentAt(0));
     }
   }
+  if (ShouldPretenure(compiler)) {
+    // Allocate in old space through the runtime, passing the same arguments
+    // as the allocation stub does on its slow path.
+    __ PushObject(Object::null_object());  // Make room for the result.
+    __ PushObject(cls());
+    if (ArgumentCount() == 1) {
+      __ pushq(Address(RSP, 2 * kWordSize));  // Type arguments.
+    } else {
+      __ PushObject(Object::null_object());  // No type arguments.
+    }
+    compiler->GenerateRuntimeCall(token_pos(), Thread::kNoDeoptId,
+                                  kAllocateOldObjectRuntimeEntry, 2, locs());
+    __ Drop(2);
+    __ popq(RAX);
+    __ Drop(ArgumentCount());  // Discard arguments.
+    return;
+  }
   const Code& stub = Code::ZoneHandle(
       compiler->zone(), StubCode::GetAllocationStubForClass(cls()));
   const StubEntry stub_entry(stub);
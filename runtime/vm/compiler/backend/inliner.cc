@@ -6,8 +6,10 @@
 
 #include "vm/compiler/backend/inliner.h"
 
+#include "vm/bootstrap_natives.h"
 #include "vm/compiler/aot/aot_call_specializer.h"
 #include "vm/compiler/aot/precompiler.h"
+#include "vm/compiler/backend/block_coverage.h"
 #include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/flow_graph_compiler.h"
@@ -17,11 +19,13 @@
 #include "vm/compiler/frontend/kernel_to_il.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/compiler/jit/jit_call_specializer.h"
+#include "vm/debugger.h"
 #include "vm/flags.h"
 #include "vm/kernel.h"
 #include "vm/longjump.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
+#include "vm/timeline.h"
 #include "vm/timer.h"
 
 namespace dart {
@@ -74,6 +78,12 @@ DEFINE_FLAG(int,
             60,
             "Inline function calls with sufficient constant arguments "
             "and up to the increased threshold on instructions");
+DEFINE_FLAG(int,
+            inlining_unboxed_arguments_size_threshold,
+            60,
+            "Inline function calls that pass or return double and int64 values "
+            "up to the increased threshold on instructions, so that they do "
+            "not have to be boxed at the call boundary");
 DEFINE_FLAG(int,
             inlining_hotness,
             10,
@@ -87,6 +97,25 @@ DEFINE_FLAG(int,
             max_inlined_per_depth,
             500,
             "Max. number of inlined calls per depth");
+DEFINE_FLAG(bool,
+            profile_guided_inlining,
+            true,
+            "Rank call sites by their execution frequency and inline hot call "
+            "sites rejected by the size heuristics within a code size budget.");
+DEFINE_FLAG(int,
+            inlining_hot_call_frequency,
+            50,
+            "Call sites executed at least that many times per 100 invocations "
+            "of the function being compiled are considered hot.");
+DEFINE_FLAG(int,
+            inlining_hot_callee_size_threshold,
+            200,
+            "Do not inline callees larger than threshold into hot call sites.");
+DEFINE_FLAG(int,
+            inlining_hot_budget,
+            50,
+            "Code size budget for inlining into hot call sites, in percents of "
+            "the initial size of the function being compiled.");
 DEFINE_FLAG(bool, print_inlining_tree, false, "Print inlining tree");
 DEFINE_FLAG(bool,
             enable_inlining_annotations,
@@ -94,7 +123,6 @@ DEFINE_FLAG(bool,
             "Enable inlining annotations");
 
 DECLARE_FLAG(bool, compiler_stats);
-DECLARE_FLAG(int, max_deoptimization_counter_threshold);
 DECLARE_FLAG(bool, print_flow_graph);
 DECLARE_FLAG(bool, print_flow_graph_optimized);
 DECLARE_FLAG(bool, verify_compiler);
@@ -116,6 +144,9 @@ DECLARE_FLAG(bool, verify_compiler);
     }                                                                          \
   } while (false)
 
+// Reason reported for call sites inlined by the profile guided heuristics.
+static const char kHotCallSiteReason[] = "--profile-guided-inlining";
+
 // Is compilation and isolate in strong mode?
 static bool CanUseStrongModeTypes(FlowGraph* flow_graph) {
   return FLAG_use_strong_mode_types && flow_graph->isolate()->strong();
@@ -257,22 +288,30 @@ class CallSites : public ValueObject {
         closure_calls_(),
         instance_calls_() {}
 
+  // Call site information. The ratio is relative to the hottest call site
+  // in the same graph, the frequency is the estimated number of executions of
+  // the call site per invocation of the function being compiled.
   struct InstanceCallInfo {
     PolymorphicInstanceCallInstr* call;
     double ratio;
+    double frequency;
     const FlowGraph* caller_graph;
     InstanceCallInfo(PolymorphicInstanceCallInstr* call_arg,
                      FlowGraph* flow_graph)
-        : call(call_arg), ratio(0.0), caller_graph(flow_graph) {}
+        : call(call_arg),
+          ratio(0.0),
+          frequency(0.0),
+          caller_graph(flow_graph) {}
     const Function& caller() const { return caller_graph->function(); }
   };
 
   struct StaticCallInfo {
     StaticCallInstr* call;
     double ratio;
+    double frequency;
     FlowGraph* caller_graph;
     StaticCallInfo(StaticCallInstr* value, FlowGraph* flow_graph)
-        : call(value), ratio(0.0), caller_graph(flow_graph) {}
+        : call(value), ratio(0.0), frequency(0.0), caller_graph(flow_graph) {}
     const Function& caller() const { return caller_graph->function(); }
   };
 
@@ -312,8 +351,18 @@ class CallSites : public ValueObject {
     instance_calls_.Clear();
   }
 
+  // Sort call sites by decreasing frequency, so that the hottest call sites
+  // get to use the inlining budget first.
+  void SortByFrequency() {
+    instance_calls_.Sort(CompareFrequency<InstanceCallInfo>);
+    static_calls_.Sort(CompareFrequency<StaticCallInfo>);
+  }
+
+  // Compute ratios of the call sites found in the graph. The given scale
+  // converts call counts into frequencies.
   void ComputeCallSiteRatio(intptr_t static_call_start_ix,
-                            intptr_t instance_call_start_ix) {
+                            intptr_t instance_call_start_ix,
+                            double scale) {
     const intptr_t num_static_calls =
         static_calls_.length() - static_call_start_ix;
     const intptr_t num_instance_calls =
@@ -343,6 +392,8 @@ class CallSites : public ValueObject {
               ? 0.0
               : static_cast<double>(instance_call_counts[i]) / max_count;
       instance_calls_[i + instance_call_start_ix].ratio = ratio;
+      instance_calls_[i + instance_call_start_ix].frequency =
+          scale * instance_call_counts[i];
     }
     for (intptr_t i = 0; i < num_static_calls; ++i) {
       const double ratio =
@@ -350,6 +401,8 @@ class CallSites : public ValueObject {
               ? 0.0
               : static_cast<double>(static_call_counts[i]) / max_count;
       static_calls_[i + static_call_start_ix].ratio = ratio;
+      static_calls_[i + static_call_start_ix].frequency =
+          scale * static_call_counts[i];
     }
   }
 
@@ -385,8 +438,11 @@ class CallSites : public ValueObject {
     }
   }
 
+  // The graph_frequency is the estimated number of invocations of the graph
+  // per invocation of the function being compiled.
   void FindCallSites(FlowGraph* graph,
                      intptr_t depth,
+                     double graph_frequency,
                      GrowableArray<InlinedInfo>* inlined_info) {
     ASSERT(graph != NULL);
     if (depth > inlining_depth_threshold_) {
@@ -449,10 +505,21 @@ class CallSites : public ValueObject {
         }
       }
     }
-    ComputeCallSiteRatio(static_call_start_ix, instance_call_start_ix);
+    const intptr_t usage_count =
+        Utils::Maximum(static_cast<intptr_t>(graph->function().usage_counter()),
+                       static_cast<intptr_t>(1));
+    ComputeCallSiteRatio(static_call_start_ix, instance_call_start_ix,
+                         graph_frequency / usage_count);
   }
 
  private:
+  template <typename T>
+  static int CompareFrequency(const T* a, const T* b) {
+    if (a->frequency > b->frequency) return -1;
+    if (a->frequency < b->frequency) return 1;
+    return 0;
+  }
+
   intptr_t inlining_depth_threshold_;
   GrowableArray<StaticCallInfo> static_calls_;
   GrowableArray<ClosureCallInfo> closure_calls_;
@@ -664,6 +731,10 @@ class CallSiteInliner : public ValueObject {
         inlining_depth_threshold_(threshold),
         collected_call_sites_(NULL),
         inlining_call_sites_(NULL),
+        call_frequency_(0.0),
+        hot_budget_(Utils::Maximum(
+            static_cast<intptr_t>(FLAG_inlining_hot_callee_size_threshold),
+            initial_size_ * FLAG_inlining_hot_budget / 100)),
         function_cache_(),
         inlined_info_() {}
 
@@ -693,7 +764,8 @@ class CallSiteInliner : public ValueObject {
   InliningDecision ShouldWeInline(const Function& callee,
                                   intptr_t instr_count,
                                   intptr_t call_site_count,
-                                  intptr_t const_arg_count) {
+                                  intptr_t const_arg_count,
+                                  intptr_t unboxed_arg_count) {
     if (inliner_->AlwaysInline(callee)) {
       return InliningDecision::Yes("AlwaysInline");
     }
@@ -707,7 +779,8 @@ class CallSiteInliner : public ValueObject {
             false, "--inlining-constant-arguments-max-size-threshold");
       }
     } else if (instr_count > FLAG_inlining_callee_size_threshold) {
-      return InliningDecision::No("--inlining-callee-size-threshold");
+      return HotCallSiteDecision(instr_count,
+                                 "--inlining-callee-size-threshold");
     }
     int callee_inlining_depth = callee.inlining_depth();
     if (callee_inlining_depth > 0 && callee_inlining_depth + inlining_depth_ >
@@ -727,7 +800,53 @@ class CallSiteInliner : public ValueObject {
                               "--inlining-constant-arguments-count and "
                               "inlining-constant-arguments-min-size-threshold");
     }
-    return InliningDecision::No("default");
+    if ((unboxed_arg_count > 0) &&
+        (instr_count <= FLAG_inlining_unboxed_arguments_size_threshold)) {
+      return InliningDecision::Yes(
+          "--inlining-unboxed-arguments-size-threshold");
+    }
+    return HotCallSiteDecision(instr_count, "default");
+  }
+
+  // Profile guided part of the heuristics: allow inlining callees rejected
+  // by the static size thresholds into call sites that are executed often
+  // relative to the function being compiled, as long as the hot inlining
+  // budget is not exhausted.
+  InliningDecision HotCallSiteDecision(intptr_t instr_count,
+                                       const char* reason) {
+    if (!FLAG_profile_guided_inlining || FLAG_precompiled_mode ||
+        (call_frequency_ * 100 < FLAG_inlining_hot_call_frequency)) {
+      return InliningDecision::No(reason);
+    }
+    if (instr_count > FLAG_inlining_hot_callee_size_threshold) {
+      return InliningDecision::No("--inlining-hot-callee-size-threshold");
+    }
+    if (instr_count > hot_budget_) {
+      return InliningDecision::No("--inlining-hot-budget");
+    }
+    return InliningDecision::Yes(kHotCallSiteReason);
+  }
+
+  // Record an inlining decision made by the profile guided heuristics in the
+  // compiler timeline.
+  void RecordHotCallSiteDecision(const Function& callee,
+                                 intptr_t instr_count,
+                                 const char* reason) {
+#if !defined(PRODUCT)
+    TimelineStream* stream = Timeline::GetCompilerStream();
+    TimelineEvent* event = (stream != NULL) ? stream->StartEvent() : NULL;
+    if (event != NULL) {
+      event->Instant("InlineHotCallSite");
+      event->SetNumArguments(5);
+      event->CopyArgument(0, "caller",
+                          caller_graph_->function().ToQualifiedCString());
+      event->CopyArgument(1, "callee", callee.ToQualifiedCString());
+      event->FormatArgument(2, "frequency", "%f", call_frequency_);
+      event->FormatArgument(3, "size", "%" Pd, instr_count);
+      event->CopyArgument(4, "decision", reason);
+      event->Complete();
+    }
+#endif  // !defined(PRODUCT)
   }
 
   void InlineCalls() {
@@ -744,7 +863,7 @@ class CallSiteInliner : public ValueObject {
     collected_call_sites_ = &sites1;
     inlining_call_sites_ = &sites2;
     // Collect initial call sites.
-    collected_call_sites_->FindCallSites(caller_graph_, inlining_depth_,
+    collected_call_sites_->FindCallSites(caller_graph_, inlining_depth_, 1.0,
                                          &inlined_info_);
     while (collected_call_sites_->HasCalls()) {
       TRACE_INLINING(
@@ -761,6 +880,9 @@ class CallSiteInliner : public ValueObject {
       collected_call_sites_ = inlining_call_sites_;
       inlining_call_sites_ = call_sites_temp;
       collected_call_sites_->Clear();
+      if (FLAG_profile_guided_inlining) {
+        inlining_call_sites_->SortByFrequency();
+      }
       // Inline call sites at the current depth.
       bool inlined_instance = InlineInstanceCalls();
       bool inlined_statics = InlineStaticCalls();
@@ -818,6 +940,17 @@ class CallSiteInliner : public ValueObject {
       return false;
     }
 
+#if !defined(PRODUCT)
+    // Breakpoints are only hit in unoptimized code. Setting one deoptimizes
+    // the code that inlined the function, which must not inline it again.
+    if (Isolate::Current()->debugger()->HasBreakpoint(function, Z)) {
+      TRACE_INLINING(THR_Print("     Bailout: has breakpoint\n"));
+      PRINT_INLINING_TREE("Breakpoint", &call_data->caller, &function,
+                          call_data->call);
+      return false;
+    }
+#endif  // !defined(PRODUCT)
+
     // Don't inline any intrinsified functions in precompiled mode
     // to reduce code size and make sure we use the intrinsic code.
     if (FLAG_precompiled_mode && function.is_intrinsic() &&
@@ -847,8 +980,7 @@ class CallSiteInliner : public ValueObject {
     }
 
     // Abort if this function has deoptimized too much.
-    if (function.deoptimization_counter() >=
-        FLAG_max_deoptimization_counter_threshold) {
+    if (Compiler::HasExcessiveDeoptimizations(function)) {
       function.set_is_inlinable(false);
       TRACE_INLINING(THR_Print("     Bailout: deoptimization threshold\n"));
       PRINT_INLINING_TREE("Deoptimization threshold exceeded",
@@ -865,9 +997,12 @@ class CallSiteInliner : public ValueObject {
 
     GrowableArray<Value*>* arguments = call_data->arguments;
     const intptr_t constant_arguments = CountConstants(*arguments);
+    const intptr_t unboxed_arguments =
+        CountUnboxedNumbers(function, *arguments);
     InliningDecision decision = ShouldWeInline(
         function, function.optimized_instruction_count(),
-        function.optimized_call_site_count(), constant_arguments);
+        function.optimized_call_site_count(), constant_arguments,
+        unboxed_arguments);
     if (!decision.value) {
       TRACE_INLINING(
           THR_Print("     Bailout: early heuristics (%s) with "
@@ -1051,6 +1186,18 @@ class CallSiteInliner : public ValueObject {
           DEBUG_ASSERT(callee_graph->VerifyUseLists());
         }
 
+        if (FLAG_optimized_coverage && !FLAG_precompiled_mode) {
+          // The inlined blocks record hits for the callee.
+          BlockCoverage::Instrument(callee_graph);
+          const ZoneGrowableArray<const Array*>* records =
+              callee_graph->block_coverage_records();
+          if (records != NULL) {
+            for (intptr_t i = 0; i < records->length(); i++) {
+              caller_graph_->AddBlockCoverageRecord(*records->At(i));
+            }
+          }
+        }
+
         {
           CSTAT_TIMER_SCOPE(thread(), graphinliner_opt_timer);
           // TODO(fschneider): Improve suppression of speculative inlining.
@@ -1122,13 +1269,17 @@ class CallSiteInliner : public ValueObject {
 
         // Use heuristics do decide if this call should be inlined.
         InliningDecision decision =
-            ShouldWeInline(function, size, call_site_count, constants_count);
+            ShouldWeInline(function, size, call_site_count, constants_count,
+                           unboxed_arguments);
         if (!decision.value) {
           // If size is larger than all thresholds, don't consider it again.
           if ((size > FLAG_inlining_size_threshold) &&
               (call_site_count > FLAG_inlining_callee_call_sites_threshold) &&
               (size > FLAG_inlining_constant_arguments_min_size_threshold) &&
-              (size > FLAG_inlining_constant_arguments_max_size_threshold)) {
+              (size > FLAG_inlining_constant_arguments_max_size_threshold) &&
+              (size > FLAG_inlining_unboxed_arguments_size_threshold) &&
+              (!FLAG_profile_guided_inlining ||
+               (size > FLAG_inlining_hot_callee_size_threshold))) {
             function.set_is_inlinable(false);
           }
           thread()->set_deopt_id(prev_deopt_id);
@@ -1149,7 +1300,7 @@ class CallSiteInliner : public ValueObject {
         const intptr_t depth =
             function.IsDispatcherOrImplicitAccessor() ? 0 : inlining_depth_;
         collected_call_sites_->FindCallSites(callee_graph, depth,
-                                             &inlined_info_);
+                                             call_frequency_, &inlined_info_);
 
         // Add the function to the cache.
         if (!in_cache) {
@@ -1159,6 +1310,10 @@ class CallSiteInliner : public ValueObject {
         // Build succeeded so we restore the bailout jump.
         inlined_ = true;
         inlined_size_ += size;
+        if (decision.reason == kHotCallSiteReason) {
+          hot_budget_ -= size;
+          RecordHotCallSiteDecision(function, size, decision.reason);
+        }
         if (is_recursive_call) {
           inlined_recursive_call_ = true;
         }
@@ -1317,6 +1472,28 @@ class CallSiteInliner : public ValueObject {
     return count;
   }
 
+  // Counts the double and int64 values that a call would have to box: the
+  // arguments that are produced unboxed by the caller and the result if the
+  // callee is declared to return a double. Inlining the call lets
+  // representation selection keep these values in registers.
+  static intptr_t CountUnboxedNumbers(const Function& callee,
+                                      const GrowableArray<Value*>& arguments) {
+    intptr_t count = 0;
+    for (intptr_t i = 0; i < arguments.length(); i++) {
+      Definition* defn = arguments[i]->definition()->OriginalDefinition();
+      const intptr_t cid = arguments[i]->Type()->ToCid();
+      if ((cid == kDoubleCid) || (cid == kMintCid) ||
+          defn->IsBinaryInt64Op() || defn->IsShiftInt64Op() ||
+          defn->IsUnaryInt64Op()) {
+        count++;
+      }
+    }
+    if (AbstractType::Handle(callee.result_type()).IsDoubleType()) {
+      count++;
+    }
+    return count;
+  }
+
   // Parse a function reusing the cache if possible.
   ParsedFunction* GetParsedFunction(const Function& function, bool* in_cache) {
     // TODO(zerny): Use a hash map for the cache.
@@ -1344,6 +1521,7 @@ class CallSiteInliner : public ValueObject {
     TRACE_INLINING(THR_Print("  Static Calls (%" Pd ")\n", call_info.length()));
     for (intptr_t call_idx = 0; call_idx < call_info.length(); ++call_idx) {
       StaticCallInstr* call = call_info[call_idx].call;
+      call_frequency_ = call_info[call_idx].frequency;
 
       if (FlowGraphInliner::TryReplaceStaticCallWithInline(
               inliner_->flow_graph(), NULL, call,
@@ -1390,6 +1568,8 @@ class CallSiteInliner : public ValueObject {
         THR_Print("  Closure Calls (%" Pd ")\n", call_info.length()));
     for (intptr_t call_idx = 0; call_idx < call_info.length(); ++call_idx) {
       ClosureCallInstr* call = call_info[call_idx].call;
+      // Closure calls carry no call counts.
+      call_frequency_ = 0.0;
       // Find the closure of the callee.
       ASSERT(call->ArgumentCount() > 0);
       Function& target = Function::ZoneHandle();
@@ -1443,6 +1623,7 @@ class CallSiteInliner : public ValueObject {
                              call_info.length()));
     for (intptr_t call_idx = 0; call_idx < call_info.length(); ++call_idx) {
       PolymorphicInstanceCallInstr* call = call_info[call_idx].call;
+      call_frequency_ = call_info[call_idx].frequency;
       // PolymorphicInliner introduces deoptimization paths.
       if (!call->complete() && !FLAG_polymorphic_with_deopt) {
         TRACE_INLINING(
@@ -1565,6 +1746,10 @@ class CallSiteInliner : public ValueObject {
   intptr_t inlining_depth_threshold_;
   CallSites* collected_call_sites_;
   CallSites* inlining_call_sites_;
+  // Frequency of the call site currently considered for inlining.
+  double call_frequency_;
+  // Remaining code size budget for inlining into hot call sites.
+  intptr_t hot_budget_;
   GrowableArray<ParsedFunction*> function_cache_;
   GrowableArray<InlinedInfo> inlined_info_;
 
@@ -3368,6 +3553,40 @@ static bool InlineMathCFunction(FlowGraph* flow_graph,
   return true;
 }
 
+// Replaces a call to a bootstrap native that has a leaf version (see
+// BOOTSTRAP_LEAF_NATIVE_LIST) with a direct call to that leaf runtime entry.
+static bool InlineLeafNative(FlowGraph* flow_graph,
+                             const Function& target,
+                             Definition* call,
+                             TargetEntryInstr** entry,
+                             Instruction** last) {
+  if (!FlowGraphCompiler::SupportsUnboxedInt64() || !target.is_static() ||
+      (target.NumParameters() != 0)) {
+    return false;
+  }
+  // Native names are only meaningful to the resolver of the declaring
+  // library, so only trust them in the core libraries.
+  const Class& owner = Class::Handle(Z, target.Owner());
+  if (!Library::Handle(Z, owner.library()).is_dart_scheme()) {
+    return false;
+  }
+  const String& native_name = String::ZoneHandle(Z, target.native_name());
+  if (native_name.IsNull()) {
+    return false;
+  }
+  const RuntimeEntry* leaf = BootstrapNatives::LookupLeaf(native_name);
+  if (leaf == NULL) {
+    return false;
+  }
+  *entry = new (Z)
+      TargetEntryInstr(flow_graph->allocate_block_id(),
+                       call->GetBlock()->try_index(), Thread::kNoDeoptId);
+  (*entry)->InheritDeoptTarget(Z, call);
+  *last = new (Z) CallLeafNativeInstr(*leaf, native_name);
+  flow_graph->AppendTo(*entry, *last, NULL, FlowGraph::kValue);
+  return true;
+}
+
 bool FlowGraphInliner::TryInlineRecognizedMethod(
     FlowGraph* flow_graph,
     intptr_t receiver_cid,
@@ -3383,6 +3602,11 @@ bool FlowGraphInliner::TryInlineRecognizedMethod(
 
   const MethodRecognizer::Kind kind = MethodRecognizer::RecognizeKind(target);
 
+  if (target.is_native() &&
+      InlineLeafNative(flow_graph, target, call, entry, last)) {
+    return true;
+  }
+
   switch (kind) {
     // Recognized [] operators.
     case MethodRecognizer::kImmutableArrayGetIndexed:
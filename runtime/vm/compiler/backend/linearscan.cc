@@ -32,6 +32,14 @@ static const intptr_t kIllegalPosition = -1;
 static const intptr_t kMaxPosition = 0x7FFFFFFF;
 static const intptr_t kPairVirtualRegisterOffset = 1;
 
+// Estimated number of iterations of a loop used to derive block frequencies
+// when no profile is available.
+static const double kLoopFrequencyEstimate = 10.0;
+
+// Maximum number of block entries considered by SplitBetween when searching
+// for the least frequently executed split position.
+static const intptr_t kMaxSplitCandidates = 32;
+
 // Definitions which have pair representations
 // (kPairOfTagged) use two virtual register names.
 // At SSA index allocation time each definition reserves two SSA indexes,
@@ -923,6 +931,20 @@ void FlowGraphAllocator::ConnectIncomingPhiMoves(JoinEntryInstr* join) {
       if (is_loop_header) second_range->mark_loop_phi();
     }
 
+    // Hint the phi with the location of its input on the first forward
+    // edge: the input is allocated before the phi and sharing a register
+    // with it removes the move on that edge.
+    Definition* hint_input = NULL;
+    for (intptr_t pred_idx = 0; pred_idx < phi->InputCount(); pred_idx++) {
+      BlockEntryInstr* pred = join->PredecessorAt(pred_idx);
+      Definition* input = phi->InputAt(pred_idx)->definition();
+      if ((pred->postorder_number() > join->postorder_number()) &&
+          !input->IsConstant() && (input->ssa_temp_index() >= 0)) {
+        hint_input = input;
+        break;
+      }
+    }
+
     for (intptr_t pred_idx = 0; pred_idx < phi->InputCount(); pred_idx++) {
       BlockEntryInstr* pred = join->PredecessorAt(pred_idx);
       GotoInstr* goto_instr = pred->last_instruction()->AsGoto();
@@ -930,13 +952,27 @@ void FlowGraphAllocator::ConnectIncomingPhiMoves(JoinEntryInstr* join) {
       MoveOperands* move =
           goto_instr->parallel_move()->MoveOperandsAt(move_idx);
       move->set_dest(Location::PrefersRegister());
-      range->AddUse(pos, move->dest_slot());
+      if (hint_input != NULL) {
+        range->AddHintedUse(
+            pos, move->dest_slot(),
+            GetLiveRange(hint_input->ssa_temp_index())
+                ->assigned_location_slot());
+      } else {
+        range->AddUse(pos, move->dest_slot());
+      }
       if (is_pair_phi) {
         LiveRange* second_range = GetLiveRange(ToSecondPairVreg(vreg));
         MoveOperands* second_move =
             goto_instr->parallel_move()->MoveOperandsAt(move_idx + 1);
         second_move->set_dest(Location::PrefersRegister());
-        second_range->AddUse(pos, second_move->dest_slot());
+        if (hint_input != NULL) {
+          second_range->AddHintedUse(
+              pos, second_move->dest_slot(),
+              GetLiveRange(ToSecondPairVreg(hint_input->ssa_temp_index()))
+                  ->assigned_location_slot());
+        } else {
+          second_range->AddUse(pos, second_move->dest_slot());
+        }
       }
     }
 
@@ -1642,6 +1678,42 @@ void FlowGraphAllocator::DiscoverLoops() {
   }
 }
 
+void FlowGraphAllocator::ComputeBlockFrequencies() {
+  // Edge weights assigned by the BlockScheduler are counts per function
+  // entry. They are only available in JIT mode.
+  const bool has_profile = FLAG_reorder_basic_blocks &&
+                           (flow_graph_.graph_entry()->entry_count() > 0);
+
+  for (intptr_t i = 0; i < block_order_.length(); i++) {
+    BlockEntryInstr* block = block_order_[i];
+    BlockInfo* info = BlockInfoAt(block->start_pos());
+
+    // For loop headers loop information points to the outer loop, so
+    // the estimate does not count iterations of the loop itself.
+    double frequency = 1.0;
+    for (BlockInfo* loop = info->loop(); loop != NULL; loop = loop->loop()) {
+      frequency *= kLoopFrequencyEstimate;
+    }
+
+    if (has_profile) {
+      if (block->IsTargetEntry()) {
+        frequency = block->AsTargetEntry()->edge_weight();
+      } else if (block->IsJoinEntry()) {
+        frequency = 0.0;
+        for (intptr_t j = 0; j < block->PredecessorCount(); j++) {
+          BlockEntryInstr* pred = block->PredecessorAt(j);
+          // Skip back edges.
+          if (pred->postorder_number() <= block->postorder_number()) continue;
+          GotoInstr* goto_instr = pred->last_instruction()->AsGoto();
+          if (goto_instr != NULL) frequency += goto_instr->edge_weight();
+        }
+      }
+    }
+
+    info->set_entry_frequency(frequency);
+  }
+}
+
 Instruction* FlowGraphAllocator::InstructionAt(intptr_t pos) const {
   return instructions_[pos / 2];
 }
@@ -1860,6 +1932,7 @@ LiveRange* FlowGraphAllocator::SplitBetween(LiveRange* range,
   BlockInfo* split_block = BlockInfoAt(to);
   if (from < split_block->entry()->lifetime_position()) {
     // Interval [from, to) spans multiple blocks.
+    BlockInfo* last_block = split_block;
 
     // If last block is inside a loop prefer splitting at outermost loop's
     // header.
@@ -1870,6 +1943,24 @@ LiveRange* FlowGraphAllocator::SplitBetween(LiveRange* range,
       loop_header = loop_header->loop();
     }
 
+    // Resolution moves for a split at a block's start are inserted on the
+    // edges entering the block. Look for a block in (from, to] entered less
+    // often than the header found above, preferring later blocks to keep
+    // the range in its current location longer.
+    const intptr_t last_index =
+        block_order_.length() - 1 - last_block->entry()->postorder_number();
+    ASSERT(block_order_[last_index] == last_block->entry());
+    for (intptr_t i = last_index, n = 0;
+         (i > 0) && (n < kMaxSplitCandidates); i--, n++) {
+      BlockEntryInstr* block = block_order_[i];
+      if (block->lifetime_position() <= from) break;
+      BlockInfo* info = BlockInfoAt(block->lifetime_position());
+      if ((info->entry_frequency() < split_block->entry_frequency()) &&
+          range->Contains(block->lifetime_position())) {
+        split_block = info;
+      }
+    }
+
     // Split at block's start.
     split_pos = split_block->entry()->lifetime_position();
   } else {
@@ -1912,18 +2003,17 @@ void FlowGraphAllocator::SpillAfter(LiveRange* range, intptr_t from) {
 
   // When spilling the value inside the loop check if this spill can
   // be moved outside.
-  BlockInfo* block_info = BlockInfoAt(from);
-  if (block_info->is_loop_header() || (block_info->loop() != NULL)) {
-    BlockInfo* loop_header =
-        block_info->is_loop_header() ? block_info : block_info->loop();
-
-    if ((range->Start() <= loop_header->entry()->start_pos()) &&
-        RangeHasOnlyUnconstrainedUsesInLoop(range, loop_header->loop_id())) {
-      ASSERT(loop_header->entry()->start_pos() <= from);
-      from = loop_header->entry()->start_pos();
-      TRACE_ALLOC(
-          THR_Print("  moved spill position to loop header %" Pd "\n", from));
-    }
+  // The spill can be moved into the header of the outermost enclosing loop
+  // in which the range has only unconstrained uses.
+  BlockInfo* loop_header = BlockInfoAt(from)->loop_header();
+  while ((loop_header != NULL) &&
+         (range->Start() <= loop_header->entry()->start_pos()) &&
+         RangeHasOnlyUnconstrainedUsesInLoop(range, loop_header->loop_id())) {
+    ASSERT(loop_header->entry()->start_pos() <= from);
+    from = loop_header->entry()->start_pos();
+    TRACE_ALLOC(
+        THR_Print("  moved spill position to loop header %" Pd "\n", from));
+    loop_header = loop_header->loop();
   }
 
   LiveRange* tail = range->SplitAt(from);
@@ -2945,6 +3035,8 @@ void FlowGraphAllocator::AllocateRegisters() {
 
   DiscoverLoops();
 
+  ComputeBlockFrequencies();
+
 #if defined(TARGET_ARCH_DBC)
   last_used_register_ = -1;
 #endif
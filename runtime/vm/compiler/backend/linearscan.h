@@ -93,6 +93,11 @@ class FlowGraphAllocator : public ValueObject {
   // optimal splitting position.
   void DiscoverLoops();
 
+  // Estimate how often control enters each block from outside of the loop
+  // it heads. Used by SplitBetween to place moves created by splitting into
+  // the least frequently executed blocks.
+  void ComputeBlockFrequencies();
+
   LiveRange* MakeLiveRangeForTemporary();
 
   // Visit instructions in the postorder and build live ranges for
@@ -340,6 +345,7 @@ class BlockInfo : public ZoneAllocated {
       : entry_(entry),
         loop_(NULL),
         is_loop_header_(false),
+        entry_frequency_(1.0),
         backedge_interference_(NULL) {}
 
   BlockEntryInstr* entry() const { return entry_; }
@@ -375,6 +381,11 @@ class BlockInfo : public ZoneAllocated {
   intptr_t loop_id() const { return loop_id_; }
   void set_loop_id(intptr_t loop_id) { loop_id_ = loop_id; }
 
+  // Estimated number of times control enters this block per invocation of
+  // the function, not counting back edges of the loop headed by this block.
+  double entry_frequency() const { return entry_frequency_; }
+  void set_entry_frequency(double frequency) { entry_frequency_ = frequency; }
+
   BitVector* backedge_interference() const { return backedge_interference_; }
 
   void set_backedge_interference(BitVector* backedge_interference) {
@@ -389,6 +400,8 @@ class BlockInfo : public ZoneAllocated {
   BlockEntryInstr* last_block_;
   intptr_t loop_id_;
 
+  double entry_frequency_;
+
   BitVector* backedge_interference_;
 
   DISALLOW_COPY_AND_ASSIGN(BlockInfo);
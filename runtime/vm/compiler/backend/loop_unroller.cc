@@ -0,0 +1,449 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_printer.h"
+#include "vm/compiler/backend/range_analysis.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool, loop_unrolling, false, "Unroll small innermost loops.");
+DEFINE_FLAG(int,
+            loop_unrolling_max_body,
+            24,
+            "Maximum number of instructions in the body of an unrolled loop.");
+DEFINE_FLAG(bool, trace_loop_unrolling, false, "Trace loop unrolling.");
+
+// Returns true if the given instruction can be duplicated without
+// duplicating any deoptimization or exception state: the copy is created
+// without an environment.
+static bool CanClone(Instruction* instr) {
+  if (instr->ComputeCanDeoptimize() || instr->MayThrow() ||
+      instr->HasUnknownSideEffects()) {
+    return false;
+  }
+  if (instr->IsBinaryIntegerOp()) {
+    switch (instr->AsBinaryIntegerOp()->representation()) {
+      case kTagged:
+      case kUnboxedInt32:
+      case kUnboxedUint32:
+      case kUnboxedInt64:
+        return true;
+      default:
+        return false;
+    }
+  }
+  if (instr->IsStoreIndexed()) {
+    return !instr->AsStoreIndexed()->ShouldEmitStoreBarrier();
+  }
+  return instr->IsBinaryDoubleOp() || instr->IsLoadIndexed() ||
+         instr->IsLoadUntagged();
+}
+
+// Loop of the shape
+//
+//   B_header:
+//     v_i <- phi(v_init, v_next)
+//     [CheckStackOverflow]
+//     Branch if COMP(v_i, v_n) goto (B_body, B_exit)
+//   B_body:
+//     ...
+//     v_next <- v_i + 1
+//     goto B_header
+//
+// which is rewritten into
+//
+//   B_header:
+//     v_i <- phi(v_init, v_next')
+//     [CheckStackOverflow]
+//     Branch if COMP(v_i, v_n) goto (B_body, B_exit)
+//   B_body:
+//     ...
+//     v_next <- v_i + 1
+//     Branch if COMP(v_next, v_n) goto (B_body', B_exit')
+//   B_body':
+//     ...
+//     v_next' <- v_next + 1
+//     goto B_header
+//   B_exit:
+//     goto B_join
+//   B_exit':
+//     goto B_join
+//   B_join:
+//     v_i' <- phi(v_i, v_next)
+//     ... original contents of B_exit using v_i' instead of v_i ...
+//
+// Only the loop condition is duplicated: there is no remainder loop since
+// the second copy of the body is guarded by its own exit test.
+class SimpleLoop : public ZoneAllocated {
+ public:
+  SimpleLoop(FlowGraph* flow_graph,
+             JoinEntryInstr* header,
+             TargetEntryInstr* body,
+             TargetEntryInstr* exit)
+      : flow_graph_(flow_graph),
+        zone_(flow_graph->zone()),
+        header_(header),
+        body_(body),
+        exit_(exit),
+        branch_(header->last_instruction()->AsBranch()),
+        back_edge_index_(header->IndexOfPredecessor(body)),
+        phis_(),
+        next_values_(),
+        originals_(),
+        copies_() {}
+
+  // Recognize a loop with single block body that can be unrolled.
+  static SimpleLoop* Match(FlowGraph* flow_graph, BlockEntryInstr* header);
+
+  void Unroll();
+
+ private:
+  // Value of the given definition after the first copy of the body.
+  Definition* NextValue(Definition* defn) const;
+
+  // Value of the given definition inside the second copy of the body.
+  Definition* CopiedValue(Definition* defn) const;
+
+  Instruction* Clone(Instruction* instr);
+
+  void RenameUsesAfterLoop(JoinEntryInstr* join,
+                           TargetEntryInstr* body2,
+                           TargetEntryInstr* exit2);
+
+  // Uses in the exit phis themselves refer to the values on loop exit.
+  bool IsUseAfterLoop(Value* use,
+                      JoinEntryInstr* join,
+                      TargetEntryInstr* body2,
+                      TargetEntryInstr* exit2) const {
+    BlockEntryInstr* block = use->instruction()->GetBlock();
+    if (block == join) {
+      return !use->instruction()->IsPhi();
+    }
+    return (block != header_) && (block != body_) && (block != exit_) &&
+           (block != body2) && (block != exit2);
+  }
+
+  FlowGraph* flow_graph_;
+  Zone* zone_;
+  JoinEntryInstr* header_;
+  TargetEntryInstr* body_;
+  TargetEntryInstr* exit_;
+  BranchInstr* branch_;
+  const intptr_t back_edge_index_;
+
+  // Header phis and their inputs along the back edge.
+  GrowableArray<PhiInstr*> phis_;
+  GrowableArray<Definition*> next_values_;
+
+  // Definitions of the body and their copies.
+  GrowableArray<Definition*> originals_;
+  GrowableArray<Definition*> copies_;
+
+  DISALLOW_COPY_AND_ASSIGN(SimpleLoop);
+};
+
+SimpleLoop* SimpleLoop::Match(FlowGraph* flow_graph, BlockEntryInstr* block) {
+  JoinEntryInstr* header = block->AsJoinEntry();
+  if ((header == NULL) || (header->PredecessorCount() != 2) ||
+      header->InsideTryBlock()) {
+    return NULL;
+  }
+
+  // The loop consists of the header and a single body block.
+  intptr_t loop_size = 0;
+  for (BitVector::Iterator it(header->loop_info()); !it.Done(); it.Advance()) {
+    loop_size++;
+  }
+  if (loop_size != 2) {
+    return NULL;
+  }
+
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  if ((branch == NULL) || (branch->comparison()->InputCount() != 2) ||
+      branch->comparison()->ComputeCanDeoptimize() || branch->MayThrow()) {
+    return NULL;
+  }
+  for (Instruction* instr = header->next(); instr != branch;
+       instr = instr->next()) {
+    if (!instr->IsCheckStackOverflow()) {
+      return NULL;
+    }
+  }
+
+  TargetEntryInstr* body = branch->true_successor();
+  TargetEntryInstr* exit = branch->false_successor();
+  if (!header->loop_info()->Contains(body->preorder_number())) {
+    body = branch->false_successor();
+    exit = branch->true_successor();
+  }
+  if (!header->loop_info()->Contains(body->preorder_number()) ||
+      header->loop_info()->Contains(exit->preorder_number())) {
+    return NULL;
+  }
+  GotoInstr* back_edge = body->last_instruction()->AsGoto();
+  if ((back_edge == NULL) || (back_edge->successor() != header)) {
+    return NULL;
+  }
+
+  intptr_t body_size = 0;
+  bool has_indexed_access = false;
+  for (Instruction* instr = body->next(); instr != back_edge;
+       instr = instr->next()) {
+    if (!CanClone(instr) || (++body_size > FLAG_loop_unrolling_max_body)) {
+      return NULL;
+    }
+    has_indexed_access = has_indexed_access || instr->IsLoadIndexed() ||
+                         instr->IsStoreIndexed();
+  }
+  // Unrolling only pays off for loops which access arrays: it halves the
+  // number of stack overflow checks and exposes more independent loads and
+  // stores to the register allocator.
+  if (!has_indexed_access) {
+    return NULL;
+  }
+
+  SimpleLoop* loop = new SimpleLoop(flow_graph, header, body, exit);
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    Definition* next = phi->InputAt(loop->back_edge_index_)->definition();
+    if (next->representation() != phi->representation()) {
+      return NULL;
+    }
+    loop->phis_.Add(phi);
+    loop->next_values_.Add(next);
+  }
+  return loop;
+}
+
+Definition* SimpleLoop::NextValue(Definition* defn) const {
+  for (intptr_t i = 0; i < phis_.length(); i++) {
+    if (phis_[i] == defn) {
+      return next_values_[i];
+    }
+  }
+  return defn;
+}
+
+Definition* SimpleLoop::CopiedValue(Definition* defn) const {
+  for (intptr_t i = 0; i < originals_.length(); i++) {
+    if (originals_[i] == defn) {
+      return copies_[i];
+    }
+  }
+  return NextValue(defn);
+}
+
+Instruction* SimpleLoop::Clone(Instruction* instr) {
+  Value* inputs[3] = {NULL, NULL, NULL};
+  ASSERT(instr->InputCount() <= 3);
+  for (intptr_t i = 0; i < instr->InputCount(); i++) {
+    inputs[i] = new (zone_) Value(CopiedValue(instr->InputAt(i)->definition()));
+  }
+
+  if (BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp()) {
+    return BinaryIntegerOpInstr::Make(
+        op->representation(), op->op_kind(), inputs[0], inputs[1],
+        Thread::kNoDeoptId, op->can_overflow(), op->is_truncating(),
+        op->range(), op->speculative_mode());
+  } else if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+    return new (zone_)
+        BinaryDoubleOpInstr(op->op_kind(), inputs[0], inputs[1],
+                            Thread::kNoDeoptId, op->token_pos(),
+                            op->speculative_mode());
+  } else if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+    return new (zone_) LoadIndexedInstr(
+        inputs[0], inputs[1], load->index_scale(), load->class_id(),
+        load->aligned() ? kAlignedAccess : kUnalignedAccess,
+        Thread::kNoDeoptId, load->token_pos());
+  } else if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+    return new (zone_) StoreIndexedInstr(
+        inputs[0], inputs[1], inputs[2], kNoStoreBarrier,
+        store->index_scale(), store->class_id(),
+        store->aligned() ? kAlignedAccess : kUnalignedAccess,
+        Thread::kNoDeoptId, store->token_pos());
+  } else if (LoadUntaggedInstr* load = instr->AsLoadUntagged()) {
+    return new (zone_) LoadUntaggedInstr(inputs[0], load->offset());
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+void SimpleLoop::Unroll() {
+  if (FLAG_support_il_printer && FLAG_trace_loop_unrolling) {
+    THR_Print("Unrolling loop B%" Pd " with body B%" Pd "\n",
+              header_->block_id(), body_->block_id());
+  }
+
+  // Blocks which replace the body and the exit inherit their block ids to
+  // keep the order of phi inputs in the header and in the successors of the
+  // exit unchanged.
+  GotoInstr* back_edge = body_->last_instruction()->AsGoto();
+  TargetEntryInstr* body2 = new (zone_) TargetEntryInstr(
+      body_->block_id(), body_->try_index(), Thread::kNoDeoptId);
+  body2->InheritDeoptTarget(zone_, body_);
+  body_->set_block_id(flow_graph_->allocate_block_id());
+
+  JoinEntryInstr* join = new (zone_) JoinEntryInstr(
+      exit_->block_id(), exit_->try_index(), Thread::kNoDeoptId);
+  join->InheritDeoptTarget(zone_, exit_);
+  join->LinkTo(exit_->next());
+  join->set_last_instruction(exit_->last_instruction());
+  exit_->set_block_id(flow_graph_->allocate_block_id());
+  GotoInstr* goto_join = new (zone_) GotoInstr(join, Thread::kNoDeoptId);
+  goto_join->InheritDeoptTarget(zone_, join);
+  exit_->LinkTo(goto_join);
+  exit_->set_last_instruction(goto_join);
+
+  // Allocated after the id of the original exit: join's phi inputs are
+  // ordered (original exit, second exit).
+  TargetEntryInstr* exit2 = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), exit_->try_index(),
+      Thread::kNoDeoptId);
+  exit2->InheritDeoptTarget(zone_, join);
+  GotoInstr* goto_join2 = new (zone_) GotoInstr(join, Thread::kNoDeoptId);
+  goto_join2->InheritDeoptTarget(zone_, join);
+  exit2->LinkTo(goto_join2);
+  exit2->set_last_instruction(goto_join2);
+
+  // Second copy of the body.
+  Instruction* last = body2;
+  for (Instruction* instr = body_->next(); instr != back_edge;
+       instr = instr->next()) {
+    Instruction* copy = Clone(instr);
+    Definition* defn = instr->AsDefinition();
+    const bool is_value = (defn != NULL) && defn->HasSSATemp();
+    last = flow_graph_->AppendTo(last, copy, NULL,
+                                 is_value ? FlowGraph::kValue
+                                          : FlowGraph::kEffect);
+    if (defn != NULL) {
+      if (!Range::IsUnknown(defn->range())) {
+        // Values computed by the copy are values computed by the original
+        // on the next iteration, so the original range applies.
+        copy->AsDefinition()->set_range(*defn->range());
+      }
+      originals_.Add(defn);
+      copies_.Add(copy->AsDefinition());
+    }
+  }
+  GotoInstr* back_edge2 = new (zone_) GotoInstr(header_, Thread::kNoDeoptId);
+  back_edge2->InheritDeoptTarget(zone_, back_edge);
+  last->AppendInstruction(back_edge2);
+  body2->set_last_instruction(back_edge2);
+
+  // Exit test between the two copies of the body.
+  ComparisonInstr* comparison = branch_->comparison();
+  ComparisonInstr* new_comparison = comparison->CopyWithNewOperands(
+      new (zone_) Value(NextValue(comparison->left()->definition())),
+      new (zone_) Value(NextValue(comparison->right()->definition())));
+  BranchInstr* new_branch =
+      new (zone_) BranchInstr(new_comparison, Thread::kNoDeoptId);
+  new_branch->InheritDeoptTarget(zone_, back_edge);
+  new_branch->InsertBefore(back_edge);
+  new_branch->set_next(NULL);
+  back_edge->UnuseAllInputs();
+  body_->set_last_instruction(new_branch);
+  const bool body_on_true = (branch_->true_successor() == body_);
+  *new_branch->true_successor_address() = body_on_true ? body2 : exit2;
+  *new_branch->false_successor_address() = body_on_true ? exit2 : body2;
+
+  RenameUsesAfterLoop(join, body2, exit2);
+
+  // Header phis now flow in from the end of the second copy.
+  for (intptr_t i = 0; i < phis_.length(); i++) {
+    phis_[i]->InputAt(back_edge_index_)->BindTo(CopiedValue(next_values_[i]));
+  }
+}
+
+// Code after the loop is dominated by the header and can only observe loop
+// state through header phis. Once the loop can be left from the middle of
+// the unrolled body these uses need to merge both exits.
+void SimpleLoop::RenameUsesAfterLoop(JoinEntryInstr* join,
+                                     TargetEntryInstr* body2,
+                                     TargetEntryInstr* exit2) {
+  GrowableArray<Value*> input_uses;
+  GrowableArray<Value*> env_uses;
+  for (intptr_t i = 0; i < phis_.length(); i++) {
+    PhiInstr* phi = phis_[i];
+    input_uses.Clear();
+    env_uses.Clear();
+    for (Value::Iterator it(phi->input_use_list()); !it.Done(); it.Advance()) {
+      Value* use = it.Current();
+      if (IsUseAfterLoop(use, join, body2, exit2)) {
+        input_uses.Add(use);
+      }
+    }
+    for (Value::Iterator it(phi->env_use_list()); !it.Done(); it.Advance()) {
+      Value* use = it.Current();
+      if (IsUseAfterLoop(use, join, body2, exit2)) {
+        env_uses.Add(use);
+      }
+    }
+    if (input_uses.is_empty() && env_uses.is_empty()) {
+      continue;
+    }
+
+    PhiInstr* exit_phi = new (zone_) PhiInstr(join, 2);
+    Value* input = new (zone_) Value(phi);
+    exit_phi->SetInputAt(0, input);
+    phi->AddInputUse(input);
+    input = new (zone_) Value(next_values_[i]);
+    exit_phi->SetInputAt(1, input);
+    next_values_[i]->AddInputUse(input);
+    exit_phi->set_representation(phi->representation());
+    if (!Range::IsUnknown(phi->range())) {
+      exit_phi->set_range(*phi->range());
+    }
+    exit_phi->mark_alive();
+    flow_graph_->AllocateSSAIndexes(exit_phi);
+    join->InsertPhi(exit_phi);
+
+    for (intptr_t j = 0; j < input_uses.length(); j++) {
+      input_uses[j]->BindTo(exit_phi);
+    }
+    for (intptr_t j = 0; j < env_uses.length(); j++) {
+      env_uses[j]->BindToEnvironment(exit_phi);
+    }
+  }
+}
+
+void LoopUnroller::Optimize(FlowGraph* flow_graph) {
+  if (!FLAG_loop_unrolling) {
+    return;
+  }
+
+  // Loops with a single block body don't contain other loops and don't
+  // share blocks with each other, so all of them can be matched before
+  // the graph is changed.
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      flow_graph->LoopHeaders();
+  GrowableArray<SimpleLoop*> loops;
+  for (intptr_t i = 0; i < loop_headers.length(); i++) {
+    SimpleLoop* loop = SimpleLoop::Match(flow_graph, loop_headers[i]);
+    if (loop != NULL) {
+      loops.Add(loop);
+    }
+  }
+  if (loops.is_empty()) {
+    return;
+  }
+
+  for (intptr_t i = 0; i < loops.length(); i++) {
+    loops[i]->Unroll();
+  }
+
+  flow_graph->DiscoverBlocks();
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
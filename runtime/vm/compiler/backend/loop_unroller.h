@@ -0,0 +1,30 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Unroll innermost loops with a single block body by a factor of two.
+//
+// The pass is intended to run after range analysis: by then bounds checks
+// inside counted loops over typed data were either proven redundant or
+// generalized into a single check hoisted into the loop pre-header, which
+// deoptimizes into the unoptimized (checked) version of the loop if the
+// whole iteration space is not in range. Bodies of such loops consist only
+// of pure arithmetic and unchecked indexed accesses, which can be duplicated
+// without duplicating any deoptimization or exception state.
+class LoopUnroller : public AllStatic {
+ public:
+  static void Optimize(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_UNROLLER_H_
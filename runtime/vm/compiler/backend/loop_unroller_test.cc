@@ -0,0 +1,96 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_unroller.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/dart_api_impl.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+DECLARE_FLAG(bool, loop_unrolling);
+
+// Counts the loads from arrays with the given class id in the optimized flow
+// graph of the function 'name'.
+static intptr_t CountOptimizedLoads(Dart_Handle lib,
+                                    const char* name,
+                                    intptr_t class_id) {
+  TransitionNativeToVM transition(Thread::Current());
+  StackZone zone(Thread::Current());
+  HANDLESCOPE(Thread::Current());
+  const Library& library = Library::CheckedHandle(Api::UnwrapHandle(lib));
+  const Function& function =
+      Function::Handle(library.LookupFunctionAllowPrivate(
+          String::Handle(Symbols::New(Thread::Current(), name))));
+  EXPECT(!function.IsNull());
+  FlowGraph* flow_graph = CompilerTest::BuildOptimizedFlowGraph(function);
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      LoadIndexedInstr* load = it.Current()->AsLoadIndexed();
+      if ((load != NULL) && (load->class_id() == class_id)) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+static const char* kUnrollingScript =
+    "import 'dart:typed_data';\n"
+    "sum(Float64List a) {\n"
+    "  double s = 0.0;\n"
+    "  for (int i = 0; i < a.length; i++) s += a[i];\n"
+    "  return s;\n"
+    "}\n"
+    "sumSquares(Float64List a) {\n"
+    "  double s = 0.0;\n"
+    "  for (int i = 0; i * i < a.length; i++) s += a[i * i];\n"
+    "  return s;\n"
+    "}\n"
+    "main() {\n"
+    "  var a = new Float64List(100);\n"
+    "  for (int i = 0; i < 10; i++) {\n"
+    "    sum(a);\n"
+    "    sumSquares(a);\n"
+    "  }\n"
+    "}\n";
+
+TEST_CASE(LoopUnroller_UnrollsSimpleLoop) {
+  Dart_Handle lib = TestCase::LoadTestScript(kUnrollingScript, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+
+  const bool saved_loop_unrolling = FLAG_loop_unrolling;
+  FLAG_loop_unrolling = false;
+  EXPECT_EQ(1, CountOptimizedLoads(lib, "sum", kTypedDataFloat64ArrayCid));
+  // The body of the unrolled loop is duplicated.
+  FLAG_loop_unrolling = true;
+  EXPECT_EQ(2, CountOptimizedLoads(lib, "sum", kTypedDataFloat64ArrayCid));
+  FLAG_loop_unrolling = saved_loop_unrolling;
+}
+
+TEST_CASE(LoopUnroller_KeepsCheckedLoop) {
+  Dart_Handle lib = TestCase::LoadTestScript(kUnrollingScript, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+
+  // The bounds check of a[i * i] stays in the loop, which can deoptimize
+  // and so must not be duplicated.
+  const bool saved_loop_unrolling = FLAG_loop_unrolling;
+  FLAG_loop_unrolling = true;
+  EXPECT_EQ(1,
+            CountOptimizedLoads(lib, "sumSquares", kTypedDataFloat64ArrayCid));
+  FLAG_loop_unrolling = saved_loop_unrolling;
+}
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+}  // namespace dart
@@ -0,0 +1,655 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/il_printer.h"
+#include "vm/compiler/backend/range_analysis.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_vectorization,
+            false,
+            "Vectorize element-wise loops over typed data.");
+DEFINE_FLAG(bool, trace_loop_vectorization, false, "Trace loop vectorization.");
+
+// Element types of typed data arrays supported by the vectorizer and their
+// 128-bit vector counterparts.
+enum LaneKind {
+  kNoLanes,
+  kFloat32Lanes,  // Float32List as Float32x4.
+  kFloat64Lanes,  // Float64List as Float64x2.
+  kInt32Lanes,    // Int32List and Uint32List as Int32x4.
+};
+
+static LaneKind LaneKindOf(intptr_t array_cid) {
+  switch (array_cid) {
+    case kTypedDataFloat32ArrayCid:
+      return kFloat32Lanes;
+    case kTypedDataFloat64ArrayCid:
+      return kFloat64Lanes;
+    case kTypedDataInt32ArrayCid:
+    case kTypedDataUint32ArrayCid:
+      return kInt32Lanes;
+    default:
+      return kNoLanes;
+  }
+}
+
+static intptr_t LaneCount(LaneKind kind) {
+  return (kind == kFloat64Lanes) ? 2 : 4;
+}
+
+static intptr_t VectorArrayCid(LaneKind kind) {
+  switch (kind) {
+    case kFloat32Lanes:
+      return kTypedDataFloat32x4ArrayCid;
+    case kFloat64Lanes:
+      return kTypedDataFloat64x2ArrayCid;
+    case kInt32Lanes:
+      return kTypedDataInt32x4ArrayCid;
+    default:
+      UNREACHABLE();
+      return kIllegalCid;
+  }
+}
+
+static intptr_t VectorCid(LaneKind kind) {
+  switch (kind) {
+    case kFloat32Lanes:
+      return kFloat32x4Cid;
+    case kFloat64Lanes:
+      return kFloat64x2Cid;
+    case kInt32Lanes:
+      return kInt32x4Cid;
+    default:
+      UNREACHABLE();
+      return kIllegalCid;
+  }
+}
+
+// Vector counterpart of a scalar definition in the loop body.
+//
+// Scalar code operating on Float32List elements computes in double
+// precision and rounds when storing. For a single +, -, * or / of two floats
+// rounding the double result to float gives the same value as the float
+// operation (double has more than twice as many significand bits), so a
+// Float32x4 operation can only be used if both operands are exactly
+// representable as floats and the result is immediately rounded.
+struct VectorValue {
+  Definition* scalar;
+  Definition* vector;
+  LaneKind kind;
+  bool exact;
+};
+
+// Counted loop with a single block body where all instructions other than
+// the induction variable increment are element-wise accesses and
+// arithmetic:
+//
+//   B_pre_header:
+//     goto B_header
+//   B_header:
+//     v_i <- phi(v_i0, v_next)
+//     [CheckStackOverflow]
+//     Branch if v_i < v_n goto (B_body, B_exit)
+//   B_body:
+//     v_x <- LoadIndexed(v_a, v_i)
+//     ...
+//     StoreIndexed(v_dst, v_i, v_y)
+//     v_next <- v_i + 1
+//     goto B_header
+//
+// is rewritten into
+//
+//   B_pre_header:
+//     goto B_vector_header
+//   B_vector_header:
+//     v_vi <- phi(v_i0, v_vnext)
+//     [CheckStackOverflow]
+//     v_t <- v_vi + (lanes - 1)
+//     Branch if v_t < v_n goto (B_vector_body, B_vector_exit)
+//   B_vector_body:
+//     v_vx <- LoadIndexed(v_a, v_vi) as vector
+//     ...
+//     StoreIndexed(v_dst, v_vi, v_vy) as vector
+//     v_vnext <- v_vi + lanes
+//     goto B_vector_header
+//   B_vector_exit:
+//     goto B_header
+//   B_header:
+//     v_i <- phi(v_vi, v_next)
+//     ...
+//
+// The original loop becomes the scalar epilogue processing the remaining
+// elements.
+class VectorizableLoop : public ZoneAllocated {
+ public:
+  VectorizableLoop(FlowGraph* flow_graph,
+                   JoinEntryInstr* header,
+                   TargetEntryInstr* body,
+                   PhiInstr* induction_variable,
+                   Definition* increment)
+      : flow_graph_(flow_graph),
+        zone_(flow_graph->zone()),
+        header_(header),
+        body_(body),
+        branch_(header->last_instruction()->AsBranch()),
+        back_edge_index_(header->IndexOfPredecessor(body)),
+        induction_variable_(induction_variable),
+        increment_(increment),
+        lane_kind_(kNoLanes),
+        vector_header_(NULL),
+        vector_index_(NULL),
+        values_(),
+        vector_body_() {}
+
+  // Recognize a loop that can be vectorized.
+  static VectorizableLoop* Match(FlowGraph* flow_graph,
+                                 BlockEntryInstr* header);
+
+  void Vectorize();
+
+ private:
+  // Build vector counterparts of all instructions in the body. The vector
+  // instructions are not inserted into the graph yet.
+  bool BuildVectorBody();
+
+  bool AddLanes(LaneKind kind);
+  VectorValue* Lookup(Definition* scalar);
+  void Record(Definition* scalar,
+              Definition* vector,
+              LaneKind kind,
+              bool exact);
+  bool IsElementAccess(Value* array, Value* index, intptr_t class_id) const;
+
+  // Blocks of the vector loop inherit deoptimization targets from the
+  // scalar loop. Their environments refer to the vector index instead of
+  // the scalar induction variable, which does not dominate them.
+  void InheritDeoptTarget(Instruction* instr, Instruction* other);
+
+  Instruction* VectorizeLoad(LoadIndexedInstr* load);
+  Instruction* VectorizeStore(StoreIndexedInstr* store);
+  Instruction* VectorizeDoubleOp(BinaryDoubleOpInstr* op);
+  Instruction* VectorizeIntegerOp(BinaryIntegerOpInstr* op);
+
+  intptr_t lane_count() const { return LaneCount(lane_kind_); }
+
+  FlowGraph* flow_graph_;
+  Zone* zone_;
+  JoinEntryInstr* header_;
+  TargetEntryInstr* body_;
+  BranchInstr* branch_;
+  const intptr_t back_edge_index_;
+  PhiInstr* induction_variable_;
+  Definition* increment_;
+
+  // All element-wise accesses in the loop must have the same number of
+  // lanes.
+  LaneKind lane_kind_;
+
+  // Header of the vector loop and its phi, used as index by vector
+  // accesses.
+  JoinEntryInstr* vector_header_;
+  PhiInstr* vector_index_;
+
+  GrowableArray<VectorValue> values_;
+  GrowableArray<Instruction*> vector_body_;
+
+  DISALLOW_COPY_AND_ASSIGN(VectorizableLoop);
+};
+
+VectorizableLoop* VectorizableLoop::Match(FlowGraph* flow_graph,
+                                          BlockEntryInstr* block) {
+  JoinEntryInstr* header = block->AsJoinEntry();
+  if ((header == NULL) || (header->PredecessorCount() != 2) ||
+      header->InsideTryBlock()) {
+    return NULL;
+  }
+
+  // The loop consists of the header and a single body block.
+  intptr_t loop_size = 0;
+  for (BitVector::Iterator it(header->loop_info()); !it.Done(); it.Advance()) {
+    loop_size++;
+  }
+  if (loop_size != 2) {
+    return NULL;
+  }
+
+  // Only the induction variable is carried around the loop.
+  if ((header->phis() == NULL) || (header->phis()->length() != 1)) {
+    return NULL;
+  }
+  PhiInstr* phi = (*header->phis())[0];
+  if ((phi == NULL) || (phi->representation() != kTagged)) {
+    return NULL;
+  }
+
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  if (branch == NULL) {
+    return NULL;
+  }
+  for (Instruction* instr = header->next(); instr != branch;
+       instr = instr->next()) {
+    if (!instr->IsCheckStackOverflow()) {
+      return NULL;
+    }
+  }
+
+  // Branch if v_i < v_n goto (B_body, B_exit)
+  RelationalOpInstr* comparison = branch->comparison()->AsRelationalOp();
+  if ((comparison == NULL) || (comparison->kind() != Token::kLT) ||
+      (comparison->operation_cid() != kSmiCid) ||
+      (comparison->left()->definition() != phi)) {
+    return NULL;
+  }
+  TargetEntryInstr* body = branch->true_successor();
+  if (!header->loop_info()->Contains(body->preorder_number()) ||
+      header->loop_info()->Contains(
+          branch->false_successor()->preorder_number())) {
+    return NULL;
+  }
+  GotoInstr* back_edge = body->last_instruction()->AsGoto();
+  if ((back_edge == NULL) || (back_edge->successor() != header)) {
+    return NULL;
+  }
+
+  // v_next <- v_i + 1
+  const intptr_t back_edge_index = header->IndexOfPredecessor(body);
+  BinarySmiOpInstr* increment =
+      phi->InputAt(back_edge_index)->definition()->AsBinarySmiOp();
+  if ((increment == NULL) || (increment->op_kind() != Token::kADD) ||
+      increment->can_overflow() || (increment->GetBlock() != body) ||
+      (increment->left()->definition() != phi) ||
+      !increment->right()->BindsToConstant() ||
+      !increment->right()->BoundConstant().IsSmi() ||
+      (Smi::Cast(increment->right()->BoundConstant()).Value() != 1)) {
+    return NULL;
+  }
+
+  VectorizableLoop* loop =
+      new VectorizableLoop(flow_graph, header, body, phi, increment);
+  if (!loop->BuildVectorBody()) {
+    return NULL;
+  }
+
+  // The vector loop computes v_vi + lanes without overflow checks.
+  if ((phi->range() == NULL) ||
+      !phi->range()->OnlyLessThanOrEqualTo(Smi::kMaxValue -
+                                           loop->lane_count())) {
+    return NULL;
+  }
+  return loop;
+}
+
+bool VectorizableLoop::AddLanes(LaneKind kind) {
+  if (kind == kNoLanes) {
+    return false;
+  }
+  if (lane_kind_ == kNoLanes) {
+    lane_kind_ = kind;
+  }
+  return LaneCount(lane_kind_) == LaneCount(kind);
+}
+
+VectorValue* VectorizableLoop::Lookup(Definition* scalar) {
+  for (intptr_t i = 0; i < values_.length(); i++) {
+    if (values_[i].scalar == scalar) {
+      return &values_[i];
+    }
+  }
+  return NULL;
+}
+
+void VectorizableLoop::Record(Definition* scalar,
+                              Definition* vector,
+                              LaneKind kind,
+                              bool exact) {
+  VectorValue value = {scalar, vector, kind, exact};
+  values_.Add(value);
+}
+
+void VectorizableLoop::InheritDeoptTarget(Instruction* instr,
+                                          Instruction* other) {
+  instr->InheritDeoptTarget(zone_, other);
+  for (Environment::DeepIterator it(instr->env()); !it.Done(); it.Advance()) {
+    Value* use = it.CurrentValue();
+    if (use->definition() == induction_variable_) {
+      use->BindToEnvironment(vector_index_);
+    }
+  }
+}
+
+// Accesses are only vectorized when made at the induction variable into
+// internal typed data: distinct internal typed data objects never overlap,
+// so the only possible aliasing between accesses is at the same element,
+// and lanes are processed in the same order as in the scalar loop.
+bool VectorizableLoop::IsElementAccess(Value* array,
+                                       Value* index,
+                                       intptr_t class_id) const {
+  return (index->definition() == induction_variable_) &&
+         (array->definition()->representation() == kTagged) &&
+         (LaneKindOf(class_id) != kNoLanes);
+}
+
+Instruction* VectorizableLoop::VectorizeLoad(LoadIndexedInstr* load) {
+  if (!IsElementAccess(load->array(), load->index(), load->class_id()) ||
+      !AddLanes(LaneKindOf(load->class_id()))) {
+    return NULL;
+  }
+  const LaneKind kind = LaneKindOf(load->class_id());
+  LoadIndexedInstr* vector = new (zone_) LoadIndexedInstr(
+      load->array()->CopyWithType(zone_), new (zone_) Value(vector_index_),
+      load->index_scale(), VectorArrayCid(kind), kUnalignedAccess,
+      Thread::kNoDeoptId, load->token_pos());
+  Record(load, vector, kind, /*exact=*/true);
+  return vector;
+}
+
+Instruction* VectorizableLoop::VectorizeStore(StoreIndexedInstr* store) {
+  if (!IsElementAccess(store->array(), store->index(), store->class_id()) ||
+      !AddLanes(LaneKindOf(store->class_id()))) {
+    return NULL;
+  }
+  const LaneKind kind = LaneKindOf(store->class_id());
+  VectorValue* value = Lookup(store->value()->definition());
+  if ((value == NULL) || (value->kind != kind) || !value->exact) {
+    return NULL;
+  }
+  return new (zone_) StoreIndexedInstr(
+      store->array()->CopyWithType(zone_), new (zone_) Value(vector_index_),
+      new (zone_) Value(value->vector), kNoStoreBarrier, store->index_scale(),
+      VectorArrayCid(kind), kUnalignedAccess, Thread::kNoDeoptId,
+      store->token_pos());
+}
+
+Instruction* VectorizableLoop::VectorizeDoubleOp(BinaryDoubleOpInstr* op) {
+  switch (op->op_kind()) {
+    case Token::kADD:
+    case Token::kSUB:
+    case Token::kMUL:
+    case Token::kDIV:
+      break;
+    default:
+      return NULL;
+  }
+  VectorValue* left = Lookup(op->left()->definition());
+  VectorValue* right = Lookup(op->right()->definition());
+  if ((left == NULL) || (right == NULL) || (left->kind != right->kind) ||
+      !left->exact || !right->exact) {
+    return NULL;
+  }
+  const LaneKind kind = left->kind;
+  if ((kind != kFloat32Lanes) && (kind != kFloat64Lanes)) {
+    return NULL;
+  }
+  SimdOpInstr* vector = SimdOpInstr::Create(
+      SimdOpInstr::KindForOperator(VectorCid(kind), op->op_kind()),
+      new (zone_) Value(left->vector), new (zone_) Value(right->vector),
+      Thread::kNoDeoptId);
+  // Double operations on Float64List elements are the vector operations.
+  Record(op, vector, kind, /*exact=*/kind == kFloat64Lanes);
+  return vector;
+}
+
+// Int32x4 arithmetic wraps around at 32 bits. This is only equivalent to
+// the scalar code if results are truncated when stored, and for operations
+// whose low 32 bits only depend on low 32 bits of operands.
+Instruction* VectorizableLoop::VectorizeIntegerOp(BinaryIntegerOpInstr* op) {
+  switch (op->op_kind()) {
+    case Token::kADD:
+    case Token::kSUB:
+    case Token::kBIT_AND:
+    case Token::kBIT_OR:
+    case Token::kBIT_XOR:
+      break;
+    default:
+      return NULL;
+  }
+  VectorValue* left = Lookup(op->left()->definition());
+  VectorValue* right = Lookup(op->right()->definition());
+  if ((left == NULL) || (right == NULL) || (left->kind != kInt32Lanes) ||
+      (right->kind != kInt32Lanes)) {
+    return NULL;
+  }
+  SimdOpInstr* vector = SimdOpInstr::Create(
+      SimdOpInstr::KindForOperator(kInt32x4Cid, op->op_kind()),
+      new (zone_) Value(left->vector), new (zone_) Value(right->vector),
+      Thread::kNoDeoptId);
+  Record(op, vector, kInt32Lanes, /*exact=*/true);
+  return vector;
+}
+
+bool VectorizableLoop::BuildVectorBody() {
+  // The vector header is entered from the pre-header and from the vector
+  // body, which is given a larger block id.
+  vector_header_ = new (zone_) JoinEntryInstr(
+      flow_graph_->allocate_block_id(), header_->try_index(),
+      Thread::kNoDeoptId);
+  vector_index_ = new (zone_) PhiInstr(vector_header_, 2);
+
+  bool has_store = false;
+  for (Instruction* instr = body_->next(); instr != body_->last_instruction();
+       instr = instr->next()) {
+    if (instr == increment_) {
+      // The increment is only used by the header phi.
+      if ((increment_->input_use_list() == NULL) ||
+          (increment_->input_use_list()->next_use() != NULL) ||
+          (increment_->env_use_list() != NULL)) {
+        return false;
+      }
+      continue;
+    }
+    if (instr->ComputeCanDeoptimize() || instr->MayThrow()) {
+      return false;
+    }
+
+    Instruction* vector = NULL;
+    if (LoadIndexedInstr* load = instr->AsLoadIndexed()) {
+      vector = VectorizeLoad(load);
+    } else if (StoreIndexedInstr* store = instr->AsStoreIndexed()) {
+      vector = VectorizeStore(store);
+      has_store = true;
+    } else if (BinaryDoubleOpInstr* op = instr->AsBinaryDoubleOp()) {
+      vector = VectorizeDoubleOp(op);
+    } else if (BinaryIntegerOpInstr* op = instr->AsBinaryIntegerOp()) {
+      vector = VectorizeIntegerOp(op);
+    } else if (FloatToDoubleInstr* conversion = instr->AsFloatToDouble()) {
+      // Widening is exact, vector lanes are already floats.
+      VectorValue* value = Lookup(conversion->value()->definition());
+      if ((value == NULL) || (value->kind != kFloat32Lanes) || !value->exact) {
+        return false;
+      }
+      Record(conversion, value->vector, kFloat32Lanes, /*exact=*/true);
+      continue;
+    } else if (DoubleToFloatInstr* conversion = instr->AsDoubleToFloat()) {
+      // Rounding is performed by the vector operation producing the value.
+      VectorValue* value = Lookup(conversion->value()->definition());
+      if ((value == NULL) || (value->kind != kFloat32Lanes)) {
+        return false;
+      }
+      Record(conversion, value->vector, kFloat32Lanes, /*exact=*/true);
+      continue;
+    } else if (UnboxedIntConverterInstr* conversion =
+                   instr->AsUnboxedIntConverter()) {
+      // Conversions that can't deoptimize preserve the low 32 bits.
+      VectorValue* value = Lookup(conversion->value()->definition());
+      if ((value == NULL) || (value->kind != kInt32Lanes)) {
+        return false;
+      }
+      Record(conversion, value->vector, kInt32Lanes, /*exact=*/true);
+      continue;
+    }
+    if (vector == NULL) {
+      if (FLAG_support_il_printer && FLAG_trace_loop_vectorization) {
+        THR_Print("Can't vectorize loop B%" Pd ": %s\n", header_->block_id(),
+                  instr->ToCString());
+      }
+      return false;
+    }
+    vector_body_.Add(vector);
+  }
+  return has_store;
+}
+
+void VectorizableLoop::Vectorize() {
+  if (FLAG_support_il_printer && FLAG_trace_loop_vectorization) {
+    THR_Print("Vectorizing loop B%" Pd " with %" Pd " lanes\n",
+              header_->block_id(), lane_count());
+  }
+
+  const intptr_t pre_header_index = 1 - back_edge_index_;
+  BlockEntryInstr* pre_header = header_->PredecessorAt(pre_header_index);
+  GotoInstr* pre_header_goto = pre_header->last_instruction()->AsGoto();
+  ASSERT(pre_header_goto != NULL);
+  Value* initial_value = induction_variable_->InputAt(pre_header_index);
+  const intptr_t try_index = header_->try_index();
+
+  JoinEntryInstr* vector_header = vector_header_;
+  TargetEntryInstr* vector_body = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), try_index, Thread::kNoDeoptId);
+  TargetEntryInstr* vector_exit = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), try_index, Thread::kNoDeoptId);
+
+  Value* input = new (zone_) Value(initial_value->definition());
+  vector_index_->SetInputAt(0, input);
+  initial_value->definition()->AddInputUse(input);
+  vector_index_->set_representation(kTagged);
+  vector_index_->mark_alive();
+  flow_graph_->AllocateSSAIndexes(vector_index_);
+  vector_header->InsertPhi(vector_index_);
+  InheritDeoptTarget(vector_header, header_);
+  InheritDeoptTarget(vector_body, body_);
+  InheritDeoptTarget(vector_exit, header_);
+
+  // Vector header: preemption check and loop condition.
+  Instruction* last = vector_header;
+  for (Instruction* instr = header_->next(); instr != branch_;
+       instr = instr->next()) {
+    CheckStackOverflowInstr* check = instr->AsCheckStackOverflow();
+    CheckStackOverflowInstr* vector_check = new (zone_)
+        CheckStackOverflowInstr(check->token_pos(), check->loop_depth(),
+                                check->deopt_id());
+    last = flow_graph_->AppendTo(last, vector_check, check->env(),
+                                 FlowGraph::kEffect);
+    // Deoptimizing here resumes the scalar loop at the first element not
+    // yet processed by the vector loop.
+    for (Environment::DeepIterator it(vector_check->env()); !it.Done();
+         it.Advance()) {
+      Value* use = it.CurrentValue();
+      if (use->definition() == induction_variable_) {
+        use->BindToEnvironment(vector_index_);
+      }
+    }
+  }
+  BinarySmiOpInstr* last_lane = new (zone_) BinarySmiOpInstr(
+      Token::kADD, new (zone_) Value(vector_index_),
+      new (zone_) Value(flow_graph_->GetConstant(
+          Smi::Handle(zone_, Smi::New(lane_count() - 1)))),
+      Thread::kNoDeoptId);
+  last_lane->set_can_overflow(false);
+  last = flow_graph_->AppendTo(last, last_lane, NULL, FlowGraph::kValue);
+  ComparisonInstr* comparison = branch_->comparison()->CopyWithNewOperands(
+      new (zone_) Value(last_lane),
+      branch_->comparison()->right()->CopyWithType(zone_));
+  BranchInstr* vector_branch =
+      new (zone_) BranchInstr(comparison, Thread::kNoDeoptId);
+  InheritDeoptTarget(vector_branch, vector_header);
+  last = flow_graph_->AppendTo(last, vector_branch, NULL, FlowGraph::kEffect);
+  vector_header->set_last_instruction(vector_branch);
+  *vector_branch->true_successor_address() = vector_body;
+  *vector_branch->false_successor_address() = vector_exit;
+
+  // Vector body.
+  last = vector_body;
+  for (intptr_t i = 0; i < vector_body_.length(); i++) {
+    Instruction* instr = vector_body_[i];
+    last = flow_graph_->AppendTo(
+        last, instr, NULL,
+        instr->IsDefinition() && !instr->IsStoreIndexed() ? FlowGraph::kValue
+                                                          : FlowGraph::kEffect);
+  }
+  BinarySmiOpInstr* next_index = new (zone_) BinarySmiOpInstr(
+      Token::kADD, new (zone_) Value(vector_index_),
+      new (zone_) Value(flow_graph_->GetConstant(
+          Smi::Handle(zone_, Smi::New(lane_count())))),
+      Thread::kNoDeoptId);
+  next_index->set_can_overflow(false);
+  last = flow_graph_->AppendTo(last, next_index, NULL, FlowGraph::kValue);
+  input = new (zone_) Value(next_index);
+  vector_index_->SetInputAt(1, input);
+  next_index->AddInputUse(input);
+  GotoInstr* vector_back_edge =
+      new (zone_) GotoInstr(vector_header, Thread::kNoDeoptId);
+  InheritDeoptTarget(vector_back_edge, vector_body);
+  last->AppendInstruction(vector_back_edge);
+  vector_body->set_last_instruction(vector_back_edge);
+
+  // The vector loop exits into the scalar loop.
+  GotoInstr* exit_goto = new (zone_) GotoInstr(header_, Thread::kNoDeoptId);
+  InheritDeoptTarget(exit_goto, vector_exit);
+  vector_exit->LinkTo(exit_goto);
+  vector_exit->set_last_instruction(exit_goto);
+
+  GotoInstr* vector_entry =
+      new (zone_) GotoInstr(vector_header, Thread::kNoDeoptId);
+  vector_entry->InheritDeoptTarget(zone_, pre_header_goto);
+  vector_entry->InsertBefore(pre_header_goto);
+  vector_entry->set_next(NULL);
+  pre_header_goto->UnuseAllInputs();
+  pre_header->set_last_instruction(vector_entry);
+
+  // The scalar loop now starts where the vector loop stopped. The vector
+  // exit replaces the pre-header as predecessor of the scalar header, it has
+  // the largest block id which might change the order of phi inputs.
+  initial_value->BindTo(vector_index_);
+  if (pre_header_index == 0) {
+    Value* from_pre_header = induction_variable_->InputAt(0);
+    Value* from_back_edge = induction_variable_->InputAt(1);
+    induction_variable_->SetInputAt(0, from_back_edge);
+    induction_variable_->SetInputAt(1, from_pre_header);
+  }
+}
+
+void LoopVectorizer::Optimize(FlowGraph* flow_graph) {
+  if (!FLAG_loop_vectorization ||
+      !FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    return;
+  }
+
+  // Vectorizable loops have a single block body: they don't contain other
+  // loops and don't share blocks with each other.
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      flow_graph->LoopHeaders();
+  GrowableArray<VectorizableLoop*> loops;
+  for (intptr_t i = 0; i < loop_headers.length(); i++) {
+    VectorizableLoop* loop =
+        VectorizableLoop::Match(flow_graph, loop_headers[i]);
+    if (loop != NULL) {
+      loops.Add(loop);
+    }
+  }
+  if (loops.is_empty()) {
+    return;
+  }
+
+  for (intptr_t i = 0; i < loops.length(); i++) {
+    loops[i]->Vectorize();
+  }
+
+  flow_graph->DiscoverBlocks();
+  GrowableArray<BitVector*> dominance_frontier;
+  flow_graph->ComputeDominators(&dominance_frontier);
+}
+
+}  // namespace dart
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
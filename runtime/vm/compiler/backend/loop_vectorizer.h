@@ -0,0 +1,32 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class FlowGraph;
+
+// Rewrite counted loops performing element-wise arithmetic on typed data
+//
+//   for (int i = i0; i < n; i++) dst[i] = a[i] + b[i];
+//
+// into a loop processing 128 bits of each array per iteration using
+// Float32x4, Int32x4 and Float64x2 operations, followed by the original
+// scalar loop that processes remaining elements.
+//
+// Like the loop unroller the pass expects bounds checks to be eliminated or
+// hoisted out of the loop by range analysis: vector accesses only touch
+// elements that the scalar loop would have accessed.
+class LoopVectorizer : public AllStatic {
+ public:
+  static void Optimize(FlowGraph* flow_graph);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
@@ -0,0 +1,107 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/dart_api_impl.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+DECLARE_FLAG(bool, loop_vectorization);
+
+// Counts the loads and stores of arrays with the given class id in the
+// optimized flow graph of the function 'name'.
+static intptr_t CountOptimizedAccesses(Dart_Handle lib,
+                                       const char* name,
+                                       intptr_t class_id) {
+  TransitionNativeToVM transition(Thread::Current());
+  StackZone zone(Thread::Current());
+  HANDLESCOPE(Thread::Current());
+  const Library& library = Library::CheckedHandle(Api::UnwrapHandle(lib));
+  const Function& function =
+      Function::Handle(library.LookupFunctionAllowPrivate(
+          String::Handle(Symbols::New(Thread::Current(), name))));
+  EXPECT(!function.IsNull());
+  FlowGraph* flow_graph = CompilerTest::BuildOptimizedFlowGraph(function);
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      LoadIndexedInstr* load = it.Current()->AsLoadIndexed();
+      StoreIndexedInstr* store = it.Current()->AsStoreIndexed();
+      if (((load != NULL) && (load->class_id() == class_id)) ||
+          ((store != NULL) && (store->class_id() == class_id))) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+static const char* kVectorizationScript =
+    "import 'dart:typed_data';\n"
+    "add(Float32List d, Float32List a, Float32List b) {\n"
+    "  for (int i = 0; i < d.length; i++) d[i] = a[i] + b[i];\n"
+    "}\n"
+    "narrow(Float32List d, Float64List a) {\n"
+    "  for (int i = 0; i < d.length; i++) d[i] = a[i];\n"
+    "}\n"
+    "main() {\n"
+    "  var d = new Float32List(100), a = new Float32List(100);\n"
+    "  var w = new Float64List(100);\n"
+    "  for (int i = 0; i < 10; i++) {\n"
+    "    add(d, a, d);\n"
+    "    narrow(d, w);\n"
+    "  }\n"
+    "}\n";
+
+TEST_CASE(LoopVectorizer_VectorizesElementWiseLoop) {
+  Dart_Handle lib = TestCase::LoadTestScript(kVectorizationScript, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+
+  const bool saved_loop_vectorization = FLAG_loop_vectorization;
+  FLAG_loop_vectorization = false;
+  EXPECT_EQ(0,
+            CountOptimizedAccesses(lib, "add", kTypedDataFloat32x4ArrayCid));
+  FLAG_loop_vectorization = true;
+  if (FlowGraphCompiler::SupportsUnboxedSimd128()) {
+    // Two vector loads and one vector store, before the scalar epilogue.
+    EXPECT_EQ(3,
+              CountOptimizedAccesses(lib, "add", kTypedDataFloat32x4ArrayCid));
+    EXPECT_EQ(3,
+              CountOptimizedAccesses(lib, "add", kTypedDataFloat32ArrayCid));
+  } else {
+    EXPECT_EQ(0,
+              CountOptimizedAccesses(lib, "add", kTypedDataFloat32x4ArrayCid));
+  }
+  FLAG_loop_vectorization = saved_loop_vectorization;
+}
+
+TEST_CASE(LoopVectorizer_KeepsMixedLaneLoop) {
+  Dart_Handle lib = TestCase::LoadTestScript(kVectorizationScript, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+
+  // Float32List and Float64List elements don't fit the same number of lanes
+  // in a vector.
+  const bool saved_loop_vectorization = FLAG_loop_vectorization;
+  FLAG_loop_vectorization = true;
+  EXPECT_EQ(0, CountOptimizedAccesses(lib, "narrow",
+                                      kTypedDataFloat32x4ArrayCid));
+  EXPECT_EQ(0, CountOptimizedAccesses(lib, "narrow",
+                                      kTypedDataFloat64x2ArrayCid));
+  FLAG_loop_vectorization = saved_loop_vectorization;
+}
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+}  // namespace dart
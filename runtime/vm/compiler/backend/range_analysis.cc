@@ -51,15 +51,17 @@ static Definition* UnwrapConstraint(Definition* defn) {
 
 // Simple induction variable is a variable that satisfies the following pattern:
 //
-//                         v1 <- phi(v0, v1 + 1)
+//                         v1 <- phi(v0, v1 + C)
 //
-// If there are two simple induction variables in the same block and one of
-// them is constrained - then another one is constrained as well, e.g.
-// from
+// where C is a positive Smi constant (the step of the induction variable).
+//
+// If there are two simple induction variables with the same step in the same
+// block and one of them is constrained - then another one is constrained as
+// well, e.g. from
 //
 //                        B1:
-//                         v3 <- phi(v0, v3 + 1)
-//                         v4 <- phi(v2, v4 + 1)
+//                         v3 <- phi(v0, v3 + C)
+//                         v4 <- phi(v2, v4 + C)
 //                        Bx:
 //                         v3 is constrained to [v0, v1]
 //
@@ -71,7 +73,7 @@ static Definition* UnwrapConstraint(Definition* defn) {
 // This pass essentially pattern matches induction variables introduced
 // like this:
 //
-//                  for (var i = i0, j = j0; i < L; i++, j++) {
+//                  for (var i = i0, j = j0; i < L; i += C, j += C) {
 //                      j is known to be within [j0, j0 + (L - i0 - 1)]
 //                  }
 //
@@ -91,6 +93,11 @@ class InductionVariableInfo : public ZoneAllocated {
   Definition* initial_value() const { return initial_value_; }
   BinarySmiOpInstr* increment() const { return increment_; }
 
+  // Positive constant added to the induction variable on every iteration.
+  intptr_t step() const {
+    return Smi::Cast(increment_->right()->BoundConstant()).Value();
+  }
+
   // Outermost constraint that constrains this induction variable into
   // [-inf, X] range.
   ConstraintInstr* limit() const { return limit_; }
@@ -154,7 +161,7 @@ static InductionVariableInfo* DetectSimpleInductionVariable(PhiInstr* phi) {
       (UnwrapConstraint(increment->left()->definition()) == phi) &&
       increment->right()->BindsToConstant() &&
       increment->right()->BoundConstant().IsSmi() &&
-      (Smi::Cast(increment->right()->BoundConstant()).Value() == 1)) {
+      (Smi::Cast(increment->right()->BoundConstant()).Value() > 0)) {
     return new InductionVariableInfo(
         phi, initial_value, increment,
         FindBoundingConstraint(phi, increment->left()->definition()));
@@ -201,7 +208,15 @@ void RangeAnalysis::DiscoverSimpleInductionVariables() {
     if (bound != NULL) {
       for (intptr_t i = 0; i < loop_variables.length(); i++) {
         InductionVariableInfo* info = loop_variables[i];
-        info->set_bound(bound->phi());
+        if (info->step() == bound->step()) {
+          info->set_bound(bound->phi());
+        } else if (info->limit() != NULL) {
+          // Variables advancing at a different pace can't be bounded
+          // through the limit of the bounding variable, use their own.
+          info->set_bound(info->phi());
+        } else {
+          continue;
+        }
         info->phi()->set_induction_variable_info(info);
       }
     }
@@ -881,12 +896,21 @@ class Scheduler {
 //
 // Upper/Lower bounds are symbolic arithmetic expressions with +, -, *
 // operations.
+//
+// When hoisting is not allowed (e.g. in precompiled code where a failing
+// hoisted check can't deoptimize into the original loop and throwing early
+// would be observable) the generalizer only removes checks for which
+// 0 <= LowerBound(index) and UpperBound(index) < length can be proven
+// statically.
 class BoundsCheckGeneralizer {
  public:
-  BoundsCheckGeneralizer(RangeAnalysis* range_analysis, FlowGraph* flow_graph)
+  BoundsCheckGeneralizer(RangeAnalysis* range_analysis,
+                         FlowGraph* flow_graph,
+                         bool allow_hoisting)
       : range_analysis_(range_analysis),
         flow_graph_(flow_graph),
-        scheduler_(flow_graph) {}
+        scheduler_(flow_graph),
+        allow_hoisting_(allow_hoisting) {}
 
   void TryGeneralize(CheckArrayBoundInstr* check,
                      const RangeBoundary& array_length) {
@@ -919,7 +943,8 @@ class BoundsCheckGeneralizer {
     // constraining. If there is a subtraction subexpression with non-positive
     // range give up on generalization for simplicity.
     GrowableArray<Definition*> non_positive_symbols;
-    if (!FindNonPositiveSymbols(&non_positive_symbols, upper_bound)) {
+    if (!FindNonPositiveSymbols(&non_positive_symbols, upper_bound) ||
+        (!allow_hoisting_ && !non_positive_symbols.is_empty())) {
 #ifndef PRODUCT
       if (FLAG_support_il_printer && FLAG_trace_range_analysis) {
         THR_Print(
@@ -1007,6 +1032,14 @@ class BoundsCheckGeneralizer {
       return;
     }
 
+    if (!allow_hoisting_) {
+      if (FLAG_trace_range_analysis) {
+        THR_Print("  => generalized check is not redundant\n");
+      }
+      scheduler_.Rollback();
+      return;
+    }
+
     new_check = scheduler_.Emit(new_check, check);
     if (new_check != NULL) {
       if (FLAG_trace_range_analysis) {
@@ -1120,7 +1153,7 @@ class BoundsCheckGeneralizer {
       if (point->IsDominatedBy(info.limit())) {
         // Given induction variable
         //
-        //          x <- phi(x0, x + 1)
+        //          x <- phi(x0, x + C)
         //
         // and a constraint x <= M that dominates the given
         // point we conclude that M is an upper bound for x.
@@ -1130,10 +1163,10 @@ class BoundsCheckGeneralizer {
       const InductionVariableInfo& bound_info =
           *info.bound()->induction_variable_info();
       if (point->IsDominatedBy(bound_info.limit())) {
-        // Given two induction variables
+        // Given two induction variables with the same step
         //
-        //          x <- phi(x0, x + 1)
-        //          y <- phi(y0, y + 1)
+        //          x <- phi(x0, x + C)
+        //          y <- phi(y0, y + C)
         //
         // and a constraint x <= M that dominates the given
         // point we can conclude that
@@ -1157,9 +1190,9 @@ class BoundsCheckGeneralizer {
   Definition* InductionVariableLowerBound(PhiInstr* phi, Instruction* point) {
     // Given induction variable
     //
-    //          x <- phi(x0, x + 1)
+    //          x <- phi(x0, x + C)
     //
-    // we can conclude that LowerBound(x) == x0.
+    // with positive C we can conclude that LowerBound(x) == x0.
     const InductionVariableInfo& info = *phi->induction_variable_info();
     return ConstructLowerBound(info.initial_value(), point);
   }
@@ -1409,19 +1442,22 @@ class BoundsCheckGeneralizer {
   RangeAnalysis* range_analysis_;
   FlowGraph* flow_graph_;
   Scheduler scheduler_;
+  const bool allow_hoisting_;
 };
 
 void RangeAnalysis::EliminateRedundantBoundsChecks() {
   if (FLAG_array_bounds_check_elimination) {
     const Function& function = flow_graph_->function();
-    // Generalization only if we have not deoptimized on a generalized
-    // check earlier, or we're compiling precompiled code (no
-    // optimistic hoisting of checks possible)
-    const bool try_generalization =
+    // Hoist generalized checks only if we have not deoptimized on a
+    // generalized check earlier and we're not compiling precompiled code (no
+    // optimistic hoisting of checks possible). Otherwise generalization is
+    // still used to prove checks redundant, which also covers the checks
+    // that become GenericCheckBound in precompiled code.
+    const bool allow_hoisting =
         !function.ProhibitsBoundsCheckGeneralization() &&
         !FLAG_precompiled_mode;
 
-    BoundsCheckGeneralizer generalizer(this, flow_graph_);
+    BoundsCheckGeneralizer generalizer(this, flow_graph_, allow_hoisting);
 
     for (intptr_t i = 0; i < bounds_checks_.length(); i++) {
       CheckArrayBoundInstr* check = bounds_checks_[i];
@@ -1429,7 +1465,7 @@ void RangeAnalysis::EliminateRedundantBoundsChecks() {
           RangeBoundary::FromDefinition(check->length()->definition());
       if (check->IsRedundant(array_length)) {
         check->RemoveFromGraph();
-      } else if (try_generalization) {
+      } else {
         generalizer.TryGeneralize(check, array_length);
       }
     }
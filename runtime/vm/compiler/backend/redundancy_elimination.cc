@@ -17,10 +17,26 @@ namespace dart {
 
 DEFINE_FLAG(bool, dead_store_elimination, true, "Eliminate dead stores");
 DEFINE_FLAG(bool, load_cse, true, "Use redundant load elimination.");
+DEFINE_FLAG(bool,
+            load_pre,
+            true,
+            "Eliminate partially redundant loads by inserting them on paths "
+            "where they are not available.");
 DEFINE_FLAG(bool,
             trace_load_optimization,
             false,
             "Print live sets for load optimization pass.");
+DEFINE_FLAG(bool,
+            partial_escape_analysis,
+            true,
+            "Sink allocations that escape only on some paths into the points "
+            "where they escape.");
+DEFINE_FLAG(int,
+            max_unchecked_loop_trip_count,
+            32,
+            "Innermost loops with a constant trip count at most this large "
+            "do not check for stack overflow and interrupts on the back "
+            "edge.");
 
 // Quick access to the current zone.
 #define Z (zone())
@@ -1460,6 +1476,9 @@ class LoadOptimizer : public ValueObject {
   bool Optimize() {
     ComputeInitialSets();
     ComputeOutSets();
+    if (FLAG_load_pre && InsertPartiallyRedundantLoads()) {
+      ComputeOutSets();
+    }
     ComputeOutValues();
     if (graph_->is_licm_allowed()) {
       MarkLoopInvariantLoads();
@@ -1761,6 +1780,157 @@ class LoadOptimizer : public ValueObject {
     }
   }
 
+  // Partial redundancy elimination for loads: if a load exposed in a join
+  // block is available on exit from some of its predecessors but not the
+  // others, then insert copies of the load at the end of the predecessors
+  // where it is not available
+  //
+  //     B1: v1 <- o.f              B1: v1 <- o.f
+  //         goto B3                    goto B3
+  //     B2: ...                    B2: ...
+  //         goto B3         =>         v2 <- o.f
+  //     B3: v3 <- o.f                  goto B3
+  //                                B3: v3 <- phi(v1, v2)
+  //
+  // Load forwarding will then replace the now fully redundant load with a
+  // phi. No path through the join executes more loads than before. Only
+  // tagged field loads are moved and only into predecessors where the
+  // instance is known to have the field, because loads are executed
+  // speculatively there.
+  //
+  // Blocks that gained a load get the place added to their GEN and OUT sets,
+  // OUT sets have to be recomputed afterwards.
+  bool InsertPartiallyRedundantLoads() {
+    bool changed = false;
+    for (BlockIterator block_it = graph_->reverse_postorder_iterator();
+         !block_it.Done(); block_it.Advance()) {
+      JoinEntryInstr* join = block_it.Current()->AsJoinEntry();
+      if ((join == NULL) || !CanMergeEagerly(join)) {
+        continue;
+      }
+
+      ZoneGrowableArray<Definition*>* loads =
+          exposed_values_[join->preorder_number()];
+      if (loads == NULL) continue;  // No exposed loads.
+
+      BitVector* in = in_[join->preorder_number()];
+      for (intptr_t i = 0; i < loads->length(); i++) {
+        LoadFieldInstr* load = (*loads)[i]->AsLoadField();
+        if ((load == NULL) || (load->field() == NULL) ||
+            load->IsUnboxedLoad() || load->IsPotentialUnboxedLoad() ||
+            in->Contains(load->place_id())) {
+          continue;
+        }
+
+        const intptr_t place_id = load->place_id();
+        intptr_t available = 0;
+        bool can_insert = true;
+        for (intptr_t j = 0; j < join->PredecessorCount(); j++) {
+          BlockEntryInstr* pred = join->PredecessorAt(j);
+          BitVector* pred_out = out_[pred->preorder_number()];
+          if ((pred_out != NULL) && pred_out->Contains(place_id)) {
+            available++;
+          } else if (!CanSpeculateLoadAt(load, join, pred)) {
+            can_insert = false;
+          }
+        }
+
+        if ((available == 0) || !can_insert) {
+          continue;
+        }
+
+        for (intptr_t j = 0; j < join->PredecessorCount(); j++) {
+          BlockEntryInstr* pred = join->PredecessorAt(j);
+          BitVector* pred_out = out_[pred->preorder_number()];
+          if ((pred_out == NULL) || !pred_out->Contains(place_id)) {
+            InsertLoadAt(load, pred);
+          }
+        }
+        changed = true;
+      }
+    }
+    return changed;
+  }
+
+  // Check if the given field load can be executed at the end of the given
+  // predecessor of the join block containing it. The instance must be
+  // defined before the join and must be known to contain the field at that
+  // point: either because it is an allocation of a class containing the
+  // field, or because a dominating load or store accessed a field of the
+  // same or a derived class with this instance.
+  bool CanSpeculateLoadAt(LoadFieldInstr* load,
+                          JoinEntryInstr* join,
+                          BlockEntryInstr* pred) {
+    Definition* instance = load->instance()->definition();
+    if ((instance->GetBlock() == join) ||
+        !pred->last_instruction()->IsGoto()) {
+      return false;
+    }
+
+    const Class& owner = Class::Handle(Z, load->field()->Owner());
+    if (instance->IsAllocateObject()) {
+      return IsSubclassOf(instance->AsAllocateObject()->cls(), owner);
+    }
+
+    Instruction* point = pred->last_instruction();
+    for (Value* use = instance->input_use_list(); use != NULL;
+         use = use->next_use()) {
+      Instruction* instr = use->instruction();
+      const Field* field = NULL;
+      if (instr->IsLoadField()) {
+        field = instr->AsLoadField()->field();
+      } else if (instr->IsStoreInstanceField() &&
+                 (instr->AsStoreInstanceField()->instance() == use) &&
+                 !instr->AsStoreInstanceField()->field().IsNull()) {
+        field = &instr->AsStoreInstanceField()->field();
+      }
+
+      if ((field != NULL) && point->IsDominatedBy(instr) &&
+          IsSubclassOf(Class::Handle(Z, field->Owner()), owner)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static bool IsSubclassOf(const Class& cls, const Class& other) {
+    Class& current = Class::Handle(cls.raw());
+    while (!current.IsNull()) {
+      if (current.raw() == other.raw()) {
+        return true;
+      }
+      current = current.SuperClass();
+    }
+    return false;
+  }
+
+  // Insert a copy of the given load at the end of the given block.
+  void InsertLoadAt(LoadFieldInstr* load, BlockEntryInstr* block) {
+    LoadFieldInstr* copy = new (Z)
+        LoadFieldInstr(new (Z) Value(load->instance()->definition()),
+                       load->field(), load->type(), load->token_pos(), NULL);
+    copy->set_result_cid(load->result_cid());
+    copy->set_is_immutable(load->AllowsCSE());
+    copy->set_place_id(load->place_id());
+    graph_->InsertBefore(block->last_instruction(), copy, NULL,
+                         FlowGraph::kValue);
+
+    const intptr_t preorder_number = block->preorder_number();
+    gen_[preorder_number]->Add(copy->place_id());
+    if (out_[preorder_number] != NULL) {
+      out_[preorder_number]->Add(copy->place_id());
+    }
+    if (out_values_[preorder_number] == NULL) {
+      out_values_[preorder_number] = CreateBlockOutValues();
+    }
+    (*out_values_[preorder_number])[copy->place_id()] = copy;
+
+    if (FLAG_support_il_printer && FLAG_trace_load_optimization) {
+      THR_Print("inserted partially redundant load %s into B%" Pd "\n",
+                copy->ToCString(), block->block_id());
+    }
+  }
+
   // Compute out_values mappings by propagating them in reverse postorder once
   // through the graph. Generate phis on back edges where eager merge is
   // impossible.
@@ -2559,6 +2729,19 @@ void DeadStoreElimination::Optimize(FlowGraph* graph) {
   }
 }
 
+// Add given instruction to the list of the instructions if it is not yet
+// present there.
+template <typename T>
+void AddInstruction(GrowableArray<T*>* list, T* value) {
+  ASSERT(!value->IsGraphEntry());
+  for (intptr_t i = 0; i < list->length(); i++) {
+    if ((*list)[i] == value) {
+      return;
+    }
+  }
+  list->Add(value);
+}
+
 enum SafeUseCheck { kOptimisticCheck, kStrictCheck };
 
 // Check if the use is safe for allocation sinking. Allocation sinking
@@ -2567,7 +2750,9 @@ enum SafeUseCheck { kOptimisticCheck, kStrictCheck };
 //     - any store into the allocation candidate itself is unconditionally safe
 //       as it just changes the rematerialization state of this candidate;
 //     - store into another object is only safe if another object is allocation
-//       candidate.
+//       candidate. This includes contexts, so that a chain of contexts and the
+//       closures capturing them (e.g. an inner context pointing to its parent)
+//       is eliminated as a whole once all the closure calls are inlined.
 //
 // We use a simple fix-point algorithm to discover the set of valid candidates
 // (see CollectCandidates method), that's why this IsSafeUse can operate in two
@@ -2590,7 +2775,8 @@ static bool IsSafeUse(Value* use, SafeUseCheck check_type) {
   if (store != NULL) {
     if (use == store->value()) {
       Definition* instance = store->instance()->definition();
-      return instance->IsAllocateObject() &&
+      return (instance->IsAllocateObject() ||
+              instance->IsAllocateUninitializedContext()) &&
              ((check_type == kOptimisticCheck) ||
               instance->Identity().IsAllocationSinkingCandidate());
     }
@@ -2600,21 +2786,178 @@ static bool IsSafeUse(Value* use, SafeUseCheck check_type) {
   return false;
 }
 
+// Maximum number of escape points at which a single partially escaping
+// allocation is materialized: each of them gets a copy of the allocation.
+static const intptr_t kMaxEscapesPerAllocation = 4;
+
+// Check if the given use of the allocation can be treated as a point where
+// the allocation escapes and has to be materialized.
+static bool IsEscapingUse(Value* use) {
+  Instruction* instr = use->instruction();
+  return !instr->IsPhi() && !instr->IsLoadField();
+}
+
+// Unboxed fields are initialized with a box by their first store: a copy
+// materialized on a path where the field was not stored would have to store
+// null there. Such objects are not materialized at escape points.
+static bool HasUnboxedFields(Definition* alloc) {
+  for (Value* use = alloc->input_use_list(); use != NULL;
+       use = use->next_use()) {
+    StoreInstanceFieldInstr* store = use->instruction()->AsStoreInstanceField();
+    if ((store != NULL) && (store->instance()->definition() == alloc) &&
+        (store->IsUnboxedStore() || store->IsPotentialUnboxedStore())) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Escaping allocations are materialized before the arguments of the call they
+// escape into are pushed.
+static Instruction* MaterializationPoint(Instruction* escape) {
+  while (escape->previous()->IsPushArgument()) {
+    escape = escape->previous();
+  }
+  return escape;
+}
+
+// Check that all uses from the given list which are located in the reachable
+// blocks are dominated by the escape point.
+static bool AreReachableUsesDominated(Value* uses,
+                                      Instruction* escape,
+                                      BitVector* reachable) {
+  for (Value* use = uses; use != NULL; use = use->next_use()) {
+    Instruction* instr = use->instruction();
+    if ((instr != escape) &&
+        reachable->Contains(instr->GetBlock()->preorder_number()) &&
+        !instr->IsDominatedBy(escape)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Check that the allocation can be materialized right before the given escape
+// point: once the allocation escaped there no other use of it can be reached
+// without passing through the allocation again, unless the use is dominated
+// by the escape point and can thus refer to the materialized copy instead.
+static bool CanMaterializeAtEscape(FlowGraph* flow_graph,
+                                   Definition* alloc,
+                                   Instruction* escape) {
+  Zone* zone = flow_graph->zone();
+  BlockEntryInstr* alloc_block = alloc->GetBlock();
+  BlockEntryInstr* escape_block = escape->GetBlock();
+
+  BitVector* reachable =
+      new (zone) BitVector(zone, flow_graph->preorder().length());
+  GrowableArray<BlockEntryInstr*> worklist;
+  worklist.Add(escape_block);
+  while (!worklist.is_empty()) {
+    BlockEntryInstr* block = worklist.RemoveLast();
+    Instruction* last = block->last_instruction();
+    for (intptr_t i = 0; i < last->SuccessorCount(); i++) {
+      BlockEntryInstr* succ = last->SuccessorAt(i);
+      if (succ == alloc_block) {
+        continue;  // Control passes through the allocation: a new object.
+      }
+      if (succ == escape_block) {
+        // The escape point can be executed again for the same object.
+        return false;
+      }
+      if (!reachable->Contains(succ->preorder_number())) {
+        reachable->Add(succ->preorder_number());
+        worklist.Add(succ);
+      }
+    }
+  }
+
+  return AreReachableUsesDominated(alloc->input_use_list(), escape,
+                                   reachable) &&
+         AreReachableUsesDominated(alloc->env_use_list(), escape, reachable);
+}
+
+// Reduce the list of escaping uses to the escape points: the uses that are
+// not dominated by another escaping use. Uses dominated by an escape point
+// will refer to the object materialized there. Returns false if the
+// allocation can't be materialized at any of the escape points.
+static bool CollectEscapePoints(FlowGraph* flow_graph,
+                                Definition* alloc,
+                                GrowableArray<Instruction*>* escapes) {
+  intptr_t j = 0;
+  for (intptr_t i = 0; i < escapes->length(); i++) {
+    Instruction* escape = (*escapes)[i];
+    bool dominated = false;
+    for (intptr_t k = 0; k < escapes->length(); k++) {
+      Instruction* other = (*escapes)[k];
+      if ((other != escape) && escape->IsDominatedBy(other)) {
+        dominated = true;
+        break;
+      }
+    }
+    if (!dominated) {
+      (*escapes)[j++] = escape;
+    }
+  }
+  escapes->TruncateTo(j);
+
+  if (escapes->length() > kMaxEscapesPerAllocation) {
+    return false;
+  }
+
+  for (intptr_t i = 0; i < escapes->length(); i++) {
+    if (!CanMaterializeAtEscape(flow_graph, alloc, (*escapes)[i])) {
+      if (FLAG_support_il_printer && FLAG_trace_optimization) {
+        THR_Print("%s can't be materialized at escape %s\n",
+                  alloc->ToCString(), (*escapes)[i]->ToCString());
+      }
+      return false;
+    }
+  }
+  return true;
+}
+
 // Right now we are attempting to sink allocation only into
 // deoptimization exit. So candidate should only be used in StoreInstanceField
 // instructions that write into fields of the allocated object.
 // We do not support materialization of the object that has type arguments.
-static bool IsAllocationSinkingCandidate(Definition* alloc,
-                                         SafeUseCheck check_type) {
+//
+// If escapes is not NULL the allocation is also allowed to escape at a
+// limited number of points (partial escape analysis). These points are
+// collected into escapes, the allocation will be materialized right before
+// each of them. Only objects without type arguments are materialized this way.
+static bool IsAllocationSinkingCandidate(
+    FlowGraph* flow_graph,
+    Definition* alloc,
+    SafeUseCheck check_type,
+    GrowableArray<Instruction*>* escapes = NULL) {
+  if (escapes != NULL) {
+    escapes->Clear();
+    if (!alloc->IsAllocateObject() || (alloc->ArgumentCount() > 0) ||
+        HasUnboxedFields(alloc)) {
+      escapes = NULL;
+    }
+  }
+
   for (Value* use = alloc->input_use_list(); use != NULL;
        use = use->next_use()) {
-    if (!IsSafeUse(use, check_type)) {
-      if (FLAG_support_il_printer && FLAG_trace_optimization) {
-        THR_Print("use of %s at %s is unsafe for allocation sinking\n",
-                  alloc->ToCString(), use->instruction()->ToCString());
-      }
-      return false;
+    if (IsSafeUse(use, check_type)) {
+      continue;
     }
+
+    if ((escapes != NULL) && IsEscapingUse(use)) {
+      AddInstruction(escapes, MaterializationPoint(use->instruction()));
+      continue;
+    }
+
+    if (FLAG_support_il_printer && FLAG_trace_optimization) {
+      THR_Print("use of %s at %s is unsafe for allocation sinking\n",
+                alloc->ToCString(), use->instruction()->ToCString());
+    }
+    return false;
+  }
+
+  if ((escapes != NULL) && !escapes->is_empty()) {
+    return CollectEscapePoints(flow_graph, alloc, escapes);
   }
 
   return true;
@@ -2634,7 +2977,7 @@ static Definition* StoreInto(Value* use) {
 // Remove the given allocation from the graph. It is not observable.
 // If deoptimization occurs the object will be materialized.
 void AllocationSinking::EliminateAllocation(Definition* alloc) {
-  ASSERT(IsAllocationSinkingCandidate(alloc, kStrictCheck));
+  ASSERT(IsAllocationSinkingCandidate(flow_graph_, alloc, kStrictCheck));
 
   if (FLAG_trace_optimization) {
     THR_Print("removing allocation from the graph: v%" Pd "\n",
@@ -2669,6 +3012,12 @@ void AllocationSinking::EliminateAllocation(Definition* alloc) {
 // rematerialized at deoptimization exits if needed. See IsSafeUse
 // for the description of algorithm used below.
 void AllocationSinking::CollectCandidates() {
+  // Escape points are only collected here to decide if partially escaping
+  // allocations are candidates. See InsertEscapeMaterializations.
+  GrowableArray<Instruction*> escapes;
+  GrowableArray<Instruction*>* partial =
+      FLAG_partial_escape_analysis ? &escapes : NULL;
+
   // Optimistically collect all potential candidates.
   for (BlockIterator block_it = flow_graph_->reverse_postorder_iterator();
        !block_it.Done(); block_it.Advance()) {
@@ -2677,7 +3026,8 @@ void AllocationSinking::CollectCandidates() {
       {
         AllocateObjectInstr* alloc = it.Current()->AsAllocateObject();
         if ((alloc != NULL) &&
-            IsAllocationSinkingCandidate(alloc, kOptimisticCheck)) {
+            IsAllocationSinkingCandidate(flow_graph_, alloc,
+                                         kOptimisticCheck, partial)) {
           alloc->SetIdentity(AliasIdentity::AllocationSinkingCandidate());
           candidates_.Add(alloc);
         }
@@ -2686,7 +3036,8 @@ void AllocationSinking::CollectCandidates() {
         AllocateUninitializedContextInstr* alloc =
             it.Current()->AsAllocateUninitializedContext();
         if ((alloc != NULL) &&
-            IsAllocationSinkingCandidate(alloc, kOptimisticCheck)) {
+            IsAllocationSinkingCandidate(flow_graph_, alloc,
+                                         kOptimisticCheck)) {
           alloc->SetIdentity(AliasIdentity::AllocationSinkingCandidate());
           candidates_.Add(alloc);
         }
@@ -2701,7 +3052,8 @@ void AllocationSinking::CollectCandidates() {
     for (intptr_t i = 0; i < candidates_.length(); i++) {
       Definition* alloc = candidates_[i];
       if (alloc->Identity().IsAllocationSinkingCandidate()) {
-        if (!IsAllocationSinkingCandidate(alloc, kStrictCheck)) {
+        if (!IsAllocationSinkingCandidate(flow_graph_, alloc, kStrictCheck,
+                                          partial)) {
           alloc->SetIdentity(AliasIdentity::Unknown());
           changed = true;
         }
@@ -2791,7 +3143,7 @@ void AllocationSinking::DiscoverFailedCandidates() {
     for (intptr_t i = 0; i < candidates_.length(); i++) {
       Definition* alloc = candidates_[i];
       if (alloc->Identity().IsAllocationSinkingCandidate()) {
-        if (!IsAllocationSinkingCandidate(alloc, kStrictCheck)) {
+        if (!IsAllocationSinkingCandidate(flow_graph_, alloc, kStrictCheck)) {
           alloc->SetIdentity(AliasIdentity::Unknown());
           changed = true;
         }
@@ -2858,6 +3210,28 @@ void AllocationSinking::DiscoverFailedCandidates() {
       }
     }
     materializations_.TruncateTo(k);
+
+    // Undo materializations at escape points: uses that were redirected to
+    // the copy return to the original allocation.
+    k = 0;
+    for (intptr_t i = 0; i < escape_materializations_.length(); i++) {
+      EscapeMaterialization* materialization = escape_materializations_[i];
+      if (!materialization->alloc()
+               ->Identity()
+               .IsAllocationSinkingCandidate()) {
+        for (intptr_t j = 0; j < materialization->stores()->length(); j++) {
+          materialization->stores()->At(j)->RemoveFromGraph();
+        }
+        materialization->copy()->ReplaceUsesWith(materialization->alloc());
+        materialization->copy()->RemoveFromGraph();
+      } else {
+        if (k != i) {
+          escape_materializations_[k] = materialization;
+        }
+        k++;
+      }
+    }
+    escape_materializations_.TruncateTo(k);
   }
 
   candidates_.TruncateTo(j);
@@ -2866,6 +3240,15 @@ void AllocationSinking::DiscoverFailedCandidates() {
 void AllocationSinking::Optimize() {
   CollectCandidates();
 
+  // Materialize partially escaping candidates at their escape points. This
+  // must precede insertion of MaterializeObject instructions: deoptimization
+  // exits dominated by an escape point refer to the materialized copy.
+  if (FLAG_partial_escape_analysis) {
+    for (intptr_t i = 0; i < candidates_.length(); i++) {
+      InsertEscapeMaterializations(candidates_[i]);
+    }
+  }
+
   // Insert MaterializeObject instructions that will describe the state of the
   // object at all deoptimization points. Each inserted materialization looks
   // like this (where v_0 is allocation that we are going to eliminate):
@@ -2975,6 +3358,19 @@ MaterializeObjectInstr* AllocationSinking::MaterializationFor(
   return NULL;
 }
 
+// Create a load of the given field/offset from the allocation.
+LoadFieldInstr* AllocationSinking::LoadSlot(Definition* alloc,
+                                            const Object& slot) {
+  return slot.IsField()
+             ? new (Z) LoadFieldInstr(new (Z) Value(alloc), &Field::Cast(slot),
+                                      AbstractType::ZoneHandle(Z),
+                                      alloc->token_pos(), NULL)
+             : new (Z) LoadFieldInstr(new (Z) Value(alloc),
+                                      Smi::Cast(slot).Value(),
+                                      AbstractType::ZoneHandle(Z),
+                                      alloc->token_pos());
+}
+
 // Insert MaterializeObject instruction for the given allocation before
 // the given instruction that can deoptimize.
 void AllocationSinking::CreateMaterializationAt(
@@ -2991,14 +3387,7 @@ void AllocationSinking::CreateMaterializationAt(
 
   // Insert load instruction for every field.
   for (intptr_t i = 0; i < slots.length(); i++) {
-    LoadFieldInstr* load =
-        slots[i]->IsField()
-            ? new (Z) LoadFieldInstr(
-                  new (Z) Value(alloc), &Field::Cast(*slots[i]),
-                  AbstractType::ZoneHandle(Z), alloc->token_pos(), NULL)
-            : new (Z) LoadFieldInstr(
-                  new (Z) Value(alloc), Smi::Cast(*slots[i]).Value(),
-                  AbstractType::ZoneHandle(Z), alloc->token_pos());
+    LoadFieldInstr* load = LoadSlot(alloc, *slots[i]);
     flow_graph_->InsertBefore(load_point, load, NULL, FlowGraph::kValue);
     values->Add(new (Z) Value(load));
   }
@@ -3040,19 +3429,6 @@ void AllocationSinking::CreateMaterializationAt(
   materializations_.Add(mat);
 }
 
-// Add given instruction to the list of the instructions if it is not yet
-// present there.
-template <typename T>
-void AddInstruction(GrowableArray<T*>* list, T* value) {
-  ASSERT(!value->IsGraphEntry());
-  for (intptr_t i = 0; i < list->length(); i++) {
-    if ((*list)[i] == value) {
-      return;
-    }
-  }
-  list->Add(value);
-}
-
 // Transitively collect all deoptimization exits that might need this allocation
 // rematerialized. It is not enough to collect only environment uses of this
 // allocation because it can flow into other objects that will be
@@ -3097,7 +3473,8 @@ void AllocationSinking::ExitsCollector::CollectTransitively(Definition* alloc) {
   }
 }
 
-void AllocationSinking::InsertMaterializations(Definition* alloc) {
+ZoneGrowableArray<const Object*>* AllocationSinking::CollectSlots(
+    Definition* alloc) {
   // Collect all fields that are written for this instance.
   ZoneGrowableArray<const Object*>* slots =
       new (Z) ZoneGrowableArray<const Object*>(5);
@@ -3122,6 +3499,12 @@ void AllocationSinking::InsertMaterializations(Definition* alloc) {
     AddSlot(slots, Smi::ZoneHandle(Z, Smi::New(type_args_offset)));
   }
 
+  return slots;
+}
+
+void AllocationSinking::InsertMaterializations(Definition* alloc) {
+  ZoneGrowableArray<const Object*>* slots = CollectSlots(alloc);
+
   // Collect all instructions that mention this object in the environment.
   exits_collector_.CollectTransitively(alloc);
 
@@ -3131,6 +3514,119 @@ void AllocationSinking::InsertMaterializations(Definition* alloc) {
   }
 }
 
+// Materialize a partially escaping allocation right before each of its escape
+// points (see IsAllocationSinkingCandidate):
+//
+//   v_1     <- LoadField(v_0, field_1)
+//           ...
+//   v_N     <- LoadField(v_0, field_N)
+//   v_{N+1} <- AllocateObject()
+//              StoreInstanceField(v_{N+1}.field_1, v_1)
+//           ...
+//              StoreInstanceField(v_{N+1}.field_N, v_N)
+//   escape(v_{N+1})
+//
+// All uses of v_0 dominated by the escape point are redirected to v_{N+1}.
+// Loads are forwarded by the load optimizer just like loads inserted for
+// MaterializeObject instructions. Unlike MaterializeObject these copies are
+// real allocations, so this works in precompiled code as well.
+void AllocationSinking::InsertEscapeMaterializations(Definition* alloc) {
+  GrowableArray<Instruction*> escapes;
+  if (!IsAllocationSinkingCandidate(flow_graph_, alloc, kStrictCheck,
+                                    &escapes) ||
+      escapes.is_empty()) {
+    return;
+  }
+
+  AllocateObjectInstr* alloc_object = alloc->AsAllocateObject();
+  ZoneGrowableArray<const Object*>* slots = CollectSlots(alloc);
+
+  // Stores into the copies use the same fields as the original stores (slots
+  // refer to original fields).
+  GrowableArray<const Field*> fields(slots->length());
+  for (intptr_t j = 0; j < slots->length(); j++) {
+    const Field* field = NULL;
+    if ((*slots)[j]->IsField()) {
+      for (Value* use = alloc->input_use_list(); use != NULL;
+           use = use->next_use()) {
+        StoreInstanceFieldInstr* store =
+            use->instruction()->AsStoreInstanceField();
+        if ((store != NULL) && (store->instance()->definition() == alloc) &&
+            (store->field().Original() == (*slots)[j]->raw())) {
+          field = &store->field();
+          break;
+        }
+      }
+      ASSERT(field != NULL);
+    }
+    fields.Add(field);
+  }
+
+  for (intptr_t i = 0; i < escapes.length(); i++) {
+    Instruction* escape = escapes[i];
+    if (FLAG_support_il_printer && FLAG_trace_optimization) {
+      THR_Print("materializing v%" Pd " at escape %s\n",
+                alloc->ssa_temp_index(), escape->ToCString());
+    }
+
+    AllocateObjectInstr* copy = new (Z)
+        AllocateObjectInstr(alloc_object->token_pos(), alloc_object->cls(),
+                            new (Z) PushArgumentsArray(0));
+    copy->set_closure_function(alloc_object->closure_function());
+
+    GrowableArray<LoadFieldInstr*> loads(slots->length());
+    for (intptr_t j = 0; j < slots->length(); j++) {
+      LoadFieldInstr* load = LoadSlot(alloc, *(*slots)[j]);
+      flow_graph_->InsertBefore(escape, load, NULL, FlowGraph::kValue);
+      loads.Add(load);
+    }
+    flow_graph_->InsertBefore(escape, copy, NULL, FlowGraph::kValue);
+
+    EscapeMaterialization* materialization =
+        new (Z) EscapeMaterialization(alloc, copy);
+    for (intptr_t j = 0; j < slots->length(); j++) {
+      StoreInstanceFieldInstr* store =
+          (fields[j] != NULL)
+              ? new (Z) StoreInstanceFieldInstr(
+                    *fields[j], new (Z) Value(copy), new (Z) Value(loads[j]),
+                    kEmitStoreBarrier, alloc->token_pos())
+              : new (Z) StoreInstanceFieldInstr(
+                    Smi::Cast(*(*slots)[j]).Value(), new (Z) Value(copy),
+                    new (Z) Value(loads[j]), kEmitStoreBarrier,
+                    alloc->token_pos());
+      store->set_is_initialization(true);
+      flow_graph_->InsertBefore(escape, store, NULL, FlowGraph::kEffect);
+      materialization->stores()->Add(store);
+    }
+
+    // Redirect the escaping use and everything dominated by it to the copy.
+    GrowableArray<Value*> uses;
+    for (Value* use = alloc->input_use_list(); use != NULL;
+         use = use->next_use()) {
+      if ((use->instruction() == escape) ||
+          use->instruction()->IsDominatedBy(escape)) {
+        uses.Add(use);
+      }
+    }
+    for (intptr_t j = 0; j < uses.length(); j++) {
+      uses[j]->BindTo(copy);
+    }
+    uses.Clear();
+    for (Value* use = alloc->env_use_list(); use != NULL;
+         use = use->next_use()) {
+      if ((use->instruction() == escape) ||
+          use->instruction()->IsDominatedBy(escape)) {
+        uses.Add(use);
+      }
+    }
+    for (intptr_t j = 0; j < uses.length(); j++) {
+      uses[j]->BindToEnvironment(copy);
+    }
+
+    escape_materializations_.Add(materialization);
+  }
+}
+
 void TryCatchAnalyzer::Optimize(FlowGraph* flow_graph) {
   // For every catch-block: Iterate over all call instructions inside the
   // corresponding try-block and figure out for each environment value if it
@@ -3315,6 +3811,145 @@ void CheckStackOverflowElimination::EliminateStackOverflow(FlowGraph* graph) {
   }
 }
 
+// Returns the number of times the loop headed by [header] is entered when
+// it is a simple counted loop of the form
+//
+//   for (var i = c0; i < c1; i += c2) { ... }
+//
+// with constant bounds and a positive constant step, or -1 otherwise.
+static int64_t ConstantTripCount(BlockEntryInstr* header) {
+  JoinEntryInstr* join = header->AsJoinEntry();
+  if ((join == NULL) || (join->PredecessorCount() != 2)) {
+    return -1;
+  }
+  BranchInstr* branch = join->last_instruction()->AsBranch();
+  if (branch == NULL) {
+    return -1;
+  }
+  RelationalOpInstr* compare = branch->comparison()->AsRelationalOp();
+  if (compare == NULL) {
+    return -1;
+  }
+
+  // Normalize the condition so that it holds while the loop keeps running.
+  Token::Kind kind = compare->kind();
+  BitVector* loop_blocks = join->loop_info();
+  const bool true_stays = loop_blocks->Contains(
+      branch->true_successor()->preorder_number());
+  const bool false_stays = loop_blocks->Contains(
+      branch->false_successor()->preorder_number());
+  if (true_stays == false_stays) {
+    return -1;
+  }
+  if (!true_stays) {
+    kind = Token::NegateComparison(kind);
+  }
+
+  // Put the induction variable on the left.
+  Definition* left = compare->left()->definition();
+  Definition* right = compare->right()->definition();
+  PhiInstr* phi = left->AsPhi();
+  if ((phi == NULL) || (phi->block() != join)) {
+    phi = right->AsPhi();
+    if ((phi == NULL) || (phi->block() != join)) {
+      return -1;
+    }
+    right = left;
+    switch (kind) {
+      case Token::kLT:
+        kind = Token::kGT;
+        break;
+      case Token::kGT:
+        kind = Token::kLT;
+        break;
+      case Token::kLTE:
+        kind = Token::kGTE;
+        break;
+      case Token::kGTE:
+        kind = Token::kLTE;
+        break;
+      default:
+        return -1;
+    }
+  }
+  if ((kind != Token::kLT) && (kind != Token::kLTE)) {
+    return -1;
+  }
+
+  const intptr_t back_edge_index =
+      loop_blocks->Contains(join->PredecessorAt(0)->preorder_number()) ? 0
+                                                                        : 1;
+  Definition* initial = phi->InputAt(1 - back_edge_index)->definition();
+  BinaryIntegerOpInstr* increment =
+      phi->InputAt(back_edge_index)->definition()->AsBinaryIntegerOp();
+  if ((increment == NULL) || (increment->op_kind() != Token::kADD) ||
+      (increment->left()->definition() != phi)) {
+    return -1;
+  }
+
+  Definition* step = increment->right()->definition();
+  if (!initial->IsConstant() || !step->IsConstant() || !right->IsConstant()) {
+    return -1;
+  }
+  const Object& initial_value = initial->AsConstant()->value();
+  const Object& step_value = step->AsConstant()->value();
+  const Object& limit_value = right->AsConstant()->value();
+  if (!initial_value.IsSmi() || !step_value.IsSmi() || !limit_value.IsSmi()) {
+    return -1;
+  }
+  // Smi values fit comfortably in int64_t, so none of the arithmetic below
+  // can overflow.
+  const int64_t start = Smi::Cast(initial_value).Value();
+  const int64_t stride = Smi::Cast(step_value).Value();
+  const int64_t limit = Smi::Cast(limit_value).Value();
+  if (stride <= 0) {
+    return -1;
+  }
+  if (kind == Token::kLT) {
+    return (limit <= start) ? 0 : (limit - start + stride - 1) / stride;
+  }
+  return (limit < start) ? 0 : (limit - start) / stride + 1;
+}
+
+void CheckStackOverflowElimination::EliminateFromCountedLoops(
+    FlowGraph* graph) {
+  if (FLAG_max_unchecked_loop_trip_count <= 0) {
+    return;
+  }
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      graph->LoopHeaders();
+  for (intptr_t i = 0; i < loop_headers.length(); ++i) {
+    BlockEntryInstr* header = loop_headers[i];
+
+    // Only innermost loops qualify: an enclosing loop keeps its own check,
+    // so interrupts are still serviced at least once per bounded number
+    // of inner iterations.
+    bool is_innermost = true;
+    for (intptr_t j = 0; j < loop_headers.length(); ++j) {
+      if ((i != j) &&
+          header->loop_info()->Contains(loop_headers[j]->preorder_number())) {
+        is_innermost = false;
+        break;
+      }
+    }
+    if (!is_innermost) {
+      continue;
+    }
+
+    const int64_t trip_count = ConstantTripCount(header);
+    if ((trip_count < 0) || (trip_count > FLAG_max_unchecked_loop_trip_count)) {
+      continue;
+    }
+
+    for (ForwardInstructionIterator it(header); !it.Done(); it.Advance()) {
+      CheckStackOverflowInstr* check = it.Current()->AsCheckStackOverflow();
+      if ((check != NULL) && check->in_loop()) {
+        it.RemoveCurrentFromGraph();
+      }
+    }
+  }
+}
+
 }  // namespace dart
 
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
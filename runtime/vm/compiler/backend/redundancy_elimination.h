@@ -15,7 +15,10 @@ class CSEInstructionMap;
 class AllocationSinking : public ZoneAllocated {
  public:
   explicit AllocationSinking(FlowGraph* flow_graph)
-      : flow_graph_(flow_graph), candidates_(5), materializations_(5) {}
+      : flow_graph_(flow_graph),
+        candidates_(5),
+        materializations_(5),
+        escape_materializations_(5) {}
 
   const GrowableArray<Definition*>& candidates() const { return candidates_; }
 
@@ -52,6 +55,25 @@ class AllocationSinking : public ZoneAllocated {
     GrowableArray<Definition*> worklist_;
   };
 
+  // Copy of a partially escaping allocation created right before one of
+  // its escape points.
+  class EscapeMaterialization : public ZoneAllocated {
+   public:
+    EscapeMaterialization(Definition* alloc, AllocateObjectInstr* copy)
+        : alloc_(alloc), copy_(copy), stores_(4) {}
+
+    Definition* alloc() const { return alloc_; }
+    AllocateObjectInstr* copy() const { return copy_; }
+
+    // Stores initializing fields of the copy.
+    GrowableArray<StoreInstanceFieldInstr*>* stores() { return &stores_; }
+
+   private:
+    Definition* alloc_;
+    AllocateObjectInstr* copy_;
+    GrowableArray<StoreInstanceFieldInstr*> stores_;
+  };
+
   void CollectCandidates();
 
   void NormalizeMaterializations();
@@ -60,6 +82,12 @@ class AllocationSinking : public ZoneAllocated {
 
   void DiscoverFailedCandidates();
 
+  ZoneGrowableArray<const Object*>* CollectSlots(Definition* alloc);
+
+  LoadFieldInstr* LoadSlot(Definition* alloc, const Object& slot);
+
+  void InsertEscapeMaterializations(Definition* alloc);
+
   void InsertMaterializations(Definition* alloc);
 
   void CreateMaterializationAt(Instruction* exit,
@@ -75,6 +103,7 @@ class AllocationSinking : public ZoneAllocated {
 
   GrowableArray<Definition*> candidates_;
   GrowableArray<MaterializeObjectInstr*> materializations_;
+  GrowableArray<EscapeMaterialization*> escape_materializations_;
 
   ExitsCollector exits_collector_;
 };
@@ -137,6 +166,10 @@ class CheckStackOverflowElimination : public AllStatic {
  public:
   // For leaf functions with only a single [StackOverflowInstr] we remove it.
   static void EliminateStackOverflow(FlowGraph* graph);
+
+  // Removes the back-edge checks from innermost loops whose trip count is a
+  // small compile-time constant (see --max_unchecked_loop_trip_count).
+  static void EliminateFromCountedLoops(FlowGraph* graph);
 };
 
 }  // namespace dart
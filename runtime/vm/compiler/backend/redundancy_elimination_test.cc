@@ -0,0 +1,71 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/redundancy_elimination.h"
+
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/dart_api_impl.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+// Counts the context and closure allocations left in the optimized flow graph
+// of the function 'name'.
+static intptr_t CountOptimizedAllocations(Dart_Handle lib, const char* name) {
+  TransitionNativeToVM transition(Thread::Current());
+  StackZone zone(Thread::Current());
+  HANDLESCOPE(Thread::Current());
+  const Library& library = Library::CheckedHandle(Api::UnwrapHandle(lib));
+  const Function& function =
+      Function::Handle(library.LookupFunctionAllowPrivate(
+          String::Handle(Symbols::New(Thread::Current(), name))));
+  EXPECT(!function.IsNull());
+  FlowGraph* flow_graph = CompilerTest::BuildOptimizedFlowGraph(function);
+  intptr_t count = 0;
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      Instruction* instr = it.Current();
+      if (instr->IsAllocateObject() || instr->IsAllocateContext() ||
+          instr->IsAllocateUninitializedContext() ||
+          instr->IsCloneContext()) {
+        count++;
+      }
+    }
+  }
+  return count;
+}
+
+TEST_CASE(AllocationSinking_ContextChain) {
+  // Once g and h are inlined, the context of g's locals points to the context
+  // of foo's locals, and the closures point to the contexts. None of these
+  // allocations escapes.
+  const char* kScript =
+      "foo(int x) {\n"
+      "  int a = x;\n"
+      "  g() {\n"
+      "    int b = a + 1;\n"
+      "    h() => a + b;\n"
+      "    return h();\n"
+      "  }\n"
+      "  return g();\n"
+      "}\n"
+      "main() {\n"
+      "  for (int i = 0; i < 10; i++) {\n"
+      "    foo(i);\n"
+      "  }\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+  EXPECT_EQ(0, CountOptimizedAllocations(lib, "foo"));
+}
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
+}  // namespace dart
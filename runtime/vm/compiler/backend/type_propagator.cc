@@ -1482,6 +1482,10 @@ CompileType InvokeMathCFunctionInstr::ComputeType() const {
   return CompileType::FromCid(kDoubleCid);
 }
 
+CompileType CallLeafNativeInstr::ComputeType() const {
+  return CompileType::Int();
+}
+
 CompileType TruncDivModInstr::ComputeType() const {
   return CompileType::Dynamic();
 }
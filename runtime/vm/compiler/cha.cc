@@ -16,15 +16,43 @@ namespace dart {
 void CHA::AddToGuardedClasses(const Class& cls, intptr_t subclass_count) {
   for (intptr_t i = 0; i < guarded_classes_.length(); i++) {
     if (guarded_classes_[i].cls->raw() == cls.raw()) {
+      guarded_classes_[i].selectors = NULL;
       return;
     }
   }
   GuardedClassInfo info = {&Class::ZoneHandle(thread_->zone(), cls.raw()),
-                           subclass_count};
+                           subclass_count, NULL};
   guarded_classes_.Add(info);
   return;
 }
 
+void CHA::AddToGuardedClasses(const Class& cls,
+                              intptr_t subclass_count,
+                              const String& selector) {
+  for (intptr_t i = 0; i < guarded_classes_.length(); i++) {
+    if (guarded_classes_[i].cls->raw() == cls.raw()) {
+      ZoneGrowableArray<const String*>* selectors =
+          guarded_classes_[i].selectors;
+      if (selectors == NULL) {
+        return;
+      }
+      for (intptr_t j = 0; j < selectors->length(); j++) {
+        if ((*selectors)[j]->raw() == selector.raw()) {
+          return;
+        }
+      }
+      selectors->Add(&String::ZoneHandle(thread_->zone(), selector.raw()));
+      return;
+    }
+  }
+  ZoneGrowableArray<const String*>* selectors =
+      new (thread_->zone()) ZoneGrowableArray<const String*>(1);
+  selectors->Add(&String::ZoneHandle(thread_->zone(), selector.raw()));
+  GuardedClassInfo info = {&Class::ZoneHandle(thread_->zone(), cls.raw()),
+                           subclass_count, selectors};
+  guarded_classes_.Add(info);
+}
+
 bool CHA::IsGuardedClass(intptr_t cid) const {
   for (intptr_t i = 0; i < guarded_classes_.length(); ++i) {
     if (guarded_classes_[i].cls->id() == cid) return true;
@@ -111,6 +139,10 @@ static intptr_t CountFinalizedSubclasses(Thread* thread, const Class& cls) {
   return count;
 }
 
+void CHA::AddToPretenuredClasses(const Class& cls) {
+  AddToGuardedClasses(cls, CountFinalizedSubclasses(thread_, cls));
+}
+
 bool CHA::IsConsistentWithCurrentHierarchy() const {
   for (intptr_t i = 0; i < guarded_classes_.length(); i++) {
     const intptr_t subclass_count =
@@ -167,8 +199,19 @@ bool CHA::HasOverride(const Class& cls,
 }
 
 void CHA::RegisterDependencies(const Code& code) const {
+  Array& selectors = Array::Handle(thread_->zone());
   for (intptr_t i = 0; i < guarded_classes_.length(); ++i) {
-    guarded_classes_[i].cls->RegisterCHACode(code);
+    const ZoneGrowableArray<const String*>* guarded_selectors =
+        guarded_classes_[i].selectors;
+    if (guarded_selectors == NULL) {
+      selectors = Array::null();
+    } else {
+      selectors = Array::New(guarded_selectors->length(), Heap::kOld);
+      for (intptr_t j = 0; j < guarded_selectors->length(); j++) {
+        selectors.SetAt(j, *(*guarded_selectors)[j]);
+      }
+    }
+    guarded_classes_[i].cls->RegisterCHACode(code, selectors);
   }
 }
 
@@ -58,6 +58,18 @@ class CHA : public StackResource {
   // libraries. Only classes that were used for CHA optimizations are added.
   void AddToGuardedClasses(const Class& cls, intptr_t subclass_count);
 
+  // Like AddToGuardedClasses, but for a decision that only relies on no
+  // subclass of 'cls' overriding 'selector'. A later subclass that does not
+  // override any such selector leaves the compiled code alone.
+  void AddToGuardedClasses(const Class& cls,
+                           intptr_t subclass_count,
+                           const String& selector);
+
+  // Adds class 'cls', whose instances are allocated in old space by the code
+  // being compiled, to the guarded classes. Its dependent code is disabled
+  // when the class is no longer pretenured.
+  void AddToPretenuredClasses(const Class& cls);
+
   // When compiling in background we need to check that no new finalized
   // subclasses were added to guarded classes.
   bool IsConsistentWithCurrentHierarchy() const;
@@ -78,6 +90,10 @@ class CHA : public StackResource {
     // Used to validate correctness of background compilation: if
     // any subclasses were added we will discard compiled code.
     intptr_t subclass_count;
+
+    // The selectors that subclasses must not override, or NULL if the code
+    // relies on the class having no new subclasses at all.
+    ZoneGrowableArray<const String*>* selectors;
   };
 
   GrowableArray<GuardedClassInfo> guarded_classes_;
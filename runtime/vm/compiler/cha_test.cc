@@ -5,6 +5,8 @@
 #include "vm/compiler/cha.h"
 #include "platform/assert.h"
 #include "vm/class_finalizer.h"
+#include "vm/compiler/jit/compiler.h"
+#include "vm/dart_api_impl.h"
 #include "vm/globals.h"
 #include "vm/symbols.h"
 #include "vm/unit_test.h"
@@ -95,4 +97,79 @@ TEST_CASE(ClassHierarchyAnalysis) {
   EXPECT(!cha.HasSubclasses(closure_class.id()));
 }
 
+static RawFunction* CompileOptimized(const Library& lib, const char* name) {
+  Thread* thread = Thread::Current();
+  const Function& function = Function::Handle(
+      lib.LookupLocalFunction(String::Handle(Symbols::New(thread, name))));
+  EXPECT(!function.IsNull());
+  const Object& result = Object::Handle(
+      Compiler::CompileOptimizedFunction(thread, function));
+  EXPECT(result.IsCode());
+  EXPECT(function.HasOptimizedCode());
+  return function.raw();
+}
+
+TEST_CASE(ClassHierarchyAnalysis_SelectorInvalidation) {
+  const char* kScriptChars =
+      "class A {\n"
+      "  foo() => 1;\n"
+      "  bar() => 2;\n"
+      "}\n"
+      "class B extends A {\n"
+      "  bar() => 3;\n"
+      "}\n"
+      "class C extends A {\n"
+      "}\n"
+      "useFoo(A a) => a.foo();\n"
+      "useBar(A a) => a.bar();\n"
+      "main() {\n"
+      "  for (int i = 0; i < 10; i++) {\n"
+      "    useFoo(new A());\n"
+      "    useBar(new A());\n"
+      "  }\n"
+      "}\n";
+
+  Dart_Handle lib_handle = TestCase::LoadTestScript(kScriptChars, NULL);
+  EXPECT_VALID(lib_handle);
+  EXPECT_VALID(Dart_Invoke(lib_handle, NewString("main"), 0, NULL));
+
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const Library& lib = Library::CheckedHandle(Api::UnwrapHandle(lib_handle));
+  Class& class_a =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "A"))));
+  const Class& class_b =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "B"))));
+  const Class& class_c =
+      Class::Handle(lib.LookupClass(String::Handle(Symbols::New(thread, "C"))));
+  EXPECT(!class_a.IsNull() && !class_b.IsNull() && !class_c.IsNull());
+
+  // Register the code of useFoo and useBar as relying on A's subclasses not
+  // overriding foo and bar respectively.
+  const Function& use_foo = Function::Handle(CompileOptimized(lib, "useFoo"));
+  const Function& use_bar = Function::Handle(CompileOptimized(lib, "useBar"));
+  const Array& foo_selectors = Array::Handle(Array::New(1, Heap::kOld));
+  foo_selectors.SetAt(0, String::Handle(Symbols::New(thread, "foo")));
+  const Array& bar_selectors = Array::Handle(Array::New(1, Heap::kOld));
+  bar_selectors.SetAt(0, String::Handle(Symbols::New(thread, "bar")));
+  class_a.RegisterCHACode(Code::Handle(use_foo.CurrentCode()), foo_selectors);
+  class_a.RegisterCHACode(Code::Handle(use_bar.CurrentCode()), bar_selectors);
+
+  // C overrides neither method: all code survives.
+  class_a.DisableCHAOptimizedCode(class_c);
+  EXPECT(use_foo.HasOptimizedCode());
+  EXPECT(use_bar.HasOptimizedCode());
+
+  // B overrides bar: only the code calling bar is deoptimized, and the code
+  // calling foo stays registered.
+  class_a.DisableCHAOptimizedCode(class_b);
+  EXPECT(use_foo.HasOptimizedCode());
+  EXPECT(!use_bar.HasOptimizedCode());
+
+  // An implementor of A affects all code.
+  class_a.DisableAllCHAOptimizedCode();
+  EXPECT(!use_foo.HasOptimizedCode());
+}
+
 }  // namespace dart
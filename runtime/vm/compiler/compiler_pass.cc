@@ -6,12 +6,15 @@
 
 #ifndef DART_PRECOMPILED_RUNTIME
 
+#include "vm/compiler/backend/block_coverage.h"
 #include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/constant_propagator.h"
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loop_unroller.h"
+#include "vm/compiler/backend/loop_vectorizer.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
@@ -19,6 +22,9 @@
 #if defined(DART_PRECOMPILER)
 #include "vm/compiler/aot/aot_call_specializer.h"
 #endif
+#include "vm/json_stream.h"
+#include "vm/lockers.h"
+#include "vm/os_thread.h"
 #include "vm/timeline.h"
 
 #define COMPILER_PASS_REPEAT(Name, Body)                                       \
@@ -175,8 +181,28 @@ void CompilerPass::Run(CompilerPassState* state) const {
     {
       NOT_IN_PRODUCT(
           TimelineDurationScope tds2(thread, state->compiler_timeline, name()));
+      // Counting instructions walks the whole graph, so only do it when the
+      // timeline event is recorded.
+      NOT_IN_PRODUCT(const bool count_instructions = tds2.enabled());
+      NOT_IN_PRODUCT(const intptr_t instructions_before =
+                         count_instructions
+                             ? state->flow_graph->InstructionCount()
+                             : 0);
+      NOT_IN_PRODUCT(const int64_t start = OS::GetCurrentMonotonicMicros());
       repeat = DoBody(state);
+      NOT_IN_PRODUCT(CompilerStatistics::RecordPass(
+          id_, OS::GetCurrentMonotonicMicros() - start));
       DEBUG_ASSERT(state->flow_graph->VerifyUseLists());
+#ifndef PRODUCT
+      if (count_instructions) {
+        tds2.SetNumArguments(3);
+        tds2.FormatArgument(0, "round", "%" Pd, round);
+        tds2.FormatArgument(1, "instructionsBefore", "%" Pd,
+                            instructions_before);
+        tds2.FormatArgument(2, "instructionsAfter", "%" Pd,
+                            state->flow_graph->InstructionCount());
+      }
+#endif
       thread->CheckForSafepoint();
     }
     PrintGraph(state, kTraceAfter, round);
@@ -202,12 +228,123 @@ void CompilerPass::PrintGraph(CompilerPassState* state,
   }
 }
 
+#ifndef PRODUCT
+int64_t CompilerStatistics::pass_runs_[CompilerPass::kNumPasses] = {0};
+int64_t CompilerStatistics::pass_micros_[CompilerPass::kNumPasses] = {0};
+Mutex* CompilerStatistics::mutex_ = NULL;
+CompilerStatistics::Compilation
+    CompilerStatistics::compilations_[CompilerStatistics::kMaxCompilations];
+intptr_t CompilerStatistics::compilation_count_ = 0;
+int64_t CompilerStatistics::min_recorded_micros_ = 0;
+
+void CompilerStatistics::InitOnce() {
+  ASSERT(mutex_ == NULL);
+  mutex_ = new Mutex();
+}
+
+void CompilerStatistics::Cleanup() {
+  for (intptr_t i = 0; i < compilation_count_; i++) {
+    free(compilations_[i].function_name);
+  }
+  compilation_count_ = 0;
+  min_recorded_micros_ = 0;
+  delete mutex_;
+  mutex_ = NULL;
+}
+
+void CompilerStatistics::RecordPass(CompilerPass::Id id, int64_t micros) {
+  AtomicOperations::IncrementInt64By(&pass_runs_[id], 1);
+  AtomicOperations::IncrementInt64By(&pass_micros_[id], micros);
+}
+
+void CompilerStatistics::RecordCompilation(const Function& function,
+                                           bool optimized,
+                                           int64_t micros) {
+  // Racy pre-check so that cheap compilations do not take the lock or
+  // compute the function name.
+  if ((mutex_ == NULL) || ((compilation_count_ == kMaxCompilations) &&
+                           (micros <= min_recorded_micros_))) {
+    return;
+  }
+  char* name = strdup(function.ToFullyQualifiedCString());
+  MutexLocker ml(mutex_);
+  intptr_t slot = compilation_count_;
+  if (compilation_count_ == kMaxCompilations) {
+    // Replace the cheapest recorded compilation.
+    slot = 0;
+    for (intptr_t i = 1; i < compilation_count_; i++) {
+      if (compilations_[i].micros < compilations_[slot].micros) {
+        slot = i;
+      }
+    }
+    if (compilations_[slot].micros >= micros) {
+      free(name);
+      return;
+    }
+    free(compilations_[slot].function_name);
+  } else {
+    compilation_count_++;
+  }
+  compilations_[slot].function_name = name;
+  compilations_[slot].optimized = optimized;
+  compilations_[slot].micros = micros;
+  if (compilation_count_ == kMaxCompilations) {
+    min_recorded_micros_ = compilations_[0].micros;
+    for (intptr_t i = 1; i < compilation_count_; i++) {
+      min_recorded_micros_ =
+          Utils::Minimum(min_recorded_micros_, compilations_[i].micros);
+    }
+  }
+}
+
+void CompilerStatistics::PrintJSON(JSONStream* stream, intptr_t limit) {
+  JSONObject jsobj(stream);
+  jsobj.AddProperty("type", "_CompilerStatistics");
+  {
+    JSONArray passes(&jsobj, "passes");
+    for (intptr_t i = 0; i < CompilerPass::kNumPasses; i++) {
+      CompilerPass* pass = CompilerPass::Get(static_cast<CompilerPass::Id>(i));
+      if ((pass == NULL) || (pass_runs_[i] == 0)) {
+        continue;
+      }
+      JSONObject entry(&passes);
+      entry.AddProperty("name", pass->name());
+      entry.AddProperty64("runs", pass_runs_[i]);
+      entry.AddProperty64("micros", pass_micros_[i]);
+    }
+  }
+
+  MutexLocker ml(mutex_);
+  // Selection sort of the few recorded compilations, most expensive first.
+  bool printed[kMaxCompilations] = {false};
+  JSONArray compilations(&jsobj, "compilations");
+  for (intptr_t n = 0; (n < limit) && (n < compilation_count_); n++) {
+    intptr_t best = -1;
+    for (intptr_t i = 0; i < compilation_count_; i++) {
+      if (!printed[i] && ((best == -1) || (compilations_[i].micros >
+                                           compilations_[best].micros))) {
+        best = i;
+      }
+    }
+    printed[best] = true;
+    JSONObject entry(&compilations);
+    entry.AddProperty("function", compilations_[best].function_name);
+    entry.AddProperty("optimized", compilations_[best].optimized);
+    entry.AddProperty64("micros", compilations_[best].micros);
+  }
+}
+#endif  // !PRODUCT
+
 #define INVOKE_PASS(Name)                                                      \
   CompilerPass::Get(CompilerPass::k##Name)->Run(pass_state);
 
 void CompilerPass::RunPipeline(PipelineMode mode,
                                CompilerPassState* pass_state) {
   INVOKE_PASS(ComputeSSA);
+  if ((mode == kJIT) && FLAG_optimized_coverage) {
+    // Before any optimization, the blocks still follow the source.
+    INVOKE_PASS(InstrumentBlockCoverage);
+  }
 #if defined(DART_PRECOMPILER)
   if (mode == kAOT) {
     INVOKE_PASS(ApplyClassIds);
@@ -239,6 +376,8 @@ void CompilerPass::RunPipeline(PipelineMode mode,
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(RangeAnalysis);
   INVOKE_PASS(OptimizeBranches);
+  INVOKE_PASS(LoopVectorization);
+  INVOKE_PASS(LoopUnrolling);
   INVOKE_PASS(TypePropagation);
   INVOKE_PASS(TryCatchOptimization);
   INVOKE_PASS(EliminateEnvironments);
@@ -270,6 +409,9 @@ COMPILER_PASS(ComputeSSA, {
   flow_graph->ComputeSSA(0, NULL);
 });
 
+COMPILER_PASS(InstrumentBlockCoverage,
+              { BlockCoverage::Instrument(flow_graph); });
+
 COMPILER_PASS(ApplyICData, { state->call_specializer->ApplyICData(); });
 
 COMPILER_PASS(TryOptimizePatterns, { flow_graph->TryOptimizePatterns(); });
@@ -293,6 +435,7 @@ COMPILER_PASS(ApplyClassIds, { state->call_specializer->ApplyClassIds(); });
 COMPILER_PASS(EliminateStackOverflowChecks, {
   if (!flow_graph->IsCompiledForOsr()) {
     CheckStackOverflowElimination::EliminateStackOverflow(flow_graph);
+    CheckStackOverflowElimination::EliminateFromCountedLoops(flow_graph);
   }
 });
 
@@ -359,6 +502,18 @@ COMPILER_PASS(OptimizeBranches, {
   ConstantPropagator::OptimizeBranches(flow_graph);
 });
 
+COMPILER_PASS(LoopVectorization, {
+  // Vectorized loops keep the scalar loop as epilogue, which can still be
+  // unrolled afterwards.
+  LoopVectorizer::Optimize(flow_graph);
+});
+
+COMPILER_PASS(LoopUnrolling, {
+  // Bounds checks in loop bodies must have been eliminated or hoisted by
+  // range analysis for loops to become candidates for unrolling.
+  LoopUnroller::Optimize(flow_graph);
+});
+
 COMPILER_PASS(TryCatchOptimization,
               { TryCatchAnalyzer::Optimize(flow_graph); });
 
@@ -30,8 +30,11 @@ namespace dart {
   V(EliminateStackOverflowChecks)                                              \
   V(FinalizeGraph)                                                             \
   V(IfConvert)                                                                 \
+  V(InstrumentBlockCoverage)                                                   \
   V(Inlining)                                                                  \
   V(LICM)                                                                      \
+  V(LoopUnrolling)                                                             \
+  V(LoopVectorization)                                                         \
   V(OptimisticallySpecializeSmiPhis)                                           \
   V(OptimizeBranches)                                                          \
   V(RangeAnalysis)                                                             \
@@ -49,6 +52,8 @@ class BlockScheduler;
 class CallSpecializer;
 class FlowGraph;
 class Function;
+class JSONStream;
+class Mutex;
 class Precompiler;
 class SpeculativeInliningPolicy;
 
@@ -110,7 +115,7 @@ class CompilerPass {
   static const intptr_t kNumPasses = 0 COMPILER_PASS_LIST(ADD_ONE);
 #undef ADD_ONE
 
-  CompilerPass(Id id, const char* name) : name_(name), flags_(0) {
+  CompilerPass(Id id, const char* name) : id_(id), name_(name), flags_(0) {
     ASSERT(passes_[id] == NULL);
     passes_[id] = this;
 
@@ -132,6 +137,7 @@ class CompilerPass {
   void Run(CompilerPassState* state) const;
 
   intptr_t flags() const { return flags_; }
+  Id id() const { return id_; }
   const char* name() const { return name_; }
 
   bool IsFlagSet(Flag flag) const { return (flags() & flag) != 0; }
@@ -164,10 +170,49 @@ class CompilerPass {
 
   static CompilerPass* passes_[];
 
+  const Id id_;
   const char* name_;
   intptr_t flags_;
 };
 
+#ifndef PRODUCT
+// Timing statistics for the service, collected outside of PRODUCT builds:
+// the accumulated time spent in each compiler pass and the most expensive
+// compilations of the process. Updated concurrently by the mutator and
+// background compiler threads.
+class CompilerStatistics : public AllStatic {
+ public:
+  static void InitOnce();
+  static void Cleanup();
+
+  static void RecordPass(CompilerPass::Id id, int64_t micros);
+  static void RecordCompilation(const Function& function,
+                                bool optimized,
+                                int64_t micros);
+
+  // Prints the per-pass totals and at most `limit` of the most expensive
+  // compilations, most expensive first.
+  static void PrintJSON(JSONStream* stream, intptr_t limit);
+
+  static const intptr_t kMaxCompilations = 64;
+
+ private:
+  struct Compilation {
+    char* function_name;
+    bool optimized;
+    int64_t micros;
+  };
+
+  static int64_t pass_runs_[CompilerPass::kNumPasses];
+  static int64_t pass_micros_[CompilerPass::kNumPasses];
+
+  static Mutex* mutex_;
+  static Compilation compilations_[kMaxCompilations];
+  static intptr_t compilation_count_;
+  static int64_t min_recorded_micros_;
+};
+#endif  // !PRODUCT
+
 }  // namespace dart
 
 #endif
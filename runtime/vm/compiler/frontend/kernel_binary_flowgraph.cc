@@ -2254,6 +2254,12 @@ Fragment StreamingFlowGraphBuilder::StringInterpolateSingle(
   return flow_graph_builder_->StringInterpolateSingle(position);
 }
 
+Fragment StreamingFlowGraphBuilder::StringInterpolateParts(
+    TokenPosition position,
+    intptr_t count) {
+  return flow_graph_builder_->StringInterpolateParts(position, count);
+}
+
 Fragment StreamingFlowGraphBuilder::ThrowTypeError() {
   return flow_graph_builder_->ThrowTypeError();
 }
@@ -3062,7 +3068,13 @@ Fragment StreamingFlowGraphBuilder::BuildStaticGet(TokenPosition* p) {
       const String& getter_name = H.DartGetterName(target);
       const Function& getter =
           Function::ZoneHandle(Z, owner.LookupStaticFunction(getter_name));
-      if (getter.IsNull() || !field.has_initializer()) {
+      // Once the initializer has run, the field is read directly rather than
+      // through its getter, unless it may be reset to its initial value.
+      const bool is_initialized =
+          !FLAG_fields_may_be_reset &&
+          (field.StaticValue() != Object::sentinel().raw()) &&
+          (field.StaticValue() != Object::transition_sentinel().raw());
+      if (getter.IsNull() || !field.has_initializer() || is_initialized) {
         Fragment instructions = Constant(field);
         return instructions + LoadStaticField();
       } else {
@@ -3829,6 +3841,13 @@ Fragment StreamingFlowGraphBuilder::BuildStringConcatenation(TokenPosition* p) {
   if (length == 1) {
     instructions += BuildExpression();  // read expression.
     instructions += StringInterpolateSingle(position);
+  } else if (length <= FlowGraphBuilder::kMaxStringInterpolateParts) {
+    // Pass the parts as arguments instead of storing them into an array.
+    for (intptr_t i = 0; i < length; ++i) {
+      instructions += BuildExpression();  // read ith expression.
+      instructions += PushArgument();
+    }
+    instructions += StringInterpolateParts(position, length);
   } else {
     // The type arguments for CreateArray.
     instructions += Constant(TypeArguments::ZoneHandle(Z));
@@ -4679,6 +4698,58 @@ Fragment StreamingFlowGraphBuilder::BuildForInStatement(bool async) {
   return Fragment(instructions.entry, loop_exit);
 }
 
+// A case of a switch whose value is a Smi, see BuildSmiSwitchSearch.
+struct SmiSwitchCase {
+  const Smi* value;
+  intptr_t case_index;
+  intptr_t order;
+};
+
+static int CompareSmiSwitchCases(const SmiSwitchCase* a,
+                                 const SmiSwitchCase* b) {
+  if (a->value->Value() != b->value->Value()) {
+    return (a->value->Value() < b->value->Value()) ? -1 : 1;
+  }
+  return (a->order < b->order) ? -1 : ((a->order > b->order) ? 1 : 0);
+}
+
+// Switches with at least this many Smi cases dispatch a Smi value by
+// binary search instead of comparing it with each case in turn.
+static const intptr_t kMinSmiSwitchSearchCases = 8;
+
+// Searches the sorted cases [lo, hi) for the Smi in the switch variable and
+// jumps to the body of the case found, or to miss.
+void StreamingFlowGraphBuilder::BuildSmiSwitchSearch(
+    Fragment instructions,
+    const GrowableArray<SmiSwitchCase>& cases,
+    intptr_t lo,
+    intptr_t hi,
+    SwitchBlock* block,
+    JoinEntryInstr* miss) {
+  if (hi - lo <= 3) {
+    for (intptr_t k = lo; k < hi; ++k) {
+      TargetEntryInstr* then;
+      TargetEntryInstr* otherwise;
+      instructions += LoadLocal(scopes()->switch_variable);
+      instructions += Constant(*cases[k].value);
+      instructions += B->BranchIfStrictEqual(&then, &otherwise);
+      Fragment(then) + Goto(block->DestinationDirect(cases[k].case_index));
+      instructions = Fragment(otherwise);
+    }
+    instructions += Goto(miss);
+    return;
+  }
+  const intptr_t mid = lo + (hi - lo) / 2;
+  TargetEntryInstr* less;
+  TargetEntryInstr* greater_or_equal;
+  instructions += LoadLocal(scopes()->switch_variable);
+  instructions += Constant(*cases[mid].value);
+  instructions += B->SmiRelationalOp(Token::kLT);
+  instructions += BranchIfTrue(&less, &greater_or_equal, false);
+  BuildSmiSwitchSearch(Fragment(less), cases, lo, mid, block, miss);
+  BuildSmiSwitchSearch(Fragment(greater_or_equal), cases, mid, hi, block, miss);
+}
+
 Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
   ReadPosition();  // read position.
   // We need the number of cases. So start by getting that, then go back.
@@ -4787,10 +4858,66 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
 
   intptr_t end_offset = ReaderOffset();
 
+  // If all non-default cases are Smis and there are enough of them, a Smi
+  // value is dispatched by binary search. A Smi that matches no case jumps
+  // straight to the default case, or past the switch if there is none: no
+  // `==` call in the chain built in phase 2 could succeed for it. Other
+  // values, e.g. a double equal to an int case, still take that chain. The
+  // decision doesn't depend on whether we are optimizing, so that deopt ids
+  // match.
+  GrowableArray<SmiSwitchCase> smi_cases;
+  bool all_smi = true;
+  for (intptr_t i = 0; all_smi && (i < case_count); ++i) {
+    if (i == default_case) continue;
+    SetOffset(case_expression_offsets[i]);
+    int expression_count = ReadListLength();  // read number of expressions.
+    for (intptr_t j = 0; j < expression_count; ++j) {
+      ReadPosition();  // read jth position.
+      const Instance& value = Instance::ZoneHandle(
+          Z, constant_evaluator_.EvaluateExpression(ReaderOffset()));
+      SkipExpression();  // read jth expression.
+      if (!value.IsSmi()) {
+        all_smi = false;
+        break;
+      }
+      SmiSwitchCase smi_case = {&Smi::Cast(value), i, smi_cases.length()};
+      smi_cases.Add(smi_case);
+    }
+  }
+  JoinEntryInstr* smi_miss = NULL;
+  Fragment current_instructions = head_instructions;
+  if (all_smi && (smi_cases.length() >= kMinSmiSwitchSearchCases)) {
+    smi_cases.Sort(CompareSmiSwitchCases);
+    // Only the first of several equal cases can match.
+    intptr_t length = 0;
+    for (intptr_t k = 0; k < smi_cases.length(); ++k) {
+      if ((length == 0) || (smi_cases[length - 1].value->Value() !=
+                            smi_cases[k].value->Value())) {
+        smi_cases[length++] = smi_cases[k];
+      }
+    }
+    smi_cases.TruncateTo(length);
+
+    // Make the bodies join targets before phase 2 reaches them.
+    for (intptr_t i = 0; i < case_count; ++i) {
+      if (i != default_case) block.DestinationDirect(i);
+    }
+    smi_miss = BuildJoinEntry();
+
+    TargetEntryInstr* is_smi;
+    TargetEntryInstr* is_not_smi;
+    current_instructions += LoadLocal(scopes()->switch_variable);
+    current_instructions += B->LoadClassId();
+    current_instructions += IntConstant(kSmiCid);
+    current_instructions += B->BranchIfStrictEqual(&is_smi, &is_not_smi);
+    BuildSmiSwitchSearch(Fragment(is_smi), smi_cases, 0, smi_cases.length(),
+                         &block, smi_miss);
+    current_instructions = Fragment(is_not_smi);
+  }
+
   // Phase 2: Generate everything except the real bodies:
   //   * jump directly to a body (if there is no jumper)
   //   * jump to a wrapper block which jumps to the body (if there is a jumper)
-  Fragment current_instructions = head_instructions;
   for (intptr_t i = 0; i < case_count; ++i) {
     SetOffset(case_expression_offsets[i]);
     int expression_count = ReadListLength();  // read length of expressions.
@@ -4798,6 +4925,11 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
     if (i == default_case) {
       ASSERT(i == (case_count - 1));
 
+      if (smi_miss != NULL) {
+        current_instructions += Goto(smi_miss);
+        current_instructions = Fragment(smi_miss);
+      }
+
       // Evaluate the conditions for the default [SwitchCase] just for the
       // purpose of potentially triggering a compile-time error.
 
@@ -4861,6 +4993,11 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
     }
   }
 
+  if (smi_miss != NULL && default_case < 0) {
+    current_instructions += Goto(smi_miss);
+    current_instructions = Fragment(smi_miss);
+  }
+
   if (case_count > 0 && default_case < 0) {
     // There is no default, which means we have an open [current_instructions]
     // (which is a [TargetEntryInstruction] for the last "otherwise" branch).
@@ -4870,7 +5007,8 @@ Fragment StreamingFlowGraphBuilder::BuildSwitchStatement() {
     Fragment& last_body = body_fragments[case_count - 1];
     if (last_body.is_open()) {
       ASSERT(current_instructions.is_open());
-      ASSERT(current_instructions.current->IsTargetEntry());
+      ASSERT(current_instructions.current->IsTargetEntry() ||
+             current_instructions.current == smi_miss);
 
       // Join the last "otherwise" branch and the last [SwitchCase] fragment.
       JoinEntryInstr* join = BuildJoinEntry();
@@ -19,6 +19,8 @@
 namespace dart {
 namespace kernel {
 
+struct SmiSwitchCase;
+
 class StreamingFlowGraphBuilder : public KernelReaderHelper {
  public:
   StreamingFlowGraphBuilder(FlowGraphBuilder* flow_graph_builder,
@@ -125,6 +127,7 @@ class StreamingFlowGraphBuilder : public KernelReaderHelper {
       GrowableArray<intptr_t>* record_token_positions_in,
       GrowableArray<intptr_t>* record_yield_positions_in);
   intptr_t SourceTableSize();
+  intptr_t GetOffsetForSourceInfo(intptr_t index);
   String& SourceTableUriFor(intptr_t index);
   String& GetSourceFor(intptr_t index);
   RawTypedData* GetLineStartsFor(intptr_t index);
@@ -145,8 +148,6 @@ class StreamingFlowGraphBuilder : public KernelReaderHelper {
       bool is_implicit_closure_function,
       bool throw_no_such_method_error = false);
 
-  intptr_t GetOffsetForSourceInfo(intptr_t index);
-
   Fragment BuildExpression(TokenPosition* position = NULL);
   Fragment BuildStatement();
 
@@ -269,6 +270,7 @@ class StreamingFlowGraphBuilder : public KernelReaderHelper {
   Fragment StoreInstanceField(TokenPosition position, intptr_t offset);
   Fragment StringInterpolate(TokenPosition position);
   Fragment StringInterpolateSingle(TokenPosition position);
+  Fragment StringInterpolateParts(TokenPosition position, intptr_t count);
   Fragment ThrowTypeError();
   Fragment LoadInstantiatorTypeArguments();
   Fragment LoadFunctionTypeArguments();
@@ -391,6 +393,12 @@ class StreamingFlowGraphBuilder : public KernelReaderHelper {
   Fragment BuildDoStatement();
   Fragment BuildForStatement();
   Fragment BuildForInStatement(bool async);
+  void BuildSmiSwitchSearch(Fragment instructions,
+                            const GrowableArray<SmiSwitchCase>& cases,
+                            intptr_t lo,
+                            intptr_t hi,
+                            SwitchBlock* block,
+                            JoinEntryInstr* miss);
   Fragment BuildSwitchStatement();
   Fragment BuildContinueSwitchStatement();
   Fragment BuildIfStatement();
@@ -1042,6 +1042,33 @@ Fragment FlowGraphBuilder::StringInterpolateSingle(TokenPosition position) {
   return instructions;
 }
 
+Fragment FlowGraphBuilder::StringInterpolateParts(TokenPosition position,
+                                                  intptr_t count) {
+  ASSERT((count >= 2) && (count <= kMaxStringInterpolateParts));
+  const int kTypeArgsLen = 0;
+  const Array& kNoArgumentNames = Object::null_array();
+  const Class& cls =
+      Class::Handle(Library::LookupCoreClass(Symbols::StringBase()));
+  ASSERT(!cls.IsNull());
+  const String* name = NULL;
+  switch (count) {
+    case 2:
+      name = &Symbols::Interpolate2();
+      break;
+    case 3:
+      name = &Symbols::Interpolate3();
+      break;
+    default:
+      name = &Symbols::Interpolate4();
+      break;
+  }
+  const Function& function = Function::ZoneHandle(
+      Z, Resolver::ResolveStatic(cls, Library::PrivateCoreLibName(*name),
+                                 kTypeArgsLen, count, kNoArgumentNames));
+  // The parts have already been pushed as arguments.
+  return StaticCall(position, function, count, ICData::kStatic);
+}
+
 Fragment FlowGraphBuilder::ThrowTypeError() {
   const Class& klass =
       Class::ZoneHandle(Z, Library::LookupCoreClass(Symbols::TypeError()));
@@ -275,6 +275,10 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
   // as such function already checks all of its parameters.
   static bool NeedsDynamicInvocationForwarder(const Function& function);
 
+  // String interpolations with up to this many parts call
+  // _StringBase._interpolate<N> instead of building an array of the parts.
+  static const intptr_t kMaxStringInterpolateParts = 4;
+
  private:
   BlockEntryInstr* BuildPrologue(TargetEntryInstr* normal_entry,
                                  PrologueInfo* prologue_info);
@@ -370,6 +374,7 @@ class FlowGraphBuilder : public BaseFlowGraphBuilder {
   Fragment StoreStaticField(TokenPosition position, const Field& field);
   Fragment StringInterpolate(TokenPosition position);
   Fragment StringInterpolateSingle(TokenPosition position);
+  Fragment StringInterpolateParts(TokenPosition position, intptr_t count);
   Fragment ThrowTypeError();
   Fragment ThrowNoSuchMethodError();
   Fragment BuildImplicitClosureCreation(const Function& target);
@@ -40,6 +40,9 @@ void TranslationHelper::Reset() {
   metadata_payloads_ = ExternalTypedData::null();
   metadata_mappings_ = ExternalTypedData::null();
   constants_ = Array::null();
+  symbols_.Clear();
+  libraries_.Clear();
+  classes_.Clear();
 }
 
 void TranslationHelper::InitFromScript(const Script& script) {
@@ -315,6 +318,11 @@ const String& TranslationHelper::DartSymbolPlain(const char* content) const {
 }
 
 String& TranslationHelper::DartSymbolPlain(StringIndex string_index) const {
+  // Callers may reuse the handle returned, so hand out a fresh one.
+  String* cached = symbols_.Lookup(string_index);
+  if (cached != NULL) {
+    return String::ZoneHandle(Z, cached->raw());
+  }
   intptr_t length = StringSize(string_index);
   uint8_t* buffer = Z->Alloc<uint8_t>(length);
   {
@@ -323,6 +331,7 @@ String& TranslationHelper::DartSymbolPlain(StringIndex string_index) const {
   }
   String& result =
       String::ZoneHandle(Z, Symbols::FromUTF8(thread_, buffer, length));
+  symbols_.Insert(string_index, &String::ZoneHandle(Z, result.raw()));
   return result;
 }
 
@@ -337,14 +346,7 @@ const String& TranslationHelper::DartSymbolObfuscate(
 }
 
 String& TranslationHelper::DartSymbolObfuscate(StringIndex string_index) const {
-  intptr_t length = StringSize(string_index);
-  uint8_t* buffer = Z->Alloc<uint8_t>(length);
-  {
-    NoSafepointScope no_safepoint;
-    memmove(buffer, StringBuffer(string_index), length);
-  }
-  String& result =
-      String::ZoneHandle(Z, Symbols::FromUTF8(thread_, buffer, length));
+  String& result = DartSymbolPlain(string_index);
   if (I->obfuscate()) {
     Obfuscator obfuscator(thread_, String::Handle(Z));
     result = obfuscator.Rename(result, true);
@@ -465,16 +467,27 @@ RawLibrary* TranslationHelper::LookupLibraryByKernelLibrary(
   // This ASSERT is just a sanity check.
   ASSERT(IsLibrary(kernel_library) ||
          IsAdministrative(CanonicalNameParent(kernel_library)));
+  Library* cached = libraries_.Lookup(kernel_library);
+  if (cached != NULL) {
+    return cached->raw();
+  }
   const String& library_name =
       DartSymbolPlain(CanonicalNameString(kernel_library));
   ASSERT(!library_name.IsNull());
   RawLibrary* library = Library::LookupLibrary(thread_, library_name);
   ASSERT(library != Object::null());
+  if (library != Object::null()) {
+    libraries_.Insert(kernel_library, &Library::ZoneHandle(Z, library));
+  }
   return library;
 }
 
 RawClass* TranslationHelper::LookupClassByKernelClass(NameIndex kernel_class) {
   ASSERT(IsClass(kernel_class));
+  Class* cached = classes_.Lookup(kernel_class);
+  if (cached != NULL) {
+    return cached->raw();
+  }
   const String& class_name = DartClassName(kernel_class);
   NameIndex kernel_library = CanonicalNameParent(kernel_class);
   Library& library =
@@ -482,6 +495,9 @@ RawClass* TranslationHelper::LookupClassByKernelClass(NameIndex kernel_class) {
   RawClass* klass = library.LookupClassAllowPrivate(class_name);
 
   ASSERT(klass != Object::null());
+  if (klass != Object::null()) {
+    classes_.Insert(kernel_class, &Class::ZoneHandle(Z, klass));
+  }
   return klass;
 }
 
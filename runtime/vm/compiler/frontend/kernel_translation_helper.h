@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_COMPILER_FRONTEND_KERNEL_TRANSLATION_HELPER_H_
 #define RUNTIME_VM_COMPILER_FRONTEND_KERNEL_TRANSLATION_HELPER_H_
 
+#include "vm/hash_map.h"
 #include "vm/kernel.h"
 #include "vm/kernel_binary.h"
 #include "vm/object.h"
@@ -188,6 +189,15 @@ class TranslationHelper {
   ExternalTypedData& metadata_mappings_;
   Array& constants_;
 
+  // The symbols made from the string table so far, by string index. Names
+  // repeat a lot in kernel, and decoding them again is not cheap.
+  mutable IntMap<String*> symbols_;
+
+  // The libraries and classes found by canonical name so far. Each type a
+  // function mentions is otherwise looked up by name again.
+  IntMap<Library*> libraries_;
+  IntMap<Class*> classes_;
+
   DISALLOW_COPY_AND_ASSIGN(TranslationHelper);
 };
 
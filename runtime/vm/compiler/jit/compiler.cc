@@ -10,6 +10,7 @@
 #include "vm/code_patcher.h"
 #include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/assembler/disassembler.h"
+#include "vm/compiler/backend/block_coverage.h"
 #include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/constant_propagator.h"
@@ -53,6 +54,16 @@ DEFINE_FLAG(
     max_deoptimization_counter_threshold,
     16,
     "How many times we allow deoptimization before we disallow optimization.");
+DEFINE_FLAG(bool,
+            adaptive_reoptimization,
+            true,
+            "Keep reoptimizing functions whose deoptimizations disabled the "
+            "failing speculation instead of giving up on optimization.");
+DEFINE_FLAG(int,
+            max_adaptive_deoptimization_counter_threshold,
+            64,
+            "How many times we allow deoptimization that disabled the failing "
+            "speculation before we disallow optimization.");
 DEFINE_FLAG(charp, optimization_filter, NULL, "Optimize only named function");
 DEFINE_FLAG(bool, print_flow_graph, false, "Print the IR flow graph.");
 DEFINE_FLAG(bool,
@@ -90,6 +101,9 @@ DEFINE_FLAG(bool,
 DECLARE_FLAG(bool, huge_method_cutoff_in_code_size);
 DECLARE_FLAG(bool, trace_failed_optimization_attempts);
 DECLARE_FLAG(bool, unbox_numeric_fields);
+#if defined(DART_USE_INTERPRETER)
+DECLARE_FLAG(bool, optimize_from_bytecode);
+#endif
 
 static void PrecompilationModeHandler(bool value) {
   if (value) {
@@ -268,6 +282,19 @@ DEFINE_RUNTIME_ENTRY(CompileFunction, 1) {
 #endif
 }
 
+bool Compiler::HasExcessiveDeoptimizations(const Function& function) {
+  const intptr_t count = function.deoptimization_counter();
+  if (!FLAG_adaptive_reoptimization) {
+    return count >= FLAG_max_deoptimization_counter_threshold;
+  }
+  // The counter is an int8_t, so the adaptive limit must stay below kMaxInt8.
+  const intptr_t adaptive_limit = Utils::Minimum<intptr_t>(
+      FLAG_max_adaptive_deoptimization_counter_threshold, kMaxInt8);
+  const intptr_t unadapted = count - function.adapted_deoptimization_counter();
+  return (unadapted >= FLAG_max_deoptimization_counter_threshold) ||
+         (count >= adaptive_limit);
+}
+
 bool Compiler::CanOptimizeFunction(Thread* thread, const Function& function) {
 #if !defined(PRODUCT)
   Isolate* isolate = thread->isolate();
@@ -280,8 +307,7 @@ bool Compiler::CanOptimizeFunction(Thread* thread, const Function& function) {
     return false;
   }
 #endif
-  if (function.deoptimization_counter() >=
-      FLAG_max_deoptimization_counter_threshold) {
+  if (HasExcessiveDeoptimizations(function)) {
     if (FLAG_trace_failed_optimization_attempts ||
         FLAG_stop_on_excessive_deoptimization) {
       THR_Print("Too many deoptimizations: %s\n",
@@ -536,6 +562,81 @@ RawError* Compiler::CompileClass(const Class& cls) {
   return Error::null();
 }
 
+// Returns true if 'function' was warmed up in the interpreter and has no
+// unoptimized code to collect type feedback in.
+static bool UsesInterpreterFeedback(const Function& function) {
+#if defined(DART_USE_INTERPRETER)
+  return FLAG_optimize_from_bytecode && function.HasBytecode() &&
+         (function.ic_data_array() == Array::null());
+#else
+  return false;
+#endif
+}
+
+#if defined(DART_USE_INTERPRETER)
+
+// Bytecode ICData are not keyed by deopt id, so match them to the instance
+// calls of the flow graph by selector and only when the match is unambiguous.
+static void AttachInterpreterFeedback(Zone* zone, FlowGraph* flow_graph) {
+  const Function& function = flow_graph->function();
+  const Code& bytecode = Code::Handle(zone, function.Bytecode());
+  const ObjectPool& pool = ObjectPool::Handle(zone, bytecode.object_pool());
+  GrowableArray<const ICData*> feedback;
+  Object& entry = Object::Handle(zone);
+  for (intptr_t i = 0; i < pool.Length(); i++) {
+    if (pool.TypeAt(i) != ObjectPool::kTaggedObject) continue;
+    entry = pool.ObjectAt(i);
+    if (!entry.IsICData()) continue;
+    const ICData& ic_data = ICData::Cast(entry);
+    if ((ic_data.rebind_rule() == ICData::kInstance) &&
+        (ic_data.NumArgsTested() == 1) &&
+        (ic_data.NumberOfUsedChecks() > 0)) {
+      feedback.Add(&ICData::ZoneHandle(zone, ic_data.raw()));
+    }
+  }
+  if (feedback.is_empty()) return;
+
+  Function& target = Function::Handle(zone);
+  for (BlockIterator block_it = flow_graph->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      InstanceCallInstr* call = it.Current()->AsInstanceCall();
+      if ((call == NULL) || call->HasICData() ||
+          (call->argument_names().Length() != 0)) {
+        continue;
+      }
+      const ICData* match = NULL;
+      intptr_t matches = 0;
+      for (intptr_t i = 0; i < feedback.length(); i++) {
+        const ICData& ic_data = *feedback[i];
+        const ArgumentsDescriptor args_desc(
+            Array::Handle(zone, ic_data.arguments_descriptor()));
+        if ((ic_data.target_name() == call->function_name().raw()) &&
+            (args_desc.TypeArgsLen() == call->type_args_len()) &&
+            (args_desc.Count() == call->ArgumentCountWithoutTypeArgs()) &&
+            (args_desc.NamedCount() == 0)) {
+          match = &ic_data;
+          matches++;
+        }
+      }
+      if (matches != 1) continue;
+      const ICData& ic_data = ICData::ZoneHandle(
+          zone, ICData::New(function, call->function_name(),
+                            Array::Handle(zone, match->arguments_descriptor()),
+                            call->deopt_id(), 1, ICData::kInstance));
+      for (intptr_t i = 0; i < match->NumberOfChecks(); i++) {
+        if (match->IsSentinelAt(i)) continue;
+        target = match->GetTargetAt(i);
+        ic_data.AddReceiverCheck(match->GetReceiverClassIdAt(i), target,
+                                 match->GetCountAt(i));
+      }
+      call->set_ic_data(&ic_data);
+    }
+  }
+}
+#endif  // defined(DART_USE_INTERPRETER)
+
 class CompileParsedFunctionHelper : public ValueObject {
  public:
   CompileParsedFunctionHelper(ParsedFunction* parsed_function,
@@ -595,6 +696,12 @@ RawCode* CompileParsedFunctionHelper::FinalizeCompilation(
   code.set_is_optimized(optimized());
   code.set_owner(function);
 #if !defined(PRODUCT)
+  if (optimized()) {
+    isolate()->GetCompiledOptimizedMetric()->AtomicIncrement();
+    BlockCoverage::Register(thread(), flow_graph);
+  } else {
+    isolate()->GetCompiledUnoptimizedMetric()->AtomicIncrement();
+  }
   ZoneGrowableArray<TokenPosition>* await_token_positions =
       flow_graph->await_token_positions();
   if (await_token_positions != NULL) {
@@ -798,8 +905,7 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
           // In background compilation the deoptimization counter may have
           // already reached the limit.
           ASSERT(Compiler::IsBackgroundCompilation() ||
-                 (function.deoptimization_counter() <
-                  FLAG_max_deoptimization_counter_threshold));
+                 !Compiler::HasExcessiveDeoptimizations(function));
 
           // 'Freeze' ICData in background compilation so that it does not
           // change while compiling.
@@ -807,7 +913,8 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
           function.RestoreICDataMap(ic_data_array, clone_ic_data);
 
           if (Compiler::IsBackgroundCompilation() &&
-              (function.ic_data_array() == Array::null())) {
+              (function.ic_data_array() == Array::null()) &&
+              !UsesInterpreterFeedback(function)) {
             Compiler::AbortBackgroundCompilation(
                 Thread::kNoDeoptId, "RestoreICDataMap: ICData array cleared.");
           }
@@ -832,6 +939,9 @@ RawCode* CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       if (flow_graph == NULL && function.HasBytecode()) {
         return Code::null();
       }
+      if (optimized() && UsesInterpreterFeedback(function)) {
+        AttachInterpreterFeedback(zone, flow_graph);
+      }
 #endif
 
       const bool print_flow_graph =
@@ -971,6 +1081,8 @@ static RawObject* CompileFunctionHelper(CompilationPipeline* pipeline,
         FLAG_trace_compiler || (FLAG_trace_optimizing_compiler && optimized);
     Timer per_compile_timer(trace_compiler, "Compilation time");
     per_compile_timer.Start();
+    NOT_IN_PRODUCT(const int64_t start_micros =
+                       OS::GetCurrentMonotonicMicros());
 
     ParsedFunction* parsed_function = new (zone)
         ParsedFunction(thread, Function::ZoneHandle(zone, function.raw()));
@@ -1099,6 +1211,8 @@ static RawObject* CompileFunctionHelper(CompilationPipeline* pipeline,
     }
 
     per_compile_timer.Stop();
+    NOT_IN_PRODUCT(CompilerStatistics::RecordCompilation(
+        function, optimized, OS::GetCurrentMonotonicMicros() - start_micros));
 
     if (trace_compiler) {
       THR_Print("--> '%s' entry: %#" Px " size: %" Pd " time: %" Pd64 " us\n",
@@ -1613,7 +1727,10 @@ void Compiler::AbortBackgroundCompilation(intptr_t deopt_id, const char* msg) {
 class QueueElement {
  public:
   explicit QueueElement(const Function& function)
-      : next_(NULL), function_(function.raw()) {}
+      : next_(NULL),
+        function_(function.raw()),
+        priority_(function.usage_counter()),
+        in_progress_(false) {}
 
   virtual ~QueueElement() {
     next_ = NULL;
@@ -1630,15 +1747,27 @@ class QueueElement {
     return reinterpret_cast<RawObject**>(&function_);
   }
 
+  // Usage counter of the function at the time it was enqueued.
+  intptr_t priority() const { return priority_; }
+
+  // True while a background compiler thread is compiling the function.
+  bool in_progress() const { return in_progress_; }
+  void set_in_progress(bool value) { in_progress_ = value; }
+
  private:
   QueueElement* next_;
   RawFunction* function_;
+  const intptr_t priority_;
+  bool in_progress_;
 
   DISALLOW_COPY_AND_ASSIGN(QueueElement);
 };
 
 // Allocated in C-heap. Handles both input and output of background compilation.
-// It implements a FIFO queue, using Peek, Add, Remove operations.
+// It implements a priority queue ordered by decreasing usage counter (FIFO
+// among equal priorities), using Peek, Add, Remove operations. Elements stay
+// in the queue while they are compiled so that concurrent compiler threads
+// and the mutator do not enqueue the same function twice.
 class BackgroundCompilationQueue {
  public:
   BackgroundCompilationQueue() : first_(NULL), last_(NULL) {}
@@ -1661,16 +1790,36 @@ class BackgroundCompilationQueue {
     if (first_ == NULL) {
       first_ = value;
       ASSERT(last_ == NULL);
-    } else {
-      ASSERT(last_ != NULL);
+      last_ = value;
+    } else if (last_->priority() >= value->priority()) {
       last_->set_next(value);
+      last_ = value;
+    } else if (first_->priority() < value->priority()) {
+      value->set_next(first_);
+      first_ = value;
+    } else {
+      QueueElement* prev = first_;
+      while (prev->next()->priority() >= value->priority()) {
+        prev = prev->next();
+      }
+      value->set_next(prev->next());
+      prev->set_next(value);
     }
-    last_ = value;
     ASSERT(first_ != NULL && last_ != NULL);
   }
 
   QueueElement* Peek() const { return first_; }
 
+  // Returns the element with the highest priority which is not being
+  // compiled by another thread.
+  QueueElement* PeekPending() const {
+    QueueElement* p = first_;
+    while ((p != NULL) && p->in_progress()) {
+      p = p->next();
+    }
+    return p;
+  }
+
   RawFunction* PeekFunction() const {
     QueueElement* e = Peek();
     if (e == NULL) {
@@ -1690,6 +1839,25 @@ class BackgroundCompilationQueue {
     return result;
   }
 
+  // Removes the given element, which must be in the queue.
+  void Remove(QueueElement* value) {
+    ASSERT(value != NULL);
+    if (value == first_) {
+      Remove();
+    } else {
+      QueueElement* prev = first_;
+      while (prev->next() != value) {
+        prev = prev->next();
+        ASSERT(prev != NULL);
+      }
+      prev->set_next(value->next());
+      if (last_ == value) {
+        last_ = prev;
+      }
+    }
+    value->set_next(NULL);
+  }
+
   bool ContainsObj(const Object& obj) const {
     QueueElement* p = first_;
     while (p != NULL) {
@@ -1723,6 +1891,7 @@ BackgroundCompiler::BackgroundCompiler(Isolate* isolate)
       done_monitor_(new Monitor()),
       running_(false),
       done_(true),
+      active_threads_(0),
       disabled_depth_(0) {}
 
 // Fields all deleted in ::Stop; here clear them.
@@ -1744,50 +1913,58 @@ void BackgroundCompiler::Run() {
       Zone* zone = stack_zone.GetZone();
       HANDLESCOPE(thread);
       Function& function = Function::Handle(zone);
+      QueueElement* current = NULL;
       {
         MonitorLocker ml(queue_monitor_);
-        function = function_queue()->PeekFunction();
+        current = ClaimNextFunction(&function);
       }
       while (running_ && !function.IsNull() && !isolate_->IsTopLevelParsing()) {
         // Check that we have aggregated and cleared the stats.
         ASSERT(thread->compiler_stats()->IsCleared());
         Compiler::CompileOptimizedFunction(thread, function,
                                            Compiler::kNoOSRDeoptId);
-#ifndef PRODUCT
-        Isolate* isolate = thread->isolate();
-        isolate->aggregate_compiler_stats()->Add(*thread->compiler_stats());
-        thread->compiler_stats()->Clear();
-#endif  // PRODUCT
 
-        QueueElement* qelem = NULL;
         {
           MonitorLocker ml(queue_monitor_);
-          if (function_queue()->IsEmpty()) {
+#ifndef PRODUCT
+          // Other compiler threads aggregate their stats concurrently.
+          Isolate* isolate = thread->isolate();
+          isolate->aggregate_compiler_stats()->Add(*thread->compiler_stats());
+          thread->compiler_stats()->Clear();
+#endif  // PRODUCT
+          if (!running_) {
             // We are shutting down, queue was cleared.
             function = Function::null();
+            current = NULL;
           } else {
-            qelem = function_queue()->Remove();
-            const Function& old = Function::Handle(qelem->Function());
-            if ((!old.HasOptimizedCode() && old.IsOptimizable()) ||
+            function_queue()->Remove(current);
+            delete current;
+            if ((!function.HasOptimizedCode() && function.IsOptimizable()) ||
                 FLAG_stress_test_background_compilation) {
-              if (Compiler::CanOptimizeFunction(thread, old)) {
-                QueueElement* repeat_qelem = new QueueElement(old);
+              if (Compiler::CanOptimizeFunction(thread, function)) {
+                QueueElement* repeat_qelem = new QueueElement(function);
                 function_queue()->Add(repeat_qelem);
               }
             }
-            function = function_queue()->PeekFunction();
+            current = ClaimNextFunction(&function);
           }
         }
-        if (qelem != NULL) {
-          delete qelem;
+      }
+      if (current != NULL) {
+        // Stopped compiling because of top level parsing, leave the claimed
+        // function for the next round.
+        MonitorLocker ml(queue_monitor_);
+        if (running_) {
+          current->set_in_progress(false);
         }
       }
     }
     Thread::ExitIsolateAsHelper();
     {
-      // Wait to be notified when the work queue is not empty.
+      // Wait to be notified when the work queue has pending functions.
       MonitorLocker ml(queue_monitor_);
-      while ((function_queue()->IsEmpty() || isolate_->IsTopLevelParsing()) &&
+      while (((function_queue()->PeekPending() == NULL) ||
+              isolate_->IsTopLevelParsing()) &&
              running_) {
         ml.Wait();
       }
@@ -1795,13 +1972,29 @@ void BackgroundCompiler::Run() {
   }  // while running
 
   {
-    // Notify that the thread is done.
+    // Notify that the thread is done. The background compiler is done when
+    // the last of its threads exits.
     MonitorLocker ml_done(done_monitor_);
-    done_ = true;
-    ml_done.Notify();
+    ASSERT(active_threads_ > 0);
+    if (--active_threads_ == 0) {
+      done_ = true;
+      ml_done.NotifyAll();
+    }
   }
 }
 
+QueueElement* BackgroundCompiler::ClaimNextFunction(Function* function) {
+  ASSERT(queue_monitor_->IsOwnedByCurrentThread());
+  QueueElement* next = function_queue()->PeekPending();
+  if (next == NULL) {
+    *function = Function::null();
+  } else {
+    next->set_in_progress(true);
+    *function = next->Function();
+  }
+  return next;
+}
+
 void BackgroundCompiler::CompileOptimized(const Function& function) {
   ASSERT(Thread::Current()->IsMutatorThread());
   // TODO(srdjan): Checking different strategy for collecting garbage
@@ -1860,9 +2053,19 @@ void BackgroundCompiler::Start() {
   if (running_ || !done_) return;
   running_ = true;
   done_ = false;
-  bool task_started =
-      Dart::thread_pool()->Run(new BackgroundCompilerTask(this));
-  if (!task_started) {
+  ASSERT(active_threads_ == 0);
+  const intptr_t thread_count =
+      Utils::Maximum(static_cast<intptr_t>(FLAG_background_compiler_threads),
+                     static_cast<intptr_t>(1));
+  for (intptr_t i = 0; i < thread_count; i++) {
+    // Count the thread before it starts, it may exit before Run returns.
+    active_threads_++;
+    if (!Dart::thread_pool()->Run(new BackgroundCompilerTask(this))) {
+      active_threads_--;
+      break;
+    }
+  }
+  if (active_threads_ == 0) {
     running_ = false;
     done_ = true;
   }
@@ -1877,7 +2080,7 @@ void BackgroundCompiler::Stop() {
     MonitorLocker ml(queue_monitor_);
     running_ = false;
     function_queue_->Clear();
-    ml.Notify();  // Stop waiting for the queue.
+    ml.NotifyAll();  // Stop waiting for the queue.
   }
 
   {
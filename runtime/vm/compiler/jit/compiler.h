@@ -85,6 +85,11 @@ class Compiler : public AllStatic {
   // The result for a function may change if debugging gets turned on/off.
   static bool CanOptimizeFunction(Thread* thread, const Function& function);
 
+  // Returns true if the function deoptimized so often that it should no
+  // longer be optimized or inlined. Deoptimizations that disabled the failing
+  // speculation are tolerated up to a higher limit.
+  static bool HasExcessiveDeoptimizations(const Function& function);
+
   // Extracts top level entities from the script and populates
   // the class dictionary of the library.
   //
@@ -224,6 +229,10 @@ class BackgroundCompiler {
   bool IsDisabled();
   bool IsRunning() { return !done_; }
 
+  // Marks the highest priority pending function in the queue as being
+  // compiled by the current thread. Must hold queue_monitor_.
+  QueueElement* ClaimNextFunction(Function* function);
+
   Isolate* isolate_;
 
   Monitor* queue_monitor_;  // Controls access to the queue.
@@ -231,7 +240,8 @@ class BackgroundCompiler {
 
   Monitor* done_monitor_;   // Notify/wait that the thread is done.
   bool running_;            // While true, will try to read queue and compile.
-  bool done_;               // True if the thread is done.
+  bool done_;               // True if all threads are done.
+  intptr_t active_threads_;  // Number of compiler threads not yet done.
 
   int16_t disabled_depth_;
 
@@ -27,6 +27,12 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            speculative_closure_calls,
+            true,
+            "Call the closure function seen at a closure call site directly, "
+            "guarded by a function identity check.");
+
 // Quick access to the current isolate and zone.
 #define I (isolate())
 #define Z (zone())
@@ -110,6 +116,9 @@ void JitCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
   if (TryInlineInstanceMethod(instr)) {
     return;
   }
+  if (TrySpecializeClosureCall(instr)) {
+    return;
+  }
 
   const CallTargets& targets = *CallTargets::CreateAndExpand(Z, unary_checks);
 
@@ -170,6 +179,52 @@ void JitCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
   }
 }
 
+// All closures share the same class, so the receiver class check of a 'call'
+// invocation does not identify the callee. If the call site has recorded a
+// closure function, guard on the closure's function and call it directly so
+// that the inliner can inline it. A failing guard records its own deopt reason
+// and the next optimization falls back to the generic closure call.
+bool JitCallSpecializer::TrySpecializeClosureCall(InstanceCallInstr* instr) {
+#if defined(TARGET_ARCH_DBC)
+  return false;
+#else
+  if (!FLAG_speculative_closure_calls ||
+      (instr->function_name().raw() != Symbols::Call().raw())) {
+    return false;
+  }
+  const ICData& ic_data = *instr->ic_data();
+  if (!ic_data.NumberOfChecksIs(1) ||
+      (ic_data.GetReceiverClassIdAt(0) != kClosureCid) ||
+      ic_data.HasDeoptReason(ICData::kDeoptCheckClosureFunction)) {
+    return false;
+  }
+  const Function& target = Function::ZoneHandle(Z, ic_data.closure_target());
+  if (target.IsNull()) {
+    return false;
+  }
+  ArgumentsDescriptor args_desc(
+      Array::Handle(Z, ic_data.arguments_descriptor()));
+  if (!target.AreValidArguments(args_desc, NULL)) {
+    return false;
+  }
+
+  AddReceiverCheck(instr);
+  LoadFieldInstr* load_function = new (Z)
+      LoadFieldInstr(new (Z) Value(instr->Receiver()->definition()),
+                     Closure::function_offset(), Object::dynamic_type(),
+                     instr->token_pos());
+  load_function->set_is_immutable(true);
+  InsertBefore(instr, load_function, NULL, FlowGraph::kValue);
+  InsertBefore(instr,
+               new (Z) CheckFunctionInstr(new (Z) Value(load_function), target,
+                                          instr->deopt_id()),
+               instr->env(), FlowGraph::kEffect);
+  StaticCallInstr* call = StaticCallInstr::FromCall(Z, instr, target);
+  instr->ReplaceWith(call, current_iterator());
+  return true;
+#endif  // defined(TARGET_ARCH_DBC)
+}
+
 void JitCallSpecializer::VisitStoreInstanceField(
     StoreInstanceFieldInstr* instr) {
   if (instr->IsUnboxedStore()) {
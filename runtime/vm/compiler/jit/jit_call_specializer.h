@@ -30,6 +30,8 @@ class JitCallSpecializer : public CallSpecializer {
 
   virtual bool TryOptimizeStaticCallUsingStaticTypes(StaticCallInstr* call);
 
+  bool TrySpecializeClosureCall(InstanceCallInstr* instr);
+
   void LowerContextAllocation(Definition* instr,
                               intptr_t num_context_variables,
                               Value* context_value);
@@ -745,6 +745,30 @@ namespace dart {
 //    InstanceCall ... <- lazy deopt inside first call
 //    InstanceCall ... <- patches second call with Deopt
 //
+// SUPERINSTRUCTIONS
+//
+// The following bytecodes are never emitted by the bytecode generator. They
+// are installed by the VM when bytecode is loaded (see
+// KernelBytecode::InstallSuperinstructions) in place of the first instruction
+// of a common sequence. The rest of the sequence is left in place, so that
+// branches into the middle of the sequence and pc offsets recorded for
+// exception handlers and source positions stay valid.
+//
+//  - ReturnLocal rX
+//
+//    Replaces Push rX; ReturnTOS. Returns FP[rX] to the caller.
+//
+//  - ReturnConstant D
+//
+//    Replaces PushConstant D; ReturnTOS. Returns the value at index D from
+//    the constant pool to the caller.
+//
+//  - PushLocalField rX
+//
+//    Replaces Push rX; LoadFieldTOS D. Pushes the field of FP[rX] at the
+//    offset given by the LoadFieldTOS instruction that follows, then skips
+//    that instruction.
+//
 // BYTECODE LIST FORMAT
 //
 // KernelBytecode list below is specified using the following format:
@@ -965,7 +989,10 @@ namespace dart {
   V(DebugStep,                             0, ___, ___, ___)                   \
   V(DebugBreak,                            A, num, ___, ___)                   \
   V(Deopt,                               A_D, num, num, ___)                   \
-  V(DeoptRewind,                           0, ___, ___, ___)
+  V(DeoptRewind,                           0, ___, ___, ___)                   \
+  V(ReturnLocal,                           X, xeg, ___, ___)                   \
+  V(ReturnConstant,                        D, lit, ___, ___)                   \
+  V(PushLocalField,                        X, xeg, ___, ___)
 
 // clang-format on
 
@@ -1093,6 +1120,32 @@ class KernelBytecode {
 
   static KBCInstr At(uword pc) { return *reinterpret_cast<KBCInstr*>(pc); }
 
+  // Replaces the first instruction of common instruction sequences in the
+  // given bytecode with the corresponding superinstruction. The length of the
+  // bytecode and the offsets of all instructions are not changed.
+  static void InstallSuperinstructions(KBCInstr* instrs, intptr_t count) {
+    for (intptr_t i = 0; i < count - 1; i++) {
+      const KBCInstr instr = instrs[i];
+      const Opcode next = DecodeOpcode(instrs[i + 1]);
+      switch (DecodeOpcode(instr)) {
+        case kPush:
+          if (next == kReturnTOS) {
+            instrs[i] = (instr & ~0xFF) | kReturnLocal;
+          } else if (next == kLoadFieldTOS) {
+            instrs[i] = (instr & ~0xFF) | kPushLocalField;
+          }
+          break;
+        case kPushConstant:
+          if (next == kReturnTOS) {
+            instrs[i] = (instr & ~0xFF) | kReturnConstant;
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
  private:
   DISALLOW_ALLOCATION();
   DISALLOW_IMPLICIT_CONSTRUCTORS(KernelBytecode);
@@ -0,0 +1,52 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/constants_kbc.h"
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+VM_UNIT_TEST_CASE(KernelBytecode_InstallSuperinstructions) {
+  KBCInstr instrs[] = {
+      KernelBytecode::EncodeSigned(KernelBytecode::kPush, -3),
+      KernelBytecode::Encode(KernelBytecode::kLoadFieldTOS, 0, 7),
+      KernelBytecode::EncodeSigned(KernelBytecode::kPush, 2),
+      KernelBytecode::Encode(KernelBytecode::kReturnTOS),
+      KernelBytecode::Encode(KernelBytecode::kPushConstant, 0, 5),
+      KernelBytecode::Encode(KernelBytecode::kReturnTOS),
+      // Not followed by ReturnTOS or LoadFieldTOS.
+      KernelBytecode::EncodeSigned(KernelBytecode::kPush, 1),
+      KernelBytecode::Encode(KernelBytecode::kDrop1),
+      KernelBytecode::Encode(KernelBytecode::kPushConstant, 0, 4),
+      KernelBytecode::Encode(KernelBytecode::kDrop1),
+      // The last instruction has no successor.
+      KernelBytecode::EncodeSigned(KernelBytecode::kPush, 0),
+  };
+  const intptr_t count = ARRAY_SIZE(instrs);
+  KBCInstr original[ARRAY_SIZE(instrs)];
+  memmove(original, instrs, sizeof(instrs));
+
+  KernelBytecode::InstallSuperinstructions(instrs, count);
+
+  // The first instruction of each sequence is replaced, keeping its operand.
+  EXPECT_EQ(KernelBytecode::kPushLocalField,
+            KernelBytecode::DecodeOpcode(instrs[0]));
+  EXPECT_EQ(KernelBytecode::kReturnLocal,
+            KernelBytecode::DecodeOpcode(instrs[2]));
+  EXPECT_EQ(KernelBytecode::kReturnConstant,
+            KernelBytecode::DecodeOpcode(instrs[4]));
+  EXPECT_EQ(original[0] & ~0xFF, instrs[0] & ~0xFF);
+  EXPECT_EQ(original[2] & ~0xFF, instrs[2] & ~0xFF);
+  EXPECT_EQ(5, KernelBytecode::DecodeD(instrs[4]));
+
+  // Everything else is left in place.
+  EXPECT_EQ(original[1], instrs[1]);
+  EXPECT_EQ(original[3], instrs[3]);
+  for (intptr_t i = 5; i < count; i++) {
+    EXPECT_EQ(original[i], instrs[i]);
+  }
+}
+
+}  // namespace dart
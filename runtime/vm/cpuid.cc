@@ -5,11 +5,13 @@
 #include "vm/globals.h"
 #if !defined(HOST_OS_MACOS)
 #include "vm/cpuid.h"
+#include "platform/utils.h"
 
 #if defined(HOST_ARCH_IA32) || defined(HOST_ARCH_X64)
 // GetCpuId() on Windows, __get_cpuid() on Linux
 #if defined(HOST_OS_WINDOWS)
-#include <intrin.h>  // NOLINT
+#include <immintrin.h>  // NOLINT
+#include <intrin.h>     // NOLINT
 #else
 #include <cpuid.h>  // NOLINT
 #endif
@@ -19,6 +21,7 @@ namespace dart {
 
 bool CpuId::sse2_ = false;
 bool CpuId::sse41_ = false;
+bool CpuId::avx_ = false;
 const char* CpuId::id_string_ = NULL;
 const char* CpuId::brand_string_ = NULL;
 
@@ -34,6 +37,18 @@ void CpuId::GetCpuId(int32_t level, uint32_t info[4]) {
 #endif
 }
 
+// Returns the state components enabled by the OS in XCR0. Must only be called
+// when CPUID reports OSXSAVE.
+static uint64_t GetXCR0() {
+#if defined(HOST_OS_WINDOWS)
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
 void CpuId::InitOnce() {
   uint32_t info[4] = {static_cast<uint32_t>(-1)};
 
@@ -48,6 +63,11 @@ void CpuId::InitOnce() {
   GetCpuId(1, info);
   CpuId::sse41_ = (info[2] & (1 << 19)) != 0;
   CpuId::sse2_ = (info[3] & (1 << 26)) != 0;
+  // AVX is only usable if the OS saves the upper halves of the YMM registers
+  // (XCR0 bits 1 and 2) on context switches.
+  const bool osxsave = (info[2] & (1 << 27)) != 0;
+  CpuId::avx_ = ((info[2] & (1 << 28)) != 0) && osxsave &&
+                ((GetXCR0() & 0x6) == 0x6);
 
   char* brand_string =
       reinterpret_cast<char*>(malloc(3 * 4 * sizeof(uint32_t)));
@@ -89,15 +109,11 @@ const char* CpuId::field(CpuInfoIndices idx) {
     case kCpuInfoHardware:
       return brand_string();
     case kCpuInfoFeatures: {
-      if (sse2() && sse41()) {
-        return strdup("sse2 sse4.1");
-      } else if (sse2()) {
-        return strdup("sse2");
-      } else if (sse41()) {
-        return strdup("sse4.1");
-      } else {
-        return strdup("");
-      }
+      char features[32];
+      Utils::SNPrint(features, sizeof(features), "%s%s%s",
+                     sse2() ? "sse2 " : "", sse41() ? "sse4.1 " : "",
+                     avx() ? "avx " : "");
+      return strdup(features);
     }
     default: {
       UNREACHABLE();
@@ -6,6 +6,7 @@
 
 #include "vm/clustered_snapshot.h"
 #include "vm/code_observers.h"
+#include "vm/compiler/compiler_pass.h"
 #include "vm/cpu.h"
 #include "vm/dart_api_state.h"
 #include "vm/dart_entry.h"
@@ -26,6 +27,7 @@
 #include "vm/object_store.h"
 #include "vm/port.h"
 #include "vm/profiler.h"
+#include "vm/regexp_assembler_bytecode.h"
 #include "vm/service_isolate.h"
 #include "vm/simulator.h"
 #include "vm/snapshot.h"
@@ -142,6 +144,7 @@ char* Dart::InitOnce(const uint8_t* vm_isolate_snapshot,
   start_time_micros_ = OS::GetCurrentMonotonicMicros();
   VirtualMemory::InitOnce();
   OSThread::InitOnce();
+  Zone::InitOnce();
   if (FLAG_support_timeline) {
     Timeline::InitOnce();
   }
@@ -150,6 +153,8 @@ char* Dart::InitOnce(const uint8_t* vm_isolate_snapshot,
   Isolate::InitOnce();
   IdleNotifier::InitOnce();
   PortMap::InitOnce();
+  RegExpBytecodeCache::InitOnce();
+  NOT_IN_PRODUCT(NOT_IN_PRECOMPILED(CompilerStatistics::InitOnce()));
   FreeListElement::InitOnce();
   ForwardingCorpse::InitOnce();
   Api::InitOnce();
@@ -465,9 +470,13 @@ const char* Dart::Cleanup() {
   vm_isolate_ = NULL;
   ASSERT(Isolate::IsolateListLength() == 0);
   IdleNotifier::Cleanup();
+  RegExpBytecodeCache::Cleanup();
+  NOT_IN_PRODUCT(NOT_IN_PRECOMPILED(CompilerStatistics::Cleanup()));
 
   TargetCPUFeatures::Cleanup();
   StoreBuffer::ShutDown();
+  SemiSpace::Cleanup();
+  Zone::Cleanup();
 
   // Delete the current thread's TLS and set it's TLS to null.
   // If it is the last thread then the destructor would call
@@ -695,6 +704,9 @@ const char* Dart::FeaturesString(Isolate* isolate,
     ADD_FLAG(sync_async, sync_async, FLAG_sync_async);
     ADD_FLAG(reify_generic_functions, reify_generic_functions,
              FLAG_reify_generic_functions);
+    // The write barrier only supports concurrent marking when asked to.
+    buffer.AddString(FLAG_concurrent_mark ? " concurrent_mark"
+                                          : " no-concurrent_mark");
     if (kind == Snapshot::kFullJIT) {
       ADD_FLAG(use_field_guards, use_field_guards, FLAG_use_field_guards);
       ADD_FLAG(use_osr, use_osr, FLAG_use_osr);
@@ -719,6 +731,8 @@ const char* Dart::FeaturesString(Isolate* isolate,
 #else
     buffer.AddString(" x64-sysv");
 #endif
+    // VEX-encoded instructions fault on CPUs without AVX.
+    buffer.AddString(TargetCPUFeatures::avx_supported() ? " avx" : " no-avx");
 #elif defined(TARGET_ARCH_DBC)
 #if defined(ARCH_IS_32_BIT)
     buffer.AddString(" dbc32");
@@ -29,15 +29,19 @@
 #include "vm/isolate_reload.h"
 #include "vm/kernel_isolate.h"
 #include "vm/lockers.h"
+#include "vm/malloc_hooks.h"
 #include "vm/message.h"
 #include "vm/message_handler.h"
+#include "vm/metrics.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
+#include "vm/object_graph.h"
 #include "vm/object_store.h"
 #include "vm/os.h"
 #include "vm/os_thread.h"
 #include "vm/port.h"
 #include "vm/profiler.h"
+#include "vm/profiler_service.h"
 #include "vm/program_visitor.h"
 #include "vm/resolver.h"
 #include "vm/reusable_handles.h"
@@ -668,6 +672,12 @@ void FinalizablePersistentHandle::Finalize(
   if (!handle->raw()->IsHeapObject()) {
     return;  // Free handle.
   }
+  InvokeFinalizer(isolate, handle);
+}
+
+void FinalizablePersistentHandle::InvokeFinalizer(
+    Isolate* isolate,
+    FinalizablePersistentHandle* handle) {
   Dart_WeakPersistentHandleFinalizer callback = handle->callback();
   ASSERT(callback != NULL);
   void* peer = handle->peer();
@@ -1816,16 +1826,8 @@ DART_EXPORT void Dart_EnterScope() {
   Isolate* isolate = thread->isolate();
   CHECK_ISOLATE(isolate);
   NoSafepointScope no_safepoint_scope;
-  ApiLocalScope* new_scope = thread->api_reusable_scope();
-  if (new_scope == NULL) {
-    new_scope = new ApiLocalScope(thread->api_top_scope(),
-                                  thread->top_exit_frame_info());
-    ASSERT(new_scope != NULL);
-  } else {
-    new_scope->Reinit(thread, thread->api_top_scope(),
-                      thread->top_exit_frame_info());
-    thread->set_api_reusable_scope(NULL);
-  }
+  ApiLocalScope* new_scope = thread->AllocateApiScope(
+      thread->api_top_scope(), thread->top_exit_frame_info());
   thread->set_api_top_scope(new_scope);  // New scope is now the top scope.
 }
 
@@ -1834,15 +1836,8 @@ DART_EXPORT void Dart_ExitScope() {
   CHECK_API_SCOPE(T);
   NoSafepointScope no_safepoint_scope;
   ApiLocalScope* scope = T->api_top_scope();
-  ApiLocalScope* reusable_scope = T->api_reusable_scope();
   T->set_api_top_scope(scope->previous());  // Reset top scope to previous.
-  if (reusable_scope == NULL) {
-    scope->Reset(T);  // Reset the old scope which we just exited.
-    T->set_api_reusable_scope(scope);
-  } else {
-    ASSERT(reusable_scope != scope);
-    delete scope;
-  }
+  T->FreeApiScope(scope);
 }
 
 DART_EXPORT uint8_t* Dart_ScopeAllocate(intptr_t size) {
@@ -3229,6 +3224,67 @@ DART_EXPORT Dart_Handle Dart_MapKeys(Dart_Handle map) {
   return Api::NewError("Object does not implement the 'Map' interface");
 }
 
+DART_EXPORT Dart_Handle Dart_MapGetEntries(Dart_Handle map,
+                                           Dart_Handle* keys,
+                                           Dart_Handle* values,
+                                           intptr_t capacity,
+                                           intptr_t* length) {
+  DARTSCOPE(Thread::Current());
+  if (length == NULL) {
+    RETURN_NULL_ERROR(length);
+  }
+  if ((capacity > 0) && (keys == NULL)) {
+    RETURN_NULL_ERROR(keys);
+  }
+  if ((capacity > 0) && (values == NULL)) {
+    RETURN_NULL_ERROR(values);
+  }
+  const Object& obj = Object::Handle(Z, Api::UnwrapHandle(map));
+  if (obj.IsLinkedHashMap()) {
+    const LinkedHashMap& linked_map = LinkedHashMap::Cast(obj);
+    *length = linked_map.Length();
+    LinkedHashMap::Iterator iterator(linked_map);
+    for (intptr_t i = 0; (i < capacity) && iterator.MoveNext(); i++) {
+      keys[i] = Api::NewHandle(T, iterator.CurrentKey());
+      values[i] = Api::NewHandle(T, iterator.CurrentValue());
+    }
+    return Api::Success();
+  }
+  if (obj.IsError()) {
+    return map;
+  }
+  CHECK_CALLBACK_STATE(T);
+  const Instance& instance = Instance::Handle(Z, GetMapInstance(Z, obj));
+  if (instance.IsNull()) {
+    return Api::NewError("Object does not implement the 'Map' interface");
+  }
+  const Object& iterable = Object::Handle(
+      Z, Send0Arg(instance, String::Handle(Z, String::New("get:keys"))));
+  if (!iterable.IsInstance()) {
+    return Api::NewHandle(T, iterable.raw());
+  }
+  const Object& key_list = Object::Handle(
+      Z, Send0Arg(Instance::Cast(iterable),
+                  String::Handle(Z, String::New("toList"))));
+  if (!key_list.IsGrowableObjectArray()) {
+    return Api::NewHandle(T, key_list.raw());
+  }
+  const GrowableObjectArray& key_array = GrowableObjectArray::Cast(key_list);
+  *length = key_array.Length();
+  Instance& key = Instance::Handle(Z);
+  Object& value = Object::Handle(Z);
+  for (intptr_t i = 0; (i < capacity) && (i < key_array.Length()); i++) {
+    key ^= key_array.At(i);
+    value = Send1Arg(instance, Symbols::IndexToken(), key);
+    if (value.IsError()) {
+      return Api::NewHandle(T, value.raw());
+    }
+    keys[i] = Api::NewHandle(T, key.raw());
+    values[i] = Api::NewHandle(T, value.raw());
+  }
+  return Api::Success();
+}
+
 // --- Typed Data ---
 
 // Helper method to get the type of a TypedData object.
@@ -6160,6 +6216,25 @@ DART_EXPORT Dart_Handle Dart_ServiceSendDataEvent(const char* stream_id,
   return Api::Success();
 }
 
+DART_EXPORT Dart_Handle
+Dart_WritePprofProfile(Dart_PprofProfileKind kind,
+                       Dart_StreamingWriteCallback callback,
+                       void* callback_data) {
+  return Api::NewError("%s is not supported in PRODUCT mode.", CURRENT_FUNC);
+}
+
+DART_EXPORT char* Dart_GetOpenMetrics() {
+  return NULL;
+}
+
+DART_EXPORT void Dart_RecordNativeAllocation(void* ptr, intptr_t size) {
+  return;
+}
+
+DART_EXPORT void Dart_RecordNativeFree(void* ptr) {
+  return;
+}
+
 DART_EXPORT Dart_Handle
 Dart_SetFileModifiedCallback(Dart_FileModifiedCallback file_mod_callback) {
   return Api::Success();
@@ -6280,6 +6355,67 @@ DART_EXPORT Dart_Handle Dart_ServiceSendDataEvent(const char* stream_id,
   return Api::Success();
 }
 
+// Passes each chunk of a pprof profile to the embedder's callback.
+class PprofCallbackChunkedWriter : public ChunkedWriter {
+ public:
+  PprofCallbackChunkedWriter(Dart_StreamingWriteCallback callback,
+                             void* callback_data)
+      : ChunkedWriter(kChunkSize, true /* compress */, true /* gzip */),
+        callback_(callback),
+        callback_data_(callback_data) {}
+
+  virtual void WriteChunk(const uint8_t* data, intptr_t size, bool last) {
+    callback_(callback_data_, data, size);
+  }
+
+ private:
+  static const intptr_t kChunkSize = 64 * KB;
+
+  Dart_StreamingWriteCallback callback_;
+  void* callback_data_;
+};
+
+DART_EXPORT Dart_Handle
+Dart_WritePprofProfile(Dart_PprofProfileKind kind,
+                       Dart_StreamingWriteCallback callback,
+                       void* callback_data) {
+  DARTSCOPE(Thread::Current());
+  CHECK_NULL(callback);
+  ProfilerService::PprofKind pprof_kind;
+  switch (kind) {
+    case Dart_PprofProfile_CPU:
+      pprof_kind = ProfilerService::kPprofCpu;
+      break;
+    case Dart_PprofProfile_Allocation:
+      pprof_kind = ProfilerService::kPprofAllocation;
+      break;
+    case Dart_PprofProfile_Heap:
+      pprof_kind = ProfilerService::kPprofHeap;
+      break;
+    default:
+      return Api::NewError("%s: invalid profile kind %d.", CURRENT_FUNC, kind);
+  }
+  PprofCallbackChunkedWriter writer(callback, callback_data);
+  if (!ProfilerService::WritePprof(T, pprof_kind, &writer, -1, -1)) {
+    return Api::NewError("%s: the profiler is disabled.", CURRENT_FUNC);
+  }
+  return Api::Success();
+}
+
+DART_EXPORT char* Dart_GetOpenMetrics() {
+  TextBuffer buffer(4 * KB);
+  Metric::PrintOpenMetrics(&buffer);
+  return buffer.Steal();
+}
+
+DART_EXPORT void Dart_RecordNativeAllocation(void* ptr, intptr_t size) {
+  MallocHooks::RecordAllocation(ptr, size);
+}
+
+DART_EXPORT void Dart_RecordNativeFree(void* ptr) {
+  MallocHooks::RecordFree(ptr);
+}
+
 DART_EXPORT Dart_Handle
 Dart_SetFileModifiedCallback(Dart_FileModifiedCallback file_modified_callback) {
   if (!FLAG_support_service) {
@@ -6568,6 +6704,42 @@ Dart_Handle Dart_LoadCompilationTrace(uint8_t* buffer, intptr_t buffer_length) {
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 }
 
+DART_EXPORT
+Dart_Handle Dart_SaveTypeFeedback(uint8_t** buffer, intptr_t* buffer_length) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  return Api::NewError("%s: Cannot compile on an AOT runtime.", CURRENT_FUNC);
+#else
+  Thread* thread = Thread::Current();
+  API_TIMELINE_DURATION(thread);
+  DARTSCOPE(thread);
+  CHECK_NULL(buffer);
+  CHECK_NULL(buffer_length);
+  TypeFeedbackSaver saver(thread->zone());
+  ProgramVisitor::VisitFunctions(&saver);
+  saver.StealBuffer(buffer, buffer_length);
+  return Api::Success();
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
+DART_EXPORT
+Dart_Handle Dart_LoadTypeFeedback(uint8_t* buffer, intptr_t buffer_length) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  return Api::NewError("%s: Cannot compile on an AOT runtime.", CURRENT_FUNC);
+#else
+  Thread* thread = Thread::Current();
+  API_TIMELINE_DURATION(thread);
+  DARTSCOPE(thread);
+  CHECK_NULL(buffer);
+  TypeFeedbackLoader loader(thread);
+  const Object& error =
+      Object::Handle(loader.LoadFeedback(buffer, buffer_length));
+  if (error.IsError()) {
+    return Api::NewHandle(T, Error::Cast(error).raw());
+  }
+  return Api::Success();
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
 DART_EXPORT Dart_Handle Dart_SortClasses() {
 #if defined(DART_PRECOMPILED_RUNTIME)
   return Api::NewError("%s: Cannot compile on an AOT runtime.", CURRENT_FUNC);
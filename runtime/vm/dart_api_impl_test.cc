@@ -1373,6 +1373,15 @@ class GCTestHelper : public AllStatic {
     Isolate::Current()->heap()->new_space()->Scavenge();
   }
 
+  // Scavenges, then runs the finalizers of the weak persistent handles found
+  // unreachable, as the mutator does after a scavenge.
+  static void CollectNewSpaceAndRunFinalizers() {
+    Thread* thread = Thread::Current();
+    Heap* heap = thread->isolate()->heap();
+    heap->new_space()->Scavenge();
+    heap->RunPendingFinalizers(thread, false);
+  }
+
   static void WaitForGCTasks() {
     Thread* thread = Thread::Current();
     PageSpace* old_space = thread->isolate()->heap()->old_space();
@@ -1737,6 +1746,26 @@ TEST_CASE(DartAPI_MapAccess) {
   EXPECT(equals);
 
   EXPECT(Dart_IsError(Dart_MapKeys(a)));
+
+  // Get all entries at once.
+  Dart_Handle entry_keys[2];
+  Dart_Handle entry_values[2];
+  len = 0;
+  EXPECT_VALID(Dart_MapGetEntries(map, NULL, NULL, 0, &len));
+  EXPECT_EQ(2, len);
+  EXPECT_VALID(Dart_MapGetEntries(map, entry_keys, entry_values, 2, &len));
+  EXPECT_EQ(2, len);
+  equals = false;
+  EXPECT_VALID(Dart_ObjectEquals(entry_keys[0], a, &equals));
+  EXPECT(equals);
+  EXPECT_VALID(Dart_IntegerToInt64(entry_values[0], &value));
+  EXPECT_EQ(1, value);
+  equals = false;
+  EXPECT_VALID(Dart_ObjectEquals(entry_keys[1], b, &equals));
+  EXPECT(equals);
+  EXPECT(Dart_IsNull(entry_values[1]));
+
+  EXPECT(Dart_IsError(Dart_MapGetEntries(a, NULL, NULL, 0, &len)));
 }
 
 TEST_CASE(DartAPI_IsFuture) {
@@ -2622,6 +2651,49 @@ TEST_CASE(DartAPI_SlowFinalizer) {
   EXPECT_EQ(20, count);
 }
 
+static void CountingFinalizer(void* isolate_callback_data,
+                              Dart_WeakPersistentHandle handle,
+                              void* peer) {
+  intptr_t* count = reinterpret_cast<intptr_t*>(peer);
+  (*count)++;
+}
+
+TEST_CASE(DartAPI_ParallelWeakHandleProcessing) {
+  const intptr_t saved_scavenger_tasks = FLAG_scavenger_tasks;
+  FLAG_scavenger_tasks = 2;
+  // Enough handles to fill several blocks, so that every task gets some.
+  const intptr_t kNumHandles = 3 * kFinalizablePersistentHandlesPerChunk;
+  intptr_t count = 0;
+  Dart_EnterScope();
+  for (intptr_t i = 0; i < kNumHandles; i++) {
+    Dart_Handle str = Dart_NewStringFromCString("Die young");
+    Dart_NewWeakPersistentHandle(str, &count, 0, CountingFinalizer);
+  }
+  Dart_ExitScope();
+  {
+    TransitionNativeToVM transition(thread);
+    Isolate::Current()->heap()->CollectGarbage(Heap::kNew);
+    // The finalizers ran once the scavenge was over.
+    EXPECT_EQ(kNumHandles, count);
+  }
+
+  count = 0;
+  {
+    TransitionNativeToVM transition(thread);
+    {
+      StackZone zone(thread);
+      for (intptr_t i = 0; i < kNumHandles; i++) {
+        const String& str = String::Handle(String::New("Die old", Heap::kOld));
+        FinalizablePersistentHandle::New(thread->isolate(), str, &count,
+                                         CountingFinalizer, 0);
+      }
+    }
+    Isolate::Current()->heap()->CollectGarbage(Heap::kOld);
+    EXPECT_EQ(kNumHandles, count);
+  }
+  FLAG_scavenger_tasks = saved_scavenger_tasks;
+}
+
 static void CheckFloat32x4Data(Dart_Handle obj) {
   void* raw_data = NULL;
   intptr_t len;
@@ -2934,7 +3006,7 @@ TEST_CASE(DartAPI_WeakPersistentHandle) {
   {
     TransitionNativeToVM transition(thread);
     // Garbage collect new space again.
-    GCTestHelper::CollectNewSpace();
+    GCTestHelper::CollectNewSpaceAndRunFinalizers();
     GCTestHelper::WaitForGCTasks();
   }
 
@@ -3013,7 +3085,7 @@ TEST_CASE(DartAPI_WeakPersistentHandleCallback) {
     TransitionNativeToVM transition(thread);
     Isolate::Current()->heap()->CollectGarbage(Heap::kOld);
     EXPECT(peer == 0);
-    GCTestHelper::CollectNewSpace();
+    GCTestHelper::CollectNewSpaceAndRunFinalizers();
     GCTestHelper::WaitForGCTasks();
     EXPECT(peer == 42);
   }
@@ -3039,7 +3111,7 @@ TEST_CASE(DartAPI_WeakPersistentHandleNoCallback) {
     TransitionNativeToVM transition(thread);
     Isolate::Current()->heap()->CollectGarbage(Heap::kOld);
     EXPECT(peer == 0);
-    GCTestHelper::CollectNewSpace();
+    GCTestHelper::CollectNewSpaceAndRunFinalizers();
     GCTestHelper::WaitForGCTasks();
     EXPECT(peer == 0);
   }
@@ -9126,4 +9198,123 @@ TEST_CASE(DartAPI_InvokeImportedFunction) {
 
 #endif  // !PRODUCT
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+
+static const char* kTypeFeedbackScript =
+    "class A {\n"
+    "  final int f;\n"
+    "  A(this.f);\n"
+    "  int get twice => f * 2;\n"
+    "}\n"
+    "hot(A a) => a.twice + 1;\n"
+    "main() {\n"
+    "  for (int i = 0; i < 100; i++) hot(new A(i));\n"
+    "}\n";
+
+// Returns whether the type feedback has a function record for 'name' that
+// says it was optimized.
+static bool TypeFeedbackHasOptimized(const uint8_t* buffer,
+                                     intptr_t length,
+                                     const char* name) {
+  char* text = reinterpret_cast<char*>(malloc(length + 1));
+  memmove(text, buffer, length);
+  text[length] = '\0';
+  char pattern[64];
+  Utils::SNPrint(pattern, sizeof(pattern), ",%s,", name);
+  bool optimized = false;
+  for (char* line = strtok(text, "\n"); line != NULL;
+       line = strtok(NULL, "\n")) {
+    if ((line[0] == 'U') && (strstr(line, pattern) != NULL)) {
+      optimized = (line[strlen(line) - 1] == '1');
+    }
+  }
+  free(text);
+  return optimized;
+}
+
+VM_UNIT_TEST_CASE(DartAPI_TypeFeedbackRoundTrip) {
+  const int saved_threshold = FLAG_optimization_counter_threshold;
+  const bool saved_background_compilation = FLAG_background_compilation;
+  FLAG_optimization_counter_threshold = 10;
+  FLAG_background_compilation = false;
+
+  // Collect and save feedback in one isolate.
+  uint8_t* feedback = NULL;
+  intptr_t feedback_length = 0;
+  TestCase::CreateTestIsolate();
+  {
+    Dart_EnterScope();
+    Dart_Handle lib = TestCase::LoadTestScript(kTypeFeedbackScript, NULL);
+    EXPECT_VALID(lib);
+    EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+    uint8_t* buffer = NULL;
+    intptr_t length = 0;
+    EXPECT_VALID(Dart_SaveTypeFeedback(&buffer, &length));
+    EXPECT(TypeFeedbackHasOptimized(buffer, length, "hot"));
+    // The buffer is scope allocated.
+    feedback = reinterpret_cast<uint8_t*>(malloc(length));
+    memmove(feedback, buffer, length);
+    feedback_length = length;
+    Dart_ExitScope();
+  }
+  Dart_ShutdownIsolate();
+
+  // Loading it into a fresh isolate optimizes the same function before any
+  // code runs.
+  FLAG_optimization_counter_threshold = saved_threshold;
+  TestCase::CreateTestIsolate();
+  {
+    Dart_EnterScope();
+    Dart_Handle lib = TestCase::LoadTestScript(kTypeFeedbackScript, NULL);
+    EXPECT_VALID(lib);
+    EXPECT_VALID(Dart_LoadTypeFeedback(feedback, feedback_length));
+    uint8_t* buffer = NULL;
+    intptr_t length = 0;
+    EXPECT_VALID(Dart_SaveTypeFeedback(&buffer, &length));
+    EXPECT(TypeFeedbackHasOptimized(buffer, length, "hot"));
+    EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+    Dart_ExitScope();
+  }
+  Dart_ShutdownIsolate();
+  free(feedback);
+
+  FLAG_background_compilation = saved_background_compilation;
+}
+
+TEST_CASE(DartAPI_TypeFeedbackErrors) {
+  Dart_Handle lib = TestCase::LoadTestScript(kTypeFeedbackScript, NULL);
+  EXPECT_VALID(lib);
+
+  uint8_t* buffer = NULL;
+  intptr_t length = 0;
+  EXPECT_ERROR(Dart_SaveTypeFeedback(NULL, &length),
+               "Dart_SaveTypeFeedback expects argument 'buffer' to be "
+               "non-null.");
+  EXPECT_ERROR(Dart_SaveTypeFeedback(&buffer, NULL),
+               "Dart_SaveTypeFeedback expects argument 'buffer_length' to be "
+               "non-null.");
+  EXPECT_ERROR(Dart_LoadTypeFeedback(NULL, 0),
+               "Dart_LoadTypeFeedback expects argument 'buffer' to be "
+               "non-null.");
+
+  // Feedback in another format, e.g. a compilation trace, is rejected.
+  uint8_t trace[] = "file:///test-lib,,main\n";
+  EXPECT_ERROR(Dart_LoadTypeFeedback(trace, sizeof(trace) - 1),
+               "Invalid or incompatible type feedback");
+  uint8_t truncated[] = "# type feedback";
+  EXPECT_ERROR(Dart_LoadTypeFeedback(truncated, sizeof(truncated) - 1),
+               "Invalid or incompatible type feedback");
+
+  // Records which don't match the program are ignored.
+  uint8_t stale[] =
+      "# type feedback v1\n"
+      "C,0,file:///no-such-lib,A\n"
+      "U,0,hot,1000,1\n"
+      "X,unknown record\n";
+  EXPECT_VALID(Dart_LoadTypeFeedback(stale, sizeof(stale) - 1));
+  EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+}
+
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 }  // namespace dart
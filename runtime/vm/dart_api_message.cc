@@ -20,9 +20,20 @@ ApiMessageReader::ApiMessageReader(Message* msg)
       backward_references_(kNumInitialReferences),
       vm_isolate_references_(kNumInitialReferences),
       vm_symbol_references_(NULL),
-      finalizable_data_(msg->finalizable_data()) {}
-
-ApiMessageReader::~ApiMessageReader() {}
+      finalizable_data_(msg->finalizable_data()),
+      external_typed_data_(0) {}
+
+ApiMessageReader::~ApiMessageReader() {
+  for (intptr_t i = 0; i < external_typed_data_.length(); i++) {
+    Dart_CObject* object = external_typed_data_[i];
+    ASSERT(object->type == Dart_CObject_kExternalTypedData);
+    Dart_WeakPersistentHandleFinalizer callback =
+        object->value.as_external_typed_data.callback;
+    if (callback != NULL) {
+      callback(NULL, NULL, object->value.as_external_typed_data.peer);
+    }
+  }
+}
 
 void ApiMessageReader::Init() {
   // We need to have an enclosing ApiNativeScope.
@@ -165,6 +176,34 @@ Dart_CObject* ApiMessageReader::AllocateDartCObjectTypedData(
   return value;
 }
 
+Dart_CObject* ApiMessageReader::AllocateDartCObjectTypedData(
+    Dart_TypedData_Type type,
+    intptr_t length,
+    uint8_t* values) {
+  Dart_CObject* value = AllocateDartCObject(Dart_CObject_kTypedData);
+  value->value.as_typed_data.type = type;
+  value->value.as_typed_data.length = GetTypedDataSizeInBytes(type) * length;
+  value->value.as_typed_data.values = values;
+  return value;
+}
+
+Dart_CObject* ApiMessageReader::AllocateDartCObjectExternalTypedData(
+    Dart_TypedData_Type type,
+    intptr_t length) {
+  FinalizableData finalizable_data = finalizable_data_->Take();
+  Dart_CObject* value = AllocateDartCObject(Dart_CObject_kExternalTypedData);
+  // The length is in bytes, as for Dart_CObject_kTypedData.
+  value->value.as_external_typed_data.type = type;
+  value->value.as_external_typed_data.length =
+      GetTypedDataSizeInBytes(type) * length;
+  value->value.as_external_typed_data.data =
+      reinterpret_cast<uint8_t*>(finalizable_data.data);
+  value->value.as_external_typed_data.peer = finalizable_data.peer;
+  value->value.as_external_typed_data.callback = finalizable_data.callback;
+  external_typed_data_.Add(value);
+  return value;
+}
+
 Dart_CObject* ApiMessageReader::AllocateDartCObjectArray(intptr_t length) {
   // Allocate a Dart_CObject structure followed by an array of
   // pointers to Dart_CObject structures. The pointer to the array
@@ -319,9 +358,11 @@ Dart_CObject* ApiMessageReader::ReadInlinedObject(intptr_t object_id) {
         object->internal.as_view.length = ReadSmiValue();
 
         // The buffer is fully read now as typed data objects are
-        // serialized in-line.
+        // serialized in-line. An external buffer stays alive until the
+        // reader is destroyed, as the receiver cannot take it over.
         Dart_CObject* buffer = object->internal.as_view.buffer;
-        ASSERT(buffer->type == Dart_CObject_kTypedData);
+        ASSERT((buffer->type == Dart_CObject_kTypedData) ||
+               (buffer->type == Dart_CObject_kExternalTypedData));
 
         // Now turn the view into a byte array.
         object->type = Dart_CObject_kTypedData;
@@ -583,6 +624,28 @@ Dart_CObject* ApiMessageReader::ReadInternalVMObject(intptr_t class_id,
       ASSERT(p == (object->value.as_string + utf8_len));
       return object;
     }
+    case kExternalOneByteStringCid: {
+      // Large strings are passed out of line, and their buffers may be
+      // shared with other messages and isolates.
+      intptr_t len = ReadSmiValue();
+      FinalizableData finalizable_data = finalizable_data_->Take();
+      const uint8_t* latin1 =
+          reinterpret_cast<const uint8_t*>(finalizable_data.data);
+      intptr_t utf8_len = 0;
+      for (intptr_t i = 0; i < len; i++) {
+        utf8_len += Utf8::Length(latin1[i]);
+      }
+      Dart_CObject* object = AllocateDartCObjectString(utf8_len);
+      AddBackRef(object_id, object, kIsDeserialized);
+      char* p = object->value.as_string;
+      for (intptr_t i = 0; i < len; i++) {
+        p += Utf8::Encode(latin1[i], p);
+      }
+      *p = '\0';
+      ASSERT(p == (object->value.as_string + utf8_len));
+      finalizable_data.callback(NULL, NULL, finalizable_data.peer);
+      return object;
+    }
     case kTwoByteStringCid: {
       intptr_t len = ReadSmiValue();
       uint16_t* utf16 =
@@ -632,29 +695,31 @@ Dart_CObject* ApiMessageReader::ReadInternalVMObject(intptr_t class_id,
       return object;
     }
 
-#define READ_TYPED_DATA_HEADER(type)                                           \
-  intptr_t len = ReadSmiValue();                                               \
-  Dart_CObject* object =                                                       \
-      AllocateDartCObjectTypedData(Dart_TypedData_k##type, len);               \
-  AddBackRef(object_id, object, kIsDeserialized);
-
+// The contents of typed data are referenced in place in the message buffer
+// when suitably aligned for the element type, and copied otherwise.
 #define READ_TYPED_DATA(type, ctype)                                           \
   {                                                                            \
-    READ_TYPED_DATA_HEADER(type);                                              \
-    uint8_t* p =                                                               \
-        reinterpret_cast<uint8_t*>(object->value.as_typed_data.values);        \
-    ReadBytes(p, len * sizeof(ctype));                                         \
+    intptr_t len = ReadSmiValue();                                             \
+    uint8_t* p = const_cast<uint8_t*>(CurrentBufferAddress());                 \
+    Dart_CObject* object;                                                      \
+    if ((len > 0) &&                                                           \
+        Utils::IsAligned(reinterpret_cast<uword>(p), sizeof(ctype))) {         \
+      object = AllocateDartCObjectTypedData(Dart_TypedData_k##type, len, p);   \
+      Advance(len * sizeof(ctype));                                            \
+    } else {                                                                   \
+      object = AllocateDartCObjectTypedData(Dart_TypedData_k##type, len);      \
+      ReadBytes(object->value.as_typed_data.values, len * sizeof(ctype));      \
+    }                                                                          \
+    AddBackRef(object_id, object, kIsDeserialized);                            \
     return object;                                                             \
   }
 
 #define READ_EXTERNAL_TYPED_DATA(type, ctype)                                  \
   {                                                                            \
-    READ_TYPED_DATA_HEADER(type);                                              \
-    uint8_t* p =                                                               \
-        reinterpret_cast<uint8_t*>(object->value.as_typed_data.values);        \
-    FinalizableData finalizable_data = finalizable_data_->Take();              \
-    memmove(p, finalizable_data.data, len * sizeof(ctype));                    \
-    finalizable_data.callback(NULL, NULL, finalizable_data.peer);              \
+    intptr_t len = ReadSmiValue();                                             \
+    Dart_CObject* object =                                                     \
+        AllocateDartCObjectExternalTypedData(Dart_TypedData_k##type, len);     \
+    AddBackRef(object_id, object, kIsDeserialized);                            \
     return object;                                                             \
   }
 
@@ -713,6 +778,17 @@ Dart_CObject* ApiMessageReader::ReadInternalVMObject(intptr_t class_id,
     case kExternalTypedDataFloat64ArrayCid:
       READ_EXTERNAL_TYPED_DATA(Float64, double);
 
+    case kTransferableTypedDataCid: {
+      // The contents were moved out of line into the message. They are
+      // received as external Uint8 data, like the contents of a
+      // TransferableTypedData materialized by the receiving isolate.
+      intptr_t length = Read<int64_t>();
+      Dart_CObject* object =
+          AllocateDartCObjectExternalTypedData(Dart_TypedData_kUint8, length);
+      AddBackRef(object_id, object, kIsDeserialized);
+      return object;
+    }
+
     case kGrowableObjectArrayCid: {
       // A GrowableObjectArray is serialized as its type arguments and
       // length followed by its backing store. The backing store is an
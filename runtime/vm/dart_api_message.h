@@ -47,6 +47,12 @@ class ApiMessageReader : public BaseReader {
   // The ApiMessageReader object must be enclosed by an ApiNativeScope.
   // Allocation of all C Heap objects is done in the zone associated with
   // the enclosing ApiNativeScope.
+  //
+  // Typed data in the Dart_CObject graph is not copied: it refers either to
+  // the message buffer or, for external typed data, to the external buffer
+  // itself. The graph is therefore only valid while the message is alive.
+  // External buffers whose finalizer callback has not been cleared by the
+  // receiver are finalized when the reader is destroyed.
   explicit ApiMessageReader(Message* message);
   ~ApiMessageReader();
 
@@ -91,6 +97,15 @@ class ApiMessageReader : public BaseReader {
   // Allocates a C Dart_CObject object for a typed data.
   Dart_CObject* AllocateDartCObjectTypedData(Dart_TypedData_Type type,
                                              intptr_t length);
+  // Allocates a C Dart_CObject object for a typed data whose contents are
+  // at 'values' in the message buffer.
+  Dart_CObject* AllocateDartCObjectTypedData(Dart_TypedData_Type type,
+                                             intptr_t length,
+                                             uint8_t* values);
+  // Allocates a C Dart_CObject object for an external typed data, taking
+  // over the next finalizable data of the message.
+  Dart_CObject* AllocateDartCObjectExternalTypedData(Dart_TypedData_Type type,
+                                                     intptr_t length);
   // Allocates a C array of Dart_CObject objects.
   Dart_CObject* AllocateDartCObjectArray(intptr_t length);
   // Allocate a C Dart_CObject object for a VM isolate object.
@@ -148,6 +163,9 @@ class ApiMessageReader : public BaseReader {
   Dart_CObject dynamic_type_marker;
 
   MessageFinalizableData* finalizable_data_;
+  // External typed data handed out to the receiver, finalized on destruction
+  // unless the receiver took ownership by clearing the callback.
+  ApiGrowableArray<Dart_CObject*> external_typed_data_;
 
   static _Dart_CObject* singleton_uint32_typed_data_;
 };
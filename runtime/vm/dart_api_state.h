@@ -14,6 +14,7 @@
 #include "vm/growable_array.h"
 #include "vm/handles.h"
 #include "vm/heap/weak_table.h"
+#include "vm/lockers.h"
 #include "vm/object.h"
 #include "vm/os.h"
 #include "vm/os_thread.h"
@@ -227,6 +228,18 @@ class FinalizablePersistentHandle {
     Finalize(isolate, this);
   }
 
+  // Called instead of UpdateUnreachable by a GC, which leaves running the
+  // finalizer to ApiState::RunPendingFinalizers. The referent is replaced by a
+  // Smi, like that of a free handle, so that any GC in between ignores it.
+  void PrepareFinalization(Isolate* isolate) {
+    EnsureFreeExternal(isolate);
+    raw_ = Smi::New(0);
+  }
+
+  // Runs the finalizer and frees the handle.
+  static void InvokeFinalizer(Isolate* isolate,
+                              FinalizablePersistentHandle* handle);
+
   // Called when the referent has moved, potentially between generations.
   void UpdateRelocated(Isolate* isolate) {
     if (IsSetNewSpaceBit() && (SpaceForExternal() == Heap::kOld)) {
@@ -508,6 +521,17 @@ class FinalizablePersistentHandles
             kOffsetOfRawPtrInFinalizablePersistentHandle>::Visit(visitor);
   }
 
+  // Visit one of num_slices parts of the handles.
+  void VisitHandles(HandleVisitor* visitor,
+                    intptr_t slice_index,
+                    intptr_t num_slices) {
+    Handles<kFinalizablePersistentHandleSizeInWords,
+            kFinalizablePersistentHandlesPerChunk,
+            kOffsetOfRawPtrInFinalizablePersistentHandle>::Visit(visitor,
+                                                                 slice_index,
+                                                                 num_slices);
+  }
+
   // Visit all object pointers stored in the various handles.
   void VisitObjectPointers(ObjectPointerVisitor* visitor) {
     Handles<kFinalizablePersistentHandleSizeInWords,
@@ -715,6 +739,50 @@ class ApiState {
     weak_persistent_handles().VisitHandles(visitor);
   }
 
+  void VisitWeakHandles(HandleVisitor* visitor,
+                        intptr_t slice_index,
+                        intptr_t num_slices) {
+    weak_persistent_handles().VisitHandles(visitor, slice_index, num_slices);
+  }
+
+  // Queues the weak persistent handles a GC found unreachable and prepared for
+  // finalization. Thread-safe: the GC tasks visiting the handles in parallel
+  // each add their own batch.
+  void AddPendingFinalizers(
+      const MallocGrowableArray<FinalizablePersistentHandle*>& handles) {
+    if (handles.is_empty()) {
+      return;
+    }
+    MutexLocker ml(&pending_finalizers_mutex_);
+    pending_finalizers_.AddArray(handles);
+  }
+
+  // Runs the finalizers queued by AddPendingFinalizers. The callbacks may
+  // cause further finalizers to be queued, which are run as well.
+  void RunPendingFinalizers(Isolate* isolate) {
+    while (true) {
+      FinalizablePersistentHandle** handles;
+      intptr_t length;
+      {
+        MutexLocker ml(&pending_finalizers_mutex_);
+        pending_finalizers_.StealBuffer(&handles, &length);
+      }
+      if (length == 0) {
+        free(handles);
+        return;
+      }
+      for (intptr_t i = 0; i < length; i++) {
+        FinalizablePersistentHandle::InvokeFinalizer(isolate, handles[i]);
+      }
+      free(handles);
+    }
+  }
+
+  bool HasPendingFinalizers() {
+    MutexLocker ml(&pending_finalizers_mutex_);
+    return !pending_finalizers_.is_empty();
+  }
+
   bool IsValidPersistentHandle(Dart_PersistentHandle object) const {
     return persistent_handles_.IsValidHandle(object);
   }
@@ -769,6 +837,8 @@ class ApiState {
   PersistentHandles persistent_handles_;
   FinalizablePersistentHandles weak_persistent_handles_;
   WeakTable acquired_table_;
+  Mutex pending_finalizers_mutex_;
+  MallocGrowableArray<FinalizablePersistentHandle*> pending_finalizers_;
 
   // Persistent handles to important objects.
   PersistentHandle* null_;
@@ -644,6 +644,39 @@ RawObject* DartLibraryCalls::HandleMessage(const Object& handler,
   return result.raw();
 }
 
+RawObject* DartLibraryCalls::HandleMessages(Dart_Port port_id,
+                                            const Instance& dart_message,
+                                            intptr_t max_count) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  Isolate* isolate = thread->isolate();
+  Function& function = Function::Handle(
+      zone, isolate->object_store()->handle_messages_function());
+  const int kTypeArgsLen = 0;
+  const int kNumArguments = 3;
+  if (function.IsNull()) {
+    Library& isolate_lib = Library::Handle(zone, Library::IsolateLibrary());
+    ASSERT(!isolate_lib.IsNull());
+    const String& class_name = String::Handle(
+        zone, isolate_lib.PrivateName(Symbols::_RawReceivePortImpl()));
+    const String& function_name = String::Handle(
+        zone, isolate_lib.PrivateName(Symbols::_handleMessages()));
+    function = Resolver::ResolveStatic(isolate_lib, class_name, function_name,
+                                       kTypeArgsLen, kNumArguments,
+                                       Object::empty_array());
+    ASSERT(!function.IsNull());
+    isolate->object_store()->set_handle_messages_function(function);
+  }
+  const Array& args = Array::Handle(zone, Array::New(kNumArguments));
+  args.SetAt(0, Integer::Handle(zone, Integer::New(port_id)));
+  args.SetAt(1, dart_message);
+  args.SetAt(2, Smi::Handle(zone, Smi::New(max_count)));
+  const Object& result =
+      Object::Handle(zone, DartEntry::InvokeFunction(function, args));
+  ASSERT(result.IsNull() || result.IsError());
+  return result.raw();
+}
+
 RawObject* DartLibraryCalls::DrainMicrotaskQueue() {
   Zone* zone = Thread::Current()->zone();
   Library& isolate_lib = Library::Handle(zone, Library::IsolateLibrary());
@@ -206,6 +206,13 @@ class DartLibraryCalls : public AllStatic {
   static RawObject* HandleMessage(const Object& handler,
                                   const Instance& dart_message);
 
+  // Dispatches the message for port_id and then, in the same Dart entry, up
+  // to max_count - 1 further messages that are already queued.
+  // Returns null on success, a RawError on failure.
+  static RawObject* HandleMessages(Dart_Port port_id,
+                                   const Instance& dart_message,
+                                   intptr_t max_count);
+
   // Returns null on success, a RawError on failure.
   static RawObject* DrainMicrotaskQueue();
 
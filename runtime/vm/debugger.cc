@@ -851,6 +851,11 @@ bool ActivationFrame::HandlesException(const Instance& exc_obj) {
     // Only consider user written handlers for async methods.
     if (!is_async || !handlers.IsGenerated(try_index)) {
       handled_types = handlers.GetHandledTypes(try_index);
+      if (handled_types.IsNull()) {
+        // The handled types were dropped from the snapshot; assume the
+        // exception may be caught here.
+        return true;
+      }
       const intptr_t num_types = handled_types.Length();
       for (intptr_t k = 0; k < num_types; k++) {
         type ^= handled_types.At(k);
@@ -1825,10 +1830,89 @@ RawFunction* Debugger::ResolveFunction(const Library& library,
   return function.raw();
 }
 
+// Returns true if the optimized 'code' belongs to or has inlined one of
+// 'functions'.
+static bool CodeInlinesAnyOf(const Code& code,
+                             const GrowableObjectArray& functions) {
+  Zone* zone = Thread::Current()->zone();
+  const Array& inlined = Array::Handle(zone, code.inlined_id_to_function());
+  Object& function = Object::Handle(zone, code.function());
+  const intptr_t num_inlined = inlined.IsNull() ? 0 : inlined.Length();
+  for (intptr_t i = -1; i < num_inlined; i++) {
+    if (i >= 0) {
+      function = inlined.At(i);
+    }
+    for (intptr_t j = 0; j < functions.Length(); j++) {
+      if (function.raw() == functions.At(j)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void SwitchToUnoptimizedCodeIfInlines(
+    const Function& function,
+    const GrowableObjectArray& functions) {
+  if (function.HasOptimizedCode() &&
+      CodeInlinesAnyOf(Code::Handle(function.CurrentCode()), functions)) {
+    function.SwitchToUnoptimizedCode();
+  }
+}
+
+// Deoptimizes the optimized code of 'functions' and all optimized code that
+// inlined one of them, including its activations on the stack. Breakpoints
+// in 'functions' are then reached; other optimized code keeps running. The
+// compiler neither optimizes nor inlines functions with breakpoints.
+void Debugger::DeoptimizeFunctions(const GrowableObjectArray& functions) {
+  BackgroundCompiler::Stop(isolate_);
+  Code& code = Code::Handle();
+  DartFrameIterator iterator(Thread::Current(),
+                             StackFrameIterator::kNoCrossThreadIteration);
+  for (StackFrame* frame = iterator.NextFrame(); frame != NULL;
+       frame = iterator.NextFrame()) {
+    code = frame->LookupDartCode();
+    if (code.is_optimized() && CodeInlinesAnyOf(code, functions)) {
+      DeoptimizeAt(code, frame);
+    }
+  }
+
+  // Any function may have inlined one of 'functions', so all optimized code
+  // is checked. Only the code that did is deoptimized.
+  const ClassTable& class_table = *isolate_->class_table();
+  Class& cls = Class::Handle();
+  Array& class_functions = Array::Handle();
+  GrowableObjectArray& closures = GrowableObjectArray::Handle();
+  Function& function = Function::Handle();
+  intptr_t num_classes = class_table.NumCids();
+  for (intptr_t i = 1; i < num_classes; i++) {
+    if (class_table.HasValidClassAt(i)) {
+      cls = class_table.At(i);
+      class_functions = cls.functions();
+      if (!class_functions.IsNull()) {
+        intptr_t num_functions = class_functions.Length();
+        for (intptr_t pos = 0; pos < num_functions; pos++) {
+          function ^= class_functions.At(pos);
+          ASSERT(!function.IsNull());
+          SwitchToUnoptimizedCodeIfInlines(function, functions);
+          if (function.HasImplicitClosureFunction()) {
+            function = function.ImplicitClosureFunction();
+            SwitchToUnoptimizedCodeIfInlines(function, functions);
+          }
+        }
+      }
+    }
+  }
+  closures = isolate_->object_store()->closure_functions();
+  const intptr_t num_closures = closures.Length();
+  for (intptr_t pos = 0; pos < num_closures; pos++) {
+    function ^= closures.At(pos);
+    ASSERT(!function.IsNull());
+    SwitchToUnoptimizedCodeIfInlines(function, functions);
+  }
+}
+
 // Deoptimize all functions in the isolate.
-// TODO(hausner): Actually we only need to deoptimize those functions
-// that inline the function that contains the newly created breakpoint.
-// We currently don't have this info so we deoptimize all functions.
 void Debugger::DeoptimizeWorld() {
   BackgroundCompiler::Stop(isolate_);
   DeoptimizeFunctionsOnStack();
@@ -1878,6 +1962,20 @@ void Debugger::DeoptimizeWorld() {
   }
 }
 
+// Single stepping only stops in unoptimized code. Stepping over or out of a
+// frame continues in the frames already on the stack, so only these are
+// deoptimized. Stepping into a call may reach any function, e.g. a callback
+// invoked by optimized library code or a tear-off called through a
+// megamorphic cache, so everything is deoptimized.
+void Debugger::DeoptimizeForStepping(bool step_into) {
+  if (step_into) {
+    DeoptimizeWorld();
+    return;
+  }
+  BackgroundCompiler::Stop(isolate_);
+  DeoptimizeFunctionsOnStack();
+}
+
 ActivationFrame* Debugger::CollectDartFrame(Isolate* isolate,
                                             uword pc,
                                             StackFrame* frame,
@@ -2879,7 +2977,7 @@ BreakpointLocation* Debugger::SetBreakpoint(const Script& script,
     if (functions.Length() > 0) {
       // One or more function object containing this breakpoint location
       // have already been compiled. We can resolve the breakpoint now.
-      DeoptimizeWorld();
+      DeoptimizeFunctions(functions);
       func ^= functions.At(0);
       TokenPosition breakpoint_pos = ResolveBreakpointPos(
           func, token_pos, last_token_pos, requested_column);
@@ -3390,7 +3488,7 @@ void Debugger::Pause(ServiceEvent* event) {
 
 void Debugger::EnterSingleStepMode() {
   ResetSteppingFramePointers();
-  DeoptimizeWorld();
+  DeoptimizeForStepping(true);
   isolate_->set_single_step(true);
 }
 
@@ -3444,7 +3542,7 @@ void Debugger::HandleSteppingRequest(DebuggerStackTrace* stack_trace,
     // the isolate has been interrupted, but can happen in other cases
     // as well.  We need to deoptimize the world in case we are about
     // to call an optimized function.
-    DeoptimizeWorld();
+    DeoptimizeForStepping(true);
     isolate_->set_single_step(true);
     skip_next_step_ = skip_next_step;
     SetAsyncSteppingFramePointer();
@@ -3452,7 +3550,7 @@ void Debugger::HandleSteppingRequest(DebuggerStackTrace* stack_trace,
       OS::PrintErr("HandleSteppingRequest- kStepInto\n");
     }
   } else if (resume_action_ == kStepOver) {
-    DeoptimizeWorld();
+    DeoptimizeForStepping(false);
     isolate_->set_single_step(true);
     skip_next_step_ = skip_next_step;
     ASSERT(stack_trace->Length() > 0);
@@ -3477,7 +3575,7 @@ void Debugger::HandleSteppingRequest(DebuggerStackTrace* stack_trace,
       }
     }
     // Fall through to synchronous stepping.
-    DeoptimizeWorld();
+    DeoptimizeForStepping(false);
     isolate_->set_single_step(true);
     // Find topmost caller that is debuggable.
     for (intptr_t i = 1; i < stack_trace->Length(); i++) {
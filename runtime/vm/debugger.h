@@ -659,7 +659,9 @@ class Debugger {
                                      TokenPosition requested_token_pos,
                                      TokenPosition last_token_pos,
                                      intptr_t requested_column);
+  void DeoptimizeFunctions(const GrowableObjectArray& functions);
   void DeoptimizeWorld();
+  void DeoptimizeForStepping(bool step_into);
   BreakpointLocation* SetBreakpoint(const Script& script,
                                     TokenPosition token_pos,
                                     TokenPosition last_token_pos,
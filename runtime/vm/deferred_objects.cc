@@ -130,6 +130,10 @@ void DeferredRetAddr::Materialize(DeoptContext* deopt_context) {
     ICData& ic_data = ICData::Handle(zone);
     CodePatcher::GetInstanceCallAt(pc, code, &ic_data);
     if (!ic_data.IsNull()) {
+      if ((deopt_context->deopt_reason() <= ICData::kLastRecordedDeoptReason) &&
+          !ic_data.HasDeoptReason(deopt_context->deopt_reason())) {
+        deopt_context->set_speculation_disabled();
+      }
       ic_data.AddDeoptReason(deopt_context->deopt_reason());
       // Propagate the reason to all ICData-s with same deopt_id since
       // only unoptimized-code ICData (IC calls) are propagated.
@@ -137,13 +141,17 @@ void DeferredRetAddr::Materialize(DeoptContext* deopt_context) {
                                     deopt_context->deopt_reason());
     }
   } else {
-    if (deopt_context->HasDeoptFlag(ICData::kHoisted)) {
+    if (deopt_context->HasDeoptFlag(ICData::kHoisted) &&
+        !function.ProhibitsHoistingCheckClass()) {
       // Prevent excessive deoptimization.
       function.SetProhibitsHoistingCheckClass(true);
+      deopt_context->set_speculation_disabled();
     }
 
-    if (deopt_context->HasDeoptFlag(ICData::kGeneralized)) {
+    if (deopt_context->HasDeoptFlag(ICData::kGeneralized) &&
+        !function.ProhibitsBoundsCheckGeneralization()) {
       function.SetProhibitsBoundsCheckGeneralization(true);
+      deopt_context->set_speculation_disabled();
     }
   }
 }
@@ -47,6 +47,7 @@ DeoptContext::DeoptContext(const StackFrame* frame,
       num_args_(0),
       deopt_reason_(ICData::kDeoptUnknown),
       deopt_flags_(0),
+      speculation_disabled_(false),
       thread_(Thread::Current()),
       deopt_start_micros_(0),
       deferred_slots_(NULL),
@@ -394,6 +395,18 @@ intptr_t DeoptContext::MaterializeDeferredObjects() {
   // can references each other.
   FillDeferredSlots(this, &deferred_slots_);
 
+  // Deoptimizations that disabled the failing speculation do not count
+  // towards giving up on optimizing the function altogether.
+  if (deoptimizing_code_ && speculation_disabled_) {
+    const Function& function =
+        Function::Handle(zone(), Code::Handle(zone(), code_).function());
+    if (function.adapted_deoptimization_counter() <
+        function.deoptimization_counter()) {
+      function.set_adapted_deoptimization_counter(
+          function.adapted_deoptimization_counter() + 1);
+    }
+  }
+
   // Compute total number of artificial arguments used during deoptimization.
   intptr_t deopt_arg_count = 0;
   for (intptr_t i = 0; i < DeferredObjectsCount(); i++) {
@@ -160,6 +160,11 @@ class DeoptContext {
     return (deopt_flags_ & flag) != 0;
   }
 
+  // True if materializing the frames recorded the failed speculation in the
+  // type feedback (or function state bits) so that reoptimization avoids it.
+  bool speculation_disabled() const { return speculation_disabled_; }
+  void set_speculation_disabled() { speculation_disabled_ = true; }
+
   RawTypedData* deopt_info() const { return deopt_info_; }
 
   // Fills the destination frame but defers materialization of
@@ -272,6 +277,7 @@ class DeoptContext {
   intptr_t num_args_;
   ICData::DeoptReasonId deopt_reason_;
   uint32_t deopt_flags_;
+  bool speculation_disabled_;
   intptr_t caller_fp_;
   Thread* thread_;
   int64_t deopt_start_micros_;
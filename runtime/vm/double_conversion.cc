@@ -50,6 +50,45 @@ void DoubleToCString(double d, char* buffer, int buffer_size) {
   ASSERT(result == buffer);
 }
 
+// Writes an integral double with magnitude below 2^53 as its integer digits
+// followed by ".0" and returns the number of characters written. At that
+// magnitude the exact integer is also the shortest representation.
+static intptr_t IntegralDoubleToCString(double d, char* buffer) {
+  intptr_t length = 0;
+  if (signbit(d)) {
+    buffer[length++] = '-';  // Includes -0.0.
+    d = -d;
+  }
+  uint64_t value = static_cast<uint64_t>(d);
+  char digits[16];
+  intptr_t digit_count = 0;
+  do {
+    digits[digit_count++] = '0' + (value % 10);
+    value /= 10;
+  } while (value != 0);
+  while (digit_count > 0) {
+    buffer[length++] = digits[--digit_count];
+  }
+  buffer[length++] = '.';
+  buffer[length++] = '0';
+  return length;
+}
+
+RawString* DoubleToString(double d, Heap::Space space) {
+  static const double kMaxExactIntegral = 9007199254740992.0;  // 2^53.
+  const int kBufferSize = 32;
+  char buffer[kBufferSize];
+  intptr_t length;
+  if ((-kMaxExactIntegral < d) && (d < kMaxExactIntegral) && (d == trunc(d))) {
+    length = IntegralDoubleToCString(d, buffer);
+  } else {
+    DoubleToCString(d, buffer, kBufferSize);
+    length = strlen(buffer);
+  }
+  return OneByteString::New(reinterpret_cast<const uint8_t*>(buffer), length,
+                            space);
+}
+
 RawString* DoubleToStringAsFixed(double d, int fraction_digits) {
   static const int kMinFractionDigits = 0;
   static const int kMaxFractionDigits = 20;
@@ -11,6 +11,7 @@
 namespace dart {
 
 void DoubleToCString(double d, char* buffer, int buffer_size);
+RawString* DoubleToString(double d, Heap::Space space);
 RawString* DoubleToStringAsFixed(double d, int fraction_digits);
 RawString* DoubleToStringAsExponential(double d, int fraction_digits);
 RawString* DoubleToStringAsPrecision(double d, int precision);
@@ -161,7 +161,10 @@ class ExceptionHandlerFinder : public StackResource {
   // Iterate through the stack frames and try to find a frame with an
   // exception handler. Once found, set the pc, sp and fp so that execution
   // can continue in that frame. Sets 'needs_stacktrace' if there is no
-  // cath-all handler or if a stack-trace is specified in the catch.
+  // cath-all handler or if a stack-trace is specified in the catch. Sets
+  // 'handler_needs_stacktrace' if the stack-trace is specified in the catch
+  // of the first handler and 'handler_frame_count' to the number of Dart
+  // frames up to and including the frame of that handler.
   bool Find() {
     StackFrameIterator frames(ValidationPolicy::kDontValidateFrames,
                               Thread::Current(),
@@ -170,6 +173,9 @@ class ExceptionHandlerFinder : public StackResource {
     if (frame == NULL) return false;  // No Dart frame.
     handler_pc_set_ = false;
     needs_stacktrace = false;
+    handler_needs_stacktrace = false;
+    handler_frame_count = 0;
+    intptr_t dart_frame_count = 0;
     bool is_catch_all = false;
     uword temp_handler_pc = kUwordMax;
     bool is_optimized = false;
@@ -178,11 +184,14 @@ class ExceptionHandlerFinder : public StackResource {
 
     while (!frame->IsEntryFrame()) {
       if (frame->IsDartFrame()) {
+        dart_frame_count++;
         if (frame->FindExceptionHandler(thread_, &temp_handler_pc,
                                         &needs_stacktrace, &is_catch_all,
                                         &is_optimized)) {
           if (!handler_pc_set_) {
             handler_pc_set_ = true;
+            handler_needs_stacktrace = needs_stacktrace;
+            handler_frame_count = dart_frame_count;
             handler_pc = temp_handler_pc;
             handler_sp = frame->sp();
             handler_fp = frame->fp();
@@ -324,6 +333,8 @@ class ExceptionHandlerFinder : public StackResource {
 #endif  // defined(DART_PRECOMPILED_RUNTIME) || defined(DART_PRECOMPILER)
 
   bool needs_stacktrace;
+  bool handler_needs_stacktrace;
+  intptr_t handler_frame_count;
   uword handler_pc;
   uword handler_sp;
   uword handler_fp;
@@ -588,6 +599,13 @@ static void ThrowExceptionHelper(Thread* thread,
       // a rethrow being called without an existing stacktrace.)
       ASSERT(is_rethrow);
       stacktrace = existing_stacktrace.raw();
+      if (stacktrace.IsStackTrace() &&
+          StackTrace::Cast(stacktrace).is_partial()) {
+        // Rethrown from the handler the partial trace was thrown to, e.g. when
+        // none of its catch clauses matched.
+        stacktrace =
+            CompleteStackTraceForException(StackTrace::Cast(stacktrace));
+      }
     } else {
       // Get stacktrace field of class Error to determine whether we have a
       // subclass of Error which carries around its stack trace.
@@ -596,7 +614,17 @@ static void ThrowExceptionHelper(Thread* thread,
       if (!stacktrace_field.IsNull() || handler_needs_stacktrace) {
         // Collect the stacktrace if needed.
         ASSERT(existing_stacktrace.IsNull());
-        stacktrace = Exceptions::CurrentStackTrace();
+        if (stacktrace_field.IsNull() && handler_exists &&
+            !finder.handler_needs_stacktrace &&
+            !FLAG_print_stacktrace_at_throw) {
+          // The first handler does not use the stack trace but may not catch
+          // the exception. Only capture the frames unwound by jumping to it;
+          // the rest are still on the stack if the handler rethrows.
+          stacktrace =
+              GetPartialStackTraceForException(finder.handler_frame_count);
+        } else {
+          stacktrace = Exceptions::CurrentStackTrace();
+        }
         // If we have an Error object, then set its stackTrace field only if it
         // not yet initialized.
         if (!stacktrace_field.IsNull() &&
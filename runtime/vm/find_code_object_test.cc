@@ -146,6 +146,11 @@ ISOLATE_UNIT_TEST_CASE(FindCodeObject) {
   EXPECT(code.Size() > (1 * MB));
   pc = code.PayloadStart() + (1 * MB);
   EXPECT(Code::LookupCode(pc) == code.raw());
+
+  // Code may move, so the lookup table is rebuilt after an old space GC.
+  Isolate::Current()->heap()->CollectAllGarbage();
+  pc = code.PayloadStart() + 16;
+  EXPECT(Code::LookupCode(pc) == code.raw());
 }
 
 }  // namespace dart
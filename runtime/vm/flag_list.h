@@ -56,12 +56,19 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Run optimizing compilation in background")                                \
   R(background_compilation_stop_alot, false, bool, false,                      \
     "Stress test system: stop background compiler often.")                     \
+  P(background_compiler_threads, int, 1,                                       \
+    "Number of background optimizing compiler threads per isolate.")           \
+  P(become_tasks, int, 2,                                                      \
+    "The number of tasks to use for forwarding pointers in become (0 means "   \
+    "forward on the main thread).")                                            \
   P(causal_async_stacks, bool, !USING_PRODUCT, "Improved async stacks")        \
   P(collect_code, bool, true, "Attempt to GC infrequently used code.")         \
   P(collect_dynamic_function_names, bool, true,                                \
     "Collects all dynamic function names to identify unique targets")          \
   P(compactor_tasks, int, 2,                                                   \
     "The number of tasks to use for parallel compaction.")                     \
+  P(concurrent_mark, bool, false,                                              \
+    "Concurrent mark for old generation (x64 only).")                          \
   P(concurrent_sweep, bool, USING_MULTICORE,                                   \
     "Concurrent sweep for old generation.")                                    \
   R(dedup_instructions, true, bool, false,                                     \
@@ -70,6 +77,9 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Deoptimizes we are about to return to Dart code from native entries.")    \
   C(deoptimize_every, 0, 0, int, 0,                                            \
     "Deoptimize on every N stack overflow checks")                             \
+  P(deserialization_tasks, int, USING_MULTICORE ? 2 : 0,                       \
+    "The number of tasks to use for filling objects when reading a full "      \
+    "snapshot (0 means fill on the main thread).")                             \
   R(disable_alloc_stubs_after_gc, false, bool, false, "Stress testing flag.")  \
   R(disassemble, false, bool, false, "Disassemble dart code.")                 \
   R(disassemble_optimized, false, bool, false, "Disassemble optimized code.")  \
@@ -104,8 +114,13 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Consider thread pool isolates for idle tasks after this long.")           \
   P(idle_duration_micros, int, 500 * kMicrosecondsPerMillisecond,              \
     "Allow idle tasks to run for this long.")                                  \
+  P(idle_gc_slices, bool, true,                                                \
+    "Spend idle time too short for a whole collection on a bounded slice of "  \
+    "incremental GC work.")                                                    \
   P(interpret_irregexp, bool, USING_DBC, "Use irregexp bytecode interpreter")  \
   P(lazy_dispatchers, bool, true, "Generate dispatchers lazily")               \
+  P(lazy_sweep, bool, false,                                                   \
+    "Sweep old generation data pages on demand when allocating.")              \
   P(link_natives_lazily, bool, false, "Link native calls lazily")              \
   C(load_deferred_eagerly, true, true, bool, false,                            \
     "Load deferred libraries eagerly.")                                        \
@@ -122,8 +137,14 @@ constexpr bool kDartPrecompiledRuntime = false;
     "Max size of new gen semi space in MB")                                    \
   P(new_gen_semi_initial_size, int, (kWordSize <= 4) ? 1 : 2,                  \
     "Initial size of new gen semi space in MB")                                \
+  P(numa_aware_heap, bool, false,                                              \
+    "Place heap memory and GC helper threads on the NUMA node of the thread "  \
+    "running the isolate's message handler.")                                  \
   P(optimization_counter_threshold, int, 30000,                                \
     "Function's usage-counter value before it is optimized, -1 means never")   \
+  C(optimized_coverage, false, false, bool, false,                             \
+    "Make optimized code record which blocks run, so that coverage is "        \
+    "collected without keeping code unoptimized.")                             \
   P(old_gen_heap_size, int, kDefaultMaxOldGenHeapSize,                         \
     "Max size of old gen heap size in MB, or 0 for unlimited,"                 \
     "e.g: --old_gen_heap_size=1024 allows up to 1024MB old gen heap")          \
@@ -156,6 +177,9 @@ constexpr bool kDartPrecompiledRuntime = false;
   P(reify_generic_functions, bool, false,                                      \
     "Enable reification of generic functions (not yet supported).")            \
   P(reorder_basic_blocks, bool, true, "Reorder basic blocks")                  \
+  P(scavenger_tasks, int, 0,                                                   \
+    "The number of tasks to spawn during scavenging (0 means scavenge on the " \
+    "main thread).")                                                           \
   C(stress_async_stacks, false, false, bool, false,                            \
     "Stress test async stack traces")                                          \
   P(strong, bool, false, "Enable strong mode.")                                \
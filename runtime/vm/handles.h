@@ -101,6 +101,10 @@ class Handles {
   // Visit all of the various handles.
   void Visit(HandleVisitor* visitor);
 
+  // Visit every num_slices-th block of handles, starting at slice_index, so
+  // that several threads can split the visit between them.
+  void Visit(HandleVisitor* visitor, intptr_t slice_index, intptr_t num_slices);
+
   // Reset the handles so that we can reuse.
   void Reset();
 
@@ -57,6 +57,32 @@ void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::Visit(
   } while (block != NULL);
 }
 
+template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
+void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::Visit(
+    HandleVisitor* visitor,
+    intptr_t slice_index,
+    intptr_t num_slices) {
+  ASSERT((0 <= slice_index) && (slice_index < num_slices));
+  intptr_t index = 0;
+  // Visit the zone handles in this slice.
+  HandlesBlock* block = zone_blocks_;
+  while (block != NULL) {
+    if ((index++ % num_slices) == slice_index) {
+      block->Visit(visitor);
+    }
+    block = block->next_block();
+  }
+
+  // Visit the scoped handles in this slice.
+  block = &first_scoped_block_;
+  do {
+    if ((index++ % num_slices) == slice_index) {
+      block->Visit(visitor);
+    }
+    block = block->next_block();
+  } while (block != NULL);
+}
+
 template <int kHandleSizeInWords, int kHandlesPerChunk, int kOffsetOfRawPtr>
 void Handles<kHandleSizeInWords, kHandlesPerChunk, kOffsetOfRawPtr>::Reset() {
   // Delete all the extra zone handle blocks allocated and reinit the first
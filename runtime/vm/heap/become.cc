@@ -7,11 +7,16 @@
 #include "platform/assert.h"
 #include "platform/utils.h"
 
+#include "vm/dart.h"
 #include "vm/dart_api_state.h"
+#include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
 #include "vm/isolate_reload.h"
 #include "vm/object.h"
+#include "vm/object_id_ring.h"
 #include "vm/raw_object.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
 
@@ -141,6 +146,76 @@ class ForwardHeapPointersHandleVisitor : public HandleVisitor {
   DISALLOW_COPY_AND_ASSIGN(ForwardHeapPointersHandleVisitor);
 };
 
+// Forwarding is split into units claimed from a shared counter: one for each
+// old space page, then new space, the weak persistent handles and the object
+// id ring. None of them depends on the others being forwarded first.
+static void ForwardUnits(Thread* thread,
+                         const MallocGrowableArray<HeapPage*>& pages,
+                         intptr_t* next_unit) {
+  Isolate* isolate = thread->isolate();
+  ForwardPointersVisitor pointer_visitor(thread);
+  ForwardHeapPointersVisitor object_visitor(&pointer_visitor);
+  ForwardHeapPointersHandleVisitor handle_visitor(thread);
+  const intptr_t num_pages = pages.length();
+  while (true) {
+    const intptr_t unit = AtomicOperations::FetchAndIncrement(next_unit);
+    if (unit < num_pages) {
+      pages[unit]->VisitObjects(&object_visitor);
+    } else if (unit == num_pages) {
+      isolate->heap()->new_space()->VisitObjects(&object_visitor);
+    } else if (unit == num_pages + 1) {
+      isolate->VisitWeakPersistentHandles(&handle_visitor);
+    } else if (unit == num_pages + 2) {
+#ifndef PRODUCT
+      if (FLAG_support_service) {
+        ObjectIdRing* ring = isolate->object_id_ring();
+        ASSERT(ring != NULL);
+        ring->VisitPointers(&pointer_visitor);
+      }
+#endif  // !PRODUCT
+    } else {
+      break;
+    }
+    pointer_visitor.VisitingObject(NULL);
+  }
+}
+
+class ForwardingTask : public ThreadPool::Task {
+ public:
+  ForwardingTask(Isolate* isolate,
+                 ThreadBarrier* barrier,
+                 const MallocGrowableArray<HeapPage*>* pages,
+                 intptr_t* next_unit)
+      : isolate_(isolate),
+        barrier_(barrier),
+        pages_(pages),
+        next_unit_(next_unit) {}
+
+  virtual void Run() {
+    // The main thread holds a safepoint for the whole become.
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kBecomeTask, true);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardingTask");
+      ForwardUnits(thread, *pages_, next_unit_);
+    }
+    // Flushes the store buffer block holding the objects this task found
+    // remembered.
+    Thread::ExitIsolateAsHelper(true);
+    barrier_->Exit();
+  }
+
+ private:
+  Isolate* isolate_;
+  ThreadBarrier* barrier_;
+  const MallocGrowableArray<HeapPage*>* pages_;
+  intptr_t* next_unit_;
+
+  DISALLOW_COPY_AND_ASSIGN(ForwardingTask);
+};
+
 // On IA32, object pointers are embedded directly in the instruction stream,
 // which is normally write-protected, so we need to make it temporarily writable
 // to forward the pointers. On all other architectures, object pointers are
@@ -249,10 +324,27 @@ void Become::ElementsForwardIdentity(const Array& before, const Array& after) {
       FATAL("become: No indirect chains of forwarding");
     }
 
+#if !defined(HASH_IN_OBJECT_HEADER)
+    // Read before forwarding: the corpse no longer has before's class.
+    RawObject** before_slot = Object::IdentityHashSlot(before_obj);
+    RawObject* before_hash =
+        (before_slot != NULL) ? *before_slot : Object::null();
+#endif
+
     ForwardObjectTo(before_obj, after_obj);
     heap->ForwardWeakEntries(before_obj, after_obj);
 #if defined(HASH_IN_OBJECT_HEADER)
     Object::SetCachedHash(after_obj, Object::GetCachedHash(before_obj));
+#else
+    if (before_hash->IsSmi()) {
+      RawObject** after_slot = Object::IdentityHashSlot(after_obj);
+      if (after_slot != NULL) {
+        *after_slot = before_hash;
+      } else {
+        heap->SetHash(after_obj,
+                      Smi::Value(reinterpret_cast<RawSmi*>(before_hash)));
+      }
+    }
 #endif
   }
 
@@ -275,30 +367,28 @@ void Become::FollowForwardingPointers(Thread* thread) {
   isolate->PrepareForGC();  // Have all threads flush their store buffers.
   isolate->store_buffer()->Reset();  // Drop all store buffers.
 
-  ForwardPointersVisitor pointer_visitor(thread);
-
   {
-    // Heap pointers.
+    // Heap pointers, weak persistent handles and the object id ring, split
+    // among the tasks and this thread.
     WritableCodeLiteralsScope writable_code(heap);
-    ForwardHeapPointersVisitor object_visitor(&pointer_visitor);
-    heap->VisitObjects(&object_visitor);
-    pointer_visitor.VisitingObject(NULL);
+    MallocGrowableArray<HeapPage*> pages;
+    heap->old_space()->AddPagesTo(&pages);
+    intptr_t next_unit = 0;
+    const intptr_t num_tasks = FLAG_become_tasks;
+    ThreadBarrier barrier(num_tasks + 1, heap->barrier(), heap->barrier_done());
+    for (intptr_t i = 0; i < num_tasks; i++) {
+      Dart::thread_pool()->Run(
+          new ForwardingTask(isolate, &barrier, &pages, &next_unit));
+    }
+    ForwardUnits(thread, pages, &next_unit);
+    barrier.Exit();
+    // The barrier's destructor waits for the tasks to leave the isolate.
   }
 
   // C++ pointers.
+  ForwardPointersVisitor pointer_visitor(thread);
   isolate->VisitObjectPointers(&pointer_visitor,
                                ValidationPolicy::kValidateFrames);
-#ifndef PRODUCT
-  if (FLAG_support_service) {
-    ObjectIdRing* ring = isolate->object_id_ring();
-    ASSERT(ring != NULL);
-    ring->VisitPointers(&pointer_visitor);
-  }
-#endif  // !PRODUCT
-
-  // Weak persistent handles.
-  ForwardHeapPointersHandleVisitor handle_visitor(thread);
-  isolate->VisitWeakPersistentHandles(&handle_visitor);
 }
 
 }  // namespace dart
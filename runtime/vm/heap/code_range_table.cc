@@ -0,0 +1,113 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/code_range_table.h"
+
+#include "vm/heap/heap.h"
+#include "vm/lockers.h"
+#include "vm/object.h"
+#include "vm/raw_object.h"
+#include "vm/visitor.h"
+
+namespace dart {
+
+class CodeRangeCollector : public ObjectVisitor {
+ public:
+  explicit CodeRangeCollector(MallocGrowableArray<CodeRangeTable::Entry>* out)
+      : out_(out) {}
+
+  void VisitObject(RawObject* obj) {
+    if (obj->IsCode()) {
+      RawCode* code = reinterpret_cast<RawCode*>(obj);
+      if (Code::InstructionsOf(code) != Instructions::null()) {
+        out_->Add(CodeRangeTable::EntryFor(code));
+      }
+    }
+  }
+
+ private:
+  MallocGrowableArray<CodeRangeTable::Entry>* out_;
+};
+
+CodeRangeTable::CodeRangeTable(Heap* heap)
+    : heap_(heap), mutex_(), valid_(false), entries_() {}
+
+CodeRangeTable::Entry CodeRangeTable::EntryFor(RawCode* code) {
+  RawInstructions* instructions = Code::InstructionsOf(code);
+  Entry entry;
+  entry.start = Instructions::PayloadStart(instructions);
+  entry.end = entry.start + Instructions::Size(instructions);
+  entry.code = code;
+  return entry;
+}
+
+int CodeRangeTable::CompareEntries(const Entry* a, const Entry* b) {
+  if (a->start < b->start) {
+    return -1;
+  }
+  return (a->start > b->start) ? 1 : 0;
+}
+
+intptr_t CodeRangeTable::IndexBefore(uword pc) const {
+  intptr_t lo = 0;
+  intptr_t hi = entries_.length();
+  while (lo < hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    if (entries_[mid].start <= pc) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo - 1;
+}
+
+RawCode* CodeRangeTable::LookupLocked(uword pc) const {
+  const intptr_t index = IndexBefore(pc);
+  if ((index >= 0) && (pc < entries_[index].end)) {
+    return entries_[index].code;
+  }
+  return Code::null();
+}
+
+RawCode* CodeRangeTable::Lookup(uword pc) {
+  {
+    MutexLocker ml(&mutex_);
+    if (valid_) {
+      return LookupLocked(pc);
+    }
+  }
+  // The heap is walked without holding the lock: the iteration scope stops
+  // the other threads at a safepoint, and a compiler thread waiting for the
+  // lock would never get there.
+  MallocGrowableArray<Entry> entries;
+  HeapIterationScope iteration(Thread::Current());
+  CodeRangeCollector collector(&entries);
+  heap_->old_space()->VisitObjects(&collector);
+  entries.Sort(CompareEntries);
+  MutexLocker ml(&mutex_);
+  entries_.Clear();
+  for (intptr_t i = 0; i < entries.length(); i++) {
+    entries_.Add(entries[i]);
+  }
+  valid_ = true;
+  return LookupLocked(pc);
+}
+
+void CodeRangeTable::Add(RawCode* code) {
+  MutexLocker ml(&mutex_);
+  if (!valid_) {
+    return;
+  }
+  const Entry entry = EntryFor(code);
+  entries_.InsertAt(IndexBefore(entry.start) + 1, entry);
+}
+
+void CodeRangeTable::Clear() {
+  MutexLocker ml(&mutex_);
+  valid_ = false;
+  entries_.Clear();
+}
+
+}  // namespace dart
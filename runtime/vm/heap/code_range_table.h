@@ -0,0 +1,67 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_CODE_RANGE_TABLE_H_
+#define RUNTIME_VM_HEAP_CODE_RANGE_TABLE_H_
+
+#include "platform/growable_array.h"
+#include "vm/allocation.h"
+#include "vm/globals.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+class Heap;
+class RawCode;
+
+// Maps pcs to the Code objects of a heap whose instructions contain them.
+//
+// Stack walks read the Code of a frame from its pc marker, but a bare pc, as
+// given to Code::LookupCode, can only be resolved by searching the heap for
+// it. The table does that search once: the first lookup walks the old space
+// and records the instructions range of every Code object, sorted by start,
+// and later lookups binary search it. Code installed afterwards is added as
+// it is finalized. The table is dropped whenever an old space GC may have
+// freed or moved Code objects, and rebuilt by the next lookup.
+class CodeRangeTable {
+ public:
+  explicit CodeRangeTable(Heap* heap);
+
+  // Must not be called at a safepoint or from a GC, as (re)building the
+  // table walks the heap.
+  RawCode* Lookup(uword pc);
+
+  // Called when code gets its instructions. May be called from a background
+  // compiler thread.
+  void Add(RawCode* code);
+
+  void Clear();
+
+ private:
+  struct Entry {
+    uword start;
+    uword end;
+    RawCode* code;
+  };
+
+  static Entry EntryFor(RawCode* code);
+  static int CompareEntries(const Entry* a, const Entry* b);
+
+  // Returns the index of the last entry starting at or before pc, or -1.
+  intptr_t IndexBefore(uword pc) const;
+  RawCode* LookupLocked(uword pc) const;
+
+  Heap* heap_;
+  Mutex mutex_;
+  bool valid_;
+  MallocGrowableArray<Entry> entries_;
+
+  friend class CodeRangeCollector;
+
+  DISALLOW_COPY_AND_ASSIGN(CodeRangeTable);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_CODE_RANGE_TABLE_H_
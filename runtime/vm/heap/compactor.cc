@@ -139,6 +139,7 @@ class CompactorTask : public ThreadPool::Task {
   uword PlanBlock(uword first_object, ForwardingPage* forwarding_page);
   uword SlideBlock(uword first_object, ForwardingPage* forwarding_page);
   void PlanMoveToContiguousSize(intptr_t size);
+  void FreeRemaining(uword addr, intptr_t size);
 
   Isolate* isolate_;
   GCCompactor* compactor_;
@@ -163,6 +164,23 @@ class CompactorTask : public ThreadPool::Task {
 void GCCompactor::Compact(HeapPage* pages,
                           FreeList* freelist,
                           Mutex* pages_lock) {
+  HeapPage* tail = CompactPages(pages, freelist, pages_lock);
+  MutexLocker ml(pages_lock);
+  heap_->old_space()->pages_tail_ = tail;
+}
+
+HeapPage* GCCompactor::CompactSelected(HeapPage* pages,
+                                       HeapPage* unevacuated_pages,
+                                       Mutex* pages_lock) {
+  ASSERT(pages != NULL);
+  selective_ = true;
+  unevacuated_pages_ = unevacuated_pages;
+  return CompactPages(pages, NULL, pages_lock);
+}
+
+HeapPage* GCCompactor::CompactPages(HeapPage* pages,
+                                    FreeList* freelist,
+                                    Mutex* pages_lock) {
   SetupImagePageBoundaries();
 
   // Divide the heap.
@@ -230,6 +248,7 @@ void GCCompactor::Compact(HeapPage* pages,
     ForwardStackPointers();
   }
 
+  HeapPage* tail;
   {
     MutexLocker ml(pages_lock);
 
@@ -241,7 +260,7 @@ void GCCompactor::Compact(HeapPage* pages,
         heap_->old_space()->IncreaseCapacityInWordsLocked(
             -(page->memory_->size() >> kWordSizeLog2));
         page->FreeForwardingPage();
-        page->Deallocate();
+        heap_->old_space()->DeallocatePageLocked(page);
         page = next;
       }
     }
@@ -251,7 +270,7 @@ void GCCompactor::Compact(HeapPage* pages,
       tails[task_index]->set_next(heads[task_index + 1]);
     }
     tails[num_tasks - 1]->set_next(NULL);
-    heap_->old_space()->pages_tail_ = tails[num_tasks - 1];
+    tail = tails[num_tasks - 1];
 
     delete[] heads;
     delete[] tails;
@@ -261,6 +280,7 @@ void GCCompactor::Compact(HeapPage* pages,
   for (HeapPage* page = pages; page != NULL; page = page->next()) {
     page->FreeForwardingPage();
   }
+  return tail;
 }
 
 void CompactorTask::Run() {
@@ -296,7 +316,7 @@ void CompactorTask::Run() {
       // required to make the page walkable during forwarding, etc.
       intptr_t free_remaining = free_end_ - free_current_;
       if (free_remaining != 0) {
-        freelist_->Free(free_current_, free_remaining);
+        FreeRemaining(free_current_, free_remaining);
       }
 
       ASSERT(free_page_ != NULL);
@@ -340,8 +360,16 @@ void CompactorTask::Run() {
           isolate_->VisitWeakPersistentHandles(compactor_);
           break;
         }
-#ifndef PRODUCT
         case 5: {
+          TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardUnevacuatedPages");
+          for (HeapPage* page = compactor_->unevacuated_pages_; page != NULL;
+               page = page->next()) {
+            compactor_->ForwardMarkedObjects(page);
+          }
+          break;
+        }
+#ifndef PRODUCT
+        case 6: {
           if (FLAG_support_service) {
             TIMELINE_FUNCTION_GC_DURATION(thread, "ForwardObjectIdRing");
             isolate_->object_id_ring()->VisitPointers(compactor_);
@@ -439,7 +467,7 @@ uword CompactorTask::SlideBlock(uword first_object,
         intptr_t free_remaining = free_end_ - free_current_;
         // Add any leftover at the end of a page to the free list.
         if (free_remaining > 0) {
-          freelist_->Free(free_current_, free_remaining);
+          FreeRemaining(free_current_, free_remaining);
         }
         free_page_ = free_page_->next();
         ASSERT(free_page_ != NULL);
@@ -456,7 +484,9 @@ uword CompactorTask::SlideBlock(uword first_object,
         memmove(reinterpret_cast<void*>(new_addr),
                 reinterpret_cast<void*>(old_addr), size);
       }
-      new_obj->ClearMarkBit();
+      if (!compactor_->selective_) {
+        new_obj->ClearMarkBit();
+      }
       new_obj->VisitPointers(compactor_);
 
       ASSERT(free_current_ == new_addr);
@@ -487,6 +517,16 @@ void CompactorTask::PlanMoveToContiguousSize(intptr_t size) {
   }
 }
 
+void CompactorTask::FreeRemaining(uword addr, intptr_t size) {
+  if (compactor_->selective_) {
+    // The sweep that follows selective compaction adds this to the freelist;
+    // for now it only has to keep the page walkable.
+    FreeListElement::AsElement(addr, size);
+  } else {
+    freelist_->Free(addr, size);
+  }
+}
+
 void GCCompactor::SetupImagePageBoundaries() {
   for (intptr_t i = 0; i < kMaxImagePages; i++) {
     image_page_ranges_[i].base = 0;
@@ -546,6 +586,20 @@ void GCCompactor::VisitPointers(RawObject** first, RawObject** last) {
   }
 }
 
+// Unevacuated pages are still unswept, so only their marked objects are
+// visited: dead objects may refer to evacuated pages that are already freed.
+void GCCompactor::ForwardMarkedObjects(HeapPage* page) {
+  uword current = page->object_start();
+  uword end = page->object_end();
+  while (current < end) {
+    RawObject* obj = RawObject::FromAddr(current);
+    if (obj->IsMarked()) {
+      obj->VisitPointers(this);
+    }
+    current += obj->Size();
+  }
+}
+
 void GCCompactor::VisitHandle(uword addr) {
   FinalizablePersistentHandle* handle =
       reinterpret_cast<FinalizablePersistentHandle*>(addr);
@@ -26,19 +26,34 @@ class GCCompactor : public ValueObject,
   GCCompactor(Thread* thread, Heap* heap)
       : HandleVisitor(thread),
         ObjectPointerVisitor(thread->isolate()),
-        heap_(heap) {}
+        heap_(heap),
+        selective_(false),
+        unevacuated_pages_(NULL) {}
   ~GCCompactor() {}
 
   void Compact(HeapPage* pages, FreeList* freelist, Mutex* mutex);
 
+  // Compacts only 'pages', which the caller has unlinked from the old-space
+  // page list, and forwards the pointers of the marked objects that remain
+  // in 'unevacuated_pages'. Mark bits are kept and leftover space is not added
+  // to the freelist, so every data page can be swept as usual afterwards.
+  // Returns the last surviving page of 'pages' for the caller to re-link.
+  HeapPage* CompactSelected(HeapPage* pages,
+                            HeapPage* unevacuated_pages,
+                            Mutex* pages_lock);
+
  private:
+  HeapPage* CompactPages(HeapPage* pages, FreeList* freelist, Mutex* mutex);
   void SetupImagePageBoundaries();
   void ForwardStackPointers();
+  void ForwardMarkedObjects(HeapPage* page);
   void ForwardPointer(RawObject** ptr);
   void VisitPointers(RawObject** first, RawObject** last);
   void VisitHandle(uword addr);
 
   Heap* heap_;
+  bool selective_;
+  HeapPage* unevacuated_pages_;
 
   struct ImagePageRange {
     uword base;
@@ -48,6 +63,8 @@ class GCCompactor : public ValueObject,
   // {instructions, data} x {vm isolate, current isolate, shared}
   static const intptr_t kMaxImagePages = 6;
   ImagePageRange image_page_ranges_[kMaxImagePages];
+
+  friend class CompactorTask;
 };
 
 }  // namespace dart
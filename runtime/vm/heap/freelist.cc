@@ -74,7 +74,7 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
 
   // Postcondition: if allocation succeeds, the allocated block is writable.
   int index = IndexForSize(size);
-  if ((index != kNumLists) && free_map_.Test(index)) {
+  if ((index < kNumLists) && free_map_.Test(index)) {
     FreeListElement* element = DequeueElement(index);
     if (is_protected) {
       VirtualMemory::Protect(reinterpret_cast<void*>(element), size,
@@ -106,71 +106,93 @@ uword FreeList::TryAllocateLocked(intptr_t size, bool is_protected) {
     }
   }
 
+  FreeListElement* element = TryAllocateFromLargeListsLocked(size, is_protected);
+  if (element == NULL) {
+    return 0;  // Trigger allocation of new page.
+  }
+  SplitElementAfterAndEnqueue(element, size, is_protected);
+  return reinterpret_cast<uword>(element);
+}
+
+FreeListElement* FreeList::TryAllocateFromLargeListsLocked(intptr_t size,
+                                                           bool is_protected) {
+  DEBUG_ASSERT(mutex_->IsOwnedByCurrentThread());
   FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // We are willing to search the freelist further for a big block.
-  // For each successful free-list search we:
-  //   * increase the search budget by #allocated-words
-  //   * decrease the search budget by #free-list-entries-traversed
-  //     which guarantees us to not waste more than around 1 search step per
-  //     word of allocation
-  //
-  // If we run out of search budget we fall back to allocating a new page and
-  // reset the search budget.
-  intptr_t tries_left = freelist_search_budget_ + (size >> kWordSizeLog2);
-  while (current != NULL) {
-    if (current->Size() >= size) {
-      // Found an element large enough to hold the requested size. Dequeue,
-      // split and enqueue the remainder.
-      intptr_t remainder_size = current->Size() - size;
-      intptr_t region_size =
-          size + FreeListElement::HeaderSizeFor(remainder_size);
-      if (is_protected) {
-        // Make the allocated block and the header of the remainder element
-        // writable.  The remainder will be non-writable if necessary after
-        // the call to SplitElementAfterAndEnqueue.
-        VirtualMemory::Protect(reinterpret_cast<void*>(current), region_size,
-                               VirtualMemory::kReadWrite);
+  FreeListElement* current = NULL;
+  // Any element of a size class above that of 'size' is large enough.
+  intptr_t first_fitting_class = 0;
+  intptr_t index = kNumLists;
+  if (size >= kMinLargeSize) {
+    index = IndexForSize(size);
+    first_fitting_class = index - kNumLists + 1;
+    if (large_map_.Test(index - kNumLists)) {
+      // Elements in the size class of 'size' may be too small. Search for the
+      // best fit, but bound the search to about one step per word allocated.
+      intptr_t tries_left = freelist_search_budget_ + (size >> kWordSizeLog2);
+      FreeListElement* candidate_previous = NULL;
+      for (FreeListElement* candidate = free_lists_[index]; candidate != NULL;
+           candidate = candidate->next()) {
+        const intptr_t candidate_size = candidate->Size();
+        if ((candidate_size >= size) &&
+            ((current == NULL) || (candidate_size < current->Size()))) {
+          previous = candidate_previous;
+          current = candidate;
+          if (candidate_size == size) break;
+        }
+        if (tries_left-- < 0) break;
+        candidate_previous = candidate;
       }
+      freelist_search_budget_ =
+          (tries_left < 0)
+              ? kInitialFreeListSearchBudget
+              : Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
+    }
+  }
+  if (current == NULL) {
+    if (first_fitting_class >= kNumLargeLists) {
+      return NULL;
+    }
+    const intptr_t size_class = large_map_.Next(first_fitting_class);
+    if (size_class == -1) {
+      return NULL;
+    }
+    index = kNumLists + size_class;
+    current = free_lists_[index];
+  }
 
-      if (previous == NULL) {
-        free_lists_[kNumLists] = current->next();
-      } else {
-        // If the previous free list element's next field is protected, it
-        // needs to be unprotected before storing to it and reprotected
-        // after.
-        bool target_is_protected = false;
-        uword target_address = 0L;
-        if (is_protected) {
-          uword writable_start = reinterpret_cast<uword>(current);
-          uword writable_end = writable_start + region_size - 1;
-          target_address = previous->next_address();
-          target_is_protected =
-              !VirtualMemory::InSamePage(target_address, writable_start) &&
-              !VirtualMemory::InSamePage(target_address, writable_end);
-        }
-        if (target_is_protected) {
-          VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
-                                 kWordSize, VirtualMemory::kReadWrite);
-        }
+  if (is_protected) {
+    // Make the allocated block and the header of the remainder element
+    // writable.  The remainder will be non-writable if necessary after
+    // the call to SplitElementAfterAndEnqueue.
+    intptr_t remainder_size = current->Size() - size;
+    intptr_t region_size =
+        size + FreeListElement::HeaderSizeFor(remainder_size);
+    VirtualMemory::Protect(reinterpret_cast<void*>(current), region_size,
+                           VirtualMemory::kReadWrite);
+    if (previous != NULL) {
+      // If the previous free list element's next field is protected, it
+      // needs to be unprotected before storing to it and reprotected
+      // after.
+      uword writable_start = reinterpret_cast<uword>(current);
+      uword writable_end = writable_start + region_size - 1;
+      uword target_address = previous->next_address();
+      if (!VirtualMemory::InSamePage(target_address, writable_start) &&
+          !VirtualMemory::InSamePage(target_address, writable_end)) {
+        VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
+                               kWordSize, VirtualMemory::kReadWrite);
         previous->set_next(current->next());
-        if (target_is_protected) {
-          VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
-                                 kWordSize, VirtualMemory::kReadExecute);
-        }
+        VirtualMemory::Protect(reinterpret_cast<void*>(target_address),
+                               kWordSize, VirtualMemory::kReadExecute);
+        return current;
       }
-      SplitElementAfterAndEnqueue(current, size, is_protected);
-      freelist_search_budget_ =
-          Utils::Minimum(tries_left, kInitialFreeListSearchBudget);
-      return reinterpret_cast<uword>(current);
-    } else if (tries_left-- < 0) {
-      freelist_search_budget_ = kInitialFreeListSearchBudget;
-      return 0;  // Trigger allocation of new page.
     }
-    previous = current;
-    current = current->next();
   }
-  return 0;
+  if (previous == NULL) {
+    DequeueElement(index);
+  } else {
+    previous->set_next(current->next());
+  }
+  return current;
 }
 
 void FreeList::Free(uword addr, intptr_t size) {
@@ -194,8 +216,9 @@ void FreeList::FreeLocked(uword addr, intptr_t size) {
 void FreeList::Reset() {
   MutexLocker ml(mutex_);
   free_map_.Reset();
+  large_map_.Reset();
   last_free_small_size_ = -1;
-  for (int i = 0; i < (kNumLists + 1); i++) {
+  for (int i = 0; i < (kNumLists + kNumLargeLists); i++) {
     free_lists_[i] = NULL;
   }
 }
@@ -206,17 +229,24 @@ intptr_t FreeList::IndexForSize(intptr_t size) {
 
   intptr_t index = size >> kObjectAlignmentLog2;
   if (index >= kNumLists) {
-    index = kNumLists;
+    const intptr_t size_log2 =
+        kBitsPerWord - 1 - Utils::CountLeadingZeros(static_cast<uword>(size));
+    index = kNumLists + (size_log2 - kMinLargeSizeLog2);
+    ASSERT(index < (kNumLists + kNumLargeLists));
   }
   return index;
 }
 
 void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
   FreeListElement* next = free_lists_[index];
-  if (next == NULL && index != kNumLists) {
-    free_map_.Set(index, true);
-    last_free_small_size_ =
-        Utils::Maximum(last_free_small_size_, index << kObjectAlignmentLog2);
+  if (next == NULL) {
+    if (index < kNumLists) {
+      free_map_.Set(index, true);
+      last_free_small_size_ =
+          Utils::Maximum(last_free_small_size_, index << kObjectAlignmentLog2);
+    } else {
+      large_map_.Set(index - kNumLists, true);
+    }
   }
   element->set_next(next);
   free_lists_[index] = element;
@@ -225,14 +255,18 @@ void FreeList::EnqueueElement(FreeListElement* element, intptr_t index) {
 FreeListElement* FreeList::DequeueElement(intptr_t index) {
   FreeListElement* result = free_lists_[index];
   FreeListElement* next = result->next();
-  if (next == NULL && index != kNumLists) {
-    intptr_t size = index << kObjectAlignmentLog2;
-    if (size == last_free_small_size_) {
-      // Note: This is -1 * kObjectAlignment if no other small sizes remain.
-      last_free_small_size_ =
-          free_map_.ClearLastAndFindPrevious(index) * kObjectAlignment;
+  if (next == NULL) {
+    if (index < kNumLists) {
+      intptr_t size = index << kObjectAlignmentLog2;
+      if (size == last_free_small_size_) {
+        // Note: This is -1 * kObjectAlignment if no other small sizes remain.
+        last_free_small_size_ =
+            free_map_.ClearLastAndFindPrevious(index) * kObjectAlignment;
+      } else {
+        free_map_.Set(index, false);
+      }
     } else {
-      free_map_.Set(index, false);
+      large_map_.Set(index - kNumLists, false);
     }
   }
   free_lists_[index] = next;
@@ -302,16 +336,18 @@ void FreeList::PrintLarge() const {
   int large_objects = 0;
   intptr_t large_bytes = 0;
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> > map;
-  FreeListElement* node;
-  for (node = free_lists_[kNumLists]; node != NULL; node = node->next()) {
-    IntptrPair* pair = map.Lookup(node->Size());
-    if (pair == NULL) {
-      large_sizes += 1;
-      map.Insert(IntptrPair(node->Size(), 1));
-    } else {
-      pair->set_second(pair->second() + 1);
+  for (intptr_t i = kNumLists; i < (kNumLists + kNumLargeLists); i++) {
+    FreeListElement* node;
+    for (node = free_lists_[i]; node != NULL; node = node->next()) {
+      IntptrPair* pair = map.Lookup(node->Size());
+      if (pair == NULL) {
+        large_sizes += 1;
+        map.Insert(IntptrPair(node->Size(), 1));
+      } else {
+        pair->set_second(pair->second() + 1);
+      }
+      large_objects += 1;
     }
-    large_objects += 1;
   }
 
   MallocDirectChainedHashMap<NumbersKeyValueTrait<IntptrPair> >::Iterator it =
@@ -369,17 +405,21 @@ FreeListElement* FreeList::TryAllocateLarge(intptr_t minimum_size) {
 
 FreeListElement* FreeList::TryAllocateLargeLocked(intptr_t minimum_size) {
   DEBUG_ASSERT(mutex_->IsOwnedByCurrentThread());
+  const intptr_t size_class = large_map_.Last();
+  if (size_class == -1) {
+    return NULL;
+  }
+  const intptr_t index = kNumLists + size_class;
   FreeListElement* previous = NULL;
-  FreeListElement* current = free_lists_[kNumLists];
-  // TODO(koda): Find largest.
-  // We are willing to search the freelist further for a big block.
+  FreeListElement* current = free_lists_[index];
+  // We are willing to search the largest size class further for a big block.
   intptr_t tries_left =
       freelist_search_budget_ + (minimum_size >> kWordSizeLog2);
   while (current != NULL) {
     FreeListElement* next = current->next();
     if (current->Size() >= minimum_size) {
       if (previous == NULL) {
-        free_lists_[kNumLists] = next;
+        DequeueElement(index);
       } else {
         previous->set_next(next);
       }
@@ -402,7 +442,7 @@ uword FreeList::TryAllocateSmallLocked(intptr_t size) {
     return 0;
   }
   int index = IndexForSize(size);
-  if (index != kNumLists && free_map_.Test(index)) {
+  if (index < kNumLists && free_map_.Test(index)) {
     return reinterpret_cast<uword>(DequeueElement(index));
   }
   if ((index + 1) < kNumLists) {
@@ -91,6 +91,7 @@ class FreeList {
   void FreeLocked(uword addr, intptr_t size);
 
   // Returns a large element, at least 'minimum_size', or NULL if none exists.
+  // Prefers elements from the largest size class.
   FreeListElement* TryAllocateLarge(intptr_t minimum_size);
   FreeListElement* TryAllocateLargeLocked(intptr_t minimum_size);
 
@@ -99,13 +100,29 @@ class FreeList {
   uword TryAllocateSmallLocked(intptr_t size);
 
  private:
-  static const int kNumLists = 128;
+  // Elements smaller than kNumLists * kObjectAlignment are kept in exact-size
+  // lists. Larger elements are kept in size classes of powers of two: the
+  // list at index kNumLists + i holds the elements whose size is in
+  // [kMinLargeSize << i, kMinLargeSize << (i + 1)).
+  static const int kNumListsLog2 = 7;
+  static const int kNumLists = 1 << kNumListsLog2;
+  static const intptr_t kMinLargeSizeLog2 =
+      kNumListsLog2 + kObjectAlignmentLog2;
+  static const intptr_t kMinLargeSize = 1 << kMinLargeSizeLog2;
+  static const int kNumLargeLists = kBitsPerWord - kMinLargeSizeLog2;
   static const intptr_t kInitialFreeListSearchBudget = 1000;
 
   static intptr_t IndexForSize(intptr_t size);
 
   intptr_t LengthLocked(int index) const;
 
+  // Unlinks and returns an element of at least 'size' from the large lists,
+  // or NULL if there is none. The element is chosen from the size class of
+  // 'size' by a bounded best-fit search, or else from the next larger
+  // non-empty size class.
+  FreeListElement* TryAllocateFromLargeListsLocked(intptr_t size,
+                                                   bool is_protected);
+
   void EnqueueElement(FreeListElement* element, intptr_t index);
   FreeListElement* DequeueElement(intptr_t index);
 
@@ -121,7 +138,10 @@ class FreeList {
 
   BitSet<kNumLists> free_map_;
 
-  FreeListElement* free_lists_[kNumLists + 1];
+  // Non-empty large size classes.
+  BitSet<kNumLargeLists> large_map_;
+
+  FreeListElement* free_lists_[kNumLists + kNumLargeLists];
 
   intptr_t freelist_search_budget_;
 
@@ -4,6 +4,8 @@
 
 #include "vm/heap/freelist.h"
 #include "platform/assert.h"
+#include "vm/benchmark_test.h"
+#include "vm/timer.h"
 #include "vm/unit_test.h"
 
 namespace dart {
@@ -182,4 +184,65 @@ TEST_CASE(FreeListProtectedVariableSizeObjects) {
   delete[] objects;
 }
 
+TEST_CASE(FreeListBestFit) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kBlobSize = 1 * MB;
+  VirtualMemory* region =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable = */ false, NULL);
+  const intptr_t kGap = kObjectAlignment;
+  uword block0 = region->start();
+  uword block1 = block0 + 3 * KB + kGap;
+  uword block2 = block1 + 5 * KB / 2 + kGap;
+  // Blocks of 3KB and 2.5KB share a size class; 8KB is in a larger one.
+  free_list->Free(block0, 3 * KB);
+  free_list->Free(block1, 5 * KB / 2);
+  free_list->Free(block2, 8 * KB);
+
+  // The smallest block that fits is preferred within the size class.
+  EXPECT_EQ(block1, Allocate(free_list, 5 * KB / 2, false));
+  EXPECT_EQ(block0, Allocate(free_list, 5 * KB / 2, false));
+  // The size class is exhausted, so the larger class is used.
+  EXPECT_EQ(block2, Allocate(free_list, 5 * KB / 2, false));
+  EXPECT_EQ(block2 + 5 * KB / 2, Allocate(free_list, 4 * KB, false));
+
+  delete region;
+  delete free_list;
+}
+
+// Measures allocation of medium and large sizes once free space is split into
+// many blocks of mixed sizes.
+BENCHMARK(FreeListFragmentedAllocation) {
+  FreeList* free_list = new FreeList();
+  const intptr_t kBlobSize = 32 * MB;
+  VirtualMemory* region =
+      VirtualMemory::Allocate(kBlobSize, /* is_executable = */ false, NULL);
+
+  // Free blocks between 2KB and 18KB, separated by live gaps so that they
+  // cannot be merged.
+  uword current = region->start();
+  const uword end = region->end();
+  intptr_t count = 0;
+  while (true) {
+    const intptr_t size = (128 + ((count * 37) % 1024)) * kObjectAlignment;
+    if (current + size + kObjectAlignment > end) break;
+    free_list->Free(current, size);
+    current += size + kObjectAlignment;
+    count++;
+  }
+
+  Timer timer(true, "FreeList fragmented allocation benchmark");
+  timer.Start();
+  intptr_t allocated = 0;
+  for (intptr_t i = 0; allocated < kBlobSize / 2; i++) {
+    const intptr_t size = (64 + ((i * 53) % 512)) * kObjectAlignment;
+    if (free_list->TryAllocate(size, false) == 0) break;
+    allocated += size;
+  }
+  timer.Stop();
+  benchmark->set_score(timer.TotalElapsedTime());
+
+  delete region;
+  delete free_list;
+}
+
 }  // namespace dart
@@ -5,7 +5,9 @@
 #include "vm/heap/heap.h"
 
 #include "platform/assert.h"
+#include "platform/atomic.h"
 #include "platform/utils.h"
+#include "vm/dart_api_state.h"
 #include "vm/flags.h"
 #include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
@@ -29,16 +31,26 @@
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            external_soft_limit,
+            0,
+            "Soft limit in MB on the external data held by an isolate's "
+            "objects. Allocating external data above it first collects "
+            "garbage (0 means no limit).");
 DEFINE_FLAG(bool, write_protect_vm_isolate, true, "Write protect vm_isolate.");
 
 Heap::Heap(Isolate* isolate,
            intptr_t max_new_gen_semi_words,
            intptr_t max_old_gen_words)
     : isolate_(isolate),
+      numa_node_(FLAG_numa_aware_heap ? OSThread::GetCurrentNumaNode()
+                                      : OSThread::kNoNumaNode),
       new_space_(this, max_new_gen_semi_words, kNewObjectAlignmentOffset),
       old_space_(this, max_old_gen_words),
+      code_ranges_(this),
       barrier_(new Monitor()),
       barrier_done_(new Monitor()),
+      external_retained_in_words_(0),
       read_only_(false),
       gc_new_space_in_progress_(false),
       gc_old_space_in_progress_(false) {
@@ -60,12 +72,31 @@ Heap::~Heap() {
   }
 }
 
+void Heap::BindToNumaNode(uword address, intptr_t size) const {
+  const intptr_t node = numa_node();
+  if ((node == OSThread::kNoNumaNode) || (size == 0)) {
+    return;
+  }
+  VirtualMemory::BindToNumaNode(reinterpret_cast<void*>(address), size, node);
+}
+
 uword Heap::AllocateNew(intptr_t size) {
   ASSERT(Thread::Current()->no_safepoint_scope_depth() == 0);
   // Currently, only the Dart thread may allocate in new space.
   isolate()->AssertCurrentThreadIsMutator();
   Thread* thread = Thread::Current();
   uword addr = new_space_.TryAllocateInTLAB(thread, size);
+  sampler_.set_sampled_new_allocation(0);
+  if ((addr == 0) && (thread->end() != new_space_.end())) {
+    // The allocation reached the thread's sampling point rather than the end
+    // of new space. Sample it and move on to the next sampling point.
+    thread->set_end(new_space_.end());
+    addr = new_space_.TryAllocateInTLAB(thread, size);
+    if (addr != 0) {
+      sampler_.set_sampled_new_allocation(size);
+    }
+    new_space_.SetThreadEnd(thread);
+  }
   if (addr == 0) {
     // This call to CollectGarbage might end up "reusing" a collection spawned
     // from a different thread and will be racing to allocate the requested
@@ -80,14 +111,22 @@ uword Heap::AllocateNew(intptr_t size) {
 }
 
 uword Heap::AllocateOld(intptr_t size, HeapPage::PageType type) {
-  ASSERT(Thread::Current()->no_safepoint_scope_depth() == 0);
-  uword addr = old_space_.TryAllocate(size, type);
+  Thread* thread = Thread::Current();
+  ASSERT(thread->no_safepoint_scope_depth() == 0);
+  uword addr = 0;
+  if ((type == HeapPage::kData) && !thread->IsMutatorThread() &&
+      (thread->heap() == this)) {
+    // Keep the background compiler off the lock the mutator allocates under.
+    addr = old_space_.TryAllocateInThreadBuffer(thread, size,
+                                                PageSpace::kControlGrowth);
+  } else {
+    addr = old_space_.TryAllocate(size, type);
+  }
   if (addr != 0) {
     return addr;
   }
   // If we are in the process of running a sweep, wait for the sweeper to free
   // memory.
-  Thread* thread = Thread::Current();
   if (thread->CanCollectGarbage()) {
     // Wait for any GC tasks that are in progress.
     WaitForSweeperTasks(thread);
@@ -147,6 +186,53 @@ void Heap::AllocateExternal(intptr_t cid, intptr_t size, Space space) {
       CollectAllGarbage(kExternal);
     }
   }
+  CheckExternalSoftLimit(Thread::Current());
+}
+
+bool Heap::ExceedsExternalSoftLimit() const {
+  const int64_t limit_in_words =
+      static_cast<int64_t>(FLAG_external_soft_limit) * MBInWords;
+  if (limit_in_words == 0) {
+    return false;
+  }
+  // Owners that stay alive above the limit should not make every allocation
+  // collect: wait for the external data to double before trying again.
+  const int64_t retained_in_words =
+      AtomicOperations::LoadRelaxed(&external_retained_in_words_);
+  return (ExternalInWords(kNew) + ExternalInWords(kOld)) >
+         Utils::Maximum(limit_in_words, 2 * retained_in_words);
+}
+
+// External data is allocated and freed by the mutator, by helper threads and
+// by the GC tasks, so the retained amount is only updated atomically.
+void Heap::SetExternalRetainedInWords(intptr_t value, bool only_lower) {
+  intptr_t old_value;
+  do {
+    old_value = AtomicOperations::LoadRelaxed(&external_retained_in_words_);
+    if (only_lower && (value >= old_value)) {
+      return;
+    }
+  } while (AtomicOperations::CompareAndSwapWord(
+               reinterpret_cast<uword*>(&external_retained_in_words_),
+               static_cast<uword>(old_value),
+               static_cast<uword>(value)) != static_cast<uword>(old_value));
+}
+
+void Heap::CheckExternalSoftLimit(Thread* thread) {
+  if (!ExceedsExternalSoftLimit()) {
+    return;
+  }
+  // Young owners are the cheapest to reclaim.
+  if (thread->IsMutatorThread() &&
+      (new_space_.ExternalInWords() >= old_space_.ExternalInWords())) {
+    CollectNewSpaceGarbage(thread, kExternal);
+    if (!ExceedsExternalSoftLimit()) {
+      return;
+    }
+  }
+  CollectAllGarbage(kExternal);
+  SetExternalRetainedInWords(ExternalInWords(kNew) + ExternalInWords(kOld),
+                             false);
 }
 
 void Heap::FreeExternal(intptr_t size, Space space) {
@@ -156,6 +242,9 @@ void Heap::FreeExternal(intptr_t size, Space space) {
     ASSERT(space == kOld);
     old_space_.FreeExternal(size);
   }
+  // Once the retained owners release their data, go back to the plain limit.
+  SetExternalRetainedInWords(ExternalInWords(kNew) + ExternalInWords(kOld),
+                             true);
 }
 
 void Heap::PromoteExternal(intptr_t cid, intptr_t size) {
@@ -222,6 +311,12 @@ HeapIterationScope::HeapIterationScope(Thread* thread, bool writable)
 
   isolate()->safepoint_handler()->SafepointThreads(thread);
 
+  // The unused parts of the threads' allocation chunks are not walkable.
+  isolate()->thread_registry()->ReleaseOldAllocationBuffers();
+
+  // Pages awaiting lazy sweeping still hold garbage and stale mark bits.
+  old_space_->CompleteLazySweep();
+
   if (writable_) {
     heap_->WriteProtectCode(false);
   }
@@ -372,11 +467,29 @@ void Heap::NotifyIdle(int64_t deadline) {
   } else if (old_space_.ShouldPerformIdleMarkSweep(deadline)) {
     TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGC");
     CollectOldSpaceGarbage(thread, kMarkSweep, kIdle);
+  } else if (FLAG_idle_gc_slices) {
+    PerformIdleSlice(thread, deadline);
+  }
+  old_space_.TrimPageCache(false);
+}
+
+void Heap::PerformIdleSlice(Thread* thread, int64_t deadline) {
+  TIMELINE_FUNCTION_GC_DURATION(thread, "IdleGCSlice");
+#if defined(TARGET_ARCH_X64)
+  // A whole mark-sweep does not fit, but the old generation will need one
+  // soon: start marking concurrently so this idle time, and the next, can be
+  // spent on it instead of on a pause later.
+  if (FLAG_concurrent_mark && !FLAG_use_compactor &&
+      old_space_.ShouldStartIdleMarking()) {
+    CollectOldSpaceGarbage(thread, kMarkSweep, kIdleMarking);
   }
+#endif
+  old_space_.PerformIdleSlice(thread, deadline);
 }
 
 void Heap::NotifyLowMemory() {
   CollectAllGarbage(kLowMemory);
+  old_space_.TrimPageCache(true);
 }
 
 void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
@@ -390,6 +503,7 @@ void Heap::EvacuateNewSpace(Thread* thread, GCReason reason) {
     PrintStats();
     NOT_IN_PRODUCT(PrintStatsToTimeline(&tds, reason));
     EndNewSpaceGC();
+    RunPendingFinalizers(thread, false);
   }
 }
 
@@ -406,6 +520,7 @@ void Heap::CollectNewSpaceGarbage(Thread* thread, GCReason reason) {
       NOT_IN_PRODUCT(PrintStatsToTimeline(&tds, reason));
       EndNewSpaceGC();
     }
+    RunPendingFinalizers(thread, false);
     if ((reason == kNewSpace) && old_space_.NeedsGarbageCollection()) {
       CollectOldSpaceGarbage(thread, kMarkSweep, kPromotion);
     }
@@ -420,18 +535,39 @@ void Heap::CollectOldSpaceGarbage(Thread* thread,
   if (FLAG_use_compactor) {
     type = kMarkCompact;
   }
+#if defined(TARGET_ARCH_X64)
+  // Only collections triggered by promotion or started early during idle time
+  // are run concurrently, everyone else expects the garbage to be gone when
+  // this returns. Only the x64 write barrier supports concurrent marking.
+  const bool concurrent = FLAG_concurrent_mark && (type == kMarkSweep) &&
+                          ((reason == kPromotion) || (reason == kIdleMarking));
+#else
+  const bool concurrent = false;
+#endif
   if (BeginOldSpaceGC(thread)) {
     RecordBeforeGC(type, reason);
     VMTagScope tagScope(thread, VMTag::kGCOldSpaceTagId);
     TIMELINE_FUNCTION_GC_DURATION_BASIC(thread, "CollectOldGeneration");
-    old_space_.CollectGarbage(type == kMarkCompact);
+    old_space_.CollectGarbage(type == kMarkCompact, concurrent);
     RecordAfterGC(type);
     PrintStats();
     NOT_IN_PRODUCT(PrintStatsToTimeline(&tds, reason));
     // Some Code objects may have been collected so invalidate handler cache.
     thread->isolate()->handler_info_cache()->Clear();
     thread->isolate()->catch_entry_state_cache()->Clear();
+    code_ranges_.Clear();
     EndOldSpaceGC();
+    RunPendingFinalizers(thread, false);
+  }
+}
+
+void Heap::RunPendingFinalizers(Thread* thread, bool in_pause) {
+  if (thread->IsMutatorThread() == in_pause) {
+    return;
+  }
+  ApiState* state = isolate()->api_state();
+  if (state != NULL) {
+    state->RunPendingFinalizers(isolate());
   }
 }
 
@@ -655,6 +791,8 @@ const char* Heap::GCReasonToString(GCReason gc_reason) {
       return "external";
     case kIdle:
       return "idle";
+    case kIdleMarking:
+      return "idle marking";
     case kLowMemory:
       return "low memory";
     case kDebugging:
@@ -776,6 +914,48 @@ void Heap::RecordAfterGC(GCType type) {
     Service::HandleEvent(&event);
   }
 #endif  // !PRODUCT
+  RecordGCMetrics(delta);
+}
+
+void Heap::RecordGCMetrics(int64_t pause_micros) {
+#if !defined(PRODUCT)
+  Isolate* isolate = this->isolate();
+  if (stats_.type_ == kScavenge) {
+    isolate->GetGCNewPauseMetric()->Record(pause_micros);
+    isolate->GetGCNewSafepointMetric()->Record(
+        stats_.times_[Scavenger::kSafePoint]);
+    isolate->GetGCNewRootsMetric()->Record(
+        stats_.times_[Scavenger::kVisitIsolateRoots]);
+    isolate->GetGCNewStoreBufferMetric()->Record(
+        stats_.times_[Scavenger::kIterateStoreBuffers]);
+    isolate->GetGCNewToSpaceMetric()->Record(
+        stats_.times_[Scavenger::kProcessToSpace]);
+    isolate->GetGCNewWeaksMetric()->Record(
+        stats_.times_[Scavenger::kIterateWeaks]);
+    isolate->GetGCNewPromotedMetric()->Record(
+        stats_.data_[Scavenger::kPromotedKB] * KB);
+    return;
+  }
+  // Weak processing is part of marking in the stats, but reported separately.
+  const int64_t weak_micros = stats_.times_[PageSpace::kMarkWeaks];
+  isolate->GetGCOldPauseMetric()->Record(pause_micros);
+  isolate->GetGCOldSafepointMetric()->Record(
+      stats_.times_[PageSpace::kSafePoint]);
+  isolate->GetGCOldMarkMetric()->Record(
+      stats_.times_[PageSpace::kMarkObjects] - weak_micros);
+  isolate->GetGCOldWeaksMetric()->Record(weak_micros);
+  // When compacting, the page sweep is replaced by the compaction.
+  const int64_t sweep_micros = stats_.times_[PageSpace::kResetFreeLists] +
+                               stats_.times_[PageSpace::kSweepPages];
+  if (stats_.type_ == kMarkCompact) {
+    isolate->GetGCOldSweepMetric()->Record(sweep_micros);
+    isolate->GetGCOldCompactMetric()->Record(
+        stats_.times_[PageSpace::kSweepLargePages]);
+  } else {
+    isolate->GetGCOldSweepMetric()->Record(
+        sweep_micros + stats_.times_[PageSpace::kSweepLargePages]);
+  }
+#endif  // !defined(PRODUCT)
 }
 
 void Heap::PrintStats() {
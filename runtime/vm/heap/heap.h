@@ -9,7 +9,10 @@
 #include "vm/allocation.h"
 #include "vm/flags.h"
 #include "vm/globals.h"
+#include "vm/heap/code_range_table.h"
 #include "vm/heap/pages.h"
+#include "vm/heap/pretenuring.h"
+#include "vm/heap/sampler.h"
 #include "vm/heap/scavenger.h"
 #include "vm/heap/spaces.h"
 #include "vm/heap/weak_table.h"
@@ -48,14 +51,15 @@ class Heap {
   };
 
   enum GCReason {
-    kNewSpace,   // New space is full.
-    kPromotion,  // Old space limit crossed after a scavenge.
-    kOldSpace,   // Old space limit crossed.
-    kFull,       // Heap::CollectAllGarbage
-    kExternal,   // Dart_NewWeakPersistentHandle
-    kIdle,       // Dart_NotifyIdle
-    kLowMemory,  // Dart_NotifyLowMemory
-    kDebugging,  // service request, --gc_at_instance_allocation, etc.
+    kNewSpace,     // New space is full.
+    kPromotion,    // Old space limit crossed after a scavenge.
+    kOldSpace,     // Old space limit crossed.
+    kFull,         // Heap::CollectAllGarbage
+    kExternal,     // Dart_NewWeakPersistentHandle
+    kIdle,         // Dart_NotifyIdle
+    kIdleMarking,  // Dart_NotifyIdle started a concurrent marking.
+    kLowMemory,    // Dart_NotifyLowMemory
+    kDebugging,    // service request, --gc_at_instance_allocation, etc.
   };
 
   // Pattern for unused new space and swept old space.
@@ -65,6 +69,9 @@ class Heap {
 
   Scavenger* new_space() { return &new_space_; }
   PageSpace* old_space() { return &old_space_; }
+  PretenuringFeedback* pretenuring_feedback() { return &pretenuring_feedback_; }
+  HeapSampler* sampler() { return &sampler_; }
+  CodeRangeTable* code_ranges() { return &code_ranges_; }
 
   uword Allocate(intptr_t size, Space space) {
     ASSERT(!read_only_);
@@ -90,6 +97,9 @@ class Heap {
   void FreeExternal(intptr_t size, Space space);
   // Move external size from new to old space. Does not by itself trigger GC.
   void PromoteExternal(intptr_t cid, intptr_t size);
+  // Whether the external data attributed to this heap is above the soft limit
+  // set by --external_soft_limit.
+  bool ExceedsExternalSoftLimit() const;
 
   // Heap contains the specified address.
   bool Contains(uword addr) const;
@@ -117,6 +127,13 @@ class Heap {
   void CollectGarbage(Space space);
   void CollectGarbage(GCType type, GCReason reason);
   void CollectAllGarbage(GCReason reason = kFull);
+
+  // A GC only queues the finalizers of the weak persistent handles whose
+  // referents died; they run here in one batch. The mutator runs them after
+  // the pause (in_pause is false). Other threads that collect garbage run them
+  // before it ends (in_pause is true), as only the mutator may use the handles
+  // once the isolate resumes.
+  void RunPendingFinalizers(Thread* thread, bool in_pause);
   bool NeedsGarbageCollection() const {
     return old_space_.NeedsGarbageCollection();
   }
@@ -255,6 +272,13 @@ class Heap {
 
   Isolate* isolate() const { return isolate_; }
 
+  // With --numa_aware_heap, the NUMA node of the thread that last ran the
+  // isolate's message handler, which new heap memory is bound to and GC helper
+  // tasks run on. OSThread::kNoNumaNode otherwise.
+  intptr_t numa_node() const { return numa_node_; }
+  void set_numa_node(intptr_t node) { numa_node_ = node; }
+  void BindToNumaNode(uword address, intptr_t size) const;
+
   Monitor* barrier() const { return barrier_; }
   Monitor* barrier_done() const { return barrier_done_; }
 
@@ -283,7 +307,7 @@ class Heap {
       DISALLOW_COPY_AND_ASSIGN(Data);
     };
 
-    enum { kTimeEntries = 6 };
+    enum { kTimeEntries = 7 };
     enum { kDataEntries = 4 };
 
     Data before_;
@@ -320,10 +344,20 @@ class Heap {
   void CollectNewSpaceGarbage(Thread* thread, GCReason reason);
   void CollectOldSpaceGarbage(Thread* thread, GCType type, GCReason reason);
   void EvacuateNewSpace(Thread* thread, GCReason reason);
+  // Collects the owners of external data once it crosses the soft limit, so
+  // their finalizers release native memory before more is allocated.
+  void CheckExternalSoftLimit(Thread* thread);
+  // Sets external_retained_in_words_ to 'value', or only lowers it to
+  // 'value' if 'only_lower' is true.
+  void SetExternalRetainedInWords(intptr_t value, bool only_lower);
+  // Spends the time until 'deadline' on part of a collection that is too long
+  // to run whole during idle time.
+  void PerformIdleSlice(Thread* thread, int64_t deadline);
 
   // GC stats collection.
   void RecordBeforeGC(GCType type, GCReason reason);
   void RecordAfterGC(GCType type);
+  void RecordGCMetrics(int64_t pause_micros);
   void PrintStats();
   void PrintStatsToTimeline(TimelineEventScope* event, GCReason reason);
 
@@ -336,10 +370,14 @@ class Heap {
   void AddRegionsToObjectSet(ObjectSet* set) const;
 
   Isolate* isolate_;
+  intptr_t numa_node_;
 
   // The different spaces used for allocation.
   Scavenger new_space_;
   PageSpace old_space_;
+  PretenuringFeedback pretenuring_feedback_;
+  HeapSampler sampler_;
+  CodeRangeTable code_ranges_;
 
   WeakTable* new_weak_tables_[kNumWeakSelectors];
   WeakTable* old_weak_tables_[kNumWeakSelectors];
@@ -350,6 +388,10 @@ class Heap {
   // GC stats collection.
   GCStats stats_;
 
+  // External data still attributed to this heap after the last collection
+  // triggered by the soft limit. Updated with SetExternalRetainedInWords.
+  intptr_t external_retained_in_words_;
+
   // This heap is in read-only mode: No allocation is allowed.
   bool read_only_;
 
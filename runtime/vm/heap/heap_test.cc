@@ -8,11 +8,22 @@
 #include "vm/dart_api_impl.h"
 #include "vm/globals.h"
 #include "vm/heap/become.h"
+#include "vm/heap/freelist.h"
 #include "vm/heap/heap.h"
 #include "vm/unit_test.h"
 
 namespace dart {
 
+DECLARE_FLAG(int, early_tenuring_threshold);
+DECLARE_FLAG(int, external_soft_limit);
+DECLARE_FLAG(int, gc_pause_goal);
+DECLARE_FLAG(int, gc_time_goal);
+DECLARE_FLAG(bool, pretenure);
+DECLARE_FLAG(int, pretenure_sample_interval);
+DECLARE_FLAG(bool, selective_compaction);
+DECLARE_FLAG(int, selective_compaction_budget);
+DECLARE_FLAG(int, tenuring_threshold);
+
 TEST_CASE(OldGC) {
   const char* kScriptChars =
       "main() {\n"
@@ -377,6 +388,44 @@ ISOLATE_UNIT_TEST_CASE(BecomeForwardRememberedObject) {
   EXPECT(before_obj.raw() == after_obj.raw());
 }
 
+ISOLATE_UNIT_TEST_CASE(BecomeForwardParallel) {
+  const int saved_become_tasks = FLAG_become_tasks;
+  FLAG_become_tasks = 4;
+  Heap* heap = thread->isolate()->heap();
+
+  const String& before_obj = String::Handle(String::New("old", Heap::kOld));
+  const String& after_obj = String::Handle(String::New("new", Heap::kNew));
+  // Spread references to 'before_obj' over many old space pages.
+  const intptr_t kNumHolders = 1000;
+  const Array& holders = Array::Handle(Array::New(kNumHolders, Heap::kOld));
+  Array& holder = Array::Handle();
+  for (intptr_t i = 0; i < kNumHolders; i++) {
+    holder = Array::New(100, Heap::kOld);
+    holder.SetAt(i % 100, before_obj);
+    holders.SetAt(i, holder);
+  }
+
+  const Array& before = Array::Handle(Array::New(1, Heap::kOld));
+  before.SetAt(0, before_obj);
+  const Array& after = Array::Handle(Array::New(1, Heap::kOld));
+  after.SetAt(0, after_obj);
+  Become::ElementsForwardIdentity(before, after);
+
+  for (intptr_t i = 0; i < kNumHolders; i++) {
+    holder ^= holders.At(i);
+    EXPECT(holder.At(i % 100) == after_obj.raw());
+    // Old holders now point into new space and must have been remembered by
+    // whichever task forwarded them.
+    EXPECT(holder.raw()->IsRemembered());
+  }
+  heap->CollectGarbage(Heap::kNew);
+  holder ^= holders.At(0);
+  const String& element = String::Handle(String::RawCast(holder.At(0)));
+  EXPECT(element.Equals("new"));
+
+  FLAG_become_tasks = saved_become_tasks;
+}
+
 ISOLATE_UNIT_TEST_CASE(CollectAllGarbage_DeadOldToNew) {
   Isolate* isolate = Isolate::Current();
   Heap* heap = isolate->heap();
@@ -576,6 +625,415 @@ ISOLATE_UNIT_TEST_CASE(CollectAllGarbage_LiveOldToNewChain) {
   EXPECT(size_before < size_after);
 }
 
+ISOLATE_UNIT_TEST_CASE(ParallelScavenge) {
+  const intptr_t saved_scavenger_tasks = FLAG_scavenger_tasks;
+  FLAG_scavenger_tasks = 2;
+  Isolate* isolate = Isolate::Current();
+  Heap* heap = isolate->heap();
+
+  const intptr_t kLength = 1000;
+  Array& old = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& neu = Array::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    neu = Array::New(1, Heap::kNew);
+    neu.SetAt(0, Smi::Handle(Smi::New(i)));
+    old.SetAt(i, neu);
+  }
+  Array& live_key = Array::Handle(Array::New(1, Heap::kNew));
+  WeakProperty& live_weak = WeakProperty::Handle(WeakProperty::New());
+  live_weak.set_key(live_key);
+  live_weak.set_value(live_key);
+  WeakProperty& dead_weak = WeakProperty::Handle(WeakProperty::New());
+  dead_weak.set_key(Array::Handle(Array::New(1, Heap::kNew)));
+  dead_weak.set_value(live_key);
+
+  // The first scavenge copies the arrays within new space, the second one
+  // promotes them.
+  heap->CollectGarbage(Heap::kNew);
+  heap->CollectGarbage(Heap::kNew);
+
+  for (intptr_t i = 0; i < kLength; i++) {
+    neu ^= old.At(i);
+    EXPECT(neu.IsOld());
+    EXPECT_EQ(i, Smi::Value(Smi::RawCast(neu.At(0))));
+  }
+  EXPECT(live_weak.key() == live_key.raw());
+  EXPECT(live_weak.value() == live_key.raw());
+  EXPECT(dead_weak.key() == Object::null());
+  EXPECT(dead_weak.value() == Object::null());
+
+  FLAG_scavenger_tasks = saved_scavenger_tasks;
+}
+
+ISOLATE_UNIT_TEST_CASE(PauseGoalNewSpaceSize) {
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+  const int saved_pause_goal = FLAG_gc_pause_goal;
+  const int saved_time_goal = FLAG_gc_time_goal;
+  FLAG_gc_pause_goal = 1000;
+  FLAG_gc_time_goal = 100;
+
+  // Survivors would normally make new space grow, but scavenging can never
+  // take more than all of the time.
+  const intptr_t capacity_before = heap->CapacityInWords(Heap::kNew);
+  const Array& survivors = Array::Handle(Array::New(100, Heap::kOld));
+  for (intptr_t i = 0; i < 4; i++) {
+    HANDLESCOPE(thread);
+    for (intptr_t j = 0; j < survivors.Length(); j++) {
+      survivors.SetAt(j, Array::Handle(Array::New(100, Heap::kNew)));
+    }
+    heap->CollectGarbage(Heap::kNew);
+  }
+  EXPECT(heap->CapacityInWords(Heap::kNew) <= capacity_before);
+
+  FLAG_gc_pause_goal = saved_pause_goal;
+  FLAG_gc_time_goal = saved_time_goal;
+}
+
+ISOLATE_UNIT_TEST_CASE(TenuringThreshold) {
+  const intptr_t saved_tenuring_threshold = FLAG_tenuring_threshold;
+  const intptr_t saved_early_tenuring_threshold = FLAG_early_tenuring_threshold;
+  FLAG_tenuring_threshold = 2;
+  FLAG_early_tenuring_threshold = 101;  // Never promote all survivors.
+  Heap* heap = thread->isolate()->heap();
+  // Pick up the new threshold.
+  heap->CollectGarbage(Heap::kNew);
+
+  Array& young = Array::Handle(Array::New(1, Heap::kNew));
+  young.SetAt(0, Smi::Handle(Smi::New(42)));
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT(young.IsNew());
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT(young.IsNew());
+  // Having been kept in new space for two scavenges, it is promoted by the
+  // third.
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT(young.IsOld());
+  EXPECT_EQ(42, Smi::Value(Smi::RawCast(young.At(0))));
+
+  FLAG_tenuring_threshold = saved_tenuring_threshold;
+  FLAG_early_tenuring_threshold = saved_early_tenuring_threshold;
+  heap->CollectGarbage(Heap::kNew);
+}
+
+ISOLATE_UNIT_TEST_CASE(PretenuringFeedback) {
+  const bool saved_pretenure = FLAG_pretenure;
+  const intptr_t saved_sample_interval = FLAG_pretenure_sample_interval;
+  FLAG_pretenure_sample_interval = 1;
+  Heap* heap = thread->isolate()->heap();
+  PretenuringFeedback* feedback = heap->pretenuring_feedback();
+  // Only sample the objects allocated by the test.
+  heap->CollectGarbage(Heap::kNew);
+  FLAG_pretenure = true;
+
+  // Every sampled array survives.
+  const intptr_t kLength = 2000;
+  const Array& live = Array::Handle(Array::New(kLength, Heap::kOld));
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    element = Array::New(8, Heap::kNew);
+    live.SetAt(i, element);
+  }
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT(feedback->IsPretenured(kArrayCid));
+
+  // Most sampled arrays die.
+  {
+    HANDLESCOPE(thread);
+    Array& garbage = Array::Handle();
+    for (intptr_t i = 0; i < 2 * kLength; i++) {
+      garbage = Array::New(8, Heap::kNew);
+    }
+  }
+  heap->CollectGarbage(Heap::kNew);
+  EXPECT(!feedback->IsPretenured(kArrayCid));
+  EXPECT(feedback->HasRevertedClasses());
+  feedback->DisableRevertedCode(thread);
+  EXPECT(!feedback->HasRevertedClasses());
+
+  FLAG_pretenure = saved_pretenure;
+  FLAG_pretenure_sample_interval = saved_sample_interval;
+}
+
+#if defined(TARGET_ARCH_X64)
+ISOLATE_UNIT_TEST_CASE(ConcurrentMark) {
+  const bool saved_concurrent_mark = FLAG_concurrent_mark;
+  FLAG_concurrent_mark = true;
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+
+  // 'moved' is only reachable through 'from' when marking starts.
+  const Array& from = Array::Handle(Array::New(1, Heap::kOld));
+  const Array& to = Array::Handle(Array::New(1, Heap::kOld));
+  Array& moved = Array::Handle(Array::New(1, Heap::kOld));
+  moved.SetAt(0, Smi::Handle(Smi::New(42)));
+  from.SetAt(0, moved);
+  moved = Array::null();
+  // 'promoted' is promoted while marking is in progress.
+  Array& promoted = Array::Handle(Array::New(1, Heap::kNew));
+  promoted.SetAt(0, Smi::Handle(Smi::New(7)));
+  to.SetAt(0, promoted);
+  promoted = Array::null();
+
+  heap->CollectGarbage(Heap::kMarkSweep, Heap::kPromotion);
+  // The collection cannot complete before this thread reaches a safepoint.
+  EXPECT(heap->old_space()->IsMarking());
+
+  // Old objects are allocated black while marking.
+  const Array& fresh = Array::Handle(Array::New(1, Heap::kOld));
+  EXPECT(fresh.raw()->IsMarked());
+  EXPECT(fresh.raw()->IsRemembered());
+
+  // Move the only reference to 'moved' into another old object.
+  {
+    HANDLESCOPE(thread);
+    fresh.SetAt(0, Object::Handle(from.At(0)));
+    from.SetAt(0, Object::null_object());
+  }
+  // Promotes the element of 'to' while marking.
+  heap->CollectGarbage(Heap::kNew);
+  heap->CollectGarbage(Heap::kNew);
+
+  heap->WaitForSweeperTasks(thread);
+  EXPECT(!heap->old_space()->IsMarking());
+  EXPECT(!fresh.raw()->IsMarked());
+  moved ^= fresh.At(0);
+  EXPECT(moved.IsOld());
+  EXPECT_EQ(42, Smi::Value(Smi::RawCast(moved.At(0))));
+  promoted ^= to.At(0);
+  EXPECT(promoted.IsOld());
+  EXPECT_EQ(7, Smi::Value(Smi::RawCast(promoted.At(0))));
+
+  FLAG_concurrent_mark = saved_concurrent_mark;
+}
+#endif  // defined(TARGET_ARCH_X64)
+
+ISOLATE_UNIT_TEST_CASE(LazySweep) {
+  const bool saved_lazy_sweep = FLAG_lazy_sweep;
+  FLAG_lazy_sweep = true;
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  const Array& live = Array::Handle(Array::New(1, Heap::kOld));
+  live.SetAt(0, Smi::Handle(Smi::New(42)));
+  {
+    HANDLESCOPE(thread);
+    // Fill several data pages with garbage.
+    Array& garbage = Array::Handle();
+    for (intptr_t i = 0; i < 1000; i++) {
+      garbage = Array::New(100, Heap::kOld);
+    }
+  }
+  heap->CollectGarbage(Heap::kOld);
+  const int64_t capacity_before_sweep = heap->CapacityInWords(Heap::kOld);
+  // The collection leaves the data pages unswept.
+  EXPECT(live.raw()->IsMarked());
+
+  // Iterating the heap completes the sweep, releasing the garbage pages.
+  { HeapIterationScope iteration(thread); }
+  EXPECT(!live.raw()->IsMarked());
+  EXPECT(heap->CapacityInWords(Heap::kOld) < capacity_before_sweep);
+  EXPECT_EQ(42, Smi::Value(Smi::RawCast(live.At(0))));
+
+  FLAG_lazy_sweep = saved_lazy_sweep;
+}
+
+ISOLATE_UNIT_TEST_CASE(IdleSlice) {
+  const bool saved_lazy_sweep = FLAG_lazy_sweep;
+  FLAG_lazy_sweep = true;
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  const Array& live = Array::Handle(Array::New(1, Heap::kOld));
+  {
+    HANDLESCOPE(thread);
+    Array& garbage = Array::Handle();
+    for (intptr_t i = 0; i < 1000; i++) {
+      garbage = Array::New(100, Heap::kOld);
+    }
+  }
+  heap->CollectGarbage(Heap::kOld);
+  const int64_t capacity_before_sweep = heap->CapacityInWords(Heap::kOld);
+
+  // No time left: the sweep is not advanced.
+  const int64_t now = OS::GetCurrentMonotonicMicros();
+  heap->old_space()->PerformIdleSlice(thread, now);
+  EXPECT(live.raw()->IsMarked());
+  EXPECT_EQ(capacity_before_sweep, heap->CapacityInWords(Heap::kOld));
+
+  // Plenty of time: the slice completes the sweep.
+  heap->old_space()->PerformIdleSlice(thread,
+                                      now + 10 * kMicrosecondsPerSecond);
+  EXPECT(!live.raw()->IsMarked());
+  EXPECT(heap->CapacityInWords(Heap::kOld) < capacity_before_sweep);
+
+  FLAG_lazy_sweep = saved_lazy_sweep;
+}
+
+ISOLATE_UNIT_TEST_CASE(ThreadAllocationBuffer) {
+  Heap* heap = thread->isolate()->heap();
+  PageSpace* old_space = heap->old_space();
+  const intptr_t size = 4 * kObjectAlignment;
+  {
+    NoSafepointScope no_safepoint;
+    const uword first = old_space->TryAllocateInThreadBuffer(
+        thread, size, PageSpace::kForceGrowth);
+    const uword second = old_space->TryAllocateInThreadBuffer(
+        thread, size, PageSpace::kForceGrowth);
+    // Both come from the same chunk.
+    EXPECT_EQ(first + size, second);
+    EXPECT_EQ(second + size, thread->old_top());
+    EXPECT(thread->old_end() > thread->old_top());
+    // Keep the allocations walkable.
+    FreeListElement::AsElement(first, size);
+    FreeListElement::AsElement(second, size);
+  }
+  // The rest of the chunk is given back before the collection.
+  heap->CollectGarbage(Heap::kOld);
+  EXPECT_EQ(static_cast<uword>(0), thread->old_top());
+  EXPECT_EQ(static_cast<uword>(0), thread->old_end());
+}
+
+static intptr_t soft_limit_finalizer_calls = 0;
+
+static void SoftLimitFinalizer(void* isolate_callback_data,
+                               Dart_WeakPersistentHandle handle,
+                               void* peer) {
+  soft_limit_finalizer_calls++;
+}
+
+TEST_CASE(ExternalSoftLimit) {
+  const int saved_external_soft_limit = FLAG_external_soft_limit;
+  FLAG_external_soft_limit = 1;
+  static uint8_t data[16] = {0};
+  soft_limit_finalizer_calls = 0;
+  for (intptr_t i = 0; i < 10; i++) {
+    Dart_EnterScope();
+    Dart_Handle obj = Dart_NewExternalTypedDataWithFinalizer(
+        Dart_TypedData_kUint8, data, ARRAY_SIZE(data), NULL, 512 * KB,
+        SoftLimitFinalizer);
+    EXPECT_VALID(obj);
+    Dart_ExitScope();
+  }
+  // Crossing the limit collected the dead owners of earlier allocations, so
+  // the live external data stays close to it.
+  EXPECT(soft_limit_finalizer_calls > 0);
+  Heap* heap = Isolate::Current()->heap();
+  EXPECT((heap->ExternalInWords(Heap::kNew) +
+          heap->ExternalInWords(Heap::kOld)) <= 2 * MBInWords);
+  FLAG_external_soft_limit = saved_external_soft_limit;
+}
+
+ISOLATE_UNIT_TEST_CASE(SelectiveCompaction) {
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+
+  const intptr_t kNumElements = 4000;
+  const Array& holder = Array::Handle(Array::New(kNumElements, Heap::kOld));
+  {
+    HANDLESCOPE(thread);
+    Array& element = Array::Handle();
+    for (intptr_t i = 0; i < kNumElements; i++) {
+      element = Array::New(100, Heap::kOld);
+      element.SetAt(0, Smi::Handle(Smi::New(i)));
+      holder.SetAt(i, element);
+    }
+  }
+  // Drop three out of four elements and sweep, leaving the pages fragmented.
+  for (intptr_t i = 0; i < kNumElements; i++) {
+    if ((i % 4) != 0) {
+      holder.SetAt(i, Object::null_object());
+    }
+  }
+  heap->CollectGarbage(Heap::kOld);
+  heap->WaitForSweeperTasks(thread);
+  const int64_t capacity_before = heap->CapacityInWords(Heap::kOld);
+
+  const bool saved_selective_compaction = FLAG_selective_compaction;
+  const intptr_t saved_budget = FLAG_selective_compaction_budget;
+  FLAG_selective_compaction = true;
+  FLAG_selective_compaction_budget = 1000000;
+  heap->CollectGarbage(Heap::kOld);
+  heap->WaitForSweeperTasks(thread);
+  FLAG_selective_compaction = saved_selective_compaction;
+  FLAG_selective_compaction_budget = saved_budget;
+
+  EXPECT(heap->CapacityInWords(Heap::kOld) < capacity_before);
+  Array& element = Array::Handle();
+  for (intptr_t i = 0; i < kNumElements; i += 4) {
+    element ^= holder.At(i);
+    EXPECT_EQ(i, Smi::Value(Smi::RawCast(element.At(0))));
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(PageCache) {
+  Heap* heap = thread->isolate()->heap();
+  PageSpace* old_space = heap->old_space();
+  heap->CollectAllGarbage();
+  heap->WaitForSweeperTasks(thread);
+  old_space->TrimPageCache(true);
+  EXPECT_EQ(0, old_space->PageCacheSizeInWords());
+
+  {
+    HANDLESCOPE(thread);
+    Array& garbage = Array::Handle();
+    for (intptr_t i = 0; i < 1000; i++) {
+      garbage = Array::New(100, Heap::kOld);
+    }
+  }
+  heap->CollectGarbage(Heap::kOld);
+  heap->WaitForSweeperTasks(thread);
+  const intptr_t cached = old_space->PageCacheSizeInWords();
+  EXPECT(cached > 0);
+
+  // Growing the heap again reuses the cached pages.
+  {
+    HANDLESCOPE(thread);
+    Array& garbage = Array::Handle();
+    for (intptr_t i = 0; i < 1000; i++) {
+      garbage = Array::New(100, Heap::kOld);
+    }
+  }
+  EXPECT(old_space->PageCacheSizeInWords() < cached);
+
+  old_space->TrimPageCache(true);
+  EXPECT_EQ(0, old_space->PageCacheSizeInWords());
+}
+
+ISOLATE_UNIT_TEST_CASE(CardMarking) {
+  Heap* heap = thread->isolate()->heap();
+  heap->CollectAllGarbage();
+
+  const intptr_t len = Array::kMaxNewSpaceElements * 4;
+  const Array& big = Array::Handle(Array::New(len, Heap::kNew));
+  EXPECT(big.raw()->IsOldObject());
+  EXPECT(big.raw()->IsCardRemembered());
+  EXPECT(!Array::UseCardMarkingForAllocation(1));
+
+  // Storing a new object only dirties the card covering the slot.
+  const intptr_t index = len - 7;
+  Array& element = Array::Handle(Array::New(1, Heap::kNew));
+  element.SetAt(0, Smi::Handle(Smi::New(42)));
+  big.SetAt(index, element);
+  EXPECT(!big.raw()->IsRemembered());
+  element = Array::null();
+
+  // The card keeps the element alive until it is promoted.
+  heap->CollectGarbage(Heap::kNew);
+  heap->CollectGarbage(Heap::kNew);
+  element ^= big.At(index);
+  EXPECT(element.raw()->IsOldObject());
+  EXPECT_EQ(42, Smi::Value(Smi::RawCast(element.At(0))));
+  EXPECT(big.At(0) == Object::null());
+
+  heap->CollectAllGarbage();
+  element ^= big.At(index);
+  EXPECT_EQ(42, Smi::Value(Smi::RawCast(element.At(0))));
+}
+
 static void NoopFinalizer(void* isolate_callback_data,
                           Dart_WeakPersistentHandle handle,
                           void* peer) {}
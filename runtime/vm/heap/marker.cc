@@ -123,6 +123,14 @@ class MarkerWorkList : public ValueObject {
     work_->Push(raw_obj);
   }
 
+  // Makes the objects pushed so far available to other markers.
+  void Flush() {
+    if (!work_->IsEmpty()) {
+      marking_stack_->PushBlock(work_);
+      work_ = marking_stack_->PopEmptyBlock();
+    }
+  }
+
   void Finalize() {
     ASSERT(work_->IsEmpty());
     marking_stack_->PushBlock(work_);
@@ -136,13 +144,16 @@ class MarkerWorkList : public ValueObject {
   MarkingStack* marking_stack_;
 };
 
+// A concurrent marking visitor leaves the store buffer to the mutator instead
+// of rebuilding it, and yields to safepoint operations such as scavenges.
 template <bool sync>
 class MarkingVisitorBase : public ObjectPointerVisitor {
  public:
   MarkingVisitorBase(Isolate* isolate,
                      PageSpace* page_space,
                      MarkingStack* marking_stack,
-                     SkippedCodeFunctions* skipped_code_functions)
+                     SkippedCodeFunctions* skipped_code_functions,
+                     bool concurrent)
       : ObjectPointerVisitor(isolate),
         thread_(Thread::Current()),
 #ifndef PRODUCT
@@ -154,7 +165,8 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         delayed_weak_properties_(NULL),
         visiting_old_object_(NULL),
         skipped_code_functions_(skipped_code_functions),
-        marked_bytes_(0) {
+        marked_bytes_(0),
+        concurrent_(concurrent) {
     ASSERT(thread_->isolate() == isolate);
 #ifndef PRODUCT
     class_stats_count_.SetLength(isolate->class_table()->NumCids());
@@ -169,6 +181,8 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   uintptr_t marked_bytes() const { return marked_bytes_; }
 
 #ifndef PRODUCT
+  intptr_t num_cids() const { return class_stats_count_.length(); }
+
   intptr_t live_count(intptr_t class_id) {
     return class_stats_count_[class_id];
   }
@@ -176,7 +190,14 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   intptr_t live_size(intptr_t class_id) { return class_stats_size_[class_id]; }
 #endif  // !PRODUCT
 
-  bool ProcessPendingWeakProperties() {
+  // Resolves the pending weak properties whose keys have been marked, and
+  // returns whether that marked anything. With 'scan_values', what their
+  // values reach is scanned right away, so that keys marked by it resolve
+  // properties later in the same pass rather than in another pass over all
+  // pending properties: chains of ephemerons, as expandos holding objects
+  // that are keys of other expandos, then take a few passes instead of one
+  // per link.
+  bool ProcessPendingWeakProperties(bool scan_values) {
     bool marked = false;
     RawWeakProperty* cur_weak = delayed_weak_properties_;
     delayed_weak_properties_ = NULL;
@@ -193,6 +214,12 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
         // originating from this weak property.
         VisitingOldObject(cur_weak);
         cur_weak->VisitPointersNonvirtual(this);
+        if (scan_values) {
+          RawObject* raw_obj;
+          while ((raw_obj = work_list_.Pop()) != NULL) {
+            Scan(raw_obj);
+          }
+        }
       } else {
         // Requeue this weak property to be handled later.
         EnqueueWeakProperty(cur_weak);
@@ -206,39 +233,50 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
   void DrainMarkingStack() {
     RawObject* raw_obj = work_list_.Pop();
-    if ((raw_obj == NULL) && ProcessPendingWeakProperties()) {
-      raw_obj = work_list_.Pop();
-    }
-
-    if (raw_obj == NULL) {
-      ASSERT(visiting_old_object_ == NULL);
-      return;
-    }
+    bool marked;
     do {
-      do {
-        // First drain the marking stacks.
-        VisitingOldObject(raw_obj);
-        const intptr_t class_id = raw_obj->GetClassId();
-        if (class_id != kWeakPropertyCid) {
-          marked_bytes_ += raw_obj->VisitPointersNonvirtual(this);
-        } else {
-          RawWeakProperty* raw_weak =
-              reinterpret_cast<RawWeakProperty*>(raw_obj);
-          marked_bytes_ += ProcessWeakProperty(raw_weak);
-        }
+      // First drain the marking stacks.
+      while (raw_obj != NULL) {
+        Scan(raw_obj);
         raw_obj = work_list_.Pop();
-      } while (raw_obj != NULL);
+      }
 
-      // Marking stack is empty.
-      ProcessPendingWeakProperties();
+      // Marking stack is empty. If resolving weak properties marked anything,
+      // more of them may resolve in another pass.
+      marked = ProcessPendingWeakProperties(true);
 
-      // Check whether any further work was pushed either by other markers or
-      // by the handling of weak properties.
+      // Check whether any further work was pushed by other markers.
       raw_obj = work_list_.Pop();
-    } while (raw_obj != NULL);
+    } while (marked || (raw_obj != NULL));
     VisitingOldObject(NULL);
   }
 
+  // Like DrainMarkingStack, but gives up once 'deadline' has passed. Returns
+  // true if the marking stack ran out of work.
+  bool DrainMarkingStackUntil(int64_t deadline) {
+    // Reading the clock for every object would dominate scanning small ones.
+    const intptr_t kObjectsBetweenDeadlineChecks = 64;
+    intptr_t until_check = kObjectsBetweenDeadlineChecks;
+    while (true) {
+      RawObject* raw_obj = work_list_.Pop();
+      if ((raw_obj == NULL) && ProcessPendingWeakProperties(false)) {
+        raw_obj = work_list_.Pop();
+      }
+      if (raw_obj == NULL) {
+        VisitingOldObject(NULL);
+        return true;
+      }
+      Scan(raw_obj);
+      if (--until_check == 0) {
+        until_check = kObjectsBetweenDeadlineChecks;
+        if (OS::GetCurrentMonotonicMicros() >= deadline) {
+          VisitingOldObject(NULL);
+          return false;
+        }
+      }
+    }
+  }
+
   void VisitPointers(RawObject** first, RawObject** last) {
     for (RawObject** current = first; current <= last; current++) {
       MarkObject(*current, current);
@@ -297,12 +335,51 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
     }
   }
 
+  // Called when a concurrent marker stops before marking is complete: makes
+  // the remaining work available to other markers, and returns the pending
+  // weak properties.
+  RawWeakProperty* Abandon() {
+    ASSERT(concurrent_);
+    ASSERT(skipped_code_functions_ == NULL);
+    work_list_.Flush();
+    work_list_.Finalize();
+    RawWeakProperty* result = delayed_weak_properties_;
+    delayed_weak_properties_ = NULL;
+    return result;
+  }
+
+  // Takes over the pending weak properties of abandoned markers.
+  void AdoptWeakProperties(RawWeakProperty* list) {
+    while (list != NULL) {
+      RawWeakProperty* next = reinterpret_cast<RawWeakProperty*>(
+          list->ptr()->next_);
+      list->ptr()->next_ = 0;
+      EnqueueWeakProperty(list);
+      list = next;
+    }
+  }
+
   void VisitingOldObject(RawObject* obj) {
     ASSERT((obj == NULL) || obj->IsOldObject());
     visiting_old_object_ = obj;
   }
 
  private:
+  // Visits the pointers of a grey object taken off the marking stack.
+  void Scan(RawObject* raw_obj) {
+    VisitingOldObject(raw_obj);
+    const intptr_t class_id = raw_obj->GetClassId();
+    if (class_id != kWeakPropertyCid) {
+      marked_bytes_ += raw_obj->VisitPointersNonvirtual(this);
+    } else {
+      RawWeakProperty* raw_weak = reinterpret_cast<RawWeakProperty*>(raw_obj);
+      marked_bytes_ += ProcessWeakProperty(raw_weak);
+    }
+    if (concurrent_) {
+      thread_->CheckForSafepoint();
+    }
+  }
+
   void PushMarked(RawObject* raw_obj) {
     ASSERT(raw_obj->IsHeapObject());
     ASSERT((FLAG_verify_gc_contains)
@@ -311,10 +388,10 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
     // Push the marked object on the marking stack.
     ASSERT(raw_obj->IsMarked());
-    // We acquired the mark bit => no other task is modifying the header.
-    // TODO(koda): For concurrent mutator, this needs synchronization. Consider
-    // clearing these bits already in the CAS for the mark bit.
-    raw_obj->ClearRememberedBitUnsynchronized();
+    if (!concurrent_) {
+      // We acquired the mark bit => no other task is modifying the header.
+      raw_obj->ClearRememberedBitUnsynchronized();
+    }
     work_list_.Push(raw_obj);
   }
 
@@ -375,7 +452,16 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   }
 
   void ProcessNewSpaceObject(RawObject* raw_obj, RawObject** p) {
+    if (concurrent_) {
+      // The mutator keeps the store buffer up to date.
+      return;
+    }
     // TODO(iposva): Add consistency check.
+    if ((visiting_old_object_ != NULL) &&
+        visiting_old_object_->IsCardRemembered()) {
+      HeapPage::Of(visiting_old_object_)->RememberCard(p);
+      return;
+    }
     if ((visiting_old_object_ != NULL) &&
         TryAcquireRememberedBit(visiting_old_object_)) {
       // NOTE: We pass in the pointer to the address we are visiting
@@ -392,7 +478,8 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
 
 #ifndef PRODUCT
   void UpdateLiveOld(intptr_t class_id, intptr_t size) {
-    // TODO(koda): Support growing the array once mutator runs concurrently.
+    // Objects allocated while marking concurrently are allocated black, so
+    // classes registered after this visitor was created are never seen here.
     ASSERT(class_id < class_stats_count_.length());
     class_stats_count_[class_id] += 1;
     class_stats_size_[class_id] += size;
@@ -410,6 +497,7 @@ class MarkingVisitorBase : public ObjectPointerVisitor {
   RawObject* visiting_old_object_;
   SkippedCodeFunctions* skipped_code_functions_;
   uintptr_t marked_bytes_;
+  const bool concurrent_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(MarkingVisitorBase);
 };
@@ -440,7 +528,8 @@ class MarkingWeakVisitor : public HandleVisitor {
         reinterpret_cast<FinalizablePersistentHandle*>(addr);
     RawObject* raw_obj = handle->raw();
     if (IsUnreachable(raw_obj)) {
-      handle->UpdateUnreachable(thread()->isolate());
+      handle->PrepareFinalization(thread()->isolate());
+      unreachable_.Add(handle);
     } else {
 #ifndef PRODUCT
       intptr_t cid = raw_obj->GetClassIdMayBeSmi();
@@ -454,12 +543,27 @@ class MarkingWeakVisitor : public HandleVisitor {
     }
   }
 
+  // Queues the finalizers of the unreachable handles found.
+  void Finalize() {
+    thread()->isolate()->api_state()->AddPendingFinalizers(unreachable_);
+    unreachable_.Clear();
+  }
+
  private:
   ClassTable* class_table_;
+  MallocGrowableArray<FinalizablePersistentHandle*> unreachable_;
 
   DISALLOW_COPY_AND_ASSIGN(MarkingWeakVisitor);
 };
 
+GCMarker::GCMarker(Heap* heap)
+    : heap_(heap),
+      marked_bytes_(0),
+      weak_micros_(0),
+      delayed_weak_properties_(NULL),
+      num_busy_(0),
+      num_running_(0) {}
+
 void GCMarker::Prologue(Isolate* isolate) {
   isolate->PrepareForGC();
   // The store buffers will be rebuilt as part of marking, reset them now.
@@ -485,18 +589,28 @@ void GCMarker::IterateRoots(Isolate* isolate,
   // slices are empty.
 }
 
-void GCMarker::IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor) {
+void GCMarker::IterateWeakRoots(Isolate* isolate,
+                                HandleVisitor* visitor,
+                                intptr_t slice_index,
+                                intptr_t num_slices) {
   ApiState* state = isolate->api_state();
   ASSERT(state != NULL);
-  isolate->VisitWeakPersistentHandles(visitor);
+  isolate->VisitWeakPersistentHandles(visitor, slice_index, num_slices);
 }
 
-void GCMarker::ProcessWeakTables(PageSpace* page_space) {
+void GCMarker::ProcessWeakTables(PageSpace* page_space,
+                                 intptr_t slice_index,
+                                 intptr_t num_slices) {
+  ASSERT(0 <= slice_index && slice_index < num_slices);
   for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
     WeakTable* table =
         heap_->GetWeakTable(Heap::kOld, static_cast<Heap::WeakSelector>(sel));
-    intptr_t size = table->size();
-    for (intptr_t i = 0; i < size; i++) {
+    // Entries are only invalidated, never moved, so the slices of the table
+    // can be swept independently.
+    const intptr_t size = table->size();
+    const intptr_t begin = size * slice_index / num_slices;
+    const intptr_t end = size * (slice_index + 1) / num_slices;
+    for (intptr_t i = begin; i < end; i++) {
       if (table->IsValidEntryAt(i)) {
         RawObject* raw_obj = table->ObjectAt(i);
         ASSERT(raw_obj->IsHeapObject());
@@ -572,7 +686,7 @@ class MarkTask : public ThreadPool::Task {
       SkippedCodeFunctions* skipped_code_functions =
           collect_code_ ? new (zone) SkippedCodeFunctions() : NULL;
       SyncMarkingVisitor visitor(isolate_, page_space_, marking_stack_,
-                                 skipped_code_functions);
+                                 skipped_code_functions, false);
       // Phase 1: Iterate over roots and drain marking stack in tasks.
       marker_->IterateRoots(isolate_, &visitor, task_index_, num_tasks_);
 
@@ -609,7 +723,7 @@ class MarkTask : public ThreadPool::Task {
 #endif
         // Check if we have any pending properties with marked keys.
         // Those might have been marked by another marker.
-        more_to_mark = visitor.ProcessPendingWeakProperties();
+        more_to_mark = visitor.ProcessPendingWeakProperties(false);
         if (more_to_mark) {
           // We have more work to do. Notify others.
           AtomicOperations::FetchAndIncrement(num_busy_);
@@ -629,7 +743,15 @@ class MarkTask : public ThreadPool::Task {
         barrier_->Sync();
       } while (more_to_mark);
 
-      // Phase 2: Weak processing and follow-up marking on main thread.
+      // Phase 2: Weak processing, split between the tasks.
+      {
+        TIMELINE_FUNCTION_GC_DURATION(thread, "WeakHandleProcessing");
+        MarkingWeakVisitor mark_weak(thread);
+        marker_->IterateWeakRoots(isolate_, &mark_weak, task_index_,
+                                  num_tasks_);
+        mark_weak.Finalize();
+      }
+      marker_->ProcessWeakTables(page_space_, task_index_, num_tasks_);
       barrier_->Sync();
 
       // Phase 3: Finalize results from all markers (detach code, etc.).
@@ -660,6 +782,131 @@ class MarkTask : public ThreadPool::Task {
   DISALLOW_COPY_AND_ASSIGN(MarkTask);
 };
 
+class ConcurrentMarkTask : public ThreadPool::Task {
+ public:
+  ConcurrentMarkTask(GCMarker* marker, Isolate* isolate, PageSpace* page_space)
+      : marker_(marker), isolate_(isolate), page_space_(page_space) {}
+
+  virtual void Run() {
+    // Unlike the tasks of a stop-the-world marking, concurrent markers take
+    // part in safepoint operations.
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kMarkerTask, false);
+    ASSERT(result);
+    bool last = false;
+    {
+      Thread* thread = Thread::Current();
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ConcurrentMarkTask");
+      {
+        StackZone stack_zone(thread);
+        MarkingStack* marking_stack = &marker_->marking_stack_;
+        uintptr_t* num_busy = &marker_->num_busy_;
+        SyncMarkingVisitor visitor(isolate_, page_space_, marking_stack, NULL,
+                                   true);
+        do {
+          visitor.DrainMarkingStack();
+
+          // Same termination protocol as for MarkTask. Work pushed by the
+          // mutator or the scavenger after all markers stopped is left for
+          // the remark.
+          if (AtomicOperations::FetchAndDecrement(num_busy) == 1) break;
+          while (marking_stack->IsEmpty() &&
+                 AtomicOperations::LoadRelaxed(num_busy) > 0) {
+            thread->CheckForSafepoint();
+          }
+          if (AtomicOperations::LoadRelaxed(num_busy) == 0) break;
+          AtomicOperations::FetchAndIncrement(num_busy);
+        } while (true);
+        if (FLAG_log_marker_tasks) {
+          THR_Print("Concurrent task marked %" Pd " bytes.\n",
+                    visitor.marked_bytes());
+        }
+        marker_->AbandonResultsFrom(&visitor);
+      }
+      // The last marker to stop completes the collection.
+      last = AtomicOperations::FetchAndDecrement(&marker_->num_running_) == 1;
+      if (last) {
+        page_space_->FinishConcurrentMarking(thread);
+      }
+    }
+    // Exit isolate cleanly *before* notifying it, to avoid shutdown race.
+    Thread::ExitIsolateAsHelper(false);
+    if (last) {
+      MonitorLocker ml(page_space_->tasks_lock());
+      page_space_->set_tasks(page_space_->tasks() - 1);
+      ml.NotifyAll();
+    }
+  }
+
+ private:
+  GCMarker* marker_;
+  Isolate* isolate_;
+  PageSpace* page_space_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentMarkTask);
+};
+
+bool GCMarker::JoinConcurrentMark() {
+  // The mutator cannot reach a safepoint here, so if any marker is still
+  // running the remark cannot start until we have left again.
+  uintptr_t running = AtomicOperations::LoadRelaxed(&num_running_);
+  while (running > 0) {
+    const uintptr_t seen = AtomicOperations::CompareAndSwapWord(
+        &num_running_, running, running + 1);
+    if (seen == running) {
+      return true;
+    }
+    running = seen;
+  }
+  return false;
+}
+
+bool GCMarker::AssistConcurrentMark(Isolate* isolate,
+                                    PageSpace* page_space,
+                                    int64_t deadline) {
+  Thread* thread = Thread::Current();
+  {
+    TIMELINE_FUNCTION_GC_DURATION(thread, "IdleMarkSlice");
+    StackZone stack_zone(thread);
+    // The mutator does not count in num_busy_: the tasks may stop while it
+    // still marks, and what it has not marked by the deadline is left for
+    // the remark like the work pushed by its write barrier.
+    SyncMarkingVisitor visitor(isolate, page_space, &marking_stack_, NULL,
+                               true);
+    visitor.DrainMarkingStackUntil(deadline);
+    if (FLAG_log_marker_tasks) {
+      THR_Print("Mutator marked %" Pd " bytes during idle time.\n",
+                visitor.marked_bytes());
+    }
+    AbandonResultsFrom(&visitor);
+  }
+  return AtomicOperations::FetchAndDecrement(&num_running_) == 1;
+}
+
+template <class MarkingVisitorType>
+void GCMarker::AbandonResultsFrom(MarkingVisitorType* visitor) {
+  RawWeakProperty* cur_weak = visitor->Abandon();
+  MutexLocker ml(&stats_mutex_);
+  marked_bytes_ += visitor->marked_bytes();
+#ifndef PRODUCT
+  for (intptr_t i = 0; i < visitor->num_cids(); ++i) {
+    if (i == live_count_.length()) {
+      live_count_.Add(0);
+      live_size_.Add(0);
+    }
+    live_count_[i] += visitor->live_count(i);
+    live_size_[i] += visitor->live_size(i);
+  }
+#endif  // !PRODUCT
+  while (cur_weak != NULL) {
+    RawWeakProperty* next_weak =
+        reinterpret_cast<RawWeakProperty*>(cur_weak->ptr()->next_);
+    cur_weak->ptr()->next_ = reinterpret_cast<uword>(delayed_weak_properties_);
+    delayed_weak_properties_ = cur_weak;
+    cur_weak = next_weak;
+  }
+}
+
 template <class MarkingVisitorType>
 void GCMarker::FinalizeResultsFrom(MarkingVisitorType* visitor) {
   {
@@ -699,14 +946,18 @@ void GCMarker::MarkObjects(Isolate* isolate,
       SkippedCodeFunctions* skipped_code_functions =
           collect_code ? new (zone) SkippedCodeFunctions() : NULL;
       UnsyncMarkingVisitor mark(isolate, page_space, &marking_stack,
-                                skipped_code_functions);
+                                skipped_code_functions, false);
       IterateRoots(isolate, &mark, 0, 1);
       mark.DrainMarkingStack();
+      const int64_t weak_start = OS::GetCurrentMonotonicMicros();
       {
         TIMELINE_FUNCTION_GC_DURATION(thread, "WeakHandleProcessing");
         MarkingWeakVisitor mark_weak(thread);
-        IterateWeakRoots(isolate, &mark_weak);
+        IterateWeakRoots(isolate, &mark_weak, 0, 1);
+        mark_weak.Finalize();
       }
+      ProcessWeakTables(page_space, 0, 1);
+      weak_micros_ += OS::GetCurrentMonotonicMicros() - weak_start;
       // All marking done; detach code, etc.
       FinalizeResultsFrom(&mark);
     } else {
@@ -743,21 +994,140 @@ void GCMarker::MarkObjects(Isolate* isolate,
         barrier.Sync();
       } while (more_to_mark);
 
-      // Phase 2: Weak processing on main thread.
-      {
-        TIMELINE_FUNCTION_GC_DURATION(thread, "WeakHandleProcessing");
-        MarkingWeakVisitor mark_weak(thread);
-        IterateWeakRoots(isolate, &mark_weak);
-      }
+      // Phase 2: Weak processing in tasks.
+      const int64_t weak_start = OS::GetCurrentMonotonicMicros();
       barrier.Sync();
+      weak_micros_ += OS::GetCurrentMonotonicMicros() - weak_start;
 
       // Phase 3: Finalize results from all markers (detach code, etc.).
       barrier.Exit();
     }
-    ProcessWeakTables(page_space);
     ProcessObjectIdTable(isolate);
   }
   Epilogue(isolate);
 }
 
+template <class MarkingVisitorType>
+void GCMarker::RemarkStoreBuffer(Isolate* isolate,
+                                 MarkingVisitorType* visitor) {
+  // While marking concurrently, the mutator also remembers the old objects it
+  // writes to. Visit those that were marked already again; the entries stay
+  // in the store buffer.
+  StoreBuffer* store_buffer = isolate->store_buffer();
+  StoreBufferBlock* reading = store_buffer->Blocks();
+  StoreBufferBlock* writing = store_buffer->PopEmptyBlock();
+  while (reading != NULL) {
+    StoreBufferBlock* next = reading->next();
+    while (!reading->IsEmpty()) {
+      RawObject* raw_obj = reading->Pop();
+      ASSERT(raw_obj->IsRemembered());
+      if (raw_obj->IsMarked()) {
+        visitor->VisitingOldObject(raw_obj);
+        raw_obj->VisitPointersNonvirtual(visitor);
+      }
+      if (writing->IsFull()) {
+        store_buffer->PushBlock(writing, StoreBuffer::kIgnoreThreshold);
+        writing = store_buffer->PopEmptyBlock();
+      }
+      writing->Push(raw_obj);
+    }
+    reading->Reset();
+    store_buffer->PushBlock(reading, StoreBuffer::kIgnoreThreshold);
+    reading = next;
+  }
+  store_buffer->PushBlock(writing, StoreBuffer::kIgnoreThreshold);
+  visitor->VisitingOldObject(NULL);
+}
+
+void GCMarker::PruneStoreBuffer(Isolate* isolate) {
+  // Unmarked objects are about to be swept, so drop them from the store
+  // buffer.
+  StoreBuffer* store_buffer = isolate->store_buffer();
+  StoreBufferBlock* reading = store_buffer->Blocks();
+  StoreBufferBlock* writing = store_buffer->PopEmptyBlock();
+  while (reading != NULL) {
+    StoreBufferBlock* next = reading->next();
+    while (!reading->IsEmpty()) {
+      RawObject* raw_obj = reading->Pop();
+      if (!raw_obj->IsMarked()) {
+        continue;
+      }
+      if (writing->IsFull()) {
+        store_buffer->PushBlock(writing, StoreBuffer::kIgnoreThreshold);
+        writing = store_buffer->PopEmptyBlock();
+      }
+      writing->Push(raw_obj);
+    }
+    reading->Reset();
+    store_buffer->PushBlock(reading, StoreBuffer::kIgnoreThreshold);
+    reading = next;
+  }
+  store_buffer->PushBlock(writing, StoreBuffer::kIgnoreThreshold);
+}
+
+void GCMarker::StartConcurrentMark(Isolate* isolate, PageSpace* page_space) {
+  // Unlike in Prologue, the store buffer is kept: scavenges still need it
+  // while marking is in progress.
+  isolate->PrepareForGC();
+  marked_bytes_ = 0;
+  {
+    Thread* thread = Thread::Current();
+    StackZone stack_zone(thread);
+    UnsyncMarkingVisitor mark(isolate, page_space, &marking_stack_, NULL,
+                              true);
+    IterateRoots(isolate, &mark, 0, 1);
+    AbandonResultsFrom(&mark);
+  }
+  const intptr_t num_tasks = (FLAG_marker_tasks > 0) ? FLAG_marker_tasks : 1;
+  num_busy_ = num_tasks;
+  num_running_ = num_tasks;
+  for (intptr_t i = 0; i < num_tasks; ++i) {
+    ThreadPool* pool = Dart::thread_pool();
+    pool->Run(new ConcurrentMarkTask(this, isolate, page_space));
+  }
+}
+
+void GCMarker::FinishConcurrentMark(Isolate* isolate, PageSpace* page_space) {
+  ASSERT(AtomicOperations::LoadRelaxed(&num_running_) == 0);
+  isolate->PrepareForGC();
+  {
+    Thread* thread = Thread::Current();
+    StackZone stack_zone(thread);
+    UnsyncMarkingVisitor mark(isolate, page_space, &marking_stack_, NULL,
+                              true);
+    mark.AdoptWeakProperties(delayed_weak_properties_);
+    delayed_weak_properties_ = NULL;
+    // The roots may have changed, and objects may have been written to, since
+    // they were visited.
+    IterateRoots(isolate, &mark, 0, 1);
+    RemarkStoreBuffer(isolate, &mark);
+    mark.DrainMarkingStack();
+    const int64_t weak_start = OS::GetCurrentMonotonicMicros();
+    {
+      TIMELINE_FUNCTION_GC_DURATION(thread, "WeakHandleProcessing");
+      MarkingWeakVisitor mark_weak(thread);
+      IterateWeakRoots(isolate, &mark_weak, 0, 1);
+      mark_weak.Finalize();
+    }
+    weak_micros_ += OS::GetCurrentMonotonicMicros() - weak_start;
+    FinalizeResultsFrom(&mark);
+#ifndef PRODUCT
+    ClassTable* table = isolate->class_table();
+    for (intptr_t i = 0; i < live_count_.length(); ++i) {
+      if (live_count_[i] > 0) {
+        table->UpdateLiveOld(i, live_size_[i], live_count_[i]);
+      }
+    }
+    live_count_.Clear();
+    live_size_.Clear();
+#endif  // !PRODUCT
+  }
+  const int64_t weak_tables_start = OS::GetCurrentMonotonicMicros();
+  ProcessWeakTables(page_space, 0, 1);
+  weak_micros_ += OS::GetCurrentMonotonicMicros() - weak_tables_start;
+  ProcessObjectIdTable(isolate);
+  PruneStoreBuffer(isolate);
+  Epilogue(isolate);
+}
+
 }  // namespace dart
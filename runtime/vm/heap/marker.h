@@ -6,6 +6,8 @@
 #define RUNTIME_VM_HEAP_MARKER_H_
 
 #include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/heap/store_buffer.h"
 #include "vm/os_thread.h"  // Mutex.
 
 namespace dart {
@@ -20,15 +22,35 @@ class RawWeakProperty;
 
 // The class GCMarker is used to mark reachable old generation objects as part
 // of the mark-sweep collection. The marking bit used is defined in RawObject.
-class GCMarker : public ValueObject {
+class GCMarker {
  public:
-  explicit GCMarker(Heap* heap) : heap_(heap), marked_bytes_(0) {}
+  explicit GCMarker(Heap* heap);
   ~GCMarker() {}
 
   void MarkObjects(Isolate* isolate, PageSpace* page_space, bool collect_code);
 
+  // Concurrent marking. Both calls must be made inside a safepoint operation.
+  // StartConcurrentMark marks the roots and starts tasks that keep marking
+  // while the mutator runs. Once the tasks run out of work, the last one
+  // calls PageSpace::FinishConcurrentMarking, which uses FinishConcurrentMark
+  // to visit the roots and the objects written to in the meantime again.
+  void StartConcurrentMark(Isolate* isolate, PageSpace* page_space);
+  void FinishConcurrentMark(Isolate* isolate, PageSpace* page_space);
+
+  // Lets the mutator mark alongside the tasks during idle time. Joining fails
+  // once all markers have stopped. After joining, AssistConcurrentMark marks
+  // until 'deadline' or until it runs out of work, and returns true if the
+  // caller was the last marker to stop and has to finish the marking.
+  bool JoinConcurrentMark();
+  bool AssistConcurrentMark(Isolate* isolate,
+                            PageSpace* page_space,
+                            int64_t deadline);
+
   intptr_t marked_words() { return marked_bytes_ >> kWordSizeLog2; }
 
+  // Time the mutator was paused for weak handle and weak table processing.
+  int64_t weak_micros() const { return weak_micros_; }
+
  private:
   void Prologue(Isolate* isolate);
   void Epilogue(Isolate* isolate);
@@ -36,22 +58,48 @@ class GCMarker : public ValueObject {
                     ObjectPointerVisitor* visitor,
                     intptr_t slice_index,
                     intptr_t num_slices);
-  void IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor);
+  void IterateWeakRoots(Isolate* isolate,
+                        HandleVisitor* visitor,
+                        intptr_t slice_index,
+                        intptr_t num_slices);
   template <class MarkingVisitorType>
   void IterateWeakReferences(Isolate* isolate, MarkingVisitorType* visitor);
-  void ProcessWeakTables(PageSpace* page_space);
+  template <class MarkingVisitorType>
+  void RemarkStoreBuffer(Isolate* isolate, MarkingVisitorType* visitor);
+  void PruneStoreBuffer(Isolate* isolate);
+  void ProcessWeakTables(PageSpace* page_space,
+                         intptr_t slice_index,
+                         intptr_t num_slices);
   void ProcessObjectIdTable(Isolate* isolate);
 
   // Called by anyone: finalize and accumulate stats from 'visitor'.
   template <class MarkingVisitorType>
   void FinalizeResultsFrom(MarkingVisitorType* visitor);
 
+  // Called by concurrent markers that stop before marking is complete: keep
+  // the stats and pending weak properties of 'visitor' for the remark.
+  template <class MarkingVisitorType>
+  void AbandonResultsFrom(MarkingVisitorType* visitor);
+
   Heap* heap_;
 
   Mutex stats_mutex_;
   // TODO(koda): Remove after verifying it's redundant w.r.t. ClassHeapStats.
   uintptr_t marked_bytes_;
+  int64_t weak_micros_;
+
+  // State of a concurrent marking in progress.
+  MarkingStack marking_stack_;
+  RawWeakProperty* delayed_weak_properties_;
+  uintptr_t num_busy_;
+  uintptr_t num_running_;
+#ifndef PRODUCT
+  // Class heap stats are only updated in the remark, inside the safepoint.
+  MallocGrowableArray<intptr_t> live_count_;
+  MallocGrowableArray<intptr_t> live_size_;
+#endif  // !PRODUCT
 
+  friend class ConcurrentMarkTask;
   friend class MarkTask;
   DISALLOW_IMPLICIT_CONSTRUCTORS(GCMarker);
 };
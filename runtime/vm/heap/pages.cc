@@ -17,6 +17,7 @@
 #include "vm/object.h"
 #include "vm/object_set.h"
 #include "vm/os_thread.h"
+#include "vm/thread_registry.h"
 #include "vm/virtual_memory.h"
 
 namespace dart {
@@ -54,6 +55,41 @@ DEFINE_FLAG(bool,
             false,
             "Always try to drop code if the function's usage counter is >= 0");
 DEFINE_FLAG(bool, log_growth, false, "Log PageSpace growth policy decisions.");
+DEFINE_FLAG(int,
+            old_gen_page_cache_size,
+            16,
+            "The maximum number of freed old gen pages kept reserved for "
+            "reuse");
+DEFINE_FLAG(int,
+            gc_pause_goal,
+            0,
+            "When positive, the target maximum GC pause in milliseconds. Old "
+            "and new space are then sized for it and --gc_time_goal instead "
+            "of by the fixed growth ratios.");
+DEFINE_FLAG(int,
+            gc_time_goal,
+            5,
+            "The target percentage of time spent in GC with --gc_pause_goal.");
+DEFINE_FLAG(bool,
+            selective_compaction,
+            false,
+            "Compact the most fragmented data pages during mark-sweep.");
+DEFINE_FLAG(int,
+            selective_compaction_threshold,
+            50,
+            "The minimum percentage of a data page that must be free for it to "
+            "be compacted selectively");
+DEFINE_FLAG(int,
+            selective_compaction_budget,
+            2000,
+            "The time in microseconds selective compaction may spend moving "
+            "objects");
+
+// Threads allocating through TryAllocateInThreadBuffer get old space in chunks
+// of this size. Larger objects are allocated directly, which bounds the space
+// lost at the end of each chunk.
+static const intptr_t kThreadLabSize = 32 * KB;
+static const intptr_t kThreadLabMaxObjectSize = kThreadLabSize / 4;
 
 HeapPage* HeapPage::Allocate(intptr_t size_in_words,
                              PageType type,
@@ -61,18 +97,25 @@ HeapPage* HeapPage::Allocate(intptr_t size_in_words,
   bool is_executable = (type == kExecutable);
   // Create the new page executable (RWX) only if we're not in W^X mode
   bool create_executable = !FLAG_write_protect_code && is_executable;
-  VirtualMemory* memory = VirtualMemory::AllocateAligned(
-      size_in_words << kWordSizeLog2, kPageSize, create_executable, name);
+  // Large pages are truncated when their object shrinks.
+  const bool kTruncatable = true;
+  VirtualMemory* memory = VirtualMemory::AllocateWithHugePages(
+      size_in_words << kWordSizeLog2, kPageSize, create_executable,
+      kTruncatable, name);
   if (memory == NULL) {
     return NULL;
   }
+  return Initialize(memory, type);
+}
 
+HeapPage* HeapPage::Initialize(VirtualMemory* memory, PageType type) {
   HeapPage* result = reinterpret_cast<HeapPage*>(memory->address());
   ASSERT(result != NULL);
   result->memory_ = memory;
   result->next_ = NULL;
   result->used_in_bytes_ = 0;
   result->forwarding_page_ = NULL;
+  result->card_table_ = NULL;
   result->type_ = type;
 
   LSAN_REGISTER_ROOT_REGION(result, sizeof(*result));
@@ -85,6 +128,9 @@ void HeapPage::Deallocate() {
 
   bool image_page = is_image_page();
 
+  free(card_table_);
+  card_table_ = NULL;
+
   if (!image_page) {
     LSAN_UNREGISTER_ROOT_REGION(this, sizeof(*this));
   }
@@ -100,6 +146,51 @@ void HeapPage::Deallocate() {
   }
 }
 
+VirtualMemory* HeapPage::ReleaseMemory() {
+  ASSERT(forwarding_page_ == NULL);
+  ASSERT(!is_image_page());
+
+  free(card_table_);
+  card_table_ = NULL;
+
+  LSAN_UNREGISTER_ROOT_REGION(this, sizeof(*this));
+  return memory_;
+}
+
+void HeapPage::AllocateCardTable() {
+  ASSERT(card_table_ == NULL);
+  const intptr_t size = memory_->size() >> kBytesPerCardLog2;
+  card_table_ = reinterpret_cast<uint8_t*>(calloc(size, sizeof(uint8_t)));
+  if (card_table_ == NULL) {
+    OUT_OF_MEMORY();
+  }
+}
+
+void HeapPage::VisitRememberedCards(ObjectPointerVisitor* visitor) {
+  ASSERT(card_table_ != NULL);
+  RawArray* raw_array =
+      reinterpret_cast<RawArray*>(RawObject::FromAddr(object_start()));
+  ASSERT(raw_array->IsArray() || raw_array->IsImmutableArray());
+  ASSERT(raw_array->IsCardRemembered());
+  RawObject** obj_from = raw_array->from();
+  RawObject** obj_to =
+      raw_array->to(Smi::Value(raw_array->ptr()->length_));
+
+  const intptr_t size = memory_->size() >> kBytesPerCardLog2;
+  for (intptr_t i = 0; i < size; i++) {
+    if (card_table_[i] == 0) continue;
+    card_table_[i] = 0;
+    RawObject** card_from = reinterpret_cast<RawObject**>(
+        reinterpret_cast<uword>(this) + (i << kBytesPerCardLog2));
+    RawObject** card_to = card_from + (1 << kSlotsPerCardLog2) - 1;
+    if (card_from < obj_from) card_from = obj_from;
+    if (card_to > obj_to) card_to = obj_to;
+    if (card_from <= card_to) {
+      visitor->VisitPointers(card_from, card_to);
+    }
+  }
+}
+
 void HeapPage::VisitObjects(ObjectVisitor* visitor) const {
   ASSERT(Thread::Current()->IsAtSafepoint());
   NoSafepointScope no_safepoint;
@@ -188,6 +279,11 @@ PageSpace::PageSpace(Heap* heap, intptr_t max_capacity_in_words)
                              FLAG_old_gen_growth_space_ratio,
                              FLAG_old_gen_growth_rate,
                              FLAG_old_gen_growth_time_ratio),
+      marker_(NULL),
+      marking_start_micros_(0),
+      sweep_next_(NULL),
+      sweep_last_(NULL),
+      sweep_prev_(NULL),
       gc_time_micros_(0),
       collections_(0),
       mark_words_per_micro_(kConservativeInitialMarkSpeed) {
@@ -207,6 +303,7 @@ PageSpace::~PageSpace() {
   FreePages(exec_pages_);
   FreePages(large_pages_);
   FreePages(image_pages_);
+  TrimPageCache(true);
   delete pages_lock_;
   delete tasks_lock_;
 }
@@ -223,11 +320,21 @@ HeapPage* PageSpace::AllocatePage(HeapPage::PageType type) {
   char vm_name[kVmNameSize];
   Heap::RegionName(heap_, is_exec ? Heap::kCode : Heap::kOld, vm_name,
                    kVmNameSize);
-  HeapPage* page = HeapPage::Allocate(kPageSizeInWords, type, vm_name);
+  HeapPage* page = NULL;
+  if (!is_exec) {
+    MutexLocker ml(pages_lock_);
+    if (page_cache_.length() > 0) {
+      page = HeapPage::Initialize(page_cache_.RemoveLast(), type);
+    }
+  }
+  if (page == NULL) {
+    page = HeapPage::Allocate(kPageSizeInWords, type, vm_name);
+  }
   if (page == NULL) {
     RELEASE_ASSERT(!FLAG_abort_on_oom);
     return NULL;
   }
+  heap_->BindToNumaNode(page->memory_->start(), page->memory_->size());
 
   MutexLocker ml(pages_lock_);
   if (!is_exec) {
@@ -249,7 +356,9 @@ HeapPage* PageSpace::AllocatePage(HeapPage::PageType type) {
         exec_pages_tail_->WriteProtect(false);
       }
       exec_pages_tail_->set_next(page);
-      if (FLAG_write_protect_code) {
+      // Code pages stay writable while marking concurrently, as the markers
+      // set the mark bits of the objects in them.
+      if (FLAG_write_protect_code && !IsMarking()) {
         exec_pages_tail_->WriteProtect(true);
       }
     }
@@ -257,6 +366,9 @@ HeapPage* PageSpace::AllocatePage(HeapPage::PageType type) {
   }
   IncreaseCapacityInWordsLocked(kPageSizeInWords);
   page->set_object_end(page->memory_->end());
+  // Until it is first swept, treat the page as full so that selective
+  // compaction does not mistake it for a fragmented one.
+  page->set_used_in_bytes(page->object_end() - page->object_start());
   return page;
 }
 
@@ -271,6 +383,7 @@ HeapPage* PageSpace::AllocateLargePage(intptr_t size, HeapPage::PageType type) {
   if (page == NULL) {
     return NULL;
   }
+  heap_->BindToNumaNode(page->memory_->start(), page->memory_->size());
   page->set_next(large_pages_);
   large_pages_ = page;
   IncreaseCapacityInWords(page_size_in_words);
@@ -322,9 +435,32 @@ void PageSpace::FreePage(HeapPage* page, HeapPage* previous_page) {
         exec_pages_tail_ = previous_page;
       }
     }
+    DeallocatePageLocked(page);
+  }
+}
+
+void PageSpace::DeallocatePageLocked(HeapPage* page) {
+  DEBUG_ASSERT(pages_lock_->IsOwnedByCurrentThread());
+  if ((page->type() != HeapPage::kData) ||
+      (page_cache_.length() >= FLAG_old_gen_page_cache_size)) {
+    page->Deallocate();
+    return;
+  }
+  // Keep the reservation, so that regrowing the heap maps no new memory, but
+  // return the physical pages to the OS.
+  VirtualMemory* memory = page->ReleaseMemory();
+  memory->DontNeed();
+  page_cache_.Add(memory);
+}
+
+void PageSpace::TrimPageCache(bool all) {
+  MutexLocker ml(pages_lock_);
+  // Unmap half of the cache at a time, so a short idle period still leaves
+  // some pages for the next burst of allocation.
+  const intptr_t keep = all ? 0 : page_cache_.length() / 2;
+  while (page_cache_.length() > keep) {
+    delete page_cache_.RemoveLast();
   }
-  // TODO(iposva): Consider adding to a pool of empty pages.
-  page->Deallocate();
 }
 
 void PageSpace::FreeLargePage(HeapPage* page, HeapPage* previous_page) {
@@ -397,6 +533,16 @@ uword PageSpace::TryAllocateInternal(intptr_t size,
     } else {
       result = freelist_[type].TryAllocate(size, is_protected);
     }
+    if (type == HeapPage::kData) {
+      // Sweep more pages before growing the heap.
+      while ((result == 0) && SweepNextPage(is_locked)) {
+        if (is_locked) {
+          result = freelist_[type].TryAllocateLocked(size, is_protected);
+        } else {
+          result = freelist_[type].TryAllocate(size, is_protected);
+        }
+      }
+    }
     if (result == 0) {
       result = TryAllocateInFreshPage(size, type, growth_policy, is_locked);
       // usage_ is updated by the call above.
@@ -654,6 +800,12 @@ void PageSpace::VisitObjectsNoImagePages(ObjectVisitor* visitor) const {
   }
 }
 
+void PageSpace::AddPagesTo(MallocGrowableArray<HeapPage*>* pages) const {
+  for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
+    pages->Add(it.page());
+  }
+}
+
 void PageSpace::VisitObjectsImagePages(ObjectVisitor* visitor) const {
   for (ExclusivePageIterator it(this); !it.Done(); it.Advance()) {
     if (it.page()->is_image_page()) {
@@ -728,6 +880,7 @@ void PageSpace::PrintToJSONObject(JSONObject* object) const {
   space.AddProperty64("used", UsedInWords() * kWordSize);
   space.AddProperty64("capacity", CapacityInWords() * kWordSize);
   space.AddProperty64("external", ExternalInWords() * kWordSize);
+  space.AddProperty64("_pageCache", PageCacheSizeInWords() * kWordSize);
   space.AddProperty("time", MicrosecondsToSeconds(gc_time_micros()));
   if (collections() > 0) {
     int64_t run_time = isolate->UptimeMicros();
@@ -859,6 +1012,32 @@ bool PageSpace::ShouldPerformIdleMarkSweep(int64_t deadline) {
   return estimated_mark_completion <= deadline;
 }
 
+bool PageSpace::ShouldStartIdleMarking() {
+  // To make a consistent decision, we should not yield for a safepoint in the
+  // middle of deciding whether to perform an idle GC.
+  NoSafepointScope no_safepoint;
+
+  if (IsMarking() ||
+      !page_space_controller_.NeedsIdleGarbageCollection(usage_)) {
+    return false;
+  }
+
+  // A sweeper or a marking that is finishing would have to be waited for.
+  MonitorLocker locker(tasks_lock());
+  return tasks() == 0;
+}
+
+void PageSpace::PerformIdleSlice(Thread* thread, int64_t deadline) {
+  // The marker only changes inside safepoint operations, which cannot happen
+  // while the mutator is running here.
+  if (IsMarking()) {
+    AssistConcurrentMarking(thread, deadline);
+  }
+  // Sweep while there is time left, including right after a marking that
+  // was completed above.
+  SweepUntil(deadline);
+}
+
 bool PageSpace::ShouldPerformIdleMarkCompact(int64_t deadline) {
   // To make a consistent decision, we should not yield for a safepoint in the
   // middle of deciding whether to perform an idle GC.
@@ -899,7 +1078,7 @@ bool PageSpace::ShouldPerformIdleMarkCompact(int64_t deadline) {
   return estimated_mark_compact_completion <= deadline;
 }
 
-void PageSpace::CollectGarbage(bool compact) {
+void PageSpace::CollectGarbage(bool compact, bool concurrent) {
   Thread* thread = Thread::Current();
   Isolate* isolate = heap_->isolate();
   ASSERT(isolate == Isolate::Current());
@@ -909,12 +1088,28 @@ void PageSpace::CollectGarbage(bool compact) {
   // Wait for pending tasks to complete and then account for the driver task.
   {
     MonitorLocker locker(tasks_lock());
+    if (concurrent && IsMarking()) {
+      // The collection in progress will take care of this garbage.
+      return;
+    }
     while (tasks() > 0) {
       locker.WaitWithSafepointCheck(thread);
     }
     set_tasks(1);
   }
 
+  // Marking needs the mark bits left by the previous collection cleared.
+  CompleteLazySweep();
+
+  if (concurrent) {
+    ASSERT(!compact);
+    heap_->RecordTime(kConcurrentSweep,
+                      OS::GetCurrentMonotonicMicros() - pre_wait_for_sweepers);
+    // The marker tasks account for the driver task from now on.
+    StartConcurrentMarking(thread);
+    return;
+  }
+
   const int64_t pre_safe_point = OS::GetCurrentMonotonicMicros();
 
   // Ensure that all threads for this isolate are at a safepoint (either
@@ -932,6 +1127,10 @@ void PageSpace::CollectGarbage(bool compact) {
 
     NoSafepointScope no_safepoints;
 
+    // The marker does this too, but the verification below walks the heap
+    // before it runs.
+    isolate->thread_registry()->ReleaseOldAllocationBuffers();
+
     if (FLAG_print_free_list_before_gc) {
       OS::PrintErr("Data Freelist (before GC):\n");
       freelist_[HeapPage::kData].Print();
@@ -971,61 +1170,22 @@ void PageSpace::CollectGarbage(bool compact) {
     freelist_[HeapPage::kExecutable].Reset();
 
     int64_t mid2 = OS::GetCurrentMonotonicMicros();
-    int64_t mid3 = 0;
-
-    {
-      if (FLAG_verify_before_gc) {
-        OS::PrintErr("Verifying before sweeping...");
-        heap_->VerifyGC(kAllowMarked);
-        OS::PrintErr(" done.\n");
-      }
-      GCSweeper sweeper;
-
-      // During stop-the-world phases we should use bulk lock when adding
-      // elements to the free list.
-      MutexLocker mld(freelist_[HeapPage::kData].mutex());
-      MutexLocker mle(freelist_[HeapPage::kExecutable].mutex());
-
-      // Large and executable pages are always swept immediately.
-      HeapPage* prev_page = NULL;
-      HeapPage* page = large_pages_;
-      while (page != NULL) {
-        HeapPage* next_page = page->next();
-        const intptr_t words_to_end = sweeper.SweepLargePage(page);
-        if (words_to_end == 0) {
-          FreeLargePage(page, prev_page);
-        } else {
-          TruncateLargePage(page, words_to_end << kWordSizeLog2);
-          prev_page = page;
-        }
-        // Advance to the next page.
-        page = next_page;
-      }
-
-      prev_page = NULL;
-      page = exec_pages_;
-      FreeList* freelist = &freelist_[HeapPage::kExecutable];
-      while (page != NULL) {
-        HeapPage* next_page = page->next();
-        bool page_in_use = sweeper.SweepPage(page, freelist, true);
-        if (page_in_use) {
-          prev_page = page;
-        } else {
-          FreePage(page, prev_page);
-        }
-        // Advance to the next page.
-        page = next_page;
-      }
-
-      mid3 = OS::GetCurrentMonotonicMicros();
-    }
+    SweepLargeAndExecutablePages();
+    int64_t mid3 = OS::GetCurrentMonotonicMicros();
 
     if (compact) {
       Compact(thread);
-    } else if (FLAG_concurrent_sweep) {
-      ConcurrentSweep(isolate);
     } else {
-      BlockingSweep();
+      if (FLAG_selective_compaction) {
+        CompactFragmentedPages(thread);
+      }
+      if (FLAG_lazy_sweep) {
+        LazySweep();
+      } else if (FLAG_concurrent_sweep) {
+        ConcurrentSweep(isolate);
+      } else {
+        BlockingSweep();
+      }
     }
 
     // Make code pages read-only.
@@ -1052,6 +1212,7 @@ void PageSpace::CollectGarbage(bool compact) {
     heap_->RecordTime(kResetFreeLists, mid2 - mid1);
     heap_->RecordTime(kSweepPages, mid3 - mid2);
     heap_->RecordTime(kSweepLargePages, end - mid3);
+    heap_->RecordTime(kMarkWeaks, marker.weak_micros());
 
     if (FLAG_print_free_list_after_gc) {
       OS::PrintErr("Data Freelist (after GC):\n");
@@ -1064,6 +1225,7 @@ void PageSpace::CollectGarbage(bool compact) {
     if (heap_ != NULL) {
       heap_->UpdateGlobalMaxUsed();
     }
+    heap_->RunPendingFinalizers(thread, true);
   }
 
   // Done, reset the task count.
@@ -1074,6 +1236,177 @@ void PageSpace::CollectGarbage(bool compact) {
   }
 }
 
+void PageSpace::StartConcurrentMarking(Thread* thread) {
+  Isolate* isolate = heap_->isolate();
+  const int64_t pre_safe_point = OS::GetCurrentMonotonicMicros();
+  SafepointOperationScope safepoint_scope(thread);
+
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+
+  NOT_IN_PRODUCT(isolate->class_table()->ResetCountersOld());
+  // Perform various cleanup that relies on no tasks interfering.
+  isolate->class_table()->FreeOldTables();
+
+  NoSafepointScope no_safepoints;
+
+  // The markers set mark bits in code pages until marking completes.
+  WriteProtectCode(false);
+
+  usage_before_marking_ = GetCurrentUsage();
+  marking_start_micros_ = start;
+  ASSERT(marker_ == NULL);
+  ASSERT(sweep_next_ == NULL);
+  marker_ = new GCMarker(heap_);
+  // From now on, the mutator remembers every old object it writes to, and
+  // old objects are allocated black.
+  isolate->thread_registry()->SetMarking(true);
+  marker_->StartConcurrentMark(isolate, this);
+
+  heap_->RecordTime(kSafePoint, start - pre_safe_point);
+  heap_->RecordTime(kMarkObjects, OS::GetCurrentMonotonicMicros() - start);
+}
+
+void PageSpace::FinishConcurrentMarking(Thread* thread) {
+  Isolate* isolate = heap_->isolate();
+  ASSERT(thread->isolate() == isolate);
+  const int64_t pre_safe_point = OS::GetCurrentMonotonicMicros();
+  SafepointOperationScope safepoint_scope(thread);
+
+  const int64_t start = OS::GetCurrentMonotonicMicros();
+
+  NoSafepointScope no_safepoints;
+
+  isolate->thread_registry()->SetMarking(false);
+  GCMarker* marker = marker_;
+  marker_ = NULL;
+  marker->FinishConcurrentMark(isolate, this);
+  // Everything allocated since marking started was allocated black.
+  usage_.used_in_words =
+      marker->marked_words() +
+      (usage_.used_in_words - usage_before_marking_.used_in_words);
+  const int64_t weak_micros = marker->weak_micros();
+  delete marker;
+  const int64_t mid = OS::GetCurrentMonotonicMicros();
+
+  // Abandon the remainder of the bump allocation block.
+  AbandonBumpAllocation();
+  // Reset the freelists and setup sweeping.
+  freelist_[HeapPage::kData].Reset();
+  freelist_[HeapPage::kExecutable].Reset();
+  SweepLargeAndExecutablePages();
+  if (FLAG_selective_compaction) {
+    CompactFragmentedPages(thread);
+  }
+  if (FLAG_lazy_sweep) {
+    LazySweep();
+  } else if (FLAG_concurrent_sweep) {
+    ConcurrentSweep(isolate);
+  } else {
+    BlockingSweep();
+  }
+
+  // Make code pages read-only.
+  WriteProtectCode(true);
+
+  const int64_t end = OS::GetCurrentMonotonicMicros();
+
+  // Record signals for growth control. Include size of external allocations.
+  page_space_controller_.EvaluateGarbageCollection(
+      usage_before_marking_, GetCurrentUsage(), marking_start_micros_, end);
+  if (FLAG_log_marker_tasks) {
+    THR_Print("Concurrent marking finished in %" Pd64 " us, remark took %" Pd64
+              " us.\n",
+              end - marking_start_micros_, end - start);
+  }
+#if !defined(PRODUCT)
+  // The remark pause happens outside of Heap::CollectGarbage, so it is not
+  // in the GC stats; account for it directly.
+  isolate->GetGCOldPauseMetric()->Record(end - pre_safe_point);
+  isolate->GetGCOldSafepointMetric()->Record(start - pre_safe_point);
+  isolate->GetGCOldMarkMetric()->Record(mid - start - weak_micros);
+  isolate->GetGCOldWeaksMetric()->Record(weak_micros);
+  isolate->GetGCOldSweepMetric()->Record(end - mid);
+#endif  // !defined(PRODUCT)
+
+  // Some Code objects may have been collected so invalidate handler cache.
+  isolate->handler_info_cache()->Clear();
+  isolate->catch_entry_state_cache()->Clear();
+  heap_->code_ranges()->Clear();
+
+  UpdateMaxUsed();
+  if (heap_ != NULL) {
+    heap_->UpdateGlobalMaxUsed();
+  }
+  heap_->RunPendingFinalizers(thread, true);
+}
+
+void PageSpace::AssistConcurrentMarking(Thread* thread, int64_t deadline) {
+  ASSERT(thread->IsMutatorThread());
+  GCMarker* marker = marker_;
+  if ((marker == NULL) || !marker->JoinConcurrentMark()) {
+    // The markers have stopped and the remark is waiting for us to reach a
+    // safepoint.
+    return;
+  }
+  if (!marker->AssistConcurrentMark(heap_->isolate(), this, deadline)) {
+    return;
+  }
+  // We were the last marker to stop, so we complete the collection in place
+  // of the task that would have.
+  FinishConcurrentMarking(thread);
+  {
+    MonitorLocker ml(tasks_lock());
+    set_tasks(tasks() - 1);
+    ml.NotifyAll();
+  }
+  heap_->RunPendingFinalizers(thread, false);
+}
+
+void PageSpace::SweepLargeAndExecutablePages() {
+  if (FLAG_verify_before_gc) {
+    OS::PrintErr("Verifying before sweeping...");
+    heap_->VerifyGC(kAllowMarked);
+    OS::PrintErr(" done.\n");
+  }
+  GCSweeper sweeper;
+
+  // During stop-the-world phases we should use bulk lock when adding
+  // elements to the free list.
+  MutexLocker mld(freelist_[HeapPage::kData].mutex());
+  MutexLocker mle(freelist_[HeapPage::kExecutable].mutex());
+
+  // Large and executable pages are always swept immediately.
+  HeapPage* prev_page = NULL;
+  HeapPage* page = large_pages_;
+  while (page != NULL) {
+    HeapPage* next_page = page->next();
+    const intptr_t words_to_end = sweeper.SweepLargePage(page);
+    if (words_to_end == 0) {
+      FreeLargePage(page, prev_page);
+    } else {
+      TruncateLargePage(page, words_to_end << kWordSizeLog2);
+      prev_page = page;
+    }
+    // Advance to the next page.
+    page = next_page;
+  }
+
+  prev_page = NULL;
+  page = exec_pages_;
+  FreeList* freelist = &freelist_[HeapPage::kExecutable];
+  while (page != NULL) {
+    HeapPage* next_page = page->next();
+    bool page_in_use = sweeper.SweepPage(page, freelist, true);
+    if (page_in_use) {
+      prev_page = page;
+    } else {
+      FreePage(page, prev_page);
+    }
+    // Advance to the next page.
+    page = next_page;
+  }
+}
+
 void PageSpace::BlockingSweep() {
   MutexLocker mld(freelist_[HeapPage::kData].mutex());
   MutexLocker mle(freelist_[HeapPage::kExecutable].mutex());
@@ -1107,6 +1440,65 @@ void PageSpace::ConcurrentSweep(Isolate* isolate) {
                              &freelist_[HeapPage::kData]);
 }
 
+void PageSpace::LazySweep() {
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  ASSERT(sweep_next_ == NULL);
+  sweep_next_ = pages_;
+  sweep_last_ = pages_tail_;
+  sweep_prev_ = NULL;
+}
+
+bool PageSpace::SweepNextPage(bool is_locked) {
+  // Unsynchronized check to keep the common case cheap. It is repeated under
+  // the lock below.
+  if (sweep_next_ == NULL) {
+    return false;
+  }
+  if (is_locked) {
+    return SweepNextPageLocked();
+  }
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  return SweepNextPageLocked();
+}
+
+bool PageSpace::SweepNextPageLocked() {
+  DEBUG_ASSERT(freelist_[HeapPage::kData].mutex()->IsOwnedByCurrentThread());
+  HeapPage* page = sweep_next_;
+  if (page == NULL) {
+    return false;
+  }
+  // Pages added after the collection follow sweep_last_ and hold no garbage.
+  sweep_next_ = (page == sweep_last_) ? NULL : page->next();
+  if (sweep_next_ == NULL) {
+    sweep_last_ = NULL;
+  }
+  ASSERT(page->type() == HeapPage::kData);
+  GCSweeper sweeper;
+  if (sweeper.SweepPage(page, &freelist_[HeapPage::kData], true)) {
+    sweep_prev_ = page;
+  } else {
+    FreePage(page, sweep_prev_);
+  }
+  return true;
+}
+
+void PageSpace::CompleteLazySweep() {
+  if (sweep_next_ == NULL) {
+    return;
+  }
+  MutexLocker ml(freelist_[HeapPage::kData].mutex());
+  while (sweep_next_ != NULL) {
+    SweepNextPageLocked();
+  }
+}
+
+void PageSpace::SweepUntil(int64_t deadline) {
+  // The lock is taken for each page so that allocating helper threads are
+  // not held up for the whole slice.
+  while ((OS::GetCurrentMonotonicMicros() < deadline) && SweepNextPage(false)) {
+  }
+}
+
 void PageSpace::Compact(Thread* thread) {
   thread->isolate()->set_compaction_in_progress(true);
   GCCompactor compactor(thread, heap_);
@@ -1120,6 +1512,120 @@ void PageSpace::Compact(Thread* thread) {
   }
 }
 
+static int CompareUsedInBytes(const intptr_t* a, const intptr_t* b) {
+  if (*a < *b) return -1;
+  if (*a > *b) return 1;
+  return 0;
+}
+
+static bool IsFragmented(HeapPage* page) {
+  const intptr_t size = page->object_end() - page->object_start();
+  const intptr_t free = size - page->used_in_bytes();
+  return free * 100 >= size * FLAG_selective_compaction_threshold;
+}
+
+// Evacuates the data pages with the least live bytes, as measured when they
+// were last swept, limiting the bytes moved to what the compactor is
+// estimated to slide within the pause budget. The remaining data pages are
+// only visited to forward pointers, and all data pages are swept afterwards.
+void PageSpace::CompactFragmentedPages(Thread* thread) {
+  MallocGrowableArray<intptr_t> used_sizes;
+  for (HeapPage* page = pages_; page != NULL; page = page->next()) {
+    if (IsFragmented(page)) {
+      used_sizes.Add(page->used_in_bytes());
+    }
+  }
+  if (used_sizes.length() < 2) {
+    return;
+  }
+  used_sizes.Sort(CompareUsedInBytes);
+
+  // Assuming compaction takes as long as marking.
+  intptr_t compact_words_per_micro = mark_words_per_micro_ / 2;
+  if (compact_words_per_micro == 0) {
+    compact_words_per_micro = 1;
+  }
+  const int64_t budget_in_bytes =
+      static_cast<int64_t>(FLAG_selective_compaction_budget) *
+      compact_words_per_micro * kWordSize;
+  intptr_t num_candidates = 0;
+  intptr_t candidate_used_in_bytes = 0;
+  while ((num_candidates < used_sizes.length()) &&
+         (candidate_used_in_bytes + used_sizes[num_candidates] <=
+          budget_in_bytes)) {
+    candidate_used_in_bytes += used_sizes[num_candidates];
+    num_candidates++;
+  }
+  // Nothing is gained unless the live objects fit in fewer pages.
+  const intptr_t page_size = kPageSize - HeapPage::ObjectStartOffset();
+  if ((num_candidates < 2) ||
+      (candidate_used_in_bytes > (num_candidates - 1) * page_size)) {
+    return;
+  }
+
+  // Unlink the candidates: every page with fewer used bytes than the cutoff,
+  // and as many as were counted of those with exactly the cutoff.
+  const intptr_t cutoff = used_sizes[num_candidates - 1];
+  intptr_t num_at_cutoff = 0;
+  for (intptr_t i = 0; i < num_candidates; i++) {
+    if (used_sizes[i] == cutoff) {
+      num_at_cutoff++;
+    }
+  }
+  HeapPage* evacuated = NULL;
+  HeapPage* evacuated_tail = NULL;
+  {
+    MutexLocker ml(pages_lock_);
+    HeapPage* prev = NULL;
+    HeapPage* page = pages_;
+    while (page != NULL) {
+      HeapPage* next = page->next();
+      const intptr_t used = page->used_in_bytes();
+      bool evacuate = false;
+      if (IsFragmented(page)) {
+        if (used < cutoff) {
+          evacuate = true;
+        } else if ((used == cutoff) && (num_at_cutoff > 0)) {
+          evacuate = true;
+          num_at_cutoff--;
+        }
+      }
+      if (evacuate) {
+        if (prev == NULL) {
+          pages_ = next;
+        } else {
+          prev->set_next(next);
+        }
+        page->set_next(NULL);
+        if (evacuated_tail == NULL) {
+          evacuated = page;
+        } else {
+          evacuated_tail->set_next(page);
+        }
+        evacuated_tail = page;
+      } else {
+        prev = page;
+      }
+      page = next;
+    }
+    pages_tail_ = prev;
+  }
+
+  thread->isolate()->set_compaction_in_progress(true);
+  GCCompactor compactor(thread, heap_);
+  HeapPage* tail = compactor.CompactSelected(evacuated, pages_, pages_lock_);
+  thread->isolate()->set_compaction_in_progress(false);
+
+  // Re-link the surviving pages after the unevacuated ones, ready for sweeping.
+  MutexLocker ml(pages_lock_);
+  if (pages_tail_ == NULL) {
+    pages_ = evacuated;
+  } else {
+    pages_tail_->set_next(evacuated);
+  }
+  pages_tail_ = tail;
+}
+
 uword PageSpace::TryAllocateDataBumpInternal(intptr_t size,
                                              GrowthPolicy growth_policy,
                                              bool is_locked) {
@@ -1135,6 +1641,11 @@ uword PageSpace::TryAllocateDataBumpInternal(intptr_t size,
     FreeListElement* block =
         is_locked ? freelist_[HeapPage::kData].TryAllocateLargeLocked(size)
                   : freelist_[HeapPage::kData].TryAllocateLarge(size);
+    while ((block == NULL) && SweepNextPage(is_locked)) {
+      block = is_locked
+                  ? freelist_[HeapPage::kData].TryAllocateLargeLocked(size)
+                  : freelist_[HeapPage::kData].TryAllocateLarge(size);
+    }
     if (block == NULL) {
       // Allocating from a new page (if growth policy allows) will have the
       // side-effect of populating the freelist with a large block. The next
@@ -1181,6 +1692,37 @@ uword PageSpace::TryAllocateDataBumpLocked(intptr_t size,
   return TryAllocateDataBumpInternal(size, growth_policy, true);
 }
 
+uword PageSpace::TryAllocateInThreadBuffer(Thread* thread,
+                                           intptr_t size,
+                                           GrowthPolicy growth_policy) {
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  ASSERT(thread->heap() == heap_);
+  if (size > kThreadLabMaxObjectSize) {
+    return TryAllocate(size, HeapPage::kData, growth_policy);
+  }
+  uword top = thread->old_top();
+  if ((thread->old_end() - top) < static_cast<uword>(size)) {
+    const uword buffer =
+        TryAllocate(kThreadLabSize, HeapPage::kData, growth_policy);
+    if (buffer == 0) {
+      // Less than a chunk is left before the heap has to grow.
+      return TryAllocate(size, HeapPage::kData, growth_policy);
+    }
+    thread->ReleaseOldAllocationBuffer();
+    thread->set_old_allocation_buffer(buffer, buffer + kThreadLabSize);
+    top = buffer;
+  }
+  thread->set_old_top(top + size);
+  return top;
+}
+
+void PageSpace::AbandonThreadBuffer(uword addr, intptr_t size) {
+  // The whole chunk was counted as used when it was handed out.
+  freelist_[HeapPage::kData].Free(addr, size);
+  AtomicOperations::DecrementBy(&(usage_.used_in_words),
+                                (size >> kWordSizeLog2));
+}
+
 uword PageSpace::TryAllocatePromoLocked(intptr_t size,
                                         GrowthPolicy growth_policy) {
   FreeList* freelist = &freelist_[HeapPage::kData];
@@ -1195,6 +1737,13 @@ uword PageSpace::TryAllocatePromoLocked(intptr_t size,
   return TryAllocateDataLocked(size, growth_policy);
 }
 
+void PageSpace::FreePromoLocked(uword addr, intptr_t size) {
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  freelist_[HeapPage::kData].FreeLocked(addr, size);
+  AtomicOperations::DecrementBy(&(usage_.used_in_words),
+                                (size >> kWordSizeLog2));
+}
+
 void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   // Setup a HeapPage so precompiled Instructions can be traversed.
   // Instructions are contiguous at [pointer, pointer + size). HeapPage
@@ -1212,6 +1761,7 @@ void PageSpace::SetupImagePage(void* pointer, uword size, bool is_executable) {
   page->object_end_ = memory->end();
   page->used_in_bytes_ = page->object_end_ - page->object_start();
   page->forwarding_page_ = NULL;
+  page->card_table_ = NULL;
   if (is_executable) {
     ASSERT(Utils::IsAligned(pointer, OS::PreferredCodeAlignment()));
     page->type_ = HeapPage::kExecutable;
@@ -1272,6 +1822,15 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
   const int gc_time_fraction = history_.GarbageCollectionTimeFraction();
   heap_->RecordData(PageSpace::kGCTimeFraction, gc_time_fraction);
 
+  if (FLAG_gc_pause_goal > 0) {
+    const intptr_t grow_heap =
+        PauseGoalGrowthInPages(before, after, end - start, gc_time_fraction);
+    heap_->RecordData(PageSpace::kPageGrowth, grow_heap);
+    heap_->RecordData(PageSpace::kAllowedGrowth, grow_heap);
+    UpdateThresholds(after, grow_heap);
+    return;
+  }
+
   // Assume garbage increases linearly with allocation:
   // G = kA, and estimate k from the previous cycle.
   const intptr_t allocated_since_previous_gc =
@@ -1349,6 +1908,53 @@ void PageSpaceController::EvaluateGarbageCollection(SpaceUsage before,
       kPageSizeInWords;
   grow_heap = Utils::Maximum(grow_heap, freed_pages / 2);
   heap_->RecordData(PageSpace::kAllowedGrowth, grow_heap);
+  UpdateThresholds(after, grow_heap);
+}
+
+intptr_t PageSpaceController::PauseGoalGrowthInPages(
+    SpaceUsage before,
+    SpaceUsage after,
+    int64_t pause_micros,
+    int gc_time_fraction) const {
+  // Each collection costs about the same while the live size is stable, so the
+  // share of time spent in GC falls in proportion to how much is allocated
+  // between collections. Scale the last cycle's allocation by the factor that
+  // would have met the goal, damped to avoid oscillation.
+  intptr_t allocated_since_previous_gc =
+      before.CombinedUsedInWords() - last_usage_.CombinedUsedInWords();
+  if (allocated_since_previous_gc <= 0) {
+    allocated_since_previous_gc = kPageSizeInWords * (heap_growth_max_ / 2);
+  }
+  const double goal = Utils::Maximum(FLAG_gc_time_goal, 1) / 100.0;
+  const double fraction = gc_time_fraction / 100.0;
+  double scale = (fraction * (1.0 - goal)) / (goal * (1.0 - fraction));
+  scale = Utils::Maximum(0.5, Utils::Minimum(2.0, scale));
+  intptr_t limit = after.CombinedUsedInWords() +
+                   static_cast<intptr_t>(allocated_since_previous_gc * scale);
+
+  // The pause grows with the heap it visits. Assume the time per word of the
+  // last collection and cap the heap at the size that fits the pause goal.
+  if (pause_micros > 0) {
+    const double micros_per_word =
+        pause_micros /
+        static_cast<double>(
+            Utils::Maximum<intptr_t>(before.CombinedCapacityInWords(), 1));
+    const double pause_limit =
+        (FLAG_gc_pause_goal * kMicrosecondsPerMillisecond) / micros_per_word;
+    if (pause_limit < limit) {
+      limit = static_cast<intptr_t>(pause_limit);
+    }
+  }
+
+  // Collecting more often cannot shorten the pause for live data that
+  // already exceeds the goal, so always leave room for at least one page.
+  const intptr_t grow_heap =
+      (limit - after.CombinedCapacityInWords()) / kPageSizeInWords;
+  return Utils::Maximum<intptr_t>(grow_heap, 1);
+}
+
+void PageSpaceController::UpdateThresholds(SpaceUsage after,
+                                           intptr_t grow_heap) {
   last_usage_ = after;
 
   // Save final threshold compared before growing.
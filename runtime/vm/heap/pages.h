@@ -6,6 +6,7 @@
 #define RUNTIME_VM_HEAP_PAGES_H_
 
 #include "vm/globals.h"
+#include "vm/growable_array.h"
 #include "vm/heap/freelist.h"
 #include "vm/heap/spaces.h"
 #include "vm/lockers.h"
@@ -20,6 +21,7 @@ DECLARE_FLAG(bool, always_drop_code);
 DECLARE_FLAG(bool, write_protect_code);
 
 // Forward declarations.
+class GCMarker;
 class Heap;
 class JSONObject;
 class ObjectPointerVisitor;
@@ -64,6 +66,30 @@ class HeapPage {
 
   void WriteProtect(bool read_only);
 
+  // Card marking. The page of a card remembered object has a card table with
+  // one entry per kBytesPerCard bytes of the page, set when a new object is
+  // stored into the corresponding slots.
+  static const intptr_t kSlotsPerCardLog2 = 9;
+  static const intptr_t kBytesPerCardLog2 = kWordSizeLog2 + kSlotsPerCardLog2;
+
+  static intptr_t card_table_offset() {
+    return OFFSET_OF(HeapPage, card_table_);
+  }
+
+  void AllocateCardTable();
+  void RememberCard(RawObject* const* slot) {
+    ASSERT(card_table_ != NULL);
+    ASSERT(Contains(reinterpret_cast<uword>(slot)));
+    intptr_t offset =
+        reinterpret_cast<uword>(slot) - reinterpret_cast<uword>(this);
+    card_table_[offset >> kBytesPerCardLog2] = 1;
+  }
+  bool HasCardTable() const { return card_table_ != NULL; }
+  // Clears the remembered cards of the card remembered array at the start of
+  // this page and visits their slots. The visitor is expected to remember
+  // again the cards of the slots that still hold new objects.
+  void VisitRememberedCards(ObjectPointerVisitor* visitor);
+
   static intptr_t ObjectStartOffset() {
     return Utils::RoundUp(sizeof(HeapPage), OS::kMaxPreferredCodeAlignment);
   }
@@ -91,16 +117,22 @@ class HeapPage {
   static HeapPage* Allocate(intptr_t size_in_words,
                             PageType type,
                             const char* name);
+  static HeapPage* Initialize(VirtualMemory* memory, PageType type);
 
   // Deallocate the virtual memory backing this page. The page pointer to this
   // page becomes immediately inaccessible.
   void Deallocate();
 
+  // Like Deallocate, but hands the virtual memory backing this page to the
+  // caller instead of unmapping it.
+  VirtualMemory* ReleaseMemory();
+
   VirtualMemory* memory_;
   HeapPage* next_;
   uword object_end_;
   uword used_in_bytes_;
   ForwardingPage* forwarding_page_;
+  uint8_t* card_table_;
   PageType type_;
 
   friend class PageSpace;
@@ -172,6 +204,14 @@ class PageSpaceController {
   bool is_enabled() { return is_enabled_; }
 
  private:
+  // With --gc_pause_goal, the growth that keeps the next pause within the goal
+  // while moving the time spent in GC towards --gc_time_goal.
+  intptr_t PauseGoalGrowthInPages(SpaceUsage before,
+                                  SpaceUsage after,
+                                  int64_t pause_micros,
+                                  int gc_time_fraction) const;
+  void UpdateThresholds(SpaceUsage after, intptr_t grow_heap);
+
   Heap* heap_;
 
   bool is_enabled_;
@@ -229,6 +269,12 @@ class PageSpace {
                                is_locked);
   }
 
+  // Whether an allocation of size bytes gets a large page of its own. Large
+  // pages are freshly mapped, so their memory is zeroed.
+  static bool IsLargePageAllocation(intptr_t size) {
+    return size >= kAllocatablePageSize;
+  }
+
   bool NeedsGarbageCollection() const {
     return page_space_controller_.NeedsGarbageCollection(usage_);
   }
@@ -265,6 +311,9 @@ class PageSpace {
   void VisitObjects(ObjectVisitor* visitor) const;
   void VisitObjectsNoImagePages(ObjectVisitor* visitor) const;
   void VisitObjectsImagePages(ObjectVisitor* visitor) const;
+  // Appends every page, including large and image pages, so their objects can
+  // be split among several tasks. Caller must hold a HeapIterationScope.
+  void AddPagesTo(MallocGrowableArray<HeapPage*>* pages) const;
   void VisitObjectPointers(ObjectPointerVisitor* visitor) const;
 
   RawObject* FindObject(FindObjectVisitor* visitor,
@@ -275,7 +324,28 @@ class PageSpace {
   bool ShouldCollectCode();
 
   // Collect the garbage in the page space using mark-sweep or mark-compact.
-  void CollectGarbage(bool compact);
+  // A concurrent mark-sweep only starts marking and returns; the collection
+  // is completed by the marker tasks.
+  void CollectGarbage(bool compact, bool concurrent);
+
+  // Whether the old generation is being marked concurrently.
+  bool IsMarking() const { return marker_ != NULL; }
+
+  // Visits the remembered cards of the card remembered arrays, each as an old
+  // object being visited. Only called by the scavenger, which may allocate
+  // large pages while visiting, so the page list is walked without a lock.
+  template <typename Visitor>
+  void VisitRememberedCards(Visitor* visitor) const {
+    for (HeapPage* page = large_pages_; page != NULL; page = page->next()) {
+      if (!page->HasCardTable()) continue;
+      RawObject* raw_obj = RawObject::FromAddr(page->object_start());
+      // Become may have replaced the array with a forwarding corpse.
+      if (!raw_obj->IsCardRemembered()) continue;
+      visitor->VisitingOldObject(raw_obj);
+      page->VisitRememberedCards(visitor);
+    }
+    visitor->VisitingOldObject(NULL);
+  }
 
   void AddRegionsToObjectSet(ObjectSet* set) const;
 
@@ -294,6 +364,13 @@ class PageSpace {
 
   bool GrowthControlState() { return page_space_controller_.is_enabled(); }
 
+  intptr_t PageCacheSizeInWords() const {
+    MutexLocker ml(pages_lock_);
+    return page_cache_.length() * kPageSizeInWords;
+  }
+  // Unmaps part of the cached pages, or all of them if 'all' is true.
+  void TrimPageCache(bool all);
+
   // Note: Code pages are made executable/non-executable when 'read_only' is
   // true/false, respectively.
   void WriteProtect(bool read_only);
@@ -301,6 +378,11 @@ class PageSpace {
 
   bool ShouldPerformIdleMarkSweep(int64_t deadline);
   bool ShouldPerformIdleMarkCompact(int64_t deadline);
+  // Whether a concurrent marking should be started during idle time that is
+  // too short for a whole mark-sweep.
+  bool ShouldStartIdleMarking();
+  // Works on the marking or lazy sweep in progress until 'deadline'.
+  void PerformIdleSlice(Thread* thread, int64_t deadline);
 
   void AddGCTime(int64_t micros) { gc_time_micros_ += micros; }
 
@@ -339,8 +421,18 @@ class PageSpace {
   // Attempt to allocate from bump block rather than normal freelist.
   uword TryAllocateDataBump(intptr_t size, GrowthPolicy growth_policy);
   uword TryAllocateDataBumpLocked(intptr_t size, GrowthPolicy growth_policy);
+  // Attempt to allocate from the thread's own chunk of old space, only taking
+  // the data lock to get a new chunk. Used by helper threads and bulk loaders
+  // to stay off the lock the mutator allocates under.
+  uword TryAllocateInThreadBuffer(Thread* thread,
+                                  intptr_t size,
+                                  GrowthPolicy growth_policy);
+  // Return the unused part of a thread's chunk.
+  void AbandonThreadBuffer(uword addr, intptr_t size);
   // Prefer small freelist blocks, then chip away at the bump block.
   uword TryAllocatePromoLocked(intptr_t size, GrowthPolicy growth_policy);
+  // Return an unused part of a block obtained from TryAllocatePromoLocked.
+  void FreePromoLocked(uword addr, intptr_t size);
 
   void SetupImagePage(void* pointer, uword size, bool is_executable);
 
@@ -357,6 +449,7 @@ class PageSpace {
     kResetFreeLists = 3,
     kSweepPages = 4,
     kSweepLargePages = 5,
+    kMarkWeaks = 6,
     // Data
     kGarbageRatio = 0,
     kGCTimeFraction = 1,
@@ -382,14 +475,29 @@ class PageSpace {
   void MakeIterable() const;
   HeapPage* AllocatePage(HeapPage::PageType type);
   void FreePage(HeapPage* page, HeapPage* previous_page);
+  void DeallocatePageLocked(HeapPage* page);
   HeapPage* AllocateLargePage(intptr_t size, HeapPage::PageType type);
   void TruncateLargePage(HeapPage* page, intptr_t new_object_size_in_bytes);
   void FreeLargePage(HeapPage* page, HeapPage* previous_page);
   void FreePages(HeapPage* pages);
 
+  void StartConcurrentMarking(Thread* thread);
+  void FinishConcurrentMarking(Thread* thread);
+  // Lets the mutator mark alongside the concurrent markers until 'deadline'.
+  void AssistConcurrentMarking(Thread* thread, int64_t deadline);
+  void SweepLargeAndExecutablePages();
   void BlockingSweep();
   void ConcurrentSweep(Isolate* isolate);
+  // Lazy sweeping leaves the data pages to be swept one at a time by the
+  // allocation slow path. Any pages still unswept when the next collection or
+  // heap iteration starts are swept by CompleteLazySweep.
+  void LazySweep();
+  bool SweepNextPage(bool is_locked);
+  bool SweepNextPageLocked();
+  void CompleteLazySweep();
+  void SweepUntil(int64_t deadline);
   void Compact(Thread* thread);
+  void CompactFragmentedPages(Thread* thread);
 
   static intptr_t LargePageSizeInWordsFor(intptr_t size);
 
@@ -420,6 +528,10 @@ class PageSpace {
   HeapPage* large_pages_;
   HeapPage* image_pages_;
 
+  // The reservations of freed data pages, whose memory has been given back to
+  // the OS, kept for reuse by AllocatePage. Guarded by pages_lock_.
+  MallocGrowableArray<VirtualMemory*> page_cache_;
+
   // A block of memory in a data page, managed by bump allocation. The remainder
   // is kept formatted as a FreeListElement, but is not in any freelist.
   uword bump_top_;
@@ -440,15 +552,29 @@ class PageSpace {
 #endif
   PageSpaceController page_space_controller_;
 
+  // State of a concurrent marking in progress.
+  GCMarker* marker_;
+  SpaceUsage usage_before_marking_;
+  int64_t marking_start_micros_;
+
+  // Data pages from sweep_next_ through sweep_last_ still await lazy sweeping;
+  // sweep_prev_ is the last page kept so far. Guarded by the data freelist's
+  // lock.
+  HeapPage* sweep_next_;
+  HeapPage* sweep_last_;
+  HeapPage* sweep_prev_;
+
   int64_t gc_time_micros_;
   intptr_t collections_;
   intptr_t mark_words_per_micro_;
 
+  friend class Heap;  // For the ids of the GC stats records.
   friend class ExclusivePageIterator;
   friend class ExclusiveCodePageIterator;
   friend class ExclusiveLargePageIterator;
   friend class HeapIterationScope;
   friend class PageSpaceController;
+  friend class ConcurrentMarkTask;
   friend class SweeperTask;
   friend class GCCompactor;
   friend class CompactorTask;
@@ -0,0 +1,151 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/pretenuring.h"
+
+#include "platform/assert.h"
+#include "vm/class_table.h"
+#include "vm/flags.h"
+#include "vm/isolate.h"
+#include "vm/json_stream.h"
+#include "vm/log.h"
+#include "vm/object.h"
+#include "vm/thread.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            pretenure,
+            false,
+            "Sample the survival of young objects and allocate instances of "
+            "long-lived classes directly in old space from optimized code.");
+DEFINE_FLAG(int,
+            pretenure_sample_interval,
+            4,
+            "Sample the survival of young objects every this many scavenges.");
+DEFINE_FLAG(int,
+            pretenure_threshold,
+            90,
+            "Pretenure a class when this percentage of its sampled instances "
+            "survives a scavenge, and stop when less than half of it does.");
+DEFINE_FLAG(bool, trace_pretenuring, false, "Trace pretenuring decisions.");
+
+// A class needs at least this many sampled words for a decision.
+static const intptr_t kMinSampleInWords = 8 * KBInWords;
+
+PretenuringFeedback::PretenuringFeedback()
+    : entries_(NULL),
+      length_(0),
+      scavenges_until_sample_(0),
+      num_reverted_(0) {}
+
+PretenuringFeedback::~PretenuringFeedback() {
+  free(entries_);
+}
+
+bool PretenuringFeedback::ShouldSample() {
+  if (!FLAG_pretenure) {
+    return false;
+  }
+  if (scavenges_until_sample_ > 0) {
+    scavenges_until_sample_--;
+    return false;
+  }
+  scavenges_until_sample_ = FLAG_pretenure_sample_interval - 1;
+  return true;
+}
+
+void PretenuringFeedback::EnsureCapacity(intptr_t num_cids) {
+  ASSERT(Thread::Current()->IsAtSafepoint());
+  if (num_cids <= length_) {
+    return;
+  }
+  // Readers only look at the table outside of safepoints, so the old table
+  // can be released right away.
+  Entry* entries =
+      reinterpret_cast<Entry*>(realloc(entries_, num_cids * sizeof(Entry)));
+  if (entries == NULL) {
+    OUT_OF_MEMORY();
+  }
+  for (intptr_t cid = length_; cid < num_cids; cid++) {
+    entries[cid].allocated_in_words = 0;
+    entries[cid].survived_in_words = 0;
+    entries[cid].survival_rate = -1;
+    entries[cid].pretenured = false;
+    entries[cid].reverted = false;
+  }
+  entries_ = entries;
+  length_ = num_cids;
+}
+
+void PretenuringFeedback::UpdateDecisions(Thread* thread) {
+  const intptr_t threshold = FLAG_pretenure_threshold;
+  for (intptr_t cid = 0; cid < length_; cid++) {
+    Entry* entry = &entries_[cid];
+    if (entry->allocated_in_words < kMinSampleInWords) {
+      continue;
+    }
+    entry->survival_rate =
+        (entry->survived_in_words * 100) / entry->allocated_in_words;
+    // Age the samples so that recent behavior dominates the next decision.
+    entry->allocated_in_words >>= 1;
+    entry->survived_in_words >>= 1;
+    if (!entry->pretenured && (entry->survival_rate >= threshold)) {
+      entry->pretenured = true;
+      if (FLAG_trace_pretenuring) {
+        THR_Print("Pretenuring cid %" Pd " (%" Pd "%% survived)\n", cid,
+                  entry->survival_rate);
+      }
+    } else if (entry->pretenured && (entry->survival_rate < threshold / 2)) {
+      entry->pretenured = false;
+      if (!entry->reverted) {
+        entry->reverted = true;
+        num_reverted_++;
+      }
+      if (FLAG_trace_pretenuring) {
+        THR_Print("No longer pretenuring cid %" Pd " (%" Pd "%% survived)\n",
+                  cid, entry->survival_rate);
+      }
+    }
+  }
+  if (num_reverted_ > 0) {
+    // Dependent code can only be disabled by the mutator outside of GC, see
+    // Thread::HandleInterrupts.
+    Isolate* isolate = thread->isolate();
+    if (isolate->IsMutatorThreadScheduled()) {
+      isolate->mutator_thread()->ScheduleInterrupts(Thread::kVMInterrupt);
+    }
+  }
+}
+
+void PretenuringFeedback::DisableRevertedCode(Thread* thread) {
+  ASSERT(thread->IsMutatorThread());
+  ClassTable* class_table = thread->isolate()->class_table();
+  Class& cls = Class::Handle(thread->zone());
+  // Disabling code may allocate and thus scavenge, which can move the table.
+  for (intptr_t cid = 0; (cid < length_) && (num_reverted_ > 0); cid++) {
+    if (!entries_[cid].reverted) {
+      continue;
+    }
+    entries_[cid].reverted = false;
+    num_reverted_--;
+    if (!class_table->IsValidIndex(cid) || !class_table->HasValidClassAt(cid)) {
+      continue;
+    }
+    cls = class_table->At(cid);
+    cls.DisableAllCHAOptimizedCode();
+  }
+}
+
+#ifndef PRODUCT
+void PretenuringFeedback::PrintToJSONObject(intptr_t cid,
+                                            JSONObject* obj) const {
+  obj->AddProperty("_pretenured", IsPretenured(cid));
+  if ((cid < length_) && (entries_[cid].survival_rate >= 0)) {
+    obj->AddProperty("_survivalRate", entries_[cid].survival_rate);
+  }
+}
+#endif  // !PRODUCT
+
+}  // namespace dart
@@ -0,0 +1,86 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_PRETENURING_H_
+#define RUNTIME_VM_HEAP_PRETENURING_H_
+
+#include "vm/allocation.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+class JSONObject;
+class Thread;
+
+// Survival feedback gathered by sampling scavenges. A class whose young
+// instances almost all survive their first scavenge is pretenured: optimized
+// code allocates its instances directly in old space instead of copying them
+// out of new space later. Object headers do not record an allocation site, so
+// the feedback is kept per class id.
+//
+// Decisions are only changed at safepoints during a scavenge. Code relying on
+// a class being pretenured is registered as dependent code of the class and
+// disabled from the mutator once the class is no longer pretenured.
+class PretenuringFeedback {
+ public:
+  PretenuringFeedback();
+  ~PretenuringFeedback();
+
+  // Whether the upcoming scavenge should sample the survival of the objects
+  // allocated since the previous one.
+  bool ShouldSample();
+
+  // Records a young object seen by a sampling scavenge.
+  void RecordSample(intptr_t cid, intptr_t size, bool survived) {
+    ASSERT(cid < length_);
+    Entry* entry = &entries_[cid];
+    entry->allocated_in_words += size >> kWordSizeLog2;
+    if (survived) {
+      entry->survived_in_words += size >> kWordSizeLog2;
+    }
+  }
+
+  // Makes room for samples of all class ids below num_cids. Called at a
+  // safepoint before sampling.
+  void EnsureCapacity(intptr_t num_cids);
+
+  // Reevaluates the classes with enough samples. Called at the end of a
+  // sampling scavenge.
+  void UpdateDecisions(Thread* thread);
+
+  bool IsPretenured(intptr_t cid) const {
+    return (cid < length_) && entries_[cid].pretenured;
+  }
+
+  // Disables the optimized code of classes that are no longer pretenured.
+  // Must be called by the mutator outside of a GC.
+  void DisableRevertedCode(Thread* thread);
+  bool HasRevertedClasses() const { return num_reverted_ > 0; }
+
+#ifndef PRODUCT
+  void PrintToJSONObject(intptr_t cid, JSONObject* obj) const;
+#endif  // !PRODUCT
+
+ private:
+  struct Entry {
+    intptr_t allocated_in_words;
+    intptr_t survived_in_words;
+    // Percentage of sampled words that survived, -1 before the first
+    // decision.
+    intptr_t survival_rate;
+    bool pretenured;
+    bool reverted;
+  };
+
+  Entry* entries_;
+  intptr_t length_;
+  intptr_t scavenges_until_sample_;
+  intptr_t num_reverted_;
+
+  DISALLOW_COPY_AND_ASSIGN(PretenuringFeedback);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_PRETENURING_H_
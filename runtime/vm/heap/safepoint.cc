@@ -6,6 +6,7 @@
 
 #include "vm/thread.h"
 #include "vm/thread_registry.h"
+#include "vm/timeline.h"
 
 namespace dart {
 
@@ -38,6 +39,9 @@ SafepointHandler::SafepointHandler(Isolate* isolate)
     : isolate_(isolate),
       safepoint_lock_(new Monitor()),
       number_threads_not_at_safepoint_(0),
+      all_threads_checked_in_(false),
+      straggler_kind_(Thread::kUnknownTask),
+      straggler_id_(0),
       safepoint_operation_count_(0),
       owner_(NULL) {}
 
@@ -53,6 +57,9 @@ void SafepointHandler::SafepointThreads(Thread* T) {
   ASSERT(T->no_safepoint_scope_depth() == 0);
   ASSERT(T->execution_state() == Thread::kThreadInVM);
 
+  int64_t start;
+  intptr_t num_requested = 0;
+
   {
     // First grab the threads list lock for this isolate
     // and check if a safepoint is already in progress. This
@@ -75,6 +82,12 @@ void SafepointHandler::SafepointThreads(Thread* T) {
 
     // Set safepoint in progress state by this thread.
     SetSafepointInProgress(T);
+    start = OS::GetCurrentMonotonicMicros();
+
+    // Hold one count for this thread until every thread has been asked, so
+    // the count cannot reach zero while threads are still being added.
+    ASSERT(number_threads_not_at_safepoint_ == 0);
+    number_threads_not_at_safepoint_ = 1;
 
     // Go over the active thread list and ensure that all threads active
     // in the isolate reach a safepoint.
@@ -90,8 +103,9 @@ void SafepointHandler::SafepointThreads(Thread* T) {
             ASSERT(T->isolate() != NULL);
             current->ScheduleInterruptsLocked(Thread::kVMInterrupt);
           }
-          MonitorLocker sl(safepoint_lock_);
-          ++number_threads_not_at_safepoint_;
+          AtomicOperations::FetchAndIncrement(
+              &number_threads_not_at_safepoint_);
+          ++num_requested;
         }
       } else {
         current->SetAtSafepoint(true);
@@ -100,22 +114,51 @@ void SafepointHandler::SafepointThreads(Thread* T) {
     }
   }
   // Now wait for all threads that are not already at a safepoint to check-in.
-  {
+  // Dropping our own count tells us whether any of them are still running.
+  Thread::TaskKind straggler_kind = Thread::kUnknownTask;
+  intptr_t straggler_id = 0;
+  if (AtomicOperations::FetchAndDecrement(&number_threads_not_at_safepoint_) !=
+      1) {
     MonitorLocker sl(safepoint_lock_);
     intptr_t num_attempts = 0;
-    while (number_threads_not_at_safepoint_ > 0) {
+    while (!all_threads_checked_in_) {
       Monitor::WaitResult retval = sl.Wait(1000);
       if (retval == Monitor::kTimedOut) {
         num_attempts += 1;
         if (num_attempts > 10) {
           // We have been waiting too long, start logging this as we might
           // have an issue where a thread is not checking in for a safepoint.
-          OS::PrintErr("Attempt:%" Pd " waiting for %d threads to check in\n",
-                       num_attempts, number_threads_not_at_safepoint_);
+          OS::PrintErr("Attempt:%" Pd " waiting for %" Pd
+                       " threads to check in\n",
+                       num_attempts,
+                       AtomicOperations::LoadRelaxed(
+                           &number_threads_not_at_safepoint_));
         }
       }
     }
+    all_threads_checked_in_ = false;
+    straggler_kind = straggler_kind_;
+    straggler_id = straggler_id_;
+  }
+
+#if !defined(PRODUCT)
+  TimelineEvent* event = Timeline::GetGCStream()->StartEvent();
+  if (event != NULL) {
+    event->Duration("SafepointThreads", start,
+                    OS::GetCurrentMonotonicMicros());
+    event->SetNumArguments(3);
+    event->FormatArgument(0, "threadsRequested", "%" Pd, num_requested);
+    if (straggler_kind != Thread::kUnknownTask) {
+      event->CopyArgument(1, "stragglerKind",
+                          Thread::TaskKindToCString(straggler_kind));
+      event->FormatArgument(2, "stragglerId", "%" Pd, straggler_id);
+    } else {
+      event->CopyArgument(1, "stragglerKind", "none");
+      event->CopyArgument(2, "stragglerId", "none");
+    }
+    event->Complete();
   }
+#endif  // !defined(PRODUCT)
 }
 
 void SafepointHandler::ResumeThreads(Thread* T) {
@@ -154,10 +197,7 @@ void SafepointHandler::EnterSafepointUsingLock(Thread* T) {
   MonitorLocker tl(T->thread_lock());
   T->SetAtSafepoint(true);
   if (T->IsSafepointRequested()) {
-    MonitorLocker sl(safepoint_lock_);
-    ASSERT(number_threads_not_at_safepoint_ > 0);
-    number_threads_not_at_safepoint_ -= 1;
-    sl.Notify();
+    CheckIn(T);
   }
 }
 
@@ -176,12 +216,7 @@ void SafepointHandler::BlockForSafepoint(Thread* T) {
   MonitorLocker tl(T->thread_lock());
   if (T->IsSafepointRequested()) {
     T->SetAtSafepoint(true);
-    {
-      MonitorLocker sl(safepoint_lock_);
-      ASSERT(number_threads_not_at_safepoint_ > 0);
-      number_threads_not_at_safepoint_ -= 1;
-      sl.Notify();
-    }
+    CheckIn(T);
     while (T->IsSafepointRequested()) {
       T->SetBlockedForSafepoint(true);
       tl.Wait();
@@ -191,4 +226,24 @@ void SafepointHandler::BlockForSafepoint(Thread* T) {
   }
 }
 
+void SafepointHandler::CheckIn(Thread* T) {
+  ASSERT(T->thread_lock()->IsOwnedByCurrentThread());
+  intptr_t remaining =
+      AtomicOperations::FetchAndDecrement(&number_threads_not_at_safepoint_);
+  ASSERT(remaining > 0);
+  if (remaining == 1) {
+    // Last one in: record who kept the safepoint waiting and wake up the
+    // thread that requested it.
+    MonitorLocker sl(safepoint_lock_);
+    ASSERT(!all_threads_checked_in_);
+    all_threads_checked_in_ = true;
+    straggler_kind_ = T->task_kind();
+#if !defined(PRODUCT)
+    // Matches the thread id reported in timeline events.
+    straggler_id_ = OSThread::ThreadIdToIntPtr(T->os_thread()->trace_id());
+#endif
+    sl.Notify();
+  }
+}
+
 }  // namespace dart
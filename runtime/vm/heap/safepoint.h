@@ -38,6 +38,9 @@ class SafepointHandler {
   void SafepointThreads(Thread* T);
   void ResumeThreads(Thread* T);
 
+  // Called by a thread that was asked to reach a safepoint once it has.
+  void CheckIn(Thread* T);
+
   Isolate* isolate() const { return isolate_; }
   Monitor* threads_lock() const { return isolate_->threads_lock(); }
   bool SafepointInProgress() const {
@@ -75,10 +78,17 @@ class SafepointHandler {
 
   Isolate* isolate_;
 
-  // Monitor used by thread initiating a safepoint operation to track threads
-  // not at a safepoint and wait for these threads to reach a safepoint.
+  // Monitor used by thread initiating a safepoint operation to wait for the
+  // threads not at a safepoint to reach one. The count of those threads is
+  // updated atomically, so only the last thread to check in takes the lock.
   Monitor* safepoint_lock_;
-  int32_t number_threads_not_at_safepoint_;
+  intptr_t number_threads_not_at_safepoint_;
+  bool all_threads_checked_in_;
+
+  // The last thread to check in for the current safepoint operation, which
+  // determines the time to safepoint. Protected by safepoint_lock_.
+  Thread::TaskKind straggler_kind_;
+  intptr_t straggler_id_;
 
   // Count that indicates if a safepoint operation is currently in progress
   // and also tracks the number of recursive safepoint operations on the
@@ -0,0 +1,79 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/heap/sampler.h"
+
+#include <math.h>  // NOLINT
+
+#include "platform/assert.h"
+#include "platform/utils.h"
+#include "vm/raw_object.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            heap_sample_interval,
+            0,
+            "Record a profiler sample of about one Dart heap allocation per "
+            "this many KB allocated. 0 disables heap sampling.");
+
+// Keeps single samples of huge allocations from skewing the estimates, and
+// the distance between sampling points from overflowing.
+static const intptr_t kMaxDistanceFactor = 64;
+
+HeapSampler::HeapSampler()
+    : old_bytes_until_sample_(0), sampled_new_allocation_(0) {}
+
+double HeapSampler::Weight(intptr_t size) {
+  ASSERT(size > 0);
+  const double probability =
+      1.0 - exp(-static_cast<double>(size) / static_cast<double>(interval()));
+  return 1.0 / probability;
+}
+
+intptr_t HeapSampler::NextDistance() {
+  // A uniform sample from (0, 1].
+  const double uniform = (static_cast<double>(random_.NextUInt32()) + 1.0) /
+                         4294967296.0;
+  const double distance = -log(uniform) * static_cast<double>(interval());
+  const double max_distance =
+      static_cast<double>(interval()) * kMaxDistanceFactor;
+  if (distance >= max_distance) {
+    return static_cast<intptr_t>(max_distance);
+  }
+  return Utils::Maximum(static_cast<intptr_t>(distance),
+                        static_cast<intptr_t>(kObjectAlignment));
+}
+
+uword HeapSampler::NewSpaceEnd(uword top, uword end) {
+  if (!enabled()) {
+    return end;
+  }
+  const uword sampling_point = top + NextDistance();
+  return (sampling_point < end) ? sampling_point : end;
+}
+
+intptr_t HeapSampler::TakeSample(uword address, intptr_t size) {
+  if ((address & kNewObjectAlignmentOffset) == kNewObjectAlignmentOffset) {
+    const intptr_t sampled = sampled_new_allocation_;
+    sampled_new_allocation_ = 0;
+    ASSERT((sampled == 0) || (sampled == size));
+    return sampled;
+  }
+  if (!enabled()) {
+    return 0;
+  }
+  if (old_bytes_until_sample_ == 0) {
+    // The first old space allocation since sampling was enabled.
+    old_bytes_until_sample_ = NextDistance();
+  }
+  old_bytes_until_sample_ -= size;
+  if (old_bytes_until_sample_ > 0) {
+    return 0;
+  }
+  old_bytes_until_sample_ = NextDistance();
+  return size;
+}
+
+}  // namespace dart
@@ -0,0 +1,69 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_HEAP_SAMPLER_H_
+#define RUNTIME_VM_HEAP_SAMPLER_H_
+
+#include "vm/allocation.h"
+#include "vm/flags.h"
+#include "vm/globals.h"
+#include "vm/random.h"
+
+namespace dart {
+
+DECLARE_FLAG(int, heap_sample_interval);
+
+// Picks the mutator's Dart heap allocations for the profiler to sample,
+// about one per --heap_sample_interval KB allocated, like TCMalloc's heap
+// profiler. Distances between sampling points are drawn from an exponential
+// distribution, so every allocation of 'size' bytes is sampled with the same
+// probability 1 - exp(-size / interval), and the next sampling point can be
+// redrawn at any time, e.g. after a scavenge, without skewing the profile.
+//
+// New space allocations are inlined into generated code, so the end of the
+// mutator's allocation area is lowered to the next sampling point (see
+// Scavenger::SetThreadEnd). The allocation reaching it then takes the
+// runtime path, where Heap::AllocateNew marks it as sampled. Old space
+// allocations always take the runtime path and are counted directly.
+class HeapSampler {
+ public:
+  HeapSampler();
+
+  static bool enabled() {
+    return FLAG_profiler && (FLAG_heap_sample_interval > 0);
+  }
+  static intptr_t interval() { return FLAG_heap_sample_interval * KB; }
+
+  // The number of allocations of 'size' bytes a sample of one of them
+  // stands for on average.
+  static double Weight(intptr_t size);
+
+  // Returns where the mutator's new space allocation area should end when
+  // it starts at 'top': at 'end', or at the next sampling point if that
+  // comes first.
+  uword NewSpaceEnd(uword top, uword end);
+
+  // Called by Heap::AllocateNew with the size of the allocation it is
+  // making if it reached the sampling point, and 0 otherwise.
+  void set_sampled_new_allocation(intptr_t size) {
+    sampled_new_allocation_ = size;
+  }
+
+  // Returns 'size' if the allocation of 'size' bytes at 'address' the
+  // mutator just made is to be sampled, and 0 otherwise.
+  intptr_t TakeSample(uword address, intptr_t size);
+
+ private:
+  intptr_t NextDistance();
+
+  Random random_;
+  intptr_t old_bytes_until_sample_;
+  intptr_t sampled_new_allocation_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapSampler);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_HEAP_SAMPLER_H_
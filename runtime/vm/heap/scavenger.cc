@@ -7,6 +7,7 @@
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
 #include "vm/flag_list.h"
+#include "vm/heap/pages.h"
 #include "vm/heap/safepoint.h"
 #include "vm/heap/store_buffer.h"
 #include "vm/heap/verifier.h"
@@ -17,12 +18,17 @@
 #include "vm/object_id_ring.h"
 #include "vm/object_set.h"
 #include "vm/stack_frame.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/thread_registry.h"
 #include "vm/timeline.h"
 #include "vm/visitor.h"
 
 namespace dart {
 
+DECLARE_FLAG(int, gc_pause_goal);
+DECLARE_FLAG(int, gc_time_goal);
+
 DEFINE_FLAG(int,
             early_tenuring_threshold,
             66,
@@ -33,6 +39,17 @@ DEFINE_FLAG(int,
             90,
             "Grow new gen when less than this percentage is garbage.");
 DEFINE_FLAG(int, new_gen_growth_factor, 2, "Grow new gen by this factor.");
+DEFINE_FLAG(int,
+            new_gen_survivor_target,
+            25,
+            "Lower the tenuring threshold when survivors occupy more than this "
+            "percentage of new gen, raise it when they occupy less than half.");
+DEFINE_FLAG(int,
+            tenuring_threshold,
+            1,
+            "Number of scavenges an object is kept in new gen before it is "
+            "promoted (at most 3). Negative values adapt the threshold to the "
+            "survival rate.");
 
 // Scavenger uses RawObject::kMarkBit to distinguish forwarded and non-forwarded
 // objects. The kMarkBit does not intersect with the target address because of
@@ -43,6 +60,17 @@ enum {
   kForwarded = kForwardingMask,
 };
 
+// Objects copied within new space age by one scavenge, promoted objects
+// drop their age.
+static inline uint32_t AgedTags(uint32_t tags, bool promoted) {
+  if (promoted) {
+    return RawObject::AgeTag::update(0, tags);
+  }
+  const intptr_t age = RawObject::AgeTag::decode(tags);
+  return RawObject::AgeTag::update(
+      Utils::Minimum(age + 1, RawObject::kMaxAge), tags);
+}
+
 static inline bool IsForwarding(uword header) {
   uword bits = header & kForwardingMask;
   ASSERT((bits == kNotForwarded) || (bits == kForwarded));
@@ -72,6 +100,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
         heap_(scavenger->heap_),
         page_space_(scavenger->heap_->old_space()),
         bytes_promoted_(0),
+        bytes_aged_(0),
         visiting_old_object_(NULL) {}
 
   void VisitPointers(RawObject** first, RawObject** last) {
@@ -93,6 +122,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
   }
 
   intptr_t bytes_promoted() const { return bytes_promoted_; }
+  intptr_t bytes_aged() const { return bytes_aged_; }
 
  private:
   void UpdateStoreBuffer(RawObject** p, RawObject* obj) {
@@ -103,7 +133,15 @@ class ScavengerVisitor : public ObjectPointerVisitor {
       ASSERT(heap_->DataContains(ptr));
     }
     // If the newly written object is not a new object, drop it immediately.
-    if (!obj->IsNewObject() || visiting_old_object_->IsRemembered()) {
+    if (!obj->IsNewObject()) {
+      return;
+    }
+    // Large arrays only remember the card holding the slot.
+    if (visiting_old_object_->IsCardRemembered()) {
+      HeapPage::Of(visiting_old_object_)->RememberCard(p);
+      return;
+    }
+    if (visiting_old_object_->IsRemembered()) {
       return;
     }
     visiting_old_object_->SetRememberedBit();
@@ -132,17 +170,21 @@ class ScavengerVisitor : public ObjectPointerVisitor {
       intptr_t size = raw_obj->Size();
       NOT_IN_PRODUCT(intptr_t cid = raw_obj->GetClassId());
       NOT_IN_PRODUCT(ClassTable* class_table = isolate()->class_table());
+      bool promoted = false;
       // Check whether object should be promoted.
       if (scavenger_->survivor_end_ <= raw_addr) {
         // Not a survivor of a previous scavenge. Just copy the object into the
         // to space.
         new_addr = scavenger_->AllocateGC(size);
         NOT_IN_PRODUCT(class_table->UpdateLiveNew(cid, size));
+      } else if (RawObject::AgeTag::decode(raw_obj->ptr()->tags_) <
+                 scavenger_->tenuring_threshold_) {
+        // A survivor that has not reached the tenuring threshold yet. Keep it
+        // in the to space for another scavenge.
+        new_addr = scavenger_->AllocateGC(size);
+        bytes_aged_ += size;
+        NOT_IN_PRODUCT(class_table->UpdateLiveNew(cid, size));
       } else {
-        // TODO(iposva): Experiment with less aggressive promotion. For example
-        // a coin toss determines if an object is promoted or whether it should
-        // survive in this generation.
-        //
         // This object is a survivor of a previous scavenge. Attempt to promote
         // the object.
         new_addr =
@@ -152,6 +194,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
           // be traversed later.
           scavenger_->PushToPromotedStack(new_addr);
           bytes_promoted_ += size;
+          promoted = true;
           NOT_IN_PRODUCT(class_table->UpdateAllocatedOld(cid, size));
         } else {
           // Promotion did not succeed. Copy into the to space instead.
@@ -166,6 +209,17 @@ class ScavengerVisitor : public ObjectPointerVisitor {
       // Copy the object to the new location.
       memmove(reinterpret_cast<void*>(new_addr),
               reinterpret_cast<void*>(raw_addr), size);
+      RawObject* copied_obj = RawObject::FromAddr(new_addr);
+      copied_obj->ptr()->tags_ = AgedTags(copied_obj->ptr()->tags_, promoted);
+      if (promoted && page_space_->IsMarking()) {
+        // Like allocations in old space during concurrent marking, promoted
+        // objects are black and remembered, so that the marker visits their
+        // pointers before marking completes.
+        RawObject* promoted_obj = RawObject::FromAddr(new_addr);
+        promoted_obj->SetMarkBitUnsynchronized();
+        promoted_obj->SetRememberedBitUnsynchronized();
+        thread_->StoreBufferAddObjectGC(promoted_obj);
+      }
       // Remember forwarding address.
       ForwardTo(raw_addr, new_addr);
     }
@@ -185,6 +239,7 @@ class ScavengerVisitor : public ObjectPointerVisitor {
   PageSpace* page_space_;
   RawWeakProperty* delayed_weak_properties_;
   intptr_t bytes_promoted_;
+  intptr_t bytes_aged_;
   RawObject* visiting_old_object_;
 
   friend class Scavenger;
@@ -192,6 +247,427 @@ class ScavengerVisitor : public ObjectPointerVisitor {
   DISALLOW_COPY_AND_ASSIGN(ScavengerVisitor);
 };
 
+// Parallel scavenger tasks copy and promote objects into task-local chunks of
+// the to space and of old space, so the shared allocation tops are only
+// touched once per chunk.
+static const intptr_t kScavengerLabSize = 32 * KB;
+// Larger objects are allocated directly, which bounds the space lost at the
+// end of each chunk.
+static const intptr_t kScavengerLabMaxObjectSize = kScavengerLabSize / 4;
+
+class ScavengerWorkList : public ValueObject {
+ public:
+  explicit ScavengerWorkList(ScavengerStack* scavenger_stack)
+      : scavenger_stack_(scavenger_stack) {
+    work_ = scavenger_stack_->PopEmptyBlock();
+  }
+
+  ~ScavengerWorkList() {
+    ASSERT(work_ == NULL);
+    ASSERT(scavenger_stack_ == NULL);
+  }
+
+  // Returns NULL if no more work was found.
+  RawObject* Pop() {
+    ASSERT(work_ != NULL);
+    if (work_->IsEmpty()) {
+      ScavengerStack::Block* new_work = scavenger_stack_->PopNonEmptyBlock();
+      if (new_work == NULL) {
+        return NULL;
+      }
+      scavenger_stack_->PushBlock(work_);
+      work_ = new_work;
+    }
+    return work_->Pop();
+  }
+
+  void Push(RawObject* raw_obj) {
+    if (work_->IsFull()) {
+      // Full blocks are published so that idle tasks can steal them.
+      scavenger_stack_->PushBlock(work_);
+      work_ = scavenger_stack_->PopEmptyBlock();
+    }
+    work_->Push(raw_obj);
+  }
+
+  void Finalize() {
+    ASSERT(work_->IsEmpty());
+    scavenger_stack_->PushBlock(work_);
+    work_ = NULL;
+    // Fail fast on attempts to scavenge after finalizing.
+    scavenger_stack_ = NULL;
+  }
+
+ private:
+  ScavengerStack::Block* work_;
+  ScavengerStack* scavenger_stack_;
+};
+
+// Visitor used by the parallel scavenger tasks. Unlike ScavengerVisitor, the
+// objects still to be scanned are kept on a shared ScavengerStack instead of
+// being found by a Cheney scan of the to space, and objects are forwarded with
+// a compare-and-swap on the header so that racing tasks agree on one copy.
+class ParallelScavengerVisitor : public ObjectPointerVisitor {
+ public:
+  ParallelScavengerVisitor(Isolate* isolate,
+                           Scavenger* scavenger,
+                           SemiSpace* from,
+                           ScavengerStack* scavenger_stack)
+      : ObjectPointerVisitor(isolate),
+        thread_(Thread::Current()),
+        scavenger_(scavenger),
+        from_(from),
+        heap_(scavenger->heap_),
+        page_space_(scavenger->heap_->old_space()),
+        work_list_(scavenger_stack),
+        copy_top_(0),
+        copy_end_(0),
+        promo_top_(0),
+        promo_end_(0),
+        delayed_weak_properties_(NULL),
+        bytes_promoted_(0),
+        bytes_aged_(0),
+        visiting_old_object_(NULL) {}
+
+  void VisitPointers(RawObject** first, RawObject** last) {
+    ASSERT(Utils::IsAligned(first, sizeof(*first)));
+    ASSERT(Utils::IsAligned(last, sizeof(*last)));
+    for (RawObject** current = first; current <= last; current++) {
+      ScavengePointer(current);
+    }
+  }
+
+  void VisitingOldObject(RawObject* obj) {
+    ASSERT((obj == NULL) || obj->IsOldObject());
+    visiting_old_object_ = obj;
+  }
+
+  intptr_t bytes_promoted() const { return bytes_promoted_; }
+  intptr_t bytes_aged() const { return bytes_aged_; }
+
+  // Visits an old object that was recorded in the store buffer.
+  void VisitRememberedObject(RawObject* raw_obj) {
+    ASSERT(!raw_obj->IsForwardingCorpse());
+    ASSERT(raw_obj->IsRemembered());
+    raw_obj->ClearRememberedBit();
+    VisitingOldObject(raw_obj);
+    raw_obj->VisitPointersNonvirtual(this);
+    VisitingOldObject(NULL);
+  }
+
+  void DrainWorkList() {
+    RawObject* raw_obj = work_list_.Pop();
+    while (raw_obj != NULL) {
+      if (raw_obj->IsNewObject()) {
+        if (raw_obj->GetClassId() == kWeakPropertyCid) {
+          ProcessWeakProperty(reinterpret_cast<RawWeakProperty*>(raw_obj));
+        } else {
+          raw_obj->VisitPointersNonvirtual(this);
+        }
+      } else {
+        // As in the serial scavenger, promoted weak properties are visited
+        // like any other promoted object.
+        ASSERT(!raw_obj->IsRemembered());
+        VisitingOldObject(raw_obj);
+        raw_obj->VisitPointersNonvirtual(this);
+        VisitingOldObject(NULL);
+      }
+      raw_obj = work_list_.Pop();
+    }
+  }
+
+  // Visits the pending weak properties whose keys have been copied, possibly
+  // by another task, since they were enqueued. Returns true if any weak
+  // property was visited, which may have produced more work.
+  bool ProcessPendingWeakProperties() {
+    bool visited = false;
+    RawWeakProperty* cur_weak = delayed_weak_properties_;
+    delayed_weak_properties_ = NULL;
+    while (cur_weak != NULL) {
+      uword next_weak = cur_weak->ptr()->next_;
+      ASSERT(cur_weak->IsNewObject());
+      RawObject* raw_key = cur_weak->ptr()->key_;
+      ASSERT(raw_key->IsHeapObject());
+      ASSERT(raw_key->IsNewObject());
+      uword raw_addr = RawObject::ToAddr(raw_key);
+      ASSERT(from_->Contains(raw_addr));
+      uword header = AtomicOperations::LoadRelaxed(
+          reinterpret_cast<uword*>(raw_addr));
+      // Reset the next pointer in the weak property.
+      cur_weak->ptr()->next_ = 0;
+      if (IsForwarding(header)) {
+        cur_weak->VisitPointersNonvirtual(this);
+        visited = true;
+      } else {
+        EnqueueWeakProperty(cur_weak);
+      }
+      // Advance to next weak property in the queue.
+      cur_weak = reinterpret_cast<RawWeakProperty*>(next_weak);
+    }
+    return visited;
+  }
+
+  // Called when all scavenging is complete.
+  void Finalize() {
+    work_list_.Finalize();
+    AbandonCopyBuffer();
+    AbandonPromoBuffer();
+    // The remaining weak properties have unreachable keys, so clear them.
+    while (delayed_weak_properties_ != NULL) {
+      RawWeakProperty* cur_weak = delayed_weak_properties_;
+      delayed_weak_properties_ =
+          reinterpret_cast<RawWeakProperty*>(cur_weak->ptr()->next_);
+      cur_weak->ptr()->next_ = 0;
+      WeakProperty::Clear(cur_weak);
+    }
+  }
+
+ private:
+  void UpdateStoreBuffer(RawObject** p, RawObject* obj) {
+    ASSERT(obj->IsHeapObject());
+    if (FLAG_verify_gc_contains) {
+      uword ptr = reinterpret_cast<uword>(p);
+      ASSERT(!scavenger_->Contains(ptr));
+      ASSERT(heap_->DataContains(ptr));
+    }
+    // If the newly written object is not a new object, drop it immediately.
+    if (!obj->IsNewObject()) {
+      return;
+    }
+    // Large arrays only remember the card holding the slot.
+    if (visiting_old_object_->IsCardRemembered()) {
+      HeapPage::Of(visiting_old_object_)->RememberCard(p);
+      return;
+    }
+    if (visiting_old_object_->IsRemembered()) {
+      return;
+    }
+    visiting_old_object_->SetRememberedBit();
+    thread_->StoreBufferAddObjectGC(visiting_old_object_);
+  }
+
+  void ScavengePointer(RawObject** p) {
+    RawObject* raw_obj = *p;
+
+    if (raw_obj->IsSmiOrOldObject()) {
+      return;
+    }
+
+    uword raw_addr = RawObject::ToAddr(raw_obj);
+    // The scavenger only expects objects located in the from space.
+    ASSERT(from_->Contains(raw_addr));
+    uword header =
+        AtomicOperations::LoadRelaxed(reinterpret_cast<uword*>(raw_addr));
+    uword new_addr = IsForwarding(header)
+                         ? ForwardedAddr(header)
+                         : CopyAndForward(raw_obj, raw_addr, header);
+    // Update the reference.
+    RawObject* new_obj = RawObject::FromAddr(new_addr);
+    *p = new_obj;
+    // Update the store buffer as needed.
+    if (visiting_old_object_ != NULL) {
+      UpdateStoreBuffer(p, new_obj);
+    }
+  }
+
+  // Copies or promotes the object and installs the forwarding pointer. If
+  // another task forwarded the object first, our copy is discarded and the
+  // winner's address is returned.
+  uword CopyAndForward(RawObject* raw_obj, uword raw_addr, uword header) {
+    // Another task may overwrite the header at any time, so size and class
+    // must be decoded from the header loaded by the caller.
+    const uint32_t tags = static_cast<uint32_t>(header);
+    const intptr_t size = raw_obj->HeapSize(tags);
+    NOT_IN_PRODUCT(intptr_t cid = RawObject::ClassIdTag::decode(tags));
+    NOT_IN_PRODUCT(ClassTable* class_table = isolate()->class_table());
+    uword new_addr = 0;
+    bool aged = false;
+    if (scavenger_->survivor_end_ <= raw_addr) {
+      // Not a survivor of a previous scavenge. Just copy the object into the
+      // to space.
+      new_addr = TryAllocateCopy(size);
+    } else if (RawObject::AgeTag::decode(tags) <
+               scavenger_->tenuring_threshold_) {
+      // A survivor below the tenuring threshold stays in new space if it can.
+      new_addr = TryAllocateCopy(size);
+      aged = (new_addr != 0);
+    }
+    bool promoted = false;
+    if (new_addr == 0) {
+      // Either a survivor of a previous scavenge, or the to space has been
+      // exhausted by the unused ends of other tasks' buffers.
+      new_addr = TryAllocatePromo(size);
+      if (new_addr != 0) {
+        promoted = true;
+      } else {
+        // Promotion did not succeed. Copy into the to space instead.
+        scavenger_->failed_to_promote_ = true;
+        new_addr = TryAllocateCopy(size);
+        if (new_addr == 0) {
+          OUT_OF_MEMORY();
+        }
+      }
+    }
+    // Copy the object to the new location. The header is restored from the
+    // value loaded before copying, as a racing task may have changed it.
+    memmove(reinterpret_cast<void*>(new_addr),
+            reinterpret_cast<void*>(raw_addr), size);
+    *reinterpret_cast<uword*>(new_addr) = header;
+    RawObject::FromAddr(new_addr)->ptr()->tags_ = AgedTags(tags, promoted);
+    // Remember forwarding address.
+    ASSERT((new_addr & kForwardingMask) == 0);
+    uword old_header = AtomicOperations::CompareAndSwapWord(
+        reinterpret_cast<uword*>(raw_addr), header, new_addr | kForwarded);
+    if (old_header != header) {
+      // Lost the race against another task.
+      UndoAllocation(new_addr, size, promoted);
+      return ForwardedAddr(old_header);
+    }
+    if (promoted) {
+      bytes_promoted_ += size;
+      NOT_IN_PRODUCT(class_table->UpdateAllocatedOld(cid, size));
+    } else {
+      if (aged) {
+        bytes_aged_ += size;
+      }
+      NOT_IN_PRODUCT(class_table->UpdateLiveNew(cid, size));
+    }
+    // The copy still has to be scanned for pointers into the from space.
+    work_list_.Push(RawObject::FromAddr(new_addr));
+    return new_addr;
+  }
+
+  uword TryAllocateCopy(intptr_t size) {
+    if (size > kScavengerLabMaxObjectSize) {
+      return scavenger_->TryAllocateGCParallel(size);
+    }
+    if ((copy_end_ - copy_top_) < static_cast<uword>(size)) {
+      uword buffer = scavenger_->TryAllocateGCParallel(kScavengerLabSize);
+      if (buffer == 0) {
+        // Less than a buffer is left in the to space.
+        return scavenger_->TryAllocateGCParallel(size);
+      }
+      AbandonCopyBuffer();
+      copy_top_ = buffer;
+      copy_end_ = buffer + kScavengerLabSize;
+    }
+    uword result = copy_top_;
+    copy_top_ += size;
+    return result;
+  }
+
+  uword TryAllocatePromo(intptr_t size) {
+    if (size > kScavengerLabMaxObjectSize) {
+      return TryAllocatePromoFromPageSpace(size);
+    }
+    if ((promo_end_ - promo_top_) < static_cast<uword>(size)) {
+      uword buffer = TryAllocatePromoFromPageSpace(kScavengerLabSize);
+      if (buffer == 0) {
+        return TryAllocatePromoFromPageSpace(size);
+      }
+      AbandonPromoBuffer();
+      promo_top_ = buffer;
+      promo_end_ = buffer + kScavengerLabSize;
+    }
+    uword result = promo_top_;
+    promo_top_ += size;
+    return result;
+  }
+
+  uword TryAllocatePromoFromPageSpace(intptr_t size) {
+    page_space_->AcquireDataLock();
+    uword result =
+        page_space_->TryAllocatePromoLocked(size, PageSpace::kForceGrowth);
+    page_space_->ReleaseDataLock();
+    return result;
+  }
+
+  void FreePromoToPageSpace(uword addr, intptr_t size) {
+    page_space_->AcquireDataLock();
+    page_space_->FreePromoLocked(addr, size);
+    page_space_->ReleaseDataLock();
+  }
+
+  void UndoAllocation(uword addr, intptr_t size, bool promoted) {
+    if (promoted) {
+      if (addr + size == promo_top_) {
+        promo_top_ = addr;
+      } else {
+        FreePromoToPageSpace(addr, size);
+      }
+    } else {
+      if (addr + size == copy_top_) {
+        copy_top_ = addr;
+      } else {
+        // Keep the to space walkable.
+        FreeListElement::AsElement(addr, size);
+      }
+    }
+  }
+
+  void AbandonCopyBuffer() {
+    if (copy_top_ < copy_end_) {
+      // Keep the to space walkable.
+      FreeListElement::AsElement(copy_top_, copy_end_ - copy_top_);
+    }
+    copy_top_ = 0;
+    copy_end_ = 0;
+  }
+
+  void AbandonPromoBuffer() {
+    if (promo_top_ < promo_end_) {
+      FreePromoToPageSpace(promo_top_, promo_end_ - promo_top_);
+    }
+    promo_top_ = 0;
+    promo_end_ = 0;
+  }
+
+  void EnqueueWeakProperty(RawWeakProperty* raw_weak) {
+    ASSERT(raw_weak->IsHeapObject());
+    ASSERT(raw_weak->IsNewObject());
+    ASSERT(raw_weak->IsWeakProperty());
+    ASSERT(raw_weak->ptr()->next_ == 0);
+    raw_weak->ptr()->next_ = reinterpret_cast<uword>(delayed_weak_properties_);
+    delayed_weak_properties_ = raw_weak;
+  }
+
+  void ProcessWeakProperty(RawWeakProperty* raw_weak) {
+    // The fate of the weak property is determined by its key.
+    RawObject* raw_key = raw_weak->ptr()->key_;
+    if (raw_key->IsHeapObject() && raw_key->IsNewObject()) {
+      uword raw_addr = RawObject::ToAddr(raw_key);
+      uword header =
+          AtomicOperations::LoadRelaxed(reinterpret_cast<uword*>(raw_addr));
+      if (!IsForwarding(header)) {
+        // Key is white.  Enqueue the weak property.
+        EnqueueWeakProperty(raw_weak);
+        return;
+      }
+    }
+    // Key is gray or black.  Make the weak property black.
+    raw_weak->VisitPointersNonvirtual(this);
+  }
+
+  Thread* thread_;
+  Scavenger* scavenger_;
+  SemiSpace* from_;
+  Heap* heap_;
+  PageSpace* page_space_;
+  ScavengerWorkList work_list_;
+  // Task-local buffer in the to space.
+  uword copy_top_;
+  uword copy_end_;
+  // Task-local buffer in old space.
+  uword promo_top_;
+  uword promo_end_;
+  RawWeakProperty* delayed_weak_properties_;
+  intptr_t bytes_promoted_;
+  intptr_t bytes_aged_;
+  RawObject* visiting_old_object_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavengerVisitor);
+};
+
 class ScavengerWeakVisitor : public HandleVisitor {
  public:
   ScavengerWeakVisitor(Thread* thread, Scavenger* scavenger)
@@ -206,7 +682,8 @@ class ScavengerWeakVisitor : public HandleVisitor {
         reinterpret_cast<FinalizablePersistentHandle*>(addr);
     RawObject** p = handle->raw_addr();
     if (scavenger_->IsUnreachable(p)) {
-      handle->UpdateUnreachable(thread()->isolate());
+      handle->PrepareFinalization(thread()->isolate());
+      unreachable_.Add(handle);
     } else {
       handle->UpdateRelocated(thread()->isolate());
 #ifndef PRODUCT
@@ -221,9 +698,16 @@ class ScavengerWeakVisitor : public HandleVisitor {
     }
   }
 
+  // Queues the finalizers of the unreachable handles found.
+  void Finalize() {
+    thread()->isolate()->api_state()->AddPendingFinalizers(unreachable_);
+    unreachable_.Clear();
+  }
+
  private:
   Scavenger* scavenger_;
   ClassTable* class_table_;
+  MallocGrowableArray<FinalizablePersistentHandle*> unreachable_;
 
   DISALLOW_COPY_AND_ASSIGN(ScavengerWeakVisitor);
 };
@@ -276,6 +760,16 @@ void SemiSpace::InitOnce() {
   ASSERT(mutex_ != NULL);
 }
 
+void SemiSpace::Cleanup() {
+  SemiSpace* cache = NULL;
+  {
+    MutexLocker locker(mutex_);
+    cache = cache_;
+    cache_ = NULL;
+  }
+  delete cache;
+}
+
 SemiSpace* SemiSpace::New(intptr_t size_in_words, const char* name) {
   {
     MutexLocker locker(mutex_);
@@ -291,8 +785,10 @@ SemiSpace* SemiSpace::New(intptr_t size_in_words, const char* name) {
   } else {
     intptr_t size_in_bytes = size_in_words << kWordSizeLog2;
     const bool kExecutable = false;
-    VirtualMemory* memory =
-        VirtualMemory::Allocate(size_in_bytes, kExecutable, name);
+    const bool kTruncatable = false;
+    VirtualMemory* memory = VirtualMemory::AllocateWithHugePages(
+        size_in_bytes, VirtualMemory::PageSize(), kExecutable, kTruncatable,
+        name);
     if (memory == NULL) {
       // TODO(koda): If cache_ is not empty, we could try to delete it.
       return NULL;
@@ -347,6 +843,14 @@ Scavenger::Scavenger(Heap* heap,
       idle_scavenge_threshold_in_words_(0),
       external_size_(0),
       failed_to_promote_(false) {
+  const intptr_t initial_tenuring_threshold =
+      (FLAG_tenuring_threshold < 0)
+          ? 1
+          : Utils::Minimum<intptr_t>(FLAG_tenuring_threshold,
+                                     RawObject::kMaxAge);
+  tenuring_threshold_ = initial_tenuring_threshold;
+  target_tenuring_threshold_ = initial_tenuring_threshold;
+
   // Verify assumptions about the first word in objects which the scavenger is
   // going to use for forwarding pointers.
   ASSERT(Object::tags_offset() == 0);
@@ -362,6 +866,8 @@ Scavenger::Scavenger(Heap* heap,
   if (to_ == NULL) {
     OUT_OF_MEMORY();
   }
+  heap_->BindToNumaNode(to_->start(),
+                        to_->size_in_words() << kWordSizeLog2);
   // Setup local fields.
   top_ = FirstObjectStart();
   resolved_top_ = top_;
@@ -383,6 +889,9 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   if (stats_history_.Size() == 0) {
     return old_size_in_words;
   }
+  if (FLAG_gc_pause_goal > 0) {
+    return PauseGoalSizeInWords(old_size_in_words);
+  }
   double garbage = stats_history_.Get(0).ExpectedGarbageFraction();
   if (garbage < (FLAG_new_gen_garbage_threshold / 100.0)) {
     return Utils::Minimum(max_semi_capacity_in_words_,
@@ -392,6 +901,92 @@ intptr_t Scavenger::NewSizeInWords(intptr_t old_size_in_words) const {
   }
 }
 
+intptr_t Scavenger::PauseGoalSizeInWords(intptr_t old_size_in_words) const {
+  // Grow while scavenging takes more than its share of time, as survivors
+  // have longer to die in a larger new space, and shrink when well below it.
+  intptr_t size_in_words = old_size_in_words;
+  if (stats_history_.Size() >= 2) {
+    int64_t gc_micros = 0;
+    for (intptr_t i = 0; i < stats_history_.Size() - 1; i++) {
+      gc_micros += stats_history_.Get(i).DurationMicros();
+    }
+    const int64_t total_micros =
+        stats_history_.Get(0).EndMicros() -
+        stats_history_.Get(stats_history_.Size() - 1).EndMicros();
+    if (total_micros > 0) {
+      const double fraction = gc_micros / static_cast<double>(total_micros);
+      const double goal = FLAG_gc_time_goal / 100.0;
+      if (fraction > goal) {
+        size_in_words *= FLAG_new_gen_growth_factor;
+      } else if (fraction < (goal / 2)) {
+        size_in_words /= FLAG_new_gen_growth_factor;
+      }
+    }
+  }
+
+  // A scavenge of a full new space should fit the pause goal at the measured
+  // scavenge speed.
+  const int64_t pause_limit_in_words =
+      static_cast<int64_t>(FLAG_gc_pause_goal) * kMicrosecondsPerMillisecond *
+      scavenge_words_per_micro_;
+  if (pause_limit_in_words < size_in_words) {
+    size_in_words = static_cast<intptr_t>(pause_limit_in_words);
+  }
+  size_in_words = Utils::Maximum(Utils::RoundUp(size_in_words, MBInWords),
+                                 FLAG_new_gen_semi_initial_size * MBInWords);
+  size_in_words = Utils::Minimum(max_semi_capacity_in_words_, size_in_words);
+
+  // Everything allocated in the from space may survive, so the to space must
+  // be able to hold all of it.
+  uword top = top_;
+  Isolate* isolate = heap_->isolate();
+  if (isolate->IsMutatorThreadScheduled()) {
+    top = isolate->mutator_thread()->top();
+  }
+  const intptr_t used_in_words = Utils::RoundUp(
+      (top - FirstObjectStart()) >> kWordSizeLog2, MBInWords);
+  return Utils::Maximum(used_in_words, size_in_words);
+}
+
+void Scavenger::SampleSurvival(uword start, uword end) {
+  // The from space is still intact: dead objects are unchanged and the
+  // survivors have been replaced by forwarding headers.
+  PretenuringFeedback* pretenuring_feedback = heap_->pretenuring_feedback();
+  uword cur = start;
+  while (cur < end) {
+    const uword header = *reinterpret_cast<uword*>(cur);
+    const bool survived = IsForwarding(header);
+    RawObject* raw_obj = survived ? RawObject::FromAddr(ForwardedAddr(header))
+                                  : RawObject::FromAddr(cur);
+    const intptr_t size = raw_obj->Size();
+    pretenuring_feedback->RecordSample(raw_obj->GetClassId(), size, survived);
+    cur += size;
+  }
+}
+
+void Scavenger::UpdateTenuringThreshold() {
+  if (FLAG_tenuring_threshold >= 0) {
+    target_tenuring_threshold_ = Utils::Minimum<intptr_t>(
+        FLAG_tenuring_threshold, RawObject::kMaxAge);
+    return;
+  }
+  // Keep survivors in new space longer while they leave enough room for
+  // allocation, so that objects living for a few scavenges die young instead
+  // of filling the old generation.
+  const ScavengeStats& stats = stats_history_.Get(0);
+  const double target = FLAG_new_gen_survivor_target / 100.0;
+  const double survivors = stats.SurvivorFraction();
+  if (survivors > target) {
+    if (target_tenuring_threshold_ > 1) {
+      target_tenuring_threshold_--;
+    }
+  } else if ((survivors < (target / 2)) && (stats.PromotedInWords() > 0)) {
+    if (target_tenuring_threshold_ < RawObject::kMaxAge) {
+      target_tenuring_threshold_++;
+    }
+  }
+}
+
 SemiSpace* Scavenger::Prologue(Isolate* isolate) {
   NOT_IN_PRODUCT(isolate->class_table()->ResetCountersNew());
 
@@ -410,6 +1005,8 @@ SemiSpace* Scavenger::Prologue(Isolate* isolate) {
     // isolate to finish scavenge, etc.).
     OUT_OF_MEMORY();
   }
+  heap_->BindToNumaNode(to_->start(),
+                        to_->size_in_words() << kWordSizeLog2);
   UpdateMaxHeapCapacity();
   top_ = FirstObjectStart();
   resolved_top_ = top_;
@@ -419,12 +1016,16 @@ SemiSpace* Scavenger::Prologue(Isolate* isolate) {
   if (isolate->IsMutatorThreadScheduled()) {
     Thread* mutator_thread = isolate->mutator_thread();
     mutator_thread->set_top(top_);
-    mutator_thread->set_end(end_);
+    SetThreadEnd(mutator_thread);
   }
 
   return from;
 }
 
+void Scavenger::SetThreadEnd(Thread* thread) {
+  thread->set_end(heap_->sampler()->NewSpaceEnd(thread->top(), end_));
+}
+
 void Scavenger::Epilogue(Isolate* isolate, SemiSpace* from) {
   // All objects in the to space have been copied from the from space at this
   // moment.
@@ -434,7 +1035,7 @@ void Scavenger::Epilogue(Isolate* isolate, SemiSpace* from) {
   if (isolate->IsMutatorThreadScheduled()) {
     Thread* thread = isolate->mutator_thread();
     thread->set_top(top_);
-    thread->set_end(end_);
+    SetThreadEnd(thread);
   }
 
   double avg_frac = stats_history_.Get(0).PromoCandidatesSuccessFraction();
@@ -443,13 +1044,16 @@ void Scavenger::Epilogue(Isolate* isolate, SemiSpace* from) {
     avg_frac += 0.5 * stats_history_.Get(1).PromoCandidatesSuccessFraction();
     avg_frac /= 1.0 + 0.5;  // Normalize.
   }
+  UpdateTenuringThreshold();
   if (avg_frac < (FLAG_early_tenuring_threshold / 100.0)) {
     // Remember the limit to which objects have been copied.
     survivor_end_ = top_;
+    tenuring_threshold_ = target_tenuring_threshold_;
   } else {
     // Move survivor end to the end of the to_ space, making all surviving
     // objects candidates for promotion next time.
     survivor_end_ = end_;
+    tenuring_threshold_ = 0;
   }
 
   // Update estimate of scavenger speed. This statistic assumes survivorship
@@ -534,6 +1138,9 @@ void Scavenger::IterateStoreBuffers(Isolate* isolate,
   // Grab the deduplication sets out of the isolate's consolidated store buffer.
   StoreBufferBlock* pending = isolate->store_buffer()->Blocks();
   intptr_t total_count = 0;
+  // While the old generation is marked concurrently, the store buffer also
+  // holds the objects the marker needs to visit again; keep them.
+  const bool is_marking = heap_->old_space()->IsMarking();
   while (pending != NULL) {
     StoreBufferBlock* next = pending->next();
     // Generated code appends to store buffers; tell MemorySanitizer.
@@ -547,6 +1154,11 @@ void Scavenger::IterateStoreBuffers(Isolate* isolate,
       raw_object->ClearRememberedBit();
       visitor->VisitingOldObject(raw_object);
       raw_object->VisitPointersNonvirtual(visitor);
+      if (is_marking && raw_object->IsMarked() &&
+          !raw_object->IsRemembered()) {
+        raw_object->SetRememberedBit();
+        visitor->thread_->StoreBufferAddObjectGC(raw_object);
+      }
     }
     pending->Reset();
     // Return the emptied block for recycling (no need to check threshold).
@@ -554,14 +1166,13 @@ void Scavenger::IterateStoreBuffers(Isolate* isolate,
     pending = next;
   }
   heap_->RecordData(kStoreBufferEntries, total_count);
-  heap_->RecordData(kDataUnused1, 0);
   heap_->RecordData(kDataUnused2, 0);
   // Done iterating through old objects remembered in the store buffers.
   visitor->VisitingOldObject(NULL);
 }
 
 void Scavenger::IterateObjectIdTable(Isolate* isolate,
-                                     ScavengerVisitor* visitor) {
+                                     ObjectPointerVisitor* visitor) {
 #ifndef PRODUCT
   if (!FLAG_support_service) {
     return;
@@ -581,6 +1192,7 @@ void Scavenger::IterateRoots(Isolate* isolate, ScavengerVisitor* visitor) {
   isolate->VisitObjectPointers(visitor, ValidationPolicy::kDontValidateFrames);
   int64_t middle = OS::GetCurrentMonotonicMicros();
   IterateStoreBuffers(isolate, visitor);
+  heap_->old_space()->VisitRememberedCards(visitor);
   IterateObjectIdTable(isolate, visitor);
   int64_t end = OS::GetCurrentMonotonicMicros();
   heap_->RecordData(kToKBAfterStoreBuffer, RoundWordsToKB(UsedInWords()));
@@ -589,6 +1201,23 @@ void Scavenger::IterateRoots(Isolate* isolate, ScavengerVisitor* visitor) {
   heap_->RecordTime(kDummyScavengeTime, 0);
 }
 
+void Scavenger::IterateRootSlice(Isolate* isolate,
+                                 ObjectPointerVisitor* visitor,
+                                 intptr_t slice_index,
+                                 intptr_t num_slices) {
+  ASSERT(0 <= slice_index && slice_index < num_slices);
+  if ((slice_index == 0) || (num_slices <= 1)) {
+    isolate->VisitObjectPointers(visitor,
+                                 ValidationPolicy::kDontValidateFrames);
+  }
+  if ((slice_index == 1) || (num_slices <= 1)) {
+    IterateObjectIdTable(isolate, visitor);
+  }
+
+  // For now, we just distinguish two parts of the root set, so any remaining
+  // slices are empty. The store buffers are shared among all slices.
+}
+
 bool Scavenger::IsUnreachable(RawObject** p) {
   RawObject* raw_obj = *p;
   if (!raw_obj->IsHeapObject()) {
@@ -610,8 +1239,11 @@ bool Scavenger::IsUnreachable(RawObject** p) {
   return true;
 }
 
-void Scavenger::IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor) {
-  isolate->VisitWeakPersistentHandles(visitor);
+void Scavenger::IterateWeakRoots(Isolate* isolate,
+                                 HandleVisitor* visitor,
+                                 intptr_t slice_index,
+                                 intptr_t num_slices) {
+  isolate->VisitWeakPersistentHandles(visitor, slice_index, num_slices);
 }
 
 void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
@@ -675,6 +1307,261 @@ void Scavenger::ProcessToSpace(ScavengerVisitor* visitor) {
   }
 }
 
+uword Scavenger::TryAllocateGCParallel(intptr_t size) {
+  ASSERT(Utils::IsAligned(size, kObjectAlignment));
+  ASSERT(scavenging_);
+  uword top = AtomicOperations::LoadRelaxed(&top_);
+  while (true) {
+    if (static_cast<uword>(size) > (end_ - top)) {
+      return 0;
+    }
+    uword old_top =
+        AtomicOperations::CompareAndSwapWord(&top_, top, top + size);
+    if (old_top == top) {
+      ASSERT(to_->Contains(top));
+      ASSERT((top & kObjectAlignmentMask) == object_alignment_);
+      return top;
+    }
+    top = old_top;
+  }
+}
+
+// The store buffer blocks recorded before a parallel scavenge started. The
+// tasks compete for them; blocks pushed to the isolate's store buffer during
+// the scavenge contain re-remembered objects and must not be visited again.
+class PendingStoreBufferBlocks : public ValueObject {
+ public:
+  explicit PendingStoreBufferBlocks(StoreBufferBlock* head) : head_(head) {}
+
+  StoreBufferBlock* Pop() {
+    MutexLocker ml(&mutex_);
+    StoreBufferBlock* result = head_;
+    if (result != NULL) {
+      head_ = result->next();
+    }
+    return result;
+  }
+
+ private:
+  Mutex mutex_;
+  StoreBufferBlock* head_;
+
+  DISALLOW_COPY_AND_ASSIGN(PendingStoreBufferBlocks);
+};
+
+class ParallelScavengerTask : public ThreadPool::Task {
+ public:
+  ParallelScavengerTask(Scavenger* scavenger,
+                        Isolate* isolate,
+                        SemiSpace* from,
+                        ScavengerStack* scavenger_stack,
+                        PendingStoreBufferBlocks* pending_blocks,
+                        ThreadBarrier* barrier,
+                        intptr_t task_index,
+                        intptr_t num_tasks,
+                        uintptr_t* num_busy,
+                        intptr_t* bytes_promoted,
+                        intptr_t* bytes_aged,
+                        intptr_t* store_buffer_entries)
+      : scavenger_(scavenger),
+        isolate_(isolate),
+        from_(from),
+        scavenger_stack_(scavenger_stack),
+        pending_blocks_(pending_blocks),
+        barrier_(barrier),
+        task_index_(task_index),
+        num_tasks_(num_tasks),
+        num_busy_(num_busy),
+        bytes_promoted_(bytes_promoted),
+        bytes_aged_(bytes_aged),
+        store_buffer_entries_(store_buffer_entries) {}
+
+  virtual void Run() {
+    bool result =
+        Thread::EnterIsolateAsHelper(isolate_, Thread::kScavengerTask, true);
+    ASSERT(result);
+    {
+      Thread* thread = Thread::Current();
+      TIMELINE_FUNCTION_GC_DURATION(thread, "ParallelScavengerTask");
+      ParallelScavengerVisitor visitor(isolate_, scavenger_, from_,
+                                       scavenger_stack_);
+      // Phase 1: Iterate over roots and drain the work list in tasks.
+      IterateRoots(&visitor);
+
+      bool more_to_scavenge = false;
+      do {
+        do {
+          visitor.DrainWorkList();
+
+          // I can't find more work right now. If no other task is busy,
+          // then there will never be more work (NB: 1 is *before* decrement).
+          if (AtomicOperations::FetchAndDecrement(num_busy_) == 1) break;
+
+          // Wait for some work to appear.
+          while (scavenger_stack_->IsEmpty() &&
+                 AtomicOperations::LoadRelaxed(num_busy_) > 0) {
+          }
+
+          // If no tasks are busy, there will never be more work.
+          if (AtomicOperations::LoadRelaxed(num_busy_) == 0) break;
+
+          // I saw some work; get busy and compete for it.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+        } while (true);
+        // Wait for all scavengers to stop.
+        barrier_->Sync();
+#if defined(DEBUG)
+        ASSERT(AtomicOperations::LoadRelaxed(num_busy_) == 0);
+        // Caveat: must not allow any task to continue past the barrier
+        // before we checked num_busy, otherwise one of them might rush
+        // ahead and increment it.
+        barrier_->Sync();
+#endif
+        // Check if we have any pending weak properties whose keys were
+        // copied, possibly by another task.
+        more_to_scavenge = visitor.ProcessPendingWeakProperties();
+        if (more_to_scavenge) {
+          // We have more work to do. Notify others.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+        }
+
+        // Wait for all other tasks to finish processing their pending weak
+        // properties and decide if they need to continue scavenging.
+        barrier_->Sync();
+        if (!more_to_scavenge &&
+            (AtomicOperations::LoadRelaxed(num_busy_) > 0)) {
+          // All tasks continue to scavenge as long as any single task has
+          // some work to do.
+          AtomicOperations::FetchAndIncrement(num_busy_);
+          more_to_scavenge = true;
+        }
+        barrier_->Sync();
+      } while (more_to_scavenge);
+
+      // Phase 2: Weak processing, split between the tasks. Nothing is copied
+      // anymore, so the forwarding of every object is final.
+      {
+        TIMELINE_FUNCTION_GC_DURATION(thread, "WeakHandleProcessing");
+        ScavengerWeakVisitor weak_visitor(thread, scavenger_);
+        scavenger_->IterateWeakRoots(isolate_, &weak_visitor, task_index_,
+                                     num_tasks_);
+        weak_visitor.Finalize();
+      }
+      scavenger_->ProcessWeakTables(task_index_, num_tasks_);
+
+      // Phase 3: Return unused buffers and hand over results.
+      AtomicOperations::IncrementBy(bytes_promoted_, visitor.bytes_promoted());
+      AtomicOperations::IncrementBy(bytes_aged_, visitor.bytes_aged());
+      visitor.Finalize();
+    }
+    Thread::ExitIsolateAsHelper(true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Exit();
+  }
+
+ private:
+  void IterateRoots(ParallelScavengerVisitor* visitor) {
+    scavenger_->IterateRootSlice(isolate_, visitor, task_index_, num_tasks_);
+    // A single task walks the card tables of large arrays.
+    if (task_index_ == num_tasks_ - 1) {
+      scavenger_->heap_->old_space()->VisitRememberedCards(visitor);
+    }
+    // All tasks compete for the store buffer blocks.
+    intptr_t count = 0;
+    StoreBufferBlock* pending = pending_blocks_->Pop();
+    while (pending != NULL) {
+      // Generated code appends to store buffers; tell MemorySanitizer.
+      MSAN_UNPOISON(pending, sizeof(*pending));
+      count += pending->Count();
+      while (!pending->IsEmpty()) {
+        visitor->VisitRememberedObject(pending->Pop());
+      }
+      pending->Reset();
+      // Return the emptied block for recycling (no need to check threshold).
+      isolate_->store_buffer()->PushBlock(pending,
+                                          StoreBuffer::kIgnoreThreshold);
+      pending = pending_blocks_->Pop();
+    }
+    AtomicOperations::IncrementBy(store_buffer_entries_, count);
+  }
+
+  Scavenger* scavenger_;
+  Isolate* isolate_;
+  SemiSpace* from_;
+  ScavengerStack* scavenger_stack_;
+  PendingStoreBufferBlocks* pending_blocks_;
+  ThreadBarrier* barrier_;
+  const intptr_t task_index_;
+  const intptr_t num_tasks_;
+  uintptr_t* num_busy_;
+  intptr_t* bytes_promoted_;
+  intptr_t* bytes_aged_;
+  intptr_t* store_buffer_entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ParallelScavengerTask);
+};
+
+intptr_t Scavenger::ParallelScavenge(Isolate* isolate,
+                                     SemiSpace* from,
+                                     intptr_t* bytes_aged) {
+  const intptr_t num_tasks = FLAG_scavenger_tasks;
+  ASSERT(num_tasks > 0);
+  int64_t start = OS::GetCurrentMonotonicMicros();
+  ScavengerStack scavenger_stack;
+  PendingStoreBufferBlocks pending_blocks(isolate->store_buffer()->Blocks());
+  intptr_t bytes_promoted = 0;
+  intptr_t store_buffer_entries = 0;
+  {
+    ThreadBarrier barrier(num_tasks + 1, heap_->barrier(),
+                          heap_->barrier_done());
+    // Used to coordinate draining among tasks; all start out as 'busy'.
+    uintptr_t num_busy = num_tasks;
+    for (intptr_t i = 0; i < num_tasks; ++i) {
+      ParallelScavengerTask* task = new ParallelScavengerTask(
+          this, isolate, from, &scavenger_stack, &pending_blocks, &barrier, i,
+          num_tasks, &num_busy, &bytes_promoted, bytes_aged,
+          &store_buffer_entries);
+      ThreadPool* pool = Dart::thread_pool();
+      pool->Run(task);
+    }
+    bool more_to_scavenge = false;
+    do {
+      // Wait for all tasks to stop.
+      barrier.Sync();
+#if defined(DEBUG)
+      ASSERT(AtomicOperations::LoadRelaxed(&num_busy) == 0);
+      // Caveat: must not allow any task to continue past the barrier
+      // before we checked num_busy, otherwise one of them might rush
+      // ahead and increment it.
+      barrier.Sync();
+#endif
+
+      // Wait for all tasks to go through their weak properties and verify
+      // that there is no more work.
+      barrier.Sync();
+      more_to_scavenge = AtomicOperations::LoadRelaxed(&num_busy) > 0;
+      barrier.Sync();
+    } while (more_to_scavenge);
+    barrier.Exit();
+    // The barrier's destructor waits until every task has exited, so all
+    // buffers have been abandoned (and top_ is final) after this scope.
+  }
+  ASSERT(scavenger_stack.IsEmpty());
+  resolved_top_ = top_;
+
+  int64_t end = OS::GetCurrentMonotonicMicros();
+  heap_->RecordData(kStoreBufferEntries, store_buffer_entries);
+  heap_->RecordData(kDataUnused2, 0);
+  heap_->RecordData(kToKBAfterStoreBuffer, RoundWordsToKB(UsedInWords()));
+  // Roots, store buffers and the to space are processed together.
+  heap_->RecordTime(kVisitIsolateRoots, 0);
+  heap_->RecordTime(kIterateStoreBuffers, 0);
+  heap_->RecordTime(kDummyScavengeTime, 0);
+  heap_->RecordTime(kProcessToSpace, end - start);
+  return bytes_promoted;
+}
+
 void Scavenger::UpdateMaxHeapCapacity() {
 #if !defined(PRODUCT)
   if (heap_ == NULL) {
@@ -735,9 +1622,11 @@ uword Scavenger::ProcessWeakProperty(RawWeakProperty* raw_weak,
   return raw_weak->VisitPointersNonvirtual(visitor);
 }
 
-void Scavenger::ProcessWeakReferences() {
+void Scavenger::ProcessWeakTables(intptr_t slice_index, intptr_t num_slices) {
+  ASSERT(0 <= slice_index && slice_index < num_slices);
   // Rehash the weak tables now that we know which objects survive this cycle.
-  for (int sel = 0; sel < Heap::kNumWeakSelectors; sel++) {
+  for (int sel = slice_index; sel < Heap::kNumWeakSelectors;
+       sel += num_slices) {
     WeakTable* table =
         heap_->GetWeakTable(Heap::kNew, static_cast<Heap::WeakSelector>(sel));
     heap_->SetWeakTable(Heap::kNew, static_cast<Heap::WeakSelector>(sel),
@@ -762,7 +1651,9 @@ void Scavenger::ProcessWeakReferences() {
     // table above.
     delete table;
   }
+}
 
+void Scavenger::ProcessWeakReferences() {
   // The queued weak properties at this point do not refer to reachable keys,
   // so we clear their key and value fields.
   {
@@ -870,7 +1761,8 @@ void Scavenger::Scavenge() {
   heap_->RecordTime(kSafePoint, safe_point - start);
 
   // TODO(koda): Make verification more compatible with concurrent sweep.
-  if (FLAG_verify_before_gc && !FLAG_concurrent_sweep) {
+  if (FLAG_verify_before_gc && !FLAG_concurrent_sweep &&
+      !page_space->IsMarking()) {
     OS::PrintErr("Verifying before Scavenge...");
     heap_->Verify(kForbidMarked);
     OS::PrintErr(" done.\n");
@@ -880,38 +1772,71 @@ void Scavenger::Scavenge() {
   SpaceUsage usage_before = GetCurrentUsage();
   intptr_t promo_candidate_words =
       (survivor_end_ - FirstObjectStart()) / kWordSize;
+  // The objects allocated since the previous scavenge, whose survival is
+  // sampled for the pretenuring feedback.
+  PretenuringFeedback* pretenuring_feedback = heap_->pretenuring_feedback();
+  const bool sample_survival = pretenuring_feedback->ShouldSample();
+  const uword young_start = survivor_end_;
+  uword young_end = top_;
+  if (isolate->IsMutatorThreadScheduled()) {
+    young_end = isolate->mutator_thread()->top();
+  }
   SemiSpace* from = Prologue(isolate);
   // The API prologue/epilogue may create/destroy zones, so we must not
   // depend on zone allocations surviving beyond the epilogue callback.
   {
     StackZone zone(thread);
-    // Setup the visitor and run the scavenge.
-    ScavengerVisitor visitor(isolate, this, from);
-    page_space->AcquireDataLock();
-    IterateRoots(isolate, &visitor);
-    int64_t iterate_roots = OS::GetCurrentMonotonicMicros();
-    ProcessToSpace(&visitor);
-    int64_t process_to_space = OS::GetCurrentMonotonicMicros();
-    {
-      TIMELINE_FUNCTION_GC_DURATION(thread, "WeakHandleProcessing");
-      ScavengerWeakVisitor weak_visitor(thread, this);
-      IterateWeakRoots(isolate, &weak_visitor);
+    intptr_t bytes_promoted = 0;
+    intptr_t bytes_aged = 0;
+    int64_t process_to_space = 0;
+    if ((FLAG_scavenger_tasks > 0) && !page_space->IsMarking()) {
+      // The tasks take the data lock themselves whenever they promote.
+      bytes_promoted = ParallelScavenge(isolate, from, &bytes_aged);
+      process_to_space = OS::GetCurrentMonotonicMicros();
+      page_space->AcquireDataLock();
+    } else {
+      // Setup the visitor and run the scavenge.
+      ScavengerVisitor visitor(isolate, this, from);
+      page_space->AcquireDataLock();
+      IterateRoots(isolate, &visitor);
+      int64_t iterate_roots = OS::GetCurrentMonotonicMicros();
+      ProcessToSpace(&visitor);
+      process_to_space = OS::GetCurrentMonotonicMicros();
+      heap_->RecordTime(kProcessToSpace, process_to_space - iterate_roots);
+      bytes_promoted = visitor.bytes_promoted();
+      bytes_aged = visitor.bytes_aged();
+      {
+        TIMELINE_FUNCTION_GC_DURATION(thread, "WeakHandleProcessing");
+        ScavengerWeakVisitor weak_visitor(thread, this);
+        IterateWeakRoots(isolate, &weak_visitor, 0, 1);
+        weak_visitor.Finalize();
+      }
+      ProcessWeakTables(0, 1);
     }
     ProcessWeakReferences();
     page_space->ReleaseDataLock();
 
+    if (sample_survival) {
+      pretenuring_feedback->EnsureCapacity(isolate->class_table()->NumCids());
+      SampleSurvival(young_start, young_end);
+      pretenuring_feedback->UpdateDecisions(thread);
+    }
+
     // Scavenge finished. Run accounting.
     int64_t end = OS::GetCurrentMonotonicMicros();
-    heap_->RecordTime(kProcessToSpace, process_to_space - iterate_roots);
     heap_->RecordTime(kIterateWeaks, end - process_to_space);
-    stats_history_.Add(ScavengeStats(
-        start, end, usage_before, GetCurrentUsage(), promo_candidate_words,
-        visitor.bytes_promoted() >> kWordSizeLog2));
+    heap_->RecordData(kPromotedKB, RoundWordsToKB(bytes_promoted / kWordSize));
+    stats_history_.Add(ScavengeStats(start, end, usage_before,
+                                     GetCurrentUsage(), promo_candidate_words,
+                                     bytes_promoted >> kWordSizeLog2,
+                                     bytes_aged >> kWordSizeLog2));
   }
   Epilogue(isolate, from);
+  heap_->RunPendingFinalizers(thread, true);
 
   // TODO(koda): Make verification more compatible with concurrent sweep.
-  if (FLAG_verify_after_gc && !FLAG_concurrent_sweep) {
+  if (FLAG_verify_after_gc && !FLAG_concurrent_sweep &&
+      !page_space->IsMarking()) {
     OS::PrintErr("Verifying after Scavenge...");
     heap_->Verify(kForbidMarked);
     OS::PrintErr(" done.\n");
@@ -959,14 +1884,15 @@ void Scavenger::PrintToJSONObject(JSONObject* object) const {
 
 void Scavenger::AllocateExternal(intptr_t cid, intptr_t size) {
   ASSERT(size >= 0);
-  external_size_ += size;
+  AtomicOperations::IncrementBy(&external_size_, size);
   NOT_IN_PRODUCT(
       heap_->isolate()->class_table()->UpdateAllocatedExternalNew(cid, size));
 }
 
 void Scavenger::FreeExternal(intptr_t size) {
   ASSERT(size >= 0);
-  external_size_ -= size;
+  // Also called by the tasks visiting the weak handles in parallel.
+  AtomicOperations::DecrementBy(&external_size_, size);
   ASSERT(external_size_ >= 0);
 }
 
@@ -981,6 +1907,7 @@ void Scavenger::Evacuate() {
 
   // Forces the next scavenge to promote all the objects in the new space.
   survivor_end_ = top_;
+  tenuring_threshold_ = 0;
 
   if (heap_->isolate()->IsMutatorThreadScheduled()) {
     Thread* mutator_thread = heap_->isolate()->mutator_thread();
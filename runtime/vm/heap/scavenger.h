@@ -11,6 +11,7 @@
 #include "vm/flags.h"
 #include "vm/globals.h"
 #include "vm/heap/spaces.h"
+#include "vm/os_thread.h"
 #include "vm/raw_object.h"
 #include "vm/ring_buffer.h"
 #include "vm/virtual_memory.h"
@@ -23,12 +24,15 @@ class Heap;
 class Isolate;
 class JSONObject;
 class ObjectSet;
+class ParallelScavengerVisitor;
 class ScavengerVisitor;
 
 // Wrapper around VirtualMemory that adds caching and handles the empty case.
 class SemiSpace {
  public:
   static void InitOnce();
+  // Deletes the cached space, so that the next space is mapped afresh.
+  static void Cleanup();
 
   // Get a space of the given size. Returns NULL on out of memory. If size is 0,
   // returns an empty space: pointer(), start() and end() all return NULL.
@@ -72,13 +76,15 @@ class ScavengeStats {
                 SpaceUsage before,
                 SpaceUsage after,
                 intptr_t promo_candidates_in_words,
-                intptr_t promoted_in_words)
+                intptr_t promoted_in_words,
+                intptr_t aged_in_words)
       : start_micros_(start_micros),
         end_micros_(end_micros),
         before_(before),
         after_(after),
         promo_candidates_in_words_(promo_candidates_in_words),
-        promoted_in_words_(promoted_in_words) {}
+        promoted_in_words_(promoted_in_words),
+        aged_in_words_(aged_in_words) {}
 
   // Of all data before scavenge, what fraction was found to be garbage?
   // If this scavenge included growth, assume the extra capacity would become
@@ -88,19 +94,30 @@ class ScavengeStats {
     return 1.0 - (survived / static_cast<double>(after_.capacity_in_words));
   }
 
-  // Fraction of promotion candidates that survived and was thereby promoted.
+  // Fraction of promotion candidates that survived, either by being promoted
+  // or by being kept in new space until they reach the tenuring threshold.
   // Returns zero if there were no promotion candidates.
   double PromoCandidatesSuccessFraction() const {
     return promo_candidates_in_words_ > 0
-               ? promoted_in_words_ /
+               ? (promoted_in_words_ + aged_in_words_) /
                      static_cast<double>(promo_candidates_in_words_)
                : 0.0;
   }
 
+  // Fraction of the new space capacity occupied by survivors.
+  double SurvivorFraction() const {
+    return after_.used_in_words /
+           static_cast<double>(after_.capacity_in_words);
+  }
+
+  intptr_t PromotedInWords() const { return promoted_in_words_; }
+
   intptr_t UsedBeforeInWords() const { return before_.used_in_words; }
 
   int64_t DurationMicros() const { return end_micros_ - start_micros_; }
 
+  int64_t EndMicros() const { return end_micros_; }
+
  private:
   int64_t start_micros_;
   int64_t end_micros_;
@@ -108,6 +125,7 @@ class ScavengeStats {
   SpaceUsage after_;
   intptr_t promo_candidates_in_words_;
   intptr_t promoted_in_words_;
+  intptr_t aged_in_words_;
 };
 
 class Scavenger {
@@ -142,6 +160,10 @@ class Scavenger {
     return result;
   }
 
+  // Like AllocateGC, but may be called concurrently by parallel scavenger
+  // tasks. Returns 0 if the to space is exhausted.
+  uword TryAllocateGCParallel(intptr_t size);
+
   uword TryAllocateInTLAB(Thread* thread, intptr_t size) {
     ASSERT(Utils::IsAligned(size, kObjectAlignment));
     ASSERT(heap_ != Dart::vm_isolate()->heap());
@@ -178,10 +200,11 @@ class Scavenger {
   uword end() { return end_; }
 
   void set_top(uword value) { top_ = value; }
-  void set_end(uword value) {
-    ASSERT(to_->end() == value);
-    end_ = value;
-  }
+
+  // Sets the end of 'thread's allocation area to the end of new space, or to
+  // an earlier point where the next allocation is to be sampled, see
+  // HeapSampler.
+  void SetThreadEnd(Thread* thread);
 
   int64_t UsedInWords() const {
     return (top_ - FirstObjectStart()) >> kWordSizeLog2;
@@ -234,7 +257,7 @@ class Scavenger {
     kIterateWeaks = 5,
     // Data
     kStoreBufferEntries = 0,
-    kDataUnused1 = 1,
+    kPromotedKB = 1,
     kDataUnused2 = 2,
     kToKBAfterStoreBuffer = 3
   };
@@ -242,12 +265,26 @@ class Scavenger {
   uword FirstObjectStart() const { return to_->start() | object_alignment_; }
   SemiSpace* Prologue(Isolate* isolate);
   void IterateStoreBuffers(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateObjectIdTable(Isolate* isolate, ScavengerVisitor* visitor);
+  void IterateObjectIdTable(Isolate* isolate, ObjectPointerVisitor* visitor);
   void IterateRoots(Isolate* isolate, ScavengerVisitor* visitor);
+  void IterateRootSlice(Isolate* isolate,
+                        ObjectPointerVisitor* visitor,
+                        intptr_t slice_index,
+                        intptr_t num_slices);
   void IterateWeakProperties(Isolate* isolate, ScavengerVisitor* visitor);
   void IterateWeakReferences(Isolate* isolate, ScavengerVisitor* visitor);
-  void IterateWeakRoots(Isolate* isolate, HandleVisitor* visitor);
+  void IterateWeakRoots(Isolate* isolate,
+                        HandleVisitor* visitor,
+                        intptr_t slice_index,
+                        intptr_t num_slices);
   void ProcessToSpace(ScavengerVisitor* visitor);
+  // Performs the root iteration and the transitive closure with
+  // FLAG_scavenger_tasks helper tasks. Returns the number of bytes promoted,
+  // and the number of bytes kept in new space by the tenuring threshold in
+  // bytes_aged.
+  intptr_t ParallelScavenge(Isolate* isolate,
+                            SemiSpace* from,
+                            intptr_t* bytes_aged);
   void EnqueueWeakProperty(RawWeakProperty* raw_weak);
   uword ProcessWeakProperty(RawWeakProperty* raw_weak,
                             ScavengerVisitor* visitor);
@@ -280,9 +317,17 @@ class Scavenger {
   void UpdateMaxHeapCapacity();
   void UpdateMaxHeapUsage();
 
+  // Rehashes the weak tables of every num_slices-th selector, starting at
+  // slice_index. The tables of different selectors are independent.
+  void ProcessWeakTables(intptr_t slice_index, intptr_t num_slices);
   void ProcessWeakReferences();
 
   intptr_t NewSizeInWords(intptr_t old_size_in_words) const;
+  intptr_t PauseGoalSizeInWords(intptr_t old_size_in_words) const;
+  void UpdateTenuringThreshold();
+  // Feeds the survival of the objects in [start, end) of the from space to
+  // the pretenuring feedback.
+  void SampleSurvival(uword start, uword end);
 
   uword top_;
   uword end_;
@@ -298,6 +343,14 @@ class Scavenger {
   // Objects below this address have survived a scavenge.
   uword survivor_end_;
 
+  // Survivors of a previous scavenge whose age (see RawObject::AgeTag) is
+  // below this threshold are copied within new space instead of promoted.
+  // Zero promotes all survivors.
+  intptr_t tenuring_threshold_;
+
+  // The threshold adapted to the survival rate, see --tenuring_threshold.
+  intptr_t target_tenuring_threshold_;
+
   intptr_t max_semi_capacity_in_words_;
 
   // All object are aligned to this value.
@@ -322,6 +375,9 @@ class Scavenger {
 
   bool failed_to_promote_;
 
+  friend class Heap;  // For the ids of the GC stats records.
+  friend class ParallelScavengerTask;
+  friend class ParallelScavengerVisitor;
   friend class ScavengerVisitor;
   friend class ScavengerWeakVisitor;
 
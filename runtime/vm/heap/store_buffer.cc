@@ -130,6 +130,14 @@ typename BlockStack<BlockSize>::Block* BlockStack<BlockSize>::PopEmptyBlock() {
   return new Block();
 }
 
+template <int BlockSize>
+void BlockStack<BlockSize>::PushEmptyBlock(Block* block) {
+  ASSERT(block->IsEmpty());
+  MutexLocker ml(global_mutex_);
+  global_empty_->Push(block);
+  TrimGlobalEmpty();
+}
+
 template <int BlockSize>
 typename BlockStack<BlockSize>::Block*
 BlockStack<BlockSize>::PopNonEmptyBlock() {
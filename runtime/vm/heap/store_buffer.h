@@ -97,6 +97,9 @@ class BlockStack {
   Block* PopEmptyBlock();
   Block* PopNonEmptyBlock();
 
+  // Returns an empty block to the global cache of empty blocks.
+  static void PushEmptyBlock(Block* block);
+
   // Pops and returns all non-empty blocks as a linked list (owned by caller).
   Block* Blocks();
 
@@ -173,6 +176,16 @@ class MarkingStack : public BlockStack<kMarkingStackBlockSize> {
   }
 };
 
+// Objects copied or promoted by a parallel scavenge whose pointers have not yet
+// been scanned. Shares the cache of empty blocks with the MarkingStack.
+class ScavengerStack : public BlockStack<kMarkingStackBlockSize> {
+ public:
+  // Adds and transfers ownership of the block to the buffer.
+  void PushBlock(Block* block) {
+    BlockStack<Block::kSize>::PushBlockImpl(block);
+  }
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_HEAP_STORE_BUFFER_H_
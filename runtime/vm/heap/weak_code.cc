@@ -18,6 +18,10 @@ bool WeakCodeReferences::HasCodes() const {
 }
 
 void WeakCodeReferences::Register(const Code& value) {
+  Register(value, Object::null_object());
+}
+
+void WeakCodeReferences::Register(const Code& value, const Object& data) {
   if (!array_.IsNull()) {
     // Try to find and reuse cleared WeakProperty to avoid allocating new one.
     WeakProperty& weak_property = WeakProperty::Handle();
@@ -26,6 +30,7 @@ void WeakCodeReferences::Register(const Code& value) {
       if (weak_property.key() == Code::null()) {
         // Empty property found. Reuse it.
         weak_property.set_key(value);
+        weak_property.set_value(data);
         return;
       }
     }
@@ -34,6 +39,7 @@ void WeakCodeReferences::Register(const Code& value) {
   const WeakProperty& weak_property =
       WeakProperty::Handle(WeakProperty::New(Heap::kOld));
   weak_property.set_key(value);
+  weak_property.set_value(data);
 
   intptr_t length = array_.IsNull() ? 0 : array_.Length();
   const Array& new_array =
@@ -59,7 +65,8 @@ bool WeakCodeReferences::IsOptimizedCode(const Array& dependent_code,
 
 void WeakCodeReferences::DisableCode() {
   Thread* thread = Thread::Current();
-  const Array& code_objects = Array::Handle(thread->zone(), array_.raw());
+  Zone* zone = thread->zone();
+  Array& code_objects = Array::Handle(zone, array_.raw());
 #if defined(DART_PRECOMPILED_RUNTIME)
   ASSERT(code_objects.IsNull());
   return;
@@ -68,9 +75,47 @@ void WeakCodeReferences::DisableCode() {
     return;
   }
 
-  UpdateArrayTo(Object::null_array());
-  // Disable all code on stack.
-  Code& code = Code::Handle();
+  // Split the registered code into the affected code, which is disabled
+  // below, and the rest, which stays registered.
+  const intptr_t length = code_objects.Length();
+  GrowableArray<bool> affected(zone, length);
+  intptr_t affected_count = 0;
+  WeakProperty& weak_property = WeakProperty::Handle(zone);
+  Object& data = Object::Handle(zone);
+  for (intptr_t i = 0; i < length; i++) {
+    weak_property ^= code_objects.At(i);
+    data = weak_property.value();
+    affected.Add(IsAffected(data));
+    if (affected[i]) {
+      affected_count++;
+    }
+  }
+  if (affected_count == 0) {
+    return;
+  }
+  if (affected_count == length) {
+    UpdateArrayTo(Object::null_array());
+  } else {
+    const Array& kept =
+        Array::Handle(zone, Array::New(length - affected_count, Heap::kOld));
+    const Array& disabled =
+        Array::Handle(zone, Array::New(affected_count, Heap::kOld));
+    intptr_t kept_index = 0;
+    intptr_t disabled_index = 0;
+    for (intptr_t i = 0; i < length; i++) {
+      weak_property ^= code_objects.At(i);
+      if (affected[i]) {
+        disabled.SetAt(disabled_index++, weak_property);
+      } else {
+        kept.SetAt(kept_index++, weak_property);
+      }
+    }
+    UpdateArrayTo(kept);
+    code_objects = disabled.raw();
+  }
+
+  // Disable all affected code on stack.
+  Code& code = Code::Handle(zone);
   {
     DartFrameIterator iterator(thread,
                                StackFrameIterator::kNoCrossThreadIteration);
@@ -86,7 +131,6 @@ void WeakCodeReferences::DisableCode() {
   }
 
   // Switch functions that use dependent code to unoptimized code.
-  WeakProperty& weak_property = WeakProperty::Handle();
   Object& owner = Object::Handle();
   Function& function = Function::Handle();
   for (intptr_t i = 0; i < code_objects.Length(); i++) {
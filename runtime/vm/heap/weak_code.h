@@ -12,6 +12,7 @@ namespace dart {
 
 class Array;
 class Code;
+class Object;
 
 // Helper class to handle an array of code weak properties. Implements
 // registration and disabling of stored code objects.
@@ -22,10 +23,18 @@ class WeakCodeReferences : public ValueObject {
 
   void Register(const Code& value);
 
+  // Registers value with data describing the assumption it depends on. The
+  // data is passed to IsAffected when the code is about to be disabled.
+  void Register(const Code& value, const Object& data);
+
   virtual void UpdateArrayTo(const Array& array) = 0;
   virtual void ReportDeoptimization(const Code& code) = 0;
   virtual void ReportSwitchingCode(const Code& code) = 0;
 
+  // Returns whether code registered with data must be disabled by
+  // DisableCode. Code that is not affected stays registered.
+  virtual bool IsAffected(const Object& data) const { return true; }
+
   static bool IsOptimizedCode(const Array& dependent_code, const Code& code);
 
   void DisableCode();
@@ -13,6 +13,7 @@
 #include "vm/json_writer.h"
 #include "vm/object.h"
 #include "vm/stub_code.h"
+#include "vm/symbols.h"
 #include "vm/timeline.h"
 #include "vm/type_testing_stubs.h"
 
@@ -28,6 +29,14 @@ DEFINE_FLAG(charp,
             print_instructions_sizes_to,
             NULL,
             "Print sizes of all instruction objects to the given file");
+
+DEFINE_FLAG(charp,
+            code_order_profile,
+            NULL,
+            "Place the instructions of the functions listed in the given file "
+            "at the start of the text image. Each line names a function as "
+            "'<library uri>,<class name>,<function name>[,<weight>]'. "
+            "Functions are ordered by decreasing weight, then by line order.");
 #endif
 
 intptr_t ObjectOffsetTrait::Hashcode(Key key) {
@@ -108,6 +117,17 @@ int32_t ImageWriter::GetTextOffsetFor(RawInstructions* instructions,
     return -pair->offset;
   }
 
+  if (hot_code_.length() > 0) {
+    // The serializer holds a NoSafepointScope while it assigns offsets, so
+    // the raw pointers recorded here stay valid until the text is written.
+    ReserveHotTextOffsets();
+  }
+  InstructionsOffsetTrait::Pair* reserved =
+      reserved_text_offsets_.Lookup(instructions);
+  if (reserved != NULL) {
+    return reserved->value;
+  }
+
   intptr_t heap_size = instructions->Size();
   intptr_t offset = next_text_offset_;
   next_text_offset_ += heap_size;
@@ -115,6 +135,148 @@ int32_t ImageWriter::GetTextOffsetFor(RawInstructions* instructions,
   return offset;
 }
 
+void ImageWriter::ReserveHotTextOffsets() {
+  // Instructions are written in the order of instructions_, so claiming the
+  // first offsets for the hot code places it contiguously at the front of
+  // the image.
+  for (intptr_t i = 0; i < hot_code_.length(); i++) {
+    RawCode* code = hot_code_[i]->raw();
+    RawInstructions* instructions = Code::InstructionsOf(code);
+    if (shared_instructions_.HasKey(instructions) ||
+        reserved_text_offsets_.HasKey(instructions)) {
+      continue;
+    }
+    intptr_t offset = next_text_offset_;
+    next_text_offset_ += instructions->Size();
+    instructions_.Add(InstructionsData(instructions, code, offset));
+    reserved_text_offsets_.Insert(
+        InstructionsOffsetTrait::Pair(instructions, offset));
+  }
+  hot_code_.Clear();
+}
+
+#if defined(DART_PRECOMPILER)
+struct HotCodeEntry {
+  const Code* code;
+  intptr_t weight;
+  intptr_t line;
+};
+
+static int CompareHotCodeEntries(const HotCodeEntry* a,
+                                 const HotCodeEntry* b) {
+  if (a->weight != b->weight) {
+    return a->weight > b->weight ? -1 : 1;
+  }
+  return a->line < b->line ? -1 : (a->line > b->line ? 1 : 0);
+}
+
+static char* NextField(char* str, char goal, char* limit) {
+  while ((str < limit) && (*str != goal) && (*str != '\n')) {
+    str++;
+  }
+  return str;
+}
+
+void ImageWriter::PrepareForSerialization() {
+  if (FLAG_code_order_profile == NULL) {
+    return;
+  }
+
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    return;
+  }
+  auto file = file_open(FLAG_code_order_profile, /*write=*/false);
+  if (file == nullptr) {
+    OS::PrintErr("Failed to open file %s\n", FLAG_code_order_profile);
+    return;
+  }
+  uint8_t* buffer = nullptr;
+  intptr_t size = -1;
+  file_read(&buffer, &size, file);
+  file_close(file);
+  if ((buffer == nullptr) || (size < 0)) {
+    OS::PrintErr("Failed to read file %s\n", FLAG_code_order_profile);
+    free(buffer);
+    return;
+  }
+  SetCodeOrderProfile(reinterpret_cast<char*>(buffer), size);
+  free(buffer);
+}
+
+void ImageWriter::SetCodeOrderProfile(char* contents, intptr_t size) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  auto& uri = String::Handle(zone);
+  auto& class_name = String::Handle(zone);
+  auto& function_name = String::Handle(zone);
+  auto& lib = Library::Handle(zone);
+  auto& cls = Class::Handle(zone);
+  auto& function = Function::Handle(zone);
+  auto& code = Code::Handle(zone);
+  GrowableArray<HotCodeEntry> entries;
+
+  char* cursor = contents;
+  char* limit = cursor + size;
+  intptr_t line = 0;
+  while (cursor < limit) {
+    char* fields[4] = {cursor, NULL, NULL, NULL};
+    intptr_t num_fields = 1;
+    char* end = NextField(cursor, ',', limit);
+    while ((end < limit) && (*end == ',') && (num_fields < 4)) {
+      *end = 0;
+      fields[num_fields++] = end + 1;
+      end = NextField(end + 1, ',', limit);
+    }
+    end = NextField(end, '\n', limit);
+    if (end >= limit) {
+      break;  // Missing newline after the last line.
+    }
+    *end = 0;
+    cursor = end + 1;
+    line++;
+    if (num_fields < 3) {
+      continue;
+    }
+
+    uri = Symbols::New(thread, fields[0]);
+    class_name = Symbols::New(thread, fields[1]);
+    function_name = Symbols::New(thread, fields[2]);
+    lib = Library::LookupLibrary(thread, uri);
+    if (lib.IsNull()) {
+      continue;
+    }
+    if (class_name.Equals(Symbols::TopLevel())) {
+      function = lib.LookupFunctionAllowPrivate(function_name);
+    } else {
+      cls = lib.SlowLookupClassAllowMultiPartPrivate(class_name);
+      if (cls.IsNull()) {
+        continue;
+      }
+      function = cls.LookupFunctionAllowPrivate(function_name);
+    }
+    if (function.IsNull() || !function.HasCode()) {
+      continue;
+    }
+    code = function.CurrentCode();
+    intptr_t weight = 0;
+    if (num_fields == 4) {
+      weight = strtol(fields[3], NULL, 10);
+    }
+    HotCodeEntry entry = {&Code::ZoneHandle(zone, code.raw()), weight, line};
+    entries.Add(entry);
+  }
+
+  entries.Sort(CompareHotCodeEntries);
+  for (intptr_t i = 0; i < entries.length(); i++) {
+    hot_code_.Add(entries[i].code);
+  }
+}
+#endif  // defined(DART_PRECOMPILER)
+
 bool ImageWriter::GetSharedDataOffsetFor(RawObject* raw_object,
                                          uint32_t* offset) {
   ObjectOffsetPair* pair = shared_objects_.Lookup(raw_object);
@@ -266,9 +428,24 @@ void ImageWriter::WriteROData(WriteStream* stream) {
 #endif
     stream->WriteWord(marked_tags);
     start += sizeof(uword);
+
+    // Pointers cannot be relocated when the image is loaded, so the handled
+    // types of exception handlers are replaced by Smi 0. Only the handler
+    // table is used at runtime.
+    uword* dropped_pointer = NULL;
+    if (obj.IsExceptionHandlers()) {
+      RawExceptionHandlers* handlers =
+          ExceptionHandlers::RawCast(obj.raw());
+      dropped_pointer =
+          reinterpret_cast<uword*>(&handlers->ptr()->handled_types_data_);
+    }
     for (uword* cursor = reinterpret_cast<uword*>(start);
          cursor < reinterpret_cast<uword*>(end); cursor++) {
-      stream->WriteWord(*cursor);
+      if (cursor == dropped_pointer) {
+        stream->WriteWord(reinterpret_cast<uword>(Smi::New(0)));
+      } else {
+        stream->WriteWord(*cursor);
+      }
     }
   }
 }
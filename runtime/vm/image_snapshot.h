@@ -94,6 +94,10 @@ class ObjectOffsetTrait {
 
 typedef DirectChainedHashMap<ObjectOffsetTrait> ObjectOffsetMap;
 
+typedef RawPointerKeyValueTrait<RawInstructions, int32_t>
+    InstructionsOffsetTrait;
+typedef DirectChainedHashMap<InstructionsOffsetTrait> InstructionsOffsetMap;
+
 class ImageWriter : public ValueObject {
  public:
   ImageWriter(const void* shared_objects, const void* shared_instructions);
@@ -105,8 +109,21 @@ class ImageWriter : public ValueObject {
     next_text_offset_ = Image::kHeaderSize;
     objects_.Clear();
     instructions_.Clear();
+    reserved_text_offsets_.Clear();
+    hot_code_.Clear();
   }
 
+#if defined(DART_PRECOMPILER)
+  // Reads the code order profile named by --code-order-profile, if any, and
+  // remembers the code of the named functions so that their instructions are
+  // placed contiguously at the start of the text image, hottest first.
+  void PrepareForSerialization();
+
+  // Like PrepareForSerialization, with the contents of a profile. The
+  // contents are modified while they are parsed.
+  void SetCodeOrderProfile(char* contents, intptr_t size);
+#endif
+
   int32_t GetTextOffsetFor(RawInstructions* instructions, RawCode* code);
   bool GetSharedDataOffsetFor(RawObject* raw_object, uint32_t* offset);
   uint32_t GetDataOffsetFor(RawObject* raw_object);
@@ -124,6 +141,8 @@ class ImageWriter : public ValueObject {
   void DumpInstructionStats();
   void DumpInstructionsSizes();
 
+  void ReserveHotTextOffsets();
+
   struct InstructionsData {
     explicit InstructionsData(RawInstructions* insns,
                               RawCode* code,
@@ -156,6 +175,8 @@ class ImageWriter : public ValueObject {
   GrowableArray<InstructionsData> instructions_;
   ObjectOffsetMap shared_objects_;
   ObjectOffsetMap shared_instructions_;
+  InstructionsOffsetMap reserved_text_offsets_;
+  GrowableArray<const Code*> hot_code_;
 
  private:
   DISALLOW_COPY_AND_ASSIGN(ImageWriter);
@@ -0,0 +1,87 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/image_snapshot.h"
+
+#include "vm/dart_api_impl.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER)
+
+static uint8_t* malloc_allocator(uint8_t* ptr,
+                                 intptr_t old_size,
+                                 intptr_t new_size) {
+  return reinterpret_cast<uint8_t*>(realloc(ptr, new_size));
+}
+
+static RawCode* LookupCode(const Library& library, const char* name) {
+  const Function& function =
+      Function::Handle(library.LookupFunctionAllowPrivate(
+          String::Handle(Symbols::New(Thread::Current(), name))));
+  EXPECT(!function.IsNull());
+  EXPECT(function.HasCode());
+  return function.CurrentCode();
+}
+
+TEST_CASE(ImageWriter_CodeOrderProfile) {
+  const char* kScript =
+      "cold() => 1;\n"
+      "warm() => 2;\n"
+      "hot() => 3;\n"
+      "main() {\n"
+      "  cold();\n"
+      "  warm();\n"
+      "  hot();\n"
+      "}\n";
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+  EXPECT_VALID(Dart_Invoke(lib, NewString("main"), 0, NULL));
+
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  HANDLESCOPE(thread);
+  const Library& library = Library::CheckedHandle(Api::UnwrapHandle(lib));
+  const Code& cold = Code::Handle(LookupCode(library, "cold"));
+  const Code& warm = Code::Handle(LookupCode(library, "warm"));
+  const Code& hot = Code::Handle(LookupCode(library, "hot"));
+
+  // Hot outweighs warm, which has no weight. Functions that do not resolve
+  // are ignored.
+  const char* url = String::Handle(library.url()).ToCString();
+  char* profile = OS::SCreate(thread->zone(),
+                              "%s,::,warm\n"
+                              "%s,::,missing,100\n"
+                              "no-such-lib,::,main,100\n"
+                              "%s,::,hot,5\n",
+                              url, url, url);
+
+  uint8_t* buffer = NULL;
+  {
+    BlobImageWriter writer(&buffer, &malloc_allocator, 1024, NULL, NULL);
+    writer.SetCodeOrderProfile(profile, strlen(profile));
+    NoSafepointScope no_safepoint;
+    // The profiled code is placed first, however late it is asked for.
+    const int32_t cold_offset =
+        writer.GetTextOffsetFor(cold.instructions(), cold.raw());
+    const int32_t hot_offset =
+        writer.GetTextOffsetFor(hot.instructions(), hot.raw());
+    const int32_t warm_offset =
+        writer.GetTextOffsetFor(warm.instructions(), warm.raw());
+    EXPECT_EQ(Image::kHeaderSize, hot_offset);
+    EXPECT_LT(hot_offset, warm_offset);
+    EXPECT_LT(warm_offset, cold_offset);
+    // Offsets are stable.
+    EXPECT_EQ(hot_offset,
+              writer.GetTextOffsetFor(hot.instructions(), hot.raw()));
+    EXPECT_EQ(cold_offset,
+              writer.GetTextOffsetFor(cold.instructions(), cold.raw()));
+  }
+  free(buffer);
+}
+
+#endif  // defined(DART_PRECOMPILER)
+
+}  // namespace dart
@@ -31,6 +31,17 @@ DEFINE_FLAG(uint64_t,
             trace_interpreter_after,
             ULLONG_MAX,
             "Trace interpreter execution after instruction count reached.");
+DEFINE_FLAG(bool,
+            interpreter_superinstructions,
+            true,
+            "Fuse common bytecode sequences into superinstructions when "
+            "bytecode is loaded.");
+DEFINE_FLAG(bool,
+            optimize_from_bytecode,
+            false,
+            "Optimize hot interpreted functions directly, without compiling "
+            "unoptimized code first, using the type feedback collected by the "
+            "interpreter.");
 
 #define LIKELY(cond) __builtin_expect((cond), 1)
 #define UNLIKELY(cond) __builtin_expect((cond), 0)
@@ -938,6 +949,36 @@ DART_NOINLINE bool Interpreter::InvokeCompiled(Thread* thread,
   return true;
 }
 
+// Called when an interpreted function becomes hot. Optimizes it directly from
+// kernel, skipping the unoptimized tier, and invokes the optimized code if it
+// is available right away. If the function was queued for background
+// compilation or cannot be optimized, the caller keeps interpreting it.
+DART_NOINLINE bool Interpreter::OptimizeInvocation(bool* invoked,
+                                                   Thread* thread,
+                                                   RawFunction* function,
+                                                   RawObject** call_base,
+                                                   RawObject** call_top,
+                                                   uint32_t** pc,
+                                                   RawObject*** FP,
+                                                   RawObject*** SP) {
+  ASSERT(!Function::HasCode(function) && Function::HasBytecode(function));
+  call_top[1] = 0;  // Result.
+  call_top[2] = function;
+  Exit(thread, *FP, call_top + 3, *pc);
+  NativeArguments native_args(thread, 1, call_top + 2, call_top + 1);
+  if (!InvokeRuntime(thread, this, DRT_OptimizeInvokedFunction, native_args)) {
+    return false;
+  }
+  // The function may have been moved by a GC during compilation.
+  function = static_cast<RawFunction*>(call_top[2]);
+  if (Function::HasCode(function)) {
+    *invoked = true;
+    return InvokeCompiled(thread, function, call_base, call_top, pc, FP, SP);
+  }
+  *invoked = false;
+  return true;
+}
+
 DART_NOINLINE bool Interpreter::ProcessInvocation(bool* invoked,
                                                   Thread* thread,
                                                   RawFunction* function,
@@ -1049,6 +1090,17 @@ DART_FORCE_INLINE bool Interpreter::Invoke(Thread* thread,
     }
     ASSERT(Function::HasBytecode(function));
   }
+  if (FLAG_optimize_from_bytecode &&
+      (++(function->ptr()->usage_counter_) >=
+       FLAG_optimization_counter_threshold)) {
+    bool invoked = false;
+    bool result = OptimizeInvocation(&invoked, thread, function, call_base,
+                                     call_top, pc, FP, SP);
+    if (invoked || !result) {
+      return result;
+    }
+    function = FrameFunction(callee_fp);
+  }
 #if defined(DEBUG)
   if (IsTracingExecution()) {
     THR_Print("%" Pu64 " ", icount_);
@@ -3162,6 +3214,18 @@ RawObject* Interpreter::Call(RawFunction* function,
     result = FP[rA];
     goto ReturnImpl;
 
+    {
+      BYTECODE(ReturnLocal, A_X);
+      result = FP[rD];
+      goto ReturnImpl;
+    }
+
+    {
+      BYTECODE(ReturnConstant, __D);
+      result = LOAD_CONSTANT(rD);
+      goto ReturnImpl;
+    }
+
     BYTECODE(ReturnTOS, 0);
     result = *SP;
     // Fall through to the ReturnImpl.
@@ -3303,6 +3367,19 @@ RawObject* Interpreter::Call(RawFunction* function,
     DISPATCH();
   }
 
+  {
+    BYTECODE(PushLocalField, A_X);
+    // Fused Push rX; LoadFieldTOS D. Take D from the following LoadFieldTOS
+    // and skip it.
+    ASSERT(KernelBytecode::DecodeOpcode(*pc) == KernelBytecode::kLoadFieldTOS);
+    const uword offset_in_words = static_cast<uword>(
+        Smi::Value(RAW_CAST(Smi, LOAD_CONSTANT(KernelBytecode::DecodeD(*pc)))));
+    RawInstance* instance = static_cast<RawInstance*>(FP[rD]);
+    *++SP = reinterpret_cast<RawObject**>(instance->ptr())[offset_in_words];
+    pc++;
+    DISPATCH();
+  }
+
   {
     BYTECODE(InitStaticTOS, 0);
     UNREACHABLE();  // Not used. TODO(regis): Remove this bytecode.
@@ -3519,20 +3596,12 @@ RawObject* Interpreter::Call(RawFunction* function,
         }
       }
 
-      for (RawObject** entries = cache->ptr()->cache_->ptr()->data();
-           entries[0] != null_value;
-           entries += SubtypeTestCache::kTestEntryLength) {
-        if ((entries[SubtypeTestCache::kInstanceClassIdOrFunction] ==
-             instance_cid_or_function) &&
-            (entries[SubtypeTestCache::kInstanceTypeArguments] ==
-             instance_type_arguments) &&
-            (entries[SubtypeTestCache::kInstantiatorTypeArguments] ==
-             instantiator_type_arguments) &&
-            (entries[SubtypeTestCache::kFunctionTypeArguments] ==
-             function_type_arguments)) {
-          SP[-4] = entries[SubtypeTestCache::kTestResult];
-          goto InstanceOfOk;
-        }
+      RawObject** entry = SubtypeTestCache::LookupRaw(
+          cache, cid, instance_cid_or_function, instance_type_arguments,
+          instantiator_type_arguments, function_type_arguments);
+      if (entry != NULL) {
+        SP[-4] = entry[SubtypeTestCache::kTestResult];
+        goto InstanceOfOk;
       }
     }
 
@@ -3618,23 +3687,12 @@ RawObject* Interpreter::Call(RawFunction* function,
           }
         }
 
-        for (RawObject** entries = cache->ptr()->cache_->ptr()->data();
-             entries[0] != null_value;
-             entries += SubtypeTestCache::kTestEntryLength) {
-          if ((entries[SubtypeTestCache::kInstanceClassIdOrFunction] ==
-               instance_cid_or_function) &&
-              (entries[SubtypeTestCache::kInstanceTypeArguments] ==
-               instance_type_arguments) &&
-              (entries[SubtypeTestCache::kInstantiatorTypeArguments] ==
-               instantiator_type_arguments) &&
-              (entries[SubtypeTestCache::kFunctionTypeArguments] ==
-               function_type_arguments)) {
-            if (true_value == entries[SubtypeTestCache::kTestResult]) {
-              goto AssertAssignableOk;
-            } else {
-              break;
-            }
-          }
+        RawObject** entry = SubtypeTestCache::LookupRaw(
+            cache, cid, instance_cid_or_function, instance_type_arguments,
+            instantiator_type_arguments, function_type_arguments);
+        if ((entry != NULL) &&
+            (true_value == entry[SubtypeTestCache::kTestResult])) {
+          goto AssertAssignableOk;
         }
       }
 
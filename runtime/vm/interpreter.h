@@ -148,6 +148,15 @@ class Interpreter {
                          RawObject*** FP,
                          RawObject*** SP);
 
+  bool OptimizeInvocation(bool* invoked,
+                          Thread* thread,
+                          RawFunction* function,
+                          RawObject** call_base,
+                          RawObject** call_top,
+                          uint32_t** pc,
+                          RawObject*** FP,
+                          RawObject*** SP);
+
   bool InvokeCompiled(Thread* thread,
                       RawFunction* function,
                       RawObject** call_base,
@@ -101,6 +101,12 @@ DEFINE_FLAG_HANDLER(DeterministicModeHandler,
                     deterministic,
                     "Enable deterministic mode.");
 
+DEFINE_FLAG(int,
+            message_batch_size,
+            64,
+            "Maximum number of queued messages delivered to Dart code in a "
+            "single entry. A value of 1 disables batching.");
+
 // Quick access to the locally defined thread() and isolate() methods.
 #define T (thread())
 #define I (isolate())
@@ -273,6 +279,11 @@ class IsolateMessageHandler : public MessageHandler {
   RawError* HandleLibMessage(const Array& message);
 
   MessageStatus ProcessUnhandledException(const Error& result);
+
+  // Delivers the given message and then, in the same entry into Dart code,
+  // further normal messages that are already queued.
+  MessageStatus HandleMessageBatch(Dart_Port first_port,
+                                   const Instance& first_msg);
   Isolate* isolate_;
 };
 
@@ -408,6 +419,7 @@ RawError* IsolateMessageHandler::HandleLibMessage(const Array& message) {
     }
     case Isolate::kLowMemoryMsg: {
       I->heap()->NotifyLowMemory();
+      Zone::TrimSegmentCache(true);
       break;
     }
 
@@ -618,12 +630,22 @@ MessageHandler::MessageStatus IsolateMessageHandler::HandleMessage(
       tds.CopyArgument(1, "mode", "basic");
     }
 #endif
-    const Object& result =
-        Object::Handle(zone, DartLibraryCalls::HandleMessage(msg_handler, msg));
-    if (result.IsError()) {
-      status = ProcessUnhandledException(Error::Cast(result));
+    bool batch = FLAG_message_batch_size > 1;
+#if !defined(PRODUCT)
+    // Keep single message dispatch while stepping so that the debugger
+    // stops in the handler of the message being stepped into.
+    batch = batch && !I->debugger()->IsStepping();
+#endif
+    if (batch) {
+      status = HandleMessageBatch(message->dest_port(), msg);
     } else {
-      ASSERT(result.IsNull());
+      const Object& result = Object::Handle(
+          zone, DartLibraryCalls::HandleMessage(msg_handler, msg));
+      if (result.IsError()) {
+        status = ProcessUnhandledException(Error::Cast(result));
+      } else {
+        ASSERT(result.IsNull());
+      }
     }
   }
   delete message;
@@ -641,6 +663,23 @@ MessageHandler::MessageStatus IsolateMessageHandler::HandleMessage(
   return status;
 }
 
+MessageHandler::MessageStatus IsolateMessageHandler::HandleMessageBatch(
+    Dart_Port first_port,
+    const Instance& first_msg) {
+  // The Dart side pulls each further message off the queue only after the
+  // previous one and its microtasks are done (see DequeueBatchableMessage),
+  // so a pause or an OOB message handled in between ends the batch and the
+  // remaining messages stay queued.
+  const Object& result = Object::Handle(
+      T->zone(), DartLibraryCalls::HandleMessages(first_port, first_msg,
+                                                  FLAG_message_batch_size));
+  if (result.IsError()) {
+    return ProcessUnhandledException(Error::Cast(result));
+  }
+  ASSERT(result.IsNull());
+  return kOK;
+}
+
 #ifndef PRODUCT
 void IsolateMessageHandler::NotifyPauseOnStart() {
   if (!FLAG_support_service) {
@@ -911,6 +950,7 @@ Isolate::Isolate(const Dart_IsolateFlags& api_flags)
       library_tag_handler_(NULL),
       api_state_(NULL),
       random_(),
+      secure_random_(),
       interpreter_(NULL),
       simulator_(NULL),
       mutex_(new Mutex(NOT_IN_PRODUCT("Isolate::mutex_"))),
@@ -939,6 +979,8 @@ Isolate::Isolate(const Dart_IsolateFlags& api_flags)
       spawn_count_(0),
       handler_info_cache_(),
       catch_entry_state_cache_(),
+      regexp_backtrack_stack_(NULL),
+      regexp_backtrack_stack_capacity_(0),
       embedder_entry_points_(NULL),
       obfuscation_map_(NULL) {
   FlagsCopyFrom(api_flags);
@@ -983,6 +1025,7 @@ Isolate::~Isolate() {
 #endif  // !defined(PRODUCT)
 
   free(name_);
+  free(regexp_backtrack_stack_);
   delete store_buffer_;
   delete heap_;
   delete object_store_;
@@ -1636,6 +1679,7 @@ void Isolate::Run() {
 
 void Isolate::NotifyIdle(int64_t deadline) {
   heap()->NotifyIdle(deadline);
+  Zone::TrimSegmentCache(false);
 }
 
 void Isolate::AddClosureFunction(const Function& function) const {
@@ -1752,7 +1796,9 @@ void Isolate::LowLevelShutdown() {
   }
 #endif  // !PRODUCT
 
-  // Finalize any weak persistent handles with a non-null referent.
+  // Finalize any weak persistent handles with a non-null referent, after
+  // those whose referents the last GC found unreachable.
+  api_state()->RunPendingFinalizers(this);
   FinalizeWeakPersistentHandlesVisitor visitor;
   api_state()->weak_persistent_handles().VisitHandles(&visitor);
 
@@ -1840,7 +1886,8 @@ void Isolate::Shutdown() {
     PageSpace* old_space = heap_->old_space();
     MonitorLocker ml(old_space->tasks_lock());
     while (old_space->tasks() > 0) {
-      ml.Wait();
+      // A concurrent marker finishes its work inside a safepoint operation.
+      ml.WaitWithSafepointCheck(thread);
     }
   }
 
@@ -1980,6 +2027,14 @@ void Isolate::VisitWeakPersistentHandles(HandleVisitor* visitor) {
   }
 }
 
+void Isolate::VisitWeakPersistentHandles(HandleVisitor* visitor,
+                                         intptr_t slice_index,
+                                         intptr_t num_slices) {
+  if (api_state() != NULL) {
+    api_state()->VisitWeakHandles(visitor, slice_index, num_slices);
+  }
+}
+
 void Isolate::PrepareForGC() {
   thread_registry()->PrepareForGC();
 }
@@ -2745,13 +2800,14 @@ Thread* Isolate::ScheduleThread(bool is_mutator, bool bypass_safepoint) {
     thread->set_execution_state(Thread::kThreadInVM);
     thread->set_safepoint_state(0);
     thread->set_vm_tag(VMTag::kVMTagId);
+    thread->set_is_marking(heap()->old_space()->IsMarking());
     ASSERT(thread->no_safepoint_scope_depth() == 0);
     os_thread->set_thread(thread);
     if (is_mutator) {
       scheduled_mutator_thread_ = thread;
       if (this != Dart::vm_isolate()) {
         scheduled_mutator_thread_->set_top(heap()->new_space()->top());
-        scheduled_mutator_thread_->set_end(heap()->new_space()->end());
+        heap()->new_space()->SetThreadEnd(scheduled_mutator_thread_);
       }
     }
     Thread::SetCurrent(thread);
@@ -2794,8 +2850,9 @@ void Isolate::UnscheduleThread(Thread* thread,
   OSThread::SetCurrent(os_thread);
   if (is_mutator) {
     if (this != Dart::vm_isolate()) {
+      // The thread's end may be lowered for allocation sampling, but the
+      // end of new space never changes outside of a scavenge.
       heap()->new_space()->set_top(scheduled_mutator_thread_->top_);
-      heap()->new_space()->set_end(scheduled_mutator_thread_->end_);
     }
     scheduled_mutator_thread_->top_ = 0;
     scheduled_mutator_thread_->end_ = 0;
@@ -198,6 +198,9 @@ class Isolate : public BaseIsolate {
 
   // Visits weak object pointers.
   void VisitWeakPersistentHandles(HandleVisitor* visitor);
+  void VisitWeakPersistentHandles(HandleVisitor* visitor,
+                                  intptr_t slice_index,
+                                  intptr_t num_slices);
 
   // Prepares all threads in an isolate for Garbage Collection.
   void PrepareForGC();
@@ -404,6 +407,7 @@ class Isolate : public BaseIsolate {
   }
 
   Random* random() { return &random_; }
+  SecureRandomPool* secure_random() { return &secure_random_; }
 
   Interpreter* interpreter() const { return interpreter_; }
   void set_interpreter(Interpreter* value) { interpreter_ = value; }
@@ -771,6 +775,21 @@ class Isolate : public BaseIsolate {
     return &catch_entry_state_cache_;
   }
 
+  // The malloced backtracking stack of the regexp interpreter, kept between
+  // matches. Taking it leaves the isolate without one until it is returned.
+  intptr_t* TakeRegExpBacktrackStack(intptr_t* capacity) {
+    intptr_t* stack = regexp_backtrack_stack_;
+    *capacity = regexp_backtrack_stack_capacity_;
+    regexp_backtrack_stack_ = NULL;
+    regexp_backtrack_stack_capacity_ = 0;
+    return stack;
+  }
+  void ReturnRegExpBacktrackStack(intptr_t* stack, intptr_t capacity) {
+    ASSERT(regexp_backtrack_stack_ == NULL);
+    regexp_backtrack_stack_ = stack;
+    regexp_backtrack_stack_capacity_ = capacity;
+  }
+
   void MaybeIncreaseReloadEveryNStackOverflowChecks();
 
   static void NotifyLowMemory();
@@ -955,6 +974,7 @@ class Isolate : public BaseIsolate {
   Dart_LibraryTagHandler library_tag_handler_;
   ApiState* api_state_;
   Random random_;
+  SecureRandomPool secure_random_;
   Interpreter* interpreter_;
   Simulator* simulator_;
   Mutex* mutex_;          // Protects compiler stats.
@@ -996,6 +1016,9 @@ class Isolate : public BaseIsolate {
   HandlerInfoCache handler_info_cache_;
   CatchEntryStateCache catch_entry_state_cache_;
 
+  intptr_t* regexp_backtrack_stack_;
+  intptr_t regexp_backtrack_stack_capacity_;
+
   Dart_QualifiedFunctionName* embedder_entry_points_;
   const char** obfuscation_map_;
 
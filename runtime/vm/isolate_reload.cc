@@ -1609,11 +1609,12 @@ bool IsolateReloadContext::MorphInstances() {
     }
   }
 
-  // Find all objects that need to be morphed.
+  // Find all objects that need to be morphed. Instances are never in image
+  // pages, which hold only read-only data and instructions.
   ObjectLocator locator(this);
   {
     HeapIterationScope iteration(Thread::Current());
-    iteration.IterateObjects(&locator);
+    iteration.IterateObjectsNoImagePages(&locator);
   }
 
   // Return if no objects are located.
@@ -1795,6 +1796,7 @@ void IsolateReloadContext::ResetUnoptimizedICsOnStack() {
 
 void IsolateReloadContext::ResetMegamorphicCaches() {
   object_store()->set_megamorphic_cache_table(GrowableObjectArray::Handle());
+  object_store()->set_reflective_lookup_cache(Array::Handle());
   // Since any current optimized code will not make any more calls, it may be
   // better to clear the table instead of clearing each of the caches, allow
   // the current megamorphic caches get GC'd and any new optimized code allocate
@@ -1815,45 +1817,46 @@ class MarkFunctionsForRecompilation : public ObjectVisitor {
         zone_(zone) {}
 
   virtual void VisitObject(RawObject* obj) {
-    if (obj->IsPseudoObject()) {
-      // Cannot even be wrapped in handles.
+    // Check the class id first so that the vast majority of objects, as well
+    // as pseudo objects that cannot be wrapped in handles, are skipped
+    // without a handle assignment.
+    if (!obj->IsFunction()) {
       return;
     }
     handle_ = obj;
-    if (handle_.IsFunction()) {
-      const Function& func = Function::Cast(handle_);
-      if (func.IsSignatureFunction()) {
-        return;
-      }
+    const Function& func = Function::Cast(handle_);
+    if (func.IsSignatureFunction()) {
+      return;
+    }
 
-      // Switch to unoptimized code or the lazy compilation stub.
-      func.SwitchToLazyCompiledUnoptimizedCode();
-
-      // Grab the current code.
-      code_ = func.CurrentCode();
-      ASSERT(!code_.IsNull());
-      const bool clear_code = IsFromDirtyLibrary(func);
-      const bool stub_code = code_.IsStubCode();
-
-      // Zero edge counters.
-      func.ZeroEdgeCounters();
-
-      if (!stub_code) {
-        if (clear_code) {
-          VTIR_Print("Marking %s for recompilation, clearning code\n",
-                     func.ToCString());
-          ClearAllCode(func);
-        } else {
-          PreserveUnoptimizedCode();
-        }
-      }
+    // Switch to unoptimized code or the lazy compilation stub.
+    func.SwitchToLazyCompiledUnoptimizedCode();
 
-      // Clear counters.
-      func.set_usage_counter(0);
-      func.set_deoptimization_counter(0);
-      func.set_optimized_instruction_count(0);
-      func.set_optimized_call_site_count(0);
+    // Grab the current code.
+    code_ = func.CurrentCode();
+    ASSERT(!code_.IsNull());
+    const bool clear_code = IsFromDirtyLibrary(func);
+    const bool stub_code = code_.IsStubCode();
+
+    // Zero edge counters.
+    func.ZeroEdgeCounters();
+
+    if (!stub_code) {
+      if (clear_code) {
+        VTIR_Print("Marking %s for recompilation, clearning code\n",
+                   func.ToCString());
+        ClearAllCode(func);
+      } else {
+        PreserveUnoptimizedCode();
+      }
     }
+
+    // Clear counters.
+    func.set_usage_counter(0);
+    func.set_deoptimization_counter(0);
+    func.set_adapted_deoptimization_counter(0);
+    func.set_optimized_instruction_count(0);
+    func.set_optimized_call_site_count(0);
   }
 
  private:
@@ -1893,7 +1896,9 @@ void IsolateReloadContext::MarkAllFunctionsForRecompilation() {
   Zone* zone = stack_zone.GetZone();
   HeapIterationScope iteration(thread);
   MarkFunctionsForRecompilation visitor(isolate_, this, zone);
-  iteration.IterateObjects(&visitor);
+  // Functions are always allocated in old space and are not part of image
+  // pages, so the new space and the images need not be walked.
+  iteration.IterateOldObjectsNoImagePages(&visitor);
 }
 
 void IsolateReloadContext::InvalidateWorld() {
@@ -5,6 +5,7 @@
 #include "platform/assert.h"
 
 #include "include/dart_native_api.h"
+#include "vm/dart_api_message.h"
 #include "vm/dart_entry.h"
 #include "vm/debugger.h"
 #include "vm/heap/safepoint.h"
@@ -12,6 +13,7 @@
 #include "vm/message.h"
 #include "vm/metrics.h"
 #include "vm/object.h"
+#include "vm/port.h"
 #include "vm/service.h"
 #include "vm/service_event.h"
 #include "vm/thread_registry.h"
@@ -23,6 +25,11 @@ namespace dart {
 #ifndef PRODUCT
 
 DECLARE_FLAG(bool, trace_service);
+DEFINE_FLAG(int,
+            service_response_chunk_size,
+            1 * MB,
+            "Post service replies larger than this many bytes to the service "
+            "isolate in chunks while they are written; 0 disables chunking.");
 
 JSONStream::JSONStream(intptr_t buf_size)
     : writer_(buf_size),
@@ -37,7 +44,10 @@ JSONStream::JSONStream(intptr_t buf_size)
       param_values_(NULL),
       num_params_(0),
       offset_(0),
-      count_(-1) {
+      count_(-1),
+      chunk_size_(0),
+      posted_chunks_(false),
+      discard_chunks_(false) {
   ObjectIdRing* ring = NULL;
   Isolate* isolate = Isolate::Current();
   if (isolate != NULL) {
@@ -91,9 +101,17 @@ void JSONStream::Setup(Zone* zone,
                  Dart::UptimeMillis(), main_port, isolate_name, method_);
   }
   buffer()->Printf("{\"jsonrpc\":\"2.0\", \"result\":");
+
+  // Replies to requests without an id are dropped, so they are not chunked.
+  if ((reply_port != ILLEGAL_PORT) && !seq.IsNull()) {
+    chunk_size_ = FLAG_service_response_chunk_size;
+  }
 }
 
 void JSONStream::SetupError() {
+  if (posted_chunks_) {
+    discard_chunks_ = true;
+  }
   Clear();
   buffer()->Printf("{\"jsonrpc\":\"2.0\", \"error\":");
 }
@@ -188,6 +206,54 @@ static void Finalizer(void* isolate_callback_data,
   free(buffer);
 }
 
+static void InitializeBytes(Dart_CObject* bytes, char* cstr, intptr_t length) {
+  bytes->type = Dart_CObject_kExternalTypedData;
+  bytes->value.as_external_typed_data.type = Dart_TypedData_kUint8;
+  bytes->value.as_external_typed_data.length = length;
+  bytes->value.as_external_typed_data.data = reinterpret_cast<uint8_t*>(cstr);
+  bytes->value.as_external_typed_data.peer = cstr;
+  bytes->value.as_external_typed_data.callback = Finalizer;
+}
+
+void JSONStream::FlushChunk() {
+  ASSERT(reply_port() != ILLEGAL_PORT);
+  // Keep the last character, which the writer looks at to place commas and
+  // UncloseObject removes.
+  TextBuffer* text = buffer();
+  const intptr_t length = text->length() - 1;
+  char* cstr = reinterpret_cast<char*>(malloc(length));
+  if (cstr == NULL) {
+    OUT_OF_MEMORY();
+  }
+  memmove(cstr, text->buf(), length);
+  text->buf()[0] = text->buf()[length];
+  text->buf()[1] = '\0';
+  text->set_length(1);
+
+  Dart_CObject bytes;
+  InitializeBytes(&bytes, cstr, length);
+  Dart_CObject more;
+  more.type = Dart_CObject_kBool;
+  more.value.as_bool = true;
+  Dart_CObject* elements[2];
+  elements[0] = &bytes;
+  elements[1] = &more;
+  Dart_CObject message;
+  message.type = Dart_CObject_kArray;
+  message.value.as_array.length = 2;
+  message.value.as_array.values = elements;
+  // Posting needs no transition to native: chunks are also flushed while
+  // safepoints are not allowed, e.g. during heap iteration.
+  ApiMessageWriter writer;
+  Message* msg =
+      writer.WriteCMessage(&message, reply_port(), Message::kNormalPriority);
+  if ((msg == NULL) || !PortMap::PostMessage(msg)) {
+    // The reply port is gone. The rest of the reply is dropped as well.
+    free(cstr);
+  }
+  posted_chunks_ = true;
+}
+
 void JSONStream::PostReply() {
   ASSERT(seq_ != NULL);
   Dart_Port port = reply_port();
@@ -226,17 +292,16 @@ void JSONStream::PostReply() {
   {
     TransitionVMToNative transition(Thread::Current());
     Dart_CObject bytes;
-    bytes.type = Dart_CObject_kExternalTypedData;
-    bytes.value.as_external_typed_data.type = Dart_TypedData_kUint8;
-    bytes.value.as_external_typed_data.length = length;
-    bytes.value.as_external_typed_data.data = reinterpret_cast<uint8_t*>(cstr);
-    bytes.value.as_external_typed_data.peer = cstr;
-    bytes.value.as_external_typed_data.callback = Finalizer;
-    Dart_CObject* elements[1];
+    InitializeBytes(&bytes, cstr, length);
+    Dart_CObject replace;
+    replace.type = Dart_CObject_kBool;
+    replace.value.as_bool = false;
+    Dart_CObject* elements[2];
     elements[0] = &bytes;
+    elements[1] = &replace;
     Dart_CObject message;
     message.type = Dart_CObject_kArray;
-    message.value.as_array.length = 1;
+    message.value.as_array.length = discard_chunks_ ? 2 : 1;
     message.value.as_array.values = elements;
     result = Dart_PostCObject(port, &message);
   }
@@ -166,18 +166,30 @@ class JSONStream : ValueObject {
   void OpenObject(const char* property_name = NULL) {
     writer_.OpenObject(property_name);
   }
-  void CloseObject() { writer_.CloseObject(); }
+  void CloseObject() {
+    writer_.CloseObject();
+    MaybeFlushChunk();
+  }
   void UncloseObject() { writer_.UncloseObject(); }
 
   void OpenArray(const char* property_name = NULL) {
     writer_.OpenArray(property_name);
   }
-  void CloseArray() { writer_.CloseArray(); }
+  void CloseArray() {
+    writer_.CloseArray();
+    MaybeFlushChunk();
+  }
 
   void PrintValueNull() { writer_.PrintValueNull(); }
   void PrintValueBool(bool b) { writer_.PrintValueBool(b); }
-  void PrintValue(intptr_t i) { writer_.PrintValue(i); }
-  void PrintValue64(int64_t i) { writer_.PrintValue64(i); }
+  void PrintValue(intptr_t i) {
+    writer_.PrintValue(i);
+    MaybeFlushChunk();
+  }
+  void PrintValue64(int64_t i) {
+    writer_.PrintValue64(i);
+    MaybeFlushChunk();
+  }
   void PrintValueTimeMillis(int64_t millis) { writer_.PrintValue64(millis); }
   void PrintValueTimeMicros(int64_t micros) { writer_.PrintValue64(micros); }
   void PrintValue(double d) { writer_.PrintValue(d); }
@@ -270,6 +282,18 @@ class JSONStream : ValueObject {
     writer_.AddEscapedUTF8String(s, len);
   }
 
+  // Large replies are posted to the reply port in chunks while they are
+  // written, see FLAG_service_response_chunk_size. Each chunk is a
+  // [Uint8List, true] message, the rest of the reply the usual [Uint8List]
+  // message. A reply that turns into an error after chunks were posted ends
+  // with [Uint8List, false] instead, which replaces these chunks.
+  void MaybeFlushChunk() {
+    if ((chunk_size_ > 0) && (writer_.buffer()->length() >= chunk_size_)) {
+      FlushChunk();
+    }
+  }
+  void FlushChunk();
+
   JSONWriter writer_;
   // Default service id zone.
   RingServiceIdZone default_id_zone_;
@@ -285,6 +309,9 @@ class JSONStream : ValueObject {
   intptr_t offset_;
   intptr_t count_;
   int64_t setup_time_micros_;
+  intptr_t chunk_size_;
+  bool posted_chunks_;
+  bool discard_chunks_;
 
   friend class JSONObject;
   friend class JSONArray;
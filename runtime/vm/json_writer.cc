@@ -5,6 +5,8 @@
 #include "platform/assert.h"
 
 #include "vm/json_writer.h"
+
+#include "vm/base64.h"
 #include "vm/object.h"
 #include "vm/unicode.h"
 
@@ -121,35 +123,19 @@ void JSONWriter::PrintValue(double d) {
   buffer_.Printf("%f", d);
 }
 
-static const char base64_digits[65] =
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-static const char base64_pad = '=';
-
 void JSONWriter::PrintValueBase64(const uint8_t* bytes, intptr_t length) {
   PrintCommaIfNeeded();
   buffer_.AddChar('"');
 
-  intptr_t odd_bits = length % 3;
-  intptr_t even_bits = length - odd_bits;
-  for (intptr_t i = 0; i < even_bits; i += 3) {
-    intptr_t triplet = (bytes[i] << 16) | (bytes[i + 1] << 8) | bytes[i + 2];
-    buffer_.AddChar(base64_digits[triplet >> 18]);
-    buffer_.AddChar(base64_digits[(triplet >> 12) & 63]);
-    buffer_.AddChar(base64_digits[(triplet >> 6) & 63]);
-    buffer_.AddChar(base64_digits[triplet & 63]);
-  }
-  if (odd_bits == 1) {
-    intptr_t triplet = bytes[even_bits] << 16;
-    buffer_.AddChar(base64_digits[triplet >> 18]);
-    buffer_.AddChar(base64_digits[(triplet >> 12) & 63]);
-    buffer_.AddChar(base64_pad);
-    buffer_.AddChar(base64_pad);
-  } else if (odd_bits == 2) {
-    intptr_t triplet = (bytes[even_bits] << 16) | (bytes[even_bits + 1] << 8);
-    buffer_.AddChar(base64_digits[triplet >> 18]);
-    buffer_.AddChar(base64_digits[(triplet >> 12) & 63]);
-    buffer_.AddChar(base64_digits[(triplet >> 6) & 63]);
-    buffer_.AddChar(base64_pad);
+  // Encode in blocks through a stack buffer, appending each block at once
+  // instead of checking the buffer's capacity for every character.
+  const intptr_t kBlockBytes = 3 * 256;
+  char encoded[4 * 256];
+  for (intptr_t i = 0; i < length; i += kBlockBytes) {
+    const intptr_t block_length = Utils::Minimum(kBlockBytes, length - i);
+    const intptr_t encoded_length =
+        EncodeBase64(bytes + i, block_length, encoded);
+    buffer_.AddRaw(reinterpret_cast<const uint8_t*>(encoded), encoded_length);
   }
 
   buffer_.AddChar('"');
@@ -6,11 +6,14 @@
 
 #include <string.h>
 
+#include "platform/atomic.h"
 #include "vm/compiler/frontend/kernel_binary_flowgraph.h"
 #include "vm/compiler/frontend/kernel_to_il.h"
+#include "vm/dart.h"
 #include "vm/dart_api_impl.h"
 #include "vm/flags.h"
 #include "vm/kernel_binary.h"
+#include "vm/lockers.h"
 #include "vm/longjump.h"
 #include "vm/object_store.h"
 #include "vm/parser.h"
@@ -18,9 +21,24 @@
 #include "vm/service_isolate.h"
 #include "vm/symbols.h"
 #include "vm/thread.h"
+#include "vm/thread_pool.h"
+#include "vm/unicode.h"
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 namespace dart {
+
+DEFINE_FLAG(bool,
+            lazy_top_level_members,
+            true,
+            "Load the top level fields and procedures of non-core libraries "
+            "when they are first looked up instead of when the program is "
+            "loaded.");
+DEFINE_FLAG(int,
+            kernel_source_decoding_tasks,
+            2,
+            "Number of helper tasks decoding the sources of a kernel program "
+            "while the mutator loads it.");
+
 namespace kernel {
 
 #define Z (zone_)
@@ -170,6 +188,7 @@ KernelLoader::KernelLoader(Program* program)
       library_kernel_offset_(-1),  // Set to the correct value in LoadLibrary
       correction_offset_(-1),      // Set to the correct value in LoadLibrary
       loading_native_wrappers_library_(false),
+      lazy_top_level_members_(false),
       library_kernel_data_(ExternalTypedData::ZoneHandle(zone_)),
       kernel_program_info_(KernelProgramInfo::ZoneHandle(zone_)),
       translation_helper_(this, thread_),
@@ -261,6 +280,134 @@ void KernelLoader::index_programs(
   subprogram_file_starts->Reverse();
 }
 
+// Decodes the UTF-8 sources of the kernel source table into malloced code
+// units on helper tasks, so that the mutator only copies them into the heap
+// when it creates the scripts.
+class SourceTableDecoder : public ValueObject {
+ public:
+  SourceTableDecoder(const uint8_t* kernel_data,
+                     intptr_t kernel_data_size,
+                     const GrowableArray<intptr_t>& source_offsets)
+      : kernel_data_(kernel_data),
+        kernel_data_size_(kernel_data_size),
+        source_offsets_(source_offsets),
+        sources_(new DecodedSource[source_offsets.length()]),
+        next_index_(0),
+        running_tasks_(0) {}
+
+  ~SourceTableDecoder() {
+    for (intptr_t i = 0; i < source_offsets_.length(); i++) {
+      free(sources_[i].code_units);
+    }
+    delete[] sources_;
+  }
+
+  // Decodes all sources, on the calling thread and on up to
+  // --kernel_source_decoding_tasks helper tasks.
+  void DecodeAll(Thread* thread) {
+    const intptr_t num_tasks = Utils::Minimum<intptr_t>(
+        FLAG_kernel_source_decoding_tasks, source_offsets_.length() - 1);
+    for (intptr_t i = 0; i < num_tasks; i++) {
+      {
+        MonitorLocker ml(&monitor_);
+        running_tasks_++;
+      }
+      if (!Dart::thread_pool()->Run(new DecodeTask(this))) {
+        MonitorLocker ml(&monitor_);
+        running_tasks_--;
+      }
+    }
+    DecodeUntilDone();
+    MonitorLocker ml(&monitor_);
+    while (running_tasks_ > 0) {
+      ml.WaitWithSafepointCheck(thread);
+    }
+  }
+
+  RawString* SourceAt(intptr_t index) const {
+    const DecodedSource& source = sources_[index];
+    if (source.type == Utf8::kLatin1) {
+      return OneByteString::New(
+          reinterpret_cast<const uint8_t*>(source.code_units), source.length,
+          Heap::kOld);
+    }
+    return TwoByteString::New(
+        reinterpret_cast<const uint16_t*>(source.code_units), source.length,
+        Heap::kOld);
+  }
+
+ private:
+  struct DecodedSource {
+    Utf8::Type type;
+    intptr_t length;   // Number of code units.
+    void* code_units;  // Latin-1 or UTF-16, NULL if the source is empty.
+  };
+
+  class DecodeTask : public ThreadPool::Task {
+   public:
+    explicit DecodeTask(SourceTableDecoder* decoder) : decoder_(decoder) {}
+
+    virtual void Run() {
+      decoder_->DecodeUntilDone();
+      MonitorLocker ml(&decoder_->monitor_);
+      decoder_->running_tasks_--;
+      ml.Notify();
+    }
+
+   private:
+    SourceTableDecoder* decoder_;
+  };
+
+  void DecodeUntilDone() {
+    const uintptr_t count = source_offsets_.length();
+    for (;;) {
+      const uintptr_t index = AtomicOperations::FetchAndIncrement(&next_index_);
+      if (index >= count) {
+        return;
+      }
+      Decode(index);
+    }
+  }
+
+  void Decode(intptr_t index) {
+    Reader reader(kernel_data_, kernel_data_size_);
+    reader.set_offset(source_offsets_[index]);
+    const intptr_t uri_size = reader.ReadUInt();
+    reader.set_offset(reader.offset() + uri_size);  // skip uri.
+    const intptr_t size = reader.ReadUInt();        // read source size.
+
+    DecodedSource* source = &sources_[index];
+    source->type = Utf8::kLatin1;
+    source->length = 0;
+    source->code_units = NULL;
+    if (size == 0) {
+      return;
+    }
+    const uint8_t* utf8 = reader.BufferAt(reader.offset());
+    source->length = Utf8::CodeUnitCount(utf8, size, &source->type);
+    if (source->type == Utf8::kLatin1) {
+      uint8_t* latin1 = reinterpret_cast<uint8_t*>(malloc(source->length));
+      Utf8::DecodeToLatin1(utf8, size, latin1, source->length);
+      source->code_units = latin1;
+    } else {
+      uint16_t* utf16 = reinterpret_cast<uint16_t*>(
+          malloc(source->length * sizeof(uint16_t)));
+      Utf8::DecodeToUTF16(utf8, size, utf16, source->length);
+      source->code_units = utf16;
+    }
+  }
+
+  const uint8_t* kernel_data_;
+  const intptr_t kernel_data_size_;
+  const GrowableArray<intptr_t>& source_offsets_;
+  DecodedSource* sources_;
+  uintptr_t next_index_;
+  Monitor monitor_;
+  intptr_t running_tasks_;
+
+  DISALLOW_COPY_AND_ASSIGN(SourceTableDecoder);
+};
+
 void KernelLoader::InitializeFields() {
   const intptr_t source_table_size = builder_.SourceTableSize();
   const Array& scripts =
@@ -311,9 +458,21 @@ void KernelLoader::InitializeFields() {
 
   H.InitFromKernelProgramInfo(kernel_program_info_);
 
+  // Decoding the sources is pure parsing of the kernel binary and can be
+  // done in parallel, only the scripts are created here.
+  GrowableArray<intptr_t> source_offsets(source_table_size);
+  for (intptr_t index = 0; index < source_table_size; ++index) {
+    source_offsets.Add(builder_.GetOffsetForSourceInfo(index));
+  }
+  SourceTableDecoder decoder(program_->kernel_data(),
+                             program_->kernel_data_size(), source_offsets);
+  decoder.DecodeAll(thread_);
+
   Script& script = Script::Handle(Z);
+  String& sources = String::Handle(Z);
   for (intptr_t index = 0; index < source_table_size; ++index) {
-    script = LoadScriptAt(index);
+    sources = decoder.SourceAt(index);
+    script = LoadScriptAt(index, &sources);
     scripts.SetAt(index, script);
   }
 }
@@ -329,6 +488,7 @@ KernelLoader::KernelLoader(const Script& script,
       library_kernel_offset_(data_program_offset),
       correction_offset_(0),
       loading_native_wrappers_library_(false),
+      lazy_top_level_members_(false),
       library_kernel_data_(ExternalTypedData::ZoneHandle(zone_)),
       kernel_program_info_(
           KernelProgramInfo::ZoneHandle(zone_, script.kernel_program_info())),
@@ -566,6 +726,13 @@ RawObject* KernelLoader::LoadProgram(bool process_pending_classes) {
         "not allowed");
   }
 
+  // Deferred members are loaded by finalizing their top level class, so only
+  // defer them when the pending classes are finalized right away. The
+  // precompiler and hot reload walk library dictionaries directly.
+  lazy_top_level_members_ = FLAG_lazy_top_level_members &&
+                            process_pending_classes &&
+                            !FLAG_precompiled_mode && !I->IsReloading();
+
   LongJumpScope jump;
   if (setjmp(*jump.Set()) == 0) {
     const intptr_t length = program_->library_count();
@@ -742,7 +909,6 @@ RawLibrary* KernelLoader::LoadLibrary(intptr_t index) {
 
   LibraryIndex library_index(library_kernel_data_);
   intptr_t class_count = library_index.class_count();
-  intptr_t procedure_count = library_index.procedure_count();
 
   library_helper.ReadUntilIncluding(LibraryHelper::kName);
   library.SetName(H.DartSymbolObfuscate(library_helper.name_index_));
@@ -803,6 +969,34 @@ RawLibrary* KernelLoader::LoadLibrary(intptr_t index) {
   }
   builder_.SetOffset(next_class_offset);
 
+  // Core libraries are always loaded eagerly, the VM looks up their members
+  // while bootstrapping.
+  if (lazy_top_level_members_ && !library.is_dart_scheme() &&
+      !loading_native_wrappers_library_) {
+    // The toplevel fields and procedures are loaded by FinishLoading when the
+    // toplevel class is finalized.
+    toplevel_class.set_kernel_offset(builder_.ReaderOffset() -
+                                     correction_offset_);
+  } else {
+    FinishTopLevelClassLoading(toplevel_class, library, library_index);
+  }
+
+  if (FLAG_enable_mirrors && annotation_count > 0) {
+    ASSERT(annotations_kernel_offset > 0);
+    library.AddLibraryMetadata(toplevel_class, TokenPosition::kNoSource,
+                               annotations_kernel_offset);
+  }
+
+  classes.Add(toplevel_class, Heap::kOld);
+  if (!library.Loaded()) library.SetLoaded();
+
+  return library.raw();
+}
+
+void KernelLoader::FinishTopLevelClassLoading(
+    const Class& toplevel_class,
+    const Library& library,
+    const LibraryIndex& library_index) {
   fields_.Clear();
   functions_.Clear();
   ActiveClassScope active_class_scope(&active_class_, &toplevel_class);
@@ -847,25 +1041,19 @@ RawLibrary* KernelLoader::LoadLibrary(intptr_t index) {
   }
   toplevel_class.AddFields(fields_);
 
-  // Load toplevel procedures.
-  intptr_t next_procedure_offset = library_index.ProcedureOffset(0);
+  // Load toplevel procedures. Procedure offsets within a library index are
+  // whole program offsets and not relative to the library.
+  const intptr_t procedure_count = library_index.procedure_count();
+  const intptr_t correction = correction_offset_ - library_kernel_offset_;
+  intptr_t next_procedure_offset =
+      library_index.ProcedureOffset(0) + correction;
   for (intptr_t i = 0; i < procedure_count; ++i) {
     builder_.SetOffset(next_procedure_offset);
-    next_procedure_offset = library_index.ProcedureOffset(i + 1);
+    next_procedure_offset = library_index.ProcedureOffset(i + 1) + correction;
     LoadProcedure(library, toplevel_class, false, next_procedure_offset);
   }
 
-  if (FLAG_enable_mirrors && annotation_count > 0) {
-    ASSERT(annotations_kernel_offset > 0);
-    library.AddLibraryMetadata(toplevel_class, TokenPosition::kNoSource,
-                               annotations_kernel_offset);
-  }
-
   toplevel_class.SetFunctions(Array::Handle(MakeFunctionsArray()));
-  classes.Add(toplevel_class, Heap::kOld);
-  if (!library.Loaded()) library.SetLoaded();
-
-  return library.raw();
 }
 
 void KernelLoader::LoadLibraryImportsAndExports(Library* library,
@@ -1309,6 +1497,23 @@ void KernelLoader::FinishLoading(const Class& klass) {
   KernelLoader kernel_loader(script, library_kernel_data,
                              library_kernel_offset);
   LibraryIndex library_index(library_kernel_data);
+  kernel_loader.builder_.SetOffset(class_offset);
+
+  if (klass.IsTopLevel()) {
+    // Clear the offset first, adding the members to the library dictionary
+    // looks up their names.
+    klass.set_kernel_offset(0);
+    // Toplevel members may be declared in parts of the library, which need
+    // patch classes.
+    kernel_loader.library_kernel_data_ = library_kernel_data.raw();
+    kernel_loader.patch_classes_ = Array::New(
+        Array::Handle(zone, kernel_loader.kernel_program_info_.scripts())
+            .Length(),
+        Heap::kOld);
+    kernel_loader.FinishTopLevelClassLoading(klass, library, library_index);
+    return;
+  }
+
   ClassIndex class_index(
       library_kernel_data, class_offset,
       // Class offsets in library index are whole program offsets.
@@ -1316,8 +1521,6 @@ void KernelLoader::FinishLoading(const Class& klass) {
       // |class_offset| to lookup the entry for the class in the library
       // index.
       library_index.SizeOfClassAtOffset(class_offset + library_kernel_offset));
-
-  kernel_loader.builder_.SetOffset(class_offset);
   ClassHelper class_helper(&kernel_loader.builder_);
 
   kernel_loader.FinishClassLoading(klass, library, toplevel_class, class_offset,
@@ -1552,9 +1755,9 @@ const Object& KernelLoader::ClassForScriptAt(const Class& klass,
   return klass;
 }
 
-RawScript* KernelLoader::LoadScriptAt(intptr_t index) {
+RawScript* KernelLoader::LoadScriptAt(intptr_t index, String* sources_ptr) {
   const String& uri_string = builder_.SourceTableUriFor(index);
-  String& sources = builder_.GetSourceFor(index);
+  String& sources = *sources_ptr;
   TypedData& line_starts =
       TypedData::Handle(Z, builder_.GetLineStartsFor(index));
   if (sources.Length() == 0 && line_starts.Length() == 0 &&
@@ -227,6 +227,12 @@ class KernelLoader : public ValueObject {
                           const ClassIndex& class_index,
                           ClassHelper* class_helper);
 
+  // Loads the toplevel fields and procedures of 'library', the reader must be
+  // positioned at the toplevel fields.
+  void FinishTopLevelClassLoading(const Class& toplevel_class,
+                                  const Library& library,
+                                  const LibraryIndex& library_index);
+
   void LoadProcedure(const Library& library,
                      const Class& owner,
                      bool in_class,
@@ -234,7 +240,8 @@ class KernelLoader : public ValueObject {
 
   RawArray* MakeFunctionsArray();
 
-  RawScript* LoadScriptAt(intptr_t index);
+  // 'sources' holds the decoded source of the script at 'index'.
+  RawScript* LoadScriptAt(intptr_t index, String* sources);
 
   // If klass's script is not the script at the uri index, return a PatchClass
   // for klass whose script corresponds to the uri index.
@@ -302,6 +309,9 @@ class KernelLoader : public ValueObject {
   // to their library's kernel data, have to be corrected.
   intptr_t correction_offset_;
   bool loading_native_wrappers_library_;
+  // Whether the toplevel members of the libraries being loaded are deferred
+  // until their toplevel class is finalized.
+  bool lazy_top_level_members_;
 
   NameIndex skip_vmservice_library_;
 
@@ -0,0 +1,711 @@
+// Copyright (c) 2017, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/globals.h"
+
+#if !defined(PRODUCT)
+
+#include "vm/malloc_hooks.h"
+
+#include <math.h>    // NOLINT
+#include <stdlib.h>  // NOLINT
+#include <string.h>  // NOLINT
+
+#include "platform/assert.h"
+#include "platform/atomic.h"
+#include "platform/growable_array.h"
+#include "platform/utils.h"
+#include "vm/flags.h"
+#include "vm/hash_map.h"
+#include "vm/json_stream.h"
+#include "vm/native_symbol.h"
+#include "vm/os_thread.h"
+#include "vm/profiler.h"
+#include "vm/random.h"
+
+namespace dart {
+
+DEFINE_FLAG(int,
+            native_memory_sample_interval,
+            0,
+            "With --profiler_native_memory, record about one native allocation "
+            "per this many KB allocated instead of every allocation.");
+
+// The frames of Profiler::SampleNativeAllocation, AllocationInfo's
+// constructor unless it is inlined, MallocHooks::RecordAllocation and
+// Dart_RecordNativeAllocation. Unlike kSkipCount, this does not depend on
+// the allocator.
+#if defined(DEBUG)
+static const intptr_t kRecordAllocationSkipCount = 4;
+#else
+static const intptr_t kRecordAllocationSkipCount = 3;
+#endif
+
+// Keeps single samples of huge allocations from skewing the estimates, and
+// the distance between sampling points from overflowing.
+static const intptr_t kMaxDistanceFactor = 64;
+
+class AddressMap;
+
+// MallocHooksState contains all of the state related to the configuration of
+// the malloc hooks, allocation information, and locks.
+class MallocHooksState : public AllStatic {
+ public:
+  // Forced inline so that the stack depth below the allocator's hook, and
+  // with it kSkipCount, does not change.
+  static DART_FORCE_INLINE void RecordAllocation(const void* ptr,
+                                                 size_t size,
+                                                 intptr_t skip_count);
+  static void RecordFree(const void* ptr);
+
+  static bool Active() {
+    ASSERT(malloc_hook_mutex()->IsOwnedByCurrentThread());
+    return active_;
+  }
+  static void Init();
+
+  static bool ProfilingEnabled() { return (OSThread::TryCurrent() != NULL); }
+
+  static bool stack_trace_collection_enabled() {
+    return stack_trace_collection_enabled_;
+  }
+
+  static void set_stack_trace_collection_enabled(bool enabled) {
+    stack_trace_collection_enabled_ = enabled;
+  }
+
+  static bool IsOriginalProcess() {
+    ASSERT(original_pid_ != kInvalidPid);
+    return original_pid_ == OS::ProcessId();
+  }
+
+  static Mutex* malloc_hook_mutex() { return malloc_hook_mutex_; }
+  static ThreadId* malloc_hook_mutex_owner() {
+    return &malloc_hook_mutex_owner_;
+  }
+  static bool IsLockHeldByCurrentThread() {
+    return (malloc_hook_mutex_owner_ == OSThread::GetCurrentThreadId());
+  }
+
+  static intptr_t allocation_count() { return allocation_count_; }
+
+  static intptr_t heap_allocated_memory_in_bytes() {
+    return heap_allocated_memory_in_bytes_;
+  }
+
+  // The bytes and number of allocations recorded allocations stand for.
+  static void IncrementHeapAllocatedMemoryInBytes(intptr_t size,
+                                                  intptr_t count) {
+    ASSERT(malloc_hook_mutex()->IsOwnedByCurrentThread());
+    ASSERT(size >= 0);
+    heap_allocated_memory_in_bytes_ += size;
+    allocation_count_ += count;
+  }
+
+  static void DecrementHeapAllocatedMemoryInBytes(intptr_t size,
+                                                  intptr_t count) {
+    ASSERT(malloc_hook_mutex()->IsOwnedByCurrentThread());
+    ASSERT(size >= 0);
+    ASSERT(heap_allocated_memory_in_bytes_ >= size);
+    heap_allocated_memory_in_bytes_ -= size;
+    allocation_count_ -= count;
+    ASSERT(allocation_count_ >= 0);
+  }
+
+  static AddressMap* address_map() { return address_map_; }
+
+  // Bytes between sampling points, or 0 if every allocation is recorded.
+  static intptr_t sample_interval() { return sample_interval_; }
+
+  static void ResetStats();
+  static void TearDown();
+
+ private:
+  // A count of recorded allocations per slot of addresses, read without
+  // the lock so that most frees need not take it.
+  static const intptr_t kAddressFilterSize = 4096;
+  static intptr_t AddressFilterIndex(const void* ptr) {
+    // Allocations are at least 16 byte aligned.
+    return (reinterpret_cast<uword>(ptr) >> 4) & (kAddressFilterSize - 1);
+  }
+
+  static intptr_t NextSampleDistance();
+
+  static Mutex* malloc_hook_mutex_;
+  static ThreadId malloc_hook_mutex_owner_;
+
+  // Variables protected by malloc_hook_mutex_.
+  static bool active_;
+  static bool stack_trace_collection_enabled_;
+  static intptr_t allocation_count_;
+  static intptr_t heap_allocated_memory_in_bytes_;
+  static AddressMap* address_map_;
+  static Random* random_;
+  // End protected variables.
+
+  // Written with malloc_hook_mutex_ held, read without it.
+  static intptr_t sample_interval_;
+  static uint32_t address_filter_[kAddressFilterSize];
+
+  // Each thread's bytes until its next sampling point, or 0 before its
+  // first allocation. Distances are exponentially distributed, so the
+  // threads need not share one.
+  static ThreadLocalKey bytes_until_sample_key_;
+
+  static intptr_t original_pid_;
+  static const intptr_t kInvalidPid = -1;
+};
+
+// A locker-type class similar to MutexLocker which tracks which thread
+// currently holds the lock. We use this instead of MutexLocker and
+// mutex->IsOwnedByCurrentThread() since IsOwnedByCurrentThread() is only
+// enabled for debug mode.
+class MallocLocker : public ValueObject {
+ public:
+  explicit MallocLocker(Mutex* mutex, ThreadId* owner)
+      : mutex_(mutex), owner_(owner) {
+    ASSERT(owner != NULL);
+    mutex_->Lock();
+    ASSERT(*owner_ == OSThread::kInvalidThreadId);
+    *owner_ = OSThread::GetCurrentThreadId();
+  }
+
+  virtual ~MallocLocker() {
+    ASSERT(*owner_ == OSThread::GetCurrentThreadId());
+    *owner_ = OSThread::kInvalidThreadId;
+    mutex_->Unlock();
+  }
+
+ private:
+  Mutex* mutex_;
+  ThreadId* owner_;
+};
+
+// AllocationInfo contains all information related to a given allocation
+// including:
+//   -Allocation size in bytes
+//   -The bytes and allocations it stands for if allocations are sampled
+//   -Stack trace corresponding to the location of allocation, if applicable
+class AllocationInfo {
+ public:
+  AllocationInfo(uword address,
+                 intptr_t allocation_size,
+                 intptr_t estimated_size,
+                 intptr_t estimated_count,
+                 intptr_t skip_count)
+      : sample_(NULL),
+        address_(address),
+        allocation_size_(allocation_size),
+        estimated_size_(estimated_size),
+        estimated_count_(estimated_count) {
+    // Stack trace collection is disabled when we are in the process of creating
+    // the first OSThread in order to prevent deadlocks.
+    if (MallocHooksState::ProfilingEnabled() &&
+        MallocHooksState::stack_trace_collection_enabled()) {
+      sample_ = Profiler::SampleNativeAllocation(skip_count, address,
+                                                 estimated_size);
+      ASSERT((sample_ == NULL) ||
+             (sample_->native_allocation_address() == address_));
+    }
+  }
+
+  ~AllocationInfo() {
+    if (sample_ != NULL) {
+      Profiler::allocation_sample_buffer()->FreeAllocationSample(sample_);
+    }
+  }
+
+  Sample* sample() const { return sample_; }
+  intptr_t allocation_size() const { return allocation_size_; }
+  intptr_t estimated_size() const { return estimated_size_; }
+  intptr_t estimated_count() const { return estimated_count_; }
+
+ private:
+  // Note: sample_ is not owned by AllocationInfo, but by the SampleBuffer
+  // created by the profiler. As such, this is only here to track if the sample
+  // is still associated with a native allocation, and its fields are never
+  // accessed from this class.
+  Sample* sample_;
+  uword address_;
+  intptr_t allocation_size_;
+  intptr_t estimated_size_;
+  intptr_t estimated_count_;
+};
+
+// Custom key/value trait specifically for address/size pairs. Unlike
+// RawPointerKeyValueTrait, the default value is -1 as 0 can be a valid entry.
+class AddressKeyValueTrait : public AllStatic {
+ public:
+  typedef const void* Key;
+  typedef AllocationInfo* Value;
+
+  struct Pair {
+    Key key;
+    Value value;
+    Pair() : key(NULL), value(NULL) {}
+    Pair(const Key key, const Value& value) : key(key), value(value) {}
+    Pair(const Pair& other) : key(other.key), value(other.value) {}
+  };
+
+  static Key KeyOf(Pair kv) { return kv.key; }
+  static Value ValueOf(Pair kv) { return kv.value; }
+  static intptr_t Hashcode(Key key) { return reinterpret_cast<intptr_t>(key); }
+  static bool IsKeyEqual(Pair kv, Key key) { return kv.key == key; }
+};
+
+// Map class that will be used to store mappings between ptr -> allocation size.
+class AddressMap : public MallocDirectChainedHashMap<AddressKeyValueTrait> {
+ public:
+  typedef AddressKeyValueTrait::Key Key;
+  typedef AddressKeyValueTrait::Value Value;
+  typedef AddressKeyValueTrait::Pair Pair;
+
+  virtual ~AddressMap() { Clear(); }
+
+  void Insert(const Key& key, const Value& value) {
+    Pair pair(key, value);
+    MallocDirectChainedHashMap<AddressKeyValueTrait>::Insert(pair);
+  }
+
+  bool Lookup(const Key& key, Value* value) {
+    ASSERT(value != NULL);
+    Pair* pair = MallocDirectChainedHashMap<AddressKeyValueTrait>::Lookup(key);
+    if (pair == NULL) {
+      return false;
+    } else {
+      *value = pair->value;
+      return true;
+    }
+  }
+
+  void Clear() {
+    Iterator iter = GetIterator();
+    Pair* result = iter.Next();
+    while (result != NULL) {
+      delete result->value;
+      result->value = NULL;
+      result = iter.Next();
+    }
+    MallocDirectChainedHashMap<AddressKeyValueTrait>::Clear();
+  }
+};
+
+// MallocHooks state / locks.
+bool MallocHooksState::active_ = false;
+bool MallocHooksState::stack_trace_collection_enabled_ = false;
+intptr_t MallocHooksState::original_pid_ = MallocHooksState::kInvalidPid;
+Mutex* MallocHooksState::malloc_hook_mutex_ = new Mutex();
+ThreadId MallocHooksState::malloc_hook_mutex_owner_ =
+    OSThread::kInvalidThreadId;
+
+// Memory allocation state information.
+intptr_t MallocHooksState::allocation_count_ = 0;
+intptr_t MallocHooksState::heap_allocated_memory_in_bytes_ = 0;
+AddressMap* MallocHooksState::address_map_ = NULL;
+Random* MallocHooksState::random_ = NULL;
+
+// Sampling state.
+intptr_t MallocHooksState::sample_interval_ = 0;
+uint32_t MallocHooksState::address_filter_[kAddressFilterSize];
+ThreadLocalKey MallocHooksState::bytes_until_sample_key_ =
+    kUnsetThreadLocalKey;
+
+void MallocHooksState::Init() {
+  address_map_ = new AddressMap();
+  if (random_ == NULL) {
+    random_ = new Random();
+  }
+  if (bytes_until_sample_key_ == kUnsetThreadLocalKey) {
+    bytes_until_sample_key_ = OSThread::CreateThreadLocal();
+  }
+  memset(address_filter_, 0, sizeof(address_filter_));
+  sample_interval_ = Utils::Maximum(FLAG_native_memory_sample_interval, 0) * KB;
+  active_ = true;
+#if defined(DEBUG)
+  stack_trace_collection_enabled_ = true;
+#else
+  // Stack traces of sampled allocations are cheap enough to always collect.
+  stack_trace_collection_enabled_ = (sample_interval_ > 0);
+#endif  // defined(DEBUG)
+  original_pid_ = OS::ProcessId();
+}
+
+void MallocHooksState::ResetStats() {
+  ASSERT(malloc_hook_mutex()->IsOwnedByCurrentThread());
+  allocation_count_ = 0;
+  heap_allocated_memory_in_bytes_ = 0;
+  address_map_->Clear();
+  memset(address_filter_, 0, sizeof(address_filter_));
+}
+
+void MallocHooksState::TearDown() {
+  ASSERT(malloc_hook_mutex()->IsOwnedByCurrentThread());
+  active_ = false;
+  original_pid_ = kInvalidPid;
+  ResetStats();
+  delete address_map_;
+  address_map_ = NULL;
+  sample_interval_ = 0;
+}
+
+intptr_t MallocHooksState::NextSampleDistance() {
+  ASSERT(malloc_hook_mutex()->IsOwnedByCurrentThread());
+  // A uniform sample from (0, 1].
+  const double uniform = (static_cast<double>(random_->NextUInt32()) + 1.0) /
+                         4294967296.0;
+  const double distance = -log(uniform) * static_cast<double>(sample_interval_);
+  const double max_distance =
+      static_cast<double>(sample_interval_) * kMaxDistanceFactor;
+  if (distance >= max_distance) {
+    return static_cast<intptr_t>(max_distance);
+  }
+  return Utils::Maximum(static_cast<intptr_t>(distance),
+                        static_cast<intptr_t>(1));
+}
+
+void MallocHooksState::RecordAllocation(const void* ptr,
+                                        size_t size,
+                                        intptr_t skip_count) {
+  if ((ptr == NULL) || MallocHooksState::IsLockHeldByCurrentThread()) {
+    return;
+  }
+  // Allocations before the thread's next sampling point only count down its
+  // distance, without taking the lock.
+  intptr_t bytes_until_sample = 0;
+  if (sample_interval_ > 0) {
+    bytes_until_sample = static_cast<intptr_t>(
+        OSThread::GetThreadLocal(bytes_until_sample_key_));
+    if (bytes_until_sample > static_cast<intptr_t>(size)) {
+      OSThread::SetThreadLocal(bytes_until_sample_key_,
+                               bytes_until_sample - size);
+      return;
+    }
+  }
+  if (!MallocHooksState::IsOriginalProcess()) {
+    return;
+  }
+
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+  // Now that we hold the lock, check to make sure everything is still active.
+  if (!MallocHooksState::Active()) {
+    return;
+  }
+  intptr_t estimated_size = size;
+  intptr_t estimated_count = 1;
+  if (sample_interval_ > 0) {
+    if (bytes_until_sample == 0) {
+      // The first allocation of this thread.
+      bytes_until_sample = NextSampleDistance();
+      if (bytes_until_sample > static_cast<intptr_t>(size)) {
+        OSThread::SetThreadLocal(bytes_until_sample_key_,
+                                 bytes_until_sample - size);
+        return;
+      }
+    }
+    OSThread::SetThreadLocal(bytes_until_sample_key_, NextSampleDistance());
+    // An allocation of 'size' bytes is sampled with probability
+    // 1 - exp(-size / interval), and stands for 1 / probability of them.
+    const double probability =
+        1.0 - exp(-static_cast<double>(size) /
+                  static_cast<double>(sample_interval_));
+    estimated_size = static_cast<intptr_t>(size / probability);
+    estimated_count =
+        Utils::Maximum(static_cast<intptr_t>(1.0 / probability + 0.5),
+                       static_cast<intptr_t>(1));
+  }
+  MallocHooksState::IncrementHeapAllocatedMemoryInBytes(estimated_size,
+                                                        estimated_count);
+  MallocHooksState::address_map()->Insert(
+      ptr, new AllocationInfo(reinterpret_cast<uword>(ptr), size,
+                              estimated_size, estimated_count, skip_count));
+  address_filter_[AddressFilterIndex(ptr)]++;
+}
+
+void MallocHooksState::RecordFree(const void* ptr) {
+  if ((ptr == NULL) || MallocHooksState::IsLockHeldByCurrentThread()) {
+    return;
+  }
+  // Most frees, in particular when allocations are sampled, are of memory
+  // that was not recorded.
+  if (AtomicOperations::LoadRelaxed(
+          &address_filter_[AddressFilterIndex(ptr)]) == 0) {
+    return;
+  }
+  if (!MallocHooksState::IsOriginalProcess()) {
+    return;
+  }
+
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+  // Now that we hold the lock, check to make sure everything is still active.
+  if (MallocHooksState::Active()) {
+    AllocationInfo* allocation_info = NULL;
+    if (MallocHooksState::address_map()->Lookup(ptr, &allocation_info)) {
+      MallocHooksState::DecrementHeapAllocatedMemoryInBytes(
+          allocation_info->estimated_size(),
+          allocation_info->estimated_count());
+      const bool result = MallocHooksState::address_map()->Remove(ptr);
+      ASSERT(result);
+      delete allocation_info;
+      ASSERT(address_filter_[AddressFilterIndex(ptr)] > 0);
+      address_filter_[AddressFilterIndex(ptr)]--;
+    }
+  }
+}
+
+void MallocHooks::AllocationHook(const void* ptr, size_t size) {
+  MallocHooksState::RecordAllocation(ptr, size, kSkipCount);
+}
+
+void MallocHooks::FreeHook(const void* ptr) {
+  MallocHooksState::RecordFree(ptr);
+}
+
+void MallocHooks::RecordAllocation(const void* ptr, intptr_t size) {
+  if (!FLAG_profiler_native_memory || (size < 0)) {
+    return;
+  }
+  MallocHooksState::RecordAllocation(ptr, size, kRecordAllocationSkipCount);
+}
+
+void MallocHooks::RecordFree(const void* ptr) {
+  if (!FLAG_profiler_native_memory) {
+    return;
+  }
+  MallocHooksState::RecordFree(ptr);
+}
+
+void MallocHooks::InitOnce() {
+  if (!FLAG_profiler_native_memory || MallocHooks::Active()) {
+    return;
+  }
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+  ASSERT(!MallocHooksState::Active());
+
+  MallocHooksState::Init();
+  InstallAllocatorHooks();
+}
+
+void MallocHooks::TearDown() {
+  if (!FLAG_profiler_native_memory || !MallocHooks::Active()) {
+    return;
+  }
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+  ASSERT(MallocHooksState::Active());
+
+  RemoveAllocatorHooks();
+  MallocHooksState::TearDown();
+}
+
+bool MallocHooks::ProfilingEnabled() {
+  return MallocHooksState::ProfilingEnabled();
+}
+
+bool MallocHooks::stack_trace_collection_enabled() {
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+  return MallocHooksState::stack_trace_collection_enabled();
+}
+
+void MallocHooks::set_stack_trace_collection_enabled(bool enabled) {
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+  MallocHooksState::set_stack_trace_collection_enabled(enabled);
+}
+
+void MallocHooks::ResetStats() {
+  if (!FLAG_profiler_native_memory) {
+    return;
+  }
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+  if (MallocHooksState::Active()) {
+    MallocHooksState::ResetStats();
+  }
+}
+
+bool MallocHooks::Active() {
+  if (!FLAG_profiler_native_memory) {
+    return false;
+  }
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+
+  return MallocHooksState::Active();
+}
+
+void MallocHooks::PrintToJSONObject(JSONObject* jsobj) {
+  intptr_t allocated_memory = 0;
+  intptr_t allocation_count = 0;
+  bool add_usage = false;
+  // AddProperty may call malloc which would result in an attempt
+  // to acquire the lock recursively so we extract the values first
+  // and then add the JSON properties.
+  if (FLAG_profiler_native_memory) {
+    MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                    MallocHooksState::malloc_hook_mutex_owner());
+    if (MallocHooksState::Active()) {
+      allocated_memory = MallocHooksState::heap_allocated_memory_in_bytes();
+      allocation_count = MallocHooksState::allocation_count();
+      add_usage = true;
+    }
+  }
+  // Some allocators report their usage cheaply without hooks.
+  if (!add_usage) {
+    add_usage = AllocatorStatistics(&allocated_memory);
+  }
+  if (add_usage) {
+    jsobj->AddProperty("_heapAllocatedMemoryUsage", allocated_memory);
+    jsobj->AddProperty("_heapAllocationCount", allocation_count);
+  }
+}
+
+// The live allocations recorded with one stack trace.
+struct LiveAllocationStack {
+  static const intptr_t kMaxFrames = 16;
+
+  uword pcs[kMaxFrames];
+  intptr_t size;
+  intptr_t count;
+
+  static int CompareStacks(const LiveAllocationStack* a,
+                           const LiveAllocationStack* b) {
+    return memcmp(a->pcs, b->pcs, sizeof(a->pcs));
+  }
+
+  static int CompareSizes(const LiveAllocationStack* a,
+                          const LiveAllocationStack* b) {
+    if (a->size != b->size) {
+      return (a->size > b->size) ? -1 : 1;
+    }
+    return CompareStacks(a, b);
+  }
+};
+
+void MallocHooks::PrintLiveAllocationsJSON(JSONStream* stream,
+                                           intptr_t limit) {
+  MallocGrowableArray<LiveAllocationStack> stacks;
+  intptr_t sample_interval = 0;
+  intptr_t total_size = 0;
+  intptr_t total_count = 0;
+  // Mallocs while the lock is held are not recorded. Symbol lookup and
+  // printing happen after it is released.
+  if (FLAG_profiler_native_memory) {
+    MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                    MallocHooksState::malloc_hook_mutex_owner());
+    if (MallocHooksState::Active()) {
+      sample_interval = MallocHooksState::sample_interval();
+      total_size = MallocHooksState::heap_allocated_memory_in_bytes();
+      total_count = MallocHooksState::allocation_count();
+      AddressMap::Iterator it = MallocHooksState::address_map()->GetIterator();
+      for (AddressMap::Pair* pair = it.Next(); pair != NULL;
+           pair = it.Next()) {
+        LiveAllocationStack stack;
+        memset(stack.pcs, 0, sizeof(stack.pcs));
+        Sample* sample = pair->value->sample();
+        if (sample != NULL) {
+          const intptr_t depth = Utils::Minimum(
+              Sample::pcs_length(), LiveAllocationStack::kMaxFrames);
+          for (intptr_t i = 0; i < depth; i++) {
+            stack.pcs[i] = sample->At(i);
+          }
+        }
+        stack.size = pair->value->estimated_size();
+        stack.count = pair->value->estimated_count();
+        stacks.Add(stack);
+      }
+    }
+  }
+
+  // Merge allocations with the same stack, largest first.
+  stacks.Sort(LiveAllocationStack::CompareStacks);
+  intptr_t num_stacks = 0;
+  for (intptr_t i = 0; i < stacks.length(); i++) {
+    if ((num_stacks > 0) && (LiveAllocationStack::CompareStacks(
+                                 &stacks[num_stacks - 1], &stacks[i]) == 0)) {
+      stacks[num_stacks - 1].size += stacks[i].size;
+      stacks[num_stacks - 1].count += stacks[i].count;
+    } else {
+      stacks[num_stacks++] = stacks[i];
+    }
+  }
+  stacks.SetLength(num_stacks);
+  stacks.Sort(LiveAllocationStack::CompareSizes);
+
+  JSONObject jsobj(stream);
+  jsobj.AddProperty("type", "_NativeAllocationStacks");
+  jsobj.AddProperty("sampleInterval", sample_interval);
+  jsobj.AddProperty("liveBytes", total_size);
+  jsobj.AddProperty("liveCount", total_count);
+  JSONArray jsstacks(&jsobj, "stacks");
+  const intptr_t length =
+      (limit < 0) ? num_stacks : Utils::Minimum(limit, num_stacks);
+  for (intptr_t i = 0; i < length; i++) {
+    JSONObject jsstack(&jsstacks);
+    jsstack.AddProperty("bytes", stacks[i].size);
+    jsstack.AddProperty("count", stacks[i].count);
+    JSONArray jsframes(&jsstack, "frames");
+    for (intptr_t j = 0; j < LiveAllocationStack::kMaxFrames; j++) {
+      const uword pc = stacks[i].pcs[j];
+      if (pc == 0) {
+        break;
+      }
+      uintptr_t start = 0;
+      char* name = NativeSymbolResolver::LookupSymbolName(pc, &start);
+      if (name == NULL) {
+        jsframes.AddValueF("[0x%" Px "]", pc);
+      } else {
+        jsframes.AddValue(name);
+        NativeSymbolResolver::FreeSymbolName(name);
+      }
+    }
+  }
+}
+
+intptr_t MallocHooks::allocation_count() {
+  if (!FLAG_profiler_native_memory) {
+    return 0;
+  }
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+  return MallocHooksState::allocation_count();
+}
+
+intptr_t MallocHooks::heap_allocated_memory_in_bytes() {
+  if (FLAG_profiler_native_memory) {
+    MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                    MallocHooksState::malloc_hook_mutex_owner());
+    if (MallocHooksState::Active()) {
+      return MallocHooksState::heap_allocated_memory_in_bytes();
+    }
+  }
+  intptr_t allocated_memory = 0;
+  if (AllocatorStatistics(&allocated_memory)) {
+    return allocated_memory;
+  }
+  return 0;
+}
+
+Sample* MallocHooks::GetSample(const void* ptr) {
+  MallocLocker ml(MallocHooksState::malloc_hook_mutex(),
+                  MallocHooksState::malloc_hook_mutex_owner());
+
+  ASSERT(MallocHooksState::Active());
+
+  if (ptr != NULL) {
+    AllocationInfo* allocation_info = NULL;
+    if (MallocHooksState::address_map()->Lookup(ptr, &allocation_info)) {
+      ASSERT(allocation_info != NULL);
+      return allocation_info->sample();
+    }
+  }
+  return NULL;
+}
+
+}  // namespace dart
+
+#endif  // !defined(PRODUCT)
@@ -11,6 +11,7 @@
 namespace dart {
 
 class JSONObject;
+class JSONStream;
 class Sample;
 
 // The number of frames that are generated by the malloc hooks and collection
@@ -35,6 +36,26 @@ class MallocHooks : public AllStatic {
 
   static intptr_t allocation_count();
   static intptr_t heap_allocated_memory_in_bytes();
+
+  // Record allocations and frees the allocator's hooks do not see, e.g. all
+  // of them with allocators that have none. See Dart_RecordNativeAllocation.
+  static void RecordAllocation(const void* ptr, intptr_t size);
+  static void RecordFree(const void* ptr);
+
+  // Prints the live recorded allocations grouped by their stack traces,
+  // at most 'limit' stacks with the most bytes, or all if it is negative.
+  static void PrintLiveAllocationsJSON(JSONStream* stream, intptr_t limit);
+
+ private:
+  // Called by the allocator's hooks, if it has any.
+  static void AllocationHook(const void* ptr, size_t size);
+  static void FreeHook(const void* ptr);
+
+  // Implemented in malloc_hooks_<allocator>.cc.
+  static void InstallAllocatorHooks();
+  static void RemoveAllocatorHooks();
+  // Returns false if the allocator cannot report its usage without hooks.
+  static bool AllocatorStatistics(intptr_t* allocated_bytes);
 };
 
 }  // namespace dart
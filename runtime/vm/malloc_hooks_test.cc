@@ -16,6 +16,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(int, native_memory_sample_interval);
+
 static void MallocHookTestBufferInitializer(volatile char* buffer,
                                             uintptr_t size) {
   // Run through the buffer and do something. If we don't do this and the memory
@@ -112,6 +114,33 @@ UNIT_TEST_CASE(FreeUnseenMemoryMallocHookTest) {
   EXPECT_EQ(0L, MallocHooks::heap_allocated_memory_in_bytes());
 }
 
+static const intptr_t kSampledBufferCount = 4096;
+static char* sampled_buffers[kSampledBufferCount];
+
+UNIT_TEST_CASE(SampledMallocHookTest) {
+  SetFlagScope<int> sfs(&FLAG_native_memory_sample_interval, 16);
+  EnableMallocHooksScope scope;
+
+  // 4MB in 1KB buffers, about 256 of which are sampled.
+  const intptr_t buffer_size = 1 * KB;
+  for (intptr_t i = 0; i < kSampledBufferCount; i++) {
+    sampled_buffers[i] = new char[buffer_size];
+    MallocHookTestBufferInitializer(sampled_buffers[i], buffer_size);
+  }
+  const intptr_t allocated = kSampledBufferCount * buffer_size;
+  EXPECT(MallocHooks::heap_allocated_memory_in_bytes() > allocated / 2);
+  EXPECT(MallocHooks::heap_allocated_memory_in_bytes() < allocated * 2);
+  EXPECT(MallocHooks::allocation_count() > kSampledBufferCount / 2);
+  EXPECT(MallocHooks::allocation_count() < kSampledBufferCount * 2);
+
+  // Frees remove exactly what the sampled allocations were recorded for.
+  for (intptr_t i = 0; i < kSampledBufferCount; i++) {
+    delete[] sampled_buffers[i];
+  }
+  EXPECT_EQ(0L, MallocHooks::allocation_count());
+  EXPECT_EQ(0L, MallocHooks::heap_allocated_memory_in_bytes());
+}
+
 VM_UNIT_TEST_CASE(StackTraceMallocHookSimpleTest) {
   EnableMallocHooksAndStacksScope scope;
 
@@ -11,6 +11,8 @@
 
 namespace dart {
 
+#if defined(PRODUCT)
+
 void MallocHooks::InitOnce() {
   // Do nothing.
 }
@@ -55,6 +57,32 @@ intptr_t MallocHooks::heap_allocated_memory_in_bytes() {
   return 0;
 }
 
+void MallocHooks::RecordAllocation(const void* ptr, intptr_t size) {
+  // Do nothing.
+}
+
+void MallocHooks::RecordFree(const void* ptr) {
+  // Do nothing.
+}
+
+#else  // defined(PRODUCT)
+
+// The system allocator has no portable allocation hooks. Allocations are
+// only recorded when they are reported with Dart_RecordNativeAllocation.
+void MallocHooks::InstallAllocatorHooks() {
+  // Do nothing.
+}
+
+void MallocHooks::RemoveAllocatorHooks() {
+  // Do nothing.
+}
+
+bool MallocHooks::AllocatorStatistics(intptr_t* allocated_bytes) {
+  return false;
+}
+
+#endif  // defined(PRODUCT)
+
 }  // namespace dart
 
 #endif  // !defined(DART_USE_TCMALLOC) && ...
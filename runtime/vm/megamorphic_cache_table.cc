@@ -5,6 +5,7 @@
 #include "vm/megamorphic_cache_table.h"
 
 #include <stdlib.h>
+#include "vm/dart_entry.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
 #include "vm/stub_code.h"
@@ -38,10 +39,88 @@ RawMegamorphicCache* MegamorphicCacheTable::Lookup(Isolate* isolate,
   }
 
   cache = MegamorphicCache::New(name, descriptor);
+  AttachDispatchTableRow(isolate, cache);
   table.Add(cache, Heap::kOld);
   return cache.raw();
 }
 
+void MegamorphicCacheTable::AttachDispatchTableRow(
+    Isolate* isolate,
+    const MegamorphicCache& cache) {
+  ObjectStore* object_store = isolate->object_store();
+  if (object_store->dispatch_table() == Array::null()) {
+    return;
+  }
+  Zone* zone = Thread::Current()->zone();
+  const ArgumentsDescriptor args_desc(
+      Array::Handle(zone, cache.arguments_descriptor()));
+  if ((args_desc.TypeArgsLen() != 0) || (args_desc.NamedCount() != 0)) {
+    return;
+  }
+
+  const Array& selectors =
+      Array::Handle(zone, object_store->dispatch_table_selectors());
+  const String& name = String::Handle(zone, cache.target_name());
+  const intptr_t hash = name.Hash();
+  const intptr_t num_selectors =
+      selectors.Length() / kDispatchSelectorEntryLength;
+  String& other = String::Handle(zone);
+
+  // Binary search for the first selector with the same name hash.
+  intptr_t lo = 0;
+  intptr_t hi = num_selectors;
+  while (lo < hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    other ^= selectors.At(mid * kDispatchSelectorEntryLength +
+                          kDispatchSelectorNameIndex);
+    if (other.Hash() < hash) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  for (intptr_t i = lo; i < num_selectors; i++) {
+    const intptr_t base = i * kDispatchSelectorEntryLength;
+    other ^= selectors.At(base + kDispatchSelectorNameIndex);
+    if (other.Hash() != hash) {
+      break;
+    }
+    if (other.raw() != name.raw()) {
+      continue;
+    }
+    const intptr_t num_args = Smi::Value(
+        Smi::RawCast(selectors.At(base + kDispatchSelectorNumArgsIndex)));
+    if (num_args != args_desc.Count()) {
+      continue;
+    }
+    const intptr_t row = Smi::Value(
+        Smi::RawCast(selectors.At(base + kDispatchSelectorRowIndex)));
+    cache.set_dispatch_table_row(
+        Array::Handle(zone, object_store->dispatch_table()), row);
+    return;
+  }
+}
+
+void MegamorphicCacheTable::InsertICDataTargets(const MegamorphicCache& cache,
+                                                const ICData& ic_data) {
+  ASSERT(ic_data.NumArgsTested() == 1);
+  Zone* zone = Thread::Current()->zone();
+  Smi& class_id = Smi::Handle(zone);
+  Function& target = Function::Handle(zone);
+  const intptr_t number_of_checks = ic_data.NumberOfChecks();
+  for (intptr_t i = 0; i < number_of_checks; i++) {
+    const intptr_t cid = ic_data.GetReceiverClassIdAt(i);
+    if (cache.Contains(cid)) {
+      continue;
+    }
+    class_id = Smi::New(cid);
+    target = ic_data.GetTargetAt(i);
+    cache.EnsureCapacity();
+    cache.Insert(class_id, target);
+  }
+}
+
 RawFunction* MegamorphicCacheTable::miss_handler(Isolate* isolate) {
   ASSERT(isolate->object_store()->megamorphic_miss_function() !=
          Function::null());
@@ -102,6 +181,39 @@ void MegamorphicCacheTable::PrintSizes(Isolate* isolate) {
   OS::PrintErr("%" Pd " megamorphic caches using %" Pd "KB.\n", table.Length(),
                size / 1024);
 
+  // The caches missing most often, which are the ones still filling up.
+  const intptr_t kMaxPrintedCaches = 20;
+  GrowableArray<intptr_t> by_misses(table.Length());
+  for (intptr_t i = 0; i < table.Length(); i++) {
+    cache ^= table.At(i);
+    if (cache.miss_count() > 0) {
+      by_misses.Add(i);
+    }
+  }
+  String& name = String::Handle();
+  MegamorphicCache& other = MegamorphicCache::Handle();
+  const intptr_t printed =
+      Utils::Minimum(by_misses.length(), kMaxPrintedCaches);
+  for (intptr_t i = 0; i < printed; i++) {
+    // Selection sort of the first few, descending by miss count.
+    intptr_t max = i;
+    for (intptr_t j = i + 1; j < by_misses.length(); j++) {
+      cache ^= table.At(by_misses[j]);
+      other ^= table.At(by_misses[max]);
+      if (cache.miss_count() > other.miss_count()) {
+        max = j;
+      }
+    }
+    const intptr_t index = by_misses[max];
+    by_misses[max] = by_misses[i];
+    by_misses[i] = index;
+    cache ^= table.At(index);
+    name = cache.target_name();
+    OS::PrintErr("Megamorphic cache %s: %" Pd " entries, %" Pd " misses\n",
+                 name.ToCString(), cache.filled_entry_count(),
+                 cache.miss_count());
+  }
+
   intptr_t* probe_counts = new intptr_t[max_size];
   intptr_t entry_count = 0;
   intptr_t max_probe_count = 0;
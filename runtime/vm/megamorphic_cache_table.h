@@ -11,7 +11,9 @@ namespace dart {
 
 class Array;
 class Function;
+class ICData;
 class Isolate;
+class MegamorphicCache;
 class ObjectPointerVisitor;
 class RawArray;
 class RawFunction;
@@ -29,6 +31,35 @@ class MegamorphicCacheTable : public AllStatic {
                                      const String& name,
                                      const Array& descriptor);
 
+  // The AOT global dispatch table is an array of (row, target function)
+  // entries indexed by row + receiver class id. An entry belongs to the
+  // selector whose row it holds; entries of other selectors and holes miss.
+  enum {
+    kDispatchTableRowIndex,
+    kDispatchTableTargetIndex,
+    kDispatchTableEntryLength,
+  };
+
+  // Selectors with a row in the dispatch table are recorded as (name,
+  // number of arguments, row) entries sorted by the hash of their name.
+  enum {
+    kDispatchSelectorNameIndex,
+    kDispatchSelectorNumArgsIndex,
+    kDispatchSelectorRowIndex,
+    kDispatchSelectorEntryLength,
+  };
+
+  // Makes [cache] use the row of its selector in the dispatch table, if the
+  // selector has one and the cache's arguments descriptor matches it.
+  static void AttachDispatchTableRow(Isolate* isolate,
+                                     const MegamorphicCache& cache);
+
+  // Inserts the receiver class ids and targets of [ic_data], a call site
+  // switching to [cache], so that the classes the call site has already
+  // seen do not miss again. Must run on the mutator thread.
+  static void InsertICDataTargets(const MegamorphicCache& cache,
+                                  const ICData& ic_data);
+
   static void PrintSizes(Isolate* isolate);
 };
 
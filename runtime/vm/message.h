@@ -62,6 +62,7 @@ class Message {
   ~Message();
 
   Dart_Port dest_port() const { return dest_port_; }
+  Dart_Port delivery_failure_port() const { return delivery_failure_port_; }
 
   uint8_t* snapshot() const {
     ASSERT(!IsRaw());
@@ -120,6 +121,10 @@ class MessageQueue {
   // message is available.  This function will not block.
   Message* Dequeue();
 
+  // Returns the next message without removing it, or NULL if the queue is
+  // empty.
+  Message* Peek() const { return head_; }
+
   bool IsEmpty() { return head_ == NULL; }
 
   // Clear all messages from the message queue.
@@ -143,7 +148,9 @@ class MessageQueue {
     Message* next_;
   };
 
-  intptr_t Length() const;
+  // Can be read without the lock of the owning MessageHandler, e.g. for
+  // metrics, in which case it may be stale.
+  intptr_t Length() const { return length_; }
 
   // Returns the message with id or NULL.
   Message* FindMessageById(intptr_t id);
@@ -153,6 +160,7 @@ class MessageQueue {
  private:
   Message* head_;
   Message* tail_;
+  intptr_t length_;
 
   DISALLOW_COPY_AND_ASSIGN(MessageQueue);
 };
@@ -5,6 +5,7 @@
 #include "vm/message_handler.h"
 
 #include "vm/dart.h"
+#include "vm/heap/heap.h"
 #include "vm/lockers.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
@@ -55,6 +56,7 @@ MessageHandler::MessageHandler()
       oob_queue_(new MessageQueue()),
       oob_message_handling_allowed_(true),
       paused_for_messages_(false),
+      batching_allowed_(false),
       live_ports_(0),
       paused_(0),
 #if !defined(PRODUCT)
@@ -118,13 +120,14 @@ void MessageHandler::Run(ThreadPool* pool,
   end_callback_ = end_callback;
   callback_data_ = data;
   task_ = new MessageHandlerTask(this);
-  task_running = pool_->Run(task_);
+  task_running = pool_->Run(task_, this);
   ASSERT(task_running);
 }
 
 void MessageHandler::PostMessage(Message* message, bool before_events) {
   Message::Priority saved_priority;
   bool task_running = true;
+  bool task_pending = false;
   {
     MonitorLocker ml(&monitor_);
     if (FLAG_trace_isolates) {
@@ -162,12 +165,19 @@ void MessageHandler::PostMessage(Message* message, bool before_events) {
     if ((pool_ != NULL) && (task_ == NULL)) {
       ASSERT(!delete_me_);
       task_ = new MessageHandlerTask(this);
-      task_running = pool_->Run(task_);
+      task_running = pool_->Run(task_, this);
+    } else {
+      task_pending = (pool_ != NULL);
     }
   }
   ASSERT(task_running);
 
-  // Invoke any custom message notification.
+  // Invoke any custom message notification. A normal message posted while a
+  // task is already scheduled will be picked up by that task, so repeated
+  // notifications are coalesced into the one that scheduled it.
+  if (task_pending && (saved_priority == Message::kNormalPriority)) {
+    return;
+  }
   MessageNotify(saved_priority);
 }
 
@@ -175,7 +185,7 @@ void MessageHandler::EnsureTaskForIdleCheck() {
   MonitorLocker ml(&monitor_);
   if ((pool_ != NULL) && (task_ == NULL)) {
     task_ = new MessageHandlerTask(this);
-    bool task_running = pool_->Run(task_);
+    bool task_running = pool_->Run(task_, this);
     if (!task_running) {
       OS::PrintErr("Failed to start idle wakeup\n");
       delete task_;
@@ -193,6 +203,19 @@ Message* MessageHandler::DequeueMessage(Message::Priority min_priority) {
   return message;
 }
 
+Message* MessageHandler::DequeueBatchableMessage() {
+  MonitorLocker ml(&monitor_);
+  if (!batching_allowed_ || paused() || !oob_queue_->IsEmpty()) {
+    return NULL;
+  }
+  Message* message = queue_->Peek();
+  if ((message == NULL) || (message->dest_port() == Message::kIllegalPort) ||
+      (message->delivery_failure_port() != Message::kIllegalPort)) {
+    return NULL;
+  }
+  return queue_->Dequeue();
+}
+
 void MessageHandler::ClearOOBQueue() {
   oob_queue_->Clear();
 }
@@ -228,7 +251,9 @@ MessageHandler::MessageStatus MessageHandler::HandleMessages(
     ml->Exit();
     Message::Priority saved_priority = message->priority();
     Dart_Port saved_dest_port = message->dest_port();
+    batching_allowed_ = allow_multiple_normal_messages;
     MessageStatus status = HandleMessage(message);
+    batching_allowed_ = false;
     if (status > max_status) {
       max_status = status;
     }
@@ -363,6 +388,12 @@ bool MessageHandler::HasOOBMessages() {
 
 void MessageHandler::TaskCallback() {
   ASSERT(Isolate::Current() == NULL);
+  if (FLAG_numa_aware_heap && (isolate() != NULL) &&
+      (isolate()->heap() != NULL)) {
+    // Pool threads take turns running the handler, so follow the isolate to
+    // wherever it runs now.
+    isolate()->heap()->set_numa_node(OSThread::GetCurrentNumaNode());
+  }
   MessageStatus status = kOK;
   bool run_end_callback = false;
   bool delete_me = false;
@@ -75,6 +75,21 @@ class MessageHandler {
   // handler.
   bool HasOOBMessages();
 
+  // Dequeues the next normal priority message so that it can be delivered
+  // in the same batch as the message currently being handled. Returns NULL
+  // if batching is not allowed right now (OOB messages are pending, the
+  // handler is paused, or the caller asked for a single normal message) or
+  // if the next message is not a plain port message.
+  //
+  // Only called while HandleMessage runs, on the thread handling messages.
+  Message* DequeueBatchableMessage();
+
+  // Returns the number of messages waiting to be handled. Does not take the
+  // monitor, so the result may be stale.
+  intptr_t PendingMessageCount() const {
+    return queue_->Length() + oob_queue_->Length();
+  }
+
   // A message handler tracks how many live ports it has.
   bool HasLivePorts() const { return live_ports_ > 0; }
 
@@ -238,6 +253,9 @@ class MessageHandler {
   // thread.
   bool oob_message_handling_allowed_;
   bool paused_for_messages_;
+  // Whether HandleMessage may pull further normal messages off the queue.
+  // Only accessed by the thread handling messages.
+  bool batching_allowed_;
   intptr_t live_ports_;  // The number of open ports, including control ports.
   intptr_t paused_;      // The number of pause messages received.
 #if !defined(PRODUCT)
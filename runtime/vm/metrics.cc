@@ -6,12 +6,16 @@
 
 #include "vm/metrics.h"
 
+#include "platform/text_buffer.h"
+#include "vm/dart.h"
 #include "vm/isolate.h"
 #include "vm/json_stream.h"
 #include "vm/log.h"
+#include "vm/message_handler.h"
 #include "vm/native_entry.h"
 #include "vm/object.h"
 #include "vm/runtime_entry.h"
+#include "vm/thread_pool.h"
 
 namespace dart {
 
@@ -99,6 +103,128 @@ void Metric::PrintJSON(JSONStream* stream) {
   // TODO(johnmccutchan): Overflow?
   double value_as_double = static_cast<double>(Value());
   obj.AddProperty("value", value_as_double);
+  PrintPropertiesJSON(&obj);
+}
+
+static const char* OpenMetricsUnit(Metric::Unit unit) {
+  switch (unit) {
+    case Metric::kCounter:
+      return NULL;
+    case Metric::kByte:
+      return "bytes";
+    case Metric::kMicrosecond:
+      return "microseconds";
+  }
+  UNREACHABLE();
+  return NULL;
+}
+
+// Prints the metric family name for 'metric', e.g. dart_heap_old_used_bytes
+// for heap.old.used.
+static void PrintOpenMetricsName(TextBuffer* buffer, Metric* metric) {
+  buffer->AddString("dart_");
+  for (const char* c = metric->name(); *c != '\0'; c++) {
+    const bool valid = ((*c >= 'a') && (*c <= 'z')) ||
+                       ((*c >= 'A') && (*c <= 'Z')) ||
+                       ((*c >= '0') && (*c <= '9'));
+    buffer->AddChar(valid ? *c : '_');
+  }
+  const char* unit = OpenMetricsUnit(metric->unit());
+  if (unit != NULL) {
+    buffer->Printf("_%s", unit);
+  }
+}
+
+static void PrintOpenMetricsFamily(TextBuffer* buffer,
+                                   Metric* metric,
+                                   const char* name,
+                                   const char* type) {
+  buffer->Printf("# TYPE %s %s\n", name, type);
+  const char* unit = OpenMetricsUnit(metric->unit());
+  if (unit != NULL) {
+    buffer->Printf("# UNIT %s %s\n", name, unit);
+  }
+  if (metric->description() != NULL) {
+    buffer->Printf("# HELP %s %s\n", name, metric->description());
+  }
+}
+
+void Metric::PrintOpenMetricsSamples(TextBuffer* buffer,
+                                     const char* name,
+                                     const char* labels) {
+  if (labels[0] == '\0') {
+    buffer->Printf("%s %" Pd64 "\n", name, Value());
+  } else {
+    buffer->Printf("%s{%s} %" Pd64 "\n", name, labels, Value());
+  }
+}
+
+// Prints one family of isolate metrics, with a sample for each isolate.
+class OpenMetricsIsolateVisitor : public IsolateVisitor {
+ public:
+  OpenMetricsIsolateVisitor(TextBuffer* buffer, const char* metric_name)
+      : buffer_(buffer), metric_name_(metric_name), name_(NULL) {}
+
+  ~OpenMetricsIsolateVisitor() { free(name_); }
+
+  void VisitIsolate(Isolate* isolate) {
+    Metric* metric = isolate->metrics_list_head();
+    while ((metric != NULL) && (strcmp(metric->name(), metric_name_) != 0)) {
+      metric = metric->next();
+    }
+    if (metric == NULL) {
+      return;
+    }
+    if (name_ == NULL) {
+      TextBuffer name(64);
+      PrintOpenMetricsName(&name, metric);
+      name_ = name.Steal();
+      PrintOpenMetricsFamily(buffer_, metric, name_,
+                             metric->OpenMetricsType());
+    }
+    TextBuffer labels(64);
+    labels.AddString("isolate=\"");
+    for (const char* c = isolate->name(); *c != '\0'; c++) {
+      if ((*c == '"') || (*c == '\\')) {
+        labels.AddChar('\\');
+        labels.AddChar(*c);
+      } else if (*c == '\n') {
+        labels.AddString("\\n");
+      } else {
+        labels.AddChar(*c);
+      }
+    }
+    labels.Printf("\",isolate_id=\"%" Pd64 "\"",
+                  static_cast<int64_t>(isolate->main_port()));
+    metric->PrintOpenMetricsSamples(buffer_, name_, labels.buf());
+  }
+
+ private:
+  TextBuffer* buffer_;
+  const char* metric_name_;
+  char* name_;
+};
+
+static const char* const kIsolateMetricNames[] = {
+#define ISOLATE_METRIC_NAME(type, variable, name, unit) name,
+    ISOLATE_METRIC_LIST(ISOLATE_METRIC_NAME)
+#undef ISOLATE_METRIC_NAME
+};
+
+void Metric::PrintOpenMetrics(TextBuffer* buffer) {
+  for (Metric* metric = vm_head(); metric != NULL; metric = metric->next()) {
+    TextBuffer name(64);
+    PrintOpenMetricsName(&name, metric);
+    PrintOpenMetricsFamily(buffer, metric, name.buf(),
+                           metric->OpenMetricsType());
+    metric->PrintOpenMetricsSamples(buffer, name.buf(), "");
+  }
+  // OpenMetrics requires the samples of a family to be contiguous.
+  for (intptr_t i = 0; i < ARRAY_SIZE(kIsolateMetricNames); i++) {
+    OpenMetricsIsolateVisitor visitor(buffer, kIsolateMetricNames[i]);
+    Isolate::VisitIsolates(&visitor);
+  }
+  buffer->AddString("# EOF\n");
 }
 #endif  // !PRODUCT
 
@@ -249,38 +375,34 @@ void Metric::DeregisterWithVM() {
   UNREACHABLE();
 }
 
+// The heap metrics may also be read from other threads by PrintOpenMetrics.
+// They only read sizes, which are at worst stale.
+
 int64_t MetricHeapOldUsed::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->UsedInWords(Heap::kOld) * kWordSize;
 }
 
 int64_t MetricHeapOldCapacity::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->CapacityInWords(Heap::kOld) * kWordSize;
 }
 
 int64_t MetricHeapOldExternal::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->ExternalInWords(Heap::kOld) * kWordSize;
 }
 
 int64_t MetricHeapNewUsed::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->UsedInWords(Heap::kNew) * kWordSize;
 }
 
 int64_t MetricHeapNewCapacity::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->CapacityInWords(Heap::kNew) * kWordSize;
 }
 
 int64_t MetricHeapNewExternal::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->ExternalInWords(Heap::kNew) * kWordSize;
 }
 
 int64_t MetricHeapUsed::Value() const {
-  ASSERT(isolate() == Isolate::Current());
   return isolate()->heap()->UsedInWords(Heap::kNew) * kWordSize +
          isolate()->heap()->UsedInWords(Heap::kOld) * kWordSize;
 }
@@ -297,6 +419,21 @@ int64_t MetricPeakRSS::Value() const {
   return Service::MaxRSS();
 }
 
+int64_t MetricMessageQueueLength::Value() const {
+  MessageHandler* handler = isolate()->message_handler();
+  return (handler == NULL) ? 0 : handler->PendingMessageCount();
+}
+
+int64_t MetricThreadPoolRunning::Value() const {
+  ThreadPool* pool = Dart::thread_pool();
+  return (pool == NULL) ? 0 : pool->workers_running();
+}
+
+int64_t MetricThreadPoolIdle::Value() const {
+  ThreadPool* pool = Dart::thread_pool();
+  return (pool == NULL) ? 0 : pool->workers_idle();
+}
+
 #define VM_METRIC_VARIABLE(type, variable, name, unit)                         \
   static type vm_metric_##variable##_;
 VM_METRIC_LIST(VM_METRIC_VARIABLE);
@@ -343,6 +480,97 @@ void MinMetric::SetValue(int64_t new_value) {
   }
 }
 
+HistogramMetric::HistogramMetric() : Metric() {
+  Reset();
+}
+
+void HistogramMetric::Record(int64_t value) {
+  ASSERT(value >= 0);
+  intptr_t i = 0;
+  while ((i < kNumBuckets - 1) && (value >= BucketLimit(i))) {
+    i++;
+  }
+  buckets_[i]++;
+  count_++;
+  if (value > max_) {
+    max_ = value;
+  }
+  set_value(this->value() + value);
+}
+
+void HistogramMetric::Reset() {
+  count_ = 0;
+  max_ = 0;
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    buckets_[i] = 0;
+  }
+  set_value(0);
+}
+
+int64_t HistogramMetric::Percentile(intptr_t percent) const {
+  ASSERT((percent >= 0) && (percent <= 100));
+  if (count_ == 0) {
+    return 0;
+  }
+  // The rank of the value, counting from 1.
+  int64_t rank = (count_ * percent + 99) / 100;
+  if (rank == 0) {
+    rank = 1;
+  }
+  int64_t seen = 0;
+  for (intptr_t i = 0; i < kNumBuckets - 1; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      // The bucket limit is exclusive, but never report more than the max.
+      return Utils::Minimum(BucketLimit(i) - 1, max_);
+    }
+  }
+  return max_;
+}
+
+#ifndef PRODUCT
+void HistogramMetric::PrintPropertiesJSON(JSONObject* obj) {
+  obj->AddProperty64("count", count_);
+  obj->AddProperty64("max", max_);
+  obj->AddProperty64("p50", Percentile(50));
+  obj->AddProperty64("p90", Percentile(90));
+  obj->AddProperty64("p99", Percentile(99));
+  JSONArray buckets(obj, "buckets");
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    if (buckets_[i] == 0) {
+      continue;
+    }
+    JSONObject bucket(&buckets);
+    if (i < kNumBuckets - 1) {
+      bucket.AddProperty64("limit", BucketLimit(i));
+    }
+    bucket.AddProperty64("count", buckets_[i]);
+  }
+}
+
+void HistogramMetric::PrintOpenMetricsSamples(TextBuffer* buffer,
+                                              const char* name,
+                                              const char* labels) {
+  const char* separator = (labels[0] == '\0') ? "" : ",";
+  // OpenMetrics buckets are cumulative and their bounds are inclusive.
+  int64_t cumulative_count = 0;
+  for (intptr_t i = 0; i < kNumBuckets - 1; i++) {
+    cumulative_count += buckets_[i];
+    buffer->Printf("%s_bucket{%s%sle=\"%" Pd64 "\"} %" Pd64 "\n", name, labels,
+                   separator, BucketLimit(i) - 1, cumulative_count);
+  }
+  buffer->Printf("%s_bucket{%s%sle=\"+Inf\"} %" Pd64 "\n", name, labels,
+                 separator, count_);
+  if (labels[0] == '\0') {
+    buffer->Printf("%s_count %" Pd64 "\n", name, count_);
+    buffer->Printf("%s_sum %" Pd64 "\n", name, value());
+  } else {
+    buffer->Printf("%s_count{%s} %" Pd64 "\n", name, labels, count_);
+    buffer->Printf("%s_sum{%s} %" Pd64 "\n", name, labels, value());
+  }
+}
+#endif  // !PRODUCT
+
 }  // namespace dart
 
 #endif  // !defined(PRODUCT)
@@ -5,12 +5,34 @@
 #ifndef RUNTIME_VM_METRICS_H_
 #define RUNTIME_VM_METRICS_H_
 
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 
 namespace dart {
 
 class Isolate;
+class JSONObject;
 class JSONStream;
+class TextBuffer;
+
+// Histograms of the time spent in each phase of the collections, including
+// the time to bring all threads to a safepoint, and of the bytes promoted by
+// each scavenge. With parallel scavenging, roots and store buffers are
+// processed together with the to-space and accounted to gc.new.tospace.
+#define ISOLATE_GC_HISTOGRAM_LIST(V)                                           \
+  V(HistogramMetric, GCNewPause, "gc.new.pause", kMicrosecond)                 \
+  V(HistogramMetric, GCNewSafepoint, "gc.new.safepoint", kMicrosecond)         \
+  V(HistogramMetric, GCNewRoots, "gc.new.roots", kMicrosecond)                 \
+  V(HistogramMetric, GCNewStoreBuffer, "gc.new.storebuffer", kMicrosecond)     \
+  V(HistogramMetric, GCNewToSpace, "gc.new.tospace", kMicrosecond)             \
+  V(HistogramMetric, GCNewWeaks, "gc.new.weaks", kMicrosecond)                 \
+  V(HistogramMetric, GCNewPromoted, "gc.new.promoted", kByte)                  \
+  V(HistogramMetric, GCOldPause, "gc.old.pause", kMicrosecond)                 \
+  V(HistogramMetric, GCOldSafepoint, "gc.old.safepoint", kMicrosecond)         \
+  V(HistogramMetric, GCOldMark, "gc.old.mark", kMicrosecond)                   \
+  V(HistogramMetric, GCOldWeaks, "gc.old.weaks", kMicrosecond)                 \
+  V(HistogramMetric, GCOldSweep, "gc.old.sweep", kMicrosecond)                 \
+  V(HistogramMetric, GCOldCompact, "gc.old.compact", kMicrosecond)
 
 // Metrics for each isolate.
 #define ISOLATE_METRIC_LIST(V)                                                 \
@@ -27,12 +49,23 @@ class JSONStream;
   V(MetricHeapUsed, HeapGlobalUsed, "heap.global.used", kByte)                 \
   V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)               \
   V(Metric, RunnableLatency, "isolate.runnable.latency", kMicrosecond)         \
-  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)
+  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)                  \
+  V(MetricMessageQueueLength, MessageQueueLength, "isolate.messages.pending",  \
+    kCounter)                                                                  \
+  V(Metric, CompiledUnoptimized, "compiler.unoptimized", kCounter)             \
+  V(Metric, CompiledOptimized, "compiler.optimized", kCounter)                 \
+  V(Metric, Deoptimizations, "compiler.deoptimizations", kCounter)             \
+  V(Metric, SubtypeTestCacheMisses, "typecheck.cache.misses", kCounter)        \
+  V(Metric, SubtypeTestCacheFull, "typecheck.cache.full", kCounter)            \
+  ISOLATE_GC_HISTOGRAM_LIST(V)
 
 #define VM_METRIC_LIST(V)                                                      \
   V(MetricIsolateCount, IsolateCount, "vm.isolate.count", kCounter)            \
   V(MetricCurrentRSS, CurrentRSS, "vm.memory.current", kByte)                  \
-  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)
+  V(MetricPeakRSS, PeakRSS, "vm.memory.max", kByte)                            \
+  V(MetricThreadPoolRunning, ThreadPoolRunning, "vm.threadpool.running",       \
+    kCounter)                                                                  \
+  V(MetricThreadPoolIdle, ThreadPoolIdle, "vm.threadpool.idle", kCounter)
 
 class Metric {
  public:
@@ -61,6 +94,14 @@ class Metric {
 
 #ifndef PRODUCT
   void PrintJSON(JSONStream* stream);
+
+  // Prints the VM metrics and the metrics of all isolates in the OpenMetrics
+  // text format (https://openmetrics.io), e.g. heap.old.used as
+  // dart_heap_old_used_bytes{isolate="main",isolate_id="1234"}. Isolates are
+  // kept alive by holding the isolate list lock, but their metrics are read
+  // without synchronizing with the isolates, so values may be slightly
+  // stale. Can be called from any thread.
+  static void PrintOpenMetrics(TextBuffer* buffer);
 #endif  // !PRODUCT
 
   // Returns a zone allocated string.
@@ -74,6 +115,9 @@ class Metric {
 
   void increment() { value_++; }
 
+  // For metrics updated by several threads.
+  void AtomicIncrement() { AtomicOperations::IncrementInt64By(&value_, 1); }
+
   Metric* next() const { return next_; }
   void set_next(Metric* next) { next_ = next; }
 
@@ -91,6 +135,18 @@ class Metric {
   // Use this for metrics that produce their value on demand.
   virtual int64_t Value() const { return value(); }
 
+#ifndef PRODUCT
+  // Override to add properties beyond the value to the JSON.
+  virtual void PrintPropertiesJSON(JSONObject* obj) {}
+
+  // Override to print samples other than the value. 'name' is the metric
+  // family name and 'labels' the labels of the metric, without braces.
+  virtual void PrintOpenMetricsSamples(TextBuffer* buffer,
+                                       const char* name,
+                                       const char* labels);
+  virtual const char* OpenMetricsType() const { return "gauge"; }
+#endif  // !PRODUCT
+
  private:
   Isolate* isolate_;
   const char* name_;
@@ -107,6 +163,10 @@ class Metric {
   void DeregisterWithVM();
 
   static Metric* vm_list_head_;
+
+#ifndef PRODUCT
+  friend class OpenMetricsIsolateVisitor;
+#endif  // !PRODUCT
   DISALLOW_COPY_AND_ASSIGN(Metric);
 };
 
@@ -128,6 +188,50 @@ class MinMetric : public Metric {
   void SetValue(int64_t new_value);
 };
 
+// A Metric class that accumulates a histogram of the values recorded with
+// Record(). Bucket i counts the values below 2^i that did not fit in a
+// smaller bucket; the last bucket also counts all larger values. The reported
+// value is the sum of all recorded values.
+class HistogramMetric : public Metric {
+ public:
+  static const intptr_t kNumBuckets = 40;
+
+  HistogramMetric();
+
+  void Record(int64_t value);
+  void Reset();
+
+  int64_t count() const { return count_; }
+  int64_t max() const { return max_; }
+  int64_t bucket(intptr_t i) const {
+    ASSERT((i >= 0) && (i < kNumBuckets));
+    return buckets_[i];
+  }
+
+  // The exclusive upper bound of the values in bucket i.
+  static int64_t BucketLimit(intptr_t i) {
+    return static_cast<int64_t>(1) << i;
+  }
+
+  // An upper bound for the given percentage of the recorded values, i.e. the
+  // limit of the bucket that contains the value at that rank.
+  int64_t Percentile(intptr_t percent) const;
+
+ protected:
+#ifndef PRODUCT
+  virtual void PrintPropertiesJSON(JSONObject* obj);
+  virtual void PrintOpenMetricsSamples(TextBuffer* buffer,
+                                       const char* name,
+                                       const char* labels);
+  virtual const char* OpenMetricsType() const { return "histogram"; }
+#endif  // !PRODUCT
+
+ private:
+  int64_t count_;
+  int64_t max_;
+  int64_t buckets_[kNumBuckets];
+};
+
 class MetricHeapOldUsed : public Metric {
  protected:
   virtual int64_t Value() const;
@@ -178,6 +282,21 @@ class MetricHeapUsed : public Metric {
   virtual int64_t Value() const;
 };
 
+class MetricMessageQueueLength : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricThreadPoolRunning : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
+class MetricThreadPoolIdle : public Metric {
+ protected:
+  virtual int64_t Value() const;
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_METRICS_H_
@@ -71,6 +71,68 @@ VM_UNIT_TEST_CASE(Metric_OnDemand) {
   Dart_ShutdownIsolate();
 }
 
+VM_UNIT_TEST_CASE(Metric_Histogram) {
+  TestCase::CreateTestIsolate();
+  {
+    Thread* thread = Thread::Current();
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+    HistogramMetric metric;
+    metric.Init(Isolate::Current(), "a.b.c", "foobar", Metric::kMicrosecond);
+    EXPECT_EQ(0, metric.count());
+    EXPECT_EQ(0, metric.Percentile(50));
+
+    metric.Record(0);
+    metric.Record(1);
+    metric.Record(3);
+    metric.Record(100);
+    EXPECT_EQ(4, metric.count());
+    EXPECT_EQ(104, metric.value());
+    EXPECT_EQ(100, metric.max());
+    EXPECT_EQ(1, metric.bucket(0));  // [0, 1)
+    EXPECT_EQ(1, metric.bucket(1));  // [1, 2)
+    EXPECT_EQ(1, metric.bucket(2));  // [2, 4)
+    EXPECT_EQ(1, metric.bucket(7));  // [64, 128)
+    EXPECT_EQ(1, metric.Percentile(50));
+    EXPECT_EQ(100, metric.Percentile(99));
+
+    // Values beyond the last limit land in the last bucket.
+    metric.Record(kMaxInt64 / 2);
+    EXPECT_EQ(1, metric.bucket(HistogramMetric::kNumBuckets - 1));
+
+    JSONStream js;
+    metric.PrintJSON(&js);
+    const char* json = js.ToCString();
+    EXPECT_SUBSTRING("\"count\":5", json);
+    EXPECT_SUBSTRING("\"buckets\":[{\"limit\":1,\"count\":1}", json);
+
+    metric.Reset();
+    EXPECT_EQ(0, metric.count());
+    EXPECT_EQ(0, metric.value());
+    EXPECT_EQ(0, metric.bucket(HistogramMetric::kNumBuckets - 1));
+  }
+  Dart_ShutdownIsolate();
+}
+
+VM_UNIT_TEST_CASE(Metric_OpenMetrics) {
+  TestCase::CreateTestIsolate();
+  {
+    TextBuffer buffer(1 * KB);
+    Metric::PrintOpenMetrics(&buffer);
+    const char* text = buffer.buf();
+    EXPECT_SUBSTRING("# TYPE dart_vm_isolate_count gauge\n", text);
+    EXPECT_SUBSTRING("# UNIT dart_heap_old_used_bytes bytes\n", text);
+    EXPECT_SUBSTRING("dart_heap_old_used_bytes{isolate=\"", text);
+    EXPECT_SUBSTRING("dart_isolate_messages_pending{", text);
+    EXPECT_SUBSTRING("_bucket{isolate=\"", text);
+    EXPECT_SUBSTRING(",le=\"+Inf\"}", text);
+    const intptr_t length = strlen(text);
+    EXPECT(length > 6);
+    EXPECT_STREQ("# EOF\n", text + length - 6);
+  }
+  Dart_ShutdownIsolate();
+}
+
 #endif  // !PRODUCT
 
 }  // namespace dart
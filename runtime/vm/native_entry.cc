@@ -182,17 +182,10 @@ void NativeEntry::AutoScopeNativeCallWrapperNoStackCheck(
     ApiState* state = isolate->api_state();
     ASSERT(state != NULL);
     ApiLocalScope* current_top_scope = thread->api_top_scope();
-    ApiLocalScope* scope = thread->api_reusable_scope();
     TRACE_NATIVE_CALL("0x%" Px "", reinterpret_cast<uintptr_t>(func));
     TransitionGeneratedToNative transition(thread);
-    if (scope == NULL) {
-      scope =
-          new ApiLocalScope(current_top_scope, thread->top_exit_frame_info());
-      ASSERT(scope != NULL);
-    } else {
-      scope->Reinit(thread, current_top_scope, thread->top_exit_frame_info());
-      thread->set_api_reusable_scope(NULL);
-    }
+    ApiLocalScope* scope = thread->AllocateApiScope(
+        current_top_scope, thread->top_exit_frame_info());
     thread->set_api_top_scope(scope);  // New scope is now the top scope.
 
     func(args);
@@ -202,13 +195,7 @@ void NativeEntry::AutoScopeNativeCallWrapperNoStackCheck(
 
     ASSERT(current_top_scope == scope->previous());
     thread->set_api_top_scope(current_top_scope);  // Reset top scope to prev.
-    if (thread->api_reusable_scope() == NULL) {
-      scope->Reset(thread);  // Reset the old scope which we just exited.
-      thread->set_api_reusable_scope(scope);
-    } else {
-      ASSERT(thread->api_reusable_scope() != scope);
-      delete scope;
-    }
+    thread->FreeApiScope(scope);
     DEOPTIMIZE_ALOT;
   }
   ASSERT(thread->execution_state() == Thread::kThreadInGenerated);
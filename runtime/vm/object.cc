@@ -19,6 +19,7 @@
 #include "vm/compiler/intrinsifier.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/compiler_stats.h"
+#include "vm/constants_kbc.h"
 #include "vm/cpu.h"
 #include "vm/dart.h"
 #include "vm/dart_api_state.h"
@@ -33,6 +34,7 @@
 #include "vm/hash_table.h"
 #include "vm/heap/become.h"
 #include "vm/heap/heap.h"
+#include "vm/heap/pages.h"
 #include "vm/heap/weak_code.h"
 #include "vm/isolate_reload.h"
 #include "vm/kernel.h"
@@ -84,6 +86,7 @@ DEFINE_FLAG(bool,
             false,
             "Remove script timestamps to allow for deterministic testing.");
 
+DECLARE_FLAG(bool, interpreter_superinstructions);
 DECLARE_FLAG(bool, show_invisible_frames);
 DECLARE_FLAG(bool, trace_deoptimization);
 DECLARE_FLAG(bool, trace_deoptimization_verbose);
@@ -1188,6 +1191,37 @@ void Object::FinalizeReadOnlyObject(RawObject* object) {
     ASSERT(size <= desc->Size());
     memset(reinterpret_cast<void*>(RawObject::ToAddr(desc) + size), 0,
            desc->Size() - size);
+  } else if (cid == kMintCid) {
+    // Clear any alignment padding between the header and the value.
+    memset(reinterpret_cast<void*>(RawObject::ToAddr(object) +
+                                   sizeof(RawObject)),
+           0, Mint::value_offset() - sizeof(RawObject));
+  } else if (cid == kDoubleCid) {
+    memset(reinterpret_cast<void*>(RawObject::ToAddr(object) +
+                                   sizeof(RawObject)),
+           0, Double::value_offset() - sizeof(RawObject));
+  } else if (cid == kExceptionHandlersCid) {
+    RawExceptionHandlers* handlers = ExceptionHandlers::RawCast(object);
+    const intptr_t num_entries = handlers->ptr()->num_entries_;
+    uword start = reinterpret_cast<uword>(&handlers->ptr()->num_entries_) +
+                  sizeof(handlers->ptr()->num_entries_);
+    memset(reinterpret_cast<void*>(start), 0,
+           reinterpret_cast<uword>(&handlers->ptr()->handled_types_data_) -
+               start);
+    // Rewrite the entries field by field to clear their struct padding.
+    for (intptr_t i = 0; i < num_entries; i++) {
+      ExceptionHandlerInfo* entry = &handlers->ptr()->data()[i];
+      const ExceptionHandlerInfo info = *entry;
+      memset(entry, 0, sizeof(*entry));
+      entry->handler_pc_offset = info.handler_pc_offset;
+      entry->outer_try_index = info.outer_try_index;
+      entry->needs_stacktrace = info.needs_stacktrace;
+      entry->has_catch_all = info.has_catch_all;
+      entry->is_generated = info.is_generated;
+    }
+    start = reinterpret_cast<uword>(&handlers->ptr()->data()[num_entries]);
+    memset(reinterpret_cast<void*>(start), 0,
+           RawObject::ToAddr(handlers) + handlers->Size() - start);
   }
 }
 
@@ -1469,6 +1503,11 @@ RawError* Object::Init(Isolate* isolate,
     RegisterPrivateClass(cls, Symbols::_CapabilityImpl(), isolate_lib);
     pending_classes.Add(cls);
 
+    cls = Class::New<TransferableTypedData>();
+    RegisterPrivateClass(cls, Symbols::_TransferableTypedDataImpl(),
+                         isolate_lib);
+    pending_classes.Add(cls);
+
     cls = Class::New<ReceivePort>();
     RegisterPrivateClass(cls, Symbols::_RawReceivePortImpl(), isolate_lib);
     pending_classes.Add(cls);
@@ -1956,6 +1995,7 @@ RawError* Object::Init(Isolate* isolate,
     object_store->set_null_class(cls);
 
     cls = Class::New<Capability>();
+    cls = Class::New<TransferableTypedData>();
     cls = Class::New<ReceivePort>();
     cls = Class::New<SendPort>();
     cls = Class::New<StackTrace>();
@@ -1992,15 +2032,23 @@ RawString* Object::DictionaryName() const {
 void Object::InitializeObject(uword address,
                               intptr_t class_id,
                               intptr_t size,
-                              bool is_vm_object) {
-  uword initial_value = (class_id == kInstructionsCid)
-                            ? Assembler::GetBreakInstructionFiller()
-                            : reinterpret_cast<uword>(null_);
-  uword cur = address;
-  uword end = address + size;
-  while (cur < end) {
-    *reinterpret_cast<uword*>(cur) = initial_value;
-    cur += kWordSize;
+                              bool is_vm_object,
+                              bool is_zeroed) {
+  if (RawObject::IsTypedDataClassId(class_id)) {
+    // The length is a Smi, so zero is a valid value for all of the body.
+    if (!is_zeroed) {
+      memset(reinterpret_cast<void*>(address), 0, size);
+    }
+  } else {
+    uword initial_value = (class_id == kInstructionsCid)
+                              ? Assembler::GetBreakInstructionFiller()
+                              : reinterpret_cast<uword>(null_);
+    uword cur = address;
+    uword end = address + size;
+    while (cur < end) {
+      *reinterpret_cast<uword*>(cur) = initial_value;
+      cur += kWordSize;
+    }
   }
   uint32_t tags = 0;
   ASSERT(class_id != kIllegalCid);
@@ -2062,15 +2110,36 @@ RawObject* Object::Allocate(intptr_t cls_id, intptr_t size, Heap::Space space) {
   } else {
     class_table->UpdateAllocatedOld(cls_id, size);
   }
-  const Class& cls = Class::Handle(class_table->At(cls_id));
-  if (FLAG_profiler && cls.TraceAllocation(isolate)) {
-    Profiler::SampleAllocation(thread, cls_id);
+  intptr_t sampled_size = 0;
+  if (HeapSampler::enabled() && thread->IsMutatorThread()) {
+    sampled_size = heap->sampler()->TakeSample(address, size);
+  }
+  if (sampled_size != 0) {
+    Profiler::SampleAllocation(thread, cls_id, sampled_size);
+  } else {
+    const Class& cls = Class::Handle(class_table->At(cls_id));
+    if (FLAG_profiler && cls.TraceAllocation(isolate)) {
+      Profiler::SampleAllocation(thread, cls_id);
+    }
   }
 #endif  // !PRODUCT
   NoSafepointScope no_safepoint;
-  InitializeObject(address, cls_id, size, (isolate == Dart::vm_isolate()));
+  // Large objects get a freshly mapped page of their own.
+  const bool is_zeroed =
+      ((address & kNewObjectAlignmentOffset) == kOldObjectAlignmentOffset) &&
+      PageSpace::IsLargePageAllocation(size);
+  InitializeObject(address, cls_id, size, (isolate == Dart::vm_isolate()),
+                   is_zeroed);
   RawObject* raw_obj = reinterpret_cast<RawObject*>(address + kHeapObjectTag);
   ASSERT(cls_id == RawObject::ClassIdTag::decode(raw_obj->ptr()->tags_));
+  if (raw_obj->IsOldObject() && thread->is_marking()) {
+    // Allocate black during concurrent marking, and remember the object so
+    // that the pointers stored while initializing it are visited before
+    // marking completes.
+    raw_obj->SetMarkBitUnsynchronized();
+    raw_obj->SetRememberedBitUnsynchronized();
+    thread->StoreBufferAddObject(raw_obj);
+  }
   return raw_obj;
 }
 
@@ -2115,9 +2184,6 @@ RawObject* Object::Clone(const Object& orig, Heap::Space space) {
   intptr_t size = orig.raw()->Size();
   RawObject* raw_clone = Object::Allocate(cls.id(), size, space);
   NoSafepointScope no_safepoint;
-  // TODO(koda): This will trip when we start allocating black.
-  // Revisit code below at that point, to account for the new write barrier.
-  ASSERT(!raw_clone->IsMarked());
   // Copy the body of the original into the clone.
   uword orig_addr = RawObject::ToAddr(orig.raw());
   uword clone_addr = RawObject::ToAddr(raw_clone);
@@ -2129,7 +2195,11 @@ RawObject* Object::Clone(const Object& orig, Heap::Space space) {
   if (!raw_clone->IsOldObject()) {
     // No need to remember an object in new space.
     return raw_clone;
-  } else if (orig.raw()->IsOldObject() && !orig.raw()->IsRemembered()) {
+  } else if (raw_clone->IsRemembered()) {
+    // Allocated black during concurrent marking, and already remembered.
+    return raw_clone;
+  } else if (orig.raw()->IsOldObject() && !orig.raw()->IsRemembered() &&
+             !orig.raw()->IsCardRemembered()) {
     // Old original doesn't need to be remembered, so neither does the clone.
     return raw_clone;
   }
@@ -2443,13 +2513,13 @@ intptr_t Class::FindInvocationDispatcherFunctionIndex(
   REUSABLE_OBJECT_HANDLESCOPE(thread);
   Array& funcs = thread->ArrayHandle();
   Object& object = thread->ObjectHandle();
-  funcs ^= invocation_dispatcher_cache();
+  // Entries never move, so the index stays valid as the cache grows.
+  funcs ^= InvocationDispatcherEntries();
   ASSERT(!funcs.IsNull());
   const intptr_t len = funcs.Length();
   for (intptr_t i = 0; i < len; i++) {
     object = funcs.At(i);
-    // The invocation_dispatcher_cache is a table with some entries that
-    // are functions.
+    // The entries hold names and arguments descriptors besides functions.
     if (object.IsFunction()) {
       if (Function::Cast(object).raw() == needle.raw()) {
         return i;
@@ -2464,10 +2534,13 @@ RawFunction* Class::InvocationDispatcherFunctionFromIndex(intptr_t idx) const {
   Thread* thread = Thread::Current();
   REUSABLE_ARRAY_HANDLESCOPE(thread);
   REUSABLE_OBJECT_HANDLESCOPE(thread);
-  Array& dispatcher_cache = thread->ArrayHandle();
+  Array& entries = thread->ArrayHandle();
   Object& object = thread->ObjectHandle();
-  dispatcher_cache ^= invocation_dispatcher_cache();
-  object = dispatcher_cache.At(idx);
+  entries ^= InvocationDispatcherEntries();
+  if ((idx < 0) || (idx >= entries.Length())) {
+    return Function::null();
+  }
+  object = entries.At(idx);
   if (!object.IsFunction()) {
     return Function::null();
   }
@@ -2715,32 +2788,127 @@ void Class::CalculateFieldOffsets() const {
   set_next_field_offset(offset);
 }
 
+// The invocation dispatcher cache is an array of two arrays, or the empty
+// array before the first dispatcher is added:
+//
+//   - the entries: [name, args_desc, dispatcher] triples in the order they
+//     were added, followed by unused entries with a null name. Entries never
+//     move, so the index of a dispatcher in this array identifies it, e.g.
+//     in service ids;
+//   - the index: an open addressing hash table of entry numbers (as Smis,
+//     null when unused), keyed by the name and the shape of the arguments
+//     descriptor. Its length is a power of two, and it is kept at most half
+//     full, which is also the capacity of the entries array.
+//
+// The cache is replaced as a whole when it grows, so readers on other threads
+// see either the old or the complete new cache.
 struct InvocationDispatcherCacheLayout {
+  enum { kEntriesIndex = 0, kHashIndex, kCacheSize };
   enum { kNameIndex = 0, kArgsDescIndex, kFunctionIndex, kEntrySize };
+  static const intptr_t kInitialCapacity = 4;
 };
 
+static intptr_t InvocationDispatcherHash(const String& name,
+                                         const Array& args_desc) {
+  uint32_t hash = name.Hash();
+  if (!args_desc.IsNull()) {
+    // Descriptors are canonical and compared by identity. Hashing their
+    // shape without the argument names is enough to spread the entries.
+    ArgumentsDescriptor desc(args_desc);
+    hash = CombineHashes(hash, desc.TypeArgsLen());
+    hash = CombineHashes(hash, desc.Count());
+    hash = CombineHashes(hash, desc.PositionalCount());
+  }
+  return FinalizeHash(hash, String::kHashBits);
+}
+
+// Enters entry number 'entry' of 'entries' into the hash table 'index'.
+static void IndexInvocationDispatcher(const Array& index,
+                                      const Array& entries,
+                                      intptr_t entry) {
+  const intptr_t base = entry * InvocationDispatcherCacheLayout::kEntrySize;
+  const String& name = String::Handle(String::RawCast(
+      entries.At(base + InvocationDispatcherCacheLayout::kNameIndex)));
+  const Array& args_desc = Array::Handle(Array::RawCast(
+      entries.At(base + InvocationDispatcherCacheLayout::kArgsDescIndex)));
+  const intptr_t mask = index.Length() - 1;
+  intptr_t slot = InvocationDispatcherHash(name, args_desc) & mask;
+  while (index.At(slot) != Object::null()) {
+    slot = (slot + 1) & mask;
+  }
+  index.SetAt(slot, Smi::Handle(Smi::New(entry)));
+}
+
+RawArray* Class::InvocationDispatcherEntries() const {
+  const Array& cache = Array::Handle(invocation_dispatcher_cache());
+  if (cache.Length() == 0) {
+    return Object::empty_array().raw();
+  }
+  return Array::RawCast(
+      cache.At(InvocationDispatcherCacheLayout::kEntriesIndex));
+}
+
 void Class::AddInvocationDispatcher(const String& target_name,
                                     const Array& args_desc,
                                     const Function& dispatcher) const {
-  // Search for a free entry.
-  Array& cache = Array::Handle(invocation_dispatcher_cache());
-  intptr_t i = 0;
-  while (i < cache.Length() && cache.At(i) != Object::null()) {
-    i += InvocationDispatcherCacheLayout::kEntrySize;
+  const Array& cache = Array::Handle(invocation_dispatcher_cache());
+  Array& entries = Array::Handle(InvocationDispatcherEntries());
+  const intptr_t capacity =
+      entries.Length() / InvocationDispatcherCacheLayout::kEntrySize;
+  String& name = String::Handle();
+  intptr_t used = 0;
+  for (; used < capacity; used++) {
+    const intptr_t base = used * InvocationDispatcherCacheLayout::kEntrySize;
+    name ^= entries.At(base + InvocationDispatcherCacheLayout::kNameIndex);
+    if (name.IsNull()) break;
+    if ((entries.At(base + InvocationDispatcherCacheLayout::kFunctionIndex) ==
+         dispatcher.raw()) &&
+        (entries.At(base + InvocationDispatcherCacheLayout::kArgsDescIndex) ==
+         args_desc.raw()) &&
+        name.Equals(target_name)) {
+      return;
+    }
   }
 
-  if (i == cache.Length()) {
-    // Allocate new larger cache.
-    intptr_t new_len =
-        (cache.Length() == 0)
-            ? static_cast<intptr_t>(InvocationDispatcherCacheLayout::kEntrySize)
-            : cache.Length() * 2;
-    cache ^= Array::Grow(cache, new_len);
-    set_invocation_dispatcher_cache(cache);
+  const intptr_t base = used * InvocationDispatcherCacheLayout::kEntrySize;
+  if (used < capacity) {
+    // Complete the entry before indexing it.
+    entries.SetAt(base + InvocationDispatcherCacheLayout::kArgsDescIndex,
+                  args_desc);
+    entries.SetAt(base + InvocationDispatcherCacheLayout::kFunctionIndex,
+                  dispatcher);
+    entries.SetAt(base + InvocationDispatcherCacheLayout::kNameIndex,
+                  target_name);
+    const Array& index = Array::Handle(Array::RawCast(
+        cache.At(InvocationDispatcherCacheLayout::kHashIndex)));
+    IndexInvocationDispatcher(index, entries, used);
+    return;
   }
-  cache.SetAt(i + InvocationDispatcherCacheLayout::kNameIndex, target_name);
-  cache.SetAt(i + InvocationDispatcherCacheLayout::kArgsDescIndex, args_desc);
-  cache.SetAt(i + InvocationDispatcherCacheLayout::kFunctionIndex, dispatcher);
+
+  // Grow. The entries keep their positions; the index is rebuilt.
+  const intptr_t new_capacity =
+      (capacity == 0) ? InvocationDispatcherCacheLayout::kInitialCapacity
+                      : 2 * capacity;
+  const Array& new_entries = Array::Handle(Array::Grow(
+      entries, new_capacity * InvocationDispatcherCacheLayout::kEntrySize,
+      Heap::kOld));
+  new_entries.SetAt(base + InvocationDispatcherCacheLayout::kNameIndex,
+                    target_name);
+  new_entries.SetAt(base + InvocationDispatcherCacheLayout::kArgsDescIndex,
+                    args_desc);
+  new_entries.SetAt(base + InvocationDispatcherCacheLayout::kFunctionIndex,
+                    dispatcher);
+  const Array& new_index =
+      Array::Handle(Array::New(2 * new_capacity, Heap::kOld));
+  for (intptr_t i = 0; i <= used; i++) {
+    IndexInvocationDispatcher(new_index, new_entries, i);
+  }
+  const Array& new_cache = Array::Handle(
+      Array::New(InvocationDispatcherCacheLayout::kCacheSize, Heap::kOld));
+  new_cache.SetAt(InvocationDispatcherCacheLayout::kEntriesIndex,
+                  new_entries);
+  new_cache.SetAt(InvocationDispatcherCacheLayout::kHashIndex, new_index);
+  set_invocation_dispatcher_cache(new_cache);
 }
 
 RawFunction* Class::GetInvocationDispatcher(const String& target_name,
@@ -2751,22 +2919,35 @@ RawFunction* Class::GetInvocationDispatcher(const String& target_name,
          kind == RawFunction::kInvokeFieldDispatcher ||
          kind == RawFunction::kDynamicInvocationForwarder);
   Function& dispatcher = Function::Handle();
-  Array& cache = Array::Handle(invocation_dispatcher_cache());
+  const Array& cache = Array::Handle(invocation_dispatcher_cache());
   ASSERT(!cache.IsNull());
-  String& name = String::Handle();
-  Array& desc = Array::Handle();
-  intptr_t i = 0;
-  for (; i < cache.Length(); i += InvocationDispatcherCacheLayout::kEntrySize) {
-    name ^= cache.At(i + InvocationDispatcherCacheLayout::kNameIndex);
-    if (name.IsNull()) break;  // Reached last entry.
-    if (!name.Equals(target_name)) continue;
-    desc ^= cache.At(i + InvocationDispatcherCacheLayout::kArgsDescIndex);
-    if (desc.raw() != args_desc.raw()) continue;
-    dispatcher ^= cache.At(i + InvocationDispatcherCacheLayout::kFunctionIndex);
-    if (dispatcher.kind() == kind) {
-      // Found match.
-      ASSERT(dispatcher.IsFunction());
-      break;
+  if (cache.Length() > 0) {
+    const Array& entries = Array::Handle(Array::RawCast(
+        cache.At(InvocationDispatcherCacheLayout::kEntriesIndex)));
+    const Array& index = Array::Handle(Array::RawCast(
+        cache.At(InvocationDispatcherCacheLayout::kHashIndex)));
+    const intptr_t mask = index.Length() - 1;
+    intptr_t slot = InvocationDispatcherHash(target_name, args_desc) & mask;
+    String& name = String::Handle();
+    Function& function = Function::Handle();
+    // The index always has an unused slot, which ends the probe sequence.
+    while (index.At(slot) != Object::null()) {
+      const intptr_t base = Smi::Value(Smi::RawCast(index.At(slot))) *
+                            InvocationDispatcherCacheLayout::kEntrySize;
+      slot = (slot + 1) & mask;
+      if (entries.At(base + InvocationDispatcherCacheLayout::kArgsDescIndex) !=
+          args_desc.raw()) {
+        continue;
+      }
+      name ^= entries.At(base + InvocationDispatcherCacheLayout::kNameIndex);
+      if (!name.Equals(target_name)) continue;
+      function ^=
+          entries.At(base + InvocationDispatcherCacheLayout::kFunctionIndex);
+      if (function.kind() == kind) {
+        // Found match.
+        dispatcher = function.raw();
+        break;
+      }
     }
   }
 
@@ -2915,6 +3096,7 @@ RawFunction* Function::CreateDynamicInvocationForwarder(
   forwarder.ClearCode();
   forwarder.set_usage_counter(0);
   forwarder.set_deoptimization_counter(0);
+  forwarder.set_adapted_deoptimization_counter(0);
   forwarder.set_optimized_instruction_count(0);
   forwarder.set_inlining_depth(0);
   forwarder.set_optimized_call_site_count(0);
@@ -3025,8 +3207,10 @@ void Class::Finalize() const {
 
 class CHACodeArray : public WeakCodeReferences {
  public:
-  explicit CHACodeArray(const Class& cls)
-      : WeakCodeReferences(Array::Handle(cls.dependent_code())), cls_(cls) {}
+  CHACodeArray(const Class& cls, const Class& subclass)
+      : WeakCodeReferences(Array::Handle(cls.dependent_code())),
+        cls_(cls),
+        subclass_(subclass) {}
 
   virtual void UpdateArrayTo(const Array& value) {
     // TODO(fschneider): Fails for classes in the VM isolate.
@@ -3051,8 +3235,32 @@ class CHACodeArray : public WeakCodeReferences {
     }
   }
 
+  // Code that relies only on the absence of overrides of some selectors is
+  // affected if the new subclass, or a class between it and cls_, declares
+  // one of them. A class implementing cls_ affects all code.
+  virtual bool IsAffected(const Object& data) const {
+    if (subclass_.IsNull() || !data.IsArray()) {
+      return true;
+    }
+    const Array& selectors = Array::Cast(data);
+    Zone* zone = Thread::Current()->zone();
+    Class& cls = Class::Handle(zone, subclass_.raw());
+    String& selector = String::Handle(zone);
+    while (!cls.IsNull() && (cls.raw() != cls_.raw())) {
+      for (intptr_t i = 0; i < selectors.Length(); i++) {
+        selector ^= selectors.At(i);
+        if (cls.LookupDynamicFunction(selector) != Function::null()) {
+          return true;
+        }
+      }
+      cls = cls.SuperClass();
+    }
+    return cls.IsNull();
+  }
+
  private:
   const Class& cls_;
+  const Class& subclass_;
   DISALLOW_COPY_AND_ASSIGN(CHACodeArray);
 };
 
@@ -3063,7 +3271,7 @@ static bool IsMutatorOrAtSafepoint() {
 }
 #endif
 
-void Class::RegisterCHACode(const Code& code) {
+void Class::RegisterCHACode(const Code& code, const Array& selectors) const {
   if (FLAG_trace_cha) {
     THR_Print("RegisterCHACode '%s' depends on class '%s'\n",
               Function::Handle(code.function()).ToQualifiedCString(),
@@ -3071,13 +3279,13 @@ void Class::RegisterCHACode(const Code& code) {
   }
   DEBUG_ASSERT(IsMutatorOrAtSafepoint());
   ASSERT(code.is_optimized());
-  CHACodeArray a(*this);
-  a.Register(code);
+  CHACodeArray a(*this, Class::Handle());
+  a.Register(code, selectors);
 }
 
 void Class::DisableCHAOptimizedCode(const Class& subclass) {
   ASSERT(Thread::Current()->IsMutatorThread());
-  CHACodeArray a(*this);
+  CHACodeArray a(*this, subclass);
   if (FLAG_trace_deoptimization && a.HasCodes() && !subclass.IsNull()) {
     THR_Print("Adding subclass %s\n", subclass.ToCString());
   }
@@ -3472,8 +3680,19 @@ void Class::InjectCIDFields() const {
   AddField(field);
 
   CLASS_LIST_WITH_NULL(ADD_SET_FIELD)
-#undef ADD_SET_FIELD
 #undef CLASS_LIST_WITH_NULL
+
+  // The Uint8List implementations of the VM.
+#define kUint8ArrayCid kTypedDataUint8ArrayCid
+#define kExternalUint8ArrayCid kExternalTypedDataUint8ArrayCid
+#define kUint8ArrayViewCid kTypedDataUint8ArrayViewCid
+  ADD_SET_FIELD(Uint8Array)
+  ADD_SET_FIELD(ExternalUint8Array)
+  ADD_SET_FIELD(Uint8ArrayView)
+#undef kUint8ArrayCid
+#undef kExternalUint8ArrayCid
+#undef kUint8ArrayViewCid
+#undef ADD_SET_FIELD
 }
 
 template <class FakeInstance>
@@ -7194,6 +7413,7 @@ RawFunction* Function::New(const String& name,
   result.set_is_no_such_method_forwarder(false);
   NOT_IN_PRECOMPILED(result.set_usage_counter(0));
   NOT_IN_PRECOMPILED(result.set_deoptimization_counter(0));
+  NOT_IN_PRECOMPILED(result.set_adapted_deoptimization_counter(0));
   NOT_IN_PRECOMPILED(result.set_optimized_instruction_count(0));
   NOT_IN_PRECOMPILED(result.set_optimized_call_site_count(0));
   NOT_IN_PRECOMPILED(result.set_inlining_depth(0));
@@ -7235,6 +7455,7 @@ RawFunction* Function::Clone(const Class& new_owner) const {
   clone.set_data(Object::null_object());
   clone.set_usage_counter(0);
   clone.set_deoptimization_counter(0);
+  clone.set_adapted_deoptimization_counter(0);
   clone.set_optimized_instruction_count(0);
   clone.set_inlining_depth(0);
   clone.set_optimized_call_site_count(0);
@@ -10315,13 +10536,25 @@ RawLibrary* Script::FindLibrary() const {
 }
 
 DictionaryIterator::DictionaryIterator(const Library& library)
-    : array_(Array::Handle(library.dictionary())),
+    : DictionaryIterator(library, true) {}
+
+DictionaryIterator::DictionaryIterator(const Library& library,
+                                       bool load_top_level_members)
+    : array_(Array::Handle(DictionaryOf(library, load_top_level_members))),
       // Last element in array is a Smi indicating the number of entries used.
-      size_(Array::Handle(library.dictionary()).Length() - 1),
+      size_(array_.Length() - 1),
       next_ix_(0) {
   MoveToNextObject();
 }
 
+RawArray* DictionaryIterator::DictionaryOf(const Library& library,
+                                           bool load_top_level_members) {
+  if (load_top_level_members) {
+    library.LoadPendingTopLevelMembers();
+  }
+  return library.dictionary();
+}
+
 RawObject* DictionaryIterator::GetNext() {
   ASSERT(HasNext());
   int ix = next_ix_++;
@@ -10340,7 +10573,7 @@ void DictionaryIterator::MoveToNextObject() {
 
 ClassDictionaryIterator::ClassDictionaryIterator(const Library& library,
                                                  IterationKind kind)
-    : DictionaryIterator(library),
+    : DictionaryIterator(library, false),
       toplevel_class_(Class::Handle((kind == kIteratePrivate)
                                         ? library.toplevel_class()
                                         : Class::null())) {
@@ -10374,7 +10607,7 @@ void ClassDictionaryIterator::MoveToNextClass() {
 }
 
 LibraryPrefixIterator::LibraryPrefixIterator(const Library& library)
-    : DictionaryIterator(library) {
+    : DictionaryIterator(library, false) {
   Advance();
 }
 
@@ -11014,7 +11247,32 @@ RawObject* Library::LookupReExport(const String& name,
   return obj.raw();
 }
 
+bool Library::LoadPendingTopLevelMembers() const {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  return false;
+#else
+  Thread* thread = Thread::Current();
+  const Class& cls = Class::Handle(thread->zone(), toplevel_class());
+  // The members of a toplevel class with a kernel offset have not been loaded
+  // yet. They can only be loaded once the class is type finalized.
+  if (cls.IsNull() || (cls.kernel_offset() <= 0) ||
+      !cls.is_type_finalized()) {
+    return false;
+  }
+  return cls.EnsureIsFinalized(thread) == Error::null();
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+}
+
 RawObject* Library::LookupEntry(const String& name, intptr_t* index) const {
+  RawObject* entry = LookupLoadedEntry(name, index);
+  if ((entry == Object::null()) && LoadPendingTopLevelMembers()) {
+    entry = LookupLoadedEntry(name, index);
+  }
+  return entry;
+}
+
+RawObject* Library::LookupLoadedEntry(const String& name,
+                                      intptr_t* index) const {
   Thread* thread = Thread::Current();
   REUSABLE_ARRAY_HANDLESCOPE(thread);
   REUSABLE_OBJECT_HANDLESCOPE(thread);
@@ -13371,6 +13629,10 @@ void ExceptionHandlers::SetHandledTypes(intptr_t try_index,
 
 RawArray* ExceptionHandlers::GetHandledTypes(intptr_t try_index) const {
   ASSERT((try_index >= 0) && (try_index < num_entries()));
+  if (!raw_ptr()->handled_types_data_->IsHeapObject()) {
+    // Handlers used in place from an AOT image do not retain their types.
+    return Array::null();
+  }
   Array& array = Array::Handle(raw_ptr()->handled_types_data_);
   array ^= array.At(try_index);
   return array.raw();
@@ -13570,6 +13832,10 @@ void ICData::set_owner(const Function& value) const {
   StorePointer(&raw_ptr()->owner_, reinterpret_cast<RawObject*>(value.raw()));
 }
 
+void ICData::set_closure_target(const Function& value) const {
+  StorePointer(&raw_ptr()->closure_target_, value.raw());
+}
+
 void ICData::set_target_name(const String& value) const {
   ASSERT(!value.IsNull());
   StorePointer(&raw_ptr()->target_name_, value.raw());
@@ -14533,6 +14799,7 @@ RawICData* ICData::NewFrom(const ICData& from, intptr_t num_args_tested) {
       num_args_tested, from.rebind_rule()));
   // Copy deoptimization reasons.
   result.SetDeoptReasons(from.DeoptReasons());
+  result.set_closure_target(Function::Handle(from.closure_target()));
   return result.raw();
 }
 
@@ -14555,6 +14822,7 @@ RawICData* ICData::Clone(const ICData& from) {
   result.set_ic_data_array(cloned_array);
   // Copy deoptimization reasons.
   result.SetDeoptReasons(from.DeoptReasons());
+  result.set_closure_target(Function::Handle(zone, from.closure_target()));
   return result.raw();
 }
 
@@ -14959,6 +15227,7 @@ RawCode* Code::FinalizeCode(const char* name,
     code.SetActiveInstructions(instrs);
     code.set_instructions(instrs);
     code.set_is_alive(true);
+    isolate->heap()->code_ranges()->Add(code.raw());
 
     // Set object pool in Instructions object.
     INC_STAT(Thread::Current(), total_code_size,
@@ -15021,6 +15290,11 @@ RawCode* Code::FinalizeBytecode(const void* bytecode_data,
   MemoryRegion bytecode_region(const_cast<void*>(bytecode_data), bytecode_size);
   // TODO(regis): Avoid copying bytecode.
   instrs_region.CopyFrom(0, bytecode_region);
+  if (FLAG_interpreter_superinstructions) {
+    KernelBytecode::InstallSuperinstructions(
+        reinterpret_cast<KBCInstr*>(instrs.PayloadStart()),
+        bytecode_size / sizeof(KBCInstr));
+  }
 
   // TODO(regis): Keep following lines or not?
   code.set_compile_timestamp(OS::GetCurrentMonotonicMicros());
@@ -15038,6 +15312,7 @@ RawCode* Code::FinalizeBytecode(const void* bytecode_data,
     code.SetActiveInstructions(instrs);
     code.set_instructions(instrs);
     code.set_is_alive(true);
+    Isolate::Current()->heap()->code_ranges()->Add(code.raw());
 
     // Set object pool in Instructions object.
     INC_STAT(Thread::Current(), total_code_size,
@@ -15060,22 +15335,12 @@ RawCode* Code::FinalizeBytecode(const void* bytecode_data,
 }
 #endif  // defined(DART_USE_INTERPRETER)
 
-bool Code::SlowFindRawCodeVisitor::FindObject(RawObject* raw_obj) const {
-  return RawCode::ContainsPC(raw_obj, pc_);
-}
-
 RawCode* Code::LookupCodeInIsolate(Isolate* isolate, uword pc) {
   ASSERT((isolate == Isolate::Current()) || (isolate == Dart::vm_isolate()));
   if (isolate->heap() == NULL) {
     return Code::null();
   }
-  HeapIterationScope heap_iteration_scope(Thread::Current());
-  SlowFindRawCodeVisitor visitor(pc);
-  RawObject* needle = isolate->heap()->FindOldObject(&visitor);
-  if (needle != Code::null()) {
-    return static_cast<RawCode*>(needle);
-  }
-  return Code::null();
+  return isolate->heap()->code_ranges()->Lookup(pc);
 }
 
 RawCode* Code::LookupCode(uword pc) {
@@ -15252,12 +15517,22 @@ RawStackMap* Code::GetStackMap(uint32_t pc_offset,
   // frame slots which are marked as having objects.
   *maps = stackmaps();
   *map = StackMap::null();
-  for (intptr_t i = 0; i < maps->Length(); i++) {
-    *map ^= maps->At(i);
+  // The stack maps are sorted by pc offset, see StackMapTableBuilder::Verify.
+  intptr_t lo = 0;
+  intptr_t hi = maps->Length() - 1;
+  while (lo <= hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    *map ^= maps->At(mid);
     ASSERT(!map->IsNull());
-    if (map->PcOffset() == pc_offset) {
+    const uint32_t map_pc_offset = map->PcOffset();
+    if (map_pc_offset == pc_offset) {
       return map->raw();  // We found a stack map for this frame.
     }
+    if (map_pc_offset < pc_offset) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
   }
   // If we are missing a stack map, this must either be unoptimized code, or
   // the entry to an osr function. (In which case all stack slots are
@@ -15555,6 +15830,21 @@ void MegamorphicCache::set_filled_entry_count(intptr_t count) const {
   StoreNonPointer(&raw_ptr()->filled_entry_count_, count);
 }
 
+void MegamorphicCache::set_miss_count(intptr_t count) const {
+  StoreNonPointer(&raw_ptr()->miss_count_, count);
+}
+
+intptr_t MegamorphicCache::dispatch_row() const {
+  ASSERT(dispatch_table() != Array::null());
+  return Smi::Value(raw_ptr()->dispatch_row_);
+}
+
+void MegamorphicCache::set_dispatch_table_row(const Array& table,
+                                              intptr_t row) const {
+  StorePointer(&raw_ptr()->dispatch_table_, table.raw());
+  StoreSmi(&raw_ptr()->dispatch_row_, Smi::New(row));
+}
+
 void MegamorphicCache::set_target_name(const String& value) const {
   StorePointer(&raw_ptr()->target_name_, value.raw());
 }
@@ -15573,6 +15863,7 @@ RawMegamorphicCache* MegamorphicCache::New() {
     result ^= raw;
   }
   result.set_filled_entry_count(0);
+  result.set_miss_count(0);
   return result.raw();
 }
 
@@ -15599,6 +15890,7 @@ RawMegamorphicCache* MegamorphicCache::New(const String& target_name,
   result.set_target_name(target_name);
   result.set_arguments_descriptor(arguments_descriptor);
   result.set_filled_entry_count(0);
+  result.set_miss_count(0);
   return result.raw();
 }
 
@@ -15651,6 +15943,25 @@ void MegamorphicCache::Insert(const Smi& class_id,
   UNREACHABLE();
 }
 
+bool MegamorphicCache::Contains(intptr_t class_id) const {
+  const Array& backing_array = Array::Handle(buckets());
+  const intptr_t id_mask = mask();
+  const intptr_t index = (class_id * kSpreadFactor) & id_mask;
+  intptr_t i = index;
+  do {
+    const intptr_t probe_cid =
+        Smi::Value(Smi::RawCast(GetClassId(backing_array, i)));
+    if (probe_cid == class_id) {
+      return true;
+    }
+    if (probe_cid == kIllegalCid) {
+      return false;
+    }
+    i = (i + 1) & id_mask;
+  } while (i != index);
+  return false;
+}
+
 const char* MegamorphicCache::ToCString() const {
   const String& name = String::Handle(target_name());
   return OS::SCreate(Thread::Current()->zone(), "MegamorphicCache(%s)",
@@ -15669,8 +15980,11 @@ RawSubtypeTestCache* SubtypeTestCache::New() {
     NoSafepointScope no_safepoint;
     result ^= raw;
   }
+  // An empty cache is only the unused last entry, which every lookup hits.
   const Array& cache = Array::Handle(Array::New(kTestEntryLength, Heap::kOld));
   result.set_cache(cache);
+  result.set_mask(0);
+  result.set_filled_entry_count(0);
   return result.raw();
 }
 
@@ -15678,10 +15992,113 @@ void SubtypeTestCache::set_cache(const Array& value) const {
   StorePointer(&raw_ptr()->cache_, value.raw());
 }
 
+intptr_t SubtypeTestCache::mask() const {
+  return Smi::Value(raw_ptr()->mask_);
+}
+
+void SubtypeTestCache::set_mask(intptr_t mask) const {
+  StoreSmi(&raw_ptr()->mask_, Smi::New(mask));
+}
+
+intptr_t SubtypeTestCache::filled_entry_count() const {
+  return raw_ptr()->filled_entry_count_;
+}
+
+void SubtypeTestCache::set_filled_entry_count(intptr_t count) const {
+  StoreNonPointer(&raw_ptr()->filled_entry_count_, count);
+}
+
 intptr_t SubtypeTestCache::NumberOfChecks() const {
-  NoSafepointScope no_safepoint;
-  // Do not count the sentinel;
-  return (Smi::Value(cache()->ptr()->length_) / kTestEntryLength) - 1;
+  return filled_entry_count();
+}
+
+intptr_t SubtypeTestCache::Hash(intptr_t instance_cid,
+                                RawTypeArguments* instance_type_arguments) {
+  // Use the hash cached in the type arguments, as the stubs do. It is still 0
+  // if it could not be computed yet.
+  intptr_t hash = instance_cid * kSpreadFactor;
+  if (instance_type_arguments != TypeArguments::null()) {
+    hash += Smi::Value(instance_type_arguments->ptr()->hash_);
+  }
+  return hash;
+}
+
+static intptr_t InstanceClassIdForHash(const Object& instance_cid_or_function) {
+  return instance_cid_or_function.IsSmi()
+             ? Smi::Cast(instance_cid_or_function).Value()
+             : kClosureCid;
+}
+
+bool SubtypeTestCache::InsertEntry(
+    const Array& table,
+    intptr_t mask,
+    const Object& instance_class_id_or_function,
+    const TypeArguments& instance_type_arguments,
+    const TypeArguments& instantiator_type_arguments,
+    const TypeArguments& function_type_arguments,
+    const Bool& test_result) {
+  const intptr_t last = table.Length() / kTestEntryLength - 1;
+  const intptr_t hash =
+      Hash(InstanceClassIdForHash(instance_class_id_or_function),
+           instance_type_arguments.raw());
+  for (intptr_t i = hash & mask; i < last; i++) {
+    const intptr_t data_pos = i * kTestEntryLength;
+    if (table.At(data_pos + kInstanceClassIdOrFunction) == Object::null()) {
+      table.SetAt(data_pos + kInstanceClassIdOrFunction,
+                  instance_class_id_or_function);
+      table.SetAt(data_pos + kInstanceTypeArguments, instance_type_arguments);
+      table.SetAt(data_pos + kInstantiatorTypeArguments,
+                  instantiator_type_arguments);
+      table.SetAt(data_pos + kFunctionTypeArguments, function_type_arguments);
+      table.SetAt(data_pos + kTestResult, test_result);
+      return true;
+    }
+  }
+  return false;
+}
+
+void SubtypeTestCache::Rehash(intptr_t capacity) const {
+  ASSERT(Utils::IsPowerOfTwo(capacity));
+  Zone* zone = Thread::Current()->zone();
+  const Array& old_table = Array::Handle(zone, cache());
+  const intptr_t old_entries = old_table.Length() / kTestEntryLength;
+  Array& new_table = Array::Handle(zone);
+  Object& instance_class_id_or_function = Object::Handle(zone);
+  TypeArguments& instance_type_arguments = TypeArguments::Handle(zone);
+  TypeArguments& instantiator_type_arguments = TypeArguments::Handle(zone);
+  TypeArguments& function_type_arguments = TypeArguments::Handle(zone);
+  Bool& test_result = Bool::Handle(zone);
+  bool inserted_all;
+  do {
+    new_table = Array::New((capacity + 1) * kTestEntryLength, Heap::kOld);
+    inserted_all = true;
+    for (intptr_t i = 0; inserted_all && (i < old_entries); i++) {
+      const intptr_t data_pos = i * kTestEntryLength;
+      instance_class_id_or_function =
+          old_table.At(data_pos + kInstanceClassIdOrFunction);
+      if (instance_class_id_or_function.IsNull()) {
+        continue;
+      }
+      instance_type_arguments ^=
+          old_table.At(data_pos + kInstanceTypeArguments);
+      instantiator_type_arguments ^=
+          old_table.At(data_pos + kInstantiatorTypeArguments);
+      function_type_arguments ^=
+          old_table.At(data_pos + kFunctionTypeArguments);
+      test_result ^= old_table.At(data_pos + kTestResult);
+      inserted_all =
+          InsertEntry(new_table, capacity - 1, instance_class_id_or_function,
+                      instance_type_arguments, instantiator_type_arguments,
+                      function_type_arguments, test_result);
+    }
+    if (!inserted_all) {
+      capacity *= 2;
+    }
+  } while (!inserted_all);
+  // Install the table before the mask, so that a lookup never indexes past
+  // the end of the table it reads.
+  set_cache(new_table);
+  set_mask(capacity - 1);
 }
 
 void SubtypeTestCache::AddCheck(
@@ -15690,19 +16107,24 @@ void SubtypeTestCache::AddCheck(
     const TypeArguments& instantiator_type_arguments,
     const TypeArguments& function_type_arguments,
     const Bool& test_result) const {
-  intptr_t old_num = NumberOfChecks();
+  // Cache the hash of the instance type arguments, if it can be computed, so
+  // that the stubs find the check.
+  instance_type_arguments.Hash();
+  const intptr_t count = filled_entry_count();
+  // The table of an empty cache has no home entries.
+  const intptr_t capacity = (count == 0) ? 0 : mask() + 1;
+  // Keep the load factor at most 1/2.
+  if ((count + 1) * 2 > capacity) {
+    Rehash(Utils::Maximum(kInitialCapacity, capacity * 2));
+  }
   Array& data = Array::Handle(cache());
-  intptr_t new_len = data.Length() + kTestEntryLength;
-  data = Array::Grow(data, new_len);
-  set_cache(data);
-  intptr_t data_pos = old_num * kTestEntryLength;
-  data.SetAt(data_pos + kInstanceClassIdOrFunction,
-             instance_class_id_or_function);
-  data.SetAt(data_pos + kInstanceTypeArguments, instance_type_arguments);
-  data.SetAt(data_pos + kInstantiatorTypeArguments,
-             instantiator_type_arguments);
-  data.SetAt(data_pos + kFunctionTypeArguments, function_type_arguments);
-  data.SetAt(data_pos + kTestResult, test_result);
+  while (!InsertEntry(data, mask(), instance_class_id_or_function,
+                      instance_type_arguments, instantiator_type_arguments,
+                      function_type_arguments, test_result)) {
+    Rehash((mask() + 1) * 2);
+    data = cache();
+  }
+  set_filled_entry_count(count + 1);
 }
 
 void SubtypeTestCache::GetCheck(intptr_t ix,
@@ -15711,8 +16133,16 @@ void SubtypeTestCache::GetCheck(intptr_t ix,
                                 TypeArguments* instantiator_type_arguments,
                                 TypeArguments* function_type_arguments,
                                 Bool* test_result) const {
+  ASSERT((ix >= 0) && (ix < NumberOfChecks()));
   Array& data = Array::Handle(cache());
-  intptr_t data_pos = ix * kTestEntryLength;
+  intptr_t data_pos = 0;
+  for (intptr_t filled = -1;; data_pos += kTestEntryLength) {
+    if (data.At(data_pos + kInstanceClassIdOrFunction) != Object::null()) {
+      if (++filled == ix) {
+        break;
+      }
+    }
+  }
   *instance_class_id_or_function =
       data.At(data_pos + kInstanceClassIdOrFunction);
   *instance_type_arguments ^= data.At(data_pos + kInstanceTypeArguments);
@@ -15722,6 +16152,65 @@ void SubtypeTestCache::GetCheck(intptr_t ix,
   *test_result ^= data.At(data_pos + kTestResult);
 }
 
+RawObject** SubtypeTestCache::LookupRaw(
+    RawSubtypeTestCache* cache,
+    intptr_t instance_cid,
+    RawObject* instance_class_id_or_function,
+    RawTypeArguments* instance_type_arguments,
+    RawTypeArguments* instantiator_type_arguments,
+    RawTypeArguments* function_type_arguments) {
+  const intptr_t index = Hash(instance_cid, instance_type_arguments) &
+                         Smi::Value(cache->ptr()->mask_);
+  for (RawObject** entries =
+           cache->ptr()->cache_->ptr()->data() + index * kTestEntryLength;
+       entries[kInstanceClassIdOrFunction] != Object::null();
+       entries += kTestEntryLength) {
+    if ((entries[kInstanceClassIdOrFunction] ==
+         instance_class_id_or_function) &&
+        (entries[kInstanceTypeArguments] == instance_type_arguments) &&
+        (entries[kInstantiatorTypeArguments] == instantiator_type_arguments) &&
+        (entries[kFunctionTypeArguments] == function_type_arguments)) {
+      return entries;
+    }
+  }
+  return NULL;
+}
+
+bool SubtypeTestCache::HasCheck(
+    const Object& instance_class_id_or_function,
+    const TypeArguments& instance_type_arguments,
+    const TypeArguments& instantiator_type_arguments,
+    const TypeArguments& function_type_arguments) const {
+  NoSafepointScope no_safepoint;
+  return LookupRaw(raw(), InstanceClassIdForHash(instance_class_id_or_function),
+                   instance_class_id_or_function.raw(),
+                   instance_type_arguments.raw(),
+                   instantiator_type_arguments.raw(),
+                   function_type_arguments.raw()) != NULL;
+}
+
+void SubtypeTestCache::CollectProbeLengths(
+    GrowableArray<intptr_t>* probe_lengths) const {
+  const Array& data = Array::Handle(cache());
+  const intptr_t entries = data.Length() / kTestEntryLength;
+  Object& instance_class_id_or_function = Object::Handle();
+  TypeArguments& instance_type_arguments = TypeArguments::Handle();
+  for (intptr_t i = 0; i < entries; i++) {
+    const intptr_t data_pos = i * kTestEntryLength;
+    instance_class_id_or_function =
+        data.At(data_pos + kInstanceClassIdOrFunction);
+    if (instance_class_id_or_function.IsNull()) {
+      continue;
+    }
+    instance_type_arguments ^= data.At(data_pos + kInstanceTypeArguments);
+    const intptr_t home =
+        Hash(InstanceClassIdForHash(instance_class_id_or_function),
+             instance_type_arguments.raw()) &
+        mask();
+    probe_lengths->Add(i - home + 1);
+  }
+}
+
 const char* SubtypeTestCache::ToCString() const {
   return "SubtypeTestCache";
 }
@@ -16076,6 +16565,28 @@ RawObject* Instance::IdentityHashCode() const {
   return DartLibraryCalls::IdentityHashCode(*this);
 }
 
+#if !defined(HASH_IN_OBJECT_HEADER)
+RawObject** Object::IdentityHashSlot(RawObject* obj) {
+  if (!obj->IsHeapObject()) {
+    return NULL;
+  }
+  const intptr_t cid = obj->GetClassIdMayBeSmi();
+  if (cid < kNumPredefinedCids) {
+    return NULL;
+  }
+  RawClass* cls = Isolate::Current()->class_table()->At(cid);
+  const intptr_t next_field_offset =
+      cls->ptr()->next_field_offset_in_words_ * kWordSize;
+  const intptr_t instance_size =
+      cls->ptr()->instance_size_in_words_ * kWordSize;
+  if ((next_field_offset <= 0) || (next_field_offset >= instance_size)) {
+    return NULL;
+  }
+  return reinterpret_cast<RawObject**>(RawObject::ToAddr(obj) +
+                                       next_field_offset);
+}
+#endif
+
 bool Instance::CanonicalizeEquals(const Instance& other) const {
   if (this->raw() == other.raw()) {
     return true;  // "===".
@@ -16095,10 +16606,13 @@ bool Instance::CanonicalizeEquals(const Instance& other) const {
     if (instance_size != other_instance_size) {
       return false;
     }
+    // Only fields are compared, the padding word may hold an identity hash.
+    const intptr_t next_field_offset =
+        clazz()->ptr()->next_field_offset_in_words_ * kWordSize;
     uword this_addr = reinterpret_cast<uword>(this->raw_ptr());
     uword other_addr = reinterpret_cast<uword>(other.raw_ptr());
-    for (intptr_t offset = Instance::NextFieldOffset(); offset < instance_size;
-         offset += kWordSize) {
+    for (intptr_t offset = Instance::NextFieldOffset();
+         offset < next_field_offset; offset += kWordSize) {
       if ((*reinterpret_cast<RawObject**>(this_addr + offset)) !=
           (*reinterpret_cast<RawObject**>(other_addr + offset))) {
         return false;
@@ -16116,10 +16630,12 @@ uint32_t Instance::CanonicalizeHash() const {
   const intptr_t instance_size = SizeFromClass();
   ASSERT(instance_size != 0);
   uint32_t hash = instance_size;
+  const intptr_t next_field_offset =
+      clazz()->ptr()->next_field_offset_in_words_ * kWordSize;
   uword this_addr = reinterpret_cast<uword>(this->raw_ptr());
   Instance& member = Instance::Handle();
-  for (intptr_t offset = Instance::NextFieldOffset(); offset < instance_size;
-       offset += kWordSize) {
+  for (intptr_t offset = Instance::NextFieldOffset();
+       offset < next_field_offset; offset += kWordSize) {
     member ^= *reinterpret_cast<RawObject**>(this_addr + offset);
     hash = CombineHashes(hash, member.CanonicalizeHash());
   }
@@ -19734,6 +20250,9 @@ RawDouble* Double::NewCanonical(const String& str) {
 }
 
 RawString* Number::ToString(Heap::Space space) const {
+  if (IsDouble()) {
+    return DoubleToString(Double::Cast(*this).value(), space);
+  }
   // Refactoring can avoid Zone::Alloc and strlen, but gains are insignificant.
   const char* cstr = ToCString();
   intptr_t len = strlen(cstr);
@@ -20074,6 +20593,40 @@ bool String::StartsWith(const String& other) const {
   return true;
 }
 
+intptr_t String::IndexOfCodeUnit(uint16_t c,
+                                 intptr_t from,
+                                 intptr_t to) const {
+  ASSERT((0 <= from) && (to <= Length()));
+  if (from >= to) {
+    return to;
+  }
+  NoSafepointScope no_safepoint;
+  if (IsOneByteString() || IsExternalOneByteString()) {
+    if (c > 0xFF) {
+      return to;
+    }
+    const uint8_t* data = IsOneByteString()
+                              ? OneByteString::CharAddr(*this, from)
+                              : ExternalOneByteString::CharAddr(*this, from);
+    // The C library's memchr is vectorized.
+    const void* found = memchr(data, c, to - from);
+    if (found == NULL) {
+      return to;
+    }
+    return from + (reinterpret_cast<const uint8_t*>(found) - data);
+  }
+  ASSERT(IsTwoByteString() || IsExternalTwoByteString());
+  const uint16_t* data = IsTwoByteString()
+                             ? TwoByteString::CharAddr(*this, from)
+                             : ExternalTwoByteString::CharAddr(*this, from);
+  for (intptr_t i = 0; i < to - from; i++) {
+    if (data[i] == c) {
+      return from + i;
+    }
+  }
+  return to;
+}
+
 RawInstance* String::CheckAndCanonicalize(Thread* thread,
                                           const char** error_str) const {
   if (IsCanonical()) {
@@ -20612,12 +21165,24 @@ RawString* String::Transform(int32_t (*mapping)(int32_t ch),
 }
 
 RawString* String::ToUpperCase(const String& str, Heap::Space space) {
-  // TODO(cshapiro): create a fast-path for OneByteString instances.
+  if (str.IsOneByteString()) {
+    const bool kToUpper = true;
+    RawString* result = OneByteString::ConvertAsciiCase(str, kToUpper, space);
+    if (result != String::null()) {
+      return result;
+    }
+  }
   return Transform(CaseMapping::ToUpper, str, space);
 }
 
 RawString* String::ToLowerCase(const String& str, Heap::Space space) {
-  // TODO(cshapiro): create a fast-path for OneByteString instances.
+  if (str.IsOneByteString()) {
+    const bool kToUpper = false;
+    RawString* result = OneByteString::ConvertAsciiCase(str, kToUpper, space);
+    if (result != String::null()) {
+      return result;
+    }
+  }
   return Transform(CaseMapping::ToLower, str, space);
 }
 
@@ -20984,6 +21549,74 @@ RawOneByteString* OneByteString::Transform(int32_t (*mapping)(int32_t ch),
   return OneByteString::raw(result);
 }
 
+// Byte-wise masks for ConvertAsciiCase. For a word of ASCII characters,
+// adding kAsciiAbove(c) to it sets the high bit of exactly the bytes above c
+// without carrying into the next byte.
+static const uword kAsciiBytes = ~static_cast<uword>(0) / 0xFF;
+static const uword kAsciiHighBits = kAsciiBytes * 0x80;
+
+static inline uword AsciiAbove(uint8_t c) {
+  return kAsciiBytes * (0x7F - c);
+}
+
+// Returns the high bit of each byte of "word" that is in [first, last].
+static inline uword AsciiInRange(uword word, uint8_t first, uint8_t last) {
+  const uword above_last = word + AsciiAbove(last);
+  const uword at_least_first = word + AsciiAbove(first - 1);
+  return at_least_first & ~above_last & kAsciiHighBits;
+}
+
+RawString* OneByteString::ConvertAsciiCase(const String& str,
+                                           bool to_upper,
+                                           Heap::Space space) {
+  ASSERT(str.IsOneByteString());
+  const uint8_t first = to_upper ? 'a' : 'A';
+  const uint8_t last = to_upper ? 'z' : 'Z';
+  const intptr_t len = str.Length();
+  const intptr_t word_end = len - (len % kWordSize);
+  bool changes = false;
+  {
+    NoSafepointScope no_safepoint;
+    const uint8_t* chars = DataStart(str);
+    uword all = 0;
+    uword to_change = 0;
+    for (intptr_t i = 0; i < word_end; i += kWordSize) {
+      uword word;
+      memmove(&word, chars + i, kWordSize);
+      all |= word;
+      to_change |= AsciiInRange(word, first, last);
+    }
+    for (intptr_t i = word_end; i < len; i++) {
+      const uint8_t c = chars[i];
+      all |= c;
+      to_change |= ((c >= first) && (c <= last)) ? 1 : 0;
+    }
+    if ((all & kAsciiHighBits) != 0) {
+      return String::null();
+    }
+    changes = (to_change != 0);
+  }
+  if (!changes) {
+    return str.raw();
+  }
+  const String& result = String::Handle(OneByteString::New(len, space));
+  NoSafepointScope no_safepoint;
+  const uint8_t* chars = DataStart(str);
+  uint8_t* dst = DataStart(result);
+  // The case bit of an ASCII letter is 0x20, the high bit shifted by two.
+  for (intptr_t i = 0; i < word_end; i += kWordSize) {
+    uword word;
+    memmove(&word, chars + i, kWordSize);
+    word ^= AsciiInRange(word, first, last) >> 2;
+    memmove(dst + i, &word, kWordSize);
+  }
+  for (intptr_t i = word_end; i < len; i++) {
+    const uint8_t c = chars[i];
+    dst[i] = ((c >= first) && (c <= last)) ? (c ^ 0x20) : c;
+  }
+  return result.raw();
+}
+
 RawOneByteString* OneByteString::SubStringUnchecked(const String& str,
                                                     intptr_t begin_index,
                                                     intptr_t length,
@@ -21344,6 +21977,11 @@ RawArray* Array::New(intptr_t class_id, intptr_t len, Heap::Space space) {
         Object::Allocate(class_id, Array::InstanceSize(len), space));
     NoSafepointScope no_safepoint;
     raw->StoreSmi(&(raw->ptr()->length_), Smi::New(len));
+    if (UseCardMarkingForAllocation(len)) {
+      ASSERT(raw->IsOldObject());
+      raw->SetCardRememberedBitUnsynchronized();
+      HeapPage::Of(raw)->AllocateCardTable();
+    }
     return raw;
   }
 }
@@ -21364,6 +22002,46 @@ RawArray* Array::Slice(intptr_t start,
   return dest.raw();
 }
 
+void Array::CopyFrom(intptr_t dest_start,
+                     const Array& source,
+                     intptr_t source_start,
+                     intptr_t count) const {
+  if (count <= 0) return;
+  ASSERT((dest_start >= 0) && (dest_start + count <= Length()));
+  ASSERT((source_start >= 0) && (source_start + count <= source.Length()));
+  NoSafepointScope no_safepoint;
+  RawObject** to = const_cast<RawObject**>(ObjectAddr(dest_start));
+  RawObject* const* from = source.ObjectAddr(source_start);
+  RawArray* dest = raw();
+  if (dest->IsCardRemembered()) {
+    // Keep the per-slot cards precise, copying in the direction that is safe
+    // for overlapping ranges.
+    if (to <= from) {
+      for (intptr_t i = 0; i < count; i++) {
+        dest->StoreArrayPointer(&to[i], from[i]);
+      }
+    } else {
+      for (intptr_t i = count - 1; i >= 0; i--) {
+        dest->StoreArrayPointer(&to[i], from[i]);
+      }
+    }
+    return;
+  }
+  memmove(to, from, count * kWordSize);
+  if (!dest->IsOldObject() || dest->IsRemembered()) return;
+  // Apply the barrier of StorePointer once for the whole range.
+  Thread* thread = Thread::Current();
+  const bool is_marking = thread->is_marking();
+  for (intptr_t i = 0; i < count; i++) {
+    RawObject* value = to[i];
+    if (value->IsHeapObject() && (is_marking || value->IsNewObject())) {
+      dest->SetRememberedBit();
+      thread->StoreBufferAddObject(dest);
+      return;
+    }
+  }
+}
+
 void Array::MakeImmutable() const {
   if (IsImmutable()) return;
   ASSERT(!IsCanonical());
@@ -21957,10 +22635,8 @@ RawTypedData* TypedData::New(intptr_t class_id,
         class_id, TypedData::InstanceSize(lengthInBytes), space);
     NoSafepointScope no_safepoint;
     result ^= raw;
+    // The data is zeroed by Object::Allocate.
     result.SetLength(len);
-    if (len > 0) {
-      memset(result.DataAddr(0), 0, lengthInBytes);
-    }
   }
   return result.raw();
 }
@@ -22037,6 +22713,76 @@ const char* Capability::ToCString() const {
   return "Capability";
 }
 
+class TransferableTypedDataPeer {
+ public:
+  TransferableTypedDataPeer(uint8_t* data, intptr_t length)
+      : data_(data), length_(length) {}
+  ~TransferableTypedDataPeer() { free(data_); }
+
+  uint8_t* data() const { return data_; }
+  intptr_t length() const { return length_; }
+
+  uint8_t* Detach() {
+    uint8_t* data = data_;
+    data_ = NULL;
+    length_ = 0;
+    return data;
+  }
+
+  static void Finalizer(void* isolate_callback_data,
+                        Dart_WeakPersistentHandle handle,
+                        void* peer) {
+    delete reinterpret_cast<TransferableTypedDataPeer*>(peer);
+  }
+
+ private:
+  uint8_t* data_;
+  intptr_t length_;
+
+  DISALLOW_COPY_AND_ASSIGN(TransferableTypedDataPeer);
+};
+
+RawTransferableTypedData* TransferableTypedData::New(uint8_t* data,
+                                                     intptr_t length_in_bytes,
+                                                     Heap::Space space) {
+  ASSERT(length_in_bytes >= 0);
+  TransferableTypedDataPeer* peer =
+      new TransferableTypedDataPeer(data, (data == NULL) ? 0 : length_in_bytes);
+  TransferableTypedData& result = TransferableTypedData::Handle();
+  {
+    RawObject* raw =
+        Object::Allocate(TransferableTypedData::kClassId,
+                         TransferableTypedData::InstanceSize(), space);
+    NoSafepointScope no_safepoint;
+    result ^= raw;
+    result.StoreNonPointer(&result.raw_ptr()->peer_, peer);
+  }
+  AddFinalizer(result, peer, TransferableTypedDataPeer::Finalizer,
+               peer->length());
+  return result.raw();
+}
+
+bool TransferableTypedData::IsDetached() const {
+  return reinterpret_cast<TransferableTypedDataPeer*>(raw_ptr()->peer_)
+             ->data() == NULL;
+}
+
+intptr_t TransferableTypedData::LengthInBytes() const {
+  return reinterpret_cast<TransferableTypedDataPeer*>(raw_ptr()->peer_)
+      ->length();
+}
+
+uint8_t* TransferableTypedData::Detach(intptr_t* length_in_bytes) const {
+  TransferableTypedDataPeer* peer =
+      reinterpret_cast<TransferableTypedDataPeer*>(raw_ptr()->peer_);
+  *length_in_bytes = peer->length();
+  return peer->Detach();
+}
+
+const char* TransferableTypedData::ToCString() const {
+  return "TransferableTypedData";
+}
+
 RawReceivePort* ReceivePort::New(Dart_Port id,
                                  bool is_control_port,
                                  Heap::Space space) {
@@ -22245,6 +22991,10 @@ bool StackTrace::expand_inlined() const {
   return raw_ptr()->expand_inlined_;
 }
 
+void StackTrace::set_is_partial(bool value) const {
+  StoreNonPointer(&raw_ptr()->is_partial_, value);
+}
+
 RawStackTrace* StackTrace::New(const Array& code_array,
                                const Array& pc_offset_array,
                                Heap::Space space) {
@@ -22258,6 +23008,7 @@ RawStackTrace* StackTrace::New(const Array& code_array,
   result.set_code_array(code_array);
   result.set_pc_offset_array(pc_offset_array);
   result.set_expand_inlined(true);  // default.
+  result.set_is_partial(false);
   return result.raw();
 }
 
@@ -22276,6 +23027,7 @@ RawStackTrace* StackTrace::New(const Array& code_array,
   result.set_code_array(code_array);
   result.set_pc_offset_array(pc_offset_array);
   result.set_expand_inlined(true);  // default.
+  result.set_is_partial(false);
   return result.raw();
 }
 
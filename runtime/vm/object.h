@@ -441,6 +441,12 @@ class Object {
   static void SetCachedHash(RawObject* obj, uint32_t hash) {
     obj->ptr()->hash_ = hash;
   }
+#else
+  // Instances of Dart classes whose last field is followed by an alignment
+  // padding word keep their identity hash there, as a Smi, instead of in the
+  // heap's hash table. The word is null until a hash is set and moves with
+  // the object. Returns NULL if obj has no such word.
+  static RawObject** IdentityHashSlot(RawObject* obj);
 #endif
 
   // Compiler's constant propagation constants.
@@ -731,10 +737,14 @@ class Object {
     return -kWordSize;
   }
 
+  // Initializes the header and fills the body of a new object. Typed data
+  // is filled with zeros, which is skipped if the memory at address is known
+  // to be zeroed already.
   static void InitializeObject(uword address,
                                intptr_t id,
                                intptr_t size,
-                               bool is_vm_object);
+                               bool is_vm_object,
+                               bool is_zeroed = false);
 
   static void RegisterClass(const Class& cls,
                             const String& name,
@@ -1352,9 +1362,15 @@ class Class : public Object {
   RawArray* constants() const;
   void set_constants(const Array& value) const;
 
+  // Dispatchers are identified by their index in InvocationDispatcherEntries,
+  // which does not change as more dispatchers are added.
   intptr_t FindInvocationDispatcherFunctionIndex(const Function& needle) const;
   RawFunction* InvocationDispatcherFunctionFromIndex(intptr_t idx) const;
 
+  // The [name, args_desc, dispatcher] entries of the invocation dispatcher
+  // cache, in the order they were added. Unused entries have a null name.
+  RawArray* InvocationDispatcherEntries() const;
+
   RawFunction* GetInvocationDispatcher(const String& target_name,
                                        const Array& args_desc,
                                        RawFunction::Kind kind,
@@ -1413,11 +1429,14 @@ class Class : public Object {
   // Allocate the raw ExternalTypedData classes.
   static RawClass* NewExternalTypedDataClass(intptr_t class_id);
 
-  // Register code that has used CHA for optimization.
-  // TODO(srdjan): Also register kind of CHA optimization (e.g.: leaf class,
-  // leaf method, ...).
-  void RegisterCHACode(const Code& code);
+  // Register code that has used CHA for optimization. If selectors is not
+  // null, the code only relies on subclasses not overriding the methods
+  // named in it, and a new subclass inheriting all of them leaves the code
+  // alone. Otherwise any new subclass disables the code.
+  void RegisterCHACode(const Code& code, const Array& selectors) const;
 
+  // Disables the code registered with RegisterCHACode that adding subclass
+  // invalidates, or all of it if subclass is null.
   void DisableCHAOptimizedCode(const Class& subclass);
 
   void DisableAllCHAOptimizedCode();
@@ -1755,6 +1774,12 @@ class ICData : public Object {
 
   RawArray* arguments_descriptor() const { return raw_ptr()->args_descriptor_; }
 
+  // For 'call' invocations on closures all receivers share the same class id,
+  // so the function of the first closure invoked is recorded separately.
+  // Optimized code may speculate on it being the only target.
+  RawFunction* closure_target() const { return raw_ptr()->closure_target_; }
+  void set_closure_target(const Function& value) const;
+
   intptr_t NumArgsTested() const;
 
   intptr_t TypeArgsLen() const;
@@ -1786,6 +1811,7 @@ class ICData : public Object {
   V(DoubleToSmi)                                                               \
   V(CheckSmi)                                                                  \
   V(CheckClass)                                                                \
+  V(CheckClosureFunction)                                                      \
   V(Unknown)                                                                   \
   V(PolymorphicInstanceCallTestFail)                                           \
   V(UnaryInt64Op)                                                              \
@@ -3697,6 +3723,13 @@ class DictionaryIterator : public ValueObject {
   RawObject* GetNext();
 
  private:
+  // Classes and library prefixes are never deferred, iterating over them does
+  // not need to load the top level members.
+  DictionaryIterator(const Library& library, bool load_top_level_members);
+
+  static RawArray* DictionaryOf(const Library& library,
+                                bool load_top_level_members);
+
   void MoveToNextObject();
 
   const Array& array_;
@@ -3811,6 +3844,9 @@ class Library : public Object {
   // more regular.
   void AddClass(const Class& cls) const;
   void AddObject(const Object& obj, const String& name) const;
+  // Loads the top level fields and functions if the kernel loader deferred
+  // them. Returns true if members were loaded.
+  bool LoadPendingTopLevelMembers() const;
   void ReplaceObject(const Object& obj, const String& name) const;
   RawObject* LookupReExport(const String& name,
                             ZoneGrowableArray<intptr_t>* visited = NULL) const;
@@ -4040,6 +4076,7 @@ class Library : public Object {
   void RehashDictionary(const Array& old_dict, intptr_t new_dict_size) const;
   static RawLibrary* NewLibraryHelper(const String& url, bool import_core_lib);
   RawObject* LookupEntry(const String& name, intptr_t* index) const;
+  RawObject* LookupLoadedEntry(const String& name, intptr_t* index) const;
 
   void AllocatePrivateKey() const;
 
@@ -5104,20 +5141,6 @@ class Code : public Object {
   class PtrOffBits
       : public BitField<int32_t, intptr_t, kPtrOffBit, kPtrOffSize> {};
 
-  class SlowFindRawCodeVisitor : public FindObjectVisitor {
-   public:
-    explicit SlowFindRawCodeVisitor(uword pc) : pc_(pc) {}
-    virtual ~SlowFindRawCodeVisitor() {}
-
-    // Check if object matches find condition.
-    virtual bool FindObject(RawObject* obj) const;
-
-   private:
-    const uword pc_;
-
-    DISALLOW_COPY_AND_ASSIGN(SlowFindRawCodeVisitor);
-  };
-
   static bool IsOptimized(RawCode* code) {
     return Code::OptimizedBit::decode(code->ptr()->state_bits_);
   }
@@ -5327,9 +5350,21 @@ class MegamorphicCache : public Object {
 
   RawArray* arguments_descriptor() const { return raw_ptr()->args_descriptor_; }
 
+  // Caches of selectors that have a row in the AOT global dispatch table
+  // refer to the table. The megamorphic call stub looks up the target in
+  // that row before probing the cache.
+  RawArray* dispatch_table() const { return raw_ptr()->dispatch_table_; }
+  intptr_t dispatch_row() const;
+  void set_dispatch_table_row(const Array& table, intptr_t row) const;
+
   intptr_t filled_entry_count() const;
   void set_filled_entry_count(intptr_t num) const;
 
+  // The number of misses handled by the runtime, for
+  // --dump_megamorphic_stats.
+  intptr_t miss_count() const { return raw_ptr()->miss_count_; }
+  void set_miss_count(intptr_t count) const;
+
   static intptr_t buckets_offset() {
     return OFFSET_OF(RawMegamorphicCache, buckets_);
   }
@@ -5339,6 +5374,12 @@ class MegamorphicCache : public Object {
   static intptr_t arguments_descriptor_offset() {
     return OFFSET_OF(RawMegamorphicCache, args_descriptor_);
   }
+  static intptr_t dispatch_table_offset() {
+    return OFFSET_OF(RawMegamorphicCache, dispatch_table_);
+  }
+  static intptr_t dispatch_row_offset() {
+    return OFFSET_OF(RawMegamorphicCache, dispatch_row_);
+  }
 
   static RawMegamorphicCache* New(const String& target_name,
                                   const Array& arguments_descriptor);
@@ -5347,6 +5388,9 @@ class MegamorphicCache : public Object {
 
   void Insert(const Smi& class_id, const Function& target) const;
 
+  // Whether the cache has an entry for class_id.
+  bool Contains(intptr_t class_id) const;
+
   static intptr_t InstanceSize() {
     return RoundedAllocationSize(sizeof(RawMegamorphicCache));
   }
@@ -5390,18 +5434,48 @@ class SubtypeTestCache : public Object {
     kTestEntryLength = 5,
   };
 
+  // The checks are kept in an open addressing hash table of mask() + 1 home
+  // entries, at most half of them used, followed by one entry that always
+  // stays unused. A lookup starts at the entry given by the hash and probes
+  // the following entries, without wrapping around, until it finds the check
+  // or an unused entry, whose kInstanceClassIdOrFunction is null.
+  //
+  // The hash only combines the instance class id (kClosureCid for closures)
+  // and the cached hash of the instance type arguments, which every
+  // Subtype*TestCache stub loads, so that all stubs probe the same entries.
+  static const intptr_t kInitialCapacity = 4;
+  static const intptr_t kSpreadFactor = 7;
+
   intptr_t NumberOfChecks() const;
   void AddCheck(const Object& instance_class_id_or_function,
                 const TypeArguments& instance_type_arguments,
                 const TypeArguments& instantiator_type_arguments,
                 const TypeArguments& function_type_arguments,
                 const Bool& test_result) const;
+  // Returns the ix-th check in table order, ix < NumberOfChecks().
   void GetCheck(intptr_t ix,
                 Object* instance_class_id_or_function,
                 TypeArguments* instance_type_arguments,
                 TypeArguments* instantiator_type_arguments,
                 TypeArguments* function_type_arguments,
                 Bool* test_result) const;
+  bool HasCheck(const Object& instance_class_id_or_function,
+                const TypeArguments& instance_type_arguments,
+                const TypeArguments& instantiator_type_arguments,
+                const TypeArguments& function_type_arguments) const;
+
+  // Adds the number of entries a lookup of each check probes to
+  // probe_lengths, e.g. 1 for a check in its home entry.
+  void CollectProbeLengths(GrowableArray<intptr_t>* probe_lengths) const;
+
+  // Returns the entry of the check for these inputs, or NULL. For the
+  // interpreters, which look up the cache themselves.
+  static RawObject** LookupRaw(RawSubtypeTestCache* cache,
+                               intptr_t instance_cid,
+                               RawObject* instance_class_id_or_function,
+                               RawTypeArguments* instance_type_arguments,
+                               RawTypeArguments* instantiator_type_arguments,
+                               RawTypeArguments* function_type_arguments);
 
   static RawSubtypeTestCache* New();
 
@@ -5412,13 +5486,36 @@ class SubtypeTestCache : public Object {
   static intptr_t cache_offset() {
     return OFFSET_OF(RawSubtypeTestCache, cache_);
   }
+  static intptr_t mask_offset() {
+    return OFFSET_OF(RawSubtypeTestCache, mask_);
+  }
 
  private:
   RawArray* cache() const { return raw_ptr()->cache_; }
 
   void set_cache(const Array& value) const;
 
-  intptr_t TestEntryLength() const;
+  intptr_t mask() const;
+  void set_mask(intptr_t mask) const;
+
+  intptr_t filled_entry_count() const;
+  void set_filled_entry_count(intptr_t count) const;
+
+  static intptr_t Hash(intptr_t instance_cid,
+                       RawTypeArguments* instance_type_arguments);
+
+  // Stores the check into the first unused entry from its home entry on, or
+  // returns false if it would have to use the last entry.
+  static bool InsertEntry(const Array& table,
+                          intptr_t mask,
+                          const Object& instance_class_id_or_function,
+                          const TypeArguments& instance_type_arguments,
+                          const TypeArguments& instantiator_type_arguments,
+                          const TypeArguments& function_type_arguments,
+                          const Bool& test_result);
+
+  // Rehashes the checks into a table of at least 'capacity' home entries.
+  void Rehash(intptr_t capacity) const;
 
   FINAL_HEAP_OBJECT_IMPLEMENTATION(SubtypeTestCache, Object);
   friend class Class;
@@ -5976,6 +6073,7 @@ class TypeArguments : public Instance {
   static intptr_t instantiations_offset() {
     return OFFSET_OF(RawTypeArguments, instantiations_);
   }
+  static intptr_t hash_offset() { return OFFSET_OF(RawTypeArguments, hash_); }
 
   static const intptr_t kBytesPerElement = kWordSize;
   static const intptr_t kMaxElements = kSmiMax / kBytesPerElement;
@@ -7186,6 +7284,10 @@ class String : public Instance {
 
   bool StartsWith(const String& other) const;
 
+  // Returns the index of the first code unit equal to c in [from, to), or to
+  // if there is none.
+  intptr_t IndexOfCodeUnit(uint16_t c, intptr_t from, intptr_t to) const;
+
   // Strings are canonicalized using the symbol table.
   virtual RawInstance* CheckAndCanonicalize(Thread* thread,
                                             const char** error_str) const;
@@ -7483,6 +7585,13 @@ class OneByteString : public AllStatic {
                                      const String& str,
                                      Heap::Space space);
 
+  // Converts the case of "str", a OneByteString, a word at a time. Returns
+  // null if "str" has non-ASCII characters, whose case mapping needs the
+  // Unicode tables, and "str" itself if no character changes.
+  static RawString* ConvertAsciiCase(const String& str,
+                                     bool to_upper,
+                                     Heap::Space space);
+
   // High performance version of substring for one-byte strings.
   // "str" must be OneByteString.
   static RawOneByteString* SubStringUnchecked(const String& str,
@@ -7891,7 +8000,7 @@ class Array : public Instance {
   RawObject* At(intptr_t index) const { return *ObjectAddr(index); }
   void SetAt(intptr_t index, const Object& value) const {
     // TODO(iposva): Add storing NoSafepointScope.
-    StorePointer(ObjectAddr(index), value.raw());
+    raw()->StoreArrayPointer(ObjectAddr(index), value.raw());
   }
 
   bool IsImmutable() const { return raw()->GetClassId() == kImmutableArrayCid; }
@@ -7935,6 +8044,13 @@ class Array : public Instance {
     return RoundedAllocationSize(sizeof(RawArray) + (len * kBytesPerElement));
   }
 
+  // Arrays too large for new space are always allocated on a large page of
+  // their own, and remember the slots written to in a card table instead of
+  // being rescanned as a whole by every scavenge.
+  static bool UseCardMarkingForAllocation(intptr_t len) {
+    return InstanceSize(len) > Heap::kNewAllocatableSize;
+  }
+
   // Returns true if all elements are OK for canonicalization.
   virtual bool CheckAndCanonicalizeFields(Thread* thread,
                                           const char** error_str) const;
@@ -7972,6 +8088,15 @@ class Array : public Instance {
                   intptr_t count,
                   bool with_type_argument) const;
 
+  // Copies 'count' elements of 'source' starting at 'source_start' to this
+  // array starting at 'dest_start'. The ranges may overlap. Unlike a loop of
+  // SetAt, an array that is not card remembered is copied with one memmove
+  // and passes the write barrier at most once.
+  void CopyFrom(intptr_t dest_start,
+                const Array& source,
+                intptr_t source_start,
+                intptr_t count) const;
+
  protected:
   static RawArray* New(intptr_t class_id,
                        intptr_t len,
@@ -8062,7 +8187,7 @@ class GrowableObjectArray : public Instance {
     ASSERT(index < Length());
 
     // TODO(iposva): Add storing NoSafepointScope.
-    data()->StorePointer(ObjectAddr(index), value.raw());
+    data()->StoreArrayPointer(ObjectAddr(index), value.raw());
   }
 
   void Add(const Object& value, Heap::Space space = Heap::kNew) const;
@@ -8828,6 +8953,32 @@ class Capability : public Instance {
   friend class Class;
 };
 
+// A byte buffer whose contents can be handed to another isolate without
+// copying. Sending it, or materializing it into a typed data object, moves
+// the ownership of the contents and leaves this object detached.
+class TransferableTypedData : public Instance {
+ public:
+  bool IsDetached() const;
+  intptr_t LengthInBytes() const;
+
+  // Releases the contents to the caller, who becomes responsible for freeing
+  // them, and detaches this object. Returns NULL if it was already detached.
+  uint8_t* Detach(intptr_t* length_in_bytes) const;
+
+  static intptr_t InstanceSize() {
+    return RoundedAllocationSize(sizeof(RawTransferableTypedData));
+  }
+  // Takes ownership of the malloc'ed [data]. A NULL [data] creates a detached
+  // object.
+  static RawTransferableTypedData* New(uint8_t* data,
+                                       intptr_t length_in_bytes,
+                                       Heap::Space space = Heap::kNew);
+
+ private:
+  FINAL_HEAP_OBJECT_IMPLEMENTATION(TransferableTypedData, Instance);
+  friend class Class;
+};
+
 class ReceivePort : public Instance {
  public:
   RawSendPort* send_port() const { return raw_ptr()->send_port_; }
@@ -8882,6 +9033,9 @@ class StackTrace : public Instance {
   void set_async_link(const StackTrace& async_link) const;
   void set_expand_inlined(bool value) const;
 
+  bool is_partial() const { return raw_ptr()->is_partial_; }
+  void set_is_partial(bool value) const;
+
   RawArray* code_array() const { return raw_ptr()->code_array_; }
   RawCode* CodeAtFrame(intptr_t frame_index) const;
   void SetCodeAtFrame(intptr_t frame_index, const Code& code) const;
@@ -13,6 +13,7 @@
 #include "vm/raw_object.h"
 #include "vm/reusable_handles.h"
 #include "vm/visitor.h"
+#include "zlib/zlib.h"
 
 namespace dart {
 
@@ -334,6 +335,402 @@ intptr_t ObjectGraph::SizeReachableByClass(intptr_t class_id) {
   return total.size();
 }
 
+// Collects all strongly reachable objects, giving up once there are more
+// than 'max_count'.
+class CollectObjectsVisitor : public ObjectGraph::Visitor {
+ public:
+  CollectObjectsVisitor(MallocGrowableArray<RawObject*>* objects,
+                        intptr_t max_count)
+      : objects_(objects), max_count_(max_count), aborted_(false) {}
+
+  bool aborted() const { return aborted_; }
+
+  virtual Direction VisitObject(ObjectGraph::StackIterator* it) {
+    if (objects_->length() >= max_count_) {
+      aborted_ = true;
+      return kAbort;
+    }
+    objects_->Add(it->Get());
+    return kProceed;
+  }
+
+ private:
+  MallocGrowableArray<RawObject*>* objects_;
+  const intptr_t max_count_;
+  bool aborted_;
+
+  DISALLOW_COPY_AND_ASSIGN(CollectObjectsVisitor);
+};
+
+static int CompareObjectAddresses(RawObject* const* a, RawObject* const* b) {
+  const uword a_addr = reinterpret_cast<uword>(*a);
+  const uword b_addr = reinterpret_cast<uword>(*b);
+  return (a_addr < b_addr) ? -1 : ((a_addr > b_addr) ? 1 : 0);
+}
+
+// The graph of the reachable objects, in compressed sparse row form. Node 0
+// is the roots, and node i > 0 is the (i - 1)th object in address order.
+class HeapGraph : public ValueObject {
+ public:
+  static const uint32_t kNoNode = kMaxUint32;
+
+  // Per node: the object, its retained size, and the words of the edge
+  // offsets, the depth first search and the dominator computation.
+  static const intptr_t kBytesPerNode =
+      sizeof(RawObject*) + sizeof(intptr_t) + 13 * sizeof(uint32_t);
+  // Per edge: the successor and the predecessor.
+  static const intptr_t kBytesPerEdge = 2 * sizeof(uint32_t);
+
+  explicit HeapGraph(MallocGrowableArray<RawObject*>* objects)
+      : objects_(objects),
+        num_nodes_(objects->length() + 1),
+        succ_start_(NULL),
+        pred_start_(NULL),
+        preds_(NULL) {}
+
+  ~HeapGraph() {
+    free(succ_start_);
+    free(pred_start_);
+    free(preds_);
+  }
+
+  intptr_t num_nodes() const { return num_nodes_; }
+  RawObject* object(uint32_t node) const { return (*objects_)[node - 1]; }
+
+  uint32_t FindNode(RawObject* obj) const {
+    intptr_t lo = 0;
+    intptr_t hi = objects_->length() - 1;
+    while (lo <= hi) {
+      const intptr_t mid = lo + (hi - lo) / 2;
+      const RawObject* current = (*objects_)[mid];
+      if (current == obj) {
+        return static_cast<uint32_t>(mid + 1);
+      } else if (current < obj) {
+        lo = mid + 1;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    return kNoNode;
+  }
+
+  // The successors of the nodes are recorded in order, by visiting the
+  // pointers of each node with an EdgeVisitor after StartSuccessors.
+  void StartSuccessors(uint32_t node) {
+    if (succ_start_ == NULL) {
+      ASSERT(node == 0);
+      succ_start_ = reinterpret_cast<uint32_t*>(
+          malloc((num_nodes_ + 1) * sizeof(uint32_t)));
+    }
+    succ_start_[node] = succs_.length();
+  }
+  void FinishSuccessors() { succ_start_[num_nodes_] = succs_.length(); }
+
+  // Inverts the successors.
+  void BuildPredecessors();
+
+  uint32_t succ_start(uint32_t node) const { return succ_start_[node]; }
+  uint32_t succ(uint32_t edge) const { return succs_[edge]; }
+  uint32_t pred_start(uint32_t node) const { return pred_start_[node]; }
+  uint32_t pred(uint32_t edge) const { return preds_[edge]; }
+
+  class EdgeVisitor : public ObjectPointerVisitor {
+   public:
+    EdgeVisitor(Isolate* isolate, HeapGraph* graph, intptr_t max_edges)
+        : ObjectPointerVisitor(isolate),
+          graph_(graph),
+          max_edges_(max_edges),
+          overflow_(false) {}
+
+    bool overflow() const { return overflow_; }
+
+    virtual void VisitPointers(RawObject** first, RawObject** last) {
+      for (RawObject** current = first; current <= last; ++current) {
+        RawObject* obj = *current;
+        if (!obj->IsHeapObject()) {
+          continue;
+        }
+        // Objects that are not nodes, e.g., those of the VM isolate, do not
+        // take part in retaining.
+        const uint32_t node = graph_->FindNode(obj);
+        if (node == kNoNode) {
+          continue;
+        }
+        if (graph_->succs_.length() >= max_edges_) {
+          overflow_ = true;
+          return;
+        }
+        graph_->succs_.Add(node);
+      }
+    }
+
+   private:
+    HeapGraph* graph_;
+    const intptr_t max_edges_;
+    bool overflow_;
+
+    DISALLOW_COPY_AND_ASSIGN(EdgeVisitor);
+  };
+
+ private:
+  MallocGrowableArray<RawObject*>* objects_;
+  const intptr_t num_nodes_;
+  uint32_t* succ_start_;
+  MallocGrowableArray<uint32_t> succs_;
+  uint32_t* pred_start_;
+  uint32_t* preds_;
+
+  DISALLOW_COPY_AND_ASSIGN(HeapGraph);
+};
+
+void HeapGraph::BuildPredecessors() {
+  const intptr_t num_edges = succs_.length();
+  pred_start_ = reinterpret_cast<uint32_t*>(
+      calloc(num_nodes_ + 1, sizeof(uint32_t)));
+  preds_ = reinterpret_cast<uint32_t*>(malloc(num_edges * sizeof(uint32_t)));
+  // Count the predecessors of each node, then fill each node's range from
+  // its end.
+  for (intptr_t edge = 0; edge < num_edges; edge++) {
+    pred_start_[succs_[edge] + 1]++;
+  }
+  for (intptr_t node = 0; node < num_nodes_; node++) {
+    pred_start_[node + 1] += pred_start_[node];
+  }
+  uint32_t* pred_end = reinterpret_cast<uint32_t*>(
+      malloc(num_nodes_ * sizeof(uint32_t)));
+  memmove(pred_end, pred_start_ + 1, num_nodes_ * sizeof(uint32_t));
+  for (intptr_t node = num_nodes_ - 1; node >= 0; node--) {
+    for (uint32_t edge = succ_start_[node]; edge < succ_start_[node + 1];
+         edge++) {
+      preds_[--pred_end[succs_[edge]]] = node;
+    }
+  }
+  free(pred_end);
+}
+
+// The dominator tree of a HeapGraph, computed with the simple version of the
+// Lengauer-Tarjan algorithm. Nodes are numbered in the preorder of a depth
+// first search from the roots, and every array but 'dfnum_' is indexed by
+// these numbers.
+class DominatorTree : public ValueObject {
+ public:
+  explicit DominatorTree(const HeapGraph* graph)
+      : graph_(graph),
+        num_reached_(0),
+        dfnum_(NewArray(graph->num_nodes())),
+        vertex_(NewArray(graph->num_nodes())),
+        parent_(NewArray(graph->num_nodes())),
+        semi_(NewArray(graph->num_nodes())),
+        ancestor_(NewArray(graph->num_nodes())),
+        label_(NewArray(graph->num_nodes())),
+        idom_(NewArray(graph->num_nodes())),
+        bucket_head_(NewArray(graph->num_nodes())),
+        bucket_next_(NewArray(graph->num_nodes())) {}
+
+  ~DominatorTree() {
+    free(dfnum_);
+    free(vertex_);
+    free(parent_);
+    free(semi_);
+    free(ancestor_);
+    free(label_);
+    free(idom_);
+    free(bucket_head_);
+    free(bucket_next_);
+  }
+
+  void Compute() {
+    NumberNodes();
+    ComputeDominators();
+  }
+
+  void VisitRetainedSizes(ObjectGraph::RetainedSizeVisitor* visitor);
+
+ private:
+  static const uint32_t kNoNode = HeapGraph::kNoNode;
+
+  static uint32_t* NewArray(intptr_t length) {
+    return reinterpret_cast<uint32_t*>(malloc(length * sizeof(uint32_t)));
+  }
+
+  void NumberNodes();
+  void ComputeDominators();
+  uint32_t Eval(uint32_t v);
+  void Compress(uint32_t v);
+
+  const HeapGraph* graph_;
+  intptr_t num_reached_;
+  uint32_t* dfnum_;   // Node to preorder number, kNoNode if unreached.
+  uint32_t* vertex_;  // Preorder number to node.
+  uint32_t* parent_;
+  uint32_t* semi_;
+  uint32_t* ancestor_;
+  uint32_t* label_;
+  uint32_t* idom_;
+  uint32_t* bucket_head_;
+  uint32_t* bucket_next_;
+  // The path compressed by Compress.
+  MallocGrowableArray<uint32_t> path_;
+
+  DISALLOW_COPY_AND_ASSIGN(DominatorTree);
+};
+
+void DominatorTree::NumberNodes() {
+  const intptr_t num_nodes = graph_->num_nodes();
+  for (intptr_t node = 0; node < num_nodes; node++) {
+    dfnum_[node] = kNoNode;
+  }
+  // The search keeps the next successor to visit of each node on its path
+  // in 'label_', indexed by node, which is free until ComputeDominators.
+  MallocGrowableArray<uint32_t> stack;
+  dfnum_[0] = 0;
+  vertex_[0] = 0;
+  parent_[0] = kNoNode;
+  label_[0] = graph_->succ_start(0);
+  num_reached_ = 1;
+  stack.Add(0);
+  while (!stack.is_empty()) {
+    const uint32_t node = stack.Last();
+    if (label_[node] == graph_->succ_start(node + 1)) {
+      stack.RemoveLast();
+      continue;
+    }
+    const uint32_t succ = graph_->succ(label_[node]++);
+    if (dfnum_[succ] != kNoNode) {
+      continue;
+    }
+    dfnum_[succ] = num_reached_;
+    vertex_[num_reached_] = succ;
+    parent_[num_reached_] = dfnum_[node];
+    label_[succ] = graph_->succ_start(succ);
+    num_reached_++;
+    stack.Add(succ);
+  }
+}
+
+void DominatorTree::ComputeDominators() {
+  for (intptr_t v = 0; v < num_reached_; v++) {
+    semi_[v] = v;
+    label_[v] = v;
+    ancestor_[v] = kNoNode;
+    bucket_head_[v] = kNoNode;
+  }
+  for (intptr_t w = num_reached_ - 1; w > 0; w--) {
+    // Compute the semidominator of w.
+    const uint32_t node = vertex_[w];
+    for (uint32_t edge = graph_->pred_start(node);
+         edge < graph_->pred_start(node + 1); edge++) {
+      const uint32_t v = dfnum_[graph_->pred(edge)];
+      if (v == kNoNode) {
+        continue;
+      }
+      const uint32_t u = Eval(v);
+      if (semi_[u] < semi_[w]) {
+        semi_[w] = semi_[u];
+      }
+    }
+    bucket_next_[w] = bucket_head_[semi_[w]];
+    bucket_head_[semi_[w]] = w;
+    const uint32_t p = parent_[w];
+    ancestor_[w] = p;
+    // Implicitly define the immediate dominators of the bucket of p.
+    for (uint32_t v = bucket_head_[p]; v != kNoNode; v = bucket_next_[v]) {
+      const uint32_t u = Eval(v);
+      idom_[v] = (semi_[u] < semi_[v]) ? u : p;
+    }
+    bucket_head_[p] = kNoNode;
+  }
+  // Explicitly define the immediate dominators, in preorder.
+  idom_[0] = kNoNode;
+  for (intptr_t w = 1; w < num_reached_; w++) {
+    if (idom_[w] != semi_[w]) {
+      idom_[w] = idom_[idom_[w]];
+    }
+  }
+}
+
+uint32_t DominatorTree::Eval(uint32_t v) {
+  if (ancestor_[v] == kNoNode) {
+    return v;
+  }
+  Compress(v);
+  return label_[v];
+}
+
+void DominatorTree::Compress(uint32_t v) {
+  // Iterative version of the recursive path compression, since the paths
+  // of a heap can be far longer than the native stack allows.
+  ASSERT(ancestor_[v] != kNoNode);
+  ASSERT(path_.is_empty());
+  while (ancestor_[ancestor_[v]] != kNoNode) {
+    path_.Add(v);
+    v = ancestor_[v];
+  }
+  while (!path_.is_empty()) {
+    v = path_.RemoveLast();
+    const uint32_t a = ancestor_[v];
+    if (semi_[label_[a]] < semi_[label_[v]]) {
+      label_[v] = label_[a];
+    }
+    ancestor_[v] = ancestor_[a];
+  }
+}
+
+void DominatorTree::VisitRetainedSizes(
+    ObjectGraph::RetainedSizeVisitor* visitor) {
+  intptr_t* retained = reinterpret_cast<intptr_t*>(
+      malloc(num_reached_ * sizeof(intptr_t)));
+  retained[0] = 0;
+  for (intptr_t w = 1; w < num_reached_; w++) {
+    retained[w] = graph_->object(vertex_[w])->Size();
+  }
+  // A dominator precedes the nodes it dominates in preorder.
+  for (intptr_t w = num_reached_ - 1; w > 0; w--) {
+    retained[idom_[w]] += retained[w];
+  }
+  for (intptr_t w = 1; w < num_reached_; w++) {
+    visitor->VisitRetainedSize(graph_->object(vertex_[w]), retained[w]);
+  }
+  free(retained);
+}
+
+bool ObjectGraph::VisitRetainedSizes(RetainedSizeVisitor* visitor,
+                                     intptr_t memory_budget) {
+  MallocGrowableArray<RawObject*> objects;
+  CollectObjectsVisitor collector(&objects,
+                                  memory_budget / HeapGraph::kBytesPerNode);
+  IterateObjects(&collector);
+  if (collector.aborted()) {
+    return false;
+  }
+  objects.Sort(CompareObjectAddresses);
+
+  HeapGraph graph(&objects);
+  const intptr_t max_edges =
+      (memory_budget - graph.num_nodes() * HeapGraph::kBytesPerNode) /
+      HeapGraph::kBytesPerEdge;
+  HeapGraph::EdgeVisitor edges(isolate(), &graph, max_edges);
+  graph.StartSuccessors(0);
+  isolate()->VisitObjectPointers(&edges, ValidationPolicy::kDontValidateFrames);
+  for (intptr_t node = 1; node < graph.num_nodes(); node++) {
+    if (edges.overflow()) {
+      return false;
+    }
+    graph.StartSuccessors(node);
+    graph.object(node)->VisitPointers(&edges);
+  }
+  if (edges.overflow()) {
+    return false;
+  }
+  graph.FinishSuccessors();
+  graph.BuildPredecessors();
+
+  DominatorTree tree(&graph);
+  tree.Compute();
+  tree.VisitRetainedSizes(visitor);
+  return true;
+}
+
 class RetainingPathVisitor : public ObjectGraph::Visitor {
  public:
   // We cannot use a GrowableObjectArray, since we must not trigger GC.
@@ -506,7 +903,113 @@ intptr_t ObjectGraph::InboundReferences(Object* obj, const Array& references) {
   return visitor.length();
 }
 
-static void WritePtr(RawObject* raw, WriteStream* stream) {
+static uint8_t* ChunkAllocator(uint8_t* ptr,
+                               intptr_t old_size,
+                               intptr_t new_size) {
+  void* new_ptr = realloc(reinterpret_cast<void*>(ptr), new_size);
+  if (new_ptr == NULL) {
+    OUT_OF_MEMORY();
+  }
+  return reinterpret_cast<uint8_t*>(new_ptr);
+}
+
+// Room for the largest record written between two calls to MaybeFlush, so
+// the buffer never needs to grow.
+static const intptr_t kChunkSlack = 64;
+
+ChunkedWriter::ChunkedWriter(intptr_t chunk_size, bool compress, bool gzip)
+    : chunk_size_(chunk_size),
+      buffer_(NULL),
+      stream_(&buffer_, &ChunkAllocator, chunk_size + kChunkSlack),
+      compressed_buffer_(NULL),
+      zstream_(NULL),
+      chunk_count_(0),
+      node_count_(0) {
+  ASSERT(chunk_size > 0);
+  ASSERT(compress || !gzip);
+  if (compress) {
+    compressed_buffer_ = reinterpret_cast<uint8_t*>(malloc(chunk_size_));
+    if (compressed_buffer_ == NULL) {
+      OUT_OF_MEMORY();
+    }
+    zstream_ = new z_stream();
+    zstream_->zalloc = Z_NULL;
+    zstream_->zfree = Z_NULL;
+    zstream_->opaque = Z_NULL;
+    zstream_->next_out = compressed_buffer_;
+    zstream_->avail_out = chunk_size_;
+    // Adding 16 to the window bits selects the gzip wrapper.
+    const int window_bits = gzip ? (MAX_WBITS + 16) : MAX_WBITS;
+    int result = deflateInit2(zstream_, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                              window_bits, 8, Z_DEFAULT_STRATEGY);
+    if (result != Z_OK) {
+      FATAL1("Failed to initialize chunked output compression: %d", result);
+    }
+  }
+}
+
+ChunkedWriter::~ChunkedWriter() {
+  if (zstream_ != NULL) {
+    deflateEnd(zstream_);
+    delete zstream_;
+  }
+  free(compressed_buffer_);
+  free(buffer_);
+}
+
+void ChunkedWriter::EmitChunk(const uint8_t* data, intptr_t size, bool last) {
+  WriteChunk(data, size, last);
+  chunk_count_++;
+}
+
+void ChunkedWriter::Flush(bool last) {
+  intptr_t pending = stream_.bytes_written();
+  if (zstream_ == NULL) {
+    intptr_t offset = 0;
+    while (pending - offset >= chunk_size_) {
+      if (last && (pending - offset == chunk_size_)) {
+        break;
+      }
+      EmitChunk(buffer_ + offset, chunk_size_, false);
+      offset += chunk_size_;
+    }
+    if (last) {
+      EmitChunk(buffer_ + offset, pending - offset, true);
+      stream_.SetPosition(0);
+      return;
+    }
+    // Keep the tail of the last record for the next chunk.
+    memmove(buffer_, buffer_ + offset, pending - offset);
+    stream_.SetPosition(pending - offset);
+    return;
+  }
+
+  zstream_->next_in = buffer_;
+  zstream_->avail_in = pending;
+  for (;;) {
+    int result = deflate(zstream_, last ? Z_FINISH : Z_NO_FLUSH);
+    ASSERT((result == Z_OK) || (result == Z_STREAM_END) ||
+           (result == Z_BUF_ERROR));
+    if (last && (result == Z_STREAM_END)) {
+      break;
+    }
+    if (zstream_->avail_out == 0) {
+      EmitChunk(compressed_buffer_, chunk_size_, false);
+      zstream_->next_out = compressed_buffer_;
+      zstream_->avail_out = chunk_size_;
+    } else if (!last) {
+      // deflate stops early only once it has consumed all of its input.
+      ASSERT(zstream_->avail_in == 0);
+      break;
+    }
+  }
+  if (last) {
+    EmitChunk(compressed_buffer_, chunk_size_ - zstream_->avail_out, true);
+  }
+  stream_.SetPosition(0);
+}
+
+static void WritePtr(RawObject* raw, ChunkedWriter* writer) {
   ASSERT(raw->IsHeapObject());
   ASSERT(raw->IsOldObject());
   uword addr = RawObject::ToAddr(raw);
@@ -514,16 +1017,21 @@ static void WritePtr(RawObject* raw, WriteStream* stream) {
   // Using units of kObjectAlignment makes the ids fit into Smis when parsed
   // in the Dart code of the Observatory.
   // TODO(koda): Use delta-encoding/back-references to further compress this.
-  stream->WriteUnsigned(addr / kObjectAlignment);
+  writer->stream()->WriteUnsigned(addr / kObjectAlignment);
+}
+
+static void WriteUnsigned(intptr_t value, ChunkedWriter* writer) {
+  writer->stream()->WriteUnsigned(value);
+  writer->MaybeFlush();
 }
 
 class WritePointerVisitor : public ObjectPointerVisitor {
  public:
   WritePointerVisitor(Isolate* isolate,
-                      WriteStream* stream,
+                      ChunkedWriter* writer,
                       bool only_instances)
       : ObjectPointerVisitor(isolate),
-        stream_(stream),
+        writer_(writer),
         only_instances_(only_instances),
         count_(0) {}
   virtual void VisitPointers(RawObject** first, RawObject** last) {
@@ -539,7 +1047,8 @@ class WritePointerVisitor : public ObjectPointerVisitor {
                               (object->GetClassId() == kTypeArgumentsCid))) {
         continue;
       }
-      WritePtr(object, stream_);
+      WritePtr(object, writer_);
+      writer_->MaybeFlush();
       ++count_;
     }
   }
@@ -547,7 +1056,7 @@ class WritePointerVisitor : public ObjectPointerVisitor {
   intptr_t count() const { return count_; }
 
  private:
-  WriteStream* stream_;
+  ChunkedWriter* writer_;
   bool only_instances_;
   intptr_t count_;
 };
@@ -555,20 +1064,21 @@ class WritePointerVisitor : public ObjectPointerVisitor {
 static void WriteHeader(RawObject* raw,
                         intptr_t size,
                         intptr_t cid,
-                        WriteStream* stream) {
-  WritePtr(raw, stream);
+                        ChunkedWriter* writer) {
+  WritePtr(raw, writer);
   ASSERT(Utils::IsAligned(size, kObjectAlignment));
-  stream->WriteUnsigned(size);
-  stream->WriteUnsigned(cid);
+  writer->stream()->WriteUnsigned(size);
+  writer->stream()->WriteUnsigned(cid);
+  writer->MaybeFlush();
 }
 
 class WriteGraphVisitor : public ObjectGraph::Visitor {
  public:
   WriteGraphVisitor(Isolate* isolate,
-                    WriteStream* stream,
+                    ChunkedWriter* writer,
                     ObjectGraph::SnapshotRoots roots)
-      : stream_(stream),
-        ptr_writer_(isolate, stream, roots == ObjectGraph::kUser),
+      : writer_(writer),
+        ptr_writer_(isolate, writer, roots == ObjectGraph::kUser),
         roots_(roots),
         count_(0) {}
 
@@ -581,9 +1091,9 @@ class WriteGraphVisitor : public ObjectGraph::Visitor {
     if ((roots_ == ObjectGraph::kVM) || obj.IsField() || obj.IsInstance() ||
         obj.IsContext()) {
       // Each object is a header + a zero-terminated list of its neighbors.
-      WriteHeader(raw_obj, raw_obj->Size(), obj.GetClassId(), stream_);
+      WriteHeader(raw_obj, raw_obj->Size(), obj.GetClassId(), writer_);
       raw_obj->VisitPointers(&ptr_writer_);
-      stream_->WriteUnsigned(0);
+      WriteUnsigned(0, writer_);
       ++count_;
     }
     return kProceed;
@@ -592,7 +1102,7 @@ class WriteGraphVisitor : public ObjectGraph::Visitor {
   intptr_t count() const { return count_; }
 
  private:
-  WriteStream* stream_;
+  ChunkedWriter* writer_;
   WritePointerVisitor ptr_writer_;
   ObjectGraph::SnapshotRoots roots_;
   intptr_t count_;
@@ -600,8 +1110,8 @@ class WriteGraphVisitor : public ObjectGraph::Visitor {
 
 class WriteGraphExternalSizesVisitor : public HandleVisitor {
  public:
-  WriteGraphExternalSizesVisitor(Thread* thread, WriteStream* stream)
-      : HandleVisitor(thread), stream_(stream) {}
+  WriteGraphExternalSizesVisitor(Thread* thread, ChunkedWriter* writer)
+      : HandleVisitor(thread), writer_(writer) {}
 
   void VisitHandle(uword addr) {
     FinalizablePersistentHandle* weak_persistent_handle =
@@ -610,17 +1120,40 @@ class WriteGraphExternalSizesVisitor : public HandleVisitor {
       return;  // Free handle.
     }
 
-    WritePtr(weak_persistent_handle->raw(), stream_);
-    stream_->WriteUnsigned(weak_persistent_handle->external_size());
+    WritePtr(weak_persistent_handle->raw(), writer_);
+    WriteUnsigned(weak_persistent_handle->external_size(), writer_);
+  }
+
+ private:
+  ChunkedWriter* writer_;
+};
+
+// Collects all the chunks of a snapshot into a single stream.
+class WriteStreamChunkedWriter : public ChunkedWriter {
+ public:
+  explicit WriteStreamChunkedWriter(WriteStream* stream)
+      : ChunkedWriter(kChunkSize, false), stream_(stream) {}
+
+  virtual void WriteChunk(const uint8_t* data, intptr_t size, bool last) {
+    stream_->WriteBytes(data, size);
   }
 
  private:
+  static const intptr_t kChunkSize = 64 * KB;
+
   WriteStream* stream_;
 };
 
 intptr_t ObjectGraph::Serialize(WriteStream* stream,
                                 SnapshotRoots roots,
                                 bool collect_garbage) {
+  WriteStreamChunkedWriter writer(stream);
+  return Serialize(&writer, roots, collect_garbage);
+}
+
+intptr_t ObjectGraph::Serialize(ChunkedWriter* writer,
+                                SnapshotRoots roots,
+                                bool collect_garbage) {
   if (collect_garbage) {
     isolate()->heap()->CollectAllGarbage();
   }
@@ -633,45 +1166,45 @@ intptr_t ObjectGraph::Serialize(WriteStream* stream,
   RawObject* kStackAddress =
       reinterpret_cast<RawObject*>(kObjectAlignment + kHeapObjectTag);
 
-  stream->WriteUnsigned(kObjectAlignment);
-  stream->WriteUnsigned(kStackCid);
-  stream->WriteUnsigned(kFieldCid);
-  stream->WriteUnsigned(isolate()->class_table()->NumCids());
+  WriteUnsigned(kObjectAlignment, writer);
+  WriteUnsigned(kStackCid, writer);
+  WriteUnsigned(kFieldCid, writer);
+  WriteUnsigned(isolate()->class_table()->NumCids(), writer);
 
   if (roots == kVM) {
     // Write root "object".
-    WriteHeader(kRootAddress, 0, kRootCid, stream);
-    WritePointerVisitor ptr_writer(isolate(), stream, false);
+    WriteHeader(kRootAddress, 0, kRootCid, writer);
+    WritePointerVisitor ptr_writer(isolate(), writer, false);
     isolate()->VisitObjectPointers(&ptr_writer,
                                    ValidationPolicy::kDontValidateFrames);
-    stream->WriteUnsigned(0);
+    WriteUnsigned(0, writer);
   } else {
     {
       // Write root "object".
-      WriteHeader(kRootAddress, 0, kRootCid, stream);
-      WritePointerVisitor ptr_writer(isolate(), stream, false);
+      WriteHeader(kRootAddress, 0, kRootCid, writer);
+      WritePointerVisitor ptr_writer(isolate(), writer, false);
       IterateUserFields(&ptr_writer);
-      WritePtr(kStackAddress, stream);
-      stream->WriteUnsigned(0);
+      WritePtr(kStackAddress, writer);
+      WriteUnsigned(0, writer);
     }
 
     {
       // Write stack "object".
-      WriteHeader(kStackAddress, 0, kStackCid, stream);
-      WritePointerVisitor ptr_writer(isolate(), stream, true);
+      WriteHeader(kStackAddress, 0, kStackCid, writer);
+      WritePointerVisitor ptr_writer(isolate(), writer, true);
       isolate()->VisitStackPointers(&ptr_writer,
                                     ValidationPolicy::kDontValidateFrames);
-      stream->WriteUnsigned(0);
+      WriteUnsigned(0, writer);
     }
   }
 
-  WriteGraphVisitor visitor(isolate(), stream, roots);
+  WriteGraphVisitor visitor(isolate(), writer, roots);
   IterateObjects(&visitor);
-  stream->WriteUnsigned(0);
+  WriteUnsigned(0, writer);
 
-  WriteGraphExternalSizesVisitor external_visitor(Thread::Current(), stream);
+  WriteGraphExternalSizesVisitor external_visitor(Thread::Current(), writer);
   isolate()->VisitWeakPersistentHandles(&external_visitor);
-  stream->WriteUnsigned(0);
+  WriteUnsigned(0, writer);
 
   intptr_t object_count = visitor.count();
   if (roots == kVM) {
@@ -679,6 +1212,8 @@ intptr_t ObjectGraph::Serialize(WriteStream* stream,
   } else {
     object_count += 2;  // root and stack
   }
+  writer->set_node_count(object_count);
+  writer->Finish();
   return object_count;
 }
 
@@ -6,6 +6,9 @@
 #define RUNTIME_VM_OBJECT_GRAPH_H_
 
 #include "vm/allocation.h"
+#include "vm/datastream.h"
+
+struct z_stream_s;
 
 namespace dart {
 
@@ -13,7 +16,57 @@ class Array;
 class Isolate;
 class Object;
 class RawObject;
-class WriteStream;
+
+// Receives a heap snapshot in chunks of 'chunk_size' bytes while it is being
+// written, so the memory needed to produce a snapshot is bounded by the chunk
+// size rather than by the size of the heap. If 'compress' is true, the chunks
+// together form a single zlib stream; otherwise they are the raw snapshot.
+class ChunkedWriter {
+ public:
+  // With 'gzip', compressed output is framed as a gzip file instead of a zlib
+  // stream.
+  ChunkedWriter(intptr_t chunk_size, bool compress, bool gzip = false);
+  virtual ~ChunkedWriter();
+
+  // Called with each chunk of output. Every chunk but the last one is exactly
+  // 'chunk_size' bytes long. 'data' is only valid during the call.
+  virtual void WriteChunk(const uint8_t* data, intptr_t size, bool last) = 0;
+
+  WriteStream* stream() { return &stream_; }
+
+  // Hands completed chunks to WriteChunk. Must be called often enough that
+  // only a few bytes past 'chunk_size' are ever buffered.
+  void MaybeFlush() {
+    if (stream_.bytes_written() >= chunk_size_) {
+      Flush(false);
+    }
+  }
+
+  // Hands all buffered output to WriteChunk, ending with the last chunk.
+  void Finish() { Flush(true); }
+
+  bool compressed() const { return zstream_ != NULL; }
+  intptr_t chunk_size() const { return chunk_size_; }
+  intptr_t chunk_count() const { return chunk_count_; }
+
+  // The number of nodes in the snapshot, set before the last chunk is written.
+  intptr_t node_count() const { return node_count_; }
+  void set_node_count(intptr_t value) { node_count_ = value; }
+
+ private:
+  void Flush(bool last);
+  void EmitChunk(const uint8_t* data, intptr_t size, bool last);
+
+  const intptr_t chunk_size_;
+  uint8_t* buffer_;
+  WriteStream stream_;
+  uint8_t* compressed_buffer_;
+  struct z_stream_s* zstream_;
+  intptr_t chunk_count_;
+  intptr_t node_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(ChunkedWriter);
+};
 
 // Utility to traverse the object graph in an ordered fashion.
 // Example uses:
@@ -57,6 +110,15 @@ class ObjectGraph : public StackResource {
     virtual Direction VisitObject(StackIterator* it) = 0;
   };
 
+  class RetainedSizeVisitor {
+   public:
+    virtual ~RetainedSizeVisitor() {}
+    // Visits 'obj' and the number of bytes it retains, i.e., the total size
+    // of the objects it dominates, including itself. This method must not
+    // allocate from the heap or trigger GC in any way.
+    virtual void VisitRetainedSize(RawObject* obj, intptr_t retained_size) = 0;
+  };
+
   explicit ObjectGraph(Thread* thread);
   ~ObjectGraph();
 
@@ -78,6 +140,16 @@ class ObjectGraph : public StackResource {
   intptr_t SizeRetainedByClass(intptr_t class_id);
   intptr_t SizeReachableByClass(intptr_t class_id);
 
+  // Computes the dominator tree of all strongly reachable objects with the
+  // Lengauer-Tarjan algorithm and visits each object with its retained size.
+  // Unlike 'SizeRetainedByInstance', this costs a constant number of passes
+  // over the heap rather than one per object asked about. Returns false
+  // without visiting any object if the computation would use more than
+  // 'memory_budget' bytes of malloc'd memory. Must be called within a
+  // HeapIterationScope.
+  bool VisitRetainedSizes(RetainedSizeVisitor* visitor,
+                          intptr_t memory_budget);
+
   // Finds some retaining path from the isolate roots to 'obj'. Populates the
   // provided array with pairs of (object, offset from parent in words),
   // starting with 'obj' itself, as far as there is room. Returns the number
@@ -103,11 +175,17 @@ class ObjectGraph : public StackResource {
   // Returns the number of nodes in the stream, including the root.
   // If collect_garbage is false, the graph will include weakly-reachable
   // objects.
-  // TODO(koda): Document format; support streaming/chunking.
+  // TODO(koda): Document format.
   intptr_t Serialize(WriteStream* stream,
                      SnapshotRoots roots,
                      bool collect_garbage);
 
+  // Like 'Serialize', but passes the graph to 'writer' in chunks as it is
+  // traversed instead of accumulating all of it first.
+  intptr_t Serialize(ChunkedWriter* writer,
+                     SnapshotRoots roots,
+                     bool collect_garbage);
+
  private:
   DISALLOW_IMPLICIT_CONSTRUCTORS(ObjectGraph);
 };
@@ -138,4 +138,136 @@ ISOLATE_UNIT_TEST_CASE(ObjectGraph) {
   }
 }
 
+class RetainedSizeRecorder : public ObjectGraph::RetainedSizeVisitor {
+ public:
+  RetainedSizeRecorder(RawObject* const* objects, intptr_t* sizes, intptr_t n)
+      : objects_(objects), sizes_(sizes), n_(n) {}
+
+  virtual void VisitRetainedSize(RawObject* obj, intptr_t retained_size) {
+    for (intptr_t i = 0; i < n_; i++) {
+      if (objects_[i] == obj) {
+        sizes_[i] = retained_size;
+      }
+    }
+  }
+
+ private:
+  RawObject* const* objects_;
+  intptr_t* sizes_;
+  intptr_t n_;
+};
+
+ISOLATE_UNIT_TEST_CASE(ObjectGraphRetainedSizes) {
+  // The graph of the ObjectGraph test, with objects a, b, c, d:
+  //  a+->b+->c
+  //  +   +
+  //  |   v
+  //  +-->d
+  // a dominates all of them, and b only c.
+  Array& a = Array::Handle(Array::New(12, Heap::kNew));
+  Array& b = Array::Handle(Array::New(2, Heap::kOld));
+  Array& c = Array::Handle(Array::New(0, Heap::kOld));
+  Array& d = Array::Handle(Array::New(0, Heap::kOld));
+  a.SetAt(10, b);
+  b.SetAt(0, c);
+  b.SetAt(1, d);
+  a.SetAt(11, d);
+  intptr_t a_size = a.raw()->Size();
+  intptr_t b_size = b.raw()->Size();
+  intptr_t c_size = c.raw()->Size();
+  intptr_t d_size = d.raw()->Size();
+  {
+    // No more allocation; raw pointers ahead.
+    SafepointOperationScope safepoint(thread);
+    RawObject* objects[] = {a.raw(), b.raw(), c.raw(), d.raw()};
+    intptr_t sizes[] = {-1, -1, -1, -1};
+    // Clear handles to cut unintended retained paths.
+    b = Array::null();
+    c = Array::null();
+    d = Array::null();
+    ObjectGraph graph(thread);
+    HeapIterationScope iteration_scope(thread, true);
+    RetainedSizeRecorder recorder(objects, sizes, 4);
+    EXPECT(graph.VisitRetainedSizes(&recorder, 1 * GB));
+    EXPECT_EQ(a_size + b_size + c_size + d_size, sizes[0]);
+    EXPECT_EQ(b_size + c_size, sizes[1]);
+    EXPECT_EQ(c_size, sizes[2]);
+    EXPECT_EQ(d_size, sizes[3]);
+    // A budget too small for the heap is refused.
+    EXPECT(!graph.VisitRetainedSizes(&recorder, 1 * KB));
+  }
+}
+
+static uint8_t* TestAllocator(uint8_t* ptr,
+                              intptr_t old_size,
+                              intptr_t new_size) {
+  return reinterpret_cast<uint8_t*>(realloc(ptr, new_size));
+}
+
+class CollectingChunkedWriter : public ChunkedWriter {
+ public:
+  CollectingChunkedWriter(intptr_t chunk_size, bool compress)
+      : ChunkedWriter(chunk_size, compress),
+        buffer_(NULL),
+        output_(&buffer_, &TestAllocator, 1 * KB),
+        saw_last_(false) {}
+  ~CollectingChunkedWriter() { free(buffer_); }
+
+  virtual void WriteChunk(const uint8_t* data, intptr_t size, bool last) {
+    EXPECT(!saw_last_);
+    if (last) {
+      EXPECT_LE(size, chunk_size());
+    } else {
+      EXPECT_EQ(chunk_size(), size);
+    }
+    saw_last_ = last;
+    output_.WriteBytes(data, size);
+  }
+
+  const uint8_t* output() const { return buffer_; }
+  intptr_t output_size() const { return output_.bytes_written(); }
+  bool saw_last() const { return saw_last_; }
+
+ private:
+  uint8_t* buffer_;
+  WriteStream output_;
+  bool saw_last_;
+};
+
+ISOLATE_UNIT_TEST_CASE(ObjectGraphChunkedSerialize) {
+  HANDLESCOPE(thread);
+  Array& a = Array::Handle(Array::New(1000, Heap::kOld));
+  for (intptr_t i = 0; i < a.Length(); i++) {
+    a.SetAt(i, Array::Handle(Array::New(1, Heap::kOld)));
+  }
+  ObjectGraph graph(thread);
+
+  uint8_t* buffer = NULL;
+  WriteStream stream(&buffer, &TestAllocator, 1 * KB);
+  intptr_t node_count = graph.Serialize(&stream, ObjectGraph::kVM, false);
+  EXPECT_LT(1000, node_count);
+
+  {
+    CollectingChunkedWriter writer(1 * KB, false);
+    EXPECT_EQ(node_count, graph.Serialize(&writer, ObjectGraph::kVM, false));
+    EXPECT(writer.saw_last());
+    EXPECT_EQ(node_count, writer.node_count());
+    EXPECT_EQ(stream.bytes_written(), writer.output_size());
+    EXPECT_EQ(0, memcmp(buffer, writer.output(), writer.output_size()));
+    EXPECT_EQ((writer.output_size() + KB - 1) / KB, writer.chunk_count());
+  }
+
+  {
+    CollectingChunkedWriter writer(1 * KB, true);
+    EXPECT(writer.compressed());
+    EXPECT_EQ(node_count, graph.Serialize(&writer, ObjectGraph::kVM, false));
+    EXPECT(writer.saw_last());
+    // A zlib stream starts with a deflate method byte.
+    EXPECT_LT(2, writer.output_size());
+    EXPECT_EQ(0x78, writer.output()[0]);
+    EXPECT_LT(writer.output_size(), stream.bytes_written());
+  }
+  free(buffer);
+}
+
 }  // namespace dart
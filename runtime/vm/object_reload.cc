@@ -688,6 +688,7 @@ static const Function* static_call_target = NULL;
 void ICData::Reset(Zone* zone) const {
   RebindRule rule = rebind_rule();
   if (rule == kInstance) {
+    set_closure_target(Function::null_function());
     intptr_t num_args = NumArgsTested();
     if (num_args == 2) {
       ClearWithSentinel();
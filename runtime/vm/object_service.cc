@@ -6,6 +6,7 @@
 #include "vm/debugger.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
+#include "vm/runtime_entry.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
 #include "vm/type_table.h"
@@ -14,6 +15,16 @@ namespace dart {
 
 #ifndef PRODUCT
 
+static void AddDeoptReasons(JSONObject* jsobj, uint32_t reasons) {
+  JSONArray jsarr(jsobj, "_deoptReasons");
+  for (intptr_t i = 0; i <= ICData::kLastRecordedDeoptReason; i++) {
+    if ((reasons & (1 << i)) != 0) {
+      jsarr.AddValue(
+          DeoptReasonToCString(static_cast<ICData::DeoptReasonId>(i)));
+    }
+  }
+}
+
 static void AddNameProperties(JSONObject* jsobj,
                               const char* name,
                               const char* vm_name) {
@@ -327,6 +338,30 @@ void Function::PrintJSONImpl(JSONStream* stream, bool ref) const {
   jsobj.AddProperty("_optimizedCallSiteCount", optimized_call_site_count());
   jsobj.AddProperty("_deoptimizations",
                     static_cast<intptr_t>(deoptimization_counter()));
+  jsobj.AddProperty("_adaptedDeoptimizations",
+                    static_cast<intptr_t>(adapted_deoptimization_counter()));
+  if (!ics.IsNull()) {
+    // Number of call sites that recorded each deoptimization reason. A reason
+    // recorded at a site disables the corresponding speculation there.
+    JSONObject reasons(&jsobj, "_deoptReasonCounts");
+    ICData& ic_data = ICData::Handle();
+    for (intptr_t reason = 0; reason <= ICData::kLastRecordedDeoptReason;
+         reason++) {
+      intptr_t count = 0;
+      for (intptr_t i = 1; i < ics.Length(); i++) {
+        ic_data ^= ics.At(i);
+        if (ic_data.HasDeoptReason(
+                static_cast<ICData::DeoptReasonId>(reason))) {
+          count++;
+        }
+      }
+      if (count > 0) {
+        reasons.AddProperty(
+            DeoptReasonToCString(static_cast<ICData::DeoptReasonId>(reason)),
+            count);
+      }
+    }
+  }
   if ((kind() == RawFunction::kImplicitGetter) ||
       (kind() == RawFunction::kImplicitSetter) ||
       (kind() == RawFunction::kImplicitStaticFinalGetter)) {
@@ -773,6 +808,7 @@ void ICData::PrintJSONImpl(JSONStream* stream, bool ref) const {
   jsobj.AddProperty("_argumentsDescriptor",
                     Object::Handle(arguments_descriptor()));
   jsobj.AddProperty("_entries", Object::Handle(ic_data()));
+  AddDeoptReasons(&jsobj, DeoptReasons());
 }
 
 void ICData::PrintToJSONArray(const JSONArray& jsarray,
@@ -784,8 +820,7 @@ void ICData::PrintToJSONArray(const JSONArray& jsarray,
   JSONObject jsobj(&jsarray);
   jsobj.AddProperty("name", String::Handle(target_name()).ToCString());
   jsobj.AddProperty("tokenPos", token_pos.value());
-  // TODO(rmacnak): Figure out how to stringify DeoptReasons().
-  // jsobj.AddProperty("deoptReasons", ...);
+  AddDeoptReasons(&jsobj, DeoptReasons());
 
   JSONArray cache_entries(&jsobj, "cacheEntries");
   for (intptr_t i = 0; i < NumberOfChecks(); i++) {
@@ -909,6 +944,7 @@ void MegamorphicCache::PrintJSONImpl(JSONStream* stream, bool ref) const {
   }
   jsobj.AddProperty("_buckets", Object::Handle(buckets()));
   jsobj.AddProperty("_mask", mask());
+  jsobj.AddProperty("_missCount", miss_count());
   jsobj.AddProperty("_argumentsDescriptor",
                     Object::Handle(arguments_descriptor()));
 }
@@ -1413,6 +1449,11 @@ void Capability::PrintJSONImpl(JSONStream* stream, bool ref) const {
   Instance::PrintJSONImpl(stream, ref);
 }
 
+void TransferableTypedData::PrintJSONImpl(JSONStream* stream,
+                                          bool ref) const {
+  Instance::PrintJSONImpl(stream, ref);
+}
+
 void ReceivePort::PrintJSONImpl(JSONStream* stream, bool ref) const {
   Instance::PrintJSONImpl(stream, ref);
 }
@@ -111,6 +111,7 @@ class ObjectPointerVisitor;
   RW(Function, lookup_port_handler)                                            \
   RW(TypedData, empty_uint32_array)                                            \
   RW(Function, handle_message_function)                                        \
+  RW(Function, handle_messages_function)                                       \
   RW(Function, growable_list_factory)                                          \
   RW(Function, simple_instance_of_function)                                    \
   RW(Function, simple_instance_of_true_function)                               \
@@ -127,9 +128,14 @@ class ObjectPointerVisitor;
   RW(GrowableObjectArray, megamorphic_cache_table)                             \
   R_(Code, megamorphic_miss_code)                                              \
   R_(Function, megamorphic_miss_function)                                      \
+  RW(Array, dispatch_table)                                                    \
+  RW(Array, dispatch_table_selectors)                                          \
   RW(Array, obfuscation_map)                                                   \
   RW(GrowableObjectArray, type_testing_stubs)                                  \
   RW(GrowableObjectArray, changed_in_last_reload)                              \
+  RW(GrowableObjectArray, osr_code_cache)                                      \
+  RW(GrowableObjectArray, block_coverage_records)                              \
+  RW(Array, reflective_lookup_cache)                                           \
 // Please remember the last entry must be referred in the 'to' function below.
 
 // The object store is a per isolate instance which stores references to
@@ -222,7 +228,7 @@ class ObjectStore {
                           DECLARE_OBJECT_STORE_FIELD)
 #undef DECLARE_OBJECT_STORE_FIELD
   RawObject** to() {
-    return reinterpret_cast<RawObject**>(&changed_in_last_reload_);
+    return reinterpret_cast<RawObject**>(&reflective_lookup_cache_);
   }
   RawObject** to_snapshot(Snapshot::Kind kind) {
     switch (kind) {
@@ -230,7 +236,7 @@ class ObjectStore {
         return reinterpret_cast<RawObject**>(&library_load_error_table_);
       case Snapshot::kFullJIT:
       case Snapshot::kFullAOT:
-        return reinterpret_cast<RawObject**>(&megamorphic_miss_function_);
+        return reinterpret_cast<RawObject**>(&dispatch_table_selectors_);
       case Snapshot::kScript:
       case Snapshot::kMessage:
       case Snapshot::kNone:
@@ -581,6 +581,39 @@ ISOLATE_UNIT_TEST_CASE(Double) {
     const Double& dbl2 = Double::Handle(Double::New(dbl_str2));
     EXPECT(dbl2.IsNull());
   }
+  {
+    // Integral values take a separate path from the shortest conversion.
+    const double values[] = {5.0,
+                             -0.0,
+                             -42.0,
+                             9007199254740991.0,
+                             9007199254740992.0,
+                             1e20,
+                             1e21,
+                             0.5,
+                             -1.5e-7,
+                             INFINITY,
+                             NAN};
+    const char* expected[] = {"5.0",
+                              "-0.0",
+                              "-42.0",
+                              "9007199254740991.0",
+                              "9007199254740992.0",
+                              "100000000000000000000.0",
+                              "1e+21",
+                              "0.5",
+                              "-1.5e-7",
+                              "Infinity",
+                              "NaN"};
+    Double& dbl = Double::Handle();
+    String& str = String::Handle();
+    for (intptr_t i = 0; i < static_cast<intptr_t>(ARRAY_SIZE(values)); i++) {
+      dbl = Double::New(values[i]);
+      str = dbl.ToString(Heap::kNew);
+      EXPECT_STREQ(expected[i], str.ToCString());
+      EXPECT_STREQ(expected[i], dbl.ToCString());
+    }
+  }
 }
 
 ISOLATE_UNIT_TEST_CASE(Integer) {
@@ -3025,6 +3058,34 @@ ISOLATE_UNIT_TEST_CASE(SubtypeTestCache) {
   EXPECT_EQ(Bool::True().raw(), test_result.raw());
 }
 
+ISOLATE_UNIT_TEST_CASE(SubtypeTestCacheGrowth) {
+  SubtypeTestCache& cache = SubtypeTestCache::Handle(SubtypeTestCache::New());
+  const TypeArguments& targ = TypeArguments::Handle(TypeArguments::New(1));
+  const intptr_t kNumChecks = 100;
+  Object& class_id_or_fun = Object::Handle();
+  for (intptr_t i = 0; i < kNumChecks; i++) {
+    class_id_or_fun = Smi::New(kNumPredefinedCids + i);
+    EXPECT(!cache.HasCheck(class_id_or_fun, targ, Object::null_type_arguments(),
+                           Object::null_type_arguments()));
+    cache.AddCheck(class_id_or_fun, targ, Object::null_type_arguments(),
+                   Object::null_type_arguments(),
+                   ((i % 2) == 0) ? Bool::True() : Bool::False());
+  }
+  EXPECT_EQ(kNumChecks, cache.NumberOfChecks());
+  for (intptr_t i = 0; i < kNumChecks; i++) {
+    class_id_or_fun = Smi::New(kNumPredefinedCids + i);
+    EXPECT(cache.HasCheck(class_id_or_fun, targ, Object::null_type_arguments(),
+                          Object::null_type_arguments()));
+  }
+  // Every check is found by probing at most a few entries.
+  GrowableArray<intptr_t> probe_lengths;
+  cache.CollectProbeLengths(&probe_lengths);
+  EXPECT_EQ(kNumChecks, probe_lengths.length());
+  for (intptr_t i = 0; i < probe_lengths.length(); i++) {
+    EXPECT_LE(probe_lengths[i], 2);
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(FieldTests) {
   const String& f = String::Handle(String::New("oneField"));
   const String& getter_f = String::Handle(Field::GetterName(f));
@@ -3631,6 +3692,45 @@ ISOLATE_UNIT_TEST_CASE(WeakProperty_ClearTwoShared_OldSpace) {
   EXPECT(weak2.value() == Object::null());
 }
 
+ISOLATE_UNIT_TEST_CASE(WeakProperty_PreserveChain_OldSpace) {
+  // The value of each weak property is the key of the previous one, so only
+  // marking through the values keeps all of them alive.
+  const intptr_t kLength = 100;
+  Isolate* isolate = Isolate::Current();
+  const Array& weaks = Array::Handle(Array::New(kLength, Heap::kOld));
+  String& root = String::Handle();
+  {
+    HANDLESCOPE(thread);
+    WeakProperty& weak = WeakProperty::Handle();
+    String& key = String::Handle();
+    String& value = String::Handle();
+    value ^= OneByteString::New("value", Heap::kOld);
+    for (intptr_t i = 0; i < kLength; i++) {
+      key ^= OneByteString::New("key", Heap::kOld);
+      weak ^= WeakProperty::New(Heap::kOld);
+      weak.set_key(key);
+      weak.set_value(value);
+      weaks.SetAt(i, weak);
+      value = key.raw();
+    }
+    root = key.raw();
+  }
+  isolate->heap()->CollectAllGarbage();
+  WeakProperty& weak = WeakProperty::Handle();
+  for (intptr_t i = 0; i < kLength; i++) {
+    weak ^= weaks.At(i);
+    EXPECT(weak.key() != Object::null());
+    EXPECT(weak.value() != Object::null());
+  }
+  root = String::null();
+  isolate->heap()->CollectAllGarbage();
+  for (intptr_t i = 0; i < kLength; i++) {
+    weak ^= weaks.At(i);
+    EXPECT(weak.key() == Object::null());
+    EXPECT(weak.value() == Object::null());
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(MirrorReference) {
   const MirrorReference& reference =
       MirrorReference::Handle(MirrorReference::New(Object::Handle()));
@@ -3765,6 +3865,70 @@ ISOLATE_UNIT_TEST_CASE(FindInvocationDispatcherFunctionIndex) {
   EXPECT_EQ(bad_invocation_dispatcher_index, -1);
 }
 
+ISOLATE_UNIT_TEST_CASE(InvocationDispatcherCache) {
+  const String& class_name = String::Handle(Symbols::New(thread, "MyClass"));
+  const Script& script = Script::Handle();
+  const Class& cls = Class::Handle(CreateDummyClass(class_name, script));
+  ClassFinalizer::FinalizeTypesInClass(cls);
+  cls.SetFunctions(Object::empty_array());
+  cls.Finalize();
+
+  // Enough dispatchers to grow the cache several times, with several
+  // descriptors for each name.
+  const intptr_t kNumNames = 10;
+  const intptr_t kNumDescriptors = 4;
+  const Array& dispatchers =
+      Array::Handle(Array::New(kNumNames * kNumDescriptors));
+  intptr_t ids[kNumNames * kNumDescriptors];
+  String& name = String::Handle();
+  Array& args_desc = Array::Handle();
+  Function& dispatcher = Function::Handle();
+  char buffer[16];
+  for (intptr_t i = 0; i < kNumNames; i++) {
+    Utils::SNPrint(buffer, sizeof(buffer), "method%" Pd, i);
+    name = Symbols::New(thread, buffer);
+    for (intptr_t j = 0; j < kNumDescriptors; j++) {
+      args_desc = ArgumentsDescriptor::New(0, j + 1);
+      dispatcher = cls.GetInvocationDispatcher(
+          name, args_desc, RawFunction::kNoSuchMethodDispatcher,
+          true /* create_if_absent */);
+      EXPECT(!dispatcher.IsNull());
+      dispatchers.SetAt(i * kNumDescriptors + j, dispatcher);
+      ids[i * kNumDescriptors + j] =
+          cls.FindInvocationDispatcherFunctionIndex(dispatcher);
+      EXPECT_GE(ids[i * kNumDescriptors + j], 0);
+    }
+  }
+
+  for (intptr_t i = 0; i < kNumNames; i++) {
+    Utils::SNPrint(buffer, sizeof(buffer), "method%" Pd, i);
+    name = Symbols::New(thread, buffer);
+    for (intptr_t j = 0; j < kNumDescriptors; j++) {
+      args_desc = ArgumentsDescriptor::New(0, j + 1);
+      dispatcher = cls.GetInvocationDispatcher(
+          name, args_desc, RawFunction::kNoSuchMethodDispatcher,
+          false /* create_if_absent */);
+      EXPECT_EQ(dispatchers.At(i * kNumDescriptors + j), dispatcher.raw());
+      // Ids handed out before the cache grew still find the same dispatcher.
+      EXPECT_EQ(ids[i * kNumDescriptors + j],
+                cls.FindInvocationDispatcherFunctionIndex(dispatcher));
+      EXPECT_EQ(dispatcher.raw(), cls.InvocationDispatcherFunctionFromIndex(
+                                      ids[i * kNumDescriptors + j]));
+      // A dispatcher of another kind is not found.
+      dispatcher = cls.GetInvocationDispatcher(
+          name, args_desc, RawFunction::kInvokeFieldDispatcher,
+          false /* create_if_absent */);
+      EXPECT(dispatcher.IsNull());
+    }
+  }
+
+  // Ids past the end of the cache resolve to no dispatcher.
+  const Array& entries = Array::Handle(cls.InvocationDispatcherEntries());
+  EXPECT(cls.InvocationDispatcherFunctionFromIndex(entries.Length()) ==
+         Function::null());
+  EXPECT(cls.InvocationDispatcherFunctionFromIndex(-1) == Function::null());
+}
+
 static void PrintMetadata(const char* name, const Object& data) {
   if (data.IsError()) {
     OS::PrintErr("Error in metadata evaluation for %s: '%s'\n", name,
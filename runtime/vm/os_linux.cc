@@ -21,6 +21,7 @@
 #include <unistd.h>        // NOLINT
 
 #include "platform/memory_sanitizer.h"
+#include "platform/text_buffer.h"
 #include "platform/utils.h"
 #include "vm/code_observers.h"
 #include "vm/dart.h"
@@ -55,9 +56,12 @@ DECLARE_FLAG(bool, write_protect_vm_isolate);
 // However perf-annotate does not work in this mode because JIT code
 // is transient and does not exist anymore at the moment when you
 // invoke perf-report.
+//
+// The map is written asynchronously, in batches, so creating code does not
+// wait for file I/O.
 class PerfCodeObserver : public CodeObserver {
  public:
-  PerfCodeObserver() : out_file_(NULL) {
+  PerfCodeObserver() : out_file_(NULL), batch_(kInitialBatchSize) {
     Dart_FileOpenCallback file_open = Dart::file_open_callback();
     if (file_open == NULL) {
       return;
@@ -80,27 +84,31 @@ class PerfCodeObserver : public CodeObserver {
     return FLAG_generate_perf_events_symbols && (out_file_ != NULL);
   }
 
+  virtual bool IsAsynchronous() const { return true; }
+
   virtual void Notify(const char* name,
                       uword base,
                       uword prologue_offset,
                       uword size,
                       bool optimized) {
-    Dart_FileWriteCallback file_write = Dart::file_write_callback();
-    if ((file_write == NULL) || (out_file_ == NULL)) {
-      return;
-    }
     const char* marker = optimized ? "*" : "";
-    char* buffer =
-        OS::SCreate(Thread::Current()->zone(), "%" Px " %" Px " %s%s\n", base,
-                    size, marker, name);
-    {
+    batch_.Printf("%" Px " %" Px " %s%s\n", base, size, marker, name);
+  }
+
+  virtual void FlushBatch() {
+    Dart_FileWriteCallback file_write = Dart::file_write_callback();
+    if ((file_write != NULL) && (out_file_ != NULL)) {
       MutexLocker ml(CodeObservers::mutex());
-      (*file_write)(buffer, strlen(buffer), out_file_);
+      (*file_write)(batch_.buf(), batch_.length(), out_file_);
     }
+    batch_.Clear();
   }
 
  private:
+  static const intptr_t kInitialBatchSize = 16 * KB;
+
   void* out_file_;
+  TextBuffer batch_;
 
   DISALLOW_COPY_AND_ASSIGN(PerfCodeObserver);
 };
@@ -315,19 +323,81 @@ static bool LocalTime(int64_t seconds_since_epoch, tm* tm_result) {
   return error_code != NULL;
 }
 
-const char* OS::GetTimeZoneName(int64_t seconds_since_epoch) {
+// localtime_r is slow, but the offset and name of the local time zone only
+// change at transitions. Each thread remembers the last hour it looked up,
+// if the hour has no transition, together with the TZ it was valid for.
+struct TimeZoneCache {
+  static const int64_t kSecondsPerHour = 60 * 60;
+  static const intptr_t kMaxTZLength = 64;
+
+  bool valid;
+  int64_t hour_start;
+  int offset;
+  const char* name;
+  char tz[kMaxTZLength];
+};
+
+static thread_local TimeZoneCache tz_cache = {false, 0, 0, NULL, {0}};
+
+// Returns the offset and zone name of the local time at seconds_since_epoch.
+static bool LocalTimeZone(int64_t seconds_since_epoch,
+                          int* offset,
+                          const char** name) {
+  int64_t into_hour = seconds_since_epoch % TimeZoneCache::kSecondsPerHour;
+  if (into_hour < 0) {
+    into_hour += TimeZoneCache::kSecondsPerHour;
+  }
+  const int64_t hour_start = seconds_since_epoch - into_hour;
+  const char* tz = getenv("TZ");
+  if (tz == NULL) {
+    tz = "";
+  }
+  if (tz_cache.valid && (tz_cache.hour_start == hour_start) &&
+      (strcmp(tz_cache.tz, tz) == 0)) {
+    *offset = tz_cache.offset;
+    *name = tz_cache.name;
+    return true;
+  }
+  tm start;
+  tm end;
+  if ((strlen(tz) < static_cast<size_t>(TimeZoneCache::kMaxTZLength)) &&
+      LocalTime(hour_start, &start) &&
+      LocalTime(hour_start + TimeZoneCache::kSecondsPerHour - 1, &end) &&
+      (start.tm_gmtoff == end.tm_gmtoff) && (start.tm_zone != NULL) &&
+      (end.tm_zone != NULL) && (strcmp(start.tm_zone, end.tm_zone) == 0)) {
+    tz_cache.valid = true;
+    tz_cache.hour_start = hour_start;
+    tz_cache.offset = static_cast<int>(start.tm_gmtoff);
+    tz_cache.name = start.tm_zone;
+    strncpy(tz_cache.tz, tz, TimeZoneCache::kMaxTZLength);
+    *offset = tz_cache.offset;
+    *name = tz_cache.name;
+    return true;
+  }
   tm decomposed;
-  bool succeeded = LocalTime(seconds_since_epoch, &decomposed);
+  if (!LocalTime(seconds_since_epoch, &decomposed)) {
+    return false;
+  }
+  // Even if the offset was 24 hours it would still easily fit into 32 bits.
+  *offset = static_cast<int>(decomposed.tm_gmtoff);
+  *name = decomposed.tm_zone;
+  return true;
+}
+
+const char* OS::GetTimeZoneName(int64_t seconds_since_epoch) {
+  int offset;
+  const char* name;
+  bool succeeded = LocalTimeZone(seconds_since_epoch, &offset, &name);
   // If unsuccessful, return an empty string like V8 does.
-  return (succeeded && (decomposed.tm_zone != NULL)) ? decomposed.tm_zone : "";
+  return (succeeded && (name != NULL)) ? name : "";
 }
 
 int OS::GetTimeZoneOffsetInSeconds(int64_t seconds_since_epoch) {
-  tm decomposed;
-  bool succeeded = LocalTime(seconds_since_epoch, &decomposed);
-  // Even if the offset was 24 hours it would still easily fit into 32 bits.
+  int offset;
+  const char* name;
+  bool succeeded = LocalTimeZone(seconds_since_epoch, &offset, &name);
   // If unsuccessful, return zero like V8 does.
-  return succeeded ? static_cast<int>(decomposed.tm_gmtoff) : 0;
+  return succeeded ? offset : 0;
 }
 
 int OS::GetLocalTimeZoneAdjustmentInSeconds() {
@@ -7,6 +7,7 @@
 #include "platform/atomic.h"
 #include "vm/lockers.h"
 #include "vm/log.h"
+#include "vm/perf_counters.h"
 #include "vm/thread_interrupter.h"
 #include "vm/timeline.h"
 
@@ -35,12 +36,18 @@ OSThread::OSThread()
       name_(NULL),
       timeline_block_lock_(new Mutex()),
       timeline_block_(NULL),
+#ifndef PRODUCT
+      perf_sampling_fd_(-1),
+      perf_counting_fd_(-1),
+#endif
       thread_list_next_(NULL),
       thread_interrupt_disabled_(1),  // Thread interrupts disabled by default.
       log_(new class Log()),
       stack_base_(0),
       stack_limit_(0),
-      thread_(NULL) {
+      thread_(NULL),
+      saved_affinity_(NULL),
+      has_saved_affinity_(false) {
   // Try to get accurate stack bounds from pthreads, etc.
   if (!GetCurrentStackBounds(&stack_limit_, &stack_base_)) {
     // Fall back to a guess based on the stack pointer.
@@ -73,6 +80,9 @@ OSThread::~OSThread() {
     FATAL("Thread exited without calling Dart_ExitIsolate");
   }
   RemoveThreadFromList(this);
+#ifndef PRODUCT
+  PerfCounters::CloseThreadCounters(this);
+#endif
   delete log_;
   log_ = NULL;
   if (FLAG_support_timeline) {
@@ -83,6 +93,7 @@ OSThread::~OSThread() {
   timeline_block_ = NULL;
   delete timeline_block_lock_;
   free(name_);
+  free(saved_affinity_);
 }
 
 void OSThread::SetName(const char* name) {
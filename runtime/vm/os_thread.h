@@ -35,9 +35,23 @@ namespace dart {
 // Forward declarations.
 class Log;
 class Mutex;
+class SampleBuffer;
 class Thread;
 class TimelineEventBlock;
 
+#ifndef PRODUCT
+// The slots [next, end) of |buffer| that the profiler takes the samples of
+// one thread in. See SampleBuffer::ReserveBlockSample.
+struct SampleBlock {
+  SampleBlock() : buffer(NULL), cursor(0), next(0), end(0) {}
+
+  SampleBuffer* buffer;
+  uword cursor;  // The buffer's cursor when the block was reserved.
+  intptr_t next;
+  intptr_t end;
+};
+#endif  // !PRODUCT
+
 class BaseThread {
  public:
   bool is_os_thread() const { return is_os_thread_; }
@@ -96,6 +110,17 @@ class OSThread : public BaseThread {
     timeline_block_ = block;
   }
 
+#ifndef PRODUCT
+  // Only used by the thread interrupter while this thread is interrupted.
+  SampleBlock* sample_block() { return &sample_block_; }
+
+  // Hardware performance counters of this thread, see PerfCounters.
+  intptr_t perf_sampling_fd() const { return perf_sampling_fd_; }
+  void set_perf_sampling_fd(intptr_t fd) { perf_sampling_fd_ = fd; }
+  intptr_t perf_counting_fd() const { return perf_counting_fd_; }
+  void set_perf_counting_fd(intptr_t fd) { perf_counting_fd_ = fd; }
+#endif  // !PRODUCT
+
   Log* log() const { return log_; }
 
   uword stack_base() const { return stack_base_; }
@@ -129,6 +154,21 @@ class OSThread : public BaseThread {
   static void SetCurrentSafestackPointer(uword ssp);
 #endif
 
+  // Returns the NUMA node of the CPU the current thread is running on, or
+  // kNoNumaNode if it cannot be determined.
+  static intptr_t GetCurrentNumaNode();
+
+  // Restricts the current thread to the CPUs of the given NUMA node, saving
+  // its previous affinity for RestoreCurrentAffinity. Returns false if the
+  // affinity could not be changed.
+  static bool SetCurrentNumaAffinity(intptr_t node);
+
+  // Gives the current thread back the affinity it had before the last
+  // successful SetCurrentNumaAffinity, if any.
+  static void RestoreCurrentAffinity();
+
+  static const intptr_t kNoNumaNode = -1;
+
   // Used to temporarily disable or enable thread interrupts.
   void DisableThreadInterrupts();
   void EnableThreadInterrupts();
@@ -255,6 +295,12 @@ class OSThread : public BaseThread {
   Mutex* timeline_block_lock_;
   TimelineEventBlock* timeline_block_;
 
+#ifndef PRODUCT
+  SampleBlock sample_block_;
+  intptr_t perf_sampling_fd_;
+  intptr_t perf_counting_fd_;
+#endif  // !PRODUCT
+
   // All |Thread|s are registered in the thread list.
   OSThread* thread_list_next_;
 
@@ -264,6 +310,11 @@ class OSThread : public BaseThread {
   uword stack_limit_;
   Thread* thread_;
 
+  // The affinity saved by SetCurrentNumaAffinity, in a platform specific
+  // format, and whether RestoreCurrentAffinity still has to restore it.
+  void* saved_affinity_;
+  bool has_saved_affinity_;
+
   // thread_list_lock_ cannot have a static lifetime because the order in which
   // destructors run is undefined. At the moment this lock cannot be deleted
   // either since otherwise, if a thread only begins to run after we have
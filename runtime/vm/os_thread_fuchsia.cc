@@ -231,6 +231,16 @@ bool OSThread::GetCurrentStackBounds(uword* lower, uword* upper) {
   return true;
 }
 
+intptr_t OSThread::GetCurrentNumaNode() {
+  return kNoNumaNode;
+}
+
+bool OSThread::SetCurrentNumaAffinity(intptr_t node) {
+  return false;
+}
+
+void OSThread::RestoreCurrentAffinity() {}
+
 #if defined(USING_SAFE_STACK)
 #define STRINGIFY(s) #s
 NO_SANITIZE_ADDRESS
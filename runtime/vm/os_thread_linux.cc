@@ -9,6 +9,9 @@
 #include "vm/os_thread.h"
 
 #include <errno.h>         // NOLINT
+#include <sched.h>         // NOLINT
+#include <stdio.h>         // NOLINT
+#include <stdlib.h>        // NOLINT
 #include <sys/resource.h>  // NOLINT
 #include <sys/syscall.h>   // NOLINT
 #include <sys/time.h>      // NOLINT
@@ -246,6 +249,88 @@ bool OSThread::GetCurrentStackBounds(uword* lower, uword* upper) {
   return true;
 }
 
+intptr_t OSThread::GetCurrentNumaNode() {
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(__NR_getcpu, &cpu, &node, NULL) != 0) {
+    return kNoNumaNode;
+  }
+  return static_cast<intptr_t>(node);
+}
+
+// Adds the CPUs of a sysfs cpulist such as "0-3,8-11" to the set.
+static bool ParseCpuList(const char* list, cpu_set_t* cpus) {
+  const char* p = list;
+  while (*p != '\0' && *p != '\n') {
+    char* end;
+    const intptr_t first = strtol(p, &end, 10);
+    if (end == p) {
+      return false;
+    }
+    intptr_t last = first;
+    p = end;
+    if (*p == '-') {
+      last = strtol(p + 1, &end, 10);
+      if (end == p + 1) {
+        return false;
+      }
+      p = end;
+    }
+    for (intptr_t cpu = first; (cpu <= last) && (cpu < CPU_SETSIZE); cpu++) {
+      CPU_SET(cpu, cpus);
+    }
+    if (*p == ',') {
+      p++;
+    }
+  }
+  return true;
+}
+
+bool OSThread::SetCurrentNumaAffinity(intptr_t node) {
+  ASSERT(node != kNoNumaNode);
+  char path[64];
+  Utils::SNPrint(path, sizeof(path),
+                 "/sys/devices/system/node/node%" Pd "/cpulist", node);
+  FILE* file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+  char list[1024];
+  const bool read = fgets(list, sizeof(list), file) != NULL;
+  fclose(file);
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  if (!read || !ParseCpuList(list, &cpus) || (CPU_COUNT(&cpus) == 0)) {
+    return false;
+  }
+  OSThread* os_thread = OSThread::Current();
+  if (os_thread->saved_affinity_ == NULL) {
+    os_thread->saved_affinity_ = malloc(sizeof(cpu_set_t));
+  }
+  cpu_set_t* saved = reinterpret_cast<cpu_set_t*>(os_thread->saved_affinity_);
+  // Only the first of nested calls saves the affinity to restore.
+  if (!os_thread->has_saved_affinity_ &&
+      (sched_getaffinity(0, sizeof(*saved), saved) != 0)) {
+    return false;
+  }
+  // The kernel drops the CPUs outside the thread's cpuset.
+  if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+    return false;
+  }
+  os_thread->has_saved_affinity_ = true;
+  return true;
+}
+
+void OSThread::RestoreCurrentAffinity() {
+  OSThread* os_thread = OSThread::Current();
+  if (!os_thread->has_saved_affinity_) {
+    return;
+  }
+  cpu_set_t* saved = reinterpret_cast<cpu_set_t*>(os_thread->saved_affinity_);
+  sched_setaffinity(0, sizeof(*saved), saved);
+  os_thread->has_saved_affinity_ = false;
+}
+
 #if defined(USING_SAFE_STACK)
 NO_SANITIZE_ADDRESS
 NO_SANITIZE_SAFE_STACK
@@ -208,6 +208,16 @@ bool OSThread::GetCurrentStackBounds(uword* lower, uword* upper) {
   return true;
 }
 
+intptr_t OSThread::GetCurrentNumaNode() {
+  return kNoNumaNode;
+}
+
+bool OSThread::SetCurrentNumaAffinity(intptr_t node) {
+  return false;
+}
+
+void OSThread::RestoreCurrentAffinity() {}
+
 #if defined(USING_SAFE_STACK)
 NO_SANITIZE_ADDRESS
 NO_SANITIZE_SAFE_STACK
@@ -0,0 +1,63 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/perf_counters.h"
+
+#include "vm/flags.h"
+#include "vm/os.h"
+
+namespace dart {
+
+#if !defined(PRODUCT)
+
+DEFINE_FLAG(charp,
+            profile_event,
+            NULL,
+            "Sample on a hardware event instead of on a timer: cycles, "
+            "instructions, cache-misses, branch-misses, "
+            "stalled-cycles-frontend, stalled-cycles-backend or "
+            "raw:<hex event code>. Linux only.");
+DEFINE_FLAG(int,
+            profile_event_period,
+            0,
+            "Events between samples with --profile_event, 0 for the "
+            "default of the event.");
+DEFINE_FLAG(bool,
+            timeline_perf_counters,
+            false,
+            "Count the --profile_event event, or cycles, during timeline "
+            "duration events. Linux only.");
+
+bool PerfCounters::sampling_enabled_ = false;
+bool PerfCounters::counting_enabled_ = false;
+const char* PerfCounters::event_name_ = NULL;
+intptr_t PerfCounters::sample_period_ = 0;
+
+#if !defined(HOST_OS_LINUX)
+
+void PerfCounters::InitOnce() {
+  if ((FLAG_profile_event != NULL) || FLAG_timeline_perf_counters) {
+    OS::PrintErr(
+        "Hardware performance counters are not supported on this "
+        "platform.\n");
+  }
+}
+
+bool PerfCounters::StartSampling(OSThread* thread) {
+  return false;
+}
+
+void PerfCounters::RearmSampling(intptr_t fd) {}
+
+int64_t PerfCounters::ReadThreadCounter(OSThread* thread) {
+  return -1;
+}
+
+void PerfCounters::CloseThreadCounters(OSThread* thread) {}
+
+#endif  // !defined(HOST_OS_LINUX)
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
@@ -0,0 +1,72 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_PERF_COUNTERS_H_
+#define RUNTIME_VM_PERF_COUNTERS_H_
+
+#include "vm/allocation.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+class OSThread;
+
+#if !defined(PRODUCT)
+
+// Hardware performance counters of the current process, currently only
+// available on Linux through perf_event_open.
+//
+// With --profile_event, the thread interrupter no longer interrupts threads
+// every --profile_period microseconds. Instead, a counter on each thread
+// sends it SIGPROF each SamplePeriod() occurrences of the event, and the
+// sample is taken, stored and symbolized exactly like a timer sample. Each
+// tick of a profile then stands for SamplePeriod() events instead of for a
+// slice of time.
+//
+// With --timeline_perf_counters, duration events on the timeline get an
+// argument counting the event (cycles without --profile_event) on the
+// recording thread between their begin and end.
+class PerfCounters : public AllStatic {
+ public:
+  // Checks that the event named by the flags exists and that the kernel lets
+  // this process count it. Otherwise prints why and leaves counters off.
+  static void InitOnce();
+
+  static bool SamplingEnabled() { return sampling_enabled_; }
+  static bool CountingEnabled() { return counting_enabled_; }
+
+  // Name of the counted event, as given to --profile_event.
+  static const char* EventName() { return event_name_; }
+
+  // Events between two samples.
+  static intptr_t SamplePeriod() { return sample_period_; }
+
+  // Called by the thread interrupter on each tick for every thread it would
+  // otherwise interrupt. Arms the sampling counter of 'thread' unless it is
+  // already armed. Returns false if the counter cannot be armed.
+  static bool StartSampling(OSThread* thread);
+
+  // Called from the SIGPROF handler: the sampling counter 'fd' stops after
+  // each overflow and has to be restarted for the next sample.
+  static void RearmSampling(intptr_t fd);
+
+  // Returns the events counted on 'thread', which must be the current
+  // thread, or -1 if they cannot be read.
+  static int64_t ReadThreadCounter(OSThread* thread);
+
+  // Releases the counters of 'thread' when it exits.
+  static void CloseThreadCounters(OSThread* thread);
+
+ private:
+  static bool sampling_enabled_;
+  static bool counting_enabled_;
+  static const char* event_name_;
+  static intptr_t sample_period_;
+};
+
+#endif  // !defined(PRODUCT)
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_PERF_COUNTERS_H_
@@ -0,0 +1,204 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "platform/globals.h"
+#if defined(HOST_OS_LINUX) && !defined(PRODUCT)
+
+#include "vm/perf_counters.h"
+
+#include <errno.h>  // NOLINT
+#include <fcntl.h>  // NOLINT
+#include <linux/perf_event.h>  // NOLINT
+#include <signal.h>  // NOLINT
+#include <stdlib.h>  // NOLINT
+#include <string.h>  // NOLINT
+#include <sys/ioctl.h>  // NOLINT
+#include <sys/syscall.h>  // NOLINT
+#include <unistd.h>  // NOLINT
+
+#include "platform/utils.h"
+#include "vm/flags.h"
+#include "vm/os.h"
+#include "vm/os_thread.h"
+
+namespace dart {
+
+DECLARE_FLAG(charp, profile_event);
+DECLARE_FLAG(int, profile_event_period);
+DECLARE_FLAG(bool, timeline_perf_counters);
+DECLARE_FLAG(bool, trace_thread_interrupter);
+
+struct PerfEvent {
+  const char* name;
+  uint32_t type;
+  uint64_t config;
+  intptr_t default_period;
+};
+
+// Periods giving roughly one sample per millisecond on current hardware,
+// like the default --profile_period.
+static const PerfEvent kPerfEvents[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, 2000000},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, 2000000},
+    {"cache-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, 10000},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, 10000},
+    {"stalled-cycles-frontend", PERF_TYPE_HARDWARE,
+     PERF_COUNT_HW_STALLED_CYCLES_FRONTEND, 1000000},
+    {"stalled-cycles-backend", PERF_TYPE_HARDWARE,
+     PERF_COUNT_HW_STALLED_CYCLES_BACKEND, 1000000},
+};
+
+static const char kRawEventPrefix[] = "raw:";
+static const intptr_t kRawEventDefaultPeriod = 10000;
+
+static uint32_t event_type = 0;
+static uint64_t event_config = 0;
+
+static bool LookupEvent(const char* name, intptr_t* default_period) {
+  for (size_t i = 0; i < ARRAY_SIZE(kPerfEvents); i++) {
+    if (strcmp(name, kPerfEvents[i].name) == 0) {
+      event_type = kPerfEvents[i].type;
+      event_config = kPerfEvents[i].config;
+      *default_period = kPerfEvents[i].default_period;
+      return true;
+    }
+  }
+  const size_t prefix_length = strlen(kRawEventPrefix);
+  if (strncmp(name, kRawEventPrefix, prefix_length) == 0) {
+    const char* code = name + prefix_length;
+    char* end = NULL;
+    errno = 0;
+    uint64_t config = strtoull(code, &end, 16);
+    if ((*code == '\0') || (*end != '\0') || (errno != 0)) {
+      return false;
+    }
+    event_type = PERF_TYPE_RAW;
+    event_config = config;
+    *default_period = kRawEventDefaultPeriod;
+    return true;
+  }
+  return false;
+}
+
+// Opens a counter of the event for the thread 'tid', 0 being the current
+// thread. A sampling counter starts disabled, see StartSampling.
+static int OpenCounter(pid_t tid, intptr_t sample_period) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = event_type;
+  attr.config = event_config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  if (sample_period > 0) {
+    attr.sample_period = sample_period;
+    attr.disabled = 1;
+    attr.wakeup_events = 1;
+  }
+  int fd = syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0);
+  if (fd >= 0) {
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+  return fd;
+}
+
+void PerfCounters::InitOnce() {
+  const char* name = FLAG_profile_event;
+  if ((name == NULL) && FLAG_timeline_perf_counters) {
+    name = kPerfEvents[0].name;
+  }
+  if (name == NULL) {
+    return;
+  }
+  intptr_t default_period = 0;
+  if (!LookupEvent(name, &default_period)) {
+    OS::PrintErr("Unknown hardware event '%s'.\n", name);
+    return;
+  }
+  // The kernel may not expose the event, e.g. in a virtual machine, or may
+  // not let this process count it, see /proc/sys/kernel/perf_event_paranoid.
+  int fd = OpenCounter(0, 0);
+  if (fd < 0) {
+    const int kBufferSize = 1024;
+    char error_buf[kBufferSize];
+    OS::PrintErr("Cannot count hardware event '%s': %s\n", name,
+                 Utils::StrError(errno, error_buf, kBufferSize));
+    return;
+  }
+  close(fd);
+  event_name_ = name;
+  sample_period_ = (FLAG_profile_event_period > 0) ? FLAG_profile_event_period
+                                                   : default_period;
+  sampling_enabled_ = (FLAG_profile_event != NULL);
+  counting_enabled_ = FLAG_timeline_perf_counters;
+}
+
+bool PerfCounters::StartSampling(OSThread* thread) {
+  ASSERT(sampling_enabled_);
+  if (thread->perf_sampling_fd() >= 0) {
+    return true;
+  }
+  const pid_t tid = thread->trace_id();
+  int fd = OpenCounter(tid, sample_period_);
+  if (fd < 0) {
+    return false;
+  }
+  // Deliver the overflow signal to the counted thread itself, as
+  // pthread_kill does for timer samples.
+  struct f_owner_ex owner;
+  owner.type = F_OWNER_TID;
+  owner.pid = tid;
+  if ((fcntl(fd, F_SETOWN_EX, &owner) != 0) ||
+      (fcntl(fd, F_SETSIG, SIGPROF) != 0) ||
+      (fcntl(fd, F_SETFL, O_ASYNC) != 0) ||
+      (ioctl(fd, PERF_EVENT_IOC_REFRESH, 1) != 0)) {
+    close(fd);
+    return false;
+  }
+  if (FLAG_trace_thread_interrupter) {
+    OS::PrintErr("Sampling %s of thread %d\n", event_name_,
+                 static_cast<int>(tid));
+  }
+  thread->set_perf_sampling_fd(fd);
+  return true;
+}
+
+void PerfCounters::RearmSampling(intptr_t fd) {
+  // Async signal safe.
+  ioctl(fd, PERF_EVENT_IOC_REFRESH, 1);
+}
+
+int64_t PerfCounters::ReadThreadCounter(OSThread* thread) {
+  if (!counting_enabled_) {
+    return -1;
+  }
+  intptr_t fd = thread->perf_counting_fd();
+  if (fd < 0) {
+    fd = OpenCounter(0, 0);
+    if (fd < 0) {
+      return -1;
+    }
+    thread->set_perf_counting_fd(fd);
+  }
+  uint64_t value = 0;
+  if (read(fd, &value, sizeof(value)) != sizeof(value)) {
+    return -1;
+  }
+  return static_cast<int64_t>(value);
+}
+
+void PerfCounters::CloseThreadCounters(OSThread* thread) {
+  if (thread->perf_sampling_fd() >= 0) {
+    close(thread->perf_sampling_fd());
+    thread->set_perf_sampling_fd(-1);
+  }
+  if (thread->perf_counting_fd() >= 0) {
+    close(thread->perf_counting_fd());
+    thread->set_perf_counting_fd(-1);
+  }
+}
+
+}  // namespace dart
+
+#endif  // defined(HOST_OS_LINUX) && !defined(PRODUCT)
@@ -4,6 +4,7 @@
 
 #include "vm/port.h"
 
+#include "platform/atomic.h"
 #include "platform/utils.h"
 #include "vm/dart_api_impl.h"
 #include "vm/dart_entry.h"
@@ -15,6 +16,8 @@
 namespace dart {
 
 Mutex* PortMap::mutex_ = NULL;
+PortMap::ReaderStripe PortMap::readers_[PortMap::kReaderStripes];
+uword PortMap::writer_active_ = 0;
 PortMap::Entry* PortMap::map_ = NULL;
 MessageHandler* PortMap::deleted_entry_ = reinterpret_cast<MessageHandler*>(1);
 intptr_t PortMap::capacity_ = 0;
@@ -22,6 +25,45 @@ intptr_t PortMap::used_ = 0;
 intptr_t PortMap::deleted_ = 0;
 Random* PortMap::prng_ = NULL;
 
+intptr_t PortMap::EnterReader() {
+  const intptr_t thread_id =
+      OSThread::ThreadIdToIntPtr(OSThread::GetCurrentThreadId());
+  const intptr_t stripe = Utils::WordHash(thread_id) & (kReaderStripes - 1);
+  while (true) {
+    // The atomic increment is a full barrier, so either the writer sees this
+    // reader or this reader sees the writer.
+    AtomicOperations::FetchAndIncrement(&readers_[stripe].count);
+    if (AtomicOperations::LoadRelaxed(&writer_active_) == 0) {
+      return stripe;
+    }
+    AtomicOperations::FetchAndDecrement(&readers_[stripe].count);
+    // Block until the writer, which holds mutex_, is done.
+    MutexLocker ml(mutex_);
+  }
+}
+
+void PortMap::ExitReader(intptr_t stripe) {
+  AtomicOperations::FetchAndDecrement(&readers_[stripe].count);
+}
+
+void PortMap::BeginWriteLocked() {
+  ASSERT(mutex_->IsOwnedByCurrentThread());
+  ASSERT(writer_active_ == 0);
+  AtomicOperations::CompareAndSwapWord(&writer_active_, 0, 1);
+  for (intptr_t i = 0; i < kReaderStripes; i++) {
+    // Readers only look up a handler and enqueue a message, so this wait
+    // is short.
+    while (AtomicOperations::LoadRelaxed(&readers_[i].count) != 0) {
+      OS::SleepMicros(0);
+    }
+  }
+}
+
+void PortMap::EndWriteLocked() {
+  ASSERT(mutex_->IsOwnedByCurrentThread());
+  AtomicOperations::CompareAndSwapWord(&writer_active_, 1, 0);
+}
+
 intptr_t PortMap::FindPort(Dart_Port port) {
   // ILLEGAL_PORT (0) is used as a sentinel value in Entry.port. The loop below
   // could return the index to a deleted port when we are searching for
@@ -157,6 +199,7 @@ Dart_Port PortMap::CreatePort(MessageHandler* handler) {
   ASSERT(map_[index].port == 0);
   ASSERT((map_[index].handler == NULL) ||
          (map_[index].handler == deleted_entry_));
+  BeginWriteLocked();
   if (map_[index].handler == deleted_entry_) {
     // Consuming a deleted entry.
     deleted_--;
@@ -166,6 +209,7 @@ Dart_Port PortMap::CreatePort(MessageHandler* handler) {
   // Increment number of used slots and grow if necessary.
   used_++;
   MaintainInvariants();
+  EndWriteLocked();
 
   if (FLAG_trace_isolates) {
     OS::PrintErr(
@@ -198,6 +242,7 @@ bool PortMap::ClosePort(Dart_Port port) {
     // Before releasing the lock mark the slot in the map as deleted. This makes
     // it possible to release the port map lock before flushing all of its
     // pending messages below.
+    BeginWriteLocked();
     map_[index].port = 0;
     map_[index].handler = deleted_entry_;
     if (map_[index].state == kLivePort) {
@@ -207,6 +252,7 @@ bool PortMap::ClosePort(Dart_Port port) {
     used_--;
     deleted_++;
     MaintainInvariants();
+    EndWriteLocked();
   }
   handler->ClosePort(port);
   if (!handler->HasLivePorts() && handler->OwnedByPortMap()) {
@@ -219,6 +265,7 @@ bool PortMap::ClosePort(Dart_Port port) {
 void PortMap::ClosePorts(MessageHandler* handler) {
   {
     MutexLocker ml(mutex_);
+    BeginWriteLocked();
     for (intptr_t i = 0; i < capacity_; i++) {
       if (map_[i].handler == handler) {
         // Mark the slot as deleted.
@@ -232,14 +279,16 @@ void PortMap::ClosePorts(MessageHandler* handler) {
       }
     }
     MaintainInvariants();
+    EndWriteLocked();
   }
   handler->CloseAllPorts();
 }
 
 bool PortMap::PostMessage(Message* message) {
-  MutexLocker ml(mutex_);
+  const intptr_t stripe = EnterReader();
   intptr_t index = FindPort(message->dest_port());
   if (index < 0) {
+    ExitReader(stripe);
     delete message;
     return false;
   }
@@ -249,31 +298,38 @@ bool PortMap::PostMessage(Message* message) {
   ASSERT(map_[index].port != 0);
   ASSERT((handler != NULL) && (handler != deleted_entry_));
   handler->PostMessage(message);
+  ExitReader(stripe);
   return true;
 }
 
 bool PortMap::IsLocalPort(Dart_Port id) {
-  MutexLocker ml(mutex_);
+  const intptr_t stripe = EnterReader();
   intptr_t index = FindPort(id);
   if (index < 0) {
     // Port does not exist.
+    ExitReader(stripe);
     return false;
   }
 
   MessageHandler* handler = map_[index].handler;
-  return handler->IsCurrentIsolate();
+  const bool result = handler->IsCurrentIsolate();
+  ExitReader(stripe);
+  return result;
 }
 
 Isolate* PortMap::GetIsolate(Dart_Port id) {
-  MutexLocker ml(mutex_);
+  const intptr_t stripe = EnterReader();
   intptr_t index = FindPort(id);
   if (index < 0) {
     // Port does not exist.
+    ExitReader(stripe);
     return NULL;
   }
 
   MessageHandler* handler = map_[index].handler;
-  return handler->isolate();
+  Isolate* result = handler->isolate();
+  ExitReader(stripe);
+  return result;
 }
 
 void PortMap::InitOnce() {
@@ -87,9 +87,29 @@ class PortMap : public AllStatic {
 
   static void MaintainInvariants();
 
-  // Lock protecting access to the port map.
+  // Message posting and port queries do not take mutex_. Instead a reader
+  // announces itself in one of the reader stripes, and operations that add
+  // or remove entries wait for all readers to leave before touching the map.
+  // Once a port has been removed no reader can still be using its handler.
+  static intptr_t EnterReader();
+  static void ExitReader(intptr_t stripe);
+  static void BeginWriteLocked();
+  static void EndWriteLocked();
+
+  // Lock protecting access to the port map. Held by all writers.
   static Mutex* mutex_;
 
+  // Readers are counted in separate cache lines so that threads posting
+  // concurrently do not contend on a single counter.
+  static const intptr_t kReaderStripes = 16;
+  static const intptr_t kCacheLineSize = 64;
+  struct ReaderStripe {
+    uintptr_t count;
+    uint8_t padding[kCacheLineSize - sizeof(uintptr_t)];
+  };
+  static ReaderStripe readers_[kReaderStripes];
+  static uword writer_active_;
+
   // Hashmap of ports.
   static Entry* map_;
   static MessageHandler* deleted_entry_;
@@ -181,4 +181,66 @@ TEST_CASE(PortMap_PostMessageClosedPort) {
                   message_len, NULL, Message::kNormalPriority)));
 }
 
+struct PostThreadInfo {
+  Dart_Port port;
+  intptr_t count;
+  Monitor* monitor;
+  intptr_t* running;
+};
+
+static void PostMessages(uword param) {
+  PostThreadInfo* info = reinterpret_cast<PostThreadInfo*>(param);
+  for (intptr_t i = 0; i < info->count; i++) {
+    PortMap::PostMessage(
+        new Message(info->port, Smi::New(i), Message::kNormalPriority));
+  }
+  MonitorLocker ml(info->monitor);
+  (*info->running)--;
+  ml.Notify();
+}
+
+// Posts from several threads at once, each to its own port, for increasing
+// numbers of threads, and checks that every message was queued.
+VM_UNIT_TEST_CASE(PortMap_ConcurrentPost) {
+  const intptr_t kMaxThreads = 8;
+  const intptr_t kMessagesPerThread = 20000;
+  PortTestMessageHandler handlers[kMaxThreads];
+  Dart_Port ports[kMaxThreads];
+  PostThreadInfo infos[kMaxThreads];
+  intptr_t expected[kMaxThreads];
+  Monitor monitor;
+  for (intptr_t i = 0; i < kMaxThreads; i++) {
+    ports[i] = PortMap::CreatePort(&handlers[i]);
+    expected[i] = 0;
+  }
+  for (intptr_t threads = 1; threads <= kMaxThreads; threads *= 2) {
+    intptr_t running = threads;
+    for (intptr_t i = 0; i < threads; i++) {
+      infos[i].port = ports[i];
+      infos[i].count = kMessagesPerThread;
+      infos[i].monitor = &monitor;
+      infos[i].running = &running;
+      int result = OSThread::Start("PostMessages", PostMessages,
+                                   reinterpret_cast<uword>(&infos[i]));
+      EXPECT_EQ(0, result);
+      expected[i] += kMessagesPerThread;
+    }
+    {
+      MonitorLocker ml(&monitor);
+      while (running > 0) {
+        ml.Wait();
+      }
+    }
+    // The handlers are never run, so every posted message is still queued.
+    for (intptr_t i = 0; i < kMaxThreads; i++) {
+      EXPECT_EQ(expected[i], handlers[i].PendingMessageCount());
+    }
+  }
+  for (intptr_t i = 0; i < kMaxThreads; i++) {
+    EXPECT(PortMapTestPeer::IsActivePort(ports[i]));
+    // Drops the queued messages.
+    PortMap::ClosePort(ports[i]);
+  }
+}
+
 }  // namespace dart
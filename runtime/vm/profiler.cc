@@ -18,6 +18,7 @@
 #include "vm/native_symbol.h"
 #include "vm/object.h"
 #include "vm/os.h"
+#include "vm/perf_counters.h"
 #include "vm/profiler.h"
 #include "vm/reusable_handles.h"
 #include "vm/signal_handler.h"
@@ -42,6 +43,11 @@ DEFINE_FLAG(int,
             1000,
             "Time between profiler samples in microseconds. Minimum 50.");
 #endif
+DEFINE_FLAG(int,
+            sample_buffer_capacity,
+            SampleBuffer::kDefaultBufferCapacity,
+            "Number of samples kept by the profiler for all isolates. Each "
+            "sample holds up to 8 frames.");
 DEFINE_FLAG(int,
             max_profile_depth,
             kSampleSize* kMaxSamplesPerTick,
@@ -68,11 +74,16 @@ void Profiler::InitOnce() {
   SetSamplePeriod(FLAG_profile_period);
   SetSampleDepth(FLAG_max_profile_depth);
   Sample::InitOnce();
+  PerfCounters::InitOnce();
   if (!FLAG_profiler) {
     return;
   }
   ASSERT(!initialized_);
-  sample_buffer_ = new SampleBuffer();
+  intptr_t capacity = FLAG_sample_buffer_capacity;
+  if (capacity < SampleBuffer::kSamplesPerBlock) {
+    capacity = SampleBuffer::kSamplesPerBlock;
+  }
+  sample_buffer_ = new SampleBuffer(capacity);
   Profiler::InitAllocationSampleBuffer();
   // Zero counters.
   memset(&counters_, 0, sizeof(counters_));
@@ -191,9 +202,47 @@ Sample* SampleBuffer::ReserveSample() {
   return At(ReserveSampleSlot());
 }
 
+intptr_t SampleBuffer::ReserveSampleSlot(SampleBlock* block) {
+  ASSERT(samples_ != NULL);
+  ASSERT(block != NULL);
+  // Once the cursor has come around, other threads may be given the slots
+  // of an old block, so it must not be used any longer.
+  if ((block->buffer != this) || (block->next >= block->end) ||
+      (cursor_ - block->cursor >=
+       static_cast<uword>(capacity_ - kSamplesPerBlock))) {
+    uword cursor;
+    do {
+      cursor = cursor_;
+    } while (AtomicOperations::CompareAndSwapWord(&cursor_, cursor,
+                                                  cursor + kSamplesPerBlock) !=
+             cursor);
+    // Map back into sample buffer range. A block ending past the end of the
+    // buffer is cut short.
+    const intptr_t start = cursor % capacity_;
+    block->buffer = this;
+    block->cursor = cursor;
+    block->next = start;
+    block->end = Utils::Minimum(start + kSamplesPerBlock, capacity_);
+  }
+  return block->next++;
+}
+
+Sample* SampleBuffer::ReserveBlockSample(SampleBlock* block) {
+  return At(ReserveSampleSlot(block));
+}
+
 Sample* SampleBuffer::ReserveSampleAndLink(Sample* previous) {
   ASSERT(previous != NULL);
-  intptr_t next_index = ReserveSampleSlot();
+  return Link(previous, ReserveSampleSlot());
+}
+
+Sample* SampleBuffer::ReserveBlockSampleAndLink(Sample* previous,
+                                                SampleBlock* block) {
+  ASSERT(previous != NULL);
+  return Link(previous, ReserveSampleSlot(block));
+}
+
+Sample* SampleBuffer::Link(Sample* previous, intptr_t next_index) {
   Sample* next = At(next_index);
   next->Init(previous->port(), previous->timestamp(), previous->tid());
   next->set_head_sample(false);
@@ -447,6 +496,7 @@ class ProfilerStackWalker : public ValueObject {
       : port_id_(port_id),
         sample_(head_sample),
         sample_buffer_(sample_buffer),
+        sample_block_(NULL),
         skip_count_(skip_count),
         frames_skipped_(0),
         frame_index_(0),
@@ -459,6 +509,9 @@ class ProfilerStackWalker : public ValueObject {
     }
   }
 
+  // Take continuation samples from |block| instead of the shared cursor.
+  void set_sample_block(SampleBlock* block) { sample_block_ = block; }
+
   bool Append(uword pc) {
     if (frames_skipped_ < skip_count_) {
       frames_skipped_++;
@@ -477,7 +530,11 @@ class ProfilerStackWalker : public ValueObject {
     }
     ASSERT(sample_ != NULL);
     if (frame_index_ == kSampleSize) {
-      Sample* new_sample = sample_buffer_->ReserveSampleAndLink(sample_);
+      Sample* new_sample =
+          (sample_block_ != NULL)
+              ? sample_buffer_->ReserveBlockSampleAndLink(sample_,
+                                                          sample_block_)
+              : sample_buffer_->ReserveSampleAndLink(sample_);
       if (new_sample == NULL) {
         // Could not reserve new sample- mark this as truncated.
         sample_->set_truncated_trace(true);
@@ -497,6 +554,7 @@ class ProfilerStackWalker : public ValueObject {
   Dart_Port port_id_;
   Sample* sample_;
   SampleBuffer* sample_buffer_;
+  SampleBlock* sample_block_;
   intptr_t skip_count_;
   intptr_t frames_skipped_;
   intptr_t frame_index_;
@@ -999,13 +1057,16 @@ static bool InitialRegisterCheck(uintptr_t pc, uintptr_t fp, uintptr_t sp) {
   return true;
 }
 
+// Takes the sample from |block| if it is not NULL.
 static Sample* SetupSample(Thread* thread,
                            SampleBuffer* sample_buffer,
-                           ThreadId tid) {
+                           ThreadId tid,
+                           SampleBlock* block = NULL) {
   ASSERT(thread != NULL);
   Isolate* isolate = thread->isolate();
   ASSERT(sample_buffer != NULL);
-  Sample* sample = sample_buffer->ReserveSample();
+  Sample* sample = (block != NULL) ? sample_buffer->ReserveBlockSample(block)
+                                   : sample_buffer->ReserveSample();
   sample->Init(isolate->main_port(), OS::GetCurrentMonotonicMicros(), tid);
   uword vm_tag = thread->vm_tag();
 #if defined(USING_SIMULATOR) && !defined(TARGET_ARCH_DBC)
@@ -1127,7 +1188,9 @@ void Profiler::DumpStackTrace(uword sp, uword fp, uword pc, bool for_crash) {
   OS::PrintErr("-- End of DumpStackTrace\n");
 }
 
-void Profiler::SampleAllocation(Thread* thread, intptr_t cid) {
+void Profiler::SampleAllocation(Thread* thread,
+                                intptr_t cid,
+                                intptr_t sampled_size) {
   ASSERT(thread != NULL);
   OSThread* os_thread = thread->os_thread();
   ASSERT(os_thread != NULL);
@@ -1165,6 +1228,7 @@ void Profiler::SampleAllocation(Thread* thread, intptr_t cid) {
 
   Sample* sample = SetupSample(thread, sample_buffer, os_thread->trace_id());
   sample->SetAllocationCid(cid);
+  sample->set_sampled_allocation_size(sampled_size);
 
   if (FLAG_profile_vm_allocation) {
     ProfilerNativeStackWalker native_stack_walker(
@@ -1252,7 +1316,8 @@ void Profiler::SampleThreadSingleFrame(Thread* thread, uintptr_t pc) {
   }
 
   // Setup sample.
-  Sample* sample = SetupSample(thread, sample_buffer, os_thread->trace_id());
+  Sample* sample = SetupSample(thread, sample_buffer, os_thread->trace_id(),
+                               os_thread->sample_block());
   // Increment counter for vm tag.
   VMTagCounters* counters = isolate->vm_tag_counters();
   ASSERT(counters != NULL);
@@ -1361,7 +1426,8 @@ void Profiler::SampleThread(Thread* thread,
   }
 
   // Setup sample.
-  Sample* sample = SetupSample(thread, sample_buffer, os_thread->trace_id());
+  Sample* sample = SetupSample(thread, sample_buffer, os_thread->trace_id(),
+                               os_thread->sample_block());
   // Increment counter for vm tag.
   VMTagCounters* counters = isolate->vm_tag_counters();
   ASSERT(counters != NULL);
@@ -1376,6 +1442,8 @@ void Profiler::SampleThread(Thread* thread,
   ProfilerDartStackWalker dart_stack_walker(thread, sample, sample_buffer,
                                             stack_lower, stack_upper, pc, fp,
                                             sp, exited_dart_code, false);
+  native_stack_walker.set_sample_block(os_thread->sample_block());
+  dart_stack_walker.set_sample_block(os_thread->sample_block());
 
   // All memory access is done inside CollectSample.
   CollectSample(isolate, exited_dart_code, in_dart_code, sample,
@@ -1566,6 +1634,8 @@ ProcessedSample* SampleBuffer::BuildProcessedSample(
   // Copy state bits from sample.
   processed_sample->set_native_allocation_size_bytes(
       sample->native_allocation_size_bytes());
+  processed_sample->set_sampled_allocation_size(
+      sample->sampled_allocation_size());
   processed_sample->set_timestamp(sample->timestamp());
   processed_sample->set_tid(sample->tid());
   processed_sample->set_vm_tag(sample->vm_tag());
@@ -1624,6 +1694,9 @@ ProcessedSample::ProcessedSample()
       user_tag_(0),
       allocation_cid_(-1),
       truncated_(false),
+      native_allocation_address_(0),
+      native_allocation_size_bytes_(0),
+      sampled_allocation_size_(0),
       timeline_trie_(NULL) {}
 
 void ProcessedSample::FixupCaller(const CodeLookupTable& clt,
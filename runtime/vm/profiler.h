@@ -29,6 +29,7 @@ class Sample;
 class AllocationSampleBuffer;
 class SampleBuffer;
 class ProfileTrieNode;
+struct SampleBlock;
 
 struct ProfilerCounters {
   // Count of bail out reasons:
@@ -65,7 +66,11 @@ class Profiler : public AllStatic {
   static void DumpStackTrace(void* context);
   static void DumpStackTrace(bool for_crash = true);
 
-  static void SampleAllocation(Thread* thread, intptr_t cid);
+  // [sampled_size] is the size of the allocation chosen by the HeapSampler,
+  // or 0 for an allocation of a class whose allocations are traced.
+  static void SampleAllocation(Thread* thread,
+                               intptr_t cid,
+                               intptr_t sampled_size = 0);
   static Sample* SampleNativeAllocation(intptr_t skip_count,
                                         uword address,
                                         uintptr_t allocation_size);
@@ -192,6 +197,7 @@ class Sample {
     state_ = 0;
     native_allocation_address_ = 0;
     native_allocation_size_bytes_ = 0;
+    sampled_allocation_size_ = 0;
     continuation_index_ = -1;
     next_free_ = NULL;
     uword* pcs = GetPCArray();
@@ -309,6 +315,12 @@ class Sample {
     native_allocation_size_bytes_ = size;
   }
 
+  intptr_t sampled_allocation_size() const { return sampled_allocation_size_; }
+
+  void set_sampled_allocation_size(intptr_t size) {
+    sampled_allocation_size_ = size;
+  }
+
   Sample* next_free() const { return next_free_; }
   void set_next_free(Sample* next_free) { next_free_ = next_free; }
 
@@ -357,6 +369,9 @@ class Sample {
 
   static intptr_t instance_size() { return instance_size_; }
 
+  // The number of pcs a sample holds, see At.
+  static intptr_t pcs_length() { return pcs_length_; }
+
   uword* GetPCArray() const;
 
   static const int kStackBufferSizeInWords = 2;
@@ -405,6 +420,7 @@ class Sample {
   uword state_;
   uword native_allocation_address_;
   uintptr_t native_allocation_size_bytes_;
+  intptr_t sampled_allocation_size_;
   intptr_t continuation_index_;
   Sample* next_free_;
 
@@ -503,10 +519,16 @@ class CodeLookupTable : public ZoneAllocated {
 };
 
 // Ring buffer of Samples that is (usually) shared by many isolates.
+//
+// Samples of interrupted threads are taken in blocks of kSamplesPerBlock
+// slots that belong to one thread at a time, so that threads sampled at the
+// same time rarely update the shared cursor. Samples are not ordered by time
+// in the buffer either way; readers always visit all slots.
 class SampleBuffer {
  public:
   // Up to 1 minute @ 1000Hz, less if samples are deep.
   static const intptr_t kDefaultBufferCapacity = 60000;
+  static const intptr_t kSamplesPerBlock = 64;
 
   explicit SampleBuffer(intptr_t capacity = kDefaultBufferCapacity);
   virtual ~SampleBuffer();
@@ -518,6 +540,11 @@ class SampleBuffer {
   virtual Sample* ReserveSample();
   virtual Sample* ReserveSampleAndLink(Sample* previous);
 
+  // As above, but takes the slot from |block|, reserving a new block of
+  // slots for it when it is used up. Safe to call from a signal handler.
+  Sample* ReserveBlockSample(SampleBlock* block);
+  Sample* ReserveBlockSampleAndLink(Sample* previous, SampleBlock* block);
+
   void VisitSamples(SampleVisitor* visitor) {
     ASSERT(visitor != NULL);
     const intptr_t length = capacity();
@@ -554,6 +581,8 @@ class SampleBuffer {
   ProcessedSample* BuildProcessedSample(Sample* sample,
                                         const CodeLookupTable& clt);
   Sample* Next(Sample* sample);
+  intptr_t ReserveSampleSlot(SampleBlock* block);
+  Sample* Link(Sample* previous, intptr_t next_index);
 
   VirtualMemory* memory_;
   Sample* samples_;
@@ -636,6 +665,13 @@ class ProcessedSample : public ZoneAllocated {
     native_allocation_size_bytes_ = allocation_size;
   }
 
+  // The size of the allocation if it was chosen by the HeapSampler. 0
+  // otherwise.
+  intptr_t sampled_allocation_size() const { return sampled_allocation_size_; }
+  void set_sampled_allocation_size(intptr_t size) {
+    sampled_allocation_size_ = size;
+  }
+
   // Was the stack trace truncated?
   bool truncated() const { return truncated_; }
   void set_truncated(bool truncated) { truncated_ = truncated; }
@@ -672,6 +708,7 @@ class ProcessedSample : public ZoneAllocated {
   bool first_frame_executing_;
   uword native_allocation_address_;
   uintptr_t native_allocation_size_bytes_;
+  intptr_t sampled_allocation_size_;
   ProfileTrieNode* timeline_trie_;
 
   friend class SampleBuffer;
@@ -6,11 +6,14 @@
 
 #include "vm/growable_array.h"
 #include "vm/hash_map.h"
+#include "vm/heap/sampler.h"
 #include "vm/log.h"
 #include "vm/malloc_hooks.h"
 #include "vm/native_symbol.h"
 #include "vm/object.h"
+#include "vm/object_graph.h"
 #include "vm/os.h"
+#include "vm/perf_counters.h"
 #include "vm/profiler.h"
 #include "vm/reusable_handles.h"
 #include "vm/scope_timer.h"
@@ -2366,6 +2369,11 @@ ProfileTrieNode* Profile::GetTrieRoot(TrieKind trie_kind) {
 
 void Profile::PrintHeaderJSON(JSONObject* obj) {
   obj->AddProperty("samplePeriod", static_cast<intptr_t>(FLAG_profile_period));
+  if (PerfCounters::SamplingEnabled()) {
+    // Each tick stands for eventsPerSample occurrences of the event.
+    obj->AddProperty("sampleEvent", PerfCounters::EventName());
+    obj->AddProperty("eventsPerSample", PerfCounters::SamplePeriod());
+  }
   obj->AddProperty("stackDepth", static_cast<intptr_t>(FLAG_max_profile_depth));
   obj->AddProperty("sampleCount", sample_count());
   obj->AddProperty("timeSpan", MicrosecondsToSeconds(GetTimeSpan()));
@@ -2759,6 +2767,7 @@ class ClassAllocationSampleFilter : public SampleFilter {
 
   bool FilterSample(Sample* sample) {
     return sample->is_allocation_sample() &&
+           (sample->sampled_allocation_size() == 0) &&
            (sample->allocation_cid() == cls_.id());
   }
 
@@ -2800,7 +2809,8 @@ void ProfilerService::PrintTimelineJSON(JSONStream* stream,
   Isolate* isolate = thread->isolate();
   const intptr_t thread_task_mask = Thread::kMutatorTask |
                                     Thread::kCompilerTask |
-                                    Thread::kSweeperTask | Thread::kMarkerTask;
+                                    Thread::kSweeperTask | Thread::kMarkerTask |
+                                    Thread::kScavengerTask;
   NoAllocationSampleFilter filter(isolate->main_port(), thread_task_mask,
                                   time_origin_micros, time_extent_micros);
   const bool as_timeline = true;
@@ -2808,6 +2818,566 @@ void ProfilerService::PrintTimelineJSON(JSONStream* stream,
                 Profiler::sample_buffer(), as_timeline);
 }
 
+class AllocationSampleFilter : public SampleFilter {
+ public:
+  AllocationSampleFilter(Dart_Port port,
+                         bool sampled,
+                         intptr_t thread_task_mask,
+                         int64_t time_origin_micros,
+                         int64_t time_extent_micros)
+      : SampleFilter(port,
+                     thread_task_mask,
+                     time_origin_micros,
+                     time_extent_micros),
+        sampled_(sampled) {}
+
+  // Samples of traced classes and samples taken by the HeapSampler are
+  // kept apart, as only the latter can be scaled to the whole heap.
+  bool FilterSample(Sample* sample) {
+    return sample->is_allocation_sample() &&
+           ((sample->sampled_allocation_size() != 0) == sampled_);
+  }
+
+ private:
+  const bool sampled_;
+};
+
+// Encodes the few protocol buffer wire types used by pprof profiles.
+class PprofMessage : public ValueObject {
+ public:
+  static const intptr_t kMaxVarintLength = 10;
+
+  explicit PprofMessage(Zone* zone) : bytes_(zone, 64) {}
+
+  const uint8_t* data() const { return bytes_.data(); }
+  intptr_t length() const { return bytes_.length(); }
+  void Clear() { bytes_.Clear(); }
+
+  // Writes 'value' to 'buffer', which holds at least kMaxVarintLength bytes.
+  // Returns the number of bytes written.
+  static intptr_t EncodeVarint(uint64_t value, uint8_t* buffer) {
+    intptr_t length = 0;
+    while (value >= 0x80) {
+      buffer[length++] = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    buffer[length++] = static_cast<uint8_t>(value);
+    return length;
+  }
+
+  static uint64_t Tag(intptr_t field, intptr_t wire_type) {
+    return (static_cast<uint64_t>(field) << 3) | wire_type;
+  }
+
+  void WriteVarint(uint64_t value) {
+    uint8_t buffer[kMaxVarintLength];
+    const intptr_t length = EncodeVarint(value, buffer);
+    for (intptr_t i = 0; i < length; i++) {
+      bytes_.Add(buffer[i]);
+    }
+  }
+
+  void WriteVarintField(intptr_t field, uint64_t value) {
+    WriteVarint(Tag(field, kVarintWireType));
+    WriteVarint(value);
+  }
+
+  // Embedded messages and packed repeated fields.
+  void WriteMessageField(intptr_t field, const PprofMessage& message) {
+    WriteVarint(Tag(field, kLengthDelimitedWireType));
+    WriteVarint(message.length());
+    for (intptr_t i = 0; i < message.length(); i++) {
+      bytes_.Add(message.data()[i]);
+    }
+  }
+
+  static const intptr_t kVarintWireType = 0;
+  static const intptr_t kLengthDelimitedWireType = 2;
+
+ private:
+  GrowableArray<uint8_t> bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(PprofMessage);
+};
+
+// Writes processed samples as a perftools.profiles.Profile message. The
+// fields of a message may come in any order, so strings, functions and
+// locations are written the first time a sample refers to them and only
+// their ids are remembered.
+class PprofWriter : public ValueObject {
+ public:
+  PprofWriter(Thread* thread,
+              ProfilerService::PprofKind kind,
+              ChunkedWriter* writer,
+              const CodeLookupTable& code_lookup_table)
+      : thread_(thread),
+        zone_(thread->zone()),
+        kind_(kind),
+        writer_(writer),
+        code_lookup_table_(code_lookup_table),
+        functions_(new ProfileFunctionTable()),
+        functions_written_(0),
+        string_count_(0),
+        location_count_(0),
+        message_(zone_),
+        field_(zone_),
+        location_ids_(zone_, 64),
+        first_timestamp_(kMaxInt64),
+        last_timestamp_(0) {
+    // The string with index 0 must be the empty string.
+    WriteRecord(kProfileStringTable, NULL, 0);
+    WriteHeader();
+  }
+
+  void WriteSample(ProcessedSample* sample) {
+    location_ids_.Clear();
+    for (intptr_t i = 0; i < sample->length(); i++) {
+      location_ids_.Add(LocationId(sample, i));
+    }
+    // Label strings are written before the sample that refers to them.
+    intptr_t label_key = 0;
+    intptr_t label_value = 0;
+    if (kind_ != ProfilerService::kPprofCpu) {
+      label_key = StringIndex("class");
+      label_value = ClassNameIndex(sample->allocation_cid());
+    } else {
+      const uword tag = sample->vm_tag();
+      if (VMTag::IsVMTag(tag) || VMTag::IsRuntimeEntryTag(tag) ||
+          VMTag::IsNativeEntryTag(tag)) {
+        label_key = StringIndex("vm_tag");
+        label_value = StringIndex(VMTag::TagName(tag));
+      }
+    }
+
+    message_.Clear();
+    field_.Clear();
+    for (intptr_t i = 0; i < location_ids_.length(); i++) {
+      field_.WriteVarint(location_ids_[i]);
+    }
+    message_.WriteMessageField(kSampleLocationId, field_);
+    field_.Clear();
+    if (kind_ == ProfilerService::kPprofHeap) {
+      // Scale the sample to the allocations it stands for.
+      const intptr_t size = sample->sampled_allocation_size();
+      const double weight = HeapSampler::Weight(size);
+      field_.WriteVarint(static_cast<uint64_t>(weight + 0.5));
+      field_.WriteVarint(static_cast<uint64_t>(size * weight + 0.5));
+    } else {
+      field_.WriteVarint(1);
+    }
+    if (kind_ == ProfilerService::kPprofCpu) {
+      field_.WriteVarint(static_cast<uint64_t>(FLAG_profile_period) *
+                         kNanosecondsPerMicrosecond);
+    }
+    message_.WriteMessageField(kSampleValue, field_);
+    if (label_key != 0) {
+      field_.Clear();
+      field_.WriteVarintField(kLabelKey, label_key);
+      field_.WriteVarintField(kLabelStr, label_value);
+      message_.WriteMessageField(kSampleLabel, field_);
+    }
+    WriteRecord(kProfileSample, message_);
+
+    if (sample->timestamp() < first_timestamp_) {
+      first_timestamp_ = sample->timestamp();
+    }
+    if (sample->timestamp() > last_timestamp_) {
+      last_timestamp_ = sample->timestamp();
+    }
+  }
+
+  void Finish() {
+    if (last_timestamp_ != 0) {
+      // Samples are timestamped with the monotonic clock.
+      const int64_t wall_clock_offset =
+          OS::GetCurrentTimeMicros() - OS::GetCurrentMonotonicMicros();
+      message_.Clear();
+      message_.WriteVarintField(
+          kProfileTimeNanos, (first_timestamp_ + wall_clock_offset) *
+                                 kNanosecondsPerMicrosecond);
+      message_.WriteVarintField(
+          kProfileDurationNanos,
+          (last_timestamp_ - first_timestamp_) * kNanosecondsPerMicrosecond);
+      writer_->stream()->WriteBytes(message_.data(), message_.length());
+    }
+    writer_->Finish();
+  }
+
+ private:
+  // Field numbers from pprof's profile.proto.
+  enum {
+    kProfileSampleType = 1,
+    kProfileSample = 2,
+    kProfileLocation = 4,
+    kProfileFunction = 5,
+    kProfileStringTable = 6,
+    kProfileTimeNanos = 9,
+    kProfileDurationNanos = 10,
+    kProfilePeriodType = 11,
+    kProfilePeriod = 12,
+    kProfileDefaultSampleType = 14,
+
+    kValueTypeType = 1,
+    kValueTypeUnit = 2,
+
+    kSampleLocationId = 1,
+    kSampleValue = 2,
+    kSampleLabel = 3,
+
+    kLabelKey = 1,
+    kLabelStr = 2,
+
+    kLocationId = 1,
+    kLocationAddress = 3,
+    kLocationLine = 4,
+
+    kLineFunctionId = 1,
+    kLineLine = 2,
+
+    kFunctionId = 1,
+    kFunctionName = 2,
+    kFunctionSystemName = 3,
+    kFunctionFilename = 4,
+    kFunctionStartLine = 5,
+  };
+
+  // Writes a length-delimited field of the top-level Profile message.
+  void WriteRecord(intptr_t field, const uint8_t* data, intptr_t length) {
+    uint8_t header[2 * PprofMessage::kMaxVarintLength];
+    intptr_t header_length = PprofMessage::EncodeVarint(
+        PprofMessage::Tag(field, PprofMessage::kLengthDelimitedWireType),
+        header);
+    header_length += PprofMessage::EncodeVarint(length, header + header_length);
+    writer_->stream()->WriteBytes(header, header_length);
+    if (length > 0) {
+      writer_->stream()->WriteBytes(data, length);
+    }
+    writer_->MaybeFlush();
+  }
+
+  void WriteRecord(intptr_t field, const PprofMessage& message) {
+    WriteRecord(field, message.data(), message.length());
+  }
+
+  void WriteValueType(intptr_t field, const char* type, const char* unit) {
+    const intptr_t type_index = StringIndex(type);
+    const intptr_t unit_index = StringIndex(unit);
+    message_.Clear();
+    message_.WriteVarintField(kValueTypeType, type_index);
+    message_.WriteVarintField(kValueTypeUnit, unit_index);
+    WriteRecord(field, message_);
+  }
+
+  void WriteHeader() {
+    if (kind_ == ProfilerService::kPprofCpu) {
+      WriteValueType(kProfileSampleType, "samples", "count");
+      WriteValueType(kProfileSampleType, "cpu", "nanoseconds");
+      WriteValueType(kProfilePeriodType, "cpu", "nanoseconds");
+      message_.Clear();
+      message_.WriteVarintField(kProfilePeriod,
+                                static_cast<uint64_t>(FLAG_profile_period) *
+                                    kNanosecondsPerMicrosecond);
+      message_.WriteVarintField(kProfileDefaultSampleType, StringIndex("cpu"));
+    } else if (kind_ == ProfilerService::kPprofHeap) {
+      WriteValueType(kProfileSampleType, "alloc_objects", "count");
+      WriteValueType(kProfileSampleType, "alloc_space", "bytes");
+      WriteValueType(kProfilePeriodType, "space", "bytes");
+      message_.Clear();
+      message_.WriteVarintField(kProfilePeriod, HeapSampler::interval());
+      message_.WriteVarintField(kProfileDefaultSampleType,
+                                StringIndex("alloc_space"));
+    } else {
+      WriteValueType(kProfileSampleType, "alloc_objects", "count");
+      WriteValueType(kProfilePeriodType, "alloc_objects", "count");
+      message_.Clear();
+      message_.WriteVarintField(kProfilePeriod, 1);
+      message_.WriteVarintField(kProfileDefaultSampleType,
+                                StringIndex("alloc_objects"));
+    }
+    writer_->stream()->WriteBytes(message_.data(), message_.length());
+  }
+
+  intptr_t StringIndex(const char* value) {
+    if (value[0] == '\0') {
+      return 0;
+    }
+    const intptr_t index = strings_.LookupValue(value);
+    if (index != 0) {
+      return index;
+    }
+    string_count_++;
+    strings_.Insert(
+        StringTableTrait::Pair(zone_->MakeCopyOfString(value), string_count_));
+    WriteRecord(kProfileStringTable, reinterpret_cast<const uint8_t*>(value),
+                strlen(value));
+    return string_count_;
+  }
+
+  intptr_t ClassNameIndex(intptr_t cid) {
+    intptr_t index = class_names_.Lookup(cid);
+    if (index == 0) {
+      const Class& cls =
+          Class::Handle(zone_, thread_->isolate()->class_table()->At(cid));
+      const String& name = String::Handle(zone_, cls.ScrubbedName());
+      index = StringIndex(name.ToCString());
+      class_names_.Insert(cid, index);
+    }
+    return index;
+  }
+
+  intptr_t LineNumber(const Function& function, TokenPosition token_pos) {
+    if (!token_pos.IsReal()) {
+      return 0;
+    }
+    const Script& script = Script::Handle(zone_, function.script());
+    if (script.IsNull()) {
+      return 0;
+    }
+    intptr_t line = 0;
+    intptr_t column = 0;
+    script.GetTokenLocation(token_pos, &line, &column);
+    return line;
+  }
+
+  void WriteFunction(ProfileFunction* function) {
+    const intptr_t name_index = StringIndex(function->Name());
+    intptr_t filename_index = 0;
+    intptr_t start_line = 0;
+    if (function->kind() == ProfileFunction::kDartFunction) {
+      const Function& dart_function = *function->function();
+      const Script& script = Script::Handle(zone_, dart_function.script());
+      if (!script.IsNull()) {
+        const String& url = String::Handle(zone_, script.url());
+        filename_index = StringIndex(url.ToCString());
+        start_line = LineNumber(dart_function, dart_function.token_pos());
+      }
+    }
+    message_.Clear();
+    message_.WriteVarintField(kFunctionId, FunctionId(function));
+    message_.WriteVarintField(kFunctionName, name_index);
+    message_.WriteVarintField(kFunctionSystemName, name_index);
+    if (filename_index != 0) {
+      message_.WriteVarintField(kFunctionFilename, filename_index);
+    }
+    if (start_line != 0) {
+      message_.WriteVarintField(kFunctionStartLine, start_line);
+    }
+    WriteRecord(kProfileFunction, message_);
+  }
+
+  static intptr_t FunctionId(ProfileFunction* function) {
+    return function->table_index() + 1;
+  }
+
+  // Writes the functions added to the table since the last call.
+  void WriteNewFunctions() {
+    while (functions_written_ < functions_->length()) {
+      WriteFunction(functions_->At(functions_written_++));
+    }
+  }
+
+  ProfileFunction* NativeFunction(uword pc) {
+    uintptr_t start = 0;
+    char* symbol = NativeSymbolResolver::LookupSymbolName(pc, &start);
+    if (symbol == NULL) {
+      // Without a symbol, every pc is a function of its own.
+      start = pc;
+    }
+    ProfileFunction* function = functions_by_start_.Lookup(start);
+    if (function == NULL) {
+      const char* name = NULL;
+      uword dso_base;
+      char* dso_name;
+      if (symbol != NULL) {
+        name = zone_->MakeCopyOfString(symbol);
+      } else if (NativeSymbolResolver::LookupSharedObject(pc, &dso_base,
+                                                          &dso_name)) {
+        name = OS::SCreate(zone_, "[Native] %s+0x%" Px, dso_name,
+                           pc - dso_base);
+        NativeSymbolResolver::FreeSymbolName(dso_name);
+      } else {
+        name = OS::SCreate(zone_, "[Native] 0x%" Px, pc);
+      }
+      function = functions_->AddNative(start, name);
+      functions_by_start_.Insert(start, function);
+    }
+    if (symbol != NULL) {
+      NativeSymbolResolver::FreeSymbolName(symbol);
+    }
+    return function;
+  }
+
+  ProfileFunction* StubFunction(const Code& code) {
+    const uword start = code.PayloadStart();
+    ProfileFunction* function = functions_by_start_.Lookup(start);
+    if (function == NULL) {
+      function = functions_->AddStub(start, code.QualifiedName());
+      functions_by_start_.Insert(start, function);
+    }
+    return function;
+  }
+
+  // Returns the id of the location of frame 'frame_index' of 'sample',
+  // writing the location first if needed.
+  intptr_t LocationId(ProcessedSample* sample, intptr_t frame_index) {
+    const uword pc = sample->At(frame_index);
+    // The pc of an executing top frame is an instruction rather than a
+    // return address, and can be attributed to different inlined functions.
+    const bool executing = (frame_index == 0) &&
+                           !sample->IsAllocationSample() &&
+                           sample->first_frame_executing();
+    IntMap<intptr_t>* locations =
+        executing ? &executing_locations_ : &return_locations_;
+    intptr_t id = locations->Lookup(pc);
+    if (id != 0) {
+      return id;
+    }
+    id = ++location_count_;
+    locations->Insert(pc, id);
+    WriteLocation(id, pc, sample, frame_index);
+    return id;
+  }
+
+  void WriteLocation(intptr_t id,
+                     uword pc,
+                     ProcessedSample* sample,
+                     intptr_t frame_index) {
+    // pprof lists the innermost of a location's inlined functions first.
+    GrowableArray<ProfileFunction*> functions(zone_, 4);
+    GrowableArray<intptr_t> lines(zone_, 4);
+    const CodeDescriptor* descriptor = code_lookup_table_.FindCode(pc);
+    if (descriptor == NULL) {
+      functions.Add(NativeFunction(pc));
+      lines.Add(0);
+    } else {
+      const Code& code = Code::Handle(zone_, descriptor->code());
+      const Object& owner = Object::Handle(zone_, code.owner());
+      GrowableArray<const Function*>* inlined_functions = NULL;
+      GrowableArray<TokenPosition>* inlined_token_positions = NULL;
+      TokenPosition token_position = TokenPosition::kNoSource;
+      if (owner.IsFunction()) {
+        inlined_functions_cache_.Get(pc, code, sample, frame_index,
+                                     &inlined_functions,
+                                     &inlined_token_positions, &token_position);
+      }
+      if (!owner.IsFunction()) {
+        functions.Add(StubFunction(code));
+        lines.Add(0);
+      } else if (inlined_functions == NULL) {
+        functions.Add(functions_->LookupOrAdd(Function::Cast(owner)));
+        lines.Add(0);
+      } else {
+        for (intptr_t i = inlined_functions->length() - 1; i >= 0; i--) {
+          const Function& function = *(*inlined_functions)[i];
+          functions.Add(functions_->LookupOrAdd(function));
+          lines.Add(LineNumber(function, (*inlined_token_positions)[i]));
+        }
+      }
+    }
+    WriteNewFunctions();
+
+    message_.Clear();
+    message_.WriteVarintField(kLocationId, id);
+    message_.WriteVarintField(kLocationAddress, pc);
+    for (intptr_t i = 0; i < functions.length(); i++) {
+      field_.Clear();
+      field_.WriteVarintField(kLineFunctionId, FunctionId(functions[i]));
+      if (lines[i] != 0) {
+        field_.WriteVarintField(kLineLine, lines[i]);
+      }
+      message_.WriteMessageField(kLocationLine, field_);
+    }
+    WriteRecord(kProfileLocation, message_);
+  }
+
+  struct StringTableTrait {
+    typedef const char* Key;
+    typedef intptr_t Value;
+
+    struct Pair {
+      Key key;
+      Value value;
+      Pair() : key(NULL), value(0) {}
+      Pair(const Key key, const Value& value) : key(key), value(value) {}
+      Pair(const Pair& other) : key(other.key), value(other.value) {}
+    };
+
+    static Key KeyOf(Pair kv) { return kv.key; }
+    static Value ValueOf(Pair kv) { return kv.value; }
+    static intptr_t Hashcode(Key key) { return String::Hash(key, strlen(key)); }
+    static bool IsKeyEqual(Pair kv, Key key) {
+      return strcmp(kv.key, key) == 0;
+    }
+  };
+
+  Thread* thread_;
+  Zone* zone_;
+  const ProfilerService::PprofKind kind_;
+  ChunkedWriter* writer_;
+  const CodeLookupTable& code_lookup_table_;
+  ProfileCodeInlinedFunctionsCache inlined_functions_cache_;
+
+  ProfileFunctionTable* functions_;
+  intptr_t functions_written_;
+  // Native and stub functions by start address.
+  IntMap<ProfileFunction*> functions_by_start_;
+
+  DirectChainedHashMap<StringTableTrait> strings_;
+  intptr_t string_count_;
+  IntMap<intptr_t> class_names_;
+
+  IntMap<intptr_t> executing_locations_;
+  IntMap<intptr_t> return_locations_;
+  intptr_t location_count_;
+
+  PprofMessage message_;
+  PprofMessage field_;
+  GrowableArray<intptr_t> location_ids_;
+
+  int64_t first_timestamp_;
+  int64_t last_timestamp_;
+
+  DISALLOW_COPY_AND_ASSIGN(PprofWriter);
+};
+
+bool ProfilerService::WritePprof(Thread* thread,
+                                 PprofKind kind,
+                                 ChunkedWriter* writer,
+                                 int64_t time_origin_micros,
+                                 int64_t time_extent_micros) {
+  Isolate* isolate = thread->isolate();
+  // Disable thread interrupts while processing the buffer.
+  DisableThreadInterruptsScope dtis(thread);
+
+  SampleBuffer* sample_buffer = Profiler::sample_buffer();
+  if (sample_buffer == NULL) {
+    return false;
+  }
+
+  {
+    StackZone zone(thread);
+    HANDLESCOPE(thread);
+    ProcessedSampleBuffer* samples = NULL;
+    if (kind == kPprofCpu) {
+      NoAllocationSampleFilter filter(isolate->main_port(),
+                                      Thread::kMutatorTask, time_origin_micros,
+                                      time_extent_micros);
+      samples = sample_buffer->BuildProcessedSampleBuffer(&filter);
+    } else {
+      AllocationSampleFilter filter(isolate->main_port(), kind == kPprofHeap,
+                                    Thread::kMutatorTask, time_origin_micros,
+                                    time_extent_micros);
+      samples = sample_buffer->BuildProcessedSampleBuffer(&filter);
+    }
+    PprofWriter pprof(thread, kind, writer, samples->code_lookup_table());
+    for (intptr_t i = 0; i < samples->length(); i++) {
+      pprof.WriteSample(samples->At(i));
+    }
+    pprof.Finish();
+  }
+  return true;
+}
+
 void ProfilerService::ClearSamples() {
   SampleBuffer* sample_buffer = Profiler::sample_buffer();
   if (sample_buffer == NULL) {
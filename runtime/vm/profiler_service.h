@@ -20,6 +20,7 @@
 namespace dart {
 
 // Forward declarations.
+class ChunkedWriter;
 class Code;
 class Function;
 class JSONArray;
@@ -484,6 +485,22 @@ class ProfilerService : public AllStatic {
                                 int64_t time_origin_micros,
                                 int64_t time_extent_micros);
 
+  enum PprofKind {
+    kPprofCpu,         // Sampled CPU time.
+    kPprofAllocation,  // Allocations of classes with traced allocations.
+    kPprofHeap,        // Allocations sampled by --heap_sample_interval.
+  };
+
+  // Writes the isolate's samples to 'writer' as a pprof profile, which pprof
+  // tools expect to be gzipped. Unlike the JSON profiles, no call trees are
+  // built: each sample is written as soon as its frames are resolved.
+  // Returns false if the profiler is disabled.
+  static bool WritePprof(Thread* thread,
+                         PprofKind kind,
+                         ChunkedWriter* writer,
+                         int64_t time_origin_micros,
+                         int64_t time_extent_micros);
+
   static void ClearSamples();
 
  private:
@@ -7,6 +7,7 @@
 #include "vm/dart_api_impl.h"
 #include "vm/dart_api_state.h"
 #include "vm/globals.h"
+#include "vm/object_graph.h"
 #include "vm/profiler.h"
 #include "vm/profiler_service.h"
 #include "vm/source_report.h"
@@ -18,6 +19,7 @@ namespace dart {
 
 DECLARE_FLAG(bool, profile_vm);
 DECLARE_FLAG(int, max_profile_depth);
+DECLARE_FLAG(int, heap_sample_interval);
 DECLARE_FLAG(bool, enable_inlining_annotations);
 DECLARE_FLAG(int, optimization_counter_threshold);
 
@@ -136,6 +138,34 @@ TEST_CASE(Profiler_SampleBufferIterateTest) {
   delete sample_buffer;
 }
 
+TEST_CASE(Profiler_SampleBufferBlockTest) {
+  const intptr_t kBlock = SampleBuffer::kSamplesPerBlock;
+  SampleBuffer* sample_buffer = new SampleBuffer(4 * kBlock);
+  SampleBlock first;
+  SampleBlock second;
+  // Each block hands out consecutive slots.
+  Sample* a = sample_buffer->ReserveBlockSample(&first);
+  Sample* b = sample_buffer->ReserveBlockSample(&second);
+  EXPECT_EQ(sample_buffer->At(0), a);
+  EXPECT_EQ(sample_buffer->At(kBlock), b);
+  EXPECT_EQ(sample_buffer->At(1), sample_buffer->ReserveBlockSample(&first));
+  // Samples reserved without a block do not share slots with blocks.
+  EXPECT_EQ(sample_buffer->At(2 * kBlock), sample_buffer->ReserveSample());
+  for (intptr_t i = 2; i < kBlock; i++) {
+    sample_buffer->ReserveBlockSample(&first);
+  }
+  // A used up block is replaced by the next free one.
+  EXPECT_EQ(sample_buffer->At(2 * kBlock + 1),
+            sample_buffer->ReserveBlockSample(&first));
+  // Continuations of a sample come from the same block.
+  b->Init(123, 0, 0);
+  Sample* c = sample_buffer->ReserveBlockSampleAndLink(b, &second);
+  EXPECT_EQ(sample_buffer->At(kBlock + 1), c);
+  EXPECT(!c->head_sample());
+  EXPECT_EQ(kBlock + 1, b->continuation_index());
+  delete sample_buffer;
+}
+
 TEST_CASE(Profiler_AllocationSampleTest) {
   Isolate* isolate = Isolate::Current();
   SampleBuffer* sample_buffer = new SampleBuffer(3);
@@ -2944,6 +2974,128 @@ TEST_CASE(Profiler_ProfileCodeTableTest) {
   EXPECT_EQ(table->FindCodeForPC(50), code1);
 }
 
+// Collects an uncompressed pprof profile.
+class PprofTestWriter : public ChunkedWriter {
+ public:
+  PprofTestWriter() : ChunkedWriter(256, false), output_(1024) {}
+
+  virtual void WriteChunk(const uint8_t* data, intptr_t size, bool last) {
+    for (intptr_t i = 0; i < size; i++) {
+      output_.Add(data[i]);
+    }
+  }
+
+  const MallocGrowableArray<uint8_t>& output() const { return output_; }
+
+  // Whether the string table contains 'value'.
+  bool HasString(const char* value) const {
+    const intptr_t length = strlen(value);
+    // A string table entry: field 6, wire type 2, then a one byte length.
+    for (intptr_t i = 0; i + 2 + length <= output_.length(); i++) {
+      if ((output_[i] == 0x32) && (output_[i + 1] == length) &&
+          (memcmp(&output_[i + 2], value, length) == 0)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  MallocGrowableArray<uint8_t> output_;
+};
+
+TEST_CASE(Profiler_PprofAllocation) {
+  EnableProfiler();
+  DisableNativeProfileScope dnps;
+  const char* kScript =
+      "class A {\n"
+      "  var a;\n"
+      "  var b;\n"
+      "}\n"
+      "class B {\n"
+      "  static boo() {\n"
+      "    return new A();\n"
+      "  }\n"
+      "}\n"
+      "main() {\n"
+      "  return B.boo();\n"
+      "}\n";
+
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+  Library& root_library = Library::Handle();
+  root_library ^= Api::UnwrapHandle(lib);
+
+  const int64_t before_allocations_micros = Dart_TimelineGetMicros();
+  const Class& class_a = Class::Handle(GetClass(root_library, "A"));
+  EXPECT(!class_a.IsNull());
+  class_a.SetTraceAllocation(true);
+
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+
+  const int64_t allocation_extent_micros =
+      Dart_TimelineGetMicros() - before_allocations_micros;
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    PprofTestWriter writer;
+    EXPECT(ProfilerService::WritePprof(
+        thread, ProfilerService::kPprofAllocation, &writer,
+        before_allocations_micros, allocation_extent_micros));
+    // The string table starts with the empty string.
+    EXPECT_LE(2, writer.output().length());
+    EXPECT_EQ(0x32, writer.output()[0]);
+    EXPECT_EQ(0, writer.output()[1]);
+    EXPECT(writer.HasString("alloc_objects"));
+    EXPECT(writer.HasString("class"));
+    EXPECT(writer.HasString("A"));
+    EXPECT(writer.HasString("B.boo"));
+    EXPECT(writer.HasString("main"));
+  }
+}
+
+TEST_CASE(Profiler_PprofHeap) {
+  EnableProfiler();
+  DisableNativeProfileScope dnps;
+  SetFlagScope<int> sfs(&FLAG_heap_sample_interval, 1);
+  // Large arrays are allocated in old space, where sampling starts at once.
+  const char* kScript =
+      "class C {\n"
+      "  static makeLists() {\n"
+      "    var lists = [];\n"
+      "    for (var i = 0; i < 10; i++) {\n"
+      "      lists.add(new List(100000));\n"
+      "    }\n"
+      "    return lists;\n"
+      "  }\n"
+      "}\n"
+      "main() {\n"
+      "  return C.makeLists();\n"
+      "}\n";
+
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+
+  const int64_t before_allocations_micros = Dart_TimelineGetMicros();
+  Dart_Handle result = Dart_Invoke(lib, NewString("main"), 0, NULL);
+  EXPECT_VALID(result);
+  const int64_t allocation_extent_micros =
+      Dart_TimelineGetMicros() - before_allocations_micros;
+
+  {
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    PprofTestWriter writer;
+    EXPECT(ProfilerService::WritePprof(thread, ProfilerService::kPprofHeap,
+                                       &writer, before_allocations_micros,
+                                       allocation_extent_micros));
+    EXPECT(writer.HasString("alloc_space"));
+    EXPECT(writer.HasString("_List"));
+    EXPECT(writer.HasString("C.makeLists"));
+  }
+}
+
 #endif  // !PRODUCT
 
 }  // namespace dart
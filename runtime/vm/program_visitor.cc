@@ -5,6 +5,7 @@
 #include "vm/program_visitor.h"
 
 #include "vm/deopt_instructions.h"
+#include "vm/hash.h"
 #include "vm/hash_map.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
@@ -68,7 +69,7 @@ class ClassFunctionVisitor : public ClassVisitor {
       }
     }
 
-    functions_ = cls.invocation_dispatcher_cache();
+    functions_ = cls.InvocationDispatcherEntries();
     for (intptr_t j = 0; j < functions_.Length(); j++) {
       object_ = functions_.At(j);
       if (object_.IsFunction()) {
@@ -427,6 +428,126 @@ void ProgramVisitor::DedupCatchEntryStateMaps() {
   DedupCatchEntryStateMapsVisitor visitor(Thread::Current()->zone());
   ProgramVisitor::VisitFunctions(&visitor);
 }
+
+class ObjectPoolKeyValueTrait {
+ public:
+  // Typedefs needed for the DirectChainedHashMap template.
+  typedef const ObjectPool* Key;
+  typedef const ObjectPool* Value;
+  typedef const ObjectPool* Pair;
+
+  static Key KeyOf(Pair kv) { return kv; }
+
+  static Value ValueOf(Pair kv) { return kv; }
+
+  static inline intptr_t Hashcode(Key key) {
+    // Object addresses are not stable, but their classes are.
+    uint32_t hash = key->Length();
+    for (intptr_t i = 0; i < key->Length(); i++) {
+      if (key->TypeAt(i) == ObjectPool::kTaggedObject) {
+        RawObject* object = key->ObjectAt(i);
+        hash = CombineHashes(hash, object->IsHeapObject()
+                                       ? object->GetClassIdMayBeSmi()
+                                       : Smi::Value(Smi::RawCast(object)));
+      } else {
+        hash = CombineHashes(hash, key->RawValueAt(i));
+      }
+    }
+    return FinalizeHash(hash, kBitsPerInt32 - 1);
+  }
+
+  static inline bool IsKeyEqual(Pair pair, Key key) {
+    if (pair->Length() != key->Length()) {
+      return false;
+    }
+    for (intptr_t i = 0; i < key->Length(); i++) {
+      if (pair->TypeAt(i) != key->TypeAt(i)) {
+        return false;
+      }
+      if (key->TypeAt(i) == ObjectPool::kTaggedObject) {
+        if (pair->ObjectAt(i) != key->ObjectAt(i)) {
+          return false;
+        }
+      } else if (pair->RawValueAt(i) != key->RawValueAt(i)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+typedef DirectChainedHashMap<ObjectPoolKeyValueTrait> ObjectPoolSet;
+
+void ProgramVisitor::DedupObjectPools() {
+  if (!FLAG_precompiled_mode) {
+    return;
+  }
+  class DedupObjectPoolsVisitor : public FunctionVisitor {
+   public:
+    explicit DedupObjectPoolsVisitor(Zone* zone)
+        : zone_(zone),
+          canonical_object_pools_(),
+          code_(Code::Handle(zone)),
+          object_pool_(ObjectPool::Handle(zone)),
+          entry_(Object::Handle(zone)) {}
+
+    void Visit(const Function& function) {
+      if (!function.HasCode()) {
+        return;
+      }
+      code_ = function.CurrentCode();
+      object_pool_ = code_.object_pool();
+      if (object_pool_.IsNull() || !IsImmutable(object_pool_)) {
+        return;
+      }
+      object_pool_ = DedupObjectPool(object_pool_);
+      code_.set_object_pool(object_pool_.raw());
+    }
+
+    // The precompiled runtime patches the entries of switchable calls and
+    // lazily linked native calls, and fills in null entries reserved for
+    // subtype test caches. Pools with such entries stay with their code.
+    bool IsImmutable(const ObjectPool& pool) {
+      for (intptr_t i = 0; i < pool.Length(); i++) {
+        if (pool.TypeAt(i) != ObjectPool::kTaggedObject) {
+          if (pool.TypeAt(i) != ObjectPool::kImmediate) {
+            return false;
+          }
+          continue;
+        }
+        entry_ = pool.ObjectAt(i);
+        if (entry_.IsNull() || entry_.IsUnlinkedCall() || entry_.IsICData() ||
+            entry_.IsMegamorphicCache() || entry_.IsSingleTargetCache() ||
+            entry_.IsSubtypeTestCache()) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    RawObjectPool* DedupObjectPool(const ObjectPool& object_pool) {
+      const ObjectPool* canonical_object_pool =
+          canonical_object_pools_.LookupValue(&object_pool);
+      if (canonical_object_pool == NULL) {
+        canonical_object_pools_.Insert(
+            &ObjectPool::ZoneHandle(zone_, object_pool.raw()));
+        return object_pool.raw();
+      } else {
+        return canonical_object_pool->raw();
+      }
+    }
+
+   private:
+    Zone* zone_;
+    ObjectPoolSet canonical_object_pools_;
+    Code& code_;
+    ObjectPool& object_pool_;
+    Object& entry_;
+  };
+
+  DedupObjectPoolsVisitor visitor(Thread::Current()->zone());
+  ProgramVisitor::VisitFunctions(&visitor);
+}
 #endif  // !defined(DART_PRECOMPILER)
 
 class CodeSourceMapKeyValueTrait {
@@ -710,6 +831,8 @@ void ProgramVisitor::DedupInstructions() {
     Dart::vm_isolate()->heap()->VisitObjectsImagePages(&visitor);
   }
   ProgramVisitor::VisitFunctions(&visitor);
+  // Code now points at other instructions.
+  Isolate::Current()->heap()->code_ranges()->Clear();
 }
 
 void ProgramVisitor::Dedup() {
@@ -725,6 +848,7 @@ void ProgramVisitor::Dedup() {
   NOT_IN_PRECOMPILED(DedupDeoptEntries());
 #if defined(DART_PRECOMPILER)
   DedupCatchEntryStateMaps();
+  DedupObjectPools();
 #endif
   DedupCodeSourceMaps();
   DedupLists();
@@ -36,6 +36,7 @@ class ProgramVisitor : public AllStatic {
   NOT_IN_PRECOMPILED(static void DedupDeoptEntries());
 #if defined(DART_PRECOMPILER)
   static void DedupCatchEntryStateMaps();
+  static void DedupObjectPools();
 #endif
   static void DedupCodeSourceMaps();
   static void DedupLists();
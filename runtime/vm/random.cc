@@ -68,4 +68,39 @@ uint32_t Random::NextUInt32() {
   return static_cast<uint32_t>(_state & MASK_32);
 }
 
+SecureRandomPool::SecureRandomPool() : available_(0), pid_(0) {}
+
+SecureRandomPool::~SecureRandomPool() {
+  memset(pool_, 0, sizeof(pool_));
+}
+
+bool SecureRandomPool::GetBytes(uint8_t* buffer, intptr_t length) {
+  Dart_EntropySource callback = Dart::entropy_source_callback();
+  if (callback == NULL) {
+    return false;
+  }
+  if (length > kPoolSize) {
+    return callback(buffer, length);
+  }
+  const intptr_t pid = OS::ProcessId();
+  if (pid != pid_) {
+    // A child must not hand out the same bytes as its parent.
+    available_ = 0;
+  }
+  if (available_ < length) {
+    if (!callback(pool_, kPoolSize)) {
+      available_ = 0;
+      return false;
+    }
+    available_ = kPoolSize;
+    pid_ = pid;
+  }
+  uint8_t* bytes = pool_ + (kPoolSize - available_);
+  memmove(buffer, bytes, length);
+  // Bytes handed out are not kept around.
+  memset(bytes, 0, length);
+  available_ -= length;
+  return true;
+}
+
 }  // namespace dart
@@ -35,6 +35,28 @@ class Random {
   DISALLOW_COPY_AND_ASSIGN(Random);
 };
 
+// Buffers bytes from the embedder's entropy source, so that small reads such
+// as those of Random.secure() do not each call into the operating system.
+// The buffered bytes are dropped in a forked child process.
+class SecureRandomPool {
+ public:
+  SecureRandomPool();
+  ~SecureRandomPool();
+
+  // Fills buffer with length bytes of entropy. Returns false if there is no
+  // entropy source or it fails.
+  bool GetBytes(uint8_t* buffer, intptr_t length);
+
+ private:
+  static const intptr_t kPoolSize = 256;
+
+  uint8_t pool_[kPoolSize];
+  intptr_t available_;
+  intptr_t pid_;
+
+  DISALLOW_COPY_AND_ASSIGN(SecureRandomPool);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_RANDOM_H_
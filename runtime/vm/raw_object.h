@@ -77,6 +77,7 @@ typedef RawObject* RawCompressed;
   V(TypedData)                                                                 \
   V(ExternalTypedData)                                                         \
   V(Capability)                                                                \
+  V(TransferableTypedData)                                                     \
   V(ReceivePort)                                                               \
   V(SendPort)                                                                  \
   V(StackTrace)                                                                \
@@ -292,8 +293,11 @@ class RawObject {
     kCanonicalBit = 1,
     kVMHeapObjectBit = 2,
     kRememberedBit = 3,
-    kReservedTagPos = 4,  // kReservedBit{10K,100K,1M,10M}
-    kReservedTagSize = 4,
+    kCardRememberedBit = 4,
+    kAgeTagPos = 5,
+    kAgeTagSize = 2,
+    kReservedTagPos = 7,  // kReservedBit10M
+    kReservedTagSize = 1,
     kSizeTagPos = kReservedTagPos + kReservedTagSize,  // = 8
     kSizeTagSize = 8,
     kClassIdTagPos = kSizeTagPos + kSizeTagSize,  // = 16
@@ -341,6 +345,12 @@ class RawObject {
   class ClassIdTag
       : public BitField<uint32_t, intptr_t, kClassIdTagPos, kClassIdTagSize> {};
 
+  // The number of scavenges a new object has survived, saturating at kMaxAge.
+  // Always zero for old objects.
+  class AgeTag : public BitField<uint32_t, intptr_t, kAgeTagPos, kAgeTagSize> {
+  };
+  static const intptr_t kMaxAge = (1 << kAgeTagSize) - 1;
+
   bool IsWellFormed() const {
     uword value = reinterpret_cast<uword>(this);
     return (value & kSmiTagMask) == 0 ||
@@ -428,6 +438,19 @@ class RawObject {
   DART_WARN_UNUSED_RESULT
   bool TryAcquireRememberedBit() { return TryAcquireTagBit<RememberedBit>(); }
 
+  // Support for GC card marking. Stores of new objects into a card remembered
+  // object mark the card of the slot in its page instead of adding the object
+  // to the store buffer. Only set on large arrays, see
+  // Array::UseCardMarkingForAllocation.
+  bool IsCardRemembered() const {
+    return CardRememberedBit::decode(ptr()->tags_);
+  }
+  void SetCardRememberedBitUnsynchronized() {
+    ASSERT(!IsCardRemembered());
+    uint32_t tags = ptr()->tags_;
+    ptr()->tags_ = CardRememberedBit::update(true, tags);
+  }
+
 #define DEFINE_IS_CID(clazz)                                                   \
   bool Is##clazz() const { return ((GetClassId() == k##clazz##Cid)); }
   CLASS_LIST(DEFINE_IS_CID)
@@ -489,6 +512,19 @@ class RawObject {
     return result;
   }
 
+  // Like Size(), but decodes the size from the given header tags instead of
+  // reloading them. Used by the parallel scavenger, where another task may be
+  // concurrently overwriting the header with a forwarding pointer.
+  intptr_t HeapSize(uint32_t tags) const {
+    intptr_t result = SizeTag::decode(tags);
+    if (result != 0) {
+      return result;
+    }
+    result = SizeFromClass(tags);
+    ASSERT(result > SizeTag::kMaxSizeTag);
+    return result;
+  }
+
   bool Contains(uword addr) const {
     intptr_t this_size = Size();
     uword this_addr = RawObject::ToAddr(this);
@@ -589,6 +625,9 @@ class RawObject {
 
   class RememberedBit : public BitField<uint32_t, bool, kRememberedBit, 1> {};
 
+  class CardRememberedBit
+      : public BitField<uint32_t, bool, kCardRememberedBit, 1> {};
+
   class CanonicalObjectTag : public BitField<uint32_t, bool, kCanonicalBit, 1> {
   };
 
@@ -609,7 +648,8 @@ class RawObject {
   intptr_t VisitPointersPredefined(ObjectPointerVisitor* visitor,
                                    intptr_t class_id);
 
-  intptr_t SizeFromClass() const;
+  intptr_t SizeFromClass() const { return SizeFromClass(ptr()->tags_); }
+  intptr_t SizeFromClass(uint32_t tags) const;
 
   intptr_t GetClassId() const {
     uint32_t tags = ptr()->tags_;
@@ -648,12 +688,34 @@ class RawObject {
     *const_cast<type*>(addr) = value;
     // Filter stores based on source and target.
     if (!value->IsHeapObject()) return;
-    if (value->IsNewObject() && this->IsOldObject() && !this->IsRemembered()) {
+    if (!this->IsOldObject() || this->IsRemembered()) return;
+    // While the old generation is marked concurrently, the store buffer also
+    // records old objects written to, so that they are visited again before
+    // marking completes.
+    Thread* thread = Thread::Current();
+    if (value->IsNewObject() || thread->is_marking()) {
       this->SetRememberedBit();
-      Thread::Current()->StoreBufferAddObject(this);
+      thread->StoreBufferAddObject(this);
     }
   }
 
+  // Use for storing into the elements of an array, which may be card
+  // remembered. While the old generation is marked concurrently, card
+  // remembered arrays are recorded as a whole like other objects; the next
+  // scavenge marks the cards of the slots that still hold new objects.
+  template <typename type>
+  void StoreArrayPointer(type const* addr, type value) {
+    if (this->IsCardRemembered() && value->IsHeapObject() &&
+        value->IsNewObject() && !Thread::Current()->is_marking()) {
+      *const_cast<type*>(addr) = value;
+      RememberCard(reinterpret_cast<RawObject* const*>(addr));
+      return;
+    }
+    StorePointer(addr, value);
+  }
+
+  void RememberCard(RawObject* const* slot);
+
   // Use for storing into an explicitly Smi-typed field of an object
   // (i.e., both the previous and new value are Smis).
   void StoreSmi(RawSmi* const* addr, RawSmi* value) {
@@ -688,6 +750,7 @@ class RawObject {
   friend class Mint;
   friend class Object;
   friend class OneByteString;  // StoreSmi
+  friend class ParallelScavengerVisitor;
   friend class RawCode;
   friend class RawExternalTypedData;
   friend class RawInstructions;
@@ -969,6 +1032,7 @@ class RawFunction : public RawObject {
   F(intptr_t, uint16_t, optimized_instruction_count)                           \
   F(intptr_t, uint16_t, optimized_call_site_count)                             \
   F(int8_t, int8_t, deoptimization_counter)                                    \
+  F(int8_t, int8_t, adapted_deoptimization_counter)                            \
   F(intptr_t, int8_t, state_bits)                                              \
   F(int, int8_t, inlining_depth)
 
@@ -1554,6 +1618,7 @@ class RawExceptionHandlers : public RawObject {
   }
 
   friend class Object;
+  friend class ImageWriter;  // Drops handled_types_data_.
 };
 
 class RawContext : public RawObject {
@@ -1643,7 +1708,8 @@ class RawICData : public RawObject {
   RawString* target_name_;     // Name of target function.
   RawArray* args_descriptor_;  // Arguments descriptor.
   RawObject* owner_;  // Parent/calling function or original IC of cloned IC.
-  VISIT_TO(RawObject*, owner_);
+  RawFunction* closure_target_;  // First closure function invoked via 'call'.
+  VISIT_TO(RawObject*, closure_target_);
   RawObject** to_snapshot(Snapshot::Kind kind) {
     switch (kind) {
       case Snapshot::kFullAOT:
@@ -1678,16 +1744,22 @@ class RawMegamorphicCache : public RawObject {
   RawSmi* mask_;
   RawString* target_name_;     // Name of target function.
   RawArray* args_descriptor_;  // Arguments descriptor.
-  VISIT_TO(RawObject*, args_descriptor_)
+  RawArray* dispatch_table_;   // Global dispatch table or null.
+  RawSmi* dispatch_row_;       // Row of this selector in dispatch_table_.
+  VISIT_TO(RawObject*, dispatch_row_)
 
   int32_t filled_entry_count_;
+  int32_t miss_count_;  // Not written to snapshots.
 };
 
 class RawSubtypeTestCache : public RawObject {
   RAW_HEAP_OBJECT_IMPLEMENTATION(SubtypeTestCache);
   VISIT_FROM(RawObject*, cache_);
   RawArray* cache_;
-  VISIT_TO(RawObject*, cache_);
+  RawSmi* mask_;
+  VISIT_TO(RawObject*, mask_);
+
+  int32_t filled_entry_count_;
 };
 
 class RawError : public RawObject {
@@ -1795,6 +1867,7 @@ class RawTypeArguments : public RawInstance {
 
   friend class Object;
   friend class SnapshotReader;
+  friend class SubtypeTestCache;
 };
 
 class RawAbstractType : public RawInstance {
@@ -2072,6 +2145,7 @@ class RawArray : public RawInstance {
   friend class Object;
   friend class ICData;            // For high performance access.
   friend class SubtypeTestCache;  // For high performance access.
+  friend class HeapPage;          // VisitRememberedCards
 };
 
 class RawImmutableArray : public RawArray {
@@ -2206,6 +2280,14 @@ class RawCapability : public RawInstance {
   uint64_t id_;
 };
 
+// The contents of a TransferableTypedData live in a malloc'ed buffer owned by
+// a peer that is finalized together with the object.
+class RawTransferableTypedData : public RawInstance {
+  RAW_HEAP_OBJECT_IMPLEMENTATION(TransferableTypedData);
+  VISIT_NOTHING();
+  void* peer_;
+};
+
 class RawSendPort : public RawInstance {
   RAW_HEAP_OBJECT_IMPLEMENTATION(SendPort);
   VISIT_NOTHING();
@@ -2239,6 +2321,9 @@ class RawStackTrace : public RawInstance {
 
   // False for pre-allocated stack trace (used in OOM and Stack overflow).
   bool expand_inlined_;
+  // True for a trace that stops at the frame of the handler it was thrown to.
+  // Rethrowing it appends the frames above that handler.
+  bool is_partial_;
 };
 
 // VM type for capturing JS regular expressions.
@@ -2293,6 +2378,7 @@ class RawWeakProperty : public RawInstance {
   friend class GCMarker;
   template <bool>
   friend class MarkingVisitorBase;
+  friend class ParallelScavengerVisitor;
   friend class Scavenger;
   friend class ScavengerVisitor;
 };
@@ -2017,8 +2017,12 @@ void String::ReadFromImpl(SnapshotReader* reader,
     // Set up canonical string object.
     ASSERT(reader != NULL);
     CharacterType* ptr = reader->zone()->Alloc<CharacterType>(len);
-    for (intptr_t i = 0; i < len; i++) {
-      ptr[i] = reader->Read<CharacterType>();
+    if (sizeof(CharacterType) == 1) {
+      reader->ReadBytes(reinterpret_cast<uint8_t*>(ptr), len);
+    } else {
+      for (intptr_t i = 0; i < len; i++) {
+        ptr[i] = reader->Read<CharacterType>();
+      }
     }
     *str_obj ^= (*new_symbol)(reader->thread(), ptr, len);
   } else {
@@ -2030,9 +2034,14 @@ void String::ReadFromImpl(SnapshotReader* reader,
     }
     NoSafepointScope no_safepoint;
     CharacterType* str_addr = StringType::DataStart(*str_obj);
-    for (intptr_t i = 0; i < len; i++) {
-      *str_addr = reader->Read<CharacterType>();
-      str_addr++;
+    if (sizeof(CharacterType) == 1) {
+      // One-byte strings are written with WriteBytes, read them in bulk.
+      reader->ReadBytes(reinterpret_cast<uint8_t*>(str_addr), len);
+    } else {
+      for (intptr_t i = 0; i < len; i++) {
+        *str_addr = reader->Read<CharacterType>();
+        str_addr++;
+      }
     }
   }
 }
@@ -2069,6 +2078,74 @@ RawTwoByteString* TwoByteString::ReadFrom(SnapshotReader* reader,
   return raw(str_obj);
 }
 
+// Strings being immutable, large one byte strings are sent in messages as
+// external strings over a reference counted buffer: the sender copies the
+// characters once, and a string received this way is sent on by sharing
+// its buffer rather than copying it again.
+class SharedStringData {
+ public:
+  static const intptr_t kMinLength = 4 * KB;
+
+  static SharedStringData* New(const uint8_t* characters, intptr_t len) {
+    SharedStringData* shared = reinterpret_cast<SharedStringData*>(
+        malloc(sizeof(SharedStringData) + len));
+    if (shared == NULL) {
+      OUT_OF_MEMORY();
+    }
+    shared->magic_ = kMagic;
+    shared->ref_count_ = 1;
+    memmove(shared->data(), characters, len);
+    return shared;
+  }
+
+  // Returns the buffer an external string with 'peer' and 'characters' was
+  // received over, or NULL if it was created otherwise.
+  static SharedStringData* Of(void* peer, const uint8_t* characters) {
+    SharedStringData* shared = reinterpret_cast<SharedStringData*>(peer);
+    if ((shared == NULL) || (shared->data() != characters) ||
+        (shared->magic_ != kMagic)) {
+      return NULL;
+    }
+    return shared;
+  }
+
+  uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+
+  void Retain() { AtomicOperations::FetchAndIncrement(&ref_count_); }
+
+  // This function's name can appear in Observatory.
+  static void Release(void* isolate_callback_data,
+                      Dart_WeakPersistentHandle handle,
+                      void* peer) {
+    SharedStringData* shared = reinterpret_cast<SharedStringData*>(peer);
+    if (AtomicOperations::FetchAndDecrement(&shared->ref_count_) == 1) {
+      shared->magic_ = 0;
+      free(shared);
+    }
+  }
+
+  // Writes the string with 'tags' and 'length' as an external one byte
+  // string over 'shared', taking over a reference to it.
+  static void WriteTo(SnapshotWriter* writer,
+                      intptr_t object_id,
+                      intptr_t tags,
+                      RawSmi* length,
+                      SharedStringData* shared) {
+    writer->WriteInlinedObjectHeader(object_id);
+    writer->WriteIndexedObject(kExternalOneByteStringCid);
+    writer->WriteTags(tags);
+    writer->Write<RawObject*>(length);
+    static_cast<MessageWriter*>(writer)->finalizable_data()->Put(
+        Smi::Value(length), shared->data(), shared, Release);
+  }
+
+ private:
+  static const uword kMagic = 0x5348535452;
+
+  uword magic_;
+  uintptr_t ref_count_;
+};
+
 template <typename T>
 static void StringWriteTo(SnapshotWriter* writer,
                           intptr_t object_id,
@@ -2106,6 +2183,14 @@ void RawOneByteString::WriteTo(SnapshotWriter* writer,
                                intptr_t object_id,
                                Snapshot::Kind kind,
                                bool as_reference) {
+  const intptr_t tags = writer->GetObjectTags(this);
+  if ((kind == Snapshot::kMessage) && !RawObject::IsCanonical(tags) &&
+      (Smi::Value(ptr()->length_) >= SharedStringData::kMinLength)) {
+    SharedStringData::WriteTo(
+        writer, object_id, tags, ptr()->length_,
+        SharedStringData::New(ptr()->data(), Smi::Value(ptr()->length_)));
+    return;
+  }
   StringWriteTo(writer, object_id, kind, kOneByteStringCid,
                 writer->GetObjectTags(this), ptr()->length_, ptr()->data());
 }
@@ -2124,8 +2209,19 @@ RawExternalOneByteString* ExternalOneByteString::ReadFrom(
     intptr_t tags,
     Snapshot::Kind kind,
     bool as_reference) {
-  UNREACHABLE();
-  return ExternalOneByteString::null();
+  // Only messages contain external strings, see SharedStringData.
+  ASSERT(kind == Snapshot::kMessage);
+  intptr_t len = reader->ReadSmiValue();
+  FinalizableData finalizable_data =
+      static_cast<MessageSnapshotReader*>(reader)->finalizable_data()->Take();
+  String& str_obj = String::ZoneHandle(
+      reader->zone(),
+      ExternalOneByteString::New(
+          reinterpret_cast<const uint8_t*>(finalizable_data.data), len,
+          finalizable_data.peer, len, finalizable_data.callback,
+          HEAP_SPACE(kind)));
+  reader->AddBackRef(object_id, &str_obj, kIsDeserialized);
+  return raw(str_obj);
 }
 
 RawExternalTwoByteString* ExternalTwoByteString::ReadFrom(
@@ -2142,6 +2238,16 @@ void RawExternalOneByteString::WriteTo(SnapshotWriter* writer,
                                        intptr_t object_id,
                                        Snapshot::Kind kind,
                                        bool as_reference) {
+  if (kind == Snapshot::kMessage) {
+    SharedStringData* shared =
+        SharedStringData::Of(ptr()->peer_, ptr()->external_data_);
+    if (shared != NULL) {
+      shared->Retain();
+      SharedStringData::WriteTo(writer, object_id, writer->GetObjectTags(this),
+                                ptr()->length_, shared);
+      return;
+    }
+  }
   // Serialize as a non-external one byte string.
   StringWriteTo(writer, object_id, kind, kOneByteStringCid,
                 writer->GetObjectTags(this), ptr()->length_,
@@ -2832,6 +2938,52 @@ void RawCapability::WriteTo(SnapshotWriter* writer,
   writer->Write<uint64_t>(ptr()->id_);
 }
 
+RawTransferableTypedData* TransferableTypedData::ReadFrom(
+    SnapshotReader* reader,
+    intptr_t object_id,
+    intptr_t tags,
+    Snapshot::Kind kind,
+    bool as_reference) {
+  ASSERT(kind == Snapshot::kMessage);
+  intptr_t length = reader->Read<int64_t>();
+
+  // The sender handed the contents over instead of copying them.
+  FinalizableData finalizable_data =
+      static_cast<MessageSnapshotReader*>(reader)->finalizable_data()->Take();
+  uint8_t* data = reinterpret_cast<uint8_t*>(finalizable_data.data);
+  TransferableTypedData& result = TransferableTypedData::ZoneHandle(
+      reader->zone(), TransferableTypedData::New(data, length));
+  reader->AddBackRef(object_id, &result, kIsDeserialized);
+  return result.raw();
+}
+
+void RawTransferableTypedData::WriteTo(SnapshotWriter* writer,
+                                       intptr_t object_id,
+                                       Snapshot::Kind kind,
+                                       bool as_reference) {
+  ASSERT(writer != NULL);
+  ASSERT(kind == Snapshot::kMessage);
+
+  // Write out the serialization header value for this object.
+  writer->WriteInlinedObjectHeader(object_id);
+
+  // Write out the class and tags information.
+  writer->WriteIndexedObject(kTransferableTypedDataCid);
+  writer->WriteTags(writer->GetObjectTags(this));
+
+  // Move the contents into the message, leaving the sender detached.
+  const TransferableTypedData& transferable =
+      TransferableTypedData::Handle(writer->zone(), this);
+  intptr_t length = 0;
+  uint8_t* data = transferable.Detach(&length);
+  writer->Write<int64_t>(length);
+  static_cast<MessageWriter*>(writer)->finalizable_data()->Put(
+      length,
+      data,  // data
+      data,  // peer,
+      IsolateMessageTypedDataFinalizer);
+}
+
 RawReceivePort* ReceivePort::ReadFrom(SnapshotReader* reader,
                                       intptr_t object_id,
                                       intptr_t tags,
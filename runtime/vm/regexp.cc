@@ -2702,6 +2702,13 @@ void BoyerMoorePositionInfo::Set(intptr_t character) {
 }
 
 void BoyerMoorePositionInfo::SetInterval(const Interval& interval) {
+  if (single_character_ == kNoCharacter &&
+      interval.from() == interval.to()) {
+    single_character_ = interval.from();
+  } else if (interval.from() != single_character_ ||
+             interval.to() != single_character_) {
+    single_character_ = kManyCharacters;
+  }
   s_ = AddRange(s_, kSpaceRanges, kSpaceRangeCount, interval);
   w_ = AddRange(w_, kWordRanges, kWordRangeCount, interval);
   d_ = AddRange(d_, kDigitRanges, kDigitRangeCount, interval);
@@ -2727,6 +2734,7 @@ void BoyerMoorePositionInfo::SetInterval(const Interval& interval) {
 
 void BoyerMoorePositionInfo::SetAll() {
   s_ = w_ = d_ = kLatticeUnknown;
+  single_character_ = kManyCharacters;
   if (map_count_ != kMapSize) {
     map_count_ = kMapSize;
     for (intptr_t i = 0; i < kMapSize; i++)
@@ -2856,6 +2864,30 @@ intptr_t BoyerMooreLookahead::GetSkipTable(
   return skip;
 }
 
+// If some position in the lookahead can only hold one particular character,
+// every match must have that character at that offset, so we can scan for it
+// directly instead of stepping through the subject.  Among such positions we
+// pick the character that is least frequent in the sample subject.  Only
+// assemblers that can scan faster than a compare-and-advance loop (e.g. using
+// memchr) accept this.
+bool BoyerMooreLookahead::EmitCharacterScan(RegExpMacroAssembler* masm) {
+  intptr_t best_offset = -1;
+  intptr_t best_frequency = 0;
+  for (intptr_t i = 0; i < length_; i++) {
+    BoyerMoorePositionInfo* map = bitmaps_->At(i);
+    if (!map->has_single_character()) continue;
+    intptr_t frequency = compiler_->frequency_collator()->Frequency(
+        map->single_character() & RegExpMacroAssembler::kTableMask);
+    if (best_offset < 0 || frequency < best_frequency) {
+      best_offset = i;
+      best_frequency = frequency;
+    }
+  }
+  if (best_offset < 0) return false;
+  return masm->SkipUntilCharacter(
+      best_offset, bitmaps_->At(best_offset)->single_character());
+}
+
 // See comment above on the implementation of GetSkipTable.
 void BoyerMooreLookahead::EmitSkipInstructions(RegExpMacroAssembler* masm) {
   const intptr_t kSize = RegExpMacroAssembler::kTableSize;
@@ -2863,6 +2895,8 @@ void BoyerMooreLookahead::EmitSkipInstructions(RegExpMacroAssembler* masm) {
   intptr_t min_lookahead = 0;
   intptr_t max_lookahead = 0;
 
+  if (EmitCharacterScan(masm)) return;
+
   if (!FindWorthwhileInterval(&min_lookahead, &max_lookahead)) return;
 
   bool found_single_character = false;
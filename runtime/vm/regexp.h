@@ -961,6 +961,7 @@ class BoyerMoorePositionInfo : public ZoneAllocated {
   explicit BoyerMoorePositionInfo(Zone* zone)
       : map_(new (zone) ZoneGrowableArray<bool>(kMapSize)),
         map_count_(0),
+        single_character_(kNoCharacter),
         w_(kNotYet),
         s_(kNotYet),
         d_(kNotYet),
@@ -977,6 +978,11 @@ class BoyerMoorePositionInfo : public ZoneAllocated {
 
   intptr_t map_count() const { return map_count_; }
 
+  // Unlike the map, which folds characters modulo kMapSize, this tracks the
+  // exact character when it is the only one that can occur at this position.
+  bool has_single_character() const { return single_character_ >= 0; }
+  intptr_t single_character() const { return single_character_; }
+
   void Set(intptr_t character);
   void SetInterval(const Interval& interval);
   void SetAll();
@@ -986,10 +992,14 @@ class BoyerMoorePositionInfo : public ZoneAllocated {
  private:
   ZoneGrowableArray<bool>* map_;
   intptr_t map_count_;            // Number of set bits in the map.
+  intptr_t single_character_;     // Or kNoCharacter/kManyCharacters.
   ContainedInLattice w_;          // The \w character class.
   ContainedInLattice s_;          // The \s character class.
   ContainedInLattice d_;          // The \d character class.
   ContainedInLattice surrogate_;  // Surrogate UTF-16 code units.
+
+  static const intptr_t kNoCharacter = -1;
+  static const intptr_t kManyCharacters = -2;
 };
 
 class BoyerMooreLookahead : public ZoneAllocated {
@@ -1041,6 +1051,7 @@ class BoyerMooreLookahead : public ZoneAllocated {
   intptr_t max_char_;
   ZoneGrowableArray<BoyerMoorePositionInfo*>* bitmaps_;
 
+  bool EmitCharacterScan(RegExpMacroAssembler* masm);
   intptr_t GetSkipTable(intptr_t min_lookahead,
                         intptr_t max_lookahead,
                         const TypedData& boolean_skip_table);
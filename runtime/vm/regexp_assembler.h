@@ -167,6 +167,14 @@ class RegExpMacroAssembler : public ZoneAllocated {
                                           BlockLabel* on_no_match) {
     return false;
   }
+  // Advances the current position until the character at the given offset
+  // from it is c, or until that offset is at or past the end of the string.
+  // Returns false, emitting nothing, if the assembler has no faster way to do
+  // this than a load-check-advance loop.
+  // May clobber the current loaded character.
+  virtual bool SkipUntilCharacter(intptr_t cp_offset, uint16_t c) {
+    return false;
+  }
   virtual void Fail() = 0;
   // Check whether a register is >= a given constant and go to a label if it
   // is.  Backtracks instead if the label is NULL.
@@ -5,6 +5,7 @@
 #include "vm/regexp_assembler_bytecode.h"
 
 #include "vm/exceptions.h"
+#include "vm/lockers.h"
 #include "vm/object_store.h"
 #include "vm/regexp.h"
 #include "vm/regexp_assembler.h"
@@ -16,6 +17,12 @@
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            regexp_bytecode_cache_size,
+            1024,
+            "Maximum number of compiled regexps shared between isolates "
+            "through the process-wide bytecode cache, 0 to disable.");
+
 BytecodeRegExpMacroAssembler::BytecodeRegExpMacroAssembler(
     ZoneGrowableArray<uint8_t>* buffer,
     Zone* zone)
@@ -321,6 +328,16 @@ void BytecodeRegExpMacroAssembler::CheckCharacterNotInRange(
   EmitOrLink(on_not_in_range);
 }
 
+bool BytecodeRegExpMacroAssembler::SkipUntilCharacter(intptr_t cp_offset,
+                                                      uint16_t c) {
+  ASSERT(cp_offset >= 0);
+  ASSERT(cp_offset <= kMaxCPOffset);
+  Emit(BC_SKIP_UNTIL_CHAR, cp_offset);
+  Emit16(c);
+  Emit16(0);
+  return true;
+}
+
 void BytecodeRegExpMacroAssembler::CheckBitInTable(const TypedData& table,
                                                    BlockLabel* on_bit_set) {
   Emit(BC_CHECK_BIT_IN_TABLE, 0);
@@ -410,6 +427,157 @@ void BytecodeRegExpMacroAssembler::Expand() {
     buffer_->Add(0);
 }
 
+struct RegExpBytecodeCache::Entry {
+  Entry* next;
+  uword hash;
+  intptr_t key_flags;
+  uint16_t* pattern;
+  intptr_t pattern_length;
+  uint8_t* bytecode;
+  intptr_t bytecode_length;
+  intptr_t num_registers;
+  intptr_t num_bracket_expressions;
+  bool is_simple;
+};
+
+Mutex* RegExpBytecodeCache::mutex_ = NULL;
+RegExpBytecodeCache::Entry*
+    RegExpBytecodeCache::buckets_[RegExpBytecodeCache::kNumBuckets];
+intptr_t RegExpBytecodeCache::length_ = 0;
+
+void RegExpBytecodeCache::InitOnce() {
+  ASSERT(mutex_ == NULL);
+  mutex_ = new Mutex();
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    buckets_[i] = NULL;
+  }
+  length_ = 0;
+}
+
+void RegExpBytecodeCache::Cleanup() {
+  ASSERT(mutex_ != NULL);
+  for (intptr_t i = 0; i < kNumBuckets; i++) {
+    Entry* entry = buckets_[i];
+    while (entry != NULL) {
+      Entry* next = entry->next;
+      free(entry->pattern);
+      free(entry->bytecode);
+      delete entry;
+      entry = next;
+    }
+    buckets_[i] = NULL;
+  }
+  length_ = 0;
+  delete mutex_;
+  mutex_ = NULL;
+}
+
+intptr_t RegExpBytecodeCache::KeyFlags(const RegExp& regexp,
+                                       bool is_one_byte,
+                                       bool sticky) {
+  return (regexp.is_global() ? 1 : 0) | (regexp.is_ignore_case() ? 2 : 0) |
+         (regexp.is_multi_line() ? 4 : 0) | (is_one_byte ? 8 : 0) |
+         (sticky ? 16 : 0);
+}
+
+RegExpBytecodeCache::Entry* RegExpBytecodeCache::FindLocked(
+    const String& pattern,
+    uword hash,
+    intptr_t key_flags) {
+  ASSERT(mutex_->IsOwnedByCurrentThread());
+  for (Entry* entry = buckets_[hash % kNumBuckets]; entry != NULL;
+       entry = entry->next) {
+    if ((entry->hash == hash) && (entry->key_flags == key_flags) &&
+        pattern.Equals(entry->pattern, entry->pattern_length)) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+bool RegExpBytecodeCache::Lookup(const RegExp& regexp,
+                                 bool is_one_byte,
+                                 bool sticky) {
+  if (FLAG_regexp_bytecode_cache_size <= 0) {
+    return false;
+  }
+  const String& pattern = String::Handle(regexp.pattern());
+  Entry* entry = NULL;
+  {
+    MutexLocker ml(mutex_);
+    entry = FindLocked(pattern, pattern.Hash(),
+                       KeyFlags(regexp, is_one_byte, sticky));
+  }
+  if (entry == NULL) {
+    return false;
+  }
+  // Entries are immutable and only freed at VM shutdown, so they can be read
+  // without holding the lock.
+  const TypedData& bytecode = TypedData::Handle(TypedData::New(
+      kTypedDataUint8ArrayCid, entry->bytecode_length, Heap::kOld));
+  {
+    NoSafepointScope no_safepoint;
+    memmove(bytecode.DataAddr(0), entry->bytecode, entry->bytecode_length);
+  }
+  regexp.set_num_bracket_expressions(entry->num_bracket_expressions);
+  if (entry->is_simple) {
+    regexp.set_is_simple();
+  } else {
+    regexp.set_is_complex();
+  }
+  ASSERT((regexp.num_registers() == -1) ||
+         (regexp.num_registers() == entry->num_registers));
+  regexp.set_num_registers(entry->num_registers);
+  regexp.set_bytecode(is_one_byte, sticky, bytecode);
+  return true;
+}
+
+void RegExpBytecodeCache::Insert(const RegExp& regexp,
+                                 bool is_one_byte,
+                                 bool sticky) {
+  if (FLAG_regexp_bytecode_cache_size <= 0) {
+    return;
+  }
+  const String& pattern = String::Handle(regexp.pattern());
+  const TypedData& bytecode =
+      TypedData::Handle(regexp.bytecode(is_one_byte, sticky));
+  ASSERT(!bytecode.IsNull());
+  const uword hash = pattern.Hash();
+  const intptr_t key_flags = KeyFlags(regexp, is_one_byte, sticky);
+
+  MutexLocker ml(mutex_);
+  if (length_ >= FLAG_regexp_bytecode_cache_size) {
+    return;
+  }
+  if (FindLocked(pattern, hash, key_flags) != NULL) {
+    // Another isolate compiled the same pattern concurrently.
+    return;
+  }
+  Entry* entry = new Entry();
+  entry->hash = hash;
+  entry->key_flags = key_flags;
+  entry->pattern_length = pattern.Length();
+  entry->pattern = reinterpret_cast<uint16_t*>(
+      malloc(entry->pattern_length * sizeof(uint16_t)));
+  for (intptr_t i = 0; i < entry->pattern_length; i++) {
+    entry->pattern[i] = pattern.CharAt(i);
+  }
+  entry->bytecode_length = bytecode.LengthInBytes();
+  entry->bytecode = reinterpret_cast<uint8_t*>(malloc(entry->bytecode_length));
+  {
+    NoSafepointScope no_safepoint;
+    memmove(entry->bytecode, bytecode.DataAddr(0), entry->bytecode_length);
+  }
+  entry->num_registers = regexp.num_registers();
+  entry->num_bracket_expressions =
+      Smi::Value(regexp.num_bracket_expressions());
+  entry->is_simple = regexp.is_simple();
+  Entry** bucket = &buckets_[hash % kNumBuckets];
+  entry->next = *bucket;
+  *bucket = entry;
+  length_++;
+}
+
 static intptr_t Prepare(const RegExp& regexp,
                         const String& subject,
                         bool sticky,
@@ -417,7 +585,8 @@ static intptr_t Prepare(const RegExp& regexp,
   bool is_one_byte =
       subject.IsOneByteString() || subject.IsExternalOneByteString();
 
-  if (regexp.bytecode(is_one_byte, sticky) == TypedData::null()) {
+  if ((regexp.bytecode(is_one_byte, sticky) == TypedData::null()) &&
+      !RegExpBytecodeCache::Lookup(regexp, is_one_byte, sticky)) {
     const String& pattern = String::Handle(zone, regexp.pattern());
 #if !defined(PRODUCT)
     TimelineDurationScope tds(Thread::Current(), Timeline::GetCompilerStream(),
@@ -449,6 +618,7 @@ static intptr_t Prepare(const RegExp& regexp,
            (regexp.num_registers() == result.num_registers));
     regexp.set_num_registers(result.num_registers);
     regexp.set_bytecode(is_one_byte, sticky, *(result.bytecode));
+    RegExpBytecodeCache::Insert(regexp, is_one_byte, sticky);
   }
 
   ASSERT(regexp.num_registers() != -1);
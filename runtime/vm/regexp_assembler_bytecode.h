@@ -78,6 +78,7 @@ class BytecodeRegExpMacroAssembler : public RegExpMacroAssembler {
                                         uint16_t to,
                                         BlockLabel* on_not_in_range);
   virtual void CheckBitInTable(const TypedData& table, BlockLabel* on_bit_set);
+  virtual bool SkipUntilCharacter(intptr_t cp_offset, uint16_t c);
   virtual void CheckNotBackReference(intptr_t start_reg,
                                      BlockLabel* on_no_match);
   virtual void CheckNotBackReferenceIgnoreCase(intptr_t start_reg,
@@ -138,6 +139,36 @@ class BytecodeRegExpMacroAssembler : public RegExpMacroAssembler {
   DISALLOW_IMPLICIT_CONSTRUCTORS(BytecodeRegExpMacroAssembler);
 };
 
+// A process-wide cache of compiled irregexp bytecode. Bytecode does not refer
+// to any heap objects, so all isolates using the same pattern can share one
+// compilation of it instead of each compiling it again.
+class RegExpBytecodeCache : public AllStatic {
+ public:
+  static void InitOnce();
+  static void Cleanup();
+
+  // Initializes regexp from a cached compilation for the given kind of
+  // subject. Returns false if there is none.
+  static bool Lookup(const RegExp& regexp, bool is_one_byte, bool sticky);
+
+  // Records the compilation of regexp for the given kind of subject.
+  static void Insert(const RegExp& regexp, bool is_one_byte, bool sticky);
+
+ private:
+  struct Entry;
+
+  static intptr_t KeyFlags(const RegExp& regexp, bool is_one_byte, bool sticky);
+  static Entry* FindLocked(const String& pattern,
+                           uword hash,
+                           intptr_t key_flags);
+
+  static const intptr_t kNumBuckets = 256;
+
+  static Mutex* mutex_;
+  static Entry* buckets_[kNumBuckets];
+  static intptr_t length_;
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_REGEXP_ASSEMBLER_BYTECODE_H_
@@ -63,7 +63,8 @@ V(CHECK_AT_START,    43, 8)   /* bc8 pad24 addr32                           */ \
 V(CHECK_NOT_AT_START, 44, 8)  /* bc8 pad24 addr32                           */ \
 V(CHECK_GREEDY,      45, 8)   /* bc8 pad24 addr32                           */ \
 V(ADVANCE_CP_AND_GOTO, 46, 8) /* bc8 offset24 addr32                        */ \
-V(SET_CURRENT_POSITION_FROM_END, 47, 4) /* bc8 idx24                        */
+V(SET_CURRENT_POSITION_FROM_END, 47, 4) /* bc8 idx24                        */ \
+V(SKIP_UNTIL_CHAR,   48, 8)   /* bc8 offset24 uc16 pad16                    */
 
 // clang-format on
 
@@ -6,6 +6,7 @@
 
 #include "vm/regexp_interpreter.h"
 
+#include "vm/isolate.h"
 #include "vm/object.h"
 #include "vm/regexp_assembler.h"
 #include "vm/regexp_bytecodes.h"
@@ -122,27 +123,75 @@ static int32_t Load16Aligned(const uint8_t* pc) {
 }
 
 // A simple abstraction over the backtracking stack used by the interpreter.
-// This backtracking stack does not grow automatically, but it ensures that the
-// the memory held by the stack is released or remembered in a cache if the
-// matching terminates.
+// The stack grows on demand, and its memory is remembered in the isolate when
+// the matching terminates, so that matches don't allocate one each.
 class BacktrackStack {
  public:
-  explicit BacktrackStack(Zone* zone) {
-    data_ = zone->Alloc<intptr_t>(kBacktrackStackSize);
+  BacktrackStack() : isolate_(Isolate::Current()) {
+    data_ = isolate_->TakeRegExpBacktrackStack(&capacity_);
+    if (data_ == NULL) {
+      capacity_ = kInitialSize;
+      data_ = reinterpret_cast<intptr_t*>(malloc(capacity_ * kWordSize));
+      if (data_ == NULL) {
+        OUT_OF_MEMORY();
+      }
+    }
+  }
+
+  ~BacktrackStack() {
+    if (capacity_ > kMaxCachedSize) {
+      free(data_);
+    } else {
+      isolate_->ReturnRegExpBacktrackStack(data_, capacity_);
+    }
   }
 
   intptr_t* data() const { return data_; }
 
-  intptr_t max_size() const { return kBacktrackStackSize; }
+  intptr_t capacity() const { return capacity_; }
+
+  // Doubles the capacity, keeping the entries below 'sp' and updating it.
+  // Returns false if the stack may not grow any further.
+  bool Grow(intptr_t** sp) {
+    if (capacity_ >= kMaxSize) {
+      return false;
+    }
+    const intptr_t used = *sp - data_;
+    intptr_t* data =
+        reinterpret_cast<intptr_t*>(realloc(data_, 2 * capacity_ * kWordSize));
+    if (data == NULL) {
+      return false;
+    }
+    data_ = data;
+    capacity_ *= 2;
+    *sp = data_ + used;
+    return true;
+  }
 
  private:
-  static const intptr_t kBacktrackStackSize = 10000;
+  static const intptr_t kInitialSize = 1 * KB;
+  static const intptr_t kMaxCachedSize = 64 * KB;
+  static const intptr_t kMaxSize = 8 * MB;
 
+  Isolate* isolate_;
   intptr_t* data_;
+  intptr_t capacity_;
 
   DISALLOW_COPY_AND_ASSIGN(BacktrackStack);
 };
 
+// Makes room for one more entry on the backtracking stack, failing the match
+// with a stack overflow once the stack may not grow any further.
+#define BACKTRACK_STACK_RESERVE()                                              \
+  if (--backtrack_stack_space < 0) {                                           \
+    if (!backtrack_stack.Grow(&backtrack_sp)) {                                \
+      return IrregexpInterpreter::RE_EXCEPTION;                                \
+    }                                                                          \
+    backtrack_stack_base = backtrack_stack.data();                             \
+    backtrack_stack_space = backtrack_stack.capacity() -                       \
+                            (backtrack_sp - backtrack_stack_base) - 1;         \
+  }
+
 template <typename Char>
 static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
                                                     const String& subject,
@@ -154,10 +203,10 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
   // BacktrackStack ensures that the memory allocated for the backtracking stack
   // is returned to the system or cached if there is no stack being cached at
   // the moment.
-  BacktrackStack backtrack_stack(zone);
+  BacktrackStack backtrack_stack;
   intptr_t* backtrack_stack_base = backtrack_stack.data();
   intptr_t* backtrack_sp = backtrack_stack_base;
-  intptr_t backtrack_stack_space = backtrack_stack.max_size();
+  intptr_t backtrack_stack_space = backtrack_stack.capacity();
 
   // TODO(zerny): Optimize as single instance. V8 has this as an
   // isolate member.
@@ -177,23 +226,17 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
       UNREACHABLE();
       return IrregexpInterpreter::RE_FAILURE;
       BYTECODE(PUSH_CP)
-      if (--backtrack_stack_space < 0) {
-        return IrregexpInterpreter::RE_EXCEPTION;
-      }
+      BACKTRACK_STACK_RESERVE();
       *backtrack_sp++ = current;
       pc += BC_PUSH_CP_LENGTH;
       break;
       BYTECODE(PUSH_BT)
-      if (--backtrack_stack_space < 0) {
-        return IrregexpInterpreter::RE_EXCEPTION;
-      }
+      BACKTRACK_STACK_RESERVE();
       *backtrack_sp++ = Load32Aligned(pc + 4);
       pc += BC_PUSH_BT_LENGTH;
       break;
       BYTECODE(PUSH_REGISTER)
-      if (--backtrack_stack_space < 0) {
-        return IrregexpInterpreter::RE_EXCEPTION;
-      }
+      BACKTRACK_STACK_RESERVE();
       *backtrack_sp++ = registers[insn >> BYTECODE_SHIFT];
       pc += BC_PUSH_REGISTER_LENGTH;
       break;
@@ -221,7 +264,7 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
       BYTECODE(SET_SP_TO_REGISTER)
       backtrack_sp = backtrack_stack_base + registers[insn >> BYTECODE_SHIFT];
       backtrack_stack_space =
-          backtrack_stack.max_size() -
+          backtrack_stack.capacity() -
           static_cast<int>(backtrack_sp - backtrack_stack_base);
       pc += BC_SET_SP_TO_REGISTER_LENGTH;
       break;
@@ -557,6 +600,20 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
         pc += BC_SET_CURRENT_POSITION_FROM_END_LENGTH;
         break;
       }
+      BYTECODE(SKIP_UNTIL_CHAR) {
+        intptr_t offset = insn >> BYTECODE_SHIFT;
+        uint16_t c = Load16Aligned(pc + 4);
+        if (current + offset < subject_length) {
+          // Scanning with memchr is much faster than stepping through the
+          // subject one bytecode dispatch at a time.
+          intptr_t found =
+              subject.IndexOfCodeUnit(c, current + offset, subject_length);
+          current = found - offset;
+          if (found < subject_length) current_char = c;
+        }
+        pc += BC_SKIP_UNTIL_CHAR_LENGTH;
+        break;
+      }
       default:
         UNREACHABLE();
         break;
@@ -564,6 +621,8 @@ static IrregexpInterpreter::IrregexpResult RawMatch(const uint8_t* code_base,
   }
 }
 
+#undef BACKTRACK_STACK_RESERVE
+
 IrregexpInterpreter::IrregexpResult IrregexpInterpreter::Match(
     const TypedData& bytecode,
     const String& subject,
@@ -34,7 +34,7 @@ namespace dart {
 DEFINE_FLAG(
     int,
     max_subtype_cache_entries,
-    100,
+    1000,
     "Maximum number of subtype cache entries (number of checks cached).");
 DEFINE_FLAG(
     int,
@@ -70,6 +70,10 @@ DECLARE_FLAG(bool, trace_optimizing_compiler);
 DECLARE_FLAG(int, max_polymorphic_checks);
 
 DEFINE_FLAG(bool, trace_osr, false, "Trace attempts at on-stack replacement.");
+DEFINE_FLAG(bool,
+            cache_osr_code,
+            true,
+            "Reuse the OSR code of a loop when it is entered through OSR again.");
 
 DEFINE_FLAG(int,
             stacktrace_every,
@@ -275,11 +279,7 @@ static TokenPosition GetCallerLocation() {
   return caller_frame->GetTokenPos();
 }
 
-// Allocate a new object.
-// Arg0: class of the object that needs to be allocated.
-// Arg1: type arguments of the object that needs to be allocated.
-// Return value: newly allocated object.
-DEFINE_RUNTIME_ENTRY(AllocateObject, 2) {
+static void AllocateInstance(NativeArguments arguments, Heap::Space space) {
   const Class& cls = Class::CheckedHandle(arguments.ArgAt(0));
 
 #ifdef DEBUG
@@ -292,7 +292,6 @@ DEFINE_RUNTIME_ENTRY(AllocateObject, 2) {
     }
   }
 #endif
-  Heap::Space space = Heap::kNew;
   const Instance& instance = Instance::Handle(Instance::New(cls, space));
 
   arguments.SetReturn(instance);
@@ -312,6 +311,23 @@ DEFINE_RUNTIME_ENTRY(AllocateObject, 2) {
   instance.SetTypeArguments(type_arguments);
 }
 
+// Allocate a new object.
+// Arg0: class of the object that needs to be allocated.
+// Arg1: type arguments of the object that needs to be allocated.
+// Return value: newly allocated object.
+DEFINE_RUNTIME_ENTRY(AllocateObject, 2) {
+  AllocateInstance(arguments, Heap::kNew);
+}
+
+// Allocate a new object of a pretenured class in old space, see
+// PretenuringFeedback.
+// Arg0: class of the object that needs to be allocated.
+// Arg1: type arguments of the object that needs to be allocated.
+// Return value: newly allocated object.
+DEFINE_RUNTIME_ENTRY(AllocateOldObject, 2) {
+  AllocateInstance(arguments, Heap::kOld);
+}
+
 // Instantiate type.
 // Arg0: uninstantiated type.
 // Arg1: instantiator type arguments.
@@ -528,6 +544,10 @@ static void UpdateTypeTestCache(
     }
     return;
   }
+#if !defined(PRODUCT)
+  Isolate* isolate = Isolate::Current();
+  isolate->GetSubtypeTestCacheMissesMetric()->AtomicIncrement();
+#endif  // !defined(PRODUCT)
   if (instance.IsSmi()) {
     if (FLAG_trace_type_checks) {
       OS::PrintErr("UpdateTypeTestCache: instance is Smi\n");
@@ -568,6 +588,9 @@ static void UpdateTypeTestCache(
   }
   const intptr_t len = new_cache.NumberOfChecks();
   if (len >= FLAG_max_subtype_cache_entries) {
+#if !defined(PRODUCT)
+    isolate->GetSubtypeTestCacheFullMetric()->AtomicIncrement();
+#endif  // !defined(PRODUCT)
     return;
   }
 #if defined(DEBUG)
@@ -577,29 +600,15 @@ static void UpdateTypeTestCache(
          instantiator_type_arguments.IsCanonical());
   ASSERT(function_type_arguments.IsNull() ||
          function_type_arguments.IsCanonical());
-  Object& last_instance_class_id_or_function = Object::Handle();
-  TypeArguments& last_instance_type_arguments = TypeArguments::Handle();
-  TypeArguments& last_instantiator_type_arguments = TypeArguments::Handle();
-  TypeArguments& last_function_type_arguments = TypeArguments::Handle();
-  Bool& last_result = Bool::Handle();
-  for (intptr_t i = 0; i < len; ++i) {
-    new_cache.GetCheck(i, &last_instance_class_id_or_function,
-                       &last_instance_type_arguments,
-                       &last_instantiator_type_arguments,
-                       &last_function_type_arguments, &last_result);
-    if ((last_instance_class_id_or_function.raw() ==
-         instance_class_id_or_function.raw()) &&
-        (last_instance_type_arguments.raw() == instance_type_arguments.raw()) &&
-        (last_instantiator_type_arguments.raw() ==
-         instantiator_type_arguments.raw()) &&
-        (last_function_type_arguments.raw() == function_type_arguments.raw())) {
-      OS::PrintErr("  Error in test cache %p ix: %" Pd ",", new_cache.raw(), i);
-      PrintTypeCheck(" duplicate cache entry", instance, type,
-                     instantiator_type_arguments, function_type_arguments,
-                     result);
-      UNREACHABLE();
-      return;
-    }
+  if (new_cache.HasCheck(instance_class_id_or_function,
+                         instance_type_arguments, instantiator_type_arguments,
+                         function_type_arguments)) {
+    OS::PrintErr("  Error in test cache %p,", new_cache.raw());
+    PrintTypeCheck(" duplicate cache entry", instance, type,
+                   instantiator_type_arguments, function_type_arguments,
+                   result);
+    UNREACHABLE();
+    return;
   }
 #endif
   new_cache.AddCheck(instance_class_id_or_function, instance_type_arguments,
@@ -1117,6 +1126,12 @@ static RawFunction* InlineCacheMissHandler(
     }
     ic_data.AddCheck(class_ids, target_function);
   }
+  if (receiver.IsClosure() &&
+      (function_name.raw() == Symbols::Call().raw()) &&
+      (ic_data.closure_target() == Function::null())) {
+    ic_data.set_closure_target(
+        Function::Handle(Closure::Cast(receiver).function()));
+  }
   if (FLAG_trace_ic_miss_in_optimized || FLAG_trace_ic) {
     DartFrameIterator iterator(Thread::Current(),
                                StackFrameIterator::kNoCrossThreadIteration);
@@ -1581,6 +1596,7 @@ DEFINE_RUNTIME_ENTRY(MegamorphicCacheMissHandler, 3) {
         // Switch to megamorphic call.
         const MegamorphicCache& cache = MegamorphicCache::Handle(
             zone, MegamorphicCacheTable::Lookup(isolate, name, descriptor));
+        MegamorphicCacheTable::InsertICDataTargets(cache, ic_data);
         DartFrameIterator iterator(thread,
                                    StackFrameIterator::kNoCrossThreadIteration);
         StackFrame* miss_function_frame = iterator.NextFrame();
@@ -1598,6 +1614,7 @@ DEFINE_RUNTIME_ENTRY(MegamorphicCacheMissHandler, 3) {
     }
   } else {
     const MegamorphicCache& cache = MegamorphicCache::Cast(ic_data_or_cache);
+    cache.set_miss_count(cache.miss_count() + 1);
     // Insert function found into cache and return it.
     cache.EnsureCapacity();
     const Smi& class_id = Smi::Handle(zone, Smi::New(cls.id()));
@@ -1884,6 +1901,98 @@ static void HandleStackOverflowTestCases(Thread* thread) {
 #endif  // !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
+// OSR code is never installed on its function, so without a cache every new
+// activation that reaches the OSR threshold in the same loop (e.g. while the
+// function's regular optimized code is still being compiled in the
+// background) would compile it again. The cache is a flat list of entries
+// in ObjectStore::osr_code_cache(), oldest first.
+enum {
+  kOSRCacheUnoptimizedCode = 0,
+  kOSRCacheDeoptId,
+  kOSRCacheDeoptimizationCounter,
+  kOSRCacheCode,
+  kOSRCacheEntrySize,
+};
+static const intptr_t kOSRCacheCapacity = 16;
+
+static intptr_t FindOSRCacheEntry(const GrowableObjectArray& cache,
+                                  const Code& unoptimized_code,
+                                  intptr_t osr_id) {
+  for (intptr_t i = 0; i < cache.Length(); i += kOSRCacheEntrySize) {
+    if ((cache.At(i + kOSRCacheUnoptimizedCode) == unoptimized_code.raw()) &&
+        (Smi::Value(Smi::RawCast(cache.At(i + kOSRCacheDeoptId))) ==
+         osr_id)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Returns the cached OSR code for [osr_id] if it is still usable: it has not
+// been invalidated by a dependency, and the function has not deoptimized
+// since it was compiled, which would mean its speculations failed.
+static RawCode* LookupOSRCode(Zone* zone,
+                              const Function& function,
+                              intptr_t osr_id) {
+  const GrowableObjectArray& cache = GrowableObjectArray::Handle(
+      zone, Isolate::Current()->object_store()->osr_code_cache());
+  if (cache.IsNull()) {
+    return Code::null();
+  }
+  const Code& unoptimized_code =
+      Code::Handle(zone, function.unoptimized_code());
+  const intptr_t index = FindOSRCacheEntry(cache, unoptimized_code, osr_id);
+  if (index < 0) {
+    return Code::null();
+  }
+  const intptr_t deoptimization_counter = Smi::Value(
+      Smi::RawCast(cache.At(index + kOSRCacheDeoptimizationCounter)));
+  const Code& code =
+      Code::Handle(zone, Code::RawCast(cache.At(index + kOSRCacheCode)));
+  if (code.IsDisabled() ||
+      (deoptimization_counter != function.deoptimization_counter())) {
+    return Code::null();
+  }
+  return code.raw();
+}
+
+static void AddOSRCode(Zone* zone,
+                       const Function& function,
+                       intptr_t osr_id,
+                       const Code& code) {
+  ObjectStore* object_store = Isolate::Current()->object_store();
+  GrowableObjectArray& cache =
+      GrowableObjectArray::Handle(zone, object_store->osr_code_cache());
+  if (cache.IsNull()) {
+    cache = GrowableObjectArray::New(kOSRCacheCapacity * kOSRCacheEntrySize,
+                                     Heap::kOld);
+    object_store->set_osr_code_cache(cache);
+  }
+  const Code& unoptimized_code =
+      Code::Handle(zone, function.unoptimized_code());
+  intptr_t index = FindOSRCacheEntry(cache, unoptimized_code, osr_id);
+  if (index < 0) {
+    if (cache.Length() == kOSRCacheCapacity * kOSRCacheEntrySize) {
+      // Evict the oldest entry.
+      Object& entry = Object::Handle(zone);
+      for (intptr_t i = kOSRCacheEntrySize; i < cache.Length(); i++) {
+        entry = cache.At(i);
+        cache.SetAt(i - kOSRCacheEntrySize, entry);
+      }
+      cache.SetLength(cache.Length() - kOSRCacheEntrySize);
+    }
+    index = cache.Length();
+    for (intptr_t i = 0; i < kOSRCacheEntrySize; i++) {
+      cache.Add(Object::null_object(), Heap::kOld);
+    }
+  }
+  cache.SetAt(index + kOSRCacheUnoptimizedCode, unoptimized_code);
+  cache.SetAt(index + kOSRCacheDeoptId, Smi::Handle(zone, Smi::New(osr_id)));
+  cache.SetAt(index + kOSRCacheDeoptimizationCounter,
+              Smi::Handle(zone, Smi::New(function.deoptimization_counter())));
+  cache.SetAt(index + kOSRCacheCode, code);
+}
+
 static void HandleOSRRequest(Thread* thread) {
   Isolate* isolate = thread->isolate();
   ASSERT(isolate->use_osr());
@@ -1925,12 +2034,25 @@ static void HandleOSRRequest(Thread* thread) {
                  function.usage_counter());
   }
 
-  // Since the code is referenced from the frame and the ZoneHandle,
-  // it cannot have been removed from the function.
-  const Object& result = Object::Handle(
-      Compiler::CompileOptimizedFunction(thread, function, osr_id));
-  if (result.IsError()) {
-    Exceptions::PropagateError(Error::Cast(result));
+  Zone* zone = thread->zone();
+  Object& result = Object::Handle(zone);
+  if (FLAG_cache_osr_code) {
+    result = LookupOSRCode(zone, function, osr_id);
+    if (!result.IsNull() && FLAG_trace_osr) {
+      OS::PrintErr("Reusing OSR code for %s at id=%" Pd "\n",
+                   function.ToFullyQualifiedCString(), osr_id);
+    }
+  }
+  if (result.IsNull()) {
+    // Since the code is referenced from the frame and the ZoneHandle,
+    // it cannot have been removed from the function.
+    result = Compiler::CompileOptimizedFunction(thread, function, osr_id);
+    if (result.IsError()) {
+      Exceptions::PropagateError(Error::Cast(result));
+    }
+    if (!result.IsNull() && FLAG_cache_osr_code) {
+      AddOSRCode(zone, function, osr_id, Code::Cast(result));
+    }
   }
 
   if (!result.IsNull()) {
@@ -2024,7 +2146,12 @@ DEFINE_RUNTIME_ENTRY(OptimizeInvokedFunction, 1) {
 #if !defined(DART_PRECOMPILED_RUNTIME)
   const Function& function = Function::CheckedHandle(zone, arguments.ArgAt(0));
   ASSERT(!function.IsNull());
+#if defined(DART_USE_INTERPRETER)
+  // Hot interpreted functions are optimized without unoptimized code.
+  ASSERT(function.HasCode() || function.HasBytecode());
+#else
   ASSERT(function.HasCode());
+#endif
 
   if (Compiler::CanOptimizeFunction(thread, function)) {
     if (FLAG_background_compilation) {
@@ -2336,6 +2463,9 @@ DEFINE_LEAF_RUNTIME_ENTRY(intptr_t,
   const Function& top_function =
       Function::Handle(thread->zone(), optimized_code.function());
   const bool deoptimizing_code = top_function.HasOptimizedCode();
+#if !defined(PRODUCT)
+  isolate->GetDeoptimizationsMetric()->AtomicIncrement();
+#endif  // !defined(PRODUCT)
   if (FLAG_trace_deoptimization) {
     const Function& function = Function::Handle(optimized_code.function());
     THR_Print("== Deoptimizing code for '%s', %s, %s\n",
@@ -11,6 +11,7 @@ namespace dart {
   V(AllocateArray)                                                             \
   V(AllocateContext)                                                           \
   V(AllocateObject)                                                            \
+  V(AllocateOldObject)                                                         \
   V(BreakpointRuntimeHandler)                                                  \
   V(SingleStepHandler)                                                         \
   V(CloneContext)                                                              \
@@ -68,7 +69,11 @@ namespace dart {
   V(double, LibcAsin, double)                                                  \
   V(double, LibcAtan, double)                                                  \
   V(double, LibcAtan2, double, double)                                         \
-  V(RawBool*, CaseInsensitiveCompareUC16, RawString*, RawSmi*, RawSmi*, RawSmi*)
+  V(RawBool*, CaseInsensitiveCompareUC16, RawString*, RawSmi*, RawSmi*, RawSmi*) \
+  V(int64_t, StopwatchNow, void)                                               \
+  V(int64_t, StopwatchFrequency, void)                                         \
+  V(int64_t, TimelineGetTraceClock, void)                                      \
+  V(int64_t, TimelineGetThreadCpuClock, void)
 
 }  // namespace dart
 
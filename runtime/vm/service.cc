@@ -9,6 +9,7 @@
 #include "platform/globals.h"
 
 #include "vm/base64.h"
+#include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/cpu.h"
 #include "vm/dart_api_impl.h"
@@ -48,6 +49,7 @@ namespace dart {
 
 #define Z (T->zone())
 
+DECLARE_FLAG(int, max_subtype_cache_entries);
 DECLARE_FLAG(bool, trace_service);
 DECLARE_FLAG(bool, trace_service_pause_events);
 DECLARE_FLAG(bool, profile_vm);
@@ -63,6 +65,12 @@ DEFINE_FLAG(bool,
             "Print a message when an isolate is paused but there is no "
             "debugger attached.");
 
+DEFINE_FLAG(int,
+            retained_sizes_budget,
+            512,
+            "Megabytes of memory the service protocol may use to compute "
+            "the retained sizes of all objects.");
+
 #ifndef PRODUCT
 // The name of this of this vm as reported by the VM service protocol.
 static char* vm_name = NULL;
@@ -120,13 +128,14 @@ StreamInfo Service::graph_stream("_Graph");
 StreamInfo Service::logging_stream("_Logging");
 StreamInfo Service::extension_stream("Extension");
 StreamInfo Service::timeline_stream("Timeline");
+StreamInfo Service::profiler_stream("_Profiler");
 
 static StreamInfo* streams_[] = {
     &Service::vm_stream,      &Service::isolate_stream,
     &Service::debug_stream,   &Service::gc_stream,
     &Service::echo_stream,    &Service::graph_stream,
     &Service::logging_stream, &Service::extension_stream,
-    &Service::timeline_stream};
+    &Service::timeline_stream, &Service::profiler_stream};
 
 bool Service::ListenStream(const char* stream_id) {
   if (FLAG_trace_service) {
@@ -2249,6 +2258,158 @@ static bool GetReachableSize(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_top_retainers_params[] = {
+    RUNNABLE_ISOLATE_PARAMETER, new UIntParameter("limit", false), NULL,
+};
+
+// Keeps the 'limit' instances retaining the most memory for each class.
+class TopRetainersVisitor : public ObjectGraph::RetainedSizeVisitor {
+ public:
+  struct Retainer {
+    RawObject* object;
+    intptr_t retained_size;
+  };
+
+  TopRetainersVisitor(intptr_t num_cids, intptr_t limit)
+      : num_cids_(num_cids),
+        limit_(limit),
+        counts_(reinterpret_cast<intptr_t*>(
+            calloc(num_cids, sizeof(intptr_t)))),
+        retainers_(reinterpret_cast<Retainer*>(
+            malloc(num_cids * limit * sizeof(Retainer)))),
+        object_count_(0) {}
+
+  ~TopRetainersVisitor() {
+    free(counts_);
+    free(retainers_);
+  }
+
+  virtual void VisitRetainedSize(RawObject* obj, intptr_t retained_size) {
+    object_count_++;
+    const intptr_t cid = obj->GetClassIdMayBeSmi();
+    if (cid >= num_cids_) {
+      return;
+    }
+    Retainer* top = &retainers_[cid * limit_];
+    intptr_t count = counts_[cid];
+    if ((count == limit_) && (top[count - 1].retained_size >= retained_size)) {
+      return;
+    }
+    // Insertion into the class's list, sorted by decreasing size.
+    intptr_t i = (count < limit_) ? count++ : count - 1;
+    while ((i > 0) && (top[i - 1].retained_size < retained_size)) {
+      top[i] = top[i - 1];
+      i--;
+    }
+    top[i].object = obj;
+    top[i].retained_size = retained_size;
+    counts_[cid] = count;
+  }
+
+  intptr_t num_cids() const { return num_cids_; }
+  intptr_t count(intptr_t cid) const { return counts_[cid]; }
+  const Retainer& At(intptr_t cid, intptr_t i) const {
+    return retainers_[cid * limit_ + i];
+  }
+  intptr_t object_count() const { return object_count_; }
+
+ private:
+  const intptr_t num_cids_;
+  const intptr_t limit_;
+  intptr_t* counts_;
+  Retainer* retainers_;
+  intptr_t object_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(TopRetainersVisitor);
+};
+
+struct ClassRetainers {
+  intptr_t cid;
+  intptr_t first;  // Index of the class's first retainer.
+  intptr_t count;
+  intptr_t top_size;
+};
+
+static int CompareClassRetainers(const ClassRetainers* a,
+                                 const ClassRetainers* b) {
+  // Largest first.
+  if (a->top_size != b->top_size) {
+    return (a->top_size > b->top_size) ? -1 : 1;
+  }
+  return (a->cid < b->cid) ? -1 : ((a->cid > b->cid) ? 1 : 0);
+}
+
+static bool GetTopRetainers(Thread* thread, JSONStream* js) {
+  intptr_t limit = 5;
+  const char* limit_param = js->LookupParam("limit");
+  if (limit_param != NULL) {
+    limit = UIntParameter::Parse(limit_param);
+    if (limit <= 0) {
+      PrintInvalidParamError(js, "limit");
+      return true;
+    }
+  }
+  Isolate* isolate = thread->isolate();
+  Zone* zone = thread->zone();
+  isolate->heap()->CollectAllGarbage();
+
+  TopRetainersVisitor visitor(isolate->class_table()->NumCids(), limit);
+  bool computed;
+  {
+    ObjectGraph graph(thread);
+    HeapIterationScope iteration_scope(thread, true);
+    computed = graph.VisitRetainedSizes(
+        &visitor, static_cast<intptr_t>(FLAG_retained_sizes_budget) * MB);
+  }
+  if (!computed) {
+    js->PrintError(kFeatureDisabled,
+                   "Computing retained sizes needs more than "
+                   "--retained_sizes_budget=%d MB.",
+                   FLAG_retained_sizes_budget);
+    return true;
+  }
+
+  // Handle all objects before printing any, which may allocate.
+  GrowableArray<ClassRetainers> classes;
+  GrowableArray<const Object*> objects;
+  GrowableArray<intptr_t> sizes;
+  for (intptr_t cid = 0; cid < visitor.num_cids(); cid++) {
+    if (visitor.count(cid) == 0) {
+      continue;
+    }
+    ClassRetainers retainers;
+    retainers.cid = cid;
+    retainers.first = objects.length();
+    retainers.count = visitor.count(cid);
+    retainers.top_size = visitor.At(cid, 0).retained_size;
+    classes.Add(retainers);
+    for (intptr_t i = 0; i < visitor.count(cid); i++) {
+      objects.Add(&Object::Handle(zone, visitor.At(cid, i).object));
+      sizes.Add(visitor.At(cid, i).retained_size);
+    }
+  }
+  classes.Sort(CompareClassRetainers);
+
+  JSONObject jsobj(js);
+  jsobj.AddProperty("type", "_TopRetainers");
+  jsobj.AddProperty("objectCount", visitor.object_count());
+  JSONArray members(&jsobj, "members");
+  Class& cls = Class::Handle(zone);
+  for (intptr_t i = 0; i < classes.length(); i++) {
+    JSONObject jsclass(&members);
+    cls = isolate->class_table()->At(classes[i].cid);
+    jsclass.AddProperty("class", cls);
+    JSONArray jsretainers(&jsclass, "retainers");
+    for (intptr_t j = 0; j < classes[i].count; j++) {
+      const intptr_t index = classes[i].first + j;
+      JSONObject jsretainer(&jsretainers);
+      jsretainer.AddProperty("object", *objects[index]);
+      jsretainer.AddProperty("retainedSize", sizes[index]);
+    }
+  }
+  return true;
+}
+
 static const MethodParameter* evaluate_params[] = {
     RUNNABLE_ISOLATE_PARAMETER, NULL,
 };
@@ -3702,6 +3863,90 @@ static bool GetCpuProfileTimeline(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const char* const pprof_kind_names[] = {
+    "cpu", "allocation", "heap", NULL,
+};
+
+static ProfilerService::PprofKind pprof_kind_values[] = {
+    ProfilerService::kPprofCpu, ProfilerService::kPprofAllocation,
+    ProfilerService::kPprofHeap,
+    ProfilerService::kPprofCpu,  // default
+};
+
+// Sends each chunk of a pprof profile as an event on the _Profiler stream.
+class PprofEventChunkedWriter : public ChunkedWriter {
+ public:
+  PprofEventChunkedWriter(Thread* thread, intptr_t chunk_size)
+      : ChunkedWriter(chunk_size, true /* compress */, true /* gzip */),
+        thread_(thread) {}
+
+  virtual void WriteChunk(const uint8_t* data, intptr_t size, bool last) {
+    JSONStream js;
+    {
+      JSONObject jsobj(&js);
+      jsobj.AddProperty("jsonrpc", "2.0");
+      jsobj.AddProperty("method", "streamNotify");
+      {
+        JSONObject params(&jsobj, "params");
+        params.AddProperty("streamId", Service::profiler_stream.id());
+        {
+          JSONObject event(&params, "event");
+          event.AddProperty("type", "Event");
+          event.AddProperty("kind", "_PprofProfile");
+          event.AddProperty("isolate", thread_->isolate());
+          event.AddPropertyTimeMillis("timestamp", OS::GetCurrentTimeMillis());
+          event.AddProperty("chunkIndex", chunk_count());
+          event.AddProperty("compression", "gzip");
+          if (last) {
+            event.AddProperty("chunkCount", chunk_count() + 1);
+          }
+        }
+      }
+    }
+
+    Service::SendEventWithData(Service::profiler_stream.id(), "_PprofProfile",
+                               js.buffer()->buf(), js.buffer()->length(),
+                               data, size);
+  }
+
+ private:
+  Thread* thread_;
+};
+
+static const MethodParameter* request_pprof_profile_params[] = {
+    RUNNABLE_ISOLATE_PARAMETER,
+    new EnumParameter("kind", false, pprof_kind_names),
+    new Int64Parameter("timeOriginMicros", false),
+    new Int64Parameter("timeExtentMicros", false),
+    NULL,
+};
+
+// Streams the profile as _PprofProfile events rather than building a JSON
+// response, so that profiles with many samples stay cheap to collect.
+static bool RequestPprofProfile(Thread* thread, JSONStream* js) {
+  ProfilerService::PprofKind kind = ProfilerService::kPprofCpu;
+  const char* kind_arg = js->LookupParam("kind");
+  if (kind_arg != NULL) {
+    kind = EnumMapper(kind_arg, pprof_kind_names, pprof_kind_values);
+  }
+  int64_t time_origin_micros =
+      Int64Parameter::Parse(js->LookupParam("timeOriginMicros"));
+  int64_t time_extent_micros =
+      Int64Parameter::Parse(js->LookupParam("timeExtentMicros"));
+  if (Service::profiler_stream.enabled()) {
+    // Same chunk size as heap snapshots.
+    const intptr_t kChunkSize = 1 * MB;
+    PprofEventChunkedWriter writer(thread, kChunkSize);
+    if (!ProfilerService::WritePprof(thread, kind, &writer, time_origin_micros,
+                                     time_extent_micros)) {
+      js->PrintError(kFeatureDisabled, NULL);
+      return true;
+    }
+  }
+  PrintSuccess(js);
+  return true;
+}
+
 static const MethodParameter* get_allocation_samples_params[] = {
     RUNNABLE_ISOLATE_PARAMETER,
     new EnumParameter("tags", true, tags_enum_names),
@@ -3755,6 +4000,21 @@ static bool GetNativeAllocationSamples(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_native_allocation_stacks_params[] = {
+    NO_ISOLATE_PARAMETER,
+    new UIntParameter("limit", false),
+    NULL,
+};
+
+static bool GetNativeAllocationStacks(Thread* thread, JSONStream* js) {
+  intptr_t limit = -1;
+  if (js->HasParam("limit")) {
+    limit = UIntParameter::Parse(js->LookupParam("limit"));
+  }
+  MallocHooks::PrintLiveAllocationsJSON(js, limit);
+  return true;
+}
+
 static const MethodParameter* clear_cpu_profile_params[] = {
     RUNNABLE_ISOLATE_PARAMETER, NULL,
 };
@@ -3819,6 +4079,32 @@ static bool CollectAllGarbage(Thread* thread, JSONStream* js) {
 }
 #endif  // defined(DEBUG)
 
+static const MethodParameter* get_gc_histograms_params[] = {
+    ISOLATE_PARAMETER, new BoolParameter("reset", false /* not required */),
+    NULL,
+};
+
+static bool GetGCHistograms(Thread* thread, JSONStream* js) {
+  Isolate* isolate = thread->isolate();
+  const bool reset = BoolParameter::Parse(js->LookupParam("reset"), false);
+  JSONObject obj(js);
+  obj.AddProperty("type", "_GCHistograms");
+  {
+    JSONArray histograms(&obj, "histograms");
+#define PRINT_GC_HISTOGRAM(type, variable, name, unit)                         \
+  histograms.AddValue(isolate->Get##variable##Metric());
+    ISOLATE_GC_HISTOGRAM_LIST(PRINT_GC_HISTOGRAM)
+#undef PRINT_GC_HISTOGRAM
+  }
+  if (reset) {
+#define RESET_GC_HISTOGRAM(type, variable, name, unit)                         \
+  isolate->Get##variable##Metric()->Reset();
+    ISOLATE_GC_HISTOGRAM_LIST(RESET_GC_HISTOGRAM)
+#undef RESET_GC_HISTOGRAM
+  }
+  return true;
+}
+
 static const MethodParameter* get_heap_map_params[] = {
     RUNNABLE_ISOLATE_PARAMETER, NULL,
 };
@@ -3852,7 +4138,9 @@ static ObjectGraph::SnapshotRoots snapshot_roots_values[] = {
 static const MethodParameter* request_heap_snapshot_params[] = {
     RUNNABLE_ISOLATE_PARAMETER,
     new EnumParameter("roots", false /* not required */, snapshot_roots_names),
-    new BoolParameter("collectGarbage", false /* not required */), NULL,
+    new BoolParameter("collectGarbage", false /* not required */),
+    new BoolParameter("streaming", false /* not required */),
+    new BoolParameter("compress", false /* not required */), NULL,
 };
 
 static bool RequestHeapSnapshot(Thread* thread, JSONStream* js) {
@@ -3863,8 +4151,17 @@ static bool RequestHeapSnapshot(Thread* thread, JSONStream* js) {
   }
   const bool collect_garbage =
       BoolParameter::Parse(js->LookupParam("collectGarbage"), true);
+  const bool compress =
+      BoolParameter::Parse(js->LookupParam("compress"), false);
+  const bool streaming =
+      BoolParameter::Parse(js->LookupParam("streaming"), false) || compress;
   if (Service::graph_stream.enabled()) {
-    Service::SendGraphEvent(thread, roots, collect_garbage);
+    if (streaming) {
+      Service::SendStreamingGraphEvent(thread, roots, collect_garbage,
+                                       compress);
+    } else {
+      Service::SendGraphEvent(thread, roots, collect_garbage);
+    }
   }
   // TODO(koda): Provide some id that ties this request to async response(s).
   PrintSuccess(js);
@@ -3917,6 +4214,64 @@ void Service::SendGraphEvent(Thread* thread,
   }
 }
 
+// Sends each chunk of a heap snapshot as soon as it has been written. Since
+// the total is not known up front, only the last chunk's event carries the
+// chunkCount and nodeCount.
+class GraphEventChunkedWriter : public ChunkedWriter {
+ public:
+  GraphEventChunkedWriter(Thread* thread, intptr_t chunk_size, bool compress)
+      : ChunkedWriter(chunk_size, compress), thread_(thread) {}
+
+  virtual void WriteChunk(const uint8_t* data, intptr_t size, bool last) {
+    JSONStream js;
+    {
+      JSONObject jsobj(&js);
+      jsobj.AddProperty("jsonrpc", "2.0");
+      jsobj.AddProperty("method", "streamNotify");
+      {
+        JSONObject params(&jsobj, "params");
+        params.AddProperty("streamId", Service::graph_stream.id());
+        {
+          JSONObject event(&params, "event");
+          event.AddProperty("type", "Event");
+          event.AddProperty("kind", "_Graph");
+          event.AddProperty("isolate", thread_->isolate());
+          event.AddPropertyTimeMillis("timestamp", OS::GetCurrentTimeMillis());
+
+          event.AddProperty("chunkIndex", chunk_count());
+          event.AddProperty("streaming", true);
+          if (compressed()) {
+            event.AddProperty("compression", "zlib");
+          }
+          if (last) {
+            event.AddProperty("chunkCount", chunk_count() + 1);
+            event.AddProperty("nodeCount", node_count());
+          }
+        }
+      }
+    }
+
+    Service::SendEventWithData(Service::graph_stream.id(), "_Graph",
+                               js.buffer()->buf(), js.buffer()->length(),
+                               data, size);
+  }
+
+ private:
+  Thread* thread_;
+};
+
+void Service::SendStreamingGraphEvent(Thread* thread,
+                                      ObjectGraph::SnapshotRoots roots,
+                                      bool collect_garbage,
+                                      bool compress) {
+  // Same chunk size as SendGraphEvent, but only one chunk is buffered at a
+  // time regardless of the size of the heap.
+  const intptr_t kChunkSize = 1 * MB;
+  GraphEventChunkedWriter writer(thread, kChunkSize, compress);
+  ObjectGraph graph(thread);
+  graph.Serialize(&writer, roots, collect_garbage);
+}
+
 void Service::SendInspectEvent(Isolate* isolate, const Object& inspectee) {
   if (!Service::debug_stream.enabled()) {
     return;
@@ -4281,6 +4636,105 @@ static bool GetTypeArgumentsList(Thread* thread, JSONStream* js) {
   return true;
 }
 
+static const MethodParameter* get_subtype_test_cache_statistics_params[] = {
+    RUNNABLE_ISOLATE_PARAMETER, NULL,
+};
+
+class SubtypeTestCacheVisitor : public ObjectVisitor {
+ public:
+  explicit SubtypeTestCacheVisitor(Zone* zone)
+      : cache_(SubtypeTestCache::Handle(zone)),
+        caches_(0),
+        full_caches_(0) {}
+
+  virtual void VisitObject(RawObject* obj) {
+    if (!obj->IsSubtypeTestCache()) {
+      return;
+    }
+    cache_ ^= obj;
+    caches_++;
+    if (cache_.NumberOfChecks() >= FLAG_max_subtype_cache_entries) {
+      full_caches_++;
+    }
+    cache_.CollectProbeLengths(&probe_lengths_);
+  }
+
+  intptr_t caches() const { return caches_; }
+  intptr_t full_caches() const { return full_caches_; }
+  const GrowableArray<intptr_t>& probe_lengths() const {
+    return probe_lengths_;
+  }
+
+ private:
+  SubtypeTestCache& cache_;
+  intptr_t caches_;
+  intptr_t full_caches_;
+  GrowableArray<intptr_t> probe_lengths_;
+};
+
+static bool GetSubtypeTestCacheStatistics(Thread* thread, JSONStream* js) {
+  SubtypeTestCacheVisitor visitor(thread->zone());
+  {
+    HeapIterationScope iteration(thread);
+    iteration.IterateObjects(&visitor);
+  }
+  // Histogram of the number of entries a lookup of each cached check probes,
+  // the last bucket counting all longer probes.
+  const intptr_t kMaxProbeLength = 8;
+  intptr_t histogram[kMaxProbeLength] = {0};
+  intptr_t total_probes = 0;
+  intptr_t max_probe_length = 0;
+  const GrowableArray<intptr_t>& probe_lengths = visitor.probe_lengths();
+  for (intptr_t i = 0; i < probe_lengths.length(); i++) {
+    const intptr_t length = probe_lengths[i];
+    histogram[Utils::Minimum(length, kMaxProbeLength) - 1]++;
+    total_probes += length;
+    max_probe_length = Utils::Maximum(max_probe_length, length);
+  }
+  Isolate* isolate = thread->isolate();
+  JSONObject jsobj(js);
+  jsobj.AddProperty("type", "_SubtypeTestCacheStatistics");
+  jsobj.AddProperty("caches", visitor.caches());
+  jsobj.AddProperty("fullCaches", visitor.full_caches());
+  jsobj.AddProperty("checks", probe_lengths.length());
+  jsobj.AddProperty("maxChecksPerCache",
+                    static_cast<intptr_t>(FLAG_max_subtype_cache_entries));
+  jsobj.AddProperty64("runtimeLookups",
+                    isolate->GetSubtypeTestCacheMissesMetric()->value());
+  jsobj.AddProperty64("uncachedFullLookups",
+                    isolate->GetSubtypeTestCacheFullMetric()->value());
+  jsobj.AddProperty("maxProbeLength", max_probe_length);
+  jsobj.AddProperty("averageProbeLength",
+                    probe_lengths.is_empty()
+                        ? 0.0
+                        : static_cast<double>(total_probes) /
+                              probe_lengths.length());
+  {
+    JSONArray histogram_array(&jsobj, "probeLengths");
+    for (intptr_t i = 0; i < kMaxProbeLength; i++) {
+      histogram_array.AddValue(histogram[i]);
+    }
+  }
+  return true;
+}
+
+static const MethodParameter* get_compiler_statistics_params[] = {
+    NO_ISOLATE_PARAMETER, new UIntParameter("limit", false), NULL,
+};
+
+static bool GetCompilerStatistics(Thread* thread, JSONStream* js) {
+#if defined(DART_PRECOMPILED_RUNTIME)
+  js->PrintError(kFeatureDisabled, "Compiler is disabled in AOT mode.");
+#else
+  intptr_t limit = CompilerStatistics::kMaxCompilations;
+  if (js->HasParam("limit")) {
+    limit = UIntParameter::Parse(js->LookupParam("limit"));
+  }
+  CompilerStatistics::PrintJSON(js, limit);
+#endif
+  return true;
+}
+
 static const MethodParameter* get_version_params[] = {
     NO_ISOLATE_PARAMETER, NULL,
 };
@@ -4671,14 +5125,20 @@ static const ServiceMethodDescriptor service_methods_[] = {
       get_allocation_samples_params },
   { "_getNativeAllocationSamples", GetNativeAllocationSamples,
       get_native_allocation_samples_params },
+  { "_getNativeAllocationStacks", GetNativeAllocationStacks,
+      get_native_allocation_stacks_params },
   { "getClassList", GetClassList,
     get_class_list_params },
+  { "_getCompilerStatistics", GetCompilerStatistics,
+    get_compiler_statistics_params },
   { "_getCpuProfile", GetCpuProfile,
     get_cpu_profile_params },
   { "_getCpuProfileTimeline", GetCpuProfileTimeline,
     get_cpu_profile_timeline_params },
   { "getFlagList", GetFlagList,
     get_flag_list_params },
+  { "_getGCHistograms", GetGCHistograms,
+    get_gc_histograms_params },
   { "_getHeapMap", GetHeapMap,
     get_heap_map_params },
   { "_getInboundReferences", GetInboundReferences,
@@ -4713,8 +5173,12 @@ static const ServiceMethodDescriptor service_methods_[] = {
     get_stack_params },
   { "_getUnusedChangesInLastReload", GetUnusedChangesInLastReload,
     get_unused_changes_in_last_reload_params },
+  { "_getSubtypeTestCacheStatistics", GetSubtypeTestCacheStatistics,
+    get_subtype_test_cache_statistics_params },
   { "_getTagProfile", GetTagProfile,
     get_tag_profile_params },
+  { "_getTopRetainers", GetTopRetainers,
+    get_top_retainers_params },
   { "_getTypeArgumentsList", GetTypeArgumentsList,
     get_type_arguments_list_params },
   { "getVersion", GetVersion,
@@ -4742,6 +5206,8 @@ static const ServiceMethodDescriptor service_methods_[] = {
     resume_params },
   { "_requestHeapSnapshot", RequestHeapSnapshot,
     request_heap_snapshot_params },
+  { "_requestPprofProfile", RequestPprofProfile,
+    request_pprof_profile_params },
   { "_evaluateCompiledExpression", EvaluateCompiledExpression,
     evaluate_compiled_expression_params },
   { "setExceptionPauseMode", SetExceptionPauseMode,
@@ -115,6 +115,10 @@ class Service : public AllStatic {
   static void SendGraphEvent(Thread* thread,
                              ObjectGraph::SnapshotRoots roots,
                              bool collect_garbage);
+  static void SendStreamingGraphEvent(Thread* thread,
+                                      ObjectGraph::SnapshotRoots roots,
+                                      bool collect_garbage,
+                                      bool compress);
   static void SendInspectEvent(Isolate* isolate, const Object& inspectee);
 
   static void SendEmbedderEvent(Isolate* isolate,
@@ -154,6 +158,7 @@ class Service : public AllStatic {
   static StreamInfo logging_stream;
   static StreamInfo extension_stream;
   static StreamInfo timeline_stream;
+  static StreamInfo profiler_stream;
 
   static bool ListenStream(const char* stream_id);
   static void CancelStream(const char* stream_id);
@@ -224,6 +229,9 @@ class Service : public AllStatic {
   static bool needs_gc_events_;
   static bool needs_echo_events_;
   static bool needs_graph_events_;
+
+  friend class GraphEventChunkedWriter;
+  friend class PprofEventChunkedWriter;
 };
 
 }  // namespace dart
@@ -35,6 +35,12 @@ DEFINE_FLAG(bool,
             trace_service_verbose,
             false,
             "Provide extra service tracing information.");
+DEFINE_FLAG(bool,
+            lazy_service_isolate,
+            false,
+            "Start the service isolate only when it is first needed, e.g. "
+            "by dart:developer's Service or the loader, instead of at "
+            "VM startup.");
 
 // These must be kept in sync with service/constants.dart
 #define VM_SERVICE_ISOLATE_EXIT_MESSAGE_ID 0
@@ -77,6 +83,7 @@ Dart_Port ServiceIsolate::load_port_ = ILLEGAL_PORT;
 Dart_Port ServiceIsolate::origin_ = ILLEGAL_PORT;
 Dart_IsolateCreateCallback ServiceIsolate::create_callback_ = NULL;
 Monitor* ServiceIsolate::monitor_ = new Monitor();
+bool ServiceIsolate::deferred_ = false;
 bool ServiceIsolate::initializing_ = true;
 bool ServiceIsolate::shutting_down_ = false;
 char* ServiceIsolate::server_address_ = NULL;
@@ -141,6 +148,7 @@ Dart_Port ServiceIsolate::Port() {
 }
 
 Dart_Port ServiceIsolate::WaitForLoadPort() {
+  StartIfDeferred();
   MonitorLocker ml(monitor_);
   while (initializing_ && (load_port_ == ILLEGAL_PORT)) {
     ml.Wait();
@@ -422,9 +430,44 @@ void ServiceIsolate::Run() {
     ServiceIsolate::FinishedInitializing();
     return;
   }
+  if (FLAG_lazy_service_isolate) {
+    MonitorLocker ml(monitor_);
+    deferred_ = true;
+    return;
+  }
   Dart::thread_pool()->Run(new RunServiceTask());
 }
 
+void ServiceIsolate::StartIfDeferred() {
+  {
+    MonitorLocker ml(monitor_);
+    if (!deferred_ || shutting_down_) {
+      return;
+    }
+    deferred_ = false;
+  }
+  if (FLAG_trace_service) {
+    OS::PrintErr("vm-service: Starting deferred service isolate.\n");
+  }
+  Dart::thread_pool()->Run(new RunServiceTask());
+}
+
+bool ServiceIsolate::EnsureRunning() {
+  if (!FLAG_lazy_service_isolate) {
+    return IsRunning();
+  }
+  StartIfDeferred();
+  {
+    // Run() sets the create callback before any start. Without one, nothing
+    // is starting.
+    MonitorLocker ml(monitor_);
+    while (initializing_ && (create_callback_ != NULL)) {
+      ml.Wait();
+    }
+  }
+  return IsRunning();
+}
+
 void ServiceIsolate::KillServiceIsolate() {
   {
     MonitorLocker ml(monitor_);
@@ -440,6 +483,15 @@ void ServiceIsolate::KillServiceIsolate() {
 }
 
 void ServiceIsolate::Shutdown() {
+  {
+    MonitorLocker ml(monitor_);
+    if (deferred_) {
+      // Never started: nothing waits for it anymore.
+      deferred_ = false;
+      initializing_ = false;
+      ml.NotifyAll();
+    }
+  }
   if (IsRunning()) {
     {
       MonitorLocker ml(monitor_);
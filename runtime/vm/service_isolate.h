@@ -30,6 +30,10 @@ class ServiceIsolate : public AllStatic {
   static Dart_Port LoadPort();
 
   static void Run();
+  // With --lazy_service_isolate, Run() defers starting the service isolate
+  // until this is first called. Returns whether the service isolate is
+  // running once it has finished starting.
+  static bool EnsureRunning();
   static bool SendIsolateStartupMessage();
   static bool SendIsolateShutdownMessage();
   static void SendServiceExitMessage();
@@ -62,7 +66,10 @@ class ServiceIsolate : public AllStatic {
   }
 
   static Dart_IsolateCreateCallback create_callback_;
+  static void StartIfDeferred();
+
   static Monitor* monitor_;
+  static bool deferred_;
   static bool initializing_;
   static bool shutting_down_;
   static Isolate* isolate_;
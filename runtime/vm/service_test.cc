@@ -26,9 +26,11 @@ DEFINE_FLAG(bool, service_testing_flag, false, "Comment");
 
 #ifndef PRODUCT
 
+DECLARE_FLAG(int, service_response_chunk_size);
+
 class ServiceTestMessageHandler : public MessageHandler {
  public:
-  ServiceTestMessageHandler() : _msg(NULL) {}
+  ServiceTestMessageHandler() : _msg(NULL), _chunks(64) {}
 
   ~ServiceTestMessageHandler() { free(_msg); }
 
@@ -55,10 +57,23 @@ class ServiceTestMessageHandler : public MessageHandler {
       ASSERT(response_obj.IsArray());
       Array& response_array = Array::Handle();
       response_array ^= response_obj.raw();
-      ASSERT(response_array.Length() == 1);
       ExternalTypedData& response = ExternalTypedData::Handle();
       response ^= response_array.At(0);
-      _msg = strdup(reinterpret_cast<char*>(response.DataAddr(0)));
+      if (response_array.Length() == 2) {
+        if (response_array.At(1) == Bool::True().raw()) {
+          // A chunk of a reply, which continues in the next message.
+          _chunks.AddRaw(reinterpret_cast<uint8_t*>(response.DataAddr(0)),
+                         response.Length());
+          delete message;
+          return kOK;
+        }
+        // The rest of the reply replaces the chunks.
+        _chunks.Clear();
+      }
+      _chunks.AddRaw(reinterpret_cast<uint8_t*>(response.DataAddr(0)),
+                     response.Length());
+      _msg = strdup(_chunks.buf());
+      _chunks.Clear();
     }
 
     delete message;
@@ -72,6 +87,7 @@ class ServiceTestMessageHandler : public MessageHandler {
 
  private:
   char* _msg;
+  TextBuffer _chunks;
 };
 
 static RawArray* Eval(Dart_Handle lib, const char* expr) {
@@ -178,6 +194,47 @@ TEST_CASE(Service_IsolateStickyError) {
   }
 }
 
+TEST_CASE(Service_ChunkedReply) {
+  const char* kScript =
+      "var port;\n"  // Set to our mock port by C++.
+      "\n"
+      "main() {\n"
+      "}";
+
+  Isolate* isolate = thread->isolate();
+  isolate->set_is_runnable(true);
+  Dart_Handle lib = TestCase::LoadTestScript(kScript, NULL);
+  EXPECT_VALID(lib);
+
+  // Build a mock message handler and wrap it in a dart port.
+  ServiceTestMessageHandler handler;
+  Dart_Port port_id = PortMap::CreatePort(&handler);
+  Dart_Handle port = Api::NewHandle(thread, SendPort::New(port_id));
+  EXPECT_VALID(port);
+  EXPECT_VALID(Dart_SetField(lib, NewString("port"), port));
+
+  Array& service_msg = Array::Handle();
+  service_msg = Eval(lib, "[0, port, '0', 'getClassList', [], []]");
+  HandleIsolateMessage(isolate, service_msg);
+  EXPECT_EQ(MessageHandler::kOK, handler.HandleNextMessage());
+  EXPECT_SUBSTRING("\"type\":\"ClassList\"", handler.msg());
+  char* unchunked = strdup(handler.msg());
+
+  const intptr_t saved_chunk_size = FLAG_service_response_chunk_size;
+  FLAG_service_response_chunk_size = 64;
+  HandleIsolateMessage(isolate, service_msg);
+  FLAG_service_response_chunk_size = saved_chunk_size;
+  // The reply is posted in many chunks, which add up to the same reply.
+  intptr_t messages = 0;
+  do {
+    EXPECT_EQ(MessageHandler::kOK, handler.HandleNextMessage());
+    messages++;
+  } while (handler.msg() == NULL);
+  EXPECT(messages > 1);
+  EXPECT_STREQ(unchunked, handler.msg());
+  free(unchunked);
+}
+
 TEST_CASE(Service_IdZones) {
   Zone* zone = thread->zone();
   Isolate* isolate = thread->isolate();
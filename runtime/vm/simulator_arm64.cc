@@ -433,7 +433,8 @@ void SimulatorDebugger::Debug() {
             "gdb -- transfer control to gdb\n"
             "h/help -- print this help string\n"
             "break <address> -- set break point at specified address\n"
-            "p/print <reg or icount or value or *addr> -- print integer\n"
+            "p/print <reg or icount or decodemisses or value or *addr> -- "
+            "print integer\n"
             "pf/printfloat <vreg or *addr> --print float value\n"
             "pd/printdouble <vreg or *addr> -- print double value\n"
             "pq/printquad <vreg or *addr> -- print vector register\n"
@@ -459,13 +460,17 @@ void SimulatorDebugger::Debug() {
           if (strcmp(arg1, "icount") == 0) {
             value = sim_->get_icount();
             OS::PrintErr("icount: %" Pu64 " 0x%" Px64 "\n", value, value);
+          } else if (strcmp(arg1, "decodemisses") == 0) {
+            value = sim_->get_decode_cache_misses();
+            OS::PrintErr("decodemisses: %" Pu64 "\n", value);
           } else if (GetValue(arg1, &value)) {
             OS::PrintErr("%s: %" Pu64 " 0x%" Px64 "\n", arg1, value, value);
           } else {
             OS::PrintErr("%s unrecognized\n", arg1);
           }
         } else {
-          OS::PrintErr("print <reg or icount or value or *addr>\n");
+          OS::PrintErr(
+              "print <reg or icount or decodemisses or value or *addr>\n");
         }
       } else if ((strcmp(cmd, "pf") == 0) || (strcmp(cmd, "printfloat") == 0)) {
         if (args == 2) {
@@ -729,6 +734,14 @@ Simulator::Simulator() : exclusive_access_addr_(0), exclusive_access_value_(0) {
 
   pc_modified_ = false;
   icount_ = 0;
+  decode_cache_misses_ = 0;
+  decode_cache_ = new DecodeCacheEntry[kDecodeCacheSize];
+  for (intptr_t i = 0; i < kDecodeCacheSize; i++) {
+    // No instruction is executed at address 0, see IsIllegalAddress.
+    decode_cache_[i].pc = 0;
+    decode_cache_[i].bits = 0;
+    decode_cache_[i].decode = NULL;
+  }
   break_pc_ = NULL;
   break_instr_ = 0;
   last_setjmp_buffer_ = NULL;
@@ -760,6 +773,7 @@ Simulator::Simulator() : exclusive_access_addr_(0), exclusive_access_value_(0) {
 
 Simulator::~Simulator() {
   delete[] stack_;
+  delete[] decode_cache_;
   Isolate* isolate = Isolate::Current();
   if (isolate != NULL) {
     isolate->set_simulator(NULL);
@@ -1414,22 +1428,6 @@ void Simulator::DecodePCRel(Instr* instr) {
   }
 }
 
-void Simulator::DecodeDPImmediate(Instr* instr) {
-  if (instr->IsMoveWideOp()) {
-    DecodeMoveWide(instr);
-  } else if (instr->IsAddSubImmOp()) {
-    DecodeAddSubImm(instr);
-  } else if (instr->IsBitfieldOp()) {
-    DecodeBitfield(instr);
-  } else if (instr->IsLogicalImmOp()) {
-    DecodeLogicalImm(instr);
-  } else if (instr->IsPCRelOp()) {
-    DecodePCRel(instr);
-  } else {
-    UnimplementedInstruction(instr);
-  }
-}
-
 void Simulator::DecodeCompareAndBranch(Instr* instr) {
   const int op = instr->Bit(24);
   const Register rt = instr->RtField();
@@ -1772,26 +1770,6 @@ void Simulator::DecodeUnconditionalBranchReg(Instr* instr) {
   }
 }
 
-void Simulator::DecodeCompareBranch(Instr* instr) {
-  if (instr->IsCompareAndBranchOp()) {
-    DecodeCompareAndBranch(instr);
-  } else if (instr->IsConditionalBranchOp()) {
-    DecodeConditionalBranch(instr);
-  } else if (instr->IsExceptionGenOp()) {
-    DecodeExceptionGen(instr);
-  } else if (instr->IsSystemOp()) {
-    DecodeSystem(instr);
-  } else if (instr->IsTestAndBranchOp()) {
-    DecodeTestAndBranch(instr);
-  } else if (instr->IsUnconditionalBranchOp()) {
-    DecodeUnconditionalBranch(instr);
-  } else if (instr->IsUnconditionalBranchRegOp()) {
-    DecodeUnconditionalBranchReg(instr);
-  } else {
-    UnimplementedInstruction(instr);
-  }
-}
-
 void Simulator::DecodeLoadStoreReg(Instr* instr) {
   // Calculate the address.
   const Register rn = instr->RnField();
@@ -2139,20 +2117,6 @@ void Simulator::DecodeLoadStoreExclusive(Instr* instr) {
   }
 }
 
-void Simulator::DecodeLoadStore(Instr* instr) {
-  if (instr->IsLoadStoreRegOp()) {
-    DecodeLoadStoreReg(instr);
-  } else if (instr->IsLoadStoreRegPairOp()) {
-    DecodeLoadStoreRegPair(instr);
-  } else if (instr->IsLoadRegLiteralOp()) {
-    DecodeLoadRegLiteral(instr);
-  } else if (instr->IsLoadStoreExclusiveOp()) {
-    DecodeLoadStoreExclusive(instr);
-  } else {
-    UnimplementedInstruction(instr);
-  }
-}
-
 int64_t Simulator::ShiftOperand(uint8_t reg_size,
                                 int64_t value,
                                 Shift shift_type,
@@ -2667,26 +2631,6 @@ void Simulator::DecodeConditionalSelect(Instr* instr) {
   }
 }
 
-void Simulator::DecodeDPRegister(Instr* instr) {
-  if (instr->IsAddSubShiftExtOp()) {
-    DecodeAddSubShiftExt(instr);
-  } else if (instr->IsAddSubWithCarryOp()) {
-    DecodeAddSubWithCarry(instr);
-  } else if (instr->IsLogicalShiftOp()) {
-    DecodeLogicalShift(instr);
-  } else if (instr->IsMiscDP1SourceOp()) {
-    DecodeMiscDP1Source(instr);
-  } else if (instr->IsMiscDP2SourceOp()) {
-    DecodeMiscDP2Source(instr);
-  } else if (instr->IsMiscDP3SourceOp()) {
-    DecodeMiscDP3Source(instr);
-  } else if (instr->IsConditionalSelectOp()) {
-    DecodeConditionalSelect(instr);
-  } else {
-    UnimplementedInstruction(instr);
-  }
-}
-
 void Simulator::DecodeSIMDCopy(Instr* instr) {
   const int32_t Q = instr->Bit(30);
   const int32_t op = instr->Bit(29);
@@ -3128,18 +3072,6 @@ void Simulator::DecodeSIMDTwoReg(Instr* instr) {
   }
 }
 
-void Simulator::DecodeDPSimd1(Instr* instr) {
-  if (instr->IsSIMDCopyOp()) {
-    DecodeSIMDCopy(instr);
-  } else if (instr->IsSIMDThreeSameOp()) {
-    DecodeSIMDThreeSame(instr);
-  } else if (instr->IsSIMDTwoRegOp()) {
-    DecodeSIMDTwoReg(instr);
-  } else {
-    UnimplementedInstruction(instr);
-  }
-}
-
 void Simulator::DecodeFPImm(Instr* instr) {
   if ((instr->Bit(31) != 0) || (instr->Bit(29) != 0) || (instr->Bit(23) != 0) ||
       (instr->Bits(5, 5) != 0)) {
@@ -3355,28 +3287,99 @@ void Simulator::DecodeFPCompare(Instr* instr) {
   }
 }
 
-void Simulator::DecodeFP(Instr* instr) {
-  if (instr->IsFPImmOp()) {
-    DecodeFPImm(instr);
-  } else if (instr->IsFPIntCvtOp()) {
-    DecodeFPIntCvt(instr);
-  } else if (instr->IsFPOneSourceOp()) {
-    DecodeFPOneSource(instr);
-  } else if (instr->IsFPTwoSourceOp()) {
-    DecodeFPTwoSource(instr);
-  } else if (instr->IsFPCompareOp()) {
-    DecodeFPCompare(instr);
-  } else {
-    UnimplementedInstruction(instr);
+Simulator::DecodeFunction Simulator::ClassifyInstruction(Instr* instr) {
+  if (instr->IsDPImmediateOp()) {
+    if (instr->IsMoveWideOp()) {
+      return &Simulator::DecodeMoveWide;
+    } else if (instr->IsAddSubImmOp()) {
+      return &Simulator::DecodeAddSubImm;
+    } else if (instr->IsBitfieldOp()) {
+      return &Simulator::DecodeBitfield;
+    } else if (instr->IsLogicalImmOp()) {
+      return &Simulator::DecodeLogicalImm;
+    } else if (instr->IsPCRelOp()) {
+      return &Simulator::DecodePCRel;
+    }
+  } else if (instr->IsCompareBranchOp()) {
+    if (instr->IsCompareAndBranchOp()) {
+      return &Simulator::DecodeCompareAndBranch;
+    } else if (instr->IsConditionalBranchOp()) {
+      return &Simulator::DecodeConditionalBranch;
+    } else if (instr->IsExceptionGenOp()) {
+      return &Simulator::DecodeExceptionGen;
+    } else if (instr->IsSystemOp()) {
+      return &Simulator::DecodeSystem;
+    } else if (instr->IsTestAndBranchOp()) {
+      return &Simulator::DecodeTestAndBranch;
+    } else if (instr->IsUnconditionalBranchOp()) {
+      return &Simulator::DecodeUnconditionalBranch;
+    } else if (instr->IsUnconditionalBranchRegOp()) {
+      return &Simulator::DecodeUnconditionalBranchReg;
+    }
+  } else if (instr->IsLoadStoreOp()) {
+    if (instr->IsLoadStoreRegOp()) {
+      return &Simulator::DecodeLoadStoreReg;
+    } else if (instr->IsLoadStoreRegPairOp()) {
+      return &Simulator::DecodeLoadStoreRegPair;
+    } else if (instr->IsLoadRegLiteralOp()) {
+      return &Simulator::DecodeLoadRegLiteral;
+    } else if (instr->IsLoadStoreExclusiveOp()) {
+      return &Simulator::DecodeLoadStoreExclusive;
+    }
+  } else if (instr->IsDPRegisterOp()) {
+    if (instr->IsAddSubShiftExtOp()) {
+      return &Simulator::DecodeAddSubShiftExt;
+    } else if (instr->IsAddSubWithCarryOp()) {
+      return &Simulator::DecodeAddSubWithCarry;
+    } else if (instr->IsLogicalShiftOp()) {
+      return &Simulator::DecodeLogicalShift;
+    } else if (instr->IsMiscDP1SourceOp()) {
+      return &Simulator::DecodeMiscDP1Source;
+    } else if (instr->IsMiscDP2SourceOp()) {
+      return &Simulator::DecodeMiscDP2Source;
+    } else if (instr->IsMiscDP3SourceOp()) {
+      return &Simulator::DecodeMiscDP3Source;
+    } else if (instr->IsConditionalSelectOp()) {
+      return &Simulator::DecodeConditionalSelect;
+    }
+  } else if (instr->IsDPSimd1Op()) {
+    if (instr->IsSIMDCopyOp()) {
+      return &Simulator::DecodeSIMDCopy;
+    } else if (instr->IsSIMDThreeSameOp()) {
+      return &Simulator::DecodeSIMDThreeSame;
+    } else if (instr->IsSIMDTwoRegOp()) {
+      return &Simulator::DecodeSIMDTwoReg;
+    }
+  } else if (instr->IsDPSimd2Op()) {
+    if (instr->IsFPOp()) {
+      if (instr->IsFPImmOp()) {
+        return &Simulator::DecodeFPImm;
+      } else if (instr->IsFPIntCvtOp()) {
+        return &Simulator::DecodeFPIntCvt;
+      } else if (instr->IsFPOneSourceOp()) {
+        return &Simulator::DecodeFPOneSource;
+      } else if (instr->IsFPTwoSourceOp()) {
+        return &Simulator::DecodeFPTwoSource;
+      } else if (instr->IsFPCompareOp()) {
+        return &Simulator::DecodeFPCompare;
+      }
+    }
   }
+  return &Simulator::UnimplementedInstruction;
 }
 
-void Simulator::DecodeDPSimd2(Instr* instr) {
-  if (instr->IsFPOp()) {
-    DecodeFP(instr);
-  } else {
-    UnimplementedInstruction(instr);
+Simulator::DecodeFunction Simulator::LookupDecodeFunction(Instr* instr) {
+  const uword pc = reinterpret_cast<uword>(instr);
+  const int32_t bits = instr->InstructionBits();
+  DecodeCacheEntry* entry =
+      &decode_cache_[(pc >> Instr::kInstrSizeLog2) & (kDecodeCacheSize - 1)];
+  if ((entry->pc != pc) || (entry->bits != bits)) {
+    decode_cache_misses_++;
+    entry->pc = pc;
+    entry->bits = bits;
+    entry->decode = ClassifyInstruction(instr);
   }
+  return entry->decode;
 }
 
 // Executes the current instruction.
@@ -3393,21 +3396,7 @@ void Simulator::InstructionDecode(Instr* instr) {
     }
   }
 
-  if (instr->IsDPImmediateOp()) {
-    DecodeDPImmediate(instr);
-  } else if (instr->IsCompareBranchOp()) {
-    DecodeCompareBranch(instr);
-  } else if (instr->IsLoadStoreOp()) {
-    DecodeLoadStore(instr);
-  } else if (instr->IsDPRegisterOp()) {
-    DecodeDPRegister(instr);
-  } else if (instr->IsDPSimd1Op()) {
-    DecodeDPSimd1(instr);
-  } else if (instr->IsDPSimd2Op()) {
-    DecodeDPSimd2(instr);
-  } else {
-    UnimplementedInstruction(instr);
-  }
+  (this->*LookupDecodeFunction(instr))(instr);
 
   if (!pc_modified_) {
     set_pc(reinterpret_cast<int64_t>(instr) + Instr::kInstrSize);
@@ -80,6 +80,7 @@ class Simulator {
 
   // Accessor to the instruction counter.
   uint64_t get_icount() const { return icount_; }
+  uint64_t get_decode_cache_misses() const { return decode_cache_misses_; }
 
   // The thread's top_exit_frame_info refers to a Dart frame in the simulator
   // stack. The simulator's top_exit_frame_info refers to a C++ frame in the
@@ -145,6 +146,7 @@ class Simulator {
   uword stack_base_;
   bool pc_modified_;
   uint64_t icount_;
+  uint64_t decode_cache_misses_;
   static int64_t flag_stop_sim_at_;
   SimulatorSetjmpBuffer* last_setjmp_buffer_;
   uword top_exit_frame_info_;
@@ -228,12 +230,28 @@ class Simulator {
 
   void DoRedirectedCall(Instr* instr);
 
-  // Decode instructions.
+  // Decode instructions. The groups DPImmediate, CompareBranch, LoadStore,
+  // DPRegister, DPSimd1, DPSimd2 and FP have no Decode function:
+  // ClassifyInstruction picks the Decode function within the group.
+  typedef void (Simulator::*DecodeFunction)(Instr* instr);
   void InstructionDecode(Instr* instr);
+  static DecodeFunction ClassifyInstruction(Instr* instr);
+  inline DecodeFunction LookupDecodeFunction(Instr* instr);
 #define DECODE_OP(op) void Decode##op(Instr* instr);
   APPLY_OP_LIST(DECODE_OP)
 #undef DECODE_OP
 
+  // Caches the Decode function of recently executed instructions, indexed by
+  // address. An entry is only used if the instruction bits are unchanged, so
+  // patched code needs no invalidation.
+  struct DecodeCacheEntry {
+    uword pc;
+    int32_t bits;
+    DecodeFunction decode;
+  };
+  static const intptr_t kDecodeCacheSize = 4096;
+  DecodeCacheEntry* decode_cache_;
+
   // Executes ARM64 instructions until the PC reaches kEndSimulatingPC.
   void Execute();
 
@@ -1005,6 +1005,20 @@ DART_NOINLINE static bool InvokeNative(Thread* thread,
 // Fetch next operation from PC, increment program counter and dispatch.
 #define DISPATCH() DISPATCH_OP(*pc++)
 
+// Dispatch at the end of test bytecodes, which skip the next instruction if
+// the test fails. Tests are almost always followed by Jumps (see
+// EmitBranchOnCondition), which are executed right away instead of going
+// through the dispatch table.
+#define DISPATCH_AFTER_TEST()                                                  \
+  do {                                                                         \
+    if (Bytecode::DecodeOpcode(*pc) == Bytecode::kJump) {                      \
+      op = *pc++;                                                              \
+      TRACE_INSTRUCTION                                                        \
+      pc += (static_cast<int32_t>(op) >> 8) - 1;                               \
+    }                                                                          \
+    DISPATCH();                                                                \
+  } while (0)
+
 // Define entry point that handles bytecode Name with the given operand format.
 #define BYTECODE(Name, Operands)                                               \
   BYTECODE_HEADER(Name, DECLARE_##Operands, DECODE_##Operands)
@@ -2930,20 +2944,12 @@ RawObject* Simulator::Call(const Code& code,
         }
       }
 
-      for (RawObject** entries = cache->ptr()->cache_->ptr()->data();
-           entries[0] != null_value;
-           entries += SubtypeTestCache::kTestEntryLength) {
-        if ((entries[SubtypeTestCache::kInstanceClassIdOrFunction] ==
-             instance_cid_or_function) &&
-            (entries[SubtypeTestCache::kInstanceTypeArguments] ==
-             instance_type_arguments) &&
-            (entries[SubtypeTestCache::kInstantiatorTypeArguments] ==
-             instantiator_type_arguments) &&
-            (entries[SubtypeTestCache::kFunctionTypeArguments] ==
-             function_type_arguments)) {
-          SP[-4] = entries[SubtypeTestCache::kTestResult];
-          goto InstanceOfOk;
-        }
+      RawObject** entry = SubtypeTestCache::LookupRaw(
+          cache, cid, instance_cid_or_function, instance_type_arguments,
+          instantiator_type_arguments, function_type_arguments);
+      if (entry != NULL) {
+        SP[-4] = entry[SubtypeTestCache::kTestResult];
+        goto InstanceOfOk;
       }
     }
 
@@ -3029,23 +3035,12 @@ RawObject* Simulator::Call(const Code& code,
           }
         }
 
-        for (RawObject** entries = cache->ptr()->cache_->ptr()->data();
-             entries[0] != null_value;
-             entries += SubtypeTestCache::kTestEntryLength) {
-          if ((entries[SubtypeTestCache::kInstanceClassIdOrFunction] ==
-               instance_cid_or_function) &&
-              (entries[SubtypeTestCache::kInstanceTypeArguments] ==
-               instance_type_arguments) &&
-              (entries[SubtypeTestCache::kInstantiatorTypeArguments] ==
-               instantiator_type_arguments) &&
-              (entries[SubtypeTestCache::kFunctionTypeArguments] ==
-               function_type_arguments)) {
-            if (true_value == entries[SubtypeTestCache::kTestResult]) {
-              goto AssertAssignableOk;
-            } else {
-              break;
-            }
-          }
+        RawObject** entry = SubtypeTestCache::LookupRaw(
+            cache, cid, instance_cid_or_function, instance_type_arguments,
+            instantiator_type_arguments, function_type_arguments);
+        if ((entry != NULL) &&
+            (true_value == entry[SubtypeTestCache::kTestResult])) {
+          goto AssertAssignableOk;
         }
       }
 
@@ -3127,7 +3122,7 @@ RawObject* Simulator::Call(const Code& code,
     if ((left & right) != 0) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3148,7 +3143,7 @@ RawObject* Simulator::Call(const Code& code,
       }
     }
     pc += num_cases;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3270,7 +3265,7 @@ RawObject* Simulator::Call(const Code& code,
     if (SP[1] != SP[2]) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3279,7 +3274,7 @@ RawObject* Simulator::Call(const Code& code,
     if (SP[1] == SP[2]) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3294,7 +3289,7 @@ RawObject* Simulator::Call(const Code& code,
     if (!SimulatorHelpers::IsStrictEqualWithNumberCheck(SP[1], SP[2])) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3309,7 +3304,7 @@ RawObject* Simulator::Call(const Code& code,
     if (SimulatorHelpers::IsStrictEqualWithNumberCheck(SP[1], SP[2])) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3320,7 +3315,7 @@ RawObject* Simulator::Call(const Code& code,
       pc++;
     }
     SP -= 2;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3331,7 +3326,7 @@ RawObject* Simulator::Call(const Code& code,
       pc++;
     }
     SP -= 2;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3342,7 +3337,7 @@ RawObject* Simulator::Call(const Code& code,
       pc++;
     }
     SP -= 2;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3353,7 +3348,7 @@ RawObject* Simulator::Call(const Code& code,
       pc++;
     }
     SP -= 2;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3363,7 +3358,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs != rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3373,7 +3368,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs == rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3383,7 +3378,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs > rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3393,7 +3388,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs >= rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3403,7 +3398,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs < rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3413,7 +3408,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs <= rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3423,7 +3418,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs > rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3433,7 +3428,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs >= rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3443,7 +3438,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs < rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3453,7 +3448,7 @@ RawObject* Simulator::Call(const Code& code,
     if (lhs <= rhs) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
 #if defined(ARCH_IS_64_BIT)
@@ -3462,7 +3457,7 @@ RawObject* Simulator::Call(const Code& code,
     const double lhs = bit_cast<double, RawObject*>(FP[rA]);
     const double rhs = bit_cast<double, RawObject*>(FP[rD]);
     pc += (lhs == rhs) ? 0 : 1;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3470,7 +3465,7 @@ RawObject* Simulator::Call(const Code& code,
     const double lhs = bit_cast<double, RawObject*>(FP[rA]);
     const double rhs = bit_cast<double, RawObject*>(FP[rD]);
     pc += (lhs != rhs) ? 0 : 1;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3478,7 +3473,7 @@ RawObject* Simulator::Call(const Code& code,
     const double lhs = bit_cast<double, RawObject*>(FP[rA]);
     const double rhs = bit_cast<double, RawObject*>(FP[rD]);
     pc += (lhs <= rhs) ? 0 : 1;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3486,7 +3481,7 @@ RawObject* Simulator::Call(const Code& code,
     const double lhs = bit_cast<double, RawObject*>(FP[rA]);
     const double rhs = bit_cast<double, RawObject*>(FP[rD]);
     pc += (lhs < rhs) ? 0 : 1;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3494,7 +3489,7 @@ RawObject* Simulator::Call(const Code& code,
     const double lhs = bit_cast<double, RawObject*>(FP[rA]);
     const double rhs = bit_cast<double, RawObject*>(FP[rD]);
     pc += (lhs >= rhs) ? 0 : 1;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3502,7 +3497,7 @@ RawObject* Simulator::Call(const Code& code,
     const double lhs = bit_cast<double, RawObject*>(FP[rA]);
     const double rhs = bit_cast<double, RawObject*>(FP[rD]);
     pc += (lhs > rhs) ? 0 : 1;
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 #else   // defined(ARCH_IS_64_BIT)
   {
@@ -3549,7 +3544,7 @@ RawObject* Simulator::Call(const Code& code,
     if (!SimulatorHelpers::IsStrictEqualWithNumberCheck(lhs, rhs)) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3559,7 +3554,7 @@ RawObject* Simulator::Call(const Code& code,
     if (SimulatorHelpers::IsStrictEqualWithNumberCheck(lhs, rhs)) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3567,7 +3562,7 @@ RawObject* Simulator::Call(const Code& code,
     if (FP[rA] != null_value) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
@@ -3575,7 +3570,7 @@ RawObject* Simulator::Call(const Code& code,
     if (FP[rA] == null_value) {
       pc++;
     }
-    DISPATCH();
+    DISPATCH_AFTER_TEST();
   }
 
   {
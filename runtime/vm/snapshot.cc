@@ -1136,9 +1136,7 @@ intptr_t ForwardList::AddObject(Zone* zone,
   intptr_t object_id = next_object_id();
   ASSERT(object_id > 0 && object_id <= kMaxObjectId);
   const Object& obj = Object::ZoneHandle(zone, raw);
-  Node* node = new Node(&obj, state);
-  ASSERT(node != NULL);
-  nodes_.Add(node);
+  nodes_.Add(Node(&obj, state));
   ASSERT(object_id != 0);
   heap()->SetObjectId(raw, object_id);
   return object_id;
@@ -41,6 +41,7 @@ class RawApiError;
 class RawArray;
 class RawBoundedType;
 class RawCapability;
+class RawTransferableTypedData;
 class RawClass;
 class RawClosure;
 class RawClosureData;
@@ -625,8 +626,11 @@ class ForwardList {
   explicit ForwardList(Thread* thread, intptr_t first_object_id);
   ~ForwardList();
 
-  class Node : public ZoneAllocated {
+  // Nodes are stored by value so that adding an object to the list does not
+  // need a separate allocation for its node.
+  class Node {
    public:
+    Node() : obj_(NULL), state_(kIsNotSerialized) {}
     Node(const Object* obj, SerializeState state) : obj_(obj), state_(state) {}
     const Object* obj() const { return obj_; }
     bool is_serialized() const { return state_ == kIsSerialized; }
@@ -639,11 +643,10 @@ class ForwardList {
     SerializeState state_;
 
     friend class ForwardList;
-    DISALLOW_COPY_AND_ASSIGN(Node);
   };
 
   Node* NodeForObjectId(intptr_t object_id) const {
-    return nodes_[object_id - first_object_id_];
+    return &nodes_[object_id - first_object_id_];
   }
 
   // Returns the id for the added object.
@@ -668,7 +671,7 @@ class ForwardList {
 
   Thread* thread_;
   const intptr_t first_object_id_;
-  GrowableArray<Node*> nodes_;
+  GrowableArray<Node> nodes_;
   intptr_t first_unprocessed_object_id_;
 
   DISALLOW_COPY_AND_ASSIGN(ForwardList);
@@ -119,10 +119,10 @@ static void CheckEncodeDecodeMessage(Dart_CObject* root) {
 
   ApiMessageReader api_reader(message);
   Dart_CObject* new_root = api_reader.ReadMessage();
-  delete message;
 
   // Check that the two messages are the same.
   CompareDartCObjects(root, new_root);
+  delete message;
 }
 
 static void ExpectEncodeFail(Dart_CObject* root) {
@@ -450,6 +450,102 @@ TEST_CASE(SerializeString) {
   // TODO(sgjesse): Add tests with non-BMP characters.
 }
 
+TEST_CASE(SerializeLargeString) {
+  const intptr_t kLength = 8 * KB;
+  char* cstr = reinterpret_cast<char*>(malloc(kLength + 1));
+  for (intptr_t i = 0; i < kLength; i++) {
+    cstr[i] = 'a' + (i % 26);
+  }
+  cstr[kLength] = '\0';
+  String& str = String::Handle(String::New(cstr));
+  EXPECT(str.IsOneByteString());
+
+  // A large string is received as an external string.
+  MessageWriter writer(true);
+  Message* message =
+      writer.WriteMessage(str, ILLEGAL_PORT, Message::kNormalPriority);
+  MessageSnapshotReader reader(message, thread);
+  String& received = String::Handle();
+  received ^= reader.ReadObject();
+  EXPECT(received.IsExternalOneByteString());
+  EXPECT(str.Equals(received));
+  delete message;
+
+  // Sending it on shares its characters.
+  MessageWriter resend_writer(true);
+  message = resend_writer.WriteMessage(received, ILLEGAL_PORT,
+                                       Message::kNormalPriority);
+  MessageSnapshotReader resend_reader(message, thread);
+  String& resent = String::Handle();
+  resent ^= resend_reader.ReadObject();
+  EXPECT(resent.IsExternalOneByteString());
+  EXPECT_EQ(received.GetPeer(), resent.GetPeer());
+  delete message;
+
+  // Read object back from the snapshot into a C structure.
+  MessageWriter api_writer(true);
+  message = api_writer.WriteMessage(resent, ILLEGAL_PORT,
+                                    Message::kNormalPriority);
+  {
+    ApiNativeScope scope;
+    ApiMessageReader api_reader(message);
+    Dart_CObject* root = api_reader.ReadMessage();
+    EXPECT_EQ(Dart_CObject_kString, root->type);
+    EXPECT_STREQ(cstr, root->value.as_string);
+  }
+  delete message;
+  free(cstr);
+}
+
+TEST_CASE(SerializeTransferableTypedDataAndLargeString) {
+  const intptr_t kDataLength = 16;
+  uint8_t* data = reinterpret_cast<uint8_t*>(malloc(kDataLength));
+  for (intptr_t i = 0; i < kDataLength; i++) {
+    data[i] = i * 3;
+  }
+  const intptr_t kStringLength = 8 * KB;
+  char* cstr = reinterpret_cast<char*>(malloc(kStringLength + 1));
+  for (intptr_t i = 0; i < kStringLength; i++) {
+    cstr[i] = 'a' + (i % 26);
+  }
+  cstr[kStringLength] = '\0';
+
+  // Both the transferable contents and the large string are passed out of
+  // line, in the order they are written.
+  const Array& array = Array::Handle(Array::New(3));
+  array.SetAt(0, TransferableTypedData::Handle(
+                     TransferableTypedData::New(data, kDataLength)));
+  array.SetAt(1, String::Handle(String::New(cstr)));
+  array.SetAt(2, Smi::Handle(Smi::New(42)));
+  MessageWriter writer(true);
+  Message* message =
+      writer.WriteMessage(array, ILLEGAL_PORT, Message::kNormalPriority);
+  {
+    ApiNativeScope scope;
+    ApiMessageReader api_reader(message);
+    Dart_CObject* root = api_reader.ReadMessage();
+    EXPECT_EQ(Dart_CObject_kArray, root->type);
+    EXPECT_EQ(3, root->value.as_array.length);
+    Dart_CObject* transferred = root->value.as_array.values[0];
+    EXPECT_EQ(Dart_CObject_kExternalTypedData, transferred->type);
+    EXPECT_EQ(Dart_TypedData_kUint8,
+              transferred->value.as_external_typed_data.type);
+    EXPECT_EQ(kDataLength, transferred->value.as_external_typed_data.length);
+    EXPECT(transferred->value.as_external_typed_data.data == data);
+    for (intptr_t i = 0; i < kDataLength; i++) {
+      EXPECT_EQ(i * 3, transferred->value.as_external_typed_data.data[i]);
+    }
+    Dart_CObject* str = root->value.as_array.values[1];
+    EXPECT_EQ(Dart_CObject_kString, str->type);
+    EXPECT_STREQ(cstr, str->value.as_string);
+    Dart_CObject* smi = root->value.as_array.values[2];
+    EXPECT_EQ(Dart_CObject_kInt32, smi->type);
+    EXPECT_EQ(42, smi->value.as_int32);
+  }
+  delete message;
+  free(cstr);
+}
+
 TEST_CASE(SerializeArray) {
   // Write snapshot with object content.
   const int kArrayLength = 10;
@@ -698,6 +794,71 @@ TEST_CASE(SerializeExternalTypedArray) {
   TEST_EXTERNAL_TYPED_ARRAY(Float64, double);
 }
 
+static intptr_t external_typed_data_finalized = 0;
+
+static void ExternalTypedDataFinalizer(void* isolate_callback_data,
+                                       Dart_WeakPersistentHandle handle,
+                                       void* peer) {
+  external_typed_data_finalized++;
+}
+
+TEST_CASE(SerializeExternalTypedDataByReference) {
+  uint8_t data[] = {0, 11, 22, 33, 44, 55, 66, 77};
+  const intptr_t length = ARRAY_SIZE(data);
+  Dart_CObject root;
+  root.type = Dart_CObject_kExternalTypedData;
+  root.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+  root.value.as_external_typed_data.length = length;
+  root.value.as_external_typed_data.data = data;
+  root.value.as_external_typed_data.peer = data;
+  root.value.as_external_typed_data.callback = ExternalTypedDataFinalizer;
+
+  external_typed_data_finalized = 0;
+  {
+    // The receiver sees the original buffer, finalized once it is done.
+    ApiMessageWriter writer;
+    Message* message =
+        writer.WriteCMessage(&root, ILLEGAL_PORT, Message::kNormalPriority);
+    ApiNativeScope scope;
+    {
+      ApiMessageReader api_reader(message);
+      Dart_CObject* received = api_reader.ReadMessage();
+      EXPECT_EQ(Dart_CObject_kExternalTypedData, received->type);
+      EXPECT_EQ(Dart_TypedData_kUint8,
+                received->value.as_external_typed_data.type);
+      EXPECT_EQ(length, received->value.as_external_typed_data.length);
+      EXPECT(received->value.as_external_typed_data.data == data);
+      EXPECT(received->value.as_external_typed_data.peer == data);
+      EXPECT_EQ(0, external_typed_data_finalized);
+    }
+    EXPECT_EQ(1, external_typed_data_finalized);
+    delete message;
+  }
+
+  external_typed_data_finalized = 0;
+  {
+    // The receiver takes ownership by clearing the callback.
+    ApiMessageWriter writer;
+    Message* message =
+        writer.WriteCMessage(&root, ILLEGAL_PORT, Message::kNormalPriority);
+    ApiNativeScope scope;
+    Dart_WeakPersistentHandleFinalizer callback = NULL;
+    void* peer = NULL;
+    {
+      ApiMessageReader api_reader(message);
+      Dart_CObject* received = api_reader.ReadMessage();
+      EXPECT_EQ(Dart_CObject_kExternalTypedData, received->type);
+      callback = received->value.as_external_typed_data.callback;
+      peer = received->value.as_external_typed_data.peer;
+      received->value.as_external_typed_data.callback = NULL;
+    }
+    EXPECT_EQ(0, external_typed_data_finalized);
+    callback(NULL, NULL, peer);
+    EXPECT_EQ(1, external_typed_data_finalized);
+    delete message;
+  }
+}
+
 TEST_CASE(SerializeEmptyByteArray) {
   // Write snapshot with object content.
   const int kTypedDataLength = 0;
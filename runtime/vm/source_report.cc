@@ -4,6 +4,7 @@
 #ifndef PRODUCT
 #include "vm/source_report.h"
 
+#include "vm/compiler/backend/block_coverage.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/isolate.h"
 #include "vm/object.h"
@@ -51,6 +52,10 @@ void SourceReport::Init(Thread* thread,
   start_pos_ = start_pos;
   end_pos_ = end_pos;
   ClearScriptTable();
+  block_coverage_.Clear();
+  if (IsReportRequested(kCoverage) && FLAG_optimized_coverage) {
+    InitBlockCoverage();
+  }
   if (IsReportRequested(kProfile)) {
     // Build the profile.
     SampleFilter samplesForIsolate(thread_->isolate()->main_port(),
@@ -195,6 +200,31 @@ void SourceReport::PrintCallSitesData(JSONObject* jsobj,
   }
 }
 
+void SourceReport::InitBlockCoverage() {
+  const GrowableObjectArray& records = GrowableObjectArray::Handle(
+      zone(), isolate()->object_store()->block_coverage_records());
+  if (records.IsNull()) {
+    return;
+  }
+  for (intptr_t i = 0; i < records.Length(); i++) {
+    Array& record = Array::ZoneHandle(zone());
+    record ^= records.At(i);
+    Function& function = Function::ZoneHandle(zone());
+    function ^= record.At(BlockCoverage::kFunctionIndex);
+    BlockCoverageEntry* entry =
+        new (zone()) BlockCoverageEntry(&function, &record);
+    BlockCoverageEntry* first = block_coverage_.LookupValue(&function);
+    if (first == NULL) {
+      block_coverage_.Insert(entry);
+    } else {
+      while (first->next != NULL) {
+        first = first->next;
+      }
+      first->next = entry;
+    }
+  }
+}
+
 void SourceReport::PrintCoverageData(JSONObject* jsobj,
                                      const Function& function,
                                      const Code& code) {
@@ -256,6 +286,30 @@ void SourceReport::PrintCoverageData(JSONObject* jsobj,
     }
   }
 
+  // Calls that only ran in optimized code.
+  Array& hits = Array::Handle(zone());
+  Array& positions = Array::Handle(zone());
+  Array& block_positions = Array::Handle(zone());
+  for (BlockCoverageEntry* entry = block_coverage_.LookupValue(&function);
+       entry != NULL; entry = entry->next) {
+    hits ^= entry->record->At(BlockCoverage::kHitsIndex);
+    positions ^= entry->record->At(BlockCoverage::kPositionsIndex);
+    for (intptr_t i = 0; i < hits.Length(); i++) {
+      if (hits.At(i) == Smi::New(0)) {
+        continue;
+      }
+      block_positions ^= positions.At(i);
+      for (intptr_t j = 0; j < block_positions.Length(); j++) {
+        const TokenPosition token_pos(
+            Smi::Value(Smi::RawCast(block_positions.At(j))));
+        if ((token_pos < begin_pos) || (token_pos > end_pos)) {
+          continue;
+        }
+        coverage[token_pos.Pos() - begin_pos.Pos()] = kCoverageHit;
+      }
+    }
+  }
+
   JSONObject cov(jsobj, "coverage");
   {
     JSONArray hits(&cov, "hits");
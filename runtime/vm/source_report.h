@@ -49,6 +49,7 @@ class SourceReport {
 
  private:
   void ClearScriptTable();
+  void InitBlockCoverage();
   void Init(Thread* thread,
             const Script* script,
             TokenPosition start_pos,
@@ -108,6 +109,35 @@ class SourceReport {
     }
   };
 
+  // The BlockCoverage records of one function, chained in the order they
+  // were registered.
+  struct BlockCoverageEntry : public ZoneAllocated {
+    BlockCoverageEntry(const Function* function, const Array* record)
+        : function(function), record(record), next(NULL) {}
+
+    const Function* function;
+    const Array* record;
+    BlockCoverageEntry* next;
+  };
+
+  struct BlockCoverageTrait {
+    typedef BlockCoverageEntry* Value;
+    typedef const Function* Key;
+    typedef BlockCoverageEntry* Pair;
+
+    static Key KeyOf(Pair kv) { return kv->function; }
+
+    static Value ValueOf(Pair kv) { return kv; }
+
+    static inline intptr_t Hashcode(Key key) {
+      return key->token_pos().value();
+    }
+
+    static inline bool IsKeyEqual(Pair kv, Key key) {
+      return kv->function->raw() == key->raw();
+    }
+  };
+
   intptr_t report_set_;
   CompileMode compile_mode_;
   Thread* thread_;
@@ -117,6 +147,7 @@ class SourceReport {
   Profile profile_;
   GrowableArray<ScriptTableEntry*> script_table_entries_;
   DirectChainedHashMap<ScriptTableTrait> script_table_;
+  DirectChainedHashMap<BlockCoverageTrait> block_coverage_;
   intptr_t next_script_index_;
 };
 
@@ -457,6 +457,42 @@ TEST_CASE(SourceReport_Coverage_AllFunctions_ForceCompile) {
   EXPECT_SUBSTRING("\"scriptIndex\":2", result);
 }
 
+TEST_CASE(SourceReport_Coverage_OptimizedCode) {
+  SetFlagScope<bool> sfs1(&FLAG_optimized_coverage, true);
+  SetFlagScope<int> sfs2(&FLAG_optimization_counter_threshold, 5);
+  SetFlagScope<bool> sfs3(&FLAG_background_compilation, false);
+  const char* kScript =
+      "helper0() {}\n"
+      "helper1() {}\n"
+      "work(int i) {\n"
+      "  if (i < 10) {\n"
+      "    helper0();\n"
+      "  } else {\n"
+      "    helper1();\n"
+      "  }\n"
+      "}\n"
+      "main() {\n"
+      "  for (int i = 0; i < 100; i++) work(i);\n"
+      "}";
+
+  Library& lib = Library::Handle();
+  lib ^= ExecuteScript(kScript);
+  ASSERT(!lib.IsNull());
+  const Script& script =
+      Script::Handle(lib.LookupScript(String::Handle(String::New("test-lib"))));
+
+  SourceReport report(SourceReport::kCoverage);
+  JSONStream js;
+  report.PrintJSON(&js, script);
+
+  // work is optimized before it first calls helper1, so the unoptimized code
+  // never counts that call.
+  EXPECT_SUBSTRING(
+      "\"startPos\":26,\"endPos\":101,\"compiled\":true,"
+      "\"coverage\":{\"hits\":[26,48,60,86],\"misses\":[]}",
+      js.ToCString());
+}
+
 TEST_CASE(SourceReport_CallSites_SimpleCall) {
   char buffer[1024];
   const char* kScript =
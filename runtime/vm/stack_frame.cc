@@ -140,11 +140,19 @@ void StackFrame::VisitObjectPointers(ObjectPointerVisitor* visitor) {
   if (!code.IsNull()) {
     // Optimized frames have a stack map. We need to visit the frame based
     // on the stack map.
-    Array maps;
-    maps = Array::null();
     StackMap map;
-    const uword start = Instructions::PayloadStart(code.instructions());
-    map = code.GetStackMap(pc() - start, &maps, &map);
+    StackMapCacheEntry* cached =
+        &stack_map_cache_[(pc() / kWordSize) & (kStackMapCacheSize - 1)];
+    if (cached->pc == pc()) {
+      map = cached->map;
+    } else {
+      Array maps;
+      maps = Array::null();
+      const uword start = Instructions::PayloadStart(code.instructions());
+      map = code.GetStackMap(pc() - start, &maps, &map);
+      cached->pc = pc();
+      cached->map = map.raw();
+    }
     if (!map.IsNull()) {
 #if !defined(TARGET_ARCH_DBC)
       if (is_interpreted()) {
@@ -139,9 +139,11 @@ class StackFrame : public ValueObject {
   explicit StackFrame(Thread* thread)
 #if defined(DART_USE_INTERPRETER)
       : fp_(0), sp_(0), pc_(0), thread_(thread), is_interpreted_(false) {
+    ClearStackMapCache();
   }
 #else
       : fp_(0), sp_(0), pc_(0), thread_(thread) {
+    ClearStackMapCache();
   }
 #endif
 
@@ -183,6 +185,12 @@ class StackFrame : public ValueObject {
     return raw_pc;
   }
 
+  void ClearStackMapCache() {
+    for (intptr_t i = 0; i < kStackMapCacheSize; i++) {
+      stack_map_cache_[i].pc = 0;
+    }
+  }
+
   uword fp_;
   uword sp_;
   uword pc_;
@@ -191,6 +199,16 @@ class StackFrame : public ValueObject {
   bool is_interpreted_;
 #endif
 
+  // Stack maps found by VisitObjectPointers, by return address. The frame
+  // object is reused for all frames of one walk of the stack by the GC, and
+  // deep recursive or async stacks return to the same few addresses.
+  struct StackMapCacheEntry {
+    uword pc;
+    RawStackMap* map;
+  };
+  static const intptr_t kStackMapCacheSize = 8;
+  StackMapCacheEntry stack_map_cache_[kStackMapCacheSize];
+
   // The iterators FrameSetIterator and StackFrameIterator set the private
   // fields fp_ and sp_ when they return the respective frame objects.
   friend class FrameSetIterator;
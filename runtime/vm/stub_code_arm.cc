@@ -1838,42 +1838,54 @@ void StubCode::GenerateDebugStepCheckStub(Assembler* assembler) {
 // Result in R1: null -> not found, otherwise result (true or false).
 static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
   ASSERT((n == 1) || (n == 2) || (n == 4));
-  if (n > 1) {
-    __ LoadClass(R8, R0, R4);
-    // Compute instance type arguments into R4.
-    Label has_no_type_arguments;
-    __ LoadObject(R4, Object::null_object());
-    __ ldr(R9, FieldAddress(
-                   R8, Class::type_arguments_field_offset_in_words_offset()));
-    __ CompareImmediate(R9, Class::kNoTypeArguments);
-    __ b(&has_no_type_arguments, EQ);
-    __ add(R9, R0, Operand(R9, LSL, 2));
-    __ ldr(R4, FieldAddress(R9, 0));
-    __ Bind(&has_no_type_arguments);
-  }
+  __ LoadClass(R8, R0, R4);
+  // Compute instance type arguments into R4.
+  Label has_no_type_arguments;
+  __ LoadObject(R4, Object::null_object());
+  __ ldr(R9, FieldAddress(
+                 R8, Class::type_arguments_field_offset_in_words_offset()));
+  __ CompareImmediate(R9, Class::kNoTypeArguments);
+  __ b(&has_no_type_arguments, EQ);
+  __ add(R9, R0, Operand(R9, LSL, 2));
+  __ ldr(R4, FieldAddress(R9, 0));
+  __ Bind(&has_no_type_arguments);
   __ LoadClassId(R8, R0);
   // R0: instance.
   // R2: instantiator type arguments (only if n == 4, can be raw_null).
   // R1: function type arguments (only if n == 4, can be raw_null).
   // R3: SubtypeTestCache.
   // R8: instance class id.
-  // R4: instance type arguments (null if none), used only if n > 1.
-  __ ldr(R3, FieldAddress(R3, SubtypeTestCache::cache_offset()));
-  __ AddImmediate(R3, Array::data_offset() - kHeapObjectTag);
+  // R4: instance type arguments (null if none).
 
-  Label loop, found, not_found, next_iteration;
-  // R3: entry start.
-  // R8: instance class id.
-  // R4: instance type arguments (still null if closure).
+  Label loop, found, not_found, next_iteration, compute_hash;
   __ SmiTag(R8);
+  // R9: Smi hash = class id * kSpreadFactor + instance type arguments hash,
+  // see SubtypeTestCache::Hash. The class id is kClosureCid for closures.
+  ASSERT(SubtypeTestCache::kSpreadFactor == 7);
+  __ mov(R9, Operand(R8, LSL, 3));
+  __ sub(R9, R9, Operand(R8));
   __ CompareImmediate(R8, Smi::RawValue(kClosureCid));
-  __ b(&loop, NE);
+  __ b(&compute_hash, NE);
   __ ldr(R4, FieldAddress(R0, Closure::function_type_arguments_offset()));
   __ CompareObject(R4, Object::null_object());
   __ b(&not_found, NE);  // Cache cannot be used for generic closures.
   __ ldr(R4, FieldAddress(R0, Closure::instantiator_type_arguments_offset()));
   __ ldr(R8, FieldAddress(R0, Closure::function_offset()));
   // R8: instance class id as Smi or function.
+  // R4: instance type arguments (of the closure if it is one), or null.
+  __ Bind(&compute_hash);
+  __ CompareObject(R4, Object::null_object());
+  __ ldr(IP, FieldAddress(R4, TypeArguments::hash_offset()), NE);
+  __ add(R9, R9, Operand(IP), NE);
+  __ ldr(IP, FieldAddress(R3, SubtypeTestCache::mask_offset()));
+  __ and_(R9, R9, Operand(IP));
+  __ ldr(R3, FieldAddress(R3, SubtypeTestCache::cache_offset()));
+  // R9: Smi index of the home entry, R3: cache array.
+  ASSERT(SubtypeTestCache::kTestEntryLength == 5);
+  __ add(R9, R9, Operand(R9, LSL, 2));
+  __ add(R3, R3, Operand(R9, LSL, 1));
+  __ AddImmediate(R3, Array::data_offset() - kHeapObjectTag);
+  // R3: entry start.
   __ Bind(&loop);
   __ ldr(R9,
          Address(R3, kWordSize * SubtypeTestCache::kInstanceClassIdOrFunction));
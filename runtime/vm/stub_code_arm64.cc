@@ -11,6 +11,7 @@
 #include "vm/dart_entry.h"
 #include "vm/heap/heap.h"
 #include "vm/instructions.h"
+#include "vm/megamorphic_cache_table.h"
 #include "vm/object_store.h"
 #include "vm/runtime_entry.h"
 #include "vm/stack_frame.h"
@@ -2083,42 +2084,56 @@ void StubCode::GenerateDebugStepCheckStub(Assembler* assembler) {
 // Result in R1: null -> not found, otherwise result (true or false).
 static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
   ASSERT((n == 1) || (n == 2) || (n == 4));
-  if (n > 1) {
-    __ LoadClass(R6, R0);
-    // Compute instance type arguments into R4.
-    Label has_no_type_arguments;
-    __ LoadObject(R4, Object::null_object());
-    __ LoadFieldFromOffset(
-        R5, R6, Class::type_arguments_field_offset_in_words_offset(), kWord);
-    __ CompareImmediate(R5, Class::kNoTypeArguments);
-    __ b(&has_no_type_arguments, EQ);
-    __ add(R5, R0, Operand(R5, LSL, 3));
-    __ LoadFieldFromOffset(R4, R5, 0);
-    __ Bind(&has_no_type_arguments);
-  }
+  __ LoadClass(R6, R0);
+  // Compute instance type arguments into R4.
+  Label has_no_type_arguments;
+  __ LoadObject(R4, Object::null_object());
+  __ LoadFieldFromOffset(
+      R5, R6, Class::type_arguments_field_offset_in_words_offset(), kWord);
+  __ CompareImmediate(R5, Class::kNoTypeArguments);
+  __ b(&has_no_type_arguments, EQ);
+  __ add(R5, R0, Operand(R5, LSL, 3));
+  __ LoadFieldFromOffset(R4, R5, 0);
+  __ Bind(&has_no_type_arguments);
   __ LoadClassId(R6, R0);
   // R0: instance.
   // R1: instantiator type arguments (only if n == 4, can be raw_null).
   // R2: function type arguments (only if n == 4, can be raw_null).
   // R3: SubtypeTestCache.
   // R6: instance class id.
-  // R4: instance type arguments (null if none), used only if n > 1.
-  __ LoadFieldFromOffset(R3, R3, SubtypeTestCache::cache_offset());
-  __ AddImmediate(R3, Array::data_offset() - kHeapObjectTag);
+  // R4: instance type arguments (null if none).
 
-  Label loop, found, not_found, next_iteration;
-  // R3: entry start.
-  // R6: instance class id.
-  // R4: instance type arguments (still null if closure).
+  Label loop, found, not_found, next_iteration, compute_hash, hashed;
   __ SmiTag(R6);
+  // R7: Smi hash = class id * kSpreadFactor + instance type arguments hash,
+  // see SubtypeTestCache::Hash. The class id is kClosureCid for closures.
+  ASSERT(SubtypeTestCache::kSpreadFactor == 7);
+  __ add(R7, R6, Operand(R6, LSL, 1));
+  __ add(R7, R6, Operand(R7, LSL, 1));
   __ CompareImmediate(R6, Smi::RawValue(kClosureCid));
-  __ b(&loop, NE);
+  __ b(&compute_hash, NE);
   __ LoadFieldFromOffset(R4, R0, Closure::function_type_arguments_offset());
   __ CompareObject(R4, Object::null_object());
   __ b(&not_found, NE);  // Cache cannot be used for generic closures.
   __ LoadFieldFromOffset(R4, R0, Closure::instantiator_type_arguments_offset());
   __ LoadFieldFromOffset(R6, R0, Closure::function_offset());
   // R6: instance class id as Smi or function.
+  // R4: instance type arguments (of the closure if it is one), or null.
+  __ Bind(&compute_hash);
+  __ CompareObject(R4, Object::null_object());
+  __ b(&hashed, EQ);
+  __ LoadFieldFromOffset(R5, R4, TypeArguments::hash_offset());
+  __ add(R7, R7, Operand(R5));
+  __ Bind(&hashed);
+  __ LoadFieldFromOffset(R5, R3, SubtypeTestCache::mask_offset());
+  __ and_(R7, R7, Operand(R5));
+  __ LoadFieldFromOffset(R3, R3, SubtypeTestCache::cache_offset());
+  // R7: Smi index of the home entry, R3: cache array.
+  ASSERT(SubtypeTestCache::kTestEntryLength == 5);
+  __ add(R7, R7, Operand(R7, LSL, 2));
+  __ add(R3, R3, Operand(R7, LSL, 2));
+  __ AddImmediate(R3, Array::data_offset() - kHeapObjectTag);
+  // R3: entry start.
   __ Bind(&loop);
   __ LoadFromOffset(R5, R3,
                     kWordSize * SubtypeTestCache::kInstanceClassIdOrFunction);
@@ -2623,6 +2638,30 @@ void StubCode::GenerateMegamorphicCallStub(Assembler* assembler) {
 
   Label cid_loaded;
   __ Bind(&cid_loaded);
+
+  // Try the row of this selector in the global dispatch table first.
+  const intptr_t base = Array::data_offset();
+  Label load_target, probe_cache;
+  __ ldr(R2, FieldAddress(R5, MegamorphicCache::dispatch_table_offset()));
+  __ CompareObject(R2, Object::null_object());
+  __ b(&probe_cache, EQ);
+  __ ldr(R1, FieldAddress(R5, MegamorphicCache::dispatch_row_offset()));
+  // R3: row + cid as a smi.
+  __ add(R3, R1, Operand(R0, LSL, 1));
+  // Unsigned compare of 2 * (row + cid) with the array length also catches
+  // negative indices.
+  __ ldr(R6, FieldAddress(R2, Array::length_offset()));
+  __ cmp(R6, Operand(R3, LSL, 1));
+  __ b(&probe_cache, LS);
+  // Entries are 16 bytes, so LSL 3. The entry belongs to this selector if it
+  // holds the same row.
+  ASSERT(MegamorphicCacheTable::kDispatchTableEntryLength == 2);
+  __ add(TMP, R2, Operand(R3, LSL, 3));
+  __ ldr(R6, FieldAddress(TMP, base));
+  __ CompareRegisters(R6, R1);
+  __ b(&load_target, EQ);
+
+  __ Bind(&probe_cache);
   __ ldr(R2, FieldAddress(R5, MegamorphicCache::buckets_offset()));
   __ ldr(R1, FieldAddress(R5, MegamorphicCache::mask_offset()));
   // R2: cache buckets array.
@@ -2642,7 +2681,6 @@ void StubCode::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ Bind(&loop);
   __ and_(R3, R3, Operand(R1));
 
-  const intptr_t base = Array::data_offset();
   // R3 is smi tagged, but table entries are 16 bytes, so LSL 3.
   __ add(TMP, R2, Operand(R3, LSL, 3));
   __ ldr(R6, FieldAddress(TMP, base));
@@ -2650,7 +2688,6 @@ void StubCode::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ CompareRegisters(R6, R0);
   __ b(&probe_failed, NE);
 
-  Label load_target;
   __ Bind(&load_target);
   // Call the target found in the cache.  For a class id match, this is a
   // proper target for the given name and arguments descriptor.  If the
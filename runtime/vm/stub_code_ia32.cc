@@ -1701,34 +1701,27 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
   const Immediate& raw_null =
       Immediate(reinterpret_cast<intptr_t>(Object::null()));
   __ movl(EAX, Address(ESP, kInstanceOffsetInBytes));
-  if (n > 1) {
-    __ LoadClass(ECX, EAX, EBX);
-    // Compute instance type arguments into EBX.
-    Label has_no_type_arguments;
-    __ movl(EBX, raw_null);
-    __ movl(EDI,
-            FieldAddress(ECX,
-                         Class::type_arguments_field_offset_in_words_offset()));
-    __ cmpl(EDI, Immediate(Class::kNoTypeArguments));
-    __ j(EQUAL, &has_no_type_arguments, Assembler::kNearJump);
-    __ movl(EBX, FieldAddress(EAX, EDI, TIMES_4, 0));
-    __ Bind(&has_no_type_arguments);
-  }
+  __ LoadClass(ECX, EAX, EBX);
+  // Compute instance type arguments into EBX.
+  Label has_no_type_arguments;
+  __ movl(EBX, raw_null);
+  __ movl(EDI,
+          FieldAddress(ECX,
+                       Class::type_arguments_field_offset_in_words_offset()));
+  __ cmpl(EDI, Immediate(Class::kNoTypeArguments));
+  __ j(EQUAL, &has_no_type_arguments, Assembler::kNearJump);
+  __ movl(EBX, FieldAddress(EAX, EDI, TIMES_4, 0));
+  __ Bind(&has_no_type_arguments);
   __ LoadClassId(ECX, EAX);
   // EAX: instance, ECX: instance class id.
-  // EBX: instance type arguments (null if none), used only if n > 1.
-  __ movl(EDX, Address(ESP, kCacheOffsetInBytes));
-  // EDX: SubtypeTestCache.
-  __ movl(EDX, FieldAddress(EDX, SubtypeTestCache::cache_offset()));
-  __ addl(EDX, Immediate(Array::data_offset() - kHeapObjectTag));
+  // EBX: instance type arguments (null if none).
 
-  Label loop, found, not_found, next_iteration;
-  // EDX: Entry start.
-  // ECX: instance class id.
-  // EBX: instance type arguments (still null if closure).
+  Label loop, found, not_found, next_iteration, compute_hash;
   __ SmiTag(ECX);
+  __ movl(EDX, ECX);
+  // EDX: class id used by the hash, kClosureCid for closures.
   __ cmpl(ECX, Immediate(Smi::RawValue(kClosureCid)));
-  __ j(NOT_EQUAL, &loop, Assembler::kNearJump);
+  __ j(NOT_EQUAL, &compute_hash, Assembler::kNearJump);
   __ movl(EBX, FieldAddress(EAX, Closure::function_type_arguments_offset()));
   __ cmpl(EBX, raw_null);  // Cache cannot be used for generic closures.
   __ j(NOT_EQUAL, &not_found, Assembler::kNearJump);
@@ -1736,6 +1729,27 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
           FieldAddress(EAX, Closure::instantiator_type_arguments_offset()));
   __ movl(ECX, FieldAddress(EAX, Closure::function_offset()));
   // ECX: instance class id as Smi or function.
+  // EBX: instance type arguments (of the closure if it is one), or null.
+  __ Bind(&compute_hash);
+  // EDX: Smi hash = class id * kSpreadFactor + instance type arguments hash,
+  // see SubtypeTestCache::Hash.
+  ASSERT(SubtypeTestCache::kSpreadFactor == 7);
+  __ leal(EDI, Address(EDX, EDX, TIMES_2, 0));
+  __ leal(EDX, Address(EDX, EDI, TIMES_2, 0));
+  Label hashed;
+  __ cmpl(EBX, raw_null);
+  __ j(EQUAL, &hashed, Assembler::kNearJump);
+  __ addl(EDX, FieldAddress(EBX, TypeArguments::hash_offset()));
+  __ Bind(&hashed);
+  __ movl(EDI, Address(ESP, kCacheOffsetInBytes));
+  // EDI: SubtypeTestCache.
+  __ andl(EDX, FieldAddress(EDI, SubtypeTestCache::mask_offset()));
+  __ movl(EDI, FieldAddress(EDI, SubtypeTestCache::cache_offset()));
+  // EDX: Smi index of the home entry, EDI: cache array.
+  ASSERT(SubtypeTestCache::kTestEntryLength == 5);
+  __ leal(EDX, Address(EDX, EDX, TIMES_4, 0));
+  __ leal(EDX, FieldAddress(EDI, EDX, TIMES_2, Array::data_offset()));
+  // EDX: Entry start.
   __ Bind(&loop);
   __ movl(EDI, Address(EDX, kWordSize *
                                 SubtypeTestCache::kInstanceClassIdOrFunction));
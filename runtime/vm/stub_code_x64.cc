@@ -17,6 +17,7 @@
 #include "vm/heap/heap.h"
 #include "vm/heap/scavenger.h"
 #include "vm/instructions.h"
+#include "vm/megamorphic_cache_table.h"
 #include "vm/object_store.h"
 #include "vm/resolver.h"
 #include "vm/stack_frame.h"
@@ -2031,33 +2032,26 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
   const Register kFunctionTypeArgumentsReg = RCX;
 
   __ LoadObject(R8, Object::null_object());
-  if (n > 1) {
-    __ LoadClass(R10, kInstanceReg);
-    // Compute instance type arguments into R13.
-    Label has_no_type_arguments;
-    __ movq(R13, R8);
-    __ movl(RDI,
-            FieldAddress(R10,
-                         Class::type_arguments_field_offset_in_words_offset()));
-    __ cmpl(RDI, Immediate(Class::kNoTypeArguments));
-    __ j(EQUAL, &has_no_type_arguments, Assembler::kNearJump);
-    __ movq(R13, FieldAddress(kInstanceReg, RDI, TIMES_8, 0));
-    __ Bind(&has_no_type_arguments);
-  }
+  __ LoadClass(R10, kInstanceReg);
+  // Compute instance type arguments into R13.
+  Label has_no_type_arguments;
+  __ movq(R13, R8);
+  __ movl(RDI,
+          FieldAddress(R10,
+                       Class::type_arguments_field_offset_in_words_offset()));
+  __ cmpl(RDI, Immediate(Class::kNoTypeArguments));
+  __ j(EQUAL, &has_no_type_arguments, Assembler::kNearJump);
+  __ movq(R13, FieldAddress(kInstanceReg, RDI, TIMES_8, 0));
+  __ Bind(&has_no_type_arguments);
   __ LoadClassId(R10, kInstanceReg);
   // RAX: instance, R10: instance class id.
-  // R13: instance type arguments or null, used only if n > 1.
-  __ movq(RSI, kCacheReg);
-  // RSI: SubtypeTestCache.
-  __ movq(RSI, FieldAddress(RSI, SubtypeTestCache::cache_offset()));
-  __ addq(RSI, Immediate(Array::data_offset() - kHeapObjectTag));
-  // RSI: Entry start.
-  // R10: instance class id.
-  // R13: instance type arguments (still null if closure).
-  Label loop, found, not_found, next_iteration;
+  // R13: instance type arguments or null.
+  Label loop, found, not_found, next_iteration, compute_hash;
   __ SmiTag(R10);
+  __ movq(RSI, R10);
+  // RSI: class id used by the hash, kClosureCid for closures.
   __ cmpq(R10, Immediate(Smi::RawValue(kClosureCid)));
-  __ j(NOT_EQUAL, &loop, Assembler::kNearJump);
+  __ j(NOT_EQUAL, &compute_hash, Assembler::kNearJump);
   __ movq(R13, FieldAddress(kInstanceReg,
                             Closure::function_type_arguments_offset()));
   __ cmpq(R13, R8);  // Cache cannot be used for generic closures.
@@ -2066,6 +2060,25 @@ static void GenerateSubtypeNTestCacheStub(Assembler* assembler, int n) {
                             Closure::instantiator_type_arguments_offset()));
   __ movq(R10, FieldAddress(kInstanceReg, Closure::function_offset()));
   // R10: instance class id as Smi or function.
+  // R13: instance type arguments (of the closure if it is one), or null.
+  __ Bind(&compute_hash);
+  // RSI: Smi hash = class id * kSpreadFactor + instance type arguments hash,
+  // see SubtypeTestCache::Hash.
+  ASSERT(SubtypeTestCache::kSpreadFactor == 7);
+  __ leaq(RDI, Address(RSI, RSI, TIMES_2, 0));
+  __ leaq(RSI, Address(RSI, RDI, TIMES_2, 0));
+  Label hashed;
+  __ cmpq(R13, R8);
+  __ j(EQUAL, &hashed, Assembler::kNearJump);
+  __ addq(RSI, FieldAddress(R13, TypeArguments::hash_offset()));
+  __ Bind(&hashed);
+  __ andq(RSI, FieldAddress(kCacheReg, SubtypeTestCache::mask_offset()));
+  __ movq(RDI, FieldAddress(kCacheReg, SubtypeTestCache::cache_offset()));
+  // RSI: Smi index of the home entry, RDI: cache array.
+  ASSERT(SubtypeTestCache::kTestEntryLength == 5);
+  __ leaq(RSI, Address(RSI, RSI, TIMES_4, 0));
+  __ leaq(RSI, FieldAddress(RDI, RSI, TIMES_4, Array::data_offset()));
+  // RSI: Entry start.
   __ Bind(&loop);
   __ movq(RDI, Address(RSI, kWordSize *
                                 SubtypeTestCache::kInstanceClassIdOrFunction));
@@ -2564,6 +2577,27 @@ void StubCode::GenerateMegamorphicCallStub(Assembler* assembler) {
 
   Label cid_loaded;
   __ Bind(&cid_loaded);
+
+  // Try the row of this selector in the global dispatch table first.
+  const intptr_t base = Array::data_offset();
+  Label load_target, probe_cache;
+  __ movq(RDI, FieldAddress(RBX, MegamorphicCache::dispatch_table_offset()));
+  __ CompareObject(RDI, Object::null_object());
+  __ j(EQUAL, &probe_cache, Assembler::kNearJump);
+  __ movq(R9, FieldAddress(RBX, MegamorphicCache::dispatch_row_offset()));
+  // RCX: row + cid as a smi. Entries are two words, so TIMES_8 below.
+  ASSERT(MegamorphicCacheTable::kDispatchTableEntryLength == 2);
+  __ leaq(RCX, Address(R9, RAX, TIMES_2, 0));
+  // Unsigned compare of 2 * (row + cid) with the array length also catches
+  // negative indices.
+  __ leaq(R13, Address(RCX, RCX, TIMES_1, 0));
+  __ cmpq(R13, FieldAddress(RDI, Array::length_offset()));
+  __ j(ABOVE_EQUAL, &probe_cache, Assembler::kNearJump);
+  // The entry belongs to this selector if it holds the same row.
+  __ cmpq(R9, FieldAddress(RDI, RCX, TIMES_8, base));
+  __ j(EQUAL, &load_target);
+
+  __ Bind(&probe_cache);
   __ movq(R9, FieldAddress(RBX, MegamorphicCache::mask_offset()));
   __ movq(RDI, FieldAddress(RBX, MegamorphicCache::buckets_offset()));
   // R9: mask as a smi.
@@ -2582,13 +2616,11 @@ void StubCode::GenerateMegamorphicCallStub(Assembler* assembler) {
   __ Bind(&loop);
   __ andq(RCX, R9);
 
-  const intptr_t base = Array::data_offset();
   // RCX is smi tagged, but table entries are two words, so TIMES_8.
   Label probe_failed;
   __ cmpq(RAX, FieldAddress(RDI, RCX, TIMES_8, base));
   __ j(NOT_EQUAL, &probe_failed, Assembler::kNearJump);
 
-  Label load_target;
   __ Bind(&load_target);
   // Call the target found in the cache.  For a class id match, this is a
   // proper target for the given name and arguments descriptor.  If the
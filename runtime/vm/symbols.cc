@@ -179,13 +179,23 @@ class SymbolTraits {
   static uword Hash(const ConcatString& concat) { return concat.Hash(); }
   template <typename CharType>
   static RawObject* NewKey(const CharArray<CharType>& array) {
-    return array.ToSymbol();
+    return Publish(array.ToSymbol());
   }
   static RawObject* NewKey(const StringSlice& slice) {
-    return slice.ToSymbol();
+    return Publish(slice.ToSymbol());
   }
   static RawObject* NewKey(const ConcatString& concat) {
-    return concat.ToSymbol();
+    return Publish(concat.ToSymbol());
+  }
+
+ private:
+  // New symbols are stored into the table with a plain store and may be
+  // found by threads that do not hold the symbols mutex (see
+  // Symbols::NewSymbol), so the string has to be fully initialized before
+  // the store becomes visible.
+  static RawObject* Publish(RawString* symbol) {
+    AtomicOperations::ThreadFence();
+    return symbol;
   }
 };
 typedef UnorderedHashSet<SymbolTraits> SymbolTable;
@@ -543,6 +553,29 @@ RawString* Symbols::FromConcatAll(
   }
 }
 
+// Probes the isolate's symbol table without taking the symbols mutex.
+//
+// This is safe because the table only changes in ways a concurrent reader
+// can tolerate: symbols are added to unused slots after being fully
+// initialized (see SymbolTraits::NewKey), a grown table is a fresh array
+// that is filled in before it is published, and entries are only ever
+// removed by Symbols::Compact, which runs while no other thread can be
+// interning symbols. GC cannot run during the probe since the thread is not
+// at a safepoint. A NULL result may be stale and has to be confirmed under
+// the mutex.
+template <typename StringType>
+static RawString* LookupUnlocked(Thread* thread,
+                                 const StringType& str,
+                                 dart::Object* key,
+                                 Smi* value,
+                                 Array* data) {
+  *data ^= thread->isolate()->object_store()->symbol_table();
+  SymbolTable table(key, value, data);
+  RawString* symbol = String::RawCast(table.GetOrNull(str));
+  table.Release();
+  return symbol;
+}
+
 // StringType can be StringSlice, ConcatString, or {Latin1,UTF16,UTF32}Array.
 template <typename StringType>
 RawString* Symbols::NewSymbol(Thread* thread, const StringType& str) {
@@ -560,12 +593,17 @@ RawString* Symbols::NewSymbol(Thread* thread, const StringType& str) {
     symbol ^= table.GetOrNull(str);
     table.Release();
   }
+  if (symbol.IsNull()) {
+    symbol ^= LookupUnlocked(thread, str, &key, &value, &data);
+  }
   if (symbol.IsNull()) {
     Isolate* isolate = thread->isolate();
     SafepointMutexLocker ml(isolate->symbols_mutex());
     data ^= isolate->object_store()->symbol_table();
     SymbolTable table(&key, &value, &data);
     symbol ^= table.InsertNewOrGet(str);
+    // A grown table is filled in before it is published.
+    AtomicOperations::ThreadFence();
     isolate->object_store()->set_symbol_table(table.Release());
   }
   ASSERT(symbol.IsSymbol());
@@ -590,6 +628,10 @@ RawString* Symbols::Lookup(Thread* thread, const StringType& str) {
     table.Release();
   }
   if (symbol.IsNull()) {
+    symbol ^= LookupUnlocked(thread, str, &key, &value, &data);
+  }
+  if (symbol.IsNull()) {
+    // The symbol may have been added while we were probing a stale table.
     Isolate* isolate = thread->isolate();
     SafepointMutexLocker ml(isolate->symbols_mutex());
     data ^= isolate->object_store()->symbol_table();
@@ -91,6 +91,9 @@ class ObjectPointerVisitor;
   V(StringBase, "_StringBase")                                                 \
   V(Interpolate, "_interpolate")                                               \
   V(InterpolateSingle, "_interpolateSingle")                                   \
+  V(Interpolate2, "_interpolate2")                                             \
+  V(Interpolate3, "_interpolate3")                                             \
+  V(Interpolate4, "_interpolate4")                                             \
   V(Iterator, "iterator")                                                      \
   V(NoSuchMethod, "noSuchMethod")                                              \
   V(ArgDescVar, ":arg_desc")                                                   \
@@ -229,6 +232,7 @@ class ObjectPointerVisitor;
   V(ExternalOneByteString, "_ExternalOneByteString")                           \
   V(ExternalTwoByteString, "_ExternalTwoByteString")                           \
   V(_CapabilityImpl, "_CapabilityImpl")                                        \
+  V(_TransferableTypedDataImpl, "_TransferableTypedDataImpl")                  \
   V(_RawReceivePortImpl, "_RawReceivePortImpl")                                \
   V(_SendPortImpl, "_SendPortImpl")                                            \
   V(_StackTrace, "_StackTrace")                                                \
@@ -332,6 +336,7 @@ class ObjectPointerVisitor;
   V(toString, "toString")                                                      \
   V(_lookupHandler, "_lookupHandler")                                          \
   V(_handleMessage, "_handleMessage")                                          \
+  V(_handleMessages, "_handleMessages")                                        \
   V(DotCreate, "._create")                                                     \
   V(DotWithType, "._withType")                                                 \
   V(_get, "_get")                                                              \
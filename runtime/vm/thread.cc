@@ -7,6 +7,7 @@
 #include "vm/compiler_stats.h"
 #include "vm/dart_api_state.h"
 #include "vm/growable_array.h"
+#include "vm/heap/heap.h"
 #include "vm/isolate.h"
 #include "vm/json_stream.h"
 #include "vm/lockers.h"
@@ -38,13 +39,24 @@ Thread::~Thread() {
   }
   // There should be no top api scopes at this point.
   ASSERT(api_top_scope() == NULL);
-  // Delete the resusable api scope if there is one.
-  if (api_reusable_scope_) {
-    delete api_reusable_scope_;
-    api_reusable_scope_ = NULL;
+  // Delete the reusable api scopes.
+  while (api_reusable_scope_ != NULL) {
+    ApiLocalScope* scope = api_reusable_scope_;
+    api_reusable_scope_ = scope->previous();
+    delete scope;
+  }
+  api_reusable_scope_count_ = 0;
+  free(reinterpret_cast<void*>(reusable_assembler_buffer_));
+  reusable_assembler_buffer_ = 0;
+  if (cached_store_buffer_block_ != NULL) {
+    StoreBuffer::PushEmptyBlock(cached_store_buffer_block_);
+    cached_store_buffer_block_ = NULL;
   }
   delete thread_lock_;
   thread_lock_ = NULL;
+  // Last, since deleting the api scope above may free zone segments.
+  delete zone_segment_cache_;
+  zone_segment_cache_ = NULL;
 }
 
 #if defined(DEBUG)
@@ -70,6 +82,7 @@ Thread::Thread(Isolate* isolate)
       task_kind_(kUnknownTask),
       async_stack_trace_(StackTrace::null()),
       unboxed_int64_runtime_arg_(0),
+      marking_active_(0),
       dart_stream_(NULL),
       os_thread_(NULL),
       thread_lock_(new Monitor()),
@@ -77,6 +90,10 @@ Thread::Thread(Isolate* isolate)
       current_zone_capacity_(0),
       zone_high_watermark_(0),
       api_reusable_scope_(NULL),
+      api_reusable_scope_count_(0),
+      reusable_assembler_buffer_(0),
+      reusable_assembler_buffer_capacity_(0),
+      cached_store_buffer_block_(NULL),
       api_top_scope_(NULL),
       top_resource_(NULL),
       long_jump_base_(NULL),
@@ -92,6 +109,8 @@ Thread::Thread(Isolate* isolate)
       deferred_interrupts_mask_(0),
       deferred_interrupts_(0),
       stack_overflow_count_(0),
+      old_top_(0),
+      old_end_(0),
       cha_(NULL),
       hierarchy_info_(NULL),
       type_usage_info_(NULL),
@@ -102,6 +121,7 @@ Thread::Thread(Isolate* isolate)
       resume_pc_(0),
       sticky_error_(Error::null()),
       compiler_stats_(NULL),
+      zone_segment_cache_(NULL),
       REUSABLE_HANDLE_LIST(REUSABLE_HANDLE_INITIALIZERS)
           REUSABLE_HANDLE_LIST(REUSABLE_HANDLE_SCOPE_INIT) safepoint_state_(0),
       execution_state_(kThreadInNative),
@@ -288,6 +308,14 @@ const char* Thread::TaskKindToCString(TaskKind kind) {
       return "kSweeperTask";
     case kMarkerTask:
       return "kMarkerTask";
+    case kCompactorTask:
+      return "kCompactorTask";
+    case kScavengerTask:
+      return "kScavengerTask";
+    case kBecomeTask:
+      return "kBecomeTask";
+    case kDeserializerTask:
+      return "kDeserializerTask";
     default:
       UNREACHABLE();
       return "";
@@ -333,6 +361,7 @@ void Thread::ExitIsolate() {
   ASSERT(thread->execution_state() == Thread::kThreadInVM);
   // Clear since GC will not visit the thread once it is unscheduled.
   thread->ClearReusableHandles();
+  thread->ReleaseOldAllocationBuffer();
   thread->StoreBufferRelease();
   if (isolate->is_runnable()) {
     thread->set_vm_tag(VMTag::kIdleTagId);
@@ -343,6 +372,12 @@ void Thread::ExitIsolate() {
   isolate->UnscheduleThread(thread, kIsMutatorThread);
 }
 
+static bool IsGCTask(Thread::TaskKind kind) {
+  return (kind == Thread::kMarkerTask) || (kind == Thread::kSweeperTask) ||
+         (kind == Thread::kCompactorTask) || (kind == Thread::kScavengerTask) ||
+         (kind == Thread::kBecomeTask);
+}
+
 bool Thread::EnterIsolateAsHelper(Isolate* isolate,
                                   TaskKind kind,
                                   bool bypass_safepoint) {
@@ -354,11 +389,20 @@ bool Thread::EnterIsolateAsHelper(Isolate* isolate,
     ASSERT(thread->store_buffer_block_ == NULL);
     // TODO(koda): Use StoreBufferAcquire once we properly flush
     // before Scavenge.
-    thread->store_buffer_block_ =
-        thread->isolate()->store_buffer()->PopEmptyBlock();
+    if (thread->cached_store_buffer_block_ != NULL) {
+      thread->store_buffer_block_ = thread->cached_store_buffer_block_;
+      thread->cached_store_buffer_block_ = NULL;
+    } else {
+      thread->store_buffer_block_ =
+          thread->isolate()->store_buffer()->PopEmptyBlock();
+    }
     // This thread should not be the main mutator.
     thread->task_kind_ = kind;
     ASSERT(!thread->IsMutatorThread());
+    if (FLAG_numa_aware_heap && IsGCTask(kind)) {
+      // Keep GC helpers next to the memory they work on.
+      OSThread::SetCurrentNumaAffinity(isolate->heap()->numa_node());
+    }
     return true;
   }
   return false;
@@ -369,18 +413,42 @@ void Thread::ExitIsolateAsHelper(bool bypass_safepoint) {
   ASSERT(thread != NULL);
   ASSERT(!thread->IsMutatorThread());
   ASSERT(thread->execution_state() == Thread::kThreadInVM);
+  if (FLAG_numa_aware_heap && IsGCTask(thread->task_kind_)) {
+    // The pool thread may next run a task for an isolate on another node.
+    OSThread::RestoreCurrentAffinity();
+  }
   thread->task_kind_ = kUnknownTask;
   // Clear since GC will not visit the thread once it is unscheduled.
   thread->ClearReusableHandles();
-  thread->StoreBufferRelease();
+  thread->ReleaseOldAllocationBuffer();
+  // Most helper tasks store no pointers into old objects. Their empty block
+  // stays with the thread object for the next task, which saves taking the
+  // global block lock twice.
+  if (thread->store_buffer_block_->IsEmpty()) {
+    ASSERT(thread->cached_store_buffer_block_ == NULL);
+    thread->cached_store_buffer_block_ = thread->store_buffer_block_;
+    thread->store_buffer_block_ = NULL;
+  } else {
+    thread->StoreBufferRelease();
+  }
   Isolate* isolate = thread->isolate();
   ASSERT(isolate != NULL);
   const bool kIsNotMutatorThread = false;
   isolate->UnscheduleThread(thread, kIsNotMutatorThread, bypass_safepoint);
 }
 
+void Thread::ReleaseOldAllocationBuffer() {
+  if (old_top_ < old_end_) {
+    heap()->old_space()->AbandonThreadBuffer(old_top_, old_end_ - old_top_);
+  }
+  old_top_ = 0;
+  old_end_ = 0;
+}
+
 void Thread::PrepareForGC() {
   ASSERT(IsAtSafepoint());
+  // The collector cannot walk the unused part of the buffer.
+  ReleaseOldAllocationBuffer();
   // Prevent scheduling another GC by ignoring the threshold.
   ASSERT(store_buffer_block_ != NULL);
   StoreBufferRelease(StoreBuffer::kIgnoreThreshold);
@@ -471,6 +539,49 @@ void Thread::SetHighWatermark(intptr_t value) {
 #endif
 }
 
+ApiLocalScope* Thread::AllocateApiScope(ApiLocalScope* previous,
+                                        uword stack_marker) {
+  ApiLocalScope* scope = api_reusable_scope_;
+  if (scope == NULL) {
+    return new ApiLocalScope(previous, stack_marker);
+  }
+  api_reusable_scope_ = scope->previous();
+  api_reusable_scope_count_--;
+  scope->Reinit(this, previous, stack_marker);
+  return scope;
+}
+
+void Thread::FreeApiScope(ApiLocalScope* scope) {
+  ASSERT(scope != api_reusable_scope_);
+  if (api_reusable_scope_count_ >= kMaxReusableApiScopes) {
+    delete scope;
+    return;
+  }
+  scope->Reset(this);
+  scope->set_previous(api_reusable_scope_);
+  api_reusable_scope_ = scope;
+  api_reusable_scope_count_++;
+}
+
+uword Thread::TakeAssemblerBuffer(intptr_t* capacity) {
+  uword buffer = reusable_assembler_buffer_;
+  *capacity = reusable_assembler_buffer_capacity_;
+  reusable_assembler_buffer_ = 0;
+  reusable_assembler_buffer_capacity_ = 0;
+  return buffer;
+}
+
+void Thread::ReleaseAssemblerBuffer(uword buffer, intptr_t capacity) {
+  if ((capacity > kMaxReusableAssemblerBufferCapacity) ||
+      (capacity <= reusable_assembler_buffer_capacity_)) {
+    free(reinterpret_cast<void*>(buffer));
+    return;
+  }
+  free(reinterpret_cast<void*>(reusable_assembler_buffer_));
+  reusable_assembler_buffer_ = buffer;
+  reusable_assembler_buffer_capacity_ = capacity;
+}
+
 void Thread::DeferOOBMessageInterrupts() {
   MonitorLocker ml(thread_lock_);
   defer_oob_messages_count_++;
@@ -530,6 +641,9 @@ RawError* Thread::HandleInterrupts() {
       }
       heap()->CollectGarbage(Heap::kNew);
     }
+    if (heap()->pretenuring_feedback()->HasRevertedClasses()) {
+      heap()->pretenuring_feedback()->DisableRevertedCode(this);
+    }
   }
   if ((interrupt_bits & kMessageInterrupt) != 0) {
     MessageHandler::MessageStatus status =
@@ -58,6 +58,7 @@ class TypeArguments;
 class TypeParameter;
 class TypeUsageInfo;
 class Zone;
+class ZoneSegmentCache;
 
 #define REUSABLE_HANDLE_LIST(V)                                                \
   V(AbstractType)                                                              \
@@ -205,6 +206,9 @@ class Thread : public BaseThread {
     kMarkerTask = 0x4,
     kSweeperTask = 0x8,
     kCompactorTask = 0x10,
+    kScavengerTask = 0x20,
+    kBecomeTask = 0x40,
+    kDeserializerTask = 0x80,
   };
   // Converts a TaskKind to its corresponding C-String name.
   static const char* TaskKindToCString(TaskKind kind);
@@ -336,12 +340,20 @@ class Thread : public BaseThread {
 
   void SetHighWatermark(intptr_t value);
 
-  // The reusable api local scope for this thread.
-  ApiLocalScope* api_reusable_scope() const { return api_reusable_scope_; }
-  void set_api_reusable_scope(ApiLocalScope* value) {
-    ASSERT(value == NULL || api_reusable_scope_ == NULL);
-    api_reusable_scope_ = value;
-  }
+  // Exited api local scopes are kept for reuse, so that entering nested
+  // scopes does not allocate. At most kMaxReusableApiScopes are kept.
+  static const intptr_t kMaxReusableApiScopes = 8;
+  ApiLocalScope* AllocateApiScope(ApiLocalScope* previous,
+                                  uword stack_marker);
+  void FreeApiScope(ApiLocalScope* scope);
+
+  // The malloced data area of the last AssemblerBuffer is kept for the next
+  // compilation on this thread. Take returns 0 if there is none. Release
+  // keeps the larger of two buffers, up to
+  // kMaxReusableAssemblerBufferCapacity.
+  static const intptr_t kMaxReusableAssemblerBufferCapacity = 1 * MB;
+  uword TakeAssemblerBuffer(intptr_t* capacity);
+  void ReleaseAssemblerBuffer(uword buffer, intptr_t capacity);
 
   // The api local scope for this thread, this where all local handles
   // are allocated.
@@ -424,6 +436,27 @@ class Thread : public BaseThread {
     return OFFSET_OF(Thread, store_buffer_block_);
   }
 
+  // Whether the old generation is being marked concurrently. While it is,
+  // stores of old objects into old objects must be recorded as well.
+  bool is_marking() const { return marking_active_ != 0; }
+  void set_is_marking(bool value) { marking_active_ = value ? 1 : 0; }
+  static intptr_t marking_active_offset() {
+    return OFFSET_OF(Thread, marking_active_);
+  }
+
+  // Chunk of an old space data page this thread bump allocates from, see
+  // PageSpace::TryAllocateInThreadBuffer. The unused rest is returned to the
+  // page space before every collection and heap iteration, and when the
+  // thread leaves the isolate.
+  uword old_top() const { return old_top_; }
+  uword old_end() const { return old_end_; }
+  void set_old_top(uword value) { old_top_ = value; }
+  void set_old_allocation_buffer(uword top, uword end) {
+    old_top_ = top;
+    old_end_ = end;
+  }
+  void ReleaseOldAllocationBuffer();
+
   uword top_exit_frame_info() const { return top_exit_frame_info_; }
   void set_top_exit_frame_info(uword top_exit_frame_info) {
     top_exit_frame_info_ = top_exit_frame_info;
@@ -621,6 +654,8 @@ class Thread : public BaseThread {
 
   CompilerStats* compiler_stats() { return compiler_stats_; }
 
+  ZoneSegmentCache* zone_segment_cache() const { return zone_segment_cache_; }
+
 #if defined(DEBUG)
 #define REUSABLE_HANDLE_SCOPE_ACCESSORS(object)                                \
   void set_reusable_##object##_handle_scope_active(bool value) {               \
@@ -831,13 +866,19 @@ class Thread : public BaseThread {
   LEAF_RUNTIME_ENTRY_LIST(DECLARE_MEMBERS)
 #undef DECLARE_MEMBERS
 
+  uword marking_active_;
   TimelineStream* dart_stream_;
   OSThread* os_thread_;
   Monitor* thread_lock_;
   Zone* zone_;
   uintptr_t current_zone_capacity_;
   uintptr_t zone_high_watermark_;
-  ApiLocalScope* api_reusable_scope_;
+  ApiLocalScope* api_reusable_scope_;  // Chained through previous().
+  intptr_t api_reusable_scope_count_;
+  uword reusable_assembler_buffer_;
+  intptr_t reusable_assembler_buffer_capacity_;
+  // An empty store buffer block kept by a helper thread between tasks.
+  StoreBufferBlock* cached_store_buffer_block_;
   ApiLocalScope* api_top_scope_;
   StackResource* top_resource_;
   LongJumpScope* long_jump_base_;
@@ -853,6 +894,8 @@ class Thread : public BaseThread {
   uint16_t deferred_interrupts_mask_;
   uint16_t deferred_interrupts_;
   int32_t stack_overflow_count_;
+  uword old_top_;
+  uword old_end_;
 
   // Compiler state:
   CHA* cha_;
@@ -869,6 +912,9 @@ class Thread : public BaseThread {
   RawError* sticky_error_;
 
   CompilerStats* compiler_stats_;
+  // Free zone segments kept for zones created on this thread; see
+  // Zone::InitOnce.
+  ZoneSegmentCache* zone_segment_cache_;
 
 // Reusable handles support.
 #define REUSABLE_HANDLE_FIELDS(object) object* object##_handle_;
@@ -926,6 +972,7 @@ class Thread : public BaseThread {
   friend class Simulator;
   friend class StackZone;
   friend class ThreadRegistry;
+  friend class Zone;
   DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
@@ -9,6 +9,7 @@
 
 #include "vm/flags.h"
 #include "vm/os.h"
+#include "vm/perf_counters.h"
 #include "vm/profiler.h"
 #include "vm/signal_handler.h"
 #include "vm/thread_interrupter.h"
@@ -28,10 +29,20 @@ class ThreadInterrupterLinux : public AllStatic {
     if (signal != SIGPROF) {
       return;
     }
+    const bool counter_overflow =
+        (info->si_code == POLL_IN) || (info->si_code == POLL_HUP);
+    if (counter_overflow) {
+      PerfCounters::RearmSampling(info->si_fd);
+    }
     Thread* thread = Thread::Current();
     if (thread == NULL) {
       return;
     }
+    if (counter_overflow && !thread->os_thread()->ThreadInterruptsEnabled()) {
+      // Unlike the timer, the counter keeps running while interrupts are
+      // disabled.
+      return;
+    }
     // Extract thread state.
     ucontext_t* context = reinterpret_cast<ucontext_t*>(context_);
     mcontext_t mcontext = context->uc_mcontext;
@@ -54,6 +65,11 @@ void ThreadInterrupter::InterruptThread(OSThread* thread) {
     OS::PrintErr("ThreadInterrupter interrupting %p\n",
                  reinterpret_cast<void*>(thread->id()));
   }
+  if (PerfCounters::SamplingEnabled()) {
+    // The counter of the thread interrupts it from now on.
+    PerfCounters::StartSampling(thread);
+    return;
+  }
   int result = pthread_kill(thread->id(), SIGPROF);
   ASSERT((result == 0) || (result == ESRCH));
 }
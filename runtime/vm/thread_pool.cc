@@ -4,6 +4,7 @@
 
 #include "vm/thread_pool.h"
 
+#include "platform/atomic.h"
 #include "vm/dart.h"
 #include "vm/flags.h"
 #include "vm/lockers.h"
@@ -14,6 +15,11 @@ DEFINE_FLAG(int,
             worker_timeout_millis,
             5000,
             "Free workers when they have been idle for this amount of time.");
+DEFINE_FLAG(int,
+            worker_spin_micros,
+            20,
+            "Idle workers spin for this amount of time waiting for a new task "
+            "before they block.");
 
 ThreadPool::ThreadPool()
     : shutting_down_(false),
@@ -30,7 +36,7 @@ ThreadPool::~ThreadPool() {
   Shutdown();
 }
 
-bool ThreadPool::Run(Task* task) {
+bool ThreadPool::Run(Task* task, const void* affinity) {
   Worker* worker = NULL;
   bool new_worker = false;
   {
@@ -52,13 +58,11 @@ bool ThreadPool::Run(Task* task) {
       worker->owned_ = true;
       count_running_++;
     } else {
-      // Get the first worker from the idle worker list.
-      worker = idle_workers_;
-      idle_workers_ = worker->idle_next_;
-      worker->idle_next_ = NULL;
+      worker = TakeIdleWorkerLocked(affinity);
       count_idle_--;
       count_running_++;
     }
+    worker->last_affinity_ = affinity;
   }
 
   // Release ThreadPool::mutex_ before calling Worker functions.
@@ -176,6 +180,27 @@ bool ThreadPool::RemoveWorkerFromIdleList(Worker* worker) {
   return false;
 }
 
+ThreadPool::Worker* ThreadPool::TakeIdleWorkerLocked(const void* affinity) {
+  ASSERT(mutex_.IsOwnedByCurrentThread());
+  ASSERT(idle_workers_ != NULL);
+  if (affinity != NULL) {
+    for (Worker* current = idle_workers_; current != NULL;
+         current = current->idle_next_) {
+      if (current->last_affinity_ == affinity) {
+        bool found = RemoveWorkerFromIdleList(current);
+        ASSERT(found);
+        return current;
+      }
+    }
+  }
+  // Otherwise take the most recently idled worker, which is the most likely
+  // to still be spinning.
+  Worker* worker = idle_workers_;
+  idle_workers_ = worker->idle_next_;
+  worker->idle_next_ = NULL;
+  return worker;
+}
+
 bool ThreadPool::RemoveWorkerFromAllList(Worker* worker) {
   ASSERT(worker != NULL && worker->owned_);
   if (all_workers_ == NULL) {
@@ -320,6 +345,7 @@ ThreadPool::Worker::Worker(ThreadPool* pool)
       owned_(false),
       all_next_(NULL),
       idle_next_(NULL),
+      last_affinity_(NULL),
       shutdown_next_(NULL) {}
 
 ThreadId ThreadPool::Worker::id() {
@@ -368,6 +394,20 @@ static int64_t ComputeTimeout(int64_t idle_start) {
   }
 }
 
+void ThreadPool::Worker::SpinForTask() {
+  if (FLAG_worker_spin_micros <= 0) {
+    return;
+  }
+  // Handing a task to a spinning worker avoids the cost of parking and
+  // waking up its thread when tasks arrive in quick succession.
+  const int64_t spin_end =
+      OS::GetCurrentMonotonicMicros() + FLAG_worker_spin_micros;
+  while ((AtomicOperations::LoadRelaxed(&task_) == NULL) &&
+         !AtomicOperations::LoadRelaxed(&done_) &&
+         (OS::GetCurrentMonotonicMicros() < spin_end)) {
+  }
+}
+
 bool ThreadPool::Worker::Loop() {
   MonitorLocker ml(&monitor_);
   int64_t idle_start;
@@ -390,17 +430,20 @@ bool ThreadPool::Worker::Loop() {
     ASSERT(!done_);
     pool_->SetIdleAndReapExited(this);
     idle_start = OS::GetCurrentMonotonicMicros();
-    while (true) {
-      Monitor::WaitResult result = ml.WaitMicros(ComputeTimeout(idle_start));
-      if (task_ != NULL) {
-        // We've found a task.  Process it, regardless of whether the
-        // worker is done_.
-        break;
-      }
+
+    ml.Exit();
+    SpinForTask();
+    ml.Enter();
+
+    // If we've found a task, process it regardless of whether the worker is
+    // done_.
+    while (task_ == NULL) {
       if (IsDone()) {
         return false;
       }
-      if ((result == Monitor::kTimedOut) && pool_->ReleaseIdleWorker(this)) {
+      Monitor::WaitResult result = ml.WaitMicros(ComputeTimeout(idle_start));
+      if ((task_ == NULL) && !IsDone() && (result == Monitor::kTimedOut) &&
+          pool_->ReleaseIdleWorker(this)) {
         return true;
       }
     }
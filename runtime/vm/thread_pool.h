@@ -35,7 +35,11 @@ class ThreadPool {
   ~ThreadPool();
 
   // Runs a task on the thread pool.
-  bool Run(Task* task);
+  //
+  // If [affinity] is not NULL, the task preferably runs on the idle worker
+  // that last ran a task with the same affinity, whose caches are likely
+  // still warm with the data the task works on.
+  bool Run(Task* task, const void* affinity = NULL);
 
   // Some simple stats.
   uint64_t workers_running() const { return count_running_; }
@@ -73,6 +77,9 @@ class ThreadPool {
 
     bool IsDone() const { return done_; }
 
+    // Busy-waits briefly for a new task before the worker parks itself.
+    void SpinForTask();
+
     // Fields owned by Worker.
     Monitor monitor_;
     ThreadPool* pool_;
@@ -82,9 +89,10 @@ class ThreadPool {
 
     // Fields owned by ThreadPool.  Workers should not look at these
     // directly.  It's like looking at the sun.
-    bool owned_;         // Protected by ThreadPool::mutex_
-    Worker* all_next_;   // Protected by ThreadPool::mutex_
-    Worker* idle_next_;  // Protected by ThreadPool::mutex_
+    bool owned_;                 // Protected by ThreadPool::mutex_
+    Worker* all_next_;           // Protected by ThreadPool::mutex_
+    Worker* idle_next_;          // Protected by ThreadPool::mutex_
+    const void* last_affinity_;  // Protected by ThreadPool::mutex_
 
     Worker* shutdown_next_;  // Protected by ThreadPool::exit_monitor
 
@@ -116,6 +124,7 @@ class ThreadPool {
   bool IsIdle(Worker* worker);
 
   bool RemoveWorkerFromIdleList(Worker* worker);
+  Worker* TakeIdleWorkerLocked(const void* affinity);
   bool RemoveWorkerFromAllList(Worker* worker);
 
   void AddWorkerToShutdownList(Worker* worker);
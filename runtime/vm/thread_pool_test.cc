@@ -237,4 +237,53 @@ VM_UNIT_TEST_CASE(ThreadPool_RecursiveSpawn) {
   EXPECT_EQ(kTotalTasks, done);
 }
 
+// A chain of tasks in which each task posts its successor with the chain as
+// the affinity, like the tasks of a message handler receiving a stream of
+// messages.
+class ChainTask : public ThreadPool::Task {
+ public:
+  ChainTask(ThreadPool* pool, Monitor* sync, int remaining, int* done)
+      : pool_(pool), sync_(sync), remaining_(remaining), done_(done) {}
+
+  virtual void Run() {
+    if (remaining_ > 1) {
+      pool_->Run(new ChainTask(pool_, sync_, remaining_ - 1, done_), done_);
+      return;
+    }
+    MonitorLocker ml(sync_);
+    (*done_)++;
+    ml.Notify();
+  }
+
+ private:
+  ThreadPool* pool_;
+  Monitor* sync_;
+  int remaining_;
+  int* done_;
+};
+
+VM_UNIT_TEST_CASE(ThreadPool_Chains) {
+  const int kChainCount = 16;
+  const int kChainLength = 5000;
+  ThreadPool thread_pool;
+  Monitor sync;
+  int done[kChainCount];
+  for (int i = 0; i < kChainCount; i++) {
+    done[i] = 0;
+    thread_pool.Run(new ChainTask(&thread_pool, &sync, kChainLength, &done[i]),
+                    &done[i]);
+  }
+  {
+    MonitorLocker ml(&sync);
+    for (int i = 0; i < kChainCount; i++) {
+      while (done[i] == 0) {
+        ml.Wait();
+      }
+    }
+  }
+  for (int i = 0; i < kChainCount; i++) {
+    EXPECT_EQ(1, done[i]);
+  }
+}
+
 }  // namespace dart
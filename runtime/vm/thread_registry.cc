@@ -87,6 +87,24 @@ void ThreadRegistry::PrepareForGC() {
   }
 }
 
+void ThreadRegistry::ReleaseOldAllocationBuffers() {
+  MonitorLocker ml(threads_lock());
+  Thread* thread = active_list_;
+  while (thread != NULL) {
+    thread->ReleaseOldAllocationBuffer();
+    thread = thread->next_;
+  }
+}
+
+void ThreadRegistry::SetMarking(bool value) {
+  MonitorLocker ml(threads_lock());
+  Thread* thread = active_list_;
+  while (thread != NULL) {
+    thread->set_is_marking(value);
+    thread = thread->next_;
+  }
+}
+
 #ifndef PRODUCT
 void ThreadRegistry::PrintJSON(JSONStream* stream) const {
   MonitorLocker ml(threads_lock());
@@ -32,6 +32,8 @@ class ThreadRegistry {
   void VisitObjectPointers(ObjectPointerVisitor* visitor,
                            ValidationPolicy validate_frames);
   void PrepareForGC();
+  void ReleaseOldAllocationBuffers();
+  void SetMarking(bool value);
   Thread* mutator_thread() const { return mutator_thread_; }
 
 #ifndef PRODUCT
@@ -8,9 +8,14 @@
 #include "vm/lockers.h"
 #include "vm/profiler.h"
 #include "vm/stack_frame.h"
+#include "vm/symbols.h"
 #include "vm/thread_pool.h"
 #include "vm/unit_test.h"
 
+#if defined(HOST_OS_LINUX)
+#include <sched.h>  // NOLINT
+#endif
+
 namespace dart {
 
 VM_UNIT_TEST_CASE(Mutex) {
@@ -32,6 +37,29 @@ VM_UNIT_TEST_CASE(Mutex) {
   delete mutex;
 }
 
+VM_UNIT_TEST_CASE(NumaAffinity) {
+  const intptr_t node = OSThread::GetCurrentNumaNode();
+  if (node == OSThread::kNoNumaNode) {
+    return;  // Not supported on this platform.
+  }
+  EXPECT(node >= 0);
+#if defined(HOST_OS_LINUX)
+  cpu_set_t before;
+  EXPECT_EQ(0, sched_getaffinity(0, sizeof(before), &before));
+#endif
+  if (OSThread::SetCurrentNumaAffinity(node)) {
+    // Only the CPUs of the node are eligible now.
+    EXPECT_EQ(node, OSThread::GetCurrentNumaNode());
+    OSThread::RestoreCurrentAffinity();
+#if defined(HOST_OS_LINUX)
+    // The thread's own affinity comes back, not all online CPUs.
+    cpu_set_t after;
+    EXPECT_EQ(0, sched_getaffinity(0, sizeof(after), &after));
+    EXPECT(CPU_EQUAL(&before, &after));
+#endif
+  }
+}
+
 VM_UNIT_TEST_CASE(Monitor) {
   // This unit test case needs a running isolate.
   TestCase::CreateTestIsolate();
@@ -770,4 +798,84 @@ ISOLATE_UNIT_TEST_CASE(HelperAllocAndGC) {
   }
 }
 
+class InternSymbolsTask : public ThreadPool::Task {
+ public:
+  static const intptr_t kNumSymbols = 2000;
+
+  InternSymbolsTask(Isolate* isolate,
+                    RawString** results,
+                    Monitor* done_monitor,
+                    intptr_t* done_count)
+      : isolate_(isolate),
+        results_(results),
+        done_monitor_(done_monitor),
+        done_count_(done_count) {}
+
+  virtual void Run() {
+    Thread::EnterIsolateAsHelper(isolate_, Thread::kUnknownTask);
+    {
+      Thread* thread = Thread::Current();
+      StackZone stack_zone(thread);
+      HANDLESCOPE(thread);
+      char name[64];
+      // Intern every name twice so that both the inserting and the lookup
+      // path race with the other tasks.
+      for (intptr_t round = 0; round < 2; round++) {
+        for (intptr_t i = 0; i < kNumSymbols; i++) {
+          Utils::SNPrint(name, sizeof(name), "InternSymbolsTask_%" Pd, i);
+          RawString* symbol = Symbols::New(thread, name);
+          if (round == 0) {
+            results_[i] = symbol;
+          } else if (results_[i] != symbol) {
+            results_[i] = String::null();
+          }
+        }
+      }
+    }
+    Thread::ExitIsolateAsHelper();
+    {
+      MonitorLocker ml(done_monitor_);
+      *done_count_ += 1;
+      ml.Notify();
+    }
+  }
+
+ private:
+  Isolate* isolate_;
+  RawString** results_;
+  Monitor* done_monitor_;
+  intptr_t* done_count_;
+};
+
+ISOLATE_UNIT_TEST_CASE(ConcurrentSymbols) {
+  const intptr_t kTaskCount = 4;
+  const intptr_t kNumSymbols = InternSymbolsTask::kNumSymbols;
+  Monitor done_monitor;
+  intptr_t done_count = 0;
+  Isolate* isolate = thread->isolate();
+  // Keep symbols in place while the tasks hold raw pointers to them.
+  isolate->heap()->DisableGrowthControl();
+  RawString** results = new RawString*[kTaskCount * kNumSymbols];
+  for (intptr_t i = 0; i < kTaskCount; i++) {
+    Dart::thread_pool()->Run(new InternSymbolsTask(
+        isolate, &results[i * kNumSymbols], &done_monitor, &done_count));
+  }
+  while (true) {
+    TransitionVMToBlocked transition(thread);
+    MonitorLocker ml(&done_monitor);
+    if (done_count == kTaskCount) {
+      break;
+    }
+  }
+  // All tasks must have agreed on a single canonical symbol per name.
+  for (intptr_t i = 0; i < kNumSymbols; i++) {
+    EXPECT(results[i] != String::null());
+    for (intptr_t j = 1; j < kTaskCount; j++) {
+      EXPECT(results[i] == results[j * kNumSymbols + i]);
+    }
+  }
+  delete[] results;
+  isolate->heap()->EnableGrowthControl();
+}
+
 }  // namespace dart
@@ -17,6 +17,7 @@
 #include "vm/lockers.h"
 #include "vm/log.h"
 #include "vm/object.h"
+#include "vm/perf_counters.h"
 #include "vm/service_event.h"
 #include "vm/thread.h"
 
@@ -53,7 +54,12 @@ DEFINE_FLAG(charp,
             timeline_recorder,
             "ring",
             "Select the timeline recorder used. "
-            "Valid values: ring, endless, startup, and systrace.")
+            "Valid values: ring, endless, startup, systrace, and file.")
+DEFINE_FLAG(charp,
+            timeline_file,
+            NULL,
+            "Path of the Perfetto trace written by the file timeline "
+            "recorder. Defaults to dart-timeline-<pid>.pftrace.")
 
 // Implementation notes:
 //
@@ -126,6 +132,13 @@ static TimelineEventRecorder* CreateTimelineRecorder() {
     }
   }
 
+  if ((flag != NULL) && (strcmp("file", flag) == 0)) {
+    if (FLAG_trace_timeline) {
+      THR_Print("Using the file timeline recorder.\n");
+    }
+    return new TimelineEventFileRecorder(FLAG_timeline_file);
+  }
+
   if (use_endless_recorder || (flag != NULL)) {
     if (use_endless_recorder || (strcmp("endless", flag) == 0)) {
       if (FLAG_trace_timeline) {
@@ -695,7 +708,7 @@ void TimelineEvent::PrintJSON(JSONStream* stream) const {
     if (isolate_id_ != ILLEGAL_PORT) {
       // If we have one, append the isolate id.
       stream->UncloseObject();
-      stream->PrintfProperty("isolateNumber", "%" Pd64 "",
+      stream->PrintfProperty("isolateNumber", "%" Pd64,
                              static_cast<int64_t>(isolate_id_));
       stream->CloseObject();
     }
@@ -707,7 +720,7 @@ void TimelineEvent::PrintJSON(JSONStream* stream) const {
     }
     if (isolate_id_ != ILLEGAL_PORT) {
       // If we have one, append the isolate id.
-      args.AddPropertyF("isolateNumber", "%" Pd64 "",
+      args.AddPropertyF("isolateNumber", "%" Pd64,
                         static_cast<int64_t>(isolate_id_));
     }
   }
@@ -859,23 +872,31 @@ void TimelineEventScope::StealArguments(TimelineEvent* event) {
 
 TimelineDurationScope::TimelineDurationScope(TimelineStream* stream,
                                              const char* label)
-    : TimelineEventScope(stream, label) {
+    : TimelineEventScope(stream, label), perf_counter_(-1) {
   if (!FLAG_support_timeline || !enabled()) {
     return;
   }
   timestamp_ = OS::GetCurrentMonotonicMicros();
   thread_timestamp_ = OS::GetCurrentThreadCPUMicros();
+  ReadPerfCounter();
 }
 
 TimelineDurationScope::TimelineDurationScope(Thread* thread,
                                              TimelineStream* stream,
                                              const char* label)
-    : TimelineEventScope(thread, stream, label) {
+    : TimelineEventScope(thread, stream, label), perf_counter_(-1) {
   if (!FLAG_support_timeline || !enabled()) {
     return;
   }
   timestamp_ = OS::GetCurrentMonotonicMicros();
   thread_timestamp_ = OS::GetCurrentThreadCPUMicros();
+  ReadPerfCounter();
+}
+
+void TimelineDurationScope::ReadPerfCounter() {
+  if (PerfCounters::CountingEnabled()) {
+    perf_counter_ = PerfCounters::ReadThreadCounter(OSThread::Current());
+  }
 }
 
 TimelineDurationScope::~TimelineDurationScope() {
@@ -894,6 +915,16 @@ TimelineDurationScope::~TimelineDurationScope() {
   // Emit a duration event.
   event->Duration(label(), timestamp_, OS::GetCurrentMonotonicMicros(),
                   thread_timestamp_, OS::GetCurrentThreadCPUMicros());
+  if (perf_counter_ >= 0) {
+    const int64_t perf_counter_end =
+        PerfCounters::ReadThreadCounter(OSThread::Current());
+    if (perf_counter_end >= perf_counter_) {
+      const intptr_t i = GetNumArguments();
+      SetNumArguments(i + 1);
+      FormatArgument(i, PerfCounters::EventName(), "%" Pd64,
+                     perf_counter_end - perf_counter_);
+    }
+  }
   StealArguments(event);
   event->Complete();
 }
@@ -1514,6 +1545,405 @@ void TimelineEventEndlessRecorder::Clear() {
   thread->set_timeline_block(NULL);
 }
 
+// Encodes the protocol buffer messages of a Perfetto trace. The writer
+// thread has no zone, so the bytes are kept in malloced memory.
+class PerfettoMessage {
+ public:
+  PerfettoMessage() : bytes_(256) {}
+
+  const uint8_t* data() const { return bytes_.data(); }
+  intptr_t length() const { return bytes_.length(); }
+  void Clear() { bytes_.Clear(); }
+
+  void WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+      bytes_.Add(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    bytes_.Add(static_cast<uint8_t>(value));
+  }
+
+  void WriteVarintField(intptr_t field, uint64_t value) {
+    WriteVarint(Tag(field, kVarintWireType));
+    WriteVarint(value);
+  }
+
+  void WriteBytesField(intptr_t field, const uint8_t* data, intptr_t length) {
+    WriteVarint(Tag(field, kLengthDelimitedWireType));
+    WriteVarint(length);
+    for (intptr_t i = 0; i < length; i++) {
+      bytes_.Add(data[i]);
+    }
+  }
+
+  void WriteStringField(intptr_t field, const char* value) {
+    WriteBytesField(field, reinterpret_cast<const uint8_t*>(value),
+                    strlen(value));
+  }
+
+  void WriteMessageField(intptr_t field, const PerfettoMessage& message) {
+    WriteBytesField(field, message.data(), message.length());
+  }
+
+ private:
+  static const intptr_t kVarintWireType = 0;
+  static const intptr_t kLengthDelimitedWireType = 2;
+
+  static uint64_t Tag(intptr_t field, intptr_t wire_type) {
+    return (static_cast<uint64_t>(field) << 3) | wire_type;
+  }
+
+  MallocGrowableArray<uint8_t> bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(PerfettoMessage);
+};
+
+// Field numbers from Perfetto's trace protos.
+enum {
+  kTracePacket = 1,
+
+  kTracePacketTimestamp = 8,
+  kTracePacketSequenceId = 10,
+  kTracePacketTrackEvent = 11,
+  kTracePacketSequenceFlags = 13,
+  kTracePacketClockId = 58,
+  kTracePacketTrackDescriptor = 60,
+
+  kTrackDescriptorUuid = 1,
+  kTrackDescriptorThread = 4,
+
+  kThreadDescriptorPid = 1,
+  kThreadDescriptorTid = 2,
+  kThreadDescriptorName = 5,
+
+  kTrackEventDebugAnnotation = 4,
+  kTrackEventLegacyEvent = 6,
+  kTrackEventTrackUuid = 11,
+  kTrackEventThreadTime = 17,
+  kTrackEventCategory = 22,
+  kTrackEventName = 23,
+
+  kLegacyEventPhase = 2,
+  kLegacyEventDuration = 3,
+  kLegacyEventThreadDuration = 4,
+  kLegacyEventUnscopedId = 6,
+
+  kDebugAnnotationStringValue = 6,
+  kDebugAnnotationJsonValue = 9,
+  kDebugAnnotationName = 10,
+};
+
+static const intptr_t kClockMonotonic = 3;
+static const intptr_t kSequenceIncrementalStateCleared = 1;
+
+// The Chrome trace event phase of each TimelineEvent::EventType, as in
+// TimelineEvent::PrintJSON. Perfetto imports these as legacy events.
+static const char kEventPhases[TimelineEvent::kNumEventTypes] = {
+    '\0', 'B', 'E', 'X', 'i', 'b', 'n', 'e', 'C', 's', 't', 'f', 'M',
+};
+
+TimelineEventFileRecorder::TimelineEventFileRecorder(const char* path)
+    : file_(NULL),
+      writer_running_(false),
+      shutdown_(false),
+      writer_id_(OSThread::kInvalidThreadJoinId),
+      blocks_(NULL),
+      free_blocks_(NULL),
+      block_index_(0),
+      pending_block_count_(0),
+      first_packet_(true) {
+  Dart_FileOpenCallback file_open = Dart::file_open_callback();
+  if ((file_open == NULL) || (Dart::file_write_callback() == NULL) ||
+      (Dart::file_close_callback() == NULL)) {
+    OS::PrintErr("Failed to write timeline file: no file callbacks\n");
+  } else {
+    char* filename =
+        (path != NULL) ? strdup(path)
+                       : OS::SCreate(NULL, "dart-timeline-%" Pd ".pftrace",
+                                     OS::ProcessId());
+    file_ = (*file_open)(filename, true);
+    if (file_ == NULL) {
+      OS::PrintErr("Failed to write timeline file: %s\n", filename);
+    }
+    free(filename);
+  }
+
+  MonitorLocker ml(&monitor_);
+  int result = OSThread::Start("Dart Timeline Writer", WriterMain,
+                               reinterpret_cast<uword>(this));
+  if (result != 0) {
+    FATAL1("Failed to start the timeline writer thread: %d", result);
+  }
+  while (!writer_running_) {
+    ml.Wait();
+  }
+}
+
+TimelineEventFileRecorder::~TimelineEventFileRecorder() {
+  if (Timeline::recorder() == this) {
+    // Write the events of partially filled blocks too.
+    Timeline::ReclaimCachedBlocksFromThreads();
+  }
+  {
+    MonitorLocker ml(&monitor_);
+    shutdown_ = true;
+    ml.Notify();
+  }
+  OSThread::Join(writer_id_);
+
+  MutexLocker ml(&lock_);
+  TimelineEventBlock* lists[] = {blocks_, free_blocks_};
+  for (intptr_t i = 0; i < 2; i++) {
+    TimelineEventBlock* current = lists[i];
+    while (current != NULL) {
+      TimelineEventBlock* next = current->next();
+      delete current;
+      current = next;
+    }
+  }
+  blocks_ = NULL;
+  free_blocks_ = NULL;
+}
+
+void TimelineEventFileRecorder::PrintJSON(JSONStream* js,
+                                          TimelineEventFilter* filter) {
+  if (!FLAG_support_service) {
+    return;
+  }
+  JSONObject topLevel(js);
+  topLevel.AddProperty("type", "_Timeline");
+  {
+    JSONArray events(&topLevel, "traceEvents");
+    PrintJSONMeta(&events);
+  }
+}
+
+void TimelineEventFileRecorder::PrintTraceEvent(JSONStream* js,
+                                                TimelineEventFilter* filter) {
+  if (!FLAG_support_service) {
+    return;
+  }
+  JSONArray events(js);
+}
+
+TimelineEvent* TimelineEventFileRecorder::StartEvent() {
+  return ThreadBlockStartEvent();
+}
+
+void TimelineEventFileRecorder::CompleteEvent(TimelineEvent* event) {
+  if (event == NULL) {
+    return;
+  }
+  ThreadBlockCompleteEvent(event);
+}
+
+TimelineEventBlock* TimelineEventFileRecorder::GetNewBlockLocked() {
+  TimelineEventBlock* block = free_blocks_;
+  if (block != NULL) {
+    free_blocks_ = block->next();
+  } else {
+    block = new TimelineEventBlock(block_index_++);
+  }
+  block->set_next(blocks_);
+  block->Open();
+  blocks_ = block;
+  // Apart from a thread's first block, each new block replaces a full one.
+  if (++pending_block_count_ == kFlushBlockCount) {
+    MonitorLocker ml(&monitor_);
+    ml.Notify();
+  }
+  return block;
+}
+
+TimelineEventBlock* TimelineEventFileRecorder::TakeFinishedBlocksLocked() {
+  TimelineEventBlock* finished = NULL;
+  TimelineEventBlock** link = &blocks_;
+  while (*link != NULL) {
+    TimelineEventBlock* block = *link;
+    if (block->in_use()) {
+      link = &block->next_;
+    } else {
+      *link = block->next();
+      block->set_next(finished);
+      finished = block;
+    }
+  }
+  pending_block_count_ = 0;
+  return finished;
+}
+
+void TimelineEventFileRecorder::WriterMain(uword parameter) {
+  TimelineEventFileRecorder* recorder =
+      reinterpret_cast<TimelineEventFileRecorder*>(parameter);
+  {
+    MonitorLocker ml(&recorder->monitor_);
+    recorder->writer_id_ =
+        OSThread::GetCurrentThreadJoinId(OSThread::Current());
+    recorder->writer_running_ = true;
+    ml.Notify();
+  }
+  bool shutdown = false;
+  while (!shutdown) {
+    {
+      MonitorLocker ml(&recorder->monitor_);
+      if (!recorder->shutdown_) {
+        ml.Wait(kFlushIntervalMillis);
+      }
+      shutdown = recorder->shutdown_;
+    }
+    TimelineEventBlock* blocks = NULL;
+    {
+      MutexLocker ml(&recorder->lock_);
+      blocks = recorder->TakeFinishedBlocksLocked();
+    }
+    recorder->WriteBlocks(blocks);
+  }
+  if (recorder->file_ != NULL) {
+    (*Dart::file_close_callback())(recorder->file_);
+    recorder->file_ = NULL;
+  }
+}
+
+void TimelineEventFileRecorder::WriteBlocks(TimelineEventBlock* blocks) {
+  if (blocks == NULL) {
+    return;
+  }
+  TimelineEventBlock* last = NULL;
+  for (TimelineEventBlock* block = blocks; block != NULL;
+       block = block->next()) {
+    if ((file_ != NULL) && !block->IsEmpty()) {
+      WriteThreadTrack(block->thread_id());
+      for (intptr_t i = 0; i < block->length(); i++) {
+        TimelineEvent* event = block->At(i);
+        if (event->IsValid()) {
+          WriteEvent(event);
+        }
+      }
+    }
+    block->Reset();
+    last = block;
+  }
+  MutexLocker ml(&lock_);
+  last->set_next(free_blocks_);
+  free_blocks_ = blocks;
+}
+
+// Writes 'packet' as a TracePacket of a Trace message. Concatenated Trace
+// messages form a Trace message, so the file is valid after every packet.
+static void WritePacket(void* file, const PerfettoMessage& packet) {
+  PerfettoMessage header;
+  header.WriteVarint((kTracePacket << 3) | 2);
+  header.WriteVarint(packet.length());
+  Dart_FileWriteCallback file_write = Dart::file_write_callback();
+  (*file_write)(header.data(), header.length(), file);
+  (*file_write)(packet.data(), packet.length(), file);
+}
+
+void TimelineEventFileRecorder::WriteThreadTrack(ThreadId tid) {
+  for (intptr_t i = 0; i < written_threads_.length(); i++) {
+    if (written_threads_[i] == tid) {
+      return;
+    }
+  }
+  written_threads_.Add(tid);
+
+  PerfettoMessage thread;
+  thread.WriteVarintField(kThreadDescriptorPid, OS::ProcessId());
+  thread.WriteVarintField(kThreadDescriptorTid,
+                          OSThread::ThreadIdToIntPtr(tid));
+  {
+    OSThreadIterator it;
+    while (it.HasNext()) {
+      OSThread* os_thread = it.Next();
+      if ((os_thread->trace_id() == tid) && (os_thread->name() != NULL)) {
+        thread.WriteStringField(kThreadDescriptorName, os_thread->name());
+        break;
+      }
+    }
+  }
+  PerfettoMessage track;
+  track.WriteVarintField(kTrackDescriptorUuid,
+                         OSThread::ThreadIdToIntPtr(tid));
+  track.WriteMessageField(kTrackDescriptorThread, thread);
+  PerfettoMessage packet;
+  packet.WriteVarintField(kTracePacketSequenceId, 1);
+  if (first_packet_) {
+    packet.WriteVarintField(kTracePacketSequenceFlags,
+                            kSequenceIncrementalStateCleared);
+    first_packet_ = false;
+  }
+  packet.WriteMessageField(kTracePacketTrackDescriptor, track);
+  WritePacket(file_, packet);
+}
+
+void TimelineEventFileRecorder::WriteEvent(TimelineEvent* event) {
+  const TimelineEvent::EventType type = event->event_type();
+  PerfettoMessage legacy_event;
+  legacy_event.WriteVarintField(kLegacyEventPhase, kEventPhases[type]);
+  if (type == TimelineEvent::kDuration) {
+    legacy_event.WriteVarintField(kLegacyEventDuration,
+                                  event->TimeDuration());
+    if (event->HasThreadCPUTime()) {
+      legacy_event.WriteVarintField(kLegacyEventThreadDuration,
+                                    event->ThreadCPUTimeDuration());
+    }
+  }
+  switch (type) {
+    case TimelineEvent::kAsyncBegin:
+    case TimelineEvent::kAsyncInstant:
+    case TimelineEvent::kAsyncEnd:
+    case TimelineEvent::kFlowBegin:
+    case TimelineEvent::kFlowStep:
+    case TimelineEvent::kFlowEnd:
+      legacy_event.WriteVarintField(kLegacyEventUnscopedId, event->AsyncId());
+      break;
+    default:
+      break;
+  }
+
+  PerfettoMessage track_event;
+  track_event.WriteStringField(kTrackEventName, event->label());
+  track_event.WriteStringField(kTrackEventCategory, event->category_);
+  track_event.WriteVarintField(kTrackEventTrackUuid,
+                               OSThread::ThreadIdToIntPtr(event->thread()));
+  if (event->HasThreadCPUTime()) {
+    track_event.WriteVarintField(kTrackEventThreadTime,
+                                 event->ThreadCPUTimeOrigin());
+  }
+  PerfettoMessage annotation;
+  for (intptr_t i = 0; i < event->arguments_length(); i++) {
+    const TimelineEventArgument& argument = event->arguments()[i];
+    annotation.Clear();
+    if (event->pre_serialized_args()) {
+      annotation.WriteStringField(kDebugAnnotationName, "args");
+      annotation.WriteStringField(kDebugAnnotationJsonValue, argument.value);
+    } else {
+      annotation.WriteStringField(kDebugAnnotationName, argument.name);
+      annotation.WriteStringField(kDebugAnnotationStringValue,
+                                  argument.value);
+    }
+    track_event.WriteMessageField(kTrackEventDebugAnnotation, annotation);
+  }
+  if (event->isolate_id() != ILLEGAL_PORT) {
+    char isolate_number[32];
+    Utils::SNPrint(isolate_number, sizeof(isolate_number), "%" Pd64,
+                   static_cast<int64_t>(event->isolate_id()));
+    annotation.Clear();
+    annotation.WriteStringField(kDebugAnnotationName, "isolateNumber");
+    annotation.WriteStringField(kDebugAnnotationStringValue, isolate_number);
+    track_event.WriteMessageField(kTrackEventDebugAnnotation, annotation);
+  }
+  track_event.WriteMessageField(kTrackEventLegacyEvent, legacy_event);
+
+  PerfettoMessage packet;
+  packet.WriteVarintField(kTracePacketTimestamp,
+                          event->TimeOrigin() * kNanosecondsPerMicrosecond);
+  packet.WriteVarintField(kTracePacketClockId, kClockMonotonic);
+  packet.WriteVarintField(kTracePacketSequenceId, 1);
+  packet.WriteMessageField(kTracePacketTrackEvent, track_event);
+  WritePacket(file_, packet);
+}
+
 TimelineEventBlock::TimelineEventBlock(intptr_t block_index)
     : next_(NULL),
       length_(0),
@@ -439,6 +439,7 @@ class TimelineEvent {
 
   friend class TimelineEventRecorder;
   friend class TimelineEventEndlessRecorder;
+  friend class TimelineEventFileRecorder;
   friend class TimelineEventRingRecorder;
   friend class TimelineEventStartupRecorder;
   friend class TimelineEventPlatformRecorder;
@@ -527,8 +528,12 @@ class TimelineDurationScope : public TimelineEventScope {
   virtual ~TimelineDurationScope();
 
  private:
+  void ReadPerfCounter();
+
   int64_t timestamp_;
   int64_t thread_timestamp_;
+  // Hardware event count at the start, -1 if not counted.
+  int64_t perf_counter_;
 
   DISALLOW_COPY_AND_ASSIGN(TimelineDurationScope);
 };
@@ -618,6 +623,7 @@ class TimelineEventBlock {
   friend class Thread;
   friend class TimelineEventRecorder;
   friend class TimelineEventEndlessRecorder;
+  friend class TimelineEventFileRecorder;
   friend class TimelineEventRingRecorder;
   friend class TimelineEventStartupRecorder;
   friend class TimelineEventPlatformRecorder;
@@ -839,6 +845,64 @@ class TimelineEventEndlessRecorder : public TimelineEventRecorder {
   friend class TimelineTestHelper;
 };
 
+// A recorder that streams events to a file in Perfetto's protobuf trace
+// format (https://perfetto.dev/docs/reference/trace-packet-proto), which
+// can be opened with ui.perfetto.dev or trace_processor. Threads fill
+// blocks as with the endless recorder, and a background thread writes
+// finished blocks and reuses them, so memory stays bounded by the blocks
+// waiting to be written. Events are not kept, so the service protocol
+// sees an empty timeline.
+class TimelineEventFileRecorder : public TimelineEventRecorder {
+ public:
+  // Blocks waiting to be written beyond which the writer is woken early.
+  static const intptr_t kFlushBlockCount = 16;
+  static const int64_t kFlushIntervalMillis = 1000;
+
+  explicit TimelineEventFileRecorder(const char* path);
+  virtual ~TimelineEventFileRecorder();
+
+  void PrintJSON(JSONStream* js, TimelineEventFilter* filter);
+  void PrintTraceEvent(JSONStream* js, TimelineEventFilter* filter);
+
+  const char* name() const { return "File"; }
+
+ protected:
+  TimelineEvent* StartEvent();
+  void CompleteEvent(TimelineEvent* event);
+  TimelineEventBlock* GetNewBlockLocked();
+  TimelineEventBlock* GetHeadBlockLocked() { return NULL; }
+  void Clear() {}
+
+ private:
+  static void WriterMain(uword parameter);
+
+  // Unlinks the finished blocks from blocks_. Requires lock_.
+  TimelineEventBlock* TakeFinishedBlocksLocked();
+  // Writes and then recycles 'blocks'. Only called by the writer thread.
+  void WriteBlocks(TimelineEventBlock* blocks);
+  void WriteThreadTrack(ThreadId tid);
+  void WriteEvent(TimelineEvent* event);
+
+  void* file_;
+
+  // Protects the writer thread's state.
+  Monitor monitor_;
+  bool writer_running_;
+  bool shutdown_;
+  ThreadJoinId writer_id_;
+
+  // The blocks handed out to threads, in use or waiting to be written, and
+  // the blocks ready for reuse. Require lock_.
+  TimelineEventBlock* blocks_;
+  TimelineEventBlock* free_blocks_;
+  intptr_t block_index_;
+  intptr_t pending_block_count_;
+
+  // Only accessed by the writer thread.
+  MallocGrowableArray<ThreadId> written_threads_;
+  bool first_packet_;
+};
+
 // An iterator for blocks.
 class TimelineEventBlockIterator {
  public:
@@ -461,31 +461,42 @@ void TypeTestingStubGenerator::
         const Register class_id_reg,
         const Register instance_reg,
         const Register instance_type_args_reg) {
-  // a) First we make a quick sub*class* cid-range check.
+  // a) First we make a quick sub*class* cid-range check.  If the class is
+  // implemented, we instead check for the implementations which store the
+  // type arguments the same way as subclasses would; any other instance
+  // takes the slow path.
   Label check_failed;
-  ASSERT(!type_class.is_implemented());
-  const CidRangeVector& ranges = hi->SubclassRangesForClass(type_class);
-  BuildOptimizedSubclassRangeCheck(assembler, ranges, class_id_reg,
-                                   instance_reg, &check_failed);
+  intptr_t type_arguments_field_offset;
+  CidRangeVector implementation_ranges;
+  if (type_class.is_implemented()) {
+    const bool found = hi->SubtypeRangesWithSameTypeArgumentsLayout(
+        type_class, &implementation_ranges, &type_arguments_field_offset);
+    ASSERT(found);
+    BuildOptimizedSubclassRangeCheck(assembler, implementation_ranges,
+                                     class_id_reg, instance_reg,
+                                     &check_failed);
+  } else {
+    const CidRangeVector& ranges = hi->SubclassRangesForClass(type_class);
+    BuildOptimizedSubclassRangeCheck(assembler, ranges, class_id_reg,
+                                     instance_reg, &check_failed);
+    type_arguments_field_offset = type_class.type_arguments_field_offset();
+  }
   // fall through to continue
 
   // b) Then we'll load the values for the type parameters.
-  __ LoadField(
-      instance_type_args_reg,
-      FieldAddress(instance_reg, type_class.type_arguments_field_offset()));
+  __ LoadField(instance_type_args_reg,
+               FieldAddress(instance_reg, type_arguments_field_offset));
 
-  // The kernel frontend should fill in any non-assigned type parameters on
-  // construction with dynamic/Object, so we should never get the null type
-  // argument vector in created instances.
+  // The null type argument vector stands for all-dynamic, e.g. for
+  // <dynamic>[], which is not an instance of the non-rare types checked here.
+  // Leave the instance to the slow path, which decides without assuming
+  // anything about how the type arguments were filled in.
   //
   // TODO(kustermann): We could consider not using "null" as type argument
   // vector representing all-dynamic to avoid this extra check (which will be
   // uncommon because most Dart code in 2.0 will be strongly typed)!
-  Label process_done;
   __ CompareObject(instance_type_args_reg, Object::null_object());
-  __ BranchIf(NOT_EQUAL, &process_done);
-  __ Ret();
-  __ Bind(&process_done);
+  __ BranchIf(EQUAL, &check_failed);
 
   // c) Then we'll check each value of the type argument.
   AbstractType& type_arg = AbstractType::Handle();
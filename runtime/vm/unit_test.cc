@@ -15,7 +15,10 @@
 #include "vm/ast_printer.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/assembler/disassembler.h"
+#include "vm/compiler/backend/inliner.h"
+#include "vm/compiler/compiler_pass.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/compiler/jit/jit_call_specializer.h"
 #include "vm/dart_api_impl.h"
 #include "vm/isolate_reload.h"
 #include "vm/kernel_isolate.h"
@@ -850,6 +853,32 @@ bool CompilerTest::TestCompileFunction(const Function& function) {
   return result.IsCode();
 }
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+FlowGraph* CompilerTest::BuildOptimizedFlowGraph(const Function& function) {
+  Thread* thread = Thread::Current();
+  Zone* zone = thread->zone();
+  ParsedFunction* parsed_function =
+      new (zone) ParsedFunction(thread, Function::ZoneHandle(function.raw()));
+  DartCompilationPipeline pipeline;
+  pipeline.ParseFunction(parsed_function);
+  ZoneGrowableArray<const ICData*>* ic_data_array =
+      new (zone) ZoneGrowableArray<const ICData*>();
+  function.RestoreICDataMap(ic_data_array, /*clone_ic_data=*/false);
+  FlowGraph* flow_graph =
+      pipeline.BuildFlowGraph(zone, parsed_function, *ic_data_array,
+                              Compiler::kNoOSRDeoptId, /*optimized=*/true);
+
+  SpeculativeInliningPolicy speculative_policy(/*enable_blacklist=*/false);
+  CompilerPassState pass_state(thread, flow_graph, &speculative_policy);
+  pass_state.inline_id_to_function.Add(&function);
+  pass_state.caller_inline_id.Add(-1);
+  JitCallSpecializer call_specializer(flow_graph, &speculative_policy);
+  pass_state.call_specializer = &call_specializer;
+  CompilerPass::RunPipeline(CompilerPass::kJIT, &pass_state);
+  return flow_graph;
+}
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
 void ElideJSONSubstring(const char* prefix, const char* in, char* out) {
   const char* pos = strstr(in, prefix);
   while (pos != NULL) {
@@ -260,6 +260,7 @@ namespace dart {
 // Forward declarations.
 class Assembler;
 class CodeGenerator;
+class FlowGraph;
 class VirtualMemory;
 
 namespace bin {
@@ -636,6 +637,13 @@ class CompilerTest : public AllStatic {
   // Test the Compiler::CompileFunction functionality by checking the return
   // value to see if no parse errors were reported.
   static bool TestCompileFunction(const Function& function);
+
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // Builds the flow graph of 'function' and runs the JIT optimization
+  // pipeline on it with the type feedback collected so far, without
+  // generating code.
+  static FlowGraph* BuildOptimizedFlowGraph(const Function& function);
+#endif
 };
 
 #define EXPECT_VALID(handle)                                                   \
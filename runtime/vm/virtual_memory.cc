@@ -6,9 +6,27 @@
 
 #include "platform/assert.h"
 #include "platform/utils.h"
+#include "vm/flags.h"
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            use_huge_pages,
+            false,
+            "Back new space and heap pages with transparent huge pages where "
+            "the OS supports them.");
+DEFINE_FLAG(bool,
+            use_explicit_huge_pages,
+            false,
+            "Back new space with reserved huge pages, falling back to "
+            "transparent huge pages when none are available.");
+DEFINE_FLAG(bool,
+            compressible_heap,
+            false,
+            "Place all heap pages in a single 4GB reservation aligned to 4GB, "
+            "so that heap addresses fit in 32-bit offsets from its base. "
+            "Only on 64-bit Linux.");
+
 bool VirtualMemory::InSamePage(uword address0, uword address1) {
   return (Utils::RoundDown(address0, PageSize()) ==
           Utils::RoundDown(address1, PageSize()));
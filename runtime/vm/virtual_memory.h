@@ -37,6 +37,16 @@ class VirtualMemory {
   static void Protect(void* address, intptr_t size, Protection mode);
   void Protect(Protection mode) { return Protect(address(), size(), mode); }
 
+  // Lets the OS reclaim the physical memory backing an area whose contents are
+  // no longer needed. The area stays reserved and accessible; later reads see
+  // either the old contents or zeros.
+  static void DontNeed(void* address, intptr_t size);
+  void DontNeed() { DontNeed(address(), size()); }
+
+  // Asks the OS to back the not yet committed pages of an area with memory
+  // from the given NUMA node. Best effort: ignored where unsupported.
+  static void BindToNumaNode(void* address, intptr_t size, intptr_t node);
+
   // Reserves and commits a virtual memory segment with size. If a segment of
   // the requested size cannot be allocated, NULL is returned.
   static VirtualMemory* Allocate(intptr_t size,
@@ -47,6 +57,17 @@ class VirtualMemory {
                                         bool is_executable,
                                         const char* name);
 
+  // Like AllocateAligned, but with --use_huge_pages asks for transparent huge
+  // pages, aligning segments that span a huge page to one. With
+  // --use_explicit_huge_pages, a segment that is a whole number of huge pages
+  // and is never truncated is first backed by reserved huge pages. Falls back
+  // to ordinary pages where huge pages are unavailable.
+  static VirtualMemory* AllocateWithHugePages(intptr_t size,
+                                              intptr_t alignment,
+                                              bool is_executable,
+                                              bool is_truncatable,
+                                              const char* name);
+
   static intptr_t PageSize() {
     ASSERT(page_size_ != 0);
     ASSERT(Utils::IsPowerOfTwo(page_size_));
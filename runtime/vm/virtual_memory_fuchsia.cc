@@ -129,6 +129,15 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   return new VirtualMemory(region, region);
 }
 
+VirtualMemory* VirtualMemory::AllocateWithHugePages(intptr_t size,
+                                                    intptr_t alignment,
+                                                    bool is_executable,
+                                                    bool is_truncatable,
+                                                    const char* name) {
+  // Huge pages are not supported on this platform.
+  return AllocateAligned(size, alignment, is_executable, name);
+}
+
 VirtualMemory::~VirtualMemory() {
   // Reserved region may be empty due to VirtualMemory::Truncate.
   if (vm_owns_region() && reserved_.size() != 0) {
@@ -155,6 +164,16 @@ bool VirtualMemory::FreeSubSegment(void* address, intptr_t size) {
   return true;
 }
 
+void VirtualMemory::DontNeed(void* address, intptr_t size) {
+  // The VMO handle is closed once mapped, so its pages cannot be decommitted
+  // here; the memory simply stays committed.
+  LOG_INFO("DontNeed(%p, %lx) ignored\n", address, size);
+}
+
+void VirtualMemory::BindToNumaNode(void* address,
+                                   intptr_t size,
+                                   intptr_t node) {}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
   ASSERT(Thread::Current()->IsMutatorThread() ||
          Isolate::Current()->mutator_thread()->IsAtSafepoint());
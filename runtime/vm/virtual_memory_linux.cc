@@ -9,15 +9,23 @@
 
 #include <errno.h>
 #include <sys/mman.h>
+#include <sys/syscall.h>
 #include <unistd.h>
 
 #include "platform/assert.h"
 #include "platform/utils.h"
 
+#include "vm/flags.h"
 #include "vm/isolate.h"
+#include "vm/lockers.h"
+#include "vm/os_thread.h"
 
 namespace dart {
 
+DECLARE_FLAG(bool, compressible_heap);
+DECLARE_FLAG(bool, use_huge_pages);
+DECLARE_FLAG(bool, use_explicit_huge_pages);
+
 // standard MAP_FAILED causes "error: use of old-style cast" as it
 // defines MAP_FAILED as ((void *) -1)
 #undef MAP_FAILED
@@ -25,10 +33,6 @@ namespace dart {
 
 uword VirtualMemory::page_size_ = 0;
 
-void VirtualMemory::InitOnce() {
-  page_size_ = getpagesize();
-}
-
 static void unmap(void* address, intptr_t size) {
   if (size == 0) {
     return;
@@ -43,6 +47,163 @@ static void unmap(void* address, intptr_t size) {
   }
 }
 
+#if defined(ARCH_IS_64_BIT)
+// With --compressible_heap, heap pages are carved out of one reservation of
+// 4GB aligned to 4GB instead of being mapped wherever the OS chooses. Every
+// heap address is then the base of the reservation plus a 32-bit offset,
+// which is what storing heap pointers in 32-bit slots needs.
+//
+// The reservation is mapped inaccessible and without swap accounting; pages
+// are committed when handed out and discarded again when given back.
+class CompressibleHeapRegion : public AllStatic {
+ public:
+  static const uword kSize = static_cast<uword>(4) * GB;
+
+  static void InitOnce();
+
+  static bool IsEnabled() { return base_ != 0; }
+  static bool Contains(uword address) {
+    return (address - base_) < kSize;
+  }
+
+  // Returns 0 when no free range of size bytes is left.
+  static uword Allocate(intptr_t size, intptr_t alignment, int prot);
+  static void Free(uword start, intptr_t size);
+
+ private:
+  // Free ranges, sorted by address and never adjacent.
+  struct Range {
+    uword start;
+    uword size;
+    Range* next;
+  };
+
+  static uword base_;
+  static Mutex* mutex_;
+  static Range* free_ranges_;
+};
+
+uword CompressibleHeapRegion::base_ = 0;
+Mutex* CompressibleHeapRegion::mutex_ = NULL;
+CompressibleHeapRegion::Range* CompressibleHeapRegion::free_ranges_ = NULL;
+
+void CompressibleHeapRegion::InitOnce() {
+  ASSERT(base_ == 0);
+  const uword reserved_size = 2 * kSize;
+  void* address = mmap(NULL, reserved_size, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+  if (address == MAP_FAILED) {
+    // Heap pages go anywhere, as without the flag.
+    return;
+  }
+  const uword start = reinterpret_cast<uword>(address);
+  const uword aligned_start = Utils::RoundUp(start, kSize);
+  unmap(address, aligned_start - start);
+  unmap(reinterpret_cast<void*>(aligned_start + kSize),
+        start + reserved_size - (aligned_start + kSize));
+  base_ = aligned_start;
+  mutex_ = new Mutex();
+  free_ranges_ = reinterpret_cast<Range*>(malloc(sizeof(Range)));
+  free_ranges_->start = base_;
+  free_ranges_->size = kSize;
+  free_ranges_->next = NULL;
+}
+
+uword CompressibleHeapRegion::Allocate(intptr_t size,
+                                       intptr_t alignment,
+                                       int prot) {
+  ASSERT(IsEnabled());
+  uword result = 0;
+  {
+    MutexLocker ml(mutex_);
+    Range** link = &free_ranges_;
+    for (Range* range = free_ranges_; range != NULL; range = range->next) {
+      const uword start = Utils::RoundUp(range->start, alignment);
+      const uword end = range->start + range->size;
+      if ((start < end) && (end - start >= static_cast<uword>(size))) {
+        result = start;
+        // Keep what is left after the allocated range, then what is left
+        // before it.
+        if (end - start > static_cast<uword>(size)) {
+          Range* rest = reinterpret_cast<Range*>(malloc(sizeof(Range)));
+          rest->start = start + size;
+          rest->size = end - rest->start;
+          rest->next = range->next;
+          range->next = rest;
+        }
+        if (start > range->start) {
+          range->size = start - range->start;
+        } else {
+          *link = range->next;
+          free(range);
+        }
+        break;
+      }
+      link = &range->next;
+    }
+  }
+  if (result == 0) {
+    return 0;
+  }
+  if (mprotect(reinterpret_cast<void*>(result), size, prot) != 0) {
+    Free(result, size);
+    return 0;
+  }
+  return result;
+}
+
+void CompressibleHeapRegion::Free(uword start, intptr_t size) {
+  ASSERT(Contains(start) && Contains(start + size - 1));
+  // Replacing the pages drops their contents and their commit charge.
+  void* address = mmap(reinterpret_cast<void*>(start), size, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANON | MAP_NORESERVE | MAP_FIXED, -1,
+                       0);
+  if (address == MAP_FAILED) {
+    int error = errno;
+    const int kBufferSize = 1024;
+    char error_buf[kBufferSize];
+    FATAL2("mmap error: %d (%s)", error,
+           Utils::StrError(error, error_buf, kBufferSize));
+  }
+  MutexLocker ml(mutex_);
+  Range* previous = NULL;
+  Range* next = free_ranges_;
+  while ((next != NULL) && (next->start < start)) {
+    previous = next;
+    next = next->next;
+  }
+  Range* range = NULL;
+  if ((previous != NULL) && (previous->start + previous->size == start)) {
+    range = previous;
+    range->size += size;
+  } else {
+    range = reinterpret_cast<Range*>(malloc(sizeof(Range)));
+    range->start = start;
+    range->size = size;
+    range->next = next;
+    if (previous == NULL) {
+      free_ranges_ = range;
+    } else {
+      previous->next = range;
+    }
+  }
+  if ((next != NULL) && (range->start + range->size == next->start)) {
+    range->size += next->size;
+    range->next = next->next;
+    free(next);
+  }
+}
+#endif  // defined(ARCH_IS_64_BIT)
+
+void VirtualMemory::InitOnce() {
+  page_size_ = getpagesize();
+#if defined(ARCH_IS_64_BIT)
+  if (FLAG_compressible_heap) {
+    CompressibleHeapRegion::InitOnce();
+  }
+#endif  // defined(ARCH_IS_64_BIT)
+}
+
 VirtualMemory* VirtualMemory::Allocate(intptr_t size,
                                        bool is_executable,
                                        const char* name) {
@@ -89,18 +250,114 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   return new VirtualMemory(region, region);
 }
 
+// The size of a huge page on the architectures we run on.
+static const intptr_t kHugePageSize = 2 * MB;
+
+VirtualMemory* VirtualMemory::AllocateWithHugePages(intptr_t size,
+                                                    intptr_t alignment,
+                                                    bool is_executable,
+                                                    bool is_truncatable,
+                                                    const char* name) {
+#if defined(ARCH_IS_64_BIT)
+  if (CompressibleHeapRegion::IsEnabled()) {
+    // Only the region's own pages are used, so running out of them is running
+    // out of heap.
+    int prot = PROT_READ | PROT_WRITE | (is_executable ? PROT_EXEC : 0);
+    uword address = CompressibleHeapRegion::Allocate(
+        size, Utils::Maximum(alignment, PageSize()), prot);
+    if (address == 0) {
+      return NULL;
+    }
+#if defined(MADV_HUGEPAGE)
+    if (FLAG_use_huge_pages || FLAG_use_explicit_huge_pages) {
+      madvise(reinterpret_cast<void*>(address), size, MADV_HUGEPAGE);
+    }
+#endif  // defined(MADV_HUGEPAGE)
+    MemoryRegion region(reinterpret_cast<void*>(address), size);
+    return new VirtualMemory(region, region);
+  }
+#endif  // defined(ARCH_IS_64_BIT)
+#if defined(MAP_HUGETLB)
+  // Reserved huge pages cannot be partially unmapped, so they are only used
+  // for segments that are never truncated.
+  if (FLAG_use_explicit_huge_pages && !is_truncatable &&
+      Utils::IsAligned(size, kHugePageSize) && (alignment <= kHugePageSize)) {
+    int prot = PROT_READ | PROT_WRITE | (is_executable ? PROT_EXEC : 0);
+    void* address = mmap(NULL, size, prot,
+                         MAP_PRIVATE | MAP_ANON | MAP_HUGETLB, -1, 0);
+    if (address != MAP_FAILED) {
+      MemoryRegion region(address, size);
+      return new VirtualMemory(region, region);
+    }
+    // No huge pages are reserved; try transparent huge pages instead.
+  }
+#endif  // defined(MAP_HUGETLB)
+  if (!FLAG_use_huge_pages && !FLAG_use_explicit_huge_pages) {
+    return AllocateAligned(size, alignment, is_executable, name);
+  }
+  // Transparent huge pages only back huge page aligned ranges. Smaller
+  // segments are still advised, so khugepaged can collapse neighbouring ones
+  // that the kernel has merged into a single mapping.
+  if (size >= kHugePageSize) {
+    alignment = Utils::Maximum(alignment, kHugePageSize);
+  }
+  VirtualMemory* memory = AllocateAligned(size, alignment, is_executable, name);
+#if defined(MADV_HUGEPAGE)
+  if (memory != NULL) {
+    // Failure only means transparent huge pages are disabled.
+    madvise(memory->address(), memory->size(), MADV_HUGEPAGE);
+  }
+#endif  // defined(MADV_HUGEPAGE)
+  return memory;
+}
+
 VirtualMemory::~VirtualMemory() {
   if (vm_owns_region()) {
-    unmap(reserved_.pointer(), reserved_.size());
+    FreeSubSegment(reserved_.pointer(), reserved_.size());
   }
 }
 
 bool VirtualMemory::FreeSubSegment(void* address,
                                    intptr_t size) {
+#if defined(ARCH_IS_64_BIT)
+  if (CompressibleHeapRegion::IsEnabled() &&
+      CompressibleHeapRegion::Contains(reinterpret_cast<uword>(address))) {
+    if (size != 0) {
+      CompressibleHeapRegion::Free(reinterpret_cast<uword>(address), size);
+    }
+    return true;
+  }
+#endif  // defined(ARCH_IS_64_BIT)
   unmap(address, size);
   return true;
 }
 
+void VirtualMemory::DontNeed(void* address, intptr_t size) {
+  if (madvise(address, size, MADV_DONTNEED) != 0) {
+    int error = errno;
+    const int kBufferSize = 1024;
+    char error_buf[kBufferSize];
+    FATAL2("madvise error: %d (%s)", error,
+           Utils::StrError(error, error_buf, kBufferSize));
+  }
+}
+
+void VirtualMemory::BindToNumaNode(void* address,
+                                   intptr_t size,
+                                   intptr_t node) {
+  // MPOL_PREFERRED from <numaif.h>, which comes with libnuma rather than libc.
+  const int kMpolPreferred = 1;
+  ASSERT(node >= 0);
+  if (node >= kBitsPerWord) {
+    return;
+  }
+  uword node_mask = static_cast<uword>(1) << node;
+  // The kernel reads one node less than the given maximum. Failure (e.g. a
+  // kernel without NUMA support) leaves the default first-touch placement.
+  syscall(__NR_mbind, address, size, kMpolPreferred, &node_mask,
+          kBitsPerWord + 1, 0);
+}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
   ASSERT(Thread::Current()->IsMutatorThread() ||
          Isolate::Current()->mutator_thread()->IsAtSafepoint());
@@ -89,6 +89,15 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   return new VirtualMemory(region, region);
 }
 
+VirtualMemory* VirtualMemory::AllocateWithHugePages(intptr_t size,
+                                                    intptr_t alignment,
+                                                    bool is_executable,
+                                                    bool is_truncatable,
+                                                    const char* name) {
+  // Huge pages are not supported on this platform.
+  return AllocateAligned(size, alignment, is_executable, name);
+}
+
 VirtualMemory::~VirtualMemory() {
   if (vm_owns_region()) {
     unmap(reserved_.pointer(), reserved_.size());
@@ -101,6 +110,20 @@ bool VirtualMemory::FreeSubSegment(void* address,
   return true;
 }
 
+void VirtualMemory::DontNeed(void* address, intptr_t size) {
+  if (madvise(address, size, MADV_FREE) != 0) {
+    int error = errno;
+    const int kBufferSize = 1024;
+    char error_buf[kBufferSize];
+    FATAL2("madvise error: %d (%s)", error,
+           Utils::StrError(error, error_buf, kBufferSize));
+  }
+}
+
+void VirtualMemory::BindToNumaNode(void* address,
+                                   intptr_t size,
+                                   intptr_t node) {}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
   ASSERT(Thread::Current()->IsMutatorThread() ||
          Isolate::Current()->mutator_thread()->IsAtSafepoint());
@@ -61,6 +61,15 @@ VirtualMemory* VirtualMemory::AllocateAligned(intptr_t size,
   return new VirtualMemory(region, reserved);
 }
 
+VirtualMemory* VirtualMemory::AllocateWithHugePages(intptr_t size,
+                                                    intptr_t alignment,
+                                                    bool is_executable,
+                                                    bool is_truncatable,
+                                                    const char* name) {
+  // Huge pages are not supported on this platform.
+  return AllocateAligned(size, alignment, is_executable, name);
+}
+
 VirtualMemory::~VirtualMemory() {
   // Note that the size of the reserved region might be set to 0 by
   // Truncate(0, true) but that does not actually release the mapping
@@ -82,6 +91,16 @@ bool VirtualMemory::FreeSubSegment(void* address,
   return true;
 }
 
+void VirtualMemory::DontNeed(void* address, intptr_t size) {
+  if (VirtualAlloc(address, size, MEM_RESET, PAGE_READWRITE) == NULL) {
+    FATAL1("VirtualAlloc failed: Error code %d\n", GetLastError());
+  }
+}
+
+void VirtualMemory::BindToNumaNode(void* address,
+                                   intptr_t size,
+                                   intptr_t node) {}
+
 void VirtualMemory::Protect(void* address, intptr_t size, Protection mode) {
   ASSERT(Thread::Current()->IsMutatorThread() ||
          Isolate::Current()->mutator_thread()->IsAtSafepoint());
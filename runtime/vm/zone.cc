@@ -10,16 +10,24 @@
 #include "vm/flags.h"
 #include "vm/handles_impl.h"
 #include "vm/heap/heap.h"
+#include "vm/lockers.h"
 #include "vm/os.h"
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            zone_segment_cache_size,
+            32,
+            "The maximum number of freed zone segments kept for reuse by "
+            "all threads");
+
 // Zone segments represent chunks of memory: They have starting
 // address encoded in the this pointer and a size in bytes. They are
 // chained together to form the backing storage for an expanding zone.
 class Zone::Segment {
  public:
   Segment* next() const { return next_; }
+  void set_next(Segment* next) { next_ = next; }
   intptr_t size() const { return size_; }
 
   uword start() { return address(sizeof(Segment)); }
@@ -40,12 +48,21 @@ class Zone::Segment {
 
   static void Delete(Segment* segment) { free(segment); }
 
+  friend class Zone;
+
   DISALLOW_IMPLICIT_CONSTRUCTORS(Segment);
 };
 
+Mutex* Zone::segment_cache_mutex_ = NULL;
+Zone::Segment* Zone::segment_cache_ = NULL;
+intptr_t Zone::segment_cache_length_ = 0;
+
 Zone::Segment* Zone::Segment::New(intptr_t size, Zone::Segment* next) {
   ASSERT(size >= 0);
-  Segment* result = reinterpret_cast<Segment*>(malloc(size));
+  Segment* result = (size == kSegmentSize) ? TakeCachedSegment() : NULL;
+  if (result == NULL) {
+    result = reinterpret_cast<Segment*>(malloc(size));
+  }
   if (result == NULL) {
     OUT_OF_MEMORY();
   }
@@ -69,7 +86,9 @@ void Zone::Segment::DeleteSegmentList(Segment* head) {
     // Zap the entire current segment (including the header).
     memset(current, kZapDeletedByte, current->size());
 #endif
-    Segment::Delete(current);
+    if ((current->size() != kSegmentSize) || !CacheSegment(current)) {
+      Segment::Delete(current);
+    }
     current = next;
   }
 }
@@ -94,6 +113,136 @@ void Zone::Segment::DecrementMemoryCapacity(uintptr_t size) {
   }
 }
 
+void Zone::InitOnce() {
+  ASSERT(segment_cache_mutex_ == NULL);
+  segment_cache_mutex_ = new Mutex(NOT_IN_PRODUCT("Zone::segment_cache_mutex_"));
+}
+
+void Zone::Cleanup() {
+  TrimSegmentCache(true);
+  delete segment_cache_mutex_;
+  segment_cache_mutex_ = NULL;
+}
+
+void Zone::TrimSegmentCache(bool all) {
+  Thread* thread = Thread::Current();
+  ZoneSegmentCache* local =
+      (thread != NULL) ? thread->zone_segment_cache_ : NULL;
+  if (local != NULL) {
+    const intptr_t keep = all ? 0 : local->length_ / 2;
+    while (local->length_ > keep) {
+      Segment* segment = local->head_;
+      local->head_ = segment->next();
+      local->length_--;
+      Segment::Delete(segment);
+    }
+  }
+  if (segment_cache_mutex_ == NULL) {
+    return;
+  }
+  Segment* trimmed = NULL;
+  {
+    MutexLocker ml(segment_cache_mutex_);
+    const intptr_t keep = all ? 0 : segment_cache_length_ / 2;
+    while (segment_cache_length_ > keep) {
+      Segment* segment = segment_cache_;
+      segment_cache_ = segment->next();
+      segment_cache_length_--;
+      segment->set_next(trimmed);
+      trimmed = segment;
+    }
+  }
+  // Free outside of the lock.
+  while (trimmed != NULL) {
+    Segment* next = trimmed->next();
+    Segment::Delete(trimmed);
+    trimmed = next;
+  }
+}
+
+ZoneSegmentCache* Zone::ThreadSegmentCache() {
+  Thread* thread = Thread::Current();
+  if (thread == NULL) {
+    return NULL;
+  }
+  if (thread->zone_segment_cache_ == NULL) {
+    thread->zone_segment_cache_ = new ZoneSegmentCache();
+  }
+  return thread->zone_segment_cache_;
+}
+
+Zone::Segment* Zone::TakeCachedSegment() {
+  ZoneSegmentCache* local = ThreadSegmentCache();
+  Segment* result = NULL;
+  if ((local != NULL) && (local->head_ != NULL)) {
+    result = local->head_;
+    local->head_ = result->next();
+    local->length_--;
+  } else if (segment_cache_mutex_ != NULL) {
+    MutexLocker ml(segment_cache_mutex_);
+    if (segment_cache_ != NULL) {
+      result = segment_cache_;
+      segment_cache_ = result->next();
+      segment_cache_length_--;
+    }
+  }
+  if (local != NULL) {
+    if (result != NULL) {
+      local->hits_++;
+    } else {
+      local->misses_++;
+    }
+  }
+  return result;
+}
+
+bool Zone::CacheSegment(Segment* segment) {
+  ASSERT(segment->size() == kSegmentSize);
+  ZoneSegmentCache* local = ThreadSegmentCache();
+  if ((local != NULL) && (local->length_ < ZoneSegmentCache::kMaxLength)) {
+    segment->set_next(local->head_);
+    local->head_ = segment;
+    local->length_++;
+    return true;
+  }
+  if (segment_cache_mutex_ == NULL) {
+    return false;
+  }
+  MutexLocker ml(segment_cache_mutex_);
+  if (segment_cache_length_ >= FLAG_zone_segment_cache_size) {
+    return false;
+  }
+  segment->set_next(segment_cache_);
+  segment_cache_ = segment;
+  segment_cache_length_++;
+  return true;
+}
+
+void Zone::ReleaseSegmentCache(ZoneSegmentCache* cache) {
+  while (cache->head_ != NULL) {
+    Segment* segment = cache->head_;
+    cache->head_ = segment->next();
+    cache->length_--;
+    bool cached = false;
+    if (segment_cache_mutex_ != NULL) {
+      MutexLocker ml(segment_cache_mutex_);
+      if (segment_cache_length_ < FLAG_zone_segment_cache_size) {
+        segment->set_next(segment_cache_);
+        segment_cache_ = segment;
+        segment_cache_length_++;
+        cached = true;
+      }
+    }
+    if (!cached) {
+      Segment::Delete(segment);
+    }
+  }
+}
+
+ZoneSegmentCache::~ZoneSegmentCache() {
+  Zone::ReleaseSegmentCache(this);
+}
+
 // TODO(bkonyi): We need to account for the initial chunk size when a new zone
 // is created within a new thread or ApiNativeScope when calculating high
 // watermarks or memory consumption.
@@ -266,6 +415,14 @@ void Zone::DumpZoneSizes() {
                ") size in bytes,"
                " Total = %" Pd " Large Segments = %" Pd "\n",
                reinterpret_cast<intptr_t>(this), SizeInBytes(), size);
+  Thread* thread = Thread::Current();
+  if ((thread != NULL) && (thread->zone_segment_cache_ != NULL)) {
+    ZoneSegmentCache* cache = thread->zone_segment_cache_;
+    OS::PrintErr("***   Segment cache: thread cached = %" Pd " hits = %" Pd
+                 " misses = %" Pd " shared cached = %" Pd "\n",
+                 cache->length(), cache->hits(), cache->misses(),
+                 segment_cache_length_);
+  }
 }
 
 void Zone::VisitObjectPointers(ObjectPointerVisitor* visitor) {
@@ -14,6 +14,8 @@
 
 namespace dart {
 
+class ZoneSegmentCache;
+
 // Zones support very fast allocation of small chunks of memory. The
 // chunks cannot be deallocated individually, but instead zones
 // support deallocating all chunks in one fast operation.
@@ -83,6 +85,17 @@ class Zone {
     return false;
   }
 
+  // Segments of the default size are recycled rather than returned to
+  // malloc: a freed segment goes to a small cache on the current Thread (see
+  // ZoneSegmentCache), or failing that to a bounded process-wide cache.
+  static void InitOnce();
+  static void Cleanup();
+
+  // Frees all cached segments if 'all' is true. Otherwise frees half of the
+  // process-wide cache and of the current thread's cache, so that a short
+  // idle period still leaves segments for the next burst of zone allocation.
+  static void TrimSegmentCache(bool all);
+
  private:
   Zone();
   ~Zone();  // Delete all memory associated with the zone.
@@ -128,6 +141,10 @@ class Zone {
   // Dump the current allocated sizes in the zone object.
   void DumpZoneSizes();
 
+  // Returns the segment cache of the current Thread, creating it on first
+  // use, or NULL if there is no current Thread.
+  static ZoneSegmentCache* ThreadSegmentCache();
+
   // Overflow check (FATAL) for array length.
   template <class ElementType>
   static inline void CheckLength(intptr_t len);
@@ -151,6 +168,16 @@ class Zone {
   // implementation is in zone.cc.
   class Segment;
 
+  // Segment recycling, see InitOnce. TakeCachedSegment returns NULL when no
+  // cached segment is available; CacheSegment returns false if 'segment' was
+  // not kept and has to be freed by the caller.
+  static Segment* TakeCachedSegment();
+  static bool CacheSegment(Segment* segment);
+  static void ReleaseSegmentCache(ZoneSegmentCache* cache);
+  static Mutex* segment_cache_mutex_;
+  static Segment* segment_cache_;
+  static intptr_t segment_cache_length_;
+
   // The current head segment; may be NULL.
   Segment* head_;
 
@@ -165,6 +192,7 @@ class Zone {
 
   friend class StackZone;
   friend class ApiZone;
+  friend class ZoneSegmentCache;
   template <typename T, typename B, typename Allocator>
   friend class BaseGrowableArray;
   template <typename T, typename B, typename Allocator>
@@ -172,6 +200,36 @@ class Zone {
   DISALLOW_COPY_AND_ASSIGN(Zone);
 };
 
+// Free zone segments owned by a single Thread. Only the OS thread currently
+// running on that Thread touches it, so no locking is needed.
+class ZoneSegmentCache {
+ public:
+  // Maximum number of segments kept per thread.
+  static const intptr_t kMaxLength = 4;
+
+  ZoneSegmentCache() : head_(NULL), length_(0), hits_(0), misses_(0) {}
+
+  // Hands the cached segments to the process-wide cache.
+  ~ZoneSegmentCache();
+
+  intptr_t length() const { return length_; }
+
+  // Number of segment allocations by this thread that were served from a
+  // cache, or that had to go to malloc.
+  intptr_t hits() const { return hits_; }
+  intptr_t misses() const { return misses_; }
+
+ private:
+  friend class Zone;
+
+  Zone::Segment* head_;
+  intptr_t length_;
+  intptr_t hits_;
+  intptr_t misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZoneSegmentCache);
+};
+
 class StackZone : public StackResource {
  public:
   // Create an empty zone and set is at the current zone for the Thread.
@@ -176,4 +176,28 @@ VM_UNIT_TEST_CASE(NativeScopeZoneAllocation) {
   EXPECT_EQ(0UL, ApiNativeScope::current_memory_usage());
 }
 
+ISOLATE_UNIT_TEST_CASE(ZoneSegmentCache) {
+  // Zones created one after another on the same thread reuse the segments
+  // freed by their predecessors instead of going back to malloc.
+  Zone::TrimSegmentCache(true);
+  uword first_segment = 0;
+  for (intptr_t i = 0; i < 10; i++) {
+    StackZone stack_zone(thread);
+    Zone* zone = stack_zone.GetZone();
+    // Overflow the initial buffer into exactly one default sized segment.
+    uword segment = zone->AllocUnsafe(16 * KB);
+    if (i == 0) {
+      first_segment = segment;
+    } else {
+      EXPECT_EQ(first_segment, segment);
+    }
+  }
+  ZoneSegmentCache* cache = thread->zone_segment_cache();
+  EXPECT(cache != NULL);
+  EXPECT_EQ(1, cache->length());
+  EXPECT_LE(9, cache->hits());
+  Zone::TrimSegmentCache(true);
+  EXPECT_EQ(0, cache->length());
+}
+
 }  // namespace dart
@@ -622,6 +622,7 @@ class _HttpParser extends Stream<_HttpIncoming> {
               throw new HttpException("Invalid header field name");
             }
             _headerField.add(_toLowerCaseByte(byte));
+            _addHeaderFieldBytes();
           }
           break;
 
@@ -644,6 +645,7 @@ class _HttpParser extends Stream<_HttpIncoming> {
             _state = _State.HEADER_VALUE_FOLD_OR_END;
           } else {
             _headerValue.add(byte);
+            _addHeaderValueBytes();
           }
           break;
 
@@ -925,6 +927,39 @@ class _HttpParser extends Stream<_HttpIncoming> {
     _index = null;
   }
 
+  // Adds the rest of the header field name in the buffer to _headerField,
+  // stopping before the ':', without a trip through _doParse per byte.
+  void _addHeaderFieldBytes() {
+    final Uint8List buffer = _buffer;
+    final int length = buffer.length;
+    int index = _index;
+    while (index < length) {
+      final int byte = buffer[index];
+      if (byte == _CharCode.COLON) break;
+      if (!_isTokenChar(byte)) {
+        throw new HttpException("Invalid header field name");
+      }
+      _headerField.add(_toLowerCaseByte(byte));
+      index++;
+    }
+    _index = index;
+  }
+
+  // Adds the rest of the header value in the buffer to _headerValue,
+  // stopping before the CR or LF that ends the line.
+  void _addHeaderValueBytes() {
+    final Uint8List buffer = _buffer;
+    final int length = buffer.length;
+    int index = _index;
+    while (index < length) {
+      final int byte = buffer[index];
+      if (byte == _CharCode.CR || byte == _CharCode.LF) break;
+      _headerValue.add(byte);
+      index++;
+    }
+    _index = index;
+  }
+
   static bool _isTokenChar(int byte) {
     return byte > 31 && byte < 128 && !_Const.SEPARATOR_MAP[byte];
   }
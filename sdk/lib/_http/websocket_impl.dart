@@ -95,7 +95,7 @@ class _WebSocketProtocolTransformer extends StreamTransformerBase<List<int>,
   EventSink<dynamic /*List<int>|_WebSocketPing|_WebSocketPong*/ > _eventSink;
 
   final bool _serverSide;
-  final List _maskingBytes = new List(4);
+  final Uint8List _maskingBytes = new Uint8List(4);
   final BytesBuilder _payload = new BytesBuilder(copy: false);
 
   _WebSocketPerMessageDeflate _deflate;
@@ -243,8 +243,8 @@ class _WebSocketProtocolTransformer extends StreamTransformerBase<List<int>,
     const int BLOCK_SIZE = 16;
     // Skip Int32x4-version if message is small.
     if (length >= BLOCK_SIZE) {
-      // Start by aligning to 16 bytes.
-      final int startOffset = BLOCK_SIZE - (index & 15);
+      // Start by aligning to 16 bytes, unless already aligned.
+      final int startOffset = (BLOCK_SIZE - (index & 15)) & 15;
       final int end = index + startOffset;
       for (int i = index; i < end; i++) {
         buffer[i] ^= _maskingBytes[_unmaskingIndex++ & 3];
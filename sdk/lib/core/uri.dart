@@ -2803,7 +2803,14 @@ class _Uri implements Uri {
    * The decoder will create a byte-list of the percent-encoded parts, and then
    * decode the byte-list using [encoding]. The default encodings UTF-8.
    */
-  static String _uriDecode(
+  external static String _uriDecode(
+      String text, int start, int end, Encoding encoding, bool plusToSpace);
+
+  /**
+   * The portable implementation of [_uriDecode], for platforms without a
+   * faster one and for the inputs their faster one doesn't handle.
+   */
+  static String _uriDecodeGeneric(
       String text, int start, int end, Encoding encoding, bool plusToSpace) {
     assert(0 <= start);
     assert(start <= end);
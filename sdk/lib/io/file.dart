@@ -711,6 +711,25 @@ abstract class RandomAccessFile {
    */
   int readIntoSync(List<int> buffer, [int start = 0, int end]);
 
+  /**
+   * Synchronously maps the bytes of the file from [start] to [end] into
+   * memory and returns them as a [Uint8List]. If [end] is omitted, the bytes
+   * up to the current end of the file are mapped.
+   *
+   * The bytes are not read up front: they are paged in from the file when
+   * first accessed, and pages that have not been modified are shared with
+   * other processes mapping the same file. Modifying the list does not
+   * modify the file. The list stays valid after the file is closed and
+   * the mapping is released when the list is garbage collected.
+   *
+   * The contents of the list are unspecified if the file is modified while it
+   * is mapped, and accessing bytes past the end of a file that has been
+   * truncated may terminate the process.
+   *
+   * Throws a [FileSystemException] if the operation fails.
+   */
+  Uint8List mapSync([int start = 0, int end]);
+
   /**
    * Writes a single byte to the file. Returns a
    * `Future<RandomAccessFile>` that completes with this
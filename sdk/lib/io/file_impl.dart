@@ -657,6 +657,7 @@ abstract class _RandomAccessFileOps {
   readByte();
   read(int bytes);
   readInto(List<int> buffer, int start, int end);
+  map(int position, int length);
   writeByte(int value);
   writeFrom(List<int> buffer, int start, int end);
   position();
@@ -772,6 +773,22 @@ class _RandomAccessFile implements RandomAccessFile {
     return result;
   }
 
+  Uint8List mapSync([int start = 0, int end]) {
+    _checkAvailable();
+    if ((start is! int) || ((end != null) && (end is! int))) {
+      throw new ArgumentError();
+    }
+    end = RangeError.checkValidRange(start, end, lengthSync());
+    if (end == start) {
+      return new Uint8List(0);
+    }
+    var result = _ops.map(start, end - start);
+    if (result is OSError) {
+      throw new FileSystemException("mapSync failed", path, result);
+    }
+    return result;
+  }
+
   Future<int> readInto(List<int> buffer, [int start = 0, int end]) {
     if ((buffer is! List) ||
         ((start != null) && (start is! int)) ||
@@ -910,14 +927,7 @@ class _RandomAccessFile implements RandomAccessFile {
     writeFromSync(data, 0, data.length);
   }
 
-  Future<int> position() {
-    return _dispatch(_IOService.filePosition, [null]).then((response) {
-      if (_isErrorResponse(response)) {
-        throw _exceptionFromResponse(response, "position failed", path);
-      }
-      return response;
-    });
-  }
+  Future<int> position() => _dispatchNonBlocking(positionSync);
 
   int positionSync() {
     _checkAvailable();
@@ -929,11 +939,8 @@ class _RandomAccessFile implements RandomAccessFile {
   }
 
   Future<RandomAccessFile> setPosition(int position) {
-    return _dispatch(_IOService.fileSetPosition, [null, position])
-        .then((response) {
-      if (_isErrorResponse(response)) {
-        throw _exceptionFromResponse(response, "setPosition failed", path);
-      }
+    return _dispatchNonBlocking(() {
+      setPositionSync(position);
       return this;
     });
   }
@@ -1099,6 +1106,30 @@ class _RandomAccessFile implements RandomAccessFile {
     });
   }
 
+  // Performs an operation that never blocks, such as getting or setting the
+  // position, in this isolate instead of dispatching it to the IO service.
+  // The file is still considered busy until the returned future completes.
+  Future<T> _dispatchNonBlocking<T>(T operation()) {
+    if (closed) {
+      return new Future.error(new FileSystemException("File closed", path));
+    }
+    if (_asyncDispatched) {
+      var msg = "An async operation is currently pending";
+      return new Future.error(new FileSystemException(msg, path));
+    }
+    T result;
+    try {
+      result = operation();
+    } catch (e, stackTrace) {
+      return new Future.error(e, stackTrace);
+    }
+    _asyncDispatched = true;
+    return new Future<T>.microtask(() {
+      _asyncDispatched = false;
+      return result;
+    });
+  }
+
   void _checkAvailable() {
     if (_asyncDispatched) {
       throw new FileSystemException(
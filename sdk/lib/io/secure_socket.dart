@@ -522,6 +522,8 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
     _secureFilter.init();
     _secureFilter
         .registerHandshakeCompleteCallback(_secureHandshakeCompleteHandler);
+    _secureFilter
+        .registerPrivateKeyOperationCallback(_privateKeyOperationHandler);
     if (onBadCertificate != null) {
       _secureFilter.registerBadCertificateCallback(_onBadCertificateWrapper);
     }
@@ -839,6 +841,14 @@ class _RawSecureSocket extends Stream<RawSocketEvent>
     _scheduleFilter();
   }
 
+  void _privateKeyOperationHandler() {
+    // The handshake can continue now that the private key operation it
+    // waited for is done.
+    if (_status == handshakeStatus) {
+      _secureHandshake();
+    }
+  }
+
   void _secureHandshakeCompleteHandler() {
     _status = connectedStatus;
     if (_connectPending) {
@@ -1239,6 +1249,7 @@ abstract class _SecureFilter {
   int processBuffer(int bufferIndex);
   void registerBadCertificateCallback(Function callback);
   void registerHandshakeCompleteCallback(Function handshakeCompleteHandler);
+  void registerPrivateKeyOperationCallback(Function callback);
 
   // This call may cause a reference counted pointer in the native
   // implementation to be retained. It should only be called when the resulting
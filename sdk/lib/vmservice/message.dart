@@ -168,6 +168,9 @@ class Message {
   Future<Response> sendToIsolate(SendPort sendPort) {
     final receivePort = new RawReceivePort();
     receivePort.handler = (value) {
+      if (_addResponseChunk(value)) {
+        return;
+      }
       receivePort.close();
       _setResponseFromPort(value);
     };
@@ -216,6 +219,9 @@ class Message {
   Future<Response> sendToVM() {
     final receivePort = new RawReceivePort();
     receivePort.handler = (value) {
+      if (_addResponseChunk(value)) {
+        return;
+      }
       receivePort.close();
       _setResponseFromPort(value);
     };
@@ -244,7 +250,33 @@ class Message {
     return _completer.future;
   }
 
+  // Chunks of a large reply, see JSONStream::FlushChunk in the VM.
+  List<Uint8List> _responseChunks;
+
+  // Returns true if [response] is a chunk of a reply that continues in later
+  // messages.
+  bool _addResponseChunk(dynamic response) {
+    if (response is List && response.length == 2 && response[1] == true) {
+      (_responseChunks ??= <Uint8List>[]).add(response[0]);
+      return true;
+    }
+    return false;
+  }
+
   void _setResponseFromPort(dynamic response) {
+    if (response is List && response.length == 2) {
+      // The reply became an error after some of it was sent in chunks.
+      assert(response[1] == false);
+      _responseChunks = null;
+      response = [response[0]];
+    }
+    if (_responseChunks != null) {
+      _responseChunks.add(response[0]);
+      _completer.complete(
+          new Response(ResponsePayloadKind.Utf8Chunks, _responseChunks));
+      _responseChunks = null;
+      return;
+    }
     _completer.complete(new Response.from(response));
   }
 
@@ -18,6 +18,10 @@ enum ResponsePayloadKind {
 
   /// Response payload is a string encoded as UTF8 bytes (Uint8List).
   Utf8String,
+
+  /// Response payload is a string encoded as UTF8 bytes, split into chunks
+  /// (List<Uint8List>).
+  Utf8Chunks,
 }
 
 class Response {
@@ -33,6 +37,8 @@ class Response {
         case ResponsePayloadKind.Binary:
         case ResponsePayloadKind.Utf8String:
           return payload is Uint8List;
+        case ResponsePayloadKind.Utf8Chunks:
+          return payload is List<Uint8List>;
       }
     }());
   }
@@ -62,6 +68,21 @@ class Response {
     }
   }
 
+  /// Concatenates the [chunks] of a Utf8Chunks payload.
+  static Uint8List joinChunks(List<Uint8List> chunks) {
+    int length = 0;
+    for (var chunk in chunks) {
+      length += chunk.length;
+    }
+    final result = new Uint8List(length);
+    int offset = 0;
+    for (var chunk in chunks) {
+      result.setRange(offset, offset + chunk.length, chunk);
+      offset += chunk.length;
+    }
+    return result;
+  }
+
   /// Decode JSON contained in this response.
   dynamic decodeJson() {
     switch (kind) {
@@ -69,6 +90,8 @@ class Response {
         return json.decode(payload);
       case ResponsePayloadKind.Utf8String:
         return json.fuse(utf8).decode(payload);
+      case ResponsePayloadKind.Utf8Chunks:
+        return json.fuse(utf8).decode(joinChunks(payload));
       case ResponsePayloadKind.Binary:
         throw 'Binary responses can not be decoded';
     }
@@ -0,0 +1,48 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test RandomAccessFile.mapSync, including ranges that do not start on a
+// page boundary and writes to the mapped list.
+
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:expect/expect.dart';
+
+main() {
+  final dir = Directory.systemTemp.createTempSync('file_map_test');
+  try {
+    final file = new File('${dir.path}/data');
+    final content =
+        new List<int>.generate(200 * 1024 + 17, (i) => (i * 13) & 0xff);
+    file.writeAsBytesSync(content);
+
+    final opened = file.openSync();
+    Uint8List all = opened.mapSync();
+    Expect.listEquals(content, all);
+    for (final start in [1, 4095, 4096, 65537, 200 * 1024]) {
+      Expect.listEquals(content.sublist(start), opened.mapSync(start));
+      Expect.listEquals(content.sublist(start, start + 16),
+          opened.mapSync(start, start + 16));
+    }
+    Expect.equals(0, opened.mapSync(10, 10).length);
+    Expect.throws(() => opened.mapSync(-1), (e) => e is RangeError);
+    Expect.throws(() => opened.mapSync(0, content.length + 1),
+        (e) => e is RangeError);
+
+    // Writes to the list are private to it.
+    all[0] = content[0] + 1;
+    Expect.equals(content[0] + 1, all[0]);
+    Expect.equals(content[0], opened.mapSync(0, 1)[0]);
+    opened.closeSync();
+    Expect.listEquals(content, file.readAsBytesSync());
+
+    // The list stays valid after the file is closed.
+    Expect.equals(content[1], all[1]);
+    Expect.equals(content.last, all.last);
+    Expect.throws(() => opened.mapSync(), (e) => e is FileSystemException);
+  } finally {
+    dir.deleteSync(recursive: true);
+  }
+}
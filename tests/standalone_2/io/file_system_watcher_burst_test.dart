@@ -0,0 +1,59 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that a burst of changes, which the inotify watcher reads in large
+// batches and may report repeated modifications of once, reports every created
+// file and at least one modification of each written file.
+
+import "dart:async";
+import "dart:io";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+import "package:path/path.dart";
+
+const int fileCount = 200;
+
+// Mac OS coalesces the events of a path, so a file created and written in a
+// burst may only be reported once, as any one of its events.
+final bool reportsEveryKind = !Platform.isMacOS;
+
+main() async {
+  if (!FileSystemEntity.isWatchSupported) return;
+  asyncStart();
+  final dir = Directory.systemTemp.createTempSync('dart_file_system_watcher');
+  final created = new Set<String>();
+  final modified = new Set<String>();
+  final done = new Completer();
+  final sub = dir.watch().listen((event) {
+    final name = basename(event.path);
+    if (event is FileSystemCreateEvent || !reportsEveryKind) created.add(name);
+    if (event is FileSystemModifyEvent && event.contentChanged) {
+      modified.add(name);
+    }
+    if (created.length == fileCount &&
+        (!reportsEveryKind || modified.length == fileCount)) {
+      if (!done.isCompleted) done.complete();
+    }
+  }, onError: (e) {
+    dir.deleteSync(recursive: true);
+    throw e;
+  });
+
+  for (int i = 0; i < fileCount; i++) {
+    final file = new File(join(dir.path, 'file$i'));
+    for (int j = 0; j < 3; j++) {
+      file.writeAsStringSync('$j', mode: FileMode.append);
+    }
+  }
+
+  await done.future;
+  await sub.cancel();
+  for (int i = 0; i < fileCount; i++) {
+    Expect.isTrue(created.contains('file$i'));
+    if (reportsEveryKind) Expect.isTrue(modified.contains('file$i'));
+  }
+  dir.deleteSync(recursive: true);
+  asyncEnd();
+}
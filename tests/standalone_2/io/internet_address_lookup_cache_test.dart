@@ -0,0 +1,42 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--dns-cache-ttl=30
+
+// Test that repeated and concurrent host lookups, which may be answered from
+// the lookup cache, give the same answers as the first lookup.
+
+import 'dart:async';
+import 'dart:io';
+
+import 'package:async_helper/async_helper.dart';
+import 'package:expect/expect.dart';
+
+List<String> addressesOf(List<InternetAddress> addresses) =>
+    addresses.map((address) => address.address).toList();
+
+main() async {
+  asyncStart();
+  for (final type in [InternetAddressType.ANY, InternetAddressType.IP_V4]) {
+    final expected =
+        addressesOf(await InternetAddress.lookup('localhost', type: type));
+    Expect.isTrue(expected.isNotEmpty);
+    final lookups = new List.generate(
+        20, (_) => InternetAddress.lookup('localhost', type: type));
+    for (final addresses in await Future.wait(lookups)) {
+      Expect.listEquals(expected, addressesOf(addresses));
+    }
+  }
+
+  // Failed lookups fail every time, whether or not they are cached.
+  for (int i = 0; i < 3; i++) {
+    await InternetAddress.lookup('does-not-exist.invalid').then((_) {
+      Expect.fail('Lookup of an invalid host succeeded');
+    }, onError: (e) {
+      Expect.isTrue(e is SocketException);
+    });
+  }
+  asyncEnd();
+}
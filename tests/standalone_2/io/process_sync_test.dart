@@ -53,6 +53,8 @@ main() {
   test(1, kBufferSize, kBufferSize, 0);
   test(1, kBufferSize - 1, kBufferSize - 1, 0);
   test(1, kBufferSize + 1, kBufferSize + 1, 0);
+  // Output that makes the buffer grow several times.
+  test(10, 100 * kBufferSize, kBufferSize + 1, 0);
 
   test(10, 10, 10, 1);
   test(10, 10, 10, 255);
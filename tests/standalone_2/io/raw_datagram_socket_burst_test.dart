@@ -0,0 +1,62 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that a burst of datagrams from several senders, which the VM receives
+// several at a time, is delivered in order with the right data and senders.
+
+import 'dart:async';
+import 'dart:io';
+
+import 'package:async_helper/async_helper.dart';
+import 'package:expect/expect.dart';
+
+const int datagramCount = 50;
+
+main() async {
+  asyncStart();
+  final address = InternetAddress.LOOPBACK_IP_V4;
+  final receiver = await RawDatagramSocket.bind(address, 0);
+  final senders = <RawDatagramSocket>[
+    await RawDatagramSocket.bind(address, 0),
+    await RawDatagramSocket.bind(address, 0),
+  ];
+
+  final received = <int, List<int>>{};
+  final done = new Completer();
+  int total = 0;
+  receiver.listen((event) {
+    if (event != RawSocketEvent.READ) return;
+    Datagram datagram;
+    while ((datagram = receiver.receive()) != null) {
+      Expect.equals(address.address, datagram.address.address);
+      final sender = senders.indexWhere((s) => s.port == datagram.port);
+      Expect.isTrue(sender >= 0);
+      final data = datagram.data;
+      Expect.equals(sender, data[0]);
+      Expect.equals(data[1] + 2, data.length);
+      received.putIfAbsent(sender, () => <int>[]).add(data[1]);
+      if (++total == 2 * datagramCount) done.complete();
+    }
+  });
+
+  // Send all datagrams before the receiver gets a chance to run.
+  for (int i = 0; i < datagramCount; i++) {
+    for (int sender = 0; sender < senders.length; sender++) {
+      final data = new List<int>.filled(i + 2, i)
+        ..[0] = sender
+        ..[1] = i;
+      Expect.equals(data.length, senders[sender].send(data, address,
+          receiver.port));
+    }
+  }
+
+  await done.future;
+  for (int sender = 0; sender < senders.length; sender++) {
+    Expect.listEquals(
+        new List<int>.generate(datagramCount, (i) => i), received[sender]);
+    senders[sender].close();
+  }
+  receiver.close();
+  asyncEnd();
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--tls-async-private-key
+// OtherResources=certificates/server_chain.pem
+// OtherResources=certificates/server_key.pem
+// OtherResources=certificates/trusted_certs.pem
+
+// Test that many concurrent server handshakes complete, whether the server's
+// private key operations run on the isolate or on other threads.
+
+import "dart:async";
+import "dart:io";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+const int connectionCount = 20;
+
+String localFile(path) => Platform.script.resolve(path).toFilePath();
+
+SecurityContext serverContext = new SecurityContext()
+  ..useCertificateChain(localFile('certificates/server_chain.pem'))
+  ..usePrivateKey(localFile('certificates/server_key.pem'),
+      password: 'dartdart');
+
+SecurityContext clientContext = new SecurityContext()
+  ..setTrustedCertificates(localFile('certificates/trusted_certs.pem'));
+
+Future<List<int>> echo(int port, int id) async {
+  final socket =
+      await SecureSocket.connect("localhost", port, context: clientContext);
+  socket.add([id, id + 1, id + 2]);
+  await socket.close();
+  final received = <int>[];
+  await for (final data in socket) {
+    received.addAll(data);
+  }
+  return received;
+}
+
+main() async {
+  asyncStart();
+  final server = await SecureServerSocket.bind("localhost", 0, serverContext);
+  server.listen((socket) {
+    socket.listen(socket.add, onDone: socket.close);
+  });
+  final results = await Future.wait(new List<Future<List<int>>>.generate(
+      connectionCount, (i) => echo(server.port, i)));
+  for (int i = 0; i < connectionCount; i++) {
+    Expect.listEquals([i, i + 1, i + 2], results[i]);
+  }
+  await server.close();
+  asyncEnd();
+}
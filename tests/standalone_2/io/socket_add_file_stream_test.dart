@@ -0,0 +1,53 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Test that adding a file stream to a socket, which sends the file without
+// reading it into Dart where supported, sends exactly the requested range.
+
+import 'dart:async';
+import 'dart:io';
+
+import 'package:async_helper/async_helper.dart';
+import 'package:expect/expect.dart';
+
+Future<List<int>> transfer(File file, [int start, int end]) async {
+  final server = await ServerSocket.bind(InternetAddress.LOOPBACK_IP_V4, 0);
+  server.listen((socket) async {
+    await socket.addStream(file.openRead(start, end));
+    await socket.close();
+    server.close();
+  });
+  final client = await Socket.connect(server.address, server.port);
+  final received = <int>[];
+  await for (final data in client) {
+    received.addAll(data);
+  }
+  client.destroy();
+  return received;
+}
+
+main() async {
+  asyncStart();
+  final dir = Directory.systemTemp.createTempSync('socket_add_file_stream');
+  try {
+    final file = new File('${dir.path}/data');
+    final content = new List<int>.generate(300 * 1024, (i) => (i * 7) & 0xff);
+    file.writeAsBytesSync(content);
+
+    Expect.listEquals(content, await transfer(file));
+    Expect.listEquals(content.sublist(1000), await transfer(file, 1000));
+    Expect.listEquals(
+        content.sublist(1000, 200000), await transfer(file, 1000, 200000));
+    // Ranges past the end of the file stop at the end.
+    Expect.listEquals(content.sublist(content.length - 10),
+        await transfer(file, content.length - 10, content.length + 10));
+    Expect.listEquals(<int>[], await transfer(file, 5, 5));
+
+    final empty = new File('${dir.path}/empty')..createSync();
+    Expect.listEquals(<int>[], await transfer(empty));
+  } finally {
+    dir.deleteSync(recursive: true);
+  }
+  asyncEnd();
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// VMOptions=
+// VMOptions=--shared-sockets-reuse-port
+
+// Test that every connection to a port bound several times with `shared: true`
+// is accepted, whether or not the binds share one listening socket.
+
+import 'dart:async';
+import 'dart:io';
+
+import 'package:async_helper/async_helper.dart';
+import 'package:expect/expect.dart';
+
+const int connectionCount = 40;
+
+Future connectAll(int port, List<ServerSocket> servers) async {
+  int accepted = 0;
+  final done = new Completer();
+  final subscriptions = <StreamSubscription>[];
+  for (final server in servers) {
+    subscriptions.add(server.listen((socket) {
+      socket.destroy();
+      if (++accepted == connectionCount) done.complete();
+    }));
+  }
+  for (int i = 0; i < connectionCount; i++) {
+    final socket = await Socket.connect('127.0.0.1', port);
+    socket.destroy();
+  }
+  await done.future;
+  for (final subscription in subscriptions) {
+    await subscription.cancel();
+  }
+}
+
+main() async {
+  asyncStart();
+  final first = await ServerSocket.bind('127.0.0.1', 0, shared: true);
+  final port = first.port;
+  final servers = <ServerSocket>[first];
+  for (int i = 0; i < 3; i++) {
+    final server = await ServerSocket.bind('127.0.0.1', port, shared: true);
+    Expect.equals(port, server.port);
+    servers.add(server);
+  }
+  // Binding without `shared` still fails.
+  await ServerSocket.bind('127.0.0.1', port).then((_) {
+    Expect.fail('Unshared bind to a shared port succeeded');
+  }, onError: (e) {
+    Expect.isTrue(e is SocketException);
+  });
+  await connectAll(port, servers);
+  asyncEnd();
+}
@@ -0,0 +1,23 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+import "dart:io";
+
+main(List<String> arguments) async {
+  for (int i = 0; i < 1000; i++) {
+    if (i % 3 == 0) {
+      print("line $i");
+    } else {
+      stdout.writeln("line $i");
+    }
+    stderr.add("error $i\n".codeUnits);
+  }
+  if (arguments.contains("flush")) {
+    await stdout.flush();
+    await stderr.flush();
+  }
+  if (arguments.contains("exit")) {
+    exit(3);
+  }
+}
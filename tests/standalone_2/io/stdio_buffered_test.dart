@@ -0,0 +1,42 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// OtherResources=stdio_buffered_script.dart
+
+// Test that output written with --buffered-stdio, through print(), stdout and
+// stderr, is written out completely and in order, however the script ends.
+
+import "dart:async";
+import "dart:convert";
+import "dart:io";
+
+import "package:async_helper/async_helper.dart";
+import "package:expect/expect.dart";
+
+Future test(String mode, int exitCode) async {
+  final script =
+      Platform.script.resolve("stdio_buffered_script.dart").toFilePath();
+  final arguments = <String>[]
+    ..addAll(Platform.executableArguments)
+    ..addAll(["--buffered-stdio", script, mode]);
+  final result = await Process.run(Platform.executable, arguments,
+      stdoutEncoding: ascii, stderrEncoding: ascii);
+  Expect.equals(exitCode, result.exitCode);
+  final expectedStdout = new StringBuffer();
+  final expectedStderr = new StringBuffer();
+  for (int i = 0; i < 1000; i++) {
+    expectedStdout.write("line $i\n");
+    expectedStderr.write("error $i\n");
+  }
+  Expect.equals(expectedStdout.toString(), result.stdout);
+  Expect.equals(expectedStderr.toString(), result.stderr);
+}
+
+main() async {
+  asyncStart();
+  await test("return", 0);
+  await test("flush", 0);
+  await test("exit", 3);
+  asyncEnd();
+}
@@ -244,6 +244,21 @@ void testZlibWithDictionary() {
   });
 }
 
+void testZlibDeflateRepeated() {
+  // Encoders with the same settings share zlib state once each one finishes.
+  var dict = [102, 111, 111, 98, 97, 114];
+  var data = new List<int>.generate(10000, (i) => (i * 31) & 0xff);
+  [true, false].forEach((gzip) {
+    var first = new ZLibEncoder(gzip: gzip, dictionary: dict).convert(data);
+    for (int i = 0; i < 20; i++) {
+      var encoded = new ZLibEncoder(gzip: gzip, dictionary: dict).convert(data);
+      Expect.listEquals(first, encoded);
+      Expect.listEquals(
+          data, new ZLibDecoder(dictionary: dict).convert(encoded));
+    }
+  });
+}
+
 var generateListTypes = [
   (list) => list,
   (list) => new Uint8List.fromList(list),
@@ -286,5 +301,6 @@ void main() {
   testZlibInflateThrowsWithSmallerWindow();
   testZlibInflateWithLargerWindow();
   testZlibWithDictionary();
+  testZlibDeflateRepeated();
   asyncEnd();
 }
@@ -0,0 +1,83 @@
+// Copyright (c) 2018, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Checks that --kernel-cache does not serve a program compiled against other
+// package sources, or one whose sources were modified while it compiled.
+
+import "dart:io";
+
+import "package:expect/expect.dart";
+
+Directory tempDir;
+
+String path(String name) => tempDir.uri.resolve(name).toFilePath();
+
+// Writes a file with a modification time well before the next compilation,
+// so that the cache trusts it.
+void writeOld(String name, String contents) {
+  var file = new File(path(name));
+  file.writeAsStringSync(contents);
+  file.setLastModifiedSync(
+      new DateTime.now().subtract(const Duration(minutes: 1)));
+}
+
+String run() {
+  var result = Process.runSync(Platform.executable, <String>[
+    "--preview_dart_2",
+    "--kernel-cache=${path('cache')}",
+    path("main.dart"),
+  ]);
+  Expect.equals(0, result.exitCode, result.stderr);
+  return result.stdout.trim();
+}
+
+String cachedDependencies() {
+  var deps = new Directory(path("cache"))
+      .listSync()
+      .where((entity) => entity.path.endsWith(".deps"))
+      .toList();
+  Expect.equals(1, deps.length);
+  return (deps.single as File).readAsStringSync();
+}
+
+void main() {
+  if (Platform.isAndroid) {
+    return; // The frontend is not available on the test device.
+  }
+
+  tempDir = Directory.systemTemp.createTempSync("kernel-cache");
+  try {
+    new Directory(path("cache")).createSync();
+    new Directory(path("v1")).createSync();
+    new Directory(path("v2")).createSync();
+    writeOld("v1/foo.dart", "String version() => 'one';\n");
+    writeOld("v2/foo.dart", "String version() => 'two';\n");
+    writeOld(
+        "main.dart",
+        "import 'package:foo/foo.dart';\n"
+        "main() => print(version());\n");
+
+    // The '.packages' file next to the script is found without --packages,
+    // and is part of the cached entry.
+    writeOld(".packages", "foo:v1/\n");
+    Expect.equals("one", run());
+    Expect.isTrue(cachedDependencies().contains(path(".packages")));
+    Expect.equals("one", run());
+
+    // Switching package versions invalidates the entry.
+    writeOld(".packages", "foo:v2/\n");
+    Expect.equals("two", run());
+    final deps = cachedDependencies();
+
+    // A source modified as the compilation starts is not trusted to match
+    // the compiled program, so the entry is not replaced.
+    new File(path("v2/foo.dart"))
+        .writeAsStringSync("String version() => 'three';\n");
+    Expect.equals("three", run());
+    Expect.equals(deps, cachedDependencies());
+    Expect.equals("three", run());
+  } finally {
+    tempDir.deleteSync(recursive: true);
+  }
+}